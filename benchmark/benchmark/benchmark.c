@@ -0,0 +1,263 @@
+/* benchmark.c  -  Foundation benchmark library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#include <benchmark/benchmark.h>
+
+FOUNDATION_EXTERN benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t     benchmark_suite;
+volatile uintptr_t    benchmark_sink;
+
+//Minimum duration of a sample in milliseconds, iterations are doubled until reached
+#define BENCHMARK_SAMPLE_MIN_MS    2
+#define BENCHMARK_ITERATIONS_MAX   (1024U * 1024U * 1024U)
+#define BENCHMARK_WARMUP_SAMPLES   3
+#define BENCHMARK_DEFAULT_SAMPLES  50
+
+typedef struct {
+	string_const_t    group;
+	string_const_t    name;
+	benchmark_fn      fn;
+	benchmark_arg_fn  arg_fn;
+	void*             arg;
+	size_t            min_iterations;
+} benchmark_case_t;
+
+typedef struct {
+	const benchmark_case_t* benchmark;
+	size_t            iterations;
+	size_t            samples;
+	double            median;
+	double            p99;
+	double            min;
+	double            mean;
+	double            throughput;
+} benchmark_result_t;
+
+static benchmark_case_t*   _benchmark_cases;
+static benchmark_result_t* _benchmark_results;
+static size_t              _benchmark_samples = BENCHMARK_DEFAULT_SAMPLES;
+static string_const_t      _benchmark_filter;
+static string_const_t      _benchmark_json;
+
+void
+benchmark_add(benchmark_fn fn, const char* group_name, size_t group_length,
+              const char* benchmark_name, size_t benchmark_length) {
+	benchmark_case_t benchmark;
+	benchmark.group = string_const(group_name, group_length);
+	benchmark.name = string_const(benchmark_name, benchmark_length);
+	benchmark.fn = fn;
+	benchmark.arg_fn = 0;
+	benchmark.arg = 0;
+	benchmark.min_iterations = 1;
+	array_push(_benchmark_cases, benchmark);
+}
+
+void
+benchmark_add_arg(benchmark_arg_fn fn, void* arg, size_t min_iterations,
+                  const char* group_name, size_t group_length,
+                  const char* benchmark_name, size_t benchmark_length) {
+	benchmark_case_t benchmark;
+	benchmark.group = string_const(group_name, group_length);
+	benchmark.name = string_const(benchmark_name, benchmark_length);
+	benchmark.fn = 0;
+	benchmark.arg_fn = fn;
+	benchmark.arg = arg;
+	benchmark.min_iterations = min_iterations ? min_iterations : 1;
+	array_push(_benchmark_cases, benchmark);
+}
+
+static void
+benchmark_parse_command_line(void) {
+	const string_const_t* cmdline = environment_command_line();
+	size_t arg, asize;
+	for (arg = 1, asize = array_size(cmdline); arg < asize; ++arg) {
+		if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--samples"))) {
+			if (arg < asize - 1) {
+				unsigned int samples;
+				++arg;
+				samples = string_to_uint(STRING_ARGS(cmdline[arg]), false);
+				_benchmark_samples = samples ? samples : 1;
+			}
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--filter"))) {
+			if (arg < asize - 1)
+				_benchmark_filter = cmdline[++arg];
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--json"))) {
+			if (arg < asize - 1)
+				_benchmark_json = cmdline[++arg];
+		}
+	}
+}
+
+static bool
+benchmark_match(const benchmark_case_t* benchmark) {
+	char buffer[256];
+	string_t fullname;
+	if (!_benchmark_filter.length)
+		return true;
+	fullname = string_format(buffer, sizeof(buffer), STRING_CONST("%.*s.%.*s"),
+	                         STRING_FORMAT(benchmark->group), STRING_FORMAT(benchmark->name));
+	return string_find_string(STRING_ARGS(fullname), STRING_ARGS(_benchmark_filter), 0) !=
+	       STRING_NPOS;
+}
+
+static tick_t
+benchmark_sample(const benchmark_case_t* benchmark, size_t iterations) {
+	tick_t start = time_current();
+	if (benchmark->fn)
+		benchmark->fn(iterations);
+	else
+		benchmark->arg_fn(iterations, benchmark->arg);
+	return time_diff(start, time_current());
+}
+
+static void
+benchmark_measure(const benchmark_case_t* benchmark, benchmark_result_t* result) {
+	tick_t min_ticks = (time_ticks_per_second() * BENCHMARK_SAMPLE_MIN_MS) / 1000;
+	size_t iterations = benchmark->min_iterations;
+	size_t isample, jsample;
+	tick_t* samples;
+	double to_ns, total = 0;
+
+	//Calibration doubles as the first warmup, running until a sample is long enough to time
+	while ((benchmark_sample(benchmark, iterations) < min_ticks) &&
+	        (iterations < BENCHMARK_ITERATIONS_MAX))
+		iterations *= 2;
+	for (isample = 0; isample < BENCHMARK_WARMUP_SAMPLES; ++isample)
+		benchmark_sample(benchmark, iterations);
+
+	samples = memory_allocate(HASH_BENCHMARK, sizeof(tick_t) * _benchmark_samples, 0,
+	                          MEMORY_PERSISTENT);
+	for (isample = 0; isample < _benchmark_samples; ++isample) {
+		tick_t sample = benchmark_sample(benchmark, iterations);
+		//Insertion sort, sample counts are small
+		for (jsample = isample; jsample && (samples[jsample - 1] > sample); --jsample)
+			samples[jsample] = samples[jsample - 1];
+		samples[jsample] = sample;
+		total += (double)sample;
+	}
+
+	to_ns = 1000000000.0 / ((double)time_ticks_per_second() * (double)iterations);
+	result->benchmark = benchmark;
+	result->iterations = iterations;
+	result->samples = _benchmark_samples;
+	result->median = (double)samples[_benchmark_samples / 2] * to_ns;
+	result->p99 = (double)samples[((_benchmark_samples - 1) * 99) / 100] * to_ns;
+	result->min = (double)samples[0] * to_ns;
+	result->mean = (total / (double)_benchmark_samples) * to_ns;
+	result->throughput = (result->median > 0) ? 1000000000.0 / result->median : 0;
+
+	memory_deallocate(samples);
+}
+
+static bool
+benchmark_write_json(void) {
+	stream_t* stream;
+	size_t iresult, rsize;
+	stream = stream_open(STRING_ARGS(_benchmark_json), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	if (!stream) {
+		log_errorf(HASH_BENCHMARK, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to open benchmark result file: %.*s"),
+		           STRING_FORMAT(_benchmark_json));
+		return false;
+	}
+	stream_write_format(stream, STRING_CONST("{\n  \"suite\": \"%.*s\",\n  \"results\": ["),
+	                    STRING_FORMAT(benchmark_suite.application().short_name));
+	for (iresult = 0, rsize = array_size(_benchmark_results); iresult < rsize; ++iresult) {
+		const benchmark_result_t* result = _benchmark_results + iresult;
+		stream_write_format(stream, STRING_CONST("%s\n    {\"group\": \"%.*s\", \"name\": \"%.*s\", "
+		                                         "\"iterations\": %" PRIsize ", \"samples\": %" PRIsize ", "
+		                                         "\"median_ns\": %.3f, \"p99_ns\": %.3f, "
+		                                         "\"min_ns\": %.3f, \"mean_ns\": %.3f, \"throughput\": %.1f}"),
+		                    iresult ? "," : "",
+		                    STRING_FORMAT(result->benchmark->group), STRING_FORMAT(result->benchmark->name),
+		                    result->iterations, result->samples,
+		                    result->median, result->p99, result->min, result->mean, result->throughput);
+	}
+	stream_write_string(stream, STRING_CONST("\n  ]\n}\n"));
+	stream_deallocate(stream);
+	return true;
+}
+
+int
+benchmark_run_all(void) {
+	size_t ibench, bsize;
+	int result = 0;
+
+	if (benchmark_suite.initialize() < 0)
+		return -1;
+	benchmark_suite.declare();
+	benchmark_parse_command_line();
+
+	log_infof(HASH_BENCHMARK, STRING_CONST("Running benchmark suite: %.*s (%" PRIsize " samples)"),
+	          STRING_FORMAT(benchmark_suite.application().short_name), _benchmark_samples);
+
+	thread_set_main();
+
+	for (ibench = 0, bsize = array_size(_benchmark_cases); ibench < bsize; ++ibench) {
+		benchmark_result_t measured;
+		if (!benchmark_match(_benchmark_cases + ibench))
+			continue;
+		benchmark_measure(_benchmark_cases + ibench, &measured);
+		log_infof(HASH_BENCHMARK,
+		          STRING_CONST("  %.*s.%.*s: median %.1f ns, p99 %.1f ns, min %.1f ns, mean %.1f ns, "
+		                       "%.3f M/s (%" PRIsize " iterations x %" PRIsize " samples)"),
+		          STRING_FORMAT(_benchmark_cases[ibench].group), STRING_FORMAT(_benchmark_cases[ibench].name),
+		          measured.median, measured.p99, measured.min, measured.mean,
+		          measured.throughput / 1000000.0, measured.iterations, measured.samples);
+		array_push(_benchmark_results, measured);
+	}
+
+	if (_benchmark_json.length && !benchmark_write_json())
+		result = -1;
+
+	log_infof(HASH_BENCHMARK, STRING_CONST("Finished benchmark suite: %.*s"),
+	          STRING_FORMAT(benchmark_suite.application().short_name));
+
+	array_deallocate(_benchmark_results);
+	array_deallocate(_benchmark_cases);
+	_benchmark_results = 0;
+	_benchmark_cases = 0;
+
+	benchmark_suite.finalize();
+	if (result < 0)
+		process_set_exit_code(-1);
+	return result;
+}
+
+int
+main_initialize(void) {
+	log_set_suppress(0, ERRORLEVEL_INFO);
+
+	benchmark_suite = benchmark_suite_define();
+
+	return foundation_initialize(benchmark_suite.memory_system(), benchmark_suite.application(),
+	                             benchmark_suite.config());
+}
+
+int
+main_run(void* main_arg) {
+	FOUNDATION_UNUSED(main_arg);
+	log_set_suppress(HASH_BENCHMARK, ERRORLEVEL_DEBUG);
+
+	return benchmark_run_all();
+}
+
+void
+main_finalize(void) {
+	foundation_finalize();
+}
@@ -0,0 +1,80 @@
+/* benchmark.h  -  Foundation benchmark library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+#include <foundation/foundation.h>
+
+#if defined( BENCHMARK_COMPILE ) && BENCHMARK_COMPILE
+#  ifdef __cplusplus
+#  define BENCHMARK_EXTERN extern "C"
+#  else
+#  define BENCHMARK_EXTERN extern
+#  endif
+#  define BENCHMARK_API
+#else
+#  ifdef __cplusplus
+#  define BENCHMARK_EXTERN extern "C"
+#  define BENCHMARK_API extern "C"
+#  else
+#  define BENCHMARK_EXTERN extern
+#  define BENCHMARK_API extern
+#  endif
+#endif
+
+/* Each benchmark function runs the measured operation the given number of iterations. The
+harness calibrates the iteration count until a sample takes at least the minimum sample time,
+runs a number of warmup samples, then reports median, 99th percentile, minimum and mean time
+per iteration over the timed samples, with the throughput in iterations per second derived from
+the median. Command line options are
+  --samples <n>        Number of timed samples per benchmark (default 50)
+  --filter <string>    Only run benchmarks with the string in "group.name"
+  --json <path>        Write results as JSON to the given file */
+typedef void (* benchmark_fn)(size_t iterations);
+
+//Benchmark function taking a user argument, for suites registering parameterized benchmarks
+typedef void (* benchmark_arg_fn)(size_t iterations, void* arg);
+
+BENCHMARK_API void
+benchmark_add(benchmark_fn fn, const char* group_name, size_t group_length,
+              const char* benchmark_name, size_t benchmark_length);
+
+//Group and benchmark name strings must stay valid until the suite is finalized. Calibration
+//starts at the given minimum iteration count, for benchmarks with a fixed overhead per sample
+BENCHMARK_API void
+benchmark_add_arg(benchmark_arg_fn fn, void* arg, size_t min_iterations,
+                  const char* group_name, size_t group_length,
+                  const char* benchmark_name, size_t benchmark_length);
+
+BENCHMARK_API int
+benchmark_run_all(void);
+
+//Sink for results of measured operations, to keep the compiler from discarding them
+BENCHMARK_API volatile uintptr_t benchmark_sink;
+
+#define BENCHMARK_CONSUME( value ) ( benchmark_sink += (uintptr_t)(value) )
+
+#define MAKE_BENCHMARK_FN( group, name ) FOUNDATION_PREPROCESSOR_JOIN( FOUNDATION_PREPROCESSOR_JOIN( group, name ), _bench_fn )
+
+#define DECLARE_BENCHMARK( group, name ) static FOUNDATION_NOINLINE void MAKE_BENCHMARK_FN( group, name )( size_t iterations )
+#define ADD_BENCHMARK( group, name ) benchmark_add( MAKE_BENCHMARK_FN( group, name ), STRING_CONST( FOUNDATION_PREPROCESSOR_TOSTRING( group ) ), STRING_CONST( FOUNDATION_PREPROCESSOR_TOSTRING( name ) ) )
+
+typedef struct _benchmark_suite {
+  application_t (*application)(void);
+  memory_system_t (*memory_system)(void);
+  foundation_config_t (*config)(void);
+  void (*declare)(void);
+  int (*initialize)(void);
+  void (*finalize)(void);
+} benchmark_suite_t;
+
+BENCHMARK_API benchmark_suite_t benchmark_suite;
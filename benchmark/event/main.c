@@ -0,0 +1,203 @@
+/* main.c  -  Foundation event benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_event_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation event benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_event"));
+	app.config_dir = string_const(STRING_CONST("benchmark_event"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_event_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_event_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+//Events are processed in blocks of this many posted events
+#define BENCHMARK_EVENT_BLOCK 256
+
+static event_stream_t* _stream;
+static char _payload[64];
+
+static int
+benchmark_event_initialize(void) {
+	_stream = event_stream_allocate(BENCHMARK_EVENT_BLOCK);
+	return 0;
+}
+
+static void
+benchmark_event_finalize(void) {
+	event_stream_deallocate(_stream);
+}
+
+static void
+benchmark_event_drain(void) {
+	event_block_t* block = event_stream_process(_stream);
+	event_t* event = 0;
+	while ((event = event_next(block, event)))
+		BENCHMARK_CONSUME(event->id);
+}
+
+DECLARE_BENCHMARK(event, post) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		event_post(_stream, 1, 0, 0, _payload, 16);
+		if ((iter % BENCHMARK_EVENT_BLOCK) == (BENCHMARK_EVENT_BLOCK - 1))
+			benchmark_event_drain();
+	}
+	benchmark_event_drain();
+}
+
+DECLARE_BENCHMARK(event, post_payload) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		event_post(_stream, 1, 0, 0, _payload, sizeof(_payload));
+		if ((iter % BENCHMARK_EVENT_BLOCK) == (BENCHMARK_EVENT_BLOCK - 1))
+			benchmark_event_drain();
+	}
+	benchmark_event_drain();
+}
+
+DECLARE_BENCHMARK(event, reserve_commit) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		void* payload = event_reserve(_stream, 1, 0, 0, sizeof(_payload));
+		if (payload) {
+			memcpy(payload, _payload, 16);
+			event_commit(_stream, payload, 16);
+		}
+		if ((iter % BENCHMARK_EVENT_BLOCK) == (BENCHMARK_EVENT_BLOCK - 1))
+			benchmark_event_drain();
+	}
+	benchmark_event_drain();
+}
+
+//One iteration is a batch post of a full block of events followed by processing
+DECLARE_BENCHMARK(event, post_batch) {
+	event_post_t post[BENCHMARK_EVENT_BLOCK];
+	size_t iter, ipost;
+	for (ipost = 0; ipost < BENCHMARK_EVENT_BLOCK; ++ipost) {
+		post[ipost].id = (int)ipost + 1;
+		post[ipost].object = 0;
+		post[ipost].delivery = 0;
+		post[ipost].payload = _payload;
+		post[ipost].size = 16;
+	}
+	for (iter = 0; iter < iterations; ++iter) {
+		event_post_batch(_stream, post, BENCHMARK_EVENT_BLOCK);
+		benchmark_event_drain();
+	}
+}
+
+//Consumers reading the same stream, each interested in its own slice of event ids
+#define BENCHMARK_EVENT_CONSUMERS 20
+#define BENCHMARK_EVENT_SLICE     (BENCHMARK_EVENT_BLOCK / BENCHMARK_EVENT_CONSUMERS)
+
+static void
+benchmark_event_post_block(event_stream_t* stream) {
+	event_post_t post[BENCHMARK_EVENT_BLOCK];
+	size_t ipost;
+	for (ipost = 0; ipost < BENCHMARK_EVENT_BLOCK; ++ipost) {
+		post[ipost].id = (int)ipost + 1;
+		post[ipost].object = 0;
+		post[ipost].delivery = 0;
+		post[ipost].payload = _payload;
+		post[ipost].size = 16;
+	}
+	event_post_batch(stream, post, BENCHMARK_EVENT_BLOCK);
+}
+
+//One iteration is a block of events where every consumer scans all events for its ids
+DECLARE_BENCHMARK(event, consume_scan) {
+	size_t iter, iconsumer;
+	for (iter = 0; iter < iterations; ++iter) {
+		event_block_t* block;
+		benchmark_event_post_block(_stream);
+		block = event_stream_process(_stream);
+		for (iconsumer = 0; iconsumer < BENCHMARK_EVENT_CONSUMERS; ++iconsumer) {
+			int first_id = (int)(iconsumer * BENCHMARK_EVENT_SLICE) + 1;
+			int last_id = first_id + BENCHMARK_EVENT_SLICE - 1;
+			event_t* event = 0;
+			while ((event = event_next(block, event))) {
+				if ((event->id >= first_id) && (event->id <= last_id))
+					BENCHMARK_CONSUME(event->id);
+			}
+		}
+	}
+}
+
+//One iteration is a block of events routed once to consumer subscriptions
+DECLARE_BENCHMARK(event, consume_routed) {
+	event_stream_t* stream = event_stream_allocate(BENCHMARK_EVENT_BLOCK);
+	int subscriber[BENCHMARK_EVENT_CONSUMERS];
+	size_t iter, iconsumer, ievent, count;
+	for (iconsumer = 0; iconsumer < BENCHMARK_EVENT_CONSUMERS; ++iconsumer) {
+		int first_id = (int)(iconsumer * BENCHMARK_EVENT_SLICE) + 1;
+		subscriber[iconsumer] = event_stream_subscribe(stream, first_id,
+		                                               first_id + BENCHMARK_EVENT_SLICE - 1);
+	}
+	for (iter = 0; iter < iterations; ++iter) {
+		event_block_t* block;
+		benchmark_event_post_block(stream);
+		block = event_stream_process(stream);
+		for (iconsumer = 0; iconsumer < BENCHMARK_EVENT_CONSUMERS; ++iconsumer) {
+			const uint32_t* offset = event_block_subscriber_offsets(block, subscriber[iconsumer]);
+			count = event_block_subscriber_count(block, subscriber[iconsumer]);
+			for (ievent = 0; ievent < count; ++ievent) {
+				const event_t* event = pointer_offset_const(block->events, offset[ievent]);
+				BENCHMARK_CONSUME(event->id);
+			}
+		}
+	}
+	event_stream_deallocate(stream);
+}
+
+static void
+benchmark_event_declare(void) {
+	ADD_BENCHMARK(event, post);
+	ADD_BENCHMARK(event, post_payload);
+	ADD_BENCHMARK(event, reserve_commit);
+	ADD_BENCHMARK(event, post_batch);
+	ADD_BENCHMARK(event, consume_scan);
+	ADD_BENCHMARK(event, consume_routed);
+}
+
+static benchmark_suite_t benchmark_event_suite = {
+	benchmark_event_application,
+	benchmark_event_memory_system,
+	benchmark_event_config,
+	benchmark_event_declare,
+	benchmark_event_initialize,
+	benchmark_event_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_event_suite;
+}
@@ -0,0 +1,115 @@
+/* main.c  -  Foundation hash benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_hash_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation hash benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_hash"));
+	app.config_dir = string_const(STRING_CONST("benchmark_hash"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_hash_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_hash_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static char _data[64 * 1024];
+
+static int
+benchmark_hash_initialize(void) {
+	size_t ibyte;
+	for (ibyte = 0; ibyte < sizeof(_data); ++ibyte)
+		_data[ibyte] = (char)random32_range(0, 256);
+	return 0;
+}
+
+static void
+benchmark_hash_finalize(void) {
+}
+
+DECLARE_BENCHMARK(hash, hash_8) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash(_data + (iter & 1023), 8));
+}
+
+DECLARE_BENCHMARK(hash, hash_32) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash(_data + (iter & 1023), 32));
+}
+
+DECLARE_BENCHMARK(hash, hash_256) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash(_data + (iter & 1023), 256));
+}
+
+DECLARE_BENCHMARK(hash, hash_65536) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash(_data, sizeof(_data)));
+}
+
+//Hash of a literal name, as in dispatch on event and config names
+DECLARE_BENCHMARK(hash, literal_runtime) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash(STRING_CONST("enable_remote_debugger")));
+}
+
+DECLARE_BENCHMARK(hash, literal_const) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hash_literal("enable_remote_debugger"));
+}
+
+static void
+benchmark_hash_declare(void) {
+	ADD_BENCHMARK(hash, hash_8);
+	ADD_BENCHMARK(hash, hash_32);
+	ADD_BENCHMARK(hash, hash_256);
+	ADD_BENCHMARK(hash, hash_65536);
+	ADD_BENCHMARK(hash, literal_runtime);
+	ADD_BENCHMARK(hash, literal_const);
+}
+
+static benchmark_suite_t benchmark_hash_suite = {
+	benchmark_hash_application,
+	benchmark_hash_memory_system,
+	benchmark_hash_config,
+	benchmark_hash_declare,
+	benchmark_hash_initialize,
+	benchmark_hash_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_hash_suite;
+}
@@ -0,0 +1,155 @@
+/* main.c  -  Foundation hashmap benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_hashmap_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation hashmap benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_hashmap"));
+	app.config_dir = string_const(STRING_CONST("benchmark_hashmap"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_hashmap_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_hashmap_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_KEYS 4096
+
+static hashmap_t* _map;
+static hash_t _keys[BENCHMARK_KEYS];
+static hash_t _missing[BENCHMARK_KEYS];
+static hashmap_string_t* _string_map;
+static string_t _string_keys[BENCHMARK_KEYS];
+
+static int
+benchmark_hashmap_initialize(void) {
+	size_t ikey;
+	for (ikey = 0; ikey < BENCHMARK_KEYS; ++ikey) {
+		_keys[ikey] = random64();
+		_missing[ikey] = random64();
+	}
+	_map = hashmap_allocate(BENCHMARK_KEYS / 4, 8);
+	for (ikey = 0; ikey < BENCHMARK_KEYS; ++ikey)
+		hashmap_insert(_map, _keys[ikey], (void*)(uintptr_t)(ikey + 1));
+	//Mix of short symbol names and longer paths
+	_string_map = hashmap_string_allocate(BENCHMARK_KEYS);
+	for (ikey = 0; ikey < BENCHMARK_KEYS; ++ikey) {
+		_string_keys[ikey] = (ikey & 1) ?
+		                     string_allocate_format(STRING_CONST("symbol_%" PRIsize), ikey) :
+		                     string_allocate_format(STRING_CONST("/project/source/module/file_%" PRIsize ".c"), ikey);
+		hashmap_string_insert(_string_map, STRING_ARGS(_string_keys[ikey]), (void*)(uintptr_t)(ikey + 1));
+	}
+	return 0;
+}
+
+static void
+benchmark_hashmap_finalize(void) {
+	size_t ikey;
+	hashmap_deallocate(_map);
+	hashmap_string_deallocate(_string_map);
+	for (ikey = 0; ikey < BENCHMARK_KEYS; ++ikey)
+		string_deallocate(_string_keys[ikey].str);
+}
+
+DECLARE_BENCHMARK(hashmap, insert) {
+	hashmap_t* map = hashmap_allocate(BENCHMARK_KEYS / 4, 8);
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		size_t ikey = iter % BENCHMARK_KEYS;
+		if (!ikey)
+			hashmap_clear(map);
+		hashmap_insert(map, _keys[ikey], (void*)(uintptr_t)(ikey + 1));
+	}
+	hashmap_deallocate(map);
+}
+
+DECLARE_BENCHMARK(hashmap, lookup) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hashmap_lookup(_map, _keys[iter % BENCHMARK_KEYS]));
+}
+
+DECLARE_BENCHMARK(hashmap, lookup_miss) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hashmap_lookup(_map, _missing[iter % BENCHMARK_KEYS]));
+}
+
+DECLARE_BENCHMARK(hashmap, insert_erase) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		hash_t key = _missing[iter % BENCHMARK_KEYS];
+		hashmap_insert(_map, key, (void*)(uintptr_t)iter);
+		hashmap_erase(_map, key);
+	}
+}
+
+DECLARE_BENCHMARK(hashmap, string_insert) {
+	hashmap_string_t* map = hashmap_string_allocate(BENCHMARK_KEYS);
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		size_t ikey = iter % BENCHMARK_KEYS;
+		if (!ikey)
+			hashmap_string_clear(map);
+		hashmap_string_insert(map, STRING_ARGS(_string_keys[ikey]), (void*)(uintptr_t)(ikey + 1));
+	}
+	hashmap_string_deallocate(map);
+}
+
+DECLARE_BENCHMARK(hashmap, string_lookup) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		const string_t key = _string_keys[iter % BENCHMARK_KEYS];
+		BENCHMARK_CONSUME(hashmap_string_lookup(_string_map, STRING_ARGS(key)));
+	}
+}
+
+static void
+benchmark_hashmap_declare(void) {
+	ADD_BENCHMARK(hashmap, insert);
+	ADD_BENCHMARK(hashmap, lookup);
+	ADD_BENCHMARK(hashmap, lookup_miss);
+	ADD_BENCHMARK(hashmap, insert_erase);
+	ADD_BENCHMARK(hashmap, string_insert);
+	ADD_BENCHMARK(hashmap, string_lookup);
+}
+
+static benchmark_suite_t benchmark_hashmap_suite = {
+	benchmark_hashmap_application,
+	benchmark_hashmap_memory_system,
+	benchmark_hashmap_config,
+	benchmark_hashmap_declare,
+	benchmark_hashmap_initialize,
+	benchmark_hashmap_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_hashmap_suite;
+}
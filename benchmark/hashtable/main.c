@@ -0,0 +1,118 @@
+/* main.c  -  Foundation hashtable benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_hashtable_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation hashtable benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_hashtable"));
+	app.config_dir = string_const(STRING_CONST("benchmark_hashtable"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_hashtable_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_hashtable_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_KEYS 4096
+
+static hashtable32_t* _table32;
+static hashtable64_t* _table64;
+static uint32_t _keys32[BENCHMARK_KEYS];
+static uint64_t _keys64[BENCHMARK_KEYS];
+static uint64_t _values64[BENCHMARK_KEYS];
+
+static int
+benchmark_hashtable_initialize(void) {
+	size_t ikey;
+	//Tables are sized to twice the key count, zero keys are reserved
+	_table32 = hashtable32_allocate(BENCHMARK_KEYS * 2);
+	_table64 = hashtable64_allocate(BENCHMARK_KEYS * 2);
+	for (ikey = 0; ikey < BENCHMARK_KEYS; ++ikey) {
+		_keys32[ikey] = random32_range(1, 0xFFFFFFFF);
+		_keys64[ikey] = random64() | 1;
+		hashtable32_set(_table32, _keys32[ikey], (uint32_t)ikey);
+		hashtable64_set(_table64, _keys64[ikey], ikey);
+	}
+	return 0;
+}
+
+static void
+benchmark_hashtable_finalize(void) {
+	hashtable32_deallocate(_table32);
+	hashtable64_deallocate(_table64);
+}
+
+DECLARE_BENCHMARK(hashtable, set64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		hashtable64_set(_table64, _keys64[iter % BENCHMARK_KEYS], iter);
+}
+
+DECLARE_BENCHMARK(hashtable, get32) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hashtable32_get(_table32, _keys32[iter % BENCHMARK_KEYS]));
+}
+
+DECLARE_BENCHMARK(hashtable, get64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(hashtable64_get(_table64, _keys64[iter % BENCHMARK_KEYS]));
+}
+
+//One iteration is a batch lookup of all keys
+DECLARE_BENCHMARK(hashtable, get64_batch) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		hashtable64_get_batch(_table64, _keys64, _values64, BENCHMARK_KEYS);
+		BENCHMARK_CONSUME(_values64[iter % BENCHMARK_KEYS]);
+	}
+}
+
+static void
+benchmark_hashtable_declare(void) {
+	ADD_BENCHMARK(hashtable, set64);
+	ADD_BENCHMARK(hashtable, get32);
+	ADD_BENCHMARK(hashtable, get64);
+	ADD_BENCHMARK(hashtable, get64_batch);
+}
+
+static benchmark_suite_t benchmark_hashtable_suite = {
+	benchmark_hashtable_application,
+	benchmark_hashtable_memory_system,
+	benchmark_hashtable_config,
+	benchmark_hashtable_declare,
+	benchmark_hashtable_initialize,
+	benchmark_hashtable_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_hashtable_suite;
+}
@@ -0,0 +1,493 @@
+/* main.c  -  Foundation io benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+#if FOUNDATION_PLATFORM_POSIX
+#include <foundation/posix.h>
+#include <dirent.h>
+#endif
+
+static application_t
+benchmark_io_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation io benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_io"));
+	app.config_dir = string_const(STRING_CONST("benchmark_io"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_io_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_io_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+/* Stream and file system benchmarks, each paired with a baseline in the "raw" group
+doing the same work directly with system calls and libc, showing the overhead of the stream_t
+abstraction per call and per byte. Block size variants report time per block, per byte cost
+is the time divided by the block size. */
+
+#define BENCHMARK_FILE_SIZE      (16 * 1024 * 1024)
+#define BENCHMARK_TEXT_LINES     (64 * 1024)
+#define BENCHMARK_COPY_SIZE      (1024 * 1024)
+#define BENCHMARK_TREE_FILES     1024
+#define BENCHMARK_TREE_SUBDIRS   128
+#define BENCHMARK_RANDOM_OFFSETS 4096
+#define BENCHMARK_BUFFER_SIZE    (64 * 1024)
+
+static string_t _path;
+static string_t _file_path;
+static string_t _text_path;
+static string_t _copy_path;
+static string_t _copy_dest_path;
+static string_t _tree_path;
+static string_t* _names;
+static char _block[BENCHMARK_BUFFER_SIZE];
+static size_t _offsets[BENCHMARK_RANDOM_OFFSETS];
+
+static stream_t* _file;
+static stream_t* _text;
+static stream_t* _pipe;
+static stream_t* _ringbuffer_stream;
+static ringbuffer_t* _ringbuffer;
+#if FOUNDATION_PLATFORM_POSIX
+static int _fd;
+static FILE* _text_file;
+static int _pipe_fd[2];
+#endif
+
+static bool
+benchmark_io_write_file(const string_t path, size_t size, bool text) {
+	stream_t* stream = fs_open_file(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	size_t written = 0;
+	if (!stream)
+		return false;
+	if (text) {
+		size_t iline;
+		for (iline = 0; iline < BENCHMARK_TEXT_LINES; ++iline) {
+			//Lines of 8 to 119 characters
+			size_t length = 8 + (random32_range(0, 112));
+			stream_write(stream, _block, length);
+			stream_write(stream, "\n", 1);
+		}
+	}
+	else {
+		while (written < size) {
+			stream_write(stream, _block, sizeof(_block));
+			written += sizeof(_block);
+		}
+	}
+	stream_deallocate(stream);
+	return true;
+}
+
+static int
+benchmark_io_initialize(void) {
+	size_t ientry, ioffset;
+	string_const_t tmp = environment_temporary_directory();
+
+	for (ientry = 0; ientry < sizeof(_block); ++ientry)
+		_block[ientry] = (char)('a' + (ientry % 26));
+	for (ioffset = 0; ioffset < BENCHMARK_RANDOM_OFFSETS; ++ioffset)
+		_offsets[ioffset] = (size_t)random32_range(0, (BENCHMARK_FILE_SIZE - BENCHMARK_BUFFER_SIZE) / 64) * 64;
+
+	_path = path_allocate_concat(STRING_ARGS(tmp), STRING_CONST("benchmark_io"));
+	_file_path = path_allocate_concat(STRING_ARGS(_path), STRING_CONST("data.bin"));
+	_text_path = path_allocate_concat(STRING_ARGS(_path), STRING_CONST("text.txt"));
+	_copy_path = path_allocate_concat(STRING_ARGS(_path), STRING_CONST("copy.bin"));
+	_copy_dest_path = path_allocate_concat(STRING_ARGS(_path), STRING_CONST("copy_dest.bin"));
+	_tree_path = path_allocate_concat(STRING_ARGS(_path), STRING_CONST("tree"));
+
+	fs_remove_directory(STRING_ARGS(_path));
+	if (!fs_make_directory(STRING_ARGS(_tree_path)) ||
+	        !benchmark_io_write_file(_file_path, BENCHMARK_FILE_SIZE, false) ||
+	        !benchmark_io_write_file(_text_path, 0, true) ||
+	        !benchmark_io_write_file(_copy_path, BENCHMARK_COPY_SIZE, false)) {
+		log_error(HASH_BENCHMARK, ERROR_SYSTEM_CALL_FAIL, STRING_CONST("Unable to create benchmark files"));
+		return -1;
+	}
+
+	for (ientry = 0; ientry < BENCHMARK_TREE_FILES + BENCHMARK_TREE_SUBDIRS; ++ientry) {
+		char buffer[BUILD_MAX_PATHLEN];
+		bool is_file = (ientry < BENCHMARK_TREE_FILES);
+		string_t entry = string_format(buffer, sizeof(buffer), STRING_CONST("%.*s/%s%04" PRIsize),
+		                               STRING_FORMAT(_tree_path), is_file ? "file" : "dir", ientry);
+		if (is_file)
+			stream_deallocate(fs_open_file(STRING_ARGS(entry), STREAM_OUT | STREAM_CREATE));
+		else
+			fs_make_directory(STRING_ARGS(entry));
+	}
+
+	_file = fs_open_file(STRING_ARGS(_file_path), STREAM_IN | STREAM_BINARY);
+	_text = fs_open_file(STRING_ARGS(_text_path), STREAM_IN);
+	_pipe = pipe_allocate();
+	_ringbuffer_stream = ringbuffer_stream_allocate(BENCHMARK_BUFFER_SIZE * 2, 0);
+	_ringbuffer = ringbuffer_allocate(BENCHMARK_BUFFER_SIZE * 2);
+#if FOUNDATION_PLATFORM_POSIX
+	_fd = open(_file_path.str, O_RDONLY);
+	_text_file = fopen(_text_path.str, "r");
+	if (pipe(_pipe_fd) < 0)
+		_pipe_fd[0] = _pipe_fd[1] = -1;
+#endif
+	return 0;
+}
+
+static void
+benchmark_io_finalize(void) {
+#if FOUNDATION_PLATFORM_POSIX
+	if (_fd >= 0)
+		close(_fd);
+	if (_text_file)
+		fclose(_text_file);
+	if (_pipe_fd[0] >= 0) {
+		close(_pipe_fd[0]);
+		close(_pipe_fd[1]);
+	}
+#endif
+	stream_deallocate(_file);
+	stream_deallocate(_text);
+	stream_deallocate(_pipe);
+	stream_deallocate(_ringbuffer_stream);
+	ringbuffer_deallocate(_ringbuffer);
+
+	fs_remove_directory(STRING_ARGS(_path));
+	string_deallocate(_tree_path.str);
+	string_deallocate(_copy_dest_path.str);
+	string_deallocate(_copy_path.str);
+	string_deallocate(_text_path.str);
+	string_deallocate(_file_path.str);
+	string_deallocate(_path.str);
+	string_array_deallocate(_names);
+}
+
+static void
+benchmark_io_read_sequential(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		if (stream_read(_file, _block, size) != size)
+			stream_seek(_file, 0, STREAM_SEEK_BEGIN);
+	}
+}
+
+static void
+benchmark_io_read_random(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		stream_seek(_file, (ssize_t)_offsets[iter % BENCHMARK_RANDOM_OFFSETS], STREAM_SEEK_BEGIN);
+		BENCHMARK_CONSUME(stream_read(_file, _block, size));
+	}
+}
+
+static void
+benchmark_io_read_line(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		string_t line = stream_read_line(_text, '\n');
+		if (!line.str)
+			stream_seek(_text, 0, STREAM_SEEK_BEGIN);
+		BENCHMARK_CONSUME(line.length);
+		string_deallocate(line.str);
+	}
+}
+
+static void
+benchmark_io_read_line_buffer(size_t iterations, void* arg) {
+	char buffer[256];
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		if (stream_eos(_text))
+			stream_seek(_text, 0, STREAM_SEEK_BEGIN);
+		BENCHMARK_CONSUME(stream_read_line_buffer(_text, buffer, sizeof(buffer), '\n').length);
+	}
+}
+
+static void
+benchmark_io_line_iterator(size_t iterations, void* arg) {
+	stream_line_iterator_t iterator;
+	string_const_t line;
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	stream_seek(_text, 0, STREAM_SEEK_BEGIN);
+	stream_line_iterator_initialize(&iterator, _text, '\n');
+	for (iter = 0; iter < iterations; ++iter) {
+		if (!stream_line_iterator_next(&iterator, &line)) {
+			stream_line_iterator_finalize(&iterator);
+			stream_seek(_text, 0, STREAM_SEEK_BEGIN);
+			stream_line_iterator_initialize(&iterator, _text, '\n');
+			continue;
+		}
+		BENCHMARK_CONSUME(line.length);
+	}
+	stream_line_iterator_finalize(&iterator);
+}
+
+//Each iteration builds a 64KiB buffer stream in writes of the given size
+static void
+benchmark_io_buffer_grow(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter, written;
+	for (iter = 0; iter < iterations; ++iter) {
+		stream_t* stream = buffer_stream_allocate(0, STREAM_OUT, 0, 0, true, true);
+		for (written = 0; written < BENCHMARK_BUFFER_SIZE; written += size)
+			stream_write(stream, _block, size);
+		stream_deallocate(stream);
+	}
+}
+
+static void
+benchmark_io_pipe(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		stream_write(_pipe, _block, size);
+		BENCHMARK_CONSUME(stream_read(_pipe, _block, size));
+	}
+}
+
+static void
+benchmark_io_ringbuffer_stream(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		stream_write(_ringbuffer_stream, _block, size);
+		BENCHMARK_CONSUME(stream_read(_ringbuffer_stream, _block, size));
+	}
+}
+
+static void
+benchmark_io_ringbuffer(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		ringbuffer_write(_ringbuffer, _block, size);
+		BENCHMARK_CONSUME(ringbuffer_read(_ringbuffer, _block, size));
+	}
+}
+
+static void
+benchmark_io_files(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		string_t* files = fs_files(STRING_ARGS(_tree_path));
+		BENCHMARK_CONSUME(array_size(files));
+		string_array_deallocate(files);
+	}
+}
+
+static void
+benchmark_io_subdirs(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		string_t* subdirs = fs_subdirs(STRING_ARGS(_tree_path));
+		BENCHMARK_CONSUME(array_size(subdirs));
+		string_array_deallocate(subdirs);
+	}
+}
+
+static void
+benchmark_io_list_directory(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter)
+		fs_listing_deallocate(fs_list_directory(STRING_ARGS(_tree_path)));
+}
+
+static void
+benchmark_io_copy_file(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(fs_copy_file(STRING_ARGS(_copy_path), STRING_ARGS(_copy_dest_path)));
+}
+
+#if FOUNDATION_PLATFORM_POSIX
+
+static void
+benchmark_posix_read_sequential(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		if (read(_fd, _block, size) != (ssize_t)size)
+			lseek(_fd, 0, SEEK_SET);
+	}
+}
+
+static void
+benchmark_posix_read_random(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		lseek(_fd, (off_t)_offsets[iter % BENCHMARK_RANDOM_OFFSETS], SEEK_SET);
+		BENCHMARK_CONSUME(read(_fd, _block, size));
+	}
+}
+
+static void
+benchmark_posix_read_line(size_t iterations, void* arg) {
+	char buffer[256];
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		if (!fgets(buffer, sizeof(buffer), _text_file))
+			rewind(_text_file);
+		BENCHMARK_CONSUME(buffer[0]);
+	}
+}
+
+static void
+benchmark_posix_buffer_grow(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter, written;
+	for (iter = 0; iter < iterations; ++iter) {
+		size_t capacity = 0;
+		char* buffer = 0;
+		for (written = 0; written < BENCHMARK_BUFFER_SIZE; written += size) {
+			if (written + size > capacity) {
+				capacity = capacity ? capacity * 2 : 64;
+				while (capacity < written + size)
+					capacity *= 2;
+				buffer = realloc(buffer, capacity);
+			}
+			memcpy(buffer + written, _block, size);
+		}
+		free(buffer);
+	}
+}
+
+static void
+benchmark_posix_pipe(size_t iterations, void* arg) {
+	size_t size = (size_t)(uintptr_t)arg;
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		if (write(_pipe_fd[1], _block, size) == (ssize_t)size)
+			BENCHMARK_CONSUME(read(_pipe_fd[0], _block, size));
+	}
+}
+
+static void
+benchmark_posix_files(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		DIR* dir = opendir(_tree_path.str);
+		struct dirent* entry;
+		size_t count = 0;
+		while (dir && (entry = readdir(dir))) {
+			if (entry->d_type == DT_REG)
+				++count;
+		}
+		if (dir)
+			closedir(dir);
+		BENCHMARK_CONSUME(count);
+	}
+}
+
+static void
+benchmark_posix_copy_file(size_t iterations, void* arg) {
+	size_t iter;
+	FOUNDATION_UNUSED(arg);
+	for (iter = 0; iter < iterations; ++iter) {
+		int in = open(_copy_path.str, O_RDONLY);
+		int out = open(_copy_dest_path.str, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		ssize_t num;
+		while ((in >= 0) && (out >= 0) && ((num = read(in, _block, sizeof(_block))) > 0))
+			BENCHMARK_CONSUME(write(out, _block, (size_t)num));
+		if (in >= 0)
+			close(in);
+		if (out >= 0)
+			close(out);
+	}
+}
+
+#endif
+
+static void
+benchmark_io_add(benchmark_arg_fn fn, const char* group, size_t group_length, const char* name,
+                 size_t name_length, size_t size) {
+	string_t fullname = size ?
+	                    string_allocate_format(STRING_CONST("%.*s_%" PRIsize), (int)name_length, name, size) :
+	                    string_clone(name, name_length);
+	array_push(_names, fullname);
+	benchmark_add_arg(fn, (void*)(uintptr_t)size, 1, group, group_length, STRING_ARGS(fullname));
+}
+
+static void
+benchmark_io_declare(void) {
+	const size_t block_size[] = { 64, 4096, 65536 };
+	const size_t num_sizes = sizeof(block_size) / sizeof(block_size[0]);
+	size_t isize;
+
+	for (isize = 0; isize < num_sizes; ++isize) {
+		benchmark_io_add(benchmark_io_read_sequential, STRING_CONST("stream"), STRING_CONST("read_sequential"), block_size[isize]);
+		benchmark_io_add(benchmark_io_read_random, STRING_CONST("stream"), STRING_CONST("read_random"), block_size[isize]);
+	}
+	benchmark_io_add(benchmark_io_read_line, STRING_CONST("stream"), STRING_CONST("read_line"), 0);
+	benchmark_io_add(benchmark_io_read_line_buffer, STRING_CONST("stream"), STRING_CONST("read_line_buffer"), 0);
+	benchmark_io_add(benchmark_io_line_iterator, STRING_CONST("stream"), STRING_CONST("line_iterator"), 0);
+	for (isize = 0; isize < 2; ++isize) {
+		benchmark_io_add(benchmark_io_buffer_grow, STRING_CONST("stream"), STRING_CONST("buffer_grow"), block_size[isize]);
+		benchmark_io_add(benchmark_io_pipe, STRING_CONST("stream"), STRING_CONST("pipe"), block_size[isize]);
+		benchmark_io_add(benchmark_io_ringbuffer_stream, STRING_CONST("stream"), STRING_CONST("ringbuffer"), block_size[isize]);
+	}
+	benchmark_io_add(benchmark_io_files, STRING_CONST("fs"), STRING_CONST("files"), 0);
+	benchmark_io_add(benchmark_io_subdirs, STRING_CONST("fs"), STRING_CONST("subdirs"), 0);
+	benchmark_io_add(benchmark_io_list_directory, STRING_CONST("fs"), STRING_CONST("list_directory"), 0);
+	benchmark_io_add(benchmark_io_copy_file, STRING_CONST("fs"), STRING_CONST("copy_file"), 0);
+
+#if FOUNDATION_PLATFORM_POSIX
+	for (isize = 0; isize < num_sizes; ++isize) {
+		benchmark_io_add(benchmark_posix_read_sequential, STRING_CONST("raw"), STRING_CONST("read_sequential"), block_size[isize]);
+		benchmark_io_add(benchmark_posix_read_random, STRING_CONST("raw"), STRING_CONST("read_random"), block_size[isize]);
+	}
+	benchmark_io_add(benchmark_posix_read_line, STRING_CONST("raw"), STRING_CONST("read_line"), 0);
+	for (isize = 0; isize < 2; ++isize) {
+		benchmark_io_add(benchmark_posix_buffer_grow, STRING_CONST("raw"), STRING_CONST("buffer_grow"), block_size[isize]);
+		benchmark_io_add(benchmark_posix_pipe, STRING_CONST("raw"), STRING_CONST("pipe"), block_size[isize]);
+		benchmark_io_add(benchmark_io_ringbuffer, STRING_CONST("raw"), STRING_CONST("ringbuffer"), block_size[isize]);
+	}
+	benchmark_io_add(benchmark_posix_files, STRING_CONST("raw"), STRING_CONST("files"), 0);
+	benchmark_io_add(benchmark_posix_copy_file, STRING_CONST("raw"), STRING_CONST("copy_file"), 0);
+#endif
+}
+
+static benchmark_suite_t benchmark_io_suite = {
+	benchmark_io_application,
+	benchmark_io_memory_system,
+	benchmark_io_config,
+	benchmark_io_declare,
+	benchmark_io_initialize,
+	benchmark_io_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_io_suite;
+}
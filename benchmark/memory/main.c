@@ -0,0 +1,119 @@
+/* main.c  -  Foundation memory benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_memory_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation memory benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_memory"));
+	app.config_dir = string_const(STRING_CONST("benchmark_memory"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_memory_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_memory_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_BLOCKS 256
+
+static void* _blocks[BENCHMARK_BLOCKS];
+
+static int
+benchmark_memory_initialize(void) {
+	return 0;
+}
+
+static void
+benchmark_memory_finalize(void) {
+}
+
+DECLARE_BENCHMARK(memory, allocate_16) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		memory_deallocate(memory_allocate(0, 16, 0, MEMORY_PERSISTENT));
+}
+
+DECLARE_BENCHMARK(memory, allocate_aligned_64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		memory_deallocate(memory_allocate(0, 64, 64, MEMORY_PERSISTENT));
+}
+
+DECLARE_BENCHMARK(memory, allocate_zero_4096) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		memory_deallocate(memory_allocate(0, 4096, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED));
+}
+
+//Holds a window of live blocks of varying sizes to exercise allocator bookkeeping
+DECLARE_BENCHMARK(memory, allocate_mixed) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		size_t iblock = iter % BENCHMARK_BLOCKS;
+		memory_deallocate(_blocks[iblock]);
+		_blocks[iblock] = memory_allocate(0, 16 + ((iter * 37) % 2048), 0, MEMORY_PERSISTENT);
+	}
+	for (iter = 0; iter < BENCHMARK_BLOCKS; ++iter) {
+		memory_deallocate(_blocks[iter]);
+		_blocks[iter] = 0;
+	}
+}
+
+DECLARE_BENCHMARK(memory, reallocate) {
+	void* block = memory_allocate(0, 16, 0, MEMORY_PERSISTENT);
+	size_t size = 16, iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		size_t newsize = (size < 64 * 1024) ? size * 2 : 16;
+		block = memory_reallocate(block, newsize, 0, size);
+		size = newsize;
+	}
+	memory_deallocate(block);
+}
+
+static void
+benchmark_memory_declare(void) {
+	ADD_BENCHMARK(memory, allocate_16);
+	ADD_BENCHMARK(memory, allocate_aligned_64);
+	ADD_BENCHMARK(memory, allocate_zero_4096);
+	ADD_BENCHMARK(memory, allocate_mixed);
+	ADD_BENCHMARK(memory, reallocate);
+}
+
+static benchmark_suite_t benchmark_memory_suite = {
+	benchmark_memory_application,
+	benchmark_memory_memory_system,
+	benchmark_memory_config,
+	benchmark_memory_declare,
+	benchmark_memory_initialize,
+	benchmark_memory_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_memory_suite;
+}
@@ -0,0 +1,154 @@
+/* main.c  -  Foundation objectmap benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_objectmap_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation objectmap benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_objectmap"));
+	app.config_dir = string_const(STRING_CONST("benchmark_objectmap"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_objectmap_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_objectmap_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_OBJECTS 4096
+
+static objectmap_t* _map;
+static object_base_t _objects[BENCHMARK_OBJECTS];
+static soamap_t* _soamap;
+
+static int
+benchmark_objectmap_initialize(void) {
+	size_t field_size[] = { sizeof(uint32_t), sizeof(real) * 4 };
+	size_t iobj;
+	_map = objectmap_allocate(BENCHMARK_OBJECTS * 2);
+	for (iobj = 0; iobj < BENCHMARK_OBJECTS; ++iobj) {
+		_objects[iobj].id = objectmap_reserve(_map);
+		atomic_store32(&_objects[iobj].ref, 1);
+		objectmap_set(_map, _objects[iobj].id, _objects + iobj);
+	}
+	_soamap = soamap_allocate(_map, field_size, 2, BENCHMARK_OBJECTS);
+	for (iobj = 0; iobj < BENCHMARK_OBJECTS; ++iobj) {
+		size_t row = soamap_insert(_soamap, _objects[iobj].id);
+		((uint32_t*)soamap_field(_soamap, 0))[row] = (uint32_t)iobj;
+	}
+	return 0;
+}
+
+static void
+benchmark_objectmap_finalize(void) {
+	size_t iobj;
+	soamap_deallocate(_soamap);
+	for (iobj = 0; iobj < BENCHMARK_OBJECTS; ++iobj)
+		objectmap_free(_map, _objects[iobj].id);
+	objectmap_deallocate(_map);
+}
+
+DECLARE_BENCHMARK(objectmap, reserve_free) {
+	object_base_t object;
+	size_t iter;
+	atomic_store32(&object.ref, 1);
+	for (iter = 0; iter < iterations; ++iter) {
+		object.id = objectmap_reserve(_map);
+		objectmap_set(_map, object.id, &object);
+		objectmap_free(_map, object.id);
+	}
+}
+
+DECLARE_BENCHMARK(objectmap, lookup) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(objectmap_lookup(_map, _objects[iter % BENCHMARK_OBJECTS].id));
+}
+
+DECLARE_BENCHMARK(objectmap, lookup_ref) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		object_base_t* object = objectmap_lookup_ref(_map, _objects[iter % BENCHMARK_OBJECTS].id);
+		atomic_decr32(&object->ref);
+		BENCHMARK_CONSUME(object);
+	}
+}
+
+DECLARE_BENCHMARK(objectmap, soamap_lookup) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(soamap_lookup(_soamap, _objects[iter % BENCHMARK_OBJECTS].id, 0));
+}
+
+//Iterate over a field of all objects, one object per iteration
+DECLARE_BENCHMARK(objectmap, soamap_iterate) {
+	const uint32_t* value = soamap_field(_soamap, 0);
+	size_t count = soamap_size(_soamap);
+	size_t iter, row;
+	uint32_t sum = 0;
+	for (iter = 0; iter < iterations; iter += count) {
+		for (row = 0; row < count; ++row)
+			sum += value[row];
+	}
+	BENCHMARK_CONSUME(sum);
+}
+
+DECLARE_BENCHMARK(objectmap, next_iterate) {
+	size_t iter, index;
+	uint32_t sum = 0;
+	for (iter = 0; iter < iterations; iter += BENCHMARK_OBJECTS) {
+		object_base_t* object;
+		index = 0;
+		while ((object = objectmap_next(_map, &index)))
+			sum += (uint32_t)atomic_load32(&object->ref);
+	}
+	BENCHMARK_CONSUME(sum);
+}
+
+static void
+benchmark_objectmap_declare(void) {
+	ADD_BENCHMARK(objectmap, reserve_free);
+	ADD_BENCHMARK(objectmap, lookup);
+	ADD_BENCHMARK(objectmap, lookup_ref);
+	ADD_BENCHMARK(objectmap, soamap_lookup);
+	ADD_BENCHMARK(objectmap, soamap_iterate);
+	ADD_BENCHMARK(objectmap, next_iterate);
+}
+
+static benchmark_suite_t benchmark_objectmap_suite = {
+	benchmark_objectmap_application,
+	benchmark_objectmap_memory_system,
+	benchmark_objectmap_config,
+	benchmark_objectmap_declare,
+	benchmark_objectmap_initialize,
+	benchmark_objectmap_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_objectmap_suite;
+}
@@ -0,0 +1,120 @@
+/* main.c  -  Foundation radixsort benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_radixsort_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation radixsort benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_radixsort"));
+	app.config_dir = string_const(STRING_CONST("benchmark_radixsort"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_radixsort_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_radixsort_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_ELEMENTS 4096
+
+static radixsort_t* _sort_int32;
+static radixsort_t* _sort_float32;
+static radixsort_t* _sort_uint64;
+//Two input sets used alternately, so each sort starts from an order unrelated to the input
+//instead of hitting the temporal coherence early out
+static int32_t _int32[2][BENCHMARK_ELEMENTS];
+static float32_t _float32[2][BENCHMARK_ELEMENTS];
+static uint64_t _uint64[2][BENCHMARK_ELEMENTS];
+
+static int
+benchmark_radixsort_initialize(void) {
+	size_t iset, ielem;
+	for (iset = 0; iset < 2; ++iset) {
+		for (ielem = 0; ielem < BENCHMARK_ELEMENTS; ++ielem) {
+			_int32[iset][ielem] = (int32_t)random32();
+			_float32[iset][ielem] = (float32_t)(random_normalized() * REAL_C(2000.0) - REAL_C(1000.0));
+			_uint64[iset][ielem] = random64();
+		}
+	}
+	_sort_int32 = radixsort_allocate(RADIXSORT_INT32, BENCHMARK_ELEMENTS);
+	_sort_float32 = radixsort_allocate(RADIXSORT_FLOAT32, BENCHMARK_ELEMENTS);
+	_sort_uint64 = radixsort_allocate(RADIXSORT_UINT64, BENCHMARK_ELEMENTS);
+	return 0;
+}
+
+static void
+benchmark_radixsort_finalize(void) {
+	radixsort_deallocate(_sort_int32);
+	radixsort_deallocate(_sort_float32);
+	radixsort_deallocate(_sort_uint64);
+}
+
+DECLARE_BENCHMARK(radixsort, int32) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(radixsort_sort(_sort_int32, _int32[iter & 1], BENCHMARK_ELEMENTS));
+}
+
+DECLARE_BENCHMARK(radixsort, int32_sorted) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(radixsort_sort(_sort_int32, _int32[0], BENCHMARK_ELEMENTS));
+}
+
+DECLARE_BENCHMARK(radixsort, float32) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(radixsort_sort(_sort_float32, _float32[iter & 1], BENCHMARK_ELEMENTS));
+}
+
+DECLARE_BENCHMARK(radixsort, uint64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(radixsort_sort(_sort_uint64, _uint64[iter & 1], BENCHMARK_ELEMENTS));
+}
+
+static void
+benchmark_radixsort_declare(void) {
+	ADD_BENCHMARK(radixsort, int32);
+	ADD_BENCHMARK(radixsort, int32_sorted);
+	ADD_BENCHMARK(radixsort, float32);
+	ADD_BENCHMARK(radixsort, uint64);
+}
+
+static benchmark_suite_t benchmark_radixsort_suite = {
+	benchmark_radixsort_application,
+	benchmark_radixsort_memory_system,
+	benchmark_radixsort_config,
+	benchmark_radixsort_declare,
+	benchmark_radixsort_initialize,
+	benchmark_radixsort_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_radixsort_suite;
+}
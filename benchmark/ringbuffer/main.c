@@ -0,0 +1,113 @@
+/* main.c  -  Foundation ringbuffer benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_ringbuffer_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation ringbuffer benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_ringbuffer"));
+	app.config_dir = string_const(STRING_CONST("benchmark_ringbuffer"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_ringbuffer_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_ringbuffer_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+#define BENCHMARK_RINGBUFFER_SIZE (64 * 1024)
+
+static ringbuffer_t* _buffer;
+static ringbuffer_spsc_t* _spsc;
+static char _data[4096];
+
+static int
+benchmark_ringbuffer_initialize(void) {
+	_buffer = ringbuffer_allocate(BENCHMARK_RINGBUFFER_SIZE);
+	_spsc = ringbuffer_spsc_allocate(BENCHMARK_RINGBUFFER_SIZE);
+	return 0;
+}
+
+static void
+benchmark_ringbuffer_finalize(void) {
+	ringbuffer_deallocate(_buffer);
+	ringbuffer_spsc_deallocate(_spsc);
+}
+
+DECLARE_BENCHMARK(ringbuffer, write_read_64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		ringbuffer_write(_buffer, _data, 64);
+		BENCHMARK_CONSUME(ringbuffer_read(_buffer, _data, 64));
+	}
+}
+
+DECLARE_BENCHMARK(ringbuffer, write_read_4096) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		ringbuffer_write(_buffer, _data, sizeof(_data));
+		BENCHMARK_CONSUME(ringbuffer_read(_buffer, _data, sizeof(_data)));
+	}
+}
+
+DECLARE_BENCHMARK(ringbuffer, spsc_write_read_64) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		ringbuffer_spsc_write(_spsc, _data, 64);
+		BENCHMARK_CONSUME(ringbuffer_spsc_read(_spsc, _data, 64));
+	}
+}
+
+DECLARE_BENCHMARK(ringbuffer, spsc_write_read_4096) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter) {
+		ringbuffer_spsc_write(_spsc, _data, sizeof(_data));
+		BENCHMARK_CONSUME(ringbuffer_spsc_read(_spsc, _data, sizeof(_data)));
+	}
+}
+
+static void
+benchmark_ringbuffer_declare(void) {
+	ADD_BENCHMARK(ringbuffer, write_read_64);
+	ADD_BENCHMARK(ringbuffer, write_read_4096);
+	ADD_BENCHMARK(ringbuffer, spsc_write_read_64);
+	ADD_BENCHMARK(ringbuffer, spsc_write_read_4096);
+}
+
+static benchmark_suite_t benchmark_ringbuffer_suite = {
+	benchmark_ringbuffer_application,
+	benchmark_ringbuffer_memory_system,
+	benchmark_ringbuffer_config,
+	benchmark_ringbuffer_declare,
+	benchmark_ringbuffer_initialize,
+	benchmark_ringbuffer_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_ringbuffer_suite;
+}
@@ -0,0 +1,339 @@
+/* main.c  -  Foundation scaling benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_scaling_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation scaling benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_scaling"));
+	app.config_dir = string_const(STRING_CONST("benchmark_scaling"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_scaling_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_scaling_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+/* Each scenario runs at 1, 2, 4, ... threads up to the number of hardware threads, registered
+as "<scenario>.threads_<n>". Iterations are split evenly across the threads so the reported
+time per iteration and throughput are for the combined work of all threads, giving the
+throughput curve of the scenario across the thread counts. The main thread runs as the first
+thread and the others are persistent worker threads woken for each sample. The maximum thread
+count can be overridden with the --threads <n> command line option. */
+
+#define BENCHMARK_THREADS_MAX 64
+#define BENCHMARK_HASHTABLE_KEYS 1024
+//Minimum operations per thread in a sample, keeping thread wake-up latency out of calibration
+#define BENCHMARK_THREAD_MIN_OPS 1024
+
+typedef void (* scaling_fn)(size_t ithread, size_t num_threads, size_t count);
+
+typedef struct {
+	scaling_fn    fn;
+	size_t        num_threads;
+} scaling_case_t;
+
+static thread_t _threads[BENCHMARK_THREADS_MAX];
+static size_t _num_threads;
+static atomic32_t _generation;
+static atomic32_t _done;
+static semaphore_t _finished;
+static bool _exiting;
+static const scaling_case_t* _job;
+static size_t _job_count;
+
+static scaling_case_t* _cases;
+static string_t* _names;
+
+static event_stream_t* _stream;
+static objectmap_t* _map;
+static hashtable64_t* _table;
+static mutex_t* _mutex;
+static size_t _mutex_counter;
+static semaphore_t _ping[BENCHMARK_THREADS_MAX / 2];
+static semaphore_t _pong[BENCHMARK_THREADS_MAX / 2];
+
+static void*
+scaling_worker_thread(void* arg) {
+	size_t ithread = (size_t)(uintptr_t)arg;
+	int32_t generation = 0;
+	while (true) {
+		int32_t current = atomic_load32_explicit(&_generation, MEMORY_ORDER_ACQUIRE);
+		if (_exiting)
+			break;
+		if (current == generation) {
+			thread_wait();
+			continue;
+		}
+		generation = current;
+		if (ithread < _job->num_threads) {
+			_job->fn(ithread, _job->num_threads, _job_count);
+			atomic_incr32(&_done);
+			semaphore_post(&_finished);
+		}
+	}
+	return 0;
+}
+
+static void
+scaling_execute(size_t iterations, void* arg) {
+	const scaling_case_t* scaling = arg;
+	size_t ithread;
+
+	_job = scaling;
+	_job_count = (iterations > scaling->num_threads) ? iterations / scaling->num_threads : 1;
+	atomic_store32_explicit(&_done, 0, MEMORY_ORDER_RELAXED);
+	atomic_add32(&_generation, 1);
+	for (ithread = 1; ithread < scaling->num_threads; ++ithread)
+		thread_signal(_threads + ithread);
+
+	scaling->fn(0, scaling->num_threads, _job_count);
+
+	//Block rather than spin so waiting does not steal time from workers on oversubscribed cores
+	for (ithread = 1; ithread < scaling->num_threads; ++ithread)
+		semaphore_wait(&_finished);
+}
+
+static void
+scaling_memory(size_t ithread, size_t num_threads, size_t count) {
+	size_t iop;
+	FOUNDATION_UNUSED(num_threads);
+	for (iop = 0; iop < count; ++iop)
+		memory_deallocate(memory_allocate(0, 16 + ((iop + ithread) % 8) * 16, 0, MEMORY_PERSISTENT));
+}
+
+static void
+scaling_event_drain(void) {
+	event_block_t* block = event_stream_process(_stream);
+	event_t* event = 0;
+	while ((event = event_next(block, event)))
+		BENCHMARK_CONSUME(event->id);
+}
+
+//The first thread is the single consumer, processing the shared stream while posting
+static void
+scaling_event(size_t ithread, size_t num_threads, size_t count) {
+	char payload[16] = {0};
+	size_t iop;
+	FOUNDATION_UNUSED(num_threads);
+	for (iop = 0; iop < count; ++iop) {
+		event_post(_stream, 1, 0, 0, payload, sizeof(payload));
+		if (!ithread && ((iop % 64) == 63))
+			scaling_event_drain();
+	}
+	if (!ithread) {
+		while (atomic_load32_explicit(&_done, MEMORY_ORDER_ACQUIRE) < (int32_t)num_threads - 1) {
+			scaling_event_drain();
+			thread_yield();
+		}
+		scaling_event_drain();
+		scaling_event_drain();
+	}
+}
+
+static void
+scaling_objectmap(size_t ithread, size_t num_threads, size_t count) {
+	object_base_t object;
+	size_t iop;
+	FOUNDATION_UNUSED(ithread);
+	FOUNDATION_UNUSED(num_threads);
+	atomic_store32(&object.ref, 1);
+	for (iop = 0; iop < count; ++iop) {
+		object.id = objectmap_reserve(_map);
+		objectmap_set(_map, object.id, &object);
+		objectmap_free(_map, object.id);
+	}
+}
+
+//Each thread sets and gets keys in its own key range of the shared table
+static void
+scaling_hashtable(size_t ithread, size_t num_threads, size_t count) {
+	uint64_t base = ((uint64_t)ithread + 1) << 32;
+	size_t iop;
+	FOUNDATION_UNUSED(num_threads);
+	for (iop = 0; iop < count; ++iop) {
+		uint64_t key = base + (iop % BENCHMARK_HASHTABLE_KEYS);
+		hashtable64_set(_table, key, iop);
+		BENCHMARK_CONSUME(hashtable64_get(_table, key));
+	}
+}
+
+static void
+scaling_mutex(size_t ithread, size_t num_threads, size_t count) {
+	size_t iop;
+	FOUNDATION_UNUSED(ithread);
+	FOUNDATION_UNUSED(num_threads);
+	for (iop = 0; iop < count; ++iop) {
+		mutex_lock(_mutex);
+		++_mutex_counter;
+		mutex_unlock(_mutex);
+	}
+}
+
+//Threads ping-pong in pairs, an odd thread out ping-pongs with itself
+static void
+scaling_semaphore(size_t ithread, size_t num_threads, size_t count) {
+	size_t ipair = ithread / 2;
+	size_t iop;
+	if (ithread & 1) {
+		for (iop = 0; iop < count; ++iop) {
+			semaphore_wait(_ping + ipair);
+			semaphore_post(_pong + ipair);
+		}
+	}
+	else if (ithread + 1 < num_threads) {
+		for (iop = 0; iop < count; ++iop) {
+			semaphore_post(_ping + ipair);
+			semaphore_wait(_pong + ipair);
+		}
+	}
+	else {
+		for (iop = 0; iop < count; ++iop) {
+			semaphore_post(_ping + ipair);
+			semaphore_wait(_ping + ipair);
+		}
+	}
+}
+
+static int
+benchmark_scaling_initialize(void) {
+	const string_const_t* cmdline = environment_command_line();
+	size_t ithread, arg, asize;
+
+	_num_threads = system_hardware_threads();
+	for (arg = 1, asize = array_size(cmdline); arg < asize - 1; ++arg) {
+		if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--threads")))
+			_num_threads = string_to_uint(STRING_ARGS(cmdline[arg + 1]), false);
+	}
+	if (_num_threads > BENCHMARK_THREADS_MAX)
+		_num_threads = BENCHMARK_THREADS_MAX;
+	if (!_num_threads)
+		_num_threads = 1;
+
+	_stream = event_stream_allocate(4096);
+	_map = objectmap_allocate(BENCHMARK_THREADS_MAX * 16);
+	_table = hashtable64_allocate(BENCHMARK_THREADS_MAX * BENCHMARK_HASHTABLE_KEYS * 2);
+	_mutex = mutex_allocate(STRING_CONST("benchmark"));
+	semaphore_initialize(&_finished, 0);
+	for (ithread = 0; ithread < BENCHMARK_THREADS_MAX / 2; ++ithread) {
+		semaphore_initialize(_ping + ithread, 0);
+		semaphore_initialize(_pong + ithread, 0);
+	}
+
+	for (ithread = 1; ithread < _num_threads; ++ithread) {
+		thread_initialize(_threads + ithread, scaling_worker_thread, (void*)(uintptr_t)ithread,
+		                  STRING_CONST("benchmark_worker"), THREAD_PRIORITY_NORMAL, 0);
+		thread_start(_threads + ithread);
+	}
+
+	return 0;
+}
+
+static void
+benchmark_scaling_finalize(void) {
+	size_t ithread, iname;
+
+	_exiting = true;
+	atomic_add32(&_generation, 1);
+	for (ithread = 1; ithread < _num_threads; ++ithread)
+		thread_signal(_threads + ithread);
+	for (ithread = 1; ithread < _num_threads; ++ithread)
+		thread_finalize(_threads + ithread);
+
+	for (ithread = 0; ithread < BENCHMARK_THREADS_MAX / 2; ++ithread) {
+		semaphore_finalize(_ping + ithread);
+		semaphore_finalize(_pong + ithread);
+	}
+	semaphore_finalize(&_finished);
+	mutex_deallocate(_mutex);
+	hashtable64_deallocate(_table);
+	objectmap_deallocate(_map);
+	event_stream_deallocate(_stream);
+
+	for (iname = 0; iname < array_size(_names); ++iname)
+		string_deallocate(_names[iname].str);
+	array_deallocate(_names);
+	memory_deallocate(_cases);
+}
+
+static void
+benchmark_scaling_declare(void) {
+	const struct {
+		const char* name;
+		size_t length;
+		scaling_fn fn;
+	} scenario[] = {
+		{ STRING_CONST("memory"), scaling_memory },
+		{ STRING_CONST("event"), scaling_event },
+		{ STRING_CONST("objectmap"), scaling_objectmap },
+		{ STRING_CONST("hashtable"), scaling_hashtable },
+		{ STRING_CONST("mutex"), scaling_mutex },
+		{ STRING_CONST("semaphore"), scaling_semaphore }
+	};
+	size_t counts[BENCHMARK_THREADS_MAX];
+	size_t num_counts = 0;
+	size_t num_scenarios = sizeof(scenario) / sizeof(scenario[0]);
+	size_t iscenario, icount, num_threads;
+
+	for (num_threads = 1; num_threads < _num_threads; num_threads *= 2)
+		counts[num_counts++] = num_threads;
+	counts[num_counts++] = _num_threads;
+
+	for (icount = 0; icount < num_counts; ++icount) {
+		string_t name = string_allocate_format(STRING_CONST("threads_%" PRIsize), counts[icount]);
+		array_push(_names, name);
+	}
+
+	//Cases are allocated up front, the harness keeps pointers to them
+	_cases = memory_allocate(0, sizeof(scaling_case_t) * num_counts * num_scenarios,
+	                         0, MEMORY_PERSISTENT);
+	for (iscenario = 0; iscenario < num_scenarios; ++iscenario) {
+		for (icount = 0; icount < num_counts; ++icount) {
+			scaling_case_t* scaling = _cases + (iscenario * num_counts) + icount;
+			scaling->fn = scenario[iscenario].fn;
+			scaling->num_threads = counts[icount];
+			benchmark_add_arg(scaling_execute, scaling, counts[icount] * BENCHMARK_THREAD_MIN_OPS,
+			                  scenario[iscenario].name, scenario[iscenario].length,
+			                  STRING_ARGS(_names[icount]));
+		}
+	}
+}
+
+static benchmark_suite_t benchmark_scaling_suite = {
+	benchmark_scaling_application,
+	benchmark_scaling_memory_system,
+	benchmark_scaling_config,
+	benchmark_scaling_declare,
+	benchmark_scaling_initialize,
+	benchmark_scaling_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_scaling_suite;
+}
@@ -0,0 +1,153 @@
+/* main.c  -  Foundation string benchmark  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <benchmark/benchmark.h>
+
+static application_t
+benchmark_string_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation string benchmarks"));
+	app.short_name = string_const(STRING_CONST("benchmark_string"));
+	app.config_dir = string_const(STRING_CONST("benchmark_string"));
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+benchmark_string_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+benchmark_string_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static string_t _text;
+static char _buffer[1024];
+
+static int
+benchmark_string_initialize(void) {
+	size_t ichar;
+	_text = string_allocate(16 * 1024, 16 * 1024 + 1);
+	for (ichar = 0; ichar < _text.length; ++ichar)
+		_text.str[ichar] = (char)('a' + random32_range(0, 26));
+	_text.str[_text.length] = 0;
+	return 0;
+}
+
+static void
+benchmark_string_finalize(void) {
+	string_deallocate(_text.str);
+}
+
+DECLARE_BENCHMARK(string, find_string_miss) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_find_string(STRING_ARGS(_text), STRING_CONST("0123456789"), 0));
+}
+
+DECLARE_BENCHMARK(string, find_char_miss) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_find(STRING_ARGS(_text), '0', 0));
+}
+
+DECLARE_BENCHMARK(string, equal) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_equal(_text.str, 256, _text.str + (iter & 1), 256));
+}
+
+DECLARE_BENCHMARK(string, copy_256) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_copy(_buffer, sizeof(_buffer), _text.str + (iter & 1023), 256).length);
+}
+
+DECLARE_BENCHMARK(string, format) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_format(_buffer, sizeof(_buffer), STRING_CONST("%s %d %.3f %" PRIsize),
+		                                "benchmark", (int)iter, 3.25, iter).length);
+}
+
+DECLARE_BENCHMARK(string, to_int) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_to_int(STRING_CONST("-1234567")) + (int)iter);
+}
+
+DECLARE_BENCHMARK(string, from_uuid) {
+	size_t iter;
+	uuid_t uuid = uuid_generate_random();
+	for (iter = 0; iter < iterations; ++iter) {
+		uuid.word[0] += iter;
+		BENCHMARK_CONSUME(string_from_uuid(_buffer, sizeof(_buffer), uuid).str[(iter & 31)]);
+	}
+}
+
+DECLARE_BENCHMARK(string, to_uuid) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_to_uuid(STRING_CONST("6ba7b810-9dad-11d1-80b4-00c04fd430c8")).word[0]);
+}
+
+DECLARE_BENCHMARK(string, hex_decode_256) {
+	uint8_t data[128];
+	size_t iter;
+	string_t hex = string_hex_encode(_buffer, sizeof(_buffer), _text.str, 128, false);
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_hex_decode(STRING_ARGS(hex), data, sizeof(data)) + data[iter & 127]);
+}
+
+DECLARE_BENCHMARK(string, hex_encode_256) {
+	size_t iter;
+	for (iter = 0; iter < iterations; ++iter)
+		BENCHMARK_CONSUME(string_hex_encode(_buffer, sizeof(_buffer), _text.str + (iter & 1023), 128,
+		                                    false).str[iter & 255]);
+}
+
+static void
+benchmark_string_declare(void) {
+	ADD_BENCHMARK(string, find_string_miss);
+	ADD_BENCHMARK(string, find_char_miss);
+	ADD_BENCHMARK(string, equal);
+	ADD_BENCHMARK(string, copy_256);
+	ADD_BENCHMARK(string, format);
+	ADD_BENCHMARK(string, to_int);
+	ADD_BENCHMARK(string, from_uuid);
+	ADD_BENCHMARK(string, to_uuid);
+	ADD_BENCHMARK(string, hex_encode_256);
+	ADD_BENCHMARK(string, hex_decode_256);
+}
+
+static benchmark_suite_t benchmark_string_suite = {
+	benchmark_string_application,
+	benchmark_string_memory_system,
+	benchmark_string_config,
+	benchmark_string_declare,
+	benchmark_string_initialize,
+	benchmark_string_finalize
+};
+
+benchmark_suite_t
+benchmark_suite_define(void);
+
+benchmark_suite_t
+benchmark_suite_define(void) {
+	return benchmark_string_suite;
+}
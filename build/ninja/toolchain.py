@@ -843,13 +843,13 @@ class Toolchain(object):
       if config == 'debug':
         flags += '-O0 -DBUILD_DEBUG=1 -g'
       elif config == 'release':
-        flags += '-O3 -DBUILD_RELEASE=1 -g -funroll-loops'
+        flags += '-O3 -DBUILD_RELEASE=1 -g -funroll-loops -fno-omit-frame-pointer'
       elif config == 'profile':
         if self.toolchain == 'clang':
           flags += '-O3'
         else:
           flags += '-O4'
-        flags += ' -DBUILD_PROFILE=1 -g -funroll-loops'
+        flags += ' -DBUILD_PROFILE=1 -g -funroll-loops -fno-omit-frame-pointer'
       elif config == 'deploy':
         if self.toolchain == 'clang':
           flags += '-O3'
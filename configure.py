@@ -20,12 +20,12 @@ if target.is_android():
                     os.path.join( toolchain.android_ndkpath, 'sources', 'android', 'cpufeatures', 'cpu-features.c' ) ]
 
 foundation_lib = generator.lib( module = 'foundation', sources = [
-  'android.c', 'array.c', 'assert.c', 'assetstream.c', 'atomic.c', 'base64.c', 'beacon.c', 'bitbuffer.c', 'blowfish.c',
-  'bufferstream.c', 'config.c', 'crash.c', 'environment.c', 'error.c', 'event.c', 'foundation.c', 'fs.c',
-  'hash.c', 'hashmap.c', 'hashtable.c', 'library.c', 'log.c', 'main.c', 'md5.c', 'memory.c', 'mutex.c',
-  'objectmap.c', 'path.c', 'pipe.c', 'pnacl.c', 'process.c', 'profile.c', 'radixsort.c', 'random.c', 'regex.c',
-  'ringbuffer.c', 'semaphore.c', 'stacktrace.c', 'stream.c', 'string.c', 'system.c', 'thread.c', 'time.c',
-  'tizen.c', 'uuid.c', 'version.c', 'delegate.m', 'environment.m', 'fs.m', 'system.m' ] + extrasources )
+  'aes.c', 'android.c', 'array.c', 'assert.c', 'assetstream.c', 'atomic.c', 'base64.c', 'beacon.c', 'bitbuffer.c', 'blowfish.c',
+  'bufferstream.c', 'checksum.c', 'cipherstream.c', 'compressstream.c', 'config.c', 'crash.c', 'environment.c', 'error.c', 'event.c', 'fiber.c', 'foundation.c', 'fs.c',
+  'hash.c', 'hashmap.c', 'hashtable.c', 'intern.c', 'library.c', 'lock.c', 'lockfree.c', 'log.c', 'main.c', 'math.c', 'md5.c', 'memory.c', 'mutex.c',
+  'objectmap.c', 'pack.c', 'path.c', 'pipe.c', 'pnacl.c', 'process.c', 'processpool.c', 'profile.c', 'queue.c', 'radixsort.c', 'random.c',
+  'regex.c', 'ringbuffer.c', 'runloop.c', 'semaphore.c', 'sha256.c', 'socketstream.c', 'soamap.c', 'stacktrace.c', 'stream.c', 'string.c', 'system.c', 'task.c', 'thread.c', 'time.c', 'timer.c',
+  'tizen.c', 'uuid.c', 'varint.c', 'version.c', 'delegate.m', 'environment.m', 'fs.m', 'system.m' ] + extrasources )
 
 if not target.is_ios() and not target.is_android() and not target.is_tizen():
   configs = [ config for config in toolchain.configs if config not in [ 'profile', 'deploy' ] ]
@@ -38,10 +38,10 @@ includepaths = [ 'test' ]
 test_lib = generator.lib( module = 'test', basepath = 'test', sources = [ 'test.c', 'test.m' ], includepaths = includepaths )
 
 test_cases = [
-  'app', 'array', 'atomic', 'base64', 'beacon', 'bitbuffer', 'blowfish', 'bufferstream', 'config', 'crash', 'environment',
-  'error', 'event', 'fs', 'hash', 'hashmap', 'hashtable', 'library', 'math', 'md5', 'mutex', 'objectmap',
-  'path', 'pipe', 'process', 'profile', 'radixsort', 'random', 'regex', 'ringbuffer', 'semaphore', 'stacktrace',
-  'stream', 'string', 'system', 'time', 'uuid'
+  'aes', 'app', 'array', 'atomic', 'base64', 'beacon', 'bitbuffer', 'blowfish', 'bufferstream', 'checksum', 'cipherstream', 'compressstream', 'config', 'crash', 'environment',
+  'error', 'event', 'fiber', 'fs', 'hash', 'hashmap', 'hashtable', 'intern', 'library', 'lock', 'lockfree', 'math', 'md5', 'mutex', 'objectmap',
+  'pack', 'path', 'pipe', 'process', 'processpool', 'profile', 'queue', 'radixsort', 'random', 'regex', 'ringbuffer', 'runloop', 'semaphore', 'sha256', 'socketstream', 'soamap', 'stacktrace',
+  'stream', 'string', 'system', 'task', 'time', 'timer', 'uuid', 'varint'
 ]
 if toolchain.is_monolithic() or target.is_ios() or target.is_android() or target.is_tizen() or target.is_pnacl():
   #Build one fat binary with all test cases
@@ -73,3 +73,13 @@ else:
   generator.bin( module = 'all', sources = [ 'main.c' ], binname = 'test-all', basepath = 'test', implicit_deps = [ foundation_lib ], libs = [ 'foundation' ], includepaths = includepaths )
   for test in test_cases:
     generator.bin( module = test, sources = [ 'main.c' ], binname = 'test-' + test, basepath = 'test', implicit_deps = [ foundation_lib, test_lib ], libs = [ 'test', 'foundation' ], includepaths = includepaths )
+
+if not toolchain.is_monolithic() and not target.is_ios() and not target.is_android() and not target.is_tizen() and not target.is_pnacl():
+  #Build one binary per benchmark suite
+  includepaths = [ 'benchmark' ]
+  benchmark_lib = generator.lib( module = 'benchmark', basepath = 'benchmark', sources = [ 'benchmark.c' ], includepaths = includepaths )
+  benchmark_cases = [
+    'event', 'hash', 'hashmap', 'hashtable', 'io', 'memory', 'objectmap', 'radixsort', 'ringbuffer', 'scaling', 'string'
+  ]
+  for benchmark in benchmark_cases:
+    generator.bin( module = benchmark, sources = [ 'main.c' ], binname = 'benchmark-' + benchmark, basepath = 'benchmark', implicit_deps = [ foundation_lib, benchmark_lib ], libs = [ 'benchmark', 'foundation' ], includepaths = includepaths )
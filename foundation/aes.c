@@ -0,0 +1,675 @@
+/* aes.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define AES_NI 1
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define AES_TARGET_NI
+#  else
+#    define AES_TARGET_NI __attribute__((target("aes")))
+#  endif
+#elif defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+#  define AES_ARM 1
+#  include <arm_neon.h>
+#endif
+
+//Number of blocks processed per batch in modes without serial dependencies between blocks
+#define AES_BATCH_BLOCKS 16
+
+static const uint8_t _aes_sbox[256] = {
+	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
+	0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+	0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26,
+	0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+	0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2,
+	0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+	0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed,
+	0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+	0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f,
+	0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+	0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec,
+	0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+	0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14,
+	0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+	0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d,
+	0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+	0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f,
+	0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+	0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+	0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+	0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f,
+	0xb0, 0x54, 0xbb, 0x16
+};
+
+static const uint8_t _aes_sbox_inverse[256] = {
+	0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e,
+	0x81, 0xf3, 0xd7, 0xfb, 0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87,
+	0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb, 0x54, 0x7b, 0x94, 0x32,
+	0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+	0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49,
+	0x6d, 0x8b, 0xd1, 0x25, 0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16,
+	0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92, 0x6c, 0x70, 0x48, 0x50,
+	0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+	0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05,
+	0xb8, 0xb3, 0x45, 0x06, 0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02,
+	0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b, 0x3a, 0x91, 0x11, 0x41,
+	0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+	0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8,
+	0x1c, 0x75, 0xdf, 0x6e, 0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89,
+	0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b, 0xfc, 0x56, 0x3e, 0x4b,
+	0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+	0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59,
+	0x27, 0x80, 0xec, 0x5f, 0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d,
+	0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef, 0xa0, 0xe0, 0x3b, 0x4d,
+	0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+	0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63,
+	0x55, 0x21, 0x0c, 0x7d
+};
+
+static const uint32_t _aes_encrypt_table[256] = {
+	0xc66363a5U, 0xf87c7c84U, 0xee777799U, 0xf67b7b8dU, 0xfff2f20dU, 0xd66b6bbdU,
+	0xde6f6fb1U, 0x91c5c554U, 0x60303050U, 0x02010103U, 0xce6767a9U, 0x562b2b7dU,
+	0xe7fefe19U, 0xb5d7d762U, 0x4dababe6U, 0xec76769aU, 0x8fcaca45U, 0x1f82829dU,
+	0x89c9c940U, 0xfa7d7d87U, 0xeffafa15U, 0xb25959ebU, 0x8e4747c9U, 0xfbf0f00bU,
+	0x41adadecU, 0xb3d4d467U, 0x5fa2a2fdU, 0x45afafeaU, 0x239c9cbfU, 0x53a4a4f7U,
+	0xe4727296U, 0x9bc0c05bU, 0x75b7b7c2U, 0xe1fdfd1cU, 0x3d9393aeU, 0x4c26266aU,
+	0x6c36365aU, 0x7e3f3f41U, 0xf5f7f702U, 0x83cccc4fU, 0x6834345cU, 0x51a5a5f4U,
+	0xd1e5e534U, 0xf9f1f108U, 0xe2717193U, 0xabd8d873U, 0x62313153U, 0x2a15153fU,
+	0x0804040cU, 0x95c7c752U, 0x46232365U, 0x9dc3c35eU, 0x30181828U, 0x379696a1U,
+	0x0a05050fU, 0x2f9a9ab5U, 0x0e070709U, 0x24121236U, 0x1b80809bU, 0xdfe2e23dU,
+	0xcdebeb26U, 0x4e272769U, 0x7fb2b2cdU, 0xea75759fU, 0x1209091bU, 0x1d83839eU,
+	0x582c2c74U, 0x341a1a2eU, 0x361b1b2dU, 0xdc6e6eb2U, 0xb45a5aeeU, 0x5ba0a0fbU,
+	0xa45252f6U, 0x763b3b4dU, 0xb7d6d661U, 0x7db3b3ceU, 0x5229297bU, 0xdde3e33eU,
+	0x5e2f2f71U, 0x13848497U, 0xa65353f5U, 0xb9d1d168U, 0x00000000U, 0xc1eded2cU,
+	0x40202060U, 0xe3fcfc1fU, 0x79b1b1c8U, 0xb65b5bedU, 0xd46a6abeU, 0x8dcbcb46U,
+	0x67bebed9U, 0x7239394bU, 0x944a4adeU, 0x984c4cd4U, 0xb05858e8U, 0x85cfcf4aU,
+	0xbbd0d06bU, 0xc5efef2aU, 0x4faaaae5U, 0xedfbfb16U, 0x864343c5U, 0x9a4d4dd7U,
+	0x66333355U, 0x11858594U, 0x8a4545cfU, 0xe9f9f910U, 0x04020206U, 0xfe7f7f81U,
+	0xa05050f0U, 0x783c3c44U, 0x259f9fbaU, 0x4ba8a8e3U, 0xa25151f3U, 0x5da3a3feU,
+	0x804040c0U, 0x058f8f8aU, 0x3f9292adU, 0x219d9dbcU, 0x70383848U, 0xf1f5f504U,
+	0x63bcbcdfU, 0x77b6b6c1U, 0xafdada75U, 0x42212163U, 0x20101030U, 0xe5ffff1aU,
+	0xfdf3f30eU, 0xbfd2d26dU, 0x81cdcd4cU, 0x180c0c14U, 0x26131335U, 0xc3ecec2fU,
+	0xbe5f5fe1U, 0x359797a2U, 0x884444ccU, 0x2e171739U, 0x93c4c457U, 0x55a7a7f2U,
+	0xfc7e7e82U, 0x7a3d3d47U, 0xc86464acU, 0xba5d5de7U, 0x3219192bU, 0xe6737395U,
+	0xc06060a0U, 0x19818198U, 0x9e4f4fd1U, 0xa3dcdc7fU, 0x44222266U, 0x542a2a7eU,
+	0x3b9090abU, 0x0b888883U, 0x8c4646caU, 0xc7eeee29U, 0x6bb8b8d3U, 0x2814143cU,
+	0xa7dede79U, 0xbc5e5ee2U, 0x160b0b1dU, 0xaddbdb76U, 0xdbe0e03bU, 0x64323256U,
+	0x743a3a4eU, 0x140a0a1eU, 0x924949dbU, 0x0c06060aU, 0x4824246cU, 0xb85c5ce4U,
+	0x9fc2c25dU, 0xbdd3d36eU, 0x43acacefU, 0xc46262a6U, 0x399191a8U, 0x319595a4U,
+	0xd3e4e437U, 0xf279798bU, 0xd5e7e732U, 0x8bc8c843U, 0x6e373759U, 0xda6d6db7U,
+	0x018d8d8cU, 0xb1d5d564U, 0x9c4e4ed2U, 0x49a9a9e0U, 0xd86c6cb4U, 0xac5656faU,
+	0xf3f4f407U, 0xcfeaea25U, 0xca6565afU, 0xf47a7a8eU, 0x47aeaee9U, 0x10080818U,
+	0x6fbabad5U, 0xf0787888U, 0x4a25256fU, 0x5c2e2e72U, 0x381c1c24U, 0x57a6a6f1U,
+	0x73b4b4c7U, 0x97c6c651U, 0xcbe8e823U, 0xa1dddd7cU, 0xe874749cU, 0x3e1f1f21U,
+	0x964b4bddU, 0x61bdbddcU, 0x0d8b8b86U, 0x0f8a8a85U, 0xe0707090U, 0x7c3e3e42U,
+	0x71b5b5c4U, 0xcc6666aaU, 0x904848d8U, 0x06030305U, 0xf7f6f601U, 0x1c0e0e12U,
+	0xc26161a3U, 0x6a35355fU, 0xae5757f9U, 0x69b9b9d0U, 0x17868691U, 0x99c1c158U,
+	0x3a1d1d27U, 0x279e9eb9U, 0xd9e1e138U, 0xebf8f813U, 0x2b9898b3U, 0x22111133U,
+	0xd26969bbU, 0xa9d9d970U, 0x078e8e89U, 0x339494a7U, 0x2d9b9bb6U, 0x3c1e1e22U,
+	0x15878792U, 0xc9e9e920U, 0x87cece49U, 0xaa5555ffU, 0x50282878U, 0xa5dfdf7aU,
+	0x038c8c8fU, 0x59a1a1f8U, 0x09898980U, 0x1a0d0d17U, 0x65bfbfdaU, 0xd7e6e631U,
+	0x844242c6U, 0xd06868b8U, 0x824141c3U, 0x299999b0U, 0x5a2d2d77U, 0x1e0f0f11U,
+	0x7bb0b0cbU, 0xa85454fcU, 0x6dbbbbd6U, 0x2c16163aU
+};
+
+static const uint32_t _aes_decrypt_table[256] = {
+	0x51f4a750U, 0x7e416553U, 0x1a17a4c3U, 0x3a275e96U, 0x3bab6bcbU, 0x1f9d45f1U,
+	0xacfa58abU, 0x4be30393U, 0x2030fa55U, 0xad766df6U, 0x88cc7691U, 0xf5024c25U,
+	0x4fe5d7fcU, 0xc52acbd7U, 0x26354480U, 0xb562a38fU, 0xdeb15a49U, 0x25ba1b67U,
+	0x45ea0e98U, 0x5dfec0e1U, 0xc32f7502U, 0x814cf012U, 0x8d4697a3U, 0x6bd3f9c6U,
+	0x038f5fe7U, 0x15929c95U, 0xbf6d7aebU, 0x955259daU, 0xd4be832dU, 0x587421d3U,
+	0x49e06929U, 0x8ec9c844U, 0x75c2896aU, 0xf48e7978U, 0x99583e6bU, 0x27b971ddU,
+	0xbee14fb6U, 0xf088ad17U, 0xc920ac66U, 0x7dce3ab4U, 0x63df4a18U, 0xe51a3182U,
+	0x97513360U, 0x62537f45U, 0xb16477e0U, 0xbb6bae84U, 0xfe81a01cU, 0xf9082b94U,
+	0x70486858U, 0x8f45fd19U, 0x94de6c87U, 0x527bf8b7U, 0xab73d323U, 0x724b02e2U,
+	0xe31f8f57U, 0x6655ab2aU, 0xb2eb2807U, 0x2fb5c203U, 0x86c57b9aU, 0xd33708a5U,
+	0x302887f2U, 0x23bfa5b2U, 0x02036abaU, 0xed16825cU, 0x8acf1c2bU, 0xa779b492U,
+	0xf307f2f0U, 0x4e69e2a1U, 0x65daf4cdU, 0x0605bed5U, 0xd134621fU, 0xc4a6fe8aU,
+	0x342e539dU, 0xa2f355a0U, 0x058ae132U, 0xa4f6eb75U, 0x0b83ec39U, 0x4060efaaU,
+	0x5e719f06U, 0xbd6e1051U, 0x3e218af9U, 0x96dd063dU, 0xdd3e05aeU, 0x4de6bd46U,
+	0x91548db5U, 0x71c45d05U, 0x0406d46fU, 0x605015ffU, 0x1998fb24U, 0xd6bde997U,
+	0x894043ccU, 0x67d99e77U, 0xb0e842bdU, 0x07898b88U, 0xe7195b38U, 0x79c8eedbU,
+	0xa17c0a47U, 0x7c420fe9U, 0xf8841ec9U, 0x00000000U, 0x09808683U, 0x322bed48U,
+	0x1e1170acU, 0x6c5a724eU, 0xfd0efffbU, 0x0f853856U, 0x3daed51eU, 0x362d3927U,
+	0x0a0fd964U, 0x685ca621U, 0x9b5b54d1U, 0x24362e3aU, 0x0c0a67b1U, 0x9357e70fU,
+	0xb4ee96d2U, 0x1b9b919eU, 0x80c0c54fU, 0x61dc20a2U, 0x5a774b69U, 0x1c121a16U,
+	0xe293ba0aU, 0xc0a02ae5U, 0x3c22e043U, 0x121b171dU, 0x0e090d0bU, 0xf28bc7adU,
+	0x2db6a8b9U, 0x141ea9c8U, 0x57f11985U, 0xaf75074cU, 0xee99ddbbU, 0xa37f60fdU,
+	0xf701269fU, 0x5c72f5bcU, 0x44663bc5U, 0x5bfb7e34U, 0x8b432976U, 0xcb23c6dcU,
+	0xb6edfc68U, 0xb8e4f163U, 0xd731dccaU, 0x42638510U, 0x13972240U, 0x84c61120U,
+	0x854a247dU, 0xd2bb3df8U, 0xaef93211U, 0xc729a16dU, 0x1d9e2f4bU, 0xdcb230f3U,
+	0x0d8652ecU, 0x77c1e3d0U, 0x2bb3166cU, 0xa970b999U, 0x119448faU, 0x47e96422U,
+	0xa8fc8cc4U, 0xa0f03f1aU, 0x567d2cd8U, 0x223390efU, 0x87494ec7U, 0xd938d1c1U,
+	0x8ccaa2feU, 0x98d40b36U, 0xa6f581cfU, 0xa57ade28U, 0xdab78e26U, 0x3fadbfa4U,
+	0x2c3a9de4U, 0x5078920dU, 0x6a5fcc9bU, 0x547e4662U, 0xf68d13c2U, 0x90d8b8e8U,
+	0x2e39f75eU, 0x82c3aff5U, 0x9f5d80beU, 0x69d0937cU, 0x6fd52da9U, 0xcf2512b3U,
+	0xc8ac993bU, 0x10187da7U, 0xe89c636eU, 0xdb3bbb7bU, 0xcd267809U, 0x6e5918f4U,
+	0xec9ab701U, 0x834f9aa8U, 0xe6956e65U, 0xaaffe67eU, 0x21bccf08U, 0xef15e8e6U,
+	0xbae79bd9U, 0x4a6f36ceU, 0xea9f09d4U, 0x29b07cd6U, 0x31a4b2afU, 0x2a3f2331U,
+	0xc6a59430U, 0x35a266c0U, 0x744ebc37U, 0xfc82caa6U, 0xe090d0b0U, 0x33a7d815U,
+	0xf104984aU, 0x41ecdaf7U, 0x7fcd500eU, 0x1791f62fU, 0x764dd68dU, 0x43efb04dU,
+	0xccaa4d54U, 0xe49604dfU, 0x9ed1b5e3U, 0x4c6a881bU, 0xc12c1fb8U, 0x4665517fU,
+	0x9d5eea04U, 0x018c355dU, 0xfa877473U, 0xfb0b412eU, 0xb3671d5aU, 0x92dbd252U,
+	0xe9105633U, 0x6dd64713U, 0x9ad7618cU, 0x37a10c7aU, 0x59f8148eU, 0xeb133c89U,
+	0xcea927eeU, 0xb761c935U, 0xe11ce5edU, 0x7a47b13cU, 0x9cd2df59U, 0x55f2733fU,
+	0x1814ce79U, 0x73c737bfU, 0x53f7cdeaU, 0x5ffdaa5bU, 0xdf3d6f14U, 0x7844db86U,
+	0xcaaff381U, 0xb968c43eU, 0x3824342cU, 0xc2a3405fU, 0x161dc372U, 0xbce2250cU,
+	0x283c498bU, 0xff0d9541U, 0x39a80171U, 0x080cb3deU, 0xd8b4e49cU, 0x6456c190U,
+	0x7bcb8461U, 0xd532b670U, 0x486c5c74U, 0xd0b85742U
+};
+
+#define AES_LOAD32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                       ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define AES_ROTR(x, n) (((x) >> (n)) | ((x) << ((32 - (n)) & 31)))
+#define AES_TE(i, x) AES_ROTR(_aes_encrypt_table[(x) & 0xFF], (i) * 8)
+#define AES_TD(i, x) AES_ROTR(_aes_decrypt_table[(x) & 0xFF], (i) * 8)
+#define AES_SUBWORD(x) (((uint32_t)_aes_sbox[(x) >> 24] << 24) | \
+                        ((uint32_t)_aes_sbox[((x) >> 16) & 0xFF] << 16) | \
+                        ((uint32_t)_aes_sbox[((x) >> 8) & 0xFF] << 8) | \
+                        (uint32_t)_aes_sbox[(x) & 0xFF])
+
+static void
+aes_store32(uint8_t* dest, uint32_t value) {
+	dest[0] = (uint8_t)(value >> 24);
+	dest[1] = (uint8_t)(value >> 16);
+	dest[2] = (uint8_t)(value >> 8);
+	dest[3] = (uint8_t)value;
+}
+
+static void
+aes_encrypt_blocks_software(const aes_t* aes, uint8_t* blocks, size_t count) {
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	unsigned int round;
+	const uint8_t* key;
+
+	for (; count; --count, blocks += AES_BLOCKSIZE) {
+		key = aes->encrypt_keys[0];
+		s0 = AES_LOAD32(blocks) ^ AES_LOAD32(key);
+		s1 = AES_LOAD32(blocks + 4) ^ AES_LOAD32(key + 4);
+		s2 = AES_LOAD32(blocks + 8) ^ AES_LOAD32(key + 8);
+		s3 = AES_LOAD32(blocks + 12) ^ AES_LOAD32(key + 12);
+		for (round = 1; round < aes->rounds; ++round) {
+			key = aes->encrypt_keys[round];
+			t0 = AES_TE(0, s0 >> 24) ^ AES_TE(1, s1 >> 16) ^ AES_TE(2, s2 >> 8) ^ AES_TE(3, s3) ^
+			     AES_LOAD32(key);
+			t1 = AES_TE(0, s1 >> 24) ^ AES_TE(1, s2 >> 16) ^ AES_TE(2, s3 >> 8) ^ AES_TE(3, s0) ^
+			     AES_LOAD32(key + 4);
+			t2 = AES_TE(0, s2 >> 24) ^ AES_TE(1, s3 >> 16) ^ AES_TE(2, s0 >> 8) ^ AES_TE(3, s1) ^
+			     AES_LOAD32(key + 8);
+			t3 = AES_TE(0, s3 >> 24) ^ AES_TE(1, s0 >> 16) ^ AES_TE(2, s1 >> 8) ^ AES_TE(3, s2) ^
+			     AES_LOAD32(key + 12);
+			s0 = t0;
+			s1 = t1;
+			s2 = t2;
+			s3 = t3;
+		}
+		//Final round without column mixing
+		key = aes->encrypt_keys[aes->rounds];
+		t0 = ((uint32_t)_aes_sbox[s0 >> 24] << 24) | ((uint32_t)_aes_sbox[(s1 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox[(s2 >> 8) & 0xFF] << 8) | (uint32_t)_aes_sbox[s3 & 0xFF];
+		t1 = ((uint32_t)_aes_sbox[s1 >> 24] << 24) | ((uint32_t)_aes_sbox[(s2 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox[(s3 >> 8) & 0xFF] << 8) | (uint32_t)_aes_sbox[s0 & 0xFF];
+		t2 = ((uint32_t)_aes_sbox[s2 >> 24] << 24) | ((uint32_t)_aes_sbox[(s3 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox[(s0 >> 8) & 0xFF] << 8) | (uint32_t)_aes_sbox[s1 & 0xFF];
+		t3 = ((uint32_t)_aes_sbox[s3 >> 24] << 24) | ((uint32_t)_aes_sbox[(s0 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox[(s1 >> 8) & 0xFF] << 8) | (uint32_t)_aes_sbox[s2 & 0xFF];
+		aes_store32(blocks, t0 ^ AES_LOAD32(key));
+		aes_store32(blocks + 4, t1 ^ AES_LOAD32(key + 4));
+		aes_store32(blocks + 8, t2 ^ AES_LOAD32(key + 8));
+		aes_store32(blocks + 12, t3 ^ AES_LOAD32(key + 12));
+	}
+}
+
+static void
+aes_decrypt_blocks_software(const aes_t* aes, uint8_t* blocks, size_t count) {
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	unsigned int round;
+	const uint8_t* key;
+
+	for (; count; --count, blocks += AES_BLOCKSIZE) {
+		key = aes->decrypt_keys[0];
+		s0 = AES_LOAD32(blocks) ^ AES_LOAD32(key);
+		s1 = AES_LOAD32(blocks + 4) ^ AES_LOAD32(key + 4);
+		s2 = AES_LOAD32(blocks + 8) ^ AES_LOAD32(key + 8);
+		s3 = AES_LOAD32(blocks + 12) ^ AES_LOAD32(key + 12);
+		for (round = 1; round < aes->rounds; ++round) {
+			key = aes->decrypt_keys[round];
+			t0 = AES_TD(0, s0 >> 24) ^ AES_TD(1, s3 >> 16) ^ AES_TD(2, s2 >> 8) ^ AES_TD(3, s1) ^
+			     AES_LOAD32(key);
+			t1 = AES_TD(0, s1 >> 24) ^ AES_TD(1, s0 >> 16) ^ AES_TD(2, s3 >> 8) ^ AES_TD(3, s2) ^
+			     AES_LOAD32(key + 4);
+			t2 = AES_TD(0, s2 >> 24) ^ AES_TD(1, s1 >> 16) ^ AES_TD(2, s0 >> 8) ^ AES_TD(3, s3) ^
+			     AES_LOAD32(key + 8);
+			t3 = AES_TD(0, s3 >> 24) ^ AES_TD(1, s2 >> 16) ^ AES_TD(2, s1 >> 8) ^ AES_TD(3, s0) ^
+			     AES_LOAD32(key + 12);
+			s0 = t0;
+			s1 = t1;
+			s2 = t2;
+			s3 = t3;
+		}
+		key = aes->decrypt_keys[aes->rounds];
+		t0 = ((uint32_t)_aes_sbox_inverse[s0 >> 24] << 24) |
+		     ((uint32_t)_aes_sbox_inverse[(s3 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox_inverse[(s2 >> 8) & 0xFF] << 8) |
+		     (uint32_t)_aes_sbox_inverse[s1 & 0xFF];
+		t1 = ((uint32_t)_aes_sbox_inverse[s1 >> 24] << 24) |
+		     ((uint32_t)_aes_sbox_inverse[(s0 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox_inverse[(s3 >> 8) & 0xFF] << 8) |
+		     (uint32_t)_aes_sbox_inverse[s2 & 0xFF];
+		t2 = ((uint32_t)_aes_sbox_inverse[s2 >> 24] << 24) |
+		     ((uint32_t)_aes_sbox_inverse[(s1 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox_inverse[(s0 >> 8) & 0xFF] << 8) |
+		     (uint32_t)_aes_sbox_inverse[s3 & 0xFF];
+		t3 = ((uint32_t)_aes_sbox_inverse[s3 >> 24] << 24) |
+		     ((uint32_t)_aes_sbox_inverse[(s2 >> 16) & 0xFF] << 16) |
+		     ((uint32_t)_aes_sbox_inverse[(s1 >> 8) & 0xFF] << 8) |
+		     (uint32_t)_aes_sbox_inverse[s0 & 0xFF];
+		aes_store32(blocks, t0 ^ AES_LOAD32(key));
+		aes_store32(blocks + 4, t1 ^ AES_LOAD32(key + 4));
+		aes_store32(blocks + 8, t2 ^ AES_LOAD32(key + 8));
+		aes_store32(blocks + 12, t3 ^ AES_LOAD32(key + 12));
+	}
+}
+
+#if AES_NI
+
+static int _aes_hardware = -1;
+
+static bool
+aes_hardware_supported(void) {
+	if (_aes_hardware < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		__cpuid(info, 1);
+		_aes_hardware = (info[2] & (1 << 25)) ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		_aes_hardware = __builtin_cpu_supports("aes") ? 1 : 0;
+#endif
+	}
+	return _aes_hardware > 0;
+}
+
+//Blocks are processed eight at a time to hide the latency of the round instructions
+static AES_TARGET_NI void
+aes_encrypt_blocks_hardware(const aes_t* aes, uint8_t* blocks, size_t count) {
+	const unsigned int rounds = aes->rounds;
+	__m128i block[8];
+	__m128i key;
+	unsigned int round;
+	size_t iblock, batch;
+
+	while (count) {
+		batch = (count < 8) ? count : 8;
+		key = _mm_loadu_si128((const __m128i*)(const void*)aes->encrypt_keys[0]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			block[iblock] = _mm_xor_si128(key, _mm_loadu_si128((const __m128i*)(const void*)(
+			                                blocks + (iblock * AES_BLOCKSIZE))));
+		for (round = 1; round < rounds; ++round) {
+			key = _mm_loadu_si128((const __m128i*)(const void*)aes->encrypt_keys[round]);
+			for (iblock = 0; iblock < batch; ++iblock)
+				block[iblock] = _mm_aesenc_si128(block[iblock], key);
+		}
+		key = _mm_loadu_si128((const __m128i*)(const void*)aes->encrypt_keys[rounds]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			_mm_storeu_si128((__m128i*)(void*)(blocks + (iblock * AES_BLOCKSIZE)),
+			                 _mm_aesenclast_si128(block[iblock], key));
+		blocks += batch * AES_BLOCKSIZE;
+		count -= batch;
+	}
+}
+
+static AES_TARGET_NI void
+aes_decrypt_blocks_hardware(const aes_t* aes, uint8_t* blocks, size_t count) {
+	const unsigned int rounds = aes->rounds;
+	__m128i block[8];
+	__m128i key;
+	unsigned int round;
+	size_t iblock, batch;
+
+	while (count) {
+		batch = (count < 8) ? count : 8;
+		key = _mm_loadu_si128((const __m128i*)(const void*)aes->decrypt_keys[0]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			block[iblock] = _mm_xor_si128(key, _mm_loadu_si128((const __m128i*)(const void*)(
+			                                blocks + (iblock * AES_BLOCKSIZE))));
+		for (round = 1; round < rounds; ++round) {
+			key = _mm_loadu_si128((const __m128i*)(const void*)aes->decrypt_keys[round]);
+			for (iblock = 0; iblock < batch; ++iblock)
+				block[iblock] = _mm_aesdec_si128(block[iblock], key);
+		}
+		key = _mm_loadu_si128((const __m128i*)(const void*)aes->decrypt_keys[rounds]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			_mm_storeu_si128((__m128i*)(void*)(blocks + (iblock * AES_BLOCKSIZE)),
+			                 _mm_aesdeclast_si128(block[iblock], key));
+		blocks += batch * AES_BLOCKSIZE;
+		count -= batch;
+	}
+}
+
+#elif AES_ARM
+
+static bool
+aes_hardware_supported(void) {
+	return true;
+}
+
+//The AESE/AESD instructions add the round key before substitution, shifting the key
+//schedule by one round compared to the x86 instructions
+static void
+aes_encrypt_blocks_hardware(const aes_t* aes, uint8_t* blocks, size_t count) {
+	const unsigned int rounds = aes->rounds;
+	uint8x16_t block[8];
+	uint8x16_t key;
+	unsigned int round;
+	size_t iblock, batch;
+
+	while (count) {
+		batch = (count < 8) ? count : 8;
+		for (iblock = 0; iblock < batch; ++iblock)
+			block[iblock] = vld1q_u8(blocks + (iblock * AES_BLOCKSIZE));
+		for (round = 0; round < rounds - 1; ++round) {
+			key = vld1q_u8(aes->encrypt_keys[round]);
+			for (iblock = 0; iblock < batch; ++iblock)
+				block[iblock] = vaesmcq_u8(vaeseq_u8(block[iblock], key));
+		}
+		key = vld1q_u8(aes->encrypt_keys[rounds - 1]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			vst1q_u8(blocks + (iblock * AES_BLOCKSIZE),
+			         veorq_u8(vaeseq_u8(block[iblock], key), vld1q_u8(aes->encrypt_keys[rounds])));
+		blocks += batch * AES_BLOCKSIZE;
+		count -= batch;
+	}
+}
+
+static void
+aes_decrypt_blocks_hardware(const aes_t* aes, uint8_t* blocks, size_t count) {
+	const unsigned int rounds = aes->rounds;
+	uint8x16_t block[8];
+	uint8x16_t key;
+	unsigned int round;
+	size_t iblock, batch;
+
+	while (count) {
+		batch = (count < 8) ? count : 8;
+		for (iblock = 0; iblock < batch; ++iblock)
+			block[iblock] = vld1q_u8(blocks + (iblock * AES_BLOCKSIZE));
+		for (round = 0; round < rounds - 1; ++round) {
+			key = vld1q_u8(aes->decrypt_keys[round]);
+			for (iblock = 0; iblock < batch; ++iblock)
+				block[iblock] = vaesimcq_u8(vaesdq_u8(block[iblock], key));
+		}
+		key = vld1q_u8(aes->decrypt_keys[rounds - 1]);
+		for (iblock = 0; iblock < batch; ++iblock)
+			vst1q_u8(blocks + (iblock * AES_BLOCKSIZE),
+			         veorq_u8(vaesdq_u8(block[iblock], key), vld1q_u8(aes->decrypt_keys[rounds])));
+		blocks += batch * AES_BLOCKSIZE;
+		count -= batch;
+	}
+}
+
+#endif
+
+static void
+aes_encrypt_blocks(const aes_t* aes, uint8_t* blocks, size_t count) {
+#if AES_NI || AES_ARM
+	if (aes_hardware_supported()) {
+		aes_encrypt_blocks_hardware(aes, blocks, count);
+		return;
+	}
+#endif
+	aes_encrypt_blocks_software(aes, blocks, count);
+}
+
+static void
+aes_decrypt_blocks(const aes_t* aes, uint8_t* blocks, size_t count) {
+#if AES_NI || AES_ARM
+	if (aes_hardware_supported()) {
+		aes_decrypt_blocks_hardware(aes, blocks, count);
+		return;
+	}
+#endif
+	aes_decrypt_blocks_software(aes, blocks, count);
+}
+
+static void
+aes_xor(uint8_t* FOUNDATION_RESTRICT dest, const uint8_t* FOUNDATION_RESTRICT source,
+        size_t size) {
+	uint64_t dval, sval;
+	for (; size >= 8; size -= 8, dest += 8, source += 8) {
+		memcpy(&dval, dest, 8);
+		memcpy(&sval, source, 8);
+		dval ^= sval;
+		memcpy(dest, &dval, 8);
+	}
+	for (; size; --size)
+		*dest++ ^= *source++;
+}
+
+static void
+aes_store_vector(uint8_t* block, uint128_t vec) {
+	uint64_t high = byteorder_bigendian64(vec.word[1]);
+	uint64_t low = byteorder_bigendian64(vec.word[0]);
+	memcpy(block, &high, 8);
+	memcpy(block + 8, &low, 8);
+}
+
+static void
+aes_counter(const aes_t* aes, uint8_t* data, size_t length, uint128_t counter) {
+	uint8_t stream[AES_BATCH_BLOCKS * AES_BLOCKSIZE];
+	size_t iblock, count, size;
+
+	while (length) {
+		count = (length + (AES_BLOCKSIZE - 1)) / AES_BLOCKSIZE;
+		if (count > AES_BATCH_BLOCKS)
+			count = AES_BATCH_BLOCKS;
+		for (iblock = 0; iblock < count; ++iblock) {
+			aes_store_vector(stream + (iblock * AES_BLOCKSIZE), counter);
+			if (!++counter.word[0])
+				++counter.word[1];
+		}
+		aes_encrypt_blocks(aes, stream, count);
+		size = (length < count * AES_BLOCKSIZE) ? length : (count * AES_BLOCKSIZE);
+		aes_xor(data, stream, size);
+		data += size;
+		length -= size;
+	}
+
+	//Reset memory for paranoids
+	memset(stream, 0, sizeof(stream));
+}
+
+aes_t*
+aes_allocate(void) {
+	return memory_allocate(0, sizeof(aes_t), 0U, MEMORY_PERSISTENT);
+}
+
+void
+aes_deallocate(aes_t* aes) {
+	aes_finalize(aes);
+	memory_deallocate(aes);
+}
+
+void
+aes_initialize(aes_t* aes, const void* key, size_t length) {
+	uint32_t words[4 * (AES_MAXROUNDS + 1)];
+	uint8_t padded[32];
+	size_t keywords, total, iword;
+	unsigned int round;
+	uint32_t temp, rcon = 1;
+
+	if (length > sizeof(padded))
+		length = sizeof(padded);
+	keywords = (length <= 16) ? 4 : ((length <= 24) ? 6 : 8);
+	memset(padded, 0, sizeof(padded));
+	if (length)
+		memcpy(padded, key, length);
+
+	aes->rounds = (unsigned int)keywords + 6;
+	total = 4 * (aes->rounds + 1);
+
+	for (iword = 0; iword < keywords; ++iword)
+		words[iword] = AES_LOAD32(padded + (iword * 4));
+	for (; iword < total; ++iword) {
+		temp = words[iword - 1];
+		if (!(iword % keywords)) {
+			temp = AES_SUBWORD((temp << 8) | (temp >> 24)) ^ (rcon << 24);
+			rcon = ((rcon << 1) ^ ((rcon & 0x80) ? 0x1b : 0)) & 0xFF;
+		}
+		else if ((keywords > 6) && ((iword % keywords) == 4)) {
+			temp = AES_SUBWORD(temp);
+		}
+		words[iword] = words[iword - keywords] ^ temp;
+	}
+
+	for (iword = 0; iword < total; ++iword)
+		aes_store32(aes->encrypt_keys[iword / 4] + ((iword % 4) * 4), words[iword]);
+
+	//Equivalent inverse cipher uses the round keys in reverse order with inverse column
+	//mixing applied to all but the first and last round key
+	memcpy(aes->decrypt_keys[0], aes->encrypt_keys[aes->rounds], AES_BLOCKSIZE);
+	memcpy(aes->decrypt_keys[aes->rounds], aes->encrypt_keys[0], AES_BLOCKSIZE);
+	for (round = 1; round < aes->rounds; ++round) {
+		for (iword = 0; iword < 4; ++iword) {
+			temp = words[((aes->rounds - round) * 4) + iword];
+			temp = AES_TD(0, _aes_sbox[temp >> 24]) ^ AES_TD(1, _aes_sbox[(temp >> 16) & 0xFF]) ^
+			       AES_TD(2, _aes_sbox[(temp >> 8) & 0xFF]) ^ AES_TD(3, _aes_sbox[temp & 0xFF]);
+			aes_store32(aes->decrypt_keys[round] + (iword * 4), temp);
+		}
+	}
+
+	//Reset memory for paranoids
+	memset(words, 0, sizeof(words));
+	memset(padded, 0, sizeof(padded));
+}
+
+void
+aes_finalize(aes_t* aes) {
+	if (aes)
+		memset(aes, 0, sizeof(aes_t));
+}
+
+void
+aes_encrypt(const aes_t* aes, void* data, size_t length, blockcipher_mode_t mode,
+            uint128_t vec) {
+	uint8_t* FOUNDATION_RESTRICT cur = data;
+	uint8_t chain[AES_BLOCKSIZE];
+	size_t blocks = length / AES_BLOCKSIZE;
+
+	if (!data || !(blocks || ((mode == BLOCKCIPHER_CTR) && length)))
+		return;
+
+	aes_store_vector(chain, vec);
+
+	switch (mode) {
+	default:
+	case BLOCKCIPHER_ECB:
+		aes_encrypt_blocks(aes, cur, blocks);
+		break;
+
+	case BLOCKCIPHER_CBC:
+		for (; blocks; --blocks, cur += AES_BLOCKSIZE) {
+			aes_xor(cur, chain, AES_BLOCKSIZE);
+			aes_encrypt_blocks(aes, cur, 1);
+			memcpy(chain, cur, AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_CFB:
+		for (; blocks; --blocks, cur += AES_BLOCKSIZE) {
+			aes_encrypt_blocks(aes, chain, 1);
+			aes_xor(cur, chain, AES_BLOCKSIZE);
+			memcpy(chain, cur, AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_OFB:
+		for (; blocks; --blocks, cur += AES_BLOCKSIZE) {
+			aes_encrypt_blocks(aes, chain, 1);
+			aes_xor(cur, chain, AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_CTR:
+		aes_counter(aes, cur, length, vec);
+		break;
+	}
+
+	//Reset memory for paranoids
+	memset(chain, 0, sizeof(chain));
+}
+
+void
+aes_decrypt(const aes_t* aes, void* data, size_t length, blockcipher_mode_t mode,
+            uint128_t vec) {
+	uint8_t* FOUNDATION_RESTRICT cur = data;
+	uint8_t chain[AES_BLOCKSIZE];
+	uint8_t batch[AES_BATCH_BLOCKS * AES_BLOCKSIZE];
+	size_t blocks = length / AES_BLOCKSIZE;
+	size_t count;
+
+	if (!data || !(blocks || ((mode == BLOCKCIPHER_CTR) && length)))
+		return;
+
+	aes_store_vector(chain, vec);
+
+	switch (mode) {
+	default:
+	case BLOCKCIPHER_ECB:
+		aes_decrypt_blocks(aes, cur, blocks);
+		break;
+
+	case BLOCKCIPHER_CBC:
+		//Blocks only depend on the previous ciphertext, decrypt in parallel batches
+		for (; blocks; blocks -= count, cur += count * AES_BLOCKSIZE) {
+			count = (blocks < AES_BATCH_BLOCKS) ? blocks : AES_BATCH_BLOCKS;
+			memcpy(batch, chain, AES_BLOCKSIZE);
+			memcpy(batch + AES_BLOCKSIZE, cur, (count - 1) * AES_BLOCKSIZE);
+			memcpy(chain, cur + ((count - 1) * AES_BLOCKSIZE), AES_BLOCKSIZE);
+			aes_decrypt_blocks(aes, cur, count);
+			aes_xor(cur, batch, count * AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_CFB:
+		//Keystream is the encrypted previous ciphertext, encrypt in parallel batches
+		for (; blocks; blocks -= count, cur += count * AES_BLOCKSIZE) {
+			count = (blocks < AES_BATCH_BLOCKS) ? blocks : AES_BATCH_BLOCKS;
+			memcpy(batch, chain, AES_BLOCKSIZE);
+			memcpy(batch + AES_BLOCKSIZE, cur, (count - 1) * AES_BLOCKSIZE);
+			memcpy(chain, cur + ((count - 1) * AES_BLOCKSIZE), AES_BLOCKSIZE);
+			aes_encrypt_blocks(aes, batch, count);
+			aes_xor(cur, batch, count * AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_OFB:
+		for (; blocks; --blocks, cur += AES_BLOCKSIZE) {
+			aes_encrypt_blocks(aes, chain, 1);
+			aes_xor(cur, chain, AES_BLOCKSIZE);
+		}
+		break;
+
+	case BLOCKCIPHER_CTR:
+		aes_counter(aes, cur, length, vec);
+		break;
+	}
+
+	//Reset memory for paranoids
+	memset(chain, 0, sizeof(chain));
+	memset(batch, 0, sizeof(batch));
+}
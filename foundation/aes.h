@@ -0,0 +1,88 @@
+/* aes.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file aes.h
+\brief AES encryption and decryption
+
+AES (Rijndael) encryption and decryption with 128, 192 or 256 bit keys (FIPS-197). Blocks
+are processed with the AES instructions on x86 processors and the cryptography extensions
+on ARMv8 processors if available, with a portable table based implementation used otherwise.
+The API mirrors the blowfish API, using 16 byte blocks.
+
+Modes without serial dependencies between blocks (ECB, counter mode, and CBC and CFB
+decryption) process several blocks in parallel. Counter mode is recommended for bulk data,
+since each block only depends on its own counter value the data can also be split in parts
+processed independently, for example by multiple threads.
+
+The AES state is not modified by encryption or decryption and can be used concurrently by
+multiple threads once initialized. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate an AES state object. Does NOT initialize the object, must
+be done with a call to #aes_initialize before using the object for
+encryption/decryption.
+\return  New AES state object */
+FOUNDATION_API aes_t*
+aes_allocate(void);
+
+/*! Deallocate an AES state object and free resources
+\param aes AES state object to deallocate */
+FOUNDATION_API void
+aes_deallocate(aes_t* aes);
+
+/*! Initialize the AES state object with the given key data. Keys of 16, 24 or 32 bytes
+select AES-128, AES-192 or AES-256. Shorter keys are zero padded to the next of these
+lengths and keys longer than 32 bytes are truncated.
+\param aes    AES state object
+\param key    Key data
+\param length Length of key data in bytes */
+FOUNDATION_API void
+aes_initialize(aes_t* aes, const void* key, size_t length);
+
+/*! Finalize an AES state object, clearing the key schedule
+\param aes AES state object to finalize */
+FOUNDATION_API void
+aes_finalize(aes_t* aes);
+
+/*! Encrypt data using the given AES state object. Encryption is done in-place,
+no memory allocation is done internally. Length is expected to be a multiple of 16
+bytes (any extra unaligned data will be ignored), except in counter mode where a final
+partial block is also processed.
+\param aes    AES state object
+\param data   Data buffer
+\param length Length of data buffer in bytes
+\param mode   Mode of operation (see #blockcipher_mode_t)
+\param vec    Initialization vector as a 128-bit big endian number, the high 64 bits
+              holding the first 8 bytes of the block. In counter mode this is the counter
+              of the first block, incremented by one for each block. Data can be split in
+              parts at 16 byte boundaries and processed independently by passing vec plus
+              the block index of the start of each part */
+FOUNDATION_API void
+aes_encrypt(const aes_t* aes, void* data, size_t length, blockcipher_mode_t mode,
+            uint128_t vec);
+
+/*! Decrypt data using the given AES state object. Decryption is done in-place,
+no memory allocation is done internally. Length is expected to be a multiple of 16
+bytes (any extra unaligned data will be ignored), except in counter mode where a final
+partial block is also processed.
+\param aes    AES state object
+\param data   Data buffer
+\param length Length of data buffer in bytes
+\param mode   Mode of operation (see #blockcipher_mode_t)
+\param vec    Initialization vector, see #aes_encrypt */
+FOUNDATION_API void
+aes_decrypt(const aes_t* aes, void* data, size_t length, blockcipher_mode_t mode,
+            uint128_t vec);
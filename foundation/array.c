@@ -12,6 +12,12 @@
 
 #include <foundation/foundation.h>
 
+#if FOUNDATION_ARCH_SSE2
+#  include <emmintrin.h>
+#elif FOUNDATION_ARCH_NEON
+#  include <arm_neon.h>
+#endif
+
 //'FARR' in ascii
 static const uint32_t ARRAY_WATERMARK = 0x52524145U;
 static const unsigned int ARRAY_DEFAULT_ALIGN = 16U;
@@ -40,18 +46,46 @@ _array_resizefn(void** arr, size_t elements, size_t itemsize) {
 	return *arr;
 }
 
+#define ARRAY_ALLOCATOR_PREFIX 16U
+
+static array_allocator_t*
+_array_allocator(void* arr) {
+	return *(array_allocator_t**)pointer_offset(_array_raw(arr), -(ssize_t)ARRAY_ALLOCATOR_PREFIX);
+}
+
 void*
 _array_growfn(void** arr, size_t increment, size_t factor, size_t itemsize) {
+	array_allocator_t* allocator = (*arr && (_array_rawelementsize(*arr) & _array_allocator_flag)) ?
+		_array_allocator(*arr) : nullptr;
+	size_t growth = (allocator && allocator->factor && (factor > 1)) ? allocator->factor : factor;
 	size_t prev_capacity = *arr ? _array_rawcapacity(*arr) : 0;
-	size_t capacity = *arr ? (factor * prev_capacity + increment) : increment;
+	size_t capacity = *arr ? (growth * prev_capacity + increment) : increment;
 	size_t prev_storage_size = itemsize * prev_capacity;
 	size_t storage_size = itemsize * capacity;
 	size_t header_size = 4U * _array_header_size;
 	size_t prev_used_buffer_size = prev_storage_size + header_size;
 	size_t buffer_size = storage_size + header_size;
-	uint32_t* buffer = *arr ?
-		memory_reallocate(_array_raw(*arr), buffer_size, ARRAY_DEFAULT_ALIGN, prev_used_buffer_size) :
-		memory_allocate(0, buffer_size, ARRAY_DEFAULT_ALIGN, MEMORY_PERSISTENT);
+	uint32_t* buffer;
+	if (allocator) {
+		void* block = allocator->reallocate(allocator,
+		                                    pointer_offset(_array_raw(*arr), -(ssize_t)ARRAY_ALLOCATOR_PREFIX),
+		                                    buffer_size + ARRAY_ALLOCATOR_PREFIX, ARRAY_DEFAULT_ALIGN,
+		                                    prev_used_buffer_size + ARRAY_ALLOCATOR_PREFIX);
+		buffer = block ? pointer_offset(block, ARRAY_ALLOCATOR_PREFIX) : nullptr;
+	}
+	else if (*arr && _array_is_inline(*arr)) {
+		//Spill inline storage to heap, copying header and used elements
+		buffer = memory_allocate(0, buffer_size, ARRAY_DEFAULT_ALIGN, MEMORY_PERSISTENT);
+		if (buffer) {
+			memcpy(buffer, _array_raw(*arr), header_size + (itemsize * _array_rawsize(*arr)));
+			buffer[3] = (uint32_t)itemsize;
+		}
+	}
+	else {
+		buffer = *arr ?
+			memory_reallocate(_array_raw(*arr), buffer_size, ARRAY_DEFAULT_ALIGN, prev_used_buffer_size) :
+			memory_allocate(0, buffer_size, ARRAY_DEFAULT_ALIGN, MEMORY_PERSISTENT);
+	}
 	if (FOUNDATION_VALIDATE_MSG(buffer, "Failed to reallocate array storage")) {
 		buffer[0] = (uint32_t)capacity;
 		if (!*arr) {
@@ -64,3 +98,248 @@ _array_growfn(void** arr, size_t increment, size_t factor, size_t itemsize) {
 	}
 	return nullptr;
 }
+
+void*
+_array_inlinefn(void* storage, size_t capacity, size_t itemsize) {
+	uint32_t* buffer = storage;
+	buffer[0] = (uint32_t)capacity;
+	buffer[1] = 0;
+	buffer[2] = ARRAY_WATERMARK;
+	buffer[3] = (uint32_t)itemsize | _array_inline_flag;
+	return buffer + _array_header_size;
+}
+
+void*
+_array_allocatorfn(array_allocator_t* allocator, size_t capacity, size_t itemsize) {
+	size_t buffer_size = (itemsize * capacity) + (4U * _array_header_size);
+	void* block = allocator->reallocate(allocator, nullptr, buffer_size + ARRAY_ALLOCATOR_PREFIX,
+	                                    ARRAY_DEFAULT_ALIGN, 0);
+	uint32_t* buffer;
+	if (!FOUNDATION_VALIDATE_MSG(block, "Failed to allocate array storage"))
+		return nullptr;
+	*(array_allocator_t**)block = allocator;
+	buffer = pointer_offset(block, ARRAY_ALLOCATOR_PREFIX);
+	buffer[0] = (uint32_t)capacity;
+	buffer[1] = 0;
+	buffer[2] = ARRAY_WATERMARK;
+	buffer[3] = (uint32_t)itemsize | _array_allocator_flag;
+	return buffer + _array_header_size;
+}
+
+void
+_array_deallocatefn(void* arr) {
+	if (_array_rawelementsize(arr) & _array_allocator_flag) {
+		array_allocator_t* allocator = _array_allocator(arr);
+		allocator->deallocate(allocator, pointer_offset(_array_raw(arr), -(ssize_t)ARRAY_ALLOCATOR_PREFIX));
+	}
+	else if (!_array_is_inline(arr)) {
+		memory_deallocate(_array_raw(arr));
+	}
+}
+
+static void*
+_array_allocator_context_reallocate(array_allocator_t* allocator, void* p, size_t size,
+                                    unsigned int align, size_t oldsize) {
+	return p ? memory_reallocate(p, size, align, oldsize) :
+	       memory_allocate(allocator->context, size, align, MEMORY_PERSISTENT);
+}
+
+static void
+_array_allocator_context_deallocate(array_allocator_t* allocator, void* p) {
+	FOUNDATION_UNUSED(allocator);
+	memory_deallocate(p);
+}
+
+void
+array_allocator_initialize(array_allocator_t* allocator, hash_t context, unsigned int factor) {
+	allocator->reallocate = _array_allocator_context_reallocate;
+	allocator->deallocate = _array_allocator_context_deallocate;
+	allocator->data = nullptr;
+	allocator->context = context;
+	allocator->factor = factor;
+}
+
+static void*
+_array_allocator_arena_reallocate(array_allocator_t* allocator, void* p, size_t size,
+                                  unsigned int align, size_t oldsize) {
+	memory_arena_t* arena = allocator->data;
+	void* block;
+	//Extend in place if block is the last allocation in the current chunk
+	if (p && (pointer_offset(p, oldsize) == arena->head) && (pointer_offset(p, size) <= arena->end)) {
+		arena->head = pointer_offset(p, size);
+		return p;
+	}
+	block = memory_arena_allocate_block(arena, size, align);
+	if (block && p && oldsize)
+		memcpy(block, p, (size < oldsize) ? size : oldsize);
+	return block;
+}
+
+static void
+_array_allocator_arena_deallocate(array_allocator_t* allocator, void* p) {
+	//Arena memory is released in bulk with the arena
+	FOUNDATION_UNUSED(allocator);
+	FOUNDATION_UNUSED(p);
+}
+
+void
+array_allocator_initialize_arena(array_allocator_t* allocator, memory_arena_t* arena,
+                                 unsigned int factor) {
+	allocator->reallocate = _array_allocator_arena_reallocate;
+	allocator->deallocate = _array_allocator_arena_deallocate;
+	allocator->data = arena;
+	allocator->context = arena->context;
+	allocator->factor = factor;
+}
+
+static void*
+_array_allocator_pool_reallocate(array_allocator_t* allocator, void* p, size_t size,
+                                 unsigned int align, size_t oldsize) {
+	memory_pool_t* pool = allocator->data;
+	FOUNDATION_UNUSED(align);
+	FOUNDATION_UNUSED(oldsize);
+	if (size > pool->block_size)
+		return nullptr;
+	return p ? p : memory_pool_allocate_block(pool);
+}
+
+static void
+_array_allocator_pool_deallocate(array_allocator_t* allocator, void* p) {
+	memory_pool_deallocate_block(allocator->data, p);
+}
+
+void
+array_allocator_initialize_pool(array_allocator_t* allocator, memory_pool_t* pool) {
+	allocator->reallocate = _array_allocator_pool_reallocate;
+	allocator->deallocate = _array_allocator_pool_deallocate;
+	allocator->data = pool;
+	allocator->context = pool->context;
+	allocator->factor = 0;
+}
+
+ssize_t
+_array_find32fn(const uint32_t* arr, size_t size, uint32_t key) {
+	size_t i = 0;
+#if FOUNDATION_ARCH_SSE2
+	__m128i vkey = _mm_set1_epi32((int)key);
+	for (; i + 16 <= size; i += 16) {
+		__m128i m0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i)), vkey);
+		__m128i m1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 4)), vkey);
+		__m128i m2 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 8)), vkey);
+		__m128i m3 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 12)), vkey);
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+			break;
+	}
+#elif FOUNDATION_ARCH_NEON
+	uint32x4_t vkey = vdupq_n_u32(key);
+	for (; i + 16 <= size; i += 16) {
+		uint32x4_t m0 = vceqq_u32(vld1q_u32(arr + i), vkey);
+		uint32x4_t m1 = vceqq_u32(vld1q_u32(arr + i + 4), vkey);
+		uint32x4_t m2 = vceqq_u32(vld1q_u32(arr + i + 8), vkey);
+		uint32x4_t m3 = vceqq_u32(vld1q_u32(arr + i + 12), vkey);
+		uint64x2_t m = vreinterpretq_u64_u32(vorrq_u32(vorrq_u32(m0, m1), vorrq_u32(m2, m3)));
+		if (vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1))
+			break;
+	}
+#endif
+	//Scalar scan of remaining elements, or the block containing a match
+	for (; i < size; ++i) {
+		if (arr[i] == key)
+			return (ssize_t)i;
+	}
+	return -1;
+}
+
+ssize_t
+_array_find64fn(const uint64_t* arr, size_t size, uint64_t key) {
+	size_t i = 0;
+#if FOUNDATION_ARCH_SSE2
+	__m128i vkey = _mm_set1_epi64x((long long)key);
+	for (; i + 8 <= size; i += 8) {
+		__m128i m0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i)), vkey);
+		__m128i m1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 2)), vkey);
+		__m128i m2 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 4)), vkey);
+		__m128i m3 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 6)), vkey);
+		//No 64-bit compare in SSE2, require both 32-bit halves to match
+		m0 = _mm_and_si128(m0, _mm_shuffle_epi32(m0, _MM_SHUFFLE(2, 3, 0, 1)));
+		m1 = _mm_and_si128(m1, _mm_shuffle_epi32(m1, _MM_SHUFFLE(2, 3, 0, 1)));
+		m2 = _mm_and_si128(m2, _mm_shuffle_epi32(m2, _MM_SHUFFLE(2, 3, 0, 1)));
+		m3 = _mm_and_si128(m3, _mm_shuffle_epi32(m3, _MM_SHUFFLE(2, 3, 0, 1)));
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+			break;
+	}
+#elif FOUNDATION_ARCH_NEON && FOUNDATION_ARCH_ARM_64
+	uint64x2_t vkey = vdupq_n_u64(key);
+	for (; i + 8 <= size; i += 8) {
+		uint64x2_t m0 = vceqq_u64(vld1q_u64(arr + i), vkey);
+		uint64x2_t m1 = vceqq_u64(vld1q_u64(arr + i + 2), vkey);
+		uint64x2_t m2 = vceqq_u64(vld1q_u64(arr + i + 4), vkey);
+		uint64x2_t m3 = vceqq_u64(vld1q_u64(arr + i + 6), vkey);
+		uint64x2_t m = vorrq_u64(vorrq_u64(m0, m1), vorrq_u64(m2, m3));
+		if (vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1))
+			break;
+	}
+#endif
+	for (; i < size; ++i) {
+		if (arr[i] == key)
+			return (ssize_t)i;
+	}
+	return -1;
+}
+
+ssize_t
+_array_findfn(const void* arr, size_t size, const void* element, size_t itemsize) {
+	size_t i;
+	if (itemsize == sizeof(uint32_t)) {
+		uint32_t key;
+		memcpy(&key, element, sizeof(key));
+		return _array_find32fn(arr, size, key);
+	}
+	if (itemsize == sizeof(uint64_t)) {
+		uint64_t key;
+		memcpy(&key, element, sizeof(key));
+		return _array_find64fn(arr, size, key);
+	}
+	for (i = 0; i < size; ++i) {
+		if (!memcmp(pointer_offset_const(arr, i * itemsize), element, itemsize))
+			return (ssize_t)i;
+	}
+	return -1;
+}
+
+void
+_array_fillfn(void* arr, size_t size, const void* element, size_t itemsize) {
+	size_t filled;
+	size_t total = size * itemsize;
+	if (!size)
+		return;
+	memcpy(arr, element, itemsize);
+	//Double the filled range with each copy
+	for (filled = itemsize; filled < total; filled *= 2) {
+		size_t chunk = (filled < total - filled) ? filled : (total - filled);
+		memcpy(pointer_offset(arr, filled), arr, chunk);
+	}
+}
+
+size_t
+_array_erase_iffn(void* arr, uint32_t* size, size_t itemsize, array_predicate_fn predicate,
+                  void* data) {
+	size_t count = *size;
+	size_t write = 0;
+	size_t run = 0;
+	size_t read;
+	//Move each run of kept elements once, when the next erased element (or end) is reached
+	for (read = 0; read <= count; ++read) {
+		if ((read < count) && !predicate(pointer_offset(arr, read * itemsize), data))
+			continue;
+		if (read > run) {
+			if (write != run)
+				memmove(pointer_offset(arr, write * itemsize), pointer_offset(arr, run * itemsize),
+				        (read - run) * itemsize);
+			write += read - run;
+		}
+		run = read + 1;
+	}
+	*size = (uint32_t)write;
+	return count - write;
+}
@@ -32,19 +32,94 @@ array_push( arr, 10 ); //arr is now allocated and arr[0] now equals 10
 array_pop( arr ); //arr size is now 0, arr still allocated
 array_deallocate( arr ); //arr is now deallocated and arr now equals null</code>
 
+Small arrays can keep elements in caller provided inline storage, spilling to heap memory
+only when growing past the inline capacity:
+
+<code>array_inline_storage(int, 8) storage;
+int* arr = 0;
+array_initialize_inline( arr, storage ); //arr uses storage for up to 8 elements
+array_push( arr, 10 ); //no heap allocation
+array_deallocate( arr ); //releases heap memory if array spilled, arr now equals null</code>
+
+Arrays can also be bound to an allocator, for example to keep all storage in a memory arena
+which is released in bulk:
+
+<code>array_allocator_t allocator;
+array_allocator_initialize_arena( &allocator, arena, 2 );
+int* arr = 0;
+array_initialize_allocator( arr, &allocator ); //arr storage is now allocated from arena
+array_push( arr, 10 );
+array_deallocate( arr ); //arr now equals null, memory released by memory_arena_reset</code>
+
 Adapted and extended from stb_arr at http://nothings.org/stb.h */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
 #include <foundation/math.h>
 
-/*! Deallocate array memory and reset array pointer to zero.
+/*! Deallocate array memory and reset array pointer to zero. Inline storage is not
+deallocated, only heap memory the array has spilled to. Arrays bound to an allocator
+release storage through the allocator.
 \param array Array pointer */
 #define array_deallocate(array) /*lint -e{522}*/ ( \
   _array_verify(array) ? \
-    memory_deallocate(_array_raw(array)), ((array) = 0) : \
+    (_array_has_flags(array) ? _array_deallocatefn(array) : memory_deallocate(_array_raw(array))), \
+    ((array) = 0) : \
     0)
 
+/*! Declare the type of inline storage for an array of the given element type, holding
+up to the given number of elements. See #array_initialize_inline
+\param type     Element type
+\param capacity Number of elements in inline storage */
+#define array_inline_storage(type, capacity) \
+  struct { uint32_t header[_array_header_size]; type elements[capacity]; }
+
+/*! Initialize an array to use inline storage declared with #array_inline_storage, discarding
+any previous array. The array keeps elements in the inline storage until it grows past the
+inline capacity, at which point elements are moved to heap memory. The inline storage must
+remain valid while the array is in use, and the array should be deallocated with
+#array_deallocate as usual.
+\param array   Array pointer
+\param storage Inline storage */
+#define array_initialize_inline(array, storage) ( \
+  (array) = _array_inlinefn(&(storage), \
+    sizeof((storage).elements) / sizeof((storage).elements[0]), sizeof(*(array))))
+
+/*! Initialize an array bound to the given allocator, discarding any previous array. All
+later storage growth for the array is made through the allocator, using the growth factor
+of the allocator, and #array_deallocate releases storage through the allocator. The
+allocator must remain valid while the array is in use.
+\param array     Array pointer
+\param allocator Array allocator */
+#define array_initialize_allocator(array, allocator) ( \
+  (array) = _array_allocatorfn((allocator), 0, sizeof(*(array))))
+
+/*! Initialize an array allocator allocating storage from the default memory system in the
+given memory context
+\param allocator Array allocator
+\param context   Memory context
+\param factor    Growth factor, zero for default (2) */
+FOUNDATION_API void
+array_allocator_initialize(array_allocator_t* allocator, hash_t context, unsigned int factor);
+
+/*! Initialize an array allocator allocating storage from a memory arena. Storage is never
+individually released, all memory is released when the arena is reset or finalized. Growing
+the most recent allocation in the arena is done in place when possible.
+\param allocator Array allocator
+\param arena     Memory arena
+\param factor    Growth factor, zero for default (2) */
+FOUNDATION_API void
+array_allocator_initialize_arena(array_allocator_t* allocator, memory_arena_t* arena,
+                                 unsigned int factor);
+
+/*! Initialize an array allocator allocating storage from a memory pool. Storage for an
+array is a single pool block, growing an array past the block size (including the 32 byte
+array header) fails.
+\param allocator Array allocator
+\param pool      Memory pool */
+FOUNDATION_API void
+array_allocator_initialize_pool(array_allocator_t* allocator, memory_pool_t* pool);
+
 /*! Get capacity of array in number of elements. Capacity indicates the size of the allocated
 memory block (maximum size of array).
 \param array Array pointer */
@@ -276,6 +351,62 @@ in array. Position and number of elements ARE ranged checked
     array_erase_ordered_range(array, _clamped_start, _clamped_end - _clamped_start); \
 } while(0)
 
+/*! Find first element equal to the given 32-bit key in an array of 32-bit elements.
+Comparison is vectorized where supported.
+\param array Array pointer
+\param key   Key to find
+\return      Index of first matching element, <0 if not found */
+#define array_find32(array, key) \
+  _array_find32fn((const uint32_t*)(const void*)(array), array_size(array), (uint32_t)(key))
+
+/*! Find first element equal to the given 64-bit key in an array of 64-bit elements, such as
+an array of hash_t. Comparison is vectorized where supported.
+\param array Array pointer
+\param key   Key to find
+\return      Index of first matching element, <0 if not found */
+#define array_find64(array, key) \
+  _array_find64fn((const uint64_t*)(const void*)(array), array_size(array), (uint64_t)(key))
+
+/*! Find first element equal to the given element compared with memcmp. Arrays of 32-bit and
+64-bit elements are compared with #array_find32 and #array_find64 respectively.
+\param array      Array pointer
+\param elementptr Pointer to element to find
+\return           Index of first matching element, <0 if not found */
+#define array_find_memcmp(array, elementptr) \
+  _array_findfn((array), array_size(array), (elementptr), _array_elementsize(array))
+
+/*! Set all elements in array to the given element, copying data with memcpy. Does not
+affect array size.
+\param array      Array pointer
+\param elementptr Pointer to element */
+#define array_fill_memcpy(array, elementptr) ( \
+  _array_verify(array) ? \
+    _array_fillfn((array), _array_rawsize(array), (elementptr), _array_elementsize(array)), 0 : \
+    0)
+
+/*! Add a range of elements at end of array copying data with memcpy. Allocates storage
+for all elements at once.
+\param array      Array pointer
+\param elementptr Pointer to first new element
+\param num        Number of new elements */
+#define array_push_range_memcpy(array, elementptr, num) /*lint -e{506,522}*/ ( \
+  _array_maybegrow(array, (num)) ? \
+    memcpy((array) + _array_rawsize(array), (elementptr), (num) * sizeof(*(array))), \
+      (_array_rawsize(array) += (uint32_t)(num)), (array) : \
+    (array))
+
+/*! Erase all elements for which the predicate holds, preserving order of remaining
+elements. Remaining elements are moved in runs using memmove.
+\param array     Array pointer
+\param predicate Predicate function
+\param data      Data passed to predicate
+\return          Number of elements erased */
+#define array_erase_ordered_if(array, predicate, data) ( \
+  _array_verify(array) ? \
+    _array_erase_iffn((array), &_array_rawsize(array), _array_elementsize(array), \
+                      (predicate), (data)) : \
+    0)
+
 // **** Internal implementation details below, not for direct use ****
 
 /*! \internal Header size set to 16 bytes in order to align main array memory */
@@ -292,6 +423,10 @@ in array. Position and number of elements ARE ranged checked
 #define _array_rawcapacity(a)        _array_raw(a)[0]
 #define _array_rawsize(a)            _array_raw(a)[1]
 #define _array_rawelementsize(a)     _array_raw(a)[3]
+#define _array_inline_flag           0x80000000U
+#define _array_allocator_flag        0x40000000U
+#define _array_is_inline(a)          (_array_raw_const(a)[3] & _array_inline_flag)
+#define _array_has_flags(a)          (_array_raw_const(a)[3] & (_array_inline_flag | _array_allocator_flag))
 #define _array_raw_const(a)          ((const uint32_t*)(a) - _array_header_size)
 #define _array_rawcapacity_const(a)  _array_raw_const(a)[0]
 #define _array_rawsize_const(a)      _array_raw_const(a)[1]
@@ -323,6 +458,71 @@ _array_growfn(void** arr, size_t increment, size_t factor, size_t itemsize);
 FOUNDATION_API void*
 _array_resizefn(void** arr, size_t elements, size_t itemsize);
 
+/*! \internal Initialize inline array storage.
+\param storage  Inline storage, header followed by element storage
+\param capacity Number of elements in storage
+\param itemsize Size of a single item
+\return         New array pointer */
+FOUNDATION_API void*
+_array_inlinefn(void* storage, size_t capacity, size_t itemsize);
+
+/*! \internal Initialize array storage bound to an allocator.
+\param allocator Array allocator
+\param capacity  Initial number of elements in storage
+\param itemsize  Size of a single item
+\return          New array pointer */
+FOUNDATION_API void*
+_array_allocatorfn(array_allocator_t* allocator, size_t capacity, size_t itemsize);
+
+/*! \internal Deallocate array storage with inline storage or bound to an allocator.
+\param arr Array */
+FOUNDATION_API void
+_array_deallocatefn(void* arr);
+
+/*! \internal Find 32-bit key in array.
+\param arr  Array
+\param size Number of elements
+\param key  Key to find
+\return     Index of first matching element, <0 if not found */
+FOUNDATION_API ssize_t
+_array_find32fn(const uint32_t* arr, size_t size, uint32_t key);
+
+/*! \internal Find 64-bit key in array.
+\param arr  Array
+\param size Number of elements
+\param key  Key to find
+\return     Index of first matching element, <0 if not found */
+FOUNDATION_API ssize_t
+_array_find64fn(const uint64_t* arr, size_t size, uint64_t key);
+
+/*! \internal Find element in array.
+\param arr      Array
+\param size     Number of elements
+\param element  Element to find
+\param itemsize Size of a single item
+\return         Index of first matching element, <0 if not found */
+FOUNDATION_API ssize_t
+_array_findfn(const void* arr, size_t size, const void* element, size_t itemsize);
+
+/*! \internal Fill array with element.
+\param arr      Array
+\param size     Number of elements
+\param element  Element to copy
+\param itemsize Size of a single item */
+FOUNDATION_API void
+_array_fillfn(void* arr, size_t size, const void* element, size_t itemsize);
+
+/*! \internal Erase elements matching predicate preserving order.
+\param arr       Array
+\param size      Pointer to array size, updated with new size
+\param itemsize  Size of a single item
+\param predicate Predicate function
+\param data      Data passed to predicate
+\return          Number of elements erased */
+FOUNDATION_API size_t
+_array_erase_iffn(void* arr, uint32_t* size, size_t itemsize, array_predicate_fn predicate,
+                  void* data);
+
 /*! \internal Verify array integrity. Will cause an assert if array is not valid.
 \param arr      Pointer to array
 \return         Array if valid, null if invalid */
@@ -82,6 +82,13 @@ assert_report(hash_t context, const char* condition, size_t cond_length, const c
 
 	log_errorf(context, ERROR_ASSERT, STRING_CONST("%.*s"), STRING_FORMAT(messagestr));
 
+	//Expand the flight recorder, including the assert message
+	if (foundation_is_initialized() && log_recorder_size()) {
+		stream_t* errstream = stream_open_stderr();
+		log_recorder_dump(errstream);
+		stream_deallocate(errstream);
+	}
+
 	system_message_box(STRING_CONST("Assert Failure"), STRING_ARGS(messagestr), false);
 #else
 	log_errorf(context, ERROR_ASSERT, assert_format, sizeof(assert_format) - 1,
@@ -19,10 +19,17 @@
 
 #include <android/asset_manager.h>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 struct stream_asset_t {
 	FOUNDATION_DECLARE_STREAM;
 	AAsset* asset;
 	size_t position;
+	size_t size;
+	const void* data;
+	void* map;
+	size_t map_size;
 };
 
 typedef FOUNDATION_ALIGN(8) struct stream_asset_t stream_asset_t;
@@ -33,6 +40,15 @@ static size_t
 asset_stream_read(stream_t* stream, void* dest, size_t num) {
 	stream_asset_t* asset = (stream_asset_t*)stream;
 
+	if (asset->data) {
+		size_t available = asset->size - asset->position;
+		if (num > available)
+			num = available;
+		memcpy(dest, pointer_offset_const(asset->data, asset->position), num);
+		asset->position += num;
+		return num;
+	}
+
 	int curread = AAsset_read(asset->asset, dest, num);
 	if (curread > 0)
 		asset->position += curread;
@@ -52,7 +68,7 @@ asset_stream_write(stream_t* stream, const void* source, size_t num) {
 static bool
 asset_stream_eos(stream_t* stream) {
 	stream_asset_t* asset = (stream_asset_t*)stream;
-	return !asset || !asset->asset || ((off_t)asset->position >= AAsset_getLength(asset->asset));
+	return !asset || (!asset->asset && !asset->data) || (asset->position >= asset->size);
 }
 
 static void
@@ -70,12 +86,23 @@ asset_stream_truncate(stream_t* stream, size_t size) {
 static size_t
 asset_stream_size(stream_t* stream) {
 	stream_asset_t* asset = (stream_asset_t*)stream;
-	return (asset && asset->asset ? AAsset_getLength(asset->asset) : 0);
+	return asset ? asset->size : 0;
 }
 
 static void
 asset_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
 	stream_asset_t* asset = (stream_asset_t*)stream;
+	if (asset->data) {
+		ssize_t position = offset;
+		if (direction == STREAM_SEEK_CURRENT)
+			position += (ssize_t)asset->position;
+		else if (direction == STREAM_SEEK_END)
+			position += (ssize_t)asset->size;
+		if (position < 0)
+			position = 0;
+		asset->position = ((size_t)position < asset->size) ? (size_t)position : asset->size;
+		return;
+	}
 	ssize_t newpos = AAsset_seek(asset->asset, offset, direction);
 	if (newpos >= 0)
 		asset->position = (size_t)newpos;
@@ -96,7 +123,7 @@ asset_stream_lastmod(const stream_t* stream) {
 static size_t
 asset_stream_available_read(stream_t* stream) {
 	stream_asset_t* asset = (stream_asset_t*)stream;
-	return AAsset_getLength(asset->asset) - asset->position;
+	return asset->size - asset->position;
 }
 
 static void
@@ -106,10 +133,75 @@ asset_stream_finalize(stream_t* stream) {
 	if (!asset || (stream->type != STREAMTYPE_ASSET))
 		return;
 
+	if (asset->map)
+		munmap(asset->map, asset->map_size);
 	if (asset->asset)
 		AAsset_close(asset->asset);
 
 	asset->asset = 0;
+	asset->map = 0;
+	asset->data = 0;
+	asset->size = 0;
+}
+
+static void
+asset_stream_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	stream_asset_t* asset = (stream_asset_t*)stream;
+	if (!asset->map || (offset >= asset->size))
+		return;
+	//Range must start on a page boundary, offset is relative to the asset data in the mapping
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t begin = offset + (size_t)pointer_diff(asset->data, asset->map);
+	if (!size || (size > asset->size - offset))
+		size = asset->size - offset;
+	size += begin % page_size;
+	begin -= begin % page_size;
+	int flag = MADV_NORMAL;
+	if (advice == STREAM_ADVICE_SEQUENTIAL)
+		flag = MADV_SEQUENTIAL;
+	else if (advice == STREAM_ADVICE_RANDOM)
+		flag = MADV_RANDOM;
+	else if (advice == STREAM_ADVICE_WILLNEED)
+		flag = MADV_WILLNEED;
+	else if (advice == STREAM_ADVICE_DONTNEED)
+		flag = MADV_DONTNEED;
+	madvise(pointer_offset(asset->map, begin), size, flag);
+}
+
+static bool
+asset_stream_map(stream_asset_t* asset) {
+	//Only assets stored uncompressed in the package have a file descriptor
+	off_t start = 0, length = 0;
+	int fd = AAsset_openFileDescriptor(asset->asset, &start, &length);
+	if (fd < 0)
+		return false;
+	if (length <= 0) {
+		close(fd);
+		return false;
+	}
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t align = (size_t)start % page_size;
+	size_t map_size = (size_t)length + align;
+	void* map = mmap(0, map_size, PROT_READ, MAP_PRIVATE, fd, start - (off_t)align);
+	close(fd);
+	if (map == MAP_FAILED)
+		return false;
+	asset->map = map;
+	asset->map_size = map_size;
+	asset->data = pointer_offset(map, align);
+	asset->size = (size_t)length;
+	//Mapping is independent of the asset handle
+	AAsset_close(asset->asset);
+	asset->asset = 0;
+	return true;
+}
+
+const void*
+_asset_stream_mapped_data(stream_t* stream, size_t* size) {
+	stream_asset_t* asset = (stream_asset_t*)stream;
+	if (size)
+		*size = asset->data ? asset->size : 0;
+	return asset->data;
 }
 
 static stream_t*
@@ -162,6 +254,8 @@ asset_stream_open(const char* path, size_t length, unsigned int mode) {
 
 	asset->asset = assetobj;
 	asset->position = 0;
+	asset->size = (size_t)AAsset_getLength(assetobj);
+	asset_stream_map(asset);
 
 	return stream;
 }
@@ -180,6 +274,7 @@ _asset_stream_initialize(void) {
 	_asset_stream_vtable.available_read = asset_stream_available_read;
 	_asset_stream_vtable.finalize = asset_stream_finalize;
 	_asset_stream_vtable.clone = asset_stream_clone;
+	_asset_stream_vtable.advise = asset_stream_advise;
 }
 
 #endif
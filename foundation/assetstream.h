@@ -20,6 +20,12 @@ Asset streams are read only streams stored in the application package. For more
 check the Android developer portal at
 http://developer.android.com/intl/ru/tools/projects/index.html#ApplicationModules
 
+Assets stored uncompressed in the package are memory mapped directly from the package file
+when opened, reads are then served from the mapping and the content is available without
+copying through #fs_mapped_data. Compressed assets are read through the asset manager. Store
+large assets like textures and levels uncompressed (for example with the aapt -0 option) to
+allow mapping.
+
 Streams are not inherently thread safe, synchronization in a multithread use case must be done
 by caller. */
 
@@ -25,6 +25,18 @@ Atomic operations provide a means to atomically load, store and perform basic op
 a 32/64 bit data location. On Windows all atomic store/modify functions also provide a full
 memory fence (both acquire and release).
 
+On platforms with a double width compare and swap instruction (cmpxchg16b on x86-64,
+casp or ldaxp/stlxp on ARM64) 128 bit atomic operations are available, indicated by
+FOUNDATION_ATOMIC128. Tagged pointers pair a pointer with a counter that is incremented on
+every store, and are compared and swapped as a single unit. This avoids ABA issues in
+lock-free data structures without packing a counter into the pointer or index bits, and
+is available when FOUNDATION_ATOMIC_TAGPTR is set.
+
+The explicit variants of load, store, add and compare and swap take a memory order
+argument, allowing hot paths like statistics counters to use relaxed operations and avoid
+barriers that are not needed, which is most noticeable on ARM. With compilers lacking the
+atomic builtins the explicit variants fall back to the stronger default operations.
+
 Signal fences guarantee memory order between threads on same core or between interrupt
 and signal. Thread fences guarantee memory order between multiple threads on a multicore
 system */
@@ -36,6 +48,18 @@ system */
 #  include <libkern/OSAtomic.h>
 #endif
 
+#if FOUNDATION_ARCH_X86_64 || FOUNDATION_ARCH_ARM_64
+#  define FOUNDATION_ATOMIC128 1
+#else
+#  define FOUNDATION_ATOMIC128 0
+#endif
+
+#if FOUNDATION_ATOMIC128 || (FOUNDATION_SIZE_POINTER == 4)
+#  define FOUNDATION_ATOMIC_TAGPTR 1
+#else
+#  define FOUNDATION_ATOMIC_TAGPTR 0
+#endif
+
 /*! Atomically load 32 bit value
 \param src   Value
 \return      Current value */
@@ -154,6 +178,170 @@ the reference value, and if equal the new value is stored in the destination loc
 static FOUNDATION_FORCEINLINE bool
 atomic_cas_ptr(atomicptr_t* dst, void* val, void* ref);
 
+/*! Atomically exchange pointer value, storing the new value and returning the old value
+\param dst   Value to change
+\param val   Value to set
+\return      Old value before exchange */
+static FOUNDATION_FORCEINLINE void*
+atomic_exchange_ptr(atomicptr_t* dst, void* val);
+
+/*! Atomically load 32 bit value with the given memory order
+\param src   Value
+\param order Memory order, relaxed, acquire or sequentially consistent
+\return      Current value */
+static FOUNDATION_FORCEINLINE int32_t
+atomic_load32_explicit(const atomic32_t* src, memory_order_t order);
+
+/*! Atomically load 64 bit value with the given memory order
+\param src   Value
+\param order Memory order, relaxed, acquire or sequentially consistent
+\return      Current value */
+static FOUNDATION_FORCEINLINE int64_t
+atomic_load64_explicit(const atomic64_t* src, memory_order_t order);
+
+/*! Atomically load pointer value with the given memory order
+\param src   Value
+\param order Memory order, relaxed, acquire or sequentially consistent
+\return      Current value */
+static FOUNDATION_FORCEINLINE void*
+atomic_loadptr_explicit(atomicptr_t* src, memory_order_t order);
+
+/*! Atomically store 32 bit value with the given memory order
+\param dst   Target
+\param val   Value to store
+\param order Memory order, relaxed, release or sequentially consistent */
+static FOUNDATION_FORCEINLINE void
+atomic_store32_explicit(atomic32_t* dst, int32_t val, memory_order_t order);
+
+/*! Atomically store 64 bit value with the given memory order
+\param dst   Target
+\param val   Value to store
+\param order Memory order, relaxed, release or sequentially consistent */
+static FOUNDATION_FORCEINLINE void
+atomic_store64_explicit(atomic64_t* dst, int64_t val, memory_order_t order);
+
+/*! Atomically store pointer value with the given memory order
+\param dst   Target
+\param val   Value to store
+\param order Memory order, relaxed, release or sequentially consistent */
+static FOUNDATION_FORCEINLINE void
+atomic_storeptr_explicit(atomicptr_t* dst, void* val, memory_order_t order);
+
+/*! Atomically add to the value of the 32 bit integer with the given memory order and
+returns its new value
+\param val   Value to change
+\param add   Value to add
+\param order Memory order
+\return      New value after addition */
+static FOUNDATION_FORCEINLINE int32_t
+atomic_add32_explicit(atomic32_t* val, int32_t add, memory_order_t order);
+
+/*! Atomically add to the value of the 64 bit integer with the given memory order and
+returns its new value
+\param val   Value to change
+\param add   Value to add
+\param order Memory order
+\return      New value after addition */
+static FOUNDATION_FORCEINLINE int64_t
+atomic_add64_explicit(atomic64_t* val, int64_t add, memory_order_t order);
+
+/*! Atomically compare and swap (CAS) with the given memory order. The value in the
+destination location is compared to the reference value, and if equal the new value is
+stored in the destination location. A failed comparison has the order of a load, acquire
+for acquire and acquire-release order and relaxed for release order.
+\param dst   Value to change
+\param val   Value to set
+\param ref   Reference value
+\param order Memory order
+\return      true if operation was successful and new value stored,
+             false if comparison failed and value was unchanged */
+static FOUNDATION_FORCEINLINE bool
+atomic_cas32_explicit(atomic32_t* dst, int32_t val, int32_t ref, memory_order_t order);
+
+/*! Atomically compare and swap (CAS) with the given memory order. The value in the
+destination location is compared to the reference value, and if equal the new value is
+stored in the destination location. A failed comparison has the order of a load, acquire
+for acquire and acquire-release order and relaxed for release order.
+\param dst   Value to change
+\param val   Value to set
+\param ref   Reference value
+\param order Memory order
+\return      true if operation was successful and new value stored,
+             false if comparison failed and value was unchanged */
+static FOUNDATION_FORCEINLINE bool
+atomic_cas64_explicit(atomic64_t* dst, int64_t val, int64_t ref, memory_order_t order);
+
+/*! Atomically compare and swap (CAS) with the given memory order. The value in the
+destination location is compared to the reference value, and if equal the new value is
+stored in the destination location. A failed comparison has the order of a load, acquire
+for acquire and acquire-release order and relaxed for release order.
+\param dst   Value to change
+\param val   Value to set
+\param ref   Reference value
+\param order Memory order
+\return      true if operation was successful and new value stored,
+             false if comparison failed and value was unchanged */
+static FOUNDATION_FORCEINLINE bool
+atomic_cas_ptr_explicit(atomicptr_t* dst, void* val, void* ref, memory_order_t order);
+
+#if FOUNDATION_ATOMIC128
+
+/*! Atomically load 128 bit value. Implemented as a compare and swap, so the value must
+reside in writable memory
+\param src   Value
+\return      Current value */
+static FOUNDATION_FORCEINLINE uint128_t
+atomic_load128(atomic128_t* src);
+
+/*! Atomically store 128 bit value
+\param dst   Target
+\param val   Value to store */
+static FOUNDATION_FORCEINLINE void
+atomic_store128(atomic128_t* dst, uint128_t val);
+
+/*! Atomically compare and swap (CAS) 128 bit value. The value in the destination location
+is compared to the reference value, and if equal the new value is stored in the destination
+location.
+\param dst   Value to change
+\param val   Value to set
+\param ref   Reference value
+\return      true if operation was successful and new value stored,
+             false if comparison failed and value was unchanged */
+static FOUNDATION_FORCEINLINE bool
+atomic_cas128(atomic128_t* dst, uint128_t val, uint128_t ref);
+
+#endif
+
+#if FOUNDATION_ATOMIC_TAGPTR
+
+/*! Atomically load tagged pointer value and tag
+\param src   Tagged pointer
+\param tag   Receives current tag, can be null
+\return      Current pointer value */
+static FOUNDATION_FORCEINLINE void*
+atomic_load_tagptr(atomictagptr_t* src, uintptr_t* tag);
+
+/*! Atomically store tagged pointer value, incrementing the tag
+\param dst   Tagged pointer
+\param val   Pointer value to store */
+static FOUNDATION_FORCEINLINE void
+atomic_store_tagptr(atomictagptr_t* dst, void* val);
+
+/*! Atomically compare and swap (CAS) tagged pointer. The pointer and tag in the destination
+location are compared to the reference pointer and tag, and if both are equal the new pointer
+is stored with the tag incremented by one. The reference tag should be obtained together with
+the reference pointer from #atomic_load_tagptr.
+\param dst   Tagged pointer to change
+\param val   Pointer value to set
+\param ref   Reference pointer value
+\param tag   Reference tag
+\return      true if operation was successful and new value stored,
+             false if comparison failed and value was unchanged */
+static FOUNDATION_FORCEINLINE bool
+atomic_cas_tagptr(atomictagptr_t* dst, void* val, void* ref, uintptr_t tag);
+
+#endif
+
 /*! Signal fence making prior writes made to other memory locations done by a thread on
 the same core doing a release fence visible to the calling thread. Implemented as a compile
 barrier on all supported platforms */
@@ -403,6 +591,151 @@ atomic_cas_ptr(atomicptr_t* dst, void* val, void* ref) {
 #  endif
 }
 
+static FOUNDATION_FORCEINLINE void*
+atomic_exchange_ptr(atomicptr_t* dst, void* val) {
+#if FOUNDATION_PLATFORM_WINDOWS && ( FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_INTEL )
+	return _InterlockedExchangePointer((void* volatile*)&dst->nonatomic, val);
+#elif FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
+	return __atomic_exchange_n(&dst->nonatomic, val, __ATOMIC_SEQ_CST);
+#else
+#  error Not implemented
+#endif
+}
+
+#if FOUNDATION_ATOMIC128
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas128(atomic128_t* dst, uint128_t val, uint128_t ref) {
+#if FOUNDATION_PLATFORM_WINDOWS && ( FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_INTEL )
+	long long comparand[2] = { (long long)ref.word[0], (long long)ref.word[1] };
+	return _InterlockedCompareExchange128((volatile long long*)dst->nonatomic.word,
+	                                      (long long)val.word[1], (long long)val.word[0],
+	                                      comparand) ? true : false;
+#elif FOUNDATION_ARCH_X86_64
+	bool result;
+	__asm volatile(
+	  "lock; cmpxchg16b %1\n"
+	  "setz %0"
+	  : "=q"(result), "+m"(dst->nonatomic), "+a"(ref.word[0]), "+d"(ref.word[1])
+	  : "b"(val.word[0]), "c"(val.word[1])
+	  : "cc", "memory");
+	return result;
+#elif defined(__ARM_FEATURE_ATOMICS)
+	register uint64_t low __asm("x0") = ref.word[0];
+	register uint64_t high __asm("x1") = ref.word[1];
+	register uint64_t newlow __asm("x2") = val.word[0];
+	register uint64_t newhigh __asm("x3") = val.word[1];
+	__asm volatile(
+	  "caspal x0, x1, x2, x3, [%4]"
+	  : "+r"(low), "+r"(high)
+	  : "r"(newlow), "r"(newhigh), "r"(dst->nonatomic.word)
+	  : "memory");
+	return (low == ref.word[0]) && (high == ref.word[1]);
+#else
+	uint64_t low, high;
+	uint32_t failed;
+	__asm volatile(
+	  "1:    ldaxp %0, %1, [%3]\n"
+	  "      cmp %0, %4\n"
+	  "      ccmp %1, %5, #0, eq\n"
+	  "      b.ne 2f\n"
+	  "      stlxp %w2, %6, %7, [%3]\n"
+	  "      cbnz %w2, 1b\n"
+	  "2:"
+	  : "=&r"(low), "=&r"(high), "=&r"(failed)
+	  : "r"(dst->nonatomic.word), "r"(ref.word[0]), "r"(ref.word[1]),
+	  "r"(val.word[0]), "r"(val.word[1])
+	  : "cc", "memory");
+	return (low == ref.word[0]) && (high == ref.word[1]);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE uint128_t
+atomic_load128(atomic128_t* src) {
+	//Possibly torn read is corrected by the CAS, which fails unless both words match
+	uint128_t val;
+	do {
+		val.word[0] = ((volatile uint64_t*)src->nonatomic.word)[0];
+		val.word[1] = ((volatile uint64_t*)src->nonatomic.word)[1];
+	}
+	while (!atomic_cas128(src, val, val));
+	return val;
+}
+
+static FOUNDATION_FORCEINLINE void
+atomic_store128(atomic128_t* dst, uint128_t val) {
+	uint128_t ref;
+	do {
+		ref.word[0] = ((volatile uint64_t*)dst->nonatomic.word)[0];
+		ref.word[1] = ((volatile uint64_t*)dst->nonatomic.word)[1];
+	}
+	while (!atomic_cas128(dst, val, ref));
+}
+
+#endif
+
+#if FOUNDATION_ATOMIC_TAGPTR
+
+#if FOUNDATION_SIZE_POINTER == 8
+
+static FOUNDATION_FORCEINLINE void*
+atomic_load_tagptr(atomictagptr_t* src, uintptr_t* tag) {
+	uint128_t val = atomic_load128((atomic128_t*)src);
+	if (tag)
+		*tag = (uintptr_t)val.word[1];
+	return (void*)(uintptr_t)val.word[0];
+}
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas_tagptr(atomictagptr_t* dst, void* val, void* ref, uintptr_t tag) {
+	return atomic_cas128((atomic128_t*)dst,
+	                     uint128_make((uint64_t)(uintptr_t)val, (uint64_t)tag + 1),
+	                     uint128_make((uint64_t)(uintptr_t)ref, (uint64_t)tag));
+}
+
+#else
+
+typedef union {
+	int64_t raw;
+	struct {
+		void* ptr;
+		uintptr_t tag;
+	} pair;
+} atomic_tagptr_value_t;
+
+static FOUNDATION_FORCEINLINE void*
+atomic_load_tagptr(atomictagptr_t* src, uintptr_t* tag) {
+	atomic_tagptr_value_t val;
+	val.raw = atomic_load64((atomic64_t*)src);
+	if (tag)
+		*tag = val.pair.tag;
+	return val.pair.ptr;
+}
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas_tagptr(atomictagptr_t* dst, void* val, void* ref, uintptr_t tag) {
+	atomic_tagptr_value_t newval, refval;
+	newval.pair.ptr = val;
+	newval.pair.tag = tag + 1;
+	refval.pair.ptr = ref;
+	refval.pair.tag = tag;
+	return atomic_cas64((atomic64_t*)dst, newval.raw, refval.raw);
+}
+
+#endif
+
+static FOUNDATION_FORCEINLINE void
+atomic_store_tagptr(atomictagptr_t* dst, void* val) {
+	uintptr_t tag;
+	void* ref;
+	do {
+		ref = atomic_load_tagptr(dst, &tag);
+	}
+	while (!atomic_cas_tagptr(dst, val, ref, tag));
+}
+
+#endif
+
 static FOUNDATION_FORCEINLINE void atomic_signal_fence_acquire(void) {}
 static FOUNDATION_FORCEINLINE void atomic_signal_fence_release(void) {}
 static FOUNDATION_FORCEINLINE void atomic_signal_fence_sequentially_consistent(void) {}
@@ -464,3 +797,144 @@ _atomic_thread_fence_sequentially_consistent(void);
 #  endif
 
 #endif
+
+// Explicit memory order, fallback implementations rely on the fence definitions above
+
+#if FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
+#  define FOUNDATION_ATOMIC_BUILTIN 1
+#  define FOUNDATION_ATOMIC_BUILTIN64 (!FOUNDATION_MUTEX_64BIT_ATOMIC)
+#  define FOUNDATION_ATOMIC_ORDER_FAIL(order) \
+	((order) == MEMORY_ORDER_RELEASE ? MEMORY_ORDER_RELAXED : \
+	((order) == MEMORY_ORDER_ACQ_REL ? MEMORY_ORDER_ACQUIRE : (order)))
+#else
+#  define FOUNDATION_ATOMIC_BUILTIN 0
+#  define FOUNDATION_ATOMIC_BUILTIN64 0
+#endif
+
+static FOUNDATION_FORCEINLINE int32_t
+atomic_load32_explicit(const atomic32_t* src, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	return __atomic_load_n(&src->nonatomic, (int)order);
+#else
+	int32_t val = atomic_load32(src);
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_acquire();
+	return val;
+#endif
+}
+
+static FOUNDATION_FORCEINLINE int64_t
+atomic_load64_explicit(const atomic64_t* src, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN64
+	return __atomic_load_n(&src->nonatomic, (int)order);
+#else
+	int64_t val = atomic_load64(src);
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_acquire();
+	return val;
+#endif
+}
+
+static FOUNDATION_FORCEINLINE void*
+atomic_loadptr_explicit(atomicptr_t* src, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	return __atomic_load_n(&src->nonatomic, (int)order);
+#else
+	void* val = atomic_loadptr(src);
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_acquire();
+	return val;
+#endif
+}
+
+static FOUNDATION_FORCEINLINE void
+atomic_store32_explicit(atomic32_t* dst, int32_t val, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	__atomic_store_n(&dst->nonatomic, val, (int)order);
+#else
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_release();
+	atomic_store32(dst, val);
+	if (order == MEMORY_ORDER_SEQ_CST)
+		atomic_thread_fence_sequentially_consistent();
+#endif
+}
+
+static FOUNDATION_FORCEINLINE void
+atomic_store64_explicit(atomic64_t* dst, int64_t val, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN64
+	__atomic_store_n(&dst->nonatomic, val, (int)order);
+#else
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_release();
+	atomic_store64(dst, val);
+	if (order == MEMORY_ORDER_SEQ_CST)
+		atomic_thread_fence_sequentially_consistent();
+#endif
+}
+
+static FOUNDATION_FORCEINLINE void
+atomic_storeptr_explicit(atomicptr_t* dst, void* val, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	__atomic_store_n(&dst->nonatomic, val, (int)order);
+#else
+	if (order != MEMORY_ORDER_RELAXED)
+		atomic_thread_fence_release();
+	atomic_storeptr(dst, val);
+	if (order == MEMORY_ORDER_SEQ_CST)
+		atomic_thread_fence_sequentially_consistent();
+#endif
+}
+
+static FOUNDATION_FORCEINLINE int32_t
+atomic_add32_explicit(atomic32_t* val, int32_t add, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	return __atomic_add_fetch(&val->nonatomic, add, (int)order);
+#else
+	FOUNDATION_UNUSED(order);
+	return atomic_add32(val, add);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE int64_t
+atomic_add64_explicit(atomic64_t* val, int64_t add, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN64
+	return __atomic_add_fetch(&val->nonatomic, add, (int)order);
+#else
+	FOUNDATION_UNUSED(order);
+	return atomic_add64(val, add);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas32_explicit(atomic32_t* dst, int32_t val, int32_t ref, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	return __atomic_compare_exchange_n(&dst->nonatomic, &ref, val, false, (int)order,
+	                                   (int)FOUNDATION_ATOMIC_ORDER_FAIL(order));
+#else
+	FOUNDATION_UNUSED(order);
+	return atomic_cas32(dst, val, ref);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas64_explicit(atomic64_t* dst, int64_t val, int64_t ref, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN64
+	return __atomic_compare_exchange_n(&dst->nonatomic, &ref, val, false, (int)order,
+	                                   (int)FOUNDATION_ATOMIC_ORDER_FAIL(order));
+#else
+	FOUNDATION_UNUSED(order);
+	return atomic_cas64(dst, val, ref);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE bool
+atomic_cas_ptr_explicit(atomicptr_t* dst, void* val, void* ref, memory_order_t order) {
+#if FOUNDATION_ATOMIC_BUILTIN
+	return __atomic_compare_exchange_n(&dst->nonatomic, &ref, val, false, (int)order,
+	                                   (int)FOUNDATION_ATOMIC_ORDER_FAIL(order));
+#else
+	FOUNDATION_UNUSED(order);
+	return atomic_cas_ptr(dst, val, ref);
+#endif
+}
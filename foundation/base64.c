@@ -11,6 +11,28 @@
  */
 
 #include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define BASE64_SIMD_X86 1
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define BASE64_TARGET_SSSE3
+#    define BASE64_TARGET_AVX2
+#  else
+#    define BASE64_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    define BASE64_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define BASE64_SIMD_NEON 1
+#  include <arm_neon.h>
+#endif
+
+//Number of encoded characters read from the wrapped stream in one chunk, a multiple of 4
+//decoding to at most the size of the stream buffer
+#define BASE64_STREAM_TEXT_SIZE 1024
 
 /*lint -e{840}  We use null character in string literal deliberately here*/
 static const char _base64_decode[] =
@@ -18,6 +40,300 @@ static const char _base64_decode[] =
 static const char _base64_encode[] =
   "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+static stream_vtable_t _base64_stream_vtable;
+
+static FOUNDATION_FORCEINLINE bool
+base64_is_valid(char c) {
+	return (c >= 43) && (c <= 122) && _base64_decode[c - 43];
+}
+
+#if BASE64_SIMD_X86
+
+//0 for scalar only, 1 for SSSE3, 2 for AVX2
+static int _base64_simd = -1;
+
+static int
+base64_simd_level(void) {
+	if (_base64_simd < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		int level = 0;
+		__cpuid(info, 1);
+		if (info[2] & (1 << 9)) {
+			level = 1;
+			//Require OS support for saving YMM state
+			if ((info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6)) {
+				__cpuidex(info, 7, 0);
+				if (info[1] & (1 << 5))
+					level = 2;
+			}
+		}
+		_base64_simd = level;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			_base64_simd = 2;
+		else if (__builtin_cpu_supports("ssse3"))
+			_base64_simd = 1;
+		else
+			_base64_simd = 0;
+#endif
+	}
+	return _base64_simd;
+}
+
+/* Vectorized codecs as described by Wojciech Muła and Daniel Lemire, "Faster Base64 Encoding
+   and Decoding using AVX2 Instructions". Encoding spreads each 3 byte group over a 32-bit
+   word, isolates the four 6-bit indices with multiplies and translates indices to characters
+   by adding a per-range offset. Decoding validates characters by nibble lookups, translates
+   back to 6-bit values and packs four values to three bytes with multiply-add. */
+
+static BASE64_TARGET_SSSE3 __m128i
+base64_encode_unpack_ssse3(__m128i in) {
+	const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	__m128i indices = _mm_or_si128(t1, t3);
+	//Offsets for A-Z, a-z, 0-9 (ten entries), + and /
+	const __m128i offset = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19,
+	                                     -16, 0, 0);
+	__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+	return _mm_add_epi8(indices, _mm_shuffle_epi8(offset, range));
+}
+
+static BASE64_TARGET_SSSE3 size_t
+base64_encode_ssse3(const unsigned char* src, size_t size, char* dst) {
+	const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	size_t done = 0;
+	//Each step loads 16 bytes and encodes the first 12
+	while (size - done >= 16) {
+		__m128i in = _mm_loadu_si128((const __m128i*)(const void*)(src + done));
+		in = base64_encode_unpack_ssse3(_mm_shuffle_epi8(in, shuffle));
+		_mm_storeu_si128((__m128i*)(void*)dst, in);
+		dst += 16;
+		done += 12;
+	}
+	return done;
+}
+
+static BASE64_TARGET_AVX2 size_t
+base64_encode_avx2(const unsigned char* src, size_t size, char* dst) {
+	const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+	                                        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m256i offset = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19,
+	                                        -16, 0, 0, 65, 71, -4, -4, -4, -4, -4, -4, -4, -4,
+	                                        -4, -4, -19, -16, 0, 0);
+	size_t done = 0;
+	//Each step loads two overlapping 16 byte halves and encodes 24 bytes
+	while (size - done >= 28) {
+		__m256i in = _mm256_inserti128_si256(
+		               _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(const void*)(src + done))),
+		               _mm_loadu_si128((const __m128i*)(const void*)(src + done + 12)), 1);
+		__m256i t0, t1, t2, t3, range;
+		in = _mm256_shuffle_epi8(in, shuffle);
+		t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+		t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+		t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		in = _mm256_or_si256(t1, t3);
+		range = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+		range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25)));
+		in = _mm256_add_epi8(in, _mm256_shuffle_epi8(offset, range));
+		_mm256_storeu_si256((__m256i*)(void*)dst, in);
+		dst += 32;
+		done += 24;
+	}
+	return done;
+}
+
+static size_t
+base64_encode_simd(const unsigned char* src, size_t size, char* dst) {
+	int level = base64_simd_level();
+	size_t done = 0;
+	if (level > 1)
+		done = base64_encode_avx2(src, size, dst);
+	if (level > 0)
+		done += base64_encode_ssse3(src + done, size - done, dst + ((done / 3) * 4));
+	return done;
+}
+
+/* Decode one block of 16 characters (SSSE3) or 32 characters (AVX2) to 12 or 24 bytes.
+   Returns false without writing any output if the block contains any character outside the
+   base64 alphabet (including padding and line breaks), leaving it to the scalar decoder. */
+
+static BASE64_TARGET_SSSE3 bool
+base64_decode_block_ssse3(const char* src, unsigned char* dst) {
+	const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+	                                     0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+	                                     0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0,
+	                                       0, 0);
+	const __m128i nibble = _mm_set1_epi8(0x0f);
+	const __m128i slash = _mm_set1_epi8(0x2f);
+	__m128i in = _mm_loadu_si128((const __m128i*)(const void*)src);
+	__m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+	__m128i lo_nibbles = _mm_and_si128(in, nibble);
+	__m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo_nibbles),
+	                                _mm_shuffle_epi8(lut_hi, hi_nibbles));
+	__m128i roll;
+	uint32_t tail;
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xffff)
+		return false;
+	roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, slash), hi_nibbles));
+	in = _mm_add_epi8(in, roll);
+	in = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+	in = _mm_madd_epi16(in, _mm_set1_epi32(0x00011000));
+	in = _mm_shuffle_epi8(in, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+	                                        -1));
+	_mm_storel_epi64((__m128i*)(void*)dst, in);
+	tail = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(in, 8));
+	memcpy(dst + 8, &tail, 4);
+	return true;
+}
+
+static BASE64_TARGET_AVX2 bool
+base64_decode_block_avx2(const char* src, unsigned char* dst) {
+	const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+	                                        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+	                                        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+	                                        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+	                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+	                                        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+	                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0,
+	                                          0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0,
+	                                          0, 0, 0, 0, 0, 0);
+	const __m256i nibble = _mm256_set1_epi8(0x0f);
+	const __m256i slash = _mm256_set1_epi8(0x2f);
+	__m256i in = _mm256_loadu_si256((const __m256i*)(const void*)src);
+	__m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+	__m256i lo_nibbles = _mm256_and_si256(in, nibble);
+	__m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo_nibbles),
+	                                   _mm256_shuffle_epi8(lut_hi, hi_nibbles));
+	__m256i roll;
+	if (!_mm256_testz_si256(invalid, invalid))
+		return false;
+	roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, slash),
+	                                                     hi_nibbles));
+	in = _mm256_add_epi8(in, roll);
+	in = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+	in = _mm256_madd_epi16(in, _mm256_set1_epi32(0x00011000));
+	in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1,
+	                                              -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14,
+	                                              13, 12, -1, -1, -1, -1));
+	in = _mm256_permutevar8x32_epi32(in, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+	_mm_storeu_si128((__m128i*)(void*)dst, _mm256_castsi256_si128(in));
+	_mm_storel_epi64((__m128i*)(void*)(dst + 16), _mm256_extracti128_si256(in, 1));
+	return true;
+}
+
+//Decode as many leading blocks of valid characters as possible, returns number of
+//characters consumed (3 bytes written for every 4 characters)
+static size_t
+base64_decode_simd(const char* src, size_t size, unsigned char* dst, size_t capacity) {
+	int level = base64_simd_level();
+	size_t done = 0;
+	if (level > 1) {
+		while ((size - done >= 32) && (capacity >= 24) && base64_decode_block_avx2(src + done, dst)) {
+			done += 32;
+			dst += 24;
+			capacity -= 24;
+		}
+	}
+	if (level > 0) {
+		while ((size - done >= 16) && (capacity >= 12) && base64_decode_block_ssse3(src + done, dst)) {
+			done += 16;
+			dst += 12;
+			capacity -= 12;
+		}
+	}
+	return done;
+}
+
+#elif BASE64_SIMD_NEON
+
+static size_t
+base64_encode_simd(const unsigned char* src, size_t size, char* dst) {
+	const unsigned char* table = (const unsigned char*)_base64_encode;
+	const uint8x16x4_t lut = {{
+		vld1q_u8(table), vld1q_u8(table + 16), vld1q_u8(table + 32), vld1q_u8(table + 48)
+	}};
+	const uint8x16_t mask = vdupq_n_u8(0x3f);
+	size_t done = 0;
+	//De-interleave 48 bytes to three byte planes, encode four index planes and interleave
+	while (size - done >= 48) {
+		uint8x16x3_t in = vld3q_u8(src + done);
+		uint8x16x4_t out;
+		out.val[0] = vshrq_n_u8(in.val[0], 2);
+		out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+		out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+		out.val[3] = vandq_u8(in.val[2], mask);
+		out.val[0] = vqtbl4q_u8(lut, out.val[0]);
+		out.val[1] = vqtbl4q_u8(lut, out.val[1]);
+		out.val[2] = vqtbl4q_u8(lut, out.val[2]);
+		out.val[3] = vqtbl4q_u8(lut, out.val[3]);
+		vst4q_u8((uint8_t*)dst, out);
+		dst += 64;
+		done += 48;
+	}
+	return done;
+}
+
+//Sextet value for each 7-bit character, 0xff for characters outside the alphabet
+static const uint8_t _base64_decode_neon[128] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static size_t
+base64_decode_simd(const char* src, size_t size, unsigned char* dst, size_t capacity) {
+	const uint8x16x4_t lut_lo = {{
+		vld1q_u8(_base64_decode_neon), vld1q_u8(_base64_decode_neon + 16),
+		vld1q_u8(_base64_decode_neon + 32), vld1q_u8(_base64_decode_neon + 48)
+	}};
+	const uint8x16x4_t lut_hi = {{
+		vld1q_u8(_base64_decode_neon + 64), vld1q_u8(_base64_decode_neon + 80),
+		vld1q_u8(_base64_decode_neon + 96), vld1q_u8(_base64_decode_neon + 112)
+	}};
+	const uint8x16_t high = vdupq_n_u8(0x40);
+	size_t done = 0;
+	while ((size - done >= 64) && (capacity >= 48)) {
+		uint8x16x4_t in = vld4q_u8((const uint8_t*)src + done);
+		uint8x16_t error = vdupq_n_u8(0);
+		uint8x16x3_t out;
+		int i;
+		for (i = 0; i < 4; ++i) {
+			//Characters 64-127 index the upper table, anything above 127 yields an error bit
+			uint8x16_t value = vqtbx4q_u8(vqtbl4q_u8(lut_lo, in.val[i]), lut_hi,
+			                              veorq_u8(in.val[i], high));
+			error = vorrq_u8(error, vorrq_u8(value, in.val[i]));
+			in.val[i] = value;
+		}
+		if (vmaxvq_u8(error) & 0x80)
+			break;
+		out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+		vst3q_u8(dst, out);
+		dst += 48;
+		capacity -= 48;
+		done += 64;
+	}
+	return done;
+}
+
+#endif
+
 size_t
 base64_encode(const void* source, size_t size, char* destination, size_t capacity) {
 	char* ptr;
@@ -35,6 +351,14 @@ base64_encode(const void* source, size_t size, char* destination, size_t capacit
 
 	carr = (const unsigned char*)source;
 	ptr = destination;
+#if BASE64_SIMD_X86 || BASE64_SIMD_NEON
+	{
+		size_t done = base64_encode_simd(carr, size, ptr);
+		carr += done;
+		ptr += (done / 3) * 4;
+		size -= done;
+	}
+#endif
 	while (size > 2) {
 		bits = (*carr >> 2) & 0x3F;
 		*ptr++ = _base64_encode[bits];
@@ -70,13 +394,30 @@ base64_encode(const void* source, size_t size, char* destination, size_t capacit
 	return (size_t)pointer_diff(ptr, destination);
 }
 
-size_t
-base64_decode(const char* source, size_t size, void* destination, size_t capacity) {
+/* Decode groups of four valid characters, discarding invalid characters. If final is false
+   an incomplete trailing group is not decoded, and the number of characters consumed stops
+   at the start of that group. */
+static size_t
+base64_decode_groups(const char* source, size_t size, unsigned char* destination,
+                     size_t capacity, bool final, size_t* consumed) {
 	size_t i, blocksize;
-	char* cdst = (char*)destination;
-	char* cdstend = cdst + capacity;
+	const char* begin = source;
+	unsigned char* cdst = destination;
+	unsigned char* cdstend = cdst + capacity;
 	while (size && (cdst < cdstend)) {
 		unsigned char in[4] = { 0, 0, 0, 0 }; //Always build blocks of 4 bytes to decode, pad with 0
+		const char* group = source;
+#if BASE64_SIMD_X86 || BASE64_SIMD_NEON
+		if (size >= 16) {
+			size_t done = base64_decode_simd(source, size, cdst, (size_t)pointer_diff(cdstend, cdst));
+			source += done;
+			size -= done;
+			cdst += (done / 4) * 3;
+			group = source;
+			if (!size || (cdst >= cdstend))
+				break;
+		}
+#endif
 		blocksize = 0;
 		for (i = 0; size && (i < 4); i++) {
 			char v = 0;
@@ -90,15 +431,240 @@ base64_decode(const char* source, size_t size, void* destination, size_t capacit
 				--size;
 			}
 		}
+		if ((blocksize < 4) && !final) {
+			source = group;
+			break;
+		}
 		if (blocksize > 1) {
-			char out[3];
-			out[0] = (char)((in[0] << 2) | (in[1] >> 4));
-			out[1] = (char)((in[1] << 4) | (in[2] >> 2));
-			out[2] = (char)(((in[2] << 6) & 0xc0) | in[3]);
+			unsigned char out[3];
+			out[0] = (unsigned char)((in[0] << 2) | (in[1] >> 4));
+			out[1] = (unsigned char)((in[1] << 4) | (in[2] >> 2));
+			out[2] = (unsigned char)(((in[2] << 6) & 0xc0) | in[3]);
 			for (i = 0; (i < blocksize - 1) && (cdst < cdstend); ++i)
 				*cdst++ = out[i];
 		}
 	}
 
+	if (consumed)
+		*consumed = (size_t)pointer_diff(source, begin);
 	return (size_t)pointer_diff(cdst, destination);
 }
+
+size_t
+base64_decode(const char* source, size_t size, void* destination, size_t capacity) {
+	return base64_decode_groups(source, size, destination, capacity, true, 0);
+}
+
+static bool
+base64_stream_fill(stream_base64_t* base64) {
+	char text[BASE64_STREAM_TEXT_SIZE];
+	size_t read, size, consumed, ichar;
+	bool end;
+
+	if (base64->end)
+		return false;
+
+	memcpy(text, base64->carry, base64->carry_size);
+	read = stream_read(base64->stream, text + base64->carry_size,
+	                   sizeof(text) - base64->carry_size);
+	size = base64->carry_size + read;
+	end = stream_eos(base64->stream);
+
+	//Keep the valid characters of an incomplete trailing group for the next chunk
+	base64->buffer_offset = 0;
+	base64->buffer_size = base64_decode_groups(text, size, base64->buffer, sizeof(base64->buffer),
+	                                           end, &consumed);
+	base64->carry_size = 0;
+	for (ichar = consumed; (ichar < size) && (base64->carry_size < 3); ++ichar) {
+		if (base64_is_valid(text[ichar]))
+			base64->carry[base64->carry_size++] = text[ichar];
+	}
+	base64->end = end;
+
+	return (read > 0) || (base64->buffer_size > 0);
+}
+
+static size_t
+_base64_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	size_t total_read = 0;
+
+	if (base64->mode & STREAM_OUT)
+		return 0;
+
+	while (total_read < num) {
+		size_t available = base64->buffer_size - base64->buffer_offset;
+		if (!available) {
+			if (!base64_stream_fill(base64))
+				break;
+			continue;
+		}
+		if (available > num - total_read)
+			available = num - total_read;
+		memcpy(pointer_offset(dest, total_read), base64->buffer + base64->buffer_offset, available);
+		base64->buffer_offset += available;
+		total_read += available;
+	}
+
+	base64->offset += total_read;
+	return total_read;
+}
+
+static size_t
+_base64_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	const unsigned char* data = source;
+	char text[BASE64_STREAM_TEXT_SIZE + 1];
+	size_t total_written = 0;
+
+	if (!(base64->mode & STREAM_OUT))
+		return 0;
+
+	//Complete a group carried over from the previous write
+	if (base64->buffer_size) {
+		while ((base64->buffer_size < 3) && (total_written < num))
+			base64->buffer[base64->buffer_size++] = data[total_written++];
+		if (base64->buffer_size < 3) {
+			base64->offset += total_written;
+			return total_written;
+		}
+		base64_encode(base64->buffer, 3, text, sizeof(text));
+		stream_write(base64->stream, text, 4);
+		base64->buffer_size = 0;
+	}
+
+	//Padding is only written at the end of the stream, keep trailing bytes of a partial group
+	while (num - total_written >= 3) {
+		size_t chunk = ((num - total_written) / 3) * 3;
+		if (chunk > (BASE64_STREAM_TEXT_SIZE / 4) * 3)
+			chunk = (BASE64_STREAM_TEXT_SIZE / 4) * 3;
+		base64_encode(data + total_written, chunk, text, sizeof(text));
+		stream_write(base64->stream, text, (chunk / 3) * 4);
+		total_written += chunk;
+	}
+	while (total_written < num)
+		base64->buffer[base64->buffer_size++] = data[total_written++];
+
+	base64->offset += total_written;
+	return total_written;
+}
+
+static bool
+_base64_stream_eos(stream_t* stream) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	if (base64->mode & STREAM_OUT)
+		return stream_eos(base64->stream);
+	if (base64->buffer_offset < base64->buffer_size)
+		return false;
+	//Decode any carried partial group once the wrapped stream is exhausted
+	if (!base64->end && stream_eos(base64->stream))
+		base64_stream_fill(base64);
+	return base64->end && (base64->buffer_offset >= base64->buffer_size);
+}
+
+static void
+_base64_stream_flush(stream_t* stream) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	if (base64->mode & STREAM_OUT)
+		stream_flush(base64->stream);
+}
+
+static size_t
+_base64_stream_size(stream_t* stream) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	if (base64->mode & STREAM_OUT)
+		return base64->offset;
+	return 0;
+}
+
+static void
+_base64_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(offset);
+	FOUNDATION_UNUSED(direction);
+}
+
+static size_t
+_base64_stream_tell(stream_t* stream) {
+	return ((stream_base64_t*)stream)->offset;
+}
+
+static tick_t
+_base64_stream_last_modified(const stream_t* stream) {
+	return stream_last_modified(((const stream_base64_t*)stream)->stream);
+}
+
+static void
+_base64_stream_buffer_read(stream_t* stream) {
+	stream_buffer_read(((stream_base64_t*)stream)->stream);
+}
+
+static size_t
+_base64_stream_available_read(stream_t* stream) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+	if (base64->mode & STREAM_OUT)
+		return 0;
+	return base64->buffer_size - base64->buffer_offset;
+}
+
+static void
+_base64_stream_finalize(stream_t* stream) {
+	stream_base64_t* base64 = (stream_base64_t*)stream;
+
+	if (!base64 || (stream->type != STREAMTYPE_BASE64))
+		return;
+
+	if (base64->mode & STREAM_OUT) {
+		if (base64->buffer_size) {
+			char text[5];
+			base64_encode(base64->buffer, base64->buffer_size, text, sizeof(text));
+			stream_write(base64->stream, text, 4);
+			base64->buffer_size = 0;
+		}
+		stream_flush(base64->stream);
+	}
+	if (base64->own)
+		stream_deallocate(base64->stream);
+	base64->stream = 0;
+}
+
+stream_t*
+base64_stream_allocate(stream_t* stream, unsigned int mode, bool adopt) {
+	stream_base64_t* base64 = memory_allocate(HASH_STREAM, sizeof(stream_base64_t), 8,
+	                                          MEMORY_PERSISTENT);
+	base64_stream_initialize(base64, stream, mode, adopt);
+	return (stream_t*)base64;
+}
+
+void
+base64_stream_initialize(stream_base64_t* base64, stream_t* stream, unsigned int mode,
+                         bool adopt) {
+	memset(base64, 0, sizeof(stream_base64_t));
+	stream_initialize((stream_t*)base64, stream_byteorder(stream));
+
+	base64->type = STREAMTYPE_BASE64;
+	base64->sequential = true;
+	base64->reliable = stream->reliable;
+	base64->inorder = stream->inorder;
+	base64->mode = ((mode & STREAM_OUT) ? STREAM_OUT : STREAM_IN) | STREAM_BINARY;
+	base64->path = string_clone(STRING_ARGS(stream->path));
+	base64->vtable = &_base64_stream_vtable;
+	base64->stream = stream;
+	base64->own = adopt;
+}
+
+void
+_base64_stream_initialize(void) {
+	memset(&_base64_stream_vtable, 0, sizeof(_base64_stream_vtable));
+	_base64_stream_vtable.read = _base64_stream_read;
+	_base64_stream_vtable.write = _base64_stream_write;
+	_base64_stream_vtable.eos = _base64_stream_eos;
+	_base64_stream_vtable.flush = _base64_stream_flush;
+	_base64_stream_vtable.size = _base64_stream_size;
+	_base64_stream_vtable.seek = _base64_stream_seek;
+	_base64_stream_vtable.tell = _base64_stream_tell;
+	_base64_stream_vtable.lastmod = _base64_stream_last_modified;
+	_base64_stream_vtable.buffer_read = _base64_stream_buffer_read;
+	_base64_stream_vtable.available_read = _base64_stream_available_read;
+	_base64_stream_vtable.finalize = _base64_stream_finalize;
+}
@@ -16,7 +16,15 @@
 \brief Base64 encoding and decoding
 
 Base64 encoding and decoding, using [A-Z][a-z][0-9][+/] as encoding characters. For more
-information, see https://en.wikipedia.org/wiki/Base64 */
+information, see https://en.wikipedia.org/wiki/Base64
+
+Large buffers are encoded and decoded with SSSE3/AVX2 instructions on x86 processors
+supporting them, and NEON instructions on ARMv8 processors. Decoding falls back to the
+portable implementation around blocks containing line breaks, padding or other characters
+outside the encoding alphabet.
+
+A base64 stream wraps another stream, encoding data written to it or decoding data read
+from it without requiring the entire data up front. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -57,3 +65,27 @@ decode as much of the source data that fits into the destination buffer (i.e
 \return            Number of bytes written to destination buffer */
 FOUNDATION_API size_t
 base64_decode(const char* source, size_t size, void* destination, size_t capacity);
+
+/*! Allocate a base64 stream wrapping the given stream. Deallocate the stream with a call
+to #stream_deallocate, which writes the final padded group of a stream opened for writing.
+\param stream Stream to wrap
+\param mode   Open mode, STREAM_OUT to encode data written to the wrapped stream, otherwise
+              decode data read from the wrapped stream
+\param adopt  Take ownership of the wrapped stream, deallocating it with the base64 stream
+\return       New base64 stream */
+FOUNDATION_API stream_t*
+base64_stream_allocate(stream_t* stream, unsigned int mode, bool adopt);
+
+/*! Initialize a base64 stream wrapping the given stream. Finalize the stream with a call
+to #stream_finalize, which writes the final padded group of a stream opened for writing.
+Flushing a stream opened for writing does not write an incomplete trailing group, as the
+padding would end the encoded data. Invalid characters, line breaks and noise read from the
+wrapped stream are silently discarded like in #base64_decode. Base64 streams are sequential.
+\param base64 Base64 stream
+\param stream Stream to wrap
+\param mode   Open mode, STREAM_OUT to encode data written to the wrapped stream, otherwise
+              decode data read from the wrapped stream
+\param adopt  Take ownership of the wrapped stream, deallocating it with the base64 stream */
+FOUNDATION_API void
+base64_stream_initialize(stream_base64_t* base64, stream_t* stream, unsigned int mode,
+                         bool adopt);
@@ -27,6 +27,9 @@
 #define BEACON_FIRE_READING 3
 #endif
 
+//Number of kernel events fetched by a single wait call
+#define BEACON_WAIT_BATCH   64
+
 beacon_t*
 beacon_allocate(void) {
 	beacon_t* beacon = memory_allocate(0, sizeof(beacon_t), 0, MEMORY_PERSISTENT);
@@ -39,7 +42,7 @@ beacon_initialize(beacon_t* beacon) {
 	memset(beacon, 0, sizeof(beacon_t));
 #if FOUNDATION_PLATFORM_WINDOWS
 	beacon->event = CreateEventA(nullptr, FALSE, FALSE, nullptr);
-	beacon->all[0] = beacon->event;
+	array_push(beacon->all, beacon->event);
 	beacon->count = 1;
 #elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 #  if FOUNDATION_PLATFORM_LINUX
@@ -47,9 +50,10 @@ beacon_initialize(beacon_t* beacon) {
 #  else
 	beacon->fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
 #  endif
-	beacon->poll = epoll_create(sizeof(beacon->all)/sizeof(beacon->all[0]));
+	beacon->poll = epoll_create(BEACON_WAIT_BATCH);
 	beacon->count = 1;
-	beacon->all[0] = beacon->fd;
+	array_push(beacon->all, beacon->fd);
+	array_push(beacon->writable, false);
 	struct epoll_event event;
 	event.events = EPOLLIN | EPOLLERR | EPOLLHUP;
 	event.data.fd = 0;
@@ -59,7 +63,8 @@ beacon_initialize(beacon_t* beacon) {
 	beacon->kq = kqueue();
 	pipe(pipefd);
 	fcntl(pipefd[0], F_SETFL, O_NONBLOCK);
-	beacon->all[0] = pipefd[0];
+	array_push(beacon->all, pipefd[0]);
+	array_push(beacon->writable, false);
 	beacon->writefd = pipefd[1];
 	struct kevent changes;
 	EV_SET(&changes, beacon->all[0], EVFILT_READ, EV_ADD, 0, 0, nullptr);
@@ -74,16 +79,22 @@ void
 beacon_finalize(beacon_t* beacon) {
 #if FOUNDATION_PLATFORM_WINDOWS
 	CloseHandle(beacon->event);
-#elif FOUNDATION_PLATFORM_LINUX
+	array_deallocate(beacon->all);
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 	close(beacon->poll);
 	close(beacon->fd);
+	array_deallocate(beacon->all);
+	array_deallocate(beacon->writable);
 #elif FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
 	close(beacon->kq);
 	close(beacon->all[0]);
 	close(beacon->writefd);
+	array_deallocate(beacon->all);
+	array_deallocate(beacon->writable);
 #elif FOUNDATION_PLATFORM_PNACL
 	mutex_deallocate(beacon->mutex);
 #endif
+	beacon->count = 0;
 }
 
 void
@@ -106,52 +117,97 @@ beacon_wait(beacon_t* beacon) {
 int
 beacon_try_wait(beacon_t* beacon, unsigned int milliseconds) {
 	int slot = -1;
-#if FOUNDATION_PLATFORM_WINDOWS
-	unsigned int count = (unsigned int)beacon->count;
-	unsigned int wait_status = WaitForMultipleObjects(count, (HANDLE*)beacon->all,
-	                                                  FALSE, milliseconds);
-	//WAIT_OBJECT_0 value is 0, so this checks range [WAIT_OBJECT_0, WAIT_OBJECT_0+count)
-	if (wait_status < count) {
-		//Same behaviour as linux/bsd implementations, where auxiliary beacons added
-		//will remain fired after a beacon has seen it
-		if (wait_status > 0)
-			SetEvent(beacon->all[wait_status]);
-		return (int)wait_status;
-	}
-#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	if (!beacon_try_wait_many(beacon, milliseconds, &slot, 1))
+		return -1;
+	return slot;
+}
+
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+static bool
+_beacon_consume(beacon_t* beacon) {
 	if (atomic_cas32(&beacon->fired, BEACON_FIRE_READING, BEACON_FIRE_DONE)) {
 		eventfd_t value = 0;
 		eventfd_read(beacon->fd, &value);
 		atomic_cas32(&beacon->fired, BEACON_FIRE_NONE, BEACON_FIRE_READING);
-		if (value > 0)
-			return 0;
-	}
-	struct epoll_event event;
-	int ret = epoll_wait(beacon->poll, &event, 1, (int)milliseconds);
-	if (ret > 0)
-		slot = event.data.fd;
-	if (slot == 0) {
-		if (atomic_cas32(&beacon->fired, BEACON_FIRE_READING, BEACON_FIRE_DONE)) {
-			eventfd_t value = 0;
-			eventfd_read(beacon->fd, &value);
-			atomic_cas32(&beacon->fired, BEACON_FIRE_NONE, BEACON_FIRE_READING);
-			if (value > 0)
-				return 0;
-		}
-		slot = -1;
+		return (value > 0);
 	}
+	return false;
+}
+
 #elif FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
-	int ret;
-	struct timespec tspec;
-	struct timespec* timeout = nullptr;
-	struct kevent event;
+
+static bool
+_beacon_consume(beacon_t* beacon) {
 	if (atomic_cas32(&beacon->fired, BEACON_FIRE_READING, BEACON_FIRE_DONE)) {
 		char data[8];
 		while (read(beacon->all[0], data, 8) <= 0)
 			thread_yield();
 		while (read(beacon->all[0], data, 8) > 0);
 		atomic_cas32(&beacon->fired, BEACON_FIRE_NONE, BEACON_FIRE_READING);
+		return true;
+	}
+	return false;
+}
+
+#endif
+
+static size_t
+_beacon_try_wait_many(beacon_t* beacon, unsigned int milliseconds, int* slots, size_t capacity) {
+	size_t fired = 0;
+	if (!capacity)
 		return 0;
+#if FOUNDATION_PLATFORM_WINDOWS
+	unsigned int count = (unsigned int)beacon->count;
+	unsigned int base = 0;
+	while ((fired < capacity) && (base < count)) {
+		unsigned int wait_status = WaitForMultipleObjects(count - base, (HANDLE*)beacon->all + base,
+		                                                  FALSE, fired ? 0 : milliseconds);
+		//WAIT_OBJECT_0 value is 0, so this checks range [WAIT_OBJECT_0, WAIT_OBJECT_0+count)
+		if (wait_status >= count - base)
+			break;
+		base += wait_status;
+		//Same behaviour as linux/bsd implementations, where auxiliary beacons added
+		//will remain fired after a beacon has seen it
+		if (base > 0)
+			SetEvent(beacon->all[base]);
+		slots[fired++] = (int)base++;
+	}
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	struct epoll_event event[BEACON_WAIT_BATCH];
+	bool base_fired = false;
+	int ievent, ret;
+	if (_beacon_consume(beacon)) {
+		slots[fired++] = 0;
+		base_fired = true;
+		if (fired == capacity)
+			return fired;
+		milliseconds = 0;
+	}
+	ret = epoll_wait(beacon->poll, event,
+	                 (int)((capacity - fired) < BEACON_WAIT_BATCH ? (capacity - fired) : BEACON_WAIT_BATCH),
+	                 (int)milliseconds);
+	for (ievent = 0; ievent < ret; ++ievent) {
+		int slot = event[ievent].data.fd;
+		if (slot == 0) {
+			if (base_fired || !_beacon_consume(beacon))
+				continue;
+			base_fired = true;
+		}
+		slots[fired++] = slot;
+	}
+#elif FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+	struct timespec tspec;
+	struct timespec* timeout = nullptr;
+	struct kevent event[BEACON_WAIT_BATCH];
+	bool base_fired = false;
+	int ievent, ret;
+	if (_beacon_consume(beacon)) {
+		slots[fired++] = 0;
+		base_fired = true;
+		if (fired == capacity)
+			return fired;
+		milliseconds = 0;
 	}
 	if (milliseconds != (unsigned int)-1) {
 		tspec.tv_sec  = (time_t)(milliseconds / 1000);
@@ -162,21 +218,19 @@ beacon_try_wait(beacon_t* beacon, unsigned int milliseconds) {
 		}
 		timeout = &tspec;
 	}
-	ret = kevent(beacon->kq, nullptr, 0, &event, 1, timeout);
-	if (ret > 0)
-		slot = (int)(uintptr_t)event.udata;
-	else if ((ret < 0) && timeout)
+	ret = kevent(beacon->kq, nullptr, 0, event,
+	             (int)((capacity - fired) < BEACON_WAIT_BATCH ? (capacity - fired) : BEACON_WAIT_BATCH),
+	             timeout);
+	if ((ret < 0) && timeout && milliseconds)
 		thread_sleep(milliseconds);
-	if (slot == 0) {
-		if (atomic_cas32(&beacon->fired, BEACON_FIRE_READING, BEACON_FIRE_DONE)) {
-			char data[8];
-			while (read(beacon->all[0], data, 8) <= 0)
-				thread_yield();
-			while (read(beacon->all[0], data, 8) > 0);
-			atomic_cas32(&beacon->fired, BEACON_FIRE_NONE, BEACON_FIRE_READING);
-			return 0;
+	for (ievent = 0; ievent < ret; ++ievent) {
+		int slot = (int)(uintptr_t)event[ievent].udata;
+		if (slot == 0) {
+			if (base_fired || !_beacon_consume(beacon))
+				continue;
+			base_fired = true;
 		}
-		slot = -1;
+		slots[fired++] = slot;
 	}
 #elif FOUNDATION_PLATFORM_PNACL
 	bool got = false;
@@ -185,11 +239,53 @@ beacon_try_wait(beacon_t* beacon, unsigned int milliseconds) {
 	else
 		got = mutex_wait(beacon->mutex);
 	if (got) {
-		slot = 0;
+		slots[fired++] = 0;
 		mutex_unlock(beacon->mutex);
 	}
 #endif
-	return slot;
+	return fired;
+}
+
+size_t
+beacon_try_wait_many(beacon_t* beacon, unsigned int milliseconds, int* slots, size_t capacity) {
+	tick_t start, end;
+	size_t fired;
+
+	//Poll first so only blocking waits are timed
+	fired = _beacon_try_wait_many(beacon, 0, slots, capacity);
+	if (!fired && milliseconds && capacity) {
+		start = time_current();
+		fired = _beacon_try_wait_many(beacon, milliseconds, slots, capacity);
+		end = time_current();
+#if BUILD_ENABLE_LOCK_STATISTICS
+		++beacon->statistics.contentions;
+		beacon->statistics.wait_ticks += end - start;
+		if ((end - start) > beacon->statistics.peak_wait_ticks)
+			beacon->statistics.peak_wait_ticks = end - start;
+#endif
+#if !BUILD_DEPLOY
+		profile_contention(STRING_CONST("beacon_wait"), start, end);
+#else
+		FOUNDATION_UNUSED(end);
+#endif
+	}
+#if BUILD_ENABLE_LOCK_STATISTICS
+	if (fired)
+		++beacon->statistics.acquisitions;
+#endif
+	return fired;
+}
+
+lock_statistics_t
+beacon_statistics(beacon_t* beacon) {
+	lock_statistics_t statistics;
+#if BUILD_ENABLE_LOCK_STATISTICS
+	statistics = beacon->statistics;
+#else
+	FOUNDATION_UNUSED(beacon);
+	memset(&statistics, 0, sizeof(statistics));
+#endif
+	return statistics;
 }
 
 void
@@ -217,9 +313,8 @@ beacon_fire(beacon_t* beacon) {
 
 int
 beacon_add(beacon_t* beacon, void* handle) {
-	size_t numslots = sizeof(beacon->all)/sizeof(beacon->all[0]);
-	if (beacon->count < numslots) {
-		beacon->all[beacon->count] = handle;
+	if (beacon->count < MAXIMUM_WAIT_OBJECTS) {
+		array_push(beacon->all, handle);
 		return (int)beacon->count++;
 	}
 	return -1;
@@ -229,8 +324,10 @@ void
 beacon_remove(beacon_t* beacon, void* handle) {
 	size_t islot;
 	for (islot = 1; islot < beacon->count; ++islot) {
-		if (beacon->all[islot] == handle)
+		if (beacon->all[islot] == handle) {
 			beacon->all[islot] = beacon->all[--beacon->count];
+			array_pop(beacon->all);
+		}
 	}
 }
 
@@ -239,24 +336,42 @@ beacon_event_handle(beacon_t* beacon) {
 	return beacon->event;
 }
 
+void*
+beacon_slot_handle(beacon_t* beacon, int slot) {
+	if ((slot >= 0) && ((size_t)slot < beacon->count))
+		return beacon->all[slot];
+	return nullptr;
+}
+
 #endif
 
 #if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 
-int
-beacon_add(beacon_t* beacon, int fd) {
-	size_t numslots = sizeof(beacon->all)/sizeof(beacon->all[0]);
-	if (beacon->count < numslots) {
-		beacon->all[beacon->count] = fd;
+static int
+_beacon_add(beacon_t* beacon, int fd, bool writable) {
+	if (beacon->count < INT_MAX) {
 		struct epoll_event event;
-		event.events = EPOLLIN | EPOLLERR | EPOLLHUP;
+		event.events = (writable ? EPOLLOUT : EPOLLIN) | EPOLLERR | EPOLLHUP;
 		event.data.fd = (int)beacon->count;
-		epoll_ctl(beacon->poll, EPOLL_CTL_ADD, fd, &event);
+		if (epoll_ctl(beacon->poll, EPOLL_CTL_ADD, fd, &event) < 0)
+			return -1;
+		array_push(beacon->all, fd);
+		array_push(beacon->writable, writable);
 		return (int)beacon->count++;
 	}
 	return -1;
 }
 
+int
+beacon_add(beacon_t* beacon, int fd) {
+	return _beacon_add(beacon, fd, false);
+}
+
+int
+beacon_add_writable(beacon_t* beacon, int fd) {
+	return _beacon_add(beacon, fd, true);
+}
+
 void
 beacon_remove(beacon_t* beacon, int fd) {
 	size_t islot;
@@ -267,10 +382,13 @@ beacon_remove(beacon_t* beacon, int fd) {
 			--beacon->count;
 			if (islot < beacon->count) {
 				beacon->all[islot] = beacon->all[beacon->count];
-				event.events = EPOLLIN | EPOLLERR | EPOLLHUP;
+				beacon->writable[islot] = beacon->writable[beacon->count];
+				event.events = (beacon->writable[islot] ? EPOLLOUT : EPOLLIN) | EPOLLERR | EPOLLHUP;
 				event.data.fd = (int)islot;
 				epoll_ctl(beacon->poll, EPOLL_CTL_MOD, beacon->all[islot], &event);
 			}
+			array_pop(beacon->all);
+			array_pop(beacon->writable);
 		}
 	}
 }
@@ -284,34 +402,52 @@ beacon_event_handle(beacon_t* beacon) {
 
 #if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
 
-int
-beacon_add(beacon_t* beacon, int fd) {
-	size_t numslots = sizeof(beacon->all)/sizeof(beacon->all[0]);
-	if (beacon->count < numslots) {
-		beacon->all[beacon->count] = fd;
+static int
+_beacon_add(beacon_t* beacon, int fd, bool writable) {
+	if (beacon->count < INT_MAX) {
 		struct kevent changes;
-		EV_SET(&changes, fd, EVFILT_READ, EV_ADD, 0, 0, (void*)(uintptr_t)beacon->count);
-		kevent(beacon->kq, &changes, 1, 0, 0, 0);
+		EV_SET(&changes, fd, writable ? EVFILT_WRITE : EVFILT_READ, EV_ADD, 0, 0,
+		       (void*)(uintptr_t)beacon->count);
+		if (kevent(beacon->kq, &changes, 1, 0, 0, 0) < 0)
+			return -1;
+		array_push(beacon->all, fd);
+		array_push(beacon->writable, writable);
 		return (int)beacon->count++;
 	}
 	return -1;
 }
 
+int
+beacon_add(beacon_t* beacon, int fd) {
+	return _beacon_add(beacon, fd, false);
+}
+
+int
+beacon_add_writable(beacon_t* beacon, int fd) {
+	return _beacon_add(beacon, fd, true);
+}
+
 void
 beacon_remove(beacon_t* beacon, int fd) {
 	size_t islot;
 	for (islot = 1; islot < beacon->count; ++islot) {
 		if (beacon->all[islot] == fd) {
 			struct kevent changes;
-			EV_SET(&changes, fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+			EV_SET(&changes, fd, beacon->writable[islot] ? EVFILT_WRITE : EVFILT_READ, EV_DELETE,
+			       0, 0, nullptr);
 			kevent(beacon->kq, &changes, 1, 0, 0, 0);
 			--beacon->count;
 			if (islot < beacon->count) {
 				beacon->all[islot] = beacon->all[beacon->count];
+				beacon->writable[islot] = beacon->writable[beacon->count];
 				//Re-add acts as mosify
-				EV_SET(&changes, beacon->all[islot], EVFILT_READ, EV_ADD, 0, 0, (void*)(uintptr_t)islot);
+				EV_SET(&changes, beacon->all[islot],
+				       beacon->writable[islot] ? EVFILT_WRITE : EVFILT_READ, EV_ADD, 0, 0,
+				       (void*)(uintptr_t)islot);
 				kevent(beacon->kq, &changes, 1, 0, 0, 0);
 			}
+			array_pop(beacon->all);
+			array_pop(beacon->writable);
 		}
 	}
 }
@@ -322,3 +458,15 @@ beacon_event_handle(beacon_t* beacon) {
 }
 
 #endif
+
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID || \
+    FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+
+int
+beacon_slot_handle(beacon_t* beacon, int slot) {
+	if ((slot >= 0) && ((size_t)slot < beacon->count))
+		return beacon->all[slot];
+	return -1;
+}
+
+#endif
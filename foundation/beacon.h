@@ -54,6 +54,27 @@ beacon_wait(beacon_t* beacon);
 FOUNDATION_API int
 beacon_try_wait(beacon_t* beacon, unsigned int milliseconds);
 
+/*! Wait on beacon for the given amount of time and collect all events that fired
+in a single wakeup. On platforms with a persistent kernel event set (epoll, kqueue)
+the cost of a wait does not depend on the number of linked events.
+\param beacon Beacon to wait for
+\param milliseconds Timeout in milliseconds
+\param slots Array receiving indices of events causing the beacon to fire
+\param capacity Capacity of slots array
+\return Number of indices stored in slots, zero if timeout or error */
+FOUNDATION_API size_t
+beacon_try_wait_many(beacon_t* beacon, unsigned int milliseconds, int* slots, size_t capacity);
+
+/*! Get wait statistics for beacon. Acquisitions count waits where the beacon fired and
+contentions count waits that had to block, with the blocking time recorded. Beacons have
+no owner so the holder is always zero. Waits longer than the profile contention threshold
+also generate a profile block, see #profile_contention. Only gathered if
+#BUILD_ENABLE_LOCK_STATISTICS is enabled, otherwise all counters are zero.
+\param beacon Beacon
+\return Beacon wait statistics */
+FOUNDATION_API lock_statistics_t
+beacon_statistics(beacon_t* beacon);
+
 /*! Fire the beacon, using event zero
 \param beacon Beacon to fire */
 FOUNDATION_API void
@@ -63,7 +84,8 @@ beacon_fire(beacon_t* beacon);
 
 /*! Add another event source to the beacon, for example a semaphore,
 a pipe or another beacon. Any handle that can be passed to
-WaitForMultipleEvents can be added to the beacon.
+WaitForMultipleEvents can be added to the beacon, up to a total of
+MAXIMUM_WAIT_OBJECTS handles.
 \param beacon Beacon
 \param handle Handle to add
 \return index of handle in beacon, negative if error */
@@ -82,6 +104,13 @@ beacon_remove(beacon_t* beacon, void* handle);
 FOUNDATION_API void*
 beacon_event_handle(beacon_t* beacon);
 
+/*! Get OS handle linked to the beacon at the given index
+\param beacon Beacon
+\param slot Index of linked event
+\return OS handle, null if invalid index */
+FOUNDATION_API void*
+beacon_slot_handle(beacon_t* beacon, int slot);
+
 #endif
 
 #if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID || \
@@ -89,13 +118,23 @@ beacon_event_handle(beacon_t* beacon);
 
 /*! Add another event source to the beacon, for example a socket,
 a pipe or another beacon. Any file descriptor handle that can be used
-in a select/kevent call can be added to the beacon.
+in an epoll/kevent call can be added to the beacon. The number of
+linked file descriptors is only limited by the kernel event set.
 \param beacon Beacon
 \param fd File descriptor to add
 \return index of file descriptor in beacon, negative if error */
 FOUNDATION_API int
 beacon_add(beacon_t* beacon, int fd);
 
+/*! Add a file descriptor to the beacon firing when it is ready for writing, for example the
+write end of a non-blocking pipe or a socket. A file descriptor can only be added once to a
+beacon, either for read or write readiness.
+\param beacon Beacon
+\param fd File descriptor to add
+\return index of file descriptor in beacon, negative if error */
+FOUNDATION_API int
+beacon_add_writable(beacon_t* beacon, int fd);
+
 /*! Remove another event source from the beacon.
 \param beacon Beacon
 \param fd File descriptor to remove */
@@ -108,4 +147,11 @@ beacon_remove(beacon_t* beacon, int fd);
 FOUNDATION_API int
 beacon_event_handle(beacon_t* beacon);
 
+/*! Get OS file descriptor linked to the beacon at the given index
+\param beacon Beacon
+\param slot Index of linked event
+\return File descriptor, negative if invalid index */
+FOUNDATION_API int
+beacon_slot_handle(beacon_t* beacon, int slot);
+
 #endif
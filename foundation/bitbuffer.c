@@ -11,21 +11,29 @@
  */
 
 #include <foundation/foundation.h>
+#include <foundation/internal.h>
 
-static void
-_bitbuffer_get(bitbuffer_t* FOUNDATION_RESTRICT bitbuffer) {
+static uint32_t
+_bitbuffer_fetch(bitbuffer_t* FOUNDATION_RESTRICT bitbuffer) {
 	if (bitbuffer->buffer < bitbuffer->end) {
 		//For alignment required archs, we know it is 32-bit aligned already so safe casts below
-		void* bufferptr = bitbuffer->buffer;
-		bitbuffer->pending_read = bitbuffer->swap ? byteorder_swap32(*(uint32_t*)bufferptr) :
-		                          *(uint32_t*)bufferptr;
+		uint32_t value = *(uint32_t*)(void*)bitbuffer->buffer;
 		bitbuffer->buffer += 4;
+		return bitbuffer->swap ? byteorder_swap32(value) : value;
 	}
-	else if (bitbuffer->stream) {
-		bitbuffer->pending_read = stream_read_uint32(bitbuffer->stream);
+	if (bitbuffer->stream)
+		return stream_read_uint32(bitbuffer->stream);
+	return 0;
+}
+
+static void
+_bitbuffer_get(bitbuffer_t* FOUNDATION_RESTRICT bitbuffer) {
+	if (bitbuffer->lookahead) {
+		bitbuffer->pending_read = bitbuffer->lookahead_read;
+		bitbuffer->lookahead = false;
 	}
 	else {
-		bitbuffer->pending_read = 0;
+		bitbuffer->pending_read = _bitbuffer_fetch(bitbuffer);
 	}
 	bitbuffer->offset_read = 0;
 }
@@ -119,16 +127,35 @@ bitbuffer_read128(bitbuffer_t* bitbuffer, unsigned int bits) {
 
 uint64_t
 bitbuffer_read64(bitbuffer_t* bitbuffer, unsigned int bits) {
-	uint32_t val0, val1;
+	uint64_t value;
+	unsigned int curbits;
 
 	if (bits <= 32)
 		return bitbuffer_read32(bitbuffer, bits);
 	if (bits > 64)
 		bits = 64;
 
-	val0 = bitbuffer_read32(bitbuffer, 32);
-	val1 = bitbuffer_read32(bitbuffer, bits - 32);
-	return (uint64_t)val0 | ((uint64_t)val1 << 32ULL);
+	//Accumulate remaining pending bits and the following one or two chunks in a 64-bit word
+	if (bitbuffer->offset_read >= 32)
+		_bitbuffer_get(bitbuffer);
+	curbits = 32 - bitbuffer->offset_read;
+	value = (uint64_t)(bitbuffer->pending_read >> bitbuffer->offset_read);
+
+	_bitbuffer_get(bitbuffer);
+	value |= (uint64_t)bitbuffer->pending_read << curbits;
+	curbits += 32;
+
+	if (curbits < bits) {
+		_bitbuffer_get(bitbuffer);
+		value |= (uint64_t)bitbuffer->pending_read << curbits;
+		bitbuffer->offset_read = bits - curbits;
+	}
+	else {
+		bitbuffer->offset_read = 32 - (curbits - bits);
+	}
+	bitbuffer->count_read += bits;
+
+	return (bits < 64) ? (value & ((1ULL << bits) - 1)) : value;
 }
 
 float64_t
@@ -190,6 +217,98 @@ bitbuffer_read32(bitbuffer_t* bitbuffer, unsigned int bits) {
 	return ret;
 }
 
+void
+bitbuffer_read32_array(bitbuffer_t* bitbuffer, uint32_t* values, size_t count, unsigned int bits) {
+	size_t ival = 0;
+	if ((bits != 32) || (bitbuffer->offset_read < 32)) {
+		for (; ival < count; ++ival)
+			values[ival] = bitbuffer_read32(bitbuffer, bits);
+		return;
+	}
+
+	//Chunk aligned 32 bit values map directly to chunks, copy them in bulk
+	if (count && bitbuffer->lookahead) {
+		values[ival++] = bitbuffer->lookahead_read;
+		bitbuffer->lookahead = false;
+	}
+	if ((ival < count) && (bitbuffer->buffer < bitbuffer->end)) {
+		size_t chunks = count - ival;
+		size_t available = (size_t)(bitbuffer->end - bitbuffer->buffer) / 4;
+		if (chunks > available)
+			chunks = available;
+		if (bitbuffer->swap)
+			_stream_swap_array(values + ival, bitbuffer->buffer, chunks, 4);
+		else
+			memcpy(values + ival, bitbuffer->buffer, chunks * 4);
+		bitbuffer->buffer += chunks * 4;
+		ival += chunks;
+	}
+	if ((ival < count) && bitbuffer->stream)
+		ival += stream_read_uint32_array(bitbuffer->stream, values + ival, count - ival);
+	if (ival < count)
+		memset(values + ival, 0, (count - ival) * 4);
+	bitbuffer->count_read += count * 32;
+}
+
+void
+bitbuffer_read_float32_array(bitbuffer_t* bitbuffer, float32_t* values, size_t count) {
+	bitbuffer_read32_array(bitbuffer, (uint32_t*)(void*)values, count, 32);
+}
+
+uint32_t
+bitbuffer_peek32(bitbuffer_t* bitbuffer, unsigned int bits) {
+	uint64_t value;
+	unsigned int curbits;
+
+	if (!bits)
+		return 0;
+	if (bits > 32)
+		bits = 32;
+
+	if (bitbuffer->offset_read >= 32)
+		_bitbuffer_get(bitbuffer);
+
+	curbits = 32 - bitbuffer->offset_read;
+	value = (uint64_t)(bitbuffer->pending_read >> bitbuffer->offset_read);
+	if (bits > curbits) {
+		if (!bitbuffer->lookahead) {
+			bitbuffer->lookahead_read = _bitbuffer_fetch(bitbuffer);
+			bitbuffer->lookahead = true;
+		}
+		value |= (uint64_t)bitbuffer->lookahead_read << curbits;
+	}
+
+	return (uint32_t)(value & ((1ULL << bits) - 1));
+}
+
+void
+bitbuffer_consume(bitbuffer_t* bitbuffer, size_t bits) {
+	while (bits) {
+		unsigned int curbits;
+		if (bitbuffer->offset_read >= 32) {
+			//Skip whole chunks in memory buffers without reading them
+			if ((bits >= 32) && !bitbuffer->lookahead && (bitbuffer->buffer < bitbuffer->end)) {
+				size_t chunks = bits / 32;
+				size_t available = (size_t)(bitbuffer->end - bitbuffer->buffer) / 4;
+				if (chunks > available)
+					chunks = available;
+				bitbuffer->buffer += chunks * 4;
+				bitbuffer->count_read += chunks * 32;
+				bits -= chunks * 32;
+				if (!bits)
+					break;
+			}
+			_bitbuffer_get(bitbuffer);
+		}
+		curbits = 32 - bitbuffer->offset_read;
+		if (bits < curbits)
+			curbits = (unsigned int)bits;
+		bitbuffer->offset_read += curbits;
+		bitbuffer->count_read += curbits;
+		bits -= curbits;
+	}
+}
+
 void
 bitbuffer_write128(bitbuffer_t* bitbuffer, uint128_t value, unsigned int bits) {
 	if (bits <= 64) {
@@ -206,6 +325,9 @@ bitbuffer_write128(bitbuffer_t* bitbuffer, uint128_t value, unsigned int bits) {
 
 void
 bitbuffer_write64(bitbuffer_t* bitbuffer, uint64_t value, unsigned int bits) {
+	uint64_t accumulator;
+	unsigned int offset, total;
+
 	if (bits <= 32) {
 		bitbuffer_write32(bitbuffer, (uint32_t)value, bits);
 		return;
@@ -213,9 +335,27 @@ bitbuffer_write64(bitbuffer_t* bitbuffer, uint64_t value, unsigned int bits) {
 
 	if (bits > 64)
 		bits = 64;
+	if (bits < 64)
+		value &= (1ULL << bits) - 1;
 
-	bitbuffer_write32(bitbuffer, (uint32_t)value, 32);
-	bitbuffer_write32(bitbuffer, (uint32_t)(value >> 32ULL), bits - 32);
+	//Merge pending bits with the value in a 64-bit word, then output full chunks
+	offset = bitbuffer->offset_write;
+	total = offset + bits;
+	accumulator = (uint64_t)bitbuffer->pending_write | (value << offset);
+	bitbuffer->count_write += bits;
+
+	bitbuffer->pending_write = (uint32_t)accumulator;
+	_bitbuffer_put(bitbuffer);
+	bitbuffer->pending_write = (uint32_t)(accumulator >> 32ULL);
+	if (total < 64) {
+		bitbuffer->offset_write = total - 32;
+		return;
+	}
+	_bitbuffer_put(bitbuffer);
+	if (total > 64) {
+		bitbuffer->pending_write = (uint32_t)(value >> (64 - offset));
+		bitbuffer->offset_write = total - 64;
+	}
 }
 
 void
@@ -269,6 +409,71 @@ bitbuffer_write32(bitbuffer_t* bitbuffer, uint32_t value, unsigned int bits) {
 	bitbuffer->offset_write  = bits - curbits;
 }
 
+void
+bitbuffer_write32_array(bitbuffer_t* bitbuffer, const uint32_t* values, size_t count,
+                        unsigned int bits) {
+	size_t ival = 0;
+	if ((bits != 32) || bitbuffer->offset_write) {
+		for (; ival < count; ++ival)
+			bitbuffer_write32(bitbuffer, values[ival], bits);
+		return;
+	}
+
+	//Chunk aligned 32 bit values map directly to chunks, copy them in bulk
+	if (bitbuffer->buffer < bitbuffer->end) {
+		size_t chunks = count;
+		size_t available = (size_t)(bitbuffer->end - bitbuffer->buffer) / 4;
+		if (chunks > available)
+			chunks = available;
+		if (bitbuffer->swap)
+			_stream_swap_array(bitbuffer->buffer, values, chunks, 4);
+		else
+			memcpy(bitbuffer->buffer, values, chunks * 4);
+		bitbuffer->buffer += chunks * 4;
+		ival += chunks;
+	}
+	if ((ival < count) && bitbuffer->stream)
+		stream_write_uint32_array(bitbuffer->stream, values + ival, count - ival);
+	bitbuffer->count_write += count * 32;
+}
+
+void
+bitbuffer_write_float32_array(bitbuffer_t* bitbuffer, const float32_t* values, size_t count) {
+	bitbuffer_write32_array(bitbuffer, (const uint32_t*)(const void*)values, count, 32);
+}
+
+uint64_t
+bitbuffer_read_varint(bitbuffer_t* bitbuffer) {
+	uint64_t value = 0;
+	unsigned int shift;
+	for (shift = 0; shift < 64; shift += 7) {
+		uint32_t group = bitbuffer_read32(bitbuffer, 8);
+		value |= (uint64_t)(group & 0x7F) << shift;
+		if (!(group & 0x80))
+			break;
+	}
+	return value;
+}
+
+int64_t
+bitbuffer_read_varint_signed(bitbuffer_t* bitbuffer) {
+	return varint_unzigzag(bitbuffer_read_varint(bitbuffer));
+}
+
+void
+bitbuffer_write_varint(bitbuffer_t* bitbuffer, uint64_t value) {
+	while (value >= 0x80) {
+		bitbuffer_write32(bitbuffer, (uint32_t)(value & 0x7F) | 0x80, 8);
+		value >>= 7;
+	}
+	bitbuffer_write32(bitbuffer, (uint32_t)value, 8);
+}
+
+void
+bitbuffer_write_varint_signed(bitbuffer_t* bitbuffer, int64_t value) {
+	bitbuffer_write_varint(bitbuffer, varint_zigzag(value));
+}
+
 void
 bitbuffer_align_read(bitbuffer_t* bitbuffer, bool force) {
 	if (!(bitbuffer->offset_read & 31)) {  //0 or 32
@@ -17,7 +17,8 @@
 
 Bit buffer I/O for reading and writing tightly packed bits from/to a memory buffer or a stream.
 The bit buffers support reading and writing integers up to 128 bits and floats up to 64 bits
-in one operation.
+in one operation. Reads and writes of more than 32 bits are merged with the pending data in a
+64 bit word, transferring each 32 bit chunk once.
 
 The bit buffer is not inherently thread safe, synchronization must be done by caller in a
 multithreaded used case. */
@@ -96,6 +97,52 @@ bitbuffer_read_float32(bitbuffer_t* bitbuffer);
 FOUNDATION_API float64_t
 bitbuffer_read_float64(bitbuffer_t* bitbuffer);
 
+/*! Peek at up to 32 bits of data without consuming them. The bits are returned the same way
+as #bitbuffer_read32 would return them. Peeking past the pending 32 bit chunk reads the next
+chunk ahead from the buffer or stream, the chunk is then used by following reads. Combine
+with #bitbuffer_consume to decode variable length codes with a single lookup.
+\param bitbuffer  Bit buffer object
+\param bits       Number of bits to peek (max 32)
+\return           Data peeked */
+FOUNDATION_API uint32_t
+bitbuffer_peek32(bitbuffer_t* bitbuffer, unsigned int bits);
+
+/*! Consume bits without returning them, any number of bits can be skipped in one call.
+Whole 32 bit chunks in a memory buffer are skipped without being read.
+\param bitbuffer  Bit buffer object
+\param bits       Number of bits to consume */
+FOUNDATION_API void
+bitbuffer_consume(bitbuffer_t* bitbuffer, size_t bits);
+
+/*! Read an array of integers of up to 32 bits each, equivalent to calling #bitbuffer_read32
+for each value. When reading full 32 bit values at a chunk boundary the chunks are copied
+in bulk from the buffer or stream, with byte order swapped in bulk if needed.
+\param bitbuffer  Bit buffer object
+\param values     Destination array
+\param count      Number of values to read
+\param bits       Number of bits per value (max 32) */
+FOUNDATION_API void
+bitbuffer_read32_array(bitbuffer_t* bitbuffer, uint32_t* values, size_t count, unsigned int bits);
+
+/*! Read an array of floats, 32 bits each, see #bitbuffer_read32_array
+\param bitbuffer  Bit buffer object
+\param values     Destination array
+\param count      Number of values to read */
+FOUNDATION_API void
+bitbuffer_read_float32_array(bitbuffer_t* bitbuffer, float32_t* values, size_t count);
+
+/*! Read varint coded integer, see #bitbuffer_write_varint
+\param bitbuffer  Bit buffer object
+\return           Data read */
+FOUNDATION_API uint64_t
+bitbuffer_read_varint(bitbuffer_t* bitbuffer);
+
+/*! Read zigzag and varint coded integer, see #bitbuffer_write_varint_signed
+\param bitbuffer  Bit buffer object
+\return           Data read */
+FOUNDATION_API int64_t
+bitbuffer_read_varint_signed(bitbuffer_t* bitbuffer);
+
 /*! Write up to 32 bits of integer data
 \param bitbuffer  Bit buffer object
 \param value      Data to write
@@ -129,6 +176,38 @@ bitbuffer_write_float32(bitbuffer_t* bitbuffer, float32_t value);
 FOUNDATION_API void
 bitbuffer_write_float64(bitbuffer_t* bitbuffer, float64_t value);
 
+/*! Write an array of integers of up to 32 bits each, equivalent to calling
+#bitbuffer_write32 for each value. When writing full 32 bit values at a chunk boundary the
+chunks are copied in bulk to the buffer or stream, with byte order swapped in bulk if needed.
+\param bitbuffer  Bit buffer object
+\param values     Data to write
+\param count      Number of values to write
+\param bits       Number of bits per value (max 32) */
+FOUNDATION_API void
+bitbuffer_write32_array(bitbuffer_t* bitbuffer, const uint32_t* values, size_t count,
+                        unsigned int bits);
+
+/*! Write an array of floats, 32 bits each, see #bitbuffer_write32_array
+\param bitbuffer  Bit buffer object
+\param values     Data to write
+\param count      Number of values to write */
+FOUNDATION_API void
+bitbuffer_write_float32_array(bitbuffer_t* bitbuffer, const float32_t* values, size_t count);
+
+/*! Write integer data varint coded in groups of 8 bits, seven data bits and one
+continuation bit, see #varint_encode. Values less than 128 use 8 bits.
+\param bitbuffer  Bit buffer object
+\param value      Data to write */
+FOUNDATION_API void
+bitbuffer_write_varint(bitbuffer_t* bitbuffer, uint64_t value);
+
+/*! Write integer data zigzag and varint coded, see #varint_zigzag. Values in the range
+[-64,63] use 8 bits.
+\param bitbuffer  Bit buffer object
+\param value      Data to write */
+FOUNDATION_API void
+bitbuffer_write_varint_signed(bitbuffer_t* bitbuffer, int64_t value);
+
 /*! Align input to next even 32-bit boundary. Any remaining pending bit data is discarded,
 a new 32 bit chunk is read from the buffer and bit pointer is set to first bit in that
 chunk. If a full 32 bit chunk is available nothing is done, unless force flag is set
@@ -348,6 +348,42 @@ _blowfish_decrypt_words(const blowfish_t* blowfish, uint32_t* lvalres, uint32_t*
 
 #undef FEISTEL
 
+//Counter mode keystream, encrypting successive values of the 64-bit counter. Keystream
+//blocks are independent, four are generated per step to overlap their latencies
+static void
+_blowfish_counter(const blowfish_t* blowfish, void* data, size_t length, uint64_t counter) {
+	uint32_t* FOUNDATION_RESTRICT cur = data;
+	uint32_t stream[8];
+	size_t iblock, blocks = length / 8;
+
+	while (blocks) {
+		size_t count = (blocks < 4) ? blocks : 4;
+		for (iblock = 0; iblock < count; ++iblock, ++counter) {
+			stream[iblock * 2] = (uint32_t)((counter >> 32ULL) & 0xFFFFFFFFU);
+			stream[(iblock * 2) + 1] = (uint32_t)(counter & 0xFFFFFFFFU);
+		}
+		for (iblock = 0; iblock < count; ++iblock)
+			_blowfish_encrypt_words(blowfish, stream + (iblock * 2), stream + (iblock * 2) + 1);
+		for (iblock = 0; iblock < count * 2; ++iblock)
+			cur[iblock] ^= stream[iblock];
+		cur += count * 2;
+		blocks -= count;
+	}
+
+	if (length % 8) {
+		unsigned char* FOUNDATION_RESTRICT bytes = (unsigned char*)cur;
+		const unsigned char* keystream = (const unsigned char*)stream;
+		stream[0] = (uint32_t)((counter >> 32ULL) & 0xFFFFFFFFU);
+		stream[1] = (uint32_t)(counter & 0xFFFFFFFFU);
+		_blowfish_encrypt_words(blowfish, stream, stream + 1);
+		for (iblock = 0; iblock < (length % 8); ++iblock)
+			bytes[iblock] ^= keystream[iblock];
+	}
+
+	//Reset memory for paranoids
+	memset(stream, 0, sizeof(stream));
+}
+
 blowfish_t*
 blowfish_allocate(void) {
 	return memory_allocate(0, sizeof(blowfish_t), 0U, MEMORY_PERSISTENT);
@@ -416,11 +452,14 @@ blowfish_encrypt(const blowfish_t* blowfish, void* data, size_t length,
 	uint32_t* FOUNDATION_RESTRICT cur;
 	uint32_t* FOUNDATION_RESTRICT end;
 	uint32_t chain[2];
+	size_t tail;
 
+	//Counter mode also processes a final partial block
+	tail = (mode == BLOCKCIPHER_CTR) ? (length % 8) : 0;
 	if (length % 8)
 		length -= (length % 8);
 
-	if (!data || !length)
+	if (!data || !(length + tail))
 		return;
 
 	FOUNDATION_ASSERT_PLATFORM_ALIGNMENT(data, 4);
@@ -465,6 +504,10 @@ blowfish_encrypt(const blowfish_t* blowfish, void* data, size_t length,
 			cur[1] ^= chain[1];
 		}
 		break;
+
+	case BLOCKCIPHER_CTR:
+		_blowfish_counter(blowfish, data, length + tail, vec);
+		break;
 	}
 
 	//Reset memory for paranoids
@@ -481,11 +524,14 @@ blowfish_decrypt(const blowfish_t* blowfish, void* data, size_t length,
 	uint32_t chain[2];
 	uint32_t prev_chain[2];
 	uint32_t swap_chain[2];
+	size_t tail;
 
+	//Counter mode also processes a final partial block
+	tail = (mode == BLOCKCIPHER_CTR) ? (length % 8) : 0;
 	if (length % 8)
 		length -= (length % 8);
 
-	if (!data || !length)
+	if (!data || !(length + tail))
 		return;
 
 	/*lint --e{826} */
@@ -540,6 +586,10 @@ blowfish_decrypt(const blowfish_t* blowfish, void* data, size_t length,
 			cur[1] ^= chain[1];
 		}
 		break;
+
+	case BLOCKCIPHER_CTR:
+		_blowfish_counter(blowfish, data, length + tail, vec);
+		break;
 	}
 
 	//Reset memory for paranoids
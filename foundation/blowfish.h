@@ -51,24 +51,32 @@ blowfish_finalize(blowfish_t* blowfish);
 
 /*! Encrypt data using the given blowfish state object. Encryption is done in-place,
 no memory allocation is done internally. Length is expected to be a multiple of 8
-bytes (any extra unaligned data will be ignored).
+bytes (any extra unaligned data will be ignored), except in counter mode where a final
+partial block is also processed.
 \param blowfish Blowfish state object
 \param data     Data buffer
 \param length   Length of data buffer in bytes
 \param mode     Mode of operation (see #blockcipher_mode_t)
-\param vec      Initialization vector */
+\param vec      Initialization vector. In counter mode this is the counter of the first
+                block, incremented by one for each block. Data can be split in parts at
+                8 byte boundaries and processed independently, for example by multiple
+                threads, by passing vec plus the block index of the start of each part */
 FOUNDATION_API void
 blowfish_encrypt(const blowfish_t* blowfish, void* data, size_t length,
                  blockcipher_mode_t mode, uint64_t vec);
 
 /*! Decrypt data using the given blowfish state object. Decryption is done in-place,
 no memory allocation is done internally. Length is expected to be a multiple of 8
-bytes (any extra unaligned data will be ignored).
+bytes (any extra unaligned data will be ignored), except in counter mode where a final
+partial block is also processed.
 \param blowfish Blowfish state object
 \param data     Data buffer
 \param length   Length of data buffer in bytes
 \param mode     Mode of operation (see #blockcipher_mode_t)
-\param vec      Initialization vector */
+\param vec      Initialization vector. In counter mode this is the counter of the first
+                block, incremented by one for each block. Data can be split in parts at
+                8 byte boundaries and processed independently, for example by multiple
+                threads, by passing vec plus the block index of the start of each part */
 FOUNDATION_API void
 blowfish_decrypt(const blowfish_t* blowfish, void* data, size_t length,
                  blockcipher_mode_t mode, uint64_t vec);
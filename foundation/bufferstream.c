@@ -13,7 +13,21 @@
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
 
+#define BUFFER_STREAM_SEGMENT_SIZE (64 * 1024)
+
+struct stream_segmented_t {
+	FOUNDATION_DECLARE_STREAM;
+	void** segment;
+	size_t segment_size;
+	size_t size;
+	size_t current;
+	tick_t lastmod;
+};
+
+typedef FOUNDATION_ALIGN(8) struct stream_segmented_t stream_segmented_t;
+
 static stream_vtable_t _buffer_stream_vtable;
+static stream_vtable_t _segmented_stream_vtable;
 
 stream_t*
 buffer_stream_allocate(void* buffer, unsigned int mode, size_t size, size_t capacity,
@@ -211,6 +225,183 @@ _buffer_stream_available_read(stream_t* stream) {
 	return buffer_stream->size - buffer_stream->current;
 }
 
+stream_t*
+buffer_stream_allocate_segmented(unsigned int mode, size_t segment_size) {
+	stream_segmented_t* stream = memory_allocate(HASH_STREAM, sizeof(stream_segmented_t), 8,
+	                                             MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_initialize((stream_t*)stream, system_byteorder());
+
+	stream->type = STREAMTYPE_SEGMENTED;
+	stream->path = string_allocate_format(STRING_CONST("buffer://0x%" PRIfixPTR), (uintptr_t)stream);
+	stream->mode = mode & (STREAM_OUT | STREAM_IN | STREAM_BINARY);
+	stream->segment_size = segment_size ? segment_size : BUFFER_STREAM_SEGMENT_SIZE;
+	stream->lastmod = time_current();
+	stream->vtable = &_segmented_stream_vtable;
+
+	return (stream_t*)stream;
+}
+
+size_t
+buffer_stream_segments(stream_t* stream, stream_span_t* spans, size_t capacity) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	size_t count, iseg;
+
+	if (!stream || (stream->type != STREAMTYPE_SEGMENTED) || !segmented->size)
+		return 0;
+
+	count = ((segmented->size - 1) / segmented->segment_size) + 1;
+	for (iseg = 0; (iseg < count) && (iseg < capacity); ++iseg) {
+		size_t offset = iseg * segmented->segment_size;
+		size_t remain = segmented->size - offset;
+		spans[iseg].data = segmented->segment[iseg];
+		spans[iseg].size = (remain < segmented->segment_size) ? remain : segmented->segment_size;
+	}
+	return count;
+}
+
+static void
+_segmented_stream_finalize(stream_t* stream) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	size_t iseg, count;
+
+	if (!segmented || (stream->type != STREAMTYPE_SEGMENTED))
+		return;
+
+	for (iseg = 0, count = array_size(segmented->segment); iseg < count; ++iseg)
+		memory_deallocate(segmented->segment[iseg]);
+	array_deallocate(segmented->segment);
+	segmented->size = 0;
+	segmented->current = 0;
+}
+
+//Make sure segments are allocated to hold the given number of bytes
+static void
+_segmented_stream_reserve(stream_segmented_t* segmented, size_t size) {
+	size_t need = size ? ((size - 1) / segmented->segment_size) + 1 : 0;
+	while (array_size(segmented->segment) < need) {
+		void* segment = memory_allocate(HASH_STREAM, segmented->segment_size, 0, MEMORY_PERSISTENT);
+		array_push(segmented->segment, segment);
+	}
+}
+
+static size_t
+_segmented_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	size_t available = segmented->size - segmented->current;
+	size_t num_read = (num < available) ? num : available;
+	size_t remain = num_read;
+
+	while (remain) {
+		size_t iseg = segmented->current / segmented->segment_size;
+		size_t offset = segmented->current % segmented->segment_size;
+		size_t chunk = segmented->segment_size - offset;
+		if (chunk > remain)
+			chunk = remain;
+		memcpy(dest, pointer_offset(segmented->segment[iseg], offset), chunk);
+		dest = pointer_offset(dest, chunk);
+		segmented->current += chunk;
+		remain -= chunk;
+	}
+
+	return num_read;
+}
+
+static size_t
+_segmented_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	size_t remain = num;
+
+	_segmented_stream_reserve(segmented, segmented->current + num);
+	while (remain) {
+		size_t iseg = segmented->current / segmented->segment_size;
+		size_t offset = segmented->current % segmented->segment_size;
+		size_t chunk = segmented->segment_size - offset;
+		if (chunk > remain)
+			chunk = remain;
+		memcpy(pointer_offset(segmented->segment[iseg], offset), source, chunk);
+		source = pointer_offset_const(source, chunk);
+		segmented->current += chunk;
+		remain -= chunk;
+	}
+	if (segmented->current > segmented->size)
+		segmented->size = segmented->current;
+	segmented->lastmod = time_current();
+
+	return num;
+}
+
+static bool
+_segmented_stream_eos(stream_t* stream) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	return segmented->current >= segmented->size;
+}
+
+static void
+_segmented_stream_truncate(stream_t* stream, size_t size) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	size_t need = size ? ((size - 1) / segmented->segment_size) + 1 : 0;
+
+	if (size > segmented->size) {
+		//Zero fill the extended range
+		size_t position = segmented->size;
+		_segmented_stream_reserve(segmented, size);
+		while (position < size) {
+			size_t offset = position % segmented->segment_size;
+			size_t chunk = segmented->segment_size - offset;
+			if (chunk > size - position)
+				chunk = size - position;
+			memset(pointer_offset(segmented->segment[position / segmented->segment_size], offset), 0,
+			       chunk);
+			position += chunk;
+		}
+	}
+	else {
+		while (array_size(segmented->segment) > need) {
+			memory_deallocate(segmented->segment[array_size(segmented->segment) - 1]);
+			array_pop(segmented->segment);
+		}
+	}
+
+	segmented->size = size;
+	if (segmented->current > segmented->size)
+		segmented->current = segmented->size;
+	segmented->lastmod = time_current();
+}
+
+static size_t
+_segmented_stream_size(stream_t* stream) {
+	return ((const stream_segmented_t*)stream)->size;
+}
+
+static void
+_segmented_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_segmented_t* segmented = (stream_segmented_t*)stream;
+	ssize_t position = offset;
+	if (direction == STREAM_SEEK_CURRENT)
+		position += (ssize_t)segmented->current;
+	else if (direction == STREAM_SEEK_END)
+		position += (ssize_t)segmented->size;
+	if (position < 0)
+		position = 0;
+	segmented->current = ((size_t)position < segmented->size) ? (size_t)position : segmented->size;
+}
+
+static size_t
+_segmented_stream_tell(stream_t* stream) {
+	return ((const stream_segmented_t*)stream)->current;
+}
+
+static tick_t
+_segmented_stream_lastmod(const stream_t* stream) {
+	return ((const stream_segmented_t*)stream)->lastmod;
+}
+
+static size_t
+_segmented_stream_available_read(stream_t* stream) {
+	const stream_segmented_t* segmented = (const stream_segmented_t*)stream;
+	return segmented->size - segmented->current;
+}
+
 void
 _buffer_stream_initialize(void) {
 	memset(&_buffer_stream_vtable, 0, sizeof(_buffer_stream_vtable));
@@ -225,4 +416,17 @@ _buffer_stream_initialize(void) {
 	_buffer_stream_vtable.lastmod = _buffer_stream_lastmod;
 	_buffer_stream_vtable.available_read = _buffer_stream_available_read;
 	_buffer_stream_vtable.finalize = _buffer_stream_finalize;
+
+	memset(&_segmented_stream_vtable, 0, sizeof(_segmented_stream_vtable));
+	_segmented_stream_vtable.read = _segmented_stream_read;
+	_segmented_stream_vtable.write = _segmented_stream_write;
+	_segmented_stream_vtable.eos = _segmented_stream_eos;
+	_segmented_stream_vtable.flush = _buffer_stream_flush;
+	_segmented_stream_vtable.truncate = _segmented_stream_truncate;
+	_segmented_stream_vtable.size = _segmented_stream_size;
+	_segmented_stream_vtable.seek = _segmented_stream_seek;
+	_segmented_stream_vtable.tell = _segmented_stream_tell;
+	_segmented_stream_vtable.lastmod = _segmented_stream_lastmod;
+	_segmented_stream_vtable.available_read = _segmented_stream_available_read;
+	_segmented_stream_vtable.finalize = _segmented_stream_finalize;
 }
@@ -19,7 +19,11 @@ Stream for memory buffer, both statically sized and dynamically reallocated buff
 not inherently thread safe, synchronization in a multithread use case must be done by caller.
 
 Seeking in a buffer stream will not resize the storage buffer or change the current stream size.
-To change stream size and allocate buffer space use #stream_truncate. */
+To change stream size and allocate buffer space use #stream_truncate.
+
+A growing buffer stream reallocates and copies the entire buffer as it grows. For large outputs
+built in memory use a segmented buffer stream, see #buffer_stream_allocate_segmented, which
+stores data in a chain of fixed size segments that are never moved once allocated. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -53,3 +57,26 @@ a call to #stream_finalize
 FOUNDATION_API void
 buffer_stream_initialize(stream_buffer_t* stream, void* buffer, unsigned int mode,
                          size_t size, size_t capacity, bool adopt, bool grow);
+
+/*! Allocate a new segmented buffer stream. Data is stored in a chain of fixed size segments,
+growing the stream allocates new segments without moving or copying existing data. The
+stream should be deallocated with a call to #stream_deallocate.
+\param mode         Stream open mode
+\param segment_size Size of each segment in bytes, zero for default (64KiB)
+\return             New stream */
+FOUNDATION_API stream_t*
+buffer_stream_allocate_segmented(unsigned int mode, size_t segment_size);
+
+/*! Get the spans of the segments holding the content of a segmented buffer stream, for
+example to pass to #stream_write_vector without first gathering the data in a contiguous
+buffer. The spans cover the stream content from start to end, the last span is only filled
+up to the stream size. Spans are valid until the stream is written past the current end of
+stream, truncated or deallocated.
+\param stream   Segmented buffer stream
+\param spans    Array receiving spans, may be null if capacity is zero
+\param capacity Capacity of spans array
+\return         Total number of spans, which may exceed capacity in which case only the
+                first capacity spans are stored. Zero if stream is not a segmented buffer
+                stream or is empty */
+FOUNDATION_API size_t
+buffer_stream_segments(stream_t* stream, stream_span_t* spans, size_t capacity);
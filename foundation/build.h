@@ -78,6 +78,12 @@ Control if debug logging is enabled. Similar to BUILD_ENABLE_LOG, but explicitly
 debug level logging. Default value is enabled in debug builds, and disabled in all other
 builds. Depends on #BUILD_ENABLE_LOG
 
+\def BUILD_LOG_LEVEL
+Minimum severity level of debug, info and warning log messages compiled in, as an
+#error_level_t value. Calls below this level reduce to void (no evaluated code) at the call
+site, while the library itself still provides the functions. Default value is 0
+(ERRORLEVEL_NONE), compiling in all levels. Error and panic messages are never removed.
+
 \def BUILD_ENABLE_CONFIG_DEBUG
 Control if extra debug logging is enabled in the config module. Default is disabled in
 all builds.
@@ -111,11 +117,34 @@ For more information on memory guarding, check the memory.h documentation.
 Enable gathering of memory allocation statistics. By default enabled in debug and release
 builds, disabled in profile and deploy builds.
 
+\def BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+Enable gathering of memory allocation statistics per memory context. By default enabled in
+debug and release builds, disabled in profile and deploy builds. Requires memory context
+tracking to be enabled. Context statistics incurs a 16 byte memory overhead on each allocation
+passed to the memory system, storing the context and size of the allocation.
+
+\def BUILD_ENABLE_MEMORY_HISTOGRAM
+Enable gathering of histograms of allocation sizes, alignment requests and block lifetimes,
+see #memory_histogram. Disabled by default in all builds. Requires memory context statistics
+to be enabled, and grows the context statistics header to 32 bytes to store the allocation
+time and hint of each block.
+
+\def BUILD_ENABLE_EVENT_STATISTICS
+Enable gathering of event stream statistics. By default enabled in debug, release and
+profile builds, disabled in deploy builds. Counters are updated while holding the event
+stream staging block lock and incur no extra atomic operations.
+
+\def BUILD_ENABLE_LOCK_STATISTICS
+Enable gathering of lock contention statistics for mutexes and beacons. By default enabled
+in debug, release and profile builds, disabled in deploy builds. Only contended lock
+acquisitions and blocking waits are timed, uncontended operations only increment a counter.
+
 \def BUILD_ENABLE_STATIC_HASH_DEBUG
 Control if static string hashing debugging is enabled. Default value is enabled in debug
 and release builds on desktop platforms, and disabled all other build configurations
 and/or platforms. Static string hash debugging enables sanity checking in statically
-hashed strings, as well as reverse lookup of string hashes. See hash.h documentation for
+hashed strings, as well as registering them for reverse lookup of string hashes. The reverse
+lookup store itself is available in all builds. See hash.h documentation for
 more information on statically hashed strings.
 
 \def BUILD_MONOLITHIC
@@ -185,6 +214,10 @@ and disabled in all other configurations.
 #endif
 #endif
 
+#ifndef BUILD_LOG_LEVEL
+#define BUILD_LOG_LEVEL                       0
+#endif
+
 #define BUILD_ENABLE_CONFIG_DEBUG             0
 
 #ifndef BUILD_ENABLE_PROFILE
@@ -227,6 +260,39 @@ and disabled in all other configurations.
 #endif
 #endif
 
+#ifndef BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+#if ( BUILD_DEBUG || BUILD_RELEASE ) && BUILD_ENABLE_MEMORY_CONTEXT
+#define BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS 1
+#else
+#define BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS 0
+#endif
+#endif
+
+#ifndef BUILD_ENABLE_MEMORY_HISTOGRAM
+#define BUILD_ENABLE_MEMORY_HISTOGRAM         0
+#endif
+
+#if !BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+#undef  BUILD_ENABLE_MEMORY_HISTOGRAM
+#define BUILD_ENABLE_MEMORY_HISTOGRAM         0
+#endif
+
+#ifndef BUILD_ENABLE_EVENT_STATISTICS
+#if BUILD_DEBUG || BUILD_RELEASE || BUILD_PROFILE
+#define BUILD_ENABLE_EVENT_STATISTICS         1
+#else
+#define BUILD_ENABLE_EVENT_STATISTICS         0
+#endif
+#endif
+
+#ifndef BUILD_ENABLE_LOCK_STATISTICS
+#if BUILD_DEBUG || BUILD_RELEASE || BUILD_PROFILE
+#define BUILD_ENABLE_LOCK_STATISTICS          1
+#else
+#define BUILD_ENABLE_LOCK_STATISTICS          0
+#endif
+#endif
+
 #ifndef BUILD_ENABLE_STATIC_HASH_DEBUG
 #if ( BUILD_DEBUG || BUILD_RELEASE ) && FOUNDATION_PLATFORM_FAMILY_DESKTOP
 #define BUILD_ENABLE_STATIC_HASH_DEBUG        1
@@ -249,6 +315,18 @@ Default value is little endian, matching most supported architectures. */
 /*! The maximum length of a stream path string. Used to limit temporary memory usage. */
 #define BUILD_MAX_PATHLEN                     512
 
+/*! Number of thread local string buffers, used in turn by #string_thread_buffer and the
+string_from_*_static functions. A buffer is valid until this many more buffers have been
+handed out on the same thread. */
+#ifndef BUILD_THREAD_STRING_BUFFERS
+#define BUILD_THREAD_STRING_BUFFERS           4
+#endif
+
+/*! Size in bytes of each thread local string buffer. */
+#ifndef BUILD_THREAD_STRING_BUFFER_SIZE
+#define BUILD_THREAD_STRING_BUFFER_SIZE       BUILD_MAX_PATHLEN
+#endif
+
 
 #if defined(FOUNDATION_PLATFORM_DOXYGEN) && FOUNDATION_PLATFORM_DOXYGEN
 
@@ -260,12 +338,19 @@ Default value is little endian, matching most supported architectures. */
 #define BUILD_ENABLE_ERROR_CONTEXT
 #define BUILD_ENABLE_LOG
 #define BUILD_ENABLE_DEBUG_LOG
+#define BUILD_LOG_LEVEL
 #define BUILD_ENABLE_CONFIG_DEBUG
 #define BUILD_ENABLE_PROFILE
 #define BUILD_ENABLE_MEMORY_CONTEXT
 #define BUILD_ENABLE_MEMORY_TRACKER
 #define BUILD_ENABLE_MEMORY_GUARD
+#define BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+#define BUILD_ENABLE_MEMORY_HISTOGRAM
+#define BUILD_ENABLE_EVENT_STATISTICS
+#define BUILD_ENABLE_LOCK_STATISTICS
 #define BUILD_ENABLE_STATIC_HASH_DEBUG
 #define BUILD_MONOLITHIC
+#define BUILD_THREAD_STRING_BUFFERS
+#define BUILD_THREAD_STRING_BUFFER_SIZE
 
 #endif
@@ -0,0 +1,479 @@
+/* checksum.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define CHECKSUM_CRC32C_SSE42 1
+#  include <nmmintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define CHECKSUM_TARGET_SSE42
+#  else
+#    define CHECKSUM_TARGET_SSE42 __attribute__((target("sse4.2")))
+#  endif
+#elif defined(__ARM_FEATURE_CRC32)
+#  define CHECKSUM_CRC32C_ARM 1
+#  include <arm_acle.h>
+#endif
+
+#define CRC32C_POLYNOMIAL 0x82F63B78U
+
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+//Slicing-by-8 tables for software CRC-32C
+static uint32_t _checksum_crc32c_table[8][256];
+static bool _checksum_crc32c_hardware;
+
+static stream_vtable_t _checksum_stream_vtable;
+
+static uint32_t
+_checksum_crc32c_software(uint32_t crc, const uint8_t* data, size_t size) {
+	while (size && ((uintptr_t)data & 7)) {
+		crc = _checksum_crc32c_table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+		--size;
+	}
+	while (size >= 8) {
+		uint32_t low = byteorder_littleendian32(*(const uint32_t*)data) ^ crc;
+		uint32_t high = byteorder_littleendian32(*(const uint32_t*)(data + 4));
+		crc = _checksum_crc32c_table[7][low & 0xFF] ^
+		      _checksum_crc32c_table[6][(low >> 8) & 0xFF] ^
+		      _checksum_crc32c_table[5][(low >> 16) & 0xFF] ^
+		      _checksum_crc32c_table[4][low >> 24] ^
+		      _checksum_crc32c_table[3][high & 0xFF] ^
+		      _checksum_crc32c_table[2][(high >> 8) & 0xFF] ^
+		      _checksum_crc32c_table[1][(high >> 16) & 0xFF] ^
+		      _checksum_crc32c_table[0][high >> 24];
+		data += 8;
+		size -= 8;
+	}
+	while (size--)
+		crc = _checksum_crc32c_table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+	return crc;
+}
+
+#if CHECKSUM_CRC32C_SSE42
+
+static CHECKSUM_TARGET_SSE42 uint32_t
+_checksum_crc32c_sse42(uint32_t crc, const uint8_t* data, size_t size) {
+	while (size && ((uintptr_t)data & 7)) {
+		crc = _mm_crc32_u8(crc, *data++);
+		--size;
+	}
+#if FOUNDATION_ARCH_X86_64
+	uint64_t crc64 = crc;
+	while (size >= 8) {
+		crc64 = _mm_crc32_u64(crc64, *(const uint64_t*)data);
+		data += 8;
+		size -= 8;
+	}
+	crc = (uint32_t)crc64;
+#else
+	while (size >= 4) {
+		crc = _mm_crc32_u32(crc, *(const uint32_t*)data);
+		data += 4;
+		size -= 4;
+	}
+#endif
+	while (size--)
+		crc = _mm_crc32_u8(crc, *data++);
+	return crc;
+}
+
+static bool
+_checksum_crc32c_sse42_supported(void) {
+#if FOUNDATION_COMPILER_MSVC
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+
+#elif CHECKSUM_CRC32C_ARM
+
+static uint32_t
+_checksum_crc32c_arm(uint32_t crc, const uint8_t* data, size_t size) {
+	while (size && ((uintptr_t)data & 7)) {
+		crc = __crc32cb(crc, *data++);
+		--size;
+	}
+	while (size >= 8) {
+		crc = __crc32cd(crc, *(const uint64_t*)data);
+		data += 8;
+		size -= 8;
+	}
+	while (size--)
+		crc = __crc32cb(crc, *data++);
+	return crc;
+}
+
+#endif
+
+static uint32_t
+_checksum_crc32c(uint32_t crc, const uint8_t* data, size_t size) {
+#if CHECKSUM_CRC32C_SSE42
+	if (_checksum_crc32c_hardware)
+		return _checksum_crc32c_sse42(crc, data, size);
+#elif CHECKSUM_CRC32C_ARM
+	return _checksum_crc32c_arm(crc, data, size);
+#endif
+	return _checksum_crc32c_software(crc, data, size);
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+_xxh_read64(const uint8_t* data) {
+	uint64_t value;
+	memcpy(&value, data, sizeof(value));
+	return byteorder_littleendian64(value);
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+_xxh_read32(const uint8_t* data) {
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return byteorder_littleendian32(value);
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+_xxh_rotl64(uint64_t value, unsigned int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+_xxh_round(uint64_t acc, uint64_t input) {
+	acc += input * XXH_PRIME64_2;
+	acc = _xxh_rotl64(acc, 31);
+	return acc * XXH_PRIME64_1;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+_xxh_merge_round(uint64_t acc, uint64_t value) {
+	acc ^= _xxh_round(0, value);
+	return (acc * XXH_PRIME64_1) + XXH_PRIME64_4;
+}
+
+static const uint8_t*
+_xxh_stripes(uint64_t* state, const uint8_t* data, size_t count) {
+	uint64_t v1 = state[0], v2 = state[1], v3 = state[2], v4 = state[3];
+	while (count--) {
+		v1 = _xxh_round(v1, _xxh_read64(data));
+		v2 = _xxh_round(v2, _xxh_read64(data + 8));
+		v3 = _xxh_round(v3, _xxh_read64(data + 16));
+		v4 = _xxh_round(v4, _xxh_read64(data + 24));
+		data += 32;
+	}
+	state[0] = v1;
+	state[1] = v2;
+	state[2] = v3;
+	state[3] = v4;
+	return data;
+}
+
+static uint64_t
+_xxh_value(const checksum_t* checksum) {
+	const uint64_t* state = checksum->state;
+	const uint8_t* data = checksum->buffer;
+	size_t remain = (size_t)(checksum->size & 31);
+	uint64_t hash;
+
+	if (checksum->size >= 32) {
+		hash = _xxh_rotl64(state[0], 1) + _xxh_rotl64(state[1], 7) +
+		       _xxh_rotl64(state[2], 12) + _xxh_rotl64(state[3], 18);
+		hash = _xxh_merge_round(hash, state[0]);
+		hash = _xxh_merge_round(hash, state[1]);
+		hash = _xxh_merge_round(hash, state[2]);
+		hash = _xxh_merge_round(hash, state[3]);
+	}
+	else {
+		hash = XXH_PRIME64_5;
+	}
+	hash += checksum->size;
+
+	while (remain >= 8) {
+		hash ^= _xxh_round(0, _xxh_read64(data));
+		hash = (_xxh_rotl64(hash, 27) * XXH_PRIME64_1) + XXH_PRIME64_4;
+		data += 8;
+		remain -= 8;
+	}
+	if (remain >= 4) {
+		hash ^= (uint64_t)_xxh_read32(data) * XXH_PRIME64_1;
+		hash = (_xxh_rotl64(hash, 23) * XXH_PRIME64_2) + XXH_PRIME64_3;
+		data += 4;
+		remain -= 4;
+	}
+	while (remain--) {
+		hash ^= (*data++) * XXH_PRIME64_5;
+		hash = _xxh_rotl64(hash, 11) * XXH_PRIME64_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= XXH_PRIME64_2;
+	hash ^= hash >> 29;
+	hash *= XXH_PRIME64_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+checksum_t*
+checksum_allocate(checksum_type_t type) {
+	checksum_t* checksum = memory_allocate(0, sizeof(checksum_t), 0, MEMORY_PERSISTENT);
+	checksum_initialize(checksum, type);
+	return checksum;
+}
+
+void
+checksum_deallocate(checksum_t* checksum) {
+	if (checksum)
+		checksum_finalize(checksum);
+	memory_deallocate(checksum);
+}
+
+void
+checksum_initialize(checksum_t* checksum, checksum_type_t type) {
+	memset(checksum, 0, sizeof(checksum_t));
+	checksum->type = type;
+	if (type == CHECKSUM_XXHASH64) {
+		checksum->state[0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+		checksum->state[1] = XXH_PRIME64_2;
+		checksum->state[2] = 0;
+		checksum->state[3] = 0 - XXH_PRIME64_1;
+	}
+	else {
+		checksum->state[0] = 0xFFFFFFFFU;
+	}
+}
+
+void
+checksum_finalize(checksum_t* checksum) {
+	FOUNDATION_UNUSED(checksum);
+}
+
+checksum_t*
+checksum_digest(checksum_t* checksum, const void* buffer, size_t size) {
+	const uint8_t* data = buffer;
+	size_t buffered;
+
+	if (checksum->type != CHECKSUM_XXHASH64) {
+		checksum->state[0] = _checksum_crc32c((uint32_t)checksum->state[0], data, size);
+		checksum->size += size;
+		return checksum;
+	}
+
+	//Complete any partial stripe left from previous digest calls
+	buffered = (size_t)(checksum->size & 31);
+	checksum->size += size;
+	if (buffered) {
+		size_t fill = 32 - buffered;
+		if (size < fill) {
+			memcpy(checksum->buffer + buffered, data, size);
+			return checksum;
+		}
+		memcpy(checksum->buffer + buffered, data, fill);
+		_xxh_stripes(checksum->state, checksum->buffer, 1);
+		data += fill;
+		size -= fill;
+	}
+
+	data = _xxh_stripes(checksum->state, data, size / 32);
+	memcpy(checksum->buffer, data, size & 31);
+
+	return checksum;
+}
+
+uint64_t
+checksum_value(const checksum_t* checksum) {
+	if (checksum->type == CHECKSUM_XXHASH64)
+		return _xxh_value(checksum);
+	return (uint64_t)(~(uint32_t)checksum->state[0]);
+}
+
+uint64_t
+checksum(checksum_type_t type, const void* buffer, size_t size) {
+	checksum_t block;
+	checksum_initialize(&block, type);
+	checksum_digest(&block, buffer, size);
+	return checksum_value(&block);
+}
+
+static size_t
+_checksum_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_checksum_t* checksum = (stream_checksum_t*)stream;
+	size_t read = stream_read(checksum->stream, dest, num);
+	checksum_digest(&checksum->checksum, dest, read);
+	return read;
+}
+
+static size_t
+_checksum_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_checksum_t* checksum = (stream_checksum_t*)stream;
+	size_t written = stream_write(checksum->stream, source, num);
+	checksum_digest(&checksum->checksum, source, written);
+	return written;
+}
+
+static bool
+_checksum_stream_eos(stream_t* stream) {
+	return stream_eos(((stream_checksum_t*)stream)->stream);
+}
+
+static void
+_checksum_stream_flush(stream_t* stream) {
+	stream_flush(((stream_checksum_t*)stream)->stream);
+}
+
+static void
+_checksum_stream_truncate(stream_t* stream, size_t size) {
+	stream_truncate(((stream_checksum_t*)stream)->stream, size);
+}
+
+static size_t
+_checksum_stream_size(stream_t* stream) {
+	return stream_size(((stream_checksum_t*)stream)->stream);
+}
+
+static void
+_checksum_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_seek(((stream_checksum_t*)stream)->stream, offset, direction);
+}
+
+static size_t
+_checksum_stream_tell(stream_t* stream) {
+	return stream_tell(((stream_checksum_t*)stream)->stream);
+}
+
+static tick_t
+_checksum_stream_last_modified(const stream_t* stream) {
+	return stream_last_modified(((const stream_checksum_t*)stream)->stream);
+}
+
+static void
+_checksum_stream_buffer_read(stream_t* stream) {
+	stream_buffer_read(((stream_checksum_t*)stream)->stream);
+}
+
+static size_t
+_checksum_stream_available_read(stream_t* stream) {
+	return stream_available_read(((stream_checksum_t*)stream)->stream);
+}
+
+static void
+_checksum_stream_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	stream_advise(((stream_checksum_t*)stream)->stream, advice, offset, size);
+}
+
+static void
+_checksum_stream_finalize(stream_t* stream) {
+	stream_checksum_t* checksum = (stream_checksum_t*)stream;
+
+	if (!checksum || (stream->type != STREAMTYPE_CHECKSUM))
+		return;
+
+	if (checksum->own)
+		stream_deallocate(checksum->stream);
+	checksum->stream = 0;
+}
+
+stream_t*
+checksum_stream_allocate(stream_t* stream, checksum_type_t type, bool adopt) {
+	stream_checksum_t* checksum = memory_allocate(HASH_STREAM, sizeof(stream_checksum_t), 8,
+	                                              MEMORY_PERSISTENT);
+	checksum_stream_initialize(checksum, stream, type, adopt);
+	return (stream_t*)checksum;
+}
+
+void
+checksum_stream_initialize(stream_checksum_t* checksum, stream_t* stream, checksum_type_t type,
+                           bool adopt) {
+	memset(checksum, 0, sizeof(stream_checksum_t));
+	stream_initialize((stream_t*)checksum, stream_byteorder(stream));
+
+	checksum->type = STREAMTYPE_CHECKSUM;
+	checksum->sequential = stream->sequential;
+	checksum->reliable = stream->reliable;
+	checksum->inorder = stream->inorder;
+	checksum->mode = stream->mode;
+	checksum->path = string_clone(STRING_ARGS(stream->path));
+	checksum->vtable = &_checksum_stream_vtable;
+	checksum->stream = stream;
+	checksum->own = adopt;
+	checksum_initialize(&checksum->checksum, type);
+}
+
+uint64_t
+checksum_stream_value(stream_t* stream) {
+	if (!stream || (stream->type != STREAMTYPE_CHECKSUM))
+		return 0;
+	return checksum_value(&((stream_checksum_t*)stream)->checksum);
+}
+
+void
+checksum_stream_reset(stream_t* stream) {
+	stream_checksum_t* checksum = (stream_checksum_t*)stream;
+	if (!stream || (stream->type != STREAMTYPE_CHECKSUM))
+		return;
+	checksum_initialize(&checksum->checksum, checksum->checksum.type);
+}
+
+int
+_checksum_initialize(void) {
+	uint32_t ientry, islice, crc;
+
+	for (ientry = 0; ientry < 256; ++ientry) {
+		crc = ientry;
+		for (islice = 0; islice < 8; ++islice)
+			crc = (crc & 1) ? ((crc >> 1) ^ CRC32C_POLYNOMIAL) : (crc >> 1);
+		_checksum_crc32c_table[0][ientry] = crc;
+	}
+	for (ientry = 0; ientry < 256; ++ientry) {
+		crc = _checksum_crc32c_table[0][ientry];
+		for (islice = 1; islice < 8; ++islice) {
+			crc = _checksum_crc32c_table[0][crc & 0xFF] ^ (crc >> 8);
+			_checksum_crc32c_table[islice][ientry] = crc;
+		}
+	}
+
+#if CHECKSUM_CRC32C_SSE42
+	_checksum_crc32c_hardware = _checksum_crc32c_sse42_supported();
+#elif CHECKSUM_CRC32C_ARM
+	_checksum_crc32c_hardware = true;
+#endif
+
+	memset(&_checksum_stream_vtable, 0, sizeof(_checksum_stream_vtable));
+	_checksum_stream_vtable.read = _checksum_stream_read;
+	_checksum_stream_vtable.write = _checksum_stream_write;
+	_checksum_stream_vtable.eos = _checksum_stream_eos;
+	_checksum_stream_vtable.flush = _checksum_stream_flush;
+	_checksum_stream_vtable.truncate = _checksum_stream_truncate;
+	_checksum_stream_vtable.size = _checksum_stream_size;
+	_checksum_stream_vtable.seek = _checksum_stream_seek;
+	_checksum_stream_vtable.tell = _checksum_stream_tell;
+	_checksum_stream_vtable.lastmod = _checksum_stream_last_modified;
+	_checksum_stream_vtable.buffer_read = _checksum_stream_buffer_read;
+	_checksum_stream_vtable.available_read = _checksum_stream_available_read;
+	_checksum_stream_vtable.finalize = _checksum_stream_finalize;
+	_checksum_stream_vtable.advise = _checksum_stream_advise;
+
+	return 0;
+}
+
+void
+_checksum_finalize(void) {
+}
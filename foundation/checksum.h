@@ -0,0 +1,115 @@
+/* checksum.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file checksum.h
+\brief Fast data checksums
+
+Incremental data checksums for integrity checks, much faster than a cryptographic digest like
+MD5. Available algorithms are CRC-32C (Castagnoli polynomial), using the CRC32 instructions of
+SSE4.2 capable x86 processors and ARMv8 processors with the CRC extension when available, and
+the 64-bit xxHash (XXH64) algorithm.
+
+Data can be digested in any number of calls, the checksum of all data digested so far can be
+queried at any time without ending the digest sequence:
+<pre>checksum_initialize()
+checksum_digest()
+checksum_digest()
+... //More digest operations
+checksum_value()
+checksum_finalize()</pre>
+
+A checksum stream wraps another stream and computes the checksum of all data read from or
+written to the wrapped stream as it passes through, see #checksum_stream_allocate. To get the
+checksum of the content of a seekable stream, use #stream_checksum. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a new checksum block and initialize for digestion.
+\param type Checksum algorithm
+\return New checksum block */
+FOUNDATION_API checksum_t*
+checksum_allocate(checksum_type_t type);
+
+/*! Deallocate checksum block
+\param checksum Checksum block */
+FOUNDATION_API void
+checksum_deallocate(checksum_t* checksum);
+
+/*! Initialize checksum block, discarding any previously digested data.
+\param checksum Checksum block
+\param type Checksum algorithm */
+FOUNDATION_API void
+checksum_initialize(checksum_t* checksum, checksum_type_t type);
+
+/*! Finalize checksum block previously initialized with #checksum_initialize.
+\param checksum Checksum block */
+FOUNDATION_API void
+checksum_finalize(checksum_t* checksum);
+
+/*! Digest a raw data buffer.
+\param checksum Checksum block
+\param buffer Data to digest
+\param size Size of buffer
+\return Checksum block */
+FOUNDATION_API checksum_t*
+checksum_digest(checksum_t* checksum, const void* buffer, size_t size);
+
+/*! Get the checksum of all data digested since the block was initialized. More data can be
+digested after this call.
+\param checksum Checksum block
+\return Checksum value, CRC-32C checksums are in the low 32 bits */
+FOUNDATION_API uint64_t
+checksum_value(const checksum_t* checksum);
+
+/*! Calculate the checksum of a data buffer.
+\param type Checksum algorithm
+\param buffer Data to checksum
+\param size Size of buffer
+\return Checksum value, CRC-32C checksums are in the low 32 bits */
+FOUNDATION_API uint64_t
+checksum(checksum_type_t type, const void* buffer, size_t size);
+
+/*! Allocate a checksum stream wrapping the given stream. All data read from or written to the
+checksum stream is passed through to the wrapped stream and digested in the order it is
+transferred. Seeking is passed through to the wrapped stream and does not affect the checksum.
+Deallocate the stream with a call to #stream_deallocate.
+\param stream Stream to wrap
+\param type Checksum algorithm
+\param adopt Take ownership of the wrapped stream, deallocating it with the checksum stream
+\return New checksum stream */
+FOUNDATION_API stream_t*
+checksum_stream_allocate(stream_t* stream, checksum_type_t type, bool adopt);
+
+/*! Initialize a checksum stream wrapping the given stream. Finalize the stream with a call
+to #stream_finalize.
+\param checksum Checksum stream
+\param stream Stream to wrap
+\param type Checksum algorithm
+\param adopt Take ownership of the wrapped stream, deallocating it with the checksum stream */
+FOUNDATION_API void
+checksum_stream_initialize(stream_checksum_t* checksum, stream_t* stream, checksum_type_t type,
+                           bool adopt);
+
+/*! Get the checksum of all data transferred through a checksum stream since it was
+initialized or last reset.
+\param stream Checksum stream
+\return Checksum value, 0 if not a checksum stream */
+FOUNDATION_API uint64_t
+checksum_stream_value(stream_t* stream);
+
+/*! Reset the checksum of a checksum stream, discarding all data transferred so far.
+\param stream Checksum stream */
+FOUNDATION_API void
+checksum_stream_reset(stream_t* stream);
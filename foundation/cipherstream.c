@@ -0,0 +1,265 @@
+/* cipherstream.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+//Number of bytes encrypted or decrypted in one chunk, bounding the memory used by a stream
+#define CIPHER_STREAM_CHUNK_SIZE (16 * 1024)
+
+static stream_vtable_t _cipher_stream_vtable;
+
+//Generate the keystream for the given stream range in the chunk buffer, returning a pointer
+//to the keystream byte at the start of the range
+static uint8_t*
+_cipher_stream_keystream(stream_cipher_t* cipher, size_t offset, size_t size) {
+	size_t block_size = cipher->aes ? AES_BLOCKSIZE : 8;
+	size_t block = offset / block_size;
+	size_t head = offset % block_size;
+	size_t length = ((head + size + block_size - 1) / block_size) * block_size;
+
+	memset(cipher->keystream, 0, length);
+	if (cipher->aes) {
+		uint128_t counter = cipher->vec;
+		counter.word[0] += block;
+		if (counter.word[0] < block)
+			++counter.word[1];
+		aes_encrypt(cipher->aes, cipher->keystream, length, BLOCKCIPHER_CTR, counter);
+	}
+	else {
+		blowfish_encrypt(cipher->blowfish, cipher->keystream, length, BLOCKCIPHER_CTR,
+		                 cipher->vec.word[0] + block);
+	}
+	return cipher->keystream + head;
+}
+
+static void
+_cipher_stream_xor(uint8_t* FOUNDATION_RESTRICT dest, const uint8_t* FOUNDATION_RESTRICT source,
+                   size_t size) {
+	uint64_t dval, sval;
+	for (; size >= 8; size -= 8, dest += 8, source += 8) {
+		memcpy(&dval, dest, 8);
+		memcpy(&sval, source, 8);
+		dval ^= sval;
+		memcpy(dest, &dval, 8);
+	}
+	for (; size; --size)
+		*dest++ ^= *source++;
+}
+
+static size_t
+_cipher_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	size_t total_read = 0;
+
+	while (total_read < num) {
+		size_t chunk = num - total_read;
+		size_t read;
+		if (chunk > CIPHER_STREAM_CHUNK_SIZE)
+			chunk = CIPHER_STREAM_CHUNK_SIZE;
+		read = stream_read(cipher->stream, pointer_offset(dest, total_read), chunk);
+		_cipher_stream_xor(pointer_offset(dest, total_read),
+		                   _cipher_stream_keystream(cipher, cipher->offset, read), read);
+		cipher->offset += read;
+		total_read += read;
+		if (read < chunk)
+			break;
+	}
+
+	return total_read;
+}
+
+static size_t
+_cipher_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	size_t total_written = 0;
+
+	while (total_written < num) {
+		size_t chunk = num - total_written;
+		size_t written;
+		uint8_t* data;
+		if (chunk > CIPHER_STREAM_CHUNK_SIZE)
+			chunk = CIPHER_STREAM_CHUNK_SIZE;
+		//Encrypt in the keystream buffer, the source buffer is left untouched
+		data = _cipher_stream_keystream(cipher, cipher->offset, chunk);
+		_cipher_stream_xor(data, pointer_offset_const(source, total_written), chunk);
+		written = stream_write(cipher->stream, data, chunk);
+		cipher->offset += written;
+		total_written += written;
+		if (written < chunk)
+			break;
+	}
+
+	return total_written;
+}
+
+static bool
+_cipher_stream_eos(stream_t* stream) {
+	return stream_eos(((stream_cipher_t*)stream)->stream);
+}
+
+static void
+_cipher_stream_flush(stream_t* stream) {
+	stream_flush(((stream_cipher_t*)stream)->stream);
+}
+
+static void
+_cipher_stream_truncate(stream_t* stream, size_t size) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	stream_truncate(cipher->stream, cipher->base + size);
+	if (cipher->offset > size)
+		cipher->offset = size;
+}
+
+static size_t
+_cipher_stream_size(stream_t* stream) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	size_t size = stream_size(cipher->stream);
+	return (size > cipher->base) ? (size - cipher->base) : 0;
+}
+
+static void
+_cipher_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	size_t position;
+
+	if (cipher->stream->sequential)
+		return;
+
+	//Keystream is a function of the position only, so any position can be decrypted
+	if (direction == STREAM_SEEK_BEGIN)
+		stream_seek(cipher->stream, (ssize_t)cipher->base + ((offset > 0) ? offset : 0),
+		            STREAM_SEEK_BEGIN);
+	else
+		stream_seek(cipher->stream, offset, direction);
+
+	position = stream_tell(cipher->stream);
+	if (position < cipher->base) {
+		stream_seek(cipher->stream, (ssize_t)cipher->base, STREAM_SEEK_BEGIN);
+		position = cipher->base;
+	}
+	cipher->offset = position - cipher->base;
+}
+
+static size_t
+_cipher_stream_tell(stream_t* stream) {
+	return ((stream_cipher_t*)stream)->offset;
+}
+
+static tick_t
+_cipher_stream_last_modified(const stream_t* stream) {
+	return stream_last_modified(((const stream_cipher_t*)stream)->stream);
+}
+
+static void
+_cipher_stream_buffer_read(stream_t* stream) {
+	stream_buffer_read(((stream_cipher_t*)stream)->stream);
+}
+
+static size_t
+_cipher_stream_available_read(stream_t* stream) {
+	return stream_available_read(((stream_cipher_t*)stream)->stream);
+}
+
+static void
+_cipher_stream_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+	stream_advise(cipher->stream, advice, cipher->base + offset, size);
+}
+
+static void
+_cipher_stream_finalize(stream_t* stream) {
+	stream_cipher_t* cipher = (stream_cipher_t*)stream;
+
+	if (!cipher || (stream->type != STREAMTYPE_CIPHER))
+		return;
+
+	if (cipher->own)
+		stream_deallocate(cipher->stream);
+	if (cipher->keystream) {
+		memset(cipher->keystream, 0, CIPHER_STREAM_CHUNK_SIZE + AES_BLOCKSIZE);
+		memory_deallocate(cipher->keystream);
+	}
+	cipher->stream = 0;
+	cipher->keystream = 0;
+}
+
+static void
+_cipher_stream_setup(stream_cipher_t* cipher, stream_t* stream, bool adopt) {
+	memset(cipher, 0, sizeof(stream_cipher_t));
+	stream_initialize((stream_t*)cipher, stream_byteorder(stream));
+
+	cipher->type = STREAMTYPE_CIPHER;
+	cipher->sequential = stream->sequential;
+	cipher->reliable = stream->reliable;
+	cipher->inorder = stream->inorder;
+	cipher->mode = stream->mode | STREAM_BINARY;
+	cipher->path = string_clone(STRING_ARGS(stream->path));
+	cipher->vtable = &_cipher_stream_vtable;
+	cipher->stream = stream;
+	cipher->own = adopt;
+	cipher->base = stream->sequential ? 0 : stream_tell(stream);
+	//Room for a partial block on each side of a chunk
+	cipher->keystream = memory_allocate(HASH_STREAM, CIPHER_STREAM_CHUNK_SIZE + AES_BLOCKSIZE,
+	                                    16, MEMORY_PERSISTENT);
+}
+
+stream_t*
+cipher_stream_allocate(stream_t* stream, const aes_t* aes, uint128_t vec, bool adopt) {
+	stream_cipher_t* cipher = memory_allocate(HASH_STREAM, sizeof(stream_cipher_t), 8,
+	                                          MEMORY_PERSISTENT);
+	cipher_stream_initialize(cipher, stream, aes, vec, adopt);
+	return (stream_t*)cipher;
+}
+
+void
+cipher_stream_initialize(stream_cipher_t* cipher, stream_t* stream, const aes_t* aes,
+                         uint128_t vec, bool adopt) {
+	_cipher_stream_setup(cipher, stream, adopt);
+	cipher->aes = aes;
+	cipher->vec = vec;
+}
+
+stream_t*
+cipher_stream_allocate_blowfish(stream_t* stream, const blowfish_t* blowfish, uint64_t vec,
+                                bool adopt) {
+	stream_cipher_t* cipher = memory_allocate(HASH_STREAM, sizeof(stream_cipher_t), 8,
+	                                          MEMORY_PERSISTENT);
+	cipher_stream_initialize_blowfish(cipher, stream, blowfish, vec, adopt);
+	return (stream_t*)cipher;
+}
+
+void
+cipher_stream_initialize_blowfish(stream_cipher_t* cipher, stream_t* stream,
+                                  const blowfish_t* blowfish, uint64_t vec, bool adopt) {
+	_cipher_stream_setup(cipher, stream, adopt);
+	cipher->blowfish = blowfish;
+	cipher->vec = uint128_make(vec, 0);
+}
+
+void
+_cipher_stream_initialize(void) {
+	memset(&_cipher_stream_vtable, 0, sizeof(_cipher_stream_vtable));
+	_cipher_stream_vtable.read = _cipher_stream_read;
+	_cipher_stream_vtable.write = _cipher_stream_write;
+	_cipher_stream_vtable.eos = _cipher_stream_eos;
+	_cipher_stream_vtable.flush = _cipher_stream_flush;
+	_cipher_stream_vtable.truncate = _cipher_stream_truncate;
+	_cipher_stream_vtable.size = _cipher_stream_size;
+	_cipher_stream_vtable.seek = _cipher_stream_seek;
+	_cipher_stream_vtable.tell = _cipher_stream_tell;
+	_cipher_stream_vtable.lastmod = _cipher_stream_last_modified;
+	_cipher_stream_vtable.buffer_read = _cipher_stream_buffer_read;
+	_cipher_stream_vtable.available_read = _cipher_stream_available_read;
+	_cipher_stream_vtable.finalize = _cipher_stream_finalize;
+	_cipher_stream_vtable.advise = _cipher_stream_advise;
+}
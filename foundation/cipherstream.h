@@ -0,0 +1,79 @@
+/* cipherstream.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file cipherstream.h
+\brief Stream encrypting or decrypting another stream
+
+Stream adapter encrypting data on write to a wrapped stream and decrypting data on read from
+a wrapped stream, using AES or blowfish in counter mode (see #BLOCKCIPHER_CTR). Any stream
+type can be wrapped, for example file, memory buffer and pipe streams. Data is processed in
+bounded chunks, so streams of any size are encrypted with constant memory use.
+
+The keystream in counter mode only depends on the position in the stream, so a cipher stream
+can be opened for both reading and writing and can seek to any position if the wrapped stream
+is not sequential. The encrypted data has the same size as the plain data. Position zero of
+the cipher stream is the position of the wrapped stream when the cipher stream is created.
+
+The cipher state is referenced, not copied, and must remain valid until the cipher stream is
+deallocated. A counter value (initialization vector) must never be reused with the same key
+for different data.
+
+Streams are not inherently thread safe, synchronization in a multithread use case must be
+done by caller. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a cipher stream wrapping the given stream, using AES in counter mode. Deallocate
+the stream with a call to #stream_deallocate.
+\param stream Stream to wrap
+\param aes Initialized AES state
+\param vec Counter of the first block, see #aes_encrypt
+\param adopt Take ownership of the wrapped stream, deallocating it with the cipher stream
+\return New cipher stream */
+FOUNDATION_API stream_t*
+cipher_stream_allocate(stream_t* stream, const aes_t* aes, uint128_t vec, bool adopt);
+
+/*! Initialize a cipher stream wrapping the given stream, using AES in counter mode. Finalize
+the stream with a call to #stream_finalize.
+\param cipher Cipher stream
+\param stream Stream to wrap
+\param aes Initialized AES state
+\param vec Counter of the first block, see #aes_encrypt
+\param adopt Take ownership of the wrapped stream, deallocating it with the cipher stream */
+FOUNDATION_API void
+cipher_stream_initialize(stream_cipher_t* cipher, stream_t* stream, const aes_t* aes,
+                         uint128_t vec, bool adopt);
+
+/*! Allocate a cipher stream wrapping the given stream, using blowfish in counter mode.
+Deallocate the stream with a call to #stream_deallocate.
+\param stream Stream to wrap
+\param blowfish Initialized blowfish state
+\param vec Counter of the first block, see #blowfish_encrypt
+\param adopt Take ownership of the wrapped stream, deallocating it with the cipher stream
+\return New cipher stream */
+FOUNDATION_API stream_t*
+cipher_stream_allocate_blowfish(stream_t* stream, const blowfish_t* blowfish, uint64_t vec,
+                                bool adopt);
+
+/*! Initialize a cipher stream wrapping the given stream, using blowfish in counter mode.
+Finalize the stream with a call to #stream_finalize.
+\param cipher Cipher stream
+\param stream Stream to wrap
+\param blowfish Initialized blowfish state
+\param vec Counter of the first block, see #blowfish_encrypt
+\param adopt Take ownership of the wrapped stream, deallocating it with the cipher stream */
+FOUNDATION_API void
+cipher_stream_initialize_blowfish(stream_cipher_t* cipher, stream_t* stream,
+                                  const blowfish_t* blowfish, uint64_t vec, bool adopt);
@@ -0,0 +1,595 @@
+/* compressstream.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#define COMPRESSED_STREAM_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define COMPRESSED_STREAM_MAX_BLOCK_SIZE (64 * 1024 * 1024)
+#define COMPRESSED_STREAM_HEADER_SIZE 8
+//Frame header magic "FSZ1" and block header flag for blocks stored uncompressed
+#define COMPRESSED_STREAM_MAGIC 0x315A5346U
+#define COMPRESSED_STREAM_STORED 0x80000000U
+
+//Block compression in LZ4 block format, sequences of literals followed by a match
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5
+#define LZ_MATCH_LIMIT 12
+#define LZ_MAX_OFFSET 65535
+
+static stream_vtable_t _compressed_stream_vtable;
+
+static uint32_t
+_lz_read32(const uint8_t* src) {
+	uint32_t value;
+	memcpy(&value, src, sizeof(value));
+	return value;
+}
+
+static uint8_t*
+_lz_write_length(uint8_t* op, size_t length) {
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+static const uint8_t*
+_lz_read_length(const uint8_t* ip, const uint8_t* ip_end, size_t* length) {
+	uint8_t value;
+	do {
+		if (ip >= ip_end)
+			return 0;
+		value = *ip++;
+		*length += value;
+	}
+	while (value == 255);
+	return ip;
+}
+
+//Write a sequence of literals and a match, a zero match length ends the block with literals
+static uint8_t*
+_lz_write_sequence(uint8_t* op, const uint8_t* op_end, const uint8_t* literal,
+                   size_t literal_length, size_t offset, size_t match_length) {
+	uint8_t* token = op;
+	size_t required = 1 + literal_length + (literal_length / 255) + 1;
+	if (match_length)
+		required += 2 + (match_length / 255) + 1;
+	if (required > (size_t)(op_end - op))
+		return 0;
+
+	++op;
+	if (literal_length >= 15) {
+		*token = 15 << 4;
+		op = _lz_write_length(op, literal_length - 15);
+	}
+	else {
+		*token = (uint8_t)(literal_length << 4);
+	}
+	memcpy(op, literal, literal_length);
+	op += literal_length;
+
+	if (match_length) {
+		*op++ = (uint8_t)offset;
+		*op++ = (uint8_t)(offset >> 8);
+		match_length -= LZ_MIN_MATCH;
+		if (match_length >= 15) {
+			*token |= 15;
+			op = _lz_write_length(op, match_length - 15);
+		}
+		else {
+			*token |= (uint8_t)match_length;
+		}
+	}
+	return op;
+}
+
+static size_t
+_lz_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity, uint32_t* table) {
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;
+	const uint8_t* end = src + size;
+	uint8_t* op = dst;
+	const uint8_t* op_end = dst + capacity;
+
+	if (size > LZ_MATCH_LIMIT) {
+		//Last match must start before the match limit and leave trailing literals
+		const uint8_t* match_limit = end - LZ_MATCH_LIMIT;
+		const uint8_t* extend_limit = end - LZ_LAST_LITERALS;
+
+		//Stale table entries are harmless, any earlier position with matching bytes is valid
+		memset(table, 0, sizeof(uint32_t) << LZ_HASH_BITS);
+
+		while (ip < match_limit) {
+			const uint8_t* ref;
+			const uint8_t* match;
+			uint32_t sequence = _lz_read32(ip);
+			uint32_t hash = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+			size_t offset;
+
+			ref = src + table[hash];
+			table[hash] = (uint32_t)(ip - src);
+			if ((ref >= ip) || ((size_t)(ip - ref) > LZ_MAX_OFFSET) ||
+			        (_lz_read32(ref) != sequence)) {
+				//Step faster through incompressible data
+				ip += 1 + ((size_t)(ip - anchor) >> 6);
+				continue;
+			}
+
+			while ((ip > anchor) && (ref > src) && (ip[-1] == ref[-1])) {
+				--ip;
+				--ref;
+			}
+			offset = (size_t)(ip - ref);
+			match = ip + LZ_MIN_MATCH;
+			ref += LZ_MIN_MATCH;
+			while ((match < extend_limit) && (*match == *ref)) {
+				++match;
+				++ref;
+			}
+
+			op = _lz_write_sequence(op, op_end, anchor, (size_t)(ip - anchor), offset,
+			                        (size_t)(match - ip));
+			if (!op)
+				return 0;
+			ip = anchor = match;
+		}
+	}
+
+	op = _lz_write_sequence(op, op_end, anchor, (size_t)(end - anchor), 0, 0);
+	return op ? (size_t)(op - dst) : 0;
+}
+
+static size_t
+_lz_decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+	const uint8_t* ip = src;
+	const uint8_t* ip_end = src + size;
+	uint8_t* op = dst;
+	const uint8_t* op_end = dst + capacity;
+
+	while (ip < ip_end) {
+		const uint8_t* match;
+		unsigned int token = *ip++;
+		size_t length = token >> 4;
+		size_t offset;
+
+		if ((length == 15) && !(ip = _lz_read_length(ip, ip_end, &length)))
+			return SIZE_MAX;
+		if ((length > (size_t)(ip_end - ip)) || (length > (size_t)(op_end - op)))
+			return SIZE_MAX;
+		memcpy(op, ip, length);
+		ip += length;
+		op += length;
+		if (ip == ip_end)
+			break;
+
+		if ((ip_end - ip) < 2)
+			return SIZE_MAX;
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if (!offset || (offset > (size_t)(op - dst)))
+			return SIZE_MAX;
+
+		length = token & 15;
+		if ((length == 15) && !(ip = _lz_read_length(ip, ip_end, &length)))
+			return SIZE_MAX;
+		length += LZ_MIN_MATCH;
+		if (length > (size_t)(op_end - op))
+			return SIZE_MAX;
+
+		//Overlapping matches repeat the preceding bytes and must be copied in order
+		match = op - offset;
+		if (offset >= length) {
+			memcpy(op, match, length);
+			op += length;
+		}
+		else {
+			while (length--)
+				*op++ = *match++;
+		}
+	}
+
+	return (size_t)(op - dst);
+}
+
+static void
+_compressed_stream_store32(uint8_t* dst, size_t value) {
+	dst[0] = (uint8_t)value;
+	dst[1] = (uint8_t)(value >> 8);
+	dst[2] = (uint8_t)(value >> 16);
+	dst[3] = (uint8_t)(value >> 24);
+}
+
+static size_t
+_compressed_stream_load32(const uint8_t* src) {
+	return (size_t)src[0] | ((size_t)src[1] << 8) | ((size_t)src[2] << 16) |
+	       ((size_t)src[3] << 24);
+}
+
+static void
+_compressed_stream_allocate_buffers(stream_compressed_t* compressed) {
+	compressed->raw = memory_allocate(HASH_STREAM, compressed->block_size, 0, MEMORY_PERSISTENT);
+	compressed->packed = memory_allocate(HASH_STREAM, compressed->block_size, 0,
+	                                     MEMORY_PERSISTENT);
+}
+
+static void
+_compressed_stream_write_block(stream_compressed_t* compressed) {
+	uint8_t header[COMPRESSED_STREAM_HEADER_SIZE];
+	stream_span_t spans[2];
+	size_t packed_size = 0;
+
+	if (!compressed->header) {
+		_compressed_stream_store32(header, COMPRESSED_STREAM_MAGIC);
+		_compressed_stream_store32(header + 4, compressed->block_size);
+		stream_write(compressed->stream, header, sizeof(header));
+		compressed->header = true;
+	}
+	if (!compressed->raw_size)
+		return;
+
+	//Blocks are only stored compressed if smaller than the uncompressed data
+	if (compressed->raw_size > 1)
+		packed_size = _lz_compress((const uint8_t*)compressed->raw, compressed->raw_size,
+		                           (uint8_t*)compressed->packed, compressed->raw_size - 1,
+		                           compressed->table);
+
+	_compressed_stream_store32(header, compressed->raw_size);
+	spans[0].data = header;
+	spans[0].size = sizeof(header);
+	if (packed_size) {
+		_compressed_stream_store32(header + 4, packed_size);
+		spans[1].data = compressed->packed;
+		spans[1].size = packed_size;
+	}
+	else {
+		_compressed_stream_store32(header + 4, compressed->raw_size | COMPRESSED_STREAM_STORED);
+		spans[1].data = compressed->raw;
+		spans[1].size = compressed->raw_size;
+	}
+	stream_write_vector(compressed->stream, spans, 2);
+
+	compressed->block_offset += compressed->raw_size;
+	compressed->raw_size = 0;
+}
+
+static bool
+_compressed_stream_read_header(stream_compressed_t* compressed) {
+	uint8_t header[COMPRESSED_STREAM_HEADER_SIZE];
+	size_t block_size;
+
+	compressed->header = true;
+	if (stream_read(compressed->stream, header, sizeof(header)) != sizeof(header))
+		return false;
+
+	block_size = _compressed_stream_load32(header + 4);
+	if ((_compressed_stream_load32(header) != COMPRESSED_STREAM_MAGIC) || !block_size ||
+	        (block_size > COMPRESSED_STREAM_MAX_BLOCK_SIZE)) {
+		log_errorf(HASH_STREAM, ERROR_INVALID_VALUE,
+		           STRING_CONST("Invalid compressed frame header in stream '%.*s'"),
+		           STRING_FORMAT(compressed->path));
+		return false;
+	}
+
+	compressed->block_size = block_size;
+	_compressed_stream_allocate_buffers(compressed);
+	return true;
+}
+
+//Advance to the next block. If the block ends at or before the skip position and the wrapped
+//stream is seekable, the block data is skipped without decompressing it
+static bool
+_compressed_stream_next_block(stream_compressed_t* compressed, size_t skip) {
+	uint8_t header[COMPRESSED_STREAM_HEADER_SIZE];
+	size_t raw_size, packed_size;
+	bool stored;
+
+	if (compressed->end)
+		return false;
+	if (!compressed->header && !_compressed_stream_read_header(compressed)) {
+		compressed->end = true;
+		return false;
+	}
+
+	compressed->block_offset += compressed->raw_size;
+	compressed->raw_offset = 0;
+	compressed->raw_size = 0;
+
+	if (stream_read(compressed->stream, header, sizeof(header)) != sizeof(header)) {
+		compressed->end = true;
+		return false;
+	}
+
+	raw_size = _compressed_stream_load32(header);
+	packed_size = _compressed_stream_load32(header + 4);
+	stored = ((packed_size & COMPRESSED_STREAM_STORED) != 0);
+	packed_size &= ~(size_t)COMPRESSED_STREAM_STORED;
+	if (!raw_size) {
+		compressed->end = true;
+		return false;
+	}
+	if ((raw_size > compressed->block_size) || (packed_size > compressed->block_size) ||
+	        (stored && (packed_size != raw_size)))
+		goto invalid;
+
+	if ((compressed->block_offset + raw_size <= skip) && !compressed->stream->sequential) {
+		stream_seek(compressed->stream, (ssize_t)packed_size, STREAM_SEEK_CURRENT);
+		compressed->block_offset += raw_size;
+		return true;
+	}
+
+	if (stored) {
+		if (stream_read(compressed->stream, compressed->raw, raw_size) != raw_size)
+			goto invalid;
+	}
+	else {
+		if ((stream_read(compressed->stream, compressed->packed, packed_size) != packed_size) ||
+		        (_lz_decompress((const uint8_t*)compressed->packed, packed_size,
+		                        (uint8_t*)compressed->raw, raw_size) != raw_size))
+			goto invalid;
+	}
+	compressed->raw_size = raw_size;
+	return true;
+
+invalid:
+	log_errorf(HASH_STREAM, ERROR_INVALID_VALUE,
+	           STRING_CONST("Invalid compressed block at offset %" PRIsize " in stream '%.*s'"),
+	           compressed->block_offset, STRING_FORMAT(compressed->path));
+	compressed->end = true;
+	return false;
+}
+
+static size_t
+_compressed_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	size_t total_read = 0;
+
+	while (total_read < num) {
+		size_t available = compressed->raw_size - compressed->raw_offset;
+		if (!available) {
+			if (!_compressed_stream_next_block(compressed, 0))
+				break;
+			continue;
+		}
+		if (available > num - total_read)
+			available = num - total_read;
+		memcpy(pointer_offset(dest, total_read), compressed->raw + compressed->raw_offset,
+		       available);
+		compressed->raw_offset += available;
+		total_read += available;
+	}
+
+	return total_read;
+}
+
+static size_t
+_compressed_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	size_t total_written = 0;
+
+	while (total_written < num) {
+		size_t space = compressed->block_size - compressed->raw_size;
+		if (space > num - total_written)
+			space = num - total_written;
+		memcpy(compressed->raw + compressed->raw_size,
+		       pointer_offset_const(source, total_written), space);
+		compressed->raw_size += space;
+		total_written += space;
+		if (compressed->raw_size == compressed->block_size)
+			_compressed_stream_write_block(compressed);
+	}
+
+	return total_written;
+}
+
+static bool
+_compressed_stream_eos(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	if (compressed->mode & STREAM_OUT)
+		return stream_eos(compressed->stream);
+	if (compressed->raw_offset < compressed->raw_size)
+		return false;
+	return !_compressed_stream_next_block(compressed, 0);
+}
+
+static void
+_compressed_stream_flush(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	if (compressed->mode & STREAM_OUT) {
+		_compressed_stream_write_block(compressed);
+		stream_flush(compressed->stream);
+	}
+}
+
+static void
+_compressed_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction);
+
+static size_t
+_compressed_stream_size(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	size_t current, size;
+
+	if (compressed->mode & STREAM_OUT)
+		return compressed->block_offset + compressed->raw_size;
+	if (compressed->stream->sequential)
+		return 0;
+
+	//Skip all remaining blocks to find the end and seek back to the current position
+	current = compressed->block_offset + compressed->raw_offset;
+	while (_compressed_stream_next_block(compressed, SIZE_MAX))
+		/* */;
+	size = compressed->block_offset + compressed->raw_size;
+	_compressed_stream_seek(stream, (ssize_t)current, STREAM_SEEK_BEGIN);
+	return size;
+}
+
+static void
+_compressed_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	size_t current = compressed->block_offset + compressed->raw_offset;
+	size_t position, block_end;
+	/*lint --e{571} Used when offset < 0*/
+	size_t abs_offset = (size_t)((offset < 0) ? -offset : offset);
+
+	if (compressed->mode & STREAM_OUT)
+		return;
+
+	if (direction == STREAM_SEEK_CURRENT) {
+		if (offset < 0)
+			position = (abs_offset > current) ? 0 : (current - abs_offset);
+		else
+			position = current + abs_offset;
+	}
+	else if (direction == STREAM_SEEK_BEGIN) {
+		position = (offset > 0) ? abs_offset : 0;
+	}
+	else {
+		size_t size = _compressed_stream_size(stream);
+		position = (offset < 0) ? ((abs_offset > size) ? 0 : (size - abs_offset)) : size;
+	}
+
+	if (position < compressed->block_offset) {
+		if (compressed->stream->sequential)
+			return;
+		//Restart from first block, header is only read once
+		if (compressed->header) {
+			stream_seek(compressed->stream,
+			            (ssize_t)(compressed->frame_offset + COMPRESSED_STREAM_HEADER_SIZE),
+			            STREAM_SEEK_BEGIN);
+			compressed->end = (compressed->raw == 0);
+		}
+		compressed->block_offset = 0;
+		compressed->raw_offset = 0;
+		compressed->raw_size = 0;
+	}
+
+	while ((position > compressed->block_offset + compressed->raw_size) &&
+	        _compressed_stream_next_block(compressed, position))
+		/* */;
+
+	block_end = compressed->block_offset + compressed->raw_size;
+	compressed->raw_offset = (position > block_end) ? compressed->raw_size :
+	                         (position - compressed->block_offset);
+}
+
+static size_t
+_compressed_stream_tell(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	if (compressed->mode & STREAM_OUT)
+		return compressed->block_offset + compressed->raw_size;
+	return compressed->block_offset + compressed->raw_offset;
+}
+
+static tick_t
+_compressed_stream_last_modified(const stream_t* stream) {
+	const stream_compressed_t* compressed = (const stream_compressed_t*)stream;
+	return stream_last_modified(compressed->stream);
+}
+
+static void
+_compressed_stream_buffer_read(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	stream_buffer_read(compressed->stream);
+}
+
+static size_t
+_compressed_stream_available_read(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+	if (compressed->mode & STREAM_OUT)
+		return 0;
+	return compressed->raw_size - compressed->raw_offset;
+}
+
+static void
+_compressed_stream_finalize(stream_t* stream) {
+	stream_compressed_t* compressed = (stream_compressed_t*)stream;
+
+	if (!compressed || (stream->type != STREAMTYPE_COMPRESSED))
+		return;
+
+	if (compressed->mode & STREAM_OUT) {
+		uint8_t end[COMPRESSED_STREAM_HEADER_SIZE];
+		memset(end, 0, sizeof(end));
+		_compressed_stream_write_block(compressed);
+		stream_write(compressed->stream, end, sizeof(end));
+		stream_flush(compressed->stream);
+	}
+	if (compressed->own)
+		stream_deallocate(compressed->stream);
+
+	memory_deallocate(compressed->raw);
+	memory_deallocate(compressed->packed);
+	memory_deallocate(compressed->table);
+	compressed->stream = 0;
+	compressed->raw = 0;
+	compressed->packed = 0;
+	compressed->table = 0;
+}
+
+stream_t*
+compressed_stream_allocate(stream_t* stream, unsigned int mode, size_t block_size, bool adopt) {
+	stream_compressed_t* compressed = memory_allocate(HASH_STREAM, sizeof(stream_compressed_t), 8,
+	                                                  MEMORY_PERSISTENT);
+	compressed_stream_initialize(compressed, stream, mode, block_size, adopt);
+	return (stream_t*)compressed;
+}
+
+void
+compressed_stream_initialize(stream_compressed_t* compressed, stream_t* stream,
+                             unsigned int mode, size_t block_size, bool adopt) {
+	memset(compressed, 0, sizeof(stream_compressed_t));
+	stream_initialize((stream_t*)compressed, stream_byteorder(stream));
+
+	compressed->type = STREAMTYPE_COMPRESSED;
+	compressed->reliable = stream->reliable;
+	compressed->inorder = stream->inorder;
+	compressed->mode = ((mode & STREAM_OUT) ? STREAM_OUT : STREAM_IN) |
+	                   (stream->mode & STREAM_BINARY);
+	compressed->path = string_clone(STRING_ARGS(stream->path));
+	compressed->vtable = &_compressed_stream_vtable;
+	compressed->stream = stream;
+	compressed->own = adopt;
+
+	if (compressed->mode & STREAM_OUT) {
+		//Compressed output can only be appended to
+		compressed->sequential = true;
+		compressed->block_size = block_size ? block_size : COMPRESSED_STREAM_DEFAULT_BLOCK_SIZE;
+		if (compressed->block_size > COMPRESSED_STREAM_MAX_BLOCK_SIZE)
+			compressed->block_size = COMPRESSED_STREAM_MAX_BLOCK_SIZE;
+		_compressed_stream_allocate_buffers(compressed);
+		compressed->table = memory_allocate(HASH_STREAM, sizeof(uint32_t) << LZ_HASH_BITS, 0,
+		                                    MEMORY_PERSISTENT);
+	}
+	else {
+		compressed->sequential = stream->sequential;
+		compressed->frame_offset = stream->sequential ? 0 : stream_tell(stream);
+	}
+}
+
+void
+_compressed_stream_initialize(void) {
+	memset(&_compressed_stream_vtable, 0, sizeof(_compressed_stream_vtable));
+	_compressed_stream_vtable.read = _compressed_stream_read;
+	_compressed_stream_vtable.write = _compressed_stream_write;
+	_compressed_stream_vtable.eos = _compressed_stream_eos;
+	_compressed_stream_vtable.flush = _compressed_stream_flush;
+	_compressed_stream_vtable.size = _compressed_stream_size;
+	_compressed_stream_vtable.seek = _compressed_stream_seek;
+	_compressed_stream_vtable.tell = _compressed_stream_tell;
+	_compressed_stream_vtable.lastmod = _compressed_stream_last_modified;
+	_compressed_stream_vtable.buffer_read = _compressed_stream_buffer_read;
+	_compressed_stream_vtable.available_read = _compressed_stream_available_read;
+	_compressed_stream_vtable.finalize = _compressed_stream_finalize;
+}
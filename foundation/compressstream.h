@@ -0,0 +1,63 @@
+/* compressstream.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file compressstream.h
+\brief Stream compressing or decompressing another stream
+
+Stream adapter compressing data on write to a wrapped stream, or decompressing data on read
+from a wrapped stream. Any stream type can be wrapped, for example file, memory buffer and
+pipe streams. A compressed stream is opened either for writing or for reading, not both.
+
+Data is compressed in independent blocks using a fast LZ77 compressor in the LZ4 block
+format, which favours speed over compression ratio. Blocks that do not compress are stored
+uncompressed. The compressed frame is a header followed by the blocks and an end marker,
+each block prefixed by its uncompressed and compressed size. Flushing a compressed stream
+ends the current block early, making all data written so far available to a reader on a
+sequential stream like a pipe.
+
+A compressed stream opened for reading can seek if the wrapped stream is not sequential.
+Blocks before the target position are skipped without decompressing them, only the block
+containing the target position is decompressed. Seeking from the end of the stream and
+querying the stream size requires scanning the block headers of the entire frame.
+
+Streams are not inherently thread safe, synchronization in a multithread use case must be
+done by caller. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a compressed stream wrapping the given stream. Deallocate the stream with a call
+to #stream_deallocate, which ends the frame of a stream opened for writing.
+\param stream Stream to wrap
+\param mode Open mode, STREAM_OUT to compress data written to the wrapped stream, otherwise
+            decompress data read from the wrapped stream
+\param block_size Maximum number of uncompressed bytes in a block when writing, 0 for default
+                  (64KiB). Ignored when reading, the block size is stored in the frame header
+\param adopt Take ownership of the wrapped stream, deallocating it with the compressed stream
+\return New compressed stream */
+FOUNDATION_API stream_t*
+compressed_stream_allocate(stream_t* stream, unsigned int mode, size_t block_size, bool adopt);
+
+/*! Initialize a compressed stream wrapping the given stream. Finalize the stream with a call
+to #stream_finalize, which ends the frame of a stream opened for writing.
+\param compressed Compressed stream
+\param stream Stream to wrap
+\param mode Open mode, STREAM_OUT to compress data written to the wrapped stream, otherwise
+            decompress data read from the wrapped stream
+\param block_size Maximum number of uncompressed bytes in a block when writing, 0 for default
+                  (64KiB). Ignored when reading, the block size is stored in the frame header
+\param adopt Take ownership of the wrapped stream, deallocating it with the compressed stream */
+FOUNDATION_API void
+compressed_stream_initialize(stream_compressed_t* compressed, stream_t* stream,
+                             unsigned int mode, size_t block_size, bool adopt);
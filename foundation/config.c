@@ -17,6 +17,9 @@
 #define CONFIG_SECTION_BUCKETS 7
 #define CONFIG_KEY_BUCKETS     11
 
+#define CONFIG_CACHE_MAGIC     0x43464743U //"CGFC"
+#define CONFIG_CACHE_VERSION   1
+
 enum config_type_t {
 	CONFIGVALUE_BOOL = 0,
 	CONFIGVALUE_INT,
@@ -27,11 +30,52 @@ enum config_type_t {
 	CONFIGVALUE_STRING_CONST_VAR
 };
 
+typedef struct config_expand_t config_expand_t;
+typedef struct config_cache_header_t config_cache_header_t;
+typedef struct config_cache_entry_t config_cache_entry_t;
+
+//Binary config cache file header, followed by the entries and the string pool. The cache is
+//valid for a source file with the same path, size and modification time
+struct config_cache_header_t {
+	uint32_t magic;
+	uint32_t version;
+	hash_t source;
+	hash_t filter_section;
+	uint64_t source_size;
+	tick_t source_modified;
+	uint32_t num_entries;
+	uint32_t string_size;
+};
+
+//Parsed declaration, string values are stored in the string pool
+struct config_cache_entry_t {
+	hash_t section;
+	hash_t key;
+	union {
+		int64_t ival;
+		float64_t rval;
+	} value;
+	uint32_t type;
+	uint32_t string_offset;
+	uint32_t string_length;
+	uint32_t unused;
+};
+
+//Value of a variable key, expanded when queried. Shared by all copies of the key in
+//published stores and only accessed with the writer lock held
+struct config_expand_t {
+	string_t expanded;
+	int64_t ival;
+	real rval;
+	bool bval;
+};
+
 struct config_key_t {
 	hash_t name;
 	int64_t ival;
 	string_t sval;
-	string_t expanded;
+	config_expand_t* expand;
+	config_key_handle_t* handle;
 	real rval;
 	enum config_type_t type;
 	bool bval;
@@ -42,14 +86,86 @@ struct config_section_t {
 	struct config_key_t* key[CONFIG_KEY_BUCKETS];
 };
 
+//Immutable snapshot of the config repository. Writers copy the store, section bucket and key
+//bucket they modify and publish the new store, readers never block
+struct config_store_t {
+	struct config_section_t* section[CONFIG_SECTION_BUCKETS];
+};
+
+//Handle to a key, pointing to the key in the current store. Writers update the pointer when
+//publishing a store where the key moved
+struct config_key_handle_t {
+	hash_t section;
+	hash_t key;
+	atomicptr_t value;
+	atomic32_t version;
+	config_key_handle_t* next;
+};
+
+//Config file loaded with monitoring enabled, holding the declarations last parsed from it
+struct config_file_t {
+	string_t path;
+	hash_t filter_section;
+	config_cache_entry_t* entries;
+	char* strings;
+};
+
 typedef FOUNDATION_ALIGN(8) struct config_key_t config_key_t;
 typedef FOUNDATION_ALIGN(8) struct config_section_t config_section_t;
+typedef struct config_store_t config_store_t;
+typedef struct config_file_t config_file_t;
 
 FOUNDATION_STATIC_ASSERT(FOUNDATION_ALIGNOF(config_key_t) == 8, "config_key_t alignment");
 FOUNDATION_STATIC_ASSERT(FOUNDATION_ALIGNOF(config_section_t) == 8, "config_section_t alignment");
 
-//Global config store
-static config_section_t* _config_section[CONFIG_SECTION_BUCKETS];
+//Global config store, current snapshot
+static atomicptr_t _config_store;
+
+//Writer lock, also serializing expansion of variable keys
+static lock_t _config_lock;
+
+//Number of retired allocations pending before trying to reclaim
+#define CONFIG_RECLAIM_THRESHOLD 64
+
+typedef struct config_retired_t config_retired_t;
+typedef struct config_reader_t config_reader_t;
+
+//Storage replaced by a writer, deallocated once no reader can still observe it
+struct config_retired_t {
+	void* memory;
+	void (*deallocate)(void*);
+	int64_t epoch;
+};
+
+//Per-thread reader state, announcing the epoch the reader started in
+FOUNDATION_ALIGNED_STRUCT(config_reader_t, 64) {
+	//Announced epoch while in read section, 0 if not reading
+	atomic64_t epoch;
+	atomic32_t owned;
+	unsigned int depth;
+	config_reader_t* next;
+};
+
+//Storage replaced by writers, only accessed with the writer lock held
+static config_retired_t* _config_retired;
+
+static atomic64_t _config_epoch;
+static atomicptr_t _config_readers;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(config_reader_t*, config_reader, 0)
+
+//Key handles by combined section and key hash, chained on collision. Only accessed by writers
+static hashmap_t* _config_handles;
+
+//Monitored config files, lock order is file lock before writer lock
+static config_file_t* _config_files;
+static lock_t _config_file_lock;
+
+//Config change events
+static event_stream_t* _config_event_stream;
+
+static string_const_t
+_config_string(hash_t section, hash_t key);
 
 static int64_t
 _config_string_to_int(string_const_t str) {
@@ -169,7 +285,7 @@ _expand_string(hash_t section_current, string_t str) {
 		           variable.length - (var_offset + (variable.str[ variable.length - 1 ] == ')' ? 1 : 0)));
 
 		if (section != HASH_ENVIRONMENT)
-			value = config_string(section, key);
+			value = _config_string(section, key);
 		else
 			value = _expand_environment(key, string_substr(STRING_ARGS(variable), var_offset,
 			                                               variable.length - (var_offset + 1)));
@@ -198,23 +314,174 @@ _expand_string(hash_t section_current, string_t str) {
 	return expanded;
 }
 
-static FOUNDATION_NOINLINE void
-_expand_string_val(hash_t section, config_key_t* key) {
-	bool is_true;
+static void
+_config_parse_string_val(string_const_t value, bool* bval, int64_t* ival, real* rval) {
+	bool is_true = string_equal(STRING_ARGS(value), STRING_CONST("true"));
+	*bval = (string_equal(STRING_ARGS(value), STRING_CONST("false")) ||
+	         string_equal(STRING_ARGS(value), STRING_CONST("0")) ||
+	         !value.length) ? false : true;
+	*ival = is_true ? 1 : _config_string_to_int(value);
+	*rval = is_true ? REAL_C(1.0) : _config_string_to_real(value);
+}
+
+static void
+_config_deallocate_expand(void* memory) {
+	config_expand_t* expand = memory;
+	string_deallocate(expand->expanded.str);
+	memory_deallocate(expand);
+}
+
+static void
+_config_deallocate_array(void* memory) {
+	array_deallocate(memory);
+}
+
+static void
+_config_deallocate_memory(void* memory) {
+	memory_deallocate(memory);
+}
+
+static config_reader_t*
+_config_reader(void) {
+	config_reader_t* reader = get_thread_config_reader();
+	void* head;
+	if (reader)
+		return reader;
+
+	//Reuse state released by a finished thread, or add new state
+	for (reader = atomic_loadptr(&_config_readers); reader; reader = reader->next) {
+		if (!atomic_load32(&reader->owned) && atomic_cas32(&reader->owned, 1, 0))
+			break;
+	}
+	if (!reader) {
+		reader = memory_allocate(0, sizeof(config_reader_t), 64,
+		                         MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		atomic_store32(&reader->owned, 1);
+		do {
+			head = atomic_loadptr(&_config_readers);
+			reader->next = head;
+		}
+		while (!atomic_cas_ptr(&_config_readers, reader, head));
+	}
+
+	set_thread_config_reader(reader);
+	return reader;
+}
+
+void
+config_read_begin(void) {
+	config_reader_t* reader = _config_reader();
+	if (!reader->depth++) {
+		atomic_store64(&reader->epoch, atomic_load64(&_config_epoch));
+		atomic_thread_fence_sequentially_consistent();
+	}
+}
+
+void
+config_read_end(void) {
+	config_reader_t* reader = get_thread_config_reader();
+	FOUNDATION_ASSERT_MSG(reader && reader->depth, "Mismatched config read section");
+	if (!--reader->depth) {
+		atomic_thread_fence_release();
+		atomic_store64(&reader->epoch, 0);
+	}
+}
+
+static void
+_config_epoch_advance(void) {
+	config_reader_t* reader;
+	int64_t epoch = atomic_load64(&_config_epoch);
+
+	//Epoch can only advance once all threads in a read section have observed current epoch
+	atomic_thread_fence_sequentially_consistent();
+	for (reader = atomic_loadptr(&_config_readers); reader; reader = reader->next) {
+		int64_t announced = atomic_load64(&reader->epoch);
+		if (announced && (announced != epoch))
+			return;
+	}
+	atomic_cas64(&_config_epoch, epoch + 1, epoch);
+}
+
+//Deallocate retired storage no longer observable by readers, must be called with the writer
+//lock held
+static void
+_config_reclaim(void) {
+	size_t iretired, kept, size;
+	int64_t epoch;
+
+	//Storage retired in epoch N might be in use by readers until epoch N+2
+	_config_epoch_advance();
+	_config_epoch_advance();
+	epoch = atomic_load64(&_config_epoch);
+
+	for (iretired = 0, kept = 0, size = array_size(_config_retired); iretired < size; ++iretired) {
+		config_retired_t retired = _config_retired[iretired];
+		if (retired.epoch + 2 <= epoch)
+			retired.deallocate(retired.memory);
+		else
+			_config_retired[kept++] = retired;
+	}
+	if (size)
+		array_resize(_config_retired, kept);
+}
+
+//Retire storage replaced by a writer, must be called with the writer lock held
+static void
+_config_retire(void* memory, void (*deallocate)(void*)) {
+	config_retired_t retired;
+	retired.memory = memory;
+	retired.deallocate = deallocate;
+	//Epoch only advances with the writer lock held, so it is the same when the replacement
+	//is published later in the writer section
+	retired.epoch = atomic_load64(&_config_epoch);
+	array_push_memcpy(_config_retired, &retired);
+}
+
+void
+_config_thread_finalize(void) {
+	config_reader_t* reader = get_thread_config_reader();
+	if (!reader)
+		return;
+	reader->depth = 0;
+	atomic_store64(&reader->epoch, 0);
+	set_thread_config_reader(0);
+	atomic_thread_fence_release();
+	atomic_store32(&reader->owned, 0);
+}
+
+//Expand a variable key, must be called with the writer lock held. A changed expansion retires
+//the previous expanded string which might have been returned to a reader
+static FOUNDATION_NOINLINE const config_expand_t*
+_expand_string_val(hash_t section, const config_key_t* key) {
+	config_expand_t* expand = key->expand;
+	string_t expanded;
 	FOUNDATION_ASSERT(key->sval.str);
-	if (key->expanded.str != key->sval.str)
-		string_deallocate(key->expanded.str);
-	key->expanded = _expand_string(section, key->sval);
+	expanded = _expand_string(section, key->sval);
+	if (expanded.str == key->sval.str)
+		expanded = string_clone(STRING_ARGS(expanded));
+	if (expand->expanded.str &&
+	        string_equal(STRING_ARGS(expanded), STRING_ARGS(expand->expanded))) {
+		string_deallocate(expanded.str);
+		return expand;
+	}
 
-	is_true = string_equal(STRING_ARGS(key->expanded), STRING_CONST("true"));
-	key->bval = (string_equal(STRING_ARGS(key->expanded), STRING_CONST("false")) ||
-	             string_equal(STRING_ARGS(key->expanded), STRING_CONST("0")) ||
-	             !key->expanded.length) ? false : true;
-	key->ival = is_true ? 1 : _config_string_to_int(string_to_const(key->expanded));
-	key->rval = is_true ? REAL_C(1.0) : _config_string_to_real(string_to_const(key->expanded));
+	if (expand->expanded.str) {
+		_config_retire(expand->expanded.str, _config_deallocate_memory);
+		if (array_size(_config_retired) >= CONFIG_RECLAIM_THRESHOLD)
+			_config_reclaim();
+	}
+	expand->expanded = expanded;
+	_config_parse_string_val(string_to_const(expanded), &expand->bval, &expand->ival,
+	                         &expand->rval);
+	return expand;
 }
 
 int _config_initialize(void) {
+	atomic_store64(&_config_epoch, 1);
+	lock_initialize(&_config_lock);
+	lock_initialize(&_config_file_lock);
+	_config_event_stream = event_stream_allocate(0);
+
 	config_load(STRING_CONST("foundation"), HASH_FOUNDATION, true, false);
 	config_load(STRING_CONST("application"), HASH_APPLICATION, true, false);
 
@@ -228,19 +495,21 @@ int _config_initialize(void) {
 
 void
 _config_finalize(void) {
-	size_t isb, is, ikb, ik, ssize, ksize;
+	size_t isb, is, ikb, ik, ssize, ksize, ir, rsize;
+	config_store_t* store = atomic_loadptr(&_config_store);
 	config_section_t* section;
 	config_key_t* key;
-	for (isb = 0; isb < CONFIG_SECTION_BUCKETS; ++isb) {
-		section = _config_section[isb];
+	config_reader_t* reader;
+	for (isb = 0; store && (isb < CONFIG_SECTION_BUCKETS); ++isb) {
+		section = store->section[isb];
 		for (is = 0, ssize = array_size(section); is < ssize; ++is) {
 			for (ikb = 0; ikb < CONFIG_KEY_BUCKETS; ++ikb) {
 				/*lint -e{613} array_size( section ) in loop condition does the null pointer guard */
 				key = section[is].key[ikb];
 				for (ik = 0, ksize = array_size(key); ik < ksize; ++ik) {
 					/*lint --e{613} array_size( key ) in loop condition does the null pointer guard */
-					if (key[ik].expanded.str != key[ik].sval.str)
-						string_deallocate(key[ik].expanded.str);
+					if (key[ik].expand)
+						_config_deallocate_expand(key[ik].expand);
 					if ((key[ik].type != CONFIGVALUE_STRING_CONST) && (key[ik].type != CONFIGVALUE_STRING_CONST_VAR))
 						string_deallocate(key[ik].sval.str);
 				}
@@ -249,6 +518,46 @@ _config_finalize(void) {
 		}
 		array_deallocate(section);
 	}
+	memory_deallocate(store);
+	atomic_storeptr(&_config_store, 0);
+
+	//No readers left, deallocate all retired storage and reader state
+	for (ir = 0, rsize = array_size(_config_retired); ir < rsize; ++ir)
+		_config_retired[ir].deallocate(_config_retired[ir].memory);
+	array_deallocate(_config_retired);
+	reader = atomic_loadptr(&_config_readers);
+	atomic_storeptr(&_config_readers, 0);
+	set_thread_config_reader(0);
+	while (reader) {
+		config_reader_t* next = reader->next;
+		memory_deallocate(reader);
+		reader = next;
+	}
+
+	if (_config_handles) {
+		hashmap_node_t* node = hashmap_next(_config_handles, 0);
+		while (node) {
+			config_key_handle_t* handle = node->value;
+			while (handle) {
+				config_key_handle_t* next = handle->next;
+				memory_deallocate(handle);
+				handle = next;
+			}
+			node = hashmap_next(_config_handles, node);
+		}
+		hashmap_deallocate(_config_handles);
+		_config_handles = 0;
+	}
+
+	for (ir = 0, rsize = array_size(_config_files); ir < rsize; ++ir) {
+		string_deallocate(_config_files[ir].path.str);
+		array_deallocate(_config_files[ir].entries);
+		array_deallocate(_config_files[ir].strings);
+	}
+	array_deallocate(_config_files);
+
+	event_stream_deallocate(_config_event_stream);
+	_config_event_stream = 0;
 }
 
 static const string_const_t platformsuffix =
@@ -457,7 +766,6 @@ config_load(const char* name, size_t length, hash_t filter_section, bool built_i
 	char buffer[BUILD_MAX_PATHLEN];
 	string_t pathname;
 	string_t filename;
-	stream_t* istream;
 	int start_path = 0;
 	int end_path = 6;
 	int ipath;
@@ -481,147 +789,253 @@ config_load(const char* name, size_t length, hash_t filter_section, bool built_i
 		                         STRING_CONST("/%.*s.ini"), (int)length, name);
 		filename.str = pathname.str;
 		filename.length += pathname.length;
-		istream = stream_open(STRING_ARGS(filename), STREAM_IN);
-		if (istream) {
-			config_parse(istream, filter_section, overwrite);
-			stream_deallocate(istream);
-		}
+		config_load_file(STRING_ARGS(filename), filter_section, overwrite);
 
 		if (built_in) {
 			filename = string_format(pathname.str + pathname.length, sizeof(buffer) - pathname.length,
 			                         STRING_CONST("%.*s/%.*s.ini"), STRING_FORMAT(platformsuffix), (int)length, name);
 			filename.str = pathname.str;
 			filename.length += pathname.length;
-			istream = stream_open(STRING_ARGS(filename), STREAM_IN);
-			if (istream) {
-				config_parse(istream, filter_section, overwrite);
-				stream_deallocate(istream);
-			}
+			config_load_file(STRING_ARGS(filename), filter_section, overwrite);
 		}
 	}
 }
 
-static FOUNDATION_NOINLINE config_section_t*
-config_section(hash_t section, bool create) {
-	config_section_t* bucket;
+static FOUNDATION_NOINLINE const config_section_t*
+config_section(hash_t section) {
+	const config_store_t* store = atomic_loadptr_explicit(&_config_store, MEMORY_ORDER_ACQUIRE);
+	const config_section_t* bucket;
 	size_t ib, bsize;
 
+	if (!store)
+		return 0;
+
 	/*lint --e{613} */
-	bucket = _config_section[ section % CONFIG_SECTION_BUCKETS ];
+	bucket = store->section[ section % CONFIG_SECTION_BUCKETS ];
 	for (ib = 0, bsize = array_size(bucket); ib < bsize; ++ib) {
 		if (bucket[ib].name == section)
 			return bucket + ib;
 	}
 
-	if (!create)
-		return 0;
+	return 0;
+}
 
-	//TODO: Thread safeness
-	{
-		config_section_t new_section;
-		memset(&new_section, 0, sizeof(new_section));
-		new_section.name = section;
+static FOUNDATION_NOINLINE const config_key_t*
+config_key(hash_t section, hash_t key) {
+	const config_section_t* csection = config_section(section);
+	const config_key_t* bucket;
+	size_t ib, bsize;
 
-		array_push_memcpy(bucket, &new_section);
-		_config_section[ section % CONFIG_SECTION_BUCKETS ] = bucket;
+	if (!csection)
+		return 0;
+
+	/*lint --e{613} */
+	bucket = csection->key[ key % CONFIG_KEY_BUCKETS ];
+	for (ib = 0, bsize = array_size(bucket); ib < bsize; ++ib) {
+		if (bucket[ib].name == key)
+			return bucket + ib;
 	}
 
-	return bucket + bsize;
+	return 0;
+}
+
+static hash_t
+_config_handle_hash(hash_t section, hash_t key) {
+	return key ^ (section * 0x9E3779B97F4A7C15ULL);
+}
+
+//Find handle for the key, must be called with the writer lock held
+static config_key_handle_t*
+_config_handle_lookup(hash_t section, hash_t key) {
+	config_key_handle_t* handle = 0;
+	if (_config_handles)
+		handle = hashmap_lookup(_config_handles, _config_handle_hash(section, key));
+	while (handle && ((handle->section != section) || (handle->key != key)))
+		handle = handle->next;
+	return handle;
 }
 
-static FOUNDATION_NOINLINE config_key_t*
-config_key(hash_t section, hash_t key, bool create) {
-	config_key_t new_key;
-	config_section_t* csection;
-	config_key_t* bucket;
+//Store a new value for the key by copying the store, section bucket and key bucket and
+//publishing the copy. The replaced value and storage are retired
+static void
+config_store(hash_t section, const config_key_t* value) {
+	config_store_t* store;
+	config_store_t* new_store;
+	config_section_t* sections = 0;
+	config_key_t* bucket = 0;
+	size_t isection = section % CONFIG_SECTION_BUCKETS;
+	size_t ikey = value->name % CONFIG_KEY_BUCKETS;
 	size_t ib, bsize;
+	config_key_handle_t* handle;
+	config_key_handle_t* changed;
+
+	lock_lock(&_config_lock);
+
+	store = atomic_loadptr(&_config_store);
+	new_store = memory_allocate(0, sizeof(config_store_t), 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	if (store)
+		*new_store = *store;
 
 	/*lint --e{613} */
-	csection = config_section(section, create);
-	if (!csection) {
-		FOUNDATION_ASSERT(!create);
-		return 0;
+	if (new_store->section[isection])
+		array_copy(sections, new_store->section[isection]);
+	for (ib = 0, bsize = array_size(sections); ib < bsize; ++ib) {
+		if (sections[ib].name == section)
+			break;
 	}
-	bucket = csection->key[ key % CONFIG_KEY_BUCKETS ];
+	if (ib == bsize) {
+		config_section_t new_section;
+		memset(&new_section, 0, sizeof(new_section));
+		new_section.name = section;
+		array_push_memcpy(sections, &new_section);
+	}
+	else if (sections[ib].key[ikey]) {
+		array_copy(bucket, sections[ib].key[ikey]);
+		_config_retire(sections[ib].key[ikey], _config_deallocate_array);
+	}
+
+	{
+		config_section_t* csection = sections + ib;
+		for (ib = 0, bsize = array_size(bucket); ib < bsize; ++ib) {
+			if (bucket[ib].name == value->name)
+				break;
+		}
+		if (ib < bsize) {
+			config_key_t* old = bucket + ib;
+			if (old->expand)
+				_config_retire(old->expand, _config_deallocate_expand);
+			if (old->sval.str && (old->type != CONFIGVALUE_STRING_CONST) &&
+			        (old->type != CONFIGVALUE_STRING_CONST_VAR))
+				_config_retire(old->sval.str, _config_deallocate_memory);
+			handle = old->handle;
+			*old = *value;
+			old->handle = handle;
+		}
+		else {
+			array_push_memcpy(bucket, value);
+			bucket[ib].handle = _config_handle_lookup(section, value->name);
+		}
+		csection->key[ikey] = bucket;
+		changed = bucket[ib].handle;
+	}
+
+	if (new_store->section[isection])
+		_config_retire(new_store->section[isection], _config_deallocate_array);
+	new_store->section[isection] = sections;
+
+	atomic_storeptr_explicit(&_config_store, new_store, MEMORY_ORDER_RELEASE);
+	if (store)
+		_config_retire(store, _config_deallocate_memory);
+
+	//Keys in the copied bucket moved, point handles to the published keys
 	for (ib = 0, bsize = array_size(bucket); ib < bsize; ++ib) {
-		if (bucket[ib].name == key)
-			return bucket + ib;
+		if (bucket[ib].handle)
+			atomic_storeptr_explicit(&bucket[ib].handle->value, bucket + ib, MEMORY_ORDER_RELEASE);
 	}
+	if (changed)
+		atomic_incr32(&changed->version);
 
-	if (!create)
-		return 0;
+	if (array_size(_config_retired) >= CONFIG_RECLAIM_THRESHOLD)
+		_config_reclaim();
 
-	memset(&new_key, 0, sizeof(new_key));
-	new_key.name = key;
+	lock_unlock(&_config_lock);
+}
+
+static bool
+_config_key_bool(hash_t section, const config_key_t* key_val) {
+	if (key_val && key_val->expand) {
+		bool value;
+		lock_lock(&_config_lock);
+		value = _expand_string_val(section, key_val)->bval;
+		lock_unlock(&_config_lock);
+		return value;
+	}
+	return key_val ? key_val->bval : false;
+}
 
-	//TODO: Thread safeness
-	array_push_memcpy(bucket, &new_key);
-	csection->key[ key % CONFIG_KEY_BUCKETS ] = bucket;
+static int64_t
+_config_key_int(hash_t section, const config_key_t* key_val) {
+	if (key_val && key_val->expand) {
+		int64_t value;
+		lock_lock(&_config_lock);
+		value = _expand_string_val(section, key_val)->ival;
+		lock_unlock(&_config_lock);
+		return value;
+	}
+	return key_val ? key_val->ival : 0;
+}
+
+static real
+_config_key_real(hash_t section, const config_key_t* key_val) {
+	if (key_val && key_val->expand) {
+		real value;
+		lock_lock(&_config_lock);
+		value = _expand_string_val(section, key_val)->rval;
+		lock_unlock(&_config_lock);
+		return value;
+	}
+	return key_val ? key_val->rval : 0;
+}
 
-	return bucket + bsize;
+//Get string value of key, variables are expanded with the writer lock held
+static string_const_t
+_config_key_string(hash_t section, const config_key_t* key_val, bool locked) {
+	if (key_val && key_val->expand) {
+		string_const_t value;
+		if (!locked)
+			lock_lock(&_config_lock);
+		value = string_to_const(_expand_string_val(section, key_val)->expanded);
+		if (!locked)
+			lock_unlock(&_config_lock);
+		return value;
+	}
+	if (key_val && (key_val->type == CONFIGVALUE_BOOL))
+		return key_val->bval ? string_const(STRING_CONST("true")) : string_const(STRING_CONST("false"));
+	if (!key_val || !key_val->sval.str)
+		return string_const("", 0);
+	return string_to_const(key_val->sval);
 }
 
 bool
 config_bool(hash_t section, hash_t key) {
-	config_key_t* key_val = config_key(section, key, false);
-	if (key_val && (key_val->type >= CONFIGVALUE_STRING_VAR))
-		_expand_string_val(section, key_val);
-	return key_val ? key_val->bval : false;
+	bool value;
+	config_read_begin();
+	value = _config_key_bool(section, config_key(section, key));
+	config_read_end();
+	return value;
 }
 
 int64_t
 config_int(hash_t section, hash_t key) {
-	config_key_t* key_val = config_key(section, key, false);
-	if (key_val && (key_val->type >= CONFIGVALUE_STRING_VAR))
-		_expand_string_val(section, key_val);
-	return key_val ? key_val->ival : 0;
+	int64_t value;
+	config_read_begin();
+	value = _config_key_int(section, config_key(section, key));
+	config_read_end();
+	return value;
 }
 
 real
 config_real(hash_t section, hash_t key) {
-	config_key_t* key_val = config_key(section, key, false);
-	if (key_val && (key_val->type >= CONFIGVALUE_STRING_VAR))
-		_expand_string_val(section, key_val);
-	return key_val ? key_val->rval : 0;
+	real value;
+	config_read_begin();
+	value = _config_key_real(section, config_key(section, key));
+	config_read_end();
+	return value;
+}
+
+//Get string value, must be called with the writer lock held
+static string_const_t
+_config_string(hash_t section, hash_t key) {
+	return _config_key_string(section, config_key(section, key), true);
 }
 
 string_const_t
 config_string(hash_t section, hash_t key) {
-	config_key_t* key_val = config_key(section, key, false);
-	if (!key_val)
-		return string_const("", 0);
-	//Convert to string
-	/*lint --e{788} We use default for remaining enums */
-	switch (key_val->type) {
-	case CONFIGVALUE_BOOL:
-		if (key_val->bval)
-			return (string_const_t) {STRING_CONST("true")};
-		return (string_const_t) {STRING_CONST("false")};
-
-	case CONFIGVALUE_INT:
-		if (!key_val->sval.str)
-			key_val->sval = string_clone_string(string_from_int_static(key_val->ival, 0, 0));
-		return string_to_const(key_val->sval);
-
-	case CONFIGVALUE_REAL:
-		if (!key_val->sval.str)
-			key_val->sval = string_clone_string(string_from_real_static(key_val->rval, 4, 0, '0'));
-		return string_to_const(key_val->sval);
-
-	case CONFIGVALUE_STRING:
-	case CONFIGVALUE_STRING_CONST:
-	case CONFIGVALUE_STRING_VAR:
-	case CONFIGVALUE_STRING_CONST_VAR:
-		break;
-	}
-	//String value of some form
-	if (!key_val->sval.str)
-		return string_const("", 0);
-	if (key_val->type >= CONFIGVALUE_STRING_VAR) {
-		_expand_string_val(section, key_val);
-		return string_to_const(key_val->expanded);
-	}
-	return string_to_const(key_val->sval);
+	string_const_t value;
+	config_read_begin();
+	value = _config_key_string(section, config_key(section, key), false);
+	config_read_end();
+	return value;
 }
 
 hash_t
@@ -630,93 +1044,229 @@ config_hash(hash_t section, hash_t key) {
 	return value.length ? hash(STRING_ARGS(value)) : HASH_EMPTY_STRING;
 }
 
-#define CLEAR_KEY_STRINGS( key_val ) \
-	if( key_val->expanded.str != key_val->sval.str ) \
-		string_deallocate( key_val->expanded.str ); \
-	if( ( key_val->type != CONFIGVALUE_STRING_CONST ) && ( key_val->type != CONFIGVALUE_STRING_CONST_VAR ) ) \
-		string_deallocate( key_val->sval.str ); \
-	key_val->expanded = key_val->sval = (string_t){ 0, 0 }
+config_key_handle_t*
+config_key_handle(hash_t section, hash_t key) {
+	config_key_handle_t* handle;
+	config_key_t* key_val;
+
+	lock_lock(&_config_lock);
+
+	handle = _config_handle_lookup(section, key);
+	if (!handle) {
+		hash_t handle_hash = _config_handle_hash(section, key);
+		handle = memory_allocate(0, sizeof(config_key_handle_t), 0,
+		                         MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		handle->section = section;
+		handle->key = key;
+		if (!_config_handles)
+			_config_handles = hashmap_allocate(32, 8);
+		handle->next = hashmap_insert(_config_handles, handle_hash, handle);
+
+		//Writers read the handle from the published key, readers never do
+		key_val = (config_key_t*)config_key(section, key);
+		if (key_val) {
+			key_val->handle = handle;
+			atomic_storeptr_explicit(&handle->value, key_val, MEMORY_ORDER_RELEASE);
+		}
+	}
+
+	lock_unlock(&_config_lock);
+
+	return handle;
+}
+
+uint32_t
+config_handle_version(config_key_handle_t* handle) {
+	return (uint32_t)atomic_load32_explicit(&handle->version, MEMORY_ORDER_ACQUIRE);
+}
+
+bool
+config_handle_bool(config_key_handle_t* handle) {
+	bool value;
+	config_read_begin();
+	value = _config_key_bool(handle->section,
+	                         atomic_loadptr_explicit(&handle->value, MEMORY_ORDER_ACQUIRE));
+	config_read_end();
+	return value;
+}
+
+int64_t
+config_handle_int(config_key_handle_t* handle) {
+	int64_t value;
+	config_read_begin();
+	value = _config_key_int(handle->section,
+	                        atomic_loadptr_explicit(&handle->value, MEMORY_ORDER_ACQUIRE));
+	config_read_end();
+	return value;
+}
+
+real
+config_handle_real(config_key_handle_t* handle) {
+	real value;
+	config_read_begin();
+	value = _config_key_real(handle->section,
+	                         atomic_loadptr_explicit(&handle->value, MEMORY_ORDER_ACQUIRE));
+	config_read_end();
+	return value;
+}
+
+string_const_t
+config_handle_string(config_key_handle_t* handle) {
+	string_const_t value;
+	config_read_begin();
+	value = _config_key_string(handle->section,
+	                           atomic_loadptr_explicit(&handle->value, MEMORY_ORDER_ACQUIRE), false);
+	config_read_end();
+	return value;
+}
 
 void
 config_set_bool(hash_t section, hash_t key, bool value) {
-	config_key_t* key_val = config_key(section, key, true);
-	if (!FOUNDATION_VALIDATE(key_val)) return;
-	key_val->bval = value;
-	key_val->ival = (value ? 1 : 0);
-	key_val->rval = (value ? REAL_C(1.0) : REAL_C(0.0));
-	CLEAR_KEY_STRINGS(key_val);
-	key_val->type = CONFIGVALUE_BOOL;
+	config_key_t key_val;
+	memset(&key_val, 0, sizeof(key_val));
+	key_val.name = key;
+	key_val.bval = value;
+	key_val.ival = (value ? 1 : 0);
+	key_val.rval = (value ? REAL_C(1.0) : REAL_C(0.0));
+	key_val.type = CONFIGVALUE_BOOL;
+	config_store(section, &key_val);
 }
 
 void
 config_set_int(hash_t section, hash_t key, int64_t value) {
-	config_key_t* key_val = config_key(section, key, true);
-	if (!FOUNDATION_VALIDATE(key_val)) return;
-	key_val->bval = value ? true : false;
-	key_val->ival = value;
-	key_val->rval = (real)value;
-	CLEAR_KEY_STRINGS(key_val);
-	key_val->type = CONFIGVALUE_INT;
+	config_key_t key_val;
+	memset(&key_val, 0, sizeof(key_val));
+	key_val.name = key;
+	key_val.bval = value ? true : false;
+	key_val.ival = value;
+	key_val.rval = (real)value;
+	key_val.sval = string_clone_string(string_from_int_static(value, 0, 0));
+	key_val.type = CONFIGVALUE_INT;
+	config_store(section, &key_val);
 }
 
 void
 config_set_real(hash_t section, hash_t key, real value) {
-	config_key_t* key_val = config_key(section, key, true);
-	if (!FOUNDATION_VALIDATE(key_val)) return;
-	key_val->bval = !math_real_is_zero(value);
-	key_val->ival = (int64_t)value;
-	key_val->rval = value;
-	CLEAR_KEY_STRINGS(key_val);
-	key_val->type = CONFIGVALUE_REAL;
+	config_key_t key_val;
+	memset(&key_val, 0, sizeof(key_val));
+	key_val.name = key;
+	key_val.bval = !math_real_is_zero(value);
+	key_val.ival = (int64_t)value;
+	key_val.rval = value;
+	key_val.sval = string_clone_string(string_from_real_static(value, 4, 0, '0'));
+	key_val.type = CONFIGVALUE_REAL;
+	config_store(section, &key_val);
+}
+
+static void
+config_set_string_value(hash_t section, hash_t key, string_t value, bool constant) {
+	config_key_t key_val;
+	bool variable = (string_find_string(STRING_ARGS(value), STRING_CONST("$("), 0) != STRING_NPOS);
+	memset(&key_val, 0, sizeof(key_val));
+	key_val.name = key;
+	key_val.sval = value;
+	if (variable) {
+		key_val.type = constant ? CONFIGVALUE_STRING_CONST_VAR : CONFIGVALUE_STRING_VAR;
+		key_val.expand = memory_allocate(0, sizeof(config_expand_t), 0,
+		                                 MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	}
+	else {
+		key_val.type = constant ? CONFIGVALUE_STRING_CONST : CONFIGVALUE_STRING;
+		_config_parse_string_val(string_to_const(value), &key_val.bval, &key_val.ival, &key_val.rval);
+	}
+	config_store(section, &key_val);
 }
 
 void
 config_set_string(hash_t section, hash_t key, const char* value, size_t length) {
-	config_key_t* key_val = config_key(section, key, true);
-	if (!FOUNDATION_VALIDATE(key_val)) return;
-	CLEAR_KEY_STRINGS(key_val);
-
-	key_val->sval = string_clone(value, length);
-	key_val->type = ((string_find_string(key_val->sval.str, key_val->sval.length,
-	                                     STRING_CONST("$("), 0) != STRING_NPOS) ?
-	                 CONFIGVALUE_STRING_VAR : CONFIGVALUE_STRING);
-
-	if (key_val->type == CONFIGVALUE_STRING) {
-		bool is_true = string_equal(STRING_ARGS(key_val->sval), STRING_CONST("true"));
-		key_val->bval = (string_equal(STRING_ARGS(key_val->sval), STRING_CONST("false")) ||
-		                 string_equal(STRING_ARGS(key_val->sval), STRING_CONST("0")) ||
-		                 !key_val->sval.length) ? false : true;
-		key_val->ival = is_true ? 1 : _config_string_to_int(string_to_const(key_val->sval));
-		key_val->rval = is_true ? REAL_C(1.0) : _config_string_to_real(string_to_const(key_val->sval));
-	}
+	config_set_string_value(section, key, string_clone(value, length), false);
 }
 
 void
 config_set_string_constant(hash_t section, hash_t key, const char* value, size_t length) {
-	config_key_t* key_val = config_key(section, key, true);
-	if (!FOUNDATION_VALIDATE(key_val)) return;
-	CLEAR_KEY_STRINGS(key_val);
+	string_t str;
+	//str.str = (char*)value;
+	memcpy(&str.str, &value, sizeof(char*));     //Yeah yeah, we're storing a const pointer in a non-const var
+	str.length = length;
+	config_set_string_value(section, key, str, true);
+}
 
-	//key_val->sval = (char*)value;
-	memcpy(&key_val->sval.str, &value,
-	       sizeof(char*));     //Yeah yeah, we're storing a const pointer in a non-const var
-	key_val->sval.length = length;
-	key_val->type = ((string_find_string(STRING_ARGS(key_val->sval),
-	                                     STRING_CONST("$("), 0) != STRING_NPOS) ?
-	                 CONFIGVALUE_STRING_CONST_VAR : CONFIGVALUE_STRING_CONST);
+static void
+_config_parse_entry(hash_t section, hash_t key, string_const_t value,
+                    config_cache_entry_t** entries, char** strings) {
+	config_cache_entry_t entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.section = section;
+	entry.key = key;
 
-	if (key_val->type == CONFIGVALUE_STRING_CONST) {
-		bool is_true = string_equal(STRING_ARGS(key_val->sval), STRING_CONST("true"));
-		key_val->bval = (string_equal(STRING_ARGS(key_val->sval), STRING_CONST("false")) ||
-		                 string_equal(STRING_ARGS(key_val->sval), STRING_CONST("0")) ||
-		                 !key_val->sval.length) ? false : true;
-		key_val->ival = is_true ? 1 : _config_string_to_int(string_to_const(key_val->sval));
-		key_val->rval = is_true ? REAL_C(1.0) : _config_string_to_real(string_to_const(key_val->sval));
+	if (!value.length) {
+		entry.type = CONFIGVALUE_STRING;
+	}
+	else if (string_equal(STRING_ARGS(value), STRING_CONST("false"))) {
+		entry.type = CONFIGVALUE_BOOL;
+		entry.value.ival = 0;
+	}
+	else if (string_equal(STRING_ARGS(value), STRING_CONST("true"))) {
+		entry.type = CONFIGVALUE_BOOL;
+		entry.value.ival = 1;
 	}
+	else if ((string_find(STRING_ARGS(value), '.', 0) != STRING_NPOS) &&
+	         (string_find_first_not_of(STRING_ARGS(value), STRING_CONST("0123456789."), 0) == STRING_NPOS) &&
+	         (string_find(STRING_ARGS(value), '.', string_find(STRING_ARGS(value), '.', 0) + 1) == STRING_NPOS)) {
+		entry.type = CONFIGVALUE_REAL; //Exactly one "."
+		entry.value.rval = (float64_t)string_to_real(STRING_ARGS(value));
+	}
+	else if (string_find_first_not_of(STRING_ARGS(value), STRING_CONST("0123456789"), 0) == STRING_NPOS) {
+		entry.type = CONFIGVALUE_INT;
+		entry.value.ival = string_to_int64(STRING_ARGS(value));
+	}
+	else {
+		entry.type = CONFIGVALUE_STRING;
+		entry.string_offset = (uint32_t)array_size(*strings);
+		entry.string_length = (uint32_t)value.length;
+		array_push_range_memcpy(*strings, value.str, value.length);
+	}
+
+	array_push_memcpy(*entries, &entry);
 }
 
-void
-config_parse(stream_t* stream, hash_t filter_section, bool overwrite) {
+static void
+_config_apply_entries(const config_cache_entry_t* entries, size_t count, const char* strings,
+                      bool overwrite) {
+	size_t ientry;
+	for (ientry = 0; ientry < count; ++ientry) {
+		const config_cache_entry_t* entry = entries + ientry;
+		if (!overwrite) {
+			bool exists;
+			config_read_begin();
+			exists = (config_key(entry->section, entry->key) != 0);
+			config_read_end();
+			if (exists)
+				continue;
+		}
+		switch (entry->type) {
+		case CONFIGVALUE_BOOL:
+			config_set_bool(entry->section, entry->key, entry->value.ival ? true : false);
+			break;
+		case CONFIGVALUE_INT:
+			config_set_int(entry->section, entry->key, entry->value.ival);
+			break;
+		case CONFIGVALUE_REAL:
+			config_set_real(entry->section, entry->key, (real)entry->value.rval);
+			break;
+		default:
+			config_set_string(entry->section, entry->key, strings + entry->string_offset,
+			                  entry->string_length);
+			break;
+		}
+	}
+}
+
+//Parse declarations into entries with values in the string pool, values are typed the same
+//way as when setting them directly
+static void
+_config_parse_entries(stream_t* stream, hash_t filter_section, config_cache_entry_t** entries,
+                      char** strings) {
 	string_t buffer;
 	string_const_t stripped;
 	hash_t section = 0;
@@ -783,32 +1333,297 @@ config_parse(stream_t* stream, hash_t filter_section, bool overwrite) {
 			}
 
 			key = hash(STRING_ARGS(name));
-
-			if (overwrite || !config_key(section, key, false)) {
 #if BUILD_ENABLE_CONFIG_DEBUG
-				log_debugf(HASH_CONFIG, STRING_CONST("  config: %.*s (0x%" PRIx64 ") = %s"), name, key, value);
+			log_debugf(HASH_CONFIG, STRING_CONST("  config: %.*s (0x%" PRIx64 ") = %.*s"),
+			           STRING_FORMAT(name), key, STRING_FORMAT(value));
 #endif
 
-				if (!value.length)
-					config_set_string(section, key, "", 0);
-				else if (string_equal(STRING_ARGS(value), STRING_CONST("false")))
-					config_set_bool(section, key, false);
-				else if (string_equal(STRING_ARGS(value), STRING_CONST("true")))
-					config_set_bool(section, key, true);
-				else if ((string_find(STRING_ARGS(value), '.', 0) != STRING_NPOS) &&
-				         (string_find_first_not_of(STRING_ARGS(value), STRING_CONST("0123456789."), 0) == STRING_NPOS) &&
-				         (string_find(STRING_ARGS(value), '.', string_find(STRING_ARGS(value), '.', 0) + 1) == STRING_NPOS))
-					config_set_real(section, key, string_to_real(STRING_ARGS(value))); //Exactly one "."
-				else if (string_find_first_not_of(STRING_ARGS(value), STRING_CONST("0123456789"), 0) == STRING_NPOS)
-					config_set_int(section, key, string_to_int64(STRING_ARGS(value)));
-				else
-					config_set_string(section, key, STRING_ARGS(value));
-			}
+			_config_parse_entry(section, key, value, entries, strings);
 		}
 	}
 	memory_deallocate(buffer.str);
 }
 
+void
+config_parse(stream_t* stream, hash_t filter_section, bool overwrite) {
+	config_cache_entry_t* entries = 0;
+	char* strings = 0;
+	_config_parse_entries(stream, filter_section, &entries, &strings);
+	_config_apply_entries(entries, array_size(entries), strings, overwrite);
+	array_deallocate(entries);
+	array_deallocate(strings);
+}
+
+#if FOUNDATION_PLATFORM_FAMILY_DESKTOP
+
+static string_t
+_config_cache_path(char* buffer, size_t capacity, hash_t source, hash_t filter_section) {
+	string_t path = config_make_path(8, buffer, capacity);
+	string_t filename;
+	if (!path.length)
+		return path;
+	filename = string_format(path.str + path.length, capacity - path.length,
+	                         STRING_CONST("/cache/%016" PRIx64 "-%016" PRIx64 ".cfgcache"),
+	                         source, filter_section);
+	path.length += filename.length;
+	return path;
+}
+
+//Apply a cached config file if the cache matches the source file, optionally copying the
+//declarations to the given arrays
+static bool
+_config_cache_load(string_const_t cachepath, const config_cache_header_t* expect, bool overwrite,
+                   config_cache_entry_t** copy_entries, char** copy_strings) {
+	const config_cache_header_t* header;
+	const config_cache_entry_t* entries;
+	const char* strings;
+	void* buffer = 0;
+	size_t size = 0;
+	bool valid;
+	stream_t* stream = fs_map_file(STRING_ARGS(cachepath), STREAM_IN | STREAM_BINARY);
+	if (stream) {
+		header = fs_mapped_data(stream, &size);
+	}
+	else {
+		stream = stream_open(STRING_ARGS(cachepath), STREAM_IN | STREAM_BINARY);
+		if (!stream)
+			return false;
+		size = stream_size(stream);
+		buffer = memory_allocate(0, size, 8, MEMORY_TEMPORARY);
+		size = stream_read(stream, buffer, size);
+		header = buffer;
+	}
+
+	valid = header && (size >= sizeof(config_cache_header_t)) &&
+	        (header->magic == expect->magic) && (header->version == expect->version) &&
+	        (header->source == expect->source) && (header->filter_section == expect->filter_section) &&
+	        (header->source_size == expect->source_size) &&
+	        (header->source_modified == expect->source_modified) &&
+	        (size == sizeof(config_cache_header_t) +
+	         (sizeof(config_cache_entry_t) * header->num_entries) + header->string_size);
+	if (valid) {
+		entries = pointer_offset_const(header, sizeof(config_cache_header_t));
+		strings = pointer_offset_const(entries, sizeof(config_cache_entry_t) * header->num_entries);
+		_config_apply_entries(entries, header->num_entries, strings, overwrite);
+		if (copy_entries) {
+			array_push_range_memcpy(*copy_entries, entries, header->num_entries);
+			array_push_range_memcpy(*copy_strings, strings, header->string_size);
+		}
+	}
+
+	memory_deallocate(buffer);
+	stream_deallocate(stream);
+	return valid;
+}
+
+static void
+_config_cache_store(string_const_t cachepath, config_cache_header_t* header,
+                    const config_cache_entry_t* entries, const char* strings) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_const_t directory = path_directory_name(STRING_ARGS(cachepath));
+	string_t temppath;
+	stream_t* stream;
+
+	//Write to a unique file and move in place so concurrent processes never see partial files
+	fs_make_directory(STRING_ARGS(directory));
+	temppath = string_format(buffer, sizeof(buffer), STRING_CONST("%.*s.%" PRIx64),
+	                         STRING_FORMAT(cachepath), random64());
+	stream = stream_open(STRING_ARGS(temppath), STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                     STREAM_TRUNCATE);
+	if (!stream)
+		return;
+	stream_write(stream, header, sizeof(config_cache_header_t));
+	stream_write(stream, entries, sizeof(config_cache_entry_t) * header->num_entries);
+	stream_write(stream, strings, header->string_size);
+	stream_deallocate(stream);
+
+	if (!fs_move_file(STRING_ARGS(temppath), STRING_ARGS(cachepath)))
+		fs_remove_file(STRING_ARGS(temppath));
+}
+
+#endif
+
+//Take ownership of the parsed declarations of a file and monitor its directory for changes
+static void
+_config_monitor_file(const char* path, size_t length, hash_t filter_section,
+                     config_cache_entry_t* entries, char* strings) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t abspath = string_copy(buffer, sizeof(buffer), path, length);
+	string_const_t directory;
+	config_file_t file;
+	size_t ifile, fsize;
+
+	abspath = path_clean(STRING_ARGS(abspath), sizeof(buffer));
+	abspath = path_absolute(STRING_ARGS(abspath), sizeof(buffer));
+
+	lock_lock(&_config_file_lock);
+	for (ifile = 0, fsize = array_size(_config_files); ifile < fsize; ++ifile) {
+		config_file_t* loaded = _config_files + ifile;
+		if (string_equal(STRING_ARGS(loaded->path), STRING_ARGS(abspath)) &&
+		        (loaded->filter_section == filter_section)) {
+			array_deallocate(loaded->entries);
+			array_deallocate(loaded->strings);
+			loaded->entries = entries;
+			loaded->strings = strings;
+			lock_unlock(&_config_file_lock);
+			return;
+		}
+	}
+	file.path = string_clone(STRING_ARGS(abspath));
+	file.filter_section = filter_section;
+	file.entries = entries;
+	file.strings = strings;
+	array_push_memcpy(_config_files, &file);
+	lock_unlock(&_config_file_lock);
+
+	directory = path_directory_name(STRING_ARGS(abspath));
+	fs_monitor(STRING_ARGS(directory));
+}
+
+void
+config_load_file(const char* path, size_t length, hash_t filter_section, bool overwrite) {
+	config_cache_entry_t* entries = 0;
+	char* strings = 0;
+	stream_t* stream;
+	bool monitor = _foundation_config.config_monitor;
+#if FOUNDATION_PLATFORM_FAMILY_DESKTOP
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t cachepath = {0, 0};
+	config_cache_header_t header;
+	memset(&header, 0, sizeof(header));
+
+	if (_foundation_config.config_cache) {
+		header.source_modified = fs_last_modified(path, length);
+		if (!header.source_modified)
+			return;
+		header.magic = CONFIG_CACHE_MAGIC;
+		header.version = CONFIG_CACHE_VERSION;
+		header.source = hash(path, length);
+		header.filter_section = filter_section;
+		header.source_size = fs_size(path, length);
+		cachepath = _config_cache_path(buffer, sizeof(buffer), header.source, filter_section);
+		if (cachepath.length &&
+		        _config_cache_load(string_to_const(cachepath), &header, overwrite,
+		                           monitor ? &entries : nullptr, &strings)) {
+			if (monitor)
+				_config_monitor_file(path, length, filter_section, entries, strings);
+			return;
+		}
+	}
+#endif
+
+	stream = stream_open(path, length, STREAM_IN);
+	if (!stream)
+		return;
+	_config_parse_entries(stream, filter_section, &entries, &strings);
+	stream_deallocate(stream);
+
+	_config_apply_entries(entries, array_size(entries), strings, overwrite);
+
+#if FOUNDATION_PLATFORM_FAMILY_DESKTOP
+	if (cachepath.length) {
+		header.num_entries = (uint32_t)array_size(entries);
+		header.string_size = (uint32_t)array_size(strings);
+		_config_cache_store(string_to_const(cachepath), &header, entries, strings);
+	}
+#endif
+
+	if (monitor) {
+		_config_monitor_file(path, length, filter_section, entries, strings);
+	}
+	else {
+		array_deallocate(entries);
+		array_deallocate(strings);
+	}
+}
+
+static bool
+_config_entry_equal(const config_cache_entry_t* entry, const char* strings,
+                    const config_cache_entry_t* other, const char* other_strings) {
+	if (entry->type != other->type)
+		return false;
+	if (entry->type == CONFIGVALUE_REAL)
+		return entry->value.rval == other->value.rval;
+	if (entry->type != CONFIGVALUE_STRING)
+		return entry->value.ival == other->value.ival;
+	return string_equal(strings + entry->string_offset, entry->string_length,
+	                    other_strings + other->string_offset, other->string_length);
+}
+
+//Reparse a monitored file, apply the declarations that differ from the previous parse and post
+//a change event listing them
+static void
+_config_reload_file(config_file_t* file) {
+	config_cache_entry_t* entries = 0;
+	char* strings = 0;
+	config_change_t* changes = 0;
+	config_cache_entry_t* changed = 0;
+	size_t ientry, iprev, count, prevcount;
+	stream_t* stream = stream_open(STRING_ARGS(file->path), STREAM_IN);
+	if (!stream)
+		return;
+	_config_parse_entries(stream, file->filter_section, &entries, &strings);
+	stream_deallocate(stream);
+
+	prevcount = array_size(file->entries);
+	for (ientry = 0, count = array_size(entries); ientry < count; ++ientry) {
+		const config_cache_entry_t* entry = entries + ientry;
+		bool unchanged = false;
+		for (iprev = prevcount; iprev; --iprev) {
+			const config_cache_entry_t* prev = file->entries + (iprev - 1);
+			if ((prev->section == entry->section) && (prev->key == entry->key)) {
+				unchanged = _config_entry_equal(entry, strings, prev, file->strings);
+				break;
+			}
+		}
+		if (!unchanged) {
+			config_change_t change = {entry->section, entry->key};
+			array_push_memcpy(changed, entry);
+			array_push_memcpy(changes, &change);
+		}
+	}
+
+	_config_apply_entries(changed, array_size(changed), strings, true);
+
+	array_deallocate(file->entries);
+	array_deallocate(file->strings);
+	file->entries = entries;
+	file->strings = strings;
+
+	if (changes) {
+		count = array_size(changes);
+		event_post_varg(_config_event_stream, FOUNDATIONEVENT_CONFIG_CHANGED, 0, 0,
+		                &count, sizeof(count), changes, sizeof(config_change_t) * count, nullptr);
+	}
+
+	array_deallocate(changed);
+	array_deallocate(changes);
+}
+
+bool
+config_process_event(const event_t* event) {
+	const fs_event_payload_t* payload;
+	size_t ifile, fsize;
+	bool processed = false;
+	if ((event->id != FOUNDATIONEVENT_FILE_MODIFIED) && (event->id != FOUNDATIONEVENT_FILE_CREATED))
+		return false;
+
+	payload = (const fs_event_payload_t*)event->payload;
+	lock_lock(&_config_file_lock);
+	for (ifile = 0, fsize = array_size(_config_files); ifile < fsize; ++ifile) {
+		if (string_equal(STRING_ARGS(_config_files[ifile].path), payload->str, payload->length)) {
+			_config_reload_file(_config_files + ifile);
+			processed = true;
+		}
+	}
+	lock_unlock(&_config_file_lock);
+	return processed;
+}
+
+event_stream_t*
+config_event_stream(void) {
+	return _config_event_stream;
+}
 
 void
 config_parse_commandline(const string_const_t* cmdline, size_t num) {
@@ -863,8 +1678,8 @@ config_parse_commandline(const string_const_t* cmdline, size_t num) {
 
 void
 config_write(stream_t* stream, hash_t filter_section, string_const_t (*map)(hash_t)) {
-	config_section_t* csection;
-	config_key_t* bucket;
+	const config_section_t* csection;
+	const config_key_t* bucket;
 	size_t key, ib, bsize;
 
 	stream_set_binary(stream, false);
@@ -876,7 +1691,8 @@ config_write(stream_t* stream, hash_t filter_section, string_const_t (*map)(hash
 		stream_write_format(stream, STRING_CONST("[%.*s]"), STRING_FORMAT(section));
 		stream_write_endl(stream);
 
-		csection = config_section(filter_section, false);
+		config_read_begin();
+		csection = config_section(filter_section);
 		if (csection) for (key = 0; key < CONFIG_KEY_BUCKETS; ++key) {
 				bucket = csection->key[ key ];
 				if (bucket) for (ib = 0, bsize = array_size(bucket); ib < bsize; ++ib) {
@@ -909,5 +1725,6 @@ config_write(stream_t* stream, hash_t filter_section, string_const_t (*map)(hash
 						stream_write_endl(stream);
 					}
 			}
+		config_read_end();
 	}
 }
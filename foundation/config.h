@@ -23,9 +23,8 @@ Values are transparently translated to the different supported types (boolean, i
 and string), so setting an integer value of 123 would yield a true boolean value, 123 integer
 value, 123.0 real value and "123" string value.
 
-String values are lazily evaluated and not allocated until queried. Setting an integer value
-123 would not allocate memory to hold the string value "123" until the string value is actually
-queried with a call to <code>config_string</code> or <code>config_string_hash</code>
+String representations of integer and real values are formatted when the value is set, so
+queries never modify the repository.
 
 Values can also be set to variables using string of format "$(section:key)" or "$(key)". If no
 section is given, the currently evaluating section is used. In this mode all evaluation is lazy
@@ -56,8 +55,13 @@ meg = 4M
 \# comment
 </pre>
 
-Config repository is not inherently thread safe, synchronization must be done by caller
-in a multithreaded use case */
+The repository is an immutable snapshot published with an atomic pointer swap. Queries are
+lock free and can run concurrently with any number of other queries and updates. Updates are
+serialized, copy the parts of the snapshot they modify and publish a new snapshot. Replaced
+snapshot storage and values are deallocated by later updates once no concurrent query can
+still access them. A string returned by #config_string is valid until the value is replaced,
+or until the end of the read section (#config_read_begin and #config_read_end) it was queried
+in. Variable values are expanded with the update lock held when queried. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -98,6 +102,58 @@ config_hash(hash_t section, hash_t key);
 FOUNDATION_API string_const_t
 config_string(hash_t section, hash_t key);
 
+/*! Get handle to a config value for repeated lookups without hashing into the repository.
+The same handle is returned for all calls with the same section and key, and it remains valid
+until the library is finalized. The key does not need to be set when the handle is created.
+\param section  Section
+\param key      Key
+\return         Handle to config value */
+FOUNDATION_API config_key_handle_t*
+config_key_handle(hash_t section, hash_t key);
+
+/*! Get version of a config value, incremented every time the value is set. Callers can
+cache values derived from the config value and only recompute them when the version changes.
+Values of variables are expanded when queried and changes of the referenced values are not
+reflected in the version.
+\param handle   Config value handle
+\return         Version */
+FOUNDATION_API uint32_t
+config_handle_version(config_key_handle_t* handle);
+
+/*! Get config value as boolean through a handle
+\param handle   Config value handle
+\return         Boolean value, false if not set */
+FOUNDATION_API bool
+config_handle_bool(config_key_handle_t* handle);
+
+/*! Get config value as integer through a handle
+\param handle   Config value handle
+\return         Integer value, 0 if not set */
+FOUNDATION_API int64_t
+config_handle_int(config_key_handle_t* handle);
+
+/*! Get config value as real through a handle
+\param handle   Config value handle
+\return         Real value, 0 if not set */
+FOUNDATION_API real
+config_handle_real(config_key_handle_t* handle);
+
+/*! Get config value as string through a handle
+\param handle   Config value handle
+\return         String value, empty string if not set */
+FOUNDATION_API string_const_t
+config_handle_string(config_key_handle_t* handle);
+
+/*! Begin a read section for the calling thread. Strings returned by #config_string and
+#config_handle_string inside a read section stay valid until the matching #config_read_end,
+even if the value is replaced by a concurrent update. Read sections can be nested. */
+FOUNDATION_API void
+config_read_begin(void);
+
+/*! End a read section started by #config_read_begin */
+FOUNDATION_API void
+config_read_end(void);
+
 /*! Set boolean config value. Will auto-translate to integer value 0/1, real value 0/1 and
 string value "false"/"true"
 \param section  Section
@@ -203,6 +259,37 @@ For MacOSX development, the user app directory
 FOUNDATION_API void
 config_load(const char* name, size_t length, hash_t section, bool built_in, bool overwrite);
 
+/*! Load config values from a file, optionally filtering by section. If config caching is
+enabled with foundation_config_t::config_cache the parsed values are stored in a binary cache
+file in the user config directory, and later loads of the unchanged file apply the cached
+values directly without parsing. Variable values are stored unexpanded and expanded when
+queried as usual.
+\param path      Path of config file
+\param length    Length of path
+\param section   Section to load, 0 for all sections
+\param overwrite If false, only set new values. If true, allow setting values to
+                 existing section:key pairs */
+FOUNDATION_API void
+config_load_file(const char* path, size_t length, hash_t section, bool overwrite);
+
+/*! Process a file system event from #fs_event_stream. If config monitoring is enabled with
+foundation_config_t::config_monitor, files loaded with #config_load_file have their
+directories monitored with #fs_monitor, and an event for a loaded file reparses that file.
+Values that differ from the previous parse of the file are set (overwriting existing values)
+and a #FOUNDATIONEVENT_CONFIG_CHANGED event listing the changed section and key pairs is
+posted to #config_event_stream. Values removed from the file are left unchanged. Readers are
+never blocked by a reload.
+\param event File system event
+\return true if the event was for a monitored config file, false if not */
+FOUNDATION_API bool
+config_process_event(const event_t* event);
+
+/*! Get the config event stream receiving #FOUNDATIONEVENT_CONFIG_CHANGED events, see
+#config_process_event
+\return Config event stream */
+FOUNDATION_API event_stream_t*
+config_event_stream(void);
+
 /*! Parse config declarations from a stream, optionally filtering on a specific section
 \param stream    Stream to read from (will read until EOS encountered)
 \param section   Optional filter, which will only load the section matching the
@@ -11,6 +11,7 @@
  */
 
 #include <foundation/foundation.h>
+#include <foundation/internal.h>
 
 static crash_dump_callback_fn  _crash_dump_callback;
 static string_const_t          _crash_dump_name;
@@ -141,7 +142,8 @@ _crash_exception_filter(LPEXCEPTION_POINTERS pointers) {
 #if FOUNDATION_PLATFORM_POSIX //&& !FOUNDATION_PLATFORM_APPLE
 
 #include <foundation/posix.h>
-//#include <ucontext.h>
+#include <ucontext.h>
+#include <dlfcn.h>
 
 FOUNDATION_DECLARE_THREAD_LOCAL(crash_dump_callback_fn, crash_callback, 0)
 FOUNDATION_DECLARE_THREAD_LOCAL(const char*, crash_callback_name, 0)
@@ -157,10 +159,125 @@ FOUNDATION_DECLARE_THREAD_LOCAL(const char*, crash_callback_name, 0)
 #endif
 FOUNDATION_DECLARE_THREAD_LOCAL(crash_env_t, crash_env, 0)
 
+//Limits of the crash dump records, all buffers are preallocated as the dump is written from
+//the signal handler
+#define CRASH_DUMP_MAX_DEPTH      64
+#define CRASH_DUMP_MAX_STACK      (64U * 1024U)
+#define CRASH_DUMP_MAX_MODULES    256
+#define CRASH_DUMP_MAX_LOG        (16U * 1024U)
+#define CRASH_DUMP_MAX_RECORDER   (64U * 1024U)
+#define CRASH_DUMP_VERSION        1
+
+static char            _crash_dump_log[CRASH_DUMP_MAX_LOG];
+static char            _crash_dump_recorder[CRASH_DUMP_MAX_RECORDER];
+static string_const_t  _crash_dump_module_name[CRASH_DUMP_MAX_MODULES];
+static uintptr_t       _crash_dump_module_base[CRASH_DUMP_MAX_MODULES];
+static uintptr_t       _crash_dump_executable_base;
+
+static bool
+_crash_dump_write(int fd, const void* data, size_t size) {
+	const char* ptr = data;
+	while (size) {
+		ssize_t written = write(fd, ptr, size);
+		if (written <= 0) {
+			if ((written < 0) && (errno == EINTR))
+				continue;
+			return false;
+		}
+		ptr += written;
+		size -= (size_t)written;
+	}
+	return true;
+}
+
+static void
+_crash_dump_record(int fd, crash_dump_record_t type, const void* data, size_t size) {
+	uint32_t header[2] = {(uint32_t)type, (uint32_t)size};
+	_crash_dump_write(fd, header, sizeof(header));
+	_crash_dump_write(fd, data, size);
+}
+
+static uintptr_t
+_crash_dump_stack_pointer(const ucontext_t* uc) {
+#if FOUNDATION_PLATFORM_APPLE && FOUNDATION_ARCH_X86_64
+	return (uintptr_t)uc->uc_mcontext->__ss.__rsp;
+#elif FOUNDATION_PLATFORM_APPLE && FOUNDATION_ARCH_ARM8_64
+	return (uintptr_t)uc->uc_mcontext->__ss.__sp;
+#elif FOUNDATION_PLATFORM_LINUX && FOUNDATION_ARCH_X86_64
+	return (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+#elif FOUNDATION_PLATFORM_LINUX && FOUNDATION_ARCH_X86
+	return (uintptr_t)uc->uc_mcontext.gregs[REG_ESP];
+#elif FOUNDATION_PLATFORM_LINUX && FOUNDATION_ARCH_ARM8_64
+	return (uintptr_t)uc->uc_mcontext.sp;
+#elif FOUNDATION_PLATFORM_BSD && FOUNDATION_ARCH_X86_64
+	return (uintptr_t)uc->uc_mcontext.mc_rsp;
+#else
+	FOUNDATION_UNUSED(uc);
+	return 0;
+#endif
+}
+
+//Stack memory is written directly from the stack to the file, the kernel fails the write
+//instead of faulting when reaching unmapped memory
+static void
+_crash_dump_stack(int fd, uintptr_t sp) {
+	uint32_t header[2] = {CRASH_DUMP_STACK, 0};
+	uint64_t address = sp;
+	off_t start = lseek(fd, 0, SEEK_CUR);
+	size_t size = 0;
+	if (!sp || (start < 0))
+		return;
+	_crash_dump_write(fd, header, sizeof(header));
+	_crash_dump_write(fd, &address, sizeof(address));
+	while (size < CRASH_DUMP_MAX_STACK) {
+		size_t chunk = 4096 - ((sp + size) & 4095);
+		if (size + chunk > CRASH_DUMP_MAX_STACK)
+			chunk = CRASH_DUMP_MAX_STACK - size;
+		if (!_crash_dump_write(fd, (const void*)(sp + size), chunk))
+			break;
+		size += chunk;
+	}
+	header[1] = (uint32_t)(sizeof(address) + size);
+	if (pwrite(fd, header, sizeof(header), start) == (ssize_t)sizeof(header))
+		lseek(fd, start + (off_t)sizeof(header) + (off_t)header[1], SEEK_SET);
+}
+
+static void
+_crash_dump_modules(int fd) {
+	uint32_t header[2] = {CRASH_DUMP_MODULES, 0};
+	size_t imod, num_modules;
+	string_const_t exe = environment_executable_path();
+
+	_crash_dump_module_name[0] = exe;
+	_crash_dump_module_base[0] = _crash_dump_executable_base;
+	num_modules = 1 + _library_modules(_crash_dump_module_name + 1, _crash_dump_module_base + 1,
+	                                   CRASH_DUMP_MAX_MODULES - 1);
+	for (imod = 0; imod < num_modules; ++imod)
+		header[1] += (uint32_t)(sizeof(uint64_t) + sizeof(uint32_t) +
+		                        _crash_dump_module_name[imod].length);
+	_crash_dump_write(fd, header, sizeof(header));
+	for (imod = 0; imod < num_modules; ++imod) {
+		uint64_t base = _crash_dump_module_base[imod];
+		uint32_t length = (uint32_t)_crash_dump_module_name[imod].length;
+		_crash_dump_write(fd, &base, sizeof(base));
+		_crash_dump_write(fd, &length, sizeof(length));
+		_crash_dump_write(fd, _crash_dump_module_name[imod].str, length);
+	}
+}
+
 static string_t
-_crash_guard_minidump(void* context, string_const_t name, string_t dump_file) {
+_crash_guard_minidump(int sig, siginfo_t* info, void* context, string_const_t name,
+                      string_t dump_file) {
 	string_const_t tmp_dir;
 	string_const_t uuid_str;
+	crash_dump_header_t header;
+	void* frames[CRASH_DUMP_MAX_DEPTH];
+	uint64_t frames64[CRASH_DUMP_MAX_DEPTH];
+	size_t iframe, num_frames;
+	const ucontext_t* user_context = context;
+	string_t log;
+	int fd;
+
 	if (!name.length)
 		name = environment_application()->short_name;
 	tmp_dir = environment_temporary_directory();
@@ -169,11 +286,54 @@ _crash_guard_minidump(void* context, string_const_t name, string_t dump_file) {
 	                          STRING_CONST("%.*s/%.*s%s%.*s-%" PRIx64 ".dmp"),
 	                          STRING_FORMAT(tmp_dir), STRING_FORMAT(name), name.length ? "-" : "",
 	                          STRING_FORMAT(uuid_str), time_system());
-	fs_make_directory(tmp_dir.str, tmp_dir.length);
 
-	//TODO: Write dump file
-	//ucontext_t* user_context = context;
-	FOUNDATION_UNUSED(context);
+	fd = open(dump_file.str, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0)
+		return (string_t) {dump_file.str, 0};
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "FDMP", 4);
+	header.version = CRASH_DUMP_VERSION;
+	header.signal = sig;
+	header.code = info ? info->si_code : 0;
+	header.address = info ? (uint64_t)(uintptr_t)info->si_addr : 0;
+	header.pid = (uint64_t)getpid();
+	header.thread = thread_id();
+	header.time = time_system();
+	_crash_dump_write(fd, &header, sizeof(header));
+
+	if (user_context) {
+#if FOUNDATION_PLATFORM_APPLE
+		_crash_dump_record(fd, CRASH_DUMP_CONTEXT, user_context->uc_mcontext,
+		                   user_context->uc_mcsize);
+#else
+		_crash_dump_record(fd, CRASH_DUMP_CONTEXT, &user_context->uc_mcontext,
+		                   sizeof(user_context->uc_mcontext));
+#endif
+	}
+
+	num_frames = stacktrace_capture_context(frames, CRASH_DUMP_MAX_DEPTH, context);
+	if (!num_frames)
+		num_frames = stacktrace_capture_fast(frames, CRASH_DUMP_MAX_DEPTH, 0);
+	for (iframe = 0; iframe < num_frames; ++iframe)
+		frames64[iframe] = (uint64_t)(uintptr_t)frames[iframe];
+	_crash_dump_record(fd, CRASH_DUMP_STACKTRACE, frames64, sizeof(uint64_t) * num_frames);
+
+	if (user_context)
+		_crash_dump_stack(fd, _crash_dump_stack_pointer(user_context));
+
+	_crash_dump_modules(fd);
+
+	log = log_history(_crash_dump_log, sizeof(_crash_dump_log));
+	_crash_dump_record(fd, CRASH_DUMP_LOG, log.str, log.length);
+
+	if (log_recorder_size()) {
+		log = log_recorder_history(_crash_dump_recorder, sizeof(_crash_dump_recorder));
+		_crash_dump_record(fd, CRASH_DUMP_RECORDER, log.str, log.length);
+	}
+
+	fsync(fd);
+	close(fd);
 
 	return dump_file;
 }
@@ -191,7 +351,8 @@ _crash_guard_sigaction(int sig, siginfo_t* info, void* arg) {
 		char file_name_buffer[ BUILD_MAX_PATHLEN ];
 		const char* name = get_thread_crash_callback_name();
 		string_t dump_file = (string_t) {file_name_buffer, sizeof(file_name_buffer)};
-		dump_file = _crash_guard_minidump(arg, (string_const_t) {name, string_length(name)}, dump_file);
+		dump_file = _crash_guard_minidump(sig, info, arg, (string_const_t) {name, string_length(name)},
+		                                  dump_file);
 		callback(dump_file.str, dump_file.length);
 	}
 
@@ -215,8 +376,18 @@ crash_guard(crash_guard_fn fn, void* data, crash_dump_callback_fn callback, cons
 	char buffer[MAX_PATH];
 #endif
 
-	//Make sure path is initialized
+	//Make sure path is initialized, the dump is written without creating directories
 	environment_temporary_directory();
+#if FOUNDATION_PLATFORM_POSIX
+	{
+		string_const_t tmp_dir = environment_temporary_directory();
+		Dl_info dl_info;
+		fs_make_directory(STRING_ARGS(tmp_dir));
+		environment_executable_path();
+		if (dladdr((void*)(uintptr_t)crash_guard, &dl_info))
+			_crash_dump_executable_base = (uintptr_t)dl_info.dli_fbase;
+	}
+#endif
 
 #if FOUNDATION_PLATFORM_WINDOWS
 
@@ -15,7 +15,14 @@
 /*! \file crash.h
 \brief Crash guards and dump utilities
 
-Crash guards and dump utilities. */
+Crash guards and dump utilities.
+
+On Windows the dump is a minidump written by dbghelp. On POSIX platforms the crash guard writes
+a compact dump from the signal handler using only preallocated memory, starting with a
+#crash_dump_header_t followed by records (see #crash_dump_record_t) holding the machine context,
+stack trace and up to 64KiB of stack memory of the crashing thread, the executable and libraries
+loaded with #library_load, the most recent log output from #log_history and, if enabled, the
+messages recorded by the log flight recorder from #log_recorder_history. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -22,8 +22,17 @@ static string_t _environment_home_dir;
 static string_t _environment_temp_dir;
 static bool _environment_temp_dir_local;
 
+//Queried environment variables, including misses, kept until invalidated
+typedef struct {
+	hash_t    key;
+	string_t  name;
+	string_t  value;
+} environment_var_t;
+
+static environment_var_t* _environment_vars;
+static mutex_t* _environment_lock;
+
 #if FOUNDATION_PLATFORM_WINDOWS
-static string_t _environment_var;
 #  include <foundation/windows.h>
 #elif FOUNDATION_PLATFORM_POSIX
 #  include <foundation/posix.h>
@@ -269,6 +278,7 @@ _environment_initialize(const application_t application) {
 #endif
 
 	_environment_app = application;
+	_environment_lock = mutex_allocate(STRING_CONST("environment"));
 
 	if (uuid_is_null(_environment_app.instance))
 		_environment_app.instance = uuid_generate_random();
@@ -287,9 +297,12 @@ _environment_finalize(void) {
 
 	string_array_deallocate(_environment_argv);
 
-#if FOUNDATION_PLATFORM_WINDOWS
-	string_deallocate(_environment_var.str);
-#endif
+	environment_variables_invalidate();
+	array_deallocate(_environment_vars);
+	mutex_deallocate(_environment_lock);
+	_environment_vars = 0;
+	_environment_lock = 0;
+
 	string_deallocate(_environment_executable_name.str);
 	string_deallocate(_environment_executable_dir.str);
 	string_deallocate(_environment_executable_path.str);
@@ -332,10 +345,8 @@ environment_initial_working_directory(void) {
 	return string_to_const(_environment_initial_working_dir);
 }
 
-string_const_t
-environment_current_working_directory(void) {
-	if (_environment_current_working_dir.str)
-		return string_to_const(_environment_current_working_dir);
+static string_t
+_environment_query_working_directory(void) {
 #if FOUNDATION_PLATFORM_WINDOWS
 	{
 		string_t localpath;
@@ -349,7 +360,7 @@ environment_current_working_directory(void) {
 		localpath = string_allocate_from_wstring(wd, ret);
 		if (wd != wdbuffer)
 			memory_deallocate(wd);
-		_environment_current_working_dir = path_clean(STRING_ARGS_CAPACITY(localpath));
+		return path_clean(STRING_ARGS_CAPACITY(localpath));
 	}
 #elif FOUNDATION_PLATFORM_POSIX
 	string_t localpath = string_thread_buffer();
@@ -358,18 +369,42 @@ environment_current_working_directory(void) {
 		string_const_t errmsg = system_error_message(err);
 		log_errorf(0, ERROR_SYSTEM_CALL_FAIL, STRING_CONST("Unable to get cwd: %.*s (%d)"),
 		           STRING_FORMAT(errmsg), err);
-		return string_const(0, 0);
+		return (string_t) {0, 0};
 	}
 	localpath = path_clean(localpath.str, string_length(localpath.str), localpath.length);
 	if ((localpath.length > 1) && (localpath.str[localpath.length - 1] == '/'))
 		localpath.str[--localpath.length] = 0;
-	_environment_current_working_dir = string_clone(STRING_ARGS(localpath));
+	return string_clone(STRING_ARGS(localpath));
 #elif FOUNDATION_PLATFORM_PNACL
-	_environment_current_working_dir = string_clone(STRING_CONST("/tmp"));
+	return string_clone(STRING_CONST("/tmp"));
 #else
 #  error Not implemented
 #endif
-	return string_to_const(_environment_current_working_dir);
+}
+
+string_const_t
+environment_current_working_directory(void) {
+	string_const_t working_dir;
+	if (_environment_current_working_dir.str)
+		return string_to_const(_environment_current_working_dir);
+	if (_environment_lock)
+		mutex_lock(_environment_lock);
+	if (!_environment_current_working_dir.str)
+		_environment_current_working_dir = _environment_query_working_directory();
+	working_dir = string_to_const(_environment_current_working_dir);
+	if (_environment_lock)
+		mutex_unlock(_environment_lock);
+	return working_dir;
+}
+
+static void
+_environment_invalidate_working_directory(void) {
+	if (_environment_lock)
+		mutex_lock(_environment_lock);
+	string_deallocate(_environment_current_working_dir.str);
+	_environment_current_working_dir = (string_t) { 0, 0 };
+	if (_environment_lock)
+		mutex_unlock(_environment_lock);
 }
 
 bool
@@ -388,8 +423,7 @@ environment_set_current_working_directory(const char* path, size_t length) {
 		}
 		wstring_deallocate(wpath);
 	}
-	string_deallocate(_environment_current_working_dir.str);
-	_environment_current_working_dir = (string_t) { 0, 0 };
+	_environment_invalidate_working_directory();
 #elif FOUNDATION_PLATFORM_POSIX
 	buffer = string_thread_buffer();
 	pathstr = string_copy(STRING_ARGS(buffer), path, length);
@@ -401,8 +435,7 @@ environment_set_current_working_directory(const char* path, size_t length) {
 		          (int)length, path, STRING_FORMAT(errmsg), err);
 		result = false;
 	}
-	string_deallocate(_environment_current_working_dir.str);
-	_environment_current_working_dir = (string_t) { 0, 0 };
+	_environment_invalidate_working_directory();
 #elif FOUNDATION_PLATFORM_PNACL
 	//Allow nothing, always set to /tmp
 	result = false;
@@ -550,13 +583,14 @@ _environment_clean_temporary_directory(bool recreate) {
 	}
 }
 
-string_const_t
-environment_variable(const char* var, size_t length) {
+static string_t
+_environment_variable_query(const char* var, size_t length) {
 #if !FOUNDATION_PLATFORM_PNACL
 	string_t buffer = string_thread_buffer();
 	string_t varstr = string_copy(STRING_ARGS(buffer), var, length);
 #endif
 #if FOUNDATION_PLATFORM_WINDOWS
+	string_t value;
 	unsigned int required;
 	wchar_t* key = wstring_allocate_from_string(STRING_ARGS(varstr));
 	wchar_t val[BUILD_MAX_PATHLEN]; val[0] = 0;
@@ -564,30 +598,71 @@ environment_variable(const char* var, size_t length) {
 		wchar_t* val_local = memory_allocate(0, sizeof(wchar_t) * ((size_t)required + 2), 0, MEMORY_TEMPORARY);
 		val_local[0] = 0;
 		required = GetEnvironmentVariableW(key, val_local, required + 1);
-		if (_environment_var.str)
-			string_deallocate(_environment_var.str);
-		_environment_var = string_allocate_from_wstring(val_local, required);
+		value = required ? string_allocate_from_wstring(val_local, required) : (string_t) {0, 0};
 		memory_deallocate(val_local);
 	}
 	else {
-		if (_environment_var.str)
-			string_deallocate(_environment_var.str);
-		_environment_var = string_allocate_from_wstring(val, required);
+		value = required ? string_allocate_from_wstring(val, required) : (string_t) {0, 0};
 	}
 	wstring_deallocate(key);
-	return string_to_const(_environment_var);
+	return value;
 #elif FOUNDATION_PLATFORM_POSIX
 	const char* value = getenv(varstr.str);
-	return string_const(value, value ? string_length(value) : 0);
+	return value ? string_clone(value, string_length(value)) : (string_t) {0, 0};
 #elif FOUNDATION_PLATFORM_PNACL
 	FOUNDATION_UNUSED(var);
 	FOUNDATION_UNUSED(length);
-	return string_const(0, 0);   //No env vars on PNaCl
+	return (string_t) {0, 0};   //No env vars on PNaCl
 #else
 #  error Not implemented
 #endif
 }
 
+string_const_t
+environment_variable(const char* var, size_t length) {
+	environment_var_t entry;
+	string_const_t value;
+	size_t ivar, vsize;
+	hash_t key = hash(var, length);
+
+	//Lock is not yet allocated during single threaded foundation initialization
+	if (_environment_lock)
+		mutex_lock(_environment_lock);
+	for (ivar = 0, vsize = array_size(_environment_vars); ivar < vsize; ++ivar) {
+		if ((_environment_vars[ivar].key == key) &&
+		        string_equal(STRING_ARGS(_environment_vars[ivar].name), var, length)) {
+			value = string_to_const(_environment_vars[ivar].value);
+			if (_environment_lock)
+				mutex_unlock(_environment_lock);
+			return value;
+		}
+	}
+
+	entry.key = key;
+	entry.name = string_clone(var, length);
+	entry.value = _environment_variable_query(var, length);
+	array_push(_environment_vars, entry);
+	value = string_to_const(entry.value);
+	if (_environment_lock)
+		mutex_unlock(_environment_lock);
+
+	return value;
+}
+
+void
+environment_variables_invalidate(void) {
+	size_t ivar, vsize;
+	if (_environment_lock)
+		mutex_lock(_environment_lock);
+	for (ivar = 0, vsize = array_size(_environment_vars); ivar < vsize; ++ivar) {
+		string_deallocate(_environment_vars[ivar].name.str);
+		string_deallocate(_environment_vars[ivar].value.str);
+	}
+	array_clear(_environment_vars);
+	if (_environment_lock)
+		mutex_unlock(_environment_lock);
+}
+
 const application_t*
 environment_application(void) {
 	return &_environment_app;
@@ -76,12 +76,19 @@ FOUNDATION_API string_const_t
 environment_temporary_directory(void);
 
 /*! Get environment variable. Returned string must not be modified or deallocated.
+Values are queried from the operating system on first use and then cached, returned strings
+remain valid until #environment_variables_invalidate is called.
 \param var    Variable name
 \param length Length of variable name
 \return       Variable value */
 FOUNDATION_API string_const_t
 environment_variable(const char* var, size_t length);
 
+/*! Discard cached environment variable values, for example after the process environment
+has been modified. Strings previously returned by #environment_variable are invalidated. */
+FOUNDATION_API void
+environment_variables_invalidate(void);
+
 /*! Get the application declaration as set by the application implementation.
 \return Application declaration */
 FOUNDATION_API const application_t*
@@ -47,16 +47,21 @@ error_set_callback(error_callback_fn callback) {
 
 #if BUILD_ENABLE_ERROR_CONTEXT
 
-FOUNDATION_DECLARE_THREAD_LOCAL(error_context_t*, error_context, 0)
+FOUNDATION_DECLARE_THREAD_CONTEXT(error_context_t*, error_context)
+
+static FOUNDATION_NOINLINE error_context_t*
+_error_context_allocate(void) {
+	size_t capacity = sizeof(error_context_t) + (sizeof(error_frame_t) * _foundation_config.error_context_depth);
+	error_context_t* context = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	set_thread_error_context(context);
+	return context;
+}
 
 void
 _error_context_push(const char* name, size_t name_length, const char* data, size_t data_length) {
 	error_context_t* context = get_thread_error_context();
-	if (!context) {
-		size_t capacity = sizeof(error_context_t) + (sizeof(error_frame_t) * _foundation_config.error_context_depth);
-		context = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
-		set_thread_error_context(context);
-	}
+	if (!context)
+		context = _error_context_allocate();
 	context->frame[ context->depth ].name.str = name ? name : "<something>";
 	context->frame[ context->depth ].name.length = name ? name_length : 11;
 	context->frame[ context->depth ].data.str = data ? data : "<nothing>";
@@ -65,6 +70,16 @@ _error_context_push(const char* name, size_t name_length, const char* data, size
 		++context->depth;
 }
 
+void
+_error_context_push_frame(const error_frame_t* frame) {
+	error_context_t* context = get_thread_error_context();
+	if (!context)
+		context = _error_context_allocate();
+	context->frame[ context->depth ] = *frame;
+	if (context->depth < _foundation_config.error_context_depth - 1)
+		++context->depth;
+}
+
 void
 _error_context_pop(void) {
 	error_context_t* context = get_thread_error_context();
@@ -67,6 +67,18 @@ Both context and data must be valid for as long as it remains on the stack.
   _error_context_push_proxy(__VA_ARGS__); \
   } while(0)
 
+/*! Push a new error context with constant string literal name and data on the error context
+stack. The frame is stored in static data at the call site and pushing it is a single frame
+copy with no string handling, suitable for hot code paths. The context is only formatted if
+an error is actually logged.
+\param name Context name string literal
+\param data Context data string literal */
+#define error_context_push_static(name, data) do { \
+  static const error_frame_t _error_context_static_frame = { \
+    { name, sizeof(name) - 1 }, { data, sizeof(data) - 1 } }; \
+  _error_context_push_frame(&_error_context_static_frame); \
+  } while(0)
+
 /*! Pop the top error context off the error context stack */
 #define error_context_pop() do { \
   _error_context_pop(); \
@@ -103,6 +115,9 @@ evaluate any code.
 FOUNDATION_API void
 _error_context_push(const char* name, size_t name_length, const char* data, size_t data_length);
 
+FOUNDATION_API void
+_error_context_push_frame(const error_frame_t* frame);
+
 FOUNDATION_API void
 _error_context_pop(void);
 
@@ -121,6 +136,7 @@ _error_context_thread_finalize(void);
 #else
 
 #define error_context_push(...) do { /* */ } while(0)
+#define error_context_push_static(name, data) do { /* */ } while(0)
 #define error_context_pop() do { /* */ } while(0)
 #define error_context_clear()  do { /* */ } while(0)
 #define error_context_buffer(str, length) string_copy(str, length, 0, 0)
@@ -16,56 +16,63 @@
 #define EVENT_BLOCK_POSTING  -1
 #define EVENT_BLOCK_SWAPPING -2
 
-static atomic32_t _event_serial = {1};
-
-static void
-_event_post_delay_with_flags(event_stream_t* stream, int id, object_t object,
-                             tick_t timestamp, uint16_t flags, const void* payload, size_t size, va_list list) {
-	event_block_t* block;
-	event_t* event;
-	bool restored_block;
-	size_t basesize;
-	size_t allocsize;
-	int32_t last_write;
-	char* part;
-	void* ptr;
-	size_t psize;
-	va_list clist;
-
-	//Events must have non-zero id
-	FOUNDATION_ASSERT_MSG(id, "Events must have non-zero id");
-	FOUNDATION_ASSERT_MSGFORMAT(size < 0xFFFF - 16, "Events size must be less than %d", 0xFFFF - 16);
-	if (!id)
-		return;
-
-	//Events must be aligned to an even 8 bytes
-	basesize = sizeof(event_t) + size;
-	va_copy(clist, list);
-	while ((ptr = va_arg(clist, void*))) {
-		psize = va_arg(clist, size_t);
-		basesize += psize;
+/*! Staging block for posting events, double buffered for concurrent post and merge. Only
+contended if several threads share the same staging block or during stream processing */
+typedef FOUNDATION_ALIGNED_STRUCT(event_stage_t, 64) {
+	atomic32_t write;
+	int32_t read;
+	int32_t reserved;
+	event_block_t block[2];
+	event_statistics_t statistics;
+} event_stage_t;
+
+#if BUILD_ENABLE_EVENT_STATISTICS
+#  define EVENT_STATISTICS_ADD(counter, value) ((counter) += (value))
+#else
+#  define EVENT_STATISTICS_ADD(counter, value) do {} while (0)
+#endif
+
+//Largest event id span covered by the dense route table, subscriptions spanning a wider id
+//range fall back to scanning the route ranges for each event
+#define EVENT_ROUTE_TABLE_MAX 4096
+
+static atomic32_t _event_serial = {0};
+static atomic32_t _event_slot;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(uint32_t, event_slot, 0)
+
+static event_stage_t*
+_event_stream_stage(event_stream_t* stream) {
+	event_stage_t* stage;
+	event_stage_t* prev_stage;
+	uint32_t slot = get_thread_event_slot();
+	if (!slot) {
+		slot = (uint32_t)atomic_add32_explicit(&_event_slot, 1, MEMORY_ORDER_RELAXED);
+		set_thread_event_slot(slot);
 	}
-	va_end(clist);
-
-	if (basesize % 8)
-		basesize += 8 - (basesize % 8);
-	basesize &= 0xFFF8;
-
-	//Delayed events have extra 8 bytes payload to hold timestamp
-	allocsize = basesize;
-	if (timestamp)
-		allocsize += 8;
-
-	//Lock the event block by atomic swapping the write block index
-	last_write = atomic_load32(&stream->write);
-	while ((last_write < 0) || !atomic_cas32(&stream->write, EVENT_BLOCK_POSTING, last_write)) {
-		thread_yield();
-		last_write = atomic_load32(&stream->write);
-	}
-
-	//We now have exclusive access to the event block
-	block = stream->block + last_write;
+	slot = (slot - 1) % EVENT_STREAM_STAGES;
+
+	stage = atomic_loadptr(&stream->stage[slot]);
+	if (stage)
+		return stage;
+
+	stage = memory_allocate(0, sizeof(event_stage_t), 64, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stage->read = 1;
+	stage->block[0].stream = stream;
+	stage->block[1].stream = stream;
+	if (atomic_cas_ptr(&stream->stage[slot], stage, 0))
+		return stage;
+
+	//Another thread sharing the slot installed a stage first
+	memory_deallocate(stage);
+	prev_stage = atomic_loadptr(&stream->stage[slot]);
+	return prev_stage;
+}
 
+static bool
+_event_block_reserve(event_block_t* block, event_statistics_t* statistics, size_t basesize,
+                     size_t allocsize) {
+	FOUNDATION_UNUSED(statistics);
 	if ((block->used + allocsize + 2) >= block->capacity) {
 		size_t prev_capacity = block->capacity + 16;
 		if (prev_capacity < _foundation_config.event_block_chunk) {
@@ -76,7 +83,8 @@ _event_post_delay_with_flags(event_stream_t* stream, int id, object_t object,
 				FOUNDATION_ASSERT_FAILFORMAT_LOG(0, "Event block size over limit of %" PRIsize " bytes",
 				                                 _foundation_config.event_block_limit);
 				error_report(ERRORLEVEL_ERROR, ERROR_OUT_OF_MEMORY);
-				goto unlock;
+				EVENT_STATISTICS_ADD(statistics->limit_hits, 1);
+				return false;
 			}
 			block->capacity += _foundation_config.event_block_chunk;
 			if (block->capacity > _foundation_config.event_block_limit)
@@ -88,16 +96,127 @@ _event_post_delay_with_flags(event_stream_t* stream, int id, object_t object,
 		block->events = block->events ? memory_reallocate(block->events, block->capacity + 16, 16,
 		                                                  prev_capacity) :
 		                memory_allocate(0, block->capacity + 16, 16, MEMORY_PERSISTENT);
+		EVENT_STATISTICS_ADD(statistics->reallocations, 1);
 	}
+	return true;
+}
+
+//Lock the staging block by atomic swapping the write block index, only contended
+//by threads sharing the staging block and by stream processing swapping blocks
+static event_stage_t*
+_event_stage_lock(event_stream_t* stream) {
+	event_stage_t* stage = _event_stream_stage(stream);
+	int32_t last_write = atomic_load32(&stage->write);
+	if ((last_write < 0) || !atomic_cas32(&stage->write, EVENT_BLOCK_POSTING, last_write)) {
+#if BUILD_ENABLE_EVENT_STATISTICS
+		tick_t start = time_current();
+#endif
+		do {
+			thread_yield();
+			last_write = atomic_load32(&stage->write);
+		}
+		while ((last_write < 0) || !atomic_cas32(&stage->write, EVENT_BLOCK_POSTING, last_write));
+		EVENT_STATISTICS_ADD(stage->statistics.spin_count, 1);
+		EVENT_STATISTICS_ADD(stage->statistics.spin_ticks, time_diff(start, time_current()));
+	}
+	stage->reserved = last_write;
+	return stage;
+}
+
+static void
+_event_stage_unlock(event_stream_t* stream, event_stage_t* stage, bool posted) {
+	bool restored_block = atomic_cas32(&stage->write, stage->reserved, EVENT_BLOCK_POSTING);
+	FOUNDATION_ASSERT(restored_block);
+	FOUNDATION_UNUSED(restored_block);
+
+	//Re-fire beacon
+	if (posted && stream->beacon && !atomic_load32(&stream->fired) &&
+	    atomic_cas32(&stream->fired, 1, 0))
+		beacon_fire(stream->beacon);
+}
+
+//Write event header in the locked staging block, payload is written by caller and the
+//event is included in the block by adding the event size to the block used size
+static event_t*
+_event_stage_write(event_stage_t* stage, int id, object_t object, tick_t timestamp,
+                   uint16_t flags, size_t size) {
+	event_block_t* block = stage->block + stage->reserved;
+	event_t* event;
+	size_t basesize;
+	size_t allocsize;
+
+	//Events must have non-zero id
+	FOUNDATION_ASSERT_MSG(id, "Events must have non-zero id");
+	FOUNDATION_ASSERT_MSGFORMAT(size < 0xFFFF - 16, "Events size must be less than %d", 0xFFFF - 16);
+	if (!id)
+		return 0;
+
+	//Events must be aligned to an even 8 bytes
+	basesize = sizeof(event_t) + size;
+	if (basesize % 8)
+		basesize += 8 - (basesize % 8);
+	basesize &= 0xFFF8;
+
+	//Delayed events have extra 8 bytes payload to hold timestamp
+	allocsize = basesize;
+	if (timestamp)
+		allocsize += 8;
+
+	if (!_event_block_reserve(block, &stage->statistics, basesize, allocsize)) {
+		EVENT_STATISTICS_ADD(stage->statistics.dropped, 1);
+		return 0;
+	}
+	EVENT_STATISTICS_ADD(stage->statistics.posted, 1);
 
 	event = pointer_offset(block->events, block->used);
 
 	event->id     = (uint16_t)id;
-	event->serial = (uint16_t)(atomic_exchange_and_add32(&_event_serial, 1) & 0xFFFF);
+	event->serial = (uint16_t)(atomic_add32_explicit(&_event_serial, 1, MEMORY_ORDER_RELAXED) &
+	                           0xFFFF);
 	event->size   = (uint16_t)allocsize;
 	event->flags  = flags;
 	event->object = object;
 
+	if (timestamp) {
+		event->flags |= EVENTFLAG_DELAY;
+		*(tick_t*)pointer_offset(event, basesize) = timestamp;
+	}
+
+	return event;
+}
+
+static void
+_event_stage_commit(event_stage_t* stage, const event_t* event) {
+	stage->block[stage->reserved].used += event->size;
+	EVENT_STATISTICS_ADD(stage->statistics.posted_bytes, event->size);
+}
+
+static void
+_event_post_delay_with_flags(event_stream_t* stream, int id, object_t object,
+                             tick_t timestamp, uint16_t flags, const void* payload, size_t size, va_list list) {
+	event_stage_t* stage;
+	event_t* event;
+	size_t totalsize;
+	char* part;
+	void* ptr;
+	size_t psize;
+	va_list clist;
+
+	totalsize = size;
+	va_copy(clist, list);
+	while ((ptr = va_arg(clist, void*))) {
+		psize = va_arg(clist, size_t);
+		totalsize += psize;
+	}
+	va_end(clist);
+
+	stage = _event_stage_lock(stream);
+	event = _event_stage_write(stage, id, object, timestamp, flags, totalsize);
+	if (!event) {
+		_event_stage_unlock(stream, stage, false);
+		return;
+	}
+
 	part = (void*)&event->payload[0];
 	if (size) {
 		memcpy(part, payload, size);
@@ -113,25 +232,72 @@ _event_post_delay_with_flags(event_stream_t* stream, int id, object_t object,
 	}
 	va_end(clist);
 
-	if (timestamp) {
-		event->flags |= EVENTFLAG_DELAY;
-		*(tick_t*)pointer_offset(event, basesize) = timestamp;
+	_event_stage_commit(stage, event);
+	_event_stage_unlock(stream, stage, true);
+}
+
+size_t
+event_post_batch(event_stream_t* stream, const event_post_t* post, size_t count) {
+	event_stage_t* stage;
+	size_t ipost;
+
+	if (!count)
+		return 0;
+
+	//Lock staging block and fire beacon once for the entire batch
+	stage = _event_stage_lock(stream);
+	for (ipost = 0; ipost < count; ++ipost) {
+		event_t* event = _event_stage_write(stage, post[ipost].id, post[ipost].object,
+		                                    post[ipost].delivery, 0, post[ipost].size);
+		if (!event)
+			break;
+		if (post[ipost].size)
+			memcpy(event->payload, post[ipost].payload, post[ipost].size);
+		_event_stage_commit(stage, event);
 	}
+	//Remaining events in batch after the one hitting the block limit are dropped as well
+	if (ipost < count)
+		EVENT_STATISTICS_ADD(stage->statistics.dropped, count - ipost - 1);
+	_event_stage_unlock(stream, stage, ipost > 0);
 
-	//Terminate with null id on next event
-	block->used += allocsize;
-	((event_t*)pointer_offset(block->events, block->used))->id = 0;
+	return ipost;
+}
 
-	//Re-fire beacon
-	if (!block->fired && stream->beacon) {
-		beacon_fire(stream->beacon);
-		block->fired = true;
+void*
+event_reserve(event_stream_t* stream, int id, object_t object, tick_t delivery, size_t size) {
+	event_stage_t* stage = _event_stage_lock(stream);
+	event_t* event = _event_stage_write(stage, id, object, delivery, 0, size);
+	if (!event) {
+		_event_stage_unlock(stream, stage, false);
+		return 0;
 	}
+	return event->payload;
+}
 
-unlock:
-	//Now unlock the event block
-	restored_block = atomic_cas32(&stream->write, last_write, EVENT_BLOCK_POSTING);
-	FOUNDATION_ASSERT(restored_block);
+void
+event_commit(event_stream_t* stream, void* payload, size_t size) {
+	event_t* event = pointer_offset(payload, -(ssize_t)offsetof(event_t, payload));
+	event_stage_t* stage = _event_stream_stage(stream);
+	size_t basesize = sizeof(event_t) + size;
+	if (basesize % 8)
+		basesize += 8 - (basesize % 8);
+
+	//Shrink event to the committed payload size, moving delivery timestamp
+	if (event->flags & EVENTFLAG_DELAY) {
+		FOUNDATION_ASSERT_MSG(basesize + 8 <= event->size, "Committed size larger than reserved size");
+		if (basesize + 8 < event->size) {
+			*(tick_t*)pointer_offset(event, basesize) = *(tick_t*)pointer_offset(event, event->size - 8);
+			event->size = (uint16_t)(basesize + 8);
+		}
+	}
+	else {
+		FOUNDATION_ASSERT_MSG(basesize <= event->size, "Committed size larger than reserved size");
+		if (basesize < event->size)
+			event->size = (uint16_t)basesize;
+	}
+
+	_event_stage_commit(stage, event);
+	_event_stage_unlock(stream, stage, true);
 }
 
 size_t
@@ -164,41 +330,27 @@ event_post_vlist(event_stream_t* stream, int id, object_t object, tick_t deliver
 	_event_post_delay_with_flags(stream, id, object, delivery, 0, payload, size, list);
 }
 
-static void
-event_post_varg_flags(event_stream_t* stream, int id, object_t object,
-                      tick_t delivery, uint16_t flags, const void* payload, size_t size, ...) {
-	va_list list;
-	va_start(list, size);
-	_event_post_delay_with_flags(stream, id, object, delivery, flags, payload, size, list);
-	va_end(list);
-}
-
 event_t* event_next(const event_block_t* block, event_t* event) {
-	tick_t curtime = 0;
-	tick_t eventtime;
+	//Delayed events are only merged into the block when due
+	if (!block)
+		return nullptr;
 
-	while (block) {
-		//Grab first event if no previous event, or grab next event
-		event = (event ? pointer_offset(event, event->size) : (block && block->used ? block->events : 0));
-		if (!event || !event->id)
-			break; // End of event list
+	//Grab first event if no previous event, or grab next event
+	event = (event ? pointer_offset(event, event->size) : (block->used ? block->events : 0));
+	if (!event || !event->id)
+		return nullptr; // End of event list
 
-		if (!(event->flags & EVENTFLAG_DELAY))
-			return event;
-
-		if (!curtime)
-			curtime = time_current();
+	return event;
+}
 
-		eventtime = *(tick_t*)pointer_offset(event, event->size - 8);
-		if (eventtime <= curtime)
-			return event;
+size_t
+event_block_count(const event_block_t* block) {
+	return block ? array_size(block->offset) : 0;
+}
 
-		//Re-post to next block
-		event_post_varg_flags(block->stream, event->id, event->object, eventtime, event->flags,
-		                      event->payload, event->size - (sizeof(event_t) + 8), nullptr);
-	}
-	
-	return nullptr;
+const uint32_t*
+event_block_offsets(const event_block_t* block) {
+	return block ? block->offset : 0;
 }
 
 event_stream_t*
@@ -212,25 +364,24 @@ event_stream_allocate(size_t size) {
 
 void
 event_stream_initialize(event_stream_t* stream, size_t size) {
-	atomic_store32(&stream->write, 0);
-	stream->read = 1;
+	memset(stream, 0, sizeof(event_stream_t));
 
 	if (size < 256)
 		size = 256;
 
+	stream->read = 1;
+
 	stream->block[0].events = memory_allocate(0, size, 16, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
 	stream->block[1].events = memory_allocate(0, size, 16, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
 
-	stream->block[0].used = 0;
-	stream->block[1].used = 0;
-
 	stream->block[0].capacity = size;
 	stream->block[1].capacity = size;
 
 	stream->block[0].stream = stream;
 	stream->block[1].stream = stream;
+	stream->delay.stream = stream;
 
-    stream->beacon = nullptr;
+	stream->beacon = nullptr;
 }
 
 void
@@ -243,10 +394,300 @@ event_stream_deallocate(event_stream_t* stream) {
 
 void
 event_stream_finalize(event_stream_t* stream) {
+	size_t istage, isubscriber;
+	for (istage = 0; istage < EVENT_STREAM_STAGES; ++istage) {
+		event_stage_t* stage = atomic_loadptr(&stream->stage[istage]);
+		if (!stage)
+			continue;
+		if (stage->block[0].events)
+			memory_deallocate(stage->block[0].events);
+		if (stage->block[1].events)
+			memory_deallocate(stage->block[1].events);
+		memory_deallocate(stage);
+		atomic_storeptr(&stream->stage[istage], 0);
+	}
 	if (stream->block[0].events)
 		memory_deallocate(stream->block[0].events);
 	if (stream->block[1].events)
 		memory_deallocate(stream->block[1].events);
+	array_deallocate(stream->block[0].offset);
+	array_deallocate(stream->block[1].offset);
+	if (stream->delay.events)
+		memory_deallocate(stream->delay.events);
+	array_deallocate(stream->timer);
+	for (isubscriber = 0; isubscriber < EVENT_STREAM_SUBSCRIBERS; ++isubscriber) {
+		array_deallocate(stream->routed[0][isubscriber]);
+		array_deallocate(stream->routed[1][isubscriber]);
+	}
+	array_deallocate(stream->route);
+	array_deallocate(stream->route_table);
+}
+
+static void
+_event_block_append(event_block_t* block, const void* events, size_t size) {
+	size_t need = block->used + size + 16;
+	if (need > block->capacity) {
+		size_t capacity = block->capacity * 2;
+		if (capacity < need)
+			capacity = need;
+		capacity = (capacity + 15) & ~(size_t)15;
+		block->events = block->events ? memory_reallocate(block->events, capacity, 16, block->capacity) :
+		                memory_allocate(0, capacity, 16, MEMORY_PERSISTENT);
+		block->capacity = capacity;
+	}
+	memcpy(pointer_offset(block->events, block->used), events, size);
+	block->used += size;
+}
+
+static FOUNDATION_FORCEINLINE bool
+_event_timer_before(const event_timer_t* timer, const event_timer_t* other) {
+	return (timer->timestamp < other->timestamp) ||
+	       ((timer->timestamp == other->timestamp) && (timer->sequence < other->sequence));
+}
+
+static void
+_event_timer_sift_up(event_timer_t* timer, size_t index) {
+	event_timer_t entry = timer[index];
+	while (index) {
+		size_t parent = (index - 1) / 2;
+		if (!_event_timer_before(&entry, timer + parent))
+			break;
+		timer[index] = timer[parent];
+		index = parent;
+	}
+	timer[index] = entry;
+}
+
+static void
+_event_timer_sift_down(event_timer_t* timer, size_t count, size_t index) {
+	event_timer_t entry = timer[index];
+	while (true) {
+		size_t child = (index * 2) + 1;
+		if (child >= count)
+			break;
+		if ((child + 1 < count) && _event_timer_before(timer + child + 1, timer + child))
+			++child;
+		if (!_event_timer_before(timer + child, &entry))
+			break;
+		timer[index] = timer[child];
+		index = child;
+	}
+	timer[index] = entry;
+}
+
+//Move delayed event to the delayed event storage and insert it in the heap
+static void
+_event_stream_delay(event_stream_t* stream, const event_t* event) {
+	event_timer_t timer;
+	timer.timestamp = *(const tick_t*)pointer_offset_const(event, event->size - 8);
+	timer.sequence = stream->timer_sequence++;
+	timer.offset = stream->delay.used;
+	_event_block_append(&stream->delay, event, event->size);
+	array_push(stream->timer, timer);
+	_event_timer_sift_up(stream->timer, array_size(stream->timer) - 1);
+}
+
+static void
+_event_stream_merge(event_stream_t* stream, event_block_t* block, const event_block_t* source) {
+	size_t offset = 0;
+	size_t run = 0;
+	while (offset < source->used) {
+		const event_t* event = pointer_offset_const(source->events, offset);
+		size_t size = event->size;
+		if (!(event->flags & EVENTFLAG_DELAY)) {
+			//Offset in block once current sequence of immediate events is copied
+			array_push(block->offset, (uint32_t)(block->used + (offset - run)));
+		}
+		else {
+			//Copy sequences of immediate events in one go
+			if (offset > run)
+				_event_block_append(block, pointer_offset_const(source->events, run), offset - run);
+			_event_stream_delay(stream, event);
+			run = offset + size;
+		}
+		offset += size;
+	}
+	if (offset > run)
+		_event_block_append(block, pointer_offset_const(source->events, run), offset - run);
+}
+
+//Move due delayed events from the heap to the block, only touching due events
+static void
+_event_stream_deliver(event_stream_t* stream, event_block_t* block, tick_t curtime) {
+	event_timer_t* timer = stream->timer;
+	size_t count = array_size(timer);
+	while (count && (timer[0].timestamp <= curtime)) {
+		const event_t* event = pointer_offset_const(stream->delay.events, timer[0].offset);
+		array_push(block->offset, (uint32_t)block->used);
+		_event_block_append(block, event, event->size);
+		stream->delay_free += event->size;
+		timer[0] = timer[--count];
+		array_pop(timer);
+		if (count)
+			_event_timer_sift_down(timer, count, 0);
+	}
+
+	if (!count) {
+		stream->delay.used = 0;
+		stream->delay_free = 0;
+	}
+	else if ((stream->delay_free > (stream->delay.used / 2)) &&
+	         (stream->delay.used > _foundation_config.event_block_chunk)) {
+		//Compact storage when more than half is delivered events, amortized over deliveries
+		event_block_t compact;
+		size_t itimer;
+		memset(&compact, 0, sizeof(compact));
+		for (itimer = 0; itimer < count; ++itimer) {
+			const event_t* event = pointer_offset_const(stream->delay.events, timer[itimer].offset);
+			timer[itimer].offset = compact.used;
+			_event_block_append(&compact, event, event->size);
+		}
+		memory_deallocate(stream->delay.events);
+		stream->delay.events = compact.events;
+		stream->delay.capacity = compact.capacity;
+		stream->delay.used = compact.used;
+		stream->delay_free = 0;
+	}
+}
+
+static FOUNDATION_FORCEINLINE unsigned int
+_event_first_bit(uint32_t mask) {
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	_BitScanForward(&index, (unsigned long)mask);
+	return (unsigned int)index;
+#else
+	return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+static void
+_event_stream_build_route_table(event_stream_t* stream) {
+	size_t iroute, rsize;
+	int first_id, last_id, id;
+
+	array_clear(stream->route_table);
+	rsize = array_size(stream->route);
+	if (!rsize)
+		return;
+
+	first_id = stream->route[0].first_id;
+	last_id = stream->route[0].last_id;
+	for (iroute = 1; iroute < rsize; ++iroute) {
+		if (stream->route[iroute].first_id < first_id)
+			first_id = stream->route[iroute].first_id;
+		if (stream->route[iroute].last_id > last_id)
+			last_id = stream->route[iroute].last_id;
+	}
+	if ((last_id - first_id) >= EVENT_ROUTE_TABLE_MAX)
+		return;
+
+	array_resize(stream->route_table, (size_t)(last_id - first_id) + 1);
+	memset(stream->route_table, 0, sizeof(uint32_t) * array_size(stream->route_table));
+	stream->route_base = first_id;
+	for (iroute = 0; iroute < rsize; ++iroute) {
+		const event_route_t* route = stream->route + iroute;
+		for (id = route->first_id; id <= route->last_id; ++id)
+			stream->route_table[id - first_id] |= route->subscribers;
+	}
+}
+
+//Split the block into per subscriber views of event offsets in a single pass
+static void
+_event_stream_route(event_stream_t* stream, const event_block_t* block) {
+	uint32_t** routed = stream->routed[stream->read];
+	const uint32_t* table = stream->route_table;
+	size_t table_size = array_size(table);
+	size_t rsize = array_size(stream->route);
+	size_t ievent, esize, iroute;
+
+	for (ievent = 0, esize = array_size(block->offset); ievent < esize; ++ievent) {
+		uint32_t offset = block->offset[ievent];
+		const event_t* event = pointer_offset_const(block->events, offset);
+		int id = event->id;
+		uint32_t mask = 0;
+		if (table_size) {
+			if ((id >= stream->route_base) && ((size_t)(id - stream->route_base) < table_size))
+				mask = table[id - stream->route_base];
+		}
+		else {
+			for (iroute = 0; iroute < rsize; ++iroute) {
+				if ((id >= stream->route[iroute].first_id) && (id <= stream->route[iroute].last_id))
+					mask |= stream->route[iroute].subscribers;
+			}
+		}
+		while (mask) {
+			array_push(routed[_event_first_bit(mask)], offset);
+			mask &= mask - 1;
+		}
+	}
+}
+
+int
+event_stream_subscribe(event_stream_t* stream, int first_id, int last_id) {
+	int subscriber;
+	if (!~stream->subscribers)
+		return -1;
+	subscriber = (int)_event_first_bit(~stream->subscribers);
+	stream->subscribers |= (1U << subscriber);
+	event_stream_subscribe_range(stream, subscriber, first_id, last_id);
+	return subscriber;
+}
+
+void
+event_stream_subscribe_range(event_stream_t* stream, int subscriber, int first_id, int last_id) {
+	event_route_t route;
+	if ((subscriber < 0) || (subscriber >= EVENT_STREAM_SUBSCRIBERS) ||
+	        !(stream->subscribers & (1U << subscriber)) || (first_id > last_id))
+		return;
+	route.first_id = first_id;
+	route.last_id = last_id;
+	route.subscribers = (1U << subscriber);
+	array_push(stream->route, route);
+	_event_stream_build_route_table(stream);
+}
+
+void
+event_stream_unsubscribe(event_stream_t* stream, int subscriber) {
+	size_t iroute;
+	uint32_t mask;
+	if ((subscriber < 0) || (subscriber >= EVENT_STREAM_SUBSCRIBERS))
+		return;
+	mask = (1U << subscriber);
+	for (iroute = 0; iroute < array_size(stream->route);) {
+		if (stream->route[iroute].subscribers == mask)
+			array_erase(stream->route, iroute);
+		else
+			++iroute;
+	}
+	stream->subscribers &= ~mask;
+	array_clear(stream->routed[0][subscriber]);
+	array_clear(stream->routed[1][subscriber]);
+	_event_stream_build_route_table(stream);
+}
+
+static const uint32_t*
+_event_block_routed(const event_block_t* block, int subscriber) {
+	const event_stream_t* stream;
+	if (!block || !block->stream || (subscriber < 0) || (subscriber >= EVENT_STREAM_SUBSCRIBERS))
+		return 0;
+	stream = block->stream;
+	if (block == stream->block)
+		return stream->routed[0][subscriber];
+	if (block == stream->block + 1)
+		return stream->routed[1][subscriber];
+	return 0;
+}
+
+size_t
+event_block_subscriber_count(const event_block_t* block, int subscriber) {
+	const uint32_t* routed = _event_block_routed(block, subscriber);
+	return array_size(routed);
+}
+
+const uint32_t*
+event_block_subscriber_offsets(const event_block_t* block, int subscriber) {
+	return _event_block_routed(block, subscriber);
 }
 
 event_block_t*
@@ -254,37 +695,128 @@ event_stream_process(event_stream_t* stream) {
 	event_block_t* block;
 	bool restored_block;
 	int32_t last_write, new_write;
+	size_t istage;
 
 	if (!stream)
 		return 0;
 
-	//Lock the write event block by atomic swapping the write block index
-	last_write = atomic_load32(&stream->write);
-	while ((last_write < 0) || !atomic_cas32(&stream->write, EVENT_BLOCK_SWAPPING, last_write)) {
-		thread_yield();
-		last_write = atomic_load32(&stream->write);
+	//Swap read blocks and reset used (safe, since read can only happen on one thread). Clear
+	//fired state before swapping staging blocks so any new post fires the beacon again
+	stream->read = 1 - stream->read;
+	block = stream->block + stream->read;
+	block->used = 0;
+	array_clear(block->offset);
+	if (stream->subscribers) {
+		size_t isubscriber;
+		for (isubscriber = 0; isubscriber < EVENT_STREAM_SUBSCRIBERS; ++isubscriber)
+			array_clear(stream->routed[stream->read][isubscriber]);
 	}
+	atomic_store32(&stream->fired, 0);
+	atomic_thread_fence_sequentially_consistent();
+
+	for (istage = 0; istage < EVENT_STREAM_STAGES; ++istage) {
+		event_stage_t* stage = atomic_loadptr(&stream->stage[istage]);
+		event_block_t* stage_block;
+		if (!stage)
+			continue;
+
+		//Lock the write event block by atomic swapping the write block index
+		last_write = atomic_load32(&stage->write);
+		if ((last_write < 0) || !atomic_cas32(&stage->write, EVENT_BLOCK_SWAPPING, last_write)) {
+#if BUILD_ENABLE_EVENT_STATISTICS
+			tick_t start = time_current();
+#endif
+			do {
+				thread_yield();
+				last_write = atomic_load32(&stage->write);
+			}
+			while ((last_write < 0) || !atomic_cas32(&stage->write, EVENT_BLOCK_SWAPPING, last_write));
+			EVENT_STATISTICS_ADD(stream->statistics.spin_count, 1);
+			EVENT_STATISTICS_ADD(stream->statistics.spin_ticks, time_diff(start, time_current()));
+		}
 
-	//Reset used on last read (safe, since read can only happen on one thread)
-	stream->block[ stream->read ].used = 0;
-	stream->block[ stream->read ].fired = false;
+		//Swap blocks, read block was emptied by previous merge
+		new_write = stage->read;
+		stage->read = last_write;
 
-	//Swap blocks
-	new_write = stream->read;
-	stream->read = last_write;
+		//Unlock write event block
+		restored_block = atomic_cas32(&stage->write, new_write, EVENT_BLOCK_SWAPPING);
+		FOUNDATION_ASSERT(restored_block);
 
-	block = stream->block + last_write;
+		//Merge without lock, producers are posting to the other block
+		stage_block = stage->block + last_write;
+		if (stage_block->used)
+			_event_stream_merge(stream, block, stage_block);
+		stage_block->used = 0;
+	}
 
-	//Unlock write event block
-	restored_block = atomic_cas32(&stream->write, new_write, EVENT_BLOCK_SWAPPING);
-	FOUNDATION_ASSERT(restored_block);
+	if (array_size(stream->timer))
+		_event_stream_deliver(stream, block, time_current());
+
+	if (stream->subscribers)
+		_event_stream_route(stream, block);
+
+	//Terminate with null id on next event
+	((event_t*)pointer_offset(block->events, block->used))->id = 0;
+
+	EVENT_STATISTICS_ADD(stream->statistics.processed_blocks, 1);
+	EVENT_STATISTICS_ADD(stream->statistics.processed_events, array_size(block->offset));
+	EVENT_STATISTICS_ADD(stream->statistics.processed_bytes, block->used);
+#if BUILD_ENABLE_EVENT_STATISTICS
+	if (block->used > stream->statistics.peak_block_bytes)
+		stream->statistics.peak_block_bytes = block->used;
+#endif
 
 	return block;
 }
 
+event_statistics_t
+event_stream_statistics(const event_stream_t* stream) {
+	event_statistics_t statistics;
+	size_t istage;
+
+	memset(&statistics, 0, sizeof(statistics));
+#if BUILD_ENABLE_EVENT_STATISTICS
+	statistics = stream->statistics;
+	statistics.delayed_pending = array_size(stream->timer);
+	//Posting counters are read without locking stages, values are approximate while posting
+	for (istage = 0; istage < EVENT_STREAM_STAGES; ++istage) {
+		const event_stage_t* stage = atomic_loadptr((atomicptr_t*)&stream->stage[istage]);
+		if (!stage)
+			continue;
+		statistics.posted += stage->statistics.posted;
+		statistics.posted_bytes += stage->statistics.posted_bytes;
+		statistics.dropped += stage->statistics.dropped;
+		statistics.limit_hits += stage->statistics.limit_hits;
+		statistics.reallocations += stage->statistics.reallocations;
+		statistics.spin_count += stage->statistics.spin_count;
+		statistics.spin_ticks += stage->statistics.spin_ticks;
+	}
+#else
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(istage);
+#endif
+	return statistics;
+}
+
 void
 event_stream_set_beacon(event_stream_t* stream, beacon_t* beacon) {
+	size_t istage;
 	stream->beacon = beacon;
-	if (beacon && (atomic_load32(&stream->write) > 0))
-		beacon_fire(beacon);
+	if (!beacon)
+		return;
+	atomic_thread_fence_sequentially_consistent();
+	for (istage = 0; istage < EVENT_STREAM_STAGES; ++istage) {
+		event_stage_t* stage = atomic_loadptr(&stream->stage[istage]);
+		if (stage && (stage->block[0].used || stage->block[1].used)) {
+			if (atomic_cas32(&stream->fired, 1, 0))
+				beacon_fire(beacon);
+			break;
+		}
+	}
+}
+
+tick_t
+event_stream_next_delivery(const event_stream_t* stream) {
+	return array_size(stream->timer) ? stream->timer[0].timestamp : 0;
 }
@@ -17,19 +17,23 @@
 
 Base system for event posting and processing.
 
-Double-buffered event streams with a lock-free structure of many-writers, single-reader and
-yield-spinning over an atomic operation while waiting for other threads to finish writing or
-swap-for-read. No locks needed as only write block indicator needs to be protected (which
-can be done with atomic operations).
+Event streams with a lock-free structure of many-writers, single-reader. Each posting thread
+is assigned a double-buffered staging block in the stream, so threads posting to the same
+stream do not contend with each other. Posting only yield-spins over an atomic operation
+while the stream processing swaps the staging block, or if more threads than the number of
+staging blocks post to the same stream and end up sharing a staging block.
 
-The expected contention for writing is low as the write is a quick operation and number
-of events posted to the same stream from different threads is very low.
+Events are posted in order per thread. Events posted from different threads are not ordered
+relative to each other.
 
-Current buffer used to writing events is swapped during the event_stream_process call,
+Staging blocks are swapped and merged into a read block during the event_stream_process call,
 allowing new events to be posted during the event process loop (which will then be delivered
 and processed during the next event process loop).
 
 Delayed events will not be delivered for processing until the delivery timestamp has passed.
+Pending delayed events are kept in a min-heap ordered by delivery timestamp in the stream, so
+processing cost only depends on the number of due events, not the number of pending events.
+Delayed events with equal delivery timestamp are delivered in posting order.
 Delivery is not guaranteed until next pass of <code>event_stream_process</code> and
 <code>event_next</code> iteration.
 
@@ -80,6 +84,39 @@ FOUNDATION_API void
 event_post_vlist(event_stream_t* stream, int id, object_t object, tick_t delivery,
                  const void* payload, size_t size, va_list list);
 
+/*! Post a batch of events to stream, locking the stream staging block and firing the
+beacon once for the entire batch. This operation is thread-safe and will spin loop until
+operation can be completed if in contention with another thread.
+\param stream    Event stream
+\param post      Array of event descriptions
+\param count     Number of events
+\return          Number of events posted, less than count if event block limit is reached */
+FOUNDATION_API size_t
+event_post_batch(event_stream_t* stream, const event_post_t* post, size_t count);
+
+/*! Reserve an event in the stream and get a pointer to the payload memory, allowing the
+payload to be written in place without intermediate copies. The event is not visible for
+processing until committed with #event_commit, which must be called on the same thread
+before posting or reserving any other event in the same stream. Other threads sharing the
+staging block and stream processing will spin until the event is committed, so keep the
+time between reserve and commit short.
+\param stream    Event stream
+\param id        Event id
+\param object    Sender
+\param delivery  Delivery time, 0 for immediate delivery
+\param size      Maximum event payload size
+\return          Pointer to payload memory, 0 if event could not be reserved */
+FOUNDATION_API void*
+event_reserve(event_stream_t* stream, int id, object_t object, tick_t delivery, size_t size);
+
+/*! Commit an event previously reserved with #event_reserve, making it available for
+processing. The payload size can be less than the reserved size.
+\param stream    Event stream
+\param payload   Payload pointer returned by #event_reserve
+\param size      Actual event payload size, at most the reserved size */
+FOUNDATION_API void
+event_commit(event_stream_t* stream, void* payload, size_t size);
+
 /*! Get next event during procesing
 \param block Event block
 \param event Previous event, pass in 0 for getting first event
@@ -87,6 +124,38 @@ event_post_vlist(event_stream_t* stream, int id, object_t object, tick_t deliver
 FOUNDATION_API event_t*
 event_next(const event_block_t* block, event_t* event);
 
+/*! Get number of events in a block returned by #event_stream_process
+\param block Event block
+\return      Number of events */
+FOUNDATION_API size_t
+event_block_count(const event_block_t* block);
+
+/*! Get offsets of events in a block returned by #event_stream_process. All events in the
+block are stored contiguously in the event_block_t::events memory buffer, and the offset of
+each event in bytes from the start of the buffer is precomputed during processing, allowing
+consumers to process the block as a span of events or split it up between threads.
+\param block Event block
+\return      Array of event_block_count(block) offsets */
+FOUNDATION_API const uint32_t*
+event_block_offsets(const event_block_t* block);
+
+/*! Get number of events in a block returned by #event_stream_process routed to the given
+subscriber, see #event_stream_subscribe
+\param block      Event block
+\param subscriber Subscriber
+\return           Number of events routed to subscriber */
+FOUNDATION_API size_t
+event_block_subscriber_count(const event_block_t* block, int subscriber);
+
+/*! Get offsets of events in a block returned by #event_stream_process routed to the given
+subscriber, in block order. Offsets are in bytes from the start of the event_block_t::events
+memory buffer, same as #event_block_offsets. The view stays valid as long as the block.
+\param block      Event block
+\param subscriber Subscriber
+\return           Array of event_block_subscriber_count(block, subscriber) offsets */
+FOUNDATION_API const uint32_t*
+event_block_subscriber_offsets(const event_block_t* block, int subscriber);
+
 /*! Get event actual payload size (size field in event struct may be padded and extended
 for internal data)
 \param event Event
@@ -129,3 +198,46 @@ event_stream_process(event_stream_t* stream);
 \param beacon Beacon to fire */
 FOUNDATION_API void
 event_stream_set_beacon(event_stream_t* stream, beacon_t* beacon);
+
+/*! Get delivery timestamp of the earliest delayed event held by the stream. Delayed events
+are moved from the staging blocks into the stream in #event_stream_process, events posted
+after the last call are not included. Must only be called on the thread processing the stream.
+\param stream Event stream
+\return       Delivery timestamp, zero if no delayed events are pending */
+FOUNDATION_API tick_t
+event_stream_next_delivery(const event_stream_t* stream);
+
+/*! Add a subscriber receiving events with id in the given inclusive range. Events are routed
+to subscribers once per block in #event_stream_process, and each subscriber iterates its own
+view of the block with #event_block_subscriber_offsets instead of scanning every event. An
+event matching several subscribers is routed to all of them. Subscriptions must be managed
+on the thread processing the stream.
+\param stream   Event stream
+\param first_id First event id in range
+\param last_id  Last event id in range
+\return         Subscriber, -1 if the stream already has #EVENT_STREAM_SUBSCRIBERS subscribers */
+FOUNDATION_API int
+event_stream_subscribe(event_stream_t* stream, int first_id, int last_id);
+
+/*! Add another inclusive event id range to a subscriber
+\param stream     Event stream
+\param subscriber Subscriber returned by #event_stream_subscribe
+\param first_id   First event id in range
+\param last_id    Last event id in range */
+FOUNDATION_API void
+event_stream_subscribe_range(event_stream_t* stream, int subscriber, int first_id, int last_id);
+
+/*! Remove a subscriber and all its event id ranges
+\param stream     Event stream
+\param subscriber Subscriber returned by #event_stream_subscribe */
+FOUNDATION_API void
+event_stream_unsubscribe(event_stream_t* stream, int subscriber);
+
+/*! Get statistics for an event stream. Posting counters are gathered per staging block
+without synchronization and might be slightly out of date if other threads are posting
+concurrently. Only gathered if #BUILD_ENABLE_EVENT_STATISTICS is enabled, otherwise all
+counters are zero.
+\param stream Event stream
+\return       Event stream statistics */
+FOUNDATION_API event_statistics_t
+event_stream_statistics(const event_stream_t* stream);
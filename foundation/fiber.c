@@ -0,0 +1,218 @@
+/* fiber.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+//Deprecated ucontext routines require _XOPEN_SOURCE before any system header on Apple platforms
+#if defined(__APPLE__)
+#  define _XOPEN_SOURCE 700
+#  define _DARWIN_C_SOURCE 1
+#endif
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#if FOUNDATION_PLATFORM_WINDOWS
+#  include <foundation/windows.h>
+#  define FOUNDATION_HAVE_FIBER 1
+#elif FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_ANDROID && !FOUNDATION_PLATFORM_PNACL
+#  include <foundation/posix.h>
+#  include <ucontext.h>
+#  include <sys/mman.h>
+#  define FOUNDATION_HAVE_FIBER 1
+#endif
+
+#ifndef FOUNDATION_HAVE_FIBER
+#  define FOUNDATION_HAVE_FIBER 0
+#endif
+
+#if FOUNDATION_HAVE_FIBER
+
+#if FOUNDATION_PLATFORM_APPLE && FOUNDATION_COMPILER_CLANG
+#  pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+struct fiber_t {
+	fiber_fn fn;
+	void* arg;
+	fiber_t* caller;
+	bool thread;
+	bool finished;
+#if FOUNDATION_PLATFORM_WINDOWS
+	void* handle;
+	bool converted;
+#else
+	ucontext_t context;
+	void* stack;
+	size_t stack_size;
+#endif
+};
+
+static void
+_fiber_run(fiber_t* fiber) {
+	fiber->fn(fiber->arg);
+	fiber->finished = true;
+	fiber_switch(fiber, fiber->caller);
+}
+
+#if FOUNDATION_PLATFORM_WINDOWS
+
+static void WINAPI
+_fiber_entry(void* arg) {
+	_fiber_run(arg);
+}
+
+#else
+
+//makecontext only passes int arguments, split the fiber pointer in two halves
+static void
+_fiber_entry(unsigned int low, unsigned int high) {
+	uintptr_t ptr = (uintptr_t)low;
+#if FOUNDATION_SIZE_POINTER > 4
+	ptr |= ((uintptr_t)high) << 32ULL;
+#else
+	FOUNDATION_UNUSED(high);
+#endif
+	_fiber_run((fiber_t*)ptr);
+}
+
+#endif
+
+fiber_t*
+fiber_allocate(fiber_fn fn, void* arg, size_t stack_size) {
+	fiber_t* fiber = memory_allocate(0, sizeof(fiber_t), 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	fiber->fn = fn;
+	fiber->arg = arg;
+	if (!stack_size)
+		stack_size = _foundation_config.fiber_stack_size;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	fiber->handle = CreateFiberEx(0, stack_size, FIBER_FLAG_FLOAT_SWITCH, _fiber_entry, fiber);
+	if (!fiber->handle) {
+		string_const_t errmsg = system_error_message(0);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL, STRING_CONST("Unable to create fiber: %.*s"),
+		           STRING_FORMAT(errmsg));
+		memory_deallocate(fiber);
+		return 0;
+	}
+#else
+	//Stack is mapped with a guard page at the low end, pages are committed on first use
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	uintptr_t ptr = (uintptr_t)fiber;
+	stack_size = ((stack_size + page_size - 1) / page_size) * page_size;
+	fiber->stack_size = stack_size + page_size;
+	fiber->stack = mmap(0, fiber->stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (fiber->stack == MAP_FAILED) {
+		string_const_t errmsg = system_error_message(0);
+		log_errorf(0, ERROR_OUT_OF_MEMORY, STRING_CONST("Unable to map fiber stack: %.*s"),
+		           STRING_FORMAT(errmsg));
+		memory_deallocate(fiber);
+		return 0;
+	}
+	mprotect(fiber->stack, page_size, PROT_NONE);
+
+	getcontext(&fiber->context);
+	fiber->context.uc_stack.ss_sp = pointer_offset(fiber->stack, page_size);
+	fiber->context.uc_stack.ss_size = stack_size;
+	fiber->context.uc_link = 0;
+	makecontext(&fiber->context, (void (*)(void))_fiber_entry, 2,
+	            (unsigned int)(ptr & 0xFFFFFFFFU), (unsigned int)((uint64_t)ptr >> 32ULL));
+#endif
+
+	return fiber;
+}
+
+fiber_t*
+fiber_allocate_thread(void) {
+	fiber_t* fiber = memory_allocate(0, sizeof(fiber_t), 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	fiber->thread = true;
+#if FOUNDATION_PLATFORM_WINDOWS
+	fiber->handle = ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+	if (fiber->handle)
+		fiber->converted = true;
+	else if (GetLastError() == ERROR_ALREADY_FIBER)
+		fiber->handle = GetCurrentFiber();
+	if (!fiber->handle) {
+		memory_deallocate(fiber);
+		return 0;
+	}
+#endif
+	return fiber;
+}
+
+void
+fiber_deallocate(fiber_t* fiber) {
+	if (!fiber)
+		return;
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (fiber->thread) {
+		if (fiber->converted)
+			ConvertFiberToThread();
+	}
+	else {
+		DeleteFiber(fiber->handle);
+	}
+#else
+	if (fiber->stack)
+		munmap(fiber->stack, fiber->stack_size);
+#endif
+	memory_deallocate(fiber);
+}
+
+void
+fiber_switch(fiber_t* from, fiber_t* to) {
+	FOUNDATION_ASSERT_MSG(!to->finished, "Switching to finished fiber");
+	to->caller = from;
+#if FOUNDATION_PLATFORM_WINDOWS
+	FOUNDATION_UNUSED(from);
+	SwitchToFiber(to->handle);
+#else
+	swapcontext(&from->context, &to->context);
+#endif
+}
+
+bool
+fiber_is_finished(const fiber_t* fiber) {
+	return fiber->finished;
+}
+
+#else
+
+fiber_t*
+fiber_allocate(fiber_fn fn, void* arg, size_t stack_size) {
+	FOUNDATION_UNUSED(fn);
+	FOUNDATION_UNUSED(arg);
+	FOUNDATION_UNUSED(stack_size);
+	return 0;
+}
+
+fiber_t*
+fiber_allocate_thread(void) {
+	return 0;
+}
+
+void
+fiber_deallocate(fiber_t* fiber) {
+	FOUNDATION_UNUSED(fiber);
+}
+
+void
+fiber_switch(fiber_t* from, fiber_t* to) {
+	FOUNDATION_UNUSED(from);
+	FOUNDATION_UNUSED(to);
+}
+
+bool
+fiber_is_finished(const fiber_t* fiber) {
+	FOUNDATION_UNUSED(fiber);
+	return true;
+}
+
+#endif
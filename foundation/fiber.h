@@ -0,0 +1,60 @@
+/* fiber.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file fiber.h
+\brief Fibers
+
+Fibers are cooperatively scheduled execution contexts with their own stack, switched
+explicitly on the calling thread. A thread must first be converted to a fiber with
+#fiber_allocate_thread before it can switch to other fibers. Fibers are implemented with
+ucontext on POSIX platforms and native fibers on Windows. On platforms without fiber support
+the allocation functions return null.
+
+A fiber that returns from its function switches back to the fiber that last switched to
+it and must not be switched to again. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a fiber. The fiber does not start executing until switched to.
+\param fn Fiber function
+\param arg Argument passed to fiber function
+\param stack_size Stack size, zero for default (foundation config fiber_stack_size)
+\return New fiber, null if fibers are not supported */
+FOUNDATION_API fiber_t*
+fiber_allocate(fiber_fn fn, void* arg, size_t stack_size);
+
+/*! Convert the calling thread to a fiber, allowing it to switch to other fibers.
+Deallocate the fiber on the same thread to convert it back to a thread.
+\return Fiber representing the calling thread, null if fibers are not supported */
+FOUNDATION_API fiber_t*
+fiber_allocate_thread(void);
+
+/*! Deallocate a fiber. Must not be called for the currently executing fiber.
+\param fiber Fiber */
+FOUNDATION_API void
+fiber_deallocate(fiber_t* fiber);
+
+/*! Switch execution from the currently executing fiber to another fiber. Returns
+once another fiber switches back to this fiber.
+\param from Currently executing fiber
+\param to Fiber to switch to */
+FOUNDATION_API void
+fiber_switch(fiber_t* from, fiber_t* to);
+
+/*! Query if a fiber has returned from the fiber function
+\param fiber Fiber
+\return true if fiber has finished executing */
+FOUNDATION_API bool
+fiber_is_finished(const fiber_t* fiber);
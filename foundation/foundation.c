@@ -41,8 +41,12 @@ main(int, char**);
 
 #endif
 
+#define FOUNDATION_SUBSYSTEM_TIMING_MAX 32
+
 foundation_config_t _foundation_config;
 static bool _foundation_initialized;
+static foundation_subsystem_timing_t _foundation_timing[FOUNDATION_SUBSYSTEM_TIMING_MAX];
+static atomic32_t _foundation_timing_count;
 
 static void
 foundation_initialize_config(const foundation_config_t config) {
@@ -52,10 +56,16 @@ foundation_initialize_config(const foundation_config_t config) {
 	                                        config.library_max           : 32;
 	_foundation_config.memory_tracker_max    = config.memory_tracker_max    ?
 	                                        config.memory_tracker_max    : (32 * 1024);
+	_foundation_config.memory_tracker_sample_rate = config.memory_tracker_sample_rate ?
+	                                        config.memory_tracker_sample_rate : (512 * 1024);
 	_foundation_config.temporary_memory      = config.temporary_memory      ?
 	                                        config.temporary_memory      : 0;
+	_foundation_config.memory_map_threshold  = config.memory_map_threshold;
+	_foundation_config.memory_guard_sample_rate = config.memory_guard_sample_rate;
 	_foundation_config.fs_monitor_max        = config.fs_monitor_max        ?
 	                                        config.fs_monitor_max        : 16;
+	_foundation_config.fs_stat_cache_size    = config.fs_stat_cache_size;
+	_foundation_config.fs_monitor_coalesce   = config.fs_monitor_coalesce;
 	_foundation_config.error_context_depth   = config.error_context_depth   ?
 	                                        config.error_context_depth   : 32;
 	_foundation_config.memory_context_depth  = config.memory_context_depth  ?
@@ -69,11 +79,61 @@ foundation_initialize_config(const foundation_config_t config) {
 	                                        config.event_block_limit     : (512 * 1024);
 	_foundation_config.thread_stack_size     = config.thread_stack_size     ?
 	                                        config.thread_stack_size     : 0x8000;
+	_foundation_config.fiber_stack_size      = config.fiber_stack_size      ?
+	                                        config.fiber_stack_size      : 0x10000;
 	_foundation_config.random_state_prealloc = config.random_state_prealloc;
+	_foundation_config.regex_cache_size      = config.regex_cache_size      ?
+	                                        config.regex_cache_size      : 64;
+	_foundation_config.time_cycle_counter    = config.time_cycle_counter;
+	_foundation_config.config_cache          = config.config_cache;
+	_foundation_config.config_monitor        = config.config_monitor;
+}
+
+void
+_foundation_subsystem_timing(const char* name, size_t length, tick_t start) {
+	tick_t end = _time_system_ns();
+	size_t index = (size_t)atomic_incr32(&_foundation_timing_count) - 1;
+	if (index < FOUNDATION_SUBSYSTEM_TIMING_MAX) {
+		_foundation_timing[index].name = string_const(name, length);
+		_foundation_timing[index].time = end - start;
+	}
+	//Subsystems initialized at startup are logged together once the log is configured
+	if (_foundation_initialized)
+		log_debugf(HASH_FOUNDATION, STRING_CONST("Initialized %.*s on first use in %.3fms"),
+		           (int)length, name, (double)(end - start) / 1000000.0);
+}
+
+const foundation_subsystem_timing_t*
+foundation_subsystem_timing(size_t* count) {
+	int32_t stored = atomic_load32(&_foundation_timing_count);
+	if (count)
+		*count = (stored < FOUNDATION_SUBSYSTEM_TIMING_MAX) ? (size_t)stored :
+		         FOUNDATION_SUBSYSTEM_TIMING_MAX;
+	return _foundation_timing;
 }
 
-#define SUBSYSTEM_INIT(system) if (ret == 0) ret = _##system##_initialize()
-#define SUBSYSTEM_INIT_ARGS(system, ...) if (ret == 0) ret = _##system##_initialize( __VA_ARGS__ )
+static void
+foundation_log_timing(void) {
+	size_t itiming, count;
+	tick_t total = 0;
+	const foundation_subsystem_timing_t* timing = foundation_subsystem_timing(&count);
+	for (itiming = 0; itiming < count; ++itiming) {
+		log_debugf(HASH_FOUNDATION, STRING_CONST("Initialized %.*s in %.3fms"),
+		           STRING_FORMAT(timing[itiming].name), (double)timing[itiming].time / 1000000.0);
+		total += timing[itiming].time;
+	}
+	log_debugf(HASH_FOUNDATION, STRING_CONST("Initialized foundation in %.3fms"),
+	           (double)total / 1000000.0);
+}
+
+#define SUBSYSTEM_INIT(system) if (ret == 0) { \
+		tick_t start = _time_system_ns(); \
+		ret = _##system##_initialize(); \
+		_foundation_subsystem_timing(STRING_CONST(#system), start); }
+#define SUBSYSTEM_INIT_ARGS(system, ...) if (ret == 0) { \
+		tick_t start = _time_system_ns(); \
+		ret = _##system##_initialize( __VA_ARGS__ ); \
+		_foundation_subsystem_timing(STRING_CONST(#system), start); }
 
 int
 foundation_initialize(const memory_system_t memory, const application_t application,
@@ -84,8 +144,9 @@ foundation_initialize(const memory_system_t memory, const application_t applicat
 		return 0;
 
 	process_set_exit_code(PROCESS_EXIT_SUCCESS);
-	
+
 	foundation_initialize_config(config);
+	atomic_store32(&_foundation_timing_count, 0);
 
 	/*lint -e774 */
 	SUBSYSTEM_INIT(atomic);
@@ -95,7 +156,13 @@ foundation_initialize(const memory_system_t memory, const application_t applicat
 	SUBSYSTEM_INIT(time);
 	SUBSYSTEM_INIT(thread);
 	SUBSYSTEM_INIT(random);
+	SUBSYSTEM_INIT(objectmap);
+	SUBSYSTEM_INIT(intern);
 	SUBSYSTEM_INIT(stream);
+	SUBSYSTEM_INIT(checksum);
+	SUBSYSTEM_INIT(varint);
+	SUBSYSTEM_INIT(pack);
+	SUBSYSTEM_INIT(regex);
 	SUBSYSTEM_INIT(fs);
 	SUBSYSTEM_INIT(stacktrace);
 	SUBSYSTEM_INIT_ARGS(environment, application);
@@ -122,6 +189,8 @@ foundation_initialize(const memory_system_t memory, const application_t applicat
 		config_parse_commandline(cmdline, array_size(cmdline));
 	}
 
+	foundation_log_timing();
+
 	//Artificial references
 	/*lint -e506 */
 #if FOUNDATION_PLATFORM_ANDROID
@@ -150,15 +219,23 @@ foundation_finalize(void) {
 	_foundation_initialized = false;
 
 	profile_finalize();
+	log_enable_async(false, 0, false);
+	log_set_file(0, 0, 0);
 
 	_config_finalize();
 	_fs_finalize();
+	_regex_finalize();
+	_pack_finalize();
+	_varint_finalize();
+	_checksum_finalize();
 	_stream_finalize();
 	_system_finalize();
 	_library_finalize();
 	_environment_finalize();
 	_random_finalize();
 	_thread_finalize();
+	_intern_finalize();
+	_objectmap_finalize();
 	_time_finalize();
 	_log_finalize();
 	_stacktrace_finalize();
@@ -28,11 +28,14 @@ Wrapper for foundation library headers and main entry/exit points */
 #include <foundation/error.h>
 #include <foundation/thread.h>
 #include <foundation/mutex.h>
+#include <foundation/lock.h>
+#include <foundation/lockfree.h>
 #include <foundation/semaphore.h>
 #include <foundation/beacon.h>
 #include <foundation/library.h>
 #include <foundation/system.h>
 #include <foundation/process.h>
+#include <foundation/processpool.h>
 #include <foundation/uuid.h>
 #include <foundation/log.h>
 #include <foundation/version.h>
@@ -41,12 +44,14 @@ Wrapper for foundation library headers and main entry/exit points */
 #include <foundation/hashstrings.h>
 #include <foundation/base64.h>
 #include <foundation/md5.h>
+#include <foundation/sha256.h>
 #include <foundation/array.h>
 #include <foundation/bitbuffer.h>
 #include <foundation/hashmap.h>
 #include <foundation/hashtable.h>
 #include <foundation/ringbuffer.h>
 #include <foundation/string.h>
+#include <foundation/intern.h>
 #include <foundation/path.h>
 #include <foundation/locale.h>
 
@@ -55,8 +60,14 @@ Wrapper for foundation library headers and main entry/exit points */
 #include <foundation/radixsort.h>
 
 #include <foundation/objectmap.h>
+#include <foundation/soamap.h>
+#include <foundation/queue.h>
+#include <foundation/fiber.h>
+#include <foundation/task.h>
 #include <foundation/event.h>
 #include <foundation/time.h>
+#include <foundation/timer.h>
+#include <foundation/runloop.h>
 #include <foundation/profile.h>
 
 #include <foundation/environment.h>
@@ -64,13 +75,20 @@ Wrapper for foundation library headers and main entry/exit points */
 #include <foundation/stream.h>
 #include <foundation/fs.h>
 #include <foundation/bufferstream.h>
+#include <foundation/compressstream.h>
+#include <foundation/checksum.h>
+#include <foundation/varint.h>
+#include <foundation/pack.h>
 #include <foundation/assetstream.h>
 #include <foundation/pipe.h>
+#include <foundation/socketstream.h>
 
 #include <foundation/crash.h>
 #include <foundation/stacktrace.h>
 
 #include <foundation/blowfish.h>
+#include <foundation/aes.h>
+#include <foundation/cipherstream.h>
 #include <foundation/regex.h>
 
 #include <foundation/main.h>
@@ -96,6 +114,14 @@ foundation_finalize(void);
 FOUNDATION_API bool
 foundation_is_initialized(void);
 
+/*! Query time spent initializing each subsystem, in initialization order. Subsystems
+initialized lazily on first use are appended when first used. The timings are also logged
+as debug messages in the foundation context at the end of #foundation_initialize.
+\param count Receives number of entries in returned array
+\return Array of subsystem timings, valid until the next #foundation_initialize */
+FOUNDATION_API const foundation_subsystem_timing_t*
+foundation_subsystem_timing(size_t* count);
+
 /*! Query foundation config
 \return Foundation library config */
 FOUNDATION_API foundation_config_t
@@ -16,15 +16,21 @@
 #if FOUNDATION_PLATFORM_WINDOWS
 #  include <foundation/windows.h>
 #  include <sys/utime.h>
+#  include <fcntl.h>
 #elif FOUNDATION_PLATFORM_POSIX
 #  include <foundation/posix.h>
 #  include <time.h>
 #  include <sys/types.h>
 #  include <sys/stat.h>
 #  include <sys/ioctl.h>
+#  include <sys/mman.h>
 #  include <utime.h>
 #  include <fcntl.h>
 #  include <dirent.h>
+#  if FOUNDATION_PLATFORM_APPLE
+#    include <copyfile.h>
+#    include <sys/clonefile.h>
+#  endif
 #endif
 
 #if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
@@ -38,6 +44,30 @@
 #if FOUNDATION_COMPILER_GCC
 #  pragma GCC diagnostic pop
 #endif
+#  include <sys/syscall.h>
+#endif
+
+#if !defined(FOUNDATION_HAVE_IO_URING) && FOUNDATION_PLATFORM_LINUX && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <sys/uio.h>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#      define FOUNDATION_HAVE_IO_URING 1
+#    endif
+//Path operations (statx, unlinkat, mkdirat) are declared by headers from Linux 5.15, and
+//support is probed at runtime, headers from 5.17 define IORING_FEAT_CQE_SKIP
+#    if defined(IORING_FEAT_CQE_SKIP) && defined(__NR_io_uring_register)
+#      define FOUNDATION_HAVE_IO_URING_PATH 1
+#    endif
+#  endif
+#endif
+#ifndef FOUNDATION_HAVE_IO_URING
+#  define FOUNDATION_HAVE_IO_URING 0
+#endif
+#ifndef FOUNDATION_HAVE_IO_URING_PATH
+#  define FOUNDATION_HAVE_IO_URING_PATH 0
 #endif
 
 #if FOUNDATION_PLATFORM_PNACL
@@ -74,11 +104,25 @@ struct fs_monitor_t {
 	bool       inuse;
 };
 
+struct fs_prefetch_t {
+	thread_t thread;
+	stream_t* stream;
+	void* buffer;
+	size_t window;
+	size_t requested;
+	atomic64_t offset;
+	atomic32_t stop;
+};
+
+typedef struct fs_prefetch_t fs_prefetch_t;
+
 struct stream_file_t {
 	/*lint -e830 -e754 It is used, through stream type */
 	FOUNDATION_DECLARE_STREAM;
 
 	fs_file_descriptor fd;
+	fs_prefetch_t* prefetch;
+	bool anonymous;
 
 #if FOUNDATION_PLATFORM_PNACL
 	size_t position;
@@ -86,14 +130,94 @@ struct stream_file_t {
 #endif
 };
 
+//Position, size and data share layout with stream_buffer_t, so reads are served by the inline
+//memory stream fast path in stream.h
+struct stream_mapped_t {
+	FOUNDATION_DECLARE_STREAM;
+
+	size_t position;
+	size_t size;
+	const void* data;
+#if FOUNDATION_PLATFORM_WINDOWS
+	void* mapping;
+#endif
+};
+
 typedef FOUNDATION_ALIGN(16) struct fs_monitor_t fs_monitor_t;
 typedef FOUNDATION_ALIGN(8) struct stream_file_t stream_file_t;
+typedef FOUNDATION_ALIGN(8) struct stream_mapped_t stream_mapped_t;
+
+FOUNDATION_STATIC_ASSERT((offsetof(stream_mapped_t, position) == offsetof(stream_buffer_t, current)) &&
+                         (offsetof(stream_mapped_t, size) == offsetof(stream_buffer_t, size)) &&
+                         (offsetof(stream_mapped_t, data) == offsetof(stream_buffer_t, buffer)),
+                         "mapped stream layout mismatch");
 
 #define GET_FILE( s ) ((stream_file_t*)(s))
 #define GET_FILE_CONST( s ) ((const stream_file_t*)(s))
 #define GET_STREAM( f ) ((stream_t*)(f))
 
+static void
+_fs_prefetch_request(fs_prefetch_t* prefetch, size_t position);
+
 static stream_vtable_t _fs_file_vtable;
+static stream_vtable_t _fs_mapped_vtable;
+
+#define FS_ASYNC_STOP  0xFF
+
+#define FS_ASYNC_WORKERS 4
+
+#define FS_PREFETCH_CHUNK_SIZE (256 * 1024)
+
+struct fs_async_request_t {
+	fs_async_result_t result;
+	int op;
+	fs_file_descriptor fd;
+#if FOUNDATION_HAVE_IO_URING
+	struct iovec iov;
+#endif
+#if FOUNDATION_HAVE_IO_URING_PATH
+	struct statx stx;
+#endif
+	size_t path_length;
+	size_t destination_length;
+	char path[BUILD_MAX_PATHLEN];
+	char destination[BUILD_MAX_PATHLEN];
+};
+
+typedef struct fs_async_request_t fs_async_request_t;
+
+struct fs_async_t {
+	event_stream_t* events;
+	beacon_t* beacon;
+	size_t depth;
+	fs_async_request_t* request;
+	fs_async_request_t stop;
+	queue_t free;
+	queue_t submit;
+	mutex_t* lock;
+	fs_async_result_t* completed;
+	atomic32_t pending;
+	size_t workers;
+	thread_t worker[FS_ASYNC_WORKERS];
+#if FOUNDATION_HAVE_IO_URING
+	thread_t reaper;
+	uint32_t ring_ops;
+	int ring;
+	void* sq_map;
+	size_t sq_map_size;
+	void* cq_map;
+	size_t cq_map_size;
+	struct io_uring_sqe* sqe;
+	size_t sqe_map_size;
+	unsigned int* sq_tail;
+	unsigned int* sq_mask;
+	unsigned int* sq_array;
+	unsigned int* cq_head;
+	unsigned int* cq_tail;
+	unsigned int* cq_mask;
+	struct io_uring_cqe* cqe;
+#endif
+};
 
 static mutex_t* _fs_monitor_lock;
 static fs_monitor_t* _fs_monitors;
@@ -106,6 +230,30 @@ static void* _fs_monitor(void*);
 #  define FOUNDATION_HAVE_FS_MONITOR 0
 #endif
 
+struct fs_stat_entry_t {
+	hash_t key;
+	bool exists;
+	fs_entry_type_t type;
+	size_t size;
+	tick_t last_modified;
+};
+
+typedef struct fs_stat_entry_t fs_stat_entry_t;
+
+//Direct mapped table of stat results keyed by absolute path hash, only paths below a root
+//covered by an active monitor are cached. The generation is incremented on each invalidation,
+//preventing a query racing with an invalidation from storing a stale result.
+static mutex_t* _fs_stat_cache_lock;
+static fs_stat_entry_t* _fs_stat_cache;
+static string_t* _fs_stat_cache_roots;
+static atomic32_t _fs_stat_cache_generation;
+
+static void
+_fs_stat_cache_invalidate(const char* path, size_t length);
+
+static void
+_fs_stat_cache_flush(void);
+
 static string_const_t
 _fs_strip_protocol(const char* path, size_t length) {
 	string_const_t stripped = path_strip_protocol(path, length);
@@ -249,8 +397,200 @@ fs_unmonitor(const char* path, size_t length) {
 	mutex_unlock(_fs_monitor_lock);
 }
 
+//Clean absolute paths are used as is, other paths are cleaned into the given buffer
+static string_const_t
+_fs_stat_cache_path(char* buffer, size_t capacity, const char* path, size_t length) {
+	string_const_t fspath = _fs_strip_protocol(path, length);
+	string_t fullpath;
+	if (!fspath.length)
+		return string_const(buffer, 0);
+	if (path_is_absolute(STRING_ARGS(fspath)) && path_is_clean(STRING_ARGS(fspath)))
+		return fspath;
+	fullpath = string_copy(buffer, capacity, STRING_ARGS(fspath));
+	fullpath = path_absolute(STRING_ARGS(fullpath), capacity);
+	return string_const(STRING_ARGS(fullpath));
+}
+
+static hash_t
+_fs_stat_cache_key(const char* path, size_t length) {
+	hash_t key = hash(path, length);
+	return key ? key : 1;
+}
+
+static bool
+_fs_stat_cache_covers(const char* path, size_t length) {
+	size_t iroot, rootsize;
+	for (iroot = 0, rootsize = array_size(_fs_stat_cache_roots); iroot < rootsize; ++iroot) {
+		string_t root = _fs_stat_cache_roots[iroot];
+		if ((length >= root.length) && string_equal(path, root.length, STRING_ARGS(root)) &&
+		        ((length == root.length) || (path[root.length] == '/') ||
+		         (root.length && (root.str[root.length - 1] == '/'))))
+			return true;
+	}
+	return false;
+}
+
+static bool
+_fs_stat(const char* path, size_t length, fs_stat_entry_t* entry) {
+	memset(entry, 0, sizeof(fs_stat_entry_t));
+#if FOUNDATION_PLATFORM_WINDOWS
+	const int64_t ms_offset_time = 116444736000000000LL;
+	WIN32_FILE_ATTRIBUTE_DATA attrib;
+	wchar_t* wpath = wstring_allocate_from_string(path, length);
+	entry->exists = (GetFileAttributesExW(wpath, GetFileExInfoStandard, &attrib) != 0);
+	wstring_deallocate(wpath);
+	if (entry->exists) {
+		tick_t last_write_time = (tick_t)(((uint64_t)attrib.ftLastWriteTime.dwHighDateTime << 32ULL) +
+		                                  (uint64_t)attrib.ftLastWriteTime.dwLowDateTime);
+		if (attrib.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			entry->type = FS_ENTRY_DIRECTORY;
+		else if (attrib.dwFileAttributes & FILE_ATTRIBUTE_DEVICE)
+			entry->type = FS_ENTRY_OTHER;
+		else
+			entry->type = FS_ENTRY_FILE;
+		entry->size = (size_t)(((uint64_t)attrib.nFileSizeHigh << 32ULL) + attrib.nFileSizeLow);
+		entry->last_modified = (last_write_time > ms_offset_time) ?
+		                       ((last_write_time - ms_offset_time) / 10000LL) : 0;
+	}
+	return true;
+#elif FOUNDATION_PLATFORM_POSIX
+	struct stat st;
+	FOUNDATION_UNUSED(length);
+	entry->exists = (stat(path, &st) == 0);
+	if (entry->exists) {
+		if (S_ISREG(st.st_mode))
+			entry->type = FS_ENTRY_FILE;
+		else if (S_ISDIR(st.st_mode))
+			entry->type = FS_ENTRY_DIRECTORY;
+		else
+			entry->type = FS_ENTRY_OTHER;
+		entry->size = (size_t)st.st_size;
+		entry->last_modified = (tick_t)st.st_mtime * 1000LL;
+	}
+	return true;
+#else
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	return false;
+#endif
+}
+
+/*! Query stat cache, filling the cache on a miss. Returns false if the path is not covered
+by a monitor and must be queried directly */
+static bool
+_fs_stat_cache_query(const char* path, size_t length, fs_stat_entry_t* entry) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_const_t fullpath;
+	fs_stat_entry_t* cached;
+	hash_t key;
+	int32_t generation;
+
+	if (!_fs_stat_cache)
+		return false;
+
+	fullpath = _fs_stat_cache_path(buffer, sizeof(buffer), path, length);
+	if (!fullpath.length)
+		return false;
+	key = _fs_stat_cache_key(STRING_ARGS(fullpath));
+	cached = _fs_stat_cache + (key % _foundation_config.fs_stat_cache_size);
+
+	mutex_lock(_fs_stat_cache_lock);
+	if (!_fs_stat_cache_covers(STRING_ARGS(fullpath))) {
+		mutex_unlock(_fs_stat_cache_lock);
+		return false;
+	}
+	if (cached->key == key) {
+		*entry = *cached;
+		mutex_unlock(_fs_stat_cache_lock);
+		return true;
+	}
+	generation = atomic_load32(&_fs_stat_cache_generation);
+	mutex_unlock(_fs_stat_cache_lock);
+
+	if (!_fs_stat(STRING_ARGS(fullpath), entry))
+		return false;
+	entry->key = key;
+
+	mutex_lock(_fs_stat_cache_lock);
+	if (atomic_load32(&_fs_stat_cache_generation) == generation)
+		*cached = *entry;
+	mutex_unlock(_fs_stat_cache_lock);
+
+	return true;
+}
+
+static void
+_fs_stat_cache_invalidate(const char* path, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_const_t fullpath;
+	fs_stat_entry_t* cached;
+	hash_t key;
+
+	if (!_fs_stat_cache)
+		return;
+
+	fullpath = _fs_stat_cache_path(buffer, sizeof(buffer), path, length);
+	key = _fs_stat_cache_key(STRING_ARGS(fullpath));
+	cached = _fs_stat_cache + (key % _foundation_config.fs_stat_cache_size);
+
+	mutex_lock(_fs_stat_cache_lock);
+	atomic_incr32(&_fs_stat_cache_generation);
+	if (cached->key == key)
+		cached->key = 0;
+	mutex_unlock(_fs_stat_cache_lock);
+}
+
+static void
+_fs_stat_cache_flush(void) {
+	if (!_fs_stat_cache)
+		return;
+
+	mutex_lock(_fs_stat_cache_lock);
+	atomic_incr32(&_fs_stat_cache_generation);
+	memset(_fs_stat_cache, 0, sizeof(fs_stat_entry_t) * _foundation_config.fs_stat_cache_size);
+	mutex_unlock(_fs_stat_cache_lock);
+}
+
+#if FOUNDATION_HAVE_FS_MONITOR
+
+static void
+_fs_stat_cache_add_root(string_const_t path) {
+	if (!_fs_stat_cache)
+		return;
+
+	mutex_lock(_fs_stat_cache_lock);
+	array_push(_fs_stat_cache_roots, string_clone(STRING_ARGS(path)));
+	mutex_unlock(_fs_stat_cache_lock);
+}
+
+static void
+_fs_stat_cache_remove_root(string_const_t path) {
+	size_t iroot, rootsize;
+	if (!_fs_stat_cache)
+		return;
+
+	mutex_lock(_fs_stat_cache_lock);
+	for (iroot = 0, rootsize = array_size(_fs_stat_cache_roots); iroot < rootsize; ++iroot) {
+		if (string_equal(STRING_ARGS(_fs_stat_cache_roots[iroot]), STRING_ARGS(path))) {
+			string_deallocate(_fs_stat_cache_roots[iroot].str);
+			array_erase(_fs_stat_cache_roots, iroot);
+			break;
+		}
+	}
+	mutex_unlock(_fs_stat_cache_lock);
+
+	//Entries are no longer invalidated, drop them
+	_fs_stat_cache_flush();
+}
+
+#endif
+
 bool
 fs_is_file(const char* path, size_t length) {
+	fs_stat_entry_t cached;
+	if (_fs_stat_cache_query(path, length, &cached))
+		return cached.exists && (cached.type == FS_ENTRY_FILE);
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 	string_const_t pathstr = _fs_strip_protocol(path, length);
@@ -311,6 +651,10 @@ fs_is_file(const char* path, size_t length) {
 
 bool
 fs_is_directory(const char* path, size_t length) {
+	fs_stat_entry_t cached;
+	if (_fs_stat_cache_query(path, length, &cached))
+		return cached.exists && (cached.type == FS_ENTRY_DIRECTORY);
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 	string_const_t pathstr = _fs_strip_protocol(path, length);
@@ -599,34 +943,202 @@ fs_files(const char* path, size_t length) {
 	return arr;
 }
 
-bool
-fs_remove_file(const char* path, size_t length) {
-	bool result;
-	string_const_t fspath;
-#if FOUNDATION_PLATFORM_WINDOWS
-	wchar_t* wpath;
+//Size of buffer receiving raw directory entries from the kernel, large enough to fetch
+//several hundred entries per call
+#define FS_LISTING_BUFFER_SIZE (64 * 1024)
+
+static void
+_fs_listing_add(fs_entry_t** entries, char** names, const char* name, size_t length,
+                fs_entry_type_t type, size_t size, tick_t last_modified) {
+	fs_entry_t entry;
+	//Name pointers are resolved once all names are stored, names are stored in entry order
+	entry.name.str = 0;
+	entry.name.length = length;
+	entry.type = type;
+	entry.size = (type == FS_ENTRY_FILE) ? size : 0;
+	entry.last_modified = last_modified;
+	array_push_memcpy(*entries, &entry);
+	array_push_range_memcpy(*names, name, length);
+	array_push(*names, 0);
+}
+
+static fs_listing_t*
+_fs_listing_finalize(fs_entry_t* entries, char* names) {
+	size_t count = array_size(entries);
+	size_t names_size = array_size(names);
+	size_t ientry;
+	char* store;
+	fs_listing_t* listing = memory_allocate(HASH_STREAM, sizeof(fs_listing_t) +
+	                                        (sizeof(fs_entry_t) * count) + names_size, 0,
+	                                        MEMORY_PERSISTENT);
+	listing->count = count;
+	store = pointer_offset(listing->entry, sizeof(fs_entry_t) * count);
+	if (count) {
+		memcpy(listing->entry, entries, sizeof(fs_entry_t) * count);
+		memcpy(store, names, names_size);
+	}
+	for (ientry = 0; ientry < count; ++ientry) {
+		listing->entry[ientry].name.str = store;
+		store += listing->entry[ientry].name.length + 1;
+	}
+	array_deallocate(entries);
+	array_deallocate(names);
+	return listing;
+}
+
+#if FOUNDATION_PLATFORM_POSIX
+
+static void
+_fs_listing_add_stat(fs_entry_t** entries, char** names, int fd_dir, const char* name,
+                     size_t length) {
+	struct stat st;
+	fs_entry_type_t type = FS_ENTRY_OTHER;
+	size_t size = 0;
+	tick_t last_modified = 0;
+	//Stat relative to the open directory, avoiding a full path lookup for each entry
+	if (fstatat(fd_dir, name, &st, 0) == 0) {
+		if (S_ISREG(st.st_mode))
+			type = FS_ENTRY_FILE;
+		else if (S_ISDIR(st.st_mode))
+			type = FS_ENTRY_DIRECTORY;
+		size = (size_t)st.st_size;
+		last_modified = (tick_t)st.st_mtime * 1000LL;
+	}
+	_fs_listing_add(entries, names, name, length, type, size, last_modified);
+}
+
 #endif
 
-	fspath = _fs_strip_protocol(path, length);
-	if (!fspath.length)
-		return false;
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 
+struct fs_dirent64_t {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+#endif
+
+fs_listing_t*
+fs_list_directory(const char* path, size_t length) {
+	fs_entry_t* entries = 0;
+	char* names = 0;
 #if FOUNDATION_PLATFORM_WINDOWS
 
-	wpath = wstring_allocate_from_string(fspath.str, fspath.length);
-	result = DeleteFileW(wpath);
-	wstring_deallocate(wpath);
+	const int64_t ms_offset_time = 116444736000000000LL;
+	HANDLE find;
+	WIN32_FIND_DATAW data;
+	wchar_t* wpattern;
+	size_t wsize = length;
+	size_t capacity = length + 4;
+	char namebuffer[BUILD_MAX_PATHLEN * 3];
+
+	wpattern = memory_allocate(0, sizeof(wchar_t) * capacity, 0, MEMORY_TEMPORARY);
+	wstring_from_string(wpattern, capacity, path, length);
+	if (length && (path[length - 1] != '/'))
+		wpattern[wsize++] = L'/';
+	wpattern[wsize++] = L'*';
+	wpattern[wsize] = 0;
+
+	//Skip short name lookup and fetch entries in large batches
+	find = FindFirstFileExW(wpattern, FindExInfoBasic, &data, FindExSearchNameMatch, 0,
+	                        FIND_FIRST_EX_LARGE_FETCH);
+	memory_deallocate(wpattern);
+	if (find == INVALID_HANDLE_VALUE)
+		return 0;
+
+	memory_context_push(HASH_STREAM);
+	do {
+		string_t name;
+		tick_t last_write_time;
+		fs_entry_type_t type;
+		if (data.cFileName[0] == L'.') {
+			if (!data.cFileName[1] || ((data.cFileName[1] == L'.') && !data.cFileName[2]))
+				continue; //Don't include . and .. directories
+		}
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			type = FS_ENTRY_DIRECTORY;
+		else if (data.dwFileAttributes & FILE_ATTRIBUTE_DEVICE)
+			type = FS_ENTRY_OTHER;
+		else
+			type = FS_ENTRY_FILE;
+		last_write_time = (tick_t)(((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32ULL) +
+		                           (uint64_t)data.ftLastWriteTime.dwLowDateTime);
+		name = string_convert_utf16(namebuffer, sizeof(namebuffer),
+		                            (const uint16_t*)data.cFileName,
+		                            wstring_length(data.cFileName));
+		_fs_listing_add(&entries, &names, STRING_ARGS(name), type,
+		                (size_t)(((uint64_t)data.nFileSizeHigh << 32ULL) + data.nFileSizeLow),
+		                (last_write_time > ms_offset_time) ?
+		                ((last_write_time - ms_offset_time) / 10000LL) : 0);
+	}
+	while (FindNextFileW(find, &data));
+	FindClose(find);
+	memory_context_pop();
+
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+	//Read raw entries in large batches and stat each entry relative to the directory
+	char localpath[BUILD_MAX_PATHLEN];
+	string_t cleanpath = string_copy(localpath, sizeof(localpath), path, length);
+	int fd_dir = open(cleanpath.str, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	char* buffer;
+	long fetched;
+	if (fd_dir < 0)
+		return 0;
+
+	memory_context_push(HASH_STREAM);
+	buffer = memory_allocate(0, FS_LISTING_BUFFER_SIZE, 8, MEMORY_TEMPORARY);
+	while ((fetched = syscall(SYS_getdents64, fd_dir, buffer, FS_LISTING_BUFFER_SIZE)) != 0) {
+		long offset = 0;
+		if (fetched < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		while (offset < fetched) {
+			struct fs_dirent64_t* entry = pointer_offset(buffer, offset);
+			offset += entry->d_reclen;
+			if (entry->d_name[0] == '.') {
+				if (!entry->d_name[1] || ((entry->d_name[1] == '.') && !entry->d_name[2]))
+					continue; //Don't include . and .. directories
+			}
+			_fs_listing_add_stat(&entries, &names, fd_dir, entry->d_name,
+			                     string_length(entry->d_name));
+		}
+	}
+	memory_deallocate(buffer);
+	close(fd_dir);
+	memory_context_pop();
 
 #elif FOUNDATION_PLATFORM_POSIX
 
-	char buffer[BUILD_MAX_PATHLEN];
-	string_t finalpath = string_copy(buffer, sizeof(buffer), STRING_ARGS(fspath));
-	result = (unlink(finalpath.str) == 0);
+	char localpath[BUILD_MAX_PATHLEN];
+	string_t cleanpath = string_copy(localpath, sizeof(localpath), path, length);
+	DIR* dir = opendir(cleanpath.str);
+	struct dirent* entry;
+	if (!dir)
+		return 0;
+
+	memory_context_push(HASH_STREAM);
+	while ((entry = readdir(dir)) != 0) {
+		if (entry->d_name[0] == '.') {
+			if (!entry->d_name[1] || ((entry->d_name[1] == '.') && !entry->d_name[2]))
+				continue; //Don't include . and .. directories
+		}
+		_fs_listing_add_stat(&entries, &names, dirfd(dir), entry->d_name,
+		                     string_length(entry->d_name));
+	}
+	closedir(dir);
+	memory_context_pop();
 
 #elif FOUNDATION_PLATFORM_PNACL
 
 	string_const_t localpath;
-	PP_Resource fs = _fs_resolve_path(fspath.str, fspath.length, (string_const_t*)&localpath);
+	string_const_t pathstr = _fs_strip_protocol(path, length);
+	PP_Resource fs = _fs_resolve_path(pathstr.str, pathstr.length, &localpath);
 	if (!fs)
 		return 0;
 
@@ -640,47 +1152,223 @@ fs_remove_file(const char* path, size_t length) {
 	if (!ref)
 		return 0;
 
-	result = (_pnacl_file_ref->Delete(ref, PP_BlockUntilComplete()) == PP_OK);
+	memory_context_push(HASH_STREAM);
+
+	pnacl_array_t pnacl_entries = { 0, 0 };
+	struct PP_ArrayOutput output = { &pnacl_array_output, &pnacl_entries };
+	if (_pnacl_file_ref->ReadDirectoryEntries(ref, output, PP_BlockUntilComplete()) == PP_OK) {
+		struct PP_DirectoryEntry* entry = pnacl_entries.data;
+		for (unsigned int ient = 0; ient < pnacl_entries.count; ++ient, ++entry) {
+			uint32_t varlen = 0;
+			struct PP_FileInfo info;
+			const struct PP_Var namevar = _pnacl_file_ref->GetName(entry->file_ref);
+			const char* utfname = _pnacl_var->VarToUtf8(namevar, &varlen);
+			memset(&info, 0, sizeof(info));
+			_pnacl_file_ref->Query(entry->file_ref, &info, PP_BlockUntilComplete());
+			_fs_listing_add(&entries, &names, utfname, varlen,
+			                (entry->file_type == PP_FILETYPE_REGULAR) ? FS_ENTRY_FILE :
+			                ((entry->file_type == PP_FILETYPE_DIRECTORY) ? FS_ENTRY_DIRECTORY :
+			                 FS_ENTRY_OTHER), (size_t)info.size,
+			                (tick_t)info.last_modified_time * 1000LL);
+		}
+	}
+
+	if (pnacl_entries.data)
+		memory_deallocate(pnacl_entries.data);
+
 	_pnacl_core->ReleaseResource(ref);
 
+	memory_context_pop();
+
 #else
 #  error Not implemented
 #endif
 
-	return result;
+	return _fs_listing_finalize(entries, names);
 }
 
-bool
-fs_remove_directory(const char* path, size_t length) {
-	/*lint --e{438,613,838} Lint gets seriously confused about the arrays here */
-	bool result = false;
-	string_t* subpaths;
-	string_t* subfiles;
-	string_const_t abspath, fspath;
-	string_t localpath = { 0, 0 };
-	char abspath_buffer[BUILD_MAX_PATHLEN];
-	size_t fspathofs;
-	size_t remain;
-#if FOUNDATION_PLATFORM_WINDOWS
-	wchar_t* wfpath = 0;
-#endif
-	size_t i, num;
+void
+fs_listing_deallocate(fs_listing_t* listing) {
+	memory_deallocate(listing);
+}
 
-	localpath = string_copy(abspath_buffer, BUILD_MAX_PATHLEN, path, length);
-	abspath = string_to_const(localpath);
+typedef struct fs_walk_t fs_walk_t;
+typedef struct fs_walk_directory_t fs_walk_directory_t;
 
-	fspath = _fs_strip_protocol(STRING_ARGS(abspath));
-	if (!fs_is_directory(STRING_ARGS(fspath)))
-		goto end;
+struct fs_walk_t {
+	task_scheduler_t* scheduler;
+	task_counter_t counter;
+	regex_t* exclude;
+	fs_walk_fn callback;
+	void* arg;
+	atomic64_t reported;
+};
 
-	fspathofs = (size_t)pointer_diff(fspath.str, abspath_buffer);
-	remain = BUILD_MAX_PATHLEN - fspathofs;
-	subpaths = fs_subdirs(STRING_ARGS(fspath));
-	for (i = 0, num = array_size(subpaths); i < num; ++i) {
-		localpath = path_append(abspath_buffer + fspathofs, fspath.length, remain,
-		                        STRING_ARGS(subpaths[i]));
-		fs_remove_directory(STRING_ARGS(localpath));
-	}
+struct fs_walk_directory_t {
+	fs_walk_t* walk;
+	size_t length;
+	char path[];
+};
+
+static void
+_fs_walk_submit(fs_walk_t* walk, const char* path, size_t length, const char* name,
+                size_t namelen);
+
+static void
+_fs_walk_directory(void* arg) {
+	fs_walk_directory_t* directory = arg;
+	fs_walk_t* walk = directory->walk;
+	string_const_t path = string_const(directory->path, directory->length);
+	fs_listing_t* listing = fs_list_directory(STRING_ARGS(path));
+	size_t ientry;
+	int64_t reported = 0;
+
+	for (ientry = 0; listing && (ientry < listing->count); ++ientry) {
+		const fs_entry_t* entry = listing->entry + ientry;
+		bool descend;
+		if ((entry->type == FS_ENTRY_DIRECTORY) && walk->exclude &&
+		        regex_match(walk->exclude, STRING_ARGS(entry->name), 0, 0))
+			continue;
+		descend = walk->callback(path, entry, walk->arg);
+		++reported;
+		if ((entry->type == FS_ENTRY_DIRECTORY) && descend)
+			_fs_walk_submit(walk, STRING_ARGS(path), STRING_ARGS(entry->name));
+	}
+	atomic_add64(&walk->reported, reported);
+
+	fs_listing_deallocate(listing);
+	memory_deallocate(directory);
+}
+
+static void
+_fs_walk_submit(fs_walk_t* walk, const char* path, size_t length, const char* name,
+                size_t namelen) {
+	size_t capacity = length + namelen + 2;
+	fs_walk_directory_t* directory = memory_allocate(HASH_STREAM,
+	                                                 sizeof(fs_walk_directory_t) + capacity, 0,
+	                                                 MEMORY_PERSISTENT);
+	string_t subpath = string_copy(directory->path, capacity, path, length);
+	if (namelen)
+		subpath = path_append(STRING_ARGS(subpath), capacity, name, namelen);
+	directory->walk = walk;
+	directory->length = subpath.length;
+
+	if (walk->scheduler) {
+		task_t task;
+		task.function = _fs_walk_directory;
+		task.arg = directory;
+		task.name = string_const(STRING_CONST("fs_walk"));
+		task_submit(walk->scheduler, &task, 1, &walk->counter);
+	}
+	else {
+		_fs_walk_directory(directory);
+	}
+}
+
+size_t
+fs_walk(task_scheduler_t* scheduler, const char* path, size_t length, regex_t* exclude,
+        fs_walk_fn callback, void* arg) {
+	fs_walk_t walk;
+	memset(&walk, 0, sizeof(walk));
+	walk.scheduler = scheduler;
+	walk.exclude = exclude;
+	walk.callback = callback;
+	walk.arg = arg;
+
+	if (!callback || !fs_is_directory(path, length))
+		return 0;
+
+	_fs_walk_submit(&walk, path, length, 0, 0);
+	if (scheduler)
+		task_wait(scheduler, &walk.counter);
+
+	return (size_t)atomic_load64(&walk.reported);
+}
+
+bool
+fs_remove_file(const char* path, size_t length) {
+	bool result;
+	string_const_t fspath;
+#if FOUNDATION_PLATFORM_WINDOWS
+	wchar_t* wpath;
+#endif
+
+	fspath = _fs_strip_protocol(path, length);
+	if (!fspath.length)
+		return false;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+
+	wpath = wstring_allocate_from_string(fspath.str, fspath.length);
+	result = DeleteFileW(wpath);
+	wstring_deallocate(wpath);
+
+#elif FOUNDATION_PLATFORM_POSIX
+
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t finalpath = string_copy(buffer, sizeof(buffer), STRING_ARGS(fspath));
+	result = (unlink(finalpath.str) == 0);
+
+#elif FOUNDATION_PLATFORM_PNACL
+
+	string_const_t localpath;
+	PP_Resource fs = _fs_resolve_path(fspath.str, fspath.length, (string_const_t*)&localpath);
+	if (!fs)
+		return 0;
+
+	char buffer[BUILD_MAX_PATHLEN+1];
+	string_t finalpath = string_copy(buffer+1, sizeof(buffer)-1, STRING_ARGS(localpath));
+	if (finalpath.str[0] != '/') {
+		*(--finalpath.str) = '/';
+		finalpath.length++;
+	}
+	PP_Resource ref = _pnacl_file_ref->Create(fs, finalpath.str);
+	if (!ref)
+		return 0;
+
+	result = (_pnacl_file_ref->Delete(ref, PP_BlockUntilComplete()) == PP_OK);
+	_pnacl_core->ReleaseResource(ref);
+
+#else
+#  error Not implemented
+#endif
+
+	_fs_stat_cache_invalidate(STRING_ARGS(fspath));
+
+	return result;
+}
+
+bool
+fs_remove_directory(const char* path, size_t length) {
+	/*lint --e{438,613,838} Lint gets seriously confused about the arrays here */
+	bool result = false;
+	string_t* subpaths;
+	string_t* subfiles;
+	string_const_t abspath, fspath;
+	string_t localpath = { 0, 0 };
+	char abspath_buffer[BUILD_MAX_PATHLEN];
+	size_t fspathofs;
+	size_t remain;
+#if FOUNDATION_PLATFORM_WINDOWS
+	wchar_t* wfpath = 0;
+#endif
+	size_t i, num;
+
+	localpath = string_copy(abspath_buffer, BUILD_MAX_PATHLEN, path, length);
+	abspath = string_to_const(localpath);
+
+	fspath = _fs_strip_protocol(STRING_ARGS(abspath));
+	if (!fs_is_directory(STRING_ARGS(fspath)))
+		goto end;
+
+	fspathofs = (size_t)pointer_diff(fspath.str, abspath_buffer);
+	remain = BUILD_MAX_PATHLEN - fspathofs;
+	subpaths = fs_subdirs(STRING_ARGS(fspath));
+	for (i = 0, num = array_size(subpaths); i < num; ++i) {
+		localpath = path_append(abspath_buffer + fspathofs, fspath.length, remain,
+		                        STRING_ARGS(subpaths[i]));
+		fs_remove_directory(STRING_ARGS(localpath));
+	}
 	string_array_deallocate(subpaths);
 
 	subfiles = fs_files(STRING_ARGS(fspath));
@@ -726,6 +1414,8 @@ fs_remove_directory(const char* path, size_t length) {
 #  error Not implemented
 #endif
 
+	_fs_stat_cache_invalidate(STRING_ARGS(fspath));
+
 end:
 
 	return result;
@@ -803,6 +1493,7 @@ fs_make_directory(const char* path, size_t length) {
 				          STRING_FORMAT(localpath), STRING_FORMAT(errmsg), err);
 				goto end;
 			}
+			_fs_stat_cache_invalidate(STRING_ARGS(localpath));
 		}
 		else {
 			result = true;
@@ -827,40 +1518,113 @@ bool
 fs_copy_file(const char* source, size_t srclen, const char* dest, size_t destlen) {
 	stream_t* infile;
 	stream_t* outfile;
-	void* buffer;
 	string_const_t destpath;
 
-	infile = fs_open_file(source, srclen, STREAM_IN | STREAM_BINARY);
-	if (!infile)
+	if (!fs_is_file(source, srclen))
 		return false;
 
 	destpath = path_directory_name(dest, destlen);
 	if (destpath.length)
 		fs_make_directory(STRING_ARGS(destpath));
 
+#if FOUNDATION_PLATFORM_WINDOWS
+	{
+		//Copy in the kernel, overwriting any existing destination
+		string_const_t srcpath = _fs_strip_protocol(source, srclen);
+		string_const_t dstpath = _fs_strip_protocol(dest, destlen);
+		wchar_t* wsource = wstring_allocate_from_string(STRING_ARGS(srcpath));
+		wchar_t* wdest = wstring_allocate_from_string(STRING_ARGS(dstpath));
+		BOOL copied = CopyFileExW(wsource, wdest, 0, 0, 0, 0);
+		wstring_deallocate(wsource);
+		wstring_deallocate(wdest);
+		if (copied) {
+			_fs_stat_cache_invalidate(dest, destlen);
+			return true;
+		}
+	}
+#elif FOUNDATION_PLATFORM_APPLE
+	{
+		//Clone on copy-on-write file systems, fails if destination exists
+		char srcbuffer[BUILD_MAX_PATHLEN];
+		char destbuffer[BUILD_MAX_PATHLEN];
+		string_const_t srcpath = _fs_strip_protocol(source, srclen);
+		string_const_t dstpath = _fs_strip_protocol(dest, destlen);
+		string_t srcfinal = string_copy(srcbuffer, sizeof(srcbuffer), STRING_ARGS(srcpath));
+		string_t destfinal = string_copy(destbuffer, sizeof(destbuffer), STRING_ARGS(dstpath));
+		if (clonefile(srcfinal.str, destfinal.str, 0) == 0) {
+			_fs_stat_cache_invalidate(dest, destlen);
+			return true;
+		}
+	}
+#endif
+
+	infile = fs_open_file(source, srclen, STREAM_IN | STREAM_BINARY);
+	if (!infile)
+		return false;
+
 	outfile = fs_open_file(dest, destlen, STREAM_OUT | STREAM_BINARY | STREAM_CREATE | STREAM_TRUNCATE);
 	if (!outfile) {
 		stream_deallocate(infile);
 		return false;
 	}
 
-	buffer = memory_allocate(0, 64 * 1024, 0, MEMORY_TEMPORARY);
-
-	while (!stream_eos(infile)) {
-		size_t numread = stream_read(infile, buffer, 64 * 1024);
-		if (numread > 0)
-			stream_write(outfile, buffer, numread);
-	}
+#if FOUNDATION_PLATFORM_APPLE
+	//Copy file data in the kernel
+	if (fcopyfile(fileno(GET_FILE(infile)->fd), fileno(GET_FILE(outfile)->fd), 0,
+	              COPYFILE_DATA) != 0)
+		stream_copy(outfile, infile, 0);
+#else
+	stream_copy(outfile, infile, 0);
+#endif
 
-	memory_deallocate(buffer);
 	stream_deallocate(infile);
 	stream_deallocate(outfile);
 
 	return true;
 }
 
+bool
+fs_move_file(const char* source, size_t srclen, const char* dest, size_t destlen) {
+	bool result = false;
+	string_const_t srcpath = _fs_strip_protocol(source, srclen);
+	string_const_t destpath = _fs_strip_protocol(dest, destlen);
+	if (!srcpath.length || !destpath.length)
+		return false;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+
+	wchar_t* wsrcpath = wstring_allocate_from_string(STRING_ARGS(srcpath));
+	wchar_t* wdestpath = wstring_allocate_from_string(STRING_ARGS(destpath));
+	result = (MoveFileExW(wsrcpath, wdestpath, MOVEFILE_REPLACE_EXISTING) != 0);
+	wstring_deallocate(wsrcpath);
+	wstring_deallocate(wdestpath);
+
+#elif FOUNDATION_PLATFORM_POSIX
+
+	char srcbuffer[BUILD_MAX_PATHLEN];
+	char destbuffer[BUILD_MAX_PATHLEN];
+	string_t srcfinal = string_copy(srcbuffer, sizeof(srcbuffer), STRING_ARGS(srcpath));
+	string_t destfinal = string_copy(destbuffer, sizeof(destbuffer), STRING_ARGS(destpath));
+	result = (rename(srcfinal.str, destfinal.str) == 0);
+
+#endif
+
+	//Fall back to copy and remove, for example when moving across file systems
+	if (!result && fs_copy_file(source, srclen, dest, destlen))
+		result = fs_remove_file(source, srclen);
+
+	_fs_stat_cache_invalidate(STRING_ARGS(srcpath));
+	_fs_stat_cache_invalidate(STRING_ARGS(destpath));
+
+	return result;
+}
+
 tick_t
 fs_last_modified(const char* path, size_t length) {
+	fs_stat_entry_t cached;
+	if (_fs_stat_cache_query(path, length, &cached))
+		return cached.exists ? cached.last_modified : 0;
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 	//This is retarded beyond belief, Microsoft decided that "100-nanosecond intervals since 1 Jan 1601" was
@@ -945,7 +1709,12 @@ fs_last_modified(const char* path, size_t length) {
 size_t
 fs_size(const char* path, size_t length) {
 	size_t size = 0;
-	stream_t* file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
+	stream_t* file;
+	fs_stat_entry_t cached;
+	if (_fs_stat_cache_query(path, length, &cached))
+		return (cached.exists && (cached.type == FS_ENTRY_FILE)) ? cached.size : 0;
+
+	file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
 	if (file) {
 		size = stream_size(file);
 		stream_deallocate(file);
@@ -956,7 +1725,26 @@ fs_size(const char* path, size_t length) {
 uint128_t
 fs_md5(const char* path, size_t length) {
 	uint128_t digest = uint128_null();
-	stream_t* file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
+	stream_t* file;
+	const void* data;
+	size_t size = 0;
+	md5_t md5;
+
+	//Digest mapped content in a single pass, avoiding buffered reads
+	file = fs_map_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (file) {
+		data = fs_mapped_data(file, &size);
+		md5_initialize(&md5);
+		if (data)
+			md5_digest(&md5, data, size);
+		md5_digest_finalize(&md5);
+		digest = md5_get_digest_raw(&md5);
+		md5_finalize(&md5);
+		stream_deallocate(file);
+		return digest;
+	}
+
+	file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
 	if (file) {
 		digest = stream_md5(file);
 		stream_deallocate(file);
@@ -964,6 +1752,226 @@ fs_md5(const char* path, size_t length) {
 	return digest;
 }
 
+uint256_t
+fs_sha256(const char* path, size_t length) {
+	uint256_t digest = uint256_null();
+	stream_t* file;
+	const void* data;
+	size_t size = 0;
+	sha256_t sha256;
+
+	file = fs_map_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (file) {
+		data = fs_mapped_data(file, &size);
+		sha256_initialize(&sha256);
+		if (data)
+			sha256_digest(&sha256, data, size);
+		sha256_digest_finalize(&sha256);
+		digest = sha256_get_digest_raw(&sha256);
+		sha256_finalize(&sha256);
+		stream_deallocate(file);
+		return digest;
+	}
+
+	file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (file) {
+		digest = stream_sha256(file);
+		stream_deallocate(file);
+	}
+	return digest;
+}
+
+//Number of files mapped at once and digested in parallel lanes by a single task
+#define FS_MD5_BATCH_SIZE 64
+
+struct fs_md5_batch_t {
+	const string_const_t* paths;
+	uint128_t*            digests;
+};
+
+typedef struct fs_md5_batch_t fs_md5_batch_t;
+
+static void
+_fs_md5_files(size_t begin, size_t end, void* arg) {
+	fs_md5_batch_t* batch = arg;
+	stream_t* file[FS_MD5_BATCH_SIZE];
+	const void* data[FS_MD5_BATCH_SIZE];
+	size_t size[FS_MD5_BATCH_SIZE];
+	size_t index[FS_MD5_BATCH_SIZE];
+	uint128_t digest[FS_MD5_BATCH_SIZE];
+	size_t ifile, mapped;
+
+	while (begin < end) {
+		mapped = 0;
+		for (; (begin < end) && (mapped < FS_MD5_BATCH_SIZE); ++begin) {
+			stream_t* stream = fs_map_file(STRING_ARGS(batch->paths[begin]),
+			                               STREAM_IN | STREAM_BINARY);
+			if (!stream) {
+				//Not mappable, digest with buffered reads
+				batch->digests[begin] = fs_md5(STRING_ARGS(batch->paths[begin]));
+				continue;
+			}
+			size[mapped] = 0;
+			data[mapped] = fs_mapped_data(stream, size + mapped);
+			if (!data[mapped])
+				size[mapped] = 0;
+			file[mapped] = stream;
+			index[mapped++] = begin;
+		}
+
+		md5_digest_multi(data, size, mapped, digest);
+		for (ifile = 0; ifile < mapped; ++ifile) {
+			batch->digests[index[ifile]] = digest[ifile];
+			stream_deallocate(file[ifile]);
+		}
+	}
+}
+
+void
+fs_md5_files(task_scheduler_t* scheduler, const string_const_t* paths, size_t count,
+             uint128_t* digests) {
+	fs_md5_batch_t batch;
+	batch.paths = paths;
+	batch.digests = digests;
+	if (scheduler && (count > FS_MD5_BATCH_SIZE))
+		task_parallel_for(scheduler, 0, count, FS_MD5_BATCH_SIZE, _fs_md5_files, &batch);
+	else
+		_fs_md5_files(0, count, &batch);
+}
+
+#define FS_CHECKSUM_CHUNK_SIZE (1024 * 1024)
+
+struct fs_checksum_tree_t {
+	checksum_type_t type;
+	const uint8_t*  data;
+	size_t          size;
+	uint64_t*       leaf;
+};
+
+typedef struct fs_checksum_tree_t fs_checksum_tree_t;
+
+struct fs_checksum_batch_t {
+	checksum_type_t       type;
+	const string_const_t* paths;
+	uint64_t*             checksums;
+};
+
+typedef struct fs_checksum_batch_t fs_checksum_batch_t;
+
+static void
+_fs_checksum_leaves(size_t begin, size_t end, void* arg) {
+	fs_checksum_tree_t* tree = arg;
+	for (; begin < end; ++begin) {
+		size_t offset = begin * FS_CHECKSUM_CHUNK_SIZE;
+		size_t size = tree->size - offset;
+		if (size > FS_CHECKSUM_CHUNK_SIZE)
+			size = FS_CHECKSUM_CHUNK_SIZE;
+		tree->leaf[begin] = checksum(tree->type, tree->data + offset, size);
+	}
+}
+
+static uint64_t
+_fs_checksum_root(checksum_type_t type, uint64_t* leaf, size_t count) {
+	size_t ileaf;
+	if (count == 1)
+		return leaf[0];
+	for (ileaf = 0; ileaf < count; ++ileaf)
+		leaf[ileaf] = byteorder_littleendian64(leaf[ileaf]);
+	return checksum(type, leaf, sizeof(uint64_t) * count);
+}
+
+static uint64_t
+_fs_checksum_mapped(task_scheduler_t* scheduler, stream_t* file, checksum_type_t type) {
+	fs_checksum_tree_t tree;
+	uint64_t root;
+	size_t count;
+
+	tree.type = type;
+	tree.data = fs_mapped_data(file, &tree.size);
+	if (!tree.data)
+		return checksum(type, 0, 0);
+
+	count = (tree.size + FS_CHECKSUM_CHUNK_SIZE - 1) / FS_CHECKSUM_CHUNK_SIZE;
+	tree.leaf = memory_allocate(0, sizeof(uint64_t) * count, 0, MEMORY_TEMPORARY);
+	if (scheduler && (count > 1)) {
+		//Chunks are touched out of order by the workers
+		fs_map_advise(file, FS_MAP_ADVICE_WILLNEED);
+		task_parallel_for(scheduler, 0, count, 1, _fs_checksum_leaves, &tree);
+	}
+	else {
+		fs_map_advise(file, FS_MAP_ADVICE_SEQUENTIAL);
+		_fs_checksum_leaves(0, count, &tree);
+	}
+	root = _fs_checksum_root(type, tree.leaf, count);
+	memory_deallocate(tree.leaf);
+
+	return root;
+}
+
+static uint64_t
+_fs_checksum_stream(stream_t* file, checksum_type_t type) {
+	uint64_t* leaf = 0;
+	uint64_t root;
+	void* buffer;
+	size_t size, num;
+
+	buffer = memory_allocate(0, FS_CHECKSUM_CHUNK_SIZE, 4096, MEMORY_PERSISTENT);
+	do {
+		for (size = 0; (size < FS_CHECKSUM_CHUNK_SIZE) && !stream_eos(file); size += num) {
+			num = stream_read(file, pointer_offset(buffer, size), FS_CHECKSUM_CHUNK_SIZE - size);
+			if (!num)
+				break;
+		}
+		if (size || !leaf)
+			array_push(leaf, checksum(type, buffer, size));
+	}
+	while (size == FS_CHECKSUM_CHUNK_SIZE);
+	memory_deallocate(buffer);
+
+	root = _fs_checksum_root(type, leaf, array_size(leaf));
+	array_deallocate(leaf);
+
+	return root;
+}
+
+uint64_t
+fs_checksum(task_scheduler_t* scheduler, const char* path, size_t length, checksum_type_t type) {
+	uint64_t root = 0;
+	stream_t* file = fs_map_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (file) {
+		root = _fs_checksum_mapped(scheduler, file, type);
+		stream_deallocate(file);
+		return root;
+	}
+
+	file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (file) {
+		root = _fs_checksum_stream(file, type);
+		stream_deallocate(file);
+	}
+	return root;
+}
+
+static void
+_fs_checksum_files(size_t begin, size_t end, void* arg) {
+	fs_checksum_batch_t* batch = arg;
+	for (; begin < end; ++begin)
+		batch->checksums[begin] = fs_checksum(0, STRING_ARGS(batch->paths[begin]), batch->type);
+}
+
+void
+fs_checksum_files(task_scheduler_t* scheduler, const string_const_t* paths, size_t count,
+                  checksum_type_t type, uint64_t* checksums) {
+	fs_checksum_batch_t batch;
+	batch.type = type;
+	batch.paths = paths;
+	batch.checksums = checksums;
+	if (scheduler && (count > 1))
+		task_parallel_for(scheduler, 0, count, 1, _fs_checksum_files, &batch);
+	else
+		_fs_checksum_files(0, count, &batch);
+}
+
 void
 fs_touch(const char* path, size_t length) {
 #if FOUNDATION_PLATFORM_WINDOWS
@@ -1003,6 +2011,8 @@ fs_touch(const char* path, size_t length) {
 #else
 #  error Not implemented
 #endif
+
+	_fs_stat_cache_invalidate(path, length);
 }
 
 stream_t*
@@ -1016,25 +2026,109 @@ fs_temporary_file(void) {
 	                    STREAM_IN | STREAM_OUT | STREAM_BINARY | STREAM_CREATE | STREAM_TRUNCATE);
 }
 
-string_t*
-fs_matching_files_regex(const char* path, size_t length, regex_t* pattern, bool recurse) {
-	string_t* names = 0;
-	string_t* subdirs;
-	string_t localpath;
-	size_t id, dsize, in, nsize, capacity;
-
-#if FOUNDATION_PLATFORM_WINDOWS
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+#  ifndef MFD_CLOEXEC
+#    define MFD_CLOEXEC 0x0001U
+#  endif
+#endif
 
-	//Windows specific implementation of directory listing
-	WIN32_FIND_DATAW data;
-	char filename[BUILD_MAX_PATHLEN];
-	wchar_t* wpattern;
-	size_t wsize = length;
-	capacity = length + 4;
+stream_t*
+fs_temporary_file_anonymous(void) {
+#if FOUNDATION_PLATFORM_PNACL
+	return fs_temporary_file();
+#else
+	char buf[BUILD_MAX_PATHLEN];
+	string_t filename = path_make_temporary(buf, BUILD_MAX_PATHLEN);
+	string_const_t directory = path_directory_name(filename.str, filename.length);
+	stream_file_t* file;
+	stream_t* stream;
+	fs_file_descriptor fd = 0;
 
-	memory_context_push(HASH_STREAM);
+	fs_make_directory(directory.str, directory.length);
 
-	wpattern = memory_allocate(0, sizeof(wchar_t) * capacity, 0, MEMORY_TEMPORARY);
+#if FOUNDATION_PLATFORM_WINDOWS
+	//Temporary attribute keeps data in the file cache unless under memory pressure, and
+	//the file is deleted by the system when the last handle is closed
+	wchar_t* wpath = wstring_allocate_from_string(STRING_ARGS(filename));
+	HANDLE handle = CreateFileW(wpath, GENERIC_READ | GENERIC_WRITE,
+	                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0, CREATE_NEW,
+	                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, 0);
+	wstring_deallocate(wpath);
+	if (handle != INVALID_HANDLE_VALUE) {
+		int osfd = _open_osfhandle((intptr_t)handle, _O_RDWR | _O_BINARY);
+		if (osfd >= 0) {
+			fd = _fdopen(osfd, "w+b");
+			if (!fd)
+				_close(osfd);
+		}
+		else {
+			CloseHandle(handle);
+		}
+	}
+#else
+	int osfd = -1;
+#if (FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID) && defined(__NR_memfd_create)
+	//Memory file backed by anonymous memory, swapped out only under memory pressure
+	osfd = (int)syscall(__NR_memfd_create, "foundation_temporary", MFD_CLOEXEC);
+#endif
+#if defined(O_TMPFILE)
+	//Unnamed file in the temporary directory, never linked into the file system
+	if (osfd < 0)
+		osfd = open(directory.str, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+#endif
+	if (osfd < 0) {
+		//Named file unlinked directly after creation
+		osfd = open(filename.str, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+		if (osfd >= 0)
+			unlink(filename.str);
+	}
+	if (osfd >= 0) {
+		fd = fdopen(osfd, "w+b");
+		if (!fd)
+			close(osfd);
+	}
+#endif
+
+	if (!fd) {
+		log_warn(0, WARNING_SYSTEM_CALL_FAIL,
+		         STRING_CONST("Unable to create anonymous temporary file, using named file"));
+		return fs_temporary_file();
+	}
+
+	file = memory_allocate(HASH_STREAM, sizeof(stream_file_t), 8,
+	                       MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream = GET_STREAM(file);
+	stream_initialize(stream, BUILD_DEFAULT_STREAM_BYTEORDER);
+
+	file->fd        = fd;
+	file->anonymous = true;
+	file->type      = STREAMTYPE_FILE;
+	file->mode      = STREAM_IN | STREAM_OUT | STREAM_BINARY;
+	file->vtable    = &_fs_file_vtable;
+
+	return stream;
+#endif
+}
+
+string_t*
+fs_matching_files_regex(const char* path, size_t length, regex_t* pattern, bool recurse) {
+	string_t* names = 0;
+	string_t* subdirs;
+	string_t localpath;
+	size_t id, dsize, in, nsize, capacity;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+
+	//Windows specific implementation of directory listing
+	WIN32_FIND_DATAW data;
+	char filename[BUILD_MAX_PATHLEN];
+	wchar_t* wpattern;
+	size_t wsize = length;
+	capacity = length + 4;
+
+	memory_context_push(HASH_STREAM);
+
+	wpattern = memory_allocate(0, sizeof(wchar_t) * capacity, 0, MEMORY_TEMPORARY);
 	wstring_from_string(wpattern, capacity, path, length);
 	if (length && (path[length - 1] != '/'))
 		wpattern[wsize++] = L'/';
@@ -1114,14 +2208,15 @@ fs_matching_files_regex(const char* path, size_t length, regex_t* pattern, bool
 string_t*
 fs_matching_files(const char* path, size_t length, const char* pattern,
                   size_t pattern_length, bool recurse) {
-	regex_t* regex = regex_compile(pattern, pattern_length);
+	regex_t* regex = regex_cache_acquire(pattern, pattern_length);
 	string_t* names = fs_matching_files_regex(path, length, regex, recurse);
-	regex_deallocate(regex);
+	regex_cache_release(regex);
 	return names;
 }
 
 void
 fs_post_event(foundation_event_id id, const char* path, size_t pathlen) {
+	_fs_stat_cache_invalidate(path, pathlen);
 	event_post_varg(fs_event_stream(), id, 0, 0, &pathlen, sizeof(pathlen), path, pathlen, nullptr);
 }
 
@@ -1138,6 +2233,25 @@ struct fs_watch_t {
 
 typedef struct fs_watch_t fs_watch_t;
 
+struct fs_pending_t {
+	tick_t deadline;
+	hash_t key;
+	size_t length;
+	bool   discarded;
+	char   path[];
+};
+
+typedef struct fs_pending_t fs_pending_t;
+
+struct fs_coalesce_t {
+	tick_t         window;
+	hashmap_t*     map;
+	fs_pending_t** queue;
+	size_t         head;
+};
+
+typedef struct fs_coalesce_t fs_coalesce_t;
+
 static void
 _fs_send_creations(char* path, size_t length, size_t capacity) {
 	size_t ifile, isub, fsize, subsize;
@@ -1159,11 +2273,12 @@ _fs_send_creations(char* path, size_t length, size_t capacity) {
 
 static void
 _fs_add_notify_subdir(int notify_fd, char* path, size_t length, size_t capacity,
-                      fs_watch_t** watch_arr, string_t** path_arr, bool send_create) {
+                      hashmap_t* watches, bool send_create) {
 	string_t* subdirs = 0;
 	string_t local_path;
-	string_t stored_path;
-	int fd = inotify_add_watch(notify_fd, path, IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVE);
+	fs_watch_t* watch;
+	int fd = inotify_add_watch(notify_fd, path, IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVE |
+	                           IN_ATTRIB);
 	if (fd < 0) {
 		log_warnf(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Failed watching subdir: %.*s (%d)"),
 		          (int)length, path, fd);
@@ -1173,33 +2288,127 @@ _fs_add_notify_subdir(int notify_fd, char* path, size_t length, size_t capacity,
 	if (send_create)
 		_fs_send_creations(path, length, capacity);
 
-	//Include terminating / in paths stored in path_arr/watch_arr
+	//Include terminating / in paths stored in watches, a directory moved back into the tree
+	//keeps its watch descriptor so replace any previous mapping
 	local_path = string_append(path, length, capacity, STRING_CONST("/"));
-	stored_path = string_clone(STRING_ARGS(local_path));
-	array_push((*path_arr), stored_path);
-
-	fs_watch_t watch;
-	watch.fd = fd;
-	watch.path = stored_path;
-	array_push((*watch_arr), watch);
+	watch = memory_allocate(HASH_STREAM, sizeof(fs_watch_t), 0, MEMORY_PERSISTENT);
+	watch->fd = fd;
+	watch->path = string_clone(STRING_ARGS(local_path));
+	watch = hashmap_insert(watches, (hash_t)fd, watch);
+	if (watch) {
+		string_deallocate(watch->path.str);
+		memory_deallocate(watch);
+	}
 
 	//Recurse
 	subdirs = fs_subdirs(STRING_ARGS(local_path));
 	for (size_t i = 0, size = array_size(subdirs); i < size; ++i) {
 		string_t subpath = string_append(STRING_ARGS(local_path), capacity, STRING_ARGS(subdirs[i]));
-		_fs_add_notify_subdir(notify_fd, STRING_ARGS(subpath), capacity, watch_arr, path_arr, send_create);
+		_fs_add_notify_subdir(notify_fd, STRING_ARGS(subpath), capacity, watches, send_create);
 	}
 	string_array_deallocate(subdirs);
 }
 
-static fs_watch_t*
-_fs_lookup_watch(fs_watch_t* watch_arr, int fd) {
-	//TODO: If array is kept sorted on fd, this could be made faster
-	for (size_t i = 0, size = array_size(watch_arr); i < size; ++i) {
-		if (watch_arr[i].fd == fd)
-			return watch_arr + i;
+static void
+_fs_remove_notify_watch(hashmap_t* watches, int fd) {
+	fs_watch_t* watch = hashmap_erase(watches, (hash_t)fd);
+	if (watch) {
+		string_deallocate(watch->path.str);
+		memory_deallocate(watch);
 	}
-	return 0;
+}
+
+static void
+_fs_clear_notify_watches(hashmap_t* watches) {
+	hashmap_node_t* node = 0;
+	while ((node = hashmap_next(watches, node))) {
+		fs_watch_t* watch = node->value;
+		string_deallocate(watch->path.str);
+		memory_deallocate(watch);
+	}
+	hashmap_clear(watches);
+}
+
+static void
+_fs_coalesce_modify(fs_coalesce_t* coalesce, const char* path, size_t length) {
+	hash_t key;
+	fs_pending_t* pending;
+
+	if (!coalesce->map) {
+		fs_post_event(FOUNDATIONEVENT_FILE_MODIFIED, path, length);
+		return;
+	}
+
+	//Cached stat results are stale even while the event is held back
+	_fs_stat_cache_invalidate(path, length);
+
+	key = hash(path, length);
+	pending = hashmap_lookup(coalesce->map, key);
+	if (pending) {
+		if (!string_equal(pending->path, pending->length, path, length))
+			fs_post_event(FOUNDATIONEVENT_FILE_MODIFIED, path, length);
+		return;
+	}
+
+	//Queue is ordered on deadline since all entries use the same window
+	pending = memory_allocate(HASH_STREAM, sizeof(fs_pending_t) + length + 1, 0, MEMORY_PERSISTENT);
+	pending->deadline = time_current() + coalesce->window;
+	pending->key = key;
+	pending->length = length;
+	pending->discarded = false;
+	memcpy(pending->path, path, length);
+	pending->path[length] = 0;
+	hashmap_insert(coalesce->map, key, pending);
+	array_push(coalesce->queue, pending);
+}
+
+static void
+_fs_coalesce_discard(fs_coalesce_t* coalesce, const char* path, size_t length) {
+	fs_pending_t* pending;
+	hash_t key;
+
+	if (!coalesce->map)
+		return;
+
+	//Entry is freed when reaching the front of the queue
+	key = hash(path, length);
+	pending = hashmap_lookup(coalesce->map, key);
+	if (pending && string_equal(pending->path, pending->length, path, length)) {
+		hashmap_erase(coalesce->map, key);
+		pending->discarded = true;
+	}
+}
+
+static unsigned int
+_fs_coalesce_flush(fs_coalesce_t* coalesce, bool all) {
+	size_t size = array_size(coalesce->queue);
+	tick_t now = time_current();
+
+	while (coalesce->head < size) {
+		fs_pending_t* pending = coalesce->queue[coalesce->head];
+		if (!all && !pending->discarded && (pending->deadline > now))
+			break;
+		if (!pending->discarded) {
+			hashmap_erase(coalesce->map, pending->key);
+			fs_post_event(FOUNDATIONEVENT_FILE_MODIFIED, pending->path, pending->length);
+		}
+		memory_deallocate(pending);
+		++coalesce->head;
+	}
+
+	if (coalesce->head == size) {
+		array_clear(coalesce->queue);
+		coalesce->head = 0;
+		return 0;
+	}
+	if (coalesce->head > (size / 2)) {
+		array_erase_ordered_range(coalesce->queue, 0, coalesce->head);
+		coalesce->head = 0;
+	}
+
+	//Milliseconds until next deadline, rounded up
+	return (unsigned int)(((coalesce->queue[coalesce->head]->deadline - now) * 1000) /
+	                      time_ticks_per_second()) + 1;
 }
 
 #elif FOUNDATION_PLATFORM_MACOSX
@@ -1255,18 +2464,24 @@ _fs_monitor(void* monitorptr) {
 	char pathbuffer[BUILD_MAX_PATHLEN];
 	string_t local_path;
 	int notify_fd = inotify_init();
-	fs_watch_t* watch = 0;
-	string_t* paths = 0;
+	hashmap_t* watches;
+	fs_coalesce_t coalesce;
 	beacon_t* beacon = &thread_self()->beacon;
 
 	memory_context_push(HASH_STREAM);
 
-	array_reserve(watch, 1024);
+	watches = hashmap_allocate(128, 8);
+
+	memset(&coalesce, 0, sizeof(coalesce));
+	if (_foundation_config.fs_monitor_coalesce) {
+		coalesce.window = (time_ticks_per_second() *
+		                   (tick_t)_foundation_config.fs_monitor_coalesce) / 1000;
+		coalesce.map = hashmap_allocate(13, 8);
+	}
 
 	//Recurse and add all subdirs
 	local_path = string_copy(pathbuffer, sizeof(pathbuffer), STRING_ARGS(monitor->path));
-	_fs_add_notify_subdir(notify_fd, STRING_ARGS(local_path), sizeof(pathbuffer), &watch, &paths,
-	                      false);
+	_fs_add_notify_subdir(notify_fd, STRING_ARGS(local_path), sizeof(pathbuffer), watches, false);
 
 	beacon_add(beacon, notify_fd);
 
@@ -1304,6 +2519,9 @@ _fs_monitor(void* monitorptr) {
 	overlap.hEvent = handle;
 #endif
 
+	//Changes below the monitored path are now notified, stat results can be cached
+	_fs_stat_cache_add_root(string_to_const(monitor->path));
+
 	while (keep_running) {
 #if FOUNDATION_PLATFORM_WINDOWS
 		DWORD transferred;
@@ -1365,8 +2583,11 @@ _fs_monitor(void* monitorptr) {
 							if (fs_is_file(STRING_ARGS(fullpath)))
 								fsevent = FOUNDATIONEVENT_FILE_MODIFIED; break;
 
-						//Treat rename as delete/add pair
-						case FILE_ACTION_RENAMED_OLD_NAME: fsevent = FOUNDATIONEVENT_FILE_DELETED; break;
+						//Treat rename as delete/add pair, old name might be a directory
+						case FILE_ACTION_RENAMED_OLD_NAME:
+							fsevent = FOUNDATIONEVENT_FILE_DELETED;
+							_fs_stat_cache_flush();
+							break;
 						case FILE_ACTION_RENAMED_NEW_NAME: fsevent = FOUNDATIONEVENT_FILE_CREATED; break;
 
 						default: break;
@@ -1389,9 +2610,11 @@ _fs_monitor(void* monitorptr) {
 #elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 
 		int avail = 0;
-		if (beacon_wait(beacon) == 0)
+		unsigned int timeout = coalesce.map ? _fs_coalesce_flush(&coalesce, false) : 0;
+		int wait_status = timeout ? beacon_try_wait(beacon, timeout) : beacon_wait(beacon);
+		if (wait_status == 0)
 			keep_running = false;
-		else
+		else if (wait_status > 0)
 			ioctl(notify_fd, FIONREAD, &avail);
 		if (avail > 0) {
 			void* buffer = memory_allocate(HASH_STREAM, (size_t)avail + 4, 8,
@@ -1400,7 +2623,12 @@ _fs_monitor(void* monitorptr) {
 			ssize_t avail_read = read(notify_fd, buffer, (size_t)avail);
 			struct inotify_event* event = (struct inotify_event*)buffer;
 			while (offset < avail_read) {
-				fs_watch_t* curwatch = _fs_lookup_watch(watch, event->wd);
+				fs_watch_t* curwatch = hashmap_lookup(watches, (hash_t)event->wd);
+				if (event->mask & IN_IGNORED) {
+					//Watched directory removed or moved out of the tree
+					_fs_remove_notify_watch(watches, event->wd);
+					goto skipwatch;
+				}
 				if (!curwatch) {
 					log_warnf(0, WARNING_SUSPICIOUS,
 					          STRING_CONST("inotify watch not found: %d %x %x %" PRIsize " bytes: %.*s"),
@@ -1417,18 +2645,24 @@ _fs_monitor(void* monitorptr) {
 
 				if ((event->mask & IN_CREATE) || (event->mask & IN_MOVED_TO)) {
 					if (is_dir)
-						_fs_add_notify_subdir(notify_fd, STRING_ARGS(curpath), sizeof(pathbuffer), &watch, &paths, true);
+						_fs_add_notify_subdir(notify_fd, STRING_ARGS(curpath), sizeof(pathbuffer), watches, true);
 					else
 						fs_post_event(FOUNDATIONEVENT_FILE_CREATED, STRING_ARGS(curpath));
 				}
 				if ((event->mask & IN_DELETE) || (event->mask & IN_MOVED_FROM)) {
-					if (!is_dir)
+					if (!is_dir) {
+						_fs_coalesce_discard(&coalesce, STRING_ARGS(curpath));
 						fs_post_event(FOUNDATIONEVENT_FILE_DELETED, STRING_ARGS(curpath));
+					}
+					else
+						_fs_stat_cache_flush(); //Cached entries below directory are stale
 				}
 				if (event->mask & IN_MODIFY) {
 					if (!is_dir)
-						fs_post_event(FOUNDATIONEVENT_FILE_MODIFIED, STRING_ARGS(curpath));
+						_fs_coalesce_modify(&coalesce, STRING_ARGS(curpath));
 				}
+				if ((event->mask & IN_ATTRIB) || (is_dir && (event->mask & (IN_CREATE | IN_MOVED_TO))))
+					_fs_stat_cache_invalidate(STRING_ARGS(curpath));
 				/* Moved events are also notified as CREATE/DELETE with cookies, so ignore for now
 				if (event->mask & IN_MOVED_FROM)
 				if (event->mask & IN_MOVED_TO)*/
@@ -1477,8 +2711,13 @@ exit_thread:
 #elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 
 	close(notify_fd);
-	string_array_deallocate(paths);
-	array_deallocate(watch);
+	_fs_clear_notify_watches(watches);
+	hashmap_deallocate(watches);
+	if (coalesce.map) {
+		_fs_coalesce_flush(&coalesce, true);
+		hashmap_deallocate(coalesce.map);
+		array_deallocate(coalesce.queue);
+	}
 
 #elif FOUNDATION_PLATFORM_MACOSX
 
@@ -1486,6 +2725,8 @@ exit_thread:
 
 #endif
 
+	_fs_stat_cache_remove_root(string_to_const(monitor->path));
+
 	memory_context_pop();
 
 	return 0;
@@ -1605,8 +2846,17 @@ _fs_file_fopen(const char* path, size_t length, unsigned int mode, bool* dotrunc
 
 	do {
 #if FOUNDATION_PLATFORM_WINDOWS
+		wchar_t hintmodestr[8];
+		const wchar_t* openmodestr = modestr;
+		if (mode & (STREAM_HINT_SEQUENTIAL | STREAM_HINT_RANDOM)) {
+			//Mode characters map to FILE_FLAG_SEQUENTIAL_SCAN and FILE_FLAG_RANDOM_ACCESS
+			wcscpy_s(hintmodestr, sizeof(hintmodestr) / sizeof(hintmodestr[0]), modestr);
+			wcscat_s(hintmodestr, sizeof(hintmodestr) / sizeof(hintmodestr[0]),
+			         (mode & STREAM_HINT_SEQUENTIAL) ? L"S" : L"R");
+			openmodestr = hintmodestr;
+		}
 		wpath = wstring_allocate_from_string(path, length);
-		fd = _wfsopen(wpath, modestr, (mode & STREAM_OUT) ? _SH_DENYWR : _SH_DENYNO);
+		fd = _wfsopen(wpath, openmodestr, (mode & STREAM_OUT) ? _SH_DENYWR : _SH_DENYNO);
 		wstring_deallocate(wpath);
 #elif FOUNDATION_PLATFORM_POSIX
 		FOUNDATION_UNUSED(length);
@@ -1746,6 +2996,25 @@ _fs_file_truncate(stream_t* stream, size_t length) {
 #else
 
 	file = GET_FILE(stream);
+	if (file->anonymous) {
+		//Anonymous files have no path to reopen, truncate through the open descriptor
+		int result;
+		fflush(file->fd);
+#if FOUNDATION_PLATFORM_WINDOWS
+		result = _chsize_s(_fileno(file->fd), (__int64)length);
+#else
+		result = ftruncate(fileno(file->fd), (off_t)length);
+#endif
+		if (result != 0) {
+			string_const_t errmsg = system_error_message(0);
+			log_warnf(0, WARNING_SUSPICIOUS,
+			          STRING_CONST("Unable to truncate anonymous file (%" PRIsize " bytes): %.*s"),
+			          length, STRING_FORMAT(errmsg));
+		}
+		_fs_file_seek(stream, (ssize_t)cur, STREAM_SEEK_BEGIN);
+		return;
+	}
+
 	fspath = _fs_strip_protocol(STRING_ARGS(file->path));
 	if (!fspath.length)
 		return;
@@ -1804,13 +3073,26 @@ _fs_file_truncate(stream_t* stream, size_t length) {
 
 static void
 _fs_file_flush(stream_t* stream) {
-	if (GET_FILE(stream)->fd == 0)
+	stream_file_t* file = GET_FILE(stream);
+	if (file->fd == 0)
 		return;
 
 #if FOUNDATION_PLATFORM_PNACL
-	_pnacl_file_io->Flush(GET_FILE(stream)->fd, PP_BlockUntilComplete());
+	_pnacl_file_io->Flush(file->fd, PP_BlockUntilComplete());
 #else
-	fflush(GET_FILE(stream)->fd);
+	fflush(file->fd);
+	//Synchronized streams also commit data to storage
+	if (file->mode & STREAM_SYNC) {
+#  if FOUNDATION_PLATFORM_WINDOWS
+		_commit(_fileno(file->fd));
+#  elif FOUNDATION_PLATFORM_MACOSX
+		fcntl(fileno(file->fd), F_FULLFSYNC, 0);
+#  elif FOUNDATION_PLATFORM_POSIX
+		fsync(fileno(file->fd));
+#  else
+#    error Not implemented
+#  endif
+	}
 #endif
 }
 
@@ -1855,8 +3137,11 @@ _fs_file_read(stream_t* stream, void* buffer, size_t num_bytes) {
 
 	beforepos = _fs_file_tell(stream);
 	was_read = fread(buffer, 1, num_bytes, file->fd);
-	if (was_read > 0)
+	if (was_read > 0) {
+		if (file->prefetch)
+			_fs_prefetch_request(file->prefetch, beforepos + was_read);
 		return was_read;
+	}
 
 	if (feof(file->fd)) {
 		size_t newpos = _fs_file_tell(stream);
@@ -1926,9 +3211,85 @@ _fs_file_write(stream_t* stream, const void* buffer, size_t num_bytes) {
 #endif
 }
 
+#if FOUNDATION_PLATFORM_POSIX
+
+//Direct system calls bypass the stdio buffer, pending writes are flushed and the descriptor
+//offset synchronized to the logical stream position before the system call, and the stdio
+//position is reset to the descriptor offset after
+int
+_fs_file_descriptor_acquire(stream_t* stream) {
+	stream_file_t* file = GET_FILE(stream);
+	int fd;
+	off_t pos;
+
+	if (file->fd == 0)
+		return -1;
+
+	fd = fileno(file->fd);
+	pos = ftello(file->fd);
+	fflush(file->fd);
+	if (pos >= 0)
+		lseek(fd, pos, SEEK_SET);
+	return fd;
+}
+
+void
+_fs_file_descriptor_release(stream_t* stream, int fd, bool eos) {
+	stream_file_t* file = GET_FILE(stream);
+	off_t pos = lseek(fd, 0, SEEK_CUR);
+	if (pos >= 0)
+		fseeko(file->fd, pos, SEEK_SET);
+
+	//Repositioning clears the end of file indicator, restore it by reading past the end
+	if (eos) {
+		int c = getc(file->fd);
+		if (c != EOF)
+			ungetc(c, file->fd);
+	}
+}
+
+static size_t
+_fs_file_read_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_file_t* file = GET_FILE(stream);
+	size_t ispan, num, was_read;
+	int fd;
+
+	if (!(stream->mode & STREAM_IN) || (file->fd == 0))
+		return 0;
+
+	for (ispan = 0, num = 0; ispan < count; ++ispan)
+		num += spans[ispan].size;
+
+	fd = _fs_file_descriptor_acquire(stream);
+	was_read = _stream_fd_vector(fd, spans, count, false);
+	_fs_file_descriptor_release(stream, fd, was_read < num);
+
+	return was_read;
+}
+
+static size_t
+_fs_file_write_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_file_t* file = GET_FILE(stream);
+	size_t was_written;
+	int fd;
+
+	if (!(stream->mode & STREAM_OUT) || (file->fd == 0))
+		return 0;
+
+	fd = _fs_file_descriptor_acquire(stream);
+	was_written = _stream_fd_vector(fd, spans, count, true);
+	_fs_file_descriptor_release(stream, fd, false);
+
+	return was_written;
+}
+
+#endif
+
 static tick_t
 _fs_file_last_modified(const stream_t* stream) {
 	const stream_file_t* fstream = GET_FILE_CONST(stream);
+	if (fstream->anonymous)
+		return 0;
 #if FOUNDATION_PLATFORM_PNACL
 	struct PP_FileInfo info;
 	if (_pnacl_file_io->Query(fstream->fd, &info, PP_BlockUntilComplete()) == PP_OK)
@@ -1952,31 +3313,56 @@ _fs_file_available_read(stream_t* stream) {
 
 static stream_t* _fs_file_clone(stream_t* stream) {
 	stream_file_t* file = GET_FILE(stream);
+	if (file->anonymous)
+		return 0;
 	return fs_open_file(file->path.str, file->path.length, file->mode);
 }
 
+static void
+_fs_file_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	stream_file_t* file = GET_FILE(stream);
+	if (!file->fd)
+		return;
+#if FOUNDATION_PLATFORM_APPLE
+	int fd = fileno(file->fd);
+	if (advice == STREAM_ADVICE_WILLNEED) {
+		struct radvisory advisory;
+		advisory.ra_offset = (off_t)offset;
+		advisory.ra_count = (!size || (size > INT_MAX)) ? INT_MAX : (int)size;
+		fcntl(fd, F_RDADVISE, &advisory);
+	}
+	else if (advice != STREAM_ADVICE_DONTNEED) {
+		fcntl(fd, F_RDAHEAD, (advice == STREAM_ADVICE_RANDOM) ? 0 : 1);
+	}
+#elif FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_PNACL
+	int flag = POSIX_FADV_NORMAL;
+	if (advice == STREAM_ADVICE_SEQUENTIAL)
+		flag = POSIX_FADV_SEQUENTIAL;
+	else if (advice == STREAM_ADVICE_RANDOM)
+		flag = POSIX_FADV_RANDOM;
+	else if (advice == STREAM_ADVICE_WILLNEED)
+		flag = POSIX_FADV_WILLNEED;
+	else if (advice == STREAM_ADVICE_DONTNEED)
+		flag = POSIX_FADV_DONTNEED;
+	posix_fadvise(fileno(file->fd), (off_t)offset, (off_t)size, flag);
+#else
+	//Windows access hints are only given when opening the file, see STREAM_HINT_SEQUENTIAL
+	FOUNDATION_UNUSED(advice);
+	FOUNDATION_UNUSED(offset);
+	FOUNDATION_UNUSED(size);
+#endif
+}
+
 static void
 _fs_file_finalize(stream_t* stream) {
 	stream_file_t* file = GET_FILE(stream);
 	if (file->fd == 0)
 		return;
 
-	if (file->mode & STREAM_SYNC) {
+	fs_prefetch(stream, 0);
+
+	if (file->mode & STREAM_SYNC)
 		_fs_file_flush(stream);
-		if (file->fd) {
-#if FOUNDATION_PLATFORM_WINDOWS
-			_commit(_fileno(file->fd));
-#elif FOUNDATION_PLATFORM_MACOSX
-			fcntl(fileno(file->fd), F_FULLFSYNC, 0);
-#elif FOUNDATION_PLATFORM_POSIX
-			fsync(fileno(file->fd));
-#elif FOUNDATION_PLATFORM_PNACL
-			_pnacl_file_io->Flush(file->fd, PP_BlockUntilComplete());
-#else
-#  error Not implemented
-#endif
-		}
-	}
 
 	if (file->fd) {
 #if FOUNDATION_PLATFORM_PNACL
@@ -1987,6 +3373,9 @@ _fs_file_finalize(stream_t* stream) {
 #endif
 	}
 	file->fd = 0;
+
+	if ((file->mode & STREAM_OUT) && !file->anonymous)
+		_fs_stat_cache_invalidate(STRING_ARGS(file->path));
 }
 
 stream_t*
@@ -1995,17 +3384,25 @@ fs_open_file(const char* path, size_t length, unsigned int mode) {
 	fs_file_descriptor fd;
 	stream_t* stream;
 	string_const_t fspath;
-	string_t localpath;
+	string_const_t localpath;
 	string_t finalpath;
 	size_t capacity;
 	bool dotrunc;
 	char buffer[BUILD_MAX_PATHLEN];
 
-	capacity = sizeof(buffer);
-	localpath = string_copy(buffer, capacity, path, length);
-	localpath = path_clean(STRING_ARGS(localpath), capacity);
-	if (!path_is_absolute(STRING_ARGS(localpath)))
-		localpath = path_absolute(STRING_ARGS(localpath), capacity);
+	//Clean absolute paths are copied straight into the final path
+	if (path_is_absolute(path, length) && path_is_clean(path, length)) {
+		localpath = string_const(path, length);
+	}
+	else {
+		string_t cleanpath;
+		capacity = sizeof(buffer);
+		cleanpath = string_copy(buffer, capacity, path, length);
+		cleanpath = path_clean(STRING_ARGS(cleanpath), capacity);
+		if (!path_is_absolute(STRING_ARGS(cleanpath)))
+			cleanpath = path_absolute(STRING_ARGS(cleanpath), capacity);
+		localpath = string_const(STRING_ARGS(cleanpath));
+	}
 
 	capacity = localpath.length + 8;
 	finalpath = string_allocate(0, capacity);
@@ -2033,7 +3430,8 @@ fs_open_file(const char* path, size_t length, unsigned int mode) {
 
 	file->fd     = fd;
 	file->type   = STREAMTYPE_FILE;
-	file->mode   = mode & (STREAM_OUT | STREAM_IN | STREAM_BINARY | STREAM_SYNC);
+	file->mode   = mode & (STREAM_OUT | STREAM_IN | STREAM_BINARY | STREAM_SYNC |
+	                       STREAM_HINT_SEQUENTIAL | STREAM_HINT_RANDOM);
 	file->path   = finalpath;
 	file->vtable = &_fs_file_vtable;
 
@@ -2050,9 +3448,976 @@ fs_open_file(const char* path, size_t length, unsigned int mode) {
 	else if (mode & STREAM_ATEND)
 		stream_seek(stream, 0, STREAM_SEEK_END);
 
+	if (mode & STREAM_HINT_SEQUENTIAL)
+		_fs_file_advise(stream, STREAM_ADVICE_SEQUENTIAL, 0, 0);
+	else if (mode & STREAM_HINT_RANDOM)
+		_fs_file_advise(stream, STREAM_ADVICE_RANDOM, 0, 0);
+
+	if (mode & STREAM_OUT)
+		_fs_stat_cache_invalidate(STRING_ARGS(fspath));
+
 	return stream;
 }
 
+static void*
+_fs_prefetch_worker(void* arg) {
+	fs_prefetch_t* prefetch = arg;
+	size_t end = 0;
+	while (!atomic_load32(&prefetch->stop)) {
+		size_t offset = (size_t)atomic_load64(&prefetch->offset);
+		size_t target = offset + prefetch->window;
+		if (end < offset)
+			end = offset;
+		//Read the window through a separate stream to pull it into the file system cache
+		//without touching the position of the stream being read
+		while ((end < target) && !atomic_load32(&prefetch->stop)) {
+			size_t chunk = target - end;
+			if (chunk > FS_PREFETCH_CHUNK_SIZE)
+				chunk = FS_PREFETCH_CHUNK_SIZE;
+			stream_seek(prefetch->stream, (ssize_t)end, STREAM_SEEK_BEGIN);
+			if (stream_read(prefetch->stream, prefetch->buffer, chunk) != chunk)
+				break;
+			end += chunk;
+		}
+		thread_wait();
+	}
+	return 0;
+}
+
+static void
+_fs_prefetch_request(fs_prefetch_t* prefetch, size_t position) {
+	//Request the next window once half of the previous window is consumed, or on seek back
+	if ((position + (prefetch->window / 2) < prefetch->requested) &&
+	        (position + prefetch->window >= prefetch->requested))
+		return;
+	prefetch->requested = position + prefetch->window;
+	atomic_store64(&prefetch->offset, (int64_t)position);
+	thread_signal(&prefetch->thread);
+}
+
+void
+fs_prefetch(stream_t* stream, size_t window) {
+	stream_file_t* file = GET_FILE(stream);
+	fs_prefetch_t* prefetch;
+	stream_t* prefetch_stream;
+
+	if (!stream || (stream->type != STREAMTYPE_FILE) || !(stream->mode & STREAM_IN))
+		return;
+
+	prefetch = file->prefetch;
+	if (prefetch) {
+		file->prefetch = 0;
+		atomic_store32(&prefetch->stop, 1);
+		thread_signal(&prefetch->thread);
+		thread_finalize(&prefetch->thread);
+		stream_deallocate(prefetch->stream);
+		memory_deallocate(prefetch->buffer);
+		memory_deallocate(prefetch);
+	}
+
+	if (!window || !file->fd)
+		return;
+
+	prefetch_stream = fs_open_file(STRING_ARGS(file->path),
+	                               STREAM_IN | STREAM_BINARY | STREAM_HINT_SEQUENTIAL);
+	if (!prefetch_stream)
+		return;
+
+	prefetch = memory_allocate(HASH_STREAM, sizeof(fs_prefetch_t), 0,
+	                           MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	prefetch->stream = prefetch_stream;
+	prefetch->buffer = memory_allocate(HASH_STREAM, FS_PREFETCH_CHUNK_SIZE, 0, MEMORY_PERSISTENT);
+	prefetch->window = window;
+	prefetch->requested = _fs_file_tell(stream) + window;
+	atomic_store64(&prefetch->offset, (int64_t)_fs_file_tell(stream));
+	thread_initialize(&prefetch->thread, _fs_prefetch_worker, prefetch, STRING_CONST("fs_prefetch"),
+	                  THREAD_PRIORITY_BELOWNORMAL, 0);
+	thread_start(&prefetch->thread);
+	file->prefetch = prefetch;
+}
+
+static size_t
+_fs_mapped_read(stream_t* stream, void* buffer, size_t num_bytes) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	size_t available = mapped->size - mapped->position;
+	if (num_bytes > available)
+		num_bytes = available;
+	memcpy(buffer, pointer_offset_const(mapped->data, mapped->position), num_bytes);
+	mapped->position += num_bytes;
+	return num_bytes;
+}
+
+//Writes modify the private copy-on-write pages of the mapping, never the file
+static size_t
+_fs_mapped_write(stream_t* stream, const void* buffer, size_t num_bytes) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	size_t available = mapped->size - mapped->position;
+	if (num_bytes > available)
+		num_bytes = available;
+	memcpy(pointer_offset((void*)(uintptr_t)mapped->data, mapped->position), buffer, num_bytes);
+	mapped->position += num_bytes;
+	return num_bytes;
+}
+
+static bool
+_fs_mapped_eos(stream_t* stream) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	return mapped->position >= mapped->size;
+}
+
+static size_t
+_fs_mapped_size(stream_t* stream) {
+	return ((stream_mapped_t*)stream)->size;
+}
+
+static void
+_fs_mapped_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	ssize_t position = offset;
+	if (direction == STREAM_SEEK_CURRENT)
+		position += (ssize_t)mapped->position;
+	else if (direction == STREAM_SEEK_END)
+		position += (ssize_t)mapped->size;
+	if (position < 0)
+		position = 0;
+	mapped->position = ((size_t)position < mapped->size) ? (size_t)position : mapped->size;
+}
+
+static size_t
+_fs_mapped_tell(stream_t* stream) {
+	return ((stream_mapped_t*)stream)->position;
+}
+
+static tick_t
+_fs_mapped_last_modified(const stream_t* stream) {
+	string_const_t path = path_strip_protocol(STRING_ARGS(stream->path));
+	return fs_last_modified(STRING_ARGS(path));
+}
+
+static size_t
+_fs_mapped_available_read(stream_t* stream) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	return mapped->size - mapped->position;
+}
+
+static void
+_fs_mapped_finalize(stream_t* stream) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	if (!mapped || (stream->type != STREAMTYPE_MAPPED))
+		return;
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (mapped->data)
+		UnmapViewOfFile(mapped->data);
+	if (mapped->mapping)
+		CloseHandle(mapped->mapping);
+	mapped->mapping = 0;
+#elif FOUNDATION_PLATFORM_POSIX
+	if (mapped->data)
+		munmap((void*)(uintptr_t)mapped->data, mapped->size);
+#endif
+	mapped->data = 0;
+	mapped->size = 0;
+}
+
+static stream_t*
+_fs_mapped_clone(stream_t* stream) {
+	return fs_map_file(STRING_ARGS(stream->path), stream->mode);
+}
+
+stream_t*
+fs_map_file(const char* path, size_t length, unsigned int mode) {
+	stream_mapped_t* mapped;
+	string_t localpath;
+	string_t finalpath;
+	size_t capacity;
+	const void* data = 0;
+	size_t size = 0;
+	char buffer[BUILD_MAX_PATHLEN];
+#if FOUNDATION_PLATFORM_WINDOWS
+	wchar_t* wpath;
+	HANDLE file;
+	HANDLE mapping = 0;
+	LARGE_INTEGER file_size;
+#elif FOUNDATION_PLATFORM_POSIX
+	int fd;
+	struct stat st;
+#endif
+
+	if (!(mode & STREAM_IN))
+		return 0;
+
+#if FOUNDATION_PLATFORM_ANDROID
+	//Uncompressed package assets are mapped directly from the package file
+	if ((length >= 6) && string_equal(path, 6, STRING_CONST("asset:"))) {
+		stream_t* asset;
+		if (mode & STREAM_OUT)
+			return 0;
+		asset = asset_stream_open(path, length, mode);
+		if (asset && !_asset_stream_mapped_data(asset, 0)) {
+			stream_deallocate(asset);
+			asset = 0;
+		}
+		return asset;
+	}
+#endif
+
+	if ((length >= 7) && string_equal(path, 7, STRING_CONST("mmap://"))) {
+		path += 7;
+		length -= 7;
+	}
+	else {
+		string_const_t fspath = _fs_strip_protocol(path, length);
+		path = fspath.str;
+		length = fspath.length;
+	}
+	if (!length)
+		return 0;
+
+	capacity = sizeof(buffer);
+	localpath = string_copy(buffer, capacity, path, length);
+	localpath = path_clean(STRING_ARGS(localpath), capacity);
+	if (!path_is_absolute(STRING_ARGS(localpath)))
+		localpath = path_absolute(STRING_ARGS(localpath), capacity);
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	wpath = wstring_allocate_from_string(STRING_ARGS(localpath));
+	file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, 0, OPEN_EXISTING,
+	                   FILE_ATTRIBUTE_NORMAL, 0);
+	wstring_deallocate(wpath);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+	if (!GetFileSizeEx(file, &file_size)) {
+		CloseHandle(file);
+		return 0;
+	}
+	size = (size_t)file_size.QuadPart;
+	if (size) {
+		mapping = CreateFileMappingW(file, 0, (mode & STREAM_OUT) ? PAGE_WRITECOPY : PAGE_READONLY,
+		                             0, 0, 0);
+		if (mapping)
+			data = MapViewOfFile(mapping, (mode & STREAM_OUT) ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+		if (!data) {
+			string_const_t errmsg = system_error_message(0);
+			log_warnf(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Unable to map file '%.*s': %.*s"),
+			          STRING_FORMAT(localpath), STRING_FORMAT(errmsg));
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			return 0;
+		}
+	}
+	//Mapping keeps the file open
+	CloseHandle(file);
+#elif FOUNDATION_PLATFORM_POSIX
+	fd = open(localpath.str, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return 0;
+	if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode)) {
+		close(fd);
+		return 0;
+	}
+	size = (size_t)st.st_size;
+	if (size) {
+		void* addr = mmap(0, size, (mode & STREAM_OUT) ? (PROT_READ | PROT_WRITE) : PROT_READ,
+		                  MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			string_const_t errmsg = system_error_message(0);
+			log_warnf(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Unable to map file '%.*s': %.*s"),
+			          STRING_FORMAT(localpath), STRING_FORMAT(errmsg));
+			close(fd);
+			return 0;
+		}
+		data = addr;
+	}
+	//Mapping keeps the file open
+	close(fd);
+#else
+	return 0;
+#endif
+
+	capacity = localpath.length + 8;
+	finalpath = string_allocate(0, capacity);
+	finalpath = string_copy(finalpath.str, capacity, STRING_CONST("mmap://"));
+	finalpath = string_append(STRING_ARGS(finalpath), capacity, STRING_ARGS(localpath));
+
+	mapped = memory_allocate(HASH_STREAM, sizeof(stream_mapped_t), 8,
+	                         MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_initialize((stream_t*)mapped, BUILD_DEFAULT_STREAM_BYTEORDER);
+
+	mapped->type = STREAMTYPE_MAPPED;
+	mapped->mode = STREAM_IN | (mode & (STREAM_OUT | STREAM_BINARY));
+	mapped->path = finalpath;
+	mapped->vtable = &_fs_mapped_vtable;
+	mapped->data = data;
+	mapped->size = size;
+#if FOUNDATION_PLATFORM_WINDOWS
+	mapped->mapping = mapping;
+#endif
+
+	return (stream_t*)mapped;
+}
+
+const void*
+fs_mapped_data(stream_t* stream, size_t* size) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+#if FOUNDATION_PLATFORM_ANDROID
+	if (stream && (stream->type == STREAMTYPE_ASSET))
+		return _asset_stream_mapped_data(stream, size);
+#endif
+	if (!stream || (stream->type != STREAMTYPE_MAPPED)) {
+		if (size)
+			*size = 0;
+		return 0;
+	}
+	if (size)
+		*size = mapped->size;
+	return mapped->data;
+}
+
+void
+fs_map_advise(stream_t* stream, fs_map_advice_t advice) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+#if FOUNDATION_PLATFORM_ANDROID
+	if (stream && (stream->type == STREAMTYPE_ASSET)) {
+		//Advice values share order with stream advice
+		stream_advise(stream, (stream_advice_t)advice, 0, 0);
+		return;
+	}
+#endif
+	if (!stream || (stream->type != STREAMTYPE_MAPPED) || !mapped->data)
+		return;
+#if FOUNDATION_PLATFORM_POSIX
+	int flag = MADV_NORMAL;
+	if (advice == FS_MAP_ADVICE_SEQUENTIAL)
+		flag = MADV_SEQUENTIAL;
+	else if (advice == FS_MAP_ADVICE_RANDOM)
+		flag = MADV_RANDOM;
+	else if (advice == FS_MAP_ADVICE_WILLNEED)
+		flag = MADV_WILLNEED;
+	madvise((void*)(uintptr_t)mapped->data, mapped->size, flag);
+#else
+	FOUNDATION_UNUSED(advice);
+#endif
+}
+
+static void
+_fs_mapped_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	stream_mapped_t* mapped = (stream_mapped_t*)stream;
+	if (!mapped->data || (offset >= mapped->size))
+		return;
+#if FOUNDATION_PLATFORM_POSIX
+	//Range must start on a page boundary, mapping base address is page aligned
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t begin = offset - (offset % page_size);
+	if (!size || (size > mapped->size - offset))
+		size = mapped->size - offset;
+	int flag = MADV_NORMAL;
+	if (advice == STREAM_ADVICE_SEQUENTIAL)
+		flag = MADV_SEQUENTIAL;
+	else if (advice == STREAM_ADVICE_RANDOM)
+		flag = MADV_RANDOM;
+	else if (advice == STREAM_ADVICE_WILLNEED)
+		flag = MADV_WILLNEED;
+	else if (advice == STREAM_ADVICE_DONTNEED)
+		flag = MADV_DONTNEED;
+	madvise((void*)((uintptr_t)mapped->data + begin), size + (offset - begin), flag);
+#else
+	FOUNDATION_UNUSED(advice);
+	FOUNDATION_UNUSED(size);
+#endif
+}
+
+static void
+_fs_async_complete(fs_async_t* async, fs_async_request_t* request) {
+	if (async->events) {
+		event_post(async->events, FOUNDATIONEVENT_FILE_ASYNC_COMPLETE, 0, 0,
+		           &request->result, sizeof(request->result));
+	}
+	else {
+		mutex_lock(async->lock);
+		array_push_memcpy(async->completed, &request->result);
+		mutex_unlock(async->lock);
+	}
+	queue_push(&async->free, request);
+	if (async->beacon)
+		beacon_fire(async->beacon);
+	//Context can be deallocated once no requests are pending, must be the last access
+	atomic_decr32(&async->pending);
+}
+
+static void
+_fs_async_execute_path(fs_async_request_t* request) {
+	fs_stat_entry_t entry;
+	bool result = false;
+	switch (request->op) {
+	case FS_ASYNC_STAT:
+		if (_fs_stat(request->path, request->path_length, &entry) && entry.exists) {
+			request->result.type = entry.type;
+			request->result.size = entry.size;
+			request->result.last_modified = entry.last_modified;
+			result = true;
+		}
+		break;
+	case FS_ASYNC_REMOVE_FILE:
+		result = fs_remove_file(request->path, request->path_length);
+		break;
+	case FS_ASYNC_MAKE_DIRECTORY:
+		result = fs_make_directory(request->path, request->path_length);
+		break;
+	case FS_ASYNC_COPY_FILE:
+		result = fs_copy_file(request->path, request->path_length, request->destination,
+		                      request->destination_length);
+		break;
+	case FS_ASYNC_TOUCH:
+		fs_touch(request->path, request->path_length);
+		result = (_fs_stat(request->path, request->path_length, &entry) && entry.exists);
+		break;
+	default:
+		break;
+	}
+	request->result.transferred = result ? 0 : -1;
+}
+
+static void
+_fs_async_execute(fs_async_request_t* request) {
+	int64_t transferred = -1;
+	if (request->op > FS_ASYNC_WRITE) {
+		_fs_async_execute_path(request);
+		return;
+	}
+#if FOUNDATION_PLATFORM_WINDOWS
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(request->fd));
+	OVERLAPPED overlapped;
+	DWORD done = 0;
+	DWORD size = (request->result.size > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (DWORD)request->result.size;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = (DWORD)(request->result.offset & 0xFFFFFFFFULL);
+	overlapped.OffsetHigh = (DWORD)((uint64_t)request->result.offset >> 32ULL);
+	BOOL ok;
+	if (request->op == FS_ASYNC_WRITE)
+		ok = WriteFile(handle, request->result.buffer, size, &done, &overlapped);
+	else
+		ok = ReadFile(handle, request->result.buffer, size, &done, &overlapped);
+	if (ok || (GetLastError() == ERROR_HANDLE_EOF))
+		transferred = (int64_t)done;
+#elif FOUNDATION_PLATFORM_PNACL
+	int32_t size = (request->result.size > 0x7FFFFFFFULL) ? 0x7FFFFFFF : (int32_t)request->result.size;
+	int32_t ret;
+	if (request->op == FS_ASYNC_WRITE)
+		ret = _pnacl_file_io->Write(request->fd, (int64_t)request->result.offset, request->result.buffer,
+		                            size, PP_BlockUntilComplete());
+	else
+		ret = _pnacl_file_io->Read(request->fd, (int64_t)request->result.offset, request->result.buffer,
+		                           size, PP_BlockUntilComplete());
+	if (ret >= 0)
+		transferred = ret;
+#else
+	ssize_t ret;
+	if (request->op == FS_ASYNC_WRITE)
+		ret = pwrite(fileno(request->fd), request->result.buffer, request->result.size,
+		             (off_t)request->result.offset);
+	else
+		ret = pread(fileno(request->fd), request->result.buffer, request->result.size,
+		            (off_t)request->result.offset);
+	if (ret >= 0)
+		transferred = (int64_t)ret;
+#endif
+	request->result.transferred = transferred;
+}
+
+static void*
+_fs_async_worker(void* arg) {
+	fs_async_t* async = arg;
+	while (true) {
+		fs_async_request_t* request = queue_pop(&async->submit);
+		if (request->op == FS_ASYNC_STOP)
+			break;
+		_fs_async_execute(request);
+		_fs_async_complete(async, request);
+	}
+	return 0;
+}
+
+#if FOUNDATION_HAVE_IO_URING
+
+static int
+_fs_uring_enter(int ring, unsigned int submit, unsigned int complete, unsigned int flags) {
+	return (int)syscall(__NR_io_uring_enter, ring, submit, complete, flags, nullptr, 0);
+}
+
+static void
+_fs_uring_prepare(fs_async_t* async, fs_async_request_t* request) {
+	unsigned int tail, index;
+	struct io_uring_sqe* sqe;
+
+	tail = *async->sq_tail;
+	index = tail & *async->sq_mask;
+	sqe = async->sqe + index;
+	memset(sqe, 0, sizeof(*sqe));
+	if (request->op == FS_ASYNC_STOP) {
+		sqe->opcode = IORING_OP_NOP;
+	}
+#if FOUNDATION_HAVE_IO_URING_PATH
+	else if (request->op == FS_ASYNC_STAT) {
+		sqe->opcode = IORING_OP_STATX;
+		sqe->fd = AT_FDCWD;
+		sqe->addr = (uint64_t)(uintptr_t)request->path;
+		sqe->len = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+		sqe->off = (uint64_t)(uintptr_t)&request->stx;
+	}
+	else if (request->op == FS_ASYNC_REMOVE_FILE) {
+		sqe->opcode = IORING_OP_UNLINKAT;
+		sqe->fd = AT_FDCWD;
+		sqe->addr = (uint64_t)(uintptr_t)request->path;
+	}
+	else if (request->op == FS_ASYNC_MAKE_DIRECTORY) {
+		sqe->opcode = IORING_OP_MKDIRAT;
+		sqe->fd = AT_FDCWD;
+		sqe->addr = (uint64_t)(uintptr_t)request->path;
+		sqe->len = S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IWGRP | S_IXGRP | S_IROTH | S_IXOTH;
+	}
+#endif
+	else {
+		request->iov.iov_base = request->result.buffer;
+		request->iov.iov_len = request->result.size;
+		sqe->opcode = (request->op == FS_ASYNC_WRITE) ? IORING_OP_WRITEV : IORING_OP_READV;
+		sqe->fd = fileno(request->fd);
+		sqe->off = (uint64_t)request->result.offset;
+		sqe->addr = (uint64_t)(uintptr_t)&request->iov;
+		sqe->len = 1;
+	}
+	sqe->user_data = (uint64_t)(uintptr_t)request;
+	async->sq_array[index] = index;
+	atomic_thread_fence_release();
+	atomic_store32((atomic32_t*)async->sq_tail, (int32_t)(tail + 1));
+}
+
+static void
+_fs_uring_flush(fs_async_t* async, unsigned int count) {
+	//Ring is sized to the request pool, so the submission queue can never overflow
+	while (count && (_fs_uring_enter(async->ring, count, 0, 0) < 0)) {
+		if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+			log_warnf(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Unable to submit async file I/O: %s"),
+			          strerror(errno));
+			break;
+		}
+	}
+}
+
+static void
+_fs_uring_submit(fs_async_t* async, fs_async_request_t* request) {
+	mutex_lock(async->lock);
+	_fs_uring_prepare(async, request);
+	_fs_uring_flush(async, 1);
+	mutex_unlock(async->lock);
+}
+
+static bool
+_fs_uring_reap_path(fs_async_t* async, fs_async_request_t* request, int res) {
+#if FOUNDATION_HAVE_IO_URING_PATH
+	if (request->op == FS_ASYNC_STAT) {
+		if (res >= 0) {
+			if (S_ISREG(request->stx.stx_mode))
+				request->result.type = FS_ENTRY_FILE;
+			else if (S_ISDIR(request->stx.stx_mode))
+				request->result.type = FS_ENTRY_DIRECTORY;
+			else
+				request->result.type = FS_ENTRY_OTHER;
+			request->result.size = (size_t)request->stx.stx_size;
+			request->result.last_modified = (tick_t)request->stx.stx_mtime.tv_sec * 1000LL;
+		}
+	}
+	else if ((request->op == FS_ASYNC_MAKE_DIRECTORY) && (res < 0)) {
+		//Existing directories and missing parents are handled by the worker threads
+		queue_push(&async->submit, request);
+		return false;
+	}
+	if (request->op != FS_ASYNC_STAT)
+		_fs_stat_cache_invalidate(request->path, request->path_length);
+#else
+	FOUNDATION_UNUSED(async);
+	FOUNDATION_UNUSED(request);
+	FOUNDATION_UNUSED(res);
+#endif
+	return true;
+}
+
+static void*
+_fs_uring_reaper(void* arg) {
+	fs_async_t* async = arg;
+	bool running = true;
+	while (running) {
+		unsigned int head, tail;
+		if ((_fs_uring_enter(async->ring, 0, 1, IORING_ENTER_GETEVENTS) < 0) && (errno != EINTR)) {
+			thread_yield();
+			continue;
+		}
+		head = *async->cq_head;
+		tail = (unsigned int)atomic_load32((atomic32_t*)async->cq_tail);
+		atomic_thread_fence_acquire();
+		while (head != tail) {
+			struct io_uring_cqe* cqe = async->cqe + (head & *async->cq_mask);
+			fs_async_request_t* request = (fs_async_request_t*)(uintptr_t)cqe->user_data;
+			int res = cqe->res;
+			++head;
+			atomic_thread_fence_release();
+			atomic_store32((atomic32_t*)async->cq_head, (int32_t)head);
+			if (request->op == FS_ASYNC_STOP) {
+				running = false;
+				continue;
+			}
+			if ((request->op > FS_ASYNC_WRITE) && !_fs_uring_reap_path(async, request, res))
+				continue;
+			if (request->op > FS_ASYNC_WRITE)
+				request->result.transferred = (res >= 0) ? 0 : -1;
+			else
+				request->result.transferred = (res >= 0) ? (int64_t)res : -1;
+			_fs_async_complete(async, request);
+		}
+	}
+	return 0;
+}
+
+static void
+_fs_uring_probe(fs_async_t* async) {
+#if FOUNDATION_HAVE_IO_URING_PATH
+	const size_t ops = 256;
+	struct io_uring_probe* probe = memory_allocate(HASH_STREAM, sizeof(struct io_uring_probe) +
+	                                               (sizeof(struct io_uring_probe_op) * ops), 0,
+	                                               MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	if (syscall(__NR_io_uring_register, async->ring, IORING_REGISTER_PROBE, probe, ops) >= 0) {
+		if ((probe->last_op >= IORING_OP_STATX) &&
+		        (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED))
+			async->ring_ops |= (1U << FS_ASYNC_STAT);
+		if ((probe->last_op >= IORING_OP_UNLINKAT) &&
+		        (probe->ops[IORING_OP_UNLINKAT].flags & IO_URING_OP_SUPPORTED))
+			async->ring_ops |= (1U << FS_ASYNC_REMOVE_FILE);
+		if ((probe->last_op >= IORING_OP_MKDIRAT) &&
+		        (probe->ops[IORING_OP_MKDIRAT].flags & IO_URING_OP_SUPPORTED))
+			async->ring_ops |= (1U << FS_ASYNC_MAKE_DIRECTORY);
+	}
+	memory_deallocate(probe);
+#endif
+	async->ring_ops |= (1U << FS_ASYNC_READ) | (1U << FS_ASYNC_WRITE);
+}
+
+static bool
+_fs_uring_initialize(fs_async_t* async) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	async->ring = (int)syscall(__NR_io_uring_setup, (unsigned int)(async->depth + 1), &params);
+	if (async->ring < 0)
+		return false;
+
+	async->sq_map_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned int));
+	async->cq_map_size = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (async->cq_map_size > async->sq_map_size)
+			async->sq_map_size = async->cq_map_size;
+		async->cq_map_size = 0;
+	}
+	async->sq_map = mmap(0, async->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	                     async->ring, IORING_OFF_SQ_RING);
+	if (async->sq_map == MAP_FAILED)
+		goto failed;
+	if (async->cq_map_size) {
+		async->cq_map = mmap(0, async->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		                     async->ring, IORING_OFF_CQ_RING);
+		if (async->cq_map == MAP_FAILED)
+			goto failed;
+	}
+	else {
+		async->cq_map = async->sq_map;
+	}
+	async->sqe_map_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	async->sqe = mmap(0, async->sqe_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	                  async->ring, IORING_OFF_SQES);
+	if (async->sqe == MAP_FAILED)
+		goto failed;
+
+	async->sq_tail = pointer_offset(async->sq_map, params.sq_off.tail);
+	async->sq_mask = pointer_offset(async->sq_map, params.sq_off.ring_mask);
+	async->sq_array = pointer_offset(async->sq_map, params.sq_off.array);
+	async->cq_head = pointer_offset(async->cq_map, params.cq_off.head);
+	async->cq_tail = pointer_offset(async->cq_map, params.cq_off.tail);
+	async->cq_mask = pointer_offset(async->cq_map, params.cq_off.ring_mask);
+	async->cqe = pointer_offset(async->cq_map, params.cq_off.cqes);
+	return true;
+
+failed:
+	if (async->sqe && (async->sqe != MAP_FAILED))
+		munmap(async->sqe, async->sqe_map_size);
+	if (async->cq_map_size && async->cq_map && (async->cq_map != MAP_FAILED))
+		munmap(async->cq_map, async->cq_map_size);
+	if (async->sq_map && (async->sq_map != MAP_FAILED))
+		munmap(async->sq_map, async->sq_map_size);
+	close(async->ring);
+	async->ring = -1;
+	async->sq_map = async->cq_map = 0;
+	async->sqe = 0;
+	return false;
+}
+
+static void
+_fs_uring_finalize(fs_async_t* async) {
+	munmap(async->sqe, async->sqe_map_size);
+	if (async->cq_map_size)
+		munmap(async->cq_map, async->cq_map_size);
+	munmap(async->sq_map, async->sq_map_size);
+	close(async->ring);
+	async->ring = -1;
+}
+
+#endif
+
+static void
+_fs_async_start_workers(fs_async_t* async) {
+	size_t iworker;
+	if (async->workers)
+		return;
+	async->workers = (async->depth < FS_ASYNC_WORKERS) ? async->depth : FS_ASYNC_WORKERS;
+	for (iworker = 0; iworker < async->workers; ++iworker) {
+		thread_initialize(&async->worker[iworker], _fs_async_worker, async, STRING_CONST("fs_async"),
+		                  THREAD_PRIORITY_ABOVENORMAL, 0);
+		thread_start(&async->worker[iworker]);
+	}
+}
+
+fs_async_t*
+fs_async_allocate(size_t depth, event_stream_t* events, beacon_t* beacon) {
+	fs_async_t* async;
+	size_t ireq;
+
+	if (!depth)
+		depth = 64;
+
+	async = memory_allocate(HASH_STREAM, sizeof(fs_async_t), 64,
+	                        MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	async->events = events;
+	async->beacon = beacon;
+	async->depth = depth;
+	async->stop.op = FS_ASYNC_STOP;
+	async->request = memory_allocate(HASH_STREAM, sizeof(fs_async_request_t) * depth, 0,
+	                                 MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	async->lock = mutex_allocate(STRING_CONST("fs_async"));
+	queue_initialize(&async->free, depth);
+	queue_initialize(&async->submit, depth + FS_ASYNC_WORKERS);
+	for (ireq = 0; ireq < depth; ++ireq)
+		queue_push(&async->free, async->request + ireq);
+
+#if FOUNDATION_HAVE_IO_URING
+	async->ring = -1;
+	if (_fs_uring_initialize(async)) {
+		//Worker threads are only started once operations without an io_uring opcode are submitted
+		_fs_uring_probe(async);
+		thread_initialize(&async->reaper, _fs_uring_reaper, async, STRING_CONST("fs_async"),
+		                  THREAD_PRIORITY_ABOVENORMAL, 0);
+		thread_start(&async->reaper);
+		return async;
+	}
+	log_debug(0, STRING_CONST("io_uring not available, using thread pool for async file I/O"));
+#endif
+
+	_fs_async_start_workers(async);
+
+	return async;
+}
+
+void
+fs_async_deallocate(fs_async_t* async) {
+	size_t iworker;
+	if (!async)
+		return;
+
+	//Wait for outstanding requests, then stop worker threads
+	while (atomic_load32(&async->pending) > 0)
+		thread_yield();
+
+#if FOUNDATION_HAVE_IO_URING
+	if (async->ring >= 0) {
+		_fs_uring_submit(async, &async->stop);
+		thread_join(&async->reaper);
+		thread_finalize(&async->reaper);
+	}
+#endif
+
+	for (iworker = 0; iworker < async->workers; ++iworker)
+		queue_push(&async->submit, &async->stop);
+	for (iworker = 0; iworker < async->workers; ++iworker) {
+		thread_join(&async->worker[iworker]);
+		thread_finalize(&async->worker[iworker]);
+	}
+
+#if FOUNDATION_HAVE_IO_URING
+	if (async->ring >= 0)
+		_fs_uring_finalize(async);
+#endif
+
+	queue_finalize(&async->submit);
+	queue_finalize(&async->free);
+	mutex_deallocate(async->lock);
+	array_deallocate(async->completed);
+	memory_deallocate(async->request);
+	memory_deallocate(async);
+}
+
+static bool
+_fs_async_submit(fs_async_t* async, int op, stream_t* stream, size_t offset, void* buffer,
+                 size_t size, void* userdata) {
+	fs_async_request_t* request;
+	stream_file_t* file;
+
+	if (!stream || (stream->type != STREAMTYPE_FILE) || !GET_FILE(stream)->fd)
+		return false;
+	if (!(stream->mode & ((op == FS_ASYNC_WRITE) ? STREAM_OUT : STREAM_IN)))
+		return false;
+
+	file = GET_FILE(stream);
+#if !FOUNDATION_PLATFORM_PNACL
+	//Push out any data buffered by stream writes so positional I/O sees it
+	if (file->mode & STREAM_OUT)
+		fflush(file->fd);
+#endif
+
+	request = queue_pop(&async->free);
+	request->op = op;
+	request->fd = file->fd;
+	request->result.userdata = userdata;
+	request->result.stream = stream;
+	request->result.buffer = buffer;
+	request->result.offset = offset;
+	request->result.size = size;
+	request->result.transferred = 0;
+	request->result.write = (op == FS_ASYNC_WRITE);
+	request->result.op = (fs_async_op_t)op;
+	atomic_incr32(&async->pending);
+
+#if FOUNDATION_HAVE_IO_URING
+	if (async->ring >= 0) {
+		_fs_uring_submit(async, request);
+		return true;
+	}
+#endif
+	queue_push(&async->submit, request);
+	return true;
+}
+
+bool
+fs_async_read(fs_async_t* async, stream_t* stream, size_t offset, void* buffer, size_t size,
+              void* userdata) {
+	return _fs_async_submit(async, FS_ASYNC_READ, stream, offset, buffer, size, userdata);
+}
+
+bool
+fs_async_write(fs_async_t* async, stream_t* stream, size_t offset, const void* buffer, size_t size,
+               void* userdata) {
+	return _fs_async_submit(async, FS_ASYNC_WRITE, stream, offset, (void*)(uintptr_t)buffer, size,
+	                        userdata);
+}
+
+bool
+fs_async_submit(fs_async_t* async, const fs_async_operation_t* operations, size_t count) {
+	size_t iop;
+#if FOUNDATION_HAVE_IO_URING
+	unsigned int queued = 0;
+#endif
+
+	for (iop = 0; iop < count; ++iop) {
+		const fs_async_operation_t* operation = operations + iop;
+		string_const_t path = _fs_strip_protocol(STRING_ARGS(operation->path));
+		string_const_t destination = _fs_strip_protocol(STRING_ARGS(operation->destination));
+		if ((operation->op <= FS_ASYNC_WRITE) || (operation->op > FS_ASYNC_TOUCH))
+			return false;
+		if (!path.length || (path.length >= BUILD_MAX_PATHLEN) ||
+		        (destination.length >= BUILD_MAX_PATHLEN))
+			return false;
+		if ((operation->op == FS_ASYNC_COPY_FILE) && !destination.length)
+			return false;
+	}
+
+	for (iop = 0; iop < count; ++iop) {
+		const fs_async_operation_t* operation = operations + iop;
+		string_const_t path = _fs_strip_protocol(STRING_ARGS(operation->path));
+		string_const_t destination = _fs_strip_protocol(STRING_ARGS(operation->destination));
+		fs_async_request_t* request = queue_try_pop(&async->free, 0);
+		if (!request) {
+#if FOUNDATION_HAVE_IO_URING
+			//Flush what is already queued so completions can free up requests
+			if (queued) {
+				mutex_lock(async->lock);
+				_fs_uring_flush(async, queued);
+				mutex_unlock(async->lock);
+				queued = 0;
+			}
+#endif
+			request = queue_pop(&async->free);
+		}
+
+		memset(&request->result, 0, sizeof(request->result));
+		request->op = (int)operation->op;
+		request->fd = 0;
+		request->result.op = operation->op;
+		request->result.userdata = operation->userdata;
+		request->path_length = path.length;
+		memcpy(request->path, path.str, path.length);
+		request->path[path.length] = 0;
+		request->destination_length = destination.length;
+		memcpy(request->destination, destination.str, destination.length);
+		request->destination[destination.length] = 0;
+		atomic_incr32(&async->pending);
+
+#if FOUNDATION_HAVE_IO_URING
+		if (async->ring >= 0) {
+			bool ring = ((async->ring_ops & (1U << operation->op)) != 0);
+			mutex_lock(async->lock);
+			//Directory creation falls back to workers for existing or nested directories
+			if (!ring || (operation->op == FS_ASYNC_MAKE_DIRECTORY))
+				_fs_async_start_workers(async);
+			if (ring) {
+				_fs_uring_prepare(async, request);
+				++queued;
+			}
+			mutex_unlock(async->lock);
+			if (ring)
+				continue;
+		}
+#endif
+		queue_push(&async->submit, request);
+	}
+
+#if FOUNDATION_HAVE_IO_URING
+	if (queued) {
+		mutex_lock(async->lock);
+		_fs_uring_flush(async, queued);
+		mutex_unlock(async->lock);
+	}
+#endif
+	return true;
+}
+
+size_t
+fs_async_completed(fs_async_t* async, fs_async_result_t* results, size_t capacity) {
+	size_t count, remain;
+	mutex_lock(async->lock);
+	count = array_size(async->completed);
+	if (count > capacity)
+		count = capacity;
+	if (count) {
+		memcpy(results, async->completed, sizeof(fs_async_result_t) * count);
+		remain = array_size(async->completed) - count;
+		if (remain)
+			memmove(async->completed, async->completed + count, sizeof(fs_async_result_t) * remain);
+		array_resize(async->completed, remain);
+	}
+	mutex_unlock(async->lock);
+	return count;
+}
+
+size_t
+fs_async_pending(fs_async_t* async) {
+	return (size_t)atomic_load32(&async->pending);
+}
+
 int
 _fs_initialize(void) {
 #if FOUNDATION_HAVE_FS_MONITOR
@@ -2068,8 +4433,21 @@ _fs_initialize(void) {
 
 	_fs_event_stream = event_stream_allocate(512);
 
+#if FOUNDATION_HAVE_FS_MONITOR
+	if (_foundation_config.fs_stat_cache_size) {
+		_fs_stat_cache = memory_allocate(HASH_STREAM,
+		                                 sizeof(fs_stat_entry_t) * _foundation_config.fs_stat_cache_size,
+		                                 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		_fs_stat_cache_lock = mutex_allocate(STRING_CONST("fs_stat_cache"));
+	}
+#endif
+
 	_fs_file_vtable.read = _fs_file_read;
 	_fs_file_vtable.write = _fs_file_write;
+#if FOUNDATION_PLATFORM_POSIX
+	_fs_file_vtable.read_vector = _fs_file_read_vector;
+	_fs_file_vtable.write_vector = _fs_file_write_vector;
+#endif
 	_fs_file_vtable.eos = _fs_file_eos;
 	_fs_file_vtable.flush = _fs_file_flush;
 	_fs_file_vtable.truncate = _fs_file_truncate;
@@ -2081,13 +4459,30 @@ _fs_initialize(void) {
 	_fs_file_vtable.available_read = _fs_file_available_read;
 	_fs_file_vtable.finalize = _fs_file_finalize;
 	_fs_file_vtable.clone = _fs_file_clone;
+	_fs_file_vtable.advise = _fs_file_advise;
+
+	_fs_mapped_vtable.read = _fs_mapped_read;
+	_fs_mapped_vtable.write = _fs_mapped_write;
+	_fs_mapped_vtable.eos = _fs_mapped_eos;
+	_fs_mapped_vtable.size = _fs_mapped_size;
+	_fs_mapped_vtable.seek = _fs_mapped_seek;
+	_fs_mapped_vtable.tell = _fs_mapped_tell;
+	_fs_mapped_vtable.lastmod = _fs_mapped_last_modified;
+	_fs_mapped_vtable.available_read = _fs_mapped_available_read;
+	_fs_mapped_vtable.finalize = _fs_mapped_finalize;
+	_fs_mapped_vtable.clone = _fs_mapped_clone;
+	_fs_mapped_vtable.advise = _fs_mapped_advise;
 
 	_ringbuffer_stream_initialize();
 	_buffer_stream_initialize();
+	_compressed_stream_initialize();
+	_base64_stream_initialize();
+	_cipher_stream_initialize();
 #if FOUNDATION_PLATFORM_ANDROID
 	_asset_stream_initialize();
 #endif
 	_pipe_stream_initialize();
+	_socket_stream_initialize();
 
 #if FOUNDATION_PLATFORM_PNACL
 
@@ -2144,6 +4539,12 @@ _fs_finalize(void) {
 			_fs_stop_monitor(_fs_monitors + mi);
 	mutex_deallocate(_fs_monitor_lock);
 
+	string_array_deallocate(_fs_stat_cache_roots);
+	mutex_deallocate(_fs_stat_cache_lock);
+	memory_deallocate(_fs_stat_cache);
+	_fs_stat_cache_lock = 0;
+	_fs_stat_cache = 0;
+
 	event_stream_deallocate(_fs_event_stream);
 	_fs_event_stream = 0;
 
@@ -36,6 +36,49 @@ events on platforms supporting this. */
 FOUNDATION_API stream_t*
 fs_open_file(const char* path, size_t length, unsigned int mode);
 
+/*! Open a stream for a file by mapping the file into memory, allowing zero-copy access to
+the file content through #fs_mapped_data. Also available through the "mmap" stream protocol,
+for example stream_open("mmap:///path/to/file", ...). The file content must not be modified
+while mapped. With STREAM_OUT the file is mapped copy-on-write, writes through the stream or
+to the mapped memory only modify private copies of the touched pages and are never written
+back to the file, and the stream size is fixed to the file size. Mapping is not supported on
+all platforms. On Android, paths prefixed with "asset://" open an asset stream mapping the
+asset directly from the application package, which is only possible for assets stored
+uncompressed and opened without STREAM_OUT.
+\param path Path, optionally prefixed with "mmap://"
+\param length Length of path
+\param mode Open mode, must include STREAM_IN, STREAM_OUT maps the file copy-on-write
+\return Stream, 0 if file could not be opened or mapped */
+FOUNDATION_API stream_t*
+fs_map_file(const char* path, size_t length, unsigned int mode);
+
+/*! Get pointer to the memory mapped content of a stream opened with #fs_map_file, or of an
+Android asset stream for an asset stored uncompressed. The pointer is valid until the stream
+is deallocated.
+\param stream Memory mapped stream
+\param size Optional, receives the size of the mapped content in bytes
+\return Pointer to mapped content, 0 if stream is not memory mapped or file is empty */
+FOUNDATION_API const void*
+fs_mapped_data(stream_t* stream, size_t* size);
+
+/*! Hint the expected access pattern of a memory mapped stream to the virtual memory system.
+Ignored on platforms without support for access hints.
+\param stream Memory mapped stream
+\param advice Access pattern */
+FOUNDATION_API void
+fs_map_advise(stream_t* stream, fs_map_advice_t advice);
+
+/*! Start or stop background prefetching for a file stream read sequentially. A prefetch
+thread reads ahead of the stream position through a separate file handle, pulling the next
+window of the file into the file system cache so stream reads do not wait on storage
+latency. Prefetching is stopped when the stream is deallocated. Ignored for streams other
+than file streams opened for reading.
+\param stream File stream
+\param window Number of bytes to keep prefetched ahead of the stream position, 0 to stop
+               prefetching */
+FOUNDATION_API void
+fs_prefetch(stream_t* stream, size_t window);
+
 /*! Copy source file to destination path in the file system, creating directories if needed
 \param source  Source file path
 \param srclen  Length of source file path
@@ -45,6 +88,17 @@ fs_open_file(const char* path, size_t length, unsigned int mode);
 FOUNDATION_API bool
 fs_copy_file(const char* source, size_t srclen, const char* dest, size_t destlen);
 
+/*! Move source file to destination path in the file system, replacing any existing file at
+the destination path. Falls back to copy and remove if the file cannot be renamed, for
+example when moving across file systems.
+\param source  Source file path
+\param srclen  Length of source file path
+\param dest    Destination file path
+\param destlen Length of destination file path
+\return        true if successful, false if failure */
+FOUNDATION_API bool
+fs_move_file(const char* source, size_t srclen, const char* dest, size_t destlen);
+
 /*! Remove a file from the file system
 \param path   Path
 \param length Length of path
@@ -109,6 +163,48 @@ of this function (slow)
 FOUNDATION_API uint128_t
 fs_md5(const char* path, size_t length);
 
+/*! Get file SHA-256 digest. The file is memory mapped and digested in place if possible,
+otherwise read through a file stream.
+\param path   File path
+\param length Length of path
+\return       SHA-256 digest, 0 if not an existing file or unreadable */
+FOUNDATION_API uint256_t
+fs_sha256(const char* path, size_t length);
+
+/*! Get MD5 digests of a number of files. The files are memory mapped in batches and digested
+in parallel SIMD lanes with #md5_digest_multi, each digest is equal to the one given by #fs_md5.
+\param scheduler Optional task scheduler digesting batches in parallel, 0 for calling thread only
+\param paths     File paths
+\param count     Number of paths
+\param digests   Array receiving the digest of each file, 0 if not existing or unreadable */
+FOUNDATION_API void
+fs_md5_files(task_scheduler_t* scheduler, const string_const_t* paths, size_t count,
+             uint128_t* digests);
+
+/*! Get file checksum. The file is memory mapped if possible, otherwise read in large
+aligned blocks. The content is split in 1MiB chunks hashed independently, and the checksum
+is the checksum of the little endian chunk checksums in order, allowing the chunks to be
+hashed in parallel. A file no larger than one chunk has the same checksum as its content
+as given by #checksum. The value does not depend on if a scheduler is used or not.
+\param scheduler Optional task scheduler hashing chunks in parallel, 0 for calling thread only
+\param path      File path
+\param length    Length of path
+\param type      Checksum algorithm
+\return          Checksum, 0 if not an existing file or unreadable */
+FOUNDATION_API uint64_t
+fs_checksum(task_scheduler_t* scheduler, const char* path, size_t length, checksum_type_t type);
+
+/*! Get checksums of a number of files concurrently, see #fs_checksum. Each file is hashed
+by a single task.
+\param scheduler Optional task scheduler hashing files in parallel, 0 for calling thread only
+\param paths     File paths
+\param count     Number of paths
+\param type      Checksum algorithm
+\param checksums Array receiving the checksum of each file, 0 if not existing or unreadable */
+FOUNDATION_API void
+fs_checksum_files(task_scheduler_t* scheduler, const string_const_t* paths, size_t count,
+                  checksum_type_t type, uint64_t* checksums);
+
 /*! Get files matching the given pattern. The pattern should be a regular
 expression supported by the regex parser in the library (see regex.h documentation).
 For example, to find all files with a given extension ".ext", use the regex "^.*\\.ext$"
@@ -147,8 +243,51 @@ fs_files(const char* path, size_t length);
 FOUNDATION_API string_t*
 fs_subdirs(const char* path, size_t length);
 
+/*! List all entries in the given directory path together with entry type, size and last
+modification time, gathered in a single pass over the directory. Much faster than calling
+#fs_is_file, #fs_size and #fs_last_modified for each name returned by #fs_files and
+#fs_subdirs. The listing, including all entry names, is allocated as one contiguous memory
+block, free it with #fs_listing_deallocate. The . and .. entries are not included and
+entries are not sorted.
+\param path   Path of directory
+\param length Length of path
+\return       Directory listing, null if path is not a readable directory */
+FOUNDATION_API fs_listing_t*
+fs_list_directory(const char* path, size_t length);
+
+/*! Deallocate a directory listing returned by #fs_list_directory
+\param listing Directory listing */
+FOUNDATION_API void
+fs_listing_deallocate(fs_listing_t* listing);
+
+/*! Recursively walk the given directory path, reporting each entry found to the callback as
+directories are read. Subdirectories are read in parallel as separate tasks on the given task
+scheduler, and the callback is called concurrently from the worker threads. Without a
+scheduler the walk is done sequentially on the calling thread. Subdirectories can be pruned
+either by the callback returning false, or by the exclude pattern matching the directory
+name, in which case the directory is not reported to the callback. The call returns when the
+entire tree has been walked.
+\param scheduler Task scheduler, null to walk on the calling thread
+\param path      Path of directory
+\param length    Length of path
+\param exclude   Pattern matching names of directories to prune, null to walk all
+\param callback  Callback receiving entries
+\param arg       Argument passed to callback
+\return          Number of entries reported to the callback */
+FOUNDATION_API size_t
+fs_walk(task_scheduler_t* scheduler, const char* path, size_t length, regex_t* exclude,
+        fs_walk_fn callback, void* arg);
+
 /*! Monitor the path (recursive) for file system changes. Changes are notified as file system
-events in the event stream returned by #fs_event_stream
+events in the event stream returned by #fs_event_stream. If the stat cache is enabled with
+foundation_config_t::fs_stat_cache_size, results of #fs_is_file, #fs_is_directory, #fs_size
+and #fs_last_modified for paths below a monitored path are cached until the monitor notifies
+a change, or the path is modified through the fs functions. Paths not monitored are always
+queried directly. Changes made by other processes are reflected once the monitor has
+processed the change notification. If foundation_config_t::fs_monitor_coalesce is set,
+repeated modifications of a file are posted as a single #FOUNDATIONEVENT_FILE_MODIFIED event
+at the end of the coalescing window, and a pending modification is dropped if the file is
+deleted before the window ends.
 \param path   File system path
 \param length Length of path
 \return true if successful, false if not */
@@ -168,6 +307,19 @@ of the same program.
 FOUNDATION_API stream_t*
 fs_temporary_file(void);
 
+/*! Create an anonymous temporary file for scratch data that never needs to be durable. The
+file has no name in the file system and is removed when the stream is deallocated. On Linux
+and Android the file is backed by memory with memfd_create and only written to swap under
+memory pressure, falling back to an unnamed O_TMPFILE file or a file unlinked directly after
+creation in the temporary directory. On Windows the file is created with the temporary
+attribute and deleted on close, keeping data in the file cache unless under memory pressure.
+The stream has no path, so it cannot be cloned or mapped, and the last modification
+timestamp is zero. If no anonymous file can be created, a file is created as with
+#fs_temporary_file
+\return Temporary file */
+FOUNDATION_API stream_t*
+fs_temporary_file_anonymous(void);
+
 /*! Post a file event
 \param id     Event id
 \param path   Path
@@ -180,3 +332,82 @@ fs_post_event(foundation_event_id id, const char* path, size_t length);
 FOUNDATION_API event_stream_t*
 fs_event_stream(void);
 
+/*! Allocate a context for asynchronous positional reads and writes on file streams. On
+Linux requests are submitted through io_uring, on other platforms (or if io_uring is not
+available) they are executed by a small pool of worker threads. Each completion is either
+posted as a FOUNDATIONEVENT_FILE_ASYNC_COMPLETE event to the given event stream, or if no
+stream is given queued for #fs_async_completed. The beacon, if any, is fired on each
+completion.
+\param depth Maximum number of requests in flight, zero for default (64)
+\param events Event stream receiving completion events, null to queue completions
+\param beacon Beacon to fire on completion, may be null
+\return New context */
+FOUNDATION_API fs_async_t*
+fs_async_allocate(size_t depth, event_stream_t* events, beacon_t* beacon);
+
+/*! Deallocate an asynchronous file I/O context, waiting for all requests in flight
+to complete.
+\param async Context */
+FOUNDATION_API void
+fs_async_deallocate(fs_async_t* async);
+
+/*! Submit an asynchronous read from the given offset in a file stream. Blocks if the
+maximum number of requests are in flight. The stream and buffer must remain valid until
+the request completes. The stream position is not affected.
+\param async Context
+\param stream File stream opened for reading
+\param offset File offset
+\param buffer Destination buffer
+\param size Number of bytes to read
+\param userdata User data passed back in result
+\return true if request was submitted, false if stream is not a readable file stream */
+FOUNDATION_API bool
+fs_async_read(fs_async_t* async, stream_t* stream, size_t offset, void* buffer, size_t size,
+              void* userdata);
+
+/*! Submit an asynchronous write to the given offset in a file stream. Blocks if the
+maximum number of requests are in flight. Data buffered in the stream is flushed before
+the request is submitted. The stream and buffer must remain valid until the request
+completes. The stream position is not affected.
+\param async Context
+\param stream File stream opened for writing
+\param offset File offset
+\param buffer Source buffer
+\param size Number of bytes to write
+\param userdata User data passed back in result
+\return true if request was submitted, false if stream is not a writable file stream */
+FOUNDATION_API bool
+fs_async_write(fs_async_t* async, stream_t* stream, size_t offset, const void* buffer,
+               size_t size, void* userdata);
+
+/*! Submit a batch of asynchronous file system operations (stat, remove file, make
+directory, copy file or touch). Operations in a batch may complete in any order, each
+completion is reported like read and write requests with the operation in the result op
+field. The transferred field is zero on success and negative on failure, a successful stat
+operation also fills the type, size and last_modified fields. With io_uring, stat, remove
+file and make directory are submitted to the ring with a single system call per batch,
+other operations are executed by worker threads started on first use. Blocks if the
+maximum number of requests are in flight. Paths are copied and need not remain valid.
+\param async Context
+\param operations Operations to submit
+\param count Number of operations
+\return true if all operations were submitted, false if any operation is invalid in which
+        case no operation is submitted */
+FOUNDATION_API bool
+fs_async_submit(fs_async_t* async, const fs_async_operation_t* operations, size_t count);
+
+/*! Fetch queued results of completed requests, for contexts allocated without an
+event stream.
+\param async Context
+\param results Array receiving results
+\param capacity Capacity of results array
+\return Number of results stored */
+FOUNDATION_API size_t
+fs_async_completed(fs_async_t* async, fs_async_result_t* results, size_t capacity);
+
+/*! Get number of submitted requests not yet completed
+\param async Context
+\return Number of requests in flight */
+FOUNDATION_API size_t
+fs_async_pending(fs_async_t* async);
+
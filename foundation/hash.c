@@ -12,13 +12,24 @@
 
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
+#include <foundation/hashstrings_table.h>
 
 #if FOUNDATION_COMPILER_MSVC
 #  include <stdlib.h>
+#  include <intrin.h>
 #elif FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
 #  define _rotl64(a, bits) (((a) << (uint64_t)(bits)) | ((a) >> (64ULL - (uint64_t)(bits))))
 #endif
 
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define HASH_XXH3_SSE2 1
+#  include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define HASH_XXH3_NEON 1
+#  include <arm_neon.h>
+#endif
+
 #define HASH_SEED 0xbaadf00d
 
 //-----------------------------------------------------------------------------
@@ -79,12 +90,28 @@ fmix64(uint64_t k) {
 	return k;
 }
 
-hash_t
-hash(const void* key, size_t len) {
+//Convert ascii upper case characters in block to lower case, leaving other bytes unchanged
+static FOUNDATION_FORCEINLINE uint64_t
+fold64(uint64_t block) {
+	uint64_t heptets = block & 0x7F7F7F7F7F7F7F7FULL;
+	uint64_t is_ge_a = heptets + 0x3F3F3F3F3F3F3F3FULL;
+	uint64_t is_gt_z = heptets + 0x2525252525252525ULL;
+	uint64_t is_upper = (is_ge_a ^ is_gt_z) & ~block & 0x8080808080808080ULL;
+	return block | (is_upper >> 2);
+}
+
+static FOUNDATION_FORCEINLINE uint8_t
+fold8(uint8_t c) {
+	return ((c >= 'A') && (c <= 'Z')) ? (uint8_t)(c | 0x20) : c;
+}
+
+static FOUNDATION_FORCEINLINE hash_t
+murmur3(const void* key, size_t len, const bool fold) {
 	const size_t nblocks = len / 16;
 	const uint64_t* blocks;
 	size_t i;
 	const uint8_t* tail;
+	uint8_t folded[16];
 	uint64_t k1;
 	uint64_t k2;
 
@@ -105,6 +132,10 @@ hash(const void* key, size_t len) {
 		for (i = 0; i < nblocks; ++i) {
 			k1 = getblock_nonaligned(key, i * 2);
 			k2 = getblock_nonaligned(key, i * 2 + 1);
+			if (fold) {
+				k1 = fold64(k1);
+				k2 = fold64(k2);
+			}
 
 			bmix64(h1, h2, k1, k2, c1, c2);
 		}
@@ -113,6 +144,10 @@ hash(const void* key, size_t len) {
 		for (i = 0; i < nblocks; ++i) {
 			k1 = getblock(blocks, i * 2);
 			k2 = getblock(blocks, i * 2 + 1);
+			if (fold) {
+				k1 = fold64(k1);
+				k2 = fold64(k2);
+			}
 
 			bmix64(h1, h2, k1, k2, c1, c2);
 		}
@@ -125,6 +160,12 @@ hash(const void* key, size_t len) {
 	k1 = 0;
 	k2 = 0;
 
+	if (fold && (len & 15)) {
+		for (i = 0; i < (len & 15); ++i)
+			folded[i] = fold8(tail[i]);
+		tail = folded;
+	}
+
 	switch (len & 15) { /*lint -save -e616 -e825 -e744 */
 	case 15: k2 ^= ((uint64_t)tail[14]) << 48;
 	case 14: k2 ^= ((uint64_t)tail[13]) << 40;
@@ -165,73 +206,715 @@ hash(const void* key, size_t len) {
 	return h1;
 }
 
+hash_t
+hash(const void* key, size_t len) {
+	return murmur3(key, len, false);
+}
 
-#if BUILD_ENABLE_STATIC_HASH_DEBUG
+hash_t
+hash_nocase(const void* key, size_t len) {
+	return murmur3(key, len, true);
+}
 
-static hashtable64_t* _hash_lookup;
+//-----------------------------------------------------------------------------
+// XXH3 by Yann Collet, https://github.com/Cyan4973/xxHash
+// Results are identical to the reference XXH3_64bits_withSeed and XXH3_128bits_withSeed
+
+#define XXH_PRIME32_1 0x9E3779B1U
+#define XXH_PRIME32_2 0x85EBCA77U
+#define XXH_PRIME32_3 0xC2B2AE3DU
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+#define XXH_PRIME_MX1 0x165667919E3779F9ULL
+#define XXH_PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define XXH3_SECRET_SIZE 192
+#define XXH3_STRIPE_LEN 64
+#define XXH3_SECRET_CONSUME_RATE 8
+#define XXH3_STRIPES_PER_BLOCK ((XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE)
+#define XXH3_BLOCK_LEN (XXH3_STRIPE_LEN * XXH3_STRIPES_PER_BLOCK)
+#define XXH3_MIDSIZE_MAX 240
+#define XXH3_BUFFER_SIZE 256
+
+static const uint8_t xxh3_secret[XXH3_SECRET_SIZE] = {
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+static const uint64_t xxh3_init_acc[8] = {
+	XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3,
+	XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1
+};
+
+static FOUNDATION_FORCEINLINE uint32_t
+xxh3_read32(const uint8_t* p) {
+	uint32_t val;
+	memcpy(&val, p, sizeof(val));
+	return byteorder_littleendian32(val);
+}
 
-int
-_static_hash_initialize(void) {
-	if (!_hash_lookup && _foundation_config.hash_store_size)
-		_hash_lookup = hashtable64_allocate(_foundation_config.hash_store_size + 1);
-	return 0;
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_read64(const uint8_t* p) {
+	uint64_t val;
+	memcpy(&val, p, sizeof(val));
+	return byteorder_littleendian64(val);
 }
 
-void
-_static_hash_finalize(void) {
-	size_t slot;
-	if (_hash_lookup) for (slot = 0; slot < _foundation_config.hash_store_size + 1; ++slot) {
-			char* str = (char*)((uintptr_t)hashtable64_raw(_hash_lookup, slot));
-			if (str)
-				string_deallocate(str);
+static FOUNDATION_FORCEINLINE void
+xxh3_write64(uint8_t* p, uint64_t val) {
+	val = byteorder_littleendian64(val);
+	memcpy(p, &val, sizeof(val));
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_rotl64(uint64_t val, unsigned int bits) {
+	return (val << bits) | (val >> (64 - bits));
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_mul128(uint64_t a, uint64_t b, uint64_t* high) {
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 xxh3_uint128_t;
+	xxh3_uint128_t product = (xxh3_uint128_t)a * b;
+	*high = (uint64_t)(product >> 64);
+	return (uint64_t)product;
+#elif FOUNDATION_COMPILER_MSVC && FOUNDATION_ARCH_X86_64
+	return _umul128(a, b, high);
+#else
+	const uint64_t mask = 0xFFFFFFFFULL;
+	const uint64_t ad = (a >> 32) * (b & mask), bc = (a & mask) * (b >> 32);
+	const uint64_t bd = (a & mask) * (b & mask);
+	const uint64_t mid = (bd >> 32) + (ad & mask) + (bc & mask);
+	*high = ((a >> 32) * (b >> 32)) + (ad >> 32) + (bc >> 32) + (mid >> 32);
+	return (mid << 32) | (bd & mask);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_mul128_fold64(uint64_t a, uint64_t b) {
+	uint64_t high;
+	uint64_t low = xxh3_mul128(a, b, &high);
+	return low ^ high;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh64_avalanche(uint64_t h) {
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_avalanche(uint64_t h) {
+	h ^= h >> 37;
+	h *= XXH_PRIME_MX1;
+	h ^= h >> 32;
+	return h;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_rrmxmx(uint64_t h, uint64_t len) {
+	h ^= xxh3_rotl64(h, 49) ^ xxh3_rotl64(h, 24);
+	h *= XXH_PRIME_MX2;
+	h ^= (h >> 35) + len;
+	h *= XXH_PRIME_MX2;
+	return h ^ (h >> 28);
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_mix16(const uint8_t* input, const uint8_t* secret, uint64_t seed) {
+	return xxh3_mul128_fold64(xxh3_read64(input) ^ (xxh3_read64(secret) + seed),
+	                          xxh3_read64(input + 8) ^ (xxh3_read64(secret + 8) - seed));
+}
+
+static FOUNDATION_FORCEINLINE void
+xxh3_mix32(uint64_t acc[2], const uint8_t* input0, const uint8_t* input1, const uint8_t* secret,
+           uint64_t seed) {
+	acc[0] += xxh3_mix16(input0, secret, seed);
+	acc[0] ^= xxh3_read64(input1) + xxh3_read64(input1 + 8);
+	acc[1] += xxh3_mix16(input1, secret + 16, seed);
+	acc[1] ^= xxh3_read64(input0) + xxh3_read64(input0 + 8);
+}
+
+static void
+xxh3_init_secret(uint8_t* secret, uint64_t seed) {
+	size_t i;
+	for (i = 0; i < XXH3_SECRET_SIZE; i += 16) {
+		xxh3_write64(secret + i, xxh3_read64(xxh3_secret + i) + seed);
+		xxh3_write64(secret + i + 8, xxh3_read64(xxh3_secret + i + 8) - seed);
+	}
+}
+
+//Accumulate a number of 64 byte stripes, stepping the secret 8 bytes per stripe
+static void
+xxh3_accumulate(uint64_t* FOUNDATION_RESTRICT acc, const uint8_t* FOUNDATION_RESTRICT input,
+                const uint8_t* FOUNDATION_RESTRICT secret, size_t stripes) {
+	size_t istripe, i;
+#if HASH_XXH3_SSE2
+	__m128i vacc[4];
+	for (i = 0; i < 4; ++i)
+		vacc[i] = _mm_loadu_si128((const __m128i*)(const void*)(acc + (i * 2)));
+	for (istripe = 0; istripe < stripes; ++istripe) {
+		const uint8_t* in = input + (istripe * XXH3_STRIPE_LEN);
+		const uint8_t* key = secret + (istripe * XXH3_SECRET_CONSUME_RATE);
+		for (i = 0; i < 4; ++i) {
+			__m128i data = _mm_loadu_si128((const __m128i*)(const void*)(in + (i * 16)));
+			__m128i secret_key = _mm_loadu_si128((const __m128i*)(const void*)(key + (i * 16)));
+			__m128i data_key = _mm_xor_si128(data, secret_key);
+			__m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+			__m128i product = _mm_mul_epu32(data_key, data_key_high);
+			__m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+			vacc[i] = _mm_add_epi64(vacc[i], _mm_add_epi64(product, swapped));
+		}
+	}
+	for (i = 0; i < 4; ++i)
+		_mm_storeu_si128((__m128i*)(void*)(acc + (i * 2)), vacc[i]);
+#elif HASH_XXH3_NEON
+	uint64x2_t vacc[4];
+	for (i = 0; i < 4; ++i)
+		vacc[i] = vld1q_u64(acc + (i * 2));
+	for (istripe = 0; istripe < stripes; ++istripe) {
+		const uint8_t* in = input + (istripe * XXH3_STRIPE_LEN);
+		const uint8_t* key = secret + (istripe * XXH3_SECRET_CONSUME_RATE);
+		for (i = 0; i < 4; ++i) {
+			uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(in + (i * 16)));
+			uint64x2_t data_key = veorq_u64(data, vreinterpretq_u64_u8(vld1q_u8(key + (i * 16))));
+			vacc[i] = vaddq_u64(vacc[i], vextq_u64(data, data, 1));
+			vacc[i] = vmlal_u32(vacc[i], vmovn_u64(data_key), vshrn_n_u64(data_key, 32));
 		}
+	}
+	for (i = 0; i < 4; ++i)
+		vst1q_u64(acc + (i * 2), vacc[i]);
+#else
+	for (istripe = 0; istripe < stripes; ++istripe) {
+		const uint8_t* in = input + (istripe * XXH3_STRIPE_LEN);
+		const uint8_t* key = secret + (istripe * XXH3_SECRET_CONSUME_RATE);
+		for (i = 0; i < 8; ++i) {
+			uint64_t data = xxh3_read64(in + (i * 8));
+			uint64_t data_key = data ^ xxh3_read64(key + (i * 8));
+			acc[i ^ 1] += data;
+			acc[i] += (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+		}
+	}
+#endif
+}
 
-	hashtable64_deallocate(_hash_lookup);
-	_hash_lookup = 0;
+static void
+xxh3_scramble(uint64_t* FOUNDATION_RESTRICT acc, const uint8_t* FOUNDATION_RESTRICT secret) {
+	size_t i;
+#if HASH_XXH3_SSE2
+	const __m128i prime = _mm_set1_epi32((int)XXH_PRIME32_1);
+	for (i = 0; i < 4; ++i) {
+		__m128i vacc = _mm_loadu_si128((const __m128i*)(const void*)(acc + (i * 2)));
+		__m128i secret_key = _mm_loadu_si128((const __m128i*)(const void*)(secret + (i * 16)));
+		__m128i data_key = _mm_xor_si128(_mm_xor_si128(vacc, _mm_srli_epi64(vacc, 47)), secret_key);
+		__m128i data_key_high = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+		__m128i product_low = _mm_mul_epu32(data_key, prime);
+		__m128i product_high = _mm_mul_epu32(data_key_high, prime);
+		vacc = _mm_add_epi64(product_low, _mm_slli_epi64(product_high, 32));
+		_mm_storeu_si128((__m128i*)(void*)(acc + (i * 2)), vacc);
+	}
+#elif HASH_XXH3_NEON
+	const uint32x2_t prime = vdup_n_u32(XXH_PRIME32_1);
+	for (i = 0; i < 4; ++i) {
+		uint64x2_t vacc = vld1q_u64(acc + (i * 2));
+		uint64x2_t data_key = veorq_u64(veorq_u64(vacc, vshrq_n_u64(vacc, 47)),
+		                                vreinterpretq_u64_u8(vld1q_u8(secret + (i * 16))));
+		uint64x2_t product_high = vshlq_n_u64(vmull_u32(vshrn_n_u64(data_key, 32), prime), 32);
+		vst1q_u64(acc + (i * 2), vmlal_u32(product_high, vmovn_u64(data_key), prime));
+	}
+#else
+	for (i = 0; i < 8; ++i) {
+		uint64_t val = acc[i];
+		val ^= val >> 47;
+		val ^= xxh3_read64(secret + (i * 8));
+		acc[i] = val * XXH_PRIME32_1;
+	}
+#endif
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_merge(const uint64_t* acc, const uint8_t* secret, uint64_t start) {
+	uint64_t result = start;
+	size_t i;
+	for (i = 0; i < 4; ++i)
+		result += xxh3_mul128_fold64(acc[i * 2] ^ xxh3_read64(secret + (i * 16)),
+		                             acc[(i * 2) + 1] ^ xxh3_read64(secret + (i * 16) + 8));
+	return xxh3_avalanche(result);
+}
+
+//Accumulate stripes continuing at the given stripe in the current block, scrambling the
+//accumulators at the end of each block
+static void
+xxh3_consume(uint64_t* acc, size_t* block_stripes, const uint8_t* input, size_t stripes,
+             const uint8_t* secret) {
+	while (stripes) {
+		size_t count = XXH3_STRIPES_PER_BLOCK - *block_stripes;
+		if (count > stripes)
+			count = stripes;
+		xxh3_accumulate(acc, input, secret + (*block_stripes * XXH3_SECRET_CONSUME_RATE), count);
+		*block_stripes += count;
+		if (*block_stripes == XXH3_STRIPES_PER_BLOCK) {
+			xxh3_scramble(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+			*block_stripes = 0;
+		}
+		input += count * XXH3_STRIPE_LEN;
+		stripes -= count;
+	}
+}
+
+//Accumulate all data of more than 240 bytes, leaving accumulators ready for merging
+static void
+xxh3_hash_long(uint64_t* acc, const uint8_t* input, size_t len, const uint8_t* secret) {
+	size_t block_stripes = 0;
+	memcpy(acc, xxh3_init_acc, sizeof(xxh3_init_acc));
+	xxh3_consume(acc, &block_stripes, input, (len - 1) / XXH3_STRIPE_LEN, secret);
+	xxh3_accumulate(acc, input + len - XXH3_STRIPE_LEN,
+	                secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - 7, 1);
+}
+
+static uint64_t
+xxh3_hash64_short(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+	uint64_t acc;
+	size_t i;
+	if (len <= 16) {
+		if (len > 8) {
+			uint64_t low = xxh3_read64(input) ^
+			               ((xxh3_read64(secret + 24) ^ xxh3_read64(secret + 32)) + seed);
+			uint64_t high = xxh3_read64(input + len - 8) ^
+			                ((xxh3_read64(secret + 40) ^ xxh3_read64(secret + 48)) - seed);
+			acc = len + byteorder_swap64(low) + high + xxh3_mul128_fold64(low, high);
+			return xxh3_avalanche(acc);
+		}
+		if (len >= 4) {
+			uint64_t keyed;
+			seed ^= (uint64_t)byteorder_swap32((uint32_t)seed) << 32;
+			keyed = ((uint64_t)xxh3_read32(input + len - 4) + ((uint64_t)xxh3_read32(input) << 32)) ^
+			        ((xxh3_read64(secret + 8) ^ xxh3_read64(secret + 16)) - seed);
+			return xxh3_rrmxmx(keyed, len);
+		}
+		if (len) {
+			uint32_t combined = ((uint32_t)input[0] << 16) | ((uint32_t)input[len >> 1] << 24) |
+			                    (uint32_t)input[len - 1] | ((uint32_t)len << 8);
+			uint64_t bitflip = (uint64_t)(xxh3_read32(secret) ^ xxh3_read32(secret + 4)) + seed;
+			return xxh64_avalanche((uint64_t)combined ^ bitflip);
+		}
+		return xxh64_avalanche(seed ^ xxh3_read64(secret + 56) ^ xxh3_read64(secret + 64));
+	}
+
+	acc = len * XXH_PRIME64_1;
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96) {
+					acc += xxh3_mix16(input + 48, secret + 96, seed);
+					acc += xxh3_mix16(input + len - 64, secret + 112, seed);
+				}
+				acc += xxh3_mix16(input + 32, secret + 64, seed);
+				acc += xxh3_mix16(input + len - 48, secret + 80, seed);
+			}
+			acc += xxh3_mix16(input + 16, secret + 32, seed);
+			acc += xxh3_mix16(input + len - 32, secret + 48, seed);
+		}
+		acc += xxh3_mix16(input, secret, seed);
+		acc += xxh3_mix16(input + len - 16, secret + 16, seed);
+		return xxh3_avalanche(acc);
+	}
+
+	for (i = 0; i < 8; ++i)
+		acc += xxh3_mix16(input + (i * 16), secret + (i * 16), seed);
+	acc = xxh3_avalanche(acc);
+	for (i = 8; i < len / 16; ++i)
+		acc += xxh3_mix16(input + (i * 16), secret + ((i - 8) * 16) + 3, seed);
+	acc += xxh3_mix16(input + len - 16, secret + 136 - 17, seed);
+	return xxh3_avalanche(acc);
+}
+
+static uint128_t
+xxh3_hash128_short(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+	uint64_t acc[2];
+	uint64_t low, high;
+	size_t i;
+	if (len <= 16) {
+		if (len > 8) {
+			uint64_t input_low = xxh3_read64(input);
+			uint64_t input_high = xxh3_read64(input + len - 8);
+			uint64_t mixed_low, mixed_high;
+			mixed_low = xxh3_mul128(input_low ^ input_high ^
+			                        ((xxh3_read64(secret + 32) ^ xxh3_read64(secret + 40)) - seed),
+			                        XXH_PRIME64_1, &mixed_high);
+			mixed_low += (uint64_t)(len - 1) << 54;
+			input_high ^= (xxh3_read64(secret + 48) ^ xxh3_read64(secret + 56)) + seed;
+			mixed_high += input_high + ((input_high & 0xFFFFFFFFULL) * (XXH_PRIME32_2 - 1));
+			mixed_low ^= byteorder_swap64(mixed_high);
+			low = xxh3_mul128(mixed_low, XXH_PRIME64_2, &high);
+			high += mixed_high * XXH_PRIME64_2;
+			return uint128_make(xxh3_avalanche(low), xxh3_avalanche(high));
+		}
+		if (len >= 4) {
+			uint64_t keyed;
+			seed ^= (uint64_t)byteorder_swap32((uint32_t)seed) << 32;
+			keyed = ((uint64_t)xxh3_read32(input) + ((uint64_t)xxh3_read32(input + len - 4) << 32)) ^
+			        ((xxh3_read64(secret + 16) ^ xxh3_read64(secret + 24)) + seed);
+			low = xxh3_mul128(keyed, XXH_PRIME64_1 + (len << 2), &high);
+			high += low << 1;
+			low ^= high >> 3;
+			low ^= low >> 35;
+			low *= XXH_PRIME_MX2;
+			low ^= low >> 28;
+			return uint128_make(low, xxh3_avalanche(high));
+		}
+		if (len) {
+			uint32_t combined = ((uint32_t)input[0] << 16) | ((uint32_t)input[len >> 1] << 24) |
+			                    (uint32_t)input[len - 1] | ((uint32_t)len << 8);
+			uint32_t combined_high = byteorder_swap32(combined);
+			combined_high = (combined_high << 13) | (combined_high >> 19);
+			low = (uint64_t)combined ^
+			      ((uint64_t)(xxh3_read32(secret) ^ xxh3_read32(secret + 4)) + seed);
+			high = (uint64_t)combined_high ^
+			       ((uint64_t)(xxh3_read32(secret + 8) ^ xxh3_read32(secret + 12)) - seed);
+			return uint128_make(xxh64_avalanche(low), xxh64_avalanche(high));
+		}
+		low = seed ^ xxh3_read64(secret + 64) ^ xxh3_read64(secret + 72);
+		high = seed ^ xxh3_read64(secret + 80) ^ xxh3_read64(secret + 88);
+		return uint128_make(xxh64_avalanche(low), xxh64_avalanche(high));
+	}
+
+	acc[0] = len * XXH_PRIME64_1;
+	acc[1] = 0;
+	if (len <= 128) {
+		if (len > 32) {
+			if (len > 64) {
+				if (len > 96)
+					xxh3_mix32(acc, input + 48, input + len - 64, secret + 96, seed);
+				xxh3_mix32(acc, input + 32, input + len - 48, secret + 64, seed);
+			}
+			xxh3_mix32(acc, input + 16, input + len - 32, secret + 32, seed);
+		}
+		xxh3_mix32(acc, input, input + len - 16, secret, seed);
+	}
+	else {
+		for (i = 0; i < 4; ++i)
+			xxh3_mix32(acc, input + (i * 32), input + (i * 32) + 16, secret + (i * 32), seed);
+		acc[0] = xxh3_avalanche(acc[0]);
+		acc[1] = xxh3_avalanche(acc[1]);
+		for (i = 4; i < len / 32; ++i)
+			xxh3_mix32(acc, input + (i * 32), input + (i * 32) + 16, secret + ((i - 4) * 32) + 3,
+			           seed);
+		xxh3_mix32(acc, input + len - 16, input + len - 32, secret + 136 - 17 - 16, 0 - seed);
+	}
+	low = acc[0] + acc[1];
+	high = (acc[0] * XXH_PRIME64_1) + (acc[1] * XXH_PRIME64_4) + ((len - seed) * XXH_PRIME64_2);
+	return uint128_make(xxh3_avalanche(low), 0 - xxh3_avalanche(high));
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+xxh3_merge64(const uint64_t* acc, const uint8_t* secret, uint64_t len) {
+	return xxh3_merge(acc, secret + 11, len * XXH_PRIME64_1);
+}
+
+static FOUNDATION_FORCEINLINE uint128_t
+xxh3_merge128(const uint64_t* acc, const uint8_t* secret, uint64_t len) {
+	return uint128_make(xxh3_merge(acc, secret + 11, len * XXH_PRIME64_1),
+	                    xxh3_merge(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - 11,
+	                               ~(len * XXH_PRIME64_2)));
+}
+
+uint64_t
+hash64(const void* key, size_t len, uint64_t seed) {
+	uint64_t acc[8];
+	uint8_t secret[XXH3_SECRET_SIZE];
+	const uint8_t* keysecret = xxh3_secret;
+	if (len <= XXH3_MIDSIZE_MAX)
+		return xxh3_hash64_short(key, len, xxh3_secret, seed);
+	if (seed) {
+		xxh3_init_secret(secret, seed);
+		keysecret = secret;
+	}
+	xxh3_hash_long(acc, key, len, keysecret);
+	return xxh3_merge64(acc, keysecret, len);
+}
+
+uint128_t
+hash128(const void* key, size_t len, uint64_t seed) {
+	uint64_t acc[8];
+	uint8_t secret[XXH3_SECRET_SIZE];
+	const uint8_t* keysecret = xxh3_secret;
+	if (len <= XXH3_MIDSIZE_MAX)
+		return xxh3_hash128_short(key, len, xxh3_secret, seed);
+	if (seed) {
+		xxh3_init_secret(secret, seed);
+		keysecret = secret;
+	}
+	xxh3_hash_long(acc, key, len, keysecret);
+	return xxh3_merge128(acc, keysecret, len);
 }
 
 void
-_static_hash_store(const void* key, size_t len, hash_t value) {
-	char* stored;
+hash_state_initialize(hash_state_t* state, uint64_t seed) {
+	memcpy(state->acc, xxh3_init_acc, sizeof(xxh3_init_acc));
+	xxh3_init_secret(state->secret, seed);
+	state->seed = seed;
+	state->size = 0;
+	state->buffered = 0;
+	state->stripes = 0;
+}
 
-	if (!_hash_lookup)
+void
+hash_state_update(hash_state_t* state, const void* data, size_t len) {
+	const uint8_t* input = data;
+	state->size += len;
+	if (state->buffered + len <= XXH3_BUFFER_SIZE) {
+		if (len)
+			memcpy(state->buffer + state->buffered, input, len);
+		state->buffered += len;
 		return;
+	}
 
-	stored = (char*)((uintptr_t)hashtable64_get(_hash_lookup, value));
-	if (stored) {
-		FOUNDATION_ASSERT_MSG(string_equal(stored, string_length(stored), key, len),
-		                      "Static hash collision");
-		FOUNDATION_ASSERT_MSG(string_length(stored) == len, "Static hash collision");
-		return;
+	//Buffered data is only consumed once more data follows, the final stripe is always
+	//processed when the value is computed
+	if (state->buffered) {
+		size_t fill = XXH3_BUFFER_SIZE - state->buffered;
+		memcpy(state->buffer + state->buffered, input, fill);
+		input += fill;
+		len -= fill;
+		xxh3_consume(state->acc, &state->stripes, state->buffer, XXH3_BUFFER_SIZE / XXH3_STRIPE_LEN,
+		             state->secret);
+		state->buffered = 0;
 	}
+	if (len > XXH3_BUFFER_SIZE) {
+		size_t stripes = (len - 1) / XXH3_STRIPE_LEN;
+		xxh3_consume(state->acc, &state->stripes, input, stripes, state->secret);
+		input += stripes * XXH3_STRIPE_LEN;
+		len -= stripes * XXH3_STRIPE_LEN;
+		//Keep the last consumed stripe for a final stripe overlapping consumed data
+		memcpy(state->buffer + XXH3_BUFFER_SIZE - XXH3_STRIPE_LEN, input - XXH3_STRIPE_LEN,
+		       XXH3_STRIPE_LEN);
+	}
+	memcpy(state->buffer, input, len);
+	state->buffered = len;
+}
 
-	stored = memory_allocate(0, len + 1, 0, MEMORY_PERSISTENT);
-	memcpy(stored, key, len);
-	stored[len] = 0;
+static void
+xxh3_state_digest(const hash_state_t* state, uint64_t* acc) {
+	uint8_t last[XXH3_STRIPE_LEN];
+	const uint8_t* stripe;
+	size_t stripes = state->stripes;
+	memcpy(acc, state->acc, sizeof(state->acc));
+	if (state->buffered >= XXH3_STRIPE_LEN) {
+		xxh3_consume(acc, &stripes, state->buffer, (state->buffered - 1) / XXH3_STRIPE_LEN,
+		             state->secret);
+		stripe = state->buffer + state->buffered - XXH3_STRIPE_LEN;
+	}
+	else {
+		size_t catchup = XXH3_STRIPE_LEN - state->buffered;
+		memcpy(last, state->buffer + XXH3_BUFFER_SIZE - catchup, catchup);
+		memcpy(last + catchup, state->buffer, state->buffered);
+		stripe = last;
+	}
+	xxh3_accumulate(acc, stripe, state->secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - 7, 1);
+}
 
-	hashtable64_set(_hash_lookup, value, (uintptr_t)stored);
+uint64_t
+hash_state_value64(const hash_state_t* state) {
+	uint64_t acc[8];
+	if (state->size <= XXH3_MIDSIZE_MAX)
+		return xxh3_hash64_short(state->buffer, (size_t)state->size, xxh3_secret, state->seed);
+	xxh3_state_digest(state, acc);
+	return xxh3_merge64(acc, state->secret, state->size);
 }
 
-string_const_t
-hash_to_string(hash_t value) {
-	const char* val;
+uint128_t
+hash_state_value128(const hash_state_t* state) {
+	uint64_t acc[8];
+	if (state->size <= XXH3_MIDSIZE_MAX)
+		return xxh3_hash128_short(state->buffer, (size_t)state->size, xxh3_secret, state->seed);
+	xxh3_state_digest(state, acc);
+	return xxh3_merge128(acc, state->secret, state->size);
+}
 
-	if (!_hash_lookup)
-		return string_null();
 
-	val = (const char*)(uintptr_t)hashtable64_get(_hash_lookup, value);
-	return string_const(val, string_length(val));
+//Reverse hash store, a chain of insert-only open addressed tables. When the newest table
+//reaches the load limit a table of twice the capacity is published in front of it. Tables are
+//never moved or freed until finalization, so lookups probe a bounded number of slots in each
+//table and never wait on concurrent inserts or growth.
+
+typedef struct hash_store_entry_t hash_store_entry_t;
+typedef struct hash_store_slot_t hash_store_slot_t;
+typedef struct hash_store_table_t hash_store_table_t;
+
+struct hash_store_entry_t {
+	size_t length;
+	char str[];
+};
+
+struct hash_store_slot_t {
+	atomic64_t key;
+	atomicptr_t entry;
+};
+
+struct hash_store_table_t {
+	hash_store_table_t* previous;
+	size_t mask;
+	int32_t limit;
+	atomic32_t count;
+	hash_store_slot_t slot[];
+};
+
+static atomicptr_t _hash_store;
+
+static hash_store_table_t*
+hash_store_table_allocate(size_t capacity, hash_store_table_t* previous) {
+	hash_store_table_t* table = memory_allocate(0, sizeof(hash_store_table_t) +
+	                                            sizeof(hash_store_slot_t) * capacity, 16,
+	                                            MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	table->previous = previous;
+	table->mask = capacity - 1;
+	table->limit = (int32_t)((capacity >> 1) + (capacity >> 2));
+	return table;
 }
 
-#else
+static void
+hash_store_grow(hash_store_table_t* table) {
+	hash_store_table_t* grown = hash_store_table_allocate((table->mask + 1) << 1, table);
+	//Only one thread publishes a new table, others see the head already changed
+	if (!atomic_cas_ptr(&_hash_store, grown, table))
+		memory_deallocate(grown);
+}
+
+static const hash_store_entry_t*
+hash_store_lookup(hash_t value) {
+	hash_store_table_t* table = atomic_loadptr_explicit(&_hash_store, MEMORY_ORDER_ACQUIRE);
+	for (; table; table = table->previous) {
+		size_t islot = (size_t)value & table->mask;
+		size_t probe;
+		for (probe = 0; probe <= table->mask; ++probe, islot = (islot + 1) & table->mask) {
+			hash_store_slot_t* slot = table->slot + islot;
+			hash_t key = (hash_t)atomic_load64_explicit(&slot->key, MEMORY_ORDER_RELAXED);
+			if (key == value) {
+				//A claimed slot with an unpublished entry is an insert in progress
+				const hash_store_entry_t* entry = atomic_loadptr_explicit(&slot->entry,
+				                                                          MEMORY_ORDER_ACQUIRE);
+				if (entry)
+					return entry;
+				break;
+			}
+			if (!key)
+				break;
+		}
+	}
+	return 0;
+}
+
+static void
+hash_store_insert(const void* key, size_t len, hash_t value) {
+	const hash_store_entry_t* found;
+	hash_store_entry_t* entry;
+
+	if (!value || !atomic_loadptr(&_hash_store))
+		return;
+
+	found = hash_store_lookup(value);
+	if (found) {
+		FOUNDATION_ASSERT_MSG(string_equal(found->str, found->length, key, len), "Hash collision");
+		return;
+	}
+
+	entry = memory_allocate(0, sizeof(hash_store_entry_t) + len + 1, 0, MEMORY_PERSISTENT);
+	entry->length = len;
+	memcpy(entry->str, key, len);
+	entry->str[len] = 0;
+
+	while (true) {
+		hash_store_table_t* table = atomic_loadptr_explicit(&_hash_store, MEMORY_ORDER_ACQUIRE);
+		size_t islot = (size_t)value & table->mask;
+		size_t probe;
+		for (probe = 0; probe <= table->mask; ++probe, islot = (islot + 1) & table->mask) {
+			hash_store_slot_t* slot = table->slot + islot;
+			hash_t current = (hash_t)atomic_load64_explicit(&slot->key, MEMORY_ORDER_RELAXED);
+			if (!current) {
+				if (atomic_cas64(&slot->key, (int64_t)value, 0)) {
+					atomic_storeptr_explicit(&slot->entry, entry, MEMORY_ORDER_RELEASE);
+					if (atomic_incr32(&table->count) == table->limit)
+						hash_store_grow(table);
+					return;
+				}
+				current = (hash_t)atomic_load64_explicit(&slot->key, MEMORY_ORDER_RELAXED);
+			}
+			if (current == value) {
+				//Concurrently inserted by another thread
+				memory_deallocate(entry);
+				return;
+			}
+		}
+		//Table filled up by concurrent inserts before growth was published
+		hash_store_grow(table);
+	}
+}
 
 int
 _static_hash_initialize(void) {
+	size_t capacity = 16;
+	if (atomic_loadptr(&_hash_store) || !_foundation_config.hash_store_size)
+		return 0;
+	while (capacity < _foundation_config.hash_store_size)
+		capacity <<= 1;
+	atomic_storeptr(&_hash_store, hash_store_table_allocate(capacity, 0));
 	return 0;
 }
 
 void
 _static_hash_finalize(void) {
+	hash_store_table_t* table = atomic_exchange_ptr(&_hash_store, 0);
+	while (table) {
+		hash_store_table_t* previous = table->previous;
+		size_t islot;
+		for (islot = 0; islot <= table->mask; ++islot) {
+			void* entry = atomic_loadptr(&table->slot[islot].entry);
+			if (entry)
+				memory_deallocate(entry);
+		}
+		memory_deallocate(table);
+		table = previous;
+	}
 }
 
-#endif
+void
+_static_hash_store(const void* key, size_t len, hash_t value) {
+	hash_store_insert(key, len, value);
+}
+
+hash_t
+hash_store(const void* key, size_t len) {
+	hash_t value = hash(key, len);
+	hash_store_insert(key, len, value);
+	return value;
+}
+
+string_const_t
+hash_to_string(hash_t value) {
+	const hash_store_entry_t* entry;
+	size_t index = hashstrings_table_index(value);
+	if (index < HASHSTRINGS_TABLE_SIZE)
+		return hashstrings_table_string[index];
+	entry = hash_store_lookup(value);
+	if (entry)
+		return string_const(entry->str, entry->length);
+	return string_null();
+}
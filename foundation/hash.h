@@ -13,9 +13,14 @@
 #pragma once
 
 /*! \file hash.h
-\brief Murmur3 hash
+\brief Murmur3 and XXH3 hashes
 
-Murmur3 hash from http://code.google.com/p/smhasher/
+Murmur3 hash from http://code.google.com/p/smhasher/ used for #hash_t values. The values are
+stable and used for static hashes, so #hash will not change algorithm.
+
+XXH3 hash from https://github.com/Cyan4973/xxHash with 64 and 128-bit results, optional seed
+and incremental hashing with a #hash_state_t. The XXH3 functions are several times faster than
+#hash on larger inputs and give the same values as the reference implementation.
 
 Wrapper macros around predefined static hashed strings. See hashify utility for
 creating static hashes */
@@ -35,8 +40,75 @@ creating static hashes */
 FOUNDATION_API FOUNDATION_PURECALL hash_t
 hash(const void* key, size_t len);
 
-/*! Reverse hash lookup. Only available if #BUILD_ENABLE_STATIC_HASH_DEBUG is
-enabled, otherwise if will always return an empty string
+/*! Hash data memory blob ignoring case of ascii characters. The hash is equal to the #hash of
+the data with all ascii upper case characters converted to lower case.
+\param key Key to hash
+\param len Length of key in bytes
+\return    Case insensitive hash of key */
+FOUNDATION_API FOUNDATION_PURECALL hash_t
+hash_nocase(const void* key, size_t len);
+
+/*! Hash data memory blob with the 64-bit XXH3 hash. No alignment requirements.
+\param key  Key to hash
+\param len  Length of key in bytes
+\param seed Seed, zero for the default XXH3 hash
+\return     64-bit hash of key */
+FOUNDATION_API FOUNDATION_PURECALL uint64_t
+hash64(const void* key, size_t len, uint64_t seed);
+
+/*! Hash data memory blob with the 128-bit XXH3 hash. No alignment requirements.
+\param key  Key to hash
+\param len  Length of key in bytes
+\param seed Seed, zero for the default XXH3 hash
+\return     128-bit hash of key, low 64 bits in the first word */
+FOUNDATION_API FOUNDATION_PURECALL uint128_t
+hash128(const void* key, size_t len, uint64_t seed);
+
+/*! Initialize a streaming hash state. Data can be hashed in any number of calls to
+#hash_state_update, and the hash of all data so far queried at any time with
+#hash_state_value64 or #hash_state_value128. The state holds no resources and needs no
+finalization.
+\param state Hash state
+\param seed  Seed */
+FOUNDATION_API void
+hash_state_initialize(hash_state_t* state, uint64_t seed);
+
+/*! Hash more data with a streaming hash state
+\param state Hash state
+\param data  Data to hash
+\param len   Length of data in bytes */
+FOUNDATION_API void
+hash_state_update(hash_state_t* state, const void* data, size_t len);
+
+/*! Get the 64-bit hash of all data hashed with the state. Equal to #hash64 of all data with
+the seed the state was initialized with. More data can be hashed after this call.
+\param state Hash state
+\return      64-bit hash */
+FOUNDATION_API uint64_t
+hash_state_value64(const hash_state_t* state);
+
+/*! Get the 128-bit hash of all data hashed with the state. Equal to #hash128 of all data with
+the seed the state was initialized with. More data can be hashed after this call.
+\param state Hash state
+\return      128-bit hash */
+FOUNDATION_API uint128_t
+hash_state_value128(const hash_state_t* state);
+
+/*! Hash a string and store it in the reverse hash store, allowing the string to be looked up
+from the hash value with #hash_to_string. The store is enabled by setting a nonzero
+hash_store_size in the foundation configuration, otherwise this is equal to #hash. Inserts are
+lock-free and the store grows as needed.
+\param key Key string
+\param len Length of key in bytes
+\return    Hash value */
+FOUNDATION_API hash_t
+hash_store(const void* key, size_t len);
+
+/*! Reverse hash lookup of a string previously stored with #hash_store, or with
+#static_hash_string if #BUILD_ENABLE_STATIC_HASH_DEBUG is enabled. The foundation static hash
+strings in hashstrings.h are always found through the generated table in hashstrings_table.h,
+without the store. Lookups are wait-free and can be made from any thread, including while other
+threads store strings.
 \param value Hash value
 \return      String matching hash value, or empty string if not found */
 FOUNDATION_API string_const_t
@@ -53,13 +125,10 @@ static_hash(const void* key, size_t len, hash_t value);
   ( (void)sizeof( key ), (void)sizeof( len ), \
     (hash_t)(value) )
 
-#  define hash_to_string( value ) \
-  ( (void)sizeof( value ), (const char*)0 )
-
 #endif
 
 /*! Declare a statically hashed string. If #BUILD_ENABLE_STATIC_HASH_DEBUG is enabled
-in the build config this will allow the string to be reverse looked up with hash_to_string.
+in the build config this will allow the string to be reverse looked up with #hash_to_string.
 Static hash strings are usually defined by using the hashify tool on a declaration file,
 see the hashstrings.txt and corresponding hashstrings.h header
 \param key    Key string
@@ -68,11 +137,11 @@ see the hashstrings.txt and corresponding hashstrings.h header
 #define static_hash_string( key, len, value ) \
   static_hash( key, len, (hash_t)value )
 
-#if BUILD_ENABLE_STATIC_HASH_DEBUG
-
 FOUNDATION_API void
 _static_hash_store(const void* key, size_t len, hash_t value);
 
+#if BUILD_ENABLE_STATIC_HASH_DEBUG
+
 static FOUNDATION_FORCEINLINE hash_t
 static_hash(const void* key, size_t len, hash_t value) {
   hash_t ref = hash(key, len);
@@ -87,3 +156,114 @@ static_hash(const void* key, size_t len, hash_t value) {
 
 /*! Hash of an empty/null string (length 0) */
 #define HASH_EMPTY_STRING 0xC2D00F032E25E509LL
+
+//Compile-time hash functions are constexpr where the language allows loops in constant expressions
+#if defined(__cplusplus) && (__cplusplus >= 201402L)
+#  define HASH_CONST_FN constexpr
+#else
+#  define HASH_CONST_FN static FOUNDATION_FORCEINLINE
+#endif
+
+/*! Hash constant data with the same result as #hash, written to be evaluated at compile time.
+In C the function is force inlined and folds to a constant when the key is a string literal
+(or other constant data) and the length is constant, with optimizations enabled. In C++14 and
+later the function is constexpr and can be used in constant expressions, like case labels.
+With a non-constant key this reads the key one byte at a time, use #hash for runtime data.
+\param key Key to hash
+\param len Length of key in bytes
+\return    Hash of key */
+HASH_CONST_FN hash_t
+hash_const(const char* key, size_t len);
+
+/*! Hash a string literal with the same result as #hash, computed at compile time. See
+#hash_const for details.
+\param literal String literal */
+#define hash_literal(literal) hash_const(literal, sizeof(literal) - 1)
+
+HASH_CONST_FN uint64_t
+_hash_const_rotl(uint64_t val, unsigned int bits) {
+	return (val << bits) | (val >> (64U - bits));
+}
+
+HASH_CONST_FN uint64_t
+_hash_const_fmix(uint64_t k) {
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return k;
+}
+
+//Little endian block of up to eight bytes, matching the block reads in #hash. Written without a
+//loop so compilers fold it for constant data without relying on loop unrolling
+#define _HASH_CONST_BYTE(key, offset, count, index) \
+	((count > index) ? ((uint64_t)(uint8_t)key[offset + index] << (index * 8)) : 0)
+
+HASH_CONST_FN uint64_t
+_hash_const_block(const char* key, size_t offset, size_t count) {
+	return _HASH_CONST_BYTE(key, offset, count, 0) | _HASH_CONST_BYTE(key, offset, count, 1) |
+	       _HASH_CONST_BYTE(key, offset, count, 2) | _HASH_CONST_BYTE(key, offset, count, 3) |
+	       _HASH_CONST_BYTE(key, offset, count, 4) | _HASH_CONST_BYTE(key, offset, count, 5) |
+	       _HASH_CONST_BYTE(key, offset, count, 6) | _HASH_CONST_BYTE(key, offset, count, 7);
+}
+
+#undef _HASH_CONST_BYTE
+
+//Block loop is fully unrolled for constant lengths of literal sized keys
+#if FOUNDATION_COMPILER_CLANG
+#  define _HASH_CONST_UNROLL _Pragma("clang loop unroll(full)")
+#elif FOUNDATION_COMPILER_GCC && (__GNUC__ >= 8)
+#  define _HASH_CONST_UNROLL _Pragma("GCC unroll 16")
+#else
+#  define _HASH_CONST_UNROLL
+#endif
+
+#define _HASH_CONST_MIX(h1, h2, k1, k2, c1, c2) \
+	k1 *= c1; \
+	k1 = _hash_const_rotl(k1, 23); \
+	k1 *= c2; \
+	h1 ^= k1; \
+	h1 += h2; \
+	h2 = _hash_const_rotl(h2, 41); \
+	k2 *= c2; \
+	k2 = _hash_const_rotl(k2, 23); \
+	k2 *= c1; \
+	h2 ^= k2; \
+	h2 += h1; \
+	h1 = h1 * 3 + 0x52dce729; \
+	h2 = h2 * 3 + 0x38495ab5; \
+	c1 = c1 * 5 + 0x7b7d159c; \
+	c2 = c2 * 5 + 0x6bce6396
+
+HASH_CONST_FN hash_t
+hash_const(const char* key, size_t len) {
+	uint64_t h1 = 0x9368e53c2f6af274ULL ^ 0xbaadf00dULL;
+	uint64_t h2 = 0x586dcd208f7cd3fdULL ^ 0xbaadf00dULL;
+	uint64_t c1 = 0x87c37b91114253d5ULL;
+	uint64_t c2 = 0x4cf5ad432745937fULL;
+	uint64_t k1 = 0;
+	uint64_t k2 = 0;
+	size_t offset = 0;
+	size_t tail = len & 15;
+	_HASH_CONST_UNROLL
+	for (; offset + 16 <= len; offset += 16) {
+		k1 = _hash_const_block(key, offset, 8);
+		k2 = _hash_const_block(key, offset + 8, 8);
+		_HASH_CONST_MIX(h1, h2, k1, k2, c1, c2);
+	}
+	if (tail) {
+		k1 = _hash_const_block(key, offset, (tail > 8) ? 8 : tail);
+		k2 = (tail > 8) ? _hash_const_block(key, offset + 8, tail - 8) : 0;
+		_HASH_CONST_MIX(h1, h2, k1, k2, c1, c2);
+	}
+	h2 ^= (uint64_t)(unsigned int)len;
+	h1 += h2;
+	h2 += h1;
+	h1 = _hash_const_fmix(h1);
+	h2 = _hash_const_fmix(h2);
+	return h1 + h2;
+}
+
+#undef _HASH_CONST_MIX
+#undef _HASH_CONST_UNROLL
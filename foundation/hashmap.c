@@ -14,20 +14,125 @@
 
 #define HASHMAP_MINBUCKETS     13
 #define HASHMAP_MINBUCKETSIZE  8
+#define HASHMAP_PROBE_MAX      255
+#define HASHMAP_CONCURRENT_SHARDS 16
 
-#define GET_BUCKET( map, key ) ( key % map->num_buckets )
+//Load factor limit of 7/8 before growing
+#define HASHMAP_NEED_GROW(map) \
+	(((map)->num_nodes + 1) > ((map)->num_buckets - ((map)->num_buckets >> 3)))
 
-hashmap_t*
-hashmap_allocate(size_t buckets, size_t bucketsize) {
-	hashmap_t* map;
+static size_t
+_hashmap_home(const hashmap_t* map, hash_t key) {
+	//Keys are often sequential or poorly distributed in low bits, mix before masking
+	uint64_t mix = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+	mix ^= mix >> 32;
+	return (size_t)mix & (map->num_buckets - 1);
+}
 
-	if (buckets < HASHMAP_MINBUCKETS)
-		buckets = HASHMAP_MINBUCKETS;
-	if (bucketsize < HASHMAP_MINBUCKETSIZE)
-		bucketsize = HASHMAP_MINBUCKETSIZE;
+static void
+_hashmap_allocate_storage(hashmap_t* map, size_t capacity) {
+	void* storage = memory_allocate(0, (sizeof(hashmap_node_t) + sizeof(uint8_t)) * capacity, 0,
+	                                MEMORY_PERSISTENT);
+	map->num_buckets = capacity;
+	map->bucket = storage;
+	map->probe = pointer_offset(storage, sizeof(hashmap_node_t) * capacity);
+	memset(map->probe, 0, capacity);
+}
+
+static bool
+_hashmap_place(hashmap_t* map, hashmap_node_t* node);
+
+static void
+_hashmap_rehash(hashmap_t* map, size_t capacity) {
+	hashmap_node_t* bucket = map->bucket;
+	uint8_t* probe = map->probe;
+	size_t prev_capacity = map->num_buckets;
+	size_t islot;
+	_hashmap_allocate_storage(map, capacity);
+	for (islot = 0; islot < prev_capacity; ++islot) {
+		if (probe[islot]) {
+			hashmap_node_t node = bucket[islot];
+			while (!_hashmap_place(map, &node))
+				_hashmap_rehash(map, map->num_buckets * 2);
+		}
+	}
+	memory_deallocate(bucket);
+}
+
+static void
+_hashmap_grow(hashmap_t* map) {
+	_hashmap_rehash(map, map->num_buckets * 2);
+}
+
+/*! Place a node not present in the map. Returns false if maximum probe distance was
+reached, in which case node holds a (possibly different, displaced) node still to be placed
+after growing the map */
+static bool
+_hashmap_place(hashmap_t* map, hashmap_node_t* node) {
+	size_t mask = map->num_buckets - 1;
+	size_t slot = _hashmap_home(map, node->key);
+	unsigned int dist = 1;
+	while (map->probe[slot]) {
+		//Robin hood, displace nodes closer to their home slot than the node being placed
+		if (map->probe[slot] < dist) {
+			hashmap_node_t swap = map->bucket[slot];
+			unsigned int swapdist = map->probe[slot];
+			map->bucket[slot] = *node;
+			map->probe[slot] = (uint8_t)dist;
+			*node = swap;
+			dist = swapdist;
+		}
+		slot = (slot + 1) & mask;
+		if (++dist > HASHMAP_PROBE_MAX)
+			return false;
+	}
+	map->bucket[slot] = *node;
+	map->probe[slot] = (uint8_t)dist;
+	return true;
+}
+
+static void
+_hashmap_place_grow(hashmap_t* map, hash_t key, void* value) {
+	hashmap_node_t node = { key, value };
+	while (!_hashmap_place(map, &node))
+		_hashmap_grow(map);
+}
+
+static size_t
+_hashmap_find(const hashmap_t* map, hash_t key) {
+	size_t mask = map->num_buckets - 1;
+	size_t slot = _hashmap_home(map, key);
+	unsigned int dist = 1;
+	//Stop at an empty slot or a node closer to its home than the key would be
+	while (map->probe[slot] >= dist) {
+		if ((map->probe[slot] == dist) && (map->bucket[slot].key == key))
+			return slot;
+		slot = (slot + 1) & mask;
+		++dist;
+	}
+	return map->num_buckets;
+}
+
+static void*
+_hashmap_erase_slot(hashmap_t* map, size_t slot) {
+	size_t mask = map->num_buckets - 1;
+	size_t next = (slot + 1) & mask;
+	void* prev = map->bucket[slot].value;
+	//Backward shift following nodes not in their home slot, no tombstones needed
+	while (map->probe[next] > 1) {
+		map->bucket[slot] = map->bucket[next];
+		map->probe[slot] = (uint8_t)(map->probe[next] - 1);
+		slot = next;
+		next = (next + 1) & mask;
+	}
+	map->probe[slot] = 0;
+	--map->num_nodes;
+	return prev;
+}
 
-	map = memory_allocate(0, sizeof(hashmap_t) + sizeof(hashmap_node_t*) * buckets, 0,
-	                      MEMORY_PERSISTENT);
+hashmap_t*
+hashmap_allocate(size_t buckets, size_t bucketsize) {
+	hashmap_t* map = memory_allocate(0, sizeof(hashmap_t), 0, MEMORY_PERSISTENT);
 
 	hashmap_initialize(map, buckets, bucketsize);
 
@@ -36,18 +141,17 @@ hashmap_allocate(size_t buckets, size_t bucketsize) {
 
 void
 hashmap_initialize(hashmap_t* map, size_t buckets, size_t bucketsize) {
-	size_t ibucket;
+	size_t capacity = 16;
 
+	if (buckets < HASHMAP_MINBUCKETS)
+		buckets = HASHMAP_MINBUCKETS;
 	if (bucketsize < HASHMAP_MINBUCKETSIZE)
 		bucketsize = HASHMAP_MINBUCKETSIZE;
+	while (capacity < buckets * bucketsize)
+		capacity <<= 1;
 
-	map->num_buckets = buckets;
-	map->num_nodes   = 0;
-
-	for (ibucket = 0; ibucket < buckets; ++ibucket) {
-		map->bucket[ibucket] = 0;
-		array_reserve(map->bucket[ibucket], bucketsize);
-	}
+	map->num_nodes = 0;
+	_hashmap_allocate_storage(map, capacity);
 }
 
 void
@@ -58,73 +162,69 @@ hashmap_deallocate(hashmap_t* map) {
 
 void
 hashmap_finalize(hashmap_t* map) {
-	size_t ibucket;
-	for (ibucket = 0; ibucket < map->num_buckets; ++ibucket)
-		array_deallocate(map->bucket[ibucket]);
+	memory_deallocate(map->bucket);
+	map->bucket = 0;
+	map->probe = 0;
+	map->num_buckets = 0;
+	map->num_nodes = 0;
 }
 
 void*
 hashmap_insert(hashmap_t* map, hash_t key, void* value) {
-	/*lint --e{613} */
-	size_t ibucket = GET_BUCKET(map, key);
-	hashmap_node_t* bucket = map->bucket[ibucket];
-	size_t inode, nsize;
-	for (inode = 0, nsize = array_size(bucket); inode < nsize; ++inode) {
-		if (bucket[inode].key == key) {
-			void* prev = bucket[inode].value;
-			bucket[inode].value = value;
-			return prev;
-		}
+	size_t slot = _hashmap_find(map, key);
+	if (slot < map->num_buckets) {
+		void* prev = map->bucket[slot].value;
+		map->bucket[slot].value = value;
+		return prev;
 	}
-	{
-		hashmap_node_t node = { key, value };
-		array_push(map->bucket[ibucket], node);
+	if (HASHMAP_NEED_GROW(map))
+		_hashmap_grow(map);
+	_hashmap_place_grow(map, key, value);
+	++map->num_nodes;
+	return 0;
+}
+
+void
+hashmap_insert_bulk(hashmap_t* map, const hash_t* keys, void* const* values, size_t count) {
+	size_t ikey;
+	hashmap_reserve(map, map->num_nodes + count);
+	for (ikey = 0; ikey < count; ++ikey) {
+		size_t slot = _hashmap_find(map, keys[ikey]);
+		if (slot < map->num_buckets) {
+			map->bucket[slot].value = values[ikey];
+			continue;
+		}
+		_hashmap_place_grow(map, keys[ikey], values[ikey]);
 		++map->num_nodes;
 	}
-	return 0;
+}
+
+void
+hashmap_reserve(hashmap_t* map, size_t count) {
+	size_t capacity = map->num_buckets;
+	while ((capacity - (capacity >> 3)) < count)
+		capacity <<= 1;
+	if (capacity > map->num_buckets)
+		_hashmap_rehash(map, capacity);
 }
 
 void*
 hashmap_erase(hashmap_t* map, hash_t key) {
-	/*lint --e{613} */
-	size_t ibucket = GET_BUCKET(map, key);
-	hashmap_node_t* bucket = map->bucket[ibucket];
-	size_t inode, nsize;
-	for (inode = 0, nsize = array_size(bucket); inode < nsize; ++inode) {
-		if (bucket[inode].key == key) {
-			void* prev = bucket[inode].value;
-			array_erase(map->bucket[ibucket], inode);
-			--map->num_nodes;
-			return prev;
-		}
-	}
-	return 0;
+	size_t slot = _hashmap_find(map, key);
+	if (slot >= map->num_buckets)
+		return 0;
+	return _hashmap_erase_slot(map, slot);
 }
 
 void*
 hashmap_lookup(hashmap_t* map, hash_t key) {
-	/*lint --e{613} */
-	size_t ibucket = GET_BUCKET(map, key);
-	hashmap_node_t* bucket = map->bucket[ibucket];
-	size_t inode, nsize;
-	for (inode = 0, nsize = array_size(bucket); inode < nsize; ++inode) {
-		if (bucket[inode].key == key)
-			return bucket[inode].value;
-	}
-	return 0;
+	size_t slot = _hashmap_find(map, key);
+	return (slot < map->num_buckets) ? map->bucket[slot].value : 0;
 }
 
 bool
 hashmap_has_key(hashmap_t* map, hash_t key) {
-	/*lint --e{613} */
-	size_t ibucket = GET_BUCKET(map, key);
-	hashmap_node_t* bucket = map->bucket[ibucket];
-	size_t inode, nsize;
-	for (inode = 0, nsize = array_size(bucket); inode < nsize; ++inode) {
-		if (bucket[inode].key == key)
-			return true;
-	}
-	return false;
+	return _hashmap_find(map, key) < map->num_buckets;
 }
 
 size_t
@@ -132,10 +232,465 @@ hashmap_size(hashmap_t* map) {
 	return map->num_nodes;
 }
 
+hashmap_node_t*
+hashmap_next(hashmap_t* map, hashmap_node_t* node) {
+	size_t islot = node ? (size_t)(node - map->bucket) + 1 : 0;
+	for (; islot < map->num_buckets; ++islot) {
+		if (map->probe[islot])
+			return map->bucket + islot;
+	}
+	return 0;
+}
+
 void
 hashmap_clear(hashmap_t* map) {
-	size_t ibucket;
-	for (ibucket = 0; ibucket < map->num_buckets; ++ibucket)
-		array_clear(map->bucket[ibucket]);
+	memset(map->probe, 0, map->num_buckets);
+	map->num_nodes = 0;
+}
+
+static hashmap_shard_t*
+_hashmap_shard(hashmap_concurrent_t* map, hash_t key) {
+	//Select shard from high bits, home slot in shard uses the mixed low bits
+	return map->shard + ((size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 48) & (map->num_shards - 1));
+}
+
+static void
+_hashmap_shard_lock(hashmap_shard_t* shard) {
+	lock_lock(&shard->lock);
+	atomic_store32(&shard->sequence, atomic_load32(&shard->sequence) + 1);
+	atomic_thread_fence_release();
+}
+
+static void
+_hashmap_shard_unlock(hashmap_shard_t* shard) {
+	atomic_thread_fence_release();
+	atomic_store32(&shard->sequence, atomic_load32(&shard->sequence) + 1);
+	lock_unlock(&shard->lock);
+}
+
+static void
+_hashmap_shard_grow(hashmap_shard_t* shard, hashmap_node_t* node) {
+	//Build a new map and publish it, readers may still be probing the old map
+	hashmap_t* map = atomic_loadptr(&shard->map);
+	hashmap_t* grown = memory_allocate(0, sizeof(hashmap_t), 0, MEMORY_PERSISTENT);
+	size_t islot;
+	grown->num_nodes = map->num_nodes;
+	_hashmap_allocate_storage(grown, map->num_buckets * 2);
+	for (islot = 0; islot < map->num_buckets; ++islot) {
+		if (map->probe[islot])
+			_hashmap_place_grow(grown, map->bucket[islot].key, map->bucket[islot].value);
+	}
+	if (node)
+		_hashmap_place_grow(grown, node->key, node->value);
+	atomic_thread_fence_release();
+	atomic_storeptr(&shard->map, grown);
+	array_push(shard->retired, map);
+}
+
+hashmap_concurrent_t*
+hashmap_concurrent_allocate(size_t shards, size_t capacity) {
+	hashmap_concurrent_t* map = memory_allocate(0, sizeof(hashmap_concurrent_t), 0, MEMORY_PERSISTENT);
+
+	hashmap_concurrent_initialize(map, shards, capacity);
+
+	return map;
+}
+
+void
+hashmap_concurrent_initialize(hashmap_concurrent_t* map, size_t shards, size_t capacity) {
+	size_t ishard;
+	size_t num_shards = 1;
+
+	while (num_shards < shards)
+		num_shards <<= 1;
+	if (shards < 1)
+		num_shards = HASHMAP_CONCURRENT_SHARDS;
+
+	map->num_shards = num_shards;
+	map->shard = memory_allocate(0, sizeof(hashmap_shard_t) * num_shards, FOUNDATION_ALIGNOF(hashmap_shard_t),
+	                             MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (ishard = 0; ishard < num_shards; ++ishard)
+		atomic_storeptr(&map->shard[ishard].map,
+		                hashmap_allocate((capacity / num_shards) + 1, 1));
+}
+
+void
+hashmap_concurrent_deallocate(hashmap_concurrent_t* map) {
+	hashmap_concurrent_finalize(map);
+	memory_deallocate(map);
+}
+
+void
+hashmap_concurrent_finalize(hashmap_concurrent_t* map) {
+	size_t ishard, iretired, nretired;
+	for (ishard = 0; ishard < map->num_shards; ++ishard) {
+		hashmap_shard_t* shard = map->shard + ishard;
+		for (iretired = 0, nretired = array_size(shard->retired); iretired < nretired; ++iretired)
+			hashmap_deallocate(shard->retired[iretired]);
+		array_deallocate(shard->retired);
+		hashmap_deallocate(atomic_loadptr(&shard->map));
+	}
+	memory_deallocate(map->shard);
+	map->shard = 0;
+	map->num_shards = 0;
+}
+
+void*
+hashmap_concurrent_insert(hashmap_concurrent_t* map, hash_t key, void* value) {
+	hashmap_shard_t* shard = _hashmap_shard(map, key);
+	hashmap_t* shardmap;
+	void* prev = 0;
+	size_t slot;
+	_hashmap_shard_lock(shard);
+	shardmap = atomic_loadptr(&shard->map);
+	slot = _hashmap_find(shardmap, key);
+	if (slot < shardmap->num_buckets) {
+		prev = shardmap->bucket[slot].value;
+		shardmap->bucket[slot].value = value;
+	}
+	else {
+		hashmap_node_t node = { key, value };
+		if (HASHMAP_NEED_GROW(shardmap))
+			_hashmap_shard_grow(shard, &node);
+		else if (!_hashmap_place(shardmap, &node))
+			_hashmap_shard_grow(shard, &node);
+		shardmap = atomic_loadptr(&shard->map);
+		++shardmap->num_nodes;
+	}
+	_hashmap_shard_unlock(shard);
+	return prev;
+}
+
+void*
+hashmap_concurrent_erase(hashmap_concurrent_t* map, hash_t key) {
+	hashmap_shard_t* shard = _hashmap_shard(map, key);
+	hashmap_t* shardmap;
+	void* prev = 0;
+	size_t slot;
+	_hashmap_shard_lock(shard);
+	shardmap = atomic_loadptr(&shard->map);
+	slot = _hashmap_find(shardmap, key);
+	if (slot < shardmap->num_buckets)
+		prev = _hashmap_erase_slot(shardmap, slot);
+	_hashmap_shard_unlock(shard);
+	return prev;
+}
+
+static bool
+_hashmap_concurrent_find(hashmap_concurrent_t* map, hash_t key, void** value) {
+	hashmap_shard_t* shard = _hashmap_shard(map, key);
+	while (true) {
+		int32_t sequence = atomic_load32(&shard->sequence);
+		if (!(sequence & 1)) {
+			hashmap_t* shardmap;
+			size_t slot;
+			bool found;
+			atomic_thread_fence_acquire();
+			shardmap = atomic_loadptr(&shard->map);
+			slot = _hashmap_find(shardmap, key);
+			found = (slot < shardmap->num_buckets);
+			*value = found ? shardmap->bucket[slot].value : 0;
+			atomic_thread_fence_acquire();
+			if (atomic_load32(&shard->sequence) == sequence)
+				return found;
+		}
+		thread_yield();
+	}
+}
+
+void*
+hashmap_concurrent_lookup(hashmap_concurrent_t* map, hash_t key) {
+	void* value;
+	_hashmap_concurrent_find(map, key, &value);
+	return value;
+}
+
+bool
+hashmap_concurrent_has_key(hashmap_concurrent_t* map, hash_t key) {
+	void* value;
+	return _hashmap_concurrent_find(map, key, &value);
+}
+
+size_t
+hashmap_concurrent_size(hashmap_concurrent_t* map) {
+	size_t ishard;
+	size_t size = 0;
+	for (ishard = 0; ishard < map->num_shards; ++ishard)
+		size += ((hashmap_t*)atomic_loadptr(&map->shard[ishard].map))->num_nodes;
+	return size;
+}
+
+void
+hashmap_concurrent_clear(hashmap_concurrent_t* map) {
+	size_t ishard;
+	for (ishard = 0; ishard < map->num_shards; ++ishard) {
+		hashmap_shard_t* shard = map->shard + ishard;
+		_hashmap_shard_lock(shard);
+		hashmap_clear(atomic_loadptr(&shard->map));
+		_hashmap_shard_unlock(shard);
+	}
+}
+
+#define HASHMAP_STRING_ARENA_MIN 256
+
+static size_t
+_hashmap_string_home(const hashmap_string_t* map, hash_t hash) {
+	//Key hashes are already well distributed
+	return (size_t)hash & (map->num_buckets - 1);
+}
+
+static const char*
+_hashmap_string_key(const hashmap_string_t* map, const hashmap_string_node_t* node) {
+	return (node->length > HASHMAP_STRING_INLINE) ? map->arena + node->key.offset : node->key.chars;
+}
+
+static void
+_hashmap_string_allocate_storage(hashmap_string_t* map, size_t capacity) {
+	void* storage = memory_allocate(0, (sizeof(hashmap_string_node_t) + sizeof(uint8_t)) * capacity, 0,
+	                                MEMORY_PERSISTENT);
+	map->num_buckets = capacity;
+	map->bucket = storage;
+	map->probe = pointer_offset(storage, sizeof(hashmap_string_node_t) * capacity);
+	memset(map->probe, 0, capacity);
+}
+
+static void
+_hashmap_string_store_key(hashmap_string_t* map, hashmap_string_node_t* node, const char* key,
+                          size_t length) {
+	node->length = (uint32_t)length;
+	if (length <= HASHMAP_STRING_INLINE) {
+		memcpy(node->key.chars, key, length);
+		return;
+	}
+	if (map->arena_used + length > map->arena_capacity) {
+		size_t capacity = map->arena_capacity ? map->arena_capacity : HASHMAP_STRING_ARENA_MIN;
+		while (capacity < map->arena_used + length)
+			capacity <<= 1;
+		FOUNDATION_ASSERT_MSG(capacity <= 0xFFFFFFFFU, "String hash map key arena too large");
+		if (map->arena)
+			map->arena = memory_reallocate(map->arena, capacity, 0, map->arena_used);
+		else
+			map->arena = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT);
+		map->arena_capacity = capacity;
+	}
+	node->key.offset = (uint32_t)map->arena_used;
+	memcpy(map->arena + map->arena_used, key, length);
+	map->arena_used += length;
+}
+
+static void
+_hashmap_string_compact(hashmap_string_t* map) {
+	//Copy live long keys to a new arena, dropping space of erased keys
+	size_t used = map->arena_used - map->arena_garbage;
+	size_t capacity = HASHMAP_STRING_ARENA_MIN;
+	char* arena;
+	size_t islot;
+	size_t offset = 0;
+	while (capacity < used)
+		capacity <<= 1;
+	arena = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT);
+	for (islot = 0; islot < map->num_buckets; ++islot) {
+		hashmap_string_node_t* node = map->bucket + islot;
+		if (!map->probe[islot] || (node->length <= HASHMAP_STRING_INLINE))
+			continue;
+		memcpy(arena + offset, map->arena + node->key.offset, node->length);
+		node->key.offset = (uint32_t)offset;
+		offset += node->length;
+	}
+	memory_deallocate(map->arena);
+	map->arena = arena;
+	map->arena_used = offset;
+	map->arena_capacity = capacity;
+	map->arena_garbage = 0;
+}
+
+/*! Place a node not present in the map, see #_hashmap_place */
+static bool
+_hashmap_string_place(hashmap_string_t* map, hashmap_string_node_t* node) {
+	size_t mask = map->num_buckets - 1;
+	size_t slot = _hashmap_string_home(map, node->hash);
+	unsigned int dist = 1;
+	while (map->probe[slot]) {
+		if (map->probe[slot] < dist) {
+			hashmap_string_node_t swap = map->bucket[slot];
+			unsigned int swapdist = map->probe[slot];
+			map->bucket[slot] = *node;
+			map->probe[slot] = (uint8_t)dist;
+			*node = swap;
+			dist = swapdist;
+		}
+		slot = (slot + 1) & mask;
+		if (++dist > HASHMAP_PROBE_MAX)
+			return false;
+	}
+	map->bucket[slot] = *node;
+	map->probe[slot] = (uint8_t)dist;
+	return true;
+}
+
+static void
+_hashmap_string_rehash(hashmap_string_t* map, size_t capacity) {
+	hashmap_string_node_t* bucket = map->bucket;
+	uint8_t* probe = map->probe;
+	size_t prev_capacity = map->num_buckets;
+	size_t islot;
+	_hashmap_string_allocate_storage(map, capacity);
+	for (islot = 0; islot < prev_capacity; ++islot) {
+		if (probe[islot]) {
+			hashmap_string_node_t node = bucket[islot];
+			while (!_hashmap_string_place(map, &node))
+				_hashmap_string_rehash(map, map->num_buckets * 2);
+		}
+	}
+	memory_deallocate(bucket);
+}
+
+static size_t
+_hashmap_string_find(const hashmap_string_t* map, const char* key, size_t length, hash_t hash) {
+	size_t mask = map->num_buckets - 1;
+	size_t slot = _hashmap_string_home(map, hash);
+	unsigned int dist = 1;
+	while (map->probe[slot] >= dist) {
+		const hashmap_string_node_t* node = map->bucket + slot;
+		//Only compare the full key on matching hash
+		if ((map->probe[slot] == dist) && (node->hash == hash) && (node->length == length) &&
+		        !memcmp(_hashmap_string_key(map, node), key, length))
+			return slot;
+		slot = (slot + 1) & mask;
+		++dist;
+	}
+	return map->num_buckets;
+}
+
+hashmap_string_t*
+hashmap_string_allocate(size_t capacity) {
+	hashmap_string_t* map = memory_allocate(0, sizeof(hashmap_string_t), 0, MEMORY_PERSISTENT);
+
+	hashmap_string_initialize(map, capacity);
+
+	return map;
+}
+
+void
+hashmap_string_initialize(hashmap_string_t* map, size_t capacity) {
+	size_t buckets = 16;
+
+	while ((buckets - (buckets >> 3)) < capacity)
+		buckets <<= 1;
+
+	map->num_nodes = 0;
+	map->arena = 0;
+	map->arena_used = 0;
+	map->arena_capacity = 0;
+	map->arena_garbage = 0;
+	_hashmap_string_allocate_storage(map, buckets);
+}
+
+void
+hashmap_string_deallocate(hashmap_string_t* map) {
+	hashmap_string_finalize(map);
+	memory_deallocate(map);
+}
+
+void
+hashmap_string_finalize(hashmap_string_t* map) {
+	memory_deallocate(map->bucket);
+	memory_deallocate(map->arena);
+	map->bucket = 0;
+	map->probe = 0;
+	map->arena = 0;
+	map->num_buckets = 0;
+	map->num_nodes = 0;
+	map->arena_used = 0;
+	map->arena_capacity = 0;
+	map->arena_garbage = 0;
+}
+
+void*
+hashmap_string_insert(hashmap_string_t* map, const char* key, size_t length, void* value) {
+	hash_t keyhash = hash(key, length);
+	size_t slot = _hashmap_string_find(map, key, length, keyhash);
+	hashmap_string_node_t node;
+	if (slot < map->num_buckets) {
+		void* prev = map->bucket[slot].value;
+		map->bucket[slot].value = value;
+		return prev;
+	}
+	if (HASHMAP_NEED_GROW(map)) {
+		if (map->arena_garbage > (map->arena_used >> 1))
+			_hashmap_string_compact(map);
+		_hashmap_string_rehash(map, map->num_buckets * 2);
+	}
+	node.hash = keyhash;
+	node.value = value;
+	_hashmap_string_store_key(map, &node, key, length);
+	while (!_hashmap_string_place(map, &node))
+		_hashmap_string_rehash(map, map->num_buckets * 2);
+	++map->num_nodes;
+	return 0;
+}
+
+void*
+hashmap_string_erase(hashmap_string_t* map, const char* key, size_t length) {
+	size_t slot = _hashmap_string_find(map, key, length, hash(key, length));
+	size_t mask = map->num_buckets - 1;
+	size_t next;
+	void* prev;
+	if (slot >= map->num_buckets)
+		return 0;
+	prev = map->bucket[slot].value;
+	if (map->bucket[slot].length > HASHMAP_STRING_INLINE)
+		map->arena_garbage += map->bucket[slot].length;
+	next = (slot + 1) & mask;
+	while (map->probe[next] > 1) {
+		map->bucket[slot] = map->bucket[next];
+		map->probe[slot] = (uint8_t)(map->probe[next] - 1);
+		slot = next;
+		next = (next + 1) & mask;
+	}
+	map->probe[slot] = 0;
+	if (!--map->num_nodes) {
+		map->arena_used = 0;
+		map->arena_garbage = 0;
+	}
+	return prev;
+}
+
+void*
+hashmap_string_lookup(hashmap_string_t* map, const char* key, size_t length) {
+	size_t slot = _hashmap_string_find(map, key, length, hash(key, length));
+	return (slot < map->num_buckets) ? map->bucket[slot].value : 0;
+}
+
+bool
+hashmap_string_has_key(hashmap_string_t* map, const char* key, size_t length) {
+	return _hashmap_string_find(map, key, length, hash(key, length)) < map->num_buckets;
+}
+
+size_t
+hashmap_string_size(hashmap_string_t* map) {
+	return map->num_nodes;
+}
+
+hashmap_string_node_t*
+hashmap_string_next(hashmap_string_t* map, hashmap_string_node_t* node) {
+	size_t islot = node ? (size_t)(node - map->bucket) + 1 : 0;
+	for (; islot < map->num_buckets; ++islot) {
+		if (map->probe[islot])
+			return map->bucket + islot;
+	}
+	return 0;
+}
+
+string_const_t
+hashmap_string_node_key(hashmap_string_t* map, hashmap_string_node_t* node) {
+	return string_const(_hashmap_string_key(map, node), node->length);
+}
+
+void
+hashmap_string_clear(hashmap_string_t* map) {
+	memset(map->probe, 0, map->num_buckets);
 	map->num_nodes = 0;
+	map->arena_used = 0;
+	map->arena_garbage = 0;
 }
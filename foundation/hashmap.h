@@ -15,14 +15,20 @@
 /*! \file hashmap.h
 \brief Simple container mapping hash values to pointers
 
-Simple container mapping hash values to pointers. Access is not atomic
-and therefor not thread safe. For a thread safe alternative look at hashtable.h
-instead, or provide external synchronization in caller. */
+Simple container mapping hash values to pointers. Nodes are stored in a flat open addressed
+table using robin hood probing, and the table grows automatically when the load gets too high.
+Access is not atomic and therefor not thread safe. For a thread safe alternative look at
+hashtable.h instead, or provide external synchronization in caller.
+
+The string hash map variant maps exact string keys to pointers. Short keys are stored inline
+in the nodes, longer keys in a contiguous key arena owned by the map, and keys are only
+compared in full when the stored hash matches. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
 
-/*! Allocate new hash map with the given bucket count and size. Minimum bucket
+/*! Allocate new hash map with the given bucket count and size. The product of bucket
+count and size is used as initial capacity, rounded up to a power of two. Minimum bucket
 count is 13, minimum bucket size is 8. Hash map should be deallocated with a call to
 #hashmap_deallocate
 \param buckets Bucket count
@@ -36,7 +42,8 @@ hashmap_allocate(size_t buckets, size_t bucketsize);
 FOUNDATION_API void
 hashmap_deallocate(hashmap_t* map);
 
-/*! Initialize new hash map with the given bucket count and size. Minimum bucket
+/*! Initialize new hash map with the given bucket count and size. The product of bucket
+count and size is used as initial capacity, rounded up to a power of two. Minimum bucket
 count is 13, minimum bucket size is 8. Hash map should be finalized with a call to
 #hashmap_finalize
 \param map Hash map to initialize
@@ -59,6 +66,24 @@ given key.
 FOUNDATION_API void*
 hashmap_insert(hashmap_t* map, hash_t key, void* value);
 
+/*! Insert a number of key-value mappings, reserving storage for all mappings up front.
+Replaces any previously stored mapping for a key, a key given multiple times maps to the last
+corresponding value.
+\param map Hash map
+\param keys Array of keys
+\param values Array of values, one for each key
+\param count Number of keys and values */
+FOUNDATION_API void
+hashmap_insert_bulk(hashmap_t* map, const hash_t* keys, void* const* values, size_t count);
+
+/*! Reserve storage for the given total number of key-value mappings, avoiding storage
+growth during later inserts until the map holds more mappings than reserved. Never reduces
+storage.
+\param map Hash map
+\param count Number of mappings */
+FOUNDATION_API void
+hashmap_reserve(hashmap_t* map, size_t count);
+
 /*! Erase any value mapping for the given key.
 \param map Hash map
 \param key Key
@@ -86,7 +111,177 @@ hashmap_has_key(hashmap_t* map, hash_t key);
 FOUNDATION_API size_t
 hashmap_size(hashmap_t* map);
 
+/*! Get next node during iteration over all key-value mappings. Nodes are visited in
+storage order. The value of a node may be modified during iteration, but inserting or erasing
+mappings invalidates the iteration.
+\param map Hash map
+\param node Previous node, pass in 0 for getting first node
+\return Next node, 0 if no more nodes */
+FOUNDATION_API hashmap_node_t*
+hashmap_next(hashmap_t* map, hashmap_node_t* node);
+
 /*! Clear map and erase all key-value mappings.
 \param map Hash map */
 FOUNDATION_API void
 hashmap_clear(hashmap_t* map);
+
+/*! Allocate new concurrent hash map. The map is split into a number of shards, each
+holding a hash map protected by a writer lock. Lookups do not lock or write any shared memory,
+they retry if a writer modified the shard during the lookup, making the map suitable for
+read mostly use from multiple threads. Storage of a shard replaced by growth is kept until
+the map is finalized. Concurrent hash map should be deallocated with a call to
+#hashmap_concurrent_deallocate
+\param shards Number of shards, rounded up to a power of two, zero for default (16)
+\param capacity Initial capacity across all shards
+\return New concurrent hash map */
+FOUNDATION_API hashmap_concurrent_t*
+hashmap_concurrent_allocate(size_t shards, size_t capacity);
+
+/*! Deallocate a concurrent hash map previously allocated with #hashmap_concurrent_allocate
+\param map Concurrent hash map */
+FOUNDATION_API void
+hashmap_concurrent_deallocate(hashmap_concurrent_t* map);
+
+/*! Initialize new concurrent hash map, see #hashmap_concurrent_allocate. Concurrent hash
+map should be finalized with a call to #hashmap_concurrent_finalize
+\param map Concurrent hash map to initialize
+\param shards Number of shards, rounded up to a power of two, zero for default (16)
+\param capacity Initial capacity across all shards */
+FOUNDATION_API void
+hashmap_concurrent_initialize(hashmap_concurrent_t* map, size_t shards, size_t capacity);
+
+/*! Finalize a concurrent hash map previously initialized with #hashmap_concurrent_initialize
+and free resources. Must not be called while other threads access the map.
+\param map Concurrent hash map */
+FOUNDATION_API void
+hashmap_concurrent_finalize(hashmap_concurrent_t* map);
+
+/*! Insert a new key-value mapping. Will replace any previously stored mapping for the
+given key. Thread safe.
+\param map Concurrent hash map
+\param key Key
+\param value Value
+\return Previously stored value, 0 if no value previously stored for key */
+FOUNDATION_API void*
+hashmap_concurrent_insert(hashmap_concurrent_t* map, hash_t key, void* value);
+
+/*! Erase any value mapping for the given key. Thread safe.
+\param map Concurrent hash map
+\param key Key
+\return Previously stored value, 0 if no value previously stored for key */
+FOUNDATION_API void*
+hashmap_concurrent_erase(hashmap_concurrent_t* map, hash_t key);
+
+/*! Lookup the stored value mapping for the given key without locking. Thread safe.
+\param map Concurrent hash map
+\param key Key
+\return Stored value, 0 if no value stored for key */
+FOUNDATION_API void*
+hashmap_concurrent_lookup(hashmap_concurrent_t* map, hash_t key);
+
+/*! Query if there is any value mapping stored for the given key without locking.
+Thread safe.
+\param map Concurrent hash map
+\param key Key
+\return true if there is a value mapping stored for the key, false if not */
+FOUNDATION_API bool
+hashmap_concurrent_has_key(hashmap_concurrent_t* map, hash_t key);
+
+/*! Get the number of key-value mappings stored in the concurrent hash map. The count is
+approximate if other threads modify the map concurrently.
+\param map Concurrent hash map
+\return Number of keys stored */
+FOUNDATION_API size_t
+hashmap_concurrent_size(hashmap_concurrent_t* map);
+
+/*! Clear concurrent hash map and erase all key-value mappings. Thread safe, but not atomic
+across shards.
+\param map Concurrent hash map */
+FOUNDATION_API void
+hashmap_concurrent_clear(hashmap_concurrent_t* map);
+
+/*! Allocate new string keyed hash map with storage for at least the given number of
+key-value mappings. String hash map should be deallocated with a call to
+#hashmap_string_deallocate
+\param capacity Initial capacity
+\return New string hash map */
+FOUNDATION_API hashmap_string_t*
+hashmap_string_allocate(size_t capacity);
+
+/*! Deallocate a string hash map previously allocated with #hashmap_string_allocate
+\param map String hash map */
+FOUNDATION_API void
+hashmap_string_deallocate(hashmap_string_t* map);
+
+/*! Initialize new string keyed hash map, see #hashmap_string_allocate. String hash map
+should be finalized with a call to #hashmap_string_finalize
+\param map String hash map to initialize
+\param capacity Initial capacity */
+FOUNDATION_API void
+hashmap_string_initialize(hashmap_string_t* map, size_t capacity);
+
+/*! Finalize a string hash map previously initialized with #hashmap_string_initialize and
+free resources, including stored keys
+\param map String hash map */
+FOUNDATION_API void
+hashmap_string_finalize(hashmap_string_t* map);
+
+/*! Insert a new key-value mapping. Will replace any previously stored mapping for the
+given key. The key is copied into the map.
+\param map String hash map
+\param key Key
+\param length Length of key
+\param value Value
+\return Previously stored value, 0 if no value previously stored for key */
+FOUNDATION_API void*
+hashmap_string_insert(hashmap_string_t* map, const char* key, size_t length, void* value);
+
+/*! Erase any value mapping for the given key.
+\param map String hash map
+\param key Key
+\param length Length of key
+\return Previously stored value, 0 if no value previously stored for key */
+FOUNDATION_API void*
+hashmap_string_erase(hashmap_string_t* map, const char* key, size_t length);
+
+/*! Lookup the stored value mapping for the given key
+\param map String hash map
+\param key Key
+\param length Length of key
+\return Stored value, 0 if no value stored for key */
+FOUNDATION_API void*
+hashmap_string_lookup(hashmap_string_t* map, const char* key, size_t length);
+
+/*! Query if there is any value mapping stored for the given key.
+\param map String hash map
+\param key Key
+\param length Length of key
+\return true if there is a value mapping stored for the key, false if not */
+FOUNDATION_API bool
+hashmap_string_has_key(hashmap_string_t* map, const char* key, size_t length);
+
+/*! Get the number of key-value mappings stored in the string hash map.
+\param map String hash map
+\return Number of keys stored */
+FOUNDATION_API size_t
+hashmap_string_size(hashmap_string_t* map);
+
+/*! Get next node during iteration over all key-value mappings, see #hashmap_next.
+\param map String hash map
+\param node Previous node, pass in 0 for getting first node
+\return Next node, 0 if no more nodes */
+FOUNDATION_API hashmap_string_node_t*
+hashmap_string_next(hashmap_string_t* map, hashmap_string_node_t* node);
+
+/*! Get the key of a node. The key is not zero terminated and is only valid until the map
+is modified.
+\param map String hash map
+\param node Node
+\return Key */
+FOUNDATION_API string_const_t
+hashmap_string_node_key(hashmap_string_t* map, hashmap_string_node_t* node);
+
+/*! Clear string hash map and erase all key-value mappings.
+\param map String hash map */
+FOUNDATION_API void
+hashmap_string_clear(hashmap_string_t* map);
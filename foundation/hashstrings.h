@@ -44,6 +44,9 @@ Statically hashed strings generated by the hashify tool from input file hashstri
 \def HASH_LOCAL
 \details Hash of "local"
 
+\def HASH_SAMPLED
+\details Hash of "sampled"
+
 \def HASH_REMOTE
 \details Hash of "remote"
 
@@ -126,6 +129,7 @@ Statically hashed strings generated by the hashify tool from input file hashstri
 #define HASH_TEMPORARY_MEMORY static_hash_string("temporary_memory", 16, 0x99a81dcbf3f5c346ULL)
 #define HASH_MEMORY_TRACKER static_hash_string("memory_tracker", 14, 0x344315811a5c41deULL)
 #define HASH_LOCAL static_hash_string("local", 5, 0xd17754fcf40a2974ULL)
+#define HASH_SAMPLED static_hash_string("sampled", 7, 0x89ee6d65a3e65a7eULL)
 #define HASH_REMOTE static_hash_string("remote", 6, 0x4d4ee1b3734e2c5cULL)
 #define HASH_NONE static_hash_string("none", 4, 0xa90768116f8af366ULL)
 #define HASH_TEST static_hash_string("test", 4, 0x74326336c500c367ULL)
@@ -0,0 +1,161 @@
+
+/*! \file hashstrings_table.h
+\brief Static hash string table
+
+Minimal perfect hash table of the statically hashed strings in hashstrings.h, generated by
+the hashify tool with the --table option from input file hashstrings.txt. Maps each static hash
+to a dense index and back to the string with a single table access, see #hash_to_string */
+
+#pragma once
+
+#include <foundation/hash.h>
+
+/* ****** AUTOMATICALLY GENERATED, DO NOT EDIT ******
+    Edit corresponding definitions file and rerun
+    the foundation hashify tool to update this file */
+
+#include <foundation/string.h>
+
+/* Minimal perfect hash table of the 34 static hash strings, mapping each hash
+   to a dense index in [0, HASHSTRINGS_TABLE_SIZE) and back to the string */
+
+#define HASHSTRINGS_TABLE_SIZE 34
+#define HASHSTRINGS_TABLE_BUCKETS 9
+
+#define HASH_FOUNDATION_INDEX 32
+#define HASH_DEFAULT_INDEX 5
+#define HASH_NULL_INDEX 22
+#define HASH_TRUE_INDEX 30
+#define HASH_FALSE_INDEX 21
+#define HASH_LOCALE_INDEX 33
+#define HASH_APPLICATION_INDEX 23
+#define HASH_USER_INDEX 11
+#define HASH_DAEMON_INDEX 14
+#define HASH_MEMORY_INDEX 2
+#define HASH_TEMPORARY_MEMORY_INDEX 16
+#define HASH_MEMORY_TRACKER_INDEX 25
+#define HASH_LOCAL_INDEX 12
+#define HASH_SAMPLED_INDEX 10
+#define HASH_REMOTE_INDEX 31
+#define HASH_NONE_INDEX 7
+#define HASH_TEST_INDEX 19
+#define HASH_STREAM_INDEX 17
+#define HASH_STRING_INDEX 24
+#define HASH_BENCHMARK_INDEX 0
+#define HASH_TOOL_INDEX 8
+#define HASH_CONFIG_INDEX 28
+#define HASH_ENVIRONMENT_INDEX 6
+#define HASH_EXECUTABLE_NAME_INDEX 13
+#define HASH_EXECUTABLE_DIRECTORY_INDEX 15
+#define HASH_EXECUTABLE_PATH_INDEX 18
+#define HASH_INITIAL_WORKING_DIRECTORY_INDEX 1
+#define HASH_CURRENT_WORKING_DIRECTORY_INDEX 9
+#define HASH_HOME_DIRECTORY_INDEX 29
+#define HASH_TEMPORARY_DIRECTORY_INDEX 4
+#define HASH_SYSTEM_INDEX 3
+#define HASH_DEBUG_INDEX 26
+#define HASH_PNACL_INDEX 27
+#define HASH_FS_INDEX 20
+
+static const uint32_t hashstrings_table_seed[HASHSTRINGS_TABLE_BUCKETS] = {
+	13, 14, 6, 38, 79, 0, 1, 41,
+	4616
+};
+
+static const hash_t hashstrings_table_hash[HASHSTRINGS_TABLE_SIZE] = {
+	0xf06a63ae2ff7eaceULL,
+	0x8f4d99e8f8ae0e18ULL,
+	0x1ef05c31f30b3115ULL,
+	0xb72020e83e0eb654ULL,
+	0xb75730bc0dd1d067ULL,
+	0xe1c3a22ea1763f7bULL,
+	0xaeb8326060894683ULL,
+	0xa90768116f8af366ULL,
+	0x4a8e770cf21d0529ULL,
+	0x6b80ceb3924e8af3ULL,
+	0x89ee6d65a3e65a7eULL,
+	0x921c12dbd6f624f6ULL,
+	0xd17754fcf40a2974ULL,
+	0xe04d18727d6aa0dfULL,
+	0x27b6055e22f461b7ULL,
+	0xb957eadb0ae3f969ULL,
+	0x99a81dcbf3f5c346ULL,
+	0x5798159f6f1f8b05ULL,
+	0xcdae3cb1dc4a5d81ULL,
+	0x74326336c500c367ULL,
+	0x4692a53ac19eddeeULL,
+	0xc095fcfff8bca4abULL,
+	0x9d633aef96c57587ULL,
+	0x1d0a3207798c58baULL,
+	0xa1cc1854ea614cb4ULL,
+	0x344315811a5c41deULL,
+	0x71626bc355dbf213ULL,
+	0xb361b58ae8fffba3ULL,
+	0x336f91cbb8948a62ULL,
+	0xbb5cb0f40e9f0f3aULL,
+	0x89a73a33420257f5ULL,
+	0x4d4ee1b3734e2c5cULL,
+	0x13f0d2e482a6eaadULL,
+	0xfb3833132a868037ULL
+};
+
+static const string_const_t hashstrings_table_string[HASHSTRINGS_TABLE_SIZE] = {
+	{ "benchmark", 9 },
+	{ "initial_working_directory", 25 },
+	{ "memory", 6 },
+	{ "system", 6 },
+	{ "temporary_directory", 19 },
+	{ "default", 7 },
+	{ "environment", 11 },
+	{ "none", 4 },
+	{ "tool", 4 },
+	{ "current_working_directory", 25 },
+	{ "sampled", 7 },
+	{ "user", 4 },
+	{ "local", 5 },
+	{ "executable_name", 15 },
+	{ "daemon", 6 },
+	{ "executable_directory", 20 },
+	{ "temporary_memory", 16 },
+	{ "stream", 6 },
+	{ "executable_path", 15 },
+	{ "test", 4 },
+	{ "fs", 2 },
+	{ "false", 5 },
+	{ "null", 4 },
+	{ "application", 11 },
+	{ "string", 6 },
+	{ "memory_tracker", 14 },
+	{ "debug", 5 },
+	{ "pnacl", 5 },
+	{ "config", 6 },
+	{ "home_directory", 14 },
+	{ "true", 4 },
+	{ "remote", 6 },
+	{ "foundation", 10 },
+	{ "locale", 6 }
+};
+
+/* Get dense index of a hash value in the table
+   \param value Hash value
+   \return Index of hash value, HASHSTRINGS_TABLE_SIZE if not in table */
+static FOUNDATION_FORCEINLINE size_t
+hashstrings_table_index(hash_t value) {
+	uint64_t seed = hashstrings_table_seed[(value >> 32) % HASHSTRINGS_TABLE_BUCKETS];
+	uint64_t mixed = value ^ (seed * 0x9e3779b97f4a7c15ULL);
+	size_t index;
+	mixed = (mixed ^ (mixed >> 33)) * 0xff51afd7ed558ccdULL;
+	index = (size_t)((mixed ^ (mixed >> 33)) % HASHSTRINGS_TABLE_SIZE);
+	return (hashstrings_table_hash[index] == value) ? index : HASHSTRINGS_TABLE_SIZE;
+}
+
+/* Reverse lookup of a hash value in the table
+   \param value Hash value
+   \return String matching hash value, empty string if not in table */
+static FOUNDATION_FORCEINLINE string_const_t
+hashstrings_table_lookup(hash_t value) {
+	size_t index = hashstrings_table_index(value);
+	if (index < HASHSTRINGS_TABLE_SIZE)
+		return hashstrings_table_string[index];
+	return string_null();
+}
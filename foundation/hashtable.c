@@ -13,6 +13,30 @@
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
 
+#define HASHTABLE32_SEALED      ((uint32_t)-1)
+#define HASHTABLE32_COPYING     ((uint32_t)-2)
+#define HASHTABLE64_SEALED      ((uint64_t)-1)
+#define HASHTABLE64_COPYING     ((uint64_t)-2)
+#define HASHTABLE_MIN_CAPACITY  16
+#define HASHTABLE_MIGRATE_CHUNK 64
+#define HASHTABLE_PREFETCH_DISTANCE 8
+
+#define HASHTABLE64_SNAPSHOT_MAGIC   0x34365448U //"HT64"
+#define HASHTABLE64_SNAPSHOT_VERSION 1
+
+//Snapshot header, padded so the table following it is cache line aligned in the mapping.
+//Byte order, pointer size and the hash function are encoded by magic, layout sizes and version
+typedef struct hashtable64_snapshot_t {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t header_size;
+	uint32_t entry_size;
+	uint64_t capacity;
+	uint64_t reserved[5];
+} hashtable64_snapshot_t;
+
+FOUNDATION_STATIC_ASSERT(sizeof(hashtable64_snapshot_t) == 64, "Snapshot header size mismatch");
+
 static FOUNDATION_FORCEINLINE uint32_t
 _hashtable32_hash(uint32_t key) {
 	key ^= key >> 16;
@@ -69,9 +93,12 @@ hashtable32_set(hashtable32_t* table, uint32_t key, uint32_t value) {
 
 	ie = eend = _hashtable32_hash(key) % table->capacity;
 	do {
-		uint32_t current_key = (uint32_t)atomic_load32(&table->entries[ie].key);
+		uint32_t current_key = (uint32_t)atomic_load32_explicit(&table->entries[ie].key,
+		                                                         MEMORY_ORDER_RELAXED);
 
-		if ((current_key == key) || (!current_key && atomic_cas32(&table->entries[ie].key, (int32_t)key, 0))) {
+		if ((current_key == key) || (!current_key &&
+		                              atomic_cas32_explicit(&table->entries[ie].key, (int32_t)key, 0,
+		                                                    MEMORY_ORDER_RELAXED))) {
 			table->entries[ie].value = value;
 			return true;
 		}
@@ -93,7 +120,7 @@ hashtable32_erase(hashtable32_t* table, uint32_t key) {
 
 	ie = eend = _hashtable32_hash(key) % table->capacity;
 	do {
-		current_key = (uint32_t)atomic_load32(&table->entries[ie].key);
+		current_key = (uint32_t)atomic_load32_explicit(&table->entries[ie].key, MEMORY_ORDER_RELAXED);
 
 		if (current_key == key) {
 			table->entries[ie].value = 0;
@@ -105,17 +132,12 @@ hashtable32_erase(hashtable32_t* table, uint32_t key) {
 	while (current_key && (ie != eend));
 }
 
-uint32_t
-hashtable32_get(hashtable32_t* table, uint32_t key) {
-	/*lint --e{613} */
-	size_t ie, eend;
+static FOUNDATION_FORCEINLINE uint32_t
+_hashtable32_lookup(hashtable32_t* table, uint32_t key, size_t ie) {
+	size_t eend = ie;
 	uint32_t current_key;
-
-	FOUNDATION_ASSERT(key);
-
-	ie = eend = _hashtable32_hash(key) % table->capacity;
 	do {
-		current_key = (uint32_t)atomic_load32(&table->entries[ie].key);
+		current_key = (uint32_t)atomic_load32_explicit(&table->entries[ie].key, MEMORY_ORDER_RELAXED);
 
 		if (current_key == key)
 			return table->entries[ie].value;
@@ -127,6 +149,52 @@ hashtable32_get(hashtable32_t* table, uint32_t key) {
 	return 0;
 }
 
+static FOUNDATION_FORCEINLINE uint32_t
+_hashtable32_lookup_stable(hashtable32_t* table, uint32_t key, size_t ie) {
+	//Retry if a compaction pass moved entries during the lookup
+	while (true) {
+		int32_t generation = atomic_load32_explicit(&table->generation, MEMORY_ORDER_ACQUIRE);
+		if (!(generation & 1)) {
+			uint32_t value;
+			value = _hashtable32_lookup(table, key, ie);
+			atomic_thread_fence_acquire();
+			if (atomic_load32(&table->generation) == generation)
+				return value;
+		}
+		thread_yield();
+	}
+}
+
+uint32_t
+hashtable32_get(hashtable32_t* table, uint32_t key) {
+	FOUNDATION_ASSERT(key);
+	return _hashtable32_lookup_stable(table, key, _hashtable32_hash(key) % table->capacity);
+}
+
+void
+hashtable32_get_batch(hashtable32_t* table, const uint32_t* keys, uint32_t* values, size_t count) {
+	size_t slot[HASHTABLE_PREFETCH_DISTANCE];
+	size_t ikey, iprefetch;
+
+	//Prefetch home slots for keys ahead while resolving current key, keeping computed slots
+	//in a ring buffer to avoid hashing twice
+	for (iprefetch = 0; (iprefetch < HASHTABLE_PREFETCH_DISTANCE) && (iprefetch < count); ++iprefetch) {
+		FOUNDATION_ASSERT(keys[iprefetch]);
+		slot[iprefetch] = _hashtable32_hash(keys[iprefetch]) % table->capacity;
+		FOUNDATION_PREFETCH(table->entries + slot[iprefetch]);
+	}
+	for (ikey = 0; ikey < count; ++ikey, ++iprefetch) {
+		size_t iring = ikey % HASHTABLE_PREFETCH_DISTANCE;
+		size_t ie = slot[iring];
+		if (iprefetch < count) {
+			FOUNDATION_ASSERT(keys[iprefetch]);
+			slot[iring] = _hashtable32_hash(keys[iprefetch]) % table->capacity;
+			FOUNDATION_PREFETCH(table->entries + slot[iring]);
+		}
+		values[ikey] = _hashtable32_lookup_stable(table, keys[ikey], ie);
+	}
+}
+
 uint32_t
 hashtable32_raw(hashtable32_t* table, size_t slot) {
 	if (!atomic_load32(&table->entries[slot].key))
@@ -150,6 +218,49 @@ hashtable32_clear(hashtable32_t* table) {
 	memset(table->entries, 0, sizeof(hashtable32_entry_t) * table->capacity);
 }
 
+size_t
+hashtable32_compact(hashtable32_t* table) {
+	size_t ie, istart, iprobe;
+	size_t reclaimed = 0;
+
+	atomic_store32(&table->generation, atomic_load32(&table->generation) + 1);
+	atomic_thread_fence_release();
+
+	for (ie = 0; ie < table->capacity; ++ie) {
+		if (atomic_load32(&table->entries[ie].key) && !table->entries[ie].value) {
+			atomic_store32(&table->entries[ie].key, 0);
+			++reclaimed;
+		}
+	}
+
+	//Reinsert remaining entries in probe order starting after an empty slot, so each entry
+	//is placed at or before its current position in its probe sequence
+	for (istart = 0; (istart < table->capacity) && atomic_load32(&table->entries[istart].key); ++istart)
+		/* */;
+	if (reclaimed && (istart < table->capacity)) {
+		for (iprobe = 1; iprobe <= table->capacity; ++iprobe) {
+			uint32_t key, value;
+			size_t islot;
+			ie = (istart + iprobe) % table->capacity;
+			key = (uint32_t)atomic_load32(&table->entries[ie].key);
+			if (!key)
+				continue;
+			value = table->entries[ie].value;
+			atomic_store32(&table->entries[ie].key, 0);
+			islot = _hashtable32_hash(key) % table->capacity;
+			while (atomic_load32(&table->entries[islot].key))
+				islot = (islot + 1) % table->capacity;
+			table->entries[islot].value = value;
+			atomic_store32(&table->entries[islot].key, (int32_t)key);
+		}
+	}
+
+	atomic_thread_fence_release();
+	atomic_store32(&table->generation, atomic_load32(&table->generation) + 1);
+
+	return reclaimed;
+}
+
 hashtable64_t*
 hashtable64_allocate(size_t buckets) {
 	size_t size = sizeof(hashtable64_t) + sizeof(hashtable64_entry_t) * buckets;
@@ -185,9 +296,12 @@ hashtable64_set(hashtable64_t* table, uint64_t key, uint64_t value) {
 
 	ie = eend = _hashtable64_hash(key) % table->capacity;
 	do {
-		uint64_t current_key = (uint64_t)atomic_load64(&table->entries[ie].key);
+		uint64_t current_key = (uint64_t)atomic_load64_explicit(&table->entries[ie].key,
+		                                                         MEMORY_ORDER_RELAXED);
 
-		if ((current_key == key) || (!current_key && atomic_cas64(&table->entries[ie].key, (int64_t)key, 0))) {
+		if ((current_key == key) || (!current_key &&
+		                              atomic_cas64_explicit(&table->entries[ie].key, (int64_t)key, 0,
+		                                                    MEMORY_ORDER_RELAXED))) {
 			table->entries[ie].value = value;
 			return true;
 		}
@@ -208,7 +322,7 @@ hashtable64_erase(hashtable64_t* table, uint64_t key) {
 
 	ie = eend = _hashtable64_hash(key) % table->capacity;
 	do {
-		current_key = (uint64_t)atomic_load64(&table->entries[ie].key);
+		current_key = (uint64_t)atomic_load64_explicit(&table->entries[ie].key, MEMORY_ORDER_RELAXED);
 
 		if (current_key == key) {
 			table->entries[ie].value = 0;
@@ -220,16 +334,12 @@ hashtable64_erase(hashtable64_t* table, uint64_t key) {
 	while (current_key && (ie != eend));
 }
 
-uint64_t
-hashtable64_get(hashtable64_t* table, uint64_t key) {
-	size_t ie, eend;
+static FOUNDATION_FORCEINLINE uint64_t
+_hashtable64_lookup(hashtable64_t* table, uint64_t key, size_t ie) {
+	size_t eend = ie;
 	uint64_t current_key;
-
-	FOUNDATION_ASSERT(key);
-
-	ie = eend = _hashtable64_hash(key) % table->capacity;
 	do {
-		current_key = (uint64_t)atomic_load64(&table->entries[ie].key);
+		current_key = (uint64_t)atomic_load64_explicit(&table->entries[ie].key, MEMORY_ORDER_RELAXED);
 
 		if (current_key == key)
 			return table->entries[ie].value;
@@ -241,6 +351,52 @@ hashtable64_get(hashtable64_t* table, uint64_t key) {
 	return 0;
 }
 
+static FOUNDATION_FORCEINLINE uint64_t
+_hashtable64_lookup_stable(hashtable64_t* table, uint64_t key, size_t ie) {
+	//Retry if a compaction pass moved entries during the lookup
+	while (true) {
+		int32_t generation = atomic_load32_explicit(&table->generation, MEMORY_ORDER_ACQUIRE);
+		if (!(generation & 1)) {
+			uint64_t value;
+			value = _hashtable64_lookup(table, key, ie);
+			atomic_thread_fence_acquire();
+			if (atomic_load32(&table->generation) == generation)
+				return value;
+		}
+		thread_yield();
+	}
+}
+
+uint64_t
+hashtable64_get(hashtable64_t* table, uint64_t key) {
+	FOUNDATION_ASSERT(key);
+	return _hashtable64_lookup_stable(table, key, _hashtable64_hash(key) % table->capacity);
+}
+
+void
+hashtable64_get_batch(hashtable64_t* table, const uint64_t* keys, uint64_t* values, size_t count) {
+	size_t slot[HASHTABLE_PREFETCH_DISTANCE];
+	size_t ikey, iprefetch;
+
+	//Prefetch home slots for keys ahead while resolving current key, keeping computed slots
+	//in a ring buffer to avoid hashing twice
+	for (iprefetch = 0; (iprefetch < HASHTABLE_PREFETCH_DISTANCE) && (iprefetch < count); ++iprefetch) {
+		FOUNDATION_ASSERT(keys[iprefetch]);
+		slot[iprefetch] = _hashtable64_hash(keys[iprefetch]) % table->capacity;
+		FOUNDATION_PREFETCH(table->entries + slot[iprefetch]);
+	}
+	for (ikey = 0; ikey < count; ++ikey, ++iprefetch) {
+		size_t iring = ikey % HASHTABLE_PREFETCH_DISTANCE;
+		size_t ie = slot[iring];
+		if (iprefetch < count) {
+			FOUNDATION_ASSERT(keys[iprefetch]);
+			slot[iring] = _hashtable64_hash(keys[iprefetch]) % table->capacity;
+			FOUNDATION_PREFETCH(table->entries + slot[iring]);
+		}
+		values[ikey] = _hashtable64_lookup_stable(table, keys[ikey], ie);
+	}
+}
+
 uint64_t
 hashtable64_raw(hashtable64_t* table, size_t slot) {
 	if (!atomic_load64(&table->entries[slot].key))
@@ -263,3 +419,534 @@ void
 hashtable64_clear(hashtable64_t* table) {
 	memset(table->entries, 0, sizeof(hashtable64_entry_t) * table->capacity);
 }
+
+size_t
+hashtable64_compact(hashtable64_t* table) {
+	size_t ie, istart, iprobe;
+	size_t reclaimed = 0;
+
+	atomic_store32(&table->generation, atomic_load32(&table->generation) + 1);
+	atomic_thread_fence_release();
+
+	for (ie = 0; ie < table->capacity; ++ie) {
+		if (atomic_load64(&table->entries[ie].key) && !table->entries[ie].value) {
+			atomic_store64(&table->entries[ie].key, 0);
+			++reclaimed;
+		}
+	}
+
+	//Reinsert remaining entries in probe order starting after an empty slot, so each entry
+	//is placed at or before its current position in its probe sequence
+	for (istart = 0; (istart < table->capacity) && atomic_load64(&table->entries[istart].key); ++istart)
+		/* */;
+	if (reclaimed && (istart < table->capacity)) {
+		for (iprobe = 1; iprobe <= table->capacity; ++iprobe) {
+			uint64_t key, value;
+			size_t islot;
+			ie = (istart + iprobe) % table->capacity;
+			key = (uint64_t)atomic_load64(&table->entries[ie].key);
+			if (!key)
+				continue;
+			value = table->entries[ie].value;
+			atomic_store64(&table->entries[ie].key, 0);
+			islot = _hashtable64_hash(key) % table->capacity;
+			while (atomic_load64(&table->entries[islot].key))
+				islot = (islot + 1) % table->capacity;
+			table->entries[islot].value = value;
+			atomic_store64(&table->entries[islot].key, (int64_t)key);
+		}
+	}
+
+	atomic_thread_fence_release();
+	atomic_store32(&table->generation, atomic_load32(&table->generation) + 1);
+
+	return reclaimed;
+}
+
+bool
+hashtable64_write(hashtable64_t* table, stream_t* stream) {
+	hashtable64_snapshot_t snapshot;
+	hashtable64_t header;
+	size_t entries_size = sizeof(hashtable64_entry_t) * table->capacity;
+
+	memset(&snapshot, 0, sizeof(snapshot));
+	snapshot.magic = HASHTABLE64_SNAPSHOT_MAGIC;
+	snapshot.version = HASHTABLE64_SNAPSHOT_VERSION;
+	snapshot.header_size = (uint32_t)sizeof(hashtable64_t);
+	snapshot.entry_size = (uint32_t)sizeof(hashtable64_entry_t);
+	snapshot.capacity = table->capacity;
+
+	//Written as a table at rest, not in the middle of a compaction
+	memset(&header, 0, sizeof(header));
+	header.capacity = table->capacity;
+
+	if (stream_write(stream, &snapshot, sizeof(snapshot)) != sizeof(snapshot))
+		return false;
+	if (stream_write(stream, &header, sizeof(header)) != sizeof(header))
+		return false;
+	return stream_write(stream, table->entries, entries_size) == entries_size;
+}
+
+hashtable64_t*
+hashtable64_map(stream_t* stream) {
+	const hashtable64_snapshot_t* snapshot;
+	size_t size = 0;
+
+	snapshot = fs_mapped_data(stream, &size);
+	if (!snapshot || (size < sizeof(hashtable64_snapshot_t) + sizeof(hashtable64_t)))
+		return 0;
+	if ((snapshot->magic != HASHTABLE64_SNAPSHOT_MAGIC) ||
+	    (snapshot->version != HASHTABLE64_SNAPSHOT_VERSION) ||
+	    (snapshot->header_size != sizeof(hashtable64_t)) ||
+	    (snapshot->entry_size != sizeof(hashtable64_entry_t))) {
+		log_error(0, ERROR_INVALID_VALUE, STRING_CONST("Invalid or incompatible hash table snapshot"));
+		return 0;
+	}
+	size -= sizeof(hashtable64_snapshot_t) + sizeof(hashtable64_t);
+	if (snapshot->capacity > (size / sizeof(hashtable64_entry_t))) {
+		log_error(0, ERROR_INVALID_VALUE, STRING_CONST("Truncated hash table snapshot"));
+		return 0;
+	}
+	return (hashtable64_t*)(uintptr_t)pointer_offset_const(snapshot, sizeof(hashtable64_snapshot_t));
+}
+
+static hashtable32_storage_t*
+_hashtable32_storage_allocate(size_t capacity) {
+	hashtable32_storage_t* storage = memory_allocate(0, sizeof(hashtable32_storage_t) +
+	                                                  sizeof(hashtable32_slot_t) * capacity, 8,
+	                                                  MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	storage->capacity = capacity;
+	return storage;
+}
+
+static hashtable32_storage_t*
+_hashtable32_storage_next(hashtable32_storage_t* storage) {
+	hashtable32_storage_t* next = atomic_loadptr(&storage->next);
+	if (!next) {
+		//Racing threads may allocate, only one storage gets published
+		next = _hashtable32_storage_allocate(storage->capacity * 2);
+		if (!atomic_cas_ptr(&storage->next, next, 0)) {
+			memory_deallocate(next);
+			next = atomic_loadptr(&storage->next);
+		}
+	}
+	return next;
+}
+
+static void
+_hashtable32_migrate_slot(hashtable32_storage_t* storage, hashtable32_slot_t* slot);
+
+static bool
+_hashtable32_store(hashtable32_storage_t* storage, uint32_t key, uint32_t value, bool claim) {
+	while (storage) {
+		size_t mask = storage->capacity - 1;
+		size_t ie = (size_t)_hashtable32_hash(key) & mask;
+		size_t iprobe;
+		hashtable32_slot_t* slot = 0;
+		bool sealed = false;
+
+		for (iprobe = 0; !slot && !sealed && (iprobe < storage->capacity); ++iprobe, ie = (ie + 1) & mask) {
+			hashtable32_slot_t* current = storage->slots + ie;
+			uint32_t current_key = (uint32_t)atomic_load32(&current->key);
+			if (!current_key) {
+				//Empty slot sealed by migration, key can only be in next storage
+				if ((uint32_t)atomic_load32(&current->value) == HASHTABLE32_SEALED)
+					sealed = true;
+				else if (!claim)
+					return false;
+				else if (atomic_cas32(&current->key, (int32_t)key, 0)) {
+					int32_t used = atomic_incr32(&storage->used);
+					if ((size_t)used > (storage->capacity - (storage->capacity >> 2)))
+						_hashtable32_storage_next(storage);
+					slot = current;
+				}
+				else if ((uint32_t)atomic_load32(&current->key) == key) {
+					slot = current;
+				}
+			}
+			else if (current_key == key) {
+				slot = current;
+			}
+		}
+
+		while (slot) {
+			uint32_t current_value = (uint32_t)atomic_load32(&slot->value);
+			if (current_value == HASHTABLE32_COPYING) {
+				thread_yield();
+				continue;
+			}
+			if (current_value == HASHTABLE32_SEALED) {
+				sealed = true;
+				break;
+			}
+			if (atomic_cas32(&slot->value, (int32_t)value, (int32_t)current_value))
+				return true;
+		}
+
+		if (sealed || claim)
+			storage = _hashtable32_storage_next(storage);
+		else
+			storage = atomic_loadptr(&storage->next);
+	}
+	return false;
+}
+
+static void
+_hashtable32_migrate_slot(hashtable32_storage_t* storage, hashtable32_slot_t* slot) {
+	while (true) {
+		uint32_t value = (uint32_t)atomic_load32(&slot->value);
+		if (!value) {
+			if (atomic_cas32(&slot->value, (int32_t)HASHTABLE32_SEALED, 0))
+				return;
+		}
+		else if (atomic_cas32(&slot->value, (int32_t)HASHTABLE32_COPYING, (int32_t)value)) {
+			//Writers of the key wait while slot is copying, so no newer value can exist in next
+			uint32_t key = (uint32_t)atomic_load32(&slot->key);
+			_hashtable32_store(atomic_loadptr(&storage->next), key, value, true);
+			atomic_thread_fence_release();
+			atomic_store32(&slot->value, (int32_t)HASHTABLE32_SEALED);
+			return;
+		}
+	}
+}
+
+static void
+_hashtable32_migrate(hashtable32_resizable_t* table) {
+	hashtable32_storage_t* storage = atomic_loadptr(&table->current);
+	size_t start, end, islot;
+	int32_t done;
+	if (!atomic_loadptr(&storage->next))
+		return;
+	start = (size_t)atomic_exchange_and_add32(&storage->copy_index, HASHTABLE_MIGRATE_CHUNK);
+	if (start >= storage->capacity)
+		return;
+	end = start + HASHTABLE_MIGRATE_CHUNK;
+	if (end > storage->capacity)
+		end = storage->capacity;
+	for (islot = start; islot < end; ++islot)
+		_hashtable32_migrate_slot(storage, storage->slots + islot);
+	done = atomic_add32(&storage->copy_done, (int32_t)(end - start));
+	if ((size_t)done == storage->capacity)
+		atomic_cas_ptr(&table->current, atomic_loadptr(&storage->next), storage);
+}
+
+hashtable32_resizable_t*
+hashtable32_resizable_allocate(size_t capacity) {
+	hashtable32_resizable_t* table = memory_allocate(0, sizeof(hashtable32_resizable_t), 0,
+	                                                 MEMORY_PERSISTENT);
+
+	hashtable32_resizable_initialize(table, capacity);
+
+	return table;
+}
+
+void
+hashtable32_resizable_initialize(hashtable32_resizable_t* table, size_t capacity) {
+	size_t slots = HASHTABLE_MIN_CAPACITY;
+	while (slots < capacity)
+		slots <<= 1;
+	table->first = _hashtable32_storage_allocate(slots);
+	atomic_storeptr(&table->current, table->first);
+}
+
+void
+hashtable32_resizable_deallocate(hashtable32_resizable_t* table) {
+	hashtable32_resizable_finalize(table);
+	memory_deallocate(table);
+}
+
+void
+hashtable32_resizable_finalize(hashtable32_resizable_t* table) {
+	hashtable32_storage_t* storage = table->first;
+	while (storage) {
+		hashtable32_storage_t* next = atomic_loadptr(&storage->next);
+		memory_deallocate(storage);
+		storage = next;
+	}
+	table->first = 0;
+	atomic_storeptr(&table->current, 0);
+}
+
+bool
+hashtable32_resizable_set(hashtable32_resizable_t* table, uint32_t key, uint32_t value) {
+	FOUNDATION_ASSERT(key);
+	FOUNDATION_ASSERT(value < HASHTABLE32_COPYING);
+
+	_hashtable32_migrate(table);
+	return _hashtable32_store(atomic_loadptr(&table->current), key, value, true);
+}
+
+void
+hashtable32_resizable_erase(hashtable32_resizable_t* table, uint32_t key) {
+	FOUNDATION_ASSERT(key);
+
+	_hashtable32_migrate(table);
+	_hashtable32_store(atomic_loadptr(&table->current), key, 0, false);
+}
+
+uint32_t
+hashtable32_resizable_get(hashtable32_resizable_t* table, uint32_t key) {
+	hashtable32_storage_t* storage = atomic_loadptr(&table->current);
+
+	FOUNDATION_ASSERT(key);
+
+	while (storage) {
+		size_t mask = storage->capacity - 1;
+		size_t ie = (size_t)_hashtable32_hash(key) & mask;
+		size_t iprobe;
+		for (iprobe = 0; iprobe < storage->capacity; ++iprobe, ie = (ie + 1) & mask) {
+			hashtable32_slot_t* slot = storage->slots + ie;
+			uint32_t current_key = (uint32_t)atomic_load32(&slot->key);
+			uint32_t value;
+			if (current_key && (current_key != key))
+				continue;
+			do {
+				value = (uint32_t)atomic_load32(&slot->value);
+				if (value == HASHTABLE32_COPYING)
+					thread_yield();
+			} while (value == HASHTABLE32_COPYING);
+			if (value != HASHTABLE32_SEALED)
+				return current_key ? value : 0;
+			break;
+		}
+		storage = atomic_loadptr(&storage->next);
+	}
+	return 0;
+}
+
+size_t
+hashtable32_resizable_size(hashtable32_resizable_t* table) {
+	hashtable32_storage_t* storage = atomic_loadptr(&table->current);
+	size_t count = 0;
+	size_t islot;
+	while (storage) {
+		for (islot = 0; islot < storage->capacity; ++islot) {
+			uint32_t value = (uint32_t)atomic_load32(&storage->slots[islot].value);
+			if (value && (value < HASHTABLE32_COPYING))
+				++count;
+		}
+		storage = atomic_loadptr(&storage->next);
+	}
+	return count;
+}
+
+static hashtable64_storage_t*
+_hashtable64_storage_allocate(size_t capacity) {
+	hashtable64_storage_t* storage = memory_allocate(0, sizeof(hashtable64_storage_t) +
+	                                                  sizeof(hashtable64_slot_t) * capacity,
+	                                                  FOUNDATION_ALIGNOF(hashtable64_slot_t),
+	                                                  MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	storage->capacity = capacity;
+	return storage;
+}
+
+static hashtable64_storage_t*
+_hashtable64_storage_next(hashtable64_storage_t* storage) {
+	hashtable64_storage_t* next = atomic_loadptr(&storage->next);
+	if (!next) {
+		//Racing threads may allocate, only one storage gets published
+		next = _hashtable64_storage_allocate(storage->capacity * 2);
+		if (!atomic_cas_ptr(&storage->next, next, 0)) {
+			memory_deallocate(next);
+			next = atomic_loadptr(&storage->next);
+		}
+	}
+	return next;
+}
+
+static void
+_hashtable64_migrate_slot(hashtable64_storage_t* storage, hashtable64_slot_t* slot);
+
+static bool
+_hashtable64_store(hashtable64_storage_t* storage, uint64_t key, uint64_t value, bool claim) {
+	while (storage) {
+		size_t mask = storage->capacity - 1;
+		size_t ie = (size_t)_hashtable64_hash(key) & mask;
+		size_t iprobe;
+		hashtable64_slot_t* slot = 0;
+		bool sealed = false;
+
+		for (iprobe = 0; !slot && !sealed && (iprobe < storage->capacity); ++iprobe, ie = (ie + 1) & mask) {
+			hashtable64_slot_t* current = storage->slots + ie;
+			uint64_t current_key = (uint64_t)atomic_load64(&current->key);
+			if (!current_key) {
+				//Empty slot sealed by migration, key can only be in next storage
+				if ((uint64_t)atomic_load64(&current->value) == HASHTABLE64_SEALED)
+					sealed = true;
+				else if (!claim)
+					return false;
+				else if (atomic_cas64(&current->key, (int64_t)key, 0)) {
+					int32_t used = atomic_incr32(&storage->used);
+					if ((size_t)used > (storage->capacity - (storage->capacity >> 2)))
+						_hashtable64_storage_next(storage);
+					slot = current;
+				}
+				else if ((uint64_t)atomic_load64(&current->key) == key) {
+					slot = current;
+				}
+			}
+			else if (current_key == key) {
+				slot = current;
+			}
+		}
+
+		while (slot) {
+			uint64_t current_value = (uint64_t)atomic_load64(&slot->value);
+			if (current_value == HASHTABLE64_COPYING) {
+				thread_yield();
+				continue;
+			}
+			if (current_value == HASHTABLE64_SEALED) {
+				sealed = true;
+				break;
+			}
+			if (atomic_cas64(&slot->value, (int64_t)value, (int64_t)current_value))
+				return true;
+		}
+
+		if (sealed || claim)
+			storage = _hashtable64_storage_next(storage);
+		else
+			storage = atomic_loadptr(&storage->next);
+	}
+	return false;
+}
+
+static void
+_hashtable64_migrate_slot(hashtable64_storage_t* storage, hashtable64_slot_t* slot) {
+	while (true) {
+		uint64_t value = (uint64_t)atomic_load64(&slot->value);
+		if (!value) {
+			if (atomic_cas64(&slot->value, (int64_t)HASHTABLE64_SEALED, 0))
+				return;
+		}
+		else if (atomic_cas64(&slot->value, (int64_t)HASHTABLE64_COPYING, (int64_t)value)) {
+			//Writers of the key wait while slot is copying, so no newer value can exist in next
+			uint64_t key = (uint64_t)atomic_load64(&slot->key);
+			_hashtable64_store(atomic_loadptr(&storage->next), key, value, true);
+			atomic_thread_fence_release();
+			atomic_store64(&slot->value, (int64_t)HASHTABLE64_SEALED);
+			return;
+		}
+	}
+}
+
+static void
+_hashtable64_migrate(hashtable64_resizable_t* table) {
+	hashtable64_storage_t* storage = atomic_loadptr(&table->current);
+	size_t start, end, islot;
+	int32_t done;
+	if (!atomic_loadptr(&storage->next))
+		return;
+	start = (size_t)atomic_exchange_and_add32(&storage->copy_index, HASHTABLE_MIGRATE_CHUNK);
+	if (start >= storage->capacity)
+		return;
+	end = start + HASHTABLE_MIGRATE_CHUNK;
+	if (end > storage->capacity)
+		end = storage->capacity;
+	for (islot = start; islot < end; ++islot)
+		_hashtable64_migrate_slot(storage, storage->slots + islot);
+	done = atomic_add32(&storage->copy_done, (int32_t)(end - start));
+	if ((size_t)done == storage->capacity)
+		atomic_cas_ptr(&table->current, atomic_loadptr(&storage->next), storage);
+}
+
+hashtable64_resizable_t*
+hashtable64_resizable_allocate(size_t capacity) {
+	hashtable64_resizable_t* table = memory_allocate(0, sizeof(hashtable64_resizable_t), 0,
+	                                                 MEMORY_PERSISTENT);
+
+	hashtable64_resizable_initialize(table, capacity);
+
+	return table;
+}
+
+void
+hashtable64_resizable_initialize(hashtable64_resizable_t* table, size_t capacity) {
+	size_t slots = HASHTABLE_MIN_CAPACITY;
+	while (slots < capacity)
+		slots <<= 1;
+	table->first = _hashtable64_storage_allocate(slots);
+	atomic_storeptr(&table->current, table->first);
+}
+
+void
+hashtable64_resizable_deallocate(hashtable64_resizable_t* table) {
+	hashtable64_resizable_finalize(table);
+	memory_deallocate(table);
+}
+
+void
+hashtable64_resizable_finalize(hashtable64_resizable_t* table) {
+	hashtable64_storage_t* storage = table->first;
+	while (storage) {
+		hashtable64_storage_t* next = atomic_loadptr(&storage->next);
+		memory_deallocate(storage);
+		storage = next;
+	}
+	table->first = 0;
+	atomic_storeptr(&table->current, 0);
+}
+
+bool
+hashtable64_resizable_set(hashtable64_resizable_t* table, uint64_t key, uint64_t value) {
+	FOUNDATION_ASSERT(key);
+	FOUNDATION_ASSERT(value < HASHTABLE64_COPYING);
+
+	_hashtable64_migrate(table);
+	return _hashtable64_store(atomic_loadptr(&table->current), key, value, true);
+}
+
+void
+hashtable64_resizable_erase(hashtable64_resizable_t* table, uint64_t key) {
+	FOUNDATION_ASSERT(key);
+
+	_hashtable64_migrate(table);
+	_hashtable64_store(atomic_loadptr(&table->current), key, 0, false);
+}
+
+uint64_t
+hashtable64_resizable_get(hashtable64_resizable_t* table, uint64_t key) {
+	hashtable64_storage_t* storage = atomic_loadptr(&table->current);
+
+	FOUNDATION_ASSERT(key);
+
+	while (storage) {
+		size_t mask = storage->capacity - 1;
+		size_t ie = (size_t)_hashtable64_hash(key) & mask;
+		size_t iprobe;
+		for (iprobe = 0; iprobe < storage->capacity; ++iprobe, ie = (ie + 1) & mask) {
+			hashtable64_slot_t* slot = storage->slots + ie;
+			uint64_t current_key = (uint64_t)atomic_load64(&slot->key);
+			uint64_t value;
+			if (current_key && (current_key != key))
+				continue;
+			do {
+				value = (uint64_t)atomic_load64(&slot->value);
+				if (value == HASHTABLE64_COPYING)
+					thread_yield();
+			} while (value == HASHTABLE64_COPYING);
+			if (value != HASHTABLE64_SEALED)
+				return current_key ? value : 0;
+			break;
+		}
+		storage = atomic_loadptr(&storage->next);
+	}
+	return 0;
+}
+
+size_t
+hashtable64_resizable_size(hashtable64_resizable_t* table) {
+	hashtable64_storage_t* storage = atomic_loadptr(&table->current);
+	size_t count = 0;
+	size_t islot;
+	while (storage) {
+		for (islot = 0; islot < storage->capacity; ++islot) {
+			uint64_t value = (uint64_t)atomic_load64(&storage->slots[islot].value);
+			if (value && (value < HASHTABLE64_COPYING))
+				++count;
+		}
+		storage = atomic_loadptr(&storage->next);
+	}
+	return count;
+}
@@ -16,13 +16,15 @@
 \brief Lock-free key-value mapping container
 
 Simple lock-free container mapping 32/64-bit keys to values. Fixed size, thread-safe.
-Limitation are:
+For a growable alternative see the resizable variants, for example
+#hashtable32_resizable_allocate. Limitation are:
 <ul>
 <li>Only maps 32/64 bit integers to 32/64 bit integers
 <li>All keys must be non-zero
 <li>Fixed maximum number of entries
 <li>Only operations are get/set
-<li>No true erase operation, only set to zero
+<li>No true erase operation, only set to zero. Slots of erased keys are reclaimed by
+compacting the table
 </ul>
 \todo Look into a lock-free implementation of hopscotch hashing (http://en.wikipedia.org/wiki/Hopscotch_hashing) */
 
@@ -80,6 +82,16 @@ hashtable32_erase(hashtable32_t* table, uint32_t key);
 FOUNDATION_API uint32_t
 hashtable32_get(hashtable32_t* table, uint32_t key);
 
+/*! Get the values stored for a number of keys, or zero for keys with no value stored.
+Storage for keys later in the batch is prefetched while resolving earlier keys, hiding memory
+latency when looking up many keys in a large table.
+\param table Hash table
+\param keys Array of keys
+\param values Array receiving values, one for each key
+\param count Number of keys */
+FOUNDATION_API void
+hashtable32_get_batch(hashtable32_t* table, const uint32_t* keys, uint32_t* values, size_t count);
+
 /*! Get number of stored keys with non-zero values. Walks the table
 so potentially slow.
 \param table Hash table
@@ -93,6 +105,16 @@ initial allocation, freeing up all slots in the table.
 FOUNDATION_API void
 hashtable32_clear(hashtable32_t* table);
 
+/*! Compact the table by reclaiming slots of erased keys (keys with zero value) and
+rehashing remaining keys in place, restoring short probe sequences in tables with many erased
+keys. Safe to call while other threads call #hashtable32_get and #hashtable32_get_batch, which
+will retry lookups overlapping the compaction. Must not be called while other threads set or
+erase values.
+\param table Hash table
+\return Number of slots reclaimed */
+FOUNDATION_API size_t
+hashtable32_compact(hashtable32_t* table);
+
 /*! Allocate storage for a 64-bit hash table of given size. The returned hash table should
 be deallocated with a call to #hashtable64_deallocate.
 \param buckets Number of buckets
@@ -140,6 +162,16 @@ hashtable64_erase(hashtable64_t* table, uint64_t key);
 FOUNDATION_API uint64_t
 hashtable64_get(hashtable64_t* table, uint64_t key);
 
+/*! Get the values stored for a number of keys, or zero for keys with no value stored.
+Storage for keys later in the batch is prefetched while resolving earlier keys, hiding memory
+latency when looking up many keys in a large table.
+\param table Hash table
+\param keys Array of keys
+\param values Array receiving values, one for each key
+\param count Number of keys */
+FOUNDATION_API void
+hashtable64_get_batch(hashtable64_t* table, const uint64_t* keys, uint64_t* values, size_t count);
+
 /*! Get number of stored keys with non-zero values. Walks the table
 so potentially slow.
 \param table Hash table
@@ -153,6 +185,38 @@ initial allocation.
 FOUNDATION_API void
 hashtable64_clear(hashtable64_t* table);
 
+/*! Compact the table by reclaiming slots of erased keys (keys with zero value) and
+rehashing remaining keys in place, restoring short probe sequences in tables with many erased
+keys. Safe to call while other threads call #hashtable64_get and #hashtable64_get_batch, which
+will retry lookups overlapping the compaction. Must not be called while other threads set or
+erase values.
+\param table Hash table
+\return Number of slots reclaimed */
+FOUNDATION_API size_t
+hashtable64_compact(hashtable64_t* table);
+
+/*! Write a snapshot of the table to a stream in its in-memory layout, preceded by a small
+header, for reopening with #hashtable64_map. Must not be called while other threads set or
+erase values.
+\param table Hash table
+\param stream Output stream
+\return true if successful, false if the stream write failed */
+FOUNDATION_API bool
+hashtable64_write(hashtable64_t* table, stream_t* stream);
+
+/*! Use a table snapshot written by #hashtable64_write directly from a file mapped with
+#fs_map_file, without reading or rebuilding the table. Pages of the table are loaded lazily
+on first access. If the file was mapped read-only only #hashtable64_get, #hashtable64_get_batch
+and #hashtable64_size may be called, if mapped copy-on-write with STREAM_OUT the table can also
+be modified in place, without changes being written back to the file. The table cannot grow
+beyond the snapshot capacity. The table must not be deallocated or finalized, and is valid
+until the stream is deallocated. Snapshots are only compatible between builds of the same byte
+order and pointer size.
+\param stream Memory mapped stream
+\return Hash table, null if the stream is not mapped or does not hold a valid snapshot */
+FOUNDATION_API hashtable64_t*
+hashtable64_map(stream_t* stream);
+
 /*!
 \def hashtable_t
 Defined alias for a hash table storing values the size of a pointer,
@@ -214,3 +278,125 @@ initialization.
 #define hashtable_clear         hashtable64_clear
 
 #endif
+
+/*! Allocate a resizable 32-bit hash table. The table grows when it fills up by migrating
+entries to a new storage of twice the capacity. Migration is done incrementally and
+cooperatively by all threads calling #hashtable32_resizable_set and
+#hashtable32_resizable_erase. Lookups during migration are lock free, and previous storage is
+kept until the table is finalized since concurrent lookups may still access it. Values
+must be less than 0xFFFFFFFE, the top two values are reserved for migration. The returned hash
+table should be deallocated with a call to #hashtable32_resizable_deallocate.
+\param capacity Initial capacity, rounded up to a power of two
+\return New hash table */
+FOUNDATION_API hashtable32_resizable_t*
+hashtable32_resizable_allocate(size_t capacity);
+
+/*! Deallocate hash table previously allocated by a call to #hashtable32_resizable_allocate
+and free resources and storage used by hash table
+\param table Hash table */
+FOUNDATION_API void
+hashtable32_resizable_deallocate(hashtable32_resizable_t* table);
+
+/*! Initialize a resizable 32-bit hash table, see #hashtable32_resizable_allocate. The
+hash table should be finalized with a call to #hashtable32_resizable_finalize.
+\param table Hash table
+\param capacity Initial capacity, rounded up to a power of two */
+FOUNDATION_API void
+hashtable32_resizable_initialize(hashtable32_resizable_t* table, size_t capacity);
+
+/*! Finalize a resizable hash table and free all storage. Must not be called while other
+threads access the table.
+\param table Hash table */
+FOUNDATION_API void
+hashtable32_resizable_finalize(hashtable32_resizable_t* table);
+
+/*! Set stored value for the given key, growing the table if needed. Only out of memory
+conditions cause the call to fail.
+\param table Hash table
+\param key Key
+\param value New value
+\return true if value set, false if out of memory */
+FOUNDATION_API bool
+hashtable32_resizable_set(hashtable32_resizable_t* table, uint32_t key, uint32_t value);
+
+/*! Erase the value for a key by setting the value to zero. The key still holds a slot in
+the table until the table grows, when only keys with non-zero values are migrated.
+\param table Hash table
+\param key Key */
+FOUNDATION_API void
+hashtable32_resizable_erase(hashtable32_resizable_t* table, uint32_t key);
+
+/*! Get the value stored for the given key, or zero if no value stored
+\param table Hash table
+\param key Key
+\return Value stored for key, zero if not found */
+FOUNDATION_API uint32_t
+hashtable32_resizable_get(hashtable32_resizable_t* table, uint32_t key);
+
+/*! Get number of stored keys with non-zero values. Walks the table so potentially slow,
+and the count is approximate while the table is migrating.
+\param table Hash table
+\return Number of keys with non-zero values */
+FOUNDATION_API size_t
+hashtable32_resizable_size(hashtable32_resizable_t* table);
+
+/*! Allocate a resizable 64-bit hash table. The table grows when it fills up by migrating
+entries to a new storage of twice the capacity. Migration is done incrementally and
+cooperatively by all threads calling #hashtable64_resizable_set and
+#hashtable64_resizable_erase. Lookups during migration are lock free, and previous storage is
+kept until the table is finalized since concurrent lookups may still access it. Values
+must be less than 0xFFFFFFFFFFFFFFFE, the top two values are reserved for migration. The returned hash
+table should be deallocated with a call to #hashtable64_resizable_deallocate.
+\param capacity Initial capacity, rounded up to a power of two
+\return New hash table */
+FOUNDATION_API hashtable64_resizable_t*
+hashtable64_resizable_allocate(size_t capacity);
+
+/*! Deallocate hash table previously allocated by a call to #hashtable64_resizable_allocate
+and free resources and storage used by hash table
+\param table Hash table */
+FOUNDATION_API void
+hashtable64_resizable_deallocate(hashtable64_resizable_t* table);
+
+/*! Initialize a resizable 64-bit hash table, see #hashtable64_resizable_allocate. The
+hash table should be finalized with a call to #hashtable64_resizable_finalize.
+\param table Hash table
+\param capacity Initial capacity, rounded up to a power of two */
+FOUNDATION_API void
+hashtable64_resizable_initialize(hashtable64_resizable_t* table, size_t capacity);
+
+/*! Finalize a resizable hash table and free all storage. Must not be called while other
+threads access the table.
+\param table Hash table */
+FOUNDATION_API void
+hashtable64_resizable_finalize(hashtable64_resizable_t* table);
+
+/*! Set stored value for the given key, growing the table if needed. Only out of memory
+conditions cause the call to fail.
+\param table Hash table
+\param key Key
+\param value New value
+\return true if value set, false if out of memory */
+FOUNDATION_API bool
+hashtable64_resizable_set(hashtable64_resizable_t* table, uint64_t key, uint64_t value);
+
+/*! Erase the value for a key by setting the value to zero. The key still holds a slot in
+the table until the table grows, when only keys with non-zero values are migrated.
+\param table Hash table
+\param key Key */
+FOUNDATION_API void
+hashtable64_resizable_erase(hashtable64_resizable_t* table, uint64_t key);
+
+/*! Get the value stored for the given key, or zero if no value stored
+\param table Hash table
+\param key Key
+\return Value stored for key, zero if not found */
+FOUNDATION_API uint64_t
+hashtable64_resizable_get(hashtable64_resizable_t* table, uint64_t key);
+
+/*! Get number of stored keys with non-zero values. Walks the table so potentially slow,
+and the count is approximate while the table is migrating.
+\param table Hash table
+\return Number of keys with non-zero values */
+FOUNDATION_API size_t
+hashtable64_resizable_size(hashtable64_resizable_t* table);
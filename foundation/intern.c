@@ -0,0 +1,163 @@
+/* intern.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#define INTERN_BLOCK_SIZE (64 * 1024)
+#define INTERN_INITIAL_CAPACITY 1024
+
+typedef struct intern_entry_t intern_entry_t;
+
+//Entry header, followed by the zero terminated string data
+struct intern_entry_t {
+	//Previously interned string with the same table key
+	intern_entry_t* next;
+	hash_t hash;
+	size_t length;
+};
+
+static hashtable64_resizable_t* _intern_table;
+static mutex_t* _intern_lock;
+static void** _intern_blocks;
+static char* _intern_block;
+static size_t _intern_block_used;
+static size_t _intern_count;
+
+static FOUNDATION_FORCEINLINE uint64_t
+_intern_key(hash_t value) {
+	//Zero is not a valid table key
+	return value ? value : 1;
+}
+
+static FOUNDATION_FORCEINLINE const char*
+_intern_entry_string(const intern_entry_t* entry) {
+	return pointer_offset_const(entry, sizeof(intern_entry_t));
+}
+
+static intern_entry_t*
+_intern_find(uint64_t key, const char* str, size_t length) {
+	intern_entry_t* entry = (intern_entry_t*)(uintptr_t)hashtable64_resizable_get(_intern_table, key);
+	while (entry) {
+		if ((entry->length == length) && !memcmp(_intern_entry_string(entry), str, length))
+			return entry;
+		entry = entry->next;
+	}
+	return 0;
+}
+
+static intern_entry_t*
+_intern_allocate(size_t length) {
+	intern_entry_t* entry;
+	size_t size = (sizeof(intern_entry_t) + length + 1 + 7) & ~(size_t)7;
+	if (size > (INTERN_BLOCK_SIZE / 4)) {
+		entry = memory_allocate(HASH_STRING, size, 8, MEMORY_PERSISTENT);
+		if (entry)
+			array_push(_intern_blocks, (void*)entry);
+		return entry;
+	}
+	if (!_intern_block || ((_intern_block_used + size) > INTERN_BLOCK_SIZE)) {
+		_intern_block = memory_allocate(HASH_STRING, INTERN_BLOCK_SIZE, 8, MEMORY_PERSISTENT);
+		if (!_intern_block)
+			return 0;
+		array_push(_intern_blocks, (void*)_intern_block);
+		_intern_block_used = 0;
+	}
+	entry = pointer_offset(_intern_block, _intern_block_used);
+	_intern_block_used += size;
+	return entry;
+}
+
+interned_t
+intern_string(const char* str, size_t length) {
+	interned_t interned;
+	intern_entry_t* entry;
+	uint64_t key;
+
+	interned.hash = hash(str, length);
+	interned.string = string_const(str, length);
+	if (!_intern_table)
+		return interned;
+
+	key = _intern_key(interned.hash);
+	entry = _intern_find(key, str, length);
+	if (!entry) {
+		mutex_lock(_intern_lock);
+		entry = _intern_find(key, str, length);
+		if (!entry) {
+			entry = _intern_allocate(length);
+			if (entry) {
+				char* data = pointer_offset(entry, sizeof(intern_entry_t));
+				if (length)
+					memcpy(data, str, length);
+				data[length] = 0;
+				entry->hash = interned.hash;
+				entry->length = length;
+				entry->next = (intern_entry_t*)(uintptr_t)hashtable64_resizable_get(_intern_table, key);
+				//Entry is complete before being published to lock free readers
+				if (hashtable64_resizable_set(_intern_table, key, (uintptr_t)entry))
+					++_intern_count;
+				else
+					entry = 0;
+			}
+		}
+		mutex_unlock(_intern_lock);
+	}
+
+	if (entry)
+		interned.string = string_const(_intern_entry_string(entry), length);
+	return interned;
+}
+
+string_const_t
+intern_lookup(hash_t value) {
+	intern_entry_t* entry;
+	if (!_intern_table)
+		return string_null();
+	entry = (intern_entry_t*)(uintptr_t)hashtable64_resizable_get(_intern_table, _intern_key(value));
+	while (entry && (entry->hash != value))
+		entry = entry->next;
+	return entry ? string_const(_intern_entry_string(entry), entry->length) : string_null();
+}
+
+size_t
+intern_count(void) {
+	size_t count;
+	if (!_intern_lock)
+		return 0;
+	mutex_lock(_intern_lock);
+	count = _intern_count;
+	mutex_unlock(_intern_lock);
+	return count;
+}
+
+int
+_intern_initialize(void) {
+	_intern_lock = mutex_allocate(STRING_CONST("intern"));
+	_intern_table = hashtable64_resizable_allocate(INTERN_INITIAL_CAPACITY);
+	return (_intern_lock && _intern_table) ? 0 : -1;
+}
+
+void
+_intern_finalize(void) {
+	size_t iblock, count;
+	hashtable64_resizable_deallocate(_intern_table);
+	_intern_table = 0;
+	for (iblock = 0, count = array_size(_intern_blocks); iblock < count; ++iblock)
+		memory_deallocate(_intern_blocks[iblock]);
+	array_deallocate(_intern_blocks);
+	_intern_block = 0;
+	_intern_block_used = 0;
+	_intern_count = 0;
+	mutex_deallocate(_intern_lock);
+	_intern_lock = 0;
+}
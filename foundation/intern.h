@@ -0,0 +1,49 @@
+/* intern.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file intern.h
+\brief String interning
+
+Global thread-safe pool of interned strings. Interning a string returns a single shared copy
+of the string data together with the string hash, all identical strings interned share the
+same data pointer. Interned strings can be compared by pointer, or by hash with the usual
+caveat of hash collisions, instead of comparing the string data.
+
+Lookups of already interned strings are lock free, only interning a new string takes a lock.
+Interned strings are never released, the string data is valid until the foundation library
+is finalized. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Intern a string. If the string is already interned the existing copy is returned,
+otherwise the string is copied to the pool. The returned hash equals the result of #hash
+for the string data.
+\param str String
+\param length Length of string
+\return Interned string and hash */
+FOUNDATION_API interned_t
+intern_string(const char* str, size_t length);
+
+/*! Look up a previously interned string by hash. If several interned strings have the same
+hash the most recently interned string is returned.
+\param value Hash of string
+\return Interned string, null string if no string with the given hash is interned */
+FOUNDATION_API string_const_t
+intern_lookup(hash_t value);
+
+/*! Get number of interned strings
+\return Number of interned strings */
+FOUNDATION_API size_t
+intern_count(void);
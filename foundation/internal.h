@@ -35,20 +35,38 @@ _ringbuffer_stream_initialize(void);
 FOUNDATION_API void
 _buffer_stream_initialize(void);
 
+FOUNDATION_API void
+_compressed_stream_initialize(void);
+
+FOUNDATION_API void
+_base64_stream_initialize(void);
+
+FOUNDATION_API void
+_cipher_stream_initialize(void);
+
 #if FOUNDATION_PLATFORM_ANDROID
 FOUNDATION_API void
 _asset_stream_initialize(void);
+
+FOUNDATION_API const void*
+_asset_stream_mapped_data(stream_t* stream, size_t* size);
 #endif
 
 FOUNDATION_API void
 _pipe_stream_initialize(void);
 
+FOUNDATION_API void
+_socket_stream_initialize(void);
+
 FOUNDATION_API int
 _log_initialize(void);
 
 FOUNDATION_API void
 _log_finalize(void);
 
+FOUNDATION_API void
+_log_thread_finalize(void);
+
 FOUNDATION_API int
 _memory_initialize(const memory_system_t memory);
 
@@ -58,12 +76,20 @@ _memory_preallocate(void);
 FOUNDATION_API void
 _memory_finalize(void);
 
+FOUNDATION_API void
+_foundation_subsystem_timing(const char* name, size_t length, tick_t start);
+
 FOUNDATION_API int
 _time_initialize(void);
 
 FOUNDATION_API void
 _time_finalize(void);
 
+//Operating system monotonic clock in nanoseconds, usable before time is initialized and
+//unaffected by the cycle counter selection
+FOUNDATION_API tick_t
+_time_system_ns(void);
+
 FOUNDATION_API int
 _thread_initialize(void);
 
@@ -76,12 +102,24 @@ _environment_initialize(const application_t application);
 FOUNDATION_API void
 _environment_finalize(void);
 
+FOUNDATION_API int
+_objectmap_initialize(void);
+
+FOUNDATION_API void
+_objectmap_finalize(void);
+
+FOUNDATION_API void
+_objectmap_thread_finalize(void);
+
 FOUNDATION_API int
 _library_initialize(void);
 
 FOUNDATION_API void
 _library_finalize(void);
 
+FOUNDATION_API size_t
+_library_modules(string_const_t* names, uintptr_t* bases, size_t capacity);
+
 FOUNDATION_API int
 _system_initialize(void);
 
@@ -94,6 +132,50 @@ _stream_initialize(void);
 FOUNDATION_API void
 _stream_finalize(void);
 
+FOUNDATION_API void
+_stream_swap_array(void* dst, const void* src, size_t count, size_t width);
+
+#if FOUNDATION_PLATFORM_POSIX
+FOUNDATION_API size_t
+_stream_fd_vector(int fd, const stream_span_t* spans, size_t count, bool write);
+
+FOUNDATION_API int
+_fs_file_descriptor_acquire(stream_t* stream);
+
+FOUNDATION_API void
+_fs_file_descriptor_release(stream_t* stream, int fd, bool eos);
+#endif
+
+FOUNDATION_API int
+_checksum_initialize(void);
+
+FOUNDATION_API void
+_checksum_finalize(void);
+
+FOUNDATION_API int
+_varint_initialize(void);
+
+FOUNDATION_API void
+_varint_finalize(void);
+
+FOUNDATION_API int
+_intern_initialize(void);
+
+FOUNDATION_API void
+_intern_finalize(void);
+
+FOUNDATION_API int
+_pack_initialize(void);
+
+FOUNDATION_API void
+_pack_finalize(void);
+
+FOUNDATION_API int
+_regex_initialize(void);
+
+FOUNDATION_API void
+_regex_finalize(void);
+
 FOUNDATION_API int
 _fs_initialize(void);
 
@@ -112,6 +194,9 @@ _config_initialize(void);
 FOUNDATION_API void
 _config_finalize(void);
 
+FOUNDATION_API void
+_config_thread_finalize(void);
+
 FOUNDATION_API void
 _profile_thread_finalize(void);
 
@@ -144,6 +229,36 @@ _object_initialize(object_base_t* obj, object_t id);
 FOUNDATION_API void
 _environment_main_args(int argc, const char* const* argv);
 
+// Per-thread context, grouping the thread local state touched on hot paths into a single
+// native thread local block so all of it is reached with one thread pointer offset
+
+typedef struct foundation_thread_context_t foundation_thread_context_t;
+
+struct foundation_thread_context_t {
+	memory_context_t* memory_context;
+	error_context_t* error_context;
+	unsigned int* random_state;
+	int32_t profile_block;
+};
+
+#if FOUNDATION_HAVE_NATIVE_TLS
+
+FOUNDATION_API FOUNDATION_THREADLOCAL foundation_thread_context_t _foundation_thread_context
+FOUNDATION_THREADLOCAL_MODEL;
+
+#define FOUNDATION_DECLARE_THREAD_CONTEXT( type, name ) \
+static FOUNDATION_FORCEINLINE void set_thread_##name( type val ) { _foundation_thread_context.name = val; } \
+static FOUNDATION_FORCEINLINE type get_thread_##name( void ) { return _foundation_thread_context.name; }
+
+#else
+
+// Fall back to separate thread local keys, allocating a grouped block would recurse into the
+// memory system which itself reads the memory context
+#define FOUNDATION_DECLARE_THREAD_CONTEXT( type, name ) \
+FOUNDATION_DECLARE_THREAD_LOCAL( type, name, 0 )
+
+#endif
+
 // Global data
 
 FOUNDATION_API foundation_config_t _foundation_config;
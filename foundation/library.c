@@ -18,6 +18,9 @@
 #  define FOUNDATION_SUPPORT_LIBRARY_LOAD 1
 #elif FOUNDATION_PLATFORM_POSIX
 #  include <dlfcn.h>
+#  if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_BSD
+#    include <link.h>
+#  endif
 #  define FOUNDATION_SUPPORT_LIBRARY_LOAD 1
 #else
 #  define FOUNDATION_SUPPORT_LIBRARY_LOAD 0
@@ -32,30 +35,43 @@ struct library_t {
 	char    name[32];
 	hash_t  name_hash;
 	size_t  name_length;
+	//Load address, zero if unknown
+	uintptr_t base;
 
 #if FOUNDATION_PLATFORM_WINDOWS
 	HANDLE  dll;
 #elif FOUNDATION_PLATFORM_POSIX
 	void*   lib;
 #endif
+
+	//Symbol name hash to address, including symbols not found in the library
+	lock_t     symbol_lock;
+	hashmap_t  symbols;
 };
 
 typedef FOUNDATION_ALIGN(8) struct library_t library_t;
 
 static objectmap_t* _library_map;
+//Library base name hash to object id of loaded library
+static hashmap_t* _library_names;
+static lock_t _library_lock;
 
 int
 _library_initialize(void) {
 	_library_map = objectmap_allocate(_foundation_config.library_max);
 	if (!_library_map)
 		return -1;
+	_library_names = hashmap_allocate(0, 0);
+	lock_initialize(&_library_lock);
 	return 0;
 }
 
 void
 _library_finalize(void) {
 	objectmap_deallocate(_library_map);
+	hashmap_deallocate(_library_names);
 	_library_map = 0;
+	_library_names = 0;
 }
 
 static void
@@ -64,12 +80,21 @@ _library_destroy(object_t id, void* obj) {
 
 	objectmap_free(_library_map, id);
 
+	//A library with the same name may have been loaded again while this was being released
+	lock_lock(&_library_lock);
+	if ((object_t)(uintptr_t)hashmap_lookup(_library_names, library->name_hash) == id)
+		hashmap_erase(_library_names, library->name_hash);
+	lock_unlock(&_library_lock);
+
 #if FOUNDATION_PLATFORM_WINDOWS
 	FreeLibrary(library->dll);
 #elif FOUNDATION_PLATFORM_POSIX
 	dlclose(library->lib);
 #endif
+	//Addresses in the unloaded library may be reused by other code
+	stacktrace_cache_clear();
 
+	hashmap_finalize(&library->symbols);
 	memory_deallocate(library);
 }
 
@@ -77,7 +102,6 @@ object_t
 library_load(const char* name, size_t length) {
 	library_t* library;
 	hash_t name_hash;
-	size_t i, size;
 	object_t id;
 	const char* basename;
 	size_t last_slash;
@@ -110,16 +134,16 @@ library_load(const char* name, size_t length) {
 		base_length = length - last_slash;
 	}
 
-	//Locate already loaded library
-	library = 0;
+	//Locate already loaded library, a library being released fails to get a reference and is
+	//loaded again
 	name_hash = string_hash(basename, base_length);
-	for (i = 0, size = objectmap_size(_library_map); i < size; ++i) {
-		library = objectmap_raw_lookup(_library_map, i);
-		if (library && (library->name_hash == name_hash)) {
-			FOUNDATION_ASSERT(string_equal(library->name, library->name_length, basename, base_length));
-			atomic_incr32(&library->ref);
-			return library->id;
-		}
+	lock_lock(&_library_lock);
+	id = (object_t)(uintptr_t)hashmap_lookup(_library_names, name_hash);
+	library = id ? objectmap_lookup_ref(_library_map, id) : 0;
+	lock_unlock(&_library_lock);
+	if (library) {
+		FOUNDATION_ASSERT(string_equal(library->name, library->name_length, basename, base_length));
+		return library->id;
 	}
 
 	error_context_push(STRING_CONST("loading library"), name, length);
@@ -205,11 +229,24 @@ library_load(const char* name, size_t length) {
 	                                   base_length).length;
 #if FOUNDATION_PLATFORM_WINDOWS
 	library->dll = dll;
+	library->base = (uintptr_t)dll;
 #elif FOUNDATION_PLATFORM_POSIX
 	library->lib = lib;
+#  if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_BSD
+	{
+		struct link_map* map = 0;
+		if ((dlinfo(lib, RTLD_DI_LINKMAP, &map) == 0) && map)
+			library->base = (uintptr_t)map->l_addr;
+	}
+#  endif
 #endif
+	hashmap_initialize(&library->symbols, 0, 0);
 	objectmap_set(_library_map, id, library);
 
+	lock_lock(&_library_lock);
+	hashmap_insert(_library_names, name_hash, (void*)(uintptr_t)id);
+	lock_unlock(&_library_lock);
+
 	error_context_pop();
 
 	return library->id;
@@ -225,22 +262,51 @@ library_unload(object_t id) {
 	objectmap_lookup_unref(_library_map, id, _library_destroy);
 }
 
+//Look up symbol in cache or library, must be called with symbol lock held
+static void*
+_library_symbol(library_t* library, const char* name, size_t length) {
+	hash_t symbol_hash = string_hash(name, length);
+	void* symbol = hashmap_lookup(&library->symbols, symbol_hash);
+	if (symbol || hashmap_has_key(&library->symbols, symbol_hash))
+		return symbol;
+#if FOUNDATION_PLATFORM_WINDOWS
+	symbol = (void*)GetProcAddress(library->dll, name);
+#elif FOUNDATION_PLATFORM_POSIX
+	symbol = dlsym(library->lib, name);
+#endif
+	hashmap_insert(&library->symbols, symbol_hash, symbol);
+	return symbol;
+}
+
 void*
 library_symbol(object_t id, const char* name, size_t length) {
 	library_t* library = objectmap_lookup(_library_map, id);
-	FOUNDATION_UNUSED(length);
+	void* symbol = 0;
 	if (library) {
-#if FOUNDATION_PLATFORM_WINDOWS
-		return GetProcAddress(library->dll, name);
-#elif FOUNDATION_PLATFORM_POSIX
-		return dlsym(library->lib, name);
-#else
-		FOUNDATION_UNUSED(name);
-		log_errorf(0, ERROR_NOT_IMPLEMENTED,
-		           STRING_CONST("Dynamic library symbol lookup implemented for this platform"));
-#endif
+		lock_lock(&library->symbol_lock);
+		symbol = _library_symbol(library, name, length);
+		lock_unlock(&library->symbol_lock);
 	}
-	return 0;
+	return symbol;
+}
+
+size_t
+library_symbols(object_t id, const string_const_t* names, size_t count, void** symbols) {
+	library_t* library = objectmap_lookup(_library_map, id);
+	size_t isym, found = 0;
+	if (!library) {
+		memset(symbols, 0, sizeof(void*) * count);
+		return 0;
+	}
+	lock_lock(&library->symbol_lock);
+	hashmap_reserve(&library->symbols, hashmap_size(&library->symbols) + count);
+	for (isym = 0; isym < count; ++isym) {
+		symbols[isym] = _library_symbol(library, STRING_ARGS(names[isym]));
+		if (symbols[isym])
+			++found;
+	}
+	lock_unlock(&library->symbol_lock);
+	return found;
 }
 
 string_const_t
@@ -256,6 +322,22 @@ library_valid(object_t id) {
 	return objectmap_lookup(_library_map, id) != 0;
 }
 
+size_t
+_library_modules(string_const_t* names, uintptr_t* bases, size_t capacity) {
+	size_t islot, size, count = 0;
+	//Only reads memory, as it is called from signal handlers
+	size = _library_map ? objectmap_size(_library_map) : 0;
+	for (islot = 0; (islot < size) && (count < capacity); ++islot) {
+		library_t* library = objectmap_raw_lookup(_library_map, islot);
+		if (library) {
+			names[count] = string_const(library->name, library->name_length);
+			bases[count] = library->base;
+			++count;
+		}
+	}
+	return count;
+}
+
 #else
 
 int
@@ -295,6 +377,14 @@ library_symbol(object_t id, const char* name, size_t length) {
 	return 0;
 }
 
+size_t
+library_symbols(object_t id, const string_const_t* names, size_t count, void** symbols) {
+	FOUNDATION_UNUSED(id);
+	FOUNDATION_UNUSED(names);
+	memset(symbols, 0, sizeof(void*) * count);
+	return 0;
+}
+
 string_const_t
 library_name(object_t id) {
 	FOUNDATION_UNUSED(id);
@@ -307,4 +397,12 @@ library_valid(object_t id) {
 	return false;
 }
 
+size_t
+_library_modules(string_const_t* names, uintptr_t* bases, size_t capacity) {
+	FOUNDATION_UNUSED(names);
+	FOUNDATION_UNUSED(bases);
+	FOUNDATION_UNUSED(capacity);
+	return 0;
+}
+
 #endif
@@ -54,14 +54,25 @@ associated will be released.
 FOUNDATION_API void
 library_unload(object_t library);
 
-/*! Lookup a symbol by name in the library.
+/*! Lookup a symbol by name in the library. Results are cached by name hash in the library
+object, including symbols not found, so repeated lookups do not query the system loader.
 \param library Library object
-\param name Symbol name
+\param name Symbol name, must be zero terminated
 \param length Length of symbol name
 \return Address of symbol, 0 if not found */
 FOUNDATION_API void*
 library_symbol(object_t library, const char* name, size_t length);
 
+/*! Lookup a table of symbols by name in the library in one pass, for example to bind all
+entry points of a plugin. Results are cached the same way as #library_symbol.
+\param library Library object
+\param names Symbol names, each must be zero terminated
+\param count Number of symbols
+\param symbols Receives address of each symbol, 0 for symbols not found
+\return Number of symbols found */
+FOUNDATION_API size_t
+library_symbols(object_t library, const string_const_t* names, size_t count, void** symbols);
+
 /*! Get library name
 \param library Library object
 \return Library name, empty string if not a valid library */
@@ -0,0 +1,468 @@
+/* lock.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#if FOUNDATION_PLATFORM_WINDOWS
+#  include <foundation/windows.h>
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+#  include <foundation/posix.h>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#endif
+
+//Number of backoff rounds before parking, pause count doubles each round up to the limit
+#define LOCK_SPIN_ROUNDS 10
+#define LOCK_BACKOFF_LIMIT 64
+
+//Lock states
+#define LOCK_UNLOCKED  0
+#define LOCK_LOCKED    1
+#define LOCK_CONTENDED 2
+
+//Reader-writer lock state bits
+#define RWLOCK_READERS        0x0FFFFFFF
+#define RWLOCK_WRITER         0x10000000
+#define RWLOCK_WRITER_WAITING 0x20000000
+#define RWLOCK_PARKED         0x40000000
+
+#define LOCK_INFINITE 0xFFFFFFFF
+
+static FOUNDATION_FORCEINLINE void
+_lock_pause(void) {
+#if FOUNDATION_COMPILER_MSVC
+	YieldProcessor();
+#elif FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64
+	__builtin_ia32_pause();
+#elif (FOUNDATION_ARCH_ARM6 || FOUNDATION_ARCH_ARM7 || FOUNDATION_ARCH_ARM8 || FOUNDATION_ARCH_ARM_64) && \
+      (FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+	__asm__ __volatile__("yield");
+#else
+	atomic_signal_fence_sequentially_consistent();
+#endif
+}
+
+#if FOUNDATION_PLATFORM_WINDOWS
+
+typedef BOOL (WINAPI* _lock_wait_on_address_fn)(volatile VOID*, PVOID, SIZE_T, DWORD);
+typedef VOID (WINAPI* _lock_wake_by_address_fn)(PVOID);
+
+//Resolved at runtime, WaitOnAddress is only available from Windows 8
+static _lock_wait_on_address_fn _lock_wait_on_address;
+static _lock_wake_by_address_fn _lock_wake_by_address_single;
+static _lock_wake_by_address_fn _lock_wake_by_address_all;
+static atomic32_t _lock_resolved;
+
+static void
+_lock_resolve(void) {
+	HMODULE module = GetModuleHandleA("kernelbase.dll");
+	if (module) {
+		_lock_wait_on_address = (_lock_wait_on_address_fn)GetProcAddress(module, "WaitOnAddress");
+		_lock_wake_by_address_single = (_lock_wake_by_address_fn)GetProcAddress(module, "WakeByAddressSingle");
+		_lock_wake_by_address_all = (_lock_wake_by_address_fn)GetProcAddress(module, "WakeByAddressAll");
+	}
+	if (!_lock_wait_on_address || !_lock_wake_by_address_single || !_lock_wake_by_address_all) {
+		_lock_wait_on_address = 0;
+		_lock_wake_by_address_single = 0;
+		_lock_wake_by_address_all = 0;
+	}
+	atomic_store32(&_lock_resolved, 1);
+}
+
+static void
+_lock_park(atomic32_t* addr, int32_t compare, unsigned int milliseconds) {
+	if (!atomic_load32(&_lock_resolved))
+		_lock_resolve();
+	if (_lock_wait_on_address)
+		_lock_wait_on_address(addr, &compare, sizeof(compare), milliseconds);
+	else
+		thread_yield();
+}
+
+static void
+_lock_wake(atomic32_t* addr, bool all) {
+	if (!_lock_wake_by_address_single)
+		return;
+	if (all)
+		_lock_wake_by_address_all((void*)addr);
+	else
+		_lock_wake_by_address_single((void*)addr);
+}
+
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+static void
+_lock_park(atomic32_t* addr, int32_t compare, unsigned int milliseconds) {
+	struct timespec timeout;
+	timeout.tv_sec = (time_t)(milliseconds / 1000);
+	timeout.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+	syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, compare,
+	        (milliseconds != LOCK_INFINITE) ? &timeout : 0, 0, 0);
+}
+
+static void
+_lock_wake(atomic32_t* addr, bool all) {
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, 0, 0, 0);
+}
+
+#else
+
+static void
+_lock_park(atomic32_t* addr, int32_t compare, unsigned int milliseconds) {
+	FOUNDATION_UNUSED(addr);
+	FOUNDATION_UNUSED(compare);
+	FOUNDATION_UNUSED(milliseconds);
+	thread_yield();
+}
+
+static void
+_lock_wake(atomic32_t* addr, bool all) {
+	FOUNDATION_UNUSED(addr);
+	FOUNDATION_UNUSED(all);
+}
+
+#endif
+
+static void
+_lock_backoff(unsigned int* backoff) {
+	unsigned int ipause;
+	for (ipause = 0; ipause < *backoff; ++ipause)
+		_lock_pause();
+	if (*backoff < LOCK_BACKOFF_LIMIT)
+		*backoff <<= 1;
+}
+
+//Milliseconds left until deadline to pass to park, false if deadline has passed
+static bool
+_lock_remaining(tick_t deadline, unsigned int* milliseconds) {
+	tick_t now, remain;
+	if (*milliseconds == LOCK_INFINITE)
+		return true;
+	now = time_current();
+	if (now >= deadline)
+		return false;
+	remain = ((deadline - now) * 1000) / time_ticks_per_second();
+	*milliseconds = remain ? (unsigned int)remain : 1;
+	return true;
+}
+
+static tick_t
+_lock_deadline(unsigned int milliseconds) {
+	if (milliseconds == LOCK_INFINITE)
+		return 0;
+	return time_current() + (((tick_t)milliseconds * time_ticks_per_second()) / 1000);
+}
+
+void
+lock_initialize(lock_t* lock) {
+	atomic_store32(&lock->state, LOCK_UNLOCKED);
+}
+
+bool
+lock_try_lock(lock_t* lock) {
+	return atomic_cas32(&lock->state, LOCK_LOCKED, LOCK_UNLOCKED);
+}
+
+void
+lock_lock(lock_t* lock) {
+	unsigned int round, backoff = 1;
+	int32_t state;
+
+	if (atomic_cas32(&lock->state, LOCK_LOCKED, LOCK_UNLOCKED))
+		return;
+
+	//Spin on loads only, most critical sections are short enough to be released while spinning
+	for (round = 0; round < LOCK_SPIN_ROUNDS; ++round) {
+		_lock_backoff(&backoff);
+		state = atomic_load32(&lock->state);
+		if ((state == LOCK_UNLOCKED) && atomic_cas32(&lock->state, LOCK_LOCKED, LOCK_UNLOCKED))
+			return;
+		if (state == LOCK_CONTENDED)
+			break;
+	}
+
+	//Mark lock as contended and park. A thread acquiring after parking cannot know if
+	//other threads are still waiting, so it conservatively keeps the contended state
+	while (true) {
+		state = atomic_load32(&lock->state);
+		if (state == LOCK_UNLOCKED) {
+			if (atomic_cas32(&lock->state, LOCK_CONTENDED, LOCK_UNLOCKED))
+				return;
+			continue;
+		}
+		if ((state == LOCK_LOCKED) && !atomic_cas32(&lock->state, LOCK_CONTENDED, LOCK_LOCKED))
+			continue;
+		_lock_park(&lock->state, LOCK_CONTENDED, LOCK_INFINITE);
+	}
+}
+
+void
+lock_unlock(lock_t* lock) {
+	FOUNDATION_ASSERT_MSG(atomic_load32(&lock->state) != LOCK_UNLOCKED, "Unlocking unlocked lock");
+	if (atomic_exchange_and_add32(&lock->state, -1) != LOCK_LOCKED) {
+		atomic_store32(&lock->state, LOCK_UNLOCKED);
+		_lock_wake(&lock->state, false);
+	}
+}
+
+void
+rwlock_initialize(rwlock_t* lock) {
+	atomic_store32(&lock->state, 0);
+}
+
+//Clear parked flag and wake all parked threads if any
+static void
+_rwlock_wake(rwlock_t* lock) {
+	int32_t state;
+	do {
+		state = atomic_load32(&lock->state);
+		if (!(state & RWLOCK_PARKED))
+			return;
+	}
+	while (!atomic_cas32(&lock->state, state & ~RWLOCK_PARKED, state));
+	_lock_wake(&lock->state, true);
+}
+
+bool
+rwlock_read_try_lock(rwlock_t* lock, unsigned int milliseconds) {
+	unsigned int round = 0, backoff = 1;
+	tick_t deadline = 0;
+	int32_t state;
+
+	while (true) {
+		state = atomic_load32(&lock->state);
+		//Readers do not enter while a writer is waiting, a steady stream of readers cannot
+		//starve writers
+		if (!(state & (RWLOCK_WRITER | RWLOCK_WRITER_WAITING))) {
+			if (atomic_cas32(&lock->state, state + 1, state))
+				return true;
+			continue;
+		}
+		if (!milliseconds)
+			return false;
+		if (!round)
+			deadline = _lock_deadline(milliseconds);
+		if (round++ < LOCK_SPIN_ROUNDS) {
+			_lock_backoff(&backoff);
+			continue;
+		}
+		if (!_lock_remaining(deadline, &milliseconds))
+			return false;
+		if (!(state & RWLOCK_PARKED) && !atomic_cas32(&lock->state, state | RWLOCK_PARKED, state))
+			continue;
+		_lock_park(&lock->state, state | RWLOCK_PARKED, milliseconds);
+	}
+}
+
+void
+rwlock_read_lock(rwlock_t* lock) {
+	rwlock_read_try_lock(lock, LOCK_INFINITE);
+}
+
+void
+rwlock_read_unlock(rwlock_t* lock) {
+	int32_t state;
+	FOUNDATION_ASSERT_MSG(atomic_load32(&lock->state) & RWLOCK_READERS, "Read unlocking unlocked rwlock");
+	state = atomic_add32(&lock->state, -1);
+	if (!(state & RWLOCK_READERS) && (state & RWLOCK_PARKED))
+		_rwlock_wake(lock);
+}
+
+bool
+rwlock_write_try_lock(rwlock_t* lock, unsigned int milliseconds) {
+	unsigned int round = 0, backoff = 1;
+	tick_t deadline = 0;
+	int32_t state;
+
+	while (true) {
+		state = atomic_load32(&lock->state);
+		if (!(state & (RWLOCK_READERS | RWLOCK_WRITER))) {
+			if (atomic_cas32(&lock->state, (state | RWLOCK_WRITER) & ~RWLOCK_WRITER_WAITING, state))
+				return true;
+			continue;
+		}
+		if (!milliseconds)
+			return false;
+		if (!(state & RWLOCK_WRITER_WAITING)) {
+			if (!atomic_cas32(&lock->state, state | RWLOCK_WRITER_WAITING, state))
+				continue;
+			state |= RWLOCK_WRITER_WAITING;
+		}
+		if (!round)
+			deadline = _lock_deadline(milliseconds);
+		if (round++ < LOCK_SPIN_ROUNDS) {
+			_lock_backoff(&backoff);
+			continue;
+		}
+		if (!_lock_remaining(deadline, &milliseconds)) {
+			//Let readers in again, other waiting writers will set the flag again once woken
+			do {
+				state = atomic_load32(&lock->state);
+			}
+			while (!atomic_cas32(&lock->state, state & ~RWLOCK_WRITER_WAITING, state));
+			_rwlock_wake(lock);
+			return false;
+		}
+		if (!(state & RWLOCK_PARKED) && !atomic_cas32(&lock->state, state | RWLOCK_PARKED, state))
+			continue;
+		_lock_park(&lock->state, state | RWLOCK_PARKED, milliseconds);
+	}
+}
+
+void
+rwlock_write_lock(rwlock_t* lock) {
+	rwlock_write_try_lock(lock, LOCK_INFINITE);
+}
+
+void
+rwlock_write_unlock(rwlock_t* lock) {
+	int32_t state;
+	FOUNDATION_ASSERT_MSG(atomic_load32(&lock->state) & RWLOCK_WRITER, "Write unlocking unlocked rwlock");
+	do {
+		state = atomic_load32(&lock->state);
+	}
+	while (!atomic_cas32(&lock->state, state & ~(RWLOCK_WRITER | RWLOCK_PARKED), state));
+	if (state & RWLOCK_PARKED)
+		_lock_wake(&lock->state, true);
+}
+
+void
+rwlock_distributed_initialize(rwlock_distributed_t* lock, size_t slots) {
+	size_t num_slots = 1;
+	if (!slots)
+		slots = system_hardware_threads();
+	if (slots > 64)
+		slots = 64;
+	while (num_slots < slots)
+		num_slots <<= 1;
+
+	atomic_store32(&lock->writer, 0);
+	lock_initialize(&lock->write_lock);
+	lock->num_slots = num_slots;
+	lock->slot = memory_allocate(0, sizeof(rwlock_slot_t) * num_slots, FOUNDATION_ALIGNOF(rwlock_slot_t),
+	                             MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+}
+
+void
+rwlock_distributed_finalize(rwlock_distributed_t* lock) {
+	memory_deallocate(lock->slot);
+	lock->slot = 0;
+	lock->num_slots = 0;
+}
+
+static rwlock_slot_t*
+_rwlock_distributed_slot(rwlock_distributed_t* lock) {
+	//Slot must be stable per thread since the unlock has to decrement the same counter
+	return lock->slot + ((size_t)((thread_id() * 0x9E3779B97F4A7C15ULL) >> 32) & (lock->num_slots - 1));
+}
+
+bool
+rwlock_distributed_read_try_lock(rwlock_distributed_t* lock, unsigned int milliseconds) {
+	rwlock_slot_t* slot = _rwlock_distributed_slot(lock);
+	tick_t deadline = 0;
+	bool waited = false;
+	int32_t writer;
+
+	while (true) {
+		//Publish reader before checking writer, the writer does the reverse
+		atomic_incr32(&slot->readers);
+		if (!atomic_load32(&lock->writer))
+			return true;
+		atomic_decr32(&slot->readers);
+
+		if (!milliseconds)
+			return false;
+		if (!waited) {
+			deadline = _lock_deadline(milliseconds);
+			waited = true;
+		}
+		if (!_lock_remaining(deadline, &milliseconds))
+			return false;
+		writer = atomic_load32(&lock->writer);
+		if (!writer)
+			continue;
+		if ((writer == 1) && !atomic_cas32(&lock->writer, 2, 1))
+			continue;
+		_lock_park(&lock->writer, 2, milliseconds);
+	}
+}
+
+void
+rwlock_distributed_read_lock(rwlock_distributed_t* lock) {
+	rwlock_distributed_read_try_lock(lock, LOCK_INFINITE);
+}
+
+void
+rwlock_distributed_read_unlock(rwlock_distributed_t* lock) {
+	rwlock_slot_t* slot = _rwlock_distributed_slot(lock);
+	FOUNDATION_ASSERT_MSG(atomic_load32(&slot->readers) > 0, "Read unlocking unlocked rwlock");
+	atomic_decr32(&slot->readers);
+}
+
+static void
+_rwlock_distributed_release(rwlock_distributed_t* lock) {
+	int32_t writer;
+	do {
+		writer = atomic_load32(&lock->writer);
+	}
+	while (!atomic_cas32(&lock->writer, 0, writer));
+	if (writer == 2)
+		_lock_wake(&lock->writer, true);
+	lock_unlock(&lock->write_lock);
+}
+
+bool
+rwlock_distributed_write_try_lock(rwlock_distributed_t* lock, unsigned int milliseconds) {
+	tick_t deadline = _lock_deadline(milliseconds);
+	unsigned int backoff = 1;
+	size_t islot;
+
+	if (milliseconds == LOCK_INFINITE) {
+		lock_lock(&lock->write_lock);
+	}
+	else {
+		while (!lock_try_lock(&lock->write_lock)) {
+			if (!milliseconds || !_lock_remaining(deadline, &milliseconds))
+				return false;
+			thread_yield();
+		}
+	}
+
+	atomic_store32(&lock->writer, 1);
+	atomic_thread_fence_sequentially_consistent();
+
+	//Drain readers, new readers back off as soon as they see the writer flag
+	for (islot = 0; islot < lock->num_slots; ++islot) {
+		while (atomic_load32(&lock->slot[islot].readers)) {
+			if (!milliseconds || !_lock_remaining(deadline, &milliseconds)) {
+				_rwlock_distributed_release(lock);
+				return false;
+			}
+			if (backoff < LOCK_BACKOFF_LIMIT)
+				_lock_backoff(&backoff);
+			else
+				thread_yield();
+		}
+	}
+	return true;
+}
+
+void
+rwlock_distributed_write_lock(rwlock_distributed_t* lock) {
+	rwlock_distributed_write_try_lock(lock, LOCK_INFINITE);
+}
+
+void
+rwlock_distributed_write_unlock(rwlock_distributed_t* lock) {
+	FOUNDATION_ASSERT_MSG(atomic_load32(&lock->writer), "Write unlocking unlocked rwlock");
+	_rwlock_distributed_release(lock);
+}
@@ -0,0 +1,147 @@
+/* lock.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file lock.h
+\brief Lightweight locks
+
+Lightweight lock for short critical sections. A lock is 4 bytes in size and requires no
+system resources, so it can be embedded directly in data structures. Zero initialized
+memory is a valid unlocked lock.
+
+A thread trying to acquire a contended lock first spins with exponential backoff, then
+parks in the kernel until the lock is released. Parking uses futex on Linux and Android
+and WaitOnAddress on Windows, other platforms fall back to yielding the thread.
+
+Unlike #mutex_t a lock is not reentrant, has no name and does not provide signalling. A
+thread must not lock a lock it is already holding.
+
+A reader-writer lock allows any number of concurrent readers or a single writer. Once a
+writer is waiting new readers are held back, so writers are not starved by a steady stream
+of readers. Like the lock it is 4 bytes, needs no system resources and is not reentrant.
+
+For read-mostly data where readers on many threads would contend on the shared lock state,
+a distributed reader-writer lock keeps one reader counter per cache line and slot, selected
+by the calling thread. Readers only touch their own slot in the uncontended case, making
+read locking scale with the number of threads at the cost of more expensive write locking
+which has to wait for all slots to drain. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Initialize lock to unlocked state. Equivalent to zero initialization.
+\param lock Lock */
+FOUNDATION_API void
+lock_initialize(lock_t* lock);
+
+/*! Try to acquire lock but do not block for any amount of time.
+\param lock Lock
+\return true if lock was acquired, false if lock already held */
+FOUNDATION_API bool
+lock_try_lock(lock_t* lock);
+
+/*! Acquire lock, spinning and then blocking if unavailable for an indefinite amount of time.
+\param lock Lock */
+FOUNDATION_API void
+lock_lock(lock_t* lock);
+
+/*! Release lock, waking up one waiting thread if any.
+\param lock Lock */
+FOUNDATION_API void
+lock_unlock(lock_t* lock);
+
+/*! Initialize reader-writer lock to unlocked state. Equivalent to zero initialization.
+\param lock Reader-writer lock */
+FOUNDATION_API void
+rwlock_initialize(rwlock_t* lock);
+
+/*! Try to acquire shared read access to the lock, waiting at most the given time.
+\param lock Reader-writer lock
+\param milliseconds Timeout in milliseconds, 0 means no wait
+\return true if read access was acquired, false if timeout */
+FOUNDATION_API bool
+rwlock_read_try_lock(rwlock_t* lock, unsigned int milliseconds);
+
+/*! Acquire shared read access to the lock, blocking for an indefinite amount of time.
+\param lock Reader-writer lock */
+FOUNDATION_API void
+rwlock_read_lock(rwlock_t* lock);
+
+/*! Release shared read access to the lock.
+\param lock Reader-writer lock */
+FOUNDATION_API void
+rwlock_read_unlock(rwlock_t* lock);
+
+/*! Try to acquire exclusive write access to the lock, waiting at most the given time.
+\param lock Reader-writer lock
+\param milliseconds Timeout in milliseconds, 0 means no wait
+\return true if write access was acquired, false if timeout */
+FOUNDATION_API bool
+rwlock_write_try_lock(rwlock_t* lock, unsigned int milliseconds);
+
+/*! Acquire exclusive write access to the lock, blocking for an indefinite amount of time.
+\param lock Reader-writer lock */
+FOUNDATION_API void
+rwlock_write_lock(rwlock_t* lock);
+
+/*! Release exclusive write access to the lock.
+\param lock Reader-writer lock */
+FOUNDATION_API void
+rwlock_write_unlock(rwlock_t* lock);
+
+/*! Initialize distributed reader-writer lock and allocate reader slots.
+\param lock Distributed reader-writer lock
+\param slots Number of reader slots, rounded up to a power of two and capped to 64. Zero
+             for default, the number of hardware threads */
+FOUNDATION_API void
+rwlock_distributed_initialize(rwlock_distributed_t* lock, size_t slots);
+
+/*! Finalize distributed reader-writer lock and free reader slots. Lock must not be held.
+\param lock Distributed reader-writer lock */
+FOUNDATION_API void
+rwlock_distributed_finalize(rwlock_distributed_t* lock);
+
+/*! Try to acquire shared read access to the lock, waiting at most the given time.
+\param lock Distributed reader-writer lock
+\param milliseconds Timeout in milliseconds, 0 means no wait
+\return true if read access was acquired, false if timeout */
+FOUNDATION_API bool
+rwlock_distributed_read_try_lock(rwlock_distributed_t* lock, unsigned int milliseconds);
+
+/*! Acquire shared read access to the lock, blocking for an indefinite amount of time.
+\param lock Distributed reader-writer lock */
+FOUNDATION_API void
+rwlock_distributed_read_lock(rwlock_distributed_t* lock);
+
+/*! Release shared read access to the lock. Must be called from the thread that acquired
+read access.
+\param lock Distributed reader-writer lock */
+FOUNDATION_API void
+rwlock_distributed_read_unlock(rwlock_distributed_t* lock);
+
+/*! Try to acquire exclusive write access to the lock, waiting at most the given time.
+\param lock Distributed reader-writer lock
+\param milliseconds Timeout in milliseconds, 0 means no wait
+\return true if write access was acquired, false if timeout */
+FOUNDATION_API bool
+rwlock_distributed_write_try_lock(rwlock_distributed_t* lock, unsigned int milliseconds);
+
+/*! Acquire exclusive write access to the lock, blocking for an indefinite amount of time.
+\param lock Distributed reader-writer lock */
+FOUNDATION_API void
+rwlock_distributed_write_lock(rwlock_distributed_t* lock);
+
+/*! Release exclusive write access to the lock.
+\param lock Distributed reader-writer lock */
+FOUNDATION_API void
+rwlock_distributed_write_unlock(rwlock_distributed_t* lock);
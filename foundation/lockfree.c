@@ -0,0 +1,179 @@
+/* lockfree.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#if !FOUNDATION_ATOMIC_TAGPTR
+
+//Without double width CAS the stack is serialized by a lock selected by stack address
+#define LOCKFREE_STACK_LOCKS 16
+
+static lock_t _lockfree_stack_lock[LOCKFREE_STACK_LOCKS];
+
+static lock_t*
+_lockfree_stack_lock_get(lockfree_stack_t* stack) {
+	return _lockfree_stack_lock + (((uintptr_t)stack >> 4) % LOCKFREE_STACK_LOCKS);
+}
+
+#endif
+
+void
+lockfree_stack_initialize(lockfree_stack_t* stack) {
+	memset(stack, 0, sizeof(lockfree_stack_t));
+}
+
+void
+lockfree_stack_push(lockfree_stack_t* stack, lockfree_node_t* node) {
+	lockfree_stack_push_list(stack, node, node);
+}
+
+#if FOUNDATION_ATOMIC_TAGPTR
+
+void
+lockfree_stack_push_list(lockfree_stack_t* stack, lockfree_node_t* first,
+                         lockfree_node_t* last) {
+	lockfree_node_t* head;
+	uintptr_t tag;
+	do {
+		head = atomic_load_tagptr(&stack->head, &tag);
+		atomic_storeptr_explicit(&last->next, head, MEMORY_ORDER_RELAXED);
+	}
+	while (!atomic_cas_tagptr(&stack->head, first, head, tag));
+}
+
+lockfree_node_t*
+lockfree_stack_pop(lockfree_stack_t* stack) {
+	lockfree_node_t* head;
+	lockfree_node_t* next;
+	uintptr_t tag;
+	do {
+		head = atomic_load_tagptr(&stack->head, &tag);
+		if (!head)
+			return 0;
+		//Node might be popped and reused by another thread, in which case the tag
+		//has changed and the CAS fails
+		next = atomic_loadptr_explicit(&head->next, MEMORY_ORDER_RELAXED);
+	}
+	while (!atomic_cas_tagptr(&stack->head, next, head, tag));
+	return head;
+}
+
+lockfree_node_t*
+lockfree_stack_pop_all(lockfree_stack_t* stack) {
+	lockfree_node_t* head;
+	uintptr_t tag;
+	do {
+		head = atomic_load_tagptr(&stack->head, &tag);
+		if (!head)
+			return 0;
+	}
+	while (!atomic_cas_tagptr(&stack->head, 0, head, tag));
+	return head;
+}
+
+#else
+
+void
+lockfree_stack_push_list(lockfree_stack_t* stack, lockfree_node_t* first,
+                         lockfree_node_t* last) {
+	lock_t* lock = _lockfree_stack_lock_get(stack);
+	lock_lock(lock);
+	atomic_storeptr(&last->next, stack->head.nonatomic);
+	stack->head.nonatomic = first;
+	++stack->head.tag;
+	lock_unlock(lock);
+}
+
+lockfree_node_t*
+lockfree_stack_pop(lockfree_stack_t* stack) {
+	lockfree_node_t* head;
+	lock_t* lock = _lockfree_stack_lock_get(stack);
+	lock_lock(lock);
+	head = stack->head.nonatomic;
+	if (head) {
+		stack->head.nonatomic = atomic_loadptr(&head->next);
+		++stack->head.tag;
+	}
+	lock_unlock(lock);
+	return head;
+}
+
+lockfree_node_t*
+lockfree_stack_pop_all(lockfree_stack_t* stack) {
+	lockfree_node_t* head;
+	lock_t* lock = _lockfree_stack_lock_get(stack);
+	lock_lock(lock);
+	head = stack->head.nonatomic;
+	stack->head.nonatomic = 0;
+	++stack->head.tag;
+	lock_unlock(lock);
+	return head;
+}
+
+#endif
+
+bool
+lockfree_stack_is_empty(lockfree_stack_t* stack) {
+	//Pointer is first member of tagged pointer, a plain load is enough for a snapshot
+	return atomic_loadptr_explicit((atomicptr_t*)&stack->head, MEMORY_ORDER_RELAXED) == 0;
+}
+
+void
+lockfree_queue_initialize(lockfree_queue_t* queue) {
+	memset(queue, 0, sizeof(lockfree_queue_t));
+	atomic_storeptr(&queue->head, &queue->stub);
+	queue->tail = &queue->stub;
+}
+
+void
+lockfree_queue_push(lockfree_queue_t* queue, lockfree_node_t* node) {
+	lockfree_node_t* prev;
+	atomic_storeptr_explicit(&node->next, 0, MEMORY_ORDER_RELAXED);
+	prev = atomic_exchange_ptr(&queue->head, node);
+	//Queue is briefly disconnected between the exchange and linking the previous node,
+	//the consumer treats this as an empty queue
+	atomic_storeptr_explicit(&prev->next, node, MEMORY_ORDER_RELEASE);
+}
+
+lockfree_node_t*
+lockfree_queue_pop(lockfree_queue_t* queue) {
+	lockfree_node_t* tail = queue->tail;
+	lockfree_node_t* next = atomic_loadptr_explicit(&tail->next, MEMORY_ORDER_ACQUIRE);
+	lockfree_node_t* head;
+
+	if (tail == &queue->stub) {
+		if (!next)
+			return 0;
+		queue->tail = next;
+		tail = next;
+		next = atomic_loadptr_explicit(&next->next, MEMORY_ORDER_ACQUIRE);
+	}
+
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+
+	head = atomic_loadptr_explicit(&queue->head, MEMORY_ORDER_ACQUIRE);
+	if (tail != head)
+		return 0;
+
+	//Last node in queue, push stub back so the node can be unlinked
+	lockfree_queue_push(queue, &queue->stub);
+
+	next = atomic_loadptr_explicit(&tail->next, MEMORY_ORDER_ACQUIRE);
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+	return 0;
+}
@@ -0,0 +1,91 @@
+/* lockfree.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file lockfree.h
+\brief Lock-free intrusive containers
+
+Lock-free intrusive containers linking items through a #lockfree_node_t embedded in the
+item. The containers never allocate memory, the caller owns the items and nodes.
+
+The stack is a LIFO safe for any number of threads pushing and popping concurrently. The
+head pointer is tagged with a counter incremented on each modification, which avoids the
+ABA problem without limiting the number of items. A popping thread can read the next link
+of a node that was concurrently popped and reused, so node memory must remain readable
+while the stack is in use, for example by keeping items in a pool rather than freeing them.
+On platforms without a double width compare and swap the stack is serialized by a lock.
+
+The queue is a FIFO safe for any number of threads pushing concurrently, but only one
+thread at a time can pop. Pushing is wait-free. A pop can report an empty queue while a
+push is in progress on another thread, the item will be returned by a later pop. The queue
+contains an internal stub node and must not be moved in memory after initialization. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Initialize stack to empty state. Equivalent to zero initialization.
+\param stack Stack */
+FOUNDATION_API void
+lockfree_stack_initialize(lockfree_stack_t* stack);
+
+/*! Push node on top of stack
+\param stack Stack
+\param node Node to push */
+FOUNDATION_API void
+lockfree_stack_push(lockfree_stack_t* stack, lockfree_node_t* node);
+
+/*! Push a list of nodes on top of stack in a single operation. The nodes must already be
+linked from first to last through the node next pointers.
+\param stack Stack
+\param first First node in list, will be top of stack
+\param last Last node in list */
+FOUNDATION_API void
+lockfree_stack_push_list(lockfree_stack_t* stack, lockfree_node_t* first,
+                         lockfree_node_t* last);
+
+/*! Pop node from top of stack
+\param stack Stack
+\return Popped node, null if stack was empty */
+FOUNDATION_API lockfree_node_t*
+lockfree_stack_pop(lockfree_stack_t* stack);
+
+/*! Pop all nodes from stack in a single operation. The returned nodes are linked from top
+to bottom of stack through the node next pointers.
+\param stack Stack
+\return Previous top of stack, null if stack was empty */
+FOUNDATION_API lockfree_node_t*
+lockfree_stack_pop_all(lockfree_stack_t* stack);
+
+/*! Query if stack is empty. The result can be outdated as soon as the function returns
+if other threads modify the stack concurrently.
+\param stack Stack
+\return true if stack is empty, false if not */
+FOUNDATION_API bool
+lockfree_stack_is_empty(lockfree_stack_t* stack);
+
+/*! Initialize queue to empty state
+\param queue Queue */
+FOUNDATION_API void
+lockfree_queue_initialize(lockfree_queue_t* queue);
+
+/*! Push node at end of queue. Safe to call from any number of threads concurrently.
+\param queue Queue
+\param node Node to push */
+FOUNDATION_API void
+lockfree_queue_push(lockfree_queue_t* queue, lockfree_node_t* node);
+
+/*! Pop node from front of queue. Must only be called from one thread at a time.
+\param queue Queue
+\return Popped node, null if queue was empty or a push was in progress */
+FOUNDATION_API lockfree_node_t*
+lockfree_queue_pop(lockfree_queue_t* queue);
@@ -39,6 +39,21 @@ __declspec(dllimport) void STDCALL OutputDebugStringA(LPCSTR);
 #  include <foundation/pnacl.h>
 #endif
 
+#if BUILD_ENABLE_LOG
+
+//The header macros filter calls before evaluating arguments, this module implements the calls
+#undef log_debug
+#undef log_debugf
+#undef log_info
+#undef log_infof
+#undef log_warn
+#undef log_warnf
+
+atomic64_t _log_level_cache[LOG_LEVEL_CACHE_SIZE];
+atomic32_t _log_level_generation;
+
+#endif
+
 #if BUILD_ENABLE_LOG || BUILD_ENABLE_DEBUG_LOG
 
 static bool             _log_stdout           = true;
@@ -90,22 +105,18 @@ struct log_timestamp_t {
 typedef struct log_timestamp_t log_timestamp_t;
 
 static log_timestamp_t
-_log_make_timestamp(void) {
-	tick_t elapsed;
-	tick_t ticks_per_sec;
+_log_timestamp(tick_t elapsed, tick_t ticks_per_sec) {
 	tick_t milliseconds;
 	tick_t seconds;
 	tick_t minutes;
 
 	log_timestamp_t timestamp;
 
-	ticks_per_sec = time_ticks_per_second();
 	if (!ticks_per_sec) {
 		memset(&timestamp, 0, sizeof(timestamp));
 		return timestamp;
 	}
 
-	elapsed = time_current() - time_startup();
 	milliseconds = ((elapsed % ticks_per_sec) * 1000LL) / ticks_per_sec;
 	seconds = elapsed / ticks_per_sec;
 	minutes = seconds / 60LL;
@@ -118,10 +129,1286 @@ _log_make_timestamp(void) {
 	return timestamp;
 }
 
+//Coarse clock resolution is sufficient for millisecond timestamps, but it may lag the
+//startup timestamp read from the precise clock
+static tick_t
+_log_elapsed(void) {
+	tick_t elapsed = time_current_coarse() - time_startup();
+	return (elapsed > 0) ? elapsed : 0;
+}
+
+static log_timestamp_t
+_log_make_timestamp(void) {
+	return _log_timestamp(_log_elapsed(), time_ticks_per_second());
+}
+
 #endif
 
 #if BUILD_ENABLE_LOG
 
+typedef struct log_record_t log_record_t;
+
+//Preformatted message or binary record queued for output by the log thread
+struct log_record_t {
+	lockfree_node_t node;
+	hash_t context;
+	error_level_t severity;
+	void* std;
+	unsigned int flags;
+	size_t length;
+	char message[];
+};
+
+#define LOG_RECORD_OUTPUT   1
+#define LOG_RECORD_BINARY   2
+#define LOG_RECORD_REQUIRED 4
+
+#define LOG_ASYNC_CAPACITY 4096
+
+static bool             _log_async;
+static bool             _log_async_block;
+static int32_t          _log_async_capacity;
+static atomic32_t       _log_async_pending;
+static atomic64_t       _log_async_dropped;
+static atomic32_t       _log_async_running;
+static lockfree_queue_t _log_async_queue;
+static semaphore_t      _log_async_signal;
+static thread_t         _log_async_thread;
+static stream_t*        _log_binary_stream;
+static lock_t           _log_binary_lock;
+
+typedef struct log_limit_t log_limit_t;
+
+//Rate limit of a context, as a token bucket in the form of a theoretical arrival time
+struct log_limit_t {
+	tick_t interval;
+	tick_t tolerance;
+	atomic64_t tat;
+	atomic32_t suppressed;
+};
+
+#define LOG_RATE_LIMITS 64
+
+static bool             _log_limit_active;
+static hashtable64_t*   _log_limit;
+static log_limit_t      _log_limits[LOG_RATE_LIMITS];
+static atomic32_t       _log_limit_count;
+static log_limit_t      _log_limit_default;
+
+#define LOG_FILE_BUFFER_SIZE    (64 * 1024)
+#define LOG_FILE_FLUSH_INTERVAL 1000
+#define LOG_FILE_ROTATE_COUNT   5
+
+static stream_t*         _log_file;
+static lock_t            _log_file_lock;
+static log_file_config_t _log_file_config;
+static string_t          _log_file_path;
+static char*             _log_file_buffer;
+static size_t            _log_file_used;
+static size_t            _log_file_size;
+static tick_t            _log_file_opened;
+static tick_t            _log_file_written;
+static tick_t            _log_file_interval;
+
+//File operations done while holding the file lock can log, such messages are not written
+//to the log file
+FOUNDATION_DECLARE_THREAD_LOCAL(int, log_file_locked, 0)
+
+static void
+_log_file_lock_acquire(void) {
+	lock_lock(&_log_file_lock);
+	set_thread_log_file_locked(1);
+}
+
+static void
+_log_file_lock_release(void) {
+	set_thread_log_file_locked(0);
+	lock_unlock(&_log_file_lock);
+}
+
+static void
+_log_file_flush(bool commit) {
+	if (_log_file_used) {
+		stream_write(_log_file, _log_file_buffer, _log_file_used);
+		_log_file_size += _log_file_used;
+		_log_file_used = 0;
+	}
+	//Streams opened with sync flag also commit data to storage on flush
+	if (commit || (_log_file_config.sync == LOGFILE_SYNC_ALWAYS))
+		stream_flush(_log_file);
+	_log_file_written = time_current();
+}
+
+static stream_t*
+_log_file_open(bool truncate) {
+	unsigned int mode = STREAM_OUT | STREAM_BINARY | STREAM_CREATE;
+	mode |= truncate ? STREAM_TRUNCATE : STREAM_ATEND;
+	if (_log_file_config.sync == LOGFILE_SYNC_ALWAYS)
+		mode |= STREAM_SYNC;
+	return fs_open_file(STRING_ARGS(_log_file_path), mode);
+}
+
+static string_t
+_log_file_rotated_path(char* buffer, size_t capacity, unsigned int index) {
+	return string_format(buffer, capacity, STRING_CONST("%.*s.%u"), STRING_FORMAT(_log_file_path),
+	                     index);
+}
+
+static string_t
+_log_file_rotate(char* buffer, size_t capacity) {
+	char from_buffer[BUILD_MAX_PATHLEN];
+	string_t from, to;
+	unsigned int index;
+
+	_log_file_flush(true);
+	stream_deallocate(_log_file);
+
+	//Shift older files up one index, dropping the oldest
+	to = _log_file_rotated_path(buffer, capacity, _log_file_config.rotate_count);
+	fs_remove_file(STRING_ARGS(to));
+	for (index = _log_file_config.rotate_count - 1; index > 0; --index) {
+		from = _log_file_rotated_path(from_buffer, sizeof(from_buffer), index);
+		to = _log_file_rotated_path(buffer, capacity, index + 1);
+		if (fs_is_file(STRING_ARGS(from)))
+			fs_move_file(STRING_ARGS(from), STRING_ARGS(to));
+	}
+	to = _log_file_rotated_path(buffer, capacity, 1);
+	if (!fs_move_file(STRING_ARGS(_log_file_path), STRING_ARGS(to)))
+		to.length = 0;
+
+	_log_file = _log_file_open(true);
+	_log_file_size = 0;
+	_log_file_opened = time_current();
+	return to;
+}
+
+static void
+_log_file_write(error_level_t severity, const char* buffer, size_t length) {
+	char rotated_buffer[BUILD_MAX_PATHLEN];
+	string_t rotated = { 0, 0 };
+	log_rotate_fn rotate = 0;
+	size_t capacity;
+
+	if (get_thread_log_file_locked())
+		return;
+
+	_log_file_lock_acquire();
+	if (!_log_file)
+		goto exit;
+
+	capacity = _log_file_config.buffer_size;
+	if ((_log_file_config.rotate_size && (_log_file_size + _log_file_used) &&
+	        (_log_file_size + _log_file_used + length > _log_file_config.rotate_size)) ||
+	        (_log_file_config.rotate_age &&
+	         (time_elapsed(_log_file_opened) >= (deltatime_t)_log_file_config.rotate_age))) {
+		rotated = _log_file_rotate(rotated_buffer, sizeof(rotated_buffer));
+		rotate = _log_file_config.rotate;
+		if (!_log_file)
+			goto exit;
+	}
+
+	if (_log_file_used + length > capacity)
+		_log_file_flush(false);
+	if (length > capacity) {
+		stream_write(_log_file, buffer, length);
+		_log_file_size += length;
+	}
+	else {
+		memcpy(_log_file_buffer + _log_file_used, buffer, length);
+		_log_file_used += length;
+	}
+
+	//Without a log thread buffered data is written by the next message after the interval
+	if ((severity >= ERRORLEVEL_ERROR) && (_log_file_config.sync != LOGFILE_SYNC_NONE))
+		_log_file_flush(false);
+	else if (!_log_async && (time_current() - _log_file_written >= _log_file_interval))
+		_log_file_flush(false);
+
+exit:
+	_log_file_lock_release();
+
+	//Callback outside lock, allowing it to log
+	if (rotate && rotated.length)
+		rotate(STRING_ARGS(rotated));
+}
+
+static void
+_log_file_flush_idle(void) {
+	if (!_log_file_used)
+		return;
+	_log_file_lock_acquire();
+	if (_log_file && _log_file_used && (time_current() - _log_file_written >= _log_file_interval))
+		_log_file_flush(false);
+	_log_file_lock_release();
+}
+
+//Ring buffer of the most recent log output, kept for crash dumps
+#define LOG_HISTORY_SIZE (16U * 1024U)
+
+static char       _log_history[LOG_HISTORY_SIZE];
+static atomic64_t _log_history_end;
+
+static void
+_log_history_append(const char* buffer, size_t length) {
+	size_t offset, chunk;
+	if (length > LOG_HISTORY_SIZE) {
+		buffer += length - LOG_HISTORY_SIZE;
+		length = LOG_HISTORY_SIZE;
+	}
+	//Concurrent writers reserve disjoint ranges, a reader racing with writers may see torn lines
+	offset = (size_t)(atomic_add64(&_log_history_end, (int64_t)length) - (int64_t)length) %
+	         LOG_HISTORY_SIZE;
+	chunk = LOG_HISTORY_SIZE - offset;
+	if (chunk > length)
+		chunk = length;
+	memcpy(_log_history + offset, buffer, chunk);
+	if (chunk < length)
+		memcpy(_log_history, buffer + chunk, length - chunk);
+}
+
+static void
+_log_output(hash_t context, error_level_t severity, char* buffer, size_t length, void* std,
+            bool output) {
+	_log_history_append(buffer, length);
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (output)
+		OutputDebugStringA(buffer);
+#endif
+
+#if FOUNDATION_PLATFORM_ANDROID
+	FOUNDATION_UNUSED(std);
+	if (output)
+		__android_log_write(ANDROID_LOG_DEBUG + severity - 1, environment_application()->short_name.str,
+		                    buffer);
+#elif FOUNDATION_PLATFORM_TIZEN
+	FOUNDATION_UNUSED(std);
+	if (output)
+		dlog_print(DLOG_DEBUG + severity - 1, environment_application()->short_name.str, "%s", buffer);
+#elif FOUNDATION_PLATFORM_PNACL
+	FOUNDATION_UNUSED(std);
+	if (output)
+		pnacl_post_log(context, severity, buffer, (unsigned int)length);
+#else
+	if (output && std)
+		fprintf(std, "%s", buffer);
+#endif
+
+	if (_log_file)
+		_log_file_write(severity, buffer, length);
+
+	if (_log_callback)
+		_log_callback(context, severity, buffer, length - 1);
+}
+
+static void
+_log_async_push(hash_t context, error_level_t severity, const char* buffer, size_t length,
+                void* std, unsigned int flags) {
+	log_record_t* record;
+	int32_t pending;
+
+	//Bound number of pending messages by either dropping or waiting for the log thread
+	while ((pending = atomic_add32(&_log_async_pending, 1)) > _log_async_capacity) {
+		atomic_add32(&_log_async_pending, -1);
+		if (!_log_async_block && !(flags & LOG_RECORD_REQUIRED)) {
+			atomic_incr64(&_log_async_dropped);
+			return;
+		}
+		thread_yield();
+	}
+
+	record = memory_allocate(0, sizeof(log_record_t) + length + 1, 0, MEMORY_PERSISTENT);
+	record->context = context;
+	record->severity = severity;
+	record->std = std;
+	record->flags = flags;
+	record->length = length;
+	memcpy(record->message, buffer, length);
+	record->message[length] = 0;
+
+	lockfree_queue_push(&_log_async_queue, &record->node);
+	//Log thread drains queue until no messages are pending, only wake it when idle
+	if (pending == 1)
+		semaphore_post(&_log_async_signal);
+}
+
+static void
+_log_async_drain(void) {
+	int64_t dropped;
+
+	while (atomic_load32(&_log_async_pending) > 0) {
+		lockfree_node_t* node = lockfree_queue_pop(&_log_async_queue);
+		if (node) {
+			log_record_t* record = (log_record_t*)node;
+			if (record->flags & LOG_RECORD_BINARY) {
+				if (_log_binary_stream)
+					stream_write(_log_binary_stream, record->message, record->length);
+			}
+			else {
+				_log_output(record->context, record->severity, record->message, record->length,
+				            record->std, (record->flags & LOG_RECORD_OUTPUT) != 0);
+			}
+			memory_deallocate(record);
+			atomic_add32(&_log_async_pending, -1);
+		}
+		else {
+			//Push in progress on another thread
+			thread_yield();
+		}
+	}
+
+	dropped = atomic_load64(&_log_async_dropped);
+	if (dropped && atomic_cas64(&_log_async_dropped, 0, dropped)) {
+		char buffer[128];
+		string_t message = string_format(buffer, sizeof(buffer),
+		                                 STRING_CONST("WARNING [%s]: %" PRId64 " log messages dropped\n"),
+		                                 _log_warning_name[WARNING_PERFORMANCE], dropped);
+		_log_output(0, ERRORLEVEL_WARNING, message.str, message.length, stdout, _log_stdout);
+	}
+}
+
+static void*
+_log_async_run(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	while (atomic_load32(&_log_async_running)) {
+		//Wake up periodically to write buffered log file data
+		if (_log_file)
+			semaphore_try_wait(&_log_async_signal, _log_file_config.flush_interval);
+		else
+			semaphore_wait(&_log_async_signal);
+		_log_async_drain();
+		_log_file_flush_idle();
+	}
+	_log_async_drain();
+	return 0;
+}
+
+#define LOG_BINARY_VERSION 1
+#define LOG_BINARY_FORMATS 1024
+#define LOG_BINARY_ARGS    32
+
+#define LOG_BINARY_RECORD_FORMAT  1
+#define LOG_BINARY_RECORD_MESSAGE 2
+
+#define LOG_BINARY_ARG_INT32          1
+#define LOG_BINARY_ARG_INT64          2
+#define LOG_BINARY_ARG_DOUBLE         3
+#define LOG_BINARY_ARG_POINTER        4
+#define LOG_BINARY_ARG_STRING         5
+//String bounded by the preceding precision argument
+#define LOG_BINARY_ARG_STRING_BOUNDED 6
+
+typedef struct log_format_t log_format_t;
+typedef struct log_spec_t log_spec_t;
+typedef struct log_buffer_t log_buffer_t;
+typedef union log_arg_t log_arg_t;
+
+//Format string seen by binary logging, keyed by format string pointer
+struct log_format_t {
+	atomicptr_t format;
+	atomic32_t ready;
+	uint32_t id;
+	int argc;
+	uint8_t type[LOG_BINARY_ARGS];
+	//Only used when expanding binary log
+	char* string;
+	size_t length;
+};
+
+//Conversion specification in format string
+struct log_spec_t {
+	size_t offset;
+	size_t length;
+	bool width_star;
+	bool precision_star;
+	char modifier;
+	size_t size;
+	char conversion;
+};
+
+struct log_buffer_t {
+	uint8_t* data;
+	size_t size;
+	size_t capacity;
+	//Initial storage, not deallocated
+	uint8_t* storage;
+	uint8_t local[256];
+};
+
+union log_arg_t {
+	int32_t i32;
+	int64_t i64;
+	double f64;
+	uint64_t ptr;
+	char* str;
+};
+
+static log_format_t _log_binary_format[LOG_BINARY_FORMATS];
+static atomic32_t   _log_binary_format_count;
+
+//Format strings seen by the flight recorder, identified by table slot
+static log_format_t _log_recorder_format[LOG_BINARY_FORMATS];
+
+static void
+_log_buffer_initialize_storage(log_buffer_t* buffer, void* storage, size_t capacity) {
+	buffer->data = storage;
+	buffer->size = 0;
+	buffer->capacity = capacity;
+	buffer->storage = storage;
+}
+
+static void
+_log_buffer_initialize(log_buffer_t* buffer) {
+	_log_buffer_initialize_storage(buffer, buffer->local, sizeof(buffer->local));
+}
+
+static void
+_log_buffer_finalize(log_buffer_t* buffer) {
+	if (buffer->data != buffer->storage)
+		memory_deallocate(buffer->data);
+}
+
+static uint8_t*
+_log_buffer_reserve(log_buffer_t* buffer, size_t size) {
+	if (buffer->size + size > buffer->capacity) {
+		size_t capacity = (buffer->capacity * 2) + size;
+		uint8_t* data = memory_allocate(0, capacity, 0, MEMORY_TEMPORARY);
+		memcpy(data, buffer->data, buffer->size);
+		_log_buffer_finalize(buffer);
+		buffer->data = data;
+		buffer->capacity = capacity;
+	}
+	return buffer->data + buffer->size;
+}
+
+static void
+_log_buffer_append(log_buffer_t* buffer, const void* data, size_t size) {
+	memcpy(_log_buffer_reserve(buffer, size), data, size);
+	buffer->size += size;
+}
+
+static void
+_log_buffer_append_uint(log_buffer_t* buffer, uint64_t value) {
+	uint8_t* out = _log_buffer_reserve(buffer, 10);
+	size_t size = 0;
+	while (value >= 0x80) {
+		out[size++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[size++] = (uint8_t)value;
+	buffer->size += size;
+}
+
+static bool
+_log_binary_scan(const char* format, size_t length, size_t* offset, log_spec_t* spec) {
+	size_t pos = *offset;
+	while ((pos < length) && (format[pos] != '%'))
+		++pos;
+	if (pos >= length)
+		return false;
+
+	memset(spec, 0, sizeof(log_spec_t));
+	spec->offset = pos++;
+	spec->size = sizeof(int);
+
+	while ((pos < length) && ((format[pos] == '-') || (format[pos] == '+') || (format[pos] == ' ') ||
+	                          (format[pos] == '#') || (format[pos] == '0') || (format[pos] == '\'')))
+		++pos;
+
+	if ((pos < length) && (format[pos] == '*')) {
+		spec->width_star = true;
+		++pos;
+	}
+	while ((pos < length) && (format[pos] >= '0') && (format[pos] <= '9'))
+		++pos;
+
+	if ((pos < length) && (format[pos] == '.')) {
+		++pos;
+		if ((pos < length) && (format[pos] == '*')) {
+			spec->precision_star = true;
+			++pos;
+		}
+		while ((pos < length) && (format[pos] >= '0') && (format[pos] <= '9'))
+			++pos;
+	}
+
+	if (pos < length) {
+		spec->modifier = format[pos];
+		switch (spec->modifier) {
+		case 'h':
+			if ((++pos < length) && (format[pos] == 'h'))
+				++pos;
+			break;
+		case 'l':
+			spec->size = sizeof(long);
+			if ((++pos < length) && (format[pos] == 'l')) {
+				spec->modifier = 'q';
+				spec->size = sizeof(long long);
+				++pos;
+			}
+			break;
+		case 'z':
+		case 'I':
+			spec->size = sizeof(size_t);
+			//Microsoft specific I32 and I64 modifiers
+			if ((++pos + 1 < length) && (spec->modifier == 'I')) {
+				if ((format[pos] == '3') && (format[pos + 1] == '2')) {
+					spec->size = 4;
+					pos += 2;
+				}
+				else if ((format[pos] == '6') && (format[pos + 1] == '4')) {
+					spec->size = 8;
+					pos += 2;
+				}
+			}
+			break;
+		case 'j':
+			spec->size = sizeof(intmax_t);
+			++pos;
+			break;
+		case 't':
+			spec->size = sizeof(ptrdiff_t);
+			++pos;
+			break;
+		case 'L':
+			++pos;
+			break;
+		default:
+			spec->modifier = 0;
+			break;
+		}
+	}
+
+	spec->conversion = (pos < length) ? format[pos++] : 0;
+	spec->length = pos - spec->offset;
+	*offset = pos;
+	return true;
+}
+
+static int
+_log_binary_parse(const char* format, size_t length, uint8_t* type) {
+	log_spec_t spec;
+	size_t offset = 0;
+	int argc = 0;
+
+	while (_log_binary_scan(format, length, &offset, &spec)) {
+		if (spec.conversion == '%')
+			continue;
+		if (argc + 3 > LOG_BINARY_ARGS)
+			return -1;
+		if (spec.width_star)
+			type[argc++] = LOG_BINARY_ARG_INT32;
+		if (spec.precision_star)
+			type[argc++] = LOG_BINARY_ARG_INT32;
+		switch (spec.conversion) {
+		case 'c':
+			if (spec.modifier == 'l')
+				return -1;
+			type[argc++] = LOG_BINARY_ARG_INT32;
+			break;
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			type[argc++] = (spec.size > 4) ? LOG_BINARY_ARG_INT64 : LOG_BINARY_ARG_INT32;
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			if (spec.modifier == 'L')
+				return -1;
+			type[argc++] = LOG_BINARY_ARG_DOUBLE;
+			break;
+		case 's':
+			if (spec.modifier == 'l')
+				return -1;
+			type[argc++] = spec.precision_star ? LOG_BINARY_ARG_STRING_BOUNDED : LOG_BINARY_ARG_STRING;
+			break;
+		case 'p':
+			type[argc++] = LOG_BINARY_ARG_POINTER;
+			break;
+		default:
+			//Unsupported conversion, including %n
+			return -1;
+		}
+	}
+	return argc;
+}
+
+static void
+_log_binary_emit(log_buffer_t* record, bool required) {
+	if (_log_async) {
+		_log_async_push(0, ERRORLEVEL_NONE, (const char*)record->data, record->size, 0,
+		                LOG_RECORD_BINARY | (required ? LOG_RECORD_REQUIRED : 0));
+	}
+	else {
+		lock_lock(&_log_binary_lock);
+		if (_log_binary_stream)
+			stream_write(_log_binary_stream, record->data, record->size);
+		lock_unlock(&_log_binary_lock);
+	}
+}
+
+//Look up format in the binary log table, or in the flight recorder table which keeps a copy
+//of the format string for expanding records in process
+static log_format_t*
+_log_binary_format_lookup(log_format_t* table, const char* format, size_t length) {
+	uint64_t key = (uint64_t)(uintptr_t)format;
+	size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 54) & (LOG_BINARY_FORMATS - 1);
+	size_t probe;
+
+	for (probe = 0; probe < LOG_BINARY_FORMATS; ++probe) {
+		log_format_t* entry = table + slot;
+		void* current = atomic_loadptr(&entry->format);
+		if (!current) {
+			if (atomic_cas_ptr(&entry->format, (void*)(uintptr_t)format, 0)) {
+				entry->argc = _log_binary_parse(format, length, entry->type);
+				if (table == _log_recorder_format) {
+					entry->id = (uint32_t)slot;
+					if (entry->argc >= 0) {
+						entry->string = memory_allocate(0, length + 1, 0, MEMORY_PERSISTENT);
+						memcpy(entry->string, format, length);
+						entry->string[length] = 0;
+						entry->length = length;
+					}
+				}
+				else {
+					//Format record must be output before any message using it, other threads wait
+					//for the entry to be ready
+					entry->id = (uint32_t)(atomic_incr32(&_log_binary_format_count) - 1);
+					if (entry->argc >= 0) {
+						log_buffer_t record;
+						_log_buffer_initialize(&record);
+						_log_buffer_append_uint(&record, LOG_BINARY_RECORD_FORMAT);
+						_log_buffer_append_uint(&record, entry->id);
+						_log_buffer_append_uint(&record, (uint64_t)entry->argc);
+						_log_buffer_append(&record, entry->type, (size_t)entry->argc);
+						_log_buffer_append_uint(&record, length);
+						_log_buffer_append(&record, format, length);
+						_log_binary_emit(&record, true);
+						_log_buffer_finalize(&record);
+					}
+				}
+				atomic_store32_explicit(&entry->ready, 1, MEMORY_ORDER_RELEASE);
+				return entry;
+			}
+			current = atomic_loadptr(&entry->format);
+		}
+		if (current == format) {
+			while (!atomic_load32_explicit(&entry->ready, MEMORY_ORDER_ACQUIRE))
+				thread_yield();
+			return entry;
+		}
+		slot = (slot + 1) & (LOG_BINARY_FORMATS - 1);
+	}
+	return 0;
+}
+
+static void
+_log_binary_encode_header(log_buffer_t* record, uint32_t id, hash_t context,
+                          error_level_t severity, unsigned int code) {
+	_log_buffer_append_uint(record, LOG_BINARY_RECORD_MESSAGE);
+	_log_buffer_append_uint(record, id);
+	_log_buffer_append_uint(record, (uint64_t)severity);
+	_log_buffer_append_uint(record, code);
+	_log_buffer_append(record, &context, sizeof(context));
+	_log_buffer_append_uint(record, (uint64_t)_log_elapsed());
+	_log_buffer_append_uint(record, thread_id());
+	_log_buffer_append_uint(record, thread_hardware());
+}
+
+//Encode message record, string arguments are truncated to the given maximum length
+static void
+_log_binary_encode(log_buffer_t* record, const log_format_t* entry, hash_t context,
+                   error_level_t severity, unsigned int code, size_t string_max, va_list list) {
+	int32_t bound = -1;
+	int iarg;
+
+	_log_binary_encode_header(record, entry->id, context, severity, code);
+
+	for (iarg = 0; iarg < entry->argc; ++iarg) {
+		switch (entry->type[iarg]) {
+		case LOG_BINARY_ARG_INT32: {
+				int32_t value = va_arg(list, int32_t);
+				bound = value;
+				_log_buffer_append(record, &value, sizeof(value));
+				break;
+			}
+		case LOG_BINARY_ARG_INT64: {
+				int64_t value = va_arg(list, int64_t);
+				_log_buffer_append(record, &value, sizeof(value));
+				break;
+			}
+		case LOG_BINARY_ARG_DOUBLE: {
+				double value = va_arg(list, double);
+				_log_buffer_append(record, &value, sizeof(value));
+				break;
+			}
+		case LOG_BINARY_ARG_POINTER: {
+				uint64_t value = (uint64_t)(uintptr_t)va_arg(list, void*);
+				_log_buffer_append(record, &value, sizeof(value));
+				break;
+			}
+		default: {
+				const char* str = va_arg(list, const char*);
+				size_t limit = ((entry->type[iarg] == LOG_BINARY_ARG_STRING_BOUNDED) && (bound >= 0)) ?
+				               (size_t)bound : (size_t)-1;
+				size_t str_length = 0;
+				if (limit > string_max)
+					limit = string_max;
+				if (!str)
+					str = "(null)";
+				while ((str_length < limit) && str[str_length])
+					++str_length;
+				_log_buffer_append_uint(record, str_length);
+				_log_buffer_append(record, str, str_length);
+				break;
+			}
+		}
+	}
+}
+
+static bool
+_log_binary_write(hash_t context, error_level_t severity, unsigned int code, const char* format,
+                  size_t length, va_list list) {
+	log_format_t* entry = _log_binary_format_lookup(_log_binary_format, format, length);
+	log_buffer_t record;
+
+	//Unsupported format strings and a full format table fall back to text output
+	if (!entry || (entry->argc < 0))
+		return false;
+
+	_log_buffer_initialize(&record);
+	_log_binary_encode(&record, entry, context, severity, code, (size_t)-1, list);
+	_log_binary_emit(&record, false);
+	_log_buffer_finalize(&record);
+	return true;
+}
+
+static uint64_t
+_log_binary_read_uint(stream_t* stream) {
+	uint64_t value = 0;
+	unsigned int shift = 0;
+	uint8_t byte;
+	do {
+		byte = stream_read_uint8(stream);
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	}
+	while ((byte & 0x80) && (shift < 64));
+	return value;
+}
+
+static void
+_log_binary_read_raw(stream_t* stream, void* value, size_t size, bool swap) {
+	memset(value, 0, size);
+	stream_read(stream, value, size);
+	if (swap)
+		byteorder_swap(value, size);
+}
+
+static void
+_log_binary_expand_arg(log_buffer_t* out, const char* spec, uint8_t type, const log_arg_t* arg) {
+	int need = -1;
+	int attempt;
+	size_t avail = 64;
+
+	for (attempt = 0; attempt < 2; ++attempt) {
+		char* dest = (char*)_log_buffer_reserve(out, avail);
+		switch (type) {
+		case LOG_BINARY_ARG_INT32:
+			need = snprintf(dest, avail, spec, arg->i32);
+			break;
+		case LOG_BINARY_ARG_INT64:
+			need = snprintf(dest, avail, spec, arg->i64);
+			break;
+		case LOG_BINARY_ARG_DOUBLE:
+			need = snprintf(dest, avail, spec, arg->f64);
+			break;
+		case LOG_BINARY_ARG_POINTER:
+			need = snprintf(dest, avail, spec, (void*)(uintptr_t)arg->ptr);
+			break;
+		default:
+			need = snprintf(dest, avail, spec, arg->str);
+			break;
+		}
+		if ((need < 0) || ((size_t)need < avail))
+			break;
+		avail = (size_t)need + 1;
+	}
+	if (need > 0)
+		out->size += (size_t)need;
+}
+
+static void
+_log_binary_expand_message(log_buffer_t* out, const log_format_t* format, log_arg_t* arg) {
+	log_spec_t spec;
+	size_t offset = 0;
+	size_t last = 0;
+	int iarg = 0;
+
+	while (_log_binary_scan(format->string, format->length, &offset, &spec)) {
+		char spec_text[64];
+		size_t spec_length = 0;
+		size_t ichar;
+
+		_log_buffer_append(out, format->string + last, spec.offset - last);
+		last = offset;
+		if (spec.conversion == '%') {
+			_log_buffer_append(out, "%", 1);
+			continue;
+		}
+		if (spec.length + 24 > sizeof(spec_text)) {
+			iarg += 1 + (spec.width_star ? 1 : 0) + (spec.precision_star ? 1 : 0);
+			continue;
+		}
+
+		for (ichar = spec.offset; ichar < offset; ++ichar) {
+			char c = format->string[ichar];
+			if ((c == '.') && (ichar + 1 < offset) && (format->string[ichar + 1] == '*') &&
+			        (arg[iarg].i32 < 0)) {
+				//Negative precision argument is taken as if the precision was omitted
+				++ichar;
+				++iarg;
+			}
+			else if (c == '*') {
+				string_t number = string_format(spec_text + spec_length, sizeof(spec_text) - spec_length,
+				                                STRING_CONST("%d"), arg[iarg++].i32);
+				spec_length += number.length;
+			}
+			else {
+				spec_text[spec_length++] = c;
+			}
+		}
+		spec_text[spec_length] = 0;
+
+		_log_binary_expand_arg(out, spec_text, format->type[iarg], arg + iarg);
+		++iarg;
+	}
+	_log_buffer_append(out, format->string + last, format->length - last);
+}
+
+//Expand message to a text line in the same format as text log output
+static void
+_log_binary_expand_line(log_buffer_t* line, const log_format_t* format, error_level_t severity,
+                        unsigned int code, log_timestamp_t timestamp, uint64_t tid,
+                        unsigned int pid, log_arg_t* arg) {
+	if (_log_prefix) {
+		char buffer[64];
+		string_t prefix = string_format(buffer, sizeof(buffer),
+		                                STRING_CONST("[%d:%02d:%02d.%03d] <%" PRIx64 ":%u> "),
+		                                timestamp.hours, timestamp.minutes, timestamp.seconds,
+		                                timestamp.milliseconds, tid, pid);
+		_log_buffer_append(line, prefix.str, prefix.length);
+	}
+	if (severity >= ERRORLEVEL_WARNING) {
+		char buffer[32];
+		string_t prefix;
+		if (severity == ERRORLEVEL_WARNING) {
+			if (code < LOG_WARNING_NAMES)
+				prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%s]: "),
+				                       _log_warning_name[code]);
+			else
+				prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%u]: "), code);
+		}
+		else {
+			const char* level = (severity == ERRORLEVEL_ERROR) ? "ERROR" : "PANIC";
+			if (code < LOG_ERROR_NAMES)
+				prefix = string_format(buffer, sizeof(buffer), STRING_CONST("%s [%s]: "), level,
+				                       _log_error_name[code]);
+			else
+				prefix = string_format(buffer, sizeof(buffer), STRING_CONST("%s [%u]: "), level, code);
+		}
+		_log_buffer_append(line, prefix.str, prefix.length);
+	}
+	_log_binary_expand_message(line, format, arg);
+	_log_buffer_append(line, "\n", 1);
+}
+
+#define LOG_RECORDER_SIZE_MIN    (16U * 1024U)
+#define LOG_RECORDER_RECORD_MAX  1024
+#define LOG_RECORDER_STRING_MAX  256
+#define LOG_RECORDER_THREADS     256
+#define LOG_RECORDER_LINE        2048
+//Bytes needed to decode the record header up to and including the timestamp
+#define LOG_RECORDER_HEADER_MAX  58
+
+typedef struct log_recorder_t log_recorder_t;
+typedef struct log_recorder_cursor_t log_recorder_cursor_t;
+typedef struct log_recorder_history_t log_recorder_history_t;
+
+typedef void (*log_recorder_sink_fn)(void* arg, const void* line, size_t length);
+
+//Flight recorder ring of binary message records for one thread, each record prefixed by its
+//32-bit length. Positions are monotonic, the oldest records are evicted when the ring is full
+//and the begin position is published before the evicted memory is overwritten.
+struct log_recorder_t {
+	log_recorder_t* next;
+	atomic32_t owned;
+	size_t capacity;
+	atomic64_t begin;
+	atomic64_t end;
+	uint8_t data[];
+};
+
+//Read position in a ring while merging the rings of all threads by timestamp
+struct log_recorder_cursor_t {
+	const log_recorder_t* recorder;
+	uint64_t pos;
+	uint64_t end;
+	uint32_t size;
+	tick_t elapsed;
+};
+
+struct log_recorder_history_t {
+	char* buffer;
+	size_t capacity;
+	size_t total;
+};
+
+atomic32_t _log_recorder_active;
+
+static size_t      _log_recorder_size;
+static atomicptr_t _log_recorder_list;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(log_recorder_t*, log_recorder, 0)
+
+static void
+_log_recorder_store(log_recorder_t* recorder, uint64_t pos, const void* data, size_t size) {
+	size_t offset = (size_t)(pos % recorder->capacity);
+	size_t chunk = recorder->capacity - offset;
+	if (chunk > size)
+		chunk = size;
+	memcpy(recorder->data + offset, data, chunk);
+	if (chunk < size)
+		memcpy(recorder->data, (const uint8_t*)data + chunk, size - chunk);
+}
+
+static void
+_log_recorder_load(const log_recorder_t* recorder, uint64_t pos, void* data, size_t size) {
+	size_t offset = (size_t)(pos % recorder->capacity);
+	size_t chunk = recorder->capacity - offset;
+	if (chunk > size)
+		chunk = size;
+	memcpy(data, recorder->data + offset, chunk);
+	if (chunk < size)
+		memcpy((uint8_t*)data + chunk, recorder->data, size - chunk);
+}
+
+static void
+_log_recorder_append(log_recorder_t* recorder, const void* data, size_t size) {
+	uint32_t length = (uint32_t)size;
+	uint64_t begin = (uint64_t)atomic_load64(&recorder->begin);
+	uint64_t end = (uint64_t)atomic_load64(&recorder->end);
+	uint64_t next = end + sizeof(length) + size;
+
+	while (next - begin > recorder->capacity) {
+		uint32_t evict;
+		_log_recorder_load(recorder, begin, &evict, sizeof(evict));
+		begin += sizeof(evict) + evict;
+	}
+	atomic_store64(&recorder->begin, (int64_t)begin);
+	atomic_thread_fence_sequentially_consistent();
+
+	_log_recorder_store(recorder, end, &length, sizeof(length));
+	_log_recorder_store(recorder, end + sizeof(length), data, size);
+	atomic_store64_explicit(&recorder->end, (int64_t)next, MEMORY_ORDER_RELEASE);
+}
+
+static log_recorder_t*
+_log_recorder_acquire(size_t capacity) {
+	log_recorder_t* recorder = get_thread_log_recorder();
+	void* head;
+
+	if (recorder) {
+		if (recorder->capacity == capacity)
+			return recorder;
+		atomic_store32(&recorder->owned, 0);
+	}
+
+	//Reuse a ring released by an exited thread, keeping its records until overwritten
+	recorder = atomic_loadptr(&_log_recorder_list);
+	while (recorder && ((recorder->capacity != capacity) || atomic_load32(&recorder->owned) ||
+	                    !atomic_cas32(&recorder->owned, 1, 0)))
+		recorder = recorder->next;
+
+	if (!recorder) {
+		recorder = memory_allocate(0, sizeof(log_recorder_t) + capacity, 0,
+		                           MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		recorder->capacity = capacity;
+		atomic_store32(&recorder->owned, 1);
+		do {
+			head = atomic_loadptr(&_log_recorder_list);
+			recorder->next = head;
+		}
+		while (!atomic_cas_ptr(&_log_recorder_list, recorder, head));
+	}
+
+	set_thread_log_recorder(recorder);
+	return recorder;
+}
+
+static void
+_log_recorder_write(hash_t context, error_level_t severity, unsigned int code, const char* format,
+                    size_t length, va_list list) {
+	static const char text_format[] = "%.*s";
+	log_recorder_t* recorder;
+	log_format_t* entry;
+	log_buffer_t record;
+	va_list clist;
+	size_t capacity = _log_recorder_size;
+
+	if (!capacity)
+		return;
+	recorder = _log_recorder_acquire(capacity);
+	entry = _log_binary_format_lookup(_log_recorder_format, format, length);
+	if (!entry)
+		return;
+
+	_log_buffer_initialize(&record);
+	va_copy(clist, list);
+	if (entry->argc >= 0) {
+		_log_binary_encode(&record, entry, context, severity, code, LOG_RECORDER_STRING_MAX, clist);
+	}
+	else {
+		//Unsupported format strings are formatted and recorded as a single string argument
+		char buffer[LOG_RECORDER_STRING_MAX];
+		int need = vsnprintf(buffer, sizeof(buffer), format, clist);
+		int32_t text_length = (need < 0) ? 0 :
+		                      ((need < (int)sizeof(buffer)) ? need : (int)sizeof(buffer) - 1);
+		entry = _log_binary_format_lookup(_log_recorder_format, text_format, sizeof(text_format) - 1);
+		if (entry) {
+			_log_binary_encode_header(&record, entry->id, context, severity, code);
+			_log_buffer_append(&record, &text_length, sizeof(text_length));
+			_log_buffer_append_uint(&record, (uint64_t)text_length);
+			_log_buffer_append(&record, buffer, (size_t)text_length);
+		}
+	}
+	va_end(clist);
+
+	if (record.size && (record.size <= LOG_RECORDER_RECORD_MAX))
+		_log_recorder_append(recorder, record.data, record.size);
+	_log_buffer_finalize(&record);
+}
+
+static uint64_t
+_log_recorder_read_uint(const uint8_t* data, size_t size, size_t* offset) {
+	uint64_t value = 0;
+	unsigned int shift = 0;
+	uint8_t byte;
+	do {
+		byte = (*offset < size) ? data[(*offset)++] : 0;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	}
+	while ((byte & 0x80) && (shift < 64));
+	return value;
+}
+
+static void
+_log_recorder_read_raw(const uint8_t* data, size_t size, size_t* offset, void* value,
+                       size_t value_size) {
+	memset(value, 0, value_size);
+	if (*offset + value_size <= size)
+		memcpy(value, data + *offset, value_size);
+	*offset += value_size;
+}
+
+//Read the header of the record at the cursor position, skipping records overwritten by the
+//writing thread. Returns false at the end of the ring.
+static bool
+_log_recorder_peek(log_recorder_cursor_t* cursor) {
+	const log_recorder_t* recorder = cursor->recorder;
+	uint8_t header[LOG_RECORDER_HEADER_MAX];
+	size_t offset = 0;
+	uint64_t begin;
+
+	while (cursor->pos + sizeof(uint32_t) <= cursor->end) {
+		_log_recorder_load(recorder, cursor->pos, &cursor->size, sizeof(cursor->size));
+		if ((cursor->size <= LOG_RECORDER_RECORD_MAX) &&
+		        (cursor->pos + sizeof(uint32_t) + cursor->size <= cursor->end))
+			_log_recorder_load(recorder, cursor->pos + sizeof(uint32_t), header,
+			                   (cursor->size < sizeof(header)) ? cursor->size : sizeof(header));
+		atomic_thread_fence_acquire();
+		begin = (uint64_t)atomic_load64(&recorder->begin);
+		if (begin > cursor->pos) {
+			cursor->pos = begin;
+			continue;
+		}
+		if ((cursor->size > LOG_RECORDER_RECORD_MAX) ||
+		        (cursor->pos + sizeof(uint32_t) + cursor->size > cursor->end))
+			return false;
+		_log_recorder_read_uint(header, cursor->size, &offset);
+		_log_recorder_read_uint(header, cursor->size, &offset);
+		_log_recorder_read_uint(header, cursor->size, &offset);
+		_log_recorder_read_uint(header, cursor->size, &offset);
+		offset += sizeof(hash_t);
+		cursor->elapsed = (tick_t)_log_recorder_read_uint(header, cursor->size, &offset);
+		return true;
+	}
+	return false;
+}
+
+//Expand the record at the cursor position to a text line, returns false if the record was
+//overwritten while reading
+static bool
+_log_recorder_expand(log_recorder_cursor_t* cursor, log_buffer_t* line, tick_t ticks_per_second) {
+	uint8_t record[LOG_RECORDER_RECORD_MAX];
+	char strings[LOG_RECORDER_RECORD_MAX + LOG_BINARY_ARGS];
+	log_arg_t arg[LOG_BINARY_ARGS];
+	const log_format_t* entry;
+	size_t size = cursor->size;
+	size_t offset = 0;
+	size_t used = 0;
+	error_level_t severity;
+	unsigned int code;
+	hash_t context;
+	log_timestamp_t timestamp;
+	uint64_t id, tid;
+	unsigned int pid;
+	int iarg;
+
+	_log_recorder_load(cursor->recorder, cursor->pos + sizeof(uint32_t), record, size);
+	atomic_thread_fence_acquire();
+	if ((uint64_t)atomic_load64(&cursor->recorder->begin) > cursor->pos)
+		return false;
+
+	_log_recorder_read_uint(record, size, &offset);
+	id = _log_recorder_read_uint(record, size, &offset);
+	if (id >= LOG_BINARY_FORMATS)
+		return false;
+	entry = _log_recorder_format + id;
+	if (!atomic_load32_explicit(&entry->ready, MEMORY_ORDER_ACQUIRE) || !entry->string)
+		return false;
+	severity = (error_level_t)_log_recorder_read_uint(record, size, &offset);
+	code = (unsigned int)_log_recorder_read_uint(record, size, &offset);
+	_log_recorder_read_raw(record, size, &offset, &context, sizeof(context));
+	timestamp = _log_timestamp((tick_t)_log_recorder_read_uint(record, size, &offset),
+	                           ticks_per_second);
+	tid = _log_recorder_read_uint(record, size, &offset);
+	pid = (unsigned int)_log_recorder_read_uint(record, size, &offset);
+
+	for (iarg = 0; iarg < entry->argc; ++iarg) {
+		switch (entry->type[iarg]) {
+		case LOG_BINARY_ARG_INT32:
+			_log_recorder_read_raw(record, size, &offset, &arg[iarg].i32, sizeof(int32_t));
+			break;
+		case LOG_BINARY_ARG_INT64:
+			_log_recorder_read_raw(record, size, &offset, &arg[iarg].i64, sizeof(int64_t));
+			break;
+		case LOG_BINARY_ARG_DOUBLE:
+			_log_recorder_read_raw(record, size, &offset, &arg[iarg].f64, sizeof(double));
+			break;
+		case LOG_BINARY_ARG_POINTER:
+			_log_recorder_read_raw(record, size, &offset, &arg[iarg].ptr, sizeof(uint64_t));
+			break;
+		default: {
+				size_t length = (size_t)_log_recorder_read_uint(record, size, &offset);
+				if (offset + length > size)
+					return false;
+				arg[iarg].str = strings + used;
+				memcpy(arg[iarg].str, record + offset, length);
+				arg[iarg].str[length] = 0;
+				offset += length;
+				used += length + 1;
+				break;
+			}
+		}
+	}
+	if (offset > size)
+		return false;
+
+	FOUNDATION_UNUSED(context);
+	line->size = 0;
+	_log_binary_expand_line(line, entry, severity, code, timestamp, tid, pid, arg);
+	return true;
+}
+
+//Expand the records of all threads in timestamp order, oldest first
+static size_t
+_log_recorder_replay(log_recorder_sink_fn sink, void* sink_arg) {
+	log_recorder_cursor_t cursor[LOG_RECORDER_THREADS];
+	uint8_t storage[LOG_RECORDER_LINE];
+	const log_recorder_t* recorder;
+	tick_t ticks_per_second = time_ticks_per_second();
+	log_buffer_t line;
+	size_t num_cursors = 0;
+	size_t messages = 0;
+	size_t icursor;
+
+	recorder = atomic_loadptr(&_log_recorder_list);
+	for (; recorder && (num_cursors < LOG_RECORDER_THREADS); recorder = recorder->next) {
+		cursor[num_cursors].recorder = recorder;
+		cursor[num_cursors].end = (uint64_t)atomic_load64_explicit(&recorder->end,
+		                                                           MEMORY_ORDER_ACQUIRE);
+		cursor[num_cursors].pos = (uint64_t)atomic_load64(&recorder->begin);
+		if (_log_recorder_peek(cursor + num_cursors))
+			++num_cursors;
+	}
+
+	//Lines only allocate memory if expanding to more than the local storage
+	_log_buffer_initialize_storage(&line, storage, sizeof(storage));
+	while (num_cursors) {
+		size_t oldest = 0;
+		for (icursor = 1; icursor < num_cursors; ++icursor) {
+			if (cursor[icursor].elapsed < cursor[oldest].elapsed)
+				oldest = icursor;
+		}
+		if (_log_recorder_expand(cursor + oldest, &line, ticks_per_second)) {
+			sink(sink_arg, line.data, line.size);
+			++messages;
+		}
+		cursor[oldest].pos += sizeof(uint32_t) + cursor[oldest].size;
+		if (!_log_recorder_peek(cursor + oldest))
+			cursor[oldest] = cursor[--num_cursors];
+	}
+	_log_buffer_finalize(&line);
+
+	return messages;
+}
+
+static void
+_log_recorder_sink_stream(void* arg, const void* line, size_t length) {
+	stream_write(arg, line, length);
+}
+
+//Keep the most recent output in the buffer, used as a ring
+static void
+_log_recorder_sink_history(void* arg, const void* line, size_t length) {
+	log_recorder_history_t* history = arg;
+	size_t offset, chunk;
+	if (length > history->capacity) {
+		line = (const char*)line + (length - history->capacity);
+		history->total += length - history->capacity;
+		length = history->capacity;
+	}
+	offset = history->total % history->capacity;
+	chunk = history->capacity - offset;
+	if (chunk > length)
+		chunk = length;
+	memcpy(history->buffer + offset, line, chunk);
+	if (chunk < length)
+		memcpy(history->buffer, (const char*)line + chunk, length - chunk);
+	history->total += length;
+}
+
+static void
+_log_recorder_reverse(char* buffer, size_t length) {
+	size_t ichar;
+	for (ichar = 0; ichar < length / 2; ++ichar) {
+		char c = buffer[ichar];
+		buffer[ichar] = buffer[length - ichar - 1];
+		buffer[length - ichar - 1] = c;
+	}
+}
+
 static void FOUNDATION_PRINTFCALL(5, 0)
 _log_outputf(hash_t context, error_level_t severity, const char* prefix, size_t prefix_length,
              const char* format, size_t format_length, va_list list, void* std) {
@@ -156,31 +1443,16 @@ _log_outputf(hash_t context, error_level_t severity, const char* prefix, size_t
 			buffer[endl++] = '\n';
 			buffer[endl] = 0;
 
-#if FOUNDATION_PLATFORM_WINDOWS
-			if (_log_stdout)
-				OutputDebugStringA(buffer);
-#endif
-
-#if FOUNDATION_PLATFORM_ANDROID
-			FOUNDATION_UNUSED(std);
-			if (_log_stdout)
-				__android_log_write(ANDROID_LOG_DEBUG + severity - 1, environment_application()->short_name.str,
-				                    buffer);
-#elif FOUNDATION_PLATFORM_TIZEN
-			FOUNDATION_UNUSED(std);
-			if (_log_stdout)
-				dlog_print(DLOG_DEBUG + severity - 1, environment_application()->short_name.str, "%s", buffer);
-#elif FOUNDATION_PLATFORM_PNACL
-			FOUNDATION_UNUSED(std);
-			if (_log_stdout)
-				pnacl_post_log(context, severity, buffer, (unsigned int)endl);
-#else
-			if (_log_stdout && std)
-				fprintf(std, "%s", buffer);
-#endif
-
-			if (_log_callback)
-				_log_callback(context, severity, buffer, (unsigned int)(endl - 1));
+			//Panics are always output synchronously after any pending messages
+			if (_log_async && (severity < ERRORLEVEL_PANIC)) {
+				_log_async_push(context, severity, buffer, (size_t)endl, std,
+				                _log_stdout ? LOG_RECORD_OUTPUT : 0);
+			}
+			else {
+				if (_log_async)
+					log_flush();
+				_log_output(context, severity, buffer, (size_t)endl, std, _log_stdout);
+			}
 
 			break;
 		}
@@ -198,6 +1470,56 @@ _log_outputf(hash_t context, error_level_t severity, const char* prefix, size_t
 		memory_deallocate(buffer);
 }
 
+static void FOUNDATION_PRINTFCALL(4, 6)
+_log_error_contextf(hash_t context, error_level_t error_level, void* std, const char* format,
+                    size_t length, ...) {
+	va_list list;
+	va_start(list, length);
+	if (!_log_binary_stream || (error_level >= ERRORLEVEL_PANIC) ||
+	        !_log_binary_write(context, error_level, 0, format, length, list))
+		_log_outputf(context, error_level, "", 0, format, length, list, std);
+	va_end(list);
+}
+
+static bool
+_log_rate_check(hash_t context, error_level_t severity, void* std) {
+	log_limit_t* limit = 0;
+	tick_t now, tat, next;
+	int32_t suppressed;
+
+	if (!_log_limit_active)
+		return true;
+
+	if (context && _log_limit) {
+		uint64_t slot = hashtable64_get(_log_limit, context);
+		if (slot)
+			limit = _log_limits + (slot - 1);
+	}
+	if (!limit)
+		limit = &_log_limit_default;
+	if (!limit->interval)
+		return true;
+
+	//Token bucket as theoretical arrival time, message is allowed if it does not arrive
+	//earlier than the burst tolerance allows
+	now = time_current();
+	do {
+		tat = atomic_load64(&limit->tat);
+		next = (tat > now) ? tat : now;
+		if (next - now > limit->tolerance) {
+			atomic_incr32(&limit->suppressed);
+			return false;
+		}
+	}
+	while (!atomic_cas64(&limit->tat, next + limit->interval, tat));
+
+	suppressed = atomic_load32(&limit->suppressed);
+	if (suppressed && atomic_cas32(&limit->suppressed, 0, suppressed))
+		_log_error_contextf(context, severity, std, STRING_CONST("Rate limit suppressed %d messages"),
+		                    suppressed);
+	return true;
+}
+
 #endif
 
 #if BUILD_ENABLE_LOG && BUILD_ENABLE_DEBUG_LOG
@@ -206,7 +1528,11 @@ void
 log_debugf(hash_t context, const char* format, size_t length, ...) {
 	va_list list;
 	va_start(list, length);
-	if (log_suppress(context) < ERRORLEVEL_DEBUG)
+	if (_log_recorder_size)
+		_log_recorder_write(context, ERRORLEVEL_DEBUG, 0, format, length, list);
+	if ((log_suppress(context) < ERRORLEVEL_DEBUG) &&
+	        _log_rate_check(context, ERRORLEVEL_DEBUG, stdout) && (!_log_binary_stream ||
+	        !_log_binary_write(context, ERRORLEVEL_DEBUG, 0, format, length, list)))
 		_log_outputf(context, ERRORLEVEL_DEBUG, "", 0, format, length, list, stdout);
 	va_end(list);
 }
@@ -224,7 +1550,11 @@ void
 log_infof(hash_t context, const char* format, size_t length, ...) {
 	va_list list;
 	va_start(list, length);
-	if (log_suppress(context) < ERRORLEVEL_INFO)
+	if (_log_recorder_size)
+		_log_recorder_write(context, ERRORLEVEL_INFO, 0, format, length, list);
+	if ((log_suppress(context) < ERRORLEVEL_INFO) &&
+	        _log_rate_check(context, ERRORLEVEL_INFO, stdout) && (!_log_binary_stream ||
+	        !_log_binary_write(context, ERRORLEVEL_INFO, 0, format, length, list)))
 		_log_outputf(context, ERRORLEVEL_INFO, "", 0, format, length, list, stdout);
 	va_end(list);
 }
@@ -240,19 +1570,29 @@ log_warnf(hash_t context, warning_t warn, const char* format, size_t length, ...
 	string_t prefix;
 	va_list list;
 
-	if (log_suppress(context) >= ERRORLEVEL_WARNING)
+	va_start(list, length);
+	if (_log_recorder_size)
+		_log_recorder_write(context, ERRORLEVEL_WARNING, (unsigned int)warn, format, length, list);
+
+	if ((log_suppress(context) >= ERRORLEVEL_WARNING) ||
+	        !_log_rate_check(context, ERRORLEVEL_WARNING, stdout)) {
+		va_end(list);
 		return;
+	}
 
 	log_error_context(context, ERRORLEVEL_WARNING);
 
-	if (warn < LOG_WARNING_NAMES)
-		prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%s]: "),
-		                       _log_warning_name[warn]);
-	else
-		prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%d]: "), warn);
-
-	va_start(list, length);
-	_log_outputf(context, ERRORLEVEL_WARNING, prefix.str, prefix.length, format, length, list, stdout);
+	if (!_log_binary_stream ||
+	        !_log_binary_write(context, ERRORLEVEL_WARNING, (unsigned int)warn, format, length,
+	                           list)) {
+		if (warn < LOG_WARNING_NAMES)
+			prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%s]: "),
+			                       _log_warning_name[warn]);
+		else
+			prefix = string_format(buffer, sizeof(buffer), STRING_CONST("WARNING [%d]: "), warn);
+		_log_outputf(context, ERRORLEVEL_WARNING, prefix.str, prefix.length, format, length, list,
+		             stdout);
+	}
 	va_end(list);
 }
 
@@ -269,18 +1609,28 @@ log_errorf(hash_t context, error_t err, const char* format, size_t length, ...)
 
 	error_report(ERRORLEVEL_ERROR, err);
 
-	if (log_suppress(context) >= ERRORLEVEL_ERROR)
+	va_start(list, length);
+	if (_log_recorder_size)
+		_log_recorder_write(context, ERRORLEVEL_ERROR, (unsigned int)err, format, length, list);
+
+	if ((log_suppress(context) >= ERRORLEVEL_ERROR) ||
+	        !_log_rate_check(context, ERRORLEVEL_ERROR, stderr)) {
+		va_end(list);
 		return;
+	}
 
 	log_error_context(context, ERRORLEVEL_ERROR);
 
-	if (err < LOG_ERROR_NAMES)
-		prefix = string_format(buffer, sizeof(buffer), STRING_CONST("ERROR [%s]: "), _log_error_name[err]);
-	else
-		prefix = string_format(buffer, sizeof(buffer), STRING_CONST("ERROR [%d]: "), err);
-
-	va_start(list, length);
-	_log_outputf(context, ERRORLEVEL_ERROR, prefix.str, prefix.length, format, length, list, stderr);
+	if (!_log_binary_stream ||
+	        !_log_binary_write(context, ERRORLEVEL_ERROR, (unsigned int)err, format, length, list)) {
+		if (err < LOG_ERROR_NAMES)
+			prefix = string_format(buffer, sizeof(buffer), STRING_CONST("ERROR [%s]: "),
+			                       _log_error_name[err]);
+		else
+			prefix = string_format(buffer, sizeof(buffer), STRING_CONST("ERROR [%d]: "), err);
+		_log_outputf(context, ERRORLEVEL_ERROR, prefix.str, prefix.length, format, length, list,
+		             stderr);
+	}
 	va_end(list);
 }
 
@@ -305,6 +1655,8 @@ log_panicf(hash_t context, error_t err, const char* format, size_t length, ...)
 		prefix = string_format(buffer, sizeof(buffer), STRING_CONST("PANIC [%d]: "), err);
 
 	va_start(list, length);
+	if (_log_recorder_size)
+		_log_recorder_write(context, ERRORLEVEL_PANIC, (unsigned int)err, format, length, list);
 	_log_outputf(context, ERRORLEVEL_PANIC, prefix.str, prefix.length, format, length, list, stderr);
 	va_end(list);
 }
@@ -314,15 +1666,6 @@ log_panic(hash_t context, error_t err, const char* msg, size_t length) {
 	log_panicf(context, err, STRING_CONST("%.*s"), (int)length, msg);
 }
 
-static void FOUNDATION_PRINTFCALL(4, 6)
-_log_error_contextf(hash_t context, error_level_t error_level, void* std, const char* format,
-                    size_t length, ...) {
-	va_list list;
-	va_start(list, length);
-	_log_outputf(context, error_level, "", 0, format, length, list, std);
-	va_end(list);
-}
-
 void
 log_error_context(hash_t context, error_level_t error_level) {
 	size_t i;
@@ -351,29 +1694,363 @@ log_set_callback(log_callback_fn callback) {
 	_log_callback = callback;
 }
 
+void
+log_enable_async(bool enable, size_t capacity, bool block) {
+	if (enable) {
+		_log_async_capacity = (int32_t)(capacity ? capacity : LOG_ASYNC_CAPACITY);
+		_log_async_block = block;
+		if (_log_async)
+			return;
+
+		lockfree_queue_initialize(&_log_async_queue);
+		semaphore_initialize(&_log_async_signal, 0);
+		atomic_store32(&_log_async_pending, 0);
+		atomic_store64(&_log_async_dropped, 0);
+		atomic_store32(&_log_async_running, 1);
+		thread_initialize(&_log_async_thread, _log_async_run, 0, STRING_CONST("log"),
+		                  THREAD_PRIORITY_BELOWNORMAL, 0);
+		thread_start(&_log_async_thread);
+		_log_async = true;
+	}
+	else if (_log_async) {
+		//New messages are output synchronously, then remaining queue is drained
+		_log_async = false;
+		atomic_store32(&_log_async_running, 0);
+		semaphore_post(&_log_async_signal);
+		thread_finalize(&_log_async_thread);
+		semaphore_finalize(&_log_async_signal);
+	}
+}
+
+void
+log_flush(void) {
+	if (_log_async) {
+		while (atomic_load32(&_log_async_pending) > 0)
+			thread_yield();
+	}
+	fflush(stdout);
+	fflush(stderr);
+
+	_log_file_lock_acquire();
+	if (_log_file)
+		_log_file_flush(true);
+	_log_file_lock_release();
+}
+
+bool
+log_set_file(const char* path, size_t length, const log_file_config_t* config) {
+	bool result = true;
+
+	log_flush();
+
+	_log_file_lock_acquire();
+	if (_log_file_path.str) {
+		if (_log_file) {
+			_log_file_flush(true);
+			stream_deallocate(_log_file);
+		}
+		memory_deallocate(_log_file_buffer);
+		string_deallocate(_log_file_path.str);
+		_log_file = 0;
+		_log_file_buffer = 0;
+		_log_file_path = (string_t) { 0, 0 };
+	}
+
+	if (length) {
+		if (config)
+			_log_file_config = *config;
+		else
+			memset(&_log_file_config, 0, sizeof(_log_file_config));
+		if (!_log_file_config.buffer_size)
+			_log_file_config.buffer_size = LOG_FILE_BUFFER_SIZE;
+		if (!_log_file_config.flush_interval)
+			_log_file_config.flush_interval = LOG_FILE_FLUSH_INTERVAL;
+		if (!_log_file_config.rotate_count)
+			_log_file_config.rotate_count = LOG_FILE_ROTATE_COUNT;
+
+		_log_file_path = string_clone(path, length);
+		_log_file = _log_file_open(false);
+		if (_log_file) {
+			_log_file_buffer = memory_allocate(0, _log_file_config.buffer_size, 0, MEMORY_PERSISTENT);
+			_log_file_used = 0;
+			_log_file_size = stream_tell(_log_file);
+			_log_file_opened = time_current();
+			_log_file_written = _log_file_opened;
+			_log_file_interval = (time_ticks_per_second() * _log_file_config.flush_interval) / 1000;
+		}
+		else {
+			string_deallocate(_log_file_path.str);
+			_log_file_path = (string_t) { 0, 0 };
+			result = false;
+		}
+	}
+	_log_file_lock_release();
+
+	return result;
+}
+
+uint64_t
+log_async_dropped(void) {
+	return (uint64_t)atomic_load64(&_log_async_dropped);
+}
+
+string_t
+log_history(char* buffer, size_t capacity) {
+	size_t end, length, offset, chunk, start = 0;
+	if (!capacity)
+		return (string_t) {buffer, 0};
+	end = (size_t)atomic_load64(&_log_history_end);
+	length = (end > LOG_HISTORY_SIZE) ? LOG_HISTORY_SIZE : end;
+	if (length > capacity - 1)
+		length = capacity - 1;
+	offset = (end - length) % LOG_HISTORY_SIZE;
+	chunk = LOG_HISTORY_SIZE - offset;
+	if (chunk > length)
+		chunk = length;
+	memcpy(buffer, _log_history + offset, chunk);
+	if (chunk < length)
+		memcpy(buffer + chunk, _log_history, length - chunk);
+	//Start at a line boundary if the oldest line is truncated
+	if (end > length) {
+		while ((start < length) && (buffer[start] != '\n'))
+			++start;
+		if (start < length)
+			++start;
+		memmove(buffer, buffer + start, length - start);
+		length -= start;
+	}
+	buffer[length] = 0;
+	return (string_t) {buffer, length};
+}
+
+void
+log_enable_recorder(size_t size) {
+	if (size && (size < LOG_RECORDER_SIZE_MIN))
+		size = LOG_RECORDER_SIZE_MIN;
+	//Threads switch to rings of the new size on the next message
+	_log_recorder_size = size;
+	atomic_store32(&_log_recorder_active, size ? 1 : 0);
+}
+
+size_t
+log_recorder_size(void) {
+	return _log_recorder_size;
+}
+
+size_t
+log_recorder_dump(stream_t* stream) {
+	return _log_recorder_replay(_log_recorder_sink_stream, stream);
+}
+
+string_t
+log_recorder_history(char* buffer, size_t capacity) {
+	log_recorder_history_t history;
+	size_t length, start = 0;
+
+	if (capacity < 2)
+		return (string_t) {buffer, 0};
+
+	history.buffer = buffer;
+	history.capacity = capacity - 1;
+	history.total = 0;
+	_log_recorder_replay(_log_recorder_sink_history, &history);
+
+	length = (history.total > history.capacity) ? history.capacity : history.total;
+	if (history.total > history.capacity) {
+		//Rotate the ring in place to start with the oldest output, then start at a line
+		//boundary as the oldest line is truncated
+		size_t offset = history.total % history.capacity;
+		_log_recorder_reverse(buffer, offset);
+		_log_recorder_reverse(buffer + offset, length - offset);
+		_log_recorder_reverse(buffer, length);
+		while ((start < length) && (buffer[start] != '\n'))
+			++start;
+		if (start < length)
+			++start;
+		memmove(buffer, buffer + start, length - start);
+		length -= start;
+	}
+	buffer[length] = 0;
+	return (string_t) {buffer, length};
+}
+
+void
+log_set_binary_stream(stream_t* stream) {
+	log_flush();
+
+	lock_lock(&_log_binary_lock);
+	_log_binary_stream = stream;
+	memset(_log_binary_format, 0, sizeof(_log_binary_format));
+	atomic_store32(&_log_binary_format_count, 0);
+	if (stream) {
+		log_buffer_t header;
+		_log_buffer_initialize(&header);
+		_log_buffer_append(&header, "FLOG", 4);
+		_log_buffer_append_uint(&header, LOG_BINARY_VERSION);
+		_log_buffer_append_uint(&header, FOUNDATION_ARCH_ENDIAN_LITTLE ? 0 : 1);
+		_log_buffer_append_uint(&header, (uint64_t)time_ticks_per_second());
+		stream_write(stream, header.data, header.size);
+		_log_buffer_finalize(&header);
+	}
+	lock_unlock(&_log_binary_lock);
+}
+
+stream_t*
+log_binary_stream(void) {
+	return _log_binary_stream;
+}
+
+size_t
+log_binary_expand(stream_t* input, stream_t* output) {
+	log_format_t* format = 0;
+	log_arg_t arg[LOG_BINARY_ARGS];
+	log_buffer_t line;
+	char magic[4];
+	tick_t ticks_per_second;
+	size_t messages = 0;
+	size_t iformat;
+	bool swap;
+
+	if ((stream_read(input, magic, sizeof(magic)) != sizeof(magic)) ||
+	        !string_equal(magic, sizeof(magic), STRING_CONST("FLOG")) ||
+	        (_log_binary_read_uint(input) != LOG_BINARY_VERSION))
+		return 0;
+	swap = (_log_binary_read_uint(input) != (FOUNDATION_ARCH_ENDIAN_LITTLE ? 0 : 1));
+	ticks_per_second = (tick_t)_log_binary_read_uint(input);
+
+	_log_buffer_initialize(&line);
+	while (!stream_eos(input)) {
+		uint64_t type = _log_binary_read_uint(input);
+		uint64_t id = _log_binary_read_uint(input);
+		log_format_t* entry;
+
+		if (type == LOG_BINARY_RECORD_FORMAT) {
+			size_t count = array_size(format);
+			if (id >= count) {
+				array_resize(format, (size_t)id + 1);
+				memset(format + count, 0, sizeof(log_format_t) * ((size_t)id + 1 - count));
+			}
+			entry = format + id;
+			entry->argc = (int)_log_binary_read_uint(input);
+			if (entry->argc > LOG_BINARY_ARGS)
+				break;
+			stream_read(input, entry->type, (size_t)entry->argc);
+			entry->length = (size_t)_log_binary_read_uint(input);
+			if (entry->string)
+				memory_deallocate(entry->string);
+			entry->string = memory_allocate(0, entry->length + 1, 0, MEMORY_PERSISTENT);
+			stream_read(input, entry->string, entry->length);
+			entry->string[entry->length] = 0;
+		}
+		else if ((type == LOG_BINARY_RECORD_MESSAGE) && (id < array_size(format)) &&
+		         format[id].string) {
+			error_level_t severity = (error_level_t)_log_binary_read_uint(input);
+			unsigned int code = (unsigned int)_log_binary_read_uint(input);
+			hash_t context;
+			log_timestamp_t timestamp;
+			uint64_t tid;
+			unsigned int pid;
+			int iarg;
+
+			entry = format + id;
+			_log_binary_read_raw(input, &context, sizeof(context), swap);
+			timestamp = _log_timestamp((tick_t)_log_binary_read_uint(input), ticks_per_second);
+			tid = _log_binary_read_uint(input);
+			pid = (unsigned int)_log_binary_read_uint(input);
+
+			for (iarg = 0; iarg < entry->argc; ++iarg) {
+				switch (entry->type[iarg]) {
+				case LOG_BINARY_ARG_INT32:
+					_log_binary_read_raw(input, &arg[iarg].i32, sizeof(int32_t), swap);
+					break;
+				case LOG_BINARY_ARG_INT64:
+					_log_binary_read_raw(input, &arg[iarg].i64, sizeof(int64_t), swap);
+					break;
+				case LOG_BINARY_ARG_DOUBLE:
+					_log_binary_read_raw(input, &arg[iarg].f64, sizeof(double), swap);
+					break;
+				case LOG_BINARY_ARG_POINTER:
+					_log_binary_read_raw(input, &arg[iarg].ptr, sizeof(uint64_t), swap);
+					break;
+				default: {
+						size_t length = (size_t)_log_binary_read_uint(input);
+						arg[iarg].str = memory_allocate(0, length + 1, 0, MEMORY_TEMPORARY);
+						stream_read(input, arg[iarg].str, length);
+						arg[iarg].str[length] = 0;
+						break;
+					}
+				}
+			}
+
+			line.size = 0;
+			_log_binary_expand_line(&line, entry, severity, code, timestamp, tid, pid, arg);
+			stream_write(output, line.data, line.size);
+			++messages;
+
+			for (iarg = 0; iarg < entry->argc; ++iarg) {
+				if (entry->type[iarg] >= LOG_BINARY_ARG_STRING)
+					memory_deallocate(arg[iarg].str);
+			}
+		}
+		else {
+			//Corrupt or truncated log
+			break;
+		}
+	}
+
+	for (iformat = 0; iformat < array_size(format); ++iformat) {
+		if (format[iformat].string)
+			memory_deallocate(format[iformat].string);
+	}
+	array_deallocate(format);
+	_log_buffer_finalize(&line);
+
+	return messages;
+}
+
 void
 log_enable_prefix(bool enable) {
 	_log_prefix = enable;
 }
 
+static void
+_log_level_invalidate(void) {
+	//Generation zero is reserved for the zero initialized cache, entries cached with the
+	//same generation before wrapping around must not be reused
+	if (!(atomic_incr32(&_log_level_generation) & 0xFFFFF)) {
+		memset(_log_level_cache, 0, sizeof(_log_level_cache));
+		atomic_incr32(&_log_level_generation);
+	}
+}
+
 void
 log_set_suppress(hash_t context, error_level_t level) {
 	if (!context)
 		_log_suppress_default = level;
 	else if (_log_suppress)
 		hashtable64_set(_log_suppress, context, (unsigned int)(level + 1));
+	_log_level_invalidate();
 }
 
 error_level_t
 log_suppress(hash_t context) {
-	if (!context)
-		return _log_suppress_default;
-	else if (_log_suppress) {
-		uint64_t level = hashtable64_get(_log_suppress, context);
-		if (level > 0)
-			return (error_level_t)(level - 1);
+	//Load generation before level, a concurrent change after this point will invalidate
+	//the entry stored below
+	uint64_t generation = (uint64_t)atomic_load32_explicit(&_log_level_generation,
+	                                                       MEMORY_ORDER_ACQUIRE) & 0xFFFFF;
+	error_level_t level = _log_suppress_default;
+	if (context && _log_suppress) {
+		uint64_t value = hashtable64_get(_log_suppress, context);
+		if (value > 0)
+			level = (error_level_t)(value - 1);
+	}
+	if (generation) {
+		uint64_t key = LOG_LEVEL_CACHE_KEY(context);
+		uint64_t entry = (key & ~(uint64_t)0xFFFFFF) | (generation << 4) | (uint64_t)level;
+		atomic_store64_explicit(_log_level_cache + ((key >> 24) & (LOG_LEVEL_CACHE_SIZE - 1)),
+		                        (int64_t)entry, MEMORY_ORDER_RELAXED);
 	}
-	return _log_suppress_default;
+	return level;
 }
 
 void
@@ -381,6 +2058,59 @@ log_suppress_clear(void) {
 	_log_suppress_default = ERRORLEVEL_NONE;
 	if (_log_suppress)
 		hashtable64_clear(_log_suppress);
+	_log_level_invalidate();
+}
+
+void
+log_set_rate_limit(hash_t context, unsigned int rate, unsigned int burst) {
+	log_limit_t* limit;
+	uint64_t slot = 0;
+	tick_t interval;
+
+	if (context) {
+		if (!_log_limit)
+			return;
+		slot = hashtable64_get(_log_limit, context);
+		if (!slot) {
+			if (atomic_load32(&_log_limit_count) >= LOG_RATE_LIMITS) {
+				log_warnf(0, WARNING_MEMORY,
+				          STRING_CONST("Unable to set log rate limit, out of slots (%d)"),
+				          LOG_RATE_LIMITS);
+				return;
+			}
+			limit = _log_limits + atomic_incr32(&_log_limit_count) - 1;
+			memset(limit, 0, sizeof(log_limit_t));
+		}
+		else {
+			limit = _log_limits + (slot - 1);
+		}
+	}
+	else {
+		limit = &_log_limit_default;
+	}
+
+	interval = rate ? (time_ticks_per_second() / (tick_t)rate) : 0;
+	if (rate && !interval)
+		interval = 1;
+	if (!burst)
+		burst = rate ? rate : 1;
+	limit->tolerance = interval * (tick_t)(burst - 1);
+	limit->interval = interval;
+
+	if (!slot && context)
+		hashtable64_set(_log_limit, context, (uint64_t)(limit - _log_limits) + 1);
+	if (rate)
+		_log_limit_active = true;
+}
+
+void
+log_rate_limit_clear(void) {
+	_log_limit_active = false;
+	memset(&_log_limit_default, 0, sizeof(_log_limit_default));
+	memset(_log_limits, 0, sizeof(_log_limits));
+	atomic_store32(&_log_limit_count, 0);
+	if (_log_limit)
+		hashtable64_clear(_log_limit);
 }
 
 #endif
@@ -389,6 +2119,9 @@ int
 _log_initialize(void) {
 #if BUILD_ENABLE_LOG
 	_log_suppress = hashtable64_allocate(149);
+	_log_limit = hashtable64_allocate(149);
+	memset(_log_level_cache, 0, sizeof(_log_level_cache));
+	atomic_store32(&_log_level_generation, 1);
 #endif
 	return 0;
 }
@@ -398,6 +2131,40 @@ _log_finalize(void) {
 #if BUILD_ENABLE_LOG
 	hashtable64_deallocate(_log_suppress);
 	_log_suppress = 0;
+	hashtable64_deallocate(_log_limit);
+	_log_limit = 0;
+	_log_limit_active = false;
+	_log_binary_stream = 0;
+
+	//Other threads have exited and released their rings
+	log_enable_recorder(0);
+	set_thread_log_recorder(0);
+	{
+		log_recorder_t* recorder = atomic_loadptr(&_log_recorder_list);
+		size_t iformat;
+		while (recorder) {
+			log_recorder_t* next = recorder->next;
+			memory_deallocate(recorder);
+			recorder = next;
+		}
+		atomic_storeptr(&_log_recorder_list, 0);
+		for (iformat = 0; iformat < LOG_BINARY_FORMATS; ++iformat) {
+			if (_log_recorder_format[iformat].string)
+				memory_deallocate(_log_recorder_format[iformat].string);
+		}
+		memset(_log_recorder_format, 0, sizeof(_log_recorder_format));
+	}
+#endif
+}
+
+void
+_log_thread_finalize(void) {
+#if BUILD_ENABLE_LOG
+	log_recorder_t* recorder = get_thread_log_recorder();
+	if (recorder) {
+		atomic_store32(&recorder->owned, 0);
+		set_thread_log_recorder(0);
+	}
 #endif
 }
 
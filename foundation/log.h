@@ -27,11 +27,20 @@ Using different function calls for different log levels allows build-time contol
 generation. Disabling log debug message build flag would make all log_debug/log_debugf calls
 to be statically removed at compile time instead of filtered at runtime, reducing binary
 size and call overhead. By enabling the build flag and instead using a log context level
-filter a runtime selection of log messages can be selected instead. */
+filter a runtime selection of log messages can be selected instead.
+
+For finer build-time control, #BUILD_LOG_LEVEL sets a minimum severity for debug, info and
+warning messages. The debug, info and warning log calls are macros checking the minimum
+level and the runtime suppression level of the context before the arguments are evaluated,
+the runtime level is resolved from a cache without calling into the library. Messages
+filtered by either level therefore cost no argument evaluation, formatting or function call.
+The context argument is evaluated exactly once, the remaining arguments only if the message
+passes the filters. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
 #include <foundation/error.h>
+#include <foundation/atomic.h>
 
 #if BUILD_ENABLE_LOG && BUILD_ENABLE_DEBUG_LOG
 
@@ -155,6 +164,126 @@ log_enable_stdout(bool enable);
 FOUNDATION_API void
 log_enable_prefix(bool enable);
 
+/*! Control asynchronous logging. When enabled, messages are formatted on the calling thread
+and queued for output on a background log thread, keeping blocking I/O off the caller.
+Panic messages are always output synchronously after flushing queued messages. Disabling
+asynchronous logging flushes the queue and terminates the log thread.
+\param enable Flag to enable/disable asynchronous logging
+\param capacity Maximum number of queued messages, 0 for default (4096)
+\param block Flag to block the calling thread until space is available when the queue is
+             full, if false the message is dropped and counted */
+FOUNDATION_API void
+log_enable_async(bool enable, size_t capacity, bool block);
+
+/*! Wait until all queued messages have been output, flush the standard streams and write
+any buffered log file data */
+FOUNDATION_API void
+log_flush(void);
+
+/*! Set log file. Messages are appended to the file through a write buffer, so the file is
+written in large batches rather than once per message. Buffered data is written when the
+buffer is full, when the flush interval has elapsed, on #log_flush and when the file is
+closed, and after error messages depending on the synchronization policy. The file is
+rotated by size and/or age, renaming the file to "<path>.1" and shifting older rotated
+files up one index. Enable asynchronous logging with #log_enable_async to do all file I/O
+and periodic flushing on the log thread, otherwise the thread outputting a message does
+the I/O and buffered data is written by the next message after the flush interval.
+Passing a null path closes the current log file. Should not be called while other threads
+are logging.
+\param path Log file path, null to close current log file
+\param length Length of path
+\param config Configuration, null for default configuration
+\return true if successful, false if the log file could not be opened */
+FOUNDATION_API bool
+log_set_file(const char* path, size_t length, const log_file_config_t* config);
+
+/*! Get number of messages dropped due to a full queue in asynchronous logging and not yet
+reported. Dropped messages are reported with a warning by the log thread.
+\return Number of dropped messages */
+FOUNDATION_API uint64_t
+log_async_dropped(void);
+
+/*! Get the most recent log output, up to the last 16KiB, starting at a line boundary. Output
+is recorded regardless of stdout, file and callback settings. The function only copies memory
+and is safe to call from a signal handler, for example when writing a crash dump.
+\param buffer Destination buffer
+\param capacity Capacity of buffer
+\return Most recent log output, empty string if none */
+FOUNDATION_API string_t
+log_history(char* buffer, size_t capacity);
+
+/*! Enable the log flight recorder. While enabled, every debug, info, warning, error and panic
+message is recorded regardless of suppression and rate limits into a fixed size in-memory ring
+per thread as a binary record with the raw argument values, the same encoding as binary log
+output. Nothing is formatted until the records are expanded with #log_recorder_dump or
+#log_recorder_history, which is done on assert failures and in crash dumps written by
+#crash_guard. The oldest records of a thread are overwritten when its ring is full and string
+arguments are truncated to 256 characters. Rings of exited threads are kept and reused by new
+threads. Note that the header macros pass all messages to the log functions while the recorder
+is enabled, see #log_enabled.
+\param size Size of ring per thread in bytes, minimum 16KiB, zero to disable */
+FOUNDATION_API void
+log_enable_recorder(size_t size);
+
+/*! Get size of the log flight recorder ring per thread
+\return Size of ring in bytes, zero if the flight recorder is disabled */
+FOUNDATION_API size_t
+log_recorder_size(void);
+
+/*! Expand the messages recorded by the log flight recorder in all threads to text lines in
+the same format as text log output, merged in timestamp order with the oldest first. Messages
+recorded concurrently may be skipped if overwritten while expanding.
+\param stream Text output stream
+\return Number of expanded messages */
+FOUNDATION_API size_t
+log_recorder_dump(stream_t* stream);
+
+/*! Expand the most recent messages recorded by the log flight recorder to text lines, like
+#log_recorder_dump, keeping the output that fits in the buffer starting at a line boundary. The
+function does not allocate memory unless a single line expands to more than 2KiB, and is used
+when writing a crash dump from a signal handler.
+\param buffer Destination buffer
+\param capacity Capacity of buffer
+\return Most recent recorded messages, empty string if none */
+FOUNDATION_API string_t
+log_recorder_history(char* buffer, size_t capacity);
+
+/*! Set binary log output stream. While set, debug, info, warning and error messages are
+not formatted but written to the stream as compact binary records containing the format
+string identifier and the raw argument values, deferring all formatting to
+#log_binary_expand. Each format string is written once, identified by its address, so the
+format strings must be constant. Messages using unsupported conversions (%n, wide strings
+and long double) and panic messages are output as text as usual. Combined with
+asynchronous logging the records are written to the stream by the log thread.
+
+The stream starts with the four bytes "FLOG" followed by LEB128 variable length integers
+for the version (1), byte order of raw values (0 for little endian, 1 for big endian) and
+ticks per second. Each record starts with the record type and format identifier. A format
+record (type 1) continues with the argument count, one byte per argument type, the format
+string length and the format string. A message record (type 2) continues with severity,
+warning or error code, raw 64-bit context hash, ticks since startup, thread id, hardware
+thread and the raw argument values, where strings are stored as length and characters.
+
+Should not be called while other threads are logging. Passing a null pointer stops binary
+logging. The stream must remain valid until then.
+\param stream Binary log stream, null to disable binary logging */
+FOUNDATION_API void
+log_set_binary_stream(stream_t* stream);
+
+/*! Get current binary log output stream
+\return Binary log stream, null if binary logging is disabled */
+FOUNDATION_API stream_t*
+log_binary_stream(void);
+
+/*! Expand binary log records to text lines in the same format as text log output, using
+the current prefix setting. Reads from the current position until the end of the input
+stream or until a truncated or corrupt record.
+\param input Binary log input stream
+\param output Text output stream
+\return Number of expanded messages */
+FOUNDATION_API size_t
+log_binary_expand(stream_t* input, stream_t* output);
+
 /*! Control log suppression based on severity level. Any messages at the
 given severity level or lower will be filtered and discarded. If a log context
 has no explicit supression level the default (0) context supression level will be used.
@@ -173,6 +302,93 @@ log_suppress(hash_t context);
 FOUNDATION_API void
 log_suppress_clear(void);
 
+/*! Query if a message with the given severity in the given context passes the build time
+minimum level (#BUILD_LOG_LEVEL) and the runtime suppression level of the context. The
+suppression level is resolved from a cache, only calling log_suppress if the context is not
+cached or the suppression levels changed since it was cached. Rate limiting is not checked.
+While the log flight recorder is enabled all messages passing the build time level pass.
+\param context Log context
+\param severity Severity level
+\return true if message passes the suppression level, false if discarded */
+static FOUNDATION_FORCEINLINE bool
+log_enabled(hash_t context, error_level_t severity);
+
+/*! Limit the rate of log messages for the given context with a token bucket. Messages
+exceeding the rate are discarded before any formatting is done, and the number of discarded
+messages is output as a summary with the next message passing the limit. If a log context
+has no explicit limit the default (0) context limit is used, shared by all such contexts.
+Panic messages are never rate limited. Should not be called while other threads are logging
+in the given context.
+\param context Log context
+\param rate Maximum sustained number of messages per second, 0 for no limit (an explicit
+            context is then not limited by the default context limit either)
+\param burst Maximum number of messages in a burst, 0 for same as rate */
+FOUNDATION_API void
+log_set_rate_limit(hash_t context, unsigned int rate, unsigned int burst);
+
+/*! Clear rate limits for all contexts */
+FOUNDATION_API void
+log_rate_limit_clear(void);
+
+/*! Number of entries in the context suppression level cache, must be a power of two */
+#define LOG_LEVEL_CACHE_SIZE 256
+
+/*! Context suppression level cache used by log_enabled, private to the log module. The
+context hash is scrambled by multiplication with an odd constant so contexts differing only
+in the low bits map to different entries. Each entry stores the upper 40 bits of the
+scrambled context, the low 20 bits of the cache generation in the next 20 bits and the
+suppression level in the low 4 bits. */
+FOUNDATION_API atomic64_t _log_level_cache[LOG_LEVEL_CACHE_SIZE];
+
+/*! Generation of the context suppression level cache, private to the log module. Changed
+whenever any suppression level changes, invalidating all cached entries. */
+FOUNDATION_API atomic32_t _log_level_generation;
+
+/*! Flag set while the log flight recorder is enabled, private to the log module */
+FOUNDATION_API atomic32_t _log_recorder_active;
+
+/*! Scramble context for the suppression level cache */
+#define LOG_LEVEL_CACHE_KEY(context) ((uint64_t)(context) * 0x9E3779B97F4A7C15ULL)
+
+static FOUNDATION_FORCEINLINE bool
+log_enabled(hash_t context, error_level_t severity) {
+	uint64_t key, entry, tag;
+	if ((int)severity < BUILD_LOG_LEVEL)
+		return false;
+	//Flight recorder records suppressed messages
+	if (atomic_load32_explicit(&_log_recorder_active, MEMORY_ORDER_RELAXED))
+		return true;
+	key = LOG_LEVEL_CACHE_KEY(context);
+	entry = (uint64_t)atomic_load64_explicit(_log_level_cache +
+	                                         ((key >> 24) & (LOG_LEVEL_CACHE_SIZE - 1)),
+	                                         MEMORY_ORDER_RELAXED);
+	tag = (key & ~(uint64_t)0xFFFFFF) |
+	      ((uint64_t)(atomic_load32_explicit(&_log_level_generation, MEMORY_ORDER_RELAXED) &
+	                  0xFFFFF) << 4);
+	if ((entry & ~(uint64_t)0xF) == tag)
+		return (error_level_t)(entry & 0xF) < severity;
+	return log_suppress(context) < severity;
+}
+
+/*! Call log function only if message passes log_enabled, evaluating the context once and
+the remaining arguments only if enabled. Used by the debug, info and warning log macros. */
+#define LOG_ENABLED_CALL(fn, level, context, ...) do { hash_t log_context_ = (context); \
+	if (log_enabled(log_context_, level)) (fn)(log_context_, __VA_ARGS__); } while(0)
+
+#if BUILD_ENABLE_DEBUG_LOG
+
+#define log_debug(context, ...) LOG_ENABLED_CALL(log_debug, ERRORLEVEL_DEBUG, context, __VA_ARGS__)
+#define log_debugf(context, ...) \
+	LOG_ENABLED_CALL(log_debugf, ERRORLEVEL_DEBUG, context, __VA_ARGS__)
+
+#endif
+
+#define log_info(context, ...) LOG_ENABLED_CALL(log_info, ERRORLEVEL_INFO, context, __VA_ARGS__)
+#define log_infof(context, ...) LOG_ENABLED_CALL(log_infof, ERRORLEVEL_INFO, context, __VA_ARGS__)
+#define log_warn(context, ...) LOG_ENABLED_CALL(log_warn, ERRORLEVEL_WARNING, context, __VA_ARGS__)
+#define log_warnf(context, ...) \
+	LOG_ENABLED_CALL(log_warnf, ERRORLEVEL_WARNING, context, __VA_ARGS__)
+
 #endif
 
 #if !BUILD_ENABLE_LOG || !BUILD_ENABLE_DEBUG_LOG
@@ -211,8 +427,23 @@ log_suppress_clear(void);
 #define log_set_callback(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define log_enable_stdout(enable) do { FOUNDATION_UNUSED(enable); } while(0)
 #define log_enable_prefix(enable) do { FOUNDATION_UNUSED(enable); } while(0)
+#define log_enable_async(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define log_flush() do {} while(0)
+#define log_set_file(path, length, config) ((void)sizeof(path), (void)sizeof(length), (void)sizeof(config), false)
+#define log_async_dropped() 0
+#define log_history(buffer, capacity) ((void)sizeof(capacity), string((buffer), 0))
+#define log_enable_recorder(size) do { FOUNDATION_UNUSED(size); } while(0)
+#define log_recorder_size() 0
+#define log_recorder_dump(stream) ((void)sizeof(stream), 0)
+#define log_recorder_history(buffer, capacity) ((void)sizeof(capacity), string((buffer), 0))
+#define log_set_binary_stream(stream) do { FOUNDATION_UNUSED(stream); } while(0)
+#define log_binary_stream() 0
+#define log_binary_expand(input, output) ((void)sizeof(input), (void)sizeof(output), 0)
 #define log_set_suppress(context, level) do { FOUNDATION_UNUSED(context); FOUNDATION_UNUSED(level); } while(0)
 #define log_suppress(context) ERRORLEVEL_NONE
+#define log_enabled(context, severity) ((void)sizeof(context), (void)sizeof(severity), false)
 #define log_suppress_clear() do {} while(0)
+#define log_set_rate_limit(context, rate, burst) do { FOUNDATION_UNUSED(context); FOUNDATION_UNUSED(rate); FOUNDATION_UNUSED(burst); } while(0)
+#define log_rate_limit_clear() do {} while(0)
 
 #endif
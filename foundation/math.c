@@ -0,0 +1,600 @@
+/* math.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  include <emmintrin.h>
+#  include <immintrin.h>
+#  if defined(__AVX2__)
+#    define MATH_BATCH_AVX2 1
+#  else
+#    define MATH_BATCH_SSE2 1
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define MATH_BATCH_NEON 1
+#  include <arm_neon.h>
+#endif
+
+//The batch kernels are written once against the lane operations below. The lane width is
+//selected at compile time, AVX2 is used when the library is built with AVX2 enabled
+#if MATH_BATCH_AVX2
+
+#define MATH_BATCH_SIMD 1
+#define MATHV_LANES            8
+#define MATHD_LANES            4
+typedef __m256  mathv_t;
+typedef __m256i mathvi_t;
+typedef __m256d mathd_t;
+
+#define MATHV_SET(v)           _mm256_set1_ps(v)
+#define MATHV_LOAD(p)          _mm256_loadu_ps(p)
+#define MATHV_STORE(p, a)      _mm256_storeu_ps(p, a)
+#define MATHV_ADD(a, b)        _mm256_add_ps(a, b)
+#define MATHV_SUB(a, b)        _mm256_sub_ps(a, b)
+#define MATHV_MUL(a, b)        _mm256_mul_ps(a, b)
+#define MATHV_DIV(a, b)        _mm256_div_ps(a, b)
+#if defined(__FMA__)
+#define MATHV_MADD(a, b, c)    _mm256_fmadd_ps(a, b, c)
+#else
+#define MATHV_MADD(a, b, c)    _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+#define MATHV_MIN(a, b)        _mm256_min_ps(a, b)
+#define MATHV_MAX(a, b)        _mm256_max_ps(a, b)
+#define MATHV_AND(a, b)        _mm256_and_ps(a, b)
+#define MATHV_OR(a, b)         _mm256_or_ps(a, b)
+#define MATHV_XOR(a, b)        _mm256_xor_ps(a, b)
+#define MATHV_LT(a, b)         _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define MATHV_LE(a, b)         _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define MATHV_EQ(a, b)         _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+#define MATHV_SELECT(m, a, b)  _mm256_blendv_ps(b, a, m)
+#define MATHV_ALL(m)           (_mm256_movemask_ps(m) == 0xFF)
+#define MATHV_SQRT(a)          _mm256_sqrt_ps(a)
+#define MATHV_RSQRT(a)         _mm256_rsqrt_ps(a)
+#define MATHV_ROUND(a)         _mm256_cvtps_epi32(a)
+#define MATHV_FROM_INT(i)      _mm256_cvtepi32_ps(i)
+#define MATHV_AS_INT(a)        _mm256_castps_si256(a)
+#define MATHV_FROM_BITS(i)     _mm256_castsi256_ps(i)
+#define MATHVI_SET(v)          _mm256_set1_epi32(v)
+#define MATHVI_ADD(a, b)       _mm256_add_epi32(a, b)
+#define MATHVI_SUB(a, b)       _mm256_sub_epi32(a, b)
+#define MATHVI_AND(a, b)       _mm256_and_si256(a, b)
+#define MATHVI_OR(a, b)        _mm256_or_si256(a, b)
+#define MATHVI_EQ(a, b)        _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))
+#define MATHVI_SHL(a, n)       _mm256_slli_epi32(a, n)
+#define MATHVI_SHR(a, n)       _mm256_srli_epi32(a, n)
+#define MATHVI_SRA(a, n)       _mm256_srai_epi32(a, n)
+#define MATHD_SET(v)           _mm256_set1_pd(v)
+#define MATHD_LOAD(p)          _mm256_loadu_pd(p)
+#define MATHD_STORE(p, a)      _mm256_storeu_pd(p, a)
+#define MATHD_DIV(a, b)        _mm256_div_pd(a, b)
+#define MATHD_SQRT(a)          _mm256_sqrt_pd(a)
+
+#elif MATH_BATCH_SSE2
+
+#define MATH_BATCH_SIMD 1
+#define MATHV_LANES            4
+#define MATHD_LANES            2
+typedef __m128  mathv_t;
+typedef __m128i mathvi_t;
+typedef __m128d mathd_t;
+
+#define MATHV_SET(v)           _mm_set1_ps(v)
+#define MATHV_LOAD(p)          _mm_loadu_ps(p)
+#define MATHV_STORE(p, a)      _mm_storeu_ps(p, a)
+#define MATHV_ADD(a, b)        _mm_add_ps(a, b)
+#define MATHV_SUB(a, b)        _mm_sub_ps(a, b)
+#define MATHV_MUL(a, b)        _mm_mul_ps(a, b)
+#define MATHV_DIV(a, b)        _mm_div_ps(a, b)
+#if defined(__FMA__)
+#define MATHV_MADD(a, b, c)    _mm_fmadd_ps(a, b, c)
+#else
+#define MATHV_MADD(a, b, c)    _mm_add_ps(_mm_mul_ps(a, b), c)
+#endif
+#define MATHV_MIN(a, b)        _mm_min_ps(a, b)
+#define MATHV_MAX(a, b)        _mm_max_ps(a, b)
+#define MATHV_AND(a, b)        _mm_and_ps(a, b)
+#define MATHV_OR(a, b)         _mm_or_ps(a, b)
+#define MATHV_XOR(a, b)        _mm_xor_ps(a, b)
+#define MATHV_LT(a, b)         _mm_cmplt_ps(a, b)
+#define MATHV_LE(a, b)         _mm_cmple_ps(a, b)
+#define MATHV_EQ(a, b)         _mm_cmpeq_ps(a, b)
+#define MATHV_SELECT(m, a, b)  _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define MATHV_ALL(m)           (_mm_movemask_ps(m) == 0xF)
+#define MATHV_SQRT(a)          _mm_sqrt_ps(a)
+#define MATHV_RSQRT(a)         _mm_rsqrt_ps(a)
+#define MATHV_ROUND(a)         _mm_cvtps_epi32(a)
+#define MATHV_FROM_INT(i)      _mm_cvtepi32_ps(i)
+#define MATHV_AS_INT(a)        _mm_castps_si128(a)
+#define MATHV_FROM_BITS(i)     _mm_castsi128_ps(i)
+#define MATHVI_SET(v)          _mm_set1_epi32(v)
+#define MATHVI_ADD(a, b)       _mm_add_epi32(a, b)
+#define MATHVI_SUB(a, b)       _mm_sub_epi32(a, b)
+#define MATHVI_AND(a, b)       _mm_and_si128(a, b)
+#define MATHVI_OR(a, b)        _mm_or_si128(a, b)
+#define MATHVI_EQ(a, b)        _mm_castsi128_ps(_mm_cmpeq_epi32(a, b))
+#define MATHVI_SHL(a, n)       _mm_slli_epi32(a, n)
+#define MATHVI_SHR(a, n)       _mm_srli_epi32(a, n)
+#define MATHVI_SRA(a, n)       _mm_srai_epi32(a, n)
+#define MATHD_SET(v)           _mm_set1_pd(v)
+#define MATHD_LOAD(p)          _mm_loadu_pd(p)
+#define MATHD_STORE(p, a)      _mm_storeu_pd(p, a)
+#define MATHD_DIV(a, b)        _mm_div_pd(a, b)
+#define MATHD_SQRT(a)          _mm_sqrt_pd(a)
+
+#elif MATH_BATCH_NEON
+
+#define MATH_BATCH_SIMD 1
+#define MATHV_LANES            4
+#define MATHD_LANES            2
+typedef float32x4_t mathv_t;
+typedef int32x4_t   mathvi_t;
+typedef float64x2_t mathd_t;
+
+#define MATHV_BITS(a)          vreinterpretq_u32_f32(a)
+#define MATHV_MASK(m)          vreinterpretq_f32_u32(m)
+
+#define MATHV_SET(v)           vdupq_n_f32(v)
+#define MATHV_LOAD(p)          vld1q_f32(p)
+#define MATHV_STORE(p, a)      vst1q_f32(p, a)
+#define MATHV_ADD(a, b)        vaddq_f32(a, b)
+#define MATHV_SUB(a, b)        vsubq_f32(a, b)
+#define MATHV_MUL(a, b)        vmulq_f32(a, b)
+#define MATHV_DIV(a, b)        vdivq_f32(a, b)
+#define MATHV_MADD(a, b, c)    vfmaq_f32(c, a, b)
+#define MATHV_MIN(a, b)        vminq_f32(a, b)
+#define MATHV_MAX(a, b)        vmaxq_f32(a, b)
+#define MATHV_AND(a, b)        MATHV_MASK(vandq_u32(MATHV_BITS(a), MATHV_BITS(b)))
+#define MATHV_OR(a, b)         MATHV_MASK(vorrq_u32(MATHV_BITS(a), MATHV_BITS(b)))
+#define MATHV_XOR(a, b)        MATHV_MASK(veorq_u32(MATHV_BITS(a), MATHV_BITS(b)))
+#define MATHV_LT(a, b)         MATHV_MASK(vcltq_f32(a, b))
+#define MATHV_LE(a, b)         MATHV_MASK(vcleq_f32(a, b))
+#define MATHV_EQ(a, b)         MATHV_MASK(vceqq_f32(a, b))
+#define MATHV_SELECT(m, a, b)  vbslq_f32(MATHV_BITS(m), a, b)
+#define MATHV_ALL(m)           (vminvq_u32(MATHV_BITS(m)) != 0)
+#define MATHV_SQRT(a)          vsqrtq_f32(a)
+#define MATHV_RSQRT(a)         math_batch_rsqrt_estimate(a)
+#define MATHV_ROUND(a)         vcvtnq_s32_f32(a)
+#define MATHV_FROM_INT(i)      vcvtq_f32_s32(i)
+#define MATHV_AS_INT(a)        vreinterpretq_s32_f32(a)
+#define MATHV_FROM_BITS(i)     vreinterpretq_f32_s32(i)
+#define MATHVI_SET(v)          vdupq_n_s32(v)
+#define MATHVI_ADD(a, b)       vaddq_s32(a, b)
+#define MATHVI_SUB(a, b)       vsubq_s32(a, b)
+#define MATHVI_AND(a, b)       vandq_s32(a, b)
+#define MATHVI_OR(a, b)        vorrq_s32(a, b)
+#define MATHVI_EQ(a, b)        MATHV_MASK(vceqq_s32(a, b))
+#define MATHVI_SHL(a, n)       vshlq_n_s32(a, n)
+#define MATHVI_SHR(a, n)       vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), n))
+#define MATHVI_SRA(a, n)       vshrq_n_s32(a, n)
+#define MATHD_SET(v)           vdupq_n_f64(v)
+#define MATHD_LOAD(p)          vld1q_f64(p)
+#define MATHD_STORE(p, a)      vst1q_f64(p, a)
+#define MATHD_DIV(a, b)        vdivq_f64(a, b)
+#define MATHD_SQRT(a)          vsqrtq_f64(a)
+
+//The NEON estimate has 8 bits of precision, refine once to match the 12 bits of SSE
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_rsqrt_estimate(mathv_t x) {
+	mathv_t y = vrsqrteq_f32(x);
+	return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+}
+
+#endif
+
+#if MATH_BATCH_SIMD
+
+//Pi/2 split in three parts for Cody-Waite argument reduction, the products of the first
+//part with the quadrant are exact for arguments up to the reduction limit
+#define MATH_PIO2_1         1.5703125f
+#define MATH_PIO2_2         4.837512969970703125e-4f
+#define MATH_PIO2_3         7.54978995489188216e-8f
+#define MATH_2OPI           0.636619772367581343f
+//Largest argument reduced to full precision, vectors with larger arguments fall back to the
+//scalar math library
+#define MATH_SINCOS_LIMIT   2048.0f
+
+//Fast math lets the compiler reassociate steps that split a constant in parts, folding the
+//parts back together, pin each partial result in a register to keep the steps apart
+#if FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
+#  if MATH_BATCH_NEON
+#    define MATHV_PIN(a)      __asm__("" : "+w"(a))
+#  else
+#    define MATHV_PIN(a)      __asm__("" : "+x"(a))
+#  endif
+#else
+#  define MATHV_PIN(a)        ((void)(a))
+#endif
+
+//Natural logarithm of two split in two parts, the product of the first part with the
+//exponent is exact
+#define MATH_LN2_1          0.693359375f
+#define MATH_LN2_2          -2.12194440e-4f
+#define MATH_LOG2E          1.44269504088896341f
+#define MATH_SQRTHF         0.707106781186547524f
+
+typedef mathv_t (*math_batch_kernel_fn)(mathv_t x, math_accuracy_t accuracy);
+
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_abs(mathv_t x) {
+	return MATHV_AND(x, MATHV_FROM_BITS(MATHVI_SET(0x7FFFFFFF)));
+}
+
+static FOUNDATION_NOINLINE mathv_t
+math_batch_sincos_scalar(mathv_t x, bool cosine) {
+	FOUNDATION_ALIGN(32) float32_t lane[MATHV_LANES];
+	int ilane;
+	MATHV_STORE(lane, x);
+	for (ilane = 0; ilane < MATHV_LANES; ++ilane)
+		lane[ilane] = cosine ? cosf(lane[ilane]) : sinf(lane[ilane]);
+	return MATHV_LOAD(lane);
+}
+
+//Sine and cosine polynomials from Cephes sinf/cosf, valid on [-pi/4, pi/4]
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_sincos(mathv_t x, math_accuracy_t accuracy, bool cosine) {
+	mathvi_t quadrant;
+	mathv_t q, r, z, s, c, result;
+
+	if (!MATHV_ALL(MATHV_LE(math_batch_abs(x), MATHV_SET(MATH_SINCOS_LIMIT))))
+		return math_batch_sincos_scalar(x, cosine);
+
+	quadrant = MATHV_ROUND(MATHV_MUL(x, MATHV_SET(MATH_2OPI)));
+	q = MATHV_FROM_INT(quadrant);
+	r = MATHV_MADD(q, MATHV_SET(-MATH_PIO2_1), x);
+	MATHV_PIN(r);
+	r = MATHV_MADD(q, MATHV_SET(-MATH_PIO2_2), r);
+	MATHV_PIN(r);
+	r = MATHV_MADD(q, MATHV_SET(-MATH_PIO2_3), r);
+	if (cosine)
+		quadrant = MATHVI_ADD(quadrant, MATHVI_SET(1));
+	z = MATHV_MUL(r, r);
+
+	if (accuracy == MATH_ACCURACY_PRECISE) {
+		s = MATHV_MADD(z, MATHV_SET(-1.9515295891e-4f), MATHV_SET(8.3321608736e-3f));
+		s = MATHV_MADD(z, s, MATHV_SET(-1.6666654611e-1f));
+		c = MATHV_MADD(z, MATHV_SET(2.443315711809948e-5f), MATHV_SET(-1.388731625493765e-3f));
+		c = MATHV_MADD(z, c, MATHV_SET(4.166664568298827e-2f));
+	}
+	else {
+		s = MATHV_MADD(z, MATHV_SET(8.3321608736e-3f), MATHV_SET(-1.6666654611e-1f));
+		c = MATHV_MADD(z, MATHV_SET(-1.388731625493765e-3f), MATHV_SET(4.166664568298827e-2f));
+	}
+	s = MATHV_MADD(MATHV_MUL(r, z), s, r);
+	c = MATHV_MADD(MATHV_MUL(z, z), c, MATHV_MADD(z, MATHV_SET(-0.5f), MATHV_SET(1.0f)));
+
+	//Odd quadrants use the cosine polynomial, quadrants 2 and 3 negate the result
+	result = MATHV_SELECT(MATHVI_EQ(MATHVI_AND(quadrant, MATHVI_SET(1)), MATHVI_SET(1)), c, s);
+	return MATHV_XOR(result,
+	                 MATHV_FROM_BITS(MATHVI_SHL(MATHVI_AND(quadrant, MATHVI_SET(2)), 30)));
+}
+
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_sin(mathv_t x, math_accuracy_t accuracy) {
+	return math_batch_sincos(x, accuracy, false);
+}
+
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_cos(mathv_t x, math_accuracy_t accuracy) {
+	return math_batch_sincos(x, accuracy, true);
+}
+
+//Exponential polynomial from Cephes expf, valid on [-ln2/2, ln2/2]
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_exp(mathv_t x, math_accuracy_t accuracy) {
+	mathvi_t n, nhalf;
+	mathv_t clamped, nf, r, p, scale, result;
+
+	clamped = MATHV_MIN(MATHV_MAX(x, MATHV_SET(-104.0f)), MATHV_SET(89.0f));
+	n = MATHV_ROUND(MATHV_MUL(clamped, MATHV_SET(MATH_LOG2E)));
+	nf = MATHV_FROM_INT(n);
+	r = MATHV_MADD(nf, MATHV_SET(-MATH_LN2_1), clamped);
+	MATHV_PIN(r);
+	r = MATHV_MADD(nf, MATHV_SET(-MATH_LN2_2), r);
+
+	if (accuracy == MATH_ACCURACY_PRECISE) {
+		p = MATHV_MADD(r, MATHV_SET(1.9875691500e-4f), MATHV_SET(1.3981999507e-3f));
+		p = MATHV_MADD(r, p, MATHV_SET(8.3334519073e-3f));
+		p = MATHV_MADD(r, p, MATHV_SET(4.1665795894e-2f));
+	}
+	else {
+		p = MATHV_SET(4.1665795894e-2f);
+	}
+	p = MATHV_MADD(r, p, MATHV_SET(1.6666665459e-1f));
+	p = MATHV_MADD(r, p, MATHV_SET(5.0000001201e-1f));
+	p = MATHV_MADD(MATHV_MUL(r, r), p, MATHV_ADD(r, MATHV_SET(1.0f)));
+
+	//Scale by 2^n in two steps so results overflowing or in the denormal range are rounded
+	//once from a normal intermediate
+	nhalf = MATHVI_SRA(n, 1);
+	n = MATHVI_SUB(n, nhalf);
+	scale = MATHV_FROM_BITS(MATHVI_SHL(MATHVI_ADD(nhalf, MATHVI_SET(127)), 23));
+	result = MATHV_MUL(p, scale);
+	MATHV_PIN(result);
+	scale = MATHV_FROM_BITS(MATHVI_SHL(MATHVI_ADD(n, MATHVI_SET(127)), 23));
+	result = MATHV_MUL(result, scale);
+
+	return MATHV_SELECT(MATHV_EQ(x, x), result, x);
+}
+
+//Logarithm polynomial from Cephes logf for precise accuracy, and a short atanh series for
+//fast accuracy, both on mantissa in [sqrt(0.5), sqrt(2)]
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_log(mathv_t x, math_accuracy_t accuracy) {
+	mathvi_t bits, exponent;
+	mathv_t denormal, below, m, e, z, y, result;
+
+	//Scale denormals into the normal range and correct the exponent
+	denormal = MATHV_LT(x, MATHV_SET(FLT_MIN));
+	bits = MATHV_AS_INT(MATHV_SELECT(denormal, MATHV_MUL(x, MATHV_SET(8388608.0f)), x));
+	exponent = MATHVI_SUB(MATHVI_SHR(bits, 23), MATHVI_SET(126));
+	exponent = MATHVI_SUB(exponent, MATHVI_AND(MATHV_AS_INT(denormal), MATHVI_SET(23)));
+	m = MATHV_FROM_BITS(MATHVI_OR(MATHVI_AND(bits, MATHVI_SET(0x007FFFFF)),
+	                              MATHVI_SET(0x3F000000)));
+
+	//Mantissa in [0.5, 1), move the lower part to [1, 2) and subtract one
+	e = MATHV_FROM_INT(exponent);
+	below = MATHV_LT(m, MATHV_SET(MATH_SQRTHF));
+	e = MATHV_SUB(e, MATHV_AND(below, MATHV_SET(1.0f)));
+	m = MATHV_ADD(MATHV_SUB(m, MATHV_SET(1.0f)), MATHV_AND(below, m));
+
+	if (accuracy == MATH_ACCURACY_PRECISE) {
+		z = MATHV_MUL(m, m);
+		y = MATHV_MADD(m, MATHV_SET(7.0376836292e-2f), MATHV_SET(-1.1514610310e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(1.1676998740e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(-1.2420140846e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(1.4249322787e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(-1.6668057665e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(2.0000714765e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(-2.4999993993e-1f));
+		y = MATHV_MADD(m, y, MATHV_SET(3.3333331174e-1f));
+		y = MATHV_MUL(MATHV_MUL(m, z), y);
+		y = MATHV_MADD(e, MATHV_SET(MATH_LN2_2), y);
+		y = MATHV_MADD(z, MATHV_SET(-0.5f), y);
+		result = MATHV_ADD(m, y);
+	}
+	else {
+		//log(1 + m) = 2 atanh(s) with s = m / (2 + m)
+		mathv_t s = MATHV_DIV(m, MATHV_ADD(m, MATHV_SET(2.0f)));
+		z = MATHV_MUL(s, s);
+		y = MATHV_MADD(z, MATHV_SET(0.4f), MATHV_SET(0.666666666666666667f));
+		result = MATHV_MADD(MATHV_MUL(s, z), y, MATHV_ADD(s, s));
+		result = MATHV_MADD(e, MATHV_SET(MATH_LN2_2), result);
+	}
+	MATHV_PIN(result);
+	result = MATHV_MADD(e, MATHV_SET(MATH_LN2_1), result);
+
+	result = MATHV_SELECT(MATHV_EQ(x, MATHV_SET(0.0f)), MATHV_SET(-HUGE_VALF), result);
+	result = MATHV_SELECT(MATHV_LT(x, MATHV_SET(0.0f)), MATHV_SET(NAN), result);
+	result = MATHV_SELECT(MATHV_EQ(x, MATHV_SET(HUGE_VALF)), x, result);
+	return MATHV_SELECT(MATHV_EQ(x, x), result, x);
+}
+
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_sqrt(mathv_t x, math_accuracy_t accuracy) {
+	FOUNDATION_UNUSED(accuracy);
+	return MATHV_SQRT(x);
+}
+
+static FOUNDATION_FORCEINLINE mathv_t
+math_batch_rsqrt(mathv_t x, math_accuracy_t accuracy) {
+	mathv_t y, refined, normal;
+	if (accuracy == MATH_ACCURACY_PRECISE)
+		return MATHV_DIV(MATHV_SET(1.0f), MATHV_SQRT(x));
+	//One Newton-Raphson step on the estimate. The estimate treats denormals as zero and the
+	//step breaks down for zero and infinity, so vectors with such lanes use the precise path
+	y = MATHV_RSQRT(x);
+	refined = MATHV_MUL(MATHV_MUL(x, y), y);
+	refined = MATHV_MUL(MATHV_MUL(y, MATHV_SET(0.5f)), MATHV_SUB(MATHV_SET(3.0f), refined));
+	normal = MATHV_AND(MATHV_LE(MATHV_SET(FLT_MIN), x), MATHV_LT(x, MATHV_SET(HUGE_VALF)));
+	if (!MATHV_ALL(normal))
+		return MATHV_SELECT(normal, refined, MATHV_DIV(MATHV_SET(1.0f), MATHV_SQRT(x)));
+	return refined;
+}
+
+static FOUNDATION_FORCEINLINE void
+math_batch_apply32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy,
+                   math_batch_kernel_fn kernel) {
+	FOUNDATION_ALIGN(32) float32_t tail[MATHV_LANES];
+	size_t ival = 0;
+	for (; ival + MATHV_LANES <= count; ival += MATHV_LANES)
+		MATHV_STORE(out + ival, kernel(MATHV_LOAD(in + ival), accuracy));
+	if (ival < count) {
+		memset(tail, 0, sizeof(tail));
+		memcpy(tail, in + ival, sizeof(float32_t) * (count - ival));
+		MATHV_STORE(tail, kernel(MATHV_LOAD(tail), accuracy));
+		memcpy(out + ival, tail, sizeof(float32_t) * (count - ival));
+	}
+}
+
+void
+math_batch_sin32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_sin);
+}
+
+void
+math_batch_cos32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_cos);
+}
+
+void
+math_batch_exp32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_exp);
+}
+
+void
+math_batch_log32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_log);
+}
+
+void
+math_batch_sqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_sqrt);
+}
+
+void
+math_batch_rsqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	math_batch_apply32(out, in, count, accuracy, math_batch_rsqrt);
+}
+
+void
+math_batch_sqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival = 0;
+	FOUNDATION_UNUSED(accuracy);
+	for (; ival + MATHD_LANES <= count; ival += MATHD_LANES)
+		MATHD_STORE(out + ival, MATHD_SQRT(MATHD_LOAD(in + ival)));
+	for (; ival < count; ++ival)
+		out[ival] = sqrt(in[ival]);
+}
+
+void
+math_batch_rsqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival = 0;
+	FOUNDATION_UNUSED(accuracy);
+	for (; ival + MATHD_LANES <= count; ival += MATHD_LANES)
+		MATHD_STORE(out + ival, MATHD_DIV(MATHD_SET(1.0), MATHD_SQRT(MATHD_LOAD(in + ival))));
+	for (; ival < count; ++ival)
+		out[ival] = 1.0 / sqrt(in[ival]);
+}
+
+#else
+
+void
+math_batch_sin32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = sinf(in[ival]);
+}
+
+void
+math_batch_cos32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = cosf(in[ival]);
+}
+
+void
+math_batch_exp32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = expf(in[ival]);
+}
+
+void
+math_batch_log32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = logf(in[ival]);
+}
+
+void
+math_batch_sqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = sqrtf(in[ival]);
+}
+
+void
+math_batch_rsqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = 1.0f / sqrtf(in[ival]);
+}
+
+void
+math_batch_sqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = sqrt(in[ival]);
+}
+
+void
+math_batch_rsqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	FOUNDATION_UNUSED(accuracy);
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = 1.0 / sqrt(in[ival]);
+}
+
+#endif
+
+//Number of values converted to single precision per block in fast double precision functions
+#define MATH_BATCH_BLOCK 256
+
+static void
+math_batch_apply64(float64_t* out, const float64_t* in, size_t count,
+                   void (*batch32)(float32_t*, const float32_t*, size_t, math_accuracy_t)) {
+	float32_t block[MATH_BATCH_BLOCK];
+	size_t ival, iblock, num;
+	for (ival = 0; ival < count; ival += num) {
+		num = count - ival;
+		if (num > MATH_BATCH_BLOCK)
+			num = MATH_BATCH_BLOCK;
+		for (iblock = 0; iblock < num; ++iblock)
+			block[iblock] = (float32_t)in[ival + iblock];
+		batch32(block, block, num, MATH_ACCURACY_PRECISE);
+		for (iblock = 0; iblock < num; ++iblock)
+			out[ival + iblock] = (float64_t)block[iblock];
+	}
+}
+
+void
+math_batch_sin64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	if (accuracy == MATH_ACCURACY_FAST) {
+		math_batch_apply64(out, in, count, math_batch_sin32);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = sin(in[ival]);
+}
+
+void
+math_batch_cos64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	if (accuracy == MATH_ACCURACY_FAST) {
+		math_batch_apply64(out, in, count, math_batch_cos32);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = cos(in[ival]);
+}
+
+void
+math_batch_exp64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	if (accuracy == MATH_ACCURACY_FAST) {
+		math_batch_apply64(out, in, count, math_batch_exp32);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = exp(in[ival]);
+}
+
+void
+math_batch_log64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy) {
+	size_t ival;
+	if (accuracy == MATH_ACCURACY_FAST) {
+		math_batch_apply64(out, in, count, math_batch_log32);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival)
+		out[ival] = log(in[ival]);
+}
@@ -20,6 +20,9 @@
 Core math functionality, providing single entry points to common math
 functions across platforms and floating point notations used (32 or 64 bit real numbers).
 
+Batch functions apply sine, cosine, exponential, logarithm and square roots to arrays of
+values, using SSE/AVX/NEON instructions where available with a selectable accuracy.
+
 Increment/decrement and wrap functions from
 http://cellperformance.beyond3d.com/articles/2006/07/increment-and-decrement-wrapping-values.html */
 
@@ -593,6 +596,150 @@ FOUNDATION_DECLARE_DECREMENT_AND_WRAP(int32, int32_t,  int32_t, 31)
 FOUNDATION_DECLARE_DECREMENT_AND_WRAP(int64, int64_t,  int64_t, 63ULL)
 #undef FOUNDATION_DECLARE_DECREMENT_AND_WRAP
 
+/*!
+\fn math_batch_sin32
+\brief Batch sine
+\details Compute sine of an array of 32-bit floating point values with SSE/AVX/NEON
+instructions where available. The output array may be the same as the input array.
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_cos32
+\brief Batch cosine
+\details Compute cosine of an array of 32-bit floating point values, see #math_batch_sin32
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_exp32
+\brief Batch exponential
+\details Compute natural exponential of an array of 32-bit floating point values, see
+#math_batch_sin32
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_log32
+\brief Batch logarithm
+\details Compute natural logarithm of an array of 32-bit floating point values, see
+#math_batch_sin32
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_sqrt32
+\brief Batch square root
+\details Compute square root of an array of 32-bit floating point values, see
+#math_batch_sin32. Results are correctly rounded regardless of accuracy.
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_rsqrt32
+\brief Batch reciprocal square root
+\details Compute reciprocal square root of an array of 32-bit floating point values, see
+#math_batch_sin32. Fast accuracy refines the hardware estimate with a Newton-Raphson step.
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_sin64
+\brief Batch sine
+\details Compute sine of an array of 64-bit floating point values. Precise accuracy matches
+the scalar math library, fast accuracy evaluates the values in single precision with the range
+and accuracy of #math_batch_sin32. The output array may be the same as the input array.
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_cos64
+\brief Batch cosine
+\details Compute cosine of an array of 64-bit floating point values, see #math_batch_sin64
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_exp64
+\brief Batch exponential
+\details Compute natural exponential of an array of 64-bit floating point values, see
+#math_batch_sin64
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_log64
+\brief Batch logarithm
+\details Compute natural logarithm of an array of 64-bit floating point values, see
+#math_batch_sin64
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_sqrt64
+\brief Batch square root
+\details Compute square root of an array of 64-bit floating point values. Results are
+correctly rounded regardless of accuracy.
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+
+\fn math_batch_rsqrt64
+\brief Batch reciprocal square root
+\details Compute reciprocal square root of an array of 64-bit floating point values
+\param out Output array
+\param in Input array
+\param count Number of values
+\param accuracy Accuracy of the results
+*/
+
+FOUNDATION_API void
+math_batch_sin32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_cos32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_exp32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_log32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_sqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_rsqrt32(float32_t* out, const float32_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_sin64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_cos64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_exp64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_log64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_sqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
+FOUNDATION_API void
+math_batch_rsqrt64(float64_t* out, const float64_t* in, size_t count, math_accuracy_t accuracy);
+
 // Implementation
 
 #ifndef FOUNDATION_PLATFORM_DOXYGEN
@@ -12,6 +12,27 @@
 
 #include <foundation/foundation.h>
 
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define MD5_LANES_SSE2 1
+#  include <emmintrin.h>
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define MD5_TARGET_AVX2
+#    define MD5_TARGET_AVX512
+#  else
+#    define MD5_TARGET_AVX2 __attribute__((target("avx2")))
+#    define MD5_TARGET_AVX512 __attribute__((target("avx512f")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define MD5_LANES_NEON 1
+#  include <arm_neon.h>
+#endif
+
+//Maximum number of buffers digested in parallel lanes
+#define MD5_LANES_MAX 16
+
 /*lint -e123 */
 #define MD5_F1(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
 #define MD5_F2(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
@@ -120,6 +141,83 @@ md5_transform(md5_t* digest, const unsigned char* buffer) {
 	digest->state[3] += d;
 }
 
+#if MD5_LANES_SSE2 || MD5_LANES_NEON
+
+//Multi-buffer transform digesting one block in each lane. The state is stored as four rows of
+//lane values and the block as sixteen rows of lane message words. The rounds are expanded for
+//each instruction set with MD5_VADD, MD5_VSET, MD5_VROTL, MD5_VWORD and MD5_VF1-4 defined.
+#define MD5_VSTEP(f, a, b, c, d, i, t, s) \
+	a = MD5_VADD(a, MD5_VADD(f(b, c, d), MD5_VADD(MD5_VWORD(i), MD5_VSET((int32_t)t)))); \
+	a = MD5_VROTL(a, s); a = MD5_VADD(a, b);
+
+#define MD5_VROUNDS \
+	MD5_VSTEP(MD5_VF1, a, b, c, d,  0, 0xd76aa478, 7) \
+	MD5_VSTEP(MD5_VF1, d, a, b, c,  1, 0xe8c7b756, 12) \
+	MD5_VSTEP(MD5_VF1, c, d, a, b,  2, 0x242070db, 17) \
+	MD5_VSTEP(MD5_VF1, b, c, d, a,  3, 0xc1bdceee, 22) \
+	MD5_VSTEP(MD5_VF1, a, b, c, d,  4, 0xf57c0faf, 7) \
+	MD5_VSTEP(MD5_VF1, d, a, b, c,  5, 0x4787c62a, 12) \
+	MD5_VSTEP(MD5_VF1, c, d, a, b,  6, 0xa8304613, 17) \
+	MD5_VSTEP(MD5_VF1, b, c, d, a,  7, 0xfd469501, 22) \
+	MD5_VSTEP(MD5_VF1, a, b, c, d,  8, 0x698098d8, 7) \
+	MD5_VSTEP(MD5_VF1, d, a, b, c,  9, 0x8b44f7af, 12) \
+	MD5_VSTEP(MD5_VF1, c, d, a, b, 10, 0xffff5bb1, 17) \
+	MD5_VSTEP(MD5_VF1, b, c, d, a, 11, 0x895cd7be, 22) \
+	MD5_VSTEP(MD5_VF1, a, b, c, d, 12, 0x6b901122, 7) \
+	MD5_VSTEP(MD5_VF1, d, a, b, c, 13, 0xfd987193, 12) \
+	MD5_VSTEP(MD5_VF1, c, d, a, b, 14, 0xa679438e, 17) \
+	MD5_VSTEP(MD5_VF1, b, c, d, a, 15, 0x49b40821, 22) \
+	MD5_VSTEP(MD5_VF2, a, b, c, d,  1, 0xf61e2562, 5) \
+	MD5_VSTEP(MD5_VF2, d, a, b, c,  6, 0xc040b340, 9) \
+	MD5_VSTEP(MD5_VF2, c, d, a, b, 11, 0x265e5a51, 14) \
+	MD5_VSTEP(MD5_VF2, b, c, d, a,  0, 0xe9b6c7aa, 20) \
+	MD5_VSTEP(MD5_VF2, a, b, c, d,  5, 0xd62f105d, 5) \
+	MD5_VSTEP(MD5_VF2, d, a, b, c, 10, 0x02441453, 9) \
+	MD5_VSTEP(MD5_VF2, c, d, a, b, 15, 0xd8a1e681, 14) \
+	MD5_VSTEP(MD5_VF2, b, c, d, a,  4, 0xe7d3fbc8, 20) \
+	MD5_VSTEP(MD5_VF2, a, b, c, d,  9, 0x21e1cde6, 5) \
+	MD5_VSTEP(MD5_VF2, d, a, b, c, 14, 0xc33707d6, 9) \
+	MD5_VSTEP(MD5_VF2, c, d, a, b,  3, 0xf4d50d87, 14) \
+	MD5_VSTEP(MD5_VF2, b, c, d, a,  8, 0x455a14ed, 20) \
+	MD5_VSTEP(MD5_VF2, a, b, c, d, 13, 0xa9e3e905, 5) \
+	MD5_VSTEP(MD5_VF2, d, a, b, c,  2, 0xfcefa3f8, 9) \
+	MD5_VSTEP(MD5_VF2, c, d, a, b,  7, 0x676f02d9, 14) \
+	MD5_VSTEP(MD5_VF2, b, c, d, a, 12, 0x8d2a4c8a, 20) \
+	MD5_VSTEP(MD5_VF3, a, b, c, d,  5, 0xfffa3942, 4) \
+	MD5_VSTEP(MD5_VF3, d, a, b, c,  8, 0x8771f681, 11) \
+	MD5_VSTEP(MD5_VF3, c, d, a, b, 11, 0x6d9d6122, 16) \
+	MD5_VSTEP(MD5_VF3, b, c, d, a, 14, 0xfde5380c, 23) \
+	MD5_VSTEP(MD5_VF3, a, b, c, d,  1, 0xa4beea44, 4) \
+	MD5_VSTEP(MD5_VF3, d, a, b, c,  4, 0x4bdecfa9, 11) \
+	MD5_VSTEP(MD5_VF3, c, d, a, b,  7, 0xf6bb4b60, 16) \
+	MD5_VSTEP(MD5_VF3, b, c, d, a, 10, 0xbebfbc70, 23) \
+	MD5_VSTEP(MD5_VF3, a, b, c, d, 13, 0x289b7ec6, 4) \
+	MD5_VSTEP(MD5_VF3, d, a, b, c,  0, 0xeaa127fa, 11) \
+	MD5_VSTEP(MD5_VF3, c, d, a, b,  3, 0xd4ef3085, 16) \
+	MD5_VSTEP(MD5_VF3, b, c, d, a,  6, 0x04881d05, 23) \
+	MD5_VSTEP(MD5_VF3, a, b, c, d,  9, 0xd9d4d039, 4) \
+	MD5_VSTEP(MD5_VF3, d, a, b, c, 12, 0xe6db99e5, 11) \
+	MD5_VSTEP(MD5_VF3, c, d, a, b, 15, 0x1fa27cf8, 16) \
+	MD5_VSTEP(MD5_VF3, b, c, d, a,  2, 0xc4ac5665, 23) \
+	MD5_VSTEP(MD5_VF4, a, b, c, d,  0, 0xf4292244, 6) \
+	MD5_VSTEP(MD5_VF4, d, a, b, c,  7, 0x432aff97, 10) \
+	MD5_VSTEP(MD5_VF4, c, d, a, b, 14, 0xab9423a7, 15) \
+	MD5_VSTEP(MD5_VF4, b, c, d, a,  5, 0xfc93a039, 21) \
+	MD5_VSTEP(MD5_VF4, a, b, c, d, 12, 0x655b59c3, 6) \
+	MD5_VSTEP(MD5_VF4, d, a, b, c,  3, 0x8f0ccc92, 10) \
+	MD5_VSTEP(MD5_VF4, c, d, a, b, 10, 0xffeff47d, 15) \
+	MD5_VSTEP(MD5_VF4, b, c, d, a,  1, 0x85845dd1, 21) \
+	MD5_VSTEP(MD5_VF4, a, b, c, d,  8, 0x6fa87e4f, 6) \
+	MD5_VSTEP(MD5_VF4, d, a, b, c, 15, 0xfe2ce6e0, 10) \
+	MD5_VSTEP(MD5_VF4, c, d, a, b,  6, 0xa3014314, 15) \
+	MD5_VSTEP(MD5_VF4, b, c, d, a, 13, 0x4e0811a1, 21) \
+	MD5_VSTEP(MD5_VF4, a, b, c, d,  4, 0xf7537e82, 6) \
+	MD5_VSTEP(MD5_VF4, d, a, b, c, 11, 0xbd3af235, 10) \
+	MD5_VSTEP(MD5_VF4, c, d, a, b,  2, 0x2ad7d2bb, 15) \
+	MD5_VSTEP(MD5_VF4, b, c, d, a,  9, 0xeb86d391, 21)
+
+#endif
+
 md5_t*
 md5_allocate(void) {
 	md5_t* digest = memory_allocate(0, sizeof(md5_t), 0, MEMORY_PERSISTENT);
@@ -233,23 +331,316 @@ md5_get_digest_raw(const md5_t* digest) {
 
 string_t
 md5_get_digest(const md5_t* digest, char* str, size_t length) {
-	const char trn[17] = "0123456789ABCDEF";
-	size_t i, j, num;
-
 	if (!digest)
 		return (string_t) { 0, 0 };
+	return string_hex_encode(str, length, digest->digest, 16, true);
+}
+
+
+#if MD5_LANES_SSE2
+
+#define MD5_VADD(a, b) _mm_add_epi32(a, b)
+#define MD5_VSET(t) _mm_set1_epi32(t)
+#define MD5_VROTL(a, s) _mm_or_si128(_mm_slli_epi32(a, s), _mm_srli_epi32(a, 32 - (s)))
+#define MD5_VWORD(i) _mm_load_si128((const __m128i*)(const void*)(block + ((i) * 4)))
+#define MD5_VF1(x, y, z) _mm_xor_si128(z, _mm_and_si128(x, _mm_xor_si128(y, z)))
+#define MD5_VF2(x, y, z) _mm_xor_si128(y, _mm_and_si128(z, _mm_xor_si128(x, y)))
+#define MD5_VF3(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define MD5_VF4(x, y, z) _mm_xor_si128(y, _mm_or_si128(x, _mm_xor_si128(z, _mm_set1_epi32(-1))))
+
+static void
+md5_transform_sse2(uint32_t* state, const uint32_t* block) {
+	__m128i* vstate = (__m128i*)(void*)state;
+	__m128i a = vstate[0], b = vstate[1], c = vstate[2], d = vstate[3];
+	MD5_VROUNDS
+	vstate[0] = _mm_add_epi32(vstate[0], a);
+	vstate[1] = _mm_add_epi32(vstate[1], b);
+	vstate[2] = _mm_add_epi32(vstate[2], c);
+	vstate[3] = _mm_add_epi32(vstate[3], d);
+}
+
+#undef MD5_VADD
+#undef MD5_VSET
+#undef MD5_VROTL
+#undef MD5_VWORD
+#undef MD5_VF1
+#undef MD5_VF2
+#undef MD5_VF3
+#undef MD5_VF4
+
+#define MD5_VADD(a, b) _mm256_add_epi32(a, b)
+#define MD5_VSET(t) _mm256_set1_epi32(t)
+#define MD5_VROTL(a, s) _mm256_or_si256(_mm256_slli_epi32(a, s), _mm256_srli_epi32(a, 32 - (s)))
+#define MD5_VWORD(i) _mm256_load_si256((const __m256i*)(const void*)(block + ((i) * 8)))
+#define MD5_VF1(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define MD5_VF2(x, y, z) _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)))
+#define MD5_VF3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5_VF4(x, y, z) \
+	_mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, _mm256_set1_epi32(-1))))
+
+static MD5_TARGET_AVX2 void
+md5_transform_avx2(uint32_t* state, const uint32_t* block) {
+	__m256i* vstate = (__m256i*)(void*)state;
+	__m256i a = vstate[0], b = vstate[1], c = vstate[2], d = vstate[3];
+	MD5_VROUNDS
+	vstate[0] = _mm256_add_epi32(vstate[0], a);
+	vstate[1] = _mm256_add_epi32(vstate[1], b);
+	vstate[2] = _mm256_add_epi32(vstate[2], c);
+	vstate[3] = _mm256_add_epi32(vstate[3], d);
+}
+
+#undef MD5_VADD
+#undef MD5_VSET
+#undef MD5_VROTL
+#undef MD5_VWORD
+#undef MD5_VF1
+#undef MD5_VF2
+#undef MD5_VF3
+#undef MD5_VF4
+
+//AVX-512 has native rotates, and ternary logic evaluates each round function in one operation
+#define MD5_VADD(a, b) _mm512_add_epi32(a, b)
+#define MD5_VSET(t) _mm512_set1_epi32(t)
+#define MD5_VROTL(a, s) _mm512_rol_epi32(a, s)
+#define MD5_VWORD(i) _mm512_load_si512((const void*)(block + ((i) * 16)))
+#define MD5_VF1(x, y, z) _mm512_ternarylogic_epi32(x, y, z, 0xca)
+#define MD5_VF2(x, y, z) _mm512_ternarylogic_epi32(z, x, y, 0xca)
+#define MD5_VF3(x, y, z) _mm512_ternarylogic_epi32(x, y, z, 0x96)
+#define MD5_VF4(x, y, z) _mm512_ternarylogic_epi32(x, y, z, 0x39)
+
+static MD5_TARGET_AVX512 void
+md5_transform_avx512(uint32_t* state, const uint32_t* block) {
+	__m512i* vstate = (__m512i*)(void*)state;
+	__m512i a = vstate[0], b = vstate[1], c = vstate[2], d = vstate[3];
+	MD5_VROUNDS
+	vstate[0] = _mm512_add_epi32(vstate[0], a);
+	vstate[1] = _mm512_add_epi32(vstate[1], b);
+	vstate[2] = _mm512_add_epi32(vstate[2], c);
+	vstate[3] = _mm512_add_epi32(vstate[3], d);
+}
+
+static int _md5_lanes;
+
+static int
+md5_lanes_supported(void) {
+	if (!_md5_lanes) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		int lanes = 4;
+		__cpuid(info, 1);
+		//Require OS support for saving YMM and ZMM state
+		if ((info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6)) {
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5))
+				lanes = 8;
+			if ((info[1] & (1 << 16)) && ((_xgetbv(0) & 0xe6) == 0xe6))
+				lanes = 16;
+		}
+		_md5_lanes = lanes;
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			_md5_lanes = 16;
+		else if (__builtin_cpu_supports("avx2"))
+			_md5_lanes = 8;
+		else
+			_md5_lanes = 4;
+#endif
+	}
+	return _md5_lanes;
+}
+
+#elif MD5_LANES_NEON
+
+#define MD5_VADD(a, b) vaddq_u32(a, b)
+#define MD5_VSET(t) vdupq_n_u32((uint32_t)(t))
+#define MD5_VROTL(a, s) vsriq_n_u32(vshlq_n_u32(a, s), a, 32 - (s))
+#define MD5_VWORD(i) vld1q_u32(block + ((i) * 4))
+#define MD5_VF1(x, y, z) vbslq_u32(x, y, z)
+#define MD5_VF2(x, y, z) vbslq_u32(z, x, y)
+#define MD5_VF3(x, y, z) veorq_u32(veorq_u32(x, y), z)
+#define MD5_VF4(x, y, z) veorq_u32(y, vornq_u32(x, z))
+
+static void
+md5_transform_neon(uint32_t* state, const uint32_t* block) {
+	uint32x4_t a = vld1q_u32(state), b = vld1q_u32(state + 4);
+	uint32x4_t c = vld1q_u32(state + 8), d = vld1q_u32(state + 12);
+	MD5_VROUNDS
+	vst1q_u32(state, vaddq_u32(vld1q_u32(state), a));
+	vst1q_u32(state + 4, vaddq_u32(vld1q_u32(state + 4), b));
+	vst1q_u32(state + 8, vaddq_u32(vld1q_u32(state + 8), c));
+	vst1q_u32(state + 12, vaddq_u32(vld1q_u32(state + 12), d));
+}
+
+#endif
+
+#if MD5_LANES_SSE2 || MD5_LANES_NEON
 
-	num = length / 2;
-	if (num > 16)
-		num = 16;
+typedef void (* md5_transform_lanes_fn)(uint32_t* state, const uint32_t* block);
 
-	for (i = 0, j = 0; i < num; ++i, j += 2) {
-		str[j]   = trn[ digest->digest[i] / 16 ];
-		str[j + 1] = trn[ digest->digest[i] % 16 ];
+typedef struct md5_lane_t md5_lane_t;
+
+struct md5_lane_t {
+	const unsigned char* data;
+	size_t blocks;
+	size_t buffer;
+	unsigned int tail_blocks;
+	unsigned int tail_offset;
+	unsigned char tail[128];
+};
+
+static const unsigned char _md5_zero_block[64];
+
+static void
+md5_lane_start(md5_lane_t* lane, uint32_t* state, size_t lanes, size_t ilane, const void* data,
+               size_t size, size_t buffer) {
+	size_t rest = size & 63;
+	uint64_t bits = (uint64_t)size << 3ULL;
+	unsigned int ibyte;
+
+	lane->data = data;
+	lane->blocks = size >> 6;
+	lane->buffer = buffer;
+	lane->tail_blocks = (rest < 56) ? 1 : 2;
+	lane->tail_offset = 0;
+	memset(lane->tail, 0, sizeof(lane->tail));
+	if (rest)
+		memcpy(lane->tail, pointer_offset_const(data, size - rest), rest);
+	lane->tail[rest] = 0x80;
+	for (ibyte = 0; ibyte < 8; ++ibyte)
+		lane->tail[(lane->tail_blocks * 64) - 8 + ibyte] = (unsigned char)(bits >> (ibyte * 8));
+
+	state[ilane] = 0x67452301U;
+	state[lanes + ilane] = 0xefcdab89U;
+	state[(lanes * 2) + ilane] = 0x98badcfeU;
+	state[(lanes * 3) + ilane] = 0x10325476U;
+}
+
+//Get next block of a lane, returns true if it is the last block of the buffer
+static bool
+md5_lane_next(md5_lane_t* lane, const unsigned char** block) {
+	if (lane->blocks) {
+		*block = lane->data;
+		lane->data += 64;
+		--lane->blocks;
+		return false;
+	}
+	*block = lane->tail + lane->tail_offset;
+	lane->tail_offset += 64;
+	return (lane->tail_offset == lane->tail_blocks * 64);
+}
+
+static uint128_t
+md5_state_digest(const uint32_t* state) {
+	unsigned char raw[16];
+	uint128_t digest;
+	md5_encode(raw, state, 16);
+	memcpy(&digest, raw, sizeof(digest));
+	return digest;
+}
+
+static void
+md5_digest_lanes(md5_transform_lanes_fn transform, size_t lanes, const void* const* buffers,
+                 const size_t* sizes, size_t count, uint128_t* digests) {
+	FOUNDATION_ALIGN(64) uint32_t state[4 * MD5_LANES_MAX];
+	FOUNDATION_ALIGN(64) uint32_t block[16 * MD5_LANES_MAX];
+	md5_lane_t lane[MD5_LANES_MAX];
+	bool last[MD5_LANES_MAX];
+	size_t active = 0;
+	size_t next = 0;
+	size_t ilane, iword;
+
+	for (ilane = 0; ilane < lanes; ++ilane) {
+		lane[ilane].buffer = count;
+		if (next < count) {
+			md5_lane_start(lane + ilane, state, lanes, ilane, buffers[next], sizes[next], next);
+			++next;
+			++active;
+		}
+	}
+
+	while (active > 1) {
+		for (ilane = 0; ilane < lanes; ++ilane) {
+			const unsigned char* data = _md5_zero_block;
+			last[ilane] = (lane[ilane].buffer < count) && md5_lane_next(lane + ilane, &data);
+#if FOUNDATION_ARCH_ENDIAN_LITTLE
+			for (iword = 0; iword < 16; ++iword, data += 4)
+				memcpy(block + (iword * lanes) + ilane, data, 4);
+#else
+			for (iword = 0; iword < 16; ++iword, data += 4)
+				block[(iword * lanes) + ilane] = (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+				                                 ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+#endif
+		}
+
+		transform(state, block);
+
+		for (ilane = 0; ilane < lanes; ++ilane) {
+			uint32_t final[4];
+			if (!last[ilane])
+				continue;
+			for (iword = 0; iword < 4; ++iword)
+				final[iword] = state[(iword * lanes) + ilane];
+			digests[lane[ilane].buffer] = md5_state_digest(final);
+			lane[ilane].buffer = count;
+			if (next < count) {
+				md5_lane_start(lane + ilane, state, lanes, ilane, buffers[next], sizes[next], next);
+				++next;
+			}
+			else {
+				--active;
+			}
+		}
 	}
-	if (length > 32)
-		str[32] = 0;
 
-	return (string_t) {str, num * 2};
+	//Finish a single remaining buffer without idle lanes
+	for (ilane = 0; active && (ilane < lanes); ++ilane) {
+		md5_t md5;
+		const unsigned char* data;
+		bool done = false;
+		if (lane[ilane].buffer >= count)
+			continue;
+		for (iword = 0; iword < 4; ++iword)
+			md5.state[iword] = state[(iword * lanes) + ilane];
+		while (!done) {
+			done = md5_lane_next(lane + ilane, &data);
+			md5_transform(&md5, data);
+		}
+		digests[lane[ilane].buffer] = md5_state_digest(md5.state);
+		active = 0;
+	}
 }
 
+#endif
+
+void
+md5_digest_multi(const void* const* buffers, const size_t* sizes, size_t count,
+                 uint128_t* digests) {
+	size_t ibuf;
+#if MD5_LANES_SSE2
+	if (count > 1) {
+		int lanes = md5_lanes_supported();
+		if (lanes == 16)
+			md5_digest_lanes(md5_transform_avx512, 16, buffers, sizes, count, digests);
+		else if (lanes == 8)
+			md5_digest_lanes(md5_transform_avx2, 8, buffers, sizes, count, digests);
+		else
+			md5_digest_lanes(md5_transform_sse2, 4, buffers, sizes, count, digests);
+		return;
+	}
+#elif MD5_LANES_NEON
+	if (count > 1) {
+		md5_digest_lanes(md5_transform_neon, 4, buffers, sizes, count, digests);
+		return;
+	}
+#endif
+	for (ibuf = 0; ibuf < count; ++ibuf) {
+		md5_t md5;
+		md5_initialize(&md5);
+		if (sizes[ibuf])
+			md5_digest(&md5, buffers[ibuf], sizes[ibuf]);
+		md5_digest_finalize(&md5);
+		digests[ibuf] = md5_get_digest_raw(&md5);
+		md5_finalize(&md5);
+	}
+}
@@ -29,7 +29,9 @@ md5_digest_finalize()
 md5_get_digest()
 md5_get_digest_raw()
 ... //More initialize, digest sequences
-md5_finalize()</pre> */
+md5_finalize()</pre>
+
+Multiple independent buffers can be digested in parallel with #md5_digest_multi. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -86,3 +88,16 @@ finalized with a call to #md5_digest_finalize.
 \return Message digest */
 FOUNDATION_API uint128_t
 md5_get_digest_raw(const md5_t* digest);
+
+/*! Get the MD5 digests of a number of independent buffers. The buffers are digested in parallel
+SIMD lanes where available, four lanes with SSE2 or NEON, eight with AVX2 and sixteen with
+AVX-512. Buffers of different sizes are scheduled to lanes as earlier buffers complete, best
+throughput is reached when digesting at least as many buffers as there are lanes. Each digest
+is equal to the raw digest of the buffer as given by #md5_get_digest_raw.
+\param buffers Buffers to digest
+\param sizes   Size of each buffer
+\param count   Number of buffers
+\param digests Array receiving the digest of each buffer */
+FOUNDATION_API void
+md5_digest_multi(const void* const* buffers, const size_t* sizes, size_t count,
+                 uint128_t* digests);
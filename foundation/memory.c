@@ -23,6 +23,7 @@
 
 #if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 #  include <malloc.h>
+#  include <sys/syscall.h>
 #endif
 
 #if FOUNDATION_PLATFORM_PNACL
@@ -39,6 +40,9 @@ typedef FOUNDATION_ALIGN(8) struct {
 	atomicptr_t         head;
 	size_t              size;
 	size_t              maxchunk;
+	size_t              threadchunk;
+	int32_t             generation;
+	atomic32_t          wrap;
 } atomic_linear_memory_t;
 
 typedef FOUNDATION_ALIGN(8) struct {
@@ -52,7 +56,40 @@ FOUNDATION_STATIC_ASSERT(sizeof(memory_statistics_t) == sizeof(memory_statistics
                          "statistics sizes differs");
 
 static atomic_linear_memory_t _memory_temporary;
-static memory_statistics_atomic_t _memory_stats;
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+
+//Statistics are counted in thread blocks only written by the owning thread, so counting needs
+//no atomic read-modify-write and no cache line is shared between threads. Blocks are summed on
+//demand, counters of exited threads are folded into the retired counters
+typedef struct memory_statistics_thread_t memory_statistics_thread_t;
+
+struct memory_statistics_thread_t {
+	FOUNDATION_ALIGN(64) memory_statistics_atomic_t stats;
+	memory_statistics_thread_t*                     next;
+};
+
+static memory_statistics_thread_t* _memory_stats_thread_list;
+static atomic32_t                  _memory_stats_thread_lock;
+static atomic32_t                  _memory_stats_generation;
+static memory_statistics_atomic_t  _memory_stats_retired;
+
+static void
+_memory_statistics_initialize(void);
+
+static void
+_memory_statistics_finalize(void);
+
+static void
+_memory_statistics_thread_finalize(void);
+
+#else
+
+#define _memory_statistics_initialize() do { /* */ } while(0)
+#define _memory_statistics_finalize() do { /* */ } while(0)
+#define _memory_statistics_thread_finalize() do { /* */ } while(0)
+
+#endif
 
 #if BUILD_ENABLE_MEMORY_GUARD
 #define MEMORY_GUARD_VALUE 0xDEADBEEF
@@ -75,6 +112,53 @@ _memory_untrack(void* addr);
 
 #endif
 
+#if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+#define MEMORY_CONTEXT_HEADER_SIZE 32
+#else
+#define MEMORY_CONTEXT_HEADER_SIZE 16
+#endif
+
+static void
+_memory_context_statistics_initialize(void);
+
+static void
+_memory_context_statistics_finalize(void);
+
+static void
+_memory_context_thread_finalize(void);
+
+static void*
+_memory_context_block_initialize(void* block, hash_t context, size_t size, unsigned int align,
+                                 unsigned int hint);
+
+static void*
+_memory_context_block_finalize(void* p, hash_t* context, unsigned int* hint);
+
+#else
+
+#define MEMORY_CONTEXT_HEADER_SIZE 0
+
+#define _memory_context_statistics_initialize() do { /* */ } while(0)
+#define _memory_context_statistics_finalize() do { /* */ } while(0)
+#define _memory_context_thread_finalize() do { /* */ } while(0)
+#define _memory_context_block_initialize(block, context, size, align, hint) ((void)sizeof(context), (void)sizeof(size), (void)sizeof(align), (void)sizeof(hint), (block))
+#define _memory_context_block_finalize(p, context, hint) ((void)sizeof(context), (void)sizeof(hint), (p))
+
+#endif
+
+//Hints forcing allocations to be mapped directly from the operating system
+#define MEMORY_MAPPED_HINTS (MEMORY_HUGE_PAGES | MEMORY_NODE_MASK)
+
+//Node local placement only needs a direct mapping when there is more than one node
+static FOUNDATION_FORCEINLINE bool
+_memory_hint_mapped(unsigned int hint) {
+	if (hint & MEMORY_MAPPED_HINTS)
+		return true;
+	return (hint & MEMORY_NODE_LOCAL) && (system_hardware_nodes() > 1);
+}
+
 // Max align must at least be sizeof( size_t )
 #if FOUNDATION_PLATFORM_ANDROID
 #  define FOUNDATION_MAX_ALIGN  8
@@ -82,36 +166,63 @@ _memory_untrack(void* addr);
 #  define FOUNDATION_MAX_ALIGN  16
 #endif
 
+/* Temporary memory is a ring buffer shared by all threads. Each thread bumps allocations from
+a thread local arena which is grabbed from the shared ring with a single atomic operation, so
+threads only touch the shared head when the arena is exhausted. Allocations not fitting in the
+remaining thread arena and larger than half the arena size are served directly from the shared
+ring. A thread arena is only valid for the lap of the ring it was cut from, the ring counts
+wraps and a thread drops its arena once the ring has started a new lap, since the arena memory
+is then being handed out again to other threads. */
+
+typedef struct {
+	void*   head;
+	void*   end;
+	int32_t generation;
+	int32_t wrap;
+} memory_temporary_arena_t;
+
+FOUNDATION_DECLARE_THREAD_LOCAL_ARRAY(memory_temporary_arena_t, memory_temporary, 1)
+
 static void
 _atomic_allocate_initialize(size_t storagesize) {
+	int32_t generation = _memory_temporary.generation;
 	if (storagesize < 1024)
 		storagesize = _foundation_config.temporary_memory;
 	if (!storagesize) {
 		memset(&_memory_temporary, 0, sizeof(_memory_temporary));
+		_memory_temporary.generation = generation + 1;
 		return;
 	}
-	_memory_temporary.storage   = memory_allocate(0, storagesize, 16, MEMORY_PERSISTENT);
-	_memory_temporary.end       = pointer_offset(_memory_temporary.storage, storagesize);
-	_memory_temporary.size      = storagesize;
-	_memory_temporary.maxchunk  = (storagesize / 8);
+	_memory_temporary.storage     = memory_allocate(0, storagesize, 16, MEMORY_PERSISTENT);
+	_memory_temporary.end         = pointer_offset(_memory_temporary.storage, storagesize);
+	_memory_temporary.size        = storagesize;
+	_memory_temporary.maxchunk    = (storagesize / 8);
+	_memory_temporary.threadchunk = (storagesize / 32) & ~(size_t)15;
+	_memory_temporary.generation  = generation + 1;
+	atomic_store32(&_memory_temporary.wrap, 0);
 	atomic_storeptr(&_memory_temporary.head, _memory_temporary.storage);
 }
 
 static void
 _atomic_allocate_finalize(void) {
 	void* storage = _memory_temporary.storage;
+	int32_t generation = _memory_temporary.generation;
 	memset(&_memory_temporary, 0, sizeof(_memory_temporary));
+	_memory_temporary.generation = generation + 1;
 	if (storage)
 		memory_deallocate(storage);
 }
 
 static void*
-_atomic_allocate_linear(size_t chunksize) {
+_atomic_allocate_linear(size_t chunksize, int32_t* wrap) {
 	void* old_head;
 	void* new_head;
 	void* return_pointer = 0;
+	int32_t lap;
 
 	do {
+		//Read the lap before the head, a wrap in between only makes the lap conservative
+		lap = atomic_load32(&_memory_temporary.wrap);
 		old_head = atomic_loadptr(&_memory_temporary.head);
 		new_head = pointer_offset(old_head, chunksize);
 
@@ -120,13 +231,38 @@ _atomic_allocate_linear(size_t chunksize) {
 		if (new_head > _memory_temporary.end) {
 			new_head = pointer_offset(_memory_temporary.storage, chunksize);
 			return_pointer = _memory_temporary.storage;
+			//Count the wrap before publishing the new head so no thread can be handed memory
+			//from the new lap while an arena from the previous lap still looks valid
+			lap = atomic_incr32(&_memory_temporary.wrap);
 		}
 	}
 	while (!atomic_cas_ptr(&_memory_temporary.head, new_head, old_head));
 
+	if (wrap)
+		*wrap = lap;
 	return return_pointer;
 }
 
+static void*
+_atomic_allocate_thread(size_t chunksize) {
+	memory_temporary_arena_t* arena = get_thread_memory_temporary();
+	void* block;
+
+	if ((arena->generation != _memory_temporary.generation) ||
+	    (arena->wrap != atomic_load32(&_memory_temporary.wrap)) ||
+	    (pointer_offset(arena->head, chunksize) > arena->end)) {
+		if (chunksize > (_memory_temporary.threadchunk / 2))
+			return _atomic_allocate_linear(chunksize, 0);
+		arena->head = _atomic_allocate_linear(_memory_temporary.threadchunk, &arena->wrap);
+		arena->end = pointer_offset(arena->head, _memory_temporary.threadchunk);
+		arena->generation = _memory_temporary.generation;
+	}
+
+	block = arena->head;
+	arena->head = pointer_offset(block, chunksize);
+	return block;
+}
+
 static FOUNDATION_CONSTCALL FOUNDATION_FORCEINLINE int unsigned
 _memory_get_align(unsigned int align) {
 	//All alignment in memory code is built around higher alignments
@@ -173,7 +309,8 @@ _memory_align_pointer(void* p, unsigned int align) {
 int
 _memory_initialize(const memory_system_t memory) {
 	_memory_system = memory;
-	memset(&_memory_stats, 0, sizeof(_memory_stats));
+	_memory_statistics_initialize();
+	_memory_context_statistics_initialize();
 	return _memory_system.initialize();
 }
 
@@ -187,12 +324,16 @@ _memory_preallocate(void) {
 	tracker = config_hash(HASH_FOUNDATION, HASH_MEMORY_TRACKER);
 	if (tracker == HASH_LOCAL)
 		memory_set_tracker(memory_tracker_local());
+	else if (tracker == HASH_SAMPLED)
+		memory_set_tracker(memory_tracker_sampled());
 }
 
 void
 _memory_finalize(void) {
 	memory_set_tracker(_memory_no_tracker);
 	_atomic_allocate_finalize();
+	_memory_context_statistics_finalize();
+	_memory_statistics_finalize();
 	_memory_system.finalize();
 }
 
@@ -230,51 +371,906 @@ _memory_guard_verify(void* memory) {
 
 #endif
 
+FOUNDATION_DECLARE_THREAD_LOCAL(memory_arena_t*, memory_arena, 0)
+
+static memory_arena_t*
+_memory_arena_owner(void* p) {
+	memory_arena_t* arena = get_thread_memory_arena();
+	while (arena) {
+		memory_arena_chunk_t* chunk = arena->chunk;
+		while (chunk) {
+			if ((p >= (void*)chunk) && (p < chunk->end))
+				return arena;
+			chunk = chunk->next;
+		}
+		arena = arena->outer;
+	}
+	return 0;
+}
+
+#if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+
+/* Context statistics need the context and size of a block on deallocation, so blocks from the
+memory system are prefixed with a header storing both. Counters are accumulated in a small
+thread local table of deltas indexed by context, which is merged into the global table when a
+slot is reused for another context, after a fixed number of operations and on thread exit.
+Global slot 0 holds allocations without context and contexts not fitting in the table.
+Memory histograms extend the header with the allocation time and hint, and accumulate bucket
+counters in the same thread local block. */
+
+#define MEMORY_CONTEXT_STATISTICS_SLOTS 256
+#define MEMORY_CONTEXT_DELTA_SLOTS      8
+#define MEMORY_CONTEXT_DELTA_OPERATIONS 256
+
+typedef struct {
+	hash_t   context;
+	uint64_t size;
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	tick_t   allocated;
+	uint32_t hint;
+	uint32_t unused;
+#endif
+} memory_context_header_t;
+
+FOUNDATION_STATIC_ASSERT(sizeof(memory_context_header_t) == MEMORY_CONTEXT_HEADER_SIZE,
+                         "context header size mismatch");
+
+typedef FOUNDATION_ALIGN(8) struct {
+	atomic64_t                 context;
+	atomic32_t                 state;
+	memory_statistics_atomic_t stats;
+} memory_context_slot_t;
+
+typedef struct {
+	hash_t  context;
+	int64_t allocations_total;
+	int64_t allocations_current;
+	int64_t allocated_total;
+	int64_t allocated_current;
+} memory_context_delta_t;
+
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+
+typedef struct {
+	atomic64_t size[MEMORY_HISTOGRAM_BUCKETS];
+	atomic64_t align[MEMORY_HISTOGRAM_BUCKETS];
+	atomic64_t lifetime[MEMORY_HISTOGRAM_BUCKETS];
+	atomic64_t short_lived;
+	atomic64_t short_lived_persistent;
+	atomic64_t long_lived_temporary;
+} memory_histogram_atomic_t;
+
+//Thread deltas are flushed at least every MEMORY_CONTEXT_DELTA_OPERATIONS operations
+typedef struct {
+	uint32_t size[MEMORY_HISTOGRAM_BUCKETS];
+	uint32_t align[MEMORY_HISTOGRAM_BUCKETS];
+	uint32_t lifetime[MEMORY_HISTOGRAM_BUCKETS];
+	uint32_t short_lived;
+	uint32_t short_lived_persistent;
+	uint32_t long_lived_temporary;
+} memory_histogram_delta_t;
+
+static memory_histogram_atomic_t _memory_histogram;
+static tick_t                    _memory_histogram_ticks_per_us;
+
+#endif
+
+typedef struct memory_context_thread_t memory_context_thread_t;
+
+struct memory_context_thread_t {
+	memory_context_thread_t* next;
+	unsigned int             operations;
+	memory_context_delta_t   delta[MEMORY_CONTEXT_DELTA_SLOTS];
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	memory_histogram_delta_t histogram;
+#endif
+};
+
+static memory_context_slot_t    _memory_context_slot[MEMORY_CONTEXT_STATISTICS_SLOTS + 1];
+static memory_context_thread_t* _memory_context_thread_list;
+static atomic32_t               _memory_context_thread_lock;
+static atomic32_t               _memory_context_generation;
+
+//Thread blocks are allocated directly from the memory system and are invalidated by
+//reinitialization of the memory system, detected by the generation counter
+FOUNDATION_DECLARE_THREAD_LOCAL(memory_context_thread_t*, memory_context_thread, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(intptr_t, memory_context_thread_generation, 0)
+
+static void
+_memory_context_statistics_initialize(void) {
+	memset(_memory_context_slot, 0, sizeof(_memory_context_slot));
+	atomic_store32(&_memory_context_slot[0].state, 2);
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	memset(&_memory_histogram, 0, sizeof(_memory_histogram));
+	_memory_histogram_ticks_per_us = 0;
+#endif
+	_memory_context_thread_list = 0;
+	atomic_incr32(&_memory_context_generation);
+}
+
+static void
+_memory_context_statistics_finalize(void) {
+	memory_context_thread_t* thread = _memory_context_thread_list;
+	while (thread) {
+		memory_context_thread_t* next = thread->next;
+		_memory_system.deallocate(thread);
+		thread = next;
+	}
+	_memory_context_thread_list = 0;
+	atomic_incr32(&_memory_context_generation);
+}
+
+static memory_statistics_atomic_t*
+_memory_context_statistics_slot(hash_t context) {
+	size_t islot;
+	if (!context)
+		return &_memory_context_slot[0].stats;
+	for (islot = 0; islot < MEMORY_CONTEXT_STATISTICS_SLOTS; ++islot) {
+		memory_context_slot_t* slot = _memory_context_slot + 1 +
+		                              (((size_t)context + islot) & (MEMORY_CONTEXT_STATISTICS_SLOTS - 1));
+		if (!atomic_load32(&slot->state) && atomic_cas32(&slot->state, 1, 0)) {
+			atomic_store64(&slot->context, (int64_t)context);
+			atomic_thread_fence_release();
+			atomic_store32(&slot->state, 2);
+			return &slot->stats;
+		}
+		while (atomic_load32(&slot->state) != 2)
+			thread_yield();
+		atomic_thread_fence_acquire();
+		if ((hash_t)atomic_load64(&slot->context) == context)
+			return &slot->stats;
+	}
+	return &_memory_context_slot[0].stats;
+}
+
+static void
+_memory_context_delta_flush(memory_context_delta_t* delta) {
+	if (delta->allocations_total || delta->allocations_current || delta->allocated_current) {
+		memory_statistics_atomic_t* stats = _memory_context_statistics_slot(delta->context);
+		atomic_add64_explicit(&stats->allocations_total, delta->allocations_total,
+		                      MEMORY_ORDER_RELAXED);
+		atomic_add64_explicit(&stats->allocations_current, delta->allocations_current,
+		                      MEMORY_ORDER_RELAXED);
+		atomic_add64_explicit(&stats->allocated_total, delta->allocated_total, MEMORY_ORDER_RELAXED);
+		atomic_add64_explicit(&stats->allocated_current, delta->allocated_current,
+		                      MEMORY_ORDER_RELAXED);
+		delta->allocations_total = 0;
+		delta->allocations_current = 0;
+		delta->allocated_total = 0;
+		delta->allocated_current = 0;
+	}
+}
+
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+
+static void
+_memory_histogram_flush_counters(atomic64_t* target, uint32_t* delta, size_t count) {
+	size_t icounter;
+	for (icounter = 0; icounter < count; ++icounter) {
+		if (delta[icounter]) {
+			atomic_add64_explicit(target + icounter, (int64_t)delta[icounter], MEMORY_ORDER_RELAXED);
+			delta[icounter] = 0;
+		}
+	}
+}
+
+static void
+_memory_histogram_flush(memory_histogram_delta_t* delta) {
+	_memory_histogram_flush_counters(_memory_histogram.size, delta->size, MEMORY_HISTOGRAM_BUCKETS);
+	_memory_histogram_flush_counters(_memory_histogram.align, delta->align, MEMORY_HISTOGRAM_BUCKETS);
+	_memory_histogram_flush_counters(_memory_histogram.lifetime, delta->lifetime,
+	                                 MEMORY_HISTOGRAM_BUCKETS);
+	_memory_histogram_flush_counters(&_memory_histogram.short_lived, &delta->short_lived, 1);
+	_memory_histogram_flush_counters(&_memory_histogram.short_lived_persistent,
+	                                 &delta->short_lived_persistent, 1);
+	_memory_histogram_flush_counters(&_memory_histogram.long_lived_temporary,
+	                                 &delta->long_lived_temporary, 1);
+}
+
+//Bucket n holds values in (2^(n-1), 2^n], bucket 0 values 0 and 1
+static FOUNDATION_FORCEINLINE unsigned int
+_memory_histogram_bucket(uint64_t value) {
+	unsigned int bucket;
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	if (value <= 1)
+		return 0;
+	if (_BitScanReverse(&index, (unsigned long)((value - 1) >> 32ULL)))
+		bucket = (unsigned int)index + 33;
+	else {
+		_BitScanReverse(&index, (unsigned long)(value - 1));
+		bucket = (unsigned int)index + 1;
+	}
+#else
+	if (value <= 1)
+		return 0;
+	bucket = 64U - (unsigned int)__builtin_clzll(value - 1);
+#endif
+	return (bucket < MEMORY_HISTOGRAM_BUCKETS) ? bucket : (MEMORY_HISTOGRAM_BUCKETS - 1);
+}
+
+#endif
+
+static void
+_memory_context_thread_flush(memory_context_thread_t* thread) {
+	size_t islot;
+	for (islot = 0; islot < MEMORY_CONTEXT_DELTA_SLOTS; ++islot)
+		_memory_context_delta_flush(thread->delta + islot);
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	_memory_histogram_flush(&thread->histogram);
+#endif
+	thread->operations = 0;
+}
+
+static memory_context_thread_t*
+_memory_context_thread(bool create) {
+	memory_context_thread_t* thread = get_thread_memory_context_thread();
+	int32_t generation = atomic_load32(&_memory_context_generation);
+	if (thread && (get_thread_memory_context_thread_generation() == (intptr_t)generation))
+		return thread;
+	if (!create)
+		return 0;
+
+	thread = _memory_system.allocate(0, sizeof(memory_context_thread_t), 0,
+	                                 MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	if (thread) {
+		while (!atomic_cas32(&_memory_context_thread_lock, 1, 0))
+			thread_yield();
+		thread->next = _memory_context_thread_list;
+		_memory_context_thread_list = thread;
+		atomic_store32(&_memory_context_thread_lock, 0);
+	}
+	set_thread_memory_context_thread(thread);
+	set_thread_memory_context_thread_generation((intptr_t)generation);
+	return thread;
+}
+
+static void
+_memory_context_thread_finalize(void) {
+	memory_context_thread_t* thread = _memory_context_thread(false);
+	if (thread) {
+		memory_context_thread_t** link;
+		_memory_context_thread_flush(thread);
+		while (!atomic_cas32(&_memory_context_thread_lock, 1, 0))
+			thread_yield();
+		link = &_memory_context_thread_list;
+		while (*link && (*link != thread))
+			link = &(*link)->next;
+		if (*link)
+			*link = thread->next;
+		atomic_store32(&_memory_context_thread_lock, 0);
+		_memory_system.deallocate(thread);
+	}
+	set_thread_memory_context_thread(0);
+}
+
+static void
+_memory_context_statistics_add(hash_t context, int64_t count, int64_t size) {
+	memory_context_thread_t* thread = _memory_context_thread(true);
+	memory_context_delta_t local;
+	memory_context_delta_t* delta = &local;
+	if (thread) {
+		delta = thread->delta + ((size_t)context & (MEMORY_CONTEXT_DELTA_SLOTS - 1));
+		if (delta->context != context)
+			_memory_context_delta_flush(delta);
+	}
+	else {
+		memset(&local, 0, sizeof(local));
+	}
+	delta->context = context;
+	if (count > 0) {
+		delta->allocations_total += count;
+		delta->allocated_total += size;
+	}
+	delta->allocations_current += count;
+	delta->allocated_current += size;
+	if (!thread)
+		_memory_context_delta_flush(delta);
+	else if (++thread->operations >= MEMORY_CONTEXT_DELTA_OPERATIONS)
+		_memory_context_thread_flush(thread);
+}
+
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+
+static void
+_memory_histogram_allocate(size_t size, unsigned int align) {
+	memory_context_thread_t* thread = _memory_context_thread(true);
+	memory_histogram_delta_t local;
+	memory_histogram_delta_t* delta = thread ? &thread->histogram : &local;
+	if (!thread)
+		memset(&local, 0, sizeof(local));
+	++delta->size[_memory_histogram_bucket(size)];
+	++delta->align[_memory_histogram_bucket(align)];
+	if (!thread)
+		_memory_histogram_flush(&local);
+}
+
+//Blocks allocated before the timer was initialized have no timestamp and no lifetime
+static void
+_memory_histogram_deallocate(tick_t allocated, unsigned int hint) {
+	memory_context_thread_t* thread;
+	memory_histogram_delta_t local;
+	memory_histogram_delta_t* delta;
+	tick_t lifetime;
+	tick_t ticks_per_us = _memory_histogram_ticks_per_us;
+	if (!allocated)
+		return;
+	if (!ticks_per_us) {
+		ticks_per_us = time_ticks_per_second() / 1000000;
+		if (ticks_per_us < 1)
+			ticks_per_us = 1;
+		_memory_histogram_ticks_per_us = ticks_per_us;
+	}
+	lifetime = time_current() - allocated;
+	if (lifetime < 0)
+		return;
+	lifetime /= ticks_per_us;
+
+	thread = _memory_context_thread(true);
+	delta = thread ? &thread->histogram : &local;
+	if (!thread)
+		memset(&local, 0, sizeof(local));
+	++delta->lifetime[_memory_histogram_bucket((uint64_t)lifetime)];
+	if (lifetime < MEMORY_HISTOGRAM_SHORT_LIVED) {
+		++delta->short_lived;
+		if (!(hint & MEMORY_TEMPORARY))
+			++delta->short_lived_persistent;
+	}
+	else if (hint & MEMORY_TEMPORARY) {
+		++delta->long_lived_temporary;
+	}
+	if (!thread)
+		_memory_histogram_flush(&local);
+}
+
+#endif
+
+static void*
+_memory_context_block_initialize(void* block, hash_t context, size_t size, unsigned int align,
+                                 unsigned int hint) {
+	memory_context_header_t* header = block;
+	if (!block)
+		return 0;
+	header->context = context;
+	header->size = size;
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	header->allocated = time_ticks_per_second() ? time_current() : 0;
+	header->hint = hint;
+	_memory_histogram_allocate(size, align);
+#else
+	FOUNDATION_UNUSED(align);
+	FOUNDATION_UNUSED(hint);
+#endif
+	_memory_context_statistics_add(context, 1, (int64_t)size);
+	return pointer_offset(block, MEMORY_CONTEXT_HEADER_SIZE);
+}
+
+static void*
+_memory_context_block_finalize(void* p, hash_t* context, unsigned int* hint) {
+	memory_context_header_t* header;
+	if (!p)
+		return 0;
+	header = pointer_offset(p, -MEMORY_CONTEXT_HEADER_SIZE);
+	*context = header->context;
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	*hint = header->hint;
+	_memory_histogram_deallocate(header->allocated, header->hint);
+#else
+	*hint = 0;
+#endif
+	_memory_context_statistics_add(header->context, -1, -(int64_t)header->size);
+	return header;
+}
+
+#endif
+
 void*
 memory_allocate(hash_t context, size_t size, unsigned int align, unsigned int hint) {
 	void* p = 0;
+	memory_arena_t* arena;
 	if (_memory_temporary.storage && (hint & MEMORY_TEMPORARY)) {
 		unsigned int tmpalign = _memory_get_align_forced(align);
 		if (size + tmpalign < _memory_temporary.maxchunk) {
-			p = _memory_align_pointer(_atomic_allocate_linear(size + tmpalign), tmpalign);
+			p = _memory_align_pointer(_atomic_allocate_thread(size + tmpalign), tmpalign);
 			FOUNDATION_ASSERT(!((uintptr_t)p & 1));
 			if (hint & MEMORY_ZERO_INITIALIZED)
 				memset(p, 0, (size_t)size);
 		}
 	}
-	if (!p)
-		p = _memory_system.allocate(context ? context : memory_context(), size, align, hint);
+	if (!p && (arena = get_thread_memory_arena()) && !(hint & MEMORY_32BIT_ADDRESS)) {
+		p = memory_arena_allocate_block(arena, size, align);
+		if (p && (hint & MEMORY_ZERO_INITIALIZED))
+			memset(p, 0, (size_t)size);
+		return p;
+	}
+	if (!p) {
+		if (!context)
+			context = memory_context();
+		p = _memory_system.allocate(context, size + MEMORY_CONTEXT_HEADER_SIZE, align, hint);
+		p = _memory_context_block_initialize(p, context, size, align, hint);
+	}
 	_memory_track(p, size);
 	return p;
 }
 
 void*
 memory_reallocate(void* p, size_t size, unsigned int align, size_t oldsize) {
+	memory_arena_t* arena;
+	hash_t context;
+	unsigned int hint = MEMORY_PERSISTENT;
+	void* block;
 	FOUNDATION_ASSERT_MSG((p < _memory_temporary.storage) ||
 	                      (p >= _memory_temporary.end), "Trying to reallocate temporary memory");
+	if ((arena = get_thread_memory_arena())) {
+		memory_arena_t* owner = p ? _memory_arena_owner(p) : arena;
+		if (owner) {
+			void* block = memory_arena_allocate_block(arena, size, align);
+			if (block && p && oldsize)
+				memcpy(block, p, (size < oldsize) ? size : oldsize);
+			return block;
+		}
+	}
 	_memory_untrack(p);
-	p = _memory_system.reallocate(p, size, align, oldsize);
+	context = memory_context();
+	block = _memory_context_block_finalize(p, &context, &hint);
+	if (block && oldsize)
+		oldsize += MEMORY_CONTEXT_HEADER_SIZE;
+	block = _memory_system.reallocate(block, size + MEMORY_CONTEXT_HEADER_SIZE, align, oldsize);
+	p = _memory_context_block_initialize(block, context, size, align, hint);
 	_memory_track(p, size);
 	return p;
 }
 
 void
 memory_deallocate(void* p) {
-	if ((p < _memory_temporary.storage) || (p >= _memory_temporary.end))
-		_memory_system.deallocate(p);
+	if (get_thread_memory_arena() && p && _memory_arena_owner(p))
+		return;
+	if ((p < _memory_temporary.storage) || (p >= _memory_temporary.end)) {
+		hash_t context;
+		unsigned int hint;
+		_memory_system.deallocate(_memory_context_block_finalize(p, &context, &hint));
+	}
 	_memory_untrack(p);
 }
 
+memory_arena_t*
+memory_arena_allocate(hash_t context, size_t chunk_size) {
+	memory_arena_t* arena = memory_allocate(context, sizeof(memory_arena_t), 0, MEMORY_PERSISTENT);
+	memory_arena_initialize(arena, context, chunk_size);
+	return arena;
+}
+
+void
+memory_arena_initialize(memory_arena_t* arena, hash_t context, size_t chunk_size) {
+	memset(arena, 0, sizeof(memory_arena_t));
+	arena->context = context;
+	arena->chunk_size = chunk_size ? chunk_size : (64 * 1024);
+}
+
+static void
+_memory_arena_deallocate_chunks(memory_arena_chunk_t* chunk) {
+	while (chunk) {
+		memory_arena_chunk_t* next = chunk->next;
+		memory_deallocate(chunk);
+		chunk = next;
+	}
+}
+
+void
+memory_arena_finalize(memory_arena_t* arena) {
+	memory_arena_chunk_t* chunk = arena->chunk;
+	FOUNDATION_ASSERT_MSG(!arena->outer && (get_thread_memory_arena() != arena),
+	                      "Finalizing memory arena in active scope");
+	arena->chunk = 0;
+	arena->head = arena->end = 0;
+	_memory_arena_deallocate_chunks(chunk);
+}
+
+void
+memory_arena_deallocate(memory_arena_t* arena) {
+	if (!arena)
+		return;
+	memory_arena_finalize(arena);
+	memory_deallocate(arena);
+}
+
+void*
+memory_arena_allocate_block(memory_arena_t* arena, size_t size, unsigned int align) {
+	void* block;
+	align = _memory_get_align_forced(align);
+	block = _memory_align_pointer(arena->head, align);
+	if (!block || (pointer_offset(block, size) > arena->end)) {
+		memory_arena_chunk_t* chunk;
+		memory_arena_t* scope;
+		size_t chunk_size = sizeof(memory_arena_chunk_t) + size + align;
+		if (chunk_size < arena->chunk_size)
+			chunk_size = arena->chunk_size;
+		//Allocate chunk outside of any arena scope
+		scope = get_thread_memory_arena();
+		set_thread_memory_arena(0);
+		chunk = memory_allocate(arena->context, chunk_size, FOUNDATION_MAX_ALIGN, MEMORY_PERSISTENT);
+		set_thread_memory_arena(scope);
+		if (!chunk)
+			return 0;
+		chunk->end = pointer_offset(chunk, chunk_size);
+		chunk->next = arena->chunk;
+		arena->chunk = chunk;
+		arena->head = pointer_offset(chunk, sizeof(memory_arena_chunk_t));
+		arena->end = chunk->end;
+		block = _memory_align_pointer(arena->head, align);
+	}
+	arena->head = pointer_offset(block, size);
+	return block;
+}
+
+void
+memory_arena_reset(memory_arena_t* arena) {
+	memory_arena_chunk_t* chunk = arena->chunk;
+	if (!chunk)
+		return;
+	//Retain the first allocated chunk, which is last in list
+	while (chunk->next) {
+		memory_arena_chunk_t* next = chunk->next;
+		arena->chunk = next;
+		memory_deallocate(chunk);
+		chunk = next;
+	}
+	arena->head = pointer_offset(chunk, sizeof(memory_arena_chunk_t));
+	arena->end = chunk->end;
+}
+
+void
+memory_arena_push(memory_arena_t* arena) {
+	//Push context first, context stack storage must not be allocated in arena
+	memory_context_push(arena->context);
+	arena->outer = get_thread_memory_arena();
+	set_thread_memory_arena(arena);
+}
+
+void
+memory_arena_pop(void) {
+	memory_arena_t* arena = get_thread_memory_arena();
+	if (arena) {
+		set_thread_memory_arena(arena->outer);
+		arena->outer = 0;
+		memory_context_pop();
+	}
+}
+
+/* Memory pool blocks are preceeded by a header holding the block index, which is used to
+link free blocks by index rather than pointer. The free list head pairs the index with a tag
+incremented by every operation, avoiding ABA problems in the lock free list. Chunks are never
+released until the pool is finalized, so reading the link of a block concurrently popped by
+another thread is safe and detected by the tag mismatch. */
+
+#define MEMORY_POOL_INDEX(head) ((uint32_t)((uint64_t)(head) & 0xFFFFFFFFULL))
+#define MEMORY_POOL_TAG(head)   ((uint64_t)(head) & 0xFFFFFFFF00000000ULL)
+#define MEMORY_POOL_TAG_INCR    0x100000000ULL
+
+memory_pool_t*
+memory_pool_allocate(hash_t context, size_t block_size, unsigned int align, size_t chunk_blocks,
+                     size_t chunk_max) {
+	memory_pool_t* pool = memory_allocate(context, sizeof(memory_pool_t), 0, MEMORY_PERSISTENT);
+	memory_pool_initialize(pool, context, block_size, align, chunk_blocks, chunk_max);
+	return pool;
+}
+
+void
+memory_pool_initialize(memory_pool_t* pool, hash_t context, size_t block_size, unsigned int align,
+                       size_t chunk_blocks, size_t chunk_max) {
+	size_t header;
+	memset(pool, 0, sizeof(memory_pool_t));
+	align = _memory_get_align_forced(align);
+	header = (align > 8) ? align : 8;
+	if (block_size < sizeof(uint32_t))
+		block_size = sizeof(uint32_t);
+	if (!chunk_blocks)
+		chunk_blocks = 256;
+	if (!chunk_max)
+		chunk_max = 4096;
+	pool->context = context;
+	pool->block_size = block_size;
+	pool->header = header;
+	pool->stride = (block_size + header + (header - 1)) & ~(header - 1);
+	while (((size_t)1 << pool->chunk_shift) < chunk_blocks)
+		++pool->chunk_shift;
+	while (((uint64_t)chunk_max << pool->chunk_shift) >= 0xFFFFFFFFULL)
+		chunk_max >>= 1;
+	pool->chunk_max = (unsigned int)chunk_max;
+	pool->chunk = memory_allocate(context, sizeof(void*) * chunk_max, 0,
+	                              MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+}
+
+void
+memory_pool_finalize(memory_pool_t* pool) {
+	int32_t ichunk, chunk_count = atomic_load32(&pool->chunk_count);
+	for (ichunk = 0; ichunk < chunk_count; ++ichunk)
+		memory_deallocate(pool->chunk[ichunk]);
+	memory_deallocate(pool->chunk);
+	pool->chunk = 0;
+	atomic_store32(&pool->chunk_count, 0);
+	atomic_store64(&pool->free, 0);
+}
+
+void
+memory_pool_deallocate(memory_pool_t* pool) {
+	if (!pool)
+		return;
+	memory_pool_finalize(pool);
+	memory_deallocate(pool);
+}
+
+static FOUNDATION_FORCEINLINE void*
+_memory_pool_block(memory_pool_t* pool, uint32_t index) {
+	void* chunk = pool->chunk[index >> pool->chunk_shift];
+	size_t offset = (index & ((1U << pool->chunk_shift) - 1)) * pool->stride;
+	return pointer_offset(chunk, offset + pool->header);
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+_memory_pool_index(memory_pool_t* pool, void* block) {
+	return *(uint32_t*)pointer_offset(block, -(ssize_t)pool->header);
+}
+
+static void
+_memory_pool_push(memory_pool_t* pool, void* first, void* last) {
+	int64_t head, newhead;
+	uint32_t index = _memory_pool_index(pool, first);
+	do {
+		head = atomic_load64(&pool->free);
+		*(uint32_t*)last = MEMORY_POOL_INDEX(head);
+		newhead = (int64_t)((MEMORY_POOL_TAG(head) + MEMORY_POOL_TAG_INCR) | (index + 1));
+	}
+	while (!atomic_cas64(&pool->free, newhead, head));
+}
+
+static bool
+_memory_pool_grow(memory_pool_t* pool) {
+	int64_t head;
+	int32_t chunk_count;
+	uint32_t iblock, chunk_blocks = 1U << pool->chunk_shift;
+	uint32_t base;
+	void* chunk;
+	void* first;
+	void* last;
+	bool grown = false;
+
+	while (!atomic_cas32(&pool->chunk_lock, 1, 0))
+		thread_yield();
+
+	//Another thread might have grown the pool while waiting for lock
+	head = atomic_load64(&pool->free);
+	chunk_count = atomic_load32(&pool->chunk_count);
+	if (MEMORY_POOL_INDEX(head)) {
+		grown = true;
+	}
+	else if ((unsigned int)chunk_count < pool->chunk_max) {
+		chunk = memory_allocate(pool->context, pool->stride * chunk_blocks, (unsigned int)pool->header,
+		                        MEMORY_PERSISTENT);
+		if (chunk) {
+			base = (uint32_t)chunk_count << pool->chunk_shift;
+			for (iblock = 0; iblock < chunk_blocks; ++iblock) {
+				void* header = pointer_offset(chunk, pool->stride * iblock);
+				*(uint32_t*)header = base + iblock;
+				*(uint32_t*)pointer_offset(header, pool->header) = base + iblock + 2;
+			}
+			pool->chunk[chunk_count] = chunk;
+			atomic_thread_fence_release();
+			atomic_store32(&pool->chunk_count, chunk_count + 1);
+			first = pointer_offset(chunk, pool->header);
+			last = pointer_offset(first, pool->stride * (chunk_blocks - 1));
+			_memory_pool_push(pool, first, last);
+			grown = true;
+		}
+	}
+
+	atomic_store32(&pool->chunk_lock, 0);
+	return grown;
+}
+
+void*
+memory_pool_allocate_block(memory_pool_t* pool) {
+	int64_t head, newhead;
+	uint32_t index;
+	void* block;
+	do {
+		head = atomic_load64(&pool->free);
+		index = MEMORY_POOL_INDEX(head);
+		if (!index) {
+			if (!_memory_pool_grow(pool))
+				return 0;
+			continue;
+		}
+		block = _memory_pool_block(pool, index - 1);
+		newhead = (int64_t)((MEMORY_POOL_TAG(head) + MEMORY_POOL_TAG_INCR) | *(uint32_t*)block);
+	}
+	while (!index || !atomic_cas64(&pool->free, newhead, head));
+	return block;
+}
+
+void
+memory_pool_deallocate_block(memory_pool_t* pool, void* block) {
+	if (block)
+		_memory_pool_push(pool, block, block);
+}
+
+void
+memory_pool_magazine_initialize(memory_pool_magazine_t* magazine, memory_pool_t* pool) {
+	magazine->pool = pool;
+	magazine->count = 0;
+}
+
+static void
+_memory_pool_magazine_flush(memory_pool_magazine_t* magazine, unsigned int count) {
+	unsigned int iblock;
+	unsigned int first = magazine->count - count;
+	for (iblock = first; iblock < magazine->count - 1; ++iblock)
+		*(uint32_t*)magazine->block[iblock] =
+		    _memory_pool_index(magazine->pool, magazine->block[iblock + 1]) + 1;
+	_memory_pool_push(magazine->pool, magazine->block[first], magazine->block[magazine->count - 1]);
+	magazine->count = first;
+}
+
+void
+memory_pool_magazine_finalize(memory_pool_magazine_t* magazine) {
+	if (magazine->count)
+		_memory_pool_magazine_flush(magazine, magazine->count);
+	magazine->pool = 0;
+}
+
+void*
+memory_pool_magazine_allocate_block(memory_pool_magazine_t* magazine) {
+	if (!magazine->count) {
+		while (magazine->count < MEMORY_POOL_MAGAZINE_SIZE / 2) {
+			void* block = memory_pool_allocate_block(magazine->pool);
+			if (!block)
+				break;
+			magazine->block[magazine->count++] = block;
+		}
+		if (!magazine->count)
+			return 0;
+	}
+	return magazine->block[--magazine->count];
+}
+
+void
+memory_pool_magazine_deallocate_block(memory_pool_magazine_t* magazine, void* block) {
+	if (!block)
+		return;
+	if (magazine->count == MEMORY_POOL_MAGAZINE_SIZE)
+		_memory_pool_magazine_flush(magazine, MEMORY_POOL_MAGAZINE_SIZE / 2);
+	magazine->block[magazine->count++] = block;
+}
+
+void
+memory_thread_finalize(void) {
+	_memory_context_thread_finalize();
+	_memory_statistics_thread_finalize();
+	if (_memory_system.thread_finalize)
+		_memory_system.thread_finalize();
+}
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+
+static void
+_memory_statistics_accumulate(memory_statistics_t* stats, memory_statistics_atomic_t* counters) {
+	stats->allocations_total += (uint64_t)atomic_load64_explicit(&counters->allocations_total,
+	                                                             MEMORY_ORDER_RELAXED);
+	stats->allocations_current += (uint64_t)atomic_load64_explicit(&counters->allocations_current,
+	                                                               MEMORY_ORDER_RELAXED);
+	stats->allocated_total += (uint64_t)atomic_load64_explicit(&counters->allocated_total,
+	                                                           MEMORY_ORDER_RELAXED);
+	stats->allocated_current += (uint64_t)atomic_load64_explicit(&counters->allocated_current,
+	                                                             MEMORY_ORDER_RELAXED);
+}
+
+#endif
+
 memory_statistics_t
 memory_statistics(void) {
 	memory_statistics_t stats;
-	memcpy(&stats, &_memory_stats, sizeof(memory_statistics_t));
+	memset(&stats, 0, sizeof(stats));
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	memory_statistics_thread_t* thread;
+	while (!atomic_cas32(&_memory_stats_thread_lock, 1, 0))
+		thread_yield();
+	_memory_statistics_accumulate(&stats, &_memory_stats_retired);
+	for (thread = _memory_stats_thread_list; thread; thread = thread->next)
+		_memory_statistics_accumulate(&stats, &thread->stats);
+	atomic_store32(&_memory_stats_thread_lock, 0);
+#endif
 	return stats;
 }
 
+size_t
+memory_context_statistics(memory_context_statistics_t* stats, size_t capacity) {
+	size_t count = 0;
+#if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+	size_t islot;
+	memory_context_thread_t* thread = _memory_context_thread(false);
+	if (thread)
+		_memory_context_thread_flush(thread);
+	for (islot = 0; islot <= MEMORY_CONTEXT_STATISTICS_SLOTS; ++islot) {
+		memory_context_slot_t* slot = _memory_context_slot + islot;
+		if (atomic_load32(&slot->state) != 2)
+			continue;
+		if (!islot && !atomic_load64(&slot->stats.allocations_total))
+			continue;
+		if (count < capacity) {
+			memory_statistics_t* target = &stats[count].statistics;
+			stats[count].context = (hash_t)atomic_load64(&slot->context);
+			target->allocations_total = (uint64_t)atomic_load64(&slot->stats.allocations_total);
+			target->allocations_current = (uint64_t)atomic_load64(&slot->stats.allocations_current);
+			target->allocated_total = (uint64_t)atomic_load64(&slot->stats.allocated_total);
+			target->allocated_current = (uint64_t)atomic_load64(&slot->stats.allocated_current);
+		}
+		++count;
+	}
+#else
+	FOUNDATION_UNUSED(stats);
+	FOUNDATION_UNUSED(capacity);
+#endif
+	return count;
+}
+
+void
+memory_histogram(memory_histogram_t* histogram) {
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	size_t ibucket;
+	memory_context_thread_t* thread = _memory_context_thread(false);
+	memset(histogram, 0, sizeof(memory_histogram_t));
+	if (thread)
+		_memory_context_thread_flush(thread);
+	for (ibucket = 0; ibucket < MEMORY_HISTOGRAM_BUCKETS; ++ibucket) {
+		histogram->size[ibucket] = (uint64_t)atomic_load64(&_memory_histogram.size[ibucket]);
+		histogram->align[ibucket] = (uint64_t)atomic_load64(&_memory_histogram.align[ibucket]);
+		histogram->lifetime[ibucket] = (uint64_t)atomic_load64(&_memory_histogram.lifetime[ibucket]);
+	}
+	histogram->short_lived = (uint64_t)atomic_load64(&_memory_histogram.short_lived);
+	histogram->short_lived_persistent =
+	    (uint64_t)atomic_load64(&_memory_histogram.short_lived_persistent);
+	histogram->long_lived_temporary =
+	    (uint64_t)atomic_load64(&_memory_histogram.long_lived_temporary);
+#else
+	memset(histogram, 0, sizeof(memory_histogram_t));
+#endif
+}
+
+static void
+_memory_histogram_dump_buckets(stream_t* stream, const char* name, size_t length,
+                               const uint64_t* bucket, const char* unit, size_t unit_length) {
+	size_t ibucket;
+	stream_write_format(stream, STRING_CONST("%.*s\n"), (int)length, name);
+	for (ibucket = 0; ibucket < MEMORY_HISTOGRAM_BUCKETS; ++ibucket) {
+		if (!bucket[ibucket])
+			continue;
+		stream_write_format(stream, STRING_CONST("  %s%" PRIu64 " %.*s: %" PRIu64 "\n"),
+		                    (ibucket == MEMORY_HISTOGRAM_BUCKETS - 1) ? "> " : "<= ",
+		                    (uint64_t)((ibucket == MEMORY_HISTOGRAM_BUCKETS - 1) ? (1ULL << (ibucket - 1)) :
+		                               (1ULL << ibucket)), (int)unit_length, unit, bucket[ibucket]);
+	}
+}
+
+void
+memory_histogram_dump(stream_t* stream) {
+	memory_histogram_t histogram;
+	memory_histogram(&histogram);
+	_memory_histogram_dump_buckets(stream, STRING_CONST("Allocation size"), histogram.size,
+	                               STRING_CONST("bytes"));
+	_memory_histogram_dump_buckets(stream, STRING_CONST("Allocation alignment"), histogram.align,
+	                               STRING_CONST("bytes"));
+	_memory_histogram_dump_buckets(stream, STRING_CONST("Block lifetime"), histogram.lifetime,
+	                               STRING_CONST("us"));
+	stream_write_format(stream, STRING_CONST("Short lived (< %d us): %" PRIu64 ", of which persistent: %"
+	                                         PRIu64 "\n"), MEMORY_HISTOGRAM_SHORT_LIVED,
+	                    histogram.short_lived, histogram.short_lived_persistent);
+	stream_write_format(stream, STRING_CONST("Long lived temporary: %" PRIu64 "\n"),
+	                    histogram.long_lived_temporary);
+}
+
 #if BUILD_ENABLE_MEMORY_CONTEXT
 
-FOUNDATION_DECLARE_THREAD_LOCAL(memory_context_t*, memory_context, 0)
+FOUNDATION_DECLARE_THREAD_CONTEXT(memory_context_t*, memory_context)
 
 void
 memory_context_push(hash_t context_id) {
@@ -313,10 +1309,209 @@ memory_context_thread_finalize(void) {
 
 #endif
 
-#if FOUNDATION_PLATFORM_WINDOWS && (FOUNDATION_SIZE_POINTER != 4)
+#if FOUNDATION_PLATFORM_WINDOWS && (FOUNDATION_SIZE_POINTER != 4)
+
+typedef long (*NtAllocateVirtualMemoryFn)(HANDLE, void**, ULONG, size_t*, ULONG, ULONG);
+static NtAllocateVirtualMemoryFn NtAllocateVirtualMemory = 0;
+
+#endif
+
+#if FOUNDATION_SIZE_POINTER > 4
+
+#define MEMORY_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#if FOUNDATION_PLATFORM_LINUX
+#  define MEMORY_MPOL_PREFERRED 1
+#endif
+
+static int
+_memory_hint_node(unsigned int hint) {
+	if (hint & MEMORY_NODE_MASK)
+		return (int)(hint >> 24U) - 1;
+	if ((hint & MEMORY_NODE_LOCAL) && (system_hardware_nodes() > 1))
+		return (int)system_hardware_thread_node(thread_hardware());
+	return -1;
+}
+
+//Map memory directly from the operating system, using the same block layout as allocations in
+//low 32-bit address space (raw pointer with low bit set and mapped size stored before block)
+static void*
+_memory_allocate_mapped(size_t size, unsigned int align, unsigned int hint) {
+#if BUILD_ENABLE_MEMORY_GUARD
+	size_t extra_padding = FOUNDATION_MAX_ALIGN * 3;
+#else
+	size_t extra_padding = 0;
+#endif
+	size_t allocate_size = size + align + FOUNDATION_SIZE_POINTER * 2 + extra_padding;
+	char* raw_memory = 0;
+	void* memory;
+	int node = _memory_hint_node(hint);
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (hint & MEMORY_HUGE_PAGES) {
+		//Requires the SeLockMemoryPrivilege, fall back to normal pages if not held
+		size_t large_page = GetLargePageMinimum();
+		if (large_page) {
+			size_t large_size = (allocate_size + large_page - 1) & ~(large_page - 1);
+			raw_memory = VirtualAlloc(0, large_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+			                          PAGE_READWRITE);
+			if (raw_memory)
+				allocate_size = large_size;
+		}
+	}
+	if (!raw_memory && (node >= 0))
+		raw_memory = VirtualAllocExNuma(GetCurrentProcess(), 0, allocate_size, MEM_RESERVE | MEM_COMMIT,
+		                                PAGE_READWRITE, (DWORD)node);
+	if (!raw_memory)
+		raw_memory = VirtualAlloc(0, allocate_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#  ifndef MAP_ANONYMOUS
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+#  ifdef MAP_HUGETLB
+	if (hint & MEMORY_HUGE_PAGES) {
+		//Requires preallocated huge pages, fall back to transparent huge pages if none available
+		size_t huge_size = (allocate_size + MEMORY_HUGE_PAGE_SIZE - 1) & ~(size_t)(MEMORY_HUGE_PAGE_SIZE - 1);
+		raw_memory = mmap(0, huge_size, PROT_READ | PROT_WRITE,
+		                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (raw_memory == MAP_FAILED)
+			raw_memory = 0;
+		else
+			allocate_size = huge_size;
+	}
+#  endif
+	if (!raw_memory) {
+		raw_memory = mmap(0, allocate_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw_memory == MAP_FAILED)
+			raw_memory = 0;
+#  ifdef MADV_HUGEPAGE
+		if (raw_memory && (allocate_size >= MEMORY_HUGE_PAGE_SIZE))
+			madvise(raw_memory, allocate_size, MADV_HUGEPAGE);
+#  endif
+	}
+#  if FOUNDATION_PLATFORM_LINUX && defined(SYS_mbind)
+	//Set preferred node before pages are touched, pages are placed on first access
+	if (raw_memory && (node >= 0) && (node < 64)) {
+		unsigned long nodemask = 1UL << node;
+		if (syscall(SYS_mbind, raw_memory, allocate_size, MEMORY_MPOL_PREFERRED, &nodemask,
+		            sizeof(nodemask) * 8, 0) < 0)
+			log_warnf(HASH_MEMORY, WARNING_SYSTEM_CALL_FAIL,
+			          STRING_CONST("Failed to bind memory to node %d"), node);
+	}
+#  endif
+#endif
+
+	if (!raw_memory) {
+		string_const_t errmsg = system_error_message(0);
+		log_errorf(HASH_MEMORY, ERROR_OUT_OF_MEMORY,
+		           STRING_CONST("Unable to map %" PRIsize " bytes of memory: %.*s"),
+		           size, STRING_FORMAT(errmsg));
+		return 0;
+	}
+
+	memory = _memory_align_pointer(raw_memory + FOUNDATION_SIZE_POINTER * 2, align);
+	*((uintptr_t*)memory - 1) = ((uintptr_t)raw_memory | 1);
+	*((uintptr_t*)memory - 2) = (uintptr_t)allocate_size;
+	FOUNDATION_ASSERT(!((uintptr_t)memory & 1));
+#if BUILD_ENABLE_MEMORY_GUARD
+	memory = _memory_guard_initialize(memory, size);
+	FOUNDATION_ASSERT(!((uintptr_t)memory & 1));
+#endif
+
+	return memory;
+}
+
+//Raw pointer flag for blocks placed between guard pages, in addition to the mapped flag
+#define MEMORY_GUARD_PAGES_FLAG 2
+
+//Sample state is kept in pointer sized thread locals, see the sampled memory tracker
+FOUNDATION_DECLARE_THREAD_LOCAL(intptr_t, memory_guard_countdown, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(uintptr_t, memory_guard_state, 0)
+
+//Select allocations for guard pages with uniformly distributed intervals averaging the
+//configured sample rate, so allocation patterns repeating with a fixed period are not missed
+static bool
+_memory_guard_sample(void) {
+	uint64_t state, interval;
+	intptr_t countdown = get_thread_memory_guard_countdown() - 1;
+	if (countdown > 0) {
+		set_thread_memory_guard_countdown(countdown);
+		return false;
+	}
+	state = get_thread_memory_guard_state();
+	if (!state)
+		state = ((uint64_t)(uintptr_t)&countdown * 0x9E3779B97F4A7C15ULL) | 1;
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	set_thread_memory_guard_state((uintptr_t)state ? (uintptr_t)state : 1);
+	interval = ((uint64_t)_foundation_config.memory_guard_sample_rate * 2) - 1;
+	set_thread_memory_guard_countdown((intptr_t)(((state * 0x2545F4914F6CDD1DULL) >> 11) % interval) + 1);
+	//First call on a thread only seeds the countdown
+	return (countdown == 0);
+}
+
+//Map a block with inaccessible pages before and after it, with the end of the block placed
+//against the trailing guard page so any overrun faults immediately. The mapping is released on
+//deallocation, so use after free also faults until the address range is reused
+static void*
+_memory_allocate_guarded(size_t size, unsigned int align) {
+#if BUILD_ENABLE_MEMORY_GUARD
+	size_t extra_padding = FOUNDATION_MAX_ALIGN * 3;
+#else
+	size_t extra_padding = 0;
+#endif
+	size_t page_size, data_size, allocate_size;
+	char* raw_memory;
+	char* guard_end;
+	void* memory;
+	bool guarded;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	SYSTEM_INFO system_info;
+	DWORD old_protect;
+	GetSystemInfo(&system_info);
+	page_size = (size_t)system_info.dwPageSize;
+#else
+	page_size = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	if (!align)
+		align = FOUNDATION_SIZE_POINTER;
 
-typedef long (*NtAllocateVirtualMemoryFn)(HANDLE, void**, ULONG, size_t*, ULONG, ULONG);
-static NtAllocateVirtualMemoryFn NtAllocateVirtualMemory = 0;
+	data_size = size + extra_padding + align + FOUNDATION_SIZE_POINTER * 2;
+	data_size = (data_size + page_size - 1) & ~(page_size - 1);
+	allocate_size = data_size + page_size * 2;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	raw_memory = VirtualAlloc(0, allocate_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!raw_memory)
+		return 0;
+	guarded = VirtualProtect(raw_memory, page_size, PAGE_NOACCESS, &old_protect) &&
+	            VirtualProtect(raw_memory + page_size + data_size, page_size, PAGE_NOACCESS,
+	                           &old_protect);
+#else
+	raw_memory = mmap(0, allocate_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (raw_memory == MAP_FAILED)
+		return 0;
+	guarded = (mprotect(raw_memory, page_size, PROT_NONE) == 0) &&
+	            (mprotect(raw_memory + page_size + data_size, page_size, PROT_NONE) == 0);
+#endif
+	if (!guarded) {
+		log_warn(HASH_MEMORY, WARNING_SYSTEM_CALL_FAIL,
+		         STRING_CONST("Failed to protect memory guard pages"));
+	}
+
+	guard_end = raw_memory + page_size + data_size;
+	memory = (void*)((uintptr_t)(guard_end - size - extra_padding) & ~(uintptr_t)(align - 1));
+	*((uintptr_t*)memory - 1) = ((uintptr_t)raw_memory | 1 | MEMORY_GUARD_PAGES_FLAG);
+	*((uintptr_t*)memory - 2) = (uintptr_t)allocate_size;
+#if BUILD_ENABLE_MEMORY_GUARD
+	memory = _memory_guard_initialize(memory, size);
+#endif
+	FOUNDATION_ASSERT(!((uintptr_t)memory & 1));
+
+	return memory;
+}
 
 #endif
 
@@ -324,6 +1519,18 @@ static void*
 _memory_allocate_malloc_raw(size_t size, unsigned int align, unsigned int hint) {
 	FOUNDATION_UNUSED(hint);
 
+#if FOUNDATION_SIZE_POINTER > 4
+	if (_foundation_config.memory_guard_sample_rate &&
+	    !(hint & MEMORY_32BIT_ADDRESS) && !_memory_hint_mapped(hint) && _memory_guard_sample()) {
+		void* memory = _memory_allocate_guarded(size, align);
+		if (memory)
+			return memory;
+	}
+	if (!(hint & MEMORY_32BIT_ADDRESS) && (_memory_hint_mapped(hint) ||
+	    (_foundation_config.memory_map_threshold && (size >= _foundation_config.memory_map_threshold))))
+		return _memory_allocate_mapped(size, align, hint);
+#endif
+
 	//If we align manually, we must be able to retrieve the original pointer for passing to free()
 	//Thus all allocations need to go through that path
 
@@ -550,7 +1757,7 @@ _memory_deallocate_malloc(void* p) {
 #  endif
 	raw_ptr = *((uintptr_t*)p - 1);
 	if (raw_ptr & 1) {
-		raw_ptr &= ~(uintptr_t)1;
+		raw_ptr &= ~(uintptr_t)(1 | MEMORY_GUARD_PAGES_FLAG);
 #  if FOUNDATION_PLATFORM_WINDOWS
 		if (VirtualFree((void*)raw_ptr, 0, MEM_RELEASE) == 0)
 			log_warnf(HASH_MEMORY, WARNING_SYSTEM_CALL_FAIL,
@@ -575,6 +1782,41 @@ _memory_deallocate_malloc(void* p) {
 #endif
 }
 
+#if FOUNDATION_PLATFORM_LINUX && ( FOUNDATION_SIZE_POINTER > 4 )
+
+//Resize a block mapped by _memory_allocate_mapped, given the block pointer before guard offset.
+//The data offset from the page aligned mapping start is preserved, so contents need no copy
+static void*
+_memory_reallocate_mapped(void* memory, size_t size) {
+#if BUILD_ENABLE_MEMORY_GUARD
+	size_t extra_padding = FOUNDATION_MAX_ALIGN * 3;
+#else
+	size_t extra_padding = 0;
+#endif
+	char* raw_memory = (char*)(*((uintptr_t*)memory - 1) & ~(uintptr_t)1);
+	size_t raw_size = (size_t)*((uintptr_t*)memory - 2);
+	size_t offset = (size_t)pointer_diff(memory, raw_memory);
+	size_t allocate_size = size + offset + extra_padding;
+
+	//Keep the mapping if the new size fits and does not waste more than half of it
+	if ((allocate_size > raw_size) || (allocate_size < raw_size / 2)) {
+		raw_memory = mremap(raw_memory, raw_size, allocate_size, MREMAP_MAYMOVE);
+		if (raw_memory == MAP_FAILED)
+			return 0;
+		raw_size = allocate_size;
+	}
+
+	memory = raw_memory + offset;
+	*((uintptr_t*)memory - 1) = ((uintptr_t)raw_memory | 1);
+	*((uintptr_t*)memory - 2) = (uintptr_t)raw_size;
+#if BUILD_ENABLE_MEMORY_GUARD
+	memory = _memory_guard_initialize(memory, size);
+#endif
+	return memory;
+}
+
+#endif
+
 static void*
 _memory_reallocate_malloc(void* p, size_t size, unsigned  int align, size_t oldsize) {
 #if ( FOUNDATION_SIZE_POINTER == 4 ) && FOUNDATION_PLATFORM_WINDOWS
@@ -606,6 +1848,16 @@ _memory_reallocate_malloc(void* p, size_t size, unsigned  int align, size_t olds
 		memory = _memory_guard_verify(memory);
 #  endif
 	raw_p = memory ? *((void**)memory - 1) : nullptr;
+#if FOUNDATION_PLATFORM_LINUX && ( FOUNDATION_SIZE_POINTER > 4 )
+	//Mapped blocks outside low 32-bit address space are remapped, growing in place if possible.
+	//Blocks between guard pages are moved to keep the block end against the trailing guard page
+	if (raw_p && (((uintptr_t)raw_p & (1 | MEMORY_GUARD_PAGES_FLAG)) == 1) &&
+	    ((uintptr_t)raw_p > 0xFFFFFFFFULL)) {
+		memory = _memory_reallocate_mapped(memory, size);
+		if (memory)
+			return memory;
+	}
+#endif
 	memory = nullptr;
 
 #if FOUNDATION_PLATFORM_WINDOWS
@@ -705,6 +1957,375 @@ memory_system_malloc(void) {
 	memsystem.deallocate = _memory_deallocate_malloc;
 	memsystem.initialize = _memory_initialize_malloc;
 	memsystem.finalize = _memory_finalize_malloc;
+	memsystem.thread_finalize = 0;
+	return memsystem;
+}
+
+/* Thread caching memory system. Each block is preceeded by a header holding the size class
+index plus one, or zero for large blocks passed through to the malloc system. Blocks of a
+size class are carved from spans allocated from the malloc system, and free blocks are kept
+in singly linked lists in the thread cache. When a thread list grows above twice the batch
+size of the class one batch is moved to the global pool, which is also where an empty thread
+list is refilled from before carving a new span. Batches in the global pool are linked through
+the second pointer of the first block, and the number of blocks in a batch is stored in the
+second pointer of the second block, a batch without a second block holds a single block. */
+
+#define MEMORY_CACHE_HEADER_SIZE  FOUNDATION_MAX_ALIGN
+#define MEMORY_CACHE_GRANULARITY  16
+#define MEMORY_CACHE_LINEAR_LIMIT 1024
+#define MEMORY_CACHE_LINEAR_COUNT (MEMORY_CACHE_LINEAR_LIMIT / MEMORY_CACHE_GRANULARITY)
+#define MEMORY_CACHE_CLASS_LIMIT  (16 * 1024)
+#define MEMORY_CACHE_CLASS_COUNT  (MEMORY_CACHE_LINEAR_COUNT + 4)
+#define MEMORY_CACHE_SPAN_SIZE    (64 * 1024)
+
+typedef struct memory_cache_span_t   memory_cache_span_t;
+typedef struct memory_cache_thread_t memory_cache_thread_t;
+typedef struct memory_cache_class_t  memory_cache_class_t;
+
+struct memory_cache_span_t {
+	memory_cache_span_t* next;
+};
+
+struct memory_cache_thread_t {
+	void*                  free[MEMORY_CACHE_CLASS_COUNT];
+	unsigned int           count[MEMORY_CACHE_CLASS_COUNT];
+	memory_cache_thread_t* next;
+	memory_cache_thread_t* prev;
+};
+
+struct memory_cache_class_t {
+	size_t       size;
+	unsigned int batch;
+	unsigned int span_blocks;
+	atomic32_t   lock;
+	void*        batches;
+};
+
+static memory_cache_class_t   _memory_cache_class[MEMORY_CACHE_CLASS_COUNT];
+static memory_cache_span_t*   _memory_cache_spans;
+static memory_cache_thread_t* _memory_cache_threads;
+static atomic32_t             _memory_cache_lock;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(memory_cache_thread_t*, memory_cache, 0)
+
+static FOUNDATION_FORCEINLINE void
+_memory_cache_acquire(atomic32_t* lock) {
+	while (!atomic_cas32(lock, 1, 0))
+		thread_yield();
+}
+
+static FOUNDATION_FORCEINLINE void
+_memory_cache_release(atomic32_t* lock) {
+	atomic_thread_fence_release();
+	atomic_store32(lock, 0);
+}
+
+static FOUNDATION_FORCEINLINE unsigned int
+_memory_cache_class_index(size_t size) {
+	size_t class_size;
+	unsigned int iclass;
+	if (size <= MEMORY_CACHE_LINEAR_LIMIT)
+		return (unsigned int)((size + (MEMORY_CACHE_GRANULARITY - 1)) / MEMORY_CACHE_GRANULARITY) - 1;
+	for (iclass = MEMORY_CACHE_LINEAR_COUNT, class_size = MEMORY_CACHE_LINEAR_LIMIT * 2;
+	     class_size < size; ++iclass)
+		class_size <<= 1;
+	return iclass;
+}
+
+static memory_cache_thread_t*
+_memory_cache_thread(void) {
+	memory_cache_thread_t* cache = get_thread_memory_cache();
+	if (!cache) {
+		cache = _memory_allocate_malloc(0, sizeof(memory_cache_thread_t), 0,
+		                                MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		if (!cache)
+			return 0;
+		_memory_cache_acquire(&_memory_cache_lock);
+		cache->next = _memory_cache_threads;
+		if (_memory_cache_threads)
+			_memory_cache_threads->prev = cache;
+		_memory_cache_threads = cache;
+		_memory_cache_release(&_memory_cache_lock);
+		set_thread_memory_cache(cache);
+	}
+	return cache;
+}
+
+static void*
+_memory_cache_allocate_span(memory_cache_class_t* sizeclass) {
+	char* block;
+	void* first;
+	unsigned int iblock;
+	memory_cache_span_t* span = _memory_allocate_malloc_raw(sizeof(memory_cache_span_t) +
+	                            (MEMORY_CACHE_HEADER_SIZE * 2) + (sizeclass->size * sizeclass->span_blocks),
+	                            FOUNDATION_MAX_ALIGN, 0);
+	if (!span)
+		return 0;
+
+	_memory_cache_acquire(&_memory_cache_lock);
+	span->next = _memory_cache_spans;
+	_memory_cache_spans = span;
+	_memory_cache_release(&_memory_cache_lock);
+
+	//Blocks start at an offset leaving room for the header while keeping user pointer aligned
+	first = _memory_align_pointer(pointer_offset(span, sizeof(memory_cache_span_t)),
+	                              FOUNDATION_MAX_ALIGN);
+	block = first;
+	for (iblock = 0; iblock < sizeclass->span_blocks - 1; ++iblock) {
+		*(void**)block = block + sizeclass->size;
+		block += sizeclass->size;
+	}
+	*(void**)block = 0;
+	return first;
+}
+
+static void
+_memory_cache_push_batch(memory_cache_class_t* sizeclass, void* first, unsigned int count) {
+	void* second = *(void**)first;
+	if (second)
+		((void**)second)[1] = (void*)(uintptr_t)count;
+	_memory_cache_acquire(&sizeclass->lock);
+	((void**)first)[1] = sizeclass->batches;
+	sizeclass->batches = first;
+	_memory_cache_release(&sizeclass->lock);
+}
+
+static unsigned int
+_memory_cache_batch_count(void* first) {
+	void* second = *(void**)first;
+	return second ? (unsigned int)(uintptr_t)((void**)second)[1] : 1;
+}
+
+static void*
+_memory_cache_refill(memory_cache_thread_t* cache, unsigned int iclass) {
+	memory_cache_class_t* sizeclass = _memory_cache_class + iclass;
+	void* batch = 0;
+	unsigned int count;
+
+	if (sizeclass->batches) {
+		_memory_cache_acquire(&sizeclass->lock);
+		batch = sizeclass->batches;
+		if (batch)
+			sizeclass->batches = ((void**)batch)[1];
+		_memory_cache_release(&sizeclass->lock);
+	}
+
+	if (batch) {
+		count = _memory_cache_batch_count(batch);
+	}
+	else {
+		batch = _memory_cache_allocate_span(sizeclass);
+		count = sizeclass->span_blocks;
+	}
+
+	cache->free[iclass] = batch;
+	cache->count[iclass] = batch ? count : 0;
+	return batch;
+}
+
+static void
+_memory_cache_release_batch(memory_cache_thread_t* cache, unsigned int iclass,
+                            unsigned int count) {
+	memory_cache_class_t* sizeclass = _memory_cache_class + iclass;
+	void* first = cache->free[iclass];
+	void* last = first;
+	unsigned int iblock;
+
+	for (iblock = 1; iblock < count; ++iblock)
+		last = *(void**)last;
+	cache->free[iclass] = *(void**)last;
+	cache->count[iclass] -= count;
+	*(void**)last = 0;
+
+	_memory_cache_push_batch(sizeclass, first, count);
+}
+
+static void*
+_memory_allocate_thread_cache(hash_t context, size_t size, unsigned int align, unsigned int hint) {
+	memory_cache_thread_t* cache;
+	unsigned int iclass;
+	void* block;
+	void* memory;
+
+	if ((size + MEMORY_CACHE_HEADER_SIZE > MEMORY_CACHE_CLASS_LIMIT) ||
+	    (hint & MEMORY_32BIT_ADDRESS) || _memory_hint_mapped(hint) || !(cache = _memory_cache_thread())) {
+		block = _memory_allocate_malloc(context, size + MEMORY_CACHE_HEADER_SIZE,
+		                                _memory_get_align_forced(align), hint);
+		if (!block)
+			return 0;
+		*(uintptr_t*)block = 0;
+		return pointer_offset(block, MEMORY_CACHE_HEADER_SIZE);
+	}
+
+	iclass = _memory_cache_class_index(size + MEMORY_CACHE_HEADER_SIZE);
+	block = cache->free[iclass];
+	if (!block && !(block = _memory_cache_refill(cache, iclass))) {
+		log_errorf(HASH_MEMORY, ERROR_OUT_OF_MEMORY,
+		           STRING_CONST("Unable to allocate %" PRIsize " bytes of memory"), size);
+		return 0;
+	}
+	cache->free[iclass] = *(void**)block;
+	--cache->count[iclass];
+
+	*(uintptr_t*)block = iclass + 1;
+	memory = pointer_offset(block, MEMORY_CACHE_HEADER_SIZE);
+	if (hint & MEMORY_ZERO_INITIALIZED)
+		memset(memory, 0, size);
+	return memory;
+}
+
+static void
+_memory_deallocate_thread_cache(void* p) {
+	memory_cache_thread_t* cache;
+	unsigned int iclass;
+	void* block;
+
+	if (!p)
+		return;
+
+	block = pointer_offset(p, -MEMORY_CACHE_HEADER_SIZE);
+	iclass = (unsigned int)*(uintptr_t*)block;
+	if (!iclass) {
+		_memory_deallocate_malloc(block);
+		return;
+	}
+
+	--iclass;
+	FOUNDATION_ASSERT_MSG(iclass < MEMORY_CACHE_CLASS_COUNT, "Corrupt memory block header");
+	cache = _memory_cache_thread();
+	if (!cache) {
+		//Out of memory for thread cache, pass block as its own batch to global pool
+		*(void**)block = 0;
+		_memory_cache_push_batch(_memory_cache_class + iclass, block, 1);
+		return;
+	}
+
+	*(void**)block = cache->free[iclass];
+	cache->free[iclass] = block;
+	if (++cache->count[iclass] >= _memory_cache_class[iclass].batch * 2)
+		_memory_cache_release_batch(cache, iclass, _memory_cache_class[iclass].batch);
+}
+
+static size_t
+_memory_size_thread_cache(void* p) {
+	uintptr_t iclass = *(uintptr_t*)pointer_offset(p, -MEMORY_CACHE_HEADER_SIZE);
+	return iclass ? (size_t)_memory_cache_class[iclass - 1].size - MEMORY_CACHE_HEADER_SIZE : 0;
+}
+
+static void*
+_memory_reallocate_thread_cache(void* p, size_t size, unsigned int align, size_t oldsize) {
+	void* memory;
+	size_t capacity = p ? _memory_size_thread_cache(p) : 0;
+
+	if (p && (size <= capacity) && ((size * 2) > capacity))
+		return p;
+
+	if (p && !capacity && (size + MEMORY_CACHE_HEADER_SIZE > MEMORY_CACHE_CLASS_LIMIT)) {
+		//Large to large block, let malloc system reallocate including the header
+		memory = _memory_reallocate_malloc(pointer_offset(p, -MEMORY_CACHE_HEADER_SIZE),
+		                                   size + MEMORY_CACHE_HEADER_SIZE, _memory_get_align_forced(align),
+		                                   oldsize + MEMORY_CACHE_HEADER_SIZE);
+		return memory ? pointer_offset(memory, MEMORY_CACHE_HEADER_SIZE) : 0;
+	}
+
+	memory = _memory_allocate_thread_cache(0, size, align, MEMORY_PERSISTENT);
+	if (!memory) {
+		log_panicf(HASH_MEMORY, ERROR_OUT_OF_MEMORY,
+		           STRING_CONST("Unable to reallocate memory (%" PRIsize " -> %" PRIsize " @ 0x%" PRIfixPTR ")"),
+		           oldsize, size, (uintptr_t)p);
+		return 0;
+	}
+	if (p && oldsize)
+		memcpy(memory, p, (size < oldsize) ? size : oldsize);
+	_memory_deallocate_thread_cache(p);
+	return memory;
+}
+
+static void
+_memory_thread_finalize_thread_cache(void) {
+	memory_cache_thread_t* cache = get_thread_memory_cache();
+	unsigned int iclass;
+
+	if (!cache)
+		return;
+
+	set_thread_memory_cache(0);
+
+	for (iclass = 0; iclass < MEMORY_CACHE_CLASS_COUNT; ++iclass) {
+		while (cache->count[iclass]) {
+			unsigned int count = cache->count[iclass];
+			if (count > _memory_cache_class[iclass].batch)
+				count = _memory_cache_class[iclass].batch;
+			_memory_cache_release_batch(cache, iclass, count);
+		}
+	}
+
+	_memory_cache_acquire(&_memory_cache_lock);
+	if (cache->prev)
+		cache->prev->next = cache->next;
+	else
+		_memory_cache_threads = cache->next;
+	if (cache->next)
+		cache->next->prev = cache->prev;
+	_memory_cache_release(&_memory_cache_lock);
+
+	_memory_deallocate_malloc(cache);
+}
+
+static int
+_memory_initialize_thread_cache(void) {
+	unsigned int iclass;
+	size_t size;
+
+	memset(_memory_cache_class, 0, sizeof(_memory_cache_class));
+	for (iclass = 0; iclass < MEMORY_CACHE_CLASS_COUNT; ++iclass) {
+		if (iclass < MEMORY_CACHE_LINEAR_COUNT)
+			size = (iclass + 1) * MEMORY_CACHE_GRANULARITY;
+		else
+			size = (size_t)MEMORY_CACHE_LINEAR_LIMIT << (iclass - MEMORY_CACHE_LINEAR_COUNT + 1);
+		//Blocks must be able to hold the batch links and keep user pointer alignment
+		if (size < MEMORY_CACHE_HEADER_SIZE * 2)
+			size = MEMORY_CACHE_HEADER_SIZE * 2;
+		size = (size + (FOUNDATION_MAX_ALIGN - 1)) & ~(size_t)(FOUNDATION_MAX_ALIGN - 1);
+		_memory_cache_class[iclass].size = size;
+		_memory_cache_class[iclass].span_blocks = (unsigned int)math_max(MEMORY_CACHE_SPAN_SIZE / size, 16);
+		_memory_cache_class[iclass].batch = math_clamp(_memory_cache_class[iclass].span_blocks / 4, 4, 64);
+	}
+	_memory_cache_spans = 0;
+	_memory_cache_threads = 0;
+	return _memory_initialize_malloc();
+}
+
+static void
+_memory_finalize_thread_cache(void) {
+	_memory_thread_finalize_thread_cache();
+
+	_memory_cache_acquire(&_memory_cache_lock);
+	while (_memory_cache_threads) {
+		memory_cache_thread_t* cache = _memory_cache_threads;
+		_memory_cache_threads = cache->next;
+		_memory_deallocate_malloc(cache);
+	}
+	while (_memory_cache_spans) {
+		memory_cache_span_t* span = _memory_cache_spans;
+		_memory_cache_spans = span->next;
+		_memory_deallocate_malloc(span);
+	}
+	_memory_cache_release(&_memory_cache_lock);
+
+	memset(_memory_cache_class, 0, sizeof(_memory_cache_class));
+	_memory_finalize_malloc();
+}
+
+memory_system_t
+memory_system_thread_cache(void) {
+	memory_system_t memsystem;
+	memsystem.allocate = _memory_allocate_thread_cache;
+	memsystem.reallocate = _memory_reallocate_thread_cache;
+	memsystem.deallocate = _memory_deallocate_thread_cache;
+	memsystem.initialize = _memory_initialize_thread_cache;
+	memsystem.finalize = _memory_finalize_thread_cache;
+	memsystem.thread_finalize = _memory_thread_finalize_thread_cache;
 	return memsystem;
 }
 
@@ -744,6 +2365,14 @@ _memory_untrack(void* addr) {
 
 #endif
 
+/* The local memory tracker stores tags in an open addressing table indexed by address hash,
+giving constant time track and untrack. Removed tags are marked with a tombstone address which
+can be reused by later insertions. Probing is limited to a fixed distance, allocations which
+cannot be stored within the distance are counted in statistics but not tracked. */
+
+#define MEMORY_TAG_TOMBSTONE ((void*)(uintptr_t)1)
+#define MEMORY_TAG_PROBE_MAX 64
+
 struct memory_tag_t {
 	atomicptr_t   address;
 	size_t        size;
@@ -753,113 +2382,335 @@ struct memory_tag_t {
 typedef FOUNDATION_ALIGN(8) struct memory_tag_t memory_tag_t;
 
 static memory_tag_t* _memory_tags;
-static atomic32_t    _memory_tag_next;
+static size_t        _memory_tag_mask;
+static atomic32_t    _memory_tag_dropped;
+static size_t        _memory_tag_sample_rate;
+
+static FOUNDATION_FORCEINLINE size_t
+_memory_tag_hash(void* addr) {
+	uint64_t key = (uint64_t)(uintptr_t)addr >> 3;
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (size_t)(key >> 24);
+}
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+
+//Thread blocks are allocated directly from the memory system and are invalidated by
+//reinitialization of the memory system, detected by the generation counter
+FOUNDATION_DECLARE_THREAD_LOCAL(memory_statistics_thread_t*, memory_stats_thread, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(intptr_t, memory_stats_thread_generation, 0)
+
+static void
+_memory_statistics_initialize(void) {
+	memset(&_memory_stats_retired, 0, sizeof(_memory_stats_retired));
+	_memory_stats_thread_list = 0;
+	atomic_incr32(&_memory_stats_generation);
+}
+
+static void
+_memory_statistics_retire(memory_statistics_thread_t* thread) {
+	memory_statistics_atomic_t* retired = &_memory_stats_retired;
+	atomic_add64_explicit(&retired->allocations_total,
+	                      atomic_load64_explicit(&thread->stats.allocations_total, MEMORY_ORDER_RELAXED),
+	                      MEMORY_ORDER_RELAXED);
+	atomic_add64_explicit(&retired->allocations_current,
+	                      atomic_load64_explicit(&thread->stats.allocations_current, MEMORY_ORDER_RELAXED),
+	                      MEMORY_ORDER_RELAXED);
+	atomic_add64_explicit(&retired->allocated_total,
+	                      atomic_load64_explicit(&thread->stats.allocated_total, MEMORY_ORDER_RELAXED),
+	                      MEMORY_ORDER_RELAXED);
+	atomic_add64_explicit(&retired->allocated_current,
+	                      atomic_load64_explicit(&thread->stats.allocated_current, MEMORY_ORDER_RELAXED),
+	                      MEMORY_ORDER_RELAXED);
+}
+
+//Retired counters are kept so statistics remain available after the memory system finalized
+static void
+_memory_statistics_finalize(void) {
+	memory_statistics_thread_t* thread;
+	while (!atomic_cas32(&_memory_stats_thread_lock, 1, 0))
+		thread_yield();
+	thread = _memory_stats_thread_list;
+	_memory_stats_thread_list = 0;
+	while (thread) {
+		memory_statistics_thread_t* next = thread->next;
+		_memory_statistics_retire(thread);
+		_memory_system.deallocate(thread);
+		thread = next;
+	}
+	atomic_incr32(&_memory_stats_generation);
+	atomic_store32(&_memory_stats_thread_lock, 0);
+}
+
+static memory_statistics_thread_t*
+_memory_statistics_thread(bool create) {
+	memory_statistics_thread_t* thread = get_thread_memory_stats_thread();
+	int32_t generation = atomic_load32(&_memory_stats_generation);
+	if (thread && (get_thread_memory_stats_thread_generation() == (intptr_t)generation))
+		return thread;
+	if (!create)
+		return 0;
+
+	thread = _memory_system.allocate(0, sizeof(memory_statistics_thread_t), 64,
+	                                 MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	if (thread) {
+		while (!atomic_cas32(&_memory_stats_thread_lock, 1, 0))
+			thread_yield();
+		thread->next = _memory_stats_thread_list;
+		_memory_stats_thread_list = thread;
+		atomic_store32(&_memory_stats_thread_lock, 0);
+	}
+	set_thread_memory_stats_thread(thread);
+	set_thread_memory_stats_thread_generation((intptr_t)generation);
+	return thread;
+}
+
+static void
+_memory_statistics_thread_finalize(void) {
+	memory_statistics_thread_t* thread = _memory_statistics_thread(false);
+	if (thread) {
+		memory_statistics_thread_t** link;
+		while (!atomic_cas32(&_memory_stats_thread_lock, 1, 0))
+			thread_yield();
+		link = &_memory_stats_thread_list;
+		while (*link && (*link != thread))
+			link = &(*link)->next;
+		if (*link) {
+			*link = thread->next;
+			_memory_statistics_retire(thread);
+		}
+		atomic_store32(&_memory_stats_thread_lock, 0);
+		_memory_system.deallocate(thread);
+	}
+	set_thread_memory_stats_thread(0);
+}
+
+static FOUNDATION_FORCEINLINE void
+_memory_statistics_counter_add(atomic64_t* counter, int64_t value) {
+	atomic_store64_explicit(counter, atomic_load64_explicit(counter, MEMORY_ORDER_RELAXED) + value,
+	                        MEMORY_ORDER_RELAXED);
+}
+
+//Count allocations (positive count) or deallocations (negative count), falling back to atomic
+//updates of the retired counters if the thread block could not be allocated
+static void
+_memory_statistics_add(int64_t count, int64_t size) {
+	memory_statistics_thread_t* thread = _memory_statistics_thread(true);
+	if (thread) {
+		if (count > 0) {
+			_memory_statistics_counter_add(&thread->stats.allocations_total, count);
+			_memory_statistics_counter_add(&thread->stats.allocated_total, size);
+		}
+		_memory_statistics_counter_add(&thread->stats.allocations_current, count);
+		_memory_statistics_counter_add(&thread->stats.allocated_current, size);
+	}
+	else {
+		memory_statistics_atomic_t* retired = &_memory_stats_retired;
+		if (count > 0) {
+			atomic_add64_explicit(&retired->allocations_total, count, MEMORY_ORDER_RELAXED);
+			atomic_add64_explicit(&retired->allocated_total, size, MEMORY_ORDER_RELAXED);
+		}
+		atomic_add64_explicit(&retired->allocations_current, count, MEMORY_ORDER_RELAXED);
+		atomic_add64_explicit(&retired->allocated_current, size, MEMORY_ORDER_RELAXED);
+	}
+}
+
+#endif
+
+static size_t
+_memory_tracker_size(void) {
+	size_t slots = 1024;
+	while (slots < _foundation_config.memory_tracker_max * 2)
+		slots <<= 1;
+	return slots;
+}
 
 static int
-_memory_tracker_initialize(void) {
-	log_debug(HASH_MEMORY, STRING_CONST("Initializing local memory tracker"));
+_memory_tracker_initialize_table(void) {
 	if (!_memory_tags) {
-		size_t size = sizeof(memory_tag_t) * _foundation_config.memory_tracker_max;
+		size_t slots = _memory_tracker_size();
+		size_t size = sizeof(memory_tag_t) * slots;
 		_memory_tags = memory_allocate(0, size, 16, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		_memory_tag_mask = slots - 1;
+		atomic_store32(&_memory_tag_dropped, 0);
 
 #if BUILD_ENABLE_MEMORY_STATISTICS
-		atomic_incr64(&_memory_stats.allocations_total);
-		atomic_incr64(&_memory_stats.allocations_current);
-		atomic_add64(&_memory_stats.allocated_total, (int64_t)size);
-		atomic_add64(&_memory_stats.allocated_current, (int64_t)size);
+		_memory_statistics_add(1, (int64_t)size);
 #endif
 	}
-	
+
 	return 0;
 }
 
+static int
+_memory_tracker_initialize(void) {
+	log_debug(HASH_MEMORY, STRING_CONST("Initializing local memory tracker"));
+	_memory_tag_sample_rate = 0;
+	return _memory_tracker_initialize_table();
+}
+
+static int
+_memory_tracker_initialize_sampled(void) {
+	log_debugf(HASH_MEMORY, STRING_CONST("Initializing sampled memory tracker (%" PRIsize " bytes)"),
+	           _foundation_config.memory_tracker_sample_rate);
+	_memory_tag_sample_rate = _foundation_config.memory_tracker_sample_rate;
+	return _memory_tracker_initialize_table();
+}
+
 static void
 _memory_tracker_finalize(void) {
 	if (_memory_tags) {
-		unsigned int it;
+		size_t it;
 		bool got_leaks = false;
+		memory_tag_t* tags = _memory_tags;
 
 		log_debug(HASH_MEMORY, STRING_CONST("Checking for memory leaks"));
-		for (it = 0; it < _foundation_config.memory_tracker_max; ++it) {
-			memory_tag_t* tag = _memory_tags + it;
-			if (atomic_loadptr(&tag->address)) {
+		for (it = 0; it <= _memory_tag_mask; ++it) {
+			memory_tag_t* tag = tags + it;
+			void* addr = atomic_loadptr(&tag->address);
+			if (addr && (addr != MEMORY_TAG_TOMBSTONE)) {
 				char tracebuf[512];
 				string_t trace = stacktrace_resolve(tracebuf, 512, tag->trace, 14, 0);
-				void* addr = atomic_loadptr(&tag->address);
 				log_warnf(HASH_MEMORY, WARNING_MEMORY,
-				          STRING_CONST("Memory leak: %" PRIsize " bytes @ 0x%" PRIfixPTR " : tag %d\n%.*s"),
+				          STRING_CONST("Memory leak: %" PRIsize " bytes @ 0x%" PRIfixPTR " : tag %" PRIsize "\n%.*s"),
 				          tag->size, (uintptr_t)addr, it, (int)trace.length, trace.str);
 				got_leaks = true;
 			}
 		}
-		memory_deallocate(_memory_tags);
+		if (atomic_load32(&_memory_tag_dropped))
+			log_warnf(HASH_MEMORY, WARNING_MEMORY,
+			          STRING_CONST("Memory tracker table full, %d allocations were not tracked"),
+			          atomic_load32(&_memory_tag_dropped));
+
+		_memory_tags = 0;
+		memory_deallocate(tags);
 
 #if BUILD_ENABLE_MEMORY_STATISTICS
-		size_t size = sizeof(memory_tag_t) * _foundation_config.memory_tracker_max;
-		atomic_decr64(&_memory_stats.allocations_current);
-		atomic_add64(&_memory_stats.allocated_current, -(int64_t)size);
+		_memory_statistics_add(-1, -(int64_t)(sizeof(memory_tag_t) * (_memory_tag_mask + 1)));
 #endif
 
 		if (!got_leaks)
 			log_debug(HASH_MEMORY, STRING_CONST("No memory leaks detected"));
 	}
+	_memory_tag_sample_rate = 0;
+}
+
+static FOUNDATION_FORCEINLINE void
+_memory_tracker_insert(void* addr, size_t size, size_t hash) {
+	memory_tag_t* tags = _memory_tags;
+	size_t iprobe;
+	for (iprobe = 0; iprobe < MEMORY_TAG_PROBE_MAX; ++iprobe) {
+		memory_tag_t* tag = tags + ((hash + iprobe) & _memory_tag_mask);
+		void* current = atomic_loadptr(&tag->address);
+		if ((!current || (current == MEMORY_TAG_TOMBSTONE)) &&
+		    atomic_cas_ptr(&tag->address, addr, current)) {
+			tag->size = size;
+			stacktrace_capture_fast(tag->trace, 14, 3);
+			return;
+		}
+	}
+	atomic_incr32(&_memory_tag_dropped);
+}
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+
+/* Weight of a sampled allocation. With an average sample interval of R bytes an allocation of
+size S is sampled with probability P = 1 - exp(-S/R), and represents 1/P allocations and S/P
+bytes. Weights are a pure function of size so untracking subtracts the same amounts. */
+static void
+_memory_tracker_weight(size_t size, int64_t* count, int64_t* bytes) {
+	if (_memory_tag_sample_rate) {
+		real probability = REAL_C(1.0) - math_exp(-(real)size / (real)_memory_tag_sample_rate);
+		if (probability > REAL_EPSILON) {
+			*count = (int64_t)((REAL_C(1.0) / probability) + REAL_C(0.5));
+			*bytes = (int64_t)(((real)size / probability) + REAL_C(0.5));
+			return;
+		}
+		//Probability approaches S/R for small allocations
+		*count = size ? (int64_t)(_memory_tag_sample_rate / size) : 1;
+		*bytes = (int64_t)_memory_tag_sample_rate;
+		return;
+	}
+	*count = 1;
+	*bytes = (int64_t)size;
 }
 
+#endif
+
 static void
 _memory_tracker_track(void* addr, size_t size) {
-	if (addr) {
-		size_t limit = 0;
-		do {
-			int32_t tag = atomic_exchange_and_add32(&_memory_tag_next, 1);
-			while (tag >= (int32_t)_foundation_config.memory_tracker_max) {
-				int32_t newtag = tag % (int32_t)_foundation_config.memory_tracker_max;
-				if (atomic_cas32(&_memory_tag_next, newtag + 1, tag + 1))
-					tag = newtag;
-				else
-					tag = atomic_exchange_and_add32(&_memory_tag_next, 1);
-			}
-			if (atomic_cas_ptr(&_memory_tags[tag].address, addr, 0)) {
-				_memory_tags[tag].size = size;
-				stacktrace_capture(_memory_tags[tag].trace, 14, 3);
-				break;
-			}
+	if (addr && _memory_tags) {
+		size_t hash = _memory_tag_hash(addr);
+		_memory_tracker_insert(addr, size, hash);
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+		_memory_statistics_add(1, (int64_t)size);
+#endif
+	}
+}
+
+//Sample state is kept in pointer sized thread locals, since thread local blocks can be allocated
+//through memory_allocate on some platforms which would recurse into the tracker
+FOUNDATION_DECLARE_THREAD_LOCAL(intptr_t, memory_sample_countdown, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(uintptr_t, memory_sample_state, 0)
+
+static intptr_t
+_memory_tracker_sample_interval(void* addr) {
+	real uniform;
+	uint64_t state = get_thread_memory_sample_state();
+	if (!state)
+		state = ((uint64_t)(uintptr_t)addr * 0x9E3779B97F4A7C15ULL) | 1;
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	set_thread_memory_sample_state((uintptr_t)state ? (uintptr_t)state : 1);
+	uniform = (real)(((state * 0x2545F4914F6CDD1DULL) >> 11) + 1) * (real)(1.0 / 9007199254740992.0);
+	return (intptr_t)(-math_logn(uniform) * (real)_memory_tag_sample_rate) + 1;
+}
+
+static void
+_memory_tracker_track_sampled(void* addr, size_t size) {
+	if (addr && _memory_tags) {
+		intptr_t countdown = get_thread_memory_sample_countdown() - (intptr_t)size;
+		if (countdown > 0) {
+			set_thread_memory_sample_countdown(countdown);
+			return;
 		}
-		while (limit++ < _foundation_config.memory_tracker_max*2);
+		set_thread_memory_sample_countdown(_memory_tracker_sample_interval(addr));
+
+		size_t hash = _memory_tag_hash(addr);
+		_memory_tracker_insert(addr, size, hash);
 
 #if BUILD_ENABLE_MEMORY_STATISTICS
-		atomic_incr64(&_memory_stats.allocations_total);
-		atomic_incr64(&_memory_stats.allocations_current);
-		atomic_add64(&_memory_stats.allocated_total, (int64_t)size);
-		atomic_add64(&_memory_stats.allocated_current, (int64_t)size);
+		int64_t count, bytes;
+		_memory_tracker_weight(size, &count, &bytes);
+		_memory_statistics_add(count, bytes);
 #endif
 	}
 }
 
 static void
 _memory_tracker_untrack(void* addr) {
-	int32_t tag = 0;
-	if (addr) {
-		int32_t iend = atomic_load32(&_memory_tag_next);
-		int32_t itag = iend ? iend - 1 : (int32_t)_foundation_config.memory_tracker_max - 1;
-		for (; itag != iend;) {
-			if (atomic_loadptr(&_memory_tags[itag].address) == addr) {
-				tag = itag + 1;
+	memory_tag_t* tags = _memory_tags;
+	if (addr && tags) {
+		size_t hash = _memory_tag_hash(addr);
+		size_t iprobe;
+		for (iprobe = 0; iprobe < MEMORY_TAG_PROBE_MAX; ++iprobe) {
+			memory_tag_t* tag = tags + ((hash + iprobe) & _memory_tag_mask);
+			void* current = atomic_loadptr(&tag->address);
+			if (current == addr) {
+#if BUILD_ENABLE_MEMORY_STATISTICS
+				int64_t count, bytes;
+				_memory_tracker_weight(tag->size, &count, &bytes);
+				_memory_statistics_add(-count, -bytes);
+#endif
+				atomic_storeptr(&tag->address, MEMORY_TAG_TOMBSTONE);
 				break;
 			}
-			if (itag)
-				--itag;
-			else
-				itag = (int32_t)_foundation_config.memory_tracker_max - 1;
+			if (!current)
+				break;
 		}
 	}
-	if (tag) {
-		--tag;
-#if BUILD_ENABLE_MEMORY_STATISTICS
-		atomic_decr64(&_memory_stats.allocations_current);
-		atomic_add64(&_memory_stats.allocated_current, -(int64_t)_memory_tags[tag].size);
-#endif
-		atomic_storeptr(&_memory_tags[tag].address, 0);
-	}
 	//else if (addr)
 	//	log_warnf(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Untracked deallocation: 0x%" PRIfixPTR), (uintptr_t)addr);
 }
@@ -877,3 +2728,15 @@ memory_tracker_local(void) {
 #endif
 	return tracker;
 }
+
+memory_tracker_t
+memory_tracker_sampled(void) {
+	memory_tracker_t tracker = _memory_no_tracker;
+#if BUILD_ENABLE_MEMORY_TRACKER
+	tracker.track = _memory_tracker_track_sampled;
+	tracker.untrack = _memory_tracker_untrack;
+	tracker.initialize = _memory_tracker_initialize_sampled;
+	tracker.finalize = _memory_tracker_finalize;
+#endif
+	return tracker;
+}
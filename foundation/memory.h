@@ -76,6 +76,141 @@ context is set to 0. */
 FOUNDATION_API void
 memory_context_pop(void);
 
+/*! Allocate a memory arena. Arena memory is allocated in chunks from the current memory
+system and is bump allocated linearly in each chunk. Individual blocks cannot be deallocated,
+all memory is released at once with #memory_arena_reset or when the arena is deallocated.
+Arenas are not thread safe.
+\param context    Memory context for chunk allocations
+\param chunk_size Default size of chunks, zero for default (64KiB)
+\return           New memory arena */
+FOUNDATION_API memory_arena_t*
+memory_arena_allocate(hash_t context, size_t chunk_size);
+
+/*! Initialize a memory arena, see #memory_arena_allocate
+\param arena      Memory arena
+\param context    Memory context for chunk allocations
+\param chunk_size Default size of chunks, zero for default (64KiB) */
+FOUNDATION_API void
+memory_arena_initialize(memory_arena_t* arena, hash_t context, size_t chunk_size);
+
+/*! Finalize a memory arena, releasing all chunks. The arena must not be in an active
+arena scope (see #memory_arena_push).
+\param arena Memory arena */
+FOUNDATION_API void
+memory_arena_finalize(memory_arena_t* arena);
+
+/*! Deallocate a memory arena previously allocated with #memory_arena_allocate
+\param arena Memory arena */
+FOUNDATION_API void
+memory_arena_deallocate(memory_arena_t* arena);
+
+/*! Allocate a block of memory from an arena. The block is valid until the arena is reset or
+finalized and must not be passed to #memory_deallocate outside of an arena scope.
+\param arena Memory arena
+\param size  Requested size
+\param align Requested alignment
+\return      Memory address to a block of the requested size and alignment, 0 if out of memory */
+FOUNDATION_API void*
+memory_arena_allocate_block(memory_arena_t* arena, size_t size, unsigned int align);
+
+/*! Release all blocks allocated from the arena at once. The first chunk is retained for
+further allocations, any additional chunks are deallocated.
+\param arena Memory arena */
+FOUNDATION_API void
+memory_arena_reset(memory_arena_t* arena);
+
+/*! Push an arena scope on the calling thread, routing all later #memory_allocate and
+#memory_reallocate calls on the thread into the arena until the scope is popped with
+#memory_arena_pop. This allows memory allocated internally in array, string and hash map
+functions to land in the arena. Calls to #memory_deallocate for memory owned by an arena
+in an active scope are ignored, the memory is released by #memory_arena_reset. The arena
+memory context is also pushed on the memory context stack. Temporary memory and allocations
+in low 32-bit address space are not routed to the arena.
+\param arena Memory arena */
+FOUNDATION_API void
+memory_arena_push(memory_arena_t* arena);
+
+/*! Pop the current arena scope on the calling thread, restoring the previous arena scope
+and memory context */
+FOUNDATION_API void
+memory_arena_pop(void);
+
+/*! Allocate a memory pool of fixed size blocks. Blocks are carved from chunks which are
+allocated on demand from the current memory system, and free blocks are kept in a lock free
+list. Allocating and deallocating blocks is thread safe.
+\param context      Memory context for chunk allocations
+\param block_size   Size of a block
+\param align        Block alignment
+\param chunk_blocks Number of blocks in a chunk, rounded up to a power of two, zero for
+                     default (256)
+\param chunk_max    Maximum number of chunks, zero for default (4096)
+\return             New memory pool */
+FOUNDATION_API memory_pool_t*
+memory_pool_allocate(hash_t context, size_t block_size, unsigned int align, size_t chunk_blocks,
+                     size_t chunk_max);
+
+/*! Initialize a memory pool, see #memory_pool_allocate
+\param pool         Memory pool
+\param context      Memory context for chunk allocations
+\param block_size   Size of a block
+\param align        Block alignment
+\param chunk_blocks Number of blocks in a chunk, rounded up to a power of two, zero for
+                     default (256)
+\param chunk_max    Maximum number of chunks, zero for default (4096) */
+FOUNDATION_API void
+memory_pool_initialize(memory_pool_t* pool, hash_t context, size_t block_size, unsigned int align,
+                       size_t chunk_blocks, size_t chunk_max);
+
+/*! Finalize a memory pool, releasing all chunks. Any block allocated from the pool is invalid
+after this call.
+\param pool Memory pool */
+FOUNDATION_API void
+memory_pool_finalize(memory_pool_t* pool);
+
+/*! Deallocate a memory pool previously allocated with #memory_pool_allocate
+\param pool Memory pool */
+FOUNDATION_API void
+memory_pool_deallocate(memory_pool_t* pool);
+
+/*! Allocate a block from the pool, growing the pool with a new chunk if there are no free
+blocks available.
+\param pool Memory pool
+\return     Memory block, 0 if out of memory or maximum number of chunks reached */
+FOUNDATION_API void*
+memory_pool_allocate_block(memory_pool_t* pool);
+
+/*! Return a block to the pool. Safe to pass a null pointer.
+\param pool  Memory pool
+\param block Memory block previously allocated from the pool */
+FOUNDATION_API void
+memory_pool_deallocate_block(memory_pool_t* pool, void* block);
+
+/*! Initialize a magazine for a memory pool. A magazine caches a number of free blocks for
+use by a single thread, avoiding the atomic operations on the pool free list for most
+allocations and deallocations. Magazines are not thread safe.
+\param magazine Magazine
+\param pool     Memory pool */
+FOUNDATION_API void
+memory_pool_magazine_initialize(memory_pool_magazine_t* magazine, memory_pool_t* pool);
+
+/*! Finalize a magazine and return all cached blocks to the pool
+\param magazine Magazine */
+FOUNDATION_API void
+memory_pool_magazine_finalize(memory_pool_magazine_t* magazine);
+
+/*! Allocate a block through a magazine, refilling the magazine from the pool if empty
+\param magazine Magazine
+\return         Memory block, 0 if out of memory */
+FOUNDATION_API void*
+memory_pool_magazine_allocate_block(memory_pool_magazine_t* magazine);
+
+/*! Deallocate a block through a magazine, returning half the magazine to the pool in a
+single operation if full. Safe to pass a null pointer.
+\param magazine Magazine
+\param block    Memory block previously allocated from the magazine pool */
+FOUNDATION_API void
+memory_pool_magazine_deallocate_block(memory_pool_magazine_t* magazine, void* block);
+
 /*! Get the current memory context, or 0 if no context is set
 \return Current memory context */
 FOUNDATION_API hash_t
@@ -86,26 +221,87 @@ Called internally when a foundation thread is about to exit. */
 FOUNDATION_API void
 memory_context_thread_finalize(void);
 
+/*! Cleanup and deallocate any memory used for thread-local memory system data, for example
+thread caches in the thread caching memory system. Called internally when a foundation thread
+is about to exit. */
+FOUNDATION_API void
+memory_thread_finalize(void);
+
 /*! Set the current memory tracker, see #memory_tracker_local for a default implementation
 \param tracker New memory tracker declaration */
 FOUNDATION_API void
 memory_set_tracker(memory_tracker_t tracker);
 
-/*! Get the default malloc based memory system declaration for passing to #foundation_initialize
+/*! Get the default malloc based memory system declaration for passing to #foundation_initialize.
+With memory_guard_sample_rate set in #foundation_config_t, a sampled subset of allocations is
+mapped between inaccessible guard pages to catch heap overruns and use after free in production
+builds, complementing the full guard value checks enabled by #BUILD_ENABLE_MEMORY_GUARD
 \return Default malloc based memory system declation */
 FOUNDATION_API memory_system_t
 memory_system_malloc(void);
 
-/*! Get the default local memory tracker declaration for passing to #memory_set_tracker
+/*! Get the thread caching memory system declaration for passing to #foundation_initialize.
+Small allocations are served from per-thread free lists of fixed size classes, carved from
+larger spans. Free lists exceeding a threshold are returned in batches to a global pool shared
+by all threads, and a thread cache is released to the global pool when the thread exits.
+Large allocations and allocations in low 32-bit address space are passed through to the
+malloc based memory system.
+
+\return Thread caching memory system declaration */
+FOUNDATION_API memory_system_t
+memory_system_thread_cache(void);
+
+/*! Get the default local memory tracker declaration for passing to #memory_set_tracker.
+Allocations are stored in a hash table indexed by address, sized to twice the configured
+maximum number of tracked allocations
 \return Default local memory tracker declaration */
 FOUNDATION_API memory_tracker_t
 memory_tracker_local(void);
 
+/*! Get the sampled local memory tracker declaration for passing to #memory_set_tracker.
+Instead of tracking every allocation, one allocation per average sample interval of bytes
+(see memory_tracker_sample_rate in #foundation_config_t) is selected with exponentially
+distributed intervals and stored with a stack trace. Statistics of sampled allocations are
+scaled by the inverse sampling probability, making #memory_statistics an unbiased estimate
+of the full statistics at a fraction of the tracking overhead
+\return Sampled local memory tracker declaration */
+FOUNDATION_API memory_tracker_t
+memory_tracker_sampled(void);
+
 /*! Get the memory statistics since initialization
 \return Memory statistics */
 FOUNDATION_API memory_statistics_t
 memory_statistics(void);
 
+/*! Get memory statistics per memory context since initialization. Counters are accumulated
+in thread local deltas, which are merged into the global counters after a fixed number of
+operations, when a thread exits and for the calling thread when this function is called.
+Counters may therefore lag behind for allocations in other threads. Allocations made without
+a context are reported under context 0, as are allocations in contexts exceeding the maximum
+number of tracked contexts (256).
+Only available if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS is enabled, otherwise returns 0.
+\param stats    Array receiving context statistics
+\param capacity Number of elements in array
+\return         Total number of contexts, can be larger than capacity */
+FOUNDATION_API size_t
+memory_context_statistics(memory_context_statistics_t* stats, size_t capacity);
+
+/*! Get histograms of allocation sizes, alignment requests and block lifetimes since
+initialization. Only allocations passed to the memory system are counted, not temporary ring
+buffer or arena allocations. Counters are accumulated in thread local deltas and merged like
+the counters of #memory_context_statistics, and may lag behind for other threads. Use the
+lifetime counters to find persistent allocations that could use the MEMORY_TEMPORARY hint,
+and the size and alignment buckets to configure size classes and pools.
+Only available if BUILD_ENABLE_MEMORY_HISTOGRAM is enabled, otherwise all counters are zero.
+\param histogram Histogram receiving the counters */
+FOUNDATION_API void
+memory_histogram(memory_histogram_t* histogram);
+
+/*! Write the memory histograms as text to a stream, one line per non-empty bucket
+\param stream Stream to write to */
+FOUNDATION_API void
+memory_histogram_dump(stream_t* stream);
+
 #if !BUILD_ENABLE_MEMORY_CONTEXT
 
 #define memory_context_push(context) /*lint -save -e506 -e751 */ do { (void)sizeof( context ); } while(0) /*lint -restore -e506 -e751 */
@@ -36,6 +36,7 @@ struct FOUNDATION_ALIGN(16) mutex_t {
 #endif
 	volatile int     lockcount;
 	uint64_t         lockedthread;
+	lock_statistics_t statistics;
 };
 
 static void
@@ -100,6 +101,28 @@ mutex_name(mutex_t* mutex) {
 	return mutex->name;
 }
 
+static void
+_mutex_contention(mutex_t* mutex, tick_t start, uint64_t holder) {
+	tick_t end = time_current();
+#if BUILD_ENABLE_LOCK_STATISTICS
+	tick_t elapsed = end - start;
+	++mutex->statistics.contentions;
+	mutex->statistics.wait_ticks += elapsed;
+	if (elapsed > mutex->statistics.peak_wait_ticks)
+		mutex->statistics.peak_wait_ticks = elapsed;
+	mutex->statistics.holder = holder;
+#else
+	FOUNDATION_UNUSED(holder);
+#endif
+#if !BUILD_DEPLOY
+	profile_contention(mutex->name.str, mutex->name.length, start, end);
+#else
+	FOUNDATION_UNUSED(mutex);
+	FOUNDATION_UNUSED(start);
+	FOUNDATION_UNUSED(end);
+#endif
+}
+
 bool
 mutex_try_lock(mutex_t* mutex) {
 	bool was_locked;
@@ -125,22 +148,37 @@ mutex_try_lock(mutex_t* mutex) {
 		if (!mutex->lockcount)
 			mutex->lockedthread = thread_id();
 		++mutex->lockcount;
+#if BUILD_ENABLE_LOCK_STATISTICS
+		++mutex->statistics.acquisitions;
+#endif
 	}
 	return was_locked;
 }
 
 bool
 mutex_lock(mutex_t* mutex) {
+	tick_t start = 0;
+	uint64_t holder = 0;
+
 #if !BUILD_DEPLOY
 	profile_trylock(mutex->name.str, mutex->name.length);
 #endif
 
+	//Try lock first so only contended acquisitions are timed
 #if FOUNDATION_PLATFORM_WINDOWS
-	EnterCriticalSection((CRITICAL_SECTION*)mutex->csection);
+	if (!TryEnterCriticalSection((CRITICAL_SECTION*)mutex->csection)) {
+		holder = mutex->lockedthread;
+		start = time_current();
+		EnterCriticalSection((CRITICAL_SECTION*)mutex->csection);
+	}
 #elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
-	if (pthread_mutex_lock(&mutex->mutex) != 0) {
-		FOUNDATION_ASSERT_FAILFORMAT("unable to lock mutex %s", mutex->name.str);
-		return false;
+	if (pthread_mutex_trylock(&mutex->mutex) != 0) {
+		holder = mutex->lockedthread;
+		start = time_current();
+		if (pthread_mutex_lock(&mutex->mutex) != 0) {
+			FOUNDATION_ASSERT_FAILFORMAT("unable to lock mutex %s", mutex->name.str);
+			return false;
+		}
 	}
 #else
 #  error mutex_lock not implemented
@@ -156,6 +194,11 @@ mutex_lock(mutex_t* mutex) {
 	if (!mutex->lockcount)
 		mutex->lockedthread = thread_id();
 	++mutex->lockcount;
+#if BUILD_ENABLE_LOCK_STATISTICS
+	++mutex->statistics.acquisitions;
+#endif
+	if (start)
+		_mutex_contention(mutex, start, holder);
 
 	return true;
 }
@@ -316,6 +359,19 @@ mutex_signal(mutex_t* mutex) {
 #endif
 }
 
+lock_statistics_t
+mutex_statistics(mutex_t* mutex) {
+	lock_statistics_t statistics;
+#if BUILD_ENABLE_LOCK_STATISTICS
+	//Counters are updated while holding the mutex, values are approximate if mutex is in use
+	statistics = mutex->statistics;
+#else
+	FOUNDATION_UNUSED(mutex);
+	memset(&statistics, 0, sizeof(statistics));
+#endif
+	return statistics;
+}
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 void*
@@ -95,6 +95,15 @@ mutex_try_wait(mutex_t* mutex, unsigned int milliseconds);
 FOUNDATION_API void
 mutex_signal(mutex_t* mutex);
 
+/*! Get contention statistics for mutex. Contended lock acquisitions are timed and the
+thread holding the mutex at the time of contention is recorded. Waits longer than the
+profile contention threshold also generate a profile block, see #profile_contention.
+Only gathered if #BUILD_ENABLE_LOCK_STATISTICS is enabled, otherwise all counters are zero.
+\param mutex Mutex
+\return Mutex contention statistics */
+FOUNDATION_API lock_statistics_t
+mutex_statistics(mutex_t* mutex);
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 /*! Windows only, get OS handle for event object
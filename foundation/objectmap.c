@@ -22,6 +22,171 @@ _object_initialize(object_base_t* obj, object_t id) {
 	atomic_store32(&obj->ref, 1);
 }
 
+//Number of deferred deallocations pending in a thread before trying to reclaim
+#define OBJECTMAP_RECLAIM_THRESHOLD 64
+
+typedef struct objectmap_retired_t objectmap_retired_t;
+typedef struct objectmap_epoch_thread_t objectmap_epoch_thread_t;
+
+struct objectmap_retired_t {
+	object_t id;
+	void* object;
+	object_deallocate_fn deallocate;
+	int64_t epoch;
+};
+
+FOUNDATION_ALIGNED_STRUCT(objectmap_epoch_thread_t, 64) {
+	//Announced epoch while in read section, 0 if not reading
+	atomic64_t epoch;
+	atomic32_t owned;
+	unsigned int depth;
+	objectmap_retired_t* retired;
+	objectmap_epoch_thread_t* next;
+};
+
+static atomic64_t _objectmap_epoch;
+static atomicptr_t _objectmap_epoch_threads;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(objectmap_epoch_thread_t*, objectmap_epoch_thread, 0)
+
+int
+_objectmap_initialize(void) {
+	atomic_store64(&_objectmap_epoch, 1);
+	atomic_storeptr(&_objectmap_epoch_threads, 0);
+	return 0;
+}
+
+void
+_objectmap_finalize(void) {
+	size_t iretired, size;
+	objectmap_epoch_thread_t* epoch_thread = atomic_loadptr(&_objectmap_epoch_threads);
+	atomic_storeptr(&_objectmap_epoch_threads, 0);
+	set_thread_objectmap_epoch_thread(0);
+
+	//No readers left, run all pending deallocations
+	while (epoch_thread) {
+		objectmap_epoch_thread_t* next = epoch_thread->next;
+		for (iretired = 0, size = array_size(epoch_thread->retired); iretired < size; ++iretired) {
+			objectmap_retired_t* retired = epoch_thread->retired + iretired;
+			retired->deallocate(retired->id, retired->object);
+		}
+		array_deallocate(epoch_thread->retired);
+		memory_deallocate(epoch_thread);
+		epoch_thread = next;
+	}
+}
+
+static objectmap_epoch_thread_t*
+_objectmap_epoch_thread(void) {
+	objectmap_epoch_thread_t* epoch_thread = get_thread_objectmap_epoch_thread();
+	void* head;
+	if (epoch_thread)
+		return epoch_thread;
+
+	//Reuse state released by a finished thread, or add new state
+	for (epoch_thread = atomic_loadptr(&_objectmap_epoch_threads); epoch_thread;
+	        epoch_thread = epoch_thread->next) {
+		if (!atomic_load32(&epoch_thread->owned) && atomic_cas32(&epoch_thread->owned, 1, 0))
+			break;
+	}
+	if (!epoch_thread) {
+		epoch_thread = memory_allocate(0, sizeof(objectmap_epoch_thread_t), 64,
+		                               MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		atomic_store32(&epoch_thread->owned, 1);
+		do {
+			head = atomic_loadptr(&_objectmap_epoch_threads);
+			epoch_thread->next = head;
+		}
+		while (!atomic_cas_ptr(&_objectmap_epoch_threads, epoch_thread, head));
+	}
+
+	set_thread_objectmap_epoch_thread(epoch_thread);
+	return epoch_thread;
+}
+
+static void
+_objectmap_epoch_advance(void) {
+	objectmap_epoch_thread_t* epoch_thread;
+	int64_t epoch = atomic_load64(&_objectmap_epoch);
+
+	//Epoch can only advance once all threads in a read section have observed current epoch
+	atomic_thread_fence_sequentially_consistent();
+	for (epoch_thread = atomic_loadptr(&_objectmap_epoch_threads); epoch_thread;
+	        epoch_thread = epoch_thread->next) {
+		int64_t announced = atomic_load64(&epoch_thread->epoch);
+		if (announced && (announced != epoch))
+			return;
+	}
+	atomic_cas64(&_objectmap_epoch, epoch + 1, epoch);
+}
+
+static size_t
+_objectmap_epoch_reclaim(objectmap_epoch_thread_t* epoch_thread) {
+	size_t iretired, reclaimed = 0;
+	int64_t epoch;
+
+	if (!array_size(epoch_thread->retired))
+		return 0;
+
+	//Objects retired in epoch N might be in use by readers until epoch N+2
+	_objectmap_epoch_advance();
+	_objectmap_epoch_advance();
+	epoch = atomic_load64(&_objectmap_epoch);
+
+	for (iretired = 0; iretired < array_size(epoch_thread->retired);) {
+		objectmap_retired_t retired = epoch_thread->retired[iretired];
+		if (retired.epoch + 2 <= epoch) {
+			array_erase_memcpy(epoch_thread->retired, iretired);
+			retired.deallocate(retired.id, retired.object);
+			++reclaimed;
+		}
+		else {
+			++iretired;
+		}
+	}
+	return reclaimed;
+}
+
+void
+_objectmap_thread_finalize(void) {
+	objectmap_epoch_thread_t* epoch_thread = get_thread_objectmap_epoch_thread();
+	if (!epoch_thread)
+		return;
+
+	//Pending deallocations are left for the next thread using this state
+	epoch_thread->depth = 0;
+	atomic_store64(&epoch_thread->epoch, 0);
+	_objectmap_epoch_reclaim(epoch_thread);
+	set_thread_objectmap_epoch_thread(0);
+	atomic_thread_fence_release();
+	atomic_store32(&epoch_thread->owned, 0);
+}
+
+void
+objectmap_read_begin(void) {
+	objectmap_epoch_thread_t* epoch_thread = _objectmap_epoch_thread();
+	if (!epoch_thread->depth++) {
+		atomic_store64(&epoch_thread->epoch, atomic_load64(&_objectmap_epoch));
+		atomic_thread_fence_sequentially_consistent();
+	}
+}
+
+void
+objectmap_read_end(void) {
+	objectmap_epoch_thread_t* epoch_thread = get_thread_objectmap_epoch_thread();
+	FOUNDATION_ASSERT_MSG(epoch_thread && epoch_thread->depth, "Mismatched objectmap read section");
+	if (!--epoch_thread->depth) {
+		atomic_thread_fence_release();
+		atomic_store64(&epoch_thread->epoch, 0);
+	}
+}
+
+size_t
+objectmap_reclaim(void) {
+	objectmap_epoch_thread_t* epoch_thread = get_thread_objectmap_epoch_thread();
+	return epoch_thread ? _objectmap_epoch_reclaim(epoch_thread) : 0;
+}
+
 objectmap_t*
 objectmap_allocate(size_t size) {
 	objectmap_t* map;
@@ -36,32 +201,92 @@ objectmap_allocate(size_t size) {
 	return map;
 }
 
-void
-objectmap_initialize(objectmap_t* map, size_t size) {
-	unsigned int bits;
-	unsigned int ip;
-	uintptr_t next_indexshift;
-	void** slot;
+objectmap_t*
+objectmap_allocate_growable(size_t segment_size, size_t segment_max) {
+	objectmap_t* map;
 
-	//Number of bits needed to represent index
-	bits = (unsigned int)math_round(math_log2((real)size));
-	FOUNDATION_ASSERT_MSGFORMAT(bits < 50, "Invalid objectmap size %" PRIsize, size);
+	map = memory_allocate(0, sizeof(objectmap_t), 16, MEMORY_PERSISTENT);
 
-	memset(map, 0, sizeof(objectmap_t) + (sizeof(void*) * size));
+	objectmap_initialize_growable(map, segment_size, segment_max);
+
+	return map;
+}
+
+static FOUNDATION_FORCEINLINE void**
+_objectmap_slot(const objectmap_t* map, uint64_t idx) {
+	void** segment = map->segment[idx >> map->segment_shift];
+	return segment ? segment + (idx & map->mask_segment) : 0;
+}
+
+static unsigned int
+_objectmap_index_bits(size_t size) {
+	//Number of bits needed to represent index, with all bits set reserved as free list end
+	unsigned int bits = 1;
+	while ((1ULL << bits) <= size)
+		++bits;
+	return bits;
+}
+
+static void
+_objectmap_initialize_layout(objectmap_t* map, size_t size, unsigned int segment_shift,
+                             unsigned int segment_max) {
+	unsigned int bits = _objectmap_index_bits(size);
+	FOUNDATION_ASSERT_MSGFORMAT(bits < 50, "Invalid objectmap size %" PRIsize, size);
 
 	//Top two bits unused for Lua compatibility
-	map->size_bits   = bits;
-	map->id_max      = ((1ULL << (62ULL - bits)) - 1);
-	map->size        = size;
-	map->mask_index  = ((1ULL << bits) - 1ULL);
-	map->mask_id     = (0x3FFFFFFFFFFFFFFFULL & ~map->mask_index);
+	map->size_bits     = bits;
+	map->id_max        = ((1ULL << (62ULL - bits)) - 1);
+	map->size          = size;
+	map->mask_index    = ((1ULL << bits) - 1ULL);
+	map->mask_id       = (0x3FFFFFFFFFFFFFFFULL & ~map->mask_index);
+	map->segment_shift = segment_shift;
+	map->segment_max   = segment_max;
+	map->mask_segment  = ((1ULL << segment_shift) - 1ULL);
+	map->segment       = memory_allocate(0, sizeof(void**) * ((map->mask_index >> segment_shift) + 1),
+	                                     0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
 	atomic_store64(&map->free, 0);
 	atomic_store64(&map->id, 1);
+	atomic_store32(&map->segment_lock, 0);
+}
+
+static void
+_objectmap_link(objectmap_t* map, void** slot, uint64_t base, size_t count) {
+	size_t islot;
+	uintptr_t next_indexshift = (uintptr_t)((base + 1) << 1) | 1;
+	for (islot = 0; islot < (count - 1); ++islot, next_indexshift += 2)
+		slot[islot] = (void*)next_indexshift;
+	slot[islot] = (void*)((uintptr_t)(map->mask_index << 1) | 1);
+}
+
+void
+objectmap_initialize(objectmap_t* map, size_t size) {
+	memset(map, 0, sizeof(objectmap_t) + (sizeof(void*) * size));
+
+	//Single segment spanning entire index range
+	_objectmap_initialize_layout(map, size, _objectmap_index_bits(size), 1);
+	_objectmap_link(map, map->map, 0, size);
+	map->segment[0] = map->map;
+	atomic_store32(&map->segment_count, 1);
+}
 
-	slot = map->map;
-	for (ip = 0, next_indexshift = 3; ip < (size - 1); ++ip, next_indexshift += 2, ++slot)
-		*slot = (void*)next_indexshift;
-	*slot = (void*)((uintptr_t)-1);
+void
+objectmap_initialize_growable(objectmap_t* map, size_t segment_size, size_t segment_max) {
+	unsigned int segment_shift = 4;
+	void** segment;
+
+	while ((1ULL << segment_shift) < segment_size)
+		++segment_shift;
+	if (!segment_max)
+		segment_max = 1;
+
+	memset(map, 0, sizeof(objectmap_t));
+
+	_objectmap_initialize_layout(map, segment_max << segment_shift, segment_shift,
+	                             (unsigned int)segment_max);
+	segment = memory_allocate(0, sizeof(void*) << segment_shift, 0, MEMORY_PERSISTENT);
+	_objectmap_link(map, segment, 0, 1ULL << segment_shift);
+	map->segment[0] = segment;
+	atomic_store32(&map->segment_count, 1);
 }
 
 void
@@ -72,24 +297,35 @@ objectmap_deallocate(objectmap_t* map) {
 
 void
 objectmap_finalize(objectmap_t* map) {
-	size_t i;
+	size_t i, size;
+	int32_t isegment, segment_count;
 
 	if (!map)
 		return;
 
-	for (i = 0; i < map->size; ++i) {
-		bool is_object = !((uintptr_t)map->map[i] & 1);
+	for (i = 0, size = objectmap_size(map); i < size; ++i) {
+		bool is_object = !((uintptr_t)*_objectmap_slot(map, i) & 1);
 		if (is_object) {
 			log_error(0, ERROR_MEMORY_LEAK,
 			          STRING_CONST("Object still stored in objectmap when map deallocated"));
 			break;
 		}
 	}
+
+	segment_count = atomic_load32(&map->segment_count);
+	for (isegment = 0; isegment < segment_count; ++isegment) {
+		if (map->segment[isegment] != map->map)
+			memory_deallocate(map->segment[isegment]);
+	}
+	memory_deallocate(map->segment);
+	map->segment = 0;
+	atomic_store32(&map->segment_count, 0);
 }
 
 size_t
 objectmap_size(const objectmap_t* map) {
-	return (unsigned int)map->size;
+	size_t allocated = (size_t)atomic_load32(&map->segment_count) << map->segment_shift;
+	return (allocated < map->size) ? allocated : map->size;
 }
 
 void*
@@ -97,36 +333,84 @@ objectmap_raw_lookup(const objectmap_t* map, size_t idx) {
 	uintptr_t ptr;
 
 	/*lint --e{613} Performance path (no ptr checks)*/
-	ptr = (uintptr_t)map->map[idx];
+	ptr = (uintptr_t)*_objectmap_slot(map, idx);
 	return (ptr & 1) ? 0 : (void*)ptr;
 }
 
-object_t
-objectmap_reserve(objectmap_t* map) {
+static void
+_objectmap_push(objectmap_t* map, uint64_t first, uint64_t last) {
+	uint64_t raw, free;
+	void** slot = _objectmap_slot(map, last);
+
+	free = first | (((uint64_t)atomic_incr64(&map->id) << map->size_bits) & map->mask_id);
+	do {
+		raw = (uint64_t)atomic_load64(&map->free);
+		*slot = (void*)((uintptr_t)((raw & map->mask_index) << 1) | 1);
+	}
+	while (!atomic_cas64(&map->free, (int64_t)free, (int64_t)raw));
+}
+
+static bool
+_objectmap_grow(objectmap_t* map) {
+	uint64_t base, segment_size = 1ULL << map->segment_shift;
+	int32_t segment_count;
+	void** segment;
+	bool grown = false;
+
+	while (!atomic_cas32(&map->segment_lock, 1, 0))
+		thread_yield();
+
+	//Another thread might have grown the map or freed slots while waiting for lock
+	segment_count = atomic_load32(&map->segment_count);
+	if (((uint64_t)atomic_load64(&map->free) & map->mask_index) < map->size) {
+		grown = true;
+	}
+	else if ((unsigned int)segment_count < map->segment_max) {
+		segment = memory_allocate(0, sizeof(void*) * segment_size, 0, MEMORY_PERSISTENT);
+		if (segment) {
+			base = (uint64_t)segment_count << map->segment_shift;
+			_objectmap_link(map, segment, base, segment_size);
+			map->segment[segment_count] = segment;
+			atomic_thread_fence_release();
+			atomic_store32(&map->segment_count, segment_count + 1);
+			_objectmap_push(map, base, base + segment_size - 1);
+			grown = true;
+		}
+	}
+
+	atomic_store32(&map->segment_lock, 0);
+	return grown;
+}
+
+static uint64_t
+_objectmap_pop(objectmap_t* map, uint64_t tag) {
 	uint64_t raw, idx;
 	uint64_t next;
 
-	//Reserve spot in array, using tag for ABA protection
-	uint64_t tag = (uint64_t)atomic_incr64(&map->id) & map->id_max;
-	while (!tag)
-		tag = (uint64_t)atomic_incr64(&map->id) & map->id_max; //Wrap-around handled by masking
-	//TODO: Look into double-ended implementation with allocation from tail and free push to head
-	do {
+	//Pop slot from free list, using tag for ABA protection
+	while (true) {
 		raw = (uint64_t)atomic_load64(&map->free);
 		idx = raw & map->mask_index;
 		if (idx >= map->size) {
-			log_error(0, ERROR_OUT_OF_MEMORY, STRING_CONST("Map full, unable to reserve id"));
-			return 0;
+			if (!_objectmap_grow(map))
+				return idx;
+			continue;
 		}
-		next = (uintptr_t)map->map[idx] >> 1;
+		next = (uintptr_t)*_objectmap_slot(map, idx) >> 1;
 		next = (next & map->mask_index) | (tag << map->size_bits);
+		if (atomic_cas64(&map->free, (int64_t)next, (int64_t)raw))
+			return idx;
 	}
-	while (!atomic_cas64(&map->free, (int64_t)next, (int64_t)raw));
+}
+
+static object_t
+_objectmap_claim(objectmap_t* map, uint64_t idx, uint64_t tag) {
+	void** slot = _objectmap_slot(map, idx);
 
 	//Sanity check that slot isn't taken
-	FOUNDATION_ASSERT_MSG((uintptr_t)map->map[idx] & 1,
+	FOUNDATION_ASSERT_MSG((uintptr_t)*slot & 1,
 	                      "Map failed sanity check, slot taken after reserve");
-	map->map[idx] = 0;
+	*slot = 0;
 
 	//Make sure id stays within correct bits (if fails, check objectmap allocation and the mask setup there)
 	FOUNDATION_ASSERT(((tag << map->size_bits) & map->mask_id) == (tag << map->size_bits));
@@ -134,42 +418,183 @@ objectmap_reserve(objectmap_t* map) {
 	return (tag << map->size_bits) | idx;
 }
 
-bool
-objectmap_free(objectmap_t* map, object_t id) {
+object_t
+objectmap_reserve(objectmap_t* map) {
 	uint64_t idx;
-	uint64_t raw, next, free;
+
+	//Reserve spot in array, using tag for ABA protection
+	uint64_t tag = (uint64_t)atomic_incr64(&map->id) & map->id_max;
+	while (!tag)
+		tag = (uint64_t)atomic_incr64(&map->id) & map->id_max; //Wrap-around handled by masking
+
+	idx = _objectmap_pop(map, tag);
+	if (idx >= map->size) {
+		log_error(0, ERROR_OUT_OF_MEMORY, STRING_CONST("Map full, unable to reserve id"));
+		return 0;
+	}
+
+	return _objectmap_claim(map, idx, tag);
+}
+
+static void**
+_objectmap_validate_free(objectmap_t* map, object_t id) {
+	void** slot;
 	void* object;
 
-	idx = id & map->mask_index;
-	if ((uintptr_t)map->map[idx] & 1)
-		return false; //Already free
+	slot = _objectmap_slot(map, id & map->mask_index);
+	if (!slot || ((uintptr_t)*slot & 1))
+		return 0; //Already free
 
-	object = map->map[idx];
+	object = *slot;
 	if (!FOUNDATION_VALIDATE((((object_base_t*)object)->id & map->mask_id) == (id & map->mask_id)))
+		return 0;
+
+	return slot;
+}
+
+bool
+objectmap_free_deferred(objectmap_t* map, object_t id, object_deallocate_fn deallocate) {
+	objectmap_epoch_thread_t* epoch_thread;
+	objectmap_retired_t retired;
+	uint64_t idx = id & map->mask_index;
+	void** slot = _objectmap_validate_free(map, id);
+
+	if (!slot)
 		return false;
 
-	free = idx | (((uint64_t)atomic_incr64(&map->id) << map->size_bits) & map->mask_id);
+	retired.id = id;
+	retired.object = *slot;
+	retired.deallocate = deallocate;
+
+	_objectmap_push(map, idx, idx);
+
+	//Epoch must be read after slot is reused so readers observing the object are accounted for
+	atomic_thread_fence_sequentially_consistent();
+	retired.epoch = atomic_load64(&_objectmap_epoch);
+
+	epoch_thread = _objectmap_epoch_thread();
+	array_push_memcpy(epoch_thread->retired, &retired);
+	if (array_size(epoch_thread->retired) >= OBJECTMAP_RECLAIM_THRESHOLD)
+		_objectmap_epoch_reclaim(epoch_thread);
+
+	return true;
+}
+
+void*
+objectmap_next(const objectmap_t* map, size_t* index) {
+	size_t idx, size;
+	for (idx = *index, size = objectmap_size(map); idx < size; ++idx) {
+		void* object = *_objectmap_slot(map, idx);
+		if (object && !((uintptr_t)object & 1)) {
+			*index = idx + 1;
+			return object;
+		}
+	}
+	*index = size;
+	return 0;
+}
+
+bool
+objectmap_free(objectmap_t* map, object_t id) {
+	uint64_t idx = id & map->mask_index;
+
+	if (!_objectmap_validate_free(map, id))
+		return false;
+
+	_objectmap_push(map, idx, idx);
+
+	return true;
+}
+
+void
+objectmap_magazine_initialize(objectmap_magazine_t* magazine, objectmap_t* map) {
+	magazine->map = map;
+	magazine->count = 0;
+	magazine->tag = 0;
+	magazine->tag_end = 0;
+}
+
+static void
+_objectmap_magazine_flush(objectmap_magazine_t* magazine, unsigned int count) {
+	unsigned int islot;
+	unsigned int first = magazine->count - count;
+	for (islot = first; islot < magazine->count - 1; ++islot)
+		*_objectmap_slot(magazine->map, magazine->slot[islot]) =
+		    (void*)((uintptr_t)(magazine->slot[islot + 1] << 1) | 1);
+	_objectmap_push(magazine->map, magazine->slot[first], magazine->slot[magazine->count - 1]);
+	magazine->count = first;
+}
+
+void
+objectmap_magazine_finalize(objectmap_magazine_t* magazine) {
+	if (magazine->count)
+		_objectmap_magazine_flush(magazine, magazine->count);
+	magazine->map = 0;
+}
+
+static uint64_t
+_objectmap_magazine_tag(objectmap_magazine_t* magazine) {
+	uint64_t tag;
+	//Reserve tags from map in blocks to avoid touching the shared counter for each slot
 	do {
-		raw = (uint64_t)atomic_load64(&map->free);
-		next = (raw & map->mask_index) |
-		       (((uint64_t)atomic_incr64(&map->id) << map->size_bits) & map->mask_id);
-		map->map[idx] = (void*)((uintptr_t)(next << 1) | 1);
+		if (magazine->tag == magazine->tag_end) {
+			magazine->tag_end = (uint64_t)atomic_add64(&magazine->map->id, OBJECTMAP_MAGAZINE_SIZE);
+			magazine->tag = magazine->tag_end - OBJECTMAP_MAGAZINE_SIZE;
+		}
+		tag = ++magazine->tag & magazine->map->id_max;
 	}
-	while (!atomic_cas64(&map->free, (int64_t)free, (int64_t)raw));
+	while (!tag);
+	return tag;
+}
+
+object_t
+objectmap_magazine_reserve(objectmap_magazine_t* magazine) {
+	objectmap_t* map = magazine->map;
+	uint64_t idx;
+
+	if (!magazine->count) {
+		while (magazine->count < OBJECTMAP_MAGAZINE_SIZE / 2) {
+			idx = _objectmap_pop(map, _objectmap_magazine_tag(magazine));
+			if (idx >= map->size)
+				break;
+			magazine->slot[magazine->count++] = idx;
+		}
+		if (!magazine->count) {
+			log_error(0, ERROR_OUT_OF_MEMORY, STRING_CONST("Map full, unable to reserve id"));
+			return 0;
+		}
+	}
+
+	idx = magazine->slot[--magazine->count];
+	return _objectmap_claim(map, idx, _objectmap_magazine_tag(magazine));
+}
+
+bool
+objectmap_magazine_free(objectmap_magazine_t* magazine, object_t id) {
+	void** slot = _objectmap_validate_free(magazine->map, id);
+	if (!slot)
+		return false;
+
+	if (magazine->count == OBJECTMAP_MAGAZINE_SIZE)
+		_objectmap_magazine_flush(magazine, OBJECTMAP_MAGAZINE_SIZE / 2);
+	*slot = (void*)((uintptr_t)1);
+	magazine->slot[magazine->count++] = id & magazine->map->mask_index;
 
 	return true;
 }
 
 bool
 objectmap_set(objectmap_t* map, object_t id, void* object) {
-	size_t idx;
+	void** slot;
 
-	idx = (size_t)(id & map->mask_index);
+	slot = _objectmap_slot(map, id & map->mask_index);
+	if (!slot)
+		return false;
 
 	//Sanity check, can't set free slot, and non-free slot should be initialized to 0 in reserve function
-	FOUNDATION_ASSERT(!(((uintptr_t)map->map[idx]) & 1));
-	if (FOUNDATION_VALIDATE(!map->map[idx])) {
-		map->map[idx] = object;
+	FOUNDATION_ASSERT(!(((uintptr_t)*slot) & 1));
+	if (FOUNDATION_VALIDATE(!*slot)) {
+		*slot = object;
 		return true;
 	}
 	return false;
@@ -177,11 +602,12 @@ objectmap_set(objectmap_t* map, object_t id, void* object) {
 
 void*
 objectmap_lookup_ref(const objectmap_t* map, object_t id) {
+	void** slot = _objectmap_slot(map, id & map->mask_index);
 	void* object;
 	int32_t ref;
 	do {
 		ref = 0;
-		object = map->map[ id & map->mask_index ];
+		object = slot ? *slot : 0;
 		if (object && !((uintptr_t)object & 1) &&
 		        ((((object_base_t*)object)->id & map->mask_id) == (id & map->mask_id))) {
 			object_base_t* base_obj = object;
@@ -196,11 +622,12 @@ objectmap_lookup_ref(const objectmap_t* map, object_t id) {
 
 bool
 objectmap_lookup_unref(const objectmap_t* map, object_t id, object_deallocate_fn deallocate) {
+	void** slot = _objectmap_slot(map, id & map->mask_index);
 	void* object;
 	int32_t ref;
 	do {
 		ref = 0;
-		object = map->map[ id & map->mask_index ];
+		object = slot ? *slot : 0;
 		if (object && !((uintptr_t)object & 1) &&
 		        ((((object_base_t*)object)->id & map->mask_id) == (id & map->mask_id))) {
 			object_base_t* base_obj = object;
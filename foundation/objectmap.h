@@ -16,7 +16,15 @@
 \brief Mapping of object handles to pointers
 
 Mapping of object handles to object pointers, thread safe and lock free. Used for all
-reference counted data in the library. Capacity of a map is fixed at allocation. */
+reference counted data in the library. Capacity of a map is either fixed at allocation, or
+grows in segments up to a maximum without moving existing slots. For high object churn
+from many threads, each thread can reserve and free slots through a magazine caching
+free slots, which avoids most operations on the shared free list.
+
+Read-mostly lookups can avoid reference count updates by looking up objects inside a read
+section (#objectmap_read_begin and #objectmap_read_end) and freeing objects through
+#objectmap_free_deferred, which defers the object deallocation until all read sections that
+might have observed the object have ended. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -28,7 +36,17 @@ should be deallocated with a call to #objectmap_deallocate.
 FOUNDATION_API objectmap_t*
 objectmap_allocate(size_t size);
 
-/*! Deallocate an object map previously allocated with a call to #objectmap_allocate.
+/*! Allocate storage for new map growing in segments of the given number of object slots.
+Segments are allocated on demand when the map is full, existing slots are never moved. The
+object map should be deallocated with a call to #objectmap_deallocate.
+\param segment_size Number of slots in a segment, rounded up to a power of two (minimum 16)
+\param segment_max  Maximum number of segments
+\return New object map */
+FOUNDATION_API objectmap_t*
+objectmap_allocate_growable(size_t segment_size, size_t segment_max);
+
+/*! Deallocate an object map previously allocated with a call to #objectmap_allocate or
+#objectmap_allocate_growable.
 Does not free the stored objects, only map storage.
 \param map Object map */
 FOUNDATION_API void
@@ -41,13 +59,23 @@ should be finalized with a call to #objectmap_finalize.
 FOUNDATION_API void
 objectmap_initialize(objectmap_t* map, size_t size);
 
-/*! Finalize an object map previously initialized with a call to #objectmap_initialize.
+/*! Initialize object map growing in segments, see #objectmap_allocate_growable. The map
+storage only needs to hold the objectmap_t structure. The object map should be finalized with
+a call to #objectmap_finalize.
+\param map          Object map
+\param segment_size Number of slots in a segment, rounded up to a power of two (minimum 16)
+\param segment_max  Maximum number of segments */
+FOUNDATION_API void
+objectmap_initialize_growable(objectmap_t* map, size_t segment_size, size_t segment_max);
+
+/*! Finalize an object map previously initialized with a call to #objectmap_initialize or
+#objectmap_initialize_growable.
 Does not free the stored objects.
 \param map Object map */
 FOUNDATION_API void
 objectmap_finalize(objectmap_t* map);
 
-/*! Get size of map (number of object slots)
+/*! Get size of map (number of currently allocated object slots)
 \param map Object map
 \return Size of map */
 FOUNDATION_API size_t
@@ -66,6 +94,78 @@ objectmap_reserve(objectmap_t* map);
 FOUNDATION_API bool
 objectmap_free(objectmap_t* map, object_t id);
 
+/*! Initialize a magazine for an object map. A magazine caches a number of free slots for
+use by a single thread, avoiding the atomic operations on the map free list for most
+reserve and free calls. Slots cached in a magazine are not available to other threads.
+Magazines are not thread safe.
+\param magazine Magazine
+\param map      Object map */
+FOUNDATION_API void
+objectmap_magazine_initialize(objectmap_magazine_t* magazine, objectmap_t* map);
+
+/*! Finalize a magazine and return all cached slots to the map. Must be called before
+the object map is finalized.
+\param magazine Magazine */
+FOUNDATION_API void
+objectmap_magazine_finalize(objectmap_magazine_t* magazine);
+
+/*! Reserve a slot through a magazine, refilling the magazine from the map if empty
+\param magazine Magazine
+\return         New object handle, 0 if none available */
+FOUNDATION_API object_t
+objectmap_magazine_reserve(objectmap_magazine_t* magazine);
+
+/*! Free a slot through a magazine, returning half the magazine to the map in a single
+operation if full
+\param magazine Magazine
+\param id       Object handle to free
+\return         true if object freed, false if not */
+FOUNDATION_API bool
+objectmap_magazine_free(objectmap_magazine_t* magazine, object_t id);
+
+/*! Free a slot in the map and defer deallocation of the stored object until no thread
+is in a read section which started before the slot was freed. The deallocation function is
+called in the context of a later call to #objectmap_free_deferred or #objectmap_reclaim by
+the calling thread, or at library finalization, and should only release the object since
+the slot is already freed.
+\param map        Object map
+\param id         Object handle to free
+\param deallocate Deallocation function
+\return           true if object freed, false if not */
+FOUNDATION_API bool
+objectmap_free_deferred(objectmap_t* map, object_t id, object_deallocate_fn deallocate);
+
+/*! Begin a read section for the calling thread. Object pointers returned by
+#objectmap_lookup inside a read section stay valid until the matching #objectmap_read_end,
+as long as objects are freed with #objectmap_free_deferred. Read sections can be nested
+and apply to all object maps. */
+FOUNDATION_API void
+objectmap_read_begin(void);
+
+/*! End a read section started by #objectmap_read_begin */
+FOUNDATION_API void
+objectmap_read_end(void);
+
+/*! Run deferred deallocations queued by the calling thread that are no longer observable by
+any read section
+\return Number of objects deallocated */
+FOUNDATION_API size_t
+objectmap_reclaim(void);
+
+/*! Iterate live objects in the map. Start iteration with the index set to zero, the index is
+updated to continue iteration in the next call. Slots reserved but not yet set are skipped.
+Iteration does not increase object reference counts, use inside a read section or otherwise
+guarantee object lifetime.
+<code>size_t index = 0;
+void* object;
+while ((object = objectmap_next(map, &index)))
+  do_something(object);</code>
+\param map   Object map
+\param index Iteration index
+\return      Next object, 0 if no more objects */
+FOUNDATION_API void*
+objectmap_next(const objectmap_t* map, size_t* index);
+
 /*! Set object pointer for given slot
 \param map Object map
 \param id Object handle
@@ -120,7 +220,9 @@ objectmap_lookup_unref(const objectmap_t* map, object_t id, object_deallocate_fn
 
 static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL void*
 objectmap_lookup(const objectmap_t* map, object_t id) {
-  void* object = map->map[ id & map->mask_index ];
+  uint64_t idx = id & map->mask_index;
+  void** segment = map->segment[ idx >> map->segment_shift ];
+  void* object = segment ? segment[ idx & map->mask_segment ] : 0;
   return (object && !((uintptr_t)object & 1) &&
           ((((object_base_t*)object)->id & map->mask_id) == (id & map->mask_id)) ?
           object : 0);
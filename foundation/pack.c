@@ -0,0 +1,452 @@
+/* pack.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+//Pack magic "FPK1", all values in file are little endian
+#define PACK_MAGIC 0x314B5046U
+#define PACK_ALIGNMENT 64
+
+/* File layout is header, entry table, hash slot table, entry names and entry data. Slots hold
+the entry index plus one in a linear probed open addressed table, zero for empty slots. The
+slot count is a power of two larger than the entry count, so probing always terminates. */
+struct pack_header_t {
+	uint32_t magic;
+	uint32_t entry_count;
+	uint32_t slot_count;
+	uint32_t reserved;
+	uint64_t names_offset;
+	uint64_t names_size;
+};
+
+typedef struct pack_header_t pack_header_t;
+
+struct pack_entry_t {
+	uint64_t hash;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t stored_size;
+	uint32_t flags;
+	uint32_t name_offset;
+	uint32_t name_length;
+	uint32_t reserved;
+};
+
+typedef struct pack_entry_t pack_entry_t;
+
+struct pack_t {
+	string_t path;
+	stream_t* stream;
+	void* memory;
+	const uint8_t* data;
+	size_t size;
+	const pack_entry_t* entries;
+	const uint32_t* slots;
+	const char* names;
+	size_t entry_count;
+	size_t slot_mask;
+	tick_t last_modified;
+	bool mounted;
+};
+
+struct pack_builder_entry_t {
+	string_t name;
+	hash_t hash;
+	void* data;
+	size_t size;
+	size_t stored_size;
+	unsigned int flags;
+};
+
+typedef struct pack_builder_entry_t pack_builder_entry_t;
+
+struct pack_builder_t {
+	pack_builder_entry_t* entries;
+	hashmap_t* names;
+};
+
+static mutex_t* _pack_lock;
+static pack_t** _pack_mounted;
+
+static string_const_t
+_pack_entry_name(const char* name, size_t length) {
+	while (length && (*name == '/')) {
+		++name;
+		--length;
+	}
+	return string_const(name, length);
+}
+
+static const pack_entry_t*
+_pack_lookup(const pack_t* pack, const char* name, size_t length) {
+	const pack_entry_t* entry;
+	string_const_t entryname = _pack_entry_name(name, length);
+	hash_t key = hash(STRING_ARGS(entryname));
+	size_t islot = (size_t)key & pack->slot_mask;
+	uint32_t index;
+
+	while ((index = byteorder_littleendian32(pack->slots[islot])) != 0) {
+		entry = pack->entries + (index - 1);
+		if ((byteorder_littleendian64(entry->hash) == key) &&
+		        string_equal(pack->names + byteorder_littleendian32(entry->name_offset),
+		                     byteorder_littleendian32(entry->name_length), STRING_ARGS(entryname)))
+			return entry;
+		islot = (islot + 1) & pack->slot_mask;
+	}
+	return 0;
+}
+
+static bool
+_pack_validate(pack_t* pack) {
+	const pack_header_t* header = (const pack_header_t*)pack->data;
+	size_t ientry, islot, slot_count, index_size, names_offset, names_size;
+
+	if ((pack->size < sizeof(pack_header_t)) ||
+	        (byteorder_littleendian32(header->magic) != PACK_MAGIC))
+		return false;
+
+	pack->entry_count = byteorder_littleendian32(header->entry_count);
+	slot_count = byteorder_littleendian32(header->slot_count);
+	names_offset = (size_t)byteorder_littleendian64(header->names_offset);
+	names_size = (size_t)byteorder_littleendian64(header->names_size);
+	index_size = sizeof(pack_header_t) + (sizeof(pack_entry_t) * pack->entry_count) +
+	             (sizeof(uint32_t) * slot_count);
+	if ((slot_count <= pack->entry_count) || (slot_count & (slot_count - 1)) ||
+	        (index_size > names_offset) || (names_offset > pack->size) ||
+	        (names_size > pack->size - names_offset))
+		return false;
+
+	pack->entries = pointer_offset_const(pack->data, sizeof(pack_header_t));
+	pack->slots = (const uint32_t*)(pack->entries + pack->entry_count);
+	pack->names = pointer_offset_const(pack->data, names_offset);
+	pack->slot_mask = slot_count - 1;
+
+	for (islot = 0; islot < slot_count; ++islot) {
+		if (byteorder_littleendian32(pack->slots[islot]) > pack->entry_count)
+			return false;
+	}
+	for (ientry = 0; ientry < pack->entry_count; ++ientry) {
+		const pack_entry_t* entry = pack->entries + ientry;
+		uint64_t offset = byteorder_littleendian64(entry->offset);
+		uint64_t stored_size = byteorder_littleendian64(entry->stored_size);
+		uint64_t name_end = (uint64_t)byteorder_littleendian32(entry->name_offset) +
+		                    byteorder_littleendian32(entry->name_length);
+		if ((offset > pack->size) || (stored_size > pack->size - offset) || (name_end > names_size))
+			return false;
+	}
+	return true;
+}
+
+pack_t*
+pack_open(const char* path, size_t length) {
+	pack_t* pack = memory_allocate(HASH_STREAM, sizeof(pack_t), 0,
+	                               MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+
+	//Fall back to reading the file into memory if mapping is not supported
+	pack->stream = fs_map_file(path, length, STREAM_IN | STREAM_BINARY);
+	if (pack->stream) {
+		pack->data = fs_mapped_data(pack->stream, &pack->size);
+	}
+	else {
+		stream_t* file = fs_open_file(path, length, STREAM_IN | STREAM_BINARY);
+		if (file) {
+			pack->size = (size_t)stream_size(file);
+			pack->memory = memory_allocate(HASH_STREAM, pack->size ? pack->size : 1, 16,
+			                               MEMORY_PERSISTENT);
+			if (stream_read(file, pack->memory, pack->size) == pack->size)
+				pack->data = pack->memory;
+			stream_deallocate(file);
+		}
+	}
+
+	pack->path = string_clone(path, length);
+	if (!pack->data || !_pack_validate(pack)) {
+		if (pack->stream || pack->memory)
+			log_errorf(HASH_STREAM, ERROR_INVALID_VALUE, STRING_CONST("Invalid pack file: %.*s"),
+			           (int)length, path);
+		pack_close(pack);
+		return 0;
+	}
+	pack->last_modified = fs_last_modified(path, length);
+
+	return pack;
+}
+
+void
+pack_close(pack_t* pack) {
+	if (!pack)
+		return;
+	pack_unmount(pack);
+	if (pack->stream)
+		stream_deallocate(pack->stream);
+	memory_deallocate(pack->memory);
+	string_deallocate(pack->path.str);
+	memory_deallocate(pack);
+}
+
+void
+pack_mount(pack_t* pack) {
+	mutex_lock(_pack_lock);
+	if (!pack->mounted) {
+		pack->mounted = true;
+		array_push(_pack_mounted, pack);
+	}
+	mutex_unlock(_pack_lock);
+}
+
+void
+pack_unmount(pack_t* pack) {
+	size_t ipack, size;
+	if (!pack->mounted || !_pack_lock)
+		return;
+	mutex_lock(_pack_lock);
+	for (ipack = 0, size = array_size(_pack_mounted); ipack < size; ++ipack) {
+		if (_pack_mounted[ipack] == pack) {
+			array_erase_ordered(_pack_mounted, ipack);
+			break;
+		}
+	}
+	pack->mounted = false;
+	mutex_unlock(_pack_lock);
+}
+
+size_t
+pack_entry_count(const pack_t* pack) {
+	return pack->entry_count;
+}
+
+string_const_t
+pack_entry_name(const pack_t* pack, size_t index) {
+	const pack_entry_t* entry = pack->entries + index;
+	return string_const(pack->names + byteorder_littleendian32(entry->name_offset),
+	                    byteorder_littleendian32(entry->name_length));
+}
+
+bool
+pack_has_entry(const pack_t* pack, const char* name, size_t length) {
+	return _pack_lookup(pack, name, length) != 0;
+}
+
+const void*
+pack_entry_data(const pack_t* pack, const char* name, size_t length, size_t* size) {
+	const pack_entry_t* entry = _pack_lookup(pack, name, length);
+	if (size)
+		*size = 0;
+	if (!entry || (byteorder_littleendian32(entry->flags) & PACK_ENTRY_COMPRESSED) ||
+	        !entry->size)
+		return 0;
+	if (size)
+		*size = (size_t)byteorder_littleendian64(entry->size);
+	return pack->data + byteorder_littleendian64(entry->offset);
+}
+
+stream_t*
+pack_open_entry(const pack_t* pack, const char* name, size_t length, unsigned int mode) {
+	stream_buffer_t* buffer;
+	string_const_t entryname;
+	const pack_entry_t* entry = _pack_lookup(pack, name, length);
+	if (!entry || (mode & STREAM_OUT))
+		return 0;
+
+	//Stored data is read in place from the mapped pack
+	buffer = (stream_buffer_t*)buffer_stream_allocate(
+	             (void*)(uintptr_t)(pack->data + byteorder_littleendian64(entry->offset)),
+	             STREAM_IN | (mode & STREAM_BINARY),
+	             (size_t)byteorder_littleendian64(entry->stored_size),
+	             (size_t)byteorder_littleendian64(entry->stored_size), false, false);
+	entryname = pack_entry_name(pack, (size_t)(entry - pack->entries));
+	string_deallocate(buffer->path.str);
+	buffer->path = string_allocate_concat(STRING_CONST("pack://"), STRING_ARGS(entryname));
+	buffer->lastmod = pack->last_modified;
+
+	if (byteorder_littleendian32(entry->flags) & PACK_ENTRY_COMPRESSED)
+		return compressed_stream_allocate((stream_t*)buffer, STREAM_IN, 0, true);
+	if (mode & STREAM_ATEND)
+		stream_seek((stream_t*)buffer, 0, STREAM_SEEK_END);
+	return (stream_t*)buffer;
+}
+
+stream_t*
+pack_stream_open(const char* path, size_t length, unsigned int mode) {
+	stream_t* stream = 0;
+	string_const_t name = path_strip_protocol(path, length);
+	size_t ipack;
+
+	mutex_lock(_pack_lock);
+	for (ipack = array_size(_pack_mounted); !stream && ipack; --ipack)
+		stream = pack_open_entry(_pack_mounted[ipack - 1], STRING_ARGS(name), mode);
+	mutex_unlock(_pack_lock);
+
+	return stream;
+}
+
+pack_builder_t*
+pack_builder_allocate(void) {
+	pack_builder_t* builder = memory_allocate(HASH_STREAM, sizeof(pack_builder_t), 0,
+	                                          MEMORY_PERSISTENT);
+	builder->entries = 0;
+	builder->names = hashmap_allocate(13, 8);
+	return builder;
+}
+
+void
+pack_builder_deallocate(pack_builder_t* builder) {
+	size_t ientry, size;
+	if (!builder)
+		return;
+	for (ientry = 0, size = array_size(builder->entries); ientry < size; ++ientry) {
+		string_deallocate(builder->entries[ientry].name.str);
+		memory_deallocate(builder->entries[ientry].data);
+	}
+	array_deallocate(builder->entries);
+	hashmap_deallocate(builder->names);
+	memory_deallocate(builder);
+}
+
+bool
+pack_builder_add(pack_builder_t* builder, const char* name, size_t length, const void* data,
+                 size_t size, unsigned int flags) {
+	pack_builder_entry_t entry;
+	string_const_t entryname = _pack_entry_name(name, length);
+	hash_t key = hash(STRING_ARGS(entryname));
+	uintptr_t previous = (uintptr_t)hashmap_lookup(builder->names, key);
+
+	if (!entryname.length)
+		return false;
+	if (previous &&
+	        string_equal(STRING_ARGS(builder->entries[previous - 1].name), STRING_ARGS(entryname)))
+		return false;
+
+	entry.name = string_clone(STRING_ARGS(entryname));
+	entry.hash = key;
+	entry.size = size;
+	entry.flags = 0;
+	entry.data = 0;
+	entry.stored_size = size;
+
+	if ((flags & PACK_ENTRY_COMPRESSED) && size) {
+		stream_t* buffer = buffer_stream_allocate(0, STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+		stream_t* compressed = compressed_stream_allocate(buffer, STREAM_OUT, 0, false);
+		stream_buffer_t* buffer_stream = (stream_buffer_t*)buffer;
+		stream_write(compressed, data, size);
+		stream_deallocate(compressed);
+		if (buffer_stream->size < size) {
+			entry.data = buffer_stream->buffer;
+			entry.stored_size = buffer_stream->size;
+			entry.flags = PACK_ENTRY_COMPRESSED;
+			buffer_stream->own = false;
+		}
+		stream_deallocate(buffer);
+	}
+	if (!entry.data && size) {
+		entry.data = memory_allocate(HASH_STREAM, size, 0, MEMORY_PERSISTENT);
+		memcpy(entry.data, data, size);
+	}
+
+	array_push(builder->entries, entry);
+	if (!previous)
+		hashmap_insert(builder->names, key, (void*)(uintptr_t)array_size(builder->entries));
+	return true;
+}
+
+bool
+pack_builder_write(pack_builder_t* builder, stream_t* stream) {
+	static const uint8_t padding[PACK_ALIGNMENT];
+	size_t entry_count = array_size(builder->entries);
+	size_t slot_count = 2;
+	size_t ientry, islot, names_size, index_size, offset, written, expected;
+	pack_header_t* header;
+	pack_entry_t* entries;
+	uint32_t* slots;
+	char* names;
+	void* index;
+
+	while (slot_count < entry_count * 2)
+		slot_count <<= 1;
+	for (ientry = 0, names_size = 0; ientry < entry_count; ++ientry)
+		names_size += builder->entries[ientry].name.length;
+
+	//Build index in memory and write it in one go, followed by aligned entry data
+	index_size = sizeof(pack_header_t) + (sizeof(pack_entry_t) * entry_count) +
+	             (sizeof(uint32_t) * slot_count);
+	index = memory_allocate(HASH_STREAM, index_size + names_size, 8,
+	                        MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	header = index;
+	entries = pointer_offset(index, sizeof(pack_header_t));
+	slots = (uint32_t*)(entries + entry_count);
+	names = pointer_offset(index, index_size);
+
+	header->magic = byteorder_littleendian32(PACK_MAGIC);
+	header->entry_count = byteorder_littleendian32((uint32_t)entry_count);
+	header->slot_count = byteorder_littleendian32((uint32_t)slot_count);
+	header->names_offset = byteorder_littleendian64(index_size);
+	header->names_size = byteorder_littleendian64(names_size);
+
+	offset = (index_size + names_size + (PACK_ALIGNMENT - 1)) & ~(size_t)(PACK_ALIGNMENT - 1);
+
+	names_size = 0;
+	for (ientry = 0; ientry < entry_count; ++ientry) {
+		pack_builder_entry_t* source = builder->entries + ientry;
+		pack_entry_t* entry = entries + ientry;
+		entry->hash = byteorder_littleendian64(source->hash);
+		entry->offset = byteorder_littleendian64(offset);
+		entry->size = byteorder_littleendian64(source->size);
+		entry->stored_size = byteorder_littleendian64(source->stored_size);
+		entry->flags = byteorder_littleendian32(source->flags);
+		entry->name_offset = byteorder_littleendian32((uint32_t)names_size);
+		entry->name_length = byteorder_littleendian32((uint32_t)source->name.length);
+		memcpy(names + names_size, source->name.str, source->name.length);
+		names_size += source->name.length;
+		offset = (offset + source->stored_size + (PACK_ALIGNMENT - 1)) &
+		         ~(size_t)(PACK_ALIGNMENT - 1);
+
+		for (islot = (size_t)source->hash & (slot_count - 1); slots[islot];
+		        islot = (islot + 1) & (slot_count - 1)) {
+		}
+		slots[islot] = byteorder_littleendian32((uint32_t)(ientry + 1));
+	}
+
+	expected = index_size + names_size;
+	written = stream_write(stream, index, expected);
+	memory_deallocate(index);
+
+	offset = expected;
+	for (ientry = 0; (ientry < entry_count) && (written == expected); ++ientry) {
+		pack_builder_entry_t* source = builder->entries + ientry;
+		size_t pad = (PACK_ALIGNMENT - (offset & (PACK_ALIGNMENT - 1))) & (PACK_ALIGNMENT - 1);
+		expected += pad + source->stored_size;
+		written += stream_write(stream, padding, pad);
+		written += stream_write(stream, source->data, source->stored_size);
+		offset += pad + source->stored_size;
+	}
+
+	return written == expected;
+}
+
+int
+_pack_initialize(void) {
+	_pack_lock = mutex_allocate(STRING_CONST("pack"));
+	_pack_mounted = 0;
+	stream_set_protocol_handler(STRING_CONST("pack"), pack_stream_open);
+	return 0;
+}
+
+void
+_pack_finalize(void) {
+	size_t ipack, size;
+	for (ipack = 0, size = array_size(_pack_mounted); ipack < size; ++ipack)
+		_pack_mounted[ipack]->mounted = false;
+	array_deallocate(_pack_mounted);
+	mutex_deallocate(_pack_lock);
+	_pack_lock = 0;
+}
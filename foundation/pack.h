@@ -0,0 +1,143 @@
+/* pack.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file pack.h
+\brief Indexed pack files
+
+Pack files store any number of named entries in a single file. The file starts with an index
+holding a hash table of the entry names, allowing an entry to be located with a single hashed
+lookup without parsing the entire index. Entry data is aligned to 64 bytes and optionally
+compressed with the same block format as compressed streams.
+
+A pack is opened by memory mapping the file, reading an uncompressed entry is a zero-copy
+operation returning a pointer into the mapped file, see #pack_entry_data. Entries are opened as
+read-only streams with #pack_open_entry.
+
+Mounted packs are available through the "pack" stream protocol, for example
+stream_open("pack://data/config.json", ...). Entries are searched for in the mounted packs
+from the most recently mounted pack, allowing a pack to override entries of previously mounted
+packs.
+
+Entry names are stored as given with any leading slashes removed, names are case sensitive.
+Entry streams must be deallocated before the pack they were opened from is closed. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Open a pack file by memory mapping the file, or reading the file into memory on platforms
+not supporting memory mapped files. Close the pack with a call to #pack_close.
+\param path Path of pack file
+\param length Length of path
+\return Pack, 0 if the file could not be opened or is not a valid pack file */
+FOUNDATION_API pack_t*
+pack_open(const char* path, size_t length);
+
+/*! Close a pack previously opened with #pack_open, unmounting it if mounted
+\param pack Pack */
+FOUNDATION_API void
+pack_close(pack_t* pack);
+
+/*! Mount a pack, making the entries available through the "pack" stream protocol. Entries in
+the pack override entries with the same name in previously mounted packs.
+\param pack Pack */
+FOUNDATION_API void
+pack_mount(pack_t* pack);
+
+/*! Unmount a pack previously mounted with #pack_mount
+\param pack Pack */
+FOUNDATION_API void
+pack_unmount(pack_t* pack);
+
+/*! Get number of entries in a pack
+\param pack Pack
+\return Number of entries */
+FOUNDATION_API size_t
+pack_entry_count(const pack_t* pack);
+
+/*! Get name of an entry in a pack
+\param pack Pack
+\param index Entry index, must be less than #pack_entry_count
+\return Entry name */
+FOUNDATION_API string_const_t
+pack_entry_name(const pack_t* pack, size_t index);
+
+/*! Query if a pack contains an entry
+\param pack Pack
+\param name Entry name
+\param length Length of name
+\return true if the pack has an entry with the given name, false if not */
+FOUNDATION_API bool
+pack_has_entry(const pack_t* pack, const char* name, size_t length);
+
+/*! Get pointer to the data of an uncompressed entry in a pack. The pointer is valid until the
+pack is closed.
+\param pack Pack
+\param name Entry name
+\param length Length of name
+\param size Optional, receives the size of the entry data in bytes
+\return Pointer to entry data, 0 if the entry does not exist, is compressed or is empty */
+FOUNDATION_API const void*
+pack_entry_data(const pack_t* pack, const char* name, size_t length, size_t* size);
+
+/*! Open a read-only stream for an entry in a pack. Uncompressed entries are read directly
+from the mapped pack file, compressed entries are decompressed as read. Deallocate the stream
+with a call to #stream_deallocate before the pack is closed.
+\param pack Pack
+\param name Entry name
+\param length Length of name
+\param mode Open mode, must not include STREAM_OUT
+\return Stream, 0 if the entry does not exist */
+FOUNDATION_API stream_t*
+pack_open_entry(const pack_t* pack, const char* name, size_t length, unsigned int mode);
+
+/*! Open a read-only stream for an entry in the mounted packs. This is the handler of the "pack"
+stream protocol.
+\param path Entry name, optionally prefixed with "pack://"
+\param length Length of path
+\param mode Open mode, must not include STREAM_OUT
+\return Stream, 0 if no mounted pack has the entry */
+FOUNDATION_API stream_t*
+pack_stream_open(const char* path, size_t length, unsigned int mode);
+
+/*! Allocate a builder collecting entries for a pack file. Deallocate the builder with a call
+to #pack_builder_deallocate.
+\return New pack builder */
+FOUNDATION_API pack_builder_t*
+pack_builder_allocate(void);
+
+/*! Deallocate a pack builder and all collected entries
+\param builder Pack builder */
+FOUNDATION_API void
+pack_builder_deallocate(pack_builder_t* builder);
+
+/*! Add an entry to a pack builder. The data is copied, or compressed if the
+#PACK_ENTRY_COMPRESSED flag is set. Data that does not compress is stored uncompressed.
+\param builder Pack builder
+\param name Entry name
+\param length Length of name
+\param data Entry data
+\param size Size of entry data
+\param flags Entry flags
+\return true if added, false if the name is empty or already added */
+FOUNDATION_API bool
+pack_builder_add(pack_builder_t* builder, const char* name, size_t length, const void* data,
+                 size_t size, unsigned int flags);
+
+/*! Write a pack file with all entries added to the builder. The pack is written sequentially,
+any writable stream can be used including sequential streams.
+\param builder Pack builder
+\param stream Stream to write pack to
+\return true if successful, false if the pack could not be fully written */
+FOUNDATION_API bool
+pack_builder_write(pack_builder_t* builder, stream_t* stream);
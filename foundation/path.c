@@ -14,6 +14,76 @@
 
 #include <string.h>
 
+//Word at a time scan for path special characters, a word with no byte equal to any of them is
+//skipped as a whole (zero byte detection from "Bit Twiddling Hacks")
+#define PATH_WORD_ONES  0x0101010101010101ULL
+#define PATH_WORD_HIGHS 0x8080808080808080ULL
+#define PATH_WORD_HAS_ZERO(word) (((word) - PATH_WORD_ONES) & ~(word) & PATH_WORD_HIGHS)
+#define PATH_WORD_HAS_BYTE(word, byte) PATH_WORD_HAS_ZERO((word) ^ (PATH_WORD_ONES * (uint8_t)(byte)))
+
+bool
+path_is_clean(const char* path, size_t length) {
+	size_t ofs = 0;
+	size_t end;
+	size_t protocol_sep = 0;
+	bool firstsep = true;
+	char prev = 0;
+	char next;
+
+	while (ofs < length) {
+		end = length;
+		if (ofs + sizeof(uint64_t) <= length) {
+			uint64_t word;
+			memcpy(&word, path + ofs, sizeof(word));
+			if (!(PATH_WORD_HAS_BYTE(word, '/') | PATH_WORD_HAS_BYTE(word, '.') |
+			        PATH_WORD_HAS_BYTE(word, '\\') | PATH_WORD_HAS_BYTE(word, ':'))) {
+				ofs += sizeof(uint64_t);
+				prev = path[ofs - 1];
+				continue;
+			}
+			end = ofs + sizeof(uint64_t);
+		}
+		for (; ofs < end; prev = path[ofs++]) {
+			switch (path[ofs]) {
+			case '\\':
+				return false;
+
+			case ':':
+				if (!firstsep)
+					break;
+				//Leading colon is stripped, protocol "://" separator keeps the double slash
+				if (!ofs)
+					return false;
+				firstsep = false;
+				if ((ofs > 1) && (ofs + 2 < length) && (path[ofs + 1] == '/') && (path[ofs + 2] == '/'))
+					protocol_sep = ofs + 2;
+				break;
+
+			case '/':
+				firstsep = false;
+				if ((prev == '/') && (ofs != protocol_sep))
+					return false;
+				break;
+
+			case '.':
+				//"." and ".." segments are reduced
+				if (ofs && (prev != '/') && (prev != ':'))
+					break;
+				next = (ofs + 1 < length) ? path[ofs + 1] : '/';
+				if (next == '/')
+					return false;
+				if ((next == '.') && ((ofs + 2 == length) || (path[ofs + 2] == '/')))
+					return false;
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+	return true;
+}
+
 string_t
 path_clean(char* path, size_t length, size_t capacity) {
 	size_t ofs;
@@ -26,6 +96,9 @@ path_clean(char* path, size_t length, size_t capacity) {
 
 	FOUNDATION_UNUSED(capacity);
 
+	if (path_is_clean(path, length))
+		return (string_t) { path, length };
+
 	for (ofs = 0; ofs < length;) {
 		if (path[ofs] == ':') {
 			if (firstsep) {
@@ -549,6 +622,12 @@ path_is_absolute(const char* path, size_t length) {
 string_t
 path_absolute(char* path, size_t length, size_t capacity) {
 	string_t abspath;
+	if (path_is_absolute(path, length) && path_is_clean(path, length)) {
+		//Clean paths have no "." or ".." segments left to discard
+		if (length < capacity)
+			path[length] = 0;
+		return (string_t) { path, length };
+	}
 	if (!path_is_absolute(path, length)) {
 		string_const_t cwd = environment_current_working_directory();
 		abspath = path_clean(path, length, capacity);
@@ -563,8 +642,8 @@ path_absolute(char* path, size_t length, size_t capacity) {
 	abspath = string_replace(STRING_ARGS(abspath), capacity, STRING_CONST("/../"), STRING_CONST("/"),
 	                         true);
 
-	if (abspath.length >= 3 && (abspath.str[length - 3] == '/') && (abspath.str[length - 2] == '.') &&
-	        (abspath.str[length - 1] == '.')) {
+	if (abspath.length >= 3 && (abspath.str[abspath.length - 3] == '/') &&
+	        (abspath.str[abspath.length - 2] == '.') && (abspath.str[abspath.length - 1] == '.')) {
 		if (abspath.length == 3)
 			abspath.length = 1;
 		else
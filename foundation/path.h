@@ -302,6 +302,16 @@ is zero,
 FOUNDATION_API string_t
 path_clean(char* path, size_t length, size_t capacity);
 
+/*! Check if path is already clean, meaning #path_clean would leave it unmodified. The check
+is a single read-only pass over the string, scanning a word at a time for separator, dot and
+colon characters, and allows callers to skip copying a path to a buffer for cleaning. The
+check is conservative, a few unusual paths that are clean are reported as not clean.
+\param path Path string
+\param length Length of path
+\return true if path is clean, false if it must be passed through #path_clean */
+FOUNDATION_API bool
+path_is_clean(const char* path, size_t length);
+
 /*! Check if path is absolute. An absolute path is either an URI or a file path that starts
 with a directory separator or a volume identificator
 \param path Path
@@ -168,6 +168,57 @@ pipe_write_handle(stream_t* stream) {
 
 #endif
 
+void
+pipe_set_nonblocking(stream_t* stream, bool nonblocking) {
+	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
+	if (!stream || (stream->type != STREAMTYPE_PIPE))
+		return;
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (pipestream->handle_write) {
+		DWORD mode = nonblocking ? PIPE_NOWAIT : PIPE_WAIT;
+		SetNamedPipeHandleState(pipestream->handle_write, &mode, 0, 0);
+	}
+#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
+	int fds[2] = {pipestream->fd_read, pipestream->fd_write};
+	int ifd;
+	for (ifd = 0; ifd < 2; ++ifd) {
+		int flags = fds[ifd] ? fcntl(fds[ifd], F_GETFL) : -1;
+		if (flags >= 0)
+			fcntl(fds[ifd], F_SETFL, nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+	}
+#endif
+	pipestream->nonblocking = nonblocking;
+}
+
+size_t
+pipe_tee(stream_t* dest, stream_t* source, size_t bytes) {
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	stream_pipe_t* to = (stream_pipe_t*)dest;
+	stream_pipe_t* from = (stream_pipe_t*)source;
+	ssize_t done;
+
+	if (!dest || !source || (dest->type != STREAMTYPE_PIPE) || (source->type != STREAMTYPE_PIPE) ||
+	        !from->fd_read || !to->fd_write)
+		return 0;
+
+	if (!bytes || (bytes > INT_MAX))
+		bytes = INT_MAX;
+	do {
+		done = tee(from->fd_read, to->fd_write, bytes, 0);
+	}
+	while ((done < 0) && (errno == EINTR));
+
+	if (!done)
+		from->eos = true;
+	return (done > 0) ? (size_t)done : 0;
+#else
+	FOUNDATION_UNUSED(dest);
+	FOUNDATION_UNUSED(source);
+	FOUNDATION_UNUSED(bytes);
+	return 0;
+#endif
+}
+
 static size_t
 _pipe_stream_read(stream_t* stream, void* dest, size_t num) {
 	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
@@ -175,6 +226,19 @@ _pipe_stream_read(stream_t* stream, void* dest, size_t num) {
 #if FOUNDATION_PLATFORM_WINDOWS
 	if (pipestream->handle_read && ((pipestream->mode & STREAM_IN) != 0)) {
 		size_t total_read = 0;
+		if (pipestream->nonblocking) {
+			//Limit read to available data to avoid blocking
+			DWORD available = 0;
+			if (!PeekNamedPipe(pipestream->handle_read, 0, 0, 0, &available, 0)) {
+				if (GetLastError() == ERROR_BROKEN_PIPE)
+					pipestream->eos = true;
+				return 0;
+			}
+			if (available < num)
+				num = available;
+			if (!num)
+				return 0;
+		}
 		do {
 			DWORD num_read = 0;
 			if (!ReadFile(pipestream->handle_read, pointer_offset(dest, total_read),
@@ -204,7 +268,10 @@ _pipe_stream_read(stream_t* stream, void* dest, size_t num) {
 			ssize_t num_read = read(pipestream->fd_read, pointer_offset(dest, total_read),
 			                        (size_t)(num - total_read));
 			if (num_read <= 0) {
-				pipestream->eos = true;
+				//Non-blocking read with no more available data is not end of stream
+				if (!num_read || !pipestream->nonblocking ||
+				        ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+					pipestream->eos = true;
 				break;
 			}
 			total_read += (size_t)num_read;
@@ -231,6 +298,9 @@ _pipe_stream_write(stream_t* stream, const void* source, size_t num) {
 				pipestream->eos = true;
 				break;
 			}
+			//Non-blocking write with a full pipe
+			if (!num_written && pipestream->nonblocking)
+				break;
 			total_written += num_written;
 		}
 		while (total_written < num);
@@ -243,7 +313,10 @@ _pipe_stream_write(stream_t* stream, const void* source, size_t num) {
 			ssize_t num_written = write(pipestream->fd_write, pointer_offset_const(source, total_written),
 			                            (size_t)(num - total_written));
 			if (num_written <= 0) {
-				pipestream->eos = true;
+				//Non-blocking write with a full pipe is not end of stream
+				if (!num_written || !pipestream->nonblocking ||
+				        ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+					pipestream->eos = true;
 				break;
 			}
 			total_written += (size_t)num_written;
@@ -256,6 +329,42 @@ _pipe_stream_write(stream_t* stream, const void* source, size_t num) {
 	return 0;
 }
 
+#if FOUNDATION_PLATFORM_POSIX
+
+static size_t
+_pipe_stream_read_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
+	size_t ispan, num, total_read;
+	if (!pipestream->fd_read || !(pipestream->mode & STREAM_IN))
+		return 0;
+	for (ispan = 0, num = 0; ispan < count; ++ispan)
+		num += spans[ispan].size;
+	errno = 0;
+	total_read = _stream_fd_vector(pipestream->fd_read, spans, count, false);
+	if ((total_read < num) &&
+	        (!pipestream->nonblocking || ((errno != EAGAIN) && (errno != EWOULDBLOCK))))
+		pipestream->eos = true;
+	return total_read;
+}
+
+static size_t
+_pipe_stream_write_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
+	size_t ispan, num, total_written;
+	if (!pipestream->fd_write || !(pipestream->mode & STREAM_OUT))
+		return 0;
+	for (ispan = 0, num = 0; ispan < count; ++ispan)
+		num += spans[ispan].size;
+	errno = 0;
+	total_written = _stream_fd_vector(pipestream->fd_write, spans, count, true);
+	if ((total_written < num) &&
+	        (!pipestream->nonblocking || ((errno != EAGAIN) && (errno != EWOULDBLOCK))))
+		pipestream->eos = true;
+	return total_written;
+}
+
+#endif
+
 static bool
 _pipe_stream_eos(stream_t* stream) {
 	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
@@ -306,7 +415,20 @@ _pipe_stream_lastmod(const stream_t* stream) {
 
 static size_t
 _pipe_stream_available_read(stream_t* stream) {
-	FOUNDATION_UNUSED(stream);
+	stream_pipe_t* pipestream = (stream_pipe_t*)stream;
+#if FOUNDATION_PLATFORM_WINDOWS
+	DWORD available = 0;
+	if (pipestream->handle_read && ((pipestream->mode & STREAM_IN) != 0) &&
+	        PeekNamedPipe(pipestream->handle_read, 0, 0, 0, &available, 0))
+		return available;
+#elif FOUNDATION_PLATFORM_POSIX
+	int available = 0;
+	if (pipestream->fd_read && ((pipestream->mode & STREAM_IN) != 0) &&
+	        (ioctl(pipestream->fd_read, FIONREAD, &available) == 0) && (available > 0))
+		return (size_t)available;
+#else
+	FOUNDATION_UNUSED(pipestream);
+#endif
 	return 0;
 }
 
@@ -314,6 +436,10 @@ void
 _pipe_stream_initialize(void) {
 	_pipe_stream_vtable.read = _pipe_stream_read;
 	_pipe_stream_vtable.write = _pipe_stream_write;
+#if FOUNDATION_PLATFORM_POSIX
+	_pipe_stream_vtable.read_vector = _pipe_stream_read_vector;
+	_pipe_stream_vtable.write_vector = _pipe_stream_write_vector;
+#endif
 	_pipe_stream_vtable.eos = _pipe_stream_eos;
 	_pipe_stream_vtable.flush = _pipe_stream_flush;
 	_pipe_stream_vtable.truncate = _pipe_stream_truncate;
@@ -16,7 +16,11 @@
 \brief Unnamed pipe stream
 
 Stream for unnamed pipes, usable for inter-process communication. Pipe read/write calls
-are blocking. Pipe streams are sequential (non-seekable). */
+are blocking. Pipe streams are sequential (non-seekable).
+
+On Linux and Android data forwarded between pipe streams and file streams with #stream_copy
+is moved inside the kernel with splice and never copied through user space. Data buffered in
+a pipe can be duplicated to another pipe without being consumed with #pipe_tee. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -41,6 +45,27 @@ pipe_close_read(stream_t* pipe);
 FOUNDATION_API void
 pipe_close_write(stream_t* pipe);
 
+/*! Set non-blocking mode for the pipe. A non-blocking read only returns data currently
+available in the pipe, possibly none, and end of stream is only flagged once the write end is
+closed. A non-blocking write only writes as much as fits in the pipe buffer and returns the
+partial count. Combined with adding the read handle to a beacon with #beacon_add, or the write
+handle with #beacon_add_writable, a single thread can service many pipes without blocking.
+\param pipe Pipe stream
+\param nonblocking Non-blocking flag */
+FOUNDATION_API void
+pipe_set_nonblocking(stream_t* pipe, bool nonblocking);
+
+/*! Duplicate data currently buffered in the source pipe to the destination pipe without
+consuming it, the data can still be read from the source pipe. The data is never copied through
+user space. Blocks until data is available in the source pipe. Only supported on Linux and
+Android, other platforms always return 0.
+\param dest Destination pipe stream
+\param source Source pipe stream
+\param bytes Maximum number of bytes to duplicate, 0 for all available data
+\return Number of bytes duplicated, 0 if source pipe write end was closed or on error */
+FOUNDATION_API size_t
+pipe_tee(stream_t* dest, stream_t* source, size_t bytes);
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 /*! Windows only, get OS handle for read end of pipe
@@ -614,7 +614,7 @@ thread local storage to ensure maximum portability across supported platforms */
 #  define FOUNDATION_ARCH_SSE4 1
 #endif
 
-#ifdef __ARM_NEON__
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #  undef  FOUNDATION_ARCH_NEON
 #  define FOUNDATION_ARCH_NEON 1
 #endif
@@ -636,7 +636,7 @@ thread local storage to ensure maximum portability across supported platforms */
 
 #  define FOUNDATION_RESTRICT __restrict
 #  if FOUNDATION_PLATFORM_WINDOWS
-#    define FOUNDATION_THREADLOCAL
+#    define FOUNDATION_THREADLOCAL __declspec( thread )
 #  else
 #    define FOUNDATION_THREADLOCAL __thread
 #  endif
@@ -655,6 +655,7 @@ thread local storage to ensure maximum portability across supported platforms */
 #  define FOUNDATION_ALIGN( alignment ) FOUNDATION_ATTRIBUTE2( aligned, alignment )
 #  define FOUNDATION_ALIGNOF( type ) __alignof__( type )
 #  define FOUNDATION_ALIGNED_STRUCT( name, alignment ) struct __attribute__((__aligned__(alignment))) name
+#  define FOUNDATION_PREFETCH( addr ) __builtin_prefetch( (addr) )
 
 #  if FOUNDATION_PLATFORM_WINDOWS
 #    pragma clang diagnostic push
@@ -709,6 +710,7 @@ thread local storage to ensure maximum portability across supported platforms */
 #  define FOUNDATION_ALIGN( alignment ) FOUNDATION_ATTRIBUTE2( aligned, alignment )
 #  define FOUNDATION_ALIGNOF( type ) __alignof__( type )
 #  define FOUNDATION_ALIGNED_STRUCT( name, alignment ) struct FOUNDATION_ALIGN( alignment ) name
+#  define FOUNDATION_PREFETCH( addr ) __builtin_prefetch( (addr) )
 
 #  if FOUNDATION_PLATFORM_WINDOWS
 #    define STDCALL
@@ -756,6 +758,11 @@ thread local storage to ensure maximum portability across supported platforms */
 #  define FOUNDATION_ALIGN( alignment ) __declspec( align( alignment ) )
 #  define FOUNDATION_ALIGNOF( type ) __alignof( type )
 #  define FOUNDATION_ALIGNED_STRUCT( name, alignment ) FOUNDATION_ALIGN( alignment ) struct name
+#  if FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64
+#    define FOUNDATION_PREFETCH( addr ) _mm_prefetch( (const char*)(addr), _MM_HINT_T0 )
+#  else
+#    define FOUNDATION_PREFETCH( addr ) ((void)sizeof(addr))
+#  endif
 
 #  if FOUNDATION_PLATFORM_WINDOWS
 #    define STDCALL __stdcall
@@ -795,6 +802,12 @@ thread local storage to ensure maximum portability across supported platforms */
 #  define FOUNDATION_ALIGN( alignment ) __declspec( align( alignment ) )
 #  define FOUNDATION_ALIGNOF( type ) __alignof( type )
 #  define FOUNDATION_ALIGNED_STRUCT( name, alignment ) FOUNDATION_ALIGN( alignment ) struct name
+#  if FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64
+#    include <intrin.h>
+#    define FOUNDATION_PREFETCH( addr ) _mm_prefetch( (const char*)(addr), _MM_HINT_T0 )
+#  else
+#    define FOUNDATION_PREFETCH( addr ) ((void)sizeof(addr))
+#  endif
 
 #  pragma warning( disable : 4200 )
 
@@ -841,6 +854,7 @@ typedef enum {
 #  define FOUNDATION_ALIGN
 #  define FOUNDATION_ALIGNOF
 #  define FOUNDATION_ALIGNED_STRUCT( name, alignment ) struct name
+#  define FOUNDATION_PREFETCH( addr ) ((void)sizeof(addr))
 
 typedef enum {
   false = 0,
@@ -945,6 +959,21 @@ FOUNDATION_ALIGNED_STRUCT(atomicptr_t, FOUNDATION_SIZE_POINTER) {
 };
 typedef struct atomicptr_t atomicptr_t;
 
+FOUNDATION_ALIGNED_STRUCT(atomic128_t, 16) {
+  uint128_t nonatomic;
+};
+typedef struct atomic128_t atomic128_t;
+
+#if FOUNDATION_SIZE_POINTER == 8
+FOUNDATION_ALIGNED_STRUCT(atomictagptr_t, 16) {
+#else
+FOUNDATION_ALIGNED_STRUCT(atomictagptr_t, 8) {
+#endif
+  void* nonatomic;
+  uintptr_t tag;
+};
+typedef struct atomictagptr_t atomictagptr_t;
+
 // Pointer arithmetic
 #define pointer_offset( ptr, ofs ) (void*)((char*)(ptr) + (ptrdiff_t)(ofs))
 #define pointer_offset_const( ptr, ofs ) (const void*)((const char*)(ptr) + (ptrdiff_t)(ofs))
@@ -987,8 +1016,37 @@ typedef struct atomicptr_t atomicptr_t;
 #define FOUNDATION_UNUSED_VARARGS_WRAP(n, ...) FOUNDATION_UNUSED_VARARGS_IMPL(n, __VA_ARGS__)
 #define FOUNDATION_UNUSED_VARARGS_IMPL(n, ...) FOUNDATION_PREPROCESSOR_JOIN(FOUNDATION_PREPROCESSOR_JOIN(FOUNDATION_UNUSED_ARGS_, n)(__VA_ARGS__,),)
 
-// Wrappers for platforms that not yet support thread-local storage declarations
-#if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_ANDROID
+// Native thread local storage is used everywhere the compiler supports it. Apple toolchains
+// without the tls feature and non-clang Android toolchains fall back to pthread keys
+#if FOUNDATION_PLATFORM_APPLE
+#  if defined( __has_feature )
+#    if __has_feature( tls )
+#      define FOUNDATION_HAVE_NATIVE_TLS 1
+#    endif
+#  endif
+#  ifndef FOUNDATION_HAVE_NATIVE_TLS
+#    define FOUNDATION_HAVE_NATIVE_TLS 0
+#  endif
+#elif FOUNDATION_PLATFORM_ANDROID
+#  define FOUNDATION_HAVE_NATIVE_TLS FOUNDATION_COMPILER_CLANG
+#else
+#  define FOUNDATION_HAVE_NATIVE_TLS 1
+#endif
+
+// Thread local variables use the initial-exec model on ELF platforms, which resolves them at a
+// fixed offset from the thread pointer instead of calling __tls_get_addr in position independent
+// code. Define FOUNDATION_THREADLOCAL_MODEL to nothing when linking foundation into a library
+// loaded with dlopen
+#ifndef FOUNDATION_THREADLOCAL_MODEL
+#  if ( FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG ) && !FOUNDATION_PLATFORM_ANDROID && \
+      ( FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_BSD || FOUNDATION_PLATFORM_TIZEN )
+#    define FOUNDATION_THREADLOCAL_MODEL __attribute__((__tls_model__("initial-exec")))
+#  else
+#    define FOUNDATION_THREADLOCAL_MODEL
+#  endif
+#endif
+
+#if !FOUNDATION_HAVE_NATIVE_TLS
 
 // Forward declarations of various system APIs
 #if FOUNDATION_PLATFORM_APPLE
@@ -1013,34 +1071,15 @@ static _pthread_key_t _##name##_key = 0; \
 static FOUNDATION_FORCEINLINE _pthread_key_t get_##name##_key( void ) { if( !_##name##_key ) pthread_key_create( &_##name##_key, 0 ); return _##name##_key; } \
 static FOUNDATION_FORCEINLINE type* get_thread_##name( void ) { _pthread_key_t key = get_##name##_key(); type* arr = (type*)pthread_getspecific( key ); if( !arr ) { arr = _allocate_thread_local_block( sizeof( type ) * arrsize ); pthread_setspecific( key, arr ); } return arr; }
 
-#elif FOUNDATION_PLATFORM_WINDOWS && FOUNDATION_COMPILER_CLANG
-
-__declspec(dllimport) unsigned long STDCALL TlsAlloc();
-__declspec(dllimport) void* STDCALL TlsGetValue(unsigned long);
-__declspec(dllimport) int STDCALL TlsSetValue(unsigned long, void*);
-
-FOUNDATION_API void* _allocate_thread_local_block(size_t size);
-
-#define FOUNDATION_DECLARE_THREAD_LOCAL( type, name, init ) \
-static unsigned long _##name##_key = 0; \
-static FOUNDATION_FORCEINLINE unsigned long get_##name##_key( void ) { if( !_##name##_key ) { _##name##_key = TlsAlloc(); TlsSetValue( _##name##_key, init ); } return _##name##_key; } \
-static FOUNDATION_FORCEINLINE type get_thread_##name( void ) { return (type)((uintptr_t)TlsGetValue( get_##name##_key() )); } \
-static FOUNDATION_FORCEINLINE void set_thread_##name( type val ) { TlsSetValue( get_##name##_key(), (void*)((uintptr_t)val) ); }
-
-#define FOUNDATION_DECLARE_THREAD_LOCAL_ARRAY( type, name, arrsize ) \
-static unsigned long _##name##_key = 0; \
-static FOUNDATION_FORCEINLINE unsigned long get_##name##_key( void ) { if( !_##name##_key ) _##name##_key = TlsAlloc(); return _##name##_key; } \
-static FOUNDATION_FORCEINLINE type* get_thread_##name( void ) { unsigned long key = get_##name##_key(); type* arr = (type*)TlsGetValue( key ); if( !arr ) { arr = _allocate_thread_local_block( sizeof( type ) * arrsize ); TlsSetValue( key, arr ); } return arr; }
-
 #else
 
 #define FOUNDATION_DECLARE_THREAD_LOCAL( type, name, init ) \
-static FOUNDATION_THREADLOCAL type _thread_##name = init; \
+static FOUNDATION_THREADLOCAL type _thread_##name FOUNDATION_THREADLOCAL_MODEL = init; \
 static FOUNDATION_FORCEINLINE void set_thread_##name( type val ) { _thread_##name = val; } \
 static FOUNDATION_FORCEINLINE type get_thread_##name( void ) { return _thread_##name; }
 
 #define FOUNDATION_DECLARE_THREAD_LOCAL_ARRAY( type, name, arrsize ) \
-static FOUNDATION_THREADLOCAL type _thread_##name [arrsize] = {0}; \
+static FOUNDATION_THREADLOCAL type _thread_##name [arrsize] FOUNDATION_THREADLOCAL_MODEL = {0}; \
 static FOUNDATION_FORCEINLINE type* get_thread_##name( void ) { return _thread_##name; }
 
 #endif
@@ -1349,6 +1388,15 @@ Thread local attribute, defined to nothing if the compiler/platform/architecture
 support thread local variables. For full platform support, use #FOUNDATION_DECLARE_THREAD_LOCAL
 instead.
 
+\def FOUNDATION_HAVE_NATIVE_TLS
+Defined to 1 if thread local variables declared with #FOUNDATION_DECLARE_THREAD_LOCAL use
+native compiler thread local storage, 0 if they fall back to pthread keys
+
+\def FOUNDATION_THREADLOCAL_MODEL
+Thread local storage model attribute for thread local variables, initial-exec on ELF platforms
+and nothing otherwise. Can be predefined to nothing when foundation is linked into a library
+loaded at runtime, which requires the dynamic TLS models
+
 \def FOUNDATION_DEPRECATED
 Deprecated attribute, marking a function/variable as deprecated
 
@@ -1358,6 +1406,10 @@ Attribute to force function to be inlined
 \def FOUNDATION_NOINLINE
 Attribute to prevent function from being inlined
 
+\def FOUNDATION_PREFETCH
+Hint to prefetch the cache line holding the given address for reading. Does not fault on
+invalid addresses
+
 \def FOUNDATION_PURECALL
 Attribute declaring function to be pure, meaning it has no effects except the return value
 and the return value depends only on the parameters and/or global variables.
@@ -1426,6 +1478,16 @@ for example REAL_C(1.0)
 Atomic pointer, use atomic_* functions to load/store values atomically
 (see atomic.h documentation)
 
+\struct atomic128_t
+128-bit atomic integer, use atomic_* functions to load/store values atomically. Only
+available on platforms with a double width CAS instruction, see FOUNDATION_ATOMIC128
+(see atomic.h documentation)
+
+\struct atomictagptr_t
+Atomic pointer paired with a tag counter incremented on each store, use atomic_*_tagptr
+functions to load/store values atomically. Used to avoid ABA issues in lock-free data
+structures (see atomic.h documentation)
+
 \fn uint128_t uint128_make( const uint64_t low, const uint64_t high )
 Declare a 128-bit unsigned int value from low and high 64-bit components
 \param low     Low 64 bits
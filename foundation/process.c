@@ -28,6 +28,27 @@
 #  include <sys/event.h>
 #endif
 
+#if FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_ANDROID
+#  include <spawn.h>
+#  define FOUNDATION_HAVE_SPAWN 1
+#  if FOUNDATION_PLATFORM_APPLE
+#    include <crt_externs.h>
+#    define environ (*_NSGetEnviron())
+#  else
+extern char** environ;
+#  endif
+//Changing working directory in the spawned process requires glibc 2.29
+#  if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 29)))
+#    define FOUNDATION_HAVE_SPAWN_CHDIR 1
+#  endif
+#endif
+#ifndef FOUNDATION_HAVE_SPAWN
+#  define FOUNDATION_HAVE_SPAWN 0
+#endif
+#ifndef FOUNDATION_HAVE_SPAWN_CHDIR
+#  define FOUNDATION_HAVE_SPAWN_CHDIR 0
+#endif
+
 static int _process_exit_code;
 
 process_t*
@@ -58,6 +79,7 @@ process_finalize(process_t* proc) {
 
 	stream_deallocate(proc->pipeout);
 	stream_deallocate(proc->pipein);
+	stream_deallocate(proc->pipeerr);
 	string_deallocate(proc->wd.str);
 	string_deallocate(proc->path.str);
 	string_array_deallocate(proc->args);
@@ -109,6 +131,46 @@ process_set_verb(process_t* proc, const char* verb, size_t length) {
 #endif
 }
 
+#if FOUNDATION_HAVE_SPAWN
+
+static int
+_process_posix_spawn(process_t* proc, char** argv, pid_t* pid) {
+	posix_spawn_file_actions_t actions;
+	int err = posix_spawn_file_actions_init(&actions);
+	if (err)
+		return err;
+
+#if FOUNDATION_HAVE_SPAWN_CHDIR
+	if (proc->wd.length)
+		err = posix_spawn_file_actions_addchdir_np(&actions, proc->wd.str);
+#endif
+	if (!err && proc->pipeout) {
+		err = posix_spawn_file_actions_addclose(&actions, pipe_read_handle(proc->pipeout));
+		if (!err)
+			err = posix_spawn_file_actions_adddup2(&actions, pipe_write_handle(proc->pipeout),
+			                                       STDOUT_FILENO);
+	}
+	if (!err && proc->pipein) {
+		err = posix_spawn_file_actions_addclose(&actions, pipe_write_handle(proc->pipein));
+		if (!err)
+			err = posix_spawn_file_actions_adddup2(&actions, pipe_read_handle(proc->pipein),
+			                                       STDIN_FILENO);
+	}
+	if (!err && proc->pipeerr) {
+		err = posix_spawn_file_actions_addclose(&actions, pipe_read_handle(proc->pipeerr));
+		if (!err)
+			err = posix_spawn_file_actions_adddup2(&actions, pipe_write_handle(proc->pipeerr),
+			                                       STDERR_FILENO);
+	}
+	if (!err)
+		err = posix_spawn(pid, proc->path.str, &actions, 0, argv, environ);
+
+	posix_spawn_file_actions_destroy(&actions);
+	return err;
+}
+
+#endif
+
 int
 process_spawn(process_t* proc) {
 	static const string_const_t unescaped = { STRING_CONST("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_.:/\\") };
@@ -242,7 +304,7 @@ process_spawn(process_t* proc) {
 		if (!(proc->flags & PROCESS_CONSOLE))
 			sei.fMask      |= SEE_MASK_NO_CONSOLE;
 
-		if (proc->flags & PROCESS_STDSTREAMS)
+		if (proc->flags & (PROCESS_STDSTREAMS | PROCESS_STDERR))
 			log_warn(0, WARNING_UNSUPPORTED, STRING_CONST("Unable to redirect standard in/out"
 			                                              " through pipes when using ShellExecute for process spawning"));
 
@@ -273,20 +335,31 @@ process_spawn(process_t* proc) {
 		memset(&pi, 0, sizeof(pi));
 		si.cb = sizeof(si);
 
+		if (proc->flags & (PROCESS_STDSTREAMS | PROCESS_STDERR)) {
+			si.dwFlags |= STARTF_USESTDHANDLES;
+			si.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+			si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+			si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+			inherit_handles = TRUE;
+		}
+
 		if (proc->flags & PROCESS_STDSTREAMS) {
 			proc->pipeout = pipe_allocate();
 			proc->pipein = pipe_allocate();
 
-			si.dwFlags |= STARTF_USESTDHANDLES;
 			si.hStdOutput = pipe_write_handle(proc->pipeout);
 			si.hStdInput = pipe_read_handle(proc->pipein);
-			si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
 
 			//Don't inherit wrong ends of pipes
 			SetHandleInformation(pipe_read_handle(proc->pipeout), HANDLE_FLAG_INHERIT, 0);
 			SetHandleInformation(pipe_write_handle(proc->pipein), HANDLE_FLAG_INHERIT, 0);
+		}
 
-			inherit_handles = TRUE;
+		if (proc->flags & PROCESS_STDERR) {
+			proc->pipeerr = pipe_allocate();
+			si.hStdError = pipe_write_handle(proc->pipeerr);
+			SetHandleInformation(pipe_read_handle(proc->pipeerr), HANDLE_FLAG_INHERIT, 0);
 		}
 
 		log_debugf(0, STRING_CONST("Spawn process (CreateProcess): %.*s %.*s"),
@@ -301,9 +374,11 @@ process_spawn(process_t* proc) {
 
 			stream_deallocate(proc->pipeout);
 			stream_deallocate(proc->pipein);
+			stream_deallocate(proc->pipeerr);
 
 			proc->pipeout = 0;
 			proc->pipein = 0;
+			proc->pipeerr = 0;
 		}
 		else {
 			proc->hp = pi.hProcess;
@@ -315,6 +390,8 @@ process_spawn(process_t* proc) {
 			pipe_close_write(proc->pipeout);
 		if (proc->pipein)
 			pipe_close_read(proc->pipein);
+		if (proc->pipeerr)
+			pipe_close_write(proc->pipeerr);
 	}
 
 	wstring_deallocate(wcmdline);
@@ -438,9 +515,27 @@ process_spawn(process_t* proc) {
 		proc->pipeout = pipe_allocate();
 		proc->pipein = pipe_allocate();
 	}
+	if (proc->flags & PROCESS_STDERR)
+		proc->pipeerr = pipe_allocate();
 
 	proc->pid = 0;
-	pid_t pid = fork();
+	pid_t pid = -1;
+	int err = 0;
+	bool spawned = false;
+
+#if FOUNDATION_HAVE_SPAWN
+	//Spawning avoids copying the page tables of the parent process like fork does, fork is only
+	//needed when the working directory cannot be set through the spawn file actions
+	if (!proc->wd.length || FOUNDATION_HAVE_SPAWN_CHDIR) {
+		err = _process_posix_spawn(proc, argv, &pid);
+		if (err)
+			pid = -1;
+		spawned = true;
+	}
+#endif
+
+	if (!spawned)
+		pid = fork();
 
 	if (pid == 0) {
 		//Child
@@ -460,10 +555,15 @@ process_spawn(process_t* proc) {
 			dup2(pipe_read_handle(proc->pipein), STDIN_FILENO);
 		}
 
+		if (proc->flags & PROCESS_STDERR) {
+			pipe_close_read(proc->pipeerr);
+			dup2(pipe_write_handle(proc->pipeerr), STDERR_FILENO);
+		}
+
 		int code = execv(proc->path.str, (char* const*)argv);
 
 		//Error
-		int err = errno;
+		err = errno;
 		string_const_t errmsg = system_error_message(err);
 		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
 		           STRING_CONST("Child process failed execve() '%.*s': %.*s (%d) (%d)"),
@@ -471,11 +571,14 @@ process_spawn(process_t* proc) {
 		process_exit(PROCESS_EXIT_FAILURE);
 		FOUNDATION_UNUSED(code);
 	}
+	else if (pid < 0 && !spawned) {
+		err = errno;
+	}
 
 	memory_deallocate(argv);
 
 	if (pid > 0) {
-		log_debugf(0, STRING_CONST("Child process forked, pid %d"), pid);
+		log_debugf(0, STRING_CONST("Child process %s, pid %d"), spawned ? "spawned" : "forked", pid);
 
 		proc->pid = pid;
 
@@ -483,6 +586,8 @@ process_spawn(process_t* proc) {
 			pipe_close_write(proc->pipeout);
 		if (proc->pipein)
 			pipe_close_read(proc->pipein);
+		if (proc->pipeerr)
+			pipe_close_write(proc->pipeerr);
 
 		/*if (proc->flags & PROCESS_DETACHED) {
 			int cstatus = 0;
@@ -501,20 +606,39 @@ process_spawn(process_t* proc) {
 			}
 		}*/
 	}
+	else if (spawned) {
+		//Report a failed spawn like a forked child process failing execv() and exiting
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to spawn process '%.*s': %.*s (%d)"),
+		           STRING_FORMAT(proc->path), STRING_FORMAT(errmsg), err);
+
+		if (proc->pipeout)
+			pipe_close_write(proc->pipeout);
+		if (proc->pipein)
+			pipe_close_read(proc->pipein);
+		if (proc->pipeerr)
+			pipe_close_write(proc->pipeerr);
+
+		proc->code = PROCESS_EXIT_FAILURE;
+	}
 	else {
 		//Error
 		string_const_t errmsg;
-		errmsg = system_error_message(proc->code);
+		errmsg = system_error_message(err);
 		log_errorf(0, ERROR_SYSTEM_CALL_FAIL, STRING_CONST("Unable to spawn process '%.*s': %.*s (%d)"),
-		           STRING_FORMAT(proc->path), STRING_FORMAT(errmsg), proc->code);
+		           STRING_FORMAT(proc->path), STRING_FORMAT(errmsg), err);
 
 		if (proc->pipeout)
 			stream_deallocate(proc->pipeout);
 		if (proc->pipein)
 			stream_deallocate(proc->pipein);
+		if (proc->pipeerr)
+			stream_deallocate(proc->pipeerr);
 
 		proc->pipeout = 0;
 		proc->pipein = 0;
+		proc->pipeerr = 0;
 		proc->code = PROCESS_INVALID_ARGS;
 
 		return proc->code;
@@ -530,6 +654,11 @@ process_spawn(process_t* proc) {
 exit:
 #endif
 
+	if (proc->flags & PROCESS_NONBLOCKING) {
+		pipe_set_nonblocking(proc->pipeout, true);
+		pipe_set_nonblocking(proc->pipeerr, true);
+	}
+
 	if (proc->flags & PROCESS_DETACHED)
 		return PROCESS_STILL_ACTIVE;
 
@@ -546,6 +675,11 @@ process_stdin(process_t* proc) {
 	return proc ? proc->pipein : 0;
 }
 
+stream_t*
+process_stderr(process_t* proc) {
+	return proc ? proc->pipeerr : 0;
+}
+
 bool
 process_kill(process_t* proc) {
 #if FOUNDATION_PLATFORM_WINDOWS
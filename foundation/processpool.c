@@ -0,0 +1,217 @@
+/* processpool.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+//Upper bound on message size, a larger length means the stream is not framed data
+#define PROCESSPOOL_MESSAGE_LIMIT (256U * 1024U * 1024U)
+
+struct processpool_t {
+	string_t path;
+	string_t* args;
+	size_t count;
+	process_t* worker;
+	bool* alive;
+	//Stack of idle worker indices protected by lock, with the semaphore counting idle workers
+	lock_t lock;
+	semaphore_t idle_count;
+	size_t* idle;
+	size_t num_idle;
+	atomic32_t respawns;
+};
+
+static bool
+_processpool_spawn(processpool_t* pool, size_t iworker) {
+	process_t* proc = pool->worker + iworker;
+	process_initialize(proc);
+	process_set_working_directory(proc, STRING_ARGS(environment_current_working_directory()));
+	process_set_executable_path(proc, STRING_ARGS(pool->path));
+	process_set_arguments(proc, (const string_const_t*)pool->args, array_size(pool->args));
+	process_set_flags(proc, PROCESS_DETACHED | PROCESS_STDSTREAMS);
+	pool->alive[iworker] = (process_spawn(proc) == PROCESS_STILL_ACTIVE) &&
+	                       process_stdout(proc) && process_stdin(proc);
+	return pool->alive[iworker];
+}
+
+//Wait for a worker to exit, killing it if it has not exited within the given time
+static void
+_processpool_reap(processpool_t* pool, size_t iworker, unsigned int milliseconds) {
+	process_t* proc = pool->worker + iworker;
+	tick_t start = time_current();
+	while ((process_wait(proc) == PROCESS_STILL_ACTIVE) &&
+	        (time_elapsed(start) * 1000.0 < (double)milliseconds))
+		thread_sleep(1);
+	if (process_kill(proc)) {
+		proc->flags &= ~PROCESS_DETACHED;
+		process_wait(proc);
+	}
+	process_finalize(proc);
+	pool->alive[iworker] = false;
+}
+
+static bool
+_processpool_write(stream_t* stream, const void* data, size_t size) {
+	uint32_t header = byteorder_littleendian32((uint32_t)size);
+	if ((stream_write(stream, &header, sizeof(header)) != sizeof(header)) ||
+	        (stream_write(stream, data, size) != size))
+		return false;
+	stream_flush(stream);
+	return true;
+}
+
+static void*
+_processpool_read(stream_t* stream, size_t* size) {
+	uint32_t header = 0;
+	void* data;
+	*size = 0;
+	if (stream_read(stream, &header, sizeof(header)) != sizeof(header))
+		return 0;
+	header = byteorder_littleendian32(header);
+	if (header > PROCESSPOOL_MESSAGE_LIMIT)
+		return 0;
+	//Always allocate so an empty message can be told apart from a failure
+	data = memory_allocate(0, header ? header : 1, 0, MEMORY_PERSISTENT);
+	if (header && (stream_read(stream, data, header) != header)) {
+		memory_deallocate(data);
+		return 0;
+	}
+	*size = header;
+	return data;
+}
+
+processpool_t*
+processpool_allocate(const char* path, size_t length, const string_const_t* args,
+                     size_t num_args, size_t workers) {
+	processpool_t* pool;
+	size_t iarg, iworker;
+
+	if (!workers)
+		return 0;
+
+	pool = memory_allocate(0, sizeof(processpool_t), 0,
+	                       MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	pool->path = string_clone(path, length);
+	for (iarg = 0; iarg < num_args; ++iarg) {
+		string_t arg = string_clone(STRING_ARGS(args[iarg]));
+		array_push(pool->args, arg);
+	}
+	pool->count = workers;
+	pool->worker = memory_allocate(0, sizeof(process_t) * workers, 0,
+	                               MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	pool->alive = memory_allocate(0, sizeof(bool) * workers, 0,
+	                              MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	pool->idle = memory_allocate(0, sizeof(size_t) * workers, 0, MEMORY_PERSISTENT);
+	lock_initialize(&pool->lock);
+
+	for (iworker = 0; iworker < workers; ++iworker) {
+		if (_processpool_spawn(pool, iworker))
+			pool->idle[pool->num_idle++] = iworker;
+		else
+			_processpool_reap(pool, iworker, 0);
+	}
+	semaphore_initialize(&pool->idle_count, (unsigned int)pool->num_idle);
+
+	if (!pool->num_idle) {
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to spawn any worker process for pool: %.*s"),
+		           STRING_FORMAT(pool->path));
+		processpool_deallocate(pool);
+		return 0;
+	}
+	return pool;
+}
+
+void
+processpool_deallocate(processpool_t* pool) {
+	size_t iworker, iarg;
+	if (!pool)
+		return;
+
+	//Closing stdin signals the workers to exit
+	for (iworker = 0; iworker < pool->count; ++iworker) {
+		if (pool->alive[iworker])
+			pipe_close_write(process_stdin(pool->worker + iworker));
+	}
+	for (iworker = 0; iworker < pool->count; ++iworker) {
+		if (pool->alive[iworker])
+			_processpool_reap(pool, iworker, 1000);
+	}
+
+	semaphore_finalize(&pool->idle_count);
+	for (iarg = 0; iarg < array_size(pool->args); ++iarg)
+		string_deallocate(pool->args[iarg].str);
+	array_deallocate(pool->args);
+	string_deallocate(pool->path.str);
+	memory_deallocate(pool->idle);
+	memory_deallocate(pool->alive);
+	memory_deallocate(pool->worker);
+	memory_deallocate(pool);
+}
+
+void*
+processpool_execute(processpool_t* pool, const void* request, size_t size,
+                    size_t* response_size) {
+	process_t* proc;
+	size_t iworker;
+	void* response = 0;
+
+	*response_size = 0;
+	if (size > PROCESSPOOL_MESSAGE_LIMIT)
+		return 0;
+
+	semaphore_wait(&pool->idle_count);
+	lock_lock(&pool->lock);
+	iworker = pool->idle[--pool->num_idle];
+	lock_unlock(&pool->lock);
+
+	proc = pool->worker + iworker;
+	if (!pool->alive[iworker])
+		_processpool_spawn(pool, iworker);
+
+	if (pool->alive[iworker] && _processpool_write(process_stdin(proc), request, size))
+		response = _processpool_read(process_stdout(proc), response_size);
+
+	if (!response) {
+		log_warnf(0, WARNING_SYSTEM_CALL_FAIL,
+		          STRING_CONST("Worker process failed job, respawning: %.*s"),
+		          STRING_FORMAT(pool->path));
+		//The worker is in an unknown state even if still running
+		if (pool->alive[iworker])
+			_processpool_reap(pool, iworker, 0);
+		atomic_incr32(&pool->respawns);
+		if (!_processpool_spawn(pool, iworker))
+			_processpool_reap(pool, iworker, 0);
+	}
+
+	lock_lock(&pool->lock);
+	pool->idle[pool->num_idle++] = iworker;
+	lock_unlock(&pool->lock);
+	semaphore_post(&pool->idle_count);
+
+	return response;
+}
+
+size_t
+processpool_respawn_count(processpool_t* pool) {
+	return (size_t)atomic_load32(&pool->respawns);
+}
+
+void*
+processpool_worker_receive(stream_t* in, size_t* size) {
+	log_enable_stdout(false);
+	return _processpool_read(in, size);
+}
+
+bool
+processpool_worker_reply(stream_t* out, const void* response, size_t size) {
+	return _processpool_write(out, response, size);
+}
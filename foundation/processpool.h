@@ -0,0 +1,84 @@
+/* processpool.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file processpool.h
+\brief Pool of reusable worker processes
+
+Pool of worker processes kept alive between jobs, avoiding the cost of spawning a new process
+for each short-lived job. Jobs are sent to an idle worker through the stdin pipe of the worker,
+and the worker replies through its stdout pipe. Both directions use a simple framing of a 32-bit
+little endian length followed by the message data.
+
+A worker that terminates or breaks the framing fails the job it was executing and is respawned
+before being used for another job. Jobs can be executed from multiple threads concurrently, up to
+the number of workers in the pool, with additional callers blocking until a worker is idle.
+
+A worker process implements the other end by reading jobs from stdin with
+#processpool_worker_receive and replying to each on stdout with #processpool_worker_reply until
+the pool closes stdin. Workers must not write anything else to stdout. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a process pool and spawn the worker processes
+\param path Executable path of worker process
+\param length Length of executable path
+\param args Arguments passed to worker processes
+\param num_args Number of arguments
+\param workers Number of worker processes
+\return New process pool, null if no worker process could be spawned */
+FOUNDATION_API processpool_t*
+processpool_allocate(const char* path, size_t length, const string_const_t* args,
+                     size_t num_args, size_t workers);
+
+/*! Close the stdin pipes of the worker processes, wait for them to exit, and deallocate the
+process pool. Workers still running after a short grace period are killed. Must not be called
+while jobs are being executed.
+\param pool Process pool */
+FOUNDATION_API void
+processpool_deallocate(processpool_t* pool);
+
+/*! Execute a job on an idle worker process, blocking until a worker is idle and it has replied
+\param pool Process pool
+\param request Job request data
+\param size Size of job request data
+\param response_size Receives size of response data
+\return Response data, which must be deallocated with #memory_deallocate, null if the worker
+        failed executing the job */
+FOUNDATION_API void*
+processpool_execute(processpool_t* pool, const void* request, size_t size,
+                    size_t* response_size);
+
+/*! Get number of worker processes respawned after failing a job
+\param pool Process pool
+\return Number of respawned workers */
+FOUNDATION_API size_t
+processpool_respawn_count(processpool_t* pool);
+
+/*! Worker process side, read the next job request, blocking until it is available. Logging to
+stdout is disabled to keep the framing on stdout intact.
+\param in Input stream, normally from #stream_open_stdin
+\param size Receives size of job request data
+\return Job request data, which must be deallocated with #memory_deallocate, null if the pool
+        closed the stream and the worker should exit */
+FOUNDATION_API void*
+processpool_worker_receive(stream_t* in, size_t* size);
+
+/*! Worker process side, reply to the last job request received
+\param out Output stream, normally from #stream_open_stdout
+\param response Response data
+\param size Size of response data
+\return true if successful, false if the stream was closed */
+FOUNDATION_API bool
+processpool_worker_reply(stream_t* out, const void* response, size_t size);
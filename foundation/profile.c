@@ -12,9 +12,13 @@
 
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
+#include <foundation/posix.h>
 
 #if BUILD_ENABLE_PROFILE
 
+//Sampling is driven by a profiling interval timer delivering SIGPROF to the process
+#define PROFILE_SAMPLE_SIGNAL (FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_PNACL)
+
 #define PROFILE_ENABLE_SANITY_CHECKS 0
 
 typedef struct profile_block_data_t   profile_block_data_t;
@@ -60,99 +64,244 @@ FOUNDATION_STATIC_ASSERT(sizeof(profile_block_t) == 64, "profile_block_t size");
 //#define PROFILE_ID_UNLOCKCONTINUE   10
 #define PROFILE_ID_WAIT             11
 #define PROFILE_ID_SIGNAL           12
+#define PROFILE_ID_COUNTER          13
+#define PROFILE_ID_SAMPLE           14
+//#define PROFILE_ID_SAMPLECONTINUE   15
 
 #define GET_BLOCK( index )          ( _profile_blocks + (index) )
 #define BLOCK_INDEX( block )        (uint16_t)((uintptr_t)( (block) - _profile_blocks ))
+#define GET_NODE( index )           ( _profile_nodes + (index) )
+#define NODE_INDEX( node )          (int32_t)((uintptr_t)( (node) - _profile_nodes ))
+
+//Blocks are handed out to threads in batches to avoid contention on the shared free list
+#define PROFILE_BATCH_SIZE          16
+//Block identifiers are reserved by each thread in ranges
+#define PROFILE_ID_BATCH            64
+
+//Maximum number of distinct counters accumulated between frames
+#define PROFILE_COUNTER_MAX         64
+
+//Maximum captured call stack depth and number of unprocessed samples in sampling mode
+#define PROFILE_SAMPLE_DEPTH        32
+#define PROFILE_SAMPLE_CAPACITY     256
+
+//Number of block names in the remote output string table, and worst case encoded size of
+//a name including reference and length
+#define PROFILE_REMOTE_NAMES        1024
+#define PROFILE_REMOTE_NAME_MAX     (MAX_MESSAGE_LENGTH + 4)
+
+typedef struct profile_thread_t profile_thread_t;
+typedef struct profile_counter_t profile_counter_t;
+typedef struct profile_sample_t profile_sample_t;
+typedef struct profile_stack_t profile_stack_t;
+typedef struct profile_remote_name_t profile_remote_name_t;
+
+FOUNDATION_ALIGNED_STRUCT(profile_thread_t, 64) {
+	//Completed root blocks published by the owning thread, drained by the output thread
+	lockfree_stack_t root;
+	atomic32_t owned;
+	//Cached free blocks linked through child index, only touched by the owning thread
+	int32_t free;
+	int32_t id_next;
+	int32_t id_end;
+	profile_thread_t* next;
+};
+
+//Counter slots are claimed by name hash and never released until profiling is reinitialized
+struct profile_counter_t {
+	atomic64_t key;
+	atomic64_t value;
+	atomicptr_t name;
+	size_t length;
+};
+
+//Samples are captured in signal context into free slots, state goes from 0 (free) to
+//1 (capturing) to 2 (ready) and back to 0 once aggregated by the output thread
+struct profile_sample_t {
+	atomic32_t state;
+	uint32_t thread;
+	size_t depth;
+	void* frames[PROFILE_SAMPLE_DEPTH];
+};
+
+//Entry in the remote output string table, holding a copy of a block name
+struct profile_remote_name_t {
+	size_t length;
+	char name[MAX_MESSAGE_LENGTH + 1];
+};
+
+//Aggregated samples of a unique call stack and thread, symbols resolved on first output
+struct profile_stack_t {
+	uint32_t thread;
+	uint32_t count;
+	string_t folded;
+	size_t depth;
+	void* frames[PROFILE_SAMPLE_DEPTH];
+};
 
 static string_const_t   _profile_identifier;
+static profile_counter_t _profile_counters[PROFILE_COUNTER_MAX];
 static atomic32_t       _profile_counter;
-static atomic32_t       _profile_loopid;
-static atomic32_t       _profile_free;
-static atomic32_t       _profile_root;
+static lockfree_stack_t _profile_free;
+static atomicptr_t      _profile_threads;
+static int32_t          _profile_generation = 1;
+static int32_t          _profile_io_free;
+static int32_t          _profile_io_free_last;
+static unsigned int     _profile_io_free_count;
 static profile_block_t* _profile_blocks;
+static lockfree_node_t* _profile_nodes;
 static tick_t           _profile_ground_time;
 static int              _profile_enable;
 static profile_write_fn _profile_write;
 static uint64_t         _profile_num_blocks;
 static unsigned int     _profile_wait = 100;
+static tick_t           _profile_contention_threshold;
+static unsigned int     _profile_contention_us = 1000;
 static thread_t         _profile_io_thread;
 static bool             _profile_initialized;
+static stream_t*        _profile_trace_stream;
+static bool             _profile_trace_separator;
+static double           _profile_trace_tick_us;
+static profile_block_t  _profile_trace_message;
+static char             _profile_trace_message_text[1024];
+static size_t           _profile_trace_message_length;
+static stream_t*        _profile_remote_stream;
+static ringbuffer_spsc_t* _profile_remote_buffer;
+static thread_t         _profile_remote_thread;
+static tick_t           _profile_remote_start;
+static atomic64_t       _profile_remote_dropped;
+static int32_t          _profile_remote_last_id;
+static uint32_t         _profile_remote_last_thread;
+static hashmap_string_t _profile_remote_names;
+static profile_remote_name_t* _profile_remote_table;
+static unsigned int     _profile_remote_table_next;
+static unsigned int     _profile_sample_rate;
+static bool             _profile_sample_active;
+static profile_sample_t* _profile_samples;
+static atomic32_t       _profile_sample_next;
+static hashmap_t*       _profile_stacks;
+
+FOUNDATION_DECLARE_THREAD_CONTEXT(int32_t, profile_block)
+FOUNDATION_DECLARE_THREAD_LOCAL(profile_thread_t*, profile_thread, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(int32_t, profile_generation, 0)
+
+static profile_thread_t*
+_profile_thread(void) {
+	profile_thread_t* thread = get_thread_profile_thread();
+	void* head;
+	//Records are freed on finalize, a thread can hold a stale record from a previous session
+	if (thread && (get_thread_profile_generation() == _profile_generation))
+		return thread;
+
+	//Reuse record released by a finished thread, or add new record
+	for (thread = atomic_loadptr(&_profile_threads); thread; thread = thread->next) {
+		if (!atomic_load32(&thread->owned) && atomic_cas32(&thread->owned, 1, 0))
+			break;
+	}
+	if (!thread) {
+		thread = memory_allocate(0, sizeof(profile_thread_t), 64,
+		                         MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		atomic_store32(&thread->owned, 1);
+		do {
+			head = atomic_loadptr(&_profile_threads);
+			thread->next = head;
+		}
+		while (!atomic_cas_ptr(&_profile_threads, thread, head));
+	}
+
+	set_thread_profile_thread(thread);
+	set_thread_profile_generation(_profile_generation);
+	return thread;
+}
 
-FOUNDATION_DECLARE_THREAD_LOCAL(int32_t, profile_block, 0)
+static int32_t
+_profile_id(void) {
+	profile_thread_t* thread = _profile_thread();
+	if (thread->id_next == thread->id_end) {
+		thread->id_end = atomic_add32(&_profile_counter, PROFILE_ID_BATCH) + 1;
+		thread->id_next = thread->id_end - PROFILE_ID_BATCH;
+	}
+	return thread->id_next++;
+}
 
+//Blocks are written as is to the profile stream, so the free batch and root lists link
+//blocks through a separate node array with one node per block. Blocks within a free batch
+//are linked through child index
 static profile_block_t*
 _profile_allocate_block(void) {
-	/*lint --e{701} */
-	//Grab block from free list, avoiding ABA issues by
-	//using high 16 bit as a loop counter
 	profile_block_t* block;
-	int32_t free_block_tag, free_block, next_block_tag;
-	do {
-		free_block_tag = atomic_load32(&_profile_free);
-		free_block = free_block_tag & 0xffff;
-
-		next_block_tag = GET_BLOCK(free_block)->child;
-		next_block_tag |= (atomic_incr32(&_profile_loopid) & 0xffff) << 16;
-	}
-	while (free_block && !atomic_cas32(&_profile_free, next_block_tag, free_block_tag));
-
-	if (!free_block) {
-		static atomic32_t has_warned = {0};
-		if (atomic_cas32(&has_warned, 1, 0)) {
-			if (_profile_num_blocks < 65535)
-				log_error(0, ERROR_OUT_OF_MEMORY,
-				          STRING_CONST("Profile blocks exhausted, increase profile memory block size"));
-			else
-				log_error(0, ERROR_OUT_OF_MEMORY,
-				          STRING_CONST("Profile blocks exhausted, decrease profile output wait time"));
+	profile_thread_t* thread = _profile_thread();
+	int32_t block_index = thread->free;
+
+	if (!block_index) {
+		lockfree_node_t* node = lockfree_stack_pop(&_profile_free);
+		if (!node) {
+			static atomic32_t has_warned = {0};
+			if (atomic_cas32(&has_warned, 1, 0)) {
+				if (_profile_num_blocks < 65535)
+					log_error(0, ERROR_OUT_OF_MEMORY,
+					          STRING_CONST("Profile blocks exhausted, increase profile memory block size"));
+				else
+					log_error(0, ERROR_OUT_OF_MEMORY,
+					          STRING_CONST("Profile blocks exhausted, decrease profile output wait time"));
+			}
+			return 0;
 		}
-		return 0;
+		block_index = NODE_INDEX(node);
 	}
 
-	block = GET_BLOCK(free_block);
+	block = GET_BLOCK(block_index);
+	thread->free = block->child;
 	memset(block, 0, sizeof(profile_block_t));
 	return block;
 }
 
+static void
+_profile_flush_free_blocks(void) {
+	if (_profile_io_free)
+		lockfree_stack_push(&_profile_free, GET_NODE(_profile_io_free));
+	_profile_io_free = 0;
+	_profile_io_free_last = 0;
+	_profile_io_free_count = 0;
+}
+
 static void
 _profile_free_block(int32_t block, int32_t leaf) {
-	/*lint --e{701} */
-	int32_t last_tag, block_tag;
-	do {
-		block_tag = block | ((atomic_incr32(&_profile_loopid) & 0xffff) << 16);
-		last_tag = atomic_load32(&_profile_free);
-		GET_BLOCK(leaf)->child = last_tag & 0xffff;
+	//Processed blocks form a list through child index, gather into batches before
+	//returning them to the shared free list
+	int32_t current = block;
+	while (current != leaf) {
+		++_profile_io_free_count;
+		current = GET_BLOCK(current)->child;
 	}
-	while (!atomic_cas32(&_profile_free, block_tag, last_tag));
+	++_profile_io_free_count;
+
+	if (_profile_io_free_last)
+		GET_BLOCK(_profile_io_free_last)->child = (uint16_t)block;
+	else
+		_profile_io_free = block;
+	_profile_io_free_last = leaf;
+
+	if (_profile_io_free_count >= PROFILE_BATCH_SIZE)
+		_profile_flush_free_blocks();
 }
 
 static void
 _profile_put_root_block(int32_t block) {
-	uint16_t sibling;
-	profile_block_t* self = GET_BLOCK(block);
-
 #if PROFILE_ENABLE_SANITY_CHECKS
-	FOUNDATION_ASSERT(self->sibling == 0);
+	FOUNDATION_ASSERT(GET_BLOCK(block)->sibling == 0);
 #endif
-	while (!atomic_cas32(&_profile_root, block, 0)) {
-		do {
-			sibling = (uint16_t)atomic_load32(&_profile_root);
-		}
-		while (sibling && !atomic_cas32(&_profile_root, 0, (int32_t)sibling));
-
-		if (sibling) {
-			if (self->sibling) {
-				uint16_t leaf = self->sibling;
-				while (GET_BLOCK(leaf)->sibling)
-					leaf = GET_BLOCK(leaf)->sibling;
-				GET_BLOCK(sibling)->previous = leaf;
-				GET_BLOCK(leaf)->sibling = sibling;
-			}
-			else {
-				self->sibling = sibling;
-			}
-		}
+	lockfree_stack_push(&_profile_thread()->root, GET_NODE(block));
+}
+
+static bool
+_profile_has_root_block(void) {
+	profile_thread_t* thread;
+	for (thread = atomic_loadptr(&_profile_threads); thread; thread = thread->next) {
+		if (!lockfree_stack_is_empty(&thread->root))
+			return true;
 	}
+	return false;
 }
 
 static void
@@ -186,7 +335,7 @@ _profile_put_message_block(int32_t id, const char* message, size_t length) {
 	block->data.processor = thread_hardware();
 	block->data.thread = (uint32_t)thread_id();
 	block->data.start  = time_current() - _profile_ground_time;
-	block->data.end = atomic_add32(&_profile_counter, 1);
+	block->data.end = _profile_id();
 	string_copy(block->data.name, sizeof(block->data.name), message, length);
 
 	length = (length > MAX_MESSAGE_LENGTH ? length - MAX_MESSAGE_LENGTH : 0);
@@ -205,7 +354,7 @@ _profile_put_message_block(int32_t id, const char* message, size_t length) {
 		cblock->data.processor = block->data.processor;
 		cblock->data.thread = block->data.thread;
 		cblock->data.start  = block->data.start;
-		cblock->data.end    = atomic_add32(&_profile_counter, 1);
+		cblock->data.end    = _profile_id();
 		string_copy(cblock->data.name, sizeof(cblock->data.name), message, length);
 
 		cblock->sibling = subblock->child;
@@ -222,6 +371,21 @@ _profile_put_message_block(int32_t id, const char* message, size_t length) {
 	_profile_put_simple_block(BLOCK_INDEX(block));
 }
 
+static void
+_profile_put_counter_block(const char* name, size_t length, int64_t value, tick_t timestamp) {
+	profile_block_t* block = _profile_allocate_block();
+	if (!block)
+		return;
+	block->data.id = PROFILE_ID_COUNTER;
+	block->data.processor = thread_hardware();
+	block->data.thread = (uint32_t)thread_id();
+	block->data.start = timestamp;
+	block->data.end = value;
+	string_copy(block->data.name, sizeof(block->data.name), name, length);
+
+	_profile_put_simple_block(BLOCK_INDEX(block));
+}
+
 //Pass each block once, writing it to stream and adjusting child/sibling pointers to form
 //a single-linked list through child pointer. Potential drawback of this is that block access
 //order will degenerate over time and result in random access over the whole profile memory
@@ -252,24 +416,240 @@ _profile_process_block(profile_block_t* block) {
 
 static void
 _profile_process_root_block(void) {
-	int32_t block;
+	profile_thread_t* thread;
+
+	for (thread = atomic_loadptr(&_profile_threads); thread; thread = thread->next) {
+		lockfree_node_t* node = lockfree_stack_pop_all(&thread->root);
+		while (node) {
+			profile_block_t* leaf;
+			int32_t block = NODE_INDEX(node);
+			lockfree_node_t* next = atomic_loadptr(&node->next);
+
+			leaf = _profile_process_block(GET_BLOCK(block));
+			_profile_free_block(block, BLOCK_INDEX(leaf));
+
+			node = next;
+		}
+	}
+
+	_profile_flush_free_blocks();
+}
+
+#if PROFILE_SAMPLE_SIGNAL
+
+static void
+_profile_sample_signal(int sig, siginfo_t* info, void* context) {
+	int saved_errno = errno;
+	unsigned int islot, base;
+	FOUNDATION_UNUSED(sig);
+	FOUNDATION_UNUSED(info);
+
+	//Only lock-free operations are allowed in signal context, drop the sample if no free
+	//slot is found within a few probes
+	base = (unsigned int)atomic_add32(&_profile_sample_next, 1);
+	for (islot = 0; islot < 4; ++islot) {
+		profile_sample_t* sample = _profile_samples + ((base + islot) % PROFILE_SAMPLE_CAPACITY);
+		if (atomic_cas32(&sample->state, 1, 0)) {
+			sample->thread = (uint32_t)thread_id();
+			sample->depth = stacktrace_capture_context(sample->frames, PROFILE_SAMPLE_DEPTH, context);
+			//Skip signal handler and signal trampoline frames
+			if (!sample->depth)
+				sample->depth = stacktrace_capture_fast(sample->frames, PROFILE_SAMPLE_DEPTH, 2);
+			atomic_store32_explicit(&sample->state, 2, MEMORY_ORDER_RELEASE);
+			break;
+		}
+	}
+
+	errno = saved_errno;
+}
+
+#endif
+
+static void
+_profile_sample_start(void) {
+#if PROFILE_SAMPLE_SIGNAL
+	struct sigaction action;
+	struct itimerval timer;
+	void* warmup[4];
+	unsigned int rate = _profile_sample_rate;
+
+	if (!rate || _profile_sample_active)
+		return;
+	if (rate > 1000000)
+		rate = 1000000;
+
+	if (!_profile_samples) {
+		_profile_samples = memory_allocate(0, sizeof(profile_sample_t) * PROFILE_SAMPLE_CAPACITY, 0,
+		                                   MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		_profile_stacks = hashmap_allocate(0, 0);
+	}
+
+	//Capture once outside of signal context to run any lazy initialization in the unwinder
+	stacktrace_capture_fast(warmup, 4, 0);
+
+	memset(&action, 0, sizeof(action));
+	sigemptyset(&action.sa_mask);
+#if FOUNDATION_COMPILER_CLANG
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wdisabled-macro-expansion"
+#endif
+	action.sa_sigaction = _profile_sample_signal;
+#if FOUNDATION_COMPILER_CLANG
+#  pragma clang diagnostic pop
+#endif
+	action.sa_flags = SA_RESTART | SA_SIGINFO;
+	if (sigaction(SIGPROF, &action, 0) < 0) {
+		log_warn(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Unable to set profile sample signal action"));
+		return;
+	}
+
+	timer.it_interval.tv_sec = (time_t)(1 / rate);
+	timer.it_interval.tv_usec = (suseconds_t)((rate > 1) ? (1000000 / rate) : 0);
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, 0) < 0) {
+		log_warn(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Unable to start profile sample timer"));
+		return;
+	}
+	_profile_sample_active = true;
+#endif
+}
+
+static void
+_profile_sample_stop(void) {
+#if PROFILE_SAMPLE_SIGNAL
+	struct itimerval timer;
+	if (!_profile_sample_active)
+		return;
+
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, 0);
+	//Ignore rather than restore default action, which would terminate the process if a
+	//signal is still pending
+	signal(SIGPROF, SIG_IGN);
+	_profile_sample_active = false;
+#endif
+}
+
+//Fold resolved stack into a single root first line of function names separated by semicolons
+static string_t
+_profile_sample_fold(profile_stack_t* stack) {
+	char buffer[4096];
+	string_t resolved = stacktrace_resolve(buffer, sizeof(buffer), stack->frames, stack->depth, 0);
+	size_t capacity = resolved.length + 2;
+	string_t folded = string_allocate(0, capacity);
+	size_t end = resolved.length;
+
+	while (end) {
+		size_t newline = string_rfind(resolved.str, end, '\n', STRING_NPOS);
+		size_t start = (newline != STRING_NPOS) ? newline + 1 : 0;
+		const char* line = resolved.str + start;
+		size_t length = end - start;
+		size_t name_start = string_find_string(line, length, STRING_CONST("] "), 0);
+		size_t name_end;
+
+		end = (newline != STRING_NPOS) ? newline : 0;
+		if (name_start != STRING_NPOS) {
+			line += name_start + 2;
+			length -= name_start + 2;
+		}
+		name_end = string_find_string(line, length, STRING_CONST(" ("), 0);
+		if (name_end != STRING_NPOS)
+			length = name_end;
+		if (!length)
+			continue;
+
+		if (folded.length)
+			folded = string_append(STRING_ARGS(folded), capacity, STRING_CONST(";"));
+		folded = string_append(STRING_ARGS(folded), capacity, line, length);
+	}
+
+	return folded;
+}
+
+static void
+_profile_sample_write(profile_stack_t* stack) {
+	profile_block_t block;
+	size_t offset;
+
+	if (!stack->folded.str)
+		stack->folded = _profile_sample_fold(stack);
+
+	//Folded stack is split over continuation blocks like messages, first block holds the
+	//sample count in the parent id field
+	memset(&block, 0, sizeof(profile_block_t));
+	block.data.id = PROFILE_ID_SAMPLE;
+	block.data.parentid = (int32_t)stack->count;
+	block.data.thread = stack->thread;
+	block.data.start = time_current() - _profile_ground_time;
+	block.data.end = _profile_id();
+	string_copy(block.data.name, sizeof(block.data.name), STRING_ARGS(stack->folded));
+	_profile_write(&block, sizeof(profile_block_t));
+
+	for (offset = MAX_MESSAGE_LENGTH; offset < stack->folded.length; offset += MAX_MESSAGE_LENGTH) {
+		block.data.id = PROFILE_ID_SAMPLE + 1;
+		block.data.parentid = (int32_t)block.data.end;
+		block.data.end = _profile_id();
+		string_copy(block.data.name, sizeof(block.data.name), stack->folded.str + offset,
+		            stack->folded.length - offset);
+		_profile_write(&block, sizeof(profile_block_t));
+	}
+}
+
+static void
+_profile_sample_process(void) {
+	unsigned int islot;
+	hashmap_node_t* node;
+
+	if (!_profile_samples)
+		return;
+
+	for (islot = 0; islot < PROFILE_SAMPLE_CAPACITY; ++islot) {
+		profile_sample_t* sample = _profile_samples + islot;
+		profile_stack_t* stack;
+		hash_t key;
+		if (atomic_load32_explicit(&sample->state, MEMORY_ORDER_ACQUIRE) != 2)
+			continue;
+		if (sample->depth) {
+			key = hash(sample->frames, sizeof(void*) * sample->depth) ^ (hash_t)sample->thread;
+			stack = hashmap_lookup(_profile_stacks, key);
+			if (!stack) {
+				stack = memory_allocate(0, sizeof(profile_stack_t), 0,
+				                        MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+				stack->thread = sample->thread;
+				stack->depth = sample->depth;
+				memcpy(stack->frames, sample->frames, sizeof(void*) * sample->depth);
+				hashmap_insert(_profile_stacks, key, stack);
+			}
+			++stack->count;
+		}
+		atomic_store32_explicit(&sample->state, 0, MEMORY_ORDER_RELEASE);
+	}
 
-	do {
-		block = atomic_load32(&_profile_root);
+	for (node = hashmap_next(_profile_stacks, 0); node; node = hashmap_next(_profile_stacks, node)) {
+		profile_stack_t* stack = node->value;
+		if (stack->count && _profile_write)
+			_profile_sample_write(stack);
+		stack->count = 0;
 	}
-	while (block && !atomic_cas32(&_profile_root, 0, block));
+}
 
-	while (block) {
-		profile_block_t* leaf;
-		profile_block_t* current = GET_BLOCK(block);
-		int32_t next = current->sibling;
+static void
+_profile_sample_finalize(void) {
+	hashmap_node_t* node;
 
-		current->sibling = 0;
-		leaf = _profile_process_block(current);
-		_profile_free_block(block, BLOCK_INDEX(leaf));
+	_profile_sample_stop();
+	if (!_profile_samples)
+		return;
 
-		block = next;
+	for (node = hashmap_next(_profile_stacks, 0); node; node = hashmap_next(_profile_stacks, node)) {
+		profile_stack_t* stack = node->value;
+		string_deallocate(stack->folded.str);
+		memory_deallocate(stack);
 	}
+	hashmap_deallocate(_profile_stacks);
+	memory_deallocate(_profile_samples);
+	_profile_stacks = 0;
+	_profile_samples = 0;
 }
 
 static void*
@@ -284,12 +664,14 @@ _profile_io(void* arg) {
 
 	while (!thread_try_wait(_profile_wait)) {
 
-		if (!atomic_load32(&_profile_root))
+		_profile_sample_process();
+
+		if (!_profile_has_root_block())
 			continue;
 
 		profile_begin_block(STRING_CONST("profile_io"));
 
-		if (atomic_load32(&_profile_root)) {
+		if (_profile_has_root_block()) {
 			profile_begin_block(STRING_CONST("process"));
 
 			//This is thread safe in the sense that only completely closed and ended
@@ -309,8 +691,9 @@ _profile_io(void* arg) {
 		profile_end_block();
 	}
 
-	if (atomic_load32(&_profile_root))
+	if (_profile_has_root_block())
 		_profile_process_root_block();
+	_profile_sample_process();
 
 	if (_profile_write) {
 		profile_block_t terminate;
@@ -322,33 +705,378 @@ _profile_io(void* arg) {
 	return 0;
 }
 
+//Remote output encodes blocks as variable length integers, with id, thread and start time
+//delta coded against the previous block, parent id and end time against the block's own id
+//and start time. Names are sent once and then referenced through a string table
+static size_t
+_profile_remote_encode_uint(uint8_t* buffer, uint64_t value) {
+	size_t size = 0;
+	while (value >= 0x80) {
+		buffer[size++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	buffer[size++] = (uint8_t)value;
+	return size;
+}
+
+static size_t
+_profile_remote_encode_int(uint8_t* buffer, int64_t value) {
+	uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+	return _profile_remote_encode_uint(buffer, zigzag);
+}
+
+static size_t
+_profile_remote_encode_name(uint8_t* buffer, const profile_block_t* block) {
+	size_t name_length = string_length(block->data.name);
+	size_t length;
+	size_t ref;
+	profile_remote_name_t* entry;
+	int32_t id = block->data.id;
+
+	//Log messages and samples are rarely repeated, send them without a table entry
+	if ((id == PROFILE_ID_LOGMESSAGE) || (id == PROFILE_ID_LOGMESSAGE + 1) ||
+	        (id == PROFILE_ID_SAMPLE) || (id == PROFILE_ID_SAMPLE + 1)) {
+		length = _profile_remote_encode_uint(buffer, 0);
+		length += _profile_remote_encode_uint(buffer + length, name_length);
+		memcpy(buffer + length, block->data.name, name_length);
+		return length + name_length;
+	}
+
+	ref = (size_t)(uintptr_t)hashmap_string_lookup(&_profile_remote_names, block->data.name, name_length);
+	if (ref)
+		return _profile_remote_encode_uint(buffer, ref + 1);
+
+	//Table entries are replaced in order once the table is full, mirrored by the receiver
+	entry = _profile_remote_table + _profile_remote_table_next;
+	if (hashmap_string_size(&_profile_remote_names) == PROFILE_REMOTE_NAMES)
+		hashmap_string_erase(&_profile_remote_names, entry->name, entry->length);
+	memcpy(entry->name, block->data.name, name_length);
+	entry->length = name_length;
+	hashmap_string_insert(&_profile_remote_names, entry->name, name_length,
+	                      (void*)(uintptr_t)(_profile_remote_table_next + 1));
+	_profile_remote_table_next = (_profile_remote_table_next + 1) % PROFILE_REMOTE_NAMES;
+
+	length = _profile_remote_encode_uint(buffer, 1);
+	length += _profile_remote_encode_uint(buffer + length, name_length);
+	memcpy(buffer + length, block->data.name, name_length);
+	return length + name_length;
+}
+
+static void
+_profile_remote_write(void* buffer, size_t size) {
+	const profile_block_t* block = buffer;
+	uint8_t record[128];
+	size_t length;
+
+	if (!_profile_remote_buffer || (size < sizeof(profile_block_t)))
+		return;
+
+	length = _profile_remote_encode_int(record, (int64_t)block->data.id - _profile_remote_last_id);
+	length += _profile_remote_encode_int(record + length, (int64_t)block->data.id - block->data.parentid);
+	length += _profile_remote_encode_uint(record + length, block->data.processor);
+	length += _profile_remote_encode_int(record + length,
+	                                     (int64_t)block->data.thread - _profile_remote_last_thread);
+	length += _profile_remote_encode_int(record + length, block->data.start - _profile_remote_start);
+	length += _profile_remote_encode_int(record + length, block->data.end - block->data.start);
+
+	//Never wait for the sender thread, drop data if the connection does not keep up. The
+	//worst case record size is checked before the name is encoded, since a new name
+	//modifies the string table
+	if (ringbuffer_spsc_available_write(_profile_remote_buffer) < length + PROFILE_REMOTE_NAME_MAX) {
+		atomic_incr64(&_profile_remote_dropped);
+		return;
+	}
+	length += _profile_remote_encode_name(record + length, block);
+
+	ringbuffer_spsc_write(_profile_remote_buffer, record, length);
+	_profile_remote_start = block->data.start;
+	_profile_remote_last_id = block->data.id;
+	_profile_remote_last_thread = block->data.thread;
+}
+
+static void
+_profile_remote_send(void) {
+	size_t size;
+	const void* data;
+	while ((size = ringbuffer_spsc_available_read(_profile_remote_buffer)) > 0) {
+		data = ringbuffer_spsc_read_reserve(_profile_remote_buffer, &size);
+		if (!size)
+			break;
+		stream_write(_profile_remote_stream, data, size);
+		ringbuffer_spsc_read_commit(_profile_remote_buffer, size);
+	}
+	stream_flush(_profile_remote_stream);
+}
+
+static void*
+_profile_remote(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	while (!thread_try_wait(_profile_wait))
+		_profile_remote_send();
+	_profile_remote_send();
+	return 0;
+}
+
+static uint64_t
+_profile_count_free_blocks(int32_t block_index) {
+	uint64_t num_blocks = 0;
+	while (block_index) {
+		profile_block_t* block = GET_BLOCK(block_index);
+		if (block->sibling)
+			log_errorf(0, ERROR_INTERNAL_FAILURE,
+			           STRING_CONST("Profile module state inconsistent on finalize, "
+			                        "block %d has sibling set"), block_index);
+		++num_blocks;
+		block_index = block->child;
+	}
+	return num_blocks;
+}
+
+static void
+_profile_trace_write_string(const char* str, size_t length) {
+	size_t ichar, last = 0;
+	stream_write(_profile_trace_stream, STRING_CONST("\""));
+	for (ichar = 0; ichar < length; ++ichar) {
+		char escape[8];
+		size_t escape_length;
+		unsigned char c = (unsigned char)str[ichar];
+		if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			continue;
+		if (ichar > last)
+			stream_write(_profile_trace_stream, str + last, ichar - last);
+		if (c >= 0x20) {
+			escape[0] = '\\';
+			escape[1] = (char)c;
+			escape_length = 2;
+		}
+		else {
+			escape_length = string_format(escape, sizeof(escape), STRING_CONST("\\u%04x"),
+			                              (unsigned int)c).length;
+		}
+		stream_write(_profile_trace_stream, escape, escape_length);
+		last = ichar + 1;
+	}
+	if (length > last)
+		stream_write(_profile_trace_stream, str + last, length - last);
+	stream_write(_profile_trace_stream, STRING_CONST("\""));
+}
+
+static void
+_profile_trace_write_event(const profile_block_t* block, const char* name, size_t length,
+                           const char* category, const char* object, size_t object_length) {
+	char buffer[256];
+	string_t field;
+	bool instant = (block->data.id < 128);
+
+	if (_profile_trace_separator)
+		stream_write(_profile_trace_stream, STRING_CONST(",\n"));
+	_profile_trace_separator = true;
+
+	stream_write(_profile_trace_stream, STRING_CONST("{\"name\":"));
+	_profile_trace_write_string(name, length);
+	field = string_format(buffer, sizeof(buffer),
+	                      STRING_CONST(",\"cat\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,"
+	                                   "\"pid\":0,\"tid\":%u"),
+	                      category, instant ? "i" : "X",
+	                      (double)block->data.start * _profile_trace_tick_us, block->data.thread);
+	stream_write(_profile_trace_stream, field.str, field.length);
+
+	if (!instant) {
+		field = string_format(buffer, sizeof(buffer), STRING_CONST(",\"dur\":%.3f"),
+		                      (double)(block->data.end - block->data.start) * _profile_trace_tick_us);
+	}
+	else if (block->data.id == PROFILE_ID_ENDFRAME) {
+		field = string_format(buffer, sizeof(buffer),
+		                      STRING_CONST(",\"s\":\"g\",\"args\":{\"frame\":%" PRIu64 "}"),
+		                      (uint64_t)block->data.end);
+	}
+	else {
+		field = string_format(buffer, sizeof(buffer), STRING_CONST(",\"s\":\"t\""));
+	}
+	stream_write(_profile_trace_stream, field.str, field.length);
+
+	if (object) {
+		stream_write(_profile_trace_stream, STRING_CONST(",\"args\":{\"object\":"));
+		_profile_trace_write_string(object, object_length);
+		stream_write(_profile_trace_stream, STRING_CONST("}"));
+	}
+	if (!instant) {
+		field = string_format(buffer, sizeof(buffer), STRING_CONST(",\"args\":{\"processor\":%u}"),
+		                      block->data.processor);
+		stream_write(_profile_trace_stream, field.str, field.length);
+	}
+	stream_write(_profile_trace_stream, STRING_CONST("}"));
+}
+
+static void
+_profile_trace_write_counter(const profile_block_t* block, size_t length) {
+	char buffer[128];
+	string_t field;
+
+	if (_profile_trace_separator)
+		stream_write(_profile_trace_stream, STRING_CONST(",\n"));
+	_profile_trace_separator = true;
+
+	stream_write(_profile_trace_stream, STRING_CONST("{\"name\":"));
+	_profile_trace_write_string(block->data.name, length);
+	field = string_format(buffer, sizeof(buffer),
+	                      STRING_CONST(",\"cat\":\"counter\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,"
+	                                   "\"args\":{\"value\":%" PRId64 "}}"),
+	                      (double)block->data.start * _profile_trace_tick_us,
+	                      (int64_t)block->data.end);
+	stream_write(_profile_trace_stream, field.str, field.length);
+}
+
+//Samples are instant events named by the leaf function, with the folded stack and the
+//sample count as arguments
+static void
+_profile_trace_write_sample(const profile_block_t* block, const char* stack, size_t length) {
+	char buffer[128];
+	string_t field;
+	size_t leaf = string_rfind(stack, length, ';', STRING_NPOS);
+	leaf = (leaf != STRING_NPOS) ? leaf + 1 : 0;
+
+	if (_profile_trace_separator)
+		stream_write(_profile_trace_stream, STRING_CONST(",\n"));
+	_profile_trace_separator = true;
+
+	stream_write(_profile_trace_stream, STRING_CONST("{\"name\":"));
+	_profile_trace_write_string(stack + leaf, length - leaf);
+	field = string_format(buffer, sizeof(buffer),
+	                      STRING_CONST(",\"cat\":\"sample\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+	                                   "\"pid\":0,\"tid\":%u,\"args\":{\"count\":%d,\"stack\":"),
+	                      (double)block->data.start * _profile_trace_tick_us, block->data.thread,
+	                      block->data.parentid);
+	stream_write(_profile_trace_stream, field.str, field.length);
+	_profile_trace_write_string(stack, length);
+	stream_write(_profile_trace_stream, STRING_CONST("}}"));
+}
+
+static void
+_profile_trace_flush_message(void) {
+	const profile_block_t* block = &_profile_trace_message;
+	const char* text = _profile_trace_message_text;
+	size_t length = _profile_trace_message_length;
+
+	if (!block->data.id)
+		return;
+
+	switch (block->data.id) {
+	case PROFILE_ID_LOGMESSAGE:
+		_profile_trace_write_event(block, text, length, "log", 0, 0);
+		break;
+	case PROFILE_ID_TRYLOCK:
+		_profile_trace_write_event(block, STRING_CONST("trylock"), "lock", text, length);
+		break;
+	case PROFILE_ID_LOCK:
+		_profile_trace_write_event(block, STRING_CONST("lock"), "lock", text, length);
+		break;
+	case PROFILE_ID_UNLOCK:
+		_profile_trace_write_event(block, STRING_CONST("unlock"), "lock", text, length);
+		break;
+	case PROFILE_ID_WAIT:
+		_profile_trace_write_event(block, STRING_CONST("wait"), "sync", text, length);
+		break;
+	case PROFILE_ID_SIGNAL:
+		_profile_trace_write_event(block, STRING_CONST("signal"), "sync", text, length);
+		break;
+	case PROFILE_ID_SAMPLE:
+		_profile_trace_write_sample(block, text, length);
+		break;
+	default:
+		break;
+	}
+	memset(&_profile_trace_message, 0, sizeof(profile_block_t));
+	_profile_trace_message_length = 0;
+}
+
+//Converts blocks to Chrome trace events. Messages longer than a block are split into a
+//chain of continuation blocks written directly after the first block, each one parented
+//to the counter of the previous part, so parts are gathered until the chain breaks
+static void
+_profile_trace_write(void* buffer, size_t size) {
+	const profile_block_t* block = buffer;
+	size_t length;
+
+	if (!_profile_trace_stream || (size < sizeof(profile_block_t)))
+		return;
+
+	length = string_length(block->data.name);
+	if (_profile_trace_message.data.id &&
+	        (block->data.id == _profile_trace_message.data.id + 1) &&
+	        (block->data.parentid == (int32_t)_profile_trace_message.data.end)) {
+		length = (length < sizeof(_profile_trace_message_text) - _profile_trace_message_length) ?
+		         length : sizeof(_profile_trace_message_text) - _profile_trace_message_length;
+		memcpy(_profile_trace_message_text + _profile_trace_message_length, block->data.name, length);
+		_profile_trace_message_length += length;
+		_profile_trace_message.data.end = block->data.end;
+		return;
+	}
+	_profile_trace_flush_message();
+
+	switch (block->data.id) {
+	case PROFILE_ID_ENDOFSTREAM:
+	case PROFILE_ID_SYSTEMINFO:
+		stream_flush(_profile_trace_stream);
+		break;
+	case PROFILE_ID_ENDFRAME:
+		_profile_trace_write_event(block, STRING_CONST("frame"), "frame", 0, 0);
+		break;
+	case PROFILE_ID_COUNTER:
+		_profile_trace_write_counter(block, length);
+		break;
+	case PROFILE_ID_LOGMESSAGE:
+	case PROFILE_ID_TRYLOCK:
+	case PROFILE_ID_LOCK:
+	case PROFILE_ID_UNLOCK:
+	case PROFILE_ID_WAIT:
+	case PROFILE_ID_SIGNAL:
+	case PROFILE_ID_SAMPLE:
+		memcpy(&_profile_trace_message, block, sizeof(profile_block_t));
+		memcpy(_profile_trace_message_text, block->data.name, length);
+		_profile_trace_message_length = length;
+		break;
+	default:
+		_profile_trace_write_event(block, block->data.name, length, "block", 0, 0);
+		break;
+	}
+}
+
 void
 profile_initialize(const char* identifier, size_t length, void* buffer, size_t size) {
 	profile_block_t* root  = buffer;
-	profile_block_t* block = root;
-	uint32_t num_blocks = (uint32_t)(size / sizeof(profile_block_t));
+	uint32_t num_blocks = (uint32_t)(size / (sizeof(profile_block_t) + sizeof(lockfree_node_t)));
 	uint32_t i;
 
 	if (num_blocks > 65535)
 		num_blocks = 65535;
 
-	for (i = 0; i < (num_blocks - 1); ++i, ++block) {
-		block->child = (uint16_t)(i + 1);
-		block->sibling = 0;
+	_profile_blocks = root;
+	_profile_nodes = pointer_offset(buffer, sizeof(profile_block_t) * num_blocks);
+
+	//TODO: Currently 0 is a no-block identifier, so we waste the first block
+	lockfree_stack_initialize(&_profile_free);
+	root[0].child = 0;
+	root[0].sibling = 0;
+	for (i = 1; i < num_blocks; ++i) {
+		bool last_in_batch = ((i % PROFILE_BATCH_SIZE) == 0) || (i + 1 == num_blocks);
+		root[i].child = last_in_batch ? 0 : (uint16_t)(i + 1);
+		root[i].sibling = 0;
+		if (((i - 1) % PROFILE_BATCH_SIZE) == 0)
+			lockfree_stack_push(&_profile_free, GET_NODE(i));
 	}
-	block->child = 0;
-	block->sibling = 0;
-	root->child = 0;
 
-	atomic_store32(&_profile_root, 0);
+	atomic_storeptr(&_profile_threads, 0);
+	memset(_profile_counters, 0, sizeof(_profile_counters));
+	_profile_io_free = 0;
+	_profile_io_free_last = 0;
+	_profile_io_free_count = 0;
 
 	_profile_num_blocks = num_blocks;
 	_profile_identifier = string_const(identifier, length);
-	_profile_blocks = root;
-	//TODO: Currently 0 is a no-block identifier, so we waste the first block
-	atomic_store32(&_profile_free, 1);
 	atomic_store32(&_profile_counter, 128);
 	_profile_ground_time = time_current();
+	profile_set_contention_threshold(_profile_contention_us);
 	set_thread_profile_block(0);
 
 	thread_initialize(&_profile_io_thread, _profile_io, 0, STRING_CONST("profile_io"),
@@ -368,31 +1096,31 @@ profile_finalize(void) {
 
 	thread_signal(&_profile_io_thread);
 	thread_finalize(&_profile_io_thread);
+	_profile_sample_finalize();
 
 	//Discard and free up blocks remaining in queue
 	_profile_thread_finalize();
-	if (atomic_load32(&_profile_root))
+	if (_profile_has_root_block())
 		_profile_process_root_block();
 
 	//Sanity checks
 	{
 		uint64_t num_blocks = 0;
-		uint32_t free_block = atomic_load32(&_profile_free) & 0xffff;
+		lockfree_node_t* free_node = lockfree_stack_pop_all(&_profile_free);
+		profile_thread_t* thread;
 
-		if (atomic_load32(&_profile_root))
+		if (_profile_has_root_block())
 			log_error(0, ERROR_INTERNAL_FAILURE,
 			          STRING_CONST("Profile module state inconsistent on finalize, "
 			                       "at least one root block still allocated/active"));
 
-		while (free_block) {
-			profile_block_t* block = GET_BLOCK(free_block);
-			if (block->sibling)
-				log_errorf(0, ERROR_INTERNAL_FAILURE,
-				           STRING_CONST("Profile module state inconsistent on finalize, "
-				                        "block %d has sibling set"), free_block);
-			++num_blocks;
-			free_block = GET_BLOCK(free_block)->child;
+		//Free blocks are in shared batches or cached by threads still alive
+		while (free_node) {
+			num_blocks += _profile_count_free_blocks(NODE_INDEX(free_node));
+			free_node = atomic_loadptr(&free_node->next);
 		}
+		for (thread = atomic_loadptr(&_profile_threads); thread; thread = thread->next)
+			num_blocks += _profile_count_free_blocks(thread->free);
 		if (_profile_num_blocks)
 			++num_blocks; //Include the wasted block 0
 
@@ -406,8 +1134,21 @@ profile_finalize(void) {
 		}
 	}
 
-	atomic_store32(&_profile_root, 0);
-	atomic_store32(&_profile_free, 0);
+	//Threads still alive hold records from this session, the generation change makes them
+	//acquire new records if profiling is initialized again
+	{
+		profile_thread_t* thread = atomic_loadptr(&_profile_threads);
+		atomic_storeptr(&_profile_threads, 0);
+		while (thread) {
+			profile_thread_t* next = thread->next;
+			memory_deallocate(thread);
+			thread = next;
+		}
+	}
+	++_profile_generation;
+
+	lockfree_stack_initialize(&_profile_free);
+	_profile_nodes = 0;
 
 	_profile_num_blocks = 0;
 	_profile_identifier = string_null();
@@ -419,6 +1160,88 @@ profile_set_output(profile_write_fn writer) {
 	_profile_write = writer;
 }
 
+void
+profile_set_output_stream(stream_t* stream) {
+	if (_profile_trace_stream) {
+		_profile_trace_flush_message();
+		stream_write(_profile_trace_stream, STRING_CONST("\n]\n"));
+		stream_flush(_profile_trace_stream);
+	}
+
+	_profile_trace_stream = stream;
+	_profile_trace_separator = false;
+	memset(&_profile_trace_message, 0, sizeof(profile_block_t));
+	_profile_trace_message_length = 0;
+
+	if (stream) {
+		_profile_trace_tick_us = 1000000.0 / (double)time_ticks_per_second();
+		stream_write(_profile_trace_stream, STRING_CONST("[\n"));
+		if (_profile_identifier.length) {
+			_profile_trace_separator = true;
+			stream_write(_profile_trace_stream, STRING_CONST("{\"name\":\"process_name\",\"ph\":\"M\","
+			                                                 "\"pid\":0,\"args\":{\"name\":"));
+			_profile_trace_write_string(STRING_ARGS(_profile_identifier));
+			stream_write(_profile_trace_stream, STRING_CONST("}}"));
+		}
+		_profile_write = _profile_trace_write;
+	}
+	else if (_profile_write == _profile_trace_write) {
+		_profile_write = 0;
+	}
+}
+
+void
+profile_set_output_remote(stream_t* stream, size_t buffer_size) {
+	if (_profile_remote_buffer) {
+		if (_profile_write == _profile_remote_write)
+			_profile_write = 0;
+		thread_signal(&_profile_remote_thread);
+		thread_finalize(&_profile_remote_thread);
+		ringbuffer_spsc_deallocate(_profile_remote_buffer);
+		hashmap_string_finalize(&_profile_remote_names);
+		memory_deallocate(_profile_remote_table);
+		_profile_remote_buffer = 0;
+		_profile_remote_table = 0;
+	}
+
+	_profile_remote_stream = stream;
+	if (!stream)
+		return;
+
+	_profile_remote_buffer = ringbuffer_spsc_allocate(buffer_size ? buffer_size : (256 * 1024));
+	_profile_remote_start = 0;
+	_profile_remote_last_id = 0;
+	_profile_remote_last_thread = 0;
+	_profile_remote_table = memory_allocate(0, sizeof(profile_remote_name_t) * PROFILE_REMOTE_NAMES, 0,
+	                                        MEMORY_PERSISTENT);
+	_profile_remote_table_next = 0;
+	hashmap_string_initialize(&_profile_remote_names, PROFILE_REMOTE_NAMES);
+	atomic_store64(&_profile_remote_dropped, 0);
+
+	//Header is written before the output thread can start producing records
+	{
+		uint8_t header[32];
+		size_t length = 4;
+		size_t identifier_length = _profile_identifier.length;
+		memcpy(header, "FPRF", 4);
+		header[length++] = 2;
+		length += _profile_remote_encode_uint(header + length, (uint64_t)time_ticks_per_second());
+		length += _profile_remote_encode_uint(header + length, identifier_length);
+		ringbuffer_spsc_write(_profile_remote_buffer, header, length);
+		ringbuffer_spsc_write(_profile_remote_buffer, _profile_identifier.str, identifier_length);
+	}
+
+	thread_initialize(&_profile_remote_thread, _profile_remote, 0, STRING_CONST("profile_remote"),
+	                  THREAD_PRIORITY_BELOWNORMAL, 0);
+	thread_start(&_profile_remote_thread);
+	_profile_write = _profile_remote_write;
+}
+
+uint64_t
+profile_remote_dropped(void) {
+	return (uint64_t)atomic_load64(&_profile_remote_dropped);
+}
+
 void
 profile_set_output_wait(unsigned int ms) {
 	_profile_wait = (ms ? ms : 1U);
@@ -436,9 +1259,11 @@ profile_enable(bool enable) {
 		//Start output thread
 		_profile_enable = 1;
 		thread_start(&_profile_io_thread);
+		_profile_sample_start();
 	}
 	else if (!is_enabled && was_enabled) {
-		//Stop output thread
+		//Stop sampling and output thread
+		_profile_sample_stop();
 		thread_signal(&_profile_io_thread);
 		thread_join(&_profile_io_thread);
 		_profile_enable = 0;
@@ -448,6 +1273,7 @@ profile_enable(bool enable) {
 void
 profile_end_frame(uint64_t counter) {
 	profile_block_t* block;
+	unsigned int icounter;
 	if (!_profile_enable)
 		return;
 
@@ -461,6 +1287,20 @@ profile_end_frame(uint64_t counter) {
 	block->data.start  = time_current() - _profile_ground_time;
 	block->data.end = (tick_t)counter;
 
+	//Emit counters accumulated over the frame before the frame end token
+	for (icounter = 0; icounter < PROFILE_COUNTER_MAX; ++icounter) {
+		profile_counter_t* frame_counter = _profile_counters + icounter;
+		const char* name = atomic_loadptr_explicit(&frame_counter->name, MEMORY_ORDER_ACQUIRE);
+		int64_t value;
+		if (!name)
+			continue;
+		do {
+			value = atomic_load64(&frame_counter->value);
+		}
+		while (value && !atomic_cas64(&frame_counter->value, 0, value));
+		_profile_put_counter_block(name, frame_counter->length, value, block->data.start);
+	}
+
 	_profile_put_simple_block(BLOCK_INDEX(block));
 }
 
@@ -478,7 +1318,7 @@ profile_begin_block(const char* message, size_t length) {
 		if (!block)
 			return;
 		blockindex = BLOCK_INDEX(block);
-		block->data.id = atomic_add32(&_profile_counter, 1);
+		block->data.id = _profile_id();
 		string_copy(block->data.name, sizeof(block->data.name), message, length);
 		block->data.processor = thread_hardware();
 		block->data.thread = (uint32_t)thread_id();
@@ -494,7 +1334,7 @@ profile_begin_block(const char* message, size_t length) {
 			return;
 		subindex = BLOCK_INDEX(subblock);
 		parentblock = GET_BLOCK(parent);
-		subblock->data.id = atomic_add32(&_profile_counter, 1);
+		subblock->data.id = _profile_id();
 		subblock->data.parentid = parentblock->data.id;
 		string_copy(subblock->data.name, sizeof(subblock->data.name), message, length);
 		subblock->data.processor = thread_hardware();
@@ -618,6 +1458,82 @@ profile_signal(const char* name, size_t length) {
 	_profile_put_message_block(PROFILE_ID_SIGNAL, name, length);
 }
 
+void
+profile_contention(const char* name, size_t length, tick_t start, tick_t end) {
+	profile_block_t* block;
+	int32_t parent;
+	if (!_profile_enable || ((end - start) < _profile_contention_threshold))
+		return;
+
+	block = _profile_allocate_block();
+	if (!block)
+		return;
+	parent = get_thread_profile_block();
+	block->data.id = _profile_id();
+	block->data.parentid = parent ? GET_BLOCK(parent)->data.id : 0;
+	block->data.processor = thread_hardware();
+	block->data.thread = (uint32_t)thread_id();
+	block->data.start = start - _profile_ground_time;
+	block->data.end = end - _profile_ground_time;
+	string_copy(block->data.name, sizeof(block->data.name), name, length);
+
+	_profile_put_simple_block(BLOCK_INDEX(block));
+}
+
+void
+profile_gauge(const char* name, size_t length, int64_t value) {
+	if (!_profile_enable)
+		return;
+	_profile_put_counter_block(name, length, value, time_current() - _profile_ground_time);
+}
+
+void
+profile_counter(const char* name, size_t length, int64_t delta) {
+	hash_t key;
+	unsigned int islot, icounter;
+	if (!_profile_enable)
+		return;
+
+	key = hash(name, length);
+	key = key ? key : 1;
+	for (islot = 0; islot < PROFILE_COUNTER_MAX; ++islot) {
+		profile_counter_t* counter;
+		int64_t slot_key;
+		icounter = (unsigned int)((key + islot) % PROFILE_COUNTER_MAX);
+		counter = _profile_counters + icounter;
+		slot_key = atomic_load64(&counter->key);
+		if (!slot_key) {
+			if (!atomic_cas64(&counter->key, (int64_t)key, 0)) {
+				slot_key = atomic_load64(&counter->key);
+			}
+			else {
+				counter->length = length;
+				atomic_storeptr_explicit(&counter->name, (void*)name, MEMORY_ORDER_RELEASE);
+				slot_key = (int64_t)key;
+			}
+		}
+		if (slot_key == (int64_t)key) {
+			atomic_add64(&counter->value, delta);
+			return;
+		}
+	}
+}
+
+void
+profile_set_sample_rate(unsigned int rate) {
+	_profile_sample_rate = rate;
+	if (_profile_enable) {
+		_profile_sample_stop();
+		_profile_sample_start();
+	}
+}
+
+void
+profile_set_contention_threshold(unsigned int microseconds) {
+	_profile_contention_us = microseconds;
+	_profile_contention_threshold = ((tick_t)microseconds * time_ticks_per_second()) / 1000000LL;
+}
+
 string_const_t
 profile_identifier(void) {
 	return _profile_identifier;
@@ -629,6 +1545,7 @@ void
 _profile_thread_finalize(void) {
 #if BUILD_ENABLE_PROFILE
 	int32_t block_index, last_block = 0;
+	profile_thread_t* thread;
 	while ((block_index = get_thread_profile_block())) {
 		log_warnf(0, WARNING_SUSPICIOUS, STRING_CONST("Profile thread cleanup, free block %u"),
 		          block_index);
@@ -640,5 +1557,16 @@ _profile_thread_finalize(void) {
 		profile_end_block();
 		last_block = block_index;
 	}
+
+	//Return cached blocks and release record for reuse, published roots are left for
+	//the output thread to drain
+	thread = get_thread_profile_thread();
+	if (thread && _profile_initialized && (get_thread_profile_generation() == _profile_generation)) {
+		if (thread->free)
+			lockfree_stack_push(&_profile_free, GET_NODE(thread->free));
+		thread->free = 0;
+		atomic_store32(&thread->owned, 0);
+	}
+	set_thread_profile_thread(0);
 #endif
 }
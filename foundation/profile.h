@@ -30,9 +30,14 @@ The string passed to the function must be constant over the execution of the app
 whatever you want it to identify.
 
 Memory buffer should be large enough to hold data for ~100ms to avoid excessive calls to
-output flush function. The profile subsystem will not allocate any memory, it only uses
-the passed in work buffer. Recommended size is at least 256KiB. Maximum usable size is
-4MiB, since the profiling system can only use 65k blocks of 64 bytes each.
+output flush function. Blocks are only taken from the passed in work buffer, the profile
+subsystem only allocates a small record per profiled thread. Recommended size is at least
+256KiB. Each block uses 64 bytes plus a pointer sized list node, and the profiling system
+can only use 65k blocks, so the maximum usable size is roughly 4.5MiB.
+
+Each thread caches a small batch of free blocks from the work buffer and publishes
+completed blocks in a list of its own, so threads do not contend on shared state when
+beginning and ending blocks. The cached blocks are returned when the thread exits.
 \param identifier Application identifier
 \param length Length of identifier
 \param buffer Work temporary buffer
@@ -57,6 +62,51 @@ output stream you want.
 FOUNDATION_API void
 profile_set_output(profile_write_fn writer);
 
+/*! Set output stream. Replaces the output function with a built-in writer that converts
+profile data to Chrome Trace Event JSON format, which can be loaded in chrome://tracing and
+the Perfetto UI. Blocks are written as complete events, log messages, lock and wait markers
+and frame ends as instant events. Should be called after #profile_initialize and while
+profiling is disabled. The stream must remain valid until the output stream is changed,
+which terminates the JSON array in the previous stream. Pass a null pointer to terminate
+the current stream and clear the output.
+\param stream Output stream, null to close current stream */
+FOUNDATION_API void
+profile_set_output_stream(stream_t* stream);
+
+/*! Set remote output stream. Replaces the output function with a built-in writer that
+streams compact encoded profile data to the given stream, typically a socket stream
+connected to a profile viewer. Encoding is done by the profile output thread into a send
+buffer, and a separate sender thread writes the buffer to the stream. If the stream does
+not keep up and the send buffer is full, data is dropped rather than stalling the output
+thread, see #profile_remote_dropped.
+
+The stream starts with the four bytes "FPRF", a version byte (2), the number of ticks per
+second and the length of the identifier followed by the identifier string. Each block is
+then encoded as a sequence of LEB128 variable length integers: id delta to previous block,
+id minus parent id, processor, thread delta to previous block, start time delta to previous
+block, end time delta to start time and a name reference. Deltas are zigzag encoded.
+
+Names are sent through a string table of 1024 entries kept in sync by both ends. A name
+reference of zero is followed by the name length and name, and the name is not stored in the
+table. A reference of one is followed by the name length and name, and the name is stored
+in the next table entry, starting at entry zero and wrapping around to replace the oldest
+entry once the table is full. A reference of two or more refers to table entry (reference
+minus two). Log messages and samples are sent without table entries.
+
+Should be called after #profile_initialize and while profiling is disabled. Passing a null
+pointer stops the sender thread after writing any buffered data and clears the output.
+The stream must remain valid until then.
+\param stream Output stream, null to stop streaming
+\param buffer_size Size of send buffer in bytes, zero for default (256KiB) */
+FOUNDATION_API void
+profile_set_output_remote(stream_t* stream, size_t buffer_size);
+
+/*! Get number of blocks dropped by the remote output since it was set, because the send
+buffer was full.
+\return Number of dropped blocks */
+FOUNDATION_API uint64_t
+profile_remote_dropped(void);
+
 /*! Control profile output rate by setting time between flushes in milliseconds. Default is
 100ms. Decresee time (increase rate) when passing a smaller buffer to initialization, or
 increase time (decrease rate) if passing a larger buffer.
@@ -65,7 +115,8 @@ FOUNDATION_API void
 profile_set_output_wait(unsigned int ms);
 
 /*! End a frame. Inserts a token into the profiling stream that identifies the end of a frame,
-effectively grouping profile information together in a block.
+effectively grouping profile information together in a block. Samples of all counters
+accumulated with #profile_counter are inserted before the token.
 \param counter Frame counter */
 FOUNDATION_API void
 profile_end_frame(uint64_t counter);
@@ -134,6 +185,61 @@ the block is written to the output stream.
 FOUNDATION_API void
 profile_signal(const char* name, size_t length);
 
+/*! Contention notification. Call this method right after the thread has acquired a
+contended resource or finished a blocking wait. If the time spent waiting exceeds the
+contention threshold a timed block named after the resource is inserted into the profile
+stream. Mutexes, semaphores and beacons call this automatically. The string passed to this
+function must be constant until the block is written to the output stream.
+\param name Lock name
+\param length Length of lock name
+\param start Timestamp when the thread started waiting
+\param end Timestamp when the thread stopped waiting */
+FOUNDATION_API void
+profile_contention(const char* name, size_t length, tick_t start, tick_t end);
+
+/*! Insert gauge sample. Records the current value of a named quantity, for example queue
+depth or bytes allocated. The string passed to this function must be constant until the
+block is written to the output stream, and is truncated to 25 characters.
+\param name Gauge name
+\param length Length of name
+\param value Current value */
+FOUNDATION_API void
+profile_gauge(const char* name, size_t length, int64_t value);
+
+/*! Add to a named counter. Counters are accumulated between frames and a sample with the
+accumulated value is inserted for each counter and the counter reset by each call to
+#profile_end_frame, for example to track events per frame. Once used a counter is sampled
+every frame until profiling is reinitialized. The string passed to this function must be
+constant until profiling is finalized, and is truncated to 25 characters in samples. At
+most 64 distinct counters are tracked, additional counters are ignored.
+\param name Counter name
+\param length Length of name
+\param delta Value to add */
+FOUNDATION_API void
+profile_counter(const char* name, size_t length, int64_t delta);
+
+/*! Set sampling rate. When non-zero, call stacks of running threads are sampled at the
+given rate while profiling is enabled, in addition to the instrumented blocks. Samples are
+aggregated per unique call stack and thread by the output thread, and each pass writes
+one sample record per stack sampled since the previous pass, holding the sample count and
+the stack folded into a single line of semicolon separated function names from root to
+leaf. Stacks are symbolized with #stacktrace_resolve once, the first time they are written.
+
+Sampling uses a profiling interval timer, where the rate is measured in process CPU time,
+and is only available on POSIX platforms. The SIGPROF signal is used to capture samples,
+which can interrupt blocking system calls in the sampled threads. Default is zero,
+sampling disabled.
+\param rate Samples per second, zero to disable sampling */
+FOUNDATION_API void
+profile_set_sample_rate(unsigned int rate);
+
+/*! Set contention threshold in microseconds. Waits on contended resources longer than the
+threshold generate a timed block in the profile stream, see #profile_contention. Default
+is 1000 microseconds.
+\param microseconds Threshold in microseconds */
+FOUNDATION_API void
+profile_set_contention_threshold(unsigned int microseconds);
+
 /*! Get profile identifier
 \return Identifier given to profile_initialize */
 FOUNDATION_API string_const_t
@@ -145,6 +251,9 @@ profile_identifier(void);
 #define profile_finalize() do {} while(0)
 #define profile_enable(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define profile_set_output(fn) do { profile_write_fn tmpfn = fn; FOUNDATION_UNUSED(tmpfn); } while(0)
+#define profile_set_output_stream(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_set_output_remote(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_remote_dropped() 0
 #define profile_set_output_wait(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define profile_end_frame(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define profile_begin_block_(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
@@ -164,6 +273,14 @@ profile_identifier(void);
 #define profile_wait(...) profile_wait_(__VA_ARGS__)
 #define profile_signal_(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define profile_signal(...) profile_signal_(__VA_ARGS__)
+#define profile_contention_(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_contention(...) profile_contention_(__VA_ARGS__)
+#define profile_gauge_(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_gauge(...) profile_gauge_(__VA_ARGS__)
+#define profile_counter_(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_counter(...) profile_counter_(__VA_ARGS__)
+#define profile_set_sample_rate(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
+#define profile_set_contention_threshold(...) do { FOUNDATION_UNUSED_VARARGS(__VA_ARGS__); } while(0)
 #define profile_identifier() string_null()
 
 #endif
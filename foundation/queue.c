@@ -0,0 +1,225 @@
+/* queue.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+queue_t*
+queue_allocate(size_t capacity) {
+	queue_t* queue = memory_allocate(0, sizeof(queue_t), 64, MEMORY_PERSISTENT);
+	queue_initialize(queue, capacity);
+	return queue;
+}
+
+void
+queue_deallocate(queue_t* queue) {
+	if (!queue)
+		return;
+	queue_finalize(queue);
+	memory_deallocate(queue);
+}
+
+void
+queue_initialize(queue_t* queue, size_t capacity) {
+	size_t islot;
+
+	memset(queue, 0, sizeof(queue_t));
+
+	queue->capacity = 2;
+	while (queue->capacity < capacity)
+		queue->capacity <<= 1;
+	queue->mask = queue->capacity - 1;
+	queue->slot = memory_allocate(0, sizeof(queue_slot_t) * queue->capacity, 64, MEMORY_PERSISTENT);
+	for (islot = 0; islot < queue->capacity; ++islot) {
+		atomic_store64(&queue->slot[islot].sequence, (int64_t)islot);
+		queue->slot[islot].item = 0;
+	}
+
+	atomic_store64(&queue->enqueue, 0);
+	atomic_store64(&queue->dequeue, 0);
+	atomic_store32(&queue->waiting_push, 0);
+	atomic_store32(&queue->waiting_pop, 0);
+	semaphore_initialize(&queue->signal_push, 0);
+	semaphore_initialize(&queue->signal_pop, 0);
+}
+
+void
+queue_finalize(queue_t* queue) {
+	semaphore_finalize(&queue->signal_push);
+	semaphore_finalize(&queue->signal_pop);
+	memory_deallocate(queue->slot);
+	queue->slot = 0;
+}
+
+size_t
+queue_capacity(const queue_t* queue) {
+	return queue->capacity;
+}
+
+size_t
+queue_size(const queue_t* queue) {
+	int64_t dequeue = atomic_load64(&queue->dequeue);
+	int64_t enqueue = atomic_load64(&queue->enqueue);
+	return (enqueue > dequeue) ? (size_t)(enqueue - dequeue) : 0;
+}
+
+static bool
+_queue_push(queue_t* queue, void* item) {
+	queue_slot_t* slot;
+	int64_t pos = atomic_load64(&queue->enqueue);
+	while (true) {
+		int64_t sequence, diff;
+		slot = queue->slot + ((size_t)pos & queue->mask);
+		sequence = atomic_load64(&slot->sequence);
+		diff = sequence - pos;
+		if (!diff) {
+			if (atomic_cas64(&queue->enqueue, pos + 1, pos))
+				break;
+			pos = atomic_load64(&queue->enqueue);
+		}
+		else if (diff < 0) {
+			//Slot not yet released by consumer a lap behind, queue is full
+			return false;
+		}
+		else {
+			pos = atomic_load64(&queue->enqueue);
+		}
+	}
+
+	atomic_thread_fence_acquire();
+	slot->item = item;
+	atomic_thread_fence_release();
+	atomic_store64(&slot->sequence, pos + 1);
+	return true;
+}
+
+static void*
+_queue_pop(queue_t* queue) {
+	queue_slot_t* slot;
+	void* item;
+	int64_t pos = atomic_load64(&queue->dequeue);
+	while (true) {
+		int64_t sequence, diff;
+		slot = queue->slot + ((size_t)pos & queue->mask);
+		sequence = atomic_load64(&slot->sequence);
+		diff = sequence - (pos + 1);
+		if (!diff) {
+			if (atomic_cas64(&queue->dequeue, pos + 1, pos))
+				break;
+			pos = atomic_load64(&queue->dequeue);
+		}
+		else if (diff < 0) {
+			//Slot not yet written by producer, queue is empty
+			return 0;
+		}
+		else {
+			pos = atomic_load64(&queue->dequeue);
+		}
+	}
+
+	atomic_thread_fence_acquire();
+	item = slot->item;
+	atomic_thread_fence_release();
+	atomic_store64(&slot->sequence, pos + (int64_t)queue->capacity);
+	return item;
+}
+
+static void
+_queue_signal(atomic32_t* waiting, semaphore_t* signal) {
+	atomic_thread_fence_sequentially_consistent();
+	if (atomic_load32(waiting))
+		semaphore_post(signal);
+}
+
+static bool
+_queue_wait(semaphore_t* signal, tick_t start, unsigned int milliseconds) {
+	real elapsed;
+	if (!milliseconds)
+		return semaphore_wait(signal);
+	elapsed = time_ticks_to_seconds(time_elapsed_ticks(start)) * REAL_C(1000.0);
+	if (elapsed >= (real)milliseconds)
+		return false;
+	return semaphore_try_wait(signal, milliseconds - (unsigned int)elapsed);
+}
+
+static bool
+_queue_push_wait(queue_t* queue, void* item, unsigned int milliseconds) {
+	tick_t start = milliseconds ? time_current() : 0;
+	bool pushed = false;
+	while (!pushed) {
+		//Waiting count must be visible before the retry to avoid missed wakeups, a
+		//redundant post only causes a spurious wakeup and retry
+		atomic_incr32(&queue->waiting_push);
+		atomic_thread_fence_sequentially_consistent();
+		pushed = _queue_push(queue, item);
+		if (!pushed && !_queue_wait(&queue->signal_push, start, milliseconds))
+			pushed = _queue_push(queue, item);
+		atomic_decr32(&queue->waiting_push);
+		if (!pushed && milliseconds &&
+		        (time_ticks_to_seconds(time_elapsed_ticks(start)) * REAL_C(1000.0) >= (real)milliseconds))
+			break;
+	}
+	return pushed;
+}
+
+static void*
+_queue_pop_wait(queue_t* queue, unsigned int milliseconds) {
+	tick_t start = milliseconds ? time_current() : 0;
+	void* item = 0;
+	while (!item) {
+		atomic_incr32(&queue->waiting_pop);
+		atomic_thread_fence_sequentially_consistent();
+		item = _queue_pop(queue);
+		if (!item && !_queue_wait(&queue->signal_pop, start, milliseconds))
+			item = _queue_pop(queue);
+		atomic_decr32(&queue->waiting_pop);
+		if (!item && milliseconds &&
+		        (time_ticks_to_seconds(time_elapsed_ticks(start)) * REAL_C(1000.0) >= (real)milliseconds))
+			break;
+	}
+	return item;
+}
+
+bool
+queue_try_push(queue_t* queue, void* item, unsigned int milliseconds) {
+	FOUNDATION_ASSERT(item);
+	if (!_queue_push(queue, item) && (!milliseconds || !_queue_push_wait(queue, item, milliseconds)))
+		return false;
+	_queue_signal(&queue->waiting_pop, &queue->signal_pop);
+	return true;
+}
+
+void
+queue_push(queue_t* queue, void* item) {
+	FOUNDATION_ASSERT(item);
+	if (!_queue_push(queue, item))
+		_queue_push_wait(queue, item, 0);
+	_queue_signal(&queue->waiting_pop, &queue->signal_pop);
+}
+
+void*
+queue_try_pop(queue_t* queue, unsigned int milliseconds) {
+	void* item = _queue_pop(queue);
+	if (!item && milliseconds)
+		item = _queue_pop_wait(queue, milliseconds);
+	if (item)
+		_queue_signal(&queue->waiting_push, &queue->signal_push);
+	return item;
+}
+
+void*
+queue_pop(queue_t* queue) {
+	void* item = _queue_pop(queue);
+	if (!item)
+		item = _queue_pop_wait(queue, 0);
+	_queue_signal(&queue->waiting_push, &queue->signal_push);
+	return item;
+}
@@ -0,0 +1,95 @@
+/* queue.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file queue.h
+\brief Bounded multi-producer, multi-consumer queue
+
+Bounded lock free queue of pointer sized items, safe for any number of threads pushing and
+popping concurrently. Each slot carries a sequence number flagging if the slot is ready to
+be written or read at a given position, so producers and consumers only contend on the
+position counters. Items are popped in the order they were pushed.
+
+Blocking push and pop wait on semaphores when the queue is full or empty. Waiting threads
+might wake up spuriously and retry, the blocking functions only return once the operation
+succeeded or the timeout expired. Items are non-null pointers, a null pointer is used to
+signal an empty queue. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a queue with the given capacity. Deallocate the queue with a call to
+#queue_deallocate.
+\param capacity Maximum number of items, rounded up to a power of two
+\return New queue */
+FOUNDATION_API queue_t*
+queue_allocate(size_t capacity);
+
+/*! Deallocate a queue previously allocated with a call to #queue_allocate. Items
+still in the queue are discarded.
+\param queue Queue */
+FOUNDATION_API void
+queue_deallocate(queue_t* queue);
+
+/*! Initialize a queue with the given capacity. Finalize the queue with a call to
+#queue_finalize.
+\param queue Queue
+\param capacity Maximum number of items, rounded up to a power of two */
+FOUNDATION_API void
+queue_initialize(queue_t* queue, size_t capacity);
+
+/*! Finalize a queue previously initialized with a call to #queue_initialize. Items
+still in the queue are discarded.
+\param queue Queue */
+FOUNDATION_API void
+queue_finalize(queue_t* queue);
+
+/*! Get maximum number of items in queue
+\param queue Queue
+\return Capacity of queue */
+FOUNDATION_API size_t
+queue_capacity(const queue_t* queue);
+
+/*! Get number of items in queue. The value is only approximate if other threads are
+concurrently pushing or popping items.
+\param queue Queue
+\return Number of items */
+FOUNDATION_API size_t
+queue_size(const queue_t* queue);
+
+/*! Push an item to the queue, blocking while the queue is full
+\param queue Queue
+\param item Item, must not be null */
+FOUNDATION_API void
+queue_push(queue_t* queue, void* item);
+
+/*! Push an item to the queue, waiting at most the given time if the queue is full
+\param queue Queue
+\param item Item, must not be null
+\param milliseconds Timeout in milliseconds, 0 to return immediately if full
+\return true if item was pushed, false if queue was full */
+FOUNDATION_API bool
+queue_try_push(queue_t* queue, void* item, unsigned int milliseconds);
+
+/*! Pop an item from the queue, blocking while the queue is empty
+\param queue Queue
+\return Item */
+FOUNDATION_API void*
+queue_pop(queue_t* queue);
+
+/*! Pop an item from the queue, waiting at most the given time if the queue is empty
+\param queue Queue
+\param milliseconds Timeout in milliseconds, 0 to return immediately if empty
+\return Item, 0 if queue was empty */
+FOUNDATION_API void*
+queue_try_pop(queue_t* queue, unsigned int milliseconds);
@@ -18,7 +18,8 @@ static const unsigned int _radixsort_data_size[] = {
 	8, //RADIXSORT_INT64,
 	8, //RADIXSORT_UINT64,
 	4, //RADIXSORT_FLOAT32
-	8  //RADIXSORT_FLOAT64
+	8, //RADIXSORT_FLOAT64
+	16 //RADIXSORT_UINT128
 };
 
 static const unsigned int _radixsort_data_shift[] = {
@@ -27,7 +28,8 @@ static const unsigned int _radixsort_data_shift[] = {
 	3, //RADIXSORT_INT64,
 	3, //RADIXSORT_UINT64,
 	2, //RADIXSORT_FLOAT32
-	3  //RADIXSORT_FLOAT64
+	3, //RADIXSORT_FLOAT64
+	4  //RADIXSORT_UINT128
 };
 
 static const bool _radixsort_data_signed[] = {
@@ -36,577 +38,734 @@ static const bool _radixsort_data_signed[] = {
 	true,  //RADIXSORT_INT64,
 	false, //RADIXSORT_UINT64,
 	true,  //RADIXSORT_FLOAT32
-	true   //RADIXSORT_FLOAT64
+	true,  //RADIXSORT_FLOAT64
+	false  //RADIXSORT_UINT128
 };
 
-/*lint -e647 -e679 Not truncations since data sizes are 4 or 8 */
+/*lint -e647 -e679 Not truncations since data sizes are 4, 8 or 16 */
 /*lint -e744 We cover all cases */
-/*lint -e701 radix_index_t is NOT signed, lint gets confused */
 
-static bool
-radixsort_create_histograms(radixsort_t* sort, const void* input_raw, unsigned int num) {
-	const radixsort_data_t data_type = sort->type;
-	const unsigned int data_size = _radixsort_data_size[ data_type ];
-
-	const unsigned char* loop     = input_raw;
-	const unsigned char* loop_end = loop + (num * data_size);
-	radixsort_index_t*   indices  = sort->indices[0];
-	radixsort_index_t    curindex;
-
-	/*lint -e771 */
-	//Histograms for all passes
-	radixsort_index_t*   histogram[8];
-	unsigned int         ih;
-
-	memset(sort->histogram, 0, 256 * data_size * sizeof(radixsort_index_t));
-
-	for (ih = 0; ih < data_size; ++ih)
-		histogram[ih] = &sort->histogram[ ih << 8 ];
-
-	//Read values in previous sorted order and check if already sorted
-	//Don't allow temporal coherence if increasing in size as it might introduce duplicate indices
-	if (num <= sort->lastused) switch (data_type) {
-		case RADIXSORT_INT32: {
-				const int32_t* input = (const int32_t*)input_raw;
-
-				int32_t val;
-				int32_t prev_val = *input;
-
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
-
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-#else
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
-#endif
-				}
-
-				break;
-			}
-
-		case RADIXSORT_UINT32: {
-				const uint32_t* input = (const uint32_t*)input_raw;
-
-				uint32_t val;
-				uint32_t prev_val = *input;
-
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
-
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-#else
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
-#endif
-				}
-
-				break;
-			}
-
-		case RADIXSORT_INT64: {
-				const int64_t* input = (const int64_t*)input_raw;
-
-				int64_t val;
-				int64_t prev_val = *input;
-
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
-
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[7][ *loop++ ]);
-#else
-					++(histogram[7][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
-#endif
-				}
-
-				break;
-			}
+//Sort state independent of index width. The index, histogram and offset arrays all use the
+//index type of the sort object, and the sort functions below are force inlined with a constant
+//index width so each public sort function gets a specialized implementation
+typedef struct {
+	radixsort_data_t type;
+	size_t lastused;
+	void* indices[2];
+	void* histogram;
+	void* offset;
+} radixsort_state_t;
+
+static FOUNDATION_FORCEINLINE size_t
+radixsort_get(const void* array, size_t pos, const size_t width) {
+	if (width == 2)
+		return ((const uint16_t*)array)[pos];
+	if (width == 4)
+		return ((const uint32_t*)array)[pos];
+	return (size_t)((const uint64_t*)array)[pos];
+}
 
-		case RADIXSORT_UINT64: {
-				const uint64_t* input = (const uint64_t*)input_raw;
+static FOUNDATION_FORCEINLINE void
+radixsort_set(void* array, size_t pos, size_t value, const size_t width) {
+	if (width == 2)
+		((uint16_t*)array)[pos] = (uint16_t)value;
+	else if (width == 4)
+		((uint32_t*)array)[pos] = (uint32_t)value;
+	else
+		((uint64_t*)array)[pos] = (uint64_t)value;
+}
 
-				uint64_t val;
-				uint64_t prev_val = *input;
+static FOUNDATION_FORCEINLINE void
+radixsort_increment(void* array, size_t pos, const size_t width) {
+	if (width == 2)
+		++((uint16_t*)array)[pos];
+	else if (width == 4)
+		++((uint32_t*)array)[pos];
+	else
+		++((uint64_t*)array)[pos];
+}
 
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
+static FOUNDATION_FORCEINLINE void
+radixsort_swap(radixsort_state_t* sort) {
+	//After this swap, the valid indices (most recent) are in sort->indices[0]
+	void* swap = sort->indices[0];
+	sort->indices[0] = sort->indices[1];
+	sort->indices[1] = swap;
+}
 
+//Byte offset in a value of the byte sorted in the given pass, and the pass sorting the byte at
+//the given offset. 128-bit values are two 64-bit words in native byte order, low word first
 #if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[7][ *loop++ ]);
+#  define RADIXSORT_BYTE(ibyte, data_size) (ibyte)
 #else
-					++(histogram[7][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
+#  define RADIXSORT_WORD(data_size) (((data_size) > 8) ? 8U : (data_size))
+#  define RADIXSORT_BYTE(ibyte, data_size) \
+	((((ibyte) / RADIXSORT_WORD(data_size)) * RADIXSORT_WORD(data_size)) + \
+	 (RADIXSORT_WORD(data_size) - (((ibyte) % RADIXSORT_WORD(data_size)) + 1)))
 #endif
-				}
-
-				break;
-			}
-
-		case RADIXSORT_FLOAT32: {
-				const float32_t* input = (const float32_t*)input_raw;
-
-				float32_t val;
-				float32_t prev_val = *input;
+#define RADIXSORT_HISTOGRAM(ibyte, data_size) (RADIXSORT_BYTE(ibyte, data_size) << 8)
+
+//Count the bytes of one value in the histograms of all passes, LSB histogram first. Unrolled
+//since compilers do not reliably unroll the byte loop
+static FOUNDATION_FORCEINLINE void
+radixsort_count(void* histogram, const unsigned char* value, const unsigned int data_size,
+                const size_t width) {
+	radixsort_increment(histogram, RADIXSORT_HISTOGRAM(0U, data_size) + value[0], width);
+	radixsort_increment(histogram, RADIXSORT_HISTOGRAM(1U, data_size) + value[1], width);
+	radixsort_increment(histogram, RADIXSORT_HISTOGRAM(2U, data_size) + value[2], width);
+	radixsort_increment(histogram, RADIXSORT_HISTOGRAM(3U, data_size) + value[3], width);
+	if (data_size == 8) {
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(4U, data_size) + value[4], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(5U, data_size) + value[5], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(6U, data_size) + value[6], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(7U, data_size) + value[7], width);
+	}
+	if (data_size == 16) {
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(4U, data_size) + value[4], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(5U, data_size) + value[5], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(6U, data_size) + value[6], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(7U, data_size) + value[7], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(8U, data_size) + value[8], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(9U, data_size) + value[9], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(10U, data_size) + value[10], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(11U, data_size) + value[11], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(12U, data_size) + value[12], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(13U, data_size) + value[13], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(14U, data_size) + value[14], width);
+		radixsort_increment(histogram, RADIXSORT_HISTOGRAM(15U, data_size) + value[15], width);
+	}
+}
 
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
+#define RADIXSORT_LESS(a, b) ((a) < (b))
+#define RADIXSORT_LESS128(a, b) \
+	(((a).word[1] < (b).word[1]) || (((a).word[1] == (b).word[1]) && ((a).word[0] < (b).word[0])))
+
+//Read values in previous sorted order while counting histograms if given, returns number of
+//values read before the order was broken
+#define RADIXSORT_COUNT_SORTED(type, less) do { \
+		const type* input = (const type*)input_raw; \
+		type val; \
+		type prev_val = input[ (first < num) ? first : 0 ]; \
+		for (; ival < num; ++ival, loop += data_size) { \
+			size_t curindex = radixsort_get(sort->indices[0], ival, width); \
+			if (curindex >= num) \
+				break; \
+			val = input[ curindex ]; \
+			if (less(val, prev_val)) \
+				break; \
+			prev_val = val; \
+			if (histogram) \
+				radixsort_count(histogram, loop, data_size, width); \
+		} \
+	} while (0)
+
+static FOUNDATION_FORCEINLINE size_t
+radixsort_count_sorted(radixsort_state_t* sort, const void* input_raw, size_t num,
+                       void* histogram, const size_t width) {
+	const radixsort_data_t data_type = sort->type;
+	const unsigned int data_size = _radixsort_data_size[ data_type ];
+	const unsigned char* loop = input_raw;
+	size_t ival = 0;
+	//Start comparing with the first value in previous order
+	size_t first = radixsort_get(sort->indices[0], 0, width);
 
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-#else
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
-#endif
-				}
+	//Don't allow temporal coherence if increasing in size as it might introduce duplicate indices
+	if (num <= sort->lastused) switch (data_type) {
+		case RADIXSORT_INT32:   RADIXSORT_COUNT_SORTED(int32_t, RADIXSORT_LESS); break;
+		case RADIXSORT_UINT32:  RADIXSORT_COUNT_SORTED(uint32_t, RADIXSORT_LESS); break;
+		case RADIXSORT_INT64:   RADIXSORT_COUNT_SORTED(int64_t, RADIXSORT_LESS); break;
+		case RADIXSORT_UINT64:  RADIXSORT_COUNT_SORTED(uint64_t, RADIXSORT_LESS); break;
+		case RADIXSORT_FLOAT32: RADIXSORT_COUNT_SORTED(float32_t, RADIXSORT_LESS); break;
+		case RADIXSORT_FLOAT64: RADIXSORT_COUNT_SORTED(float64_t, RADIXSORT_LESS); break;
+		case RADIXSORT_UINT128: RADIXSORT_COUNT_SORTED(uint128_t, RADIXSORT_LESS128); break;
+		}
 
-				break;
-			}
+	return ival;
+}
 
-		case RADIXSORT_FLOAT64: {
-				const float64_t* input = (const float64_t*)input_raw;
+#undef RADIXSORT_COUNT_SORTED
+#undef RADIXSORT_LESS
+#undef RADIXSORT_LESS128
 
-				float64_t val;
-				float64_t prev_val = *input;
+static FOUNDATION_FORCEINLINE bool
+radixsort_create_histograms(radixsort_state_t* sort, const void* input_raw, size_t num,
+                            const size_t width) {
+	const radixsort_data_t data_type = sort->type;
+	const unsigned int data_size = _radixsort_data_size[ data_type ];
 
-				while (loop != loop_end) {
-					curindex = *indices++;
-					if ((curindex >= num) || ((val = input[ curindex ]) < prev_val))
-						break;
-					prev_val = val;
+	const unsigned char* loop;
+	size_t ival;
 
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-					++(histogram[0][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[7][ *loop++ ]);
-#else
-					++(histogram[7][ *loop++ ]);
-					++(histogram[6][ *loop++ ]);
-					++(histogram[5][ *loop++ ]);
-					++(histogram[4][ *loop++ ]);
-					++(histogram[3][ *loop++ ]);
-					++(histogram[2][ *loop++ ]);
-					++(histogram[1][ *loop++ ]);
-					++(histogram[0][ *loop++ ]);
-#endif
-				}
+	memset(sort->histogram, 0, 256 * data_size * width);
 
-				break;
-			}
-		}
+	//Read values in previous sorted order and check if already sorted
+	ival = radixsort_count_sorted(sort, input_raw, num, sort->histogram, width);
+	loop = pointer_offset_const(input_raw, ival * data_size);
 
-	if (loop == loop_end)
+	if (ival == num)
 		return true;
 
 	if (num != sort->lastused) {
-		for (ih = 0; ih < num; ++ih) {
-			sort->indices[0][ih] = (radixsort_index_t)ih;
-			sort->indices[1][ih] = (radixsort_index_t)ih;
+		size_t iidx;
+		for (iidx = 0; iidx < num; ++iidx) {
+			radixsort_set(sort->indices[0], iidx, iidx, width);
+			radixsort_set(sort->indices[1], iidx, iidx, width);
 		}
 	}
 
-	//Finish calculating the histograms, now without checks
-	switch (data_size) {
-	case 4: {
-			while (loop != loop_end) {
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-				++(histogram[0][ *loop++ ]);
-				++(histogram[1][ *loop++ ]);
-				++(histogram[2][ *loop++ ]);
-				++(histogram[3][ *loop++ ]);
-#else
-				++(histogram[3][ *loop++ ]);
-				++(histogram[2][ *loop++ ]);
-				++(histogram[1][ *loop++ ]);
-				++(histogram[0][ *loop++ ]);
-#endif
-			}
+	//Finish calculating the histograms, now without checks. Constant data sizes let the
+	//compiler unroll the byte loop
+	if (data_size == 4) {
+		for (; ival < num; ++ival, loop += 4)
+			radixsort_count(sort->histogram, loop, 4, width);
+	}
+	else if (data_size == 8) {
+		for (; ival < num; ++ival, loop += 8)
+			radixsort_count(sort->histogram, loop, 8, width);
+	}
+	else {
+		for (; ival < num; ++ival, loop += 16)
+			radixsort_count(sort->histogram, loop, 16, width);
+	}
 
-			break;
-		}
+	return false;
+}
 
-	case 8: {
-			while (loop != loop_end) {
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-				++(histogram[0][ *loop++ ]);
-				++(histogram[1][ *loop++ ]);
-				++(histogram[2][ *loop++ ]);
-				++(histogram[3][ *loop++ ]);
-				++(histogram[4][ *loop++ ]);
-				++(histogram[5][ *loop++ ]);
-				++(histogram[6][ *loop++ ]);
-				++(histogram[7][ *loop++ ]);
-#else
-				++(histogram[7][ *loop++ ]);
-				++(histogram[6][ *loop++ ]);
-				++(histogram[5][ *loop++ ]);
-				++(histogram[4][ *loop++ ]);
-				++(histogram[3][ *loop++ ]);
-				++(histogram[2][ *loop++ ]);
-				++(histogram[1][ *loop++ ]);
-				++(histogram[0][ *loop++ ]);
-#endif
-			}
 
-			break;
-		}
+//Scatter indices to the next index buffer in order of the given input byte
+static FOUNDATION_FORCEINLINE void
+radixsort_scatter(radixsort_state_t* sort, const unsigned char* input_bytes, size_t num,
+                  unsigned int data_shift, const size_t width) {
+	const void* indices = sort->indices[0];
+	void* indices_next = sort->indices[1];
+	void* offset = sort->offset;
+	size_t ival;
+
+	for (ival = 0; ival < num; ++ival) {
+		size_t id = radixsort_get(indices, ival, width);
+		size_t radix = input_bytes[ id << data_shift ];
+		size_t pos = radixsort_get(offset, radix, width);
+		radixsort_set(offset, radix, pos + 1, width);
+		radixsort_set(indices_next, pos, id, width);
 	}
-
-	return false;
 }
 
-static const radixsort_index_t*
-radixsort_int(radixsort_t* sort, const void* input, radixsort_index_t num) {
+static FOUNDATION_FORCEINLINE void
+radixsort_int(radixsort_state_t* sort, const void* input, size_t num, const size_t width) {
 	const radixsort_data_t data_type = sort->type;
 
 	const unsigned int data_size = _radixsort_data_size[ data_type ];
 	const bool data_signed = _radixsort_data_signed[ data_type ];
 	const unsigned int data_shift = _radixsort_data_shift[ data_type ];
-	radixsort_index_t negatives = 0;
+	size_t negatives = 0;
 	unsigned int ipass, ival;
 
-	if (!num || radixsort_create_histograms(sort, input, num))
-		return sort->indices[0]; //Already sorted
+	if (!num || radixsort_create_histograms(sort, input, num, width))
+		return; //Already sorted
 
 	if (data_signed) {
 		//Number of negatives is the last 128 values in the MSB histogram
 		//(last, since we deal with sytstem byte ordering in radixsort_create_histograms)
-		radixsort_index_t* histogram = &sort->histogram[(data_size - 1) << 8 ];
+		size_t histogram = (data_size - 1) << 8;
 		for (ival = 128; ival < 256; ++ival)
-			negatives += histogram[ival];
+			negatives += radixsort_get(sort->histogram, histogram + ival, width);
 	}
 
 	//Radix sort, j is the pass number (LSB is first histogram since
 	//radixsort_create_histograms takes system byte order into account)
 	for (ipass = 0; ipass < data_size; ++ipass) {
-		radixsort_index_t* count = &sort->histogram[ ipass << 8 ];
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-		unsigned int byteofs = ipass;
-#else
-		unsigned int byteofs = (data_size - (ipass + 1));
-#endif
+		size_t count = ipass << 8;
+		unsigned int byteofs = RADIXSORT_BYTE(ipass, data_size);
 		const unsigned char* input_bytes = pointer_offset_const(input, byteofs);
 
-		if (count[ *input_bytes ] != num) {
+		if (radixsort_get(sort->histogram, count + *input_bytes, width) != num) {
 			if ((ipass != (data_size - 1)) || !data_signed) {
 				//Unsigned data or only positive values
-				radixsort_index_t next = 0, prev = 0;
-				radixsort_index_t* offset = sort->offset;
-				*offset++ = 0;
-				for (ival = 1; ival < 256; ++ival, ++offset, ++count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
+				size_t next = 0;
+				radixsort_set(sort->offset, 0, 0, width);
+				for (ival = 1; ival < 256; ++ival) {
+					next += radixsort_get(sort->histogram, count + ival - 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 			}
 			else {
 				//Signed data, both positive and negative values
-				radixsort_index_t next = 0, prev;
-				radixsort_index_t* offset = sort->offset;
-
 				//First positive data comes after the negative data
-				*offset++ = negatives;
-				prev = negatives;
-				for (ival = 1; ival < 128; ++ival, ++offset, ++count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
+				size_t next = negatives;
+				radixsort_set(sort->offset, 0, next, width);
+				for (ival = 1; ival < 128; ++ival) {
+					next += radixsort_get(sort->histogram, count + ival - 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 
 				//Fix position for negative values
-				++count;
-				*offset++ = 0;
-				prev = 0;
-				for (ival = 129; ival < 256; ++ival, ++offset, ++count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
+				next = 0;
+				radixsort_set(sort->offset, 128, 0, width);
+				for (ival = 129; ival < 256; ++ival) {
+					next += radixsort_get(sort->histogram, count + ival - 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 			}
 
-			{
-				radixsort_index_t* indices      = sort->indices[0];
-				radixsort_index_t* indices_next = sort->indices[1];
-				radixsort_index_t* indices_end  = sort->indices[0] + num;
-				radixsort_index_t* offset       = sort->offset;
-
-				do {
-					radixsort_index_t id = *indices++;
-					indices_next[ offset[ input_bytes[ id << data_shift ] ]++ ] = id;
-				}
-				while (indices != indices_end);
-			}
-
-			//After this swap, the valid indices (most recent) are in sort->indices[0]
-			{
-				radixsort_index_t* swap = sort->indices[0];
-				sort->indices[0] = sort->indices[1];
-				sort->indices[1] = swap;
-			}
+			radixsort_scatter(sort, input_bytes, num, data_shift, width);
+			radixsort_swap(sort);
 		}
 	}
-
-	return sort->indices[0];
 }
 
-static const radixsort_index_t*
-radixsort_float(radixsort_t* sort, const void* input, radixsort_index_t num) {
+static FOUNDATION_FORCEINLINE void
+radixsort_float(radixsort_state_t* sort, const void* input, size_t num, const size_t width) {
 	const radixsort_data_t data_type = sort->type;
 	const unsigned int data_size = _radixsort_data_size[ data_type ];
 	const unsigned int data_shift = _radixsort_data_shift[ data_type ];
 
-	radixsort_index_t* histogram;
-	radixsort_index_t negatives = 0;
+	size_t histogram;
+	size_t negatives = 0;
 	unsigned int ihist, ipass, ival;
+	size_t iidx;
 
-	if (!num || radixsort_create_histograms(sort, input, num))
-		return sort->indices[0]; //Already sorted
+	if (!num || radixsort_create_histograms(sort, input, num, width))
+		return; //Already sorted
 
 	//Number of negatives is the last 128 values in the MSB histogram
 	//(last, since we deal with system byte ordering in radixsort_create_histograms)
-	histogram = &sort->histogram[(data_size - 1) << 8 ];
+	histogram = (data_size - 1) << 8;
 	for (ihist = 128; ihist < 256; ++ihist)
-		negatives += histogram[ihist];
+		negatives += radixsort_get(sort->histogram, histogram + ihist, width);
 
 	// Radix sort, j is the pass number (0 = LSB, 3/7 = MSB)
 	for (ipass = 0; ipass < data_size; ++ipass) {
-#if FOUNDATION_ARCH_ENDIAN_LITTLE
-		unsigned int byteofs = ipass;
-#else
-		unsigned int byteofs = (data_size - ipass - 1);
-#endif
+		unsigned int byteofs = RADIXSORT_BYTE(ipass, data_size);
 		const unsigned char* input_bytes = pointer_offset_const(input, byteofs);
 
-		radixsort_index_t* count = &sort->histogram[ ipass << 8 ];
+		size_t count = ipass << 8;
 		if (ipass != (data_size - 1)) {
-			if (count[ *input_bytes ] != num) {
+			if (radixsort_get(sort->histogram, count + *input_bytes, width) != num) {
 				//Only positive values
-				radixsort_index_t next = 0, prev = 0;
-				radixsort_index_t* offset = sort->offset;
-				*offset++ = 0;
-				for (ival = 1; ival < 256; ++ival, ++offset, ++count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
-				}
-
-				{
-					radixsort_index_t* indices      = sort->indices[0];
-					radixsort_index_t* indices_next = sort->indices[1];
-					radixsort_index_t* indices_end  = sort->indices[0] + num;
-
-					offset = sort->offset;
-					while (indices != indices_end) {
-						radixsort_index_t id = *indices++;
-						indices_next[ offset[ input_bytes[ id << data_shift ] ]++ ] = id;
-					}
+				size_t next = 0;
+				radixsort_set(sort->offset, 0, 0, width);
+				for (ival = 1; ival < 256; ++ival) {
+					next += radixsort_get(sort->histogram, count + ival - 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 
-				//After this swap, the valid indices (most recent) are in sort->indices[0]
-				{
-					radixsort_index_t* swap = sort->indices[0];
-					sort->indices[0] = sort->indices[1];
-					sort->indices[1] = swap;
-				}
+				radixsort_scatter(sort, input_bytes, num, data_shift, width);
+				radixsort_swap(sort);
 			}
 		}
 		else {
 			unsigned char unique_val = *input_bytes;
 
-			if (count[ unique_val ] != num) {
+			if (radixsort_get(sort->histogram, count + unique_val, width) != num) {
 				//Both positive and negative values
-				radixsort_index_t next = 0, prev;
-				radixsort_index_t* offset = sort->offset;
-				radixsort_index_t* count_base = count;
-
 				//First positive data comes after the negative data
-				*offset++ = negatives;
-				prev = negatives;
-				for (ival = 1; ival < 128; ++ival, ++offset, ++count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
+				size_t next = negatives;
+				radixsort_set(sort->offset, 0, next, width);
+				for (ival = 1; ival < 128; ++ival) {
+					next += radixsort_get(sort->histogram, count + ival - 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 
 				//Reverse order for negative values
-				offset = sort->offset + 255;
-				count = count_base + 255;
-				*offset-- = 0;
-				prev = 0;
-				for (ival = 0; ival < 127; ++ival, --offset, --count) {
-					next = prev + *count;
-					prev = next;
-					*offset = next;
+				next = 0;
+				radixsort_set(sort->offset, 255, 0, width);
+				for (ival = 254; ival >= 128; --ival) {
+					next += radixsort_get(sort->histogram, count + ival + 1, width);
+					radixsort_set(sort->offset, ival, next, width);
 				}
 
 				//Fix position for negative values
-				offset = sort->offset + 128;
-				count = count_base + 128;
-				for (ival = 128; ival < 256; ++ival, ++offset, ++count)
-					*offset += *count;
+				for (ival = 128; ival < 256; ++ival)
+					radixsort_set(sort->offset, ival, radixsort_get(sort->offset, ival, width) +
+					              radixsort_get(sort->histogram, count + ival, width), width);
 
 				// Perform Radix Sort
-				if (data_type == RADIXSORT_FLOAT32) {
-					const uint32_t* input_uint = input;
-					for (ival = 0; ival < num; ++ival) {
-						unsigned int radix = input_uint[ sort->indices[0][ival] ] >> 24;
-						if (radix < 128)
-							sort->indices[1][ sort->offset[radix]++ ] = sort->indices[0][ival]; //Positive
-						else
-							sort->indices[1][ --sort->offset[radix] ] = sort->indices[0][ival]; //Negative, reverse order
+				for (iidx = 0; iidx < num; ++iidx) {
+					size_t id = radixsort_get(sort->indices[0], iidx, width);
+					size_t radix, pos;
+					if (data_type == RADIXSORT_FLOAT32)
+						radix = ((const uint32_t*)input)[id] >> 24;
+					else
+						radix = (size_t)(((const uint64_t*)input)[id] >> 56ULL);
+					pos = radixsort_get(sort->offset, radix, width);
+					if (radix < 128) {
+						//Positive
+						radixsort_set(sort->offset, radix, pos + 1, width);
 					}
-				}
-				else { //if( data_type == RADIXSORT_FLOAT64 )
-					const uint64_t* input_uint = input;
-					for (ival = 0; ival < num; ++ival) {
-						unsigned int radix = (unsigned int)(input_uint[ sort->indices[0][ival] ] >> 56ULL);
-						if (radix < 128)
-							sort->indices[1][ sort->offset[radix]++ ] = sort->indices[0][ival]; //Positive
-						else
-							sort->indices[1][ --sort->offset[radix] ] = sort->indices[0][ival]; //Negative, reverse order
+					else {
+						//Negative, reverse order
+						radixsort_set(sort->offset, radix, --pos, width);
 					}
+					radixsort_set(sort->indices[1], pos, id, width);
 				}
 
-				//After this swap, the valid indices (most recent) are in sort->indices[0]
-				{
-					radixsort_index_t* swap = sort->indices[0];
-					sort->indices[0] = sort->indices[1];
-					sort->indices[1] = swap;
-				}
+				radixsort_swap(sort);
 			}
 			else {
 				//Reverse order if all values are negative
 				if (unique_val >= 128) {
-					for (ival = 0; ival < num; ++ival)
-						sort->indices[1][ival] = sort->indices[0][ num - (ival + 1) ];
-
-					//After this swap, the valid indices (most recent) are in sort->indices[0]
-					{
-						radixsort_index_t* swap = sort->indices[0];
-						sort->indices[0] = sort->indices[1];
-						sort->indices[1] = swap;
-					}
+					for (iidx = 0; iidx < num; ++iidx)
+						radixsort_set(sort->indices[1], iidx,
+						              radixsort_get(sort->indices[0], num - (iidx + 1), width), width);
+					radixsort_swap(sort);
 				}
 			}
 		}
 	}
+}
 
-	return sort->indices[0];
+static FOUNDATION_FORCEINLINE void
+radixsort_state_sort(radixsort_state_t* state, const void* input, size_t num, const size_t width) {
+	if ((state->type == RADIXSORT_FLOAT32) || (state->type == RADIXSORT_FLOAT64))
+		radixsort_float(state, input, num, width);
+	else
+		radixsort_int(state, input, num, width);
 }
 
-const radixsort_index_t*
-radixsort_sort(radixsort_t* sort, const void* input, radixsort_index_t num) {
+//Minimum number of elements per block in parallel sorts, smaller inputs are sorted by the
+//calling thread since task overhead would dominate
+#define RADIXSORT_PARALLEL_BLOCK_MIN (32 * 1024)
+
+//Shared state for the tasks of one pass of a parallel sort. Each block is a contiguous range
+//of the current index buffer with its own histogram, converted in place to the block offsets
+//for the stable scatter
+typedef struct {
+	radixsort_state_t* sort;
+	const unsigned char* input_bytes;
+	unsigned int data_shift;
+	size_t num;
+	size_t block_size;
+	size_t* counts;
+	size_t width;
+	//Negative float buckets are filled backwards from the end of the bucket
+	bool reverse_negative;
+} radixsort_parallel_t;
+
+static FOUNDATION_FORCEINLINE void
+radixsort_block_count(radixsort_parallel_t* parallel, size_t block, const size_t width) {
+	const void* indices = parallel->sort->indices[0];
+	const unsigned char* input_bytes = parallel->input_bytes;
+	const unsigned int data_shift = parallel->data_shift;
+	size_t* count = parallel->counts + (block * 256);
+	size_t ival = block * parallel->block_size;
+	size_t end = ival + parallel->block_size;
+	if (end > parallel->num)
+		end = parallel->num;
+
+	memset(count, 0, sizeof(size_t) * 256);
+	for (; ival < end; ++ival)
+		++count[ input_bytes[ radixsort_get(indices, ival, width) << data_shift ] ];
+}
+
+static FOUNDATION_FORCEINLINE void
+radixsort_block_scatter(radixsort_parallel_t* parallel, size_t block, const size_t width) {
+	const void* indices = parallel->sort->indices[0];
+	void* indices_next = parallel->sort->indices[1];
+	const unsigned char* input_bytes = parallel->input_bytes;
+	const unsigned int data_shift = parallel->data_shift;
+	size_t* offset = parallel->counts + (block * 256);
+	size_t ival = block * parallel->block_size;
+	size_t end = ival + parallel->block_size;
+	if (end > parallel->num)
+		end = parallel->num;
+
+	if (!parallel->reverse_negative) {
+		for (; ival < end; ++ival) {
+			size_t id = radixsort_get(indices, ival, width);
+			radixsort_set(indices_next, offset[ input_bytes[ id << data_shift ] ]++, id, width);
+		}
+	}
+	else {
+		for (; ival < end; ++ival) {
+			size_t id = radixsort_get(indices, ival, width);
+			size_t radix = input_bytes[ id << data_shift ];
+			if (radix < 128)
+				radixsort_set(indices_next, offset[radix]++, id, width); //Positive
+			else
+				radixsort_set(indices_next, --offset[radix], id, width); //Negative, reverse order
+		}
+	}
+}
+
+static FOUNDATION_FORCEINLINE void
+radixsort_block_identity(radixsort_parallel_t* parallel, size_t block, const size_t width) {
+	size_t ival = block * parallel->block_size;
+	size_t end = ival + parallel->block_size;
+	if (end > parallel->num)
+		end = parallel->num;
+	for (; ival < end; ++ival) {
+		radixsort_set(parallel->sort->indices[0], ival, ival, width);
+		radixsort_set(parallel->sort->indices[1], ival, ival, width);
+	}
+}
+
+static FOUNDATION_FORCEINLINE void
+radixsort_block_reverse(radixsort_parallel_t* parallel, size_t block, const size_t width) {
+	const void* indices = parallel->sort->indices[0];
+	void* indices_next = parallel->sort->indices[1];
+	size_t num = parallel->num;
+	size_t ival = block * parallel->block_size;
+	size_t end = ival + parallel->block_size;
+	if (end > num)
+		end = num;
+	for (; ival < end; ++ival)
+		radixsort_set(indices_next, ival, radixsort_get(indices, num - (ival + 1), width), width);
+}
+
+//Task range functions dispatching to implementations specialized for the index width
+#define RADIXSORT_PARALLEL_TASK(name) \
+	static void \
+	radixsort_parallel_##name(size_t begin, size_t end, void* arg) { \
+		radixsort_parallel_t* parallel = arg; \
+		for (; begin < end; ++begin) { \
+			if (parallel->width == 4) \
+				radixsort_block_##name(parallel, begin, 4); \
+			else \
+				radixsort_block_##name(parallel, begin, 8); \
+		} \
+	}
+
+RADIXSORT_PARALLEL_TASK(count)
+RADIXSORT_PARALLEL_TASK(scatter)
+RADIXSORT_PARALLEL_TASK(identity)
+RADIXSORT_PARALLEL_TASK(reverse)
+
+#undef RADIXSORT_PARALLEL_TASK
+
+//Turn the block histograms of a pass into block offsets, returns false if all values share
+//the same radix and the pass can be skipped. The bucket layout matches the sequential sort
+static bool
+radixsort_parallel_offsets(radixsort_parallel_t* parallel, size_t blocks, bool last_pass,
+                           unsigned char* unique_val) {
+	const radixsort_data_t data_type = parallel->sort->type;
+	const bool data_float = (data_type == RADIXSORT_FLOAT32) || (data_type == RADIXSORT_FLOAT64);
+	const bool data_signed = _radixsort_data_signed[ data_type ];
+	size_t total[256];
+	size_t start[256];
+	size_t negatives = 0;
+	size_t next;
+	size_t iblock;
+	unsigned int ival;
+
+	memset(total, 0, sizeof(total));
+	for (iblock = 0; iblock < blocks; ++iblock) {
+		const size_t* count = parallel->counts + (iblock * 256);
+		for (ival = 0; ival < 256; ++ival)
+			total[ival] += count[ival];
+	}
+	for (ival = 0; ival < 256; ++ival) {
+		if (total[ival] == parallel->num) {
+			*unique_val = (unsigned char)ival;
+			return false;
+		}
+	}
+
+	parallel->reverse_negative = false;
+	if (!last_pass || !data_signed) {
+		//Unsigned data or only positive values
+		for (ival = 0, next = 0; ival < 256; ++ival) {
+			start[ival] = next;
+			next += total[ival];
+		}
+	}
+	else {
+		//First positive data comes after the negative data
+		for (ival = 128; ival < 256; ++ival)
+			negatives += total[ival];
+		for (ival = 0, next = negatives; ival < 128; ++ival) {
+			start[ival] = next;
+			next += total[ival];
+		}
+		if (!data_float) {
+			for (ival = 128, next = 0; ival < 256; ++ival) {
+				start[ival] = next;
+				next += total[ival];
+			}
+		}
+		else {
+			//Reverse bucket order for negative values, offsets point to end of bucket
+			for (ival = 255, next = 0; ival >= 128; --ival) {
+				next += total[ival];
+				start[ival] = next;
+			}
+			parallel->reverse_negative = true;
+		}
+	}
+
+	//Blocks in order get consecutive ranges in each bucket to keep the sort stable
+	for (iblock = 0; iblock < blocks; ++iblock) {
+		size_t* count = parallel->counts + (iblock * 256);
+		for (ival = 0; ival < 256; ++ival) {
+			size_t block_count = count[ival];
+			if (parallel->reverse_negative && (ival >= 128)) {
+				count[ival] = start[ival];
+				start[ival] -= block_count;
+			}
+			else {
+				count[ival] = start[ival];
+				start[ival] += block_count;
+			}
+		}
+	}
+
+	return true;
+}
+
+static void
+radixsort_state_sort_parallel(radixsort_state_t* sort, const void* input, size_t num,
+                              task_scheduler_t* scheduler, const size_t width) {
 	const radixsort_data_t data_type = sort->type;
-	const radixsort_index_t* result = 0;
+	const unsigned int data_size = _radixsort_data_size[ data_type ];
+	const bool data_float = (data_type == RADIXSORT_FLOAT32) || (data_type == RADIXSORT_FLOAT64);
+	radixsort_parallel_t parallel;
+	size_t blocks;
+	unsigned int ipass;
+
+	blocks = task_scheduler_worker_count(scheduler) + 1;
+	if (blocks > (num / RADIXSORT_PARALLEL_BLOCK_MIN))
+		blocks = num / RADIXSORT_PARALLEL_BLOCK_MIN;
+	if (blocks < 2) {
+		if (width == 4)
+			radixsort_state_sort(sort, input, num, 4);
+		else
+			radixsort_state_sort(sort, input, num, 8);
+		return;
+	}
 
-	FOUNDATION_ASSERT(num <= sort->size);
+	//Temporal coherence check is sequential but bails out early on unsorted data
+	if (((width == 4) && (radixsort_count_sorted(sort, input, num, 0, 4) == num)) ||
+	        ((width == 8) && (radixsort_count_sorted(sort, input, num, 0, 8) == num)))
+		return;
 
-	if ((data_type == RADIXSORT_FLOAT32) || (data_type == RADIXSORT_FLOAT64))
-		result = radixsort_float(sort, input, num);
-	else
-		result = radixsort_int(sort, input, num);
+	memset(&parallel, 0, sizeof(parallel));
+	parallel.sort = sort;
+	parallel.num = num;
+	parallel.block_size = (num + blocks - 1) / blocks;
+	parallel.data_shift = _radixsort_data_shift[ data_type ];
+	parallel.width = width;
+	parallel.counts = memory_allocate(0, sizeof(size_t) * 256 * blocks, 0, MEMORY_TEMPORARY);
 
-	sort->lastused = num;
+	if (num != sort->lastused)
+		task_parallel_for(scheduler, 0, blocks, 1, radixsort_parallel_identity, &parallel);
 
-	return result;
+	//LSB first, see radixsort_int
+	for (ipass = 0; ipass < data_size; ++ipass) {
+		bool last_pass = (ipass == (data_size - 1));
+		unsigned char unique_val = 0;
+		unsigned int byteofs = RADIXSORT_BYTE(ipass, data_size);
+		parallel.input_bytes = pointer_offset_const(input, byteofs);
+
+		task_parallel_for(scheduler, 0, blocks, 1, radixsort_parallel_count, &parallel);
+		if (radixsort_parallel_offsets(&parallel, blocks, last_pass, &unique_val)) {
+			task_parallel_for(scheduler, 0, blocks, 1, radixsort_parallel_scatter, &parallel);
+			radixsort_swap(sort);
+		}
+		else if (last_pass && data_float && (unique_val >= 128)) {
+			//Reverse order if all values are negative
+			task_parallel_for(scheduler, 0, blocks, 1, radixsort_parallel_reverse, &parallel);
+			radixsort_swap(sort);
+		}
+	}
+
+	memory_deallocate(parallel.counts);
 }
 
-radixsort_t*
-radixsort_allocate(radixsort_data_t type, radixsort_index_t num) {
-	radixsort_t* sort;
-	sort = memory_allocate(0,
-	                       sizeof(radixsort_t) +
-	                       /* 2 index tables */ (2 * sizeof(radixsort_index_t) * num) +
-	                       /* histograms */ (256 * _radixsort_data_size[ type ] * sizeof(radixsort_index_t)) +
-	                       /* offset table */ (256 * sizeof(radixsort_index_t)),
-	                       0, MEMORY_PERSISTENT);
-	sort->indices[0] = pointer_offset(sort, sizeof(radixsort_t));
-	sort->indices[1] = pointer_offset(sort->indices[0], sizeof(radixsort_index_t) * num);
-	sort->histogram  = pointer_offset(sort->indices[1], sizeof(radixsort_index_t) * num);
-	sort->offset     = pointer_offset(sort->histogram,
-	                                  sizeof(radixsort_index_t) * 256 * _radixsort_data_size[type]);
+//Scatter records to the destination buffer in order of the given key byte. Specialized for
+//common record sizes to let the compiler inline the copies
+static FOUNDATION_FORCEINLINE void
+radixsort_records_scatter(const unsigned char* source, unsigned char* dest, size_t num,
+                          const unsigned char* key_bytes, size_t* offset, bool reverse_negative,
+                          const size_t record_size) {
+	size_t ival;
+	for (ival = 0; ival < num; ++ival) {
+		size_t radix = key_bytes[ ival * record_size ];
+		size_t pos;
+		if (!reverse_negative || (radix < 128))
+			pos = offset[radix]++;
+		else
+			pos = --offset[radix]; //Negative float, reverse order
+		memcpy(dest + (pos * record_size), source + (ival * record_size), record_size);
+	}
+}
+
+static size_t
+radixsort_memory_size(radixsort_data_t type, size_t num, size_t width) {
+	return /* 2 index tables */ (2 * width * num) +
+	       /* histograms */ (256 * _radixsort_data_size[ type ] * width) +
+	       /* offset table */ (256 * width);
+}
 
-	radixsort_initialize(sort, type, num);
+//Set up the buffers stored after the sort object in a single memory block, then initialize
+#define RADIXSORT_ALLOCATE(sort_type, index_type, initialize) do { \
+		sort_type* sort = memory_allocate(0, sizeof(sort_type) + \
+		                                  radixsort_memory_size(type, (size_t)num, sizeof(index_type)), \
+		                                  0, MEMORY_PERSISTENT); \
+		sort->indices[0] = pointer_offset(sort, sizeof(sort_type)); \
+		sort->indices[1] = sort->indices[0] + num; \
+		sort->histogram  = sort->indices[1] + num; \
+		sort->offset     = sort->histogram + (256 * _radixsort_data_size[type]); \
+		initialize(sort, type, num); \
+		return sort; \
+	} while (0)
+
+//Sort through the width independent state, then store back the swapped index buffers
+#define RADIXSORT_SORT(index_type) do { \
+		radixsort_state_t state; \
+		FOUNDATION_ASSERT(num <= sort->size); \
+		state.type = sort->type; \
+		state.lastused = sort->lastused; \
+		state.indices[0] = sort->indices[0]; \
+		state.indices[1] = sort->indices[1]; \
+		state.histogram = sort->histogram; \
+		state.offset = sort->offset; \
+		radixsort_state_sort(&state, input, (size_t)num, sizeof(index_type)); \
+		sort->indices[0] = state.indices[0]; \
+		sort->indices[1] = state.indices[1]; \
+		sort->lastused = num; \
+		return sort->indices[0]; \
+	} while (0)
+
+//Parallel sort through the width independent state, see RADIXSORT_SORT
+#define RADIXSORT_SORT_PARALLEL(index_type) do { \
+		radixsort_state_t state; \
+		FOUNDATION_ASSERT(num <= sort->size); \
+		state.type = sort->type; \
+		state.lastused = sort->lastused; \
+		state.indices[0] = sort->indices[0]; \
+		state.indices[1] = sort->indices[1]; \
+		state.histogram = sort->histogram; \
+		state.offset = sort->offset; \
+		radixsort_state_sort_parallel(&state, input, (size_t)num, scheduler, sizeof(index_type)); \
+		sort->indices[0] = state.indices[0]; \
+		sort->indices[1] = state.indices[1]; \
+		sort->lastused = num; \
+		return sort->indices[0]; \
+	} while (0)
+
+#define RADIXSORT_INITIALIZE(index_type) do { \
+		index_type i; \
+		sort->type       = type; \
+		sort->size       = num; \
+		sort->lastused   = num; \
+		for (i = 0; i < num; ++i) { \
+			sort->indices[0][i] = i; \
+			sort->indices[1][i] = i; \
+		} \
+	} while (0)
 
-	return sort;
+const radixsort_index_t*
+radixsort_sort(radixsort_t* sort, const void* input, radixsort_index_t num) {
+	RADIXSORT_SORT(radixsort_index_t);
+}
+
+radixsort_t*
+radixsort_allocate(radixsort_data_t type, radixsort_index_t num) {
+	RADIXSORT_ALLOCATE(radixsort_t, radixsort_index_t, radixsort_initialize);
 }
 
 void
 radixsort_initialize(radixsort_t* sort, radixsort_data_t type, radixsort_index_t num) {
-	radixsort_index_t i;
-
-	sort->type       = type;
-	sort->size       = num;
-	sort->lastused   = num;
-
-	for (i = 0; i < num; ++i) {
-		sort->indices[0][i] = i;
-		sort->indices[1][i] = i;
-	}
+	RADIXSORT_INITIALIZE(radixsort_index_t);
 }
 
 void
@@ -619,3 +778,315 @@ void
 radixsort_finalize(radixsort_t* sort) {
 	FOUNDATION_UNUSED(sort);
 }
+
+const radixsort32_index_t*
+radixsort32_sort(radixsort32_t* sort, const void* input, radixsort32_index_t num) {
+	RADIXSORT_SORT(radixsort32_index_t);
+}
+
+const radixsort32_index_t*
+radixsort32_sort_parallel(radixsort32_t* sort, const void* input, radixsort32_index_t num,
+                         task_scheduler_t* scheduler) {
+	RADIXSORT_SORT_PARALLEL(radixsort32_index_t);
+}
+
+radixsort32_t*
+radixsort32_allocate(radixsort_data_t type, radixsort32_index_t num) {
+	RADIXSORT_ALLOCATE(radixsort32_t, radixsort32_index_t, radixsort32_initialize);
+}
+
+void
+radixsort32_initialize(radixsort32_t* sort, radixsort_data_t type, radixsort32_index_t num) {
+	RADIXSORT_INITIALIZE(radixsort32_index_t);
+}
+
+void
+radixsort32_deallocate(radixsort32_t* sort) {
+	radixsort32_finalize(sort);
+	memory_deallocate(sort);
+}
+
+void
+radixsort32_finalize(radixsort32_t* sort) {
+	FOUNDATION_UNUSED(sort);
+}
+
+const radixsort64_index_t*
+radixsort64_sort(radixsort64_t* sort, const void* input, radixsort64_index_t num) {
+	RADIXSORT_SORT(radixsort64_index_t);
+}
+
+const radixsort64_index_t*
+radixsort64_sort_parallel(radixsort64_t* sort, const void* input, radixsort64_index_t num,
+                         task_scheduler_t* scheduler) {
+	RADIXSORT_SORT_PARALLEL(radixsort64_index_t);
+}
+
+radixsort64_t*
+radixsort64_allocate(radixsort_data_t type, radixsort64_index_t num) {
+	RADIXSORT_ALLOCATE(radixsort64_t, radixsort64_index_t, radixsort64_initialize);
+}
+
+void
+radixsort64_initialize(radixsort64_t* sort, radixsort_data_t type, radixsort64_index_t num) {
+	RADIXSORT_INITIALIZE(radixsort64_index_t);
+}
+
+void
+radixsort64_deallocate(radixsort64_t* sort) {
+	radixsort64_finalize(sort);
+	memory_deallocate(sort);
+}
+
+void
+radixsort64_finalize(radixsort64_t* sort) {
+	FOUNDATION_UNUSED(sort);
+}
+
+void
+radixsort_sort_records(radixsort_data_t type, void* records, size_t num, size_t record_size,
+                       size_t key_offset, void* buffer) {
+	const unsigned int data_size = _radixsort_data_size[ type ];
+	const bool data_signed = _radixsort_data_signed[ type ];
+	const bool data_float = (type == RADIXSORT_FLOAT32) || (type == RADIXSORT_FLOAT64);
+	size_t* histogram;
+	size_t offset[256];
+	unsigned char* source = records;
+	unsigned char* dest = buffer;
+	unsigned char* swap;
+	const unsigned char* key;
+	unsigned int ipass, ival;
+	size_t irec;
+
+	FOUNDATION_ASSERT(key_offset + data_size <= record_size);
+	if (num < 2)
+		return;
+
+	//One block holding histograms and the temporary record buffer if not given
+	histogram = memory_allocate(0, (sizeof(size_t) * 256 * data_size) +
+	                            (buffer ? 0 : (num * record_size)), 0, MEMORY_TEMPORARY);
+	if (!dest)
+		dest = pointer_offset(histogram, sizeof(size_t) * 256 * data_size);
+
+	//Histograms for all passes in a single read of the keys
+	memset(histogram, 0, sizeof(size_t) * 256 * data_size);
+	key = source + key_offset;
+	for (irec = 0; irec < num; ++irec, key += record_size) {
+		for (ival = 0; ival < data_size; ++ival) {
+			++histogram[ RADIXSORT_HISTOGRAM(ival, data_size) + key[ival] ];
+		}
+	}
+
+	//LSB first, see radixsort_int and radixsort_float
+	for (ipass = 0; ipass < data_size; ++ipass) {
+		const size_t* count = histogram + (ipass << 8);
+		const bool last_pass = (ipass == (data_size - 1));
+		bool reverse_negative = false;
+		unsigned int byteofs = RADIXSORT_BYTE(ipass, data_size);
+		const unsigned char* key_bytes = source + key_offset + byteofs;
+		unsigned char unique_val = *key_bytes;
+		size_t next;
+
+		//Skip passes where all keys share the same digit
+		if (count[unique_val] == num) {
+			if (last_pass && data_float && (unique_val >= 128)) {
+				//Reverse order if all values are negative
+				for (irec = 0; irec < num; ++irec)
+					memcpy(dest + (irec * record_size), source + ((num - (irec + 1)) * record_size),
+					       record_size);
+				swap = source;
+				source = dest;
+				dest = swap;
+			}
+			continue;
+		}
+
+		if (!last_pass || !data_signed) {
+			for (ival = 0, next = 0; ival < 256; ++ival) {
+				offset[ival] = next;
+				next += count[ival];
+			}
+		}
+		else {
+			//First positive data comes after the negative data
+			size_t negatives = 0;
+			for (ival = 128; ival < 256; ++ival)
+				negatives += count[ival];
+			for (ival = 0, next = negatives; ival < 128; ++ival) {
+				offset[ival] = next;
+				next += count[ival];
+			}
+			if (!data_float) {
+				for (ival = 128, next = 0; ival < 256; ++ival) {
+					offset[ival] = next;
+					next += count[ival];
+				}
+			}
+			else {
+				//Reverse bucket order for negative values, offsets point to end of bucket
+				for (ival = 255, next = 0; ival >= 128; --ival) {
+					next += count[ival];
+					offset[ival] = next;
+				}
+				reverse_negative = true;
+			}
+		}
+
+		switch (record_size) {
+		case 4:
+			radixsort_records_scatter(source, dest, num, key_bytes, offset, reverse_negative, 4);
+			break;
+		case 8:
+			radixsort_records_scatter(source, dest, num, key_bytes, offset, reverse_negative, 8);
+			break;
+		case 16:
+			radixsort_records_scatter(source, dest, num, key_bytes, offset, reverse_negative, 16);
+			break;
+		default:
+			radixsort_records_scatter(source, dest, num, key_bytes, offset, reverse_negative,
+			                          record_size);
+			break;
+		}
+
+		swap = source;
+		source = dest;
+		dest = swap;
+	}
+
+	//Sorted records end up in the temporary buffer after an odd number of passes
+	if (source != records)
+		memcpy(records, source, num * record_size);
+
+	memory_deallocate(histogram);
+}
+
+//Ranges shorter than this are finished with insertion sort in string sorts
+#define RADIXSORT_STRING_CUTOFF 32
+
+typedef struct {
+	size_t begin;
+	size_t end;
+	size_t depth;
+} radixsort_string_range_t;
+
+//Digit of a string at the given depth, zero if the string ends before the depth
+static FOUNDATION_FORCEINLINE unsigned int
+radixsort_string_digit(const string_const_t* string, size_t depth) {
+	return (depth < string->length) ? (unsigned int)(unsigned char)string->str[depth] + 1 : 0;
+}
+
+//Compare strings known to be equal up to the given depth
+static FOUNDATION_FORCEINLINE bool
+radixsort_string_less(const string_const_t* lhs, const string_const_t* rhs, size_t depth) {
+	size_t length = (lhs->length < rhs->length) ? lhs->length : rhs->length;
+	int result = (length > depth) ? memcmp(lhs->str + depth, rhs->str + depth, length - depth) : 0;
+	return (result < 0) || (!result && (lhs->length < rhs->length));
+}
+
+//Length of the common prefix of a range of strings known to share the first depth bytes
+static size_t
+radixsort_string_prefix(const string_const_t* strings, size_t begin, size_t end, size_t depth) {
+	const string_const_t* first = strings + begin;
+	size_t prefix = first->length;
+	size_t ival;
+	for (ival = begin + 1; (ival < end) && (prefix > depth); ++ival) {
+		const string_const_t* string = strings + ival;
+		size_t length = (string->length < prefix) ? string->length : prefix;
+		size_t ichar = depth;
+		while ((ichar < length) && (string->str[ichar] == first->str[ichar]))
+			++ichar;
+		prefix = ichar;
+	}
+	return (prefix > depth) ? prefix : depth;
+}
+
+static void
+radixsort_string_insertion(string_const_t* strings, size_t begin, size_t end, size_t depth) {
+	size_t ival, jval;
+	for (ival = begin + 1; ival < end; ++ival) {
+		string_const_t value = strings[ival];
+		for (jval = ival; (jval > begin) && radixsort_string_less(&value, strings + jval - 1, depth);
+		        --jval)
+			strings[jval] = strings[jval - 1];
+		strings[jval] = value;
+	}
+}
+
+void
+radixsort_sort_strings(string_const_t* strings, size_t num) {
+	radixsort_string_range_t* stack = 0;
+	radixsort_string_range_t range;
+	size_t count[257];
+	size_t next[257];
+	size_t end[257];
+	unsigned int ibucket, digit;
+	size_t ival;
+
+	range.begin = 0;
+	range.end = num;
+	range.depth = 0;
+	array_push(stack, range);
+
+	//American flag sort, partitioning ranges in place by the byte at the range depth. Pending
+	//ranges are kept on an explicit stack since depth is bounded only by string length
+	while (array_size(stack)) {
+		range = stack[ array_size(stack) - 1 ];
+		array_pop(stack);
+
+		if ((range.end - range.begin) < RADIXSORT_STRING_CUTOFF) {
+			radixsort_string_insertion(strings, range.begin, range.end, range.depth);
+			continue;
+		}
+
+		memset(count, 0, sizeof(count));
+		for (ival = range.begin; ival < range.end; ++ival)
+			++count[ radixsort_string_digit(strings + ival, range.depth) ];
+
+		//Skip the partition if all strings share the digit, and skip the entire common prefix
+		//in one scan as it is typically longer than one byte (path prefixes)
+		digit = radixsort_string_digit(strings + range.begin, range.depth);
+		if (count[digit] == (range.end - range.begin)) {
+			if (digit) {
+				range.depth = radixsort_string_prefix(strings, range.begin, range.end,
+				                                      range.depth + 1);
+				array_push(stack, range);
+			}
+			continue;
+		}
+
+		next[0] = range.begin;
+		end[0] = range.begin + count[0];
+		for (ibucket = 1; ibucket < 257; ++ibucket) {
+			next[ibucket] = end[ibucket - 1];
+			end[ibucket] = next[ibucket] + count[ibucket];
+		}
+
+		//Permute in place, cycling each misplaced string to the next free slot of its bucket
+		for (ibucket = 0; ibucket < 257; ++ibucket) {
+			while (next[ibucket] < end[ibucket]) {
+				string_const_t value = strings[ next[ibucket] ];
+				digit = radixsort_string_digit(&value, range.depth);
+				while (digit != ibucket) {
+					string_const_t swap = strings[ next[digit] ];
+					strings[ next[digit]++ ] = value;
+					value = swap;
+					digit = radixsort_string_digit(&value, range.depth);
+				}
+				strings[ next[ibucket]++ ] = value;
+			}
+		}
+
+		//Strings ending at this depth are equal and done, recurse into the other buckets
+		for (ibucket = 1; ibucket < 257; ++ibucket) {
+			if (count[ibucket] > 1) {
+				radixsort_string_range_t bucket;
+				bucket.begin = end[ibucket] - count[ibucket];
+				bucket.end = end[ibucket];
+				bucket.depth = range.depth + 1;
+				array_push(stack, bucket);
+			}
+		}
+	}
+
+	array_deallocate(stack);
+}
@@ -15,7 +15,15 @@
 /*! \file radixsort.h
 \brief Radix sorter
 
-Radix sorter for 32/64-bit integer and floating point values. */
+Radix sorter for 32/64-bit integer and floating point values and 128-bit unsigned integers such
+as uuid_t and digests. Sort objects produce an index permutation of the input array, while
+#radixsort_sort_records moves records with their keys. Strings are sorted in place with a most
+significant digit first radix sort, see #radixsort_sort_strings.
+
+The #radixsort_t sorter uses 16-bit indices and can sort at most 2^16-1 elements, keeping
+memory use and cache footprint small. The #radixsort32_t and #radixsort64_t sorters have the
+same API with 32-bit and 64-bit indices for sorting larger arrays, and can also sort large
+arrays in parallel on a task scheduler. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -58,3 +66,132 @@ partially sorted and/or used in a previous sort call on this radix sort object.
 FOUNDATION_API const radixsort_index_t*
 radixsort_sort(radixsort_t* sort, const void* input, radixsort_index_t num);
 
+/*! Sort an array of fixed size records by a key stored in each record, moving the records
+instead of returning an index permutation. This avoids gathering payloads through a sorted
+index array in a separate pass. The sort is stable, and passes where all keys share the same
+digit are skipped, making narrow range keys cheaper to sort. Records are sorted in place.
+\param type Data type of key
+\param records Record array
+\param num Number of records
+\param record_size Size of a record in bytes
+\param key_offset Offset of key in record in bytes, key must fit within the record
+\param buffer Temporary buffer of num * record_size bytes, null to allocate internally */
+FOUNDATION_API void
+radixsort_sort_records(radixsort_data_t type, void* records, size_t num, size_t record_size,
+                       size_t key_offset, void* buffer);
+
+/*! Sort an array of strings in place in lexicographical byte order, with a string sorting
+before any longer string it is a prefix of. Uses an in place most significant digit first radix
+sort (American flag sort), skipping common prefixes and finishing small ranges with insertion
+sort. The sort is not stable. Only the string_const_t array is modified, string data is not
+moved.
+\param strings String array
+\param num Number of strings */
+FOUNDATION_API void
+radixsort_sort_strings(string_const_t* strings, size_t num);
+
+/*! Allocate a radix sort object with 32-bit indices. All data is stored in a single continuous
+memory block, including sort buckets and resulting index arrays. Deallocate the sort object with a call to
+#radixsort32_deallocate.
+\param type Data type
+\param num Number of elements to sort
+\return New radix sort object */
+FOUNDATION_API radixsort32_t*
+radixsort32_allocate(radixsort_data_t type, radixsort32_index_t num);
+
+/*! Deallocate a radix sort object previously allocated with a call to #radixsort32_allocate.
+\param sort Radix sort object to deallocate */
+FOUNDATION_API void
+radixsort32_deallocate(radixsort32_t* sort);
+
+/*! Initialize a radix sort object. All data pointers should be set by the caller. Finalize
+the sort object with a call to #radixsort32_finalize.
+\param sort Radix sort object
+\param type Data type
+\param num Number of elements to sort */
+FOUNDATION_API void
+radixsort32_initialize(radixsort32_t* sort, radixsort_data_t type, radixsort32_index_t num);
+
+/*! Finalize a radix sort object previously initialized with a call to #radixsort32_initialize.
+\param sort Radix sort object to finalize */
+FOUNDATION_API void
+radixsort32_finalize(radixsort32_t* sort);
+
+/*! Perform radix sort. This will take advantage of temporal coherence if the input is
+partially sorted and/or used in a previous sort call on this radix sort object.
+\param sort Radix sort object
+\param input Input data buffer of same type as radix sort object was
+             initialized with
+\param num Number of elements to sort, must be less or equal to maximum
+           number radix sort object was initialized with
+\return Sorted index array holding num indices into the input array */
+FOUNDATION_API const radixsort32_index_t*
+radixsort32_sort(radixsort32_t* sort, const void* input, radixsort32_index_t num);
+
+/*! Perform radix sort in parallel on the worker threads of the given task scheduler, with the
+calling thread participating. The index range is split in blocks counting and scattering
+their part of each pass independently, giving the same result as #radixsort32_sort. Inputs
+too small to benefit from threading are sorted by the calling thread.
+\param sort Radix sort object
+\param input Input data buffer of same type as radix sort object was
+             initialized with
+\param num Number of elements to sort, must be less or equal to maximum
+           number radix sort object was initialized with
+\param scheduler Task scheduler
+\return Sorted index array holding num indices into the input array */
+FOUNDATION_API const radixsort32_index_t*
+radixsort32_sort_parallel(radixsort32_t* sort, const void* input, radixsort32_index_t num,
+                         task_scheduler_t* scheduler);
+
+/*! Allocate a radix sort object with 64-bit indices. All data is stored in a single continuous
+memory block, including sort buckets and resulting index arrays. Deallocate the sort object with a call to
+#radixsort64_deallocate.
+\param type Data type
+\param num Number of elements to sort
+\return New radix sort object */
+FOUNDATION_API radixsort64_t*
+radixsort64_allocate(radixsort_data_t type, radixsort64_index_t num);
+
+/*! Deallocate a radix sort object previously allocated with a call to #radixsort64_allocate.
+\param sort Radix sort object to deallocate */
+FOUNDATION_API void
+radixsort64_deallocate(radixsort64_t* sort);
+
+/*! Initialize a radix sort object. All data pointers should be set by the caller. Finalize
+the sort object with a call to #radixsort64_finalize.
+\param sort Radix sort object
+\param type Data type
+\param num Number of elements to sort */
+FOUNDATION_API void
+radixsort64_initialize(radixsort64_t* sort, radixsort_data_t type, radixsort64_index_t num);
+
+/*! Finalize a radix sort object previously initialized with a call to #radixsort64_initialize.
+\param sort Radix sort object to finalize */
+FOUNDATION_API void
+radixsort64_finalize(radixsort64_t* sort);
+
+/*! Perform radix sort. This will take advantage of temporal coherence if the input is
+partially sorted and/or used in a previous sort call on this radix sort object.
+\param sort Radix sort object
+\param input Input data buffer of same type as radix sort object was
+             initialized with
+\param num Number of elements to sort, must be less or equal to maximum
+           number radix sort object was initialized with
+\return Sorted index array holding num indices into the input array */
+FOUNDATION_API const radixsort64_index_t*
+radixsort64_sort(radixsort64_t* sort, const void* input, radixsort64_index_t num);
+
+/*! Perform radix sort in parallel on the worker threads of the given task scheduler, with the
+calling thread participating. The index range is split in blocks counting and scattering
+their part of each pass independently, giving the same result as #radixsort64_sort. Inputs
+too small to benefit from threading are sorted by the calling thread.
+\param sort Radix sort object
+\param input Input data buffer of same type as radix sort object was
+             initialized with
+\param num Number of elements to sort, must be less or equal to maximum
+           number radix sort object was initialized with
+\param scheduler Task scheduler
+\return Sorted index array holding num indices into the input array */
+FOUNDATION_API const radixsort64_index_t*
+radixsort64_sort_parallel(radixsort64_t* sort, const void* input, radixsort64_index_t num,
+                         task_scheduler_t* scheduler);
@@ -13,6 +13,22 @@
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
 
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define RANDOM_LANES_SSE2 1
+#  include <emmintrin.h>
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define RANDOM_TARGET_AVX2
+#  else
+#    define RANDOM_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define RANDOM_LANES_NEON 1
+#  include <arm_neon.h>
+#endif
+
 // C implementation of the "Maximally equidistributed pseudorandom number generators via
 //linear output transformations" from http://www.sciencedirect.com/science/article/pii/S0378475408002358
 //Put state array in thread-local storage for thread safety
@@ -32,6 +48,15 @@
 #define RANDOM_MID_LIMIT    229
 #define RANDOM_HIGH_LIMIT   481
 
+//Bulk fills run this many independent xoshiro128** generators in parallel lanes. The lane
+//state is stored after the generator state in the thread buffer, one row of lanes per word
+#define RANDOM_LANES        16
+#define RANDOM_LANE_STATE   (RANDOM_STATE_SIZE + 1)
+#define RANDOM_BUFFER_SIZE  (RANDOM_LANE_STATE + (RANDOM_LANES * 4))
+
+//Number of values generated per block when converting to floating point
+#define RANDOM_FILL_BLOCK   256
+
 //Some helper macros to make code a bit more condensed
 #define RANDOM_XOR_AND_LEFTSHIFT(bits, val)  ((val) ^ ((val) << (bits)))
 #define RANDOM_XOR_AND_RIGHTSHIFT(bits, val) ((val) ^ ((val) >> (bits)))
@@ -39,11 +64,25 @@
 	(((val) & (test)) ? (((((val) << (bits)) ^ ((val) >> (RANDOM_BITS - (bits)))) & (mask)) ^ (key)) : \
 	                    (((((val) << (bits)) ^ ((val) >> (RANDOM_BITS - (bits)))) & (mask))))
 
-FOUNDATION_DECLARE_THREAD_LOCAL(unsigned int*, state, 0)
+FOUNDATION_DECLARE_THREAD_CONTEXT(unsigned int*, random_state)
+
+//State buffers are prefixed by a header linking them into the lock-free stack of available
+//buffers and the list of all buffers, so thread startup and exit never take a lock
+typedef struct random_header_t random_header_t;
 
-static mutex_t*       _random_mutex;
-static unsigned int** _random_state;
-static unsigned int** _random_available_state;
+struct random_header_t {
+	lockfree_node_t available;
+	lockfree_node_t all;
+};
+
+#define RANDOM_HEADER_SIZE ((sizeof(random_header_t) + 15) & ~(size_t)15)
+
+static bool             _random_initialized;
+static lockfree_stack_t _random_state;
+static lockfree_stack_t _random_available_state;
+
+static void
+_random_seed_lanes(unsigned int* buffer);
 
 static void
 _random_seed_buffer(unsigned int* buffer) {
@@ -54,90 +93,85 @@ _random_seed_buffer(unsigned int* buffer) {
 		             (base + time_current() + (i * RANDOM_HIGH_LIMIT * RANDOM_LOW_LIMIT))) & 0xFFFFFFFF;
 }
 
+static FOUNDATION_FORCEINLINE unsigned int*
+_random_header_buffer(random_header_t* header) {
+	return pointer_offset(header, RANDOM_HEADER_SIZE);
+}
+
+static FOUNDATION_FORCEINLINE random_header_t*
+_random_buffer_header(unsigned int* buffer) {
+	return pointer_offset(buffer, -(ssize_t)RANDOM_HEADER_SIZE);
+}
+
 static unsigned int*
 _random_allocate_buffer(void) {
-	unsigned int* buffer = memory_allocate(0, sizeof(unsigned int) * (RANDOM_STATE_SIZE + 1), 0,
-	                                       MEMORY_PERSISTENT);
+	random_header_t* header = memory_allocate(0, RANDOM_HEADER_SIZE +
+	                                          (sizeof(unsigned int) * RANDOM_BUFFER_SIZE), 16,
+	                                          MEMORY_PERSISTENT);
+	unsigned int* buffer = _random_header_buffer(header);
 	_random_seed_buffer(buffer);
 	buffer[RANDOM_STATE_SIZE] = 0;
-	array_push(_random_state, buffer);
+	_random_seed_lanes(buffer);
+	lockfree_stack_push(&_random_state, &header->all);
 	return buffer;
 }
 
 int
 _random_initialize(void) {
-	if (!_random_mutex) {
-		size_t prealloc, capacity;
+	if (!_random_initialized) {
 		size_t i;
-		_random_mutex = mutex_allocate(STRING_CONST("random"));
+		lockfree_stack_initialize(&_random_state);
+		lockfree_stack_initialize(&_random_available_state);
 
 		//Allocate and seed a number of state buffers
-		prealloc = _foundation_config.random_state_prealloc;
-		capacity = prealloc > 8 ? prealloc : 8;
-		array_reserve(_random_state, capacity);
-		array_reserve(_random_available_state, capacity);
-		for (i = 0; i < prealloc; ++i) {
+		for (i = 0; i < _foundation_config.random_state_prealloc; ++i) {
 			unsigned int* buffer = _random_allocate_buffer();
-			array_push(_random_available_state, buffer);
+			lockfree_stack_push(&_random_available_state, &_random_buffer_header(buffer)->available);
 		}
+		_random_initialized = true;
 	}
 	return 0;
 }
 
 void
 _random_finalize(void) {
-	size_t i, size;
-
-	if (_random_mutex)
-		mutex_lock(_random_mutex);
-
-	for (i = 0, size = array_size(_random_state); i < size; ++i)
-		memory_deallocate(_random_state[i]);
-	array_deallocate(_random_available_state);
-	array_deallocate(_random_state);
+	lockfree_node_t* node = lockfree_stack_pop_all(&_random_state);
+	while (node) {
+		lockfree_node_t* next = atomic_loadptr(&node->next);
+		memory_deallocate(pointer_offset(node, -(ssize_t)offsetof(random_header_t, all)));
+		node = next;
+	}
+	lockfree_stack_pop_all(&_random_available_state);
 
-	set_thread_state(0);
+	set_thread_random_state(0);
 
-	if (_random_mutex) {
-		mutex_unlock(_random_mutex);
-		mutex_deallocate(_random_mutex);
-	}
-	_random_mutex = 0;
+	_random_initialized = false;
 }
 
 static unsigned int*
 _random_thread_initialize(void) {
-	unsigned int* buffer;
-
-	mutex_lock(_random_mutex);
-
 	//Grab a free state buffer or allocate if none available
-	if (!array_size(_random_available_state)) {
+	unsigned int* buffer;
+	lockfree_node_t* node = lockfree_stack_pop(&_random_available_state);
+	if (node)
+		buffer = _random_header_buffer((random_header_t*)node);
+	else
 		buffer = _random_allocate_buffer();
-		array_push(_random_available_state, buffer);
-	}
-	else {
-		buffer = _random_available_state[ array_size(_random_available_state) - 1 ];
-		array_pop(_random_available_state);
-	}
 
-	mutex_unlock(_random_mutex);
-
-	set_thread_state(buffer);
+	set_thread_random_state(buffer);
 
 	return buffer;
 }
 
 void
 random_thread_finalize(void) {
-	if (!get_thread_state())
+	unsigned int* buffer = get_thread_random_state();
+	if (!buffer)
 		return;
 
-	mutex_lock(_random_mutex);
-	array_push(_random_available_state, get_thread_state());
-	mutex_unlock(_random_mutex);
+	lockfree_stack_push(&_random_available_state, &_random_buffer_header(buffer)->available);
 
-	set_thread_state(0);
+	set_thread_random_state(0);
 }
 
 static FOUNDATION_FORCEINLINE unsigned int
@@ -237,9 +271,210 @@ random_from_state(unsigned int* FOUNDATION_RESTRICT state) {
 	}
 }
 
+static void
+_random_seed_lanes(unsigned int* buffer) {
+	unsigned int* lanes = buffer + RANDOM_LANE_STATE;
+	unsigned int i;
+	for (i = 0; i < RANDOM_LANES * 4; ++i)
+		lanes[i] = random_from_state(buffer);
+	//All-zero state is a fixed point of the generator
+	for (i = 0; i < RANDOM_LANES; ++i)
+		lanes[i] |= 1;
+}
+
+//Multiplications by 5 and 9 in xoshiro128** are done as shift and add, which keeps
+//the lane kernels within the SSE2 instruction set
+
+#if RANDOM_LANES_SSE2
+
+#define RANDOM_SSE2_ROTL(x, k) _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - (k)))
+#define RANDOM_AVX2_ROTL(x, k) \
+	_mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - (k)))
+
+static void
+random_lanes_fill_sse2(unsigned int* lanes, uint32_t* out, size_t blocks) {
+	__m128i s0[4], s1[4], s2[4], s3[4];
+	size_t iblock;
+	int ig;
+	for (ig = 0; ig < 4; ++ig) {
+		s0[ig] = _mm_loadu_si128((const __m128i*)(const void*)(lanes + (ig * 4)));
+		s1[ig] = _mm_loadu_si128((const __m128i*)(const void*)(lanes + RANDOM_LANES + (ig * 4)));
+		s2[ig] = _mm_loadu_si128((const __m128i*)(const void*)(lanes + (RANDOM_LANES * 2) + (ig * 4)));
+		s3[ig] = _mm_loadu_si128((const __m128i*)(const void*)(lanes + (RANDOM_LANES * 3) + (ig * 4)));
+	}
+	for (iblock = 0; iblock < blocks; ++iblock, out += RANDOM_LANES) {
+		for (ig = 0; ig < 4; ++ig) {
+			__m128i x = _mm_add_epi32(s1[ig], _mm_slli_epi32(s1[ig], 2));
+			__m128i t = _mm_slli_epi32(s1[ig], 9);
+			x = RANDOM_SSE2_ROTL(x, 7);
+			x = _mm_add_epi32(x, _mm_slli_epi32(x, 3));
+			_mm_storeu_si128((__m128i*)(void*)(out + (ig * 4)), x);
+			s2[ig] = _mm_xor_si128(s2[ig], s0[ig]);
+			s3[ig] = _mm_xor_si128(s3[ig], s1[ig]);
+			s1[ig] = _mm_xor_si128(s1[ig], s2[ig]);
+			s0[ig] = _mm_xor_si128(s0[ig], s3[ig]);
+			s2[ig] = _mm_xor_si128(s2[ig], t);
+			s3[ig] = RANDOM_SSE2_ROTL(s3[ig], 11);
+		}
+	}
+	for (ig = 0; ig < 4; ++ig) {
+		_mm_storeu_si128((__m128i*)(void*)(lanes + (ig * 4)), s0[ig]);
+		_mm_storeu_si128((__m128i*)(void*)(lanes + RANDOM_LANES + (ig * 4)), s1[ig]);
+		_mm_storeu_si128((__m128i*)(void*)(lanes + (RANDOM_LANES * 2) + (ig * 4)), s2[ig]);
+		_mm_storeu_si128((__m128i*)(void*)(lanes + (RANDOM_LANES * 3) + (ig * 4)), s3[ig]);
+	}
+}
+
+static RANDOM_TARGET_AVX2 void
+random_lanes_fill_avx2(unsigned int* lanes, uint32_t* out, size_t blocks) {
+	__m256i s0[2], s1[2], s2[2], s3[2];
+	size_t iblock;
+	int ig;
+	for (ig = 0; ig < 2; ++ig) {
+		s0[ig] = _mm256_loadu_si256((const __m256i*)(const void*)(lanes + (ig * 8)));
+		s1[ig] = _mm256_loadu_si256((const __m256i*)(const void*)(lanes + RANDOM_LANES + (ig * 8)));
+		s2[ig] = _mm256_loadu_si256((const __m256i*)(const void*)(lanes + (RANDOM_LANES * 2) + (ig * 8)));
+		s3[ig] = _mm256_loadu_si256((const __m256i*)(const void*)(lanes + (RANDOM_LANES * 3) + (ig * 8)));
+	}
+	for (iblock = 0; iblock < blocks; ++iblock, out += RANDOM_LANES) {
+		for (ig = 0; ig < 2; ++ig) {
+			__m256i x = _mm256_add_epi32(s1[ig], _mm256_slli_epi32(s1[ig], 2));
+			__m256i t = _mm256_slli_epi32(s1[ig], 9);
+			x = RANDOM_AVX2_ROTL(x, 7);
+			x = _mm256_add_epi32(x, _mm256_slli_epi32(x, 3));
+			_mm256_storeu_si256((__m256i*)(void*)(out + (ig * 8)), x);
+			s2[ig] = _mm256_xor_si256(s2[ig], s0[ig]);
+			s3[ig] = _mm256_xor_si256(s3[ig], s1[ig]);
+			s1[ig] = _mm256_xor_si256(s1[ig], s2[ig]);
+			s0[ig] = _mm256_xor_si256(s0[ig], s3[ig]);
+			s2[ig] = _mm256_xor_si256(s2[ig], t);
+			s3[ig] = RANDOM_AVX2_ROTL(s3[ig], 11);
+		}
+	}
+	for (ig = 0; ig < 2; ++ig) {
+		_mm256_storeu_si256((__m256i*)(void*)(lanes + (ig * 8)), s0[ig]);
+		_mm256_storeu_si256((__m256i*)(void*)(lanes + RANDOM_LANES + (ig * 8)), s1[ig]);
+		_mm256_storeu_si256((__m256i*)(void*)(lanes + (RANDOM_LANES * 2) + (ig * 8)), s2[ig]);
+		_mm256_storeu_si256((__m256i*)(void*)(lanes + (RANDOM_LANES * 3) + (ig * 8)), s3[ig]);
+	}
+}
+
+static int _random_lanes_avx2 = -1;
+
+static bool
+_random_lanes_avx2_supported(void) {
+	if (_random_lanes_avx2 < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		bool supported = false;
+		__cpuid(info, 1);
+		//Require OS support for saving YMM state
+		if ((info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6)) {
+			__cpuidex(info, 7, 0);
+			supported = (info[1] & (1 << 5)) != 0;
+		}
+		_random_lanes_avx2 = supported ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		_random_lanes_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+	}
+	return _random_lanes_avx2 > 0;
+}
+
+#elif RANDOM_LANES_NEON
+
+#define RANDOM_NEON_ROTL(x, k) vsriq_n_u32(vshlq_n_u32(x, k), x, 32 - (k))
+
+static void
+random_lanes_fill_neon(unsigned int* lanes, uint32_t* out, size_t blocks) {
+	uint32x4_t s0[4], s1[4], s2[4], s3[4];
+	size_t iblock;
+	int ig;
+	for (ig = 0; ig < 4; ++ig) {
+		s0[ig] = vld1q_u32(lanes + (ig * 4));
+		s1[ig] = vld1q_u32(lanes + RANDOM_LANES + (ig * 4));
+		s2[ig] = vld1q_u32(lanes + (RANDOM_LANES * 2) + (ig * 4));
+		s3[ig] = vld1q_u32(lanes + (RANDOM_LANES * 3) + (ig * 4));
+	}
+	for (iblock = 0; iblock < blocks; ++iblock, out += RANDOM_LANES) {
+		for (ig = 0; ig < 4; ++ig) {
+			uint32x4_t x = vaddq_u32(s1[ig], vshlq_n_u32(s1[ig], 2));
+			uint32x4_t t = vshlq_n_u32(s1[ig], 9);
+			x = RANDOM_NEON_ROTL(x, 7);
+			x = vaddq_u32(x, vshlq_n_u32(x, 3));
+			vst1q_u32(out + (ig * 4), x);
+			s2[ig] = veorq_u32(s2[ig], s0[ig]);
+			s3[ig] = veorq_u32(s3[ig], s1[ig]);
+			s1[ig] = veorq_u32(s1[ig], s2[ig]);
+			s0[ig] = veorq_u32(s0[ig], s3[ig]);
+			s2[ig] = veorq_u32(s2[ig], t);
+			s3[ig] = RANDOM_NEON_ROTL(s3[ig], 11);
+		}
+	}
+	for (ig = 0; ig < 4; ++ig) {
+		vst1q_u32(lanes + (ig * 4), s0[ig]);
+		vst1q_u32(lanes + RANDOM_LANES + (ig * 4), s1[ig]);
+		vst1q_u32(lanes + (RANDOM_LANES * 2) + (ig * 4), s2[ig]);
+		vst1q_u32(lanes + (RANDOM_LANES * 3) + (ig * 4), s3[ig]);
+	}
+}
+
+#else
+
+static void
+random_lanes_fill_generic(unsigned int* lanes, uint32_t* out, size_t blocks) {
+	size_t iblock;
+	unsigned int lane;
+	for (iblock = 0; iblock < blocks; ++iblock, out += RANDOM_LANES) {
+		for (lane = 0; lane < RANDOM_LANES; ++lane) {
+			uint32_t s0 = lanes[lane];
+			uint32_t s1 = lanes[RANDOM_LANES + lane];
+			uint32_t s2 = lanes[(RANDOM_LANES * 2) + lane];
+			uint32_t s3 = lanes[(RANDOM_LANES * 3) + lane];
+			uint32_t x = s1 * 5;
+			uint32_t t = s1 << 9;
+			out[lane] = ((x << 7) | (x >> 25)) * 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			lanes[lane] = s0;
+			lanes[RANDOM_LANES + lane] = s1;
+			lanes[(RANDOM_LANES * 2) + lane] = s2;
+			lanes[(RANDOM_LANES * 3) + lane] = (s3 << 11) | (s3 >> 21);
+		}
+	}
+}
+
+#endif
+
+static void
+random_lanes_fill(unsigned int* lanes, uint32_t* out, size_t blocks) {
+#if RANDOM_LANES_SSE2
+	if (_random_lanes_avx2_supported())
+		random_lanes_fill_avx2(lanes, out, blocks);
+	else
+		random_lanes_fill_sse2(lanes, out, blocks);
+#elif RANDOM_LANES_NEON
+	random_lanes_fill_neon(lanes, out, blocks);
+#else
+	random_lanes_fill_generic(lanes, out, blocks);
+#endif
+}
+
+static unsigned int*
+random_lanes_thread(void) {
+	unsigned int* state = get_thread_random_state();
+	if (!state)
+		state = _random_thread_initialize();
+	return state + RANDOM_LANE_STATE;
+}
+
 uint32_t
 random32(void) {
-	unsigned int* state = get_thread_state();
+	unsigned int* state = get_thread_random_state();
 	if (!state)
 		state = _random_thread_initialize();
 
@@ -261,7 +496,7 @@ random32_range(uint32_t low, uint32_t high) {
 uint64_t
 random64(void) {
 	uint32_t low, high;
-	unsigned int* state = get_thread_state();
+	unsigned int* state = get_thread_random_state();
 	if (!state)
 		state = _random_thread_initialize();
 
@@ -283,14 +518,12 @@ random64_range(uint64_t low, uint64_t high) {
 	return low + (random64() % (high - low));
 }
 
-real
-random_normalized(void) {
+static FOUNDATION_FORCEINLINE real
+random_normalize(uint64_t rng) {
 #if FOUNDATION_SIZE_REAL == 8
-	const uint64_t rng = random64();
 	const real result = (real)rng * (REAL_C(1.0) / REAL_C(18446744073709551616.0L));
 #else
-	const uint64_t rng = random32();
-	const real result = (real)rng * (REAL_C(1.0) / REAL_C(4294967296.0));
+	const real result = (real)(rng & 0xFFFFFFFFULL) * (REAL_C(1.0) / REAL_C(4294967296.0));
 #endif
 	//Deal with floating point roundoff issues
 	if (result >= REAL_C(1.0))
@@ -298,47 +531,80 @@ random_normalized(void) {
 	return math_max(result, 0);
 }
 
-real
-random_range(real low, real high) {
+static FOUNDATION_FORCEINLINE real
+random_scale(real low, real high, real normalized) {
 	real result;
 	if (low > high) {
 		real tmp = low;
 		low = high;
 		high = tmp;
 	}
-	result = low + ((high - low) * random_normalized());
+	result = low + ((high - low) * normalized);
 	//Deal with floating point roundoff issues
 	if (result >= high)
 		return math_real_dec(high, 1);
 	return math_max(result, low);
 }
 
-int32_t
-random32_gaussian_range(int32_t low, int32_t high) {
-	const uint64_t cubic = ((((uint64_t)random32() + (uint64_t)random32()) + ((uint64_t)random32() +
-	                         (uint64_t)random32()) + 2ULL) >> 2ULL);
+static FOUNDATION_FORCEINLINE int32_t
+random32_scale(int32_t low, int32_t high, uint64_t fraction) {
 	if (low > high) {
 		int32_t tmp = low;
 		low = high;
 		high = tmp;
 	}
 	/*lint -e{571,776} */
-	return low + (int32_t)((cubic * (uint64_t)(high - low)) >> 32ULL);
+	return low + (int32_t)((fraction * (uint64_t)(high - low)) >> 32ULL);
+}
+
+static real
+random_weights_sum(uint32_t limit, const real* weights) {
+	uint32_t i;
+	real sum = 0;
+	for (i = 0; i < limit; ++i)
+		sum += (weights[i] > 0 ? weights[i] : 0);
+	return sum;
+}
+
+static uint32_t
+random_weights_select(uint32_t limit, const real* weights, real value) {
+	uint32_t i;
+	for (i = 0; i < limit; ++i) {
+		if (weights[i] > 0) {
+			if (value < weights[i])
+				return i;
+			value -= weights[i];
+		}
+	}
+	//Deal with floating point roundoff issues
+	return limit - 1;
+}
+
+real
+random_normalized(void) {
+#if FOUNDATION_SIZE_REAL == 8
+	return random_normalize(random64());
+#else
+	return random_normalize(random32());
+#endif
+}
+
+real
+random_range(real low, real high) {
+	return random_scale(low, high, random_normalized());
+}
+
+int32_t
+random32_gaussian_range(int32_t low, int32_t high) {
+	const uint64_t cubic = ((((uint64_t)random32() + (uint64_t)random32()) + ((uint64_t)random32() +
+	                         (uint64_t)random32()) + 2ULL) >> 2ULL);
+	return random32_scale(low, high, cubic);
 }
 
 real
 random_gaussian_range(real low, real high) {
-	real result;
-	if (low > high) {
-		real tmp = low;
-		low = high;
-		high = tmp;
-	}
-	result = low + ((high - low) * REAL_C(0.33333333333333333333333333333) *
-	                (random_normalized() + random_normalized() + random_normalized()));
-	if (result >= high)
-		return math_real_dec(high, 1);
-	return math_max(result, low);
+	return random_scale(low, high, REAL_C(0.33333333333333333333333333333) *
+	                    (random_normalized() + random_normalized() + random_normalized()));
 }
 
 int32_t
@@ -346,54 +612,353 @@ random32_triangle_range(int32_t low, int32_t high) {
 	const uint32_t t0 = random32();
 	const uint32_t t1  = random32();
 	const uint64_t tri = (t0 >> 1) + (t1 >> 1) + (t0 & t1 & 1);
+	return random32_scale(low, high, tri);
+}
+
+real
+random_triangle_range(real low, real high) {
+	return random_scale(low, high, REAL_C(0.5) * (random_normalized() + random_normalized()));
+}
+
+uint32_t
+random32_weighted(uint32_t limit, const real* weights) {
+	if (limit >= 2) {
+		const real sum = random_weights_sum(limit, weights);
+		if (sum > 0)
+			return random_weights_select(limit, weights, random_range(0, sum));
+		return random32_range(0, limit);
+	}
+
+	//Deal with floating point roundoff issues
+	return limit - 1;
+}
+
+void
+random_fill_uint32(uint32_t* values, size_t count) {
+	unsigned int* lanes = random_lanes_thread();
+	size_t blocks = count / RANDOM_LANES;
+	size_t remain = count % RANDOM_LANES;
+
+	random_lanes_fill(lanes, values, blocks);
+	if (remain) {
+		uint32_t tail[RANDOM_LANES];
+		random_lanes_fill(lanes, tail, 1);
+		memcpy(values + (blocks * RANDOM_LANES), tail, sizeof(uint32_t) * remain);
+	}
+}
+
+void
+random_fill_float(float* values, size_t count) {
+	unsigned int* lanes = random_lanes_thread();
+	uint32_t block[RANDOM_FILL_BLOCK];
+
+	while (count) {
+		size_t num = (count < RANDOM_FILL_BLOCK) ? count : RANDOM_FILL_BLOCK;
+		size_t i;
+		random_lanes_fill(lanes, block, (num + RANDOM_LANES - 1) / RANDOM_LANES);
+		//Upper 24 bits fill the mantissa, exactly representable and strictly below 1
+		for (i = 0; i < num; ++i)
+			values[i] = (float)(int32_t)(block[i] >> 8) * (1.0f / 16777216.0f);
+		values += num;
+		count -= num;
+	}
+}
+
+void
+random_fill_real(real* values, size_t count) {
+#if FOUNDATION_SIZE_REAL == 8
+	unsigned int* lanes = random_lanes_thread();
+	uint32_t block[RANDOM_FILL_BLOCK];
+
+	while (count) {
+		size_t num = (count < (RANDOM_FILL_BLOCK / 2)) ? count : (RANDOM_FILL_BLOCK / 2);
+		size_t i;
+		random_lanes_fill(lanes, block, ((num * 2) + RANDOM_LANES - 1) / RANDOM_LANES);
+		//Two 32-bit values give the 53 bits of mantissa precision
+		for (i = 0; i < num; ++i) {
+			const int64_t bits = (int64_t)(((uint64_t)block[i * 2] << 21) ^ (block[(i * 2) + 1] >> 11));
+			values[i] = (real)bits * (REAL_C(1.0) / REAL_C(9007199254740992.0));
+		}
+		values += num;
+		count -= num;
+	}
+#else
+	random_fill_float(values, count);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+random_rotl64(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+void
+random_state_initialize(random_state_t* state, uint64_t seed) {
+	int i;
+	//Expand the seed with splitmix64, which never yields an all-zero state
+	for (i = 0; i < 4; ++i) {
+		uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		state->s[i] = z ^ (z >> 31);
+	}
+}
+
+uint64_t
+random_state64(random_state_t* state) {
+	uint64_t* s = state->s;
+	const uint64_t result = random_rotl64(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = random_rotl64(s[3], 45);
+	return result;
+}
+
+static void
+random_state_advance(random_state_t* state, const uint64_t* polynomial) {
+	uint64_t s[4] = {0, 0, 0, 0};
+	int i, b;
+	for (i = 0; i < 4; ++i) {
+		for (b = 0; b < 64; ++b) {
+			if (polynomial[i] & (1ULL << b)) {
+				s[0] ^= state->s[0];
+				s[1] ^= state->s[1];
+				s[2] ^= state->s[2];
+				s[3] ^= state->s[3];
+			}
+			random_state64(state);
+		}
+	}
+	memcpy(state->s, s, sizeof(s));
+}
+
+void
+random_state_jump(random_state_t* state) {
+	static const uint64_t jump[4] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+	random_state_advance(state, jump);
+}
+
+void
+random_state_long_jump(random_state_t* state) {
+	static const uint64_t long_jump[4] = {
+		0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL
+	};
+	random_state_advance(state, long_jump);
+}
+
+uint32_t
+random_state32(random_state_t* state) {
+	//Upper bits have the best statistical quality
+	return (uint32_t)(random_state64(state) >> 32ULL);
+}
+
+uint32_t
+random_state32_range(random_state_t* state, uint32_t low, uint32_t high) {
 	if (low > high) {
-		int32_t tmp = low;
+		uint32_t tmp = low;
 		low = high;
 		high = tmp;
 	}
-	/*lint -e{571,776} */
-	return low + (int32_t)((tri * (uint64_t)(high - low)) >> 32ULL);
+	if (high <= low + 1)
+		return low;
+	return low + (random_state32(state) % (high - low));
 }
 
-real
-random_triangle_range(real low, real high) {
-	real result;
+uint64_t
+random_state64_range(random_state_t* state, uint64_t low, uint64_t high) {
 	if (low > high) {
-		real tmp = low;
+		uint64_t tmp = low;
 		low = high;
 		high = tmp;
 	}
-	result = low + (high - low) * REAL_C(0.5) * (random_normalized() + random_normalized());
-	if (result >= high)
-		return math_real_dec(high, 1);
-	return math_max(result, low);
+	if (high <= low + 1)
+		return low;
+	return low + (random_state64(state) % (high - low));
+}
+
+real
+random_state_normalized(random_state_t* state) {
+#if FOUNDATION_SIZE_REAL == 8
+	return random_normalize(random_state64(state));
+#else
+	return random_normalize(random_state32(state));
+#endif
+}
+
+real
+random_state_range(random_state_t* state, real low, real high) {
+	return random_scale(low, high, random_state_normalized(state));
+}
+
+int32_t
+random_state32_gaussian_range(random_state_t* state, int32_t low, int32_t high) {
+	const uint64_t r0 = random_state64(state);
+	const uint64_t r1 = random_state64(state);
+	const uint64_t cubic = (((r0 >> 32ULL) + (r0 & 0xFFFFFFFFULL)) +
+	                        ((r1 >> 32ULL) + (r1 & 0xFFFFFFFFULL)) + 2ULL) >> 2ULL;
+	return random32_scale(low, high, cubic);
+}
+
+real
+random_state_gaussian_range(random_state_t* state, real low, real high) {
+	const real n0 = random_state_normalized(state);
+	const real n1 = random_state_normalized(state);
+	const real n2 = random_state_normalized(state);
+	return random_scale(low, high, REAL_C(0.33333333333333333333333333333) * (n0 + n1 + n2));
+}
+
+int32_t
+random_state32_triangle_range(random_state_t* state, int32_t low, int32_t high) {
+	const uint64_t r = random_state64(state);
+	const uint32_t t0 = (uint32_t)(r >> 32ULL);
+	const uint32_t t1 = (uint32_t)(r & 0xFFFFFFFFULL);
+	const uint64_t tri = (t0 >> 1) + (t1 >> 1) + (t0 & t1 & 1);
+	return random32_scale(low, high, tri);
+}
+
+real
+random_state_triangle_range(random_state_t* state, real low, real high) {
+	const real n0 = random_state_normalized(state);
+	const real n1 = random_state_normalized(state);
+	return random_scale(low, high, REAL_C(0.5) * (n0 + n1));
 }
 
 uint32_t
-random32_weighted(uint32_t limit, const real* weights) {
-	uint32_t i;
-	real sum;
+random_state32_weighted(random_state_t* state, uint32_t limit, const real* weights) {
 	if (limit >= 2) {
-		sum = 0;
-		for (i = 0; i < limit; ++i)
-			sum += (weights[i] > 0 ? weights[i] : 0);
-
-		if (sum > 0) {
-			real value = random_range(0, sum);
-			for (i = 0; i < limit; ++i) {
-				if (weights[i] > 0) {
-					if (value < weights[i])
-						return i;
-					value -= weights[i];
-				}
-			}
-		}
-		else {
-			return random32_range(0, limit);
-		}
+		const real sum = random_weights_sum(limit, weights);
+		if (sum > 0)
+			return random_weights_select(limit, weights, random_state_range(state, 0, sum));
+		return random_state32_range(state, 0, limit);
 	}
 
 	//Deal with floating point roundoff issues
 	return limit - 1;
 }
 
+random_alias_t*
+random_alias_allocate(uint32_t limit, const real* weights) {
+	random_alias_t* alias = memory_allocate(0, sizeof(random_alias_t), 0, MEMORY_PERSISTENT);
+	random_alias_initialize(alias, limit, weights);
+	return alias;
+}
+
+void
+random_alias_deallocate(random_alias_t* alias) {
+	if (alias)
+		random_alias_finalize(alias);
+	memory_deallocate(alias);
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+random_alias_threshold(real probability) {
+	const double threshold = (double)probability * 4294967296.0;
+	return (threshold < 4294967295.0) ? (uint32_t)math_max(threshold, 0.0) : 0xFFFFFFFFU;
+}
+
+void
+random_alias_initialize(random_alias_t* alias, uint32_t limit, const real* weights) {
+	uint32_t i, small, large;
+	uint32_t* work;
+	real* scaled;
+	const real sum = random_weights_sum(limit, weights);
+
+	alias->count = limit ? limit : 1;
+	alias->table = memory_allocate(0, sizeof(uint32_t) * 2 * alias->count, 0, MEMORY_PERSISTENT);
+
+	//Entries accepted with full probability alias themselves
+	for (i = 0; i < alias->count; ++i) {
+		alias->table[i * 2] = 0xFFFFFFFFU;
+		alias->table[(i * 2) + 1] = i;
+	}
+	if (sum <= 0)
+		return;
+
+	//Vose's alias method, scale weights to a mean of one and pair each entry below the mean with
+	//an entry above it. Small entries are kept at the start of the work list and large at the end
+	scaled = memory_allocate(0, sizeof(real) * limit, 0, MEMORY_TEMPORARY);
+	work = memory_allocate(0, sizeof(uint32_t) * limit, 0, MEMORY_TEMPORARY);
+	small = 0;
+	large = limit;
+	for (i = 0; i < limit; ++i) {
+		scaled[i] = (weights[i] > 0 ? weights[i] : 0) * ((real)limit / sum);
+		if (scaled[i] < REAL_C(1.0))
+			work[small++] = i;
+		else
+			work[--large] = i;
+	}
+
+	while (small && (large < limit)) {
+		const uint32_t less = work[--small];
+		const uint32_t more = work[large++];
+		alias->table[less * 2] = random_alias_threshold(scaled[less]);
+		alias->table[(less * 2) + 1] = more;
+		scaled[more] = (scaled[more] + scaled[less]) - REAL_C(1.0);
+		if (scaled[more] < REAL_C(1.0))
+			work[small++] = more;
+		else
+			work[--large] = more;
+	}
+	//Any entries left are at the mean within floating point roundoff and keep full probability
+
+	memory_deallocate(work);
+	memory_deallocate(scaled);
+}
+
+void
+random_alias_finalize(random_alias_t* alias) {
+	memory_deallocate(alias->table);
+	alias->table = 0;
+	alias->count = 0;
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+random_alias_select(const random_alias_t* alias, uint32_t index_bits, uint32_t accept_bits) {
+	const uint32_t index = (uint32_t)(((uint64_t)index_bits * alias->count) >> 32ULL);
+	const uint32_t* entry = alias->table + (index * 2);
+	return (accept_bits < entry[0]) ? index : entry[1];
+}
+
+uint32_t
+random32_alias(const random_alias_t* alias) {
+	const uint64_t rng = random64();
+	return random_alias_select(alias, (uint32_t)(rng >> 32ULL), (uint32_t)rng);
+}
+
+uint32_t
+random_state32_alias(random_state_t* state, const random_alias_t* alias) {
+	const uint64_t rng = random_state64(state);
+	return random_alias_select(alias, (uint32_t)(rng >> 32ULL), (uint32_t)rng);
+}
+
+void
+random_fill_alias(const random_alias_t* alias, uint32_t* values, size_t count) {
+	unsigned int* lanes = random_lanes_thread();
+	uint32_t block[RANDOM_FILL_BLOCK];
+
+	while (count) {
+		size_t num = (count < (RANDOM_FILL_BLOCK / 2)) ? count : (RANDOM_FILL_BLOCK / 2);
+		size_t i;
+		random_lanes_fill(lanes, block, ((num * 2) + RANDOM_LANES - 1) / RANDOM_LANES);
+		for (i = 0; i < num; ++i)
+			values[i] = random_alias_select(alias, block[i * 2], block[(i * 2) + 1]);
+		values += num;
+		count -= num;
+	}
+}
+
+void
+random_state_fill_alias(random_state_t* state, const random_alias_t* alias, uint32_t* values,
+                        size_t count) {
+	size_t i;
+	for (i = 0; i < count; ++i) {
+		const uint64_t rng = random_state64(state);
+		values[i] = random_alias_select(alias, (uint32_t)(rng >> 32ULL), (uint32_t)rng);
+	}
+}
@@ -22,7 +22,23 @@ thread has exited and released ownership of such buffers.
 
 All random functions generate values in ranges where low limit of the range is included
 in the set of value, while the high limit is excluded. This is denoted [low,high) in the
-documentation for each function, as per https://en.wikipedia.org/wiki/ISO_31-11 notation. */
+documentation for each function, as per https://en.wikipedia.org/wiki/ISO_31-11 notation.
+
+The bulk fill functions fetch the thread-local state once per call and generate values with
+a set of independent xoshiro128** generators running in parallel SIMD lanes, seeded from the
+main generator. Use these when large numbers of values are needed, they are several times
+faster than repeated calls to the single value functions.
+
+The random_state functions operate on an explicit xoshiro256** generator state owned by the
+caller instead of the thread-local state, giving reproducible sequences from a seed. Independent
+non-overlapping streams for parallel tasks are created by copying a seeded state and advancing
+each copy with #random_state_jump (2^128 values apart) or #random_state_long_jump (2^192 values
+apart). A state must not be used concurrently from multiple threads.
+
+Repeated weighted sampling from the same weights should use an alias table, built once with
+#random_alias_initialize and sampled in constant time with #random32_alias,
+#random_state32_alias or the bulk #random_fill_alias, instead of #random32_weighted which
+scans the weights for every sample. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -102,6 +118,194 @@ array must have "limit" number of elements.
 FOUNDATION_API uint32_t
 random32_weighted(uint32_t limit, const real* weights);
 
+/*! Fill an array with 32 bit random numbers in full [0,2^32) range.
+\param values Destination array
+\param count Number of values to generate */
+FOUNDATION_API void
+random_fill_uint32(uint32_t* values, size_t count);
+
+/*! Fill an array with single precision floating point random numbers with 24 bits of
+precision in [0,1) range.
+\param values Destination array
+\param count Number of values to generate */
+FOUNDATION_API void
+random_fill_float(float* values, size_t count);
+
+/*! Fill an array with floating point random numbers in [0,1) range, with 53 bits of precision
+if real is double precision and 24 bits if single precision.
+\param values Destination array
+\param count Number of values to generate */
+FOUNDATION_API void
+random_fill_real(real* values, size_t count);
+
+/*! Initialize an explicit generator state from a seed. Equal seeds give equal sequences.
+\param state Generator state
+\param seed Seed value */
+FOUNDATION_API void
+random_state_initialize(random_state_t* state, uint64_t seed);
+
+/*! Advance the generator state by 2^128 values, equivalent to that number of calls to
+#random_state64. Use to split a state into up to 2^128 non-overlapping streams.
+\param state Generator state */
+FOUNDATION_API void
+random_state_jump(random_state_t* state);
+
+/*! Advance the generator state by 2^192 values, equivalent to that number of calls to
+#random_state64. Use to split a state into up to 2^64 starting points, each of which can be
+further split with #random_state_jump.
+\param state Generator state */
+FOUNDATION_API void
+random_state_long_jump(random_state_t* state);
+
+/*! Generate 32 bit random number in full [0,2^32) range from explicit state
+\param state Generator state
+\return 32-bit pseudorandom number in [0,2^32) range */
+FOUNDATION_API uint32_t
+random_state32(random_state_t* state);
+
+/*! Generate 32 bit random number in [low,high) range from explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return 32-bit pseudorandom number in [low,high) range */
+FOUNDATION_API uint32_t
+random_state32_range(random_state_t* state, uint32_t low, uint32_t high);
+
+/*! Generate 64 bit random number in full [0,2^64) range from explicit state
+\param state Generator state
+\return 64-bit pseudorandom number in [0,2^64) range */
+FOUNDATION_API uint64_t
+random_state64(random_state_t* state);
+
+/*! Generate 64 bit random number in [low,high) range from explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return 64-bit pseudorandom number in [low,high) range */
+FOUNDATION_API uint64_t
+random_state64_range(random_state_t* state, uint64_t low, uint64_t high);
+
+/*! Generate normalized floating point random number in [0,1) range from explicit state
+\param state Generator state
+\return Floating point pseudorandom number in [0,1) range */
+FOUNDATION_API real
+random_state_normalized(random_state_t* state);
+
+/*! Generate floating point random number in [low,high) range from explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return Floating point pseudorandom number in [low,high) range */
+FOUNDATION_API real
+random_state_range(random_state_t* state, real low, real high);
+
+/*! Generate 32 bit normal distribution random number in the [low, high) range from
+explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return 32-bit pseudorandom approximation to a normal distribution in the [low, high) range */
+FOUNDATION_API int32_t
+random_state32_gaussian_range(random_state_t* state, int32_t low, int32_t high);
+
+/*! Generate floating point normal distribution random number in the [low, high) range from
+explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return Floating point value with an approximated normal distribution in the [low, high) range */
+FOUNDATION_API real
+random_state_gaussian_range(random_state_t* state, real low, real high);
+
+/*! Generate 32 bit triangular distribution random number in the [low, high) range from
+explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return 32-bit triangular distribution in the [low, high) range. */
+FOUNDATION_API int32_t
+random_state32_triangle_range(random_state_t* state, int32_t low, int32_t high);
+
+/*! Generate floating point triangular distribution random number in the [low, high) range
+from explicit state
+\param state Generator state
+\param low Lower limit of range
+\param high Upper limit of range
+\return Floating point value with a triangular distribution in the [low, high) range */
+FOUNDATION_API real
+random_state_triangle_range(random_state_t* state, real low, real high);
+
+/*! Generate a weighted random number in the [0,limit) range from explicit state, see
+#random32_weighted
+\param state Generator state
+\param limit Upper limit of range
+\param weights Array of weights, must have at least limit number of elements
+\return 32-bit weighted pseudorandom number in [0,limit) range */
+FOUNDATION_API uint32_t
+random_state32_weighted(random_state_t* state, uint32_t limit, const real* weights);
+
+/*! Allocate an alias table for weighted sampling, see #random_alias_initialize.
+Deallocate with a call to #random_alias_deallocate
+\param limit Upper limit of range
+\param weights Array of weights, must have at least limit number of elements
+\return New alias table */
+FOUNDATION_API random_alias_t*
+random_alias_allocate(uint32_t limit, const real* weights);
+
+/*! Deallocate an alias table previously allocated with #random_alias_allocate
+\param alias Alias table */
+FOUNDATION_API void
+random_alias_deallocate(random_alias_t* alias);
+
+/*! Initialize an alias table with Vose's alias method for sampling numbers in the [0,limit)
+range, with probabilities equal to the relative weights as in #random32_weighted. The table is
+built once in linear time, after which each sample takes constant time regardless of the number
+of weights. The weights array is not referenced after the call. Negative weights are treated
+as zero, and if no weight is positive all numbers are equally likely. The table is not modified
+by sampling and can be sampled concurrently from any thread. Finalize with a call to
+#random_alias_finalize
+\param alias Alias table
+\param limit Upper limit of range
+\param weights Array of weights, must have at least limit number of elements */
+FOUNDATION_API void
+random_alias_initialize(random_alias_t* alias, uint32_t limit, const real* weights);
+
+/*! Finalize an alias table previously initialized with #random_alias_initialize
+\param alias Alias table */
+FOUNDATION_API void
+random_alias_finalize(random_alias_t* alias);
+
+/*! Generate a weighted random number in the [0,limit) range from an alias table
+\param alias Alias table
+\return 32-bit weighted pseudorandom number in [0,limit) range, zero for an empty table */
+FOUNDATION_API uint32_t
+random32_alias(const random_alias_t* alias);
+
+/*! Generate a weighted random number in the [0,limit) range from an alias table and explicit
+state
+\param state Generator state
+\param alias Alias table
+\return 32-bit weighted pseudorandom number in [0,limit) range, zero for an empty table */
+FOUNDATION_API uint32_t
+random_state32_alias(random_state_t* state, const random_alias_t* alias);
+
+/*! Fill an array with weighted random numbers from an alias table, using the parallel
+generator lanes of the bulk fill functions.
+\param alias Alias table
+\param values Destination array
+\param count Number of values to generate */
+FOUNDATION_API void
+random_fill_alias(const random_alias_t* alias, uint32_t* values, size_t count);
+
+/*! Fill an array with weighted random numbers from an alias table and explicit state
+\param state Generator state
+\param alias Alias table
+\param values Destination array
+\param count Number of values to generate */
+FOUNDATION_API void
+random_state_fill_alias(random_state_t* state, const random_alias_t* alias, uint32_t* values,
+                        size_t count);
+
 /*! Free thread memory used by pseudorandom number generator. Will be called automatically
 on thread exit for foundation threads. */
 FOUNDATION_API void
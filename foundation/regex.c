@@ -11,6 +11,7 @@
  */
 
 #include <foundation/foundation.h>
+#include <foundation/internal.h>
 
 #include <stdarg.h>
 
@@ -35,6 +36,15 @@
 
 #define REGEXPARSE_NOBRANCH           (size_t)-1
 
+//Maximum number of cached DFA states, matching continues by NFA simulation if exceeded
+#define REGEX_DFA_MAX_STATES          1024
+//Flag marking an NFA node output as a bytecode offset to be resolved to a node
+#define REGEX_NFA_OP                  0x80000000U
+//Initial size of the buffer for matching streams, grown to fit the longest line or match attempt
+#define REGEX_STREAM_BUFFER_SIZE      65536
+//Size of the cache entry header preceding a cached expression
+#define REGEX_CACHE_HEADER_SIZE       ((sizeof(regex_cache_entry_t) + 15) & ~(size_t)15)
+
 enum {
 	REGEXOP_BEGIN_CAPTURE = 0,
 	REGEXOP_END_CAPTURE,
@@ -73,15 +83,91 @@ enum {
 	"BRANCH_END"
 };*/
 
+enum {
+	REGEXNFA_CHAR = 0,
+	REGEXNFA_SPLIT,
+	REGEXNFA_EPSILON,
+	REGEXNFA_BEGINNING_OF_LINE,
+	REGEXNFA_END_OF_LINE,
+	REGEXNFA_MATCH
+};
+
 struct regex_context_t {
 	size_t op;
 	size_t inoffset;
 };
 
 typedef struct regex_context_t regex_context_t;
+typedef struct regex_nfa_node_t regex_nfa_node_t;
+typedef struct regex_dfa_state_t regex_dfa_state_t;
+typedef struct regex_cache_entry_t regex_cache_entry_t;
+
+//Thompson NFA node translated from the bytecode
+struct regex_nfa_node_t {
+	uint32_t type;
+	uint32_t out[2];
+	uint32_t set[8];
+};
+
+//DFA state, the set of NFA nodes (character, end of line and match nodes) active after
+//consuming input. Transitions are filled in lazily and published atomically
+struct regex_dfa_state_t {
+	atomic32_t next[256];
+	bool match;
+	bool match_end;
+	bool dead;
+	hash_t hash;
+	size_t count;
+	uint32_t node[];
+};
+
+struct regex_dfa_t {
+	lock_t lock;
+	bool anchored;
+	bool empty_match;
+	regex_nfa_node_t* node;
+	uint32_t num_nodes;
+	uint32_t start_node;
+	uint32_t match_node;
+	uint32_t generation;
+	uint32_t* mark;
+	uint32_t* stack;
+	uint32_t* set[2];
+	uint32_t* start;
+	size_t start_count;
+	regex_dfa_state_t* initial;
+	size_t num_states;
+	regex_dfa_state_t* state[REGEX_DFA_MAX_STATES];
+};
 
 static const char REGEX_META_CHARACTERS[] = "^$()[].*+?|\\";
 
+//Set when an execution depended on the end of the input, in which case a streamed match attempt
+//must be retried once more input is available
+FOUNDATION_DECLARE_THREAD_LOCAL(int, regex_end, 0)
+
+static FOUNDATION_FORCEINLINE void
+_regex_hit_end(void) {
+	set_thread_regex_end(1);
+}
+
+//Header of a cached expression, stored in the same block ahead of the expression and followed
+//by the pattern string after the expression code. The cache holds one reference while the
+//expression is in the cache
+struct regex_cache_entry_t {
+	hash_t hash;
+	atomic32_t ref;
+	uint64_t last_use;
+	const char* pattern;
+	size_t pattern_length;
+};
+
+static lock_t _regex_cache_lock;
+static regex_cache_entry_t** _regex_cache;
+static hash_t* _regex_cache_hash;
+static size_t _regex_cache_count;
+static uint64_t _regex_cache_tick;
+
 static regex_context_t
 _regex_execute_single(regex_t* regex, size_t op, const char* input, size_t inoffset,
                       size_t inlength, string_const_t* captures, size_t maxcaptures);
@@ -553,14 +639,17 @@ _regex_execute_single(regex_t* regex, size_t op, const char* input, size_t inoff
 	case REGEXOP_END_OF_LINE:
 		if (inoffset != inlength)
 			return _regex_context_nomatch(op);
+		_regex_hit_end();
 		break;
 
 	case REGEXOP_ANY_OF:
 		cin = input[inoffset];
 		buffer_len = regex->code[op++];
 
-		if (inoffset >= inlength)
+		if (inoffset >= inlength) {
+			_regex_hit_end();
 			return _regex_context_nomatch(op + buffer_len);
+		}
 
 		/*lint -e{850} */
 		for (ibuf = 0; ibuf < buffer_len; ++ibuf) {
@@ -584,8 +673,10 @@ _regex_execute_single(regex_t* regex, size_t op, const char* input, size_t inoff
 		cin = input[inoffset];
 		buffer_len = regex->code[op++];
 
-		if (inoffset >= inlength)
+		if (inoffset >= inlength) {
+			_regex_hit_end();
 			return _regex_context_nomatch(op + buffer_len);
+		}
 
 		/*lint -e{850} */
 		for (ibuf = 0; ibuf < buffer_len; ++ibuf) {
@@ -607,12 +698,18 @@ _regex_execute_single(regex_t* regex, size_t op, const char* input, size_t inoff
 			++inoffset;
 			break;
 		}
+		_regex_hit_end();
 		return _regex_context_nomatch(op);
 
 	case REGEXOP_EXACT_MATCH:
 		matchlen = regex->code[op++];
-		if ((matchlen > (inlength - inoffset)) ||
-		        !string_equal(input + inoffset, matchlen, (const char*)regex->code + op, matchlen))
+		if (matchlen > (inlength - inoffset)) {
+			if (string_equal(input + inoffset, inlength - inoffset, (const char*)regex->code + op,
+			                 inlength - inoffset))
+				_regex_hit_end();
+			return _regex_context_nomatch(op + matchlen);
+		}
+		if (!string_equal(input + inoffset, matchlen, (const char*)regex->code + op, matchlen))
 			return _regex_context_nomatch(op + matchlen);
 		op += matchlen;
 		inoffset += matchlen;
@@ -620,6 +717,8 @@ _regex_execute_single(regex_t* regex, size_t op, const char* input, size_t inoff
 
 	case REGEXOP_META_MATCH:
 		cin = (char)regex->code[op++];
+		if (inoffset >= inlength)
+			_regex_hit_end();
 		cmatch = input[inoffset++];
 		if (!cin) {
 			if (_regex_match_escape(cmatch, regex->code[op++] << 8))
@@ -728,6 +827,508 @@ _regex_execute(regex_t* regex, size_t op, const char* input, size_t inoffset, si
 	return context;
 }
 
+static size_t
+_regex_op_size(const regex_t* regex, size_t op) {
+	switch (regex->code[op]) {
+	case REGEXOP_BEGINNING_OF_LINE:
+	case REGEXOP_END_OF_LINE:
+	case REGEXOP_ANY:
+		return 1;
+	case REGEXOP_BEGIN_CAPTURE:
+	case REGEXOP_END_CAPTURE:
+	case REGEXOP_BRANCH:
+	case REGEXOP_BRANCH_END:
+		return 2;
+	case REGEXOP_EXACT_MATCH:
+	case REGEXOP_ANY_OF:
+	case REGEXOP_ANY_BUT:
+		return 2 + (size_t)regex->code[op + 1];
+	case REGEXOP_META_MATCH:
+		return regex->code[op + 1] ? 2 : 3;
+	case REGEXOP_ZERO_OR_MORE:
+	case REGEXOP_ONE_OR_MORE:
+	case REGEXOP_ZERO_OR_MORE_SHORTEST:
+	case REGEXOP_ONE_OR_MORE_SHORTEST:
+	case REGEXOP_ZERO_OR_ONE:
+		return 1 + _regex_op_size(regex, op + 1);
+	default:
+		break;
+	}
+	return 0;
+}
+
+//Character class matched by a single character op, same rules as _regex_execute_single
+static void
+_regex_nfa_class(const regex_t* regex, size_t op, uint32_t* set) {
+	unsigned int c;
+	size_t ibuf, buffer_len;
+	memset(set, 0, sizeof(uint32_t) * 8);
+	for (c = 0; c < 256; ++c) {
+		const char cin = (char)c;
+		bool match = false;
+		switch (regex->code[op]) {
+		case REGEXOP_EXACT_MATCH:
+			match = (cin == (char)regex->code[op + 2]);
+			break;
+		case REGEXOP_META_MATCH:
+			if (!regex->code[op + 1])
+				match = _regex_match_escape(cin, regex->code[op + 2] << 8);
+			else
+				match = (cin == (char)regex->code[op + 1]);
+			break;
+		case REGEXOP_ANY:
+			match = true;
+			break;
+		case REGEXOP_ANY_OF:
+		case REGEXOP_ANY_BUT:
+			buffer_len = regex->code[op + 1];
+			for (ibuf = 0; !match && (ibuf < buffer_len); ++ibuf) {
+				const char cmatch = (char)regex->code[op + 2 + ibuf];
+				if (!cmatch)
+					match = _regex_match_escape(cin, regex->code[op + 2 + (++ibuf)] << 8);
+				else
+					match = (cin == cmatch);
+			}
+			if (regex->code[op] == REGEXOP_ANY_BUT)
+				match = !match;
+			break;
+		default:
+			break;
+		}
+		if (match)
+			set[c >> 5] |= (1U << (c & 31));
+	}
+}
+
+static uint32_t
+_regex_nfa_add(regex_nfa_node_t** nodes, uint32_t type, uint32_t out0, uint32_t out1) {
+	regex_nfa_node_t node;
+	memset(&node, 0, sizeof(node));
+	node.type = type;
+	node.out[0] = out0;
+	node.out[1] = out1;
+	array_push_memcpy(*nodes, &node);
+	return (uint32_t)(array_size(*nodes) - 1);
+}
+
+//Translate the bytecode to a Thompson NFA. Each op gets an entry node, jumps to other ops
+//are stored as flagged op offsets and resolved once all entry nodes are known
+static regex_nfa_node_t*
+_regex_nfa_build(const regex_t* regex, uint32_t* start_node, uint32_t* match_node) {
+	regex_nfa_node_t* nodes = 0;
+	uint32_t* entry = memory_allocate(HASH_STRING, sizeof(uint32_t) * (regex->code_length + 1), 0,
+	                                  MEMORY_TEMPORARY);
+	size_t op, next, i, size;
+	uint32_t inode, atom, split;
+	bool valid = true;
+
+	for (op = 0; op <= regex->code_length; ++op)
+		entry[op] = REGEX_NFA_OP;
+
+	for (op = 0; valid && (op < regex->code_length); op = next) {
+		size = _regex_op_size(regex, op);
+		next = op + size;
+		if (!size || (next > regex->code_length)) {
+			valid = false;
+			break;
+		}
+		switch (regex->code[op]) {
+		case REGEXOP_BEGIN_CAPTURE:
+		case REGEXOP_END_CAPTURE:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_EPSILON, REGEX_NFA_OP | (uint32_t)next, 0);
+			break;
+
+		case REGEXOP_BEGINNING_OF_LINE:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_BEGINNING_OF_LINE,
+			                           REGEX_NFA_OP | (uint32_t)next, 0);
+			break;
+
+		case REGEXOP_END_OF_LINE:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_END_OF_LINE, REGEX_NFA_OP | (uint32_t)next, 0);
+			break;
+
+		case REGEXOP_EXACT_MATCH:
+			if (!regex->code[op + 1]) {
+				entry[op] = _regex_nfa_add(&nodes, REGEXNFA_EPSILON, REGEX_NFA_OP | (uint32_t)next, 0);
+				break;
+			}
+			entry[op] = (uint32_t)array_size(nodes);
+			for (i = 0; i < regex->code[op + 1]; ++i) {
+				const uint8_t c = regex->code[op + 2 + i];
+				inode = _regex_nfa_add(&nodes, REGEXNFA_CHAR, (i + 1 < regex->code[op + 1]) ?
+				                       (uint32_t)array_size(nodes) + 1 : (REGEX_NFA_OP | (uint32_t)next), 0);
+				nodes[inode].set[c >> 5] |= (1U << (c & 31));
+			}
+			break;
+
+		case REGEXOP_META_MATCH:
+		case REGEXOP_ANY:
+		case REGEXOP_ANY_OF:
+		case REGEXOP_ANY_BUT:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_CHAR, REGEX_NFA_OP | (uint32_t)next, 0);
+			_regex_nfa_class(regex, op, nodes[entry[op]].set);
+			break;
+
+		case REGEXOP_ZERO_OR_MORE:
+		case REGEXOP_ZERO_OR_MORE_SHORTEST:
+			//Split between the atom looping back to the split, and the next op
+			split = _regex_nfa_add(&nodes, REGEXNFA_SPLIT, 0, REGEX_NFA_OP | (uint32_t)next);
+			atom = _regex_nfa_add(&nodes, REGEXNFA_CHAR, split, 0);
+			nodes[split].out[0] = atom;
+			_regex_nfa_class(regex, op + 1, nodes[atom].set);
+			entry[op] = split;
+			break;
+
+		case REGEXOP_ONE_OR_MORE:
+		case REGEXOP_ONE_OR_MORE_SHORTEST:
+			atom = _regex_nfa_add(&nodes, REGEXNFA_CHAR, 0, 0);
+			split = _regex_nfa_add(&nodes, REGEXNFA_SPLIT, atom, REGEX_NFA_OP | (uint32_t)next);
+			nodes[atom].out[0] = split;
+			_regex_nfa_class(regex, op + 1, nodes[atom].set);
+			entry[op] = atom;
+			break;
+
+		case REGEXOP_ZERO_OR_ONE:
+			atom = _regex_nfa_add(&nodes, REGEXNFA_CHAR, REGEX_NFA_OP | (uint32_t)next, 0);
+			_regex_nfa_class(regex, op + 1, nodes[atom].set);
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_SPLIT, atom, REGEX_NFA_OP | (uint32_t)next);
+			break;
+
+		case REGEXOP_BRANCH:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_SPLIT, REGEX_NFA_OP | (uint32_t)next,
+			                           REGEX_NFA_OP | (uint32_t)(next + regex->code[op + 1]));
+			break;
+
+		case REGEXOP_BRANCH_END:
+			entry[op] = _regex_nfa_add(&nodes, REGEXNFA_EPSILON,
+			                           REGEX_NFA_OP | (uint32_t)(next + regex->code[op + 1]), 0);
+			break;
+
+		default:
+			valid = false;
+			break;
+		}
+	}
+
+	*match_node = entry[regex->code_length] = _regex_nfa_add(&nodes, REGEXNFA_MATCH, 0, 0);
+	*start_node = entry[0];
+
+	for (inode = 0; valid && (inode < array_size(nodes)); ++inode) {
+		for (i = 0; i < 2; ++i) {
+			uint32_t out = nodes[inode].out[i];
+			if (out & REGEX_NFA_OP) {
+				out &= ~REGEX_NFA_OP;
+				if ((out > regex->code_length) || (entry[out] & REGEX_NFA_OP))
+					valid = false;
+				else
+					nodes[inode].out[i] = entry[out];
+			}
+		}
+	}
+
+	memory_deallocate(entry);
+	if (!valid) {
+		array_deallocate(nodes);
+		return 0;
+	}
+	return nodes;
+}
+
+static void
+_regex_dfa_next_generation(regex_dfa_t* dfa) {
+	if (!++dfa->generation) {
+		memset(dfa->mark, 0, sizeof(uint32_t) * dfa->num_nodes);
+		dfa->generation = 1;
+	}
+}
+
+//Mark all nodes reachable from the given node without consuming input
+static void
+_regex_dfa_closure(regex_dfa_t* dfa, uint32_t start, bool at_begin, bool at_end) {
+	size_t depth = 0;
+	dfa->stack[depth++] = start;
+	while (depth) {
+		const uint32_t inode = dfa->stack[--depth];
+		const regex_nfa_node_t* node = dfa->node + inode;
+		if (dfa->mark[inode] == dfa->generation)
+			continue;
+		dfa->mark[inode] = dfa->generation;
+		switch (node->type) {
+		case REGEXNFA_SPLIT:
+			dfa->stack[depth++] = node->out[1];
+			dfa->stack[depth++] = node->out[0];
+			break;
+		case REGEXNFA_EPSILON:
+			dfa->stack[depth++] = node->out[0];
+			break;
+		case REGEXNFA_BEGINNING_OF_LINE:
+			if (at_begin)
+				dfa->stack[depth++] = node->out[0];
+			break;
+		case REGEXNFA_END_OF_LINE:
+			if (at_end)
+				dfa->stack[depth++] = node->out[0];
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+//Collect marked character, end of line and match nodes in node order
+static size_t
+_regex_dfa_collect(regex_dfa_t* dfa, uint32_t* set) {
+	uint32_t inode;
+	size_t count = 0;
+	for (inode = 0; inode < dfa->num_nodes; ++inode) {
+		if ((dfa->mark[inode] == dfa->generation) && (dfa->node[inode].type != REGEXNFA_SPLIT) &&
+		        (dfa->node[inode].type != REGEXNFA_EPSILON) &&
+		        (dfa->node[inode].type != REGEXNFA_BEGINNING_OF_LINE))
+			set[count++] = inode;
+	}
+	return count;
+}
+
+static void
+_regex_dfa_step(regex_dfa_t* dfa, const uint32_t* set, size_t count, uint8_t c) {
+	size_t iset;
+	_regex_dfa_next_generation(dfa);
+	for (iset = 0; iset < count; ++iset) {
+		const regex_nfa_node_t* node = dfa->node + set[iset];
+		if ((node->type == REGEXNFA_CHAR) && (node->set[c >> 5] & (1U << (c & 31))))
+			_regex_dfa_closure(dfa, node->out[0], false, false);
+	}
+	//Unanchored expressions start a new match attempt at every position
+	for (iset = 0; !dfa->anchored && (iset < dfa->start_count); ++iset) {
+		const regex_nfa_node_t* node = dfa->node + dfa->start[iset];
+		if ((node->type == REGEXNFA_CHAR) && (node->set[c >> 5] & (1U << (c & 31))))
+			_regex_dfa_closure(dfa, node->out[0], false, false);
+	}
+}
+
+static bool
+_regex_dfa_match_end(regex_dfa_t* dfa, const uint32_t* set, size_t count) {
+	size_t iset;
+	_regex_dfa_next_generation(dfa);
+	for (iset = 0; iset < count; ++iset) {
+		if (dfa->node[set[iset]].type == REGEXNFA_END_OF_LINE)
+			_regex_dfa_closure(dfa, set[iset], false, true);
+	}
+	return dfa->mark[dfa->match_node] == dfa->generation;
+}
+
+//Find or add the state for the node set in the first scratch set, returns state index
+//or -1 if the state cache is full
+static int32_t
+_regex_dfa_state(regex_dfa_t* dfa, size_t count) {
+	const uint32_t* set = dfa->set[0];
+	const hash_t set_hash = hash(set, sizeof(uint32_t) * count);
+	regex_dfa_state_t* state;
+	size_t istate, iset;
+
+	for (istate = 0; istate < dfa->num_states; ++istate) {
+		state = dfa->state[istate];
+		if ((state->hash == set_hash) && (state->count == count) &&
+		        !memcmp(state->node, set, sizeof(uint32_t) * count))
+			return (int32_t)istate;
+	}
+	if (dfa->num_states >= REGEX_DFA_MAX_STATES)
+		return -1;
+
+	state = memory_allocate(HASH_STRING, sizeof(regex_dfa_state_t) + (sizeof(uint32_t) * count), 0,
+	                        MEMORY_PERSISTENT);
+	for (iset = 0; iset < 256; ++iset)
+		atomic_store32_explicit(&state->next[iset], -1, MEMORY_ORDER_RELAXED);
+	state->hash = set_hash;
+	state->count = count;
+	memcpy(state->node, set, sizeof(uint32_t) * count);
+	state->match = false;
+	for (iset = 0; iset < count; ++iset)
+		state->match |= (set[iset] == dfa->match_node);
+	state->match_end = state->match || _regex_dfa_match_end(dfa, set, count);
+	state->dead = dfa->anchored && !count;
+
+	dfa->state[dfa->num_states] = state;
+	return (int32_t)(dfa->num_states++);
+}
+
+static int32_t
+_regex_dfa_transition(regex_dfa_t* dfa, regex_dfa_state_t* state, uint8_t c) {
+	int32_t next;
+	lock_lock(&dfa->lock);
+	next = atomic_load32_explicit(&state->next[c], MEMORY_ORDER_RELAXED);
+	if (next < 0) {
+		_regex_dfa_step(dfa, state->node, state->count, c);
+		next = _regex_dfa_state(dfa, _regex_dfa_collect(dfa, dfa->set[0]));
+		if (next >= 0)
+			atomic_store32_explicit(&state->next[c], next, MEMORY_ORDER_RELEASE);
+	}
+	lock_unlock(&dfa->lock);
+	return next;
+}
+
+//Continue matching by direct NFA simulation when the state cache is full, still linear time
+static bool
+_regex_dfa_simulate(regex_dfa_t* dfa, const regex_dfa_state_t* state, const uint8_t* input,
+                    size_t inlength) {
+	size_t iin, iset, count;
+	bool matched = false;
+	uint32_t* current;
+
+	lock_lock(&dfa->lock);
+	current = dfa->set[1];
+	count = state->count;
+	memcpy(current, state->node, sizeof(uint32_t) * count);
+	for (iin = 0; iin < inlength; ++iin) {
+		_regex_dfa_step(dfa, current, count, input[iin]);
+		count = _regex_dfa_collect(dfa, current);
+		if (dfa->mark[dfa->match_node] == dfa->generation) {
+			matched = true;
+			break;
+		}
+		if (dfa->anchored && !count)
+			break;
+	}
+	if (iin == inlength) {
+		for (iset = 0; iset < count; ++iset)
+			matched |= (current[iset] == dfa->match_node);
+		matched = matched || _regex_dfa_match_end(dfa, current, count);
+	}
+	lock_unlock(&dfa->lock);
+
+	return matched;
+}
+
+static bool
+_regex_dfa_match(regex_dfa_t* dfa, const char* input, size_t inlength) {
+	const uint8_t* in = (const uint8_t*)input;
+	const regex_dfa_state_t* state = dfa->initial;
+	size_t iin;
+
+	//Unanchored expressions are attempted at each position before the end of input
+	if (!dfa->anchored) {
+		if (!inlength)
+			return false;
+		if (dfa->empty_match)
+			return true;
+	}
+	if (state->match)
+		return true;
+
+	for (iin = 0; iin < inlength; ++iin) {
+		int32_t next = atomic_load32_explicit(&state->next[in[iin]], MEMORY_ORDER_ACQUIRE);
+		if (next < 0) {
+			next = _regex_dfa_transition(dfa, (regex_dfa_state_t*)state, in[iin]);
+			if (next < 0)
+				return _regex_dfa_simulate(dfa, state, in + iin, inlength - iin);
+		}
+		state = dfa->state[next];
+		if (state->match)
+			return true;
+		if (state->dead)
+			return false;
+	}
+
+	return state->match_end;
+}
+
+static void
+_regex_dfa_deallocate(regex_dfa_t* dfa) {
+	size_t istate;
+	if (!dfa)
+		return;
+	for (istate = 0; istate < dfa->num_states; ++istate)
+		memory_deallocate(dfa->state[istate]);
+	memory_deallocate(dfa->mark);
+	array_deallocate(dfa->node);
+	memory_deallocate(dfa);
+}
+
+static regex_dfa_t*
+_regex_dfa_allocate(const regex_t* regex) {
+	regex_dfa_t* dfa;
+	uint32_t start_node, match_node;
+	size_t count;
+	int32_t initial;
+	regex_nfa_node_t* nodes = _regex_nfa_build(regex, &start_node, &match_node);
+	if (!nodes)
+		return 0;
+
+	dfa = memory_allocate(HASH_STRING, sizeof(regex_dfa_t), 0,
+	                      MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	lock_initialize(&dfa->lock);
+	dfa->node = nodes;
+	dfa->num_nodes = (uint32_t)array_size(nodes);
+	dfa->start_node = start_node;
+	dfa->match_node = match_node;
+	dfa->anchored = (regex->code[0] == REGEXOP_BEGINNING_OF_LINE);
+
+	//Marks, closure stack, two scratch sets and the start set in a single block
+	dfa->mark = memory_allocate(HASH_STRING, sizeof(uint32_t) * dfa->num_nodes * 8, 0,
+	                            MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	dfa->stack = dfa->mark + dfa->num_nodes;
+	dfa->set[0] = dfa->stack + (dfa->num_nodes * 3);
+	dfa->set[1] = dfa->set[0] + dfa->num_nodes;
+	dfa->start = dfa->set[1] + dfa->num_nodes;
+
+	//Start set for attempts after the first position, where beginning of line fails
+	_regex_dfa_next_generation(dfa);
+	_regex_dfa_closure(dfa, start_node, false, false);
+	dfa->start_count = _regex_dfa_collect(dfa, dfa->start);
+	dfa->empty_match = (dfa->mark[match_node] == dfa->generation);
+
+	_regex_dfa_next_generation(dfa);
+	_regex_dfa_closure(dfa, start_node, true, false);
+	count = _regex_dfa_collect(dfa, dfa->set[0]);
+	initial = _regex_dfa_state(dfa, count);
+	dfa->initial = dfa->state[initial];
+
+	return dfa;
+}
+
+//Find the longest literal in the sequence of ops every match passes through, which ends at
+//the first branch. Zero width ops keep the literal a prefix, other consuming ops do not
+static void
+_regex_find_literal(regex_t* regex) {
+	size_t op, size;
+	bool prefix = true;
+
+	regex->literal_offset = 0;
+	regex->literal_length = 0;
+	regex->literal_prefix = false;
+
+	for (op = 0; op < regex->code_length; op += size) {
+		size = _regex_op_size(regex, op);
+		if (!size || (op + size > regex->code_length))
+			break;
+		switch (regex->code[op]) {
+		case REGEXOP_BEGIN_CAPTURE:
+		case REGEXOP_END_CAPTURE:
+		case REGEXOP_BEGINNING_OF_LINE:
+		case REGEXOP_END_OF_LINE:
+			continue;
+
+		case REGEXOP_EXACT_MATCH:
+			if (regex->code[op + 1] > regex->literal_length) {
+				regex->literal_offset = op + 2;
+				regex->literal_length = regex->code[op + 1];
+				regex->literal_prefix = prefix;
+			}
+			prefix = false;
+			continue;
+
+		case REGEXOP_BRANCH:
+		case REGEXOP_BRANCH_END:
+			break;
+
+		default:
+			prefix = false;
+			continue;
+		}
+		break;
+	}
+}
+
 regex_t*
 regex_compile(const char* pattern, size_t pattern_length) {
 	regex_t* compiled;
@@ -735,48 +1336,438 @@ regex_compile(const char* pattern, size_t pattern_length) {
 	compiled->num_captures = 0;
 	compiled->code_length = 0;
 	compiled->code_allocated = pattern_length + 16;
+	compiled->dfa = 0;
 
-	if (_regex_parse(&compiled, pattern, 0, pattern_length, true, 0) == pattern_length)
+	if (_regex_parse(&compiled, pattern, 0, pattern_length, true, 0) == pattern_length) {
+		_regex_find_literal(compiled);
 		return compiled;
+	}
 
 	memory_deallocate(compiled);
 	return 0;
 }
 
+regex_t*
+regex_compile_dfa(const char* pattern, size_t pattern_length) {
+	regex_t* compiled = regex_compile(pattern, pattern_length);
+	if (compiled && compiled->code_length)
+		compiled->dfa = _regex_dfa_allocate(compiled);
+	return compiled;
+}
+
 bool
 regex_parse(regex_t* regex, const char* pattern, size_t pattern_length) {
 	regex_t* result = regex;
-	return (_regex_parse(&result, pattern, 0, pattern_length, false, 0) == pattern_length);
+	if (_regex_parse(&result, pattern, 0, pattern_length, false, 0) != pattern_length)
+		return false;
+	_regex_find_literal(regex);
+	return true;
 }
 
 bool
 regex_match(regex_t* regex, const char* input, size_t inlength, string_const_t* captures,
             size_t maxcaptures) {
+	const char* literal;
 	size_t iin;
 
 	if (!regex || !regex->code_length)
 		return true;
 
+	//Reject input not containing the required literal, and find the first possible match start
+	literal = (const char*)regex->code + regex->literal_offset;
+	iin = 0;
+	if (regex->literal_length) {
+		iin = string_find_string(input, inlength, literal, regex->literal_length, 0);
+		if (iin == STRING_NPOS)
+			return false;
+		if (!regex->literal_prefix)
+			iin = 0;
+	}
+
+	if (regex->dfa && (!captures || !maxcaptures))
+		return _regex_dfa_match(regex->dfa, input, inlength);
+
 	if (regex->code[0] == REGEXOP_BEGINNING_OF_LINE) {
 		regex_context_t context = _regex_execute(regex, 0, input, 0, inlength, captures, maxcaptures);
 		if (context.inoffset <= inlength)
 			return true;
 	}
 	else {
-		for (iin = 0; iin < inlength; ++iin) {
+		while (iin < inlength) {
 			regex_context_t context = _regex_execute(regex, 0, input, iin, inlength, captures, maxcaptures);
 			if (context.inoffset <= inlength)
 				return true;
 			if (context.inoffset == (size_t)REGEXRES_INTERNAL_FAILURE)
 				return false;
+			//Matches starting with a literal can only start where the literal occurs
+			if (regex->literal_prefix)
+				iin = string_find_string(input, inlength, literal, regex->literal_length, iin + 1);
+			else
+				++iin;
 		}
 	}
 
 	return false;
 }
 
+//Find the first match starting at or after the given offset. Returns the match start and
+//stores the match end, or STRING_NPOS if no match. If more input can follow, the search stops at
+//the first attempt depending on the end of the input, returning the offset to resume from with
+//the match end set to STRING_NPOS
+static size_t
+_regex_search(regex_t* regex, const char* input, size_t inlength, size_t offset, bool more,
+              string_const_t* captures, size_t maxcaptures, size_t* end) {
+	const char* literal = (const char*)regex->code + regex->literal_offset;
+	bool anchored = (regex->code[0] == REGEXOP_BEGINNING_OF_LINE);
+	regex_context_t context;
+	size_t iin = offset;
+
+	*end = STRING_NPOS;
+	if (anchored && offset)
+		return STRING_NPOS;
+
+	while (anchored || (iin < inlength)) {
+		//Matches starting with a literal can only start where the literal occurs
+		if (regex->literal_prefix) {
+			size_t next = string_find_string(input, inlength, literal, regex->literal_length, iin);
+			if (next == STRING_NPOS) {
+				if (!more)
+					return STRING_NPOS;
+				//Keep the tail which might be the start of a literal split by the end of input
+				if (inlength - iin >= regex->literal_length)
+					iin = inlength - regex->literal_length + 1;
+				return iin;
+			}
+			iin = next;
+		}
+
+		if (more)
+			set_thread_regex_end(0);
+		context = _regex_execute(regex, 0, input, iin, inlength, captures, maxcaptures);
+		if (more && get_thread_regex_end())
+			return iin;
+		if (context.inoffset <= inlength) {
+			*end = context.inoffset;
+			return iin;
+		}
+		if (anchored || (context.inoffset == (size_t)REGEXRES_INTERNAL_FAILURE))
+			break;
+		++iin;
+	}
+
+	return STRING_NPOS;
+}
+
+size_t
+regex_match_all(regex_t* regex, const char* input, size_t inlength, string_const_t* captures,
+                size_t maxcaptures, regex_match_fn callback, void* arg) {
+	size_t offset = 0;
+	size_t count = 0;
+	size_t start, end;
+
+	if (!regex || !regex->code_length)
+		return 0;
+
+	if (regex->literal_length && !regex->literal_prefix &&
+	        (string_find_string(input, inlength, (const char*)regex->code + regex->literal_offset,
+	                            regex->literal_length, 0) == STRING_NPOS))
+		return 0;
+
+	while (offset <= inlength) {
+		start = _regex_search(regex, input, inlength, offset, false, captures, maxcaptures, &end);
+		if (start == STRING_NPOS)
+			break;
+		++count;
+		if (callback && !callback(start, string_const(input + start, end - start), captures,
+		                          maxcaptures, arg))
+			break;
+		//Continue after the match, an empty match advances one character to make progress
+		offset = (end > start) ? end : start + 1;
+	}
+
+	return count;
+}
+
+//Match each line of the buffer, returning the offset of the first incomplete line
+static size_t
+_regex_match_lines(regex_t* regex, const char* buffer, size_t size, size_t base, bool last,
+                   string_const_t* captures, size_t maxcaptures, regex_match_fn callback,
+                   void* arg, size_t* count, bool* stop) {
+	const char* literal = (const char*)regex->code + regex->literal_offset;
+	size_t offset = 0;
+	while (!*stop && (offset < size)) {
+		size_t line_end = string_find(buffer, size, '\n', offset);
+		size_t next, start, end, length;
+		if (line_end == STRING_NPOS) {
+			if (!last)
+				break;
+			line_end = size;
+		}
+		next = line_end + 1;
+		if ((line_end > offset) && (buffer[line_end - 1] == '\r'))
+			--line_end;
+
+		length = line_end - offset;
+		start = 0;
+		if (regex->literal_length && !regex->literal_prefix &&
+		        (string_find_string(buffer + offset, length, literal, regex->literal_length, 0) ==
+		         STRING_NPOS))
+			start = STRING_NPOS;
+		while (start <= length) {
+			start = _regex_search(regex, buffer + offset, length, start, false, captures, maxcaptures,
+			                      &end);
+			if (start == STRING_NPOS)
+				break;
+			++(*count);
+			if (callback && !callback(base + offset + start,
+			                          string_const(buffer + offset + start, end - start), captures,
+			                          maxcaptures, arg)) {
+				*stop = true;
+				break;
+			}
+			start = (end > start) ? end : start + 1;
+		}
+		offset = next;
+	}
+	return offset;
+}
+
+//Match the buffer as contiguous input, returning the offset of the first byte still needed
+static size_t
+_regex_match_buffer(regex_t* regex, const char* buffer, size_t size, size_t offset, size_t base,
+                    bool last, string_const_t* captures, size_t maxcaptures,
+                    regex_match_fn callback, void* arg, size_t* count, bool* stop) {
+	size_t start, end;
+	//Beginning of line only matches at the start of the stream, never at a later buffer start
+	if (base && (regex->code[0] == REGEXOP_BEGINNING_OF_LINE))
+		return size;
+	while (!*stop && (offset <= size)) {
+		start = _regex_search(regex, buffer, size, offset, !last, captures, maxcaptures, &end);
+		if (start == STRING_NPOS)
+			return size;
+		if (end == STRING_NPOS)
+			return start;
+		++(*count);
+		if (callback && !callback(base + start, string_const(buffer + start, end - start), captures,
+		                          maxcaptures, arg))
+			*stop = true;
+		offset = (end > start) ? end : start + 1;
+	}
+	return offset;
+}
+
+size_t
+regex_match_stream(regex_t* regex, stream_t* stream, bool lines, string_const_t* captures,
+                   size_t maxcaptures, regex_match_fn callback, void* arg) {
+	size_t capacity = REGEX_STREAM_BUFFER_SIZE;
+	char* buffer;
+	size_t size = 0;
+	size_t offset = 0;
+	size_t base = 0;
+	size_t count = 0;
+	size_t keep;
+	bool last = false;
+	bool stop = false;
+
+	if (!regex || !regex->code_length || !stream)
+		return 0;
+
+	//One extra byte as matching might peek at the byte past the end of the input
+	buffer = memory_allocate(HASH_STRING, capacity + 1, 0, MEMORY_PERSISTENT);
+
+	while (!stop && !last) {
+		//Discard consumed input, keeping the byte preceding the resume offset so that a match
+		//attempt never starts at the buffer start unless at the start of the stream
+		keep = offset;
+		if (!lines && keep)
+			--keep;
+		if (keep) {
+			memmove(buffer, buffer + keep, size - keep);
+			size -= keep;
+			offset -= keep;
+			base += keep;
+		}
+		else if (size == capacity) {
+			capacity *= 2;
+			buffer = memory_reallocate(buffer, capacity + 1, 0, size + 1);
+		}
+
+		while ((size < capacity) && !stream_eos(stream)) {
+			size_t read = stream_read(stream, buffer + size, capacity - size);
+			if (!read)
+				break;
+			size += read;
+		}
+		last = stream_eos(stream) || (size < capacity);
+		buffer[size] = 0;
+
+		if (lines)
+			offset = _regex_match_lines(regex, buffer + offset, size - offset, base + offset, last,
+			                            captures, maxcaptures, callback, arg, &count, &stop) + offset;
+		else
+			offset = _regex_match_buffer(regex, buffer, size, offset, base, last, captures,
+			                             maxcaptures, callback, arg, &count, &stop);
+	}
+
+	memory_deallocate(buffer);
+
+	return count;
+}
+
 void
 regex_deallocate(regex_t* regex) {
+	if (regex)
+		_regex_dfa_deallocate(regex->dfa);
 	memory_deallocate(regex);
 }
 
+static FOUNDATION_FORCEINLINE regex_t*
+_regex_cache_regex(regex_cache_entry_t* entry) {
+	return pointer_offset(entry, REGEX_CACHE_HEADER_SIZE);
+}
+
+static FOUNDATION_FORCEINLINE regex_cache_entry_t*
+_regex_cache_entry(regex_t* regex) {
+	return pointer_offset(regex, -(ssize_t)REGEX_CACHE_HEADER_SIZE);
+}
+
+static void
+_regex_cache_unref(regex_cache_entry_t* entry) {
+	if (!atomic_decr32(&entry->ref)) {
+		_regex_dfa_deallocate(_regex_cache_regex(entry)->dfa);
+		memory_deallocate(entry);
+	}
+}
+
+//Copy a compiled expression into a block with the cache entry header and the pattern
+static regex_cache_entry_t*
+_regex_cache_allocate(regex_t* compiled, hash_t hash, const char* pattern, size_t length) {
+	size_t regex_size = sizeof(regex_t) + compiled->code_length;
+	regex_cache_entry_t* entry = memory_allocate(HASH_STRING,
+	                                             REGEX_CACHE_HEADER_SIZE + regex_size + length + 1,
+	                                             0, MEMORY_PERSISTENT);
+	regex_t* regex = _regex_cache_regex(entry);
+	char* pattern_copy = pointer_offset(regex, regex_size);
+
+	memcpy(regex, compiled, regex_size);
+	regex->code_allocated = regex->code_length;
+	memcpy(pattern_copy, pattern, length);
+	pattern_copy[length] = 0;
+
+	entry->hash = hash;
+	atomic_store32(&entry->ref, 1);
+	entry->last_use = 0;
+	entry->pattern = pattern_copy;
+	entry->pattern_length = length;
+
+	//Ownership of the DFA moved to the cached copy
+	compiled->dfa = 0;
+	return entry;
+}
+
+//Find the entry for the pattern and mark it as used, must be called with cache locked
+static regex_cache_entry_t*
+_regex_cache_lookup(hash_t hash, const char* pattern, size_t length) {
+	size_t ientry;
+	for (ientry = 0; ientry < _regex_cache_count; ++ientry) {
+		if (_regex_cache_hash[ientry] == hash) {
+			regex_cache_entry_t* entry = _regex_cache[ientry];
+			if (string_equal(entry->pattern, entry->pattern_length, pattern, length)) {
+				entry->last_use = ++_regex_cache_tick;
+				atomic_incr32(&entry->ref);
+				return entry;
+			}
+		}
+	}
+	return 0;
+}
+
+regex_t*
+regex_cache_acquire(const char* pattern, size_t length) {
+	hash_t key = hash(pattern, length);
+	regex_cache_entry_t* entry;
+	regex_cache_entry_t* evict = 0;
+	regex_t* compiled;
+	size_t ientry, slot;
+
+	if (!_regex_cache)
+		return 0;
+
+	lock_lock(&_regex_cache_lock);
+	entry = _regex_cache_lookup(key, pattern, length);
+	lock_unlock(&_regex_cache_lock);
+	if (entry)
+		return _regex_cache_regex(entry);
+
+	//Compile outside the lock, another thread might insert the same pattern meanwhile
+	compiled = regex_compile_dfa(pattern, length);
+	if (!compiled)
+		return 0;
+	entry = _regex_cache_allocate(compiled, key, pattern, length);
+	regex_deallocate(compiled);
+
+	lock_lock(&_regex_cache_lock);
+	{
+		regex_cache_entry_t* existing = _regex_cache_lookup(key, pattern, length);
+		if (existing) {
+			lock_unlock(&_regex_cache_lock);
+			_regex_cache_unref(entry);
+			return _regex_cache_regex(existing);
+		}
+	}
+
+	//Evict the least recently used entry if full, the expression is freed once released by
+	//all users still holding it
+	if (_regex_cache_count < _foundation_config.regex_cache_size) {
+		slot = _regex_cache_count++;
+	}
+	else {
+		slot = 0;
+		for (ientry = 1; ientry < _regex_cache_count; ++ientry) {
+			if (_regex_cache[ientry]->last_use < _regex_cache[slot]->last_use)
+				slot = ientry;
+		}
+		evict = _regex_cache[slot];
+	}
+	entry->last_use = ++_regex_cache_tick;
+	atomic_incr32(&entry->ref);
+	_regex_cache[slot] = entry;
+	_regex_cache_hash[slot] = key;
+	lock_unlock(&_regex_cache_lock);
+
+	if (evict)
+		_regex_cache_unref(evict);
+
+	return _regex_cache_regex(entry);
+}
+
+void
+regex_cache_release(regex_t* regex) {
+	if (regex)
+		_regex_cache_unref(_regex_cache_entry(regex));
+}
+
+int
+_regex_initialize(void) {
+	lock_initialize(&_regex_cache_lock);
+	_regex_cache = memory_allocate(0, sizeof(regex_cache_entry_t*) * _foundation_config.regex_cache_size,
+	                               0, MEMORY_PERSISTENT);
+	_regex_cache_hash = memory_allocate(0, sizeof(hash_t) * _foundation_config.regex_cache_size, 0,
+	                                    MEMORY_PERSISTENT);
+	_regex_cache_count = 0;
+	_regex_cache_tick = 0;
+	return 0;
+}
+
+void
+_regex_finalize(void) {
+	size_t ientry;
+	for (ientry = 0; ientry < _regex_cache_count; ++ientry)
+		_regex_cache_unref(_regex_cache[ientry]);
+	memory_deallocate(_regex_cache);
+	memory_deallocate(_regex_cache_hash);
+	_regex_cache = 0;
+	_regex_cache_hash = 0;
+	_regex_cache_count = 0;
+}
+
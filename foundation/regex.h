@@ -35,7 +35,13 @@ Small regular expression implementation matching a subset of Perl regular expres
     ?        Match zero or once
     \\XX      Match byte with hex value 0xXX (must be two hex digits)
     \\meta    Match one of the meta characters ^$()[].*+?|\
-</pre> */
+</pre>
+
+Expressions are matched by a backtracking interpreter of the compiled code, which takes
+exponential time in the worst case. Expressions compiled with #regex_compile_dfa additionally
+match without captures on a lazily constructed DFA (Thompson NFA with cached DFA states),
+guaranteeing time linear in the input length. DFA states are built on demand and shared
+between threads matching the same expression. */
 
 #include <foundation/platform.h>
 
@@ -46,6 +52,32 @@ Small regular expression implementation matching a subset of Perl regular expres
 FOUNDATION_API regex_t*
 regex_compile(const char* pattern, size_t length);
 
+/*! Compile (allocate and parse) a regular expression and construct the NFA for DFA matching.
+Matching without captures (null capture array or zero max captures) runs in linear time,
+matching with captures uses the backtracking interpreter.
+\param pattern Pattern string
+\param length Length of pattern string
+\return Compiled expression, null if error */
+FOUNDATION_API regex_t*
+regex_compile_dfa(const char* pattern, size_t length);
+
+/*! Get a compiled expression for the pattern from the expression cache, compiling it with
+#regex_compile_dfa and adding it to the cache if not present. Cached expressions are shared
+read-only between all callers and threads and must be released with #regex_cache_release,
+never deallocated with #regex_deallocate. The cache holds at most
+foundation_config_t::regex_cache_size expressions, evicting the least recently used. An
+evicted expression stays valid until released by all callers holding it.
+\param pattern Pattern string
+\param length Length of pattern string
+\return Compiled expression, null if error */
+FOUNDATION_API regex_t*
+regex_cache_acquire(const char* pattern, size_t length);
+
+/*! Release a compiled expression acquired with #regex_cache_acquire
+\param regex Compiled expression */
+FOUNDATION_API void
+regex_cache_release(regex_t* regex);
+
 /*! Compile (parse) a regular expression into a predefined expression buffer
 \param regex Predefined expression buffer
 \param pattern Pattern string
@@ -67,6 +99,39 @@ FOUNDATION_API bool
 regex_match(regex_t* regex, const char* input, size_t inlength, string_const_t* captures,
             size_t maxcaptures);
 
+/*! Find all non-overlapping matches in input string, calling the callback with the span and
+captures of each match in order. Matching continues after the end of each match, or one
+character past an empty match.
+\param regex Compiled expression
+\param input Input string
+\param inlength Length of input string
+\param captures Capture array passed to callback, null if not wanted
+\param maxcaptures Maximum number of captures
+\param callback Callback for each match, null if only counting matches
+\param arg Argument passed to callback
+\return Number of matches found */
+FOUNDATION_API size_t
+regex_match_all(regex_t* regex, const char* input, size_t inlength, string_const_t* captures,
+                size_t maxcaptures, regex_match_fn callback, void* arg);
+
+/*! Find all non-overlapping matches in stream content from the current position, reading the
+stream in chunks instead of loading it in memory. Match offsets are relative to the position
+where reading started. In line mode each line (without the terminating newline or carriage
+return and newline pair) is matched as a separate input string, which bounds buffered memory
+to the longest line. Otherwise the content is matched as one input string and partial match
+attempts are carried across chunk boundaries, buffering as much input as an attempt examines.
+\param regex Compiled expression
+\param stream Input stream
+\param lines Match each line separately if true, content as a whole if false
+\param captures Capture array passed to callback, null if not wanted
+\param maxcaptures Maximum number of captures
+\param callback Callback for each match, null if only counting matches
+\param arg Argument passed to callback
+\return Number of matches found */
+FOUNDATION_API size_t
+regex_match_stream(regex_t* regex, stream_t* stream, bool lines, string_const_t* captures,
+                   size_t maxcaptures, regex_match_fn callback, void* arg);
+
 /*! Free a compiled expression
 \param regex Compiled expression */
 FOUNDATION_API void
@@ -13,7 +13,34 @@
 #include <foundation/foundation.h>
 #include <foundation/internal.h>
 
-#define RINGBUFFER_FROM_STREAM( stream ) ((ringbuffer_t*)&stream->total_read)
+#if FOUNDATION_PLATFORM_WINDOWS
+#  include <foundation/windows.h>
+#elif FOUNDATION_PLATFORM_POSIX
+#  include <foundation/posix.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+#    include <sys/syscall.h>
+#  endif
+#  ifndef MAP_ANONYMOUS
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+#endif
+
+#if FOUNDATION_PLATFORM_WINDOWS || \
+    (FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_ANDROID && !FOUNDATION_PLATFORM_IOS)
+#  define RINGBUFFER_HAS_SHARED_STREAM 1
+#else
+#  define RINGBUFFER_HAS_SHARED_STREAM 0
+#endif
+
+//Shared streams keep the ring buffer and wait flags in the shared memory block
+#define RINGBUFFER_FROM_STREAM( stream ) ((stream)->shared ? \
+	(ringbuffer_spsc_t*)&(stream)->shared->total_write : (ringbuffer_spsc_t*)&(stream)->total_write)
+#define PENDING_READ_FROM_STREAM( stream ) ((stream)->shared ? \
+	&(stream)->shared->pending_read : &(stream)->pending_read)
+#define PENDING_WRITE_FROM_STREAM( stream ) ((stream)->shared ? \
+	&(stream)->shared->pending_write : &(stream)->pending_write)
 
 static stream_vtable_t _ringbuffer_stream_vtable;
 
@@ -156,61 +183,552 @@ ringbuffer_total_written(ringbuffer_t* buffer) {
 	return buffer->total_write;
 }
 
-static size_t
-_ringbuffer_stream_read(stream_t* stream, void* dest, size_t num) {
-	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
-	ringbuffer_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
+ringbuffer_spsc_t*
+ringbuffer_spsc_allocate(size_t size) {
+	ringbuffer_spsc_t* buffer = memory_allocate(0, sizeof(ringbuffer_spsc_t) + size, 64,
+	                                            MEMORY_PERSISTENT);
 
-	size_t num_read = ringbuffer_read(buffer, dest, num);
+	ringbuffer_spsc_initialize(buffer, size);
 
-	while (num_read < num) {
-		rbstream->pending_read = 1;
+	return buffer;
+}
+
+void
+ringbuffer_spsc_initialize(ringbuffer_spsc_t* buffer, size_t size) {
+	atomic_store64(&buffer->total_write, 0);
+	atomic_store64(&buffer->total_read, 0);
+	buffer->cached_read = 0;
+	buffer->cached_write = 0;
+	buffer->buffer_size = size;
+}
+
+void
+ringbuffer_spsc_deallocate(ringbuffer_spsc_t* buffer) {
+	ringbuffer_spsc_finalize(buffer);
+	memory_deallocate(buffer);
+}
+
+void
+ringbuffer_spsc_finalize(ringbuffer_spsc_t* buffer) {
+	FOUNDATION_UNUSED(buffer);
+}
+
+size_t
+ringbuffer_spsc_size(ringbuffer_spsc_t* buffer) {
+	return buffer->buffer_size;
+}
+
+void*
+ringbuffer_spsc_write_reserve(ringbuffer_spsc_t* buffer, size_t* num) {
+	uint64_t total_write = (uint64_t)atomic_load64(&buffer->total_write);
+	size_t buffer_size = buffer->buffer_size;
+	size_t available, offset;
+
+	if (!buffer_size) {
+		*num = 0;
+		return buffer->buffer;
+	}
+
+	//Only refresh the consumer position when cached position is not enough
+	available = buffer_size - (size_t)(total_write - buffer->cached_read);
+	if (available < *num) {
+		buffer->cached_read = (uint64_t)atomic_load64(&buffer->total_read);
+		atomic_thread_fence_acquire();
+		available = buffer_size - (size_t)(total_write - buffer->cached_read);
+	}
+
+	offset = (size_t)(total_write % buffer_size);
+	if (available > buffer_size - offset)
+		available = buffer_size - offset;
+	if (*num > available)
+		*num = available;
+
+	return buffer->buffer + offset;
+}
 
-		if (rbstream->pending_write)
-			semaphore_post(&rbstream->signal_read);
+void
+ringbuffer_spsc_write_commit(ringbuffer_spsc_t* buffer, size_t num) {
+	uint64_t total_write = (uint64_t)atomic_load64(&buffer->total_write);
+	atomic_thread_fence_release();
+	atomic_store64(&buffer->total_write, (int64_t)(total_write + num));
+}
 
-		semaphore_wait(&rbstream->signal_write);
-		rbstream->pending_read = 0;
+const void*
+ringbuffer_spsc_read_reserve(ringbuffer_spsc_t* buffer, size_t* num) {
+	uint64_t total_read = (uint64_t)atomic_load64(&buffer->total_read);
+	size_t buffer_size = buffer->buffer_size;
+	size_t available, offset;
+
+	if (!buffer_size) {
+		*num = 0;
+		return buffer->buffer;
+	}
 
-		num_read += ringbuffer_read(buffer, dest ? pointer_offset(dest, num_read) : 0, num - num_read);
+	//Only refresh the producer position when cached position is not enough
+	available = (size_t)(buffer->cached_write - total_read);
+	if (available < *num) {
+		buffer->cached_write = (uint64_t)atomic_load64(&buffer->total_write);
+		atomic_thread_fence_acquire();
+		available = (size_t)(buffer->cached_write - total_read);
 	}
 
-	if (rbstream->pending_write)
-		semaphore_post(&rbstream->signal_read);
+	offset = (size_t)(total_read % buffer_size);
+	if (available > buffer_size - offset)
+		available = buffer_size - offset;
+	if (*num > available)
+		*num = available;
+
+	return buffer->buffer + offset;
+}
+
+void
+ringbuffer_spsc_read_commit(ringbuffer_spsc_t* buffer, size_t num) {
+	uint64_t total_read = (uint64_t)atomic_load64(&buffer->total_read);
+	atomic_thread_fence_release();
+	atomic_store64(&buffer->total_read, (int64_t)(total_read + num));
+}
+
+size_t
+ringbuffer_spsc_read(ringbuffer_spsc_t* buffer, void* dest, size_t num) {
+	size_t num_read = 0;
+
+	//At most two iterations, before and after wrapping around end of buffer
+	while (num_read < num) {
+		size_t do_read = num - num_read;
+		const void* source = ringbuffer_spsc_read_reserve(buffer, &do_read);
+		if (!do_read)
+			break;
+		if (dest)
+			memcpy(pointer_offset(dest, num_read), source, do_read);
+		ringbuffer_spsc_read_commit(buffer, do_read);
+		num_read += do_read;
+	}
 
 	return num_read;
 }
 
+size_t
+ringbuffer_spsc_write(ringbuffer_spsc_t* buffer, const void* source, size_t num) {
+	size_t num_write = 0;
+
+	//At most two iterations, before and after wrapping around end of buffer
+	while (num_write < num) {
+		size_t do_write = num - num_write;
+		void* dest = ringbuffer_spsc_write_reserve(buffer, &do_write);
+		if (!do_write)
+			break;
+		memcpy(dest, pointer_offset_const(source, num_write), do_write);
+		ringbuffer_spsc_write_commit(buffer, do_write);
+		num_write += do_write;
+	}
+
+	return num_write;
+}
+
+size_t
+ringbuffer_spsc_available_read(ringbuffer_spsc_t* buffer) {
+	return (size_t)((uint64_t)atomic_load64(&buffer->total_write) -
+	                (uint64_t)atomic_load64(&buffer->total_read));
+}
+
+size_t
+ringbuffer_spsc_available_write(ringbuffer_spsc_t* buffer) {
+	return buffer->buffer_size - ringbuffer_spsc_available_read(buffer);
+}
+
+uint64_t
+ringbuffer_spsc_total_read(ringbuffer_spsc_t* buffer) {
+	return (uint64_t)atomic_load64(&buffer->total_read);
+}
+
+uint64_t
+ringbuffer_spsc_total_written(ringbuffer_spsc_t* buffer) {
+	return (uint64_t)atomic_load64(&buffer->total_write);
+}
+
 static size_t
-_ringbuffer_stream_write(stream_t* stream, const void* source, size_t num) {
+_ringbuffer_mirror_granularity(void) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	return system_info.dwAllocationGranularity;
+#elif FOUNDATION_PLATFORM_POSIX
+	long page_size = sysconf(_SC_PAGESIZE);
+	return (page_size > 0) ? (size_t)page_size : 4096;
+#else
+	return 4096;
+#endif
+}
+
+//Map the same physical pages at two consecutive virtual address ranges
+static char*
+_ringbuffer_mirror_map(size_t size) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	char* base = 0;
+	int attempt;
+	HANDLE section = CreateFileMappingW(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+	                                    (DWORD)((uint64_t)size >> 32ULL), (DWORD)size, 0);
+	if (!section)
+		return 0;
+	//Find a free address range of twice the size and map both views into it, retrying
+	//if another thread grabbed the range between releasing the reservation and mapping
+	for (attempt = 0; !base && (attempt < 16); ++attempt) {
+		char* address = VirtualAlloc(0, size * 2, MEM_RESERVE, PAGE_NOACCESS);
+		if (!address)
+			break;
+		VirtualFree(address, 0, MEM_RELEASE);
+		if (MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, size, address) != address)
+			continue;
+		if (MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, size, address + size) != address + size) {
+			UnmapViewOfFile(address);
+			continue;
+		}
+		base = address;
+	}
+	//Views keep the section alive until unmapped
+	CloseHandle(section);
+	return base;
+#elif FOUNDATION_PLATFORM_POSIX
+	char* base;
+	int fd = -1;
+#  if defined(SYS_memfd_create)
+	fd = (int)syscall(SYS_memfd_create, "foundation_ringbuffer", 1U /*MFD_CLOEXEC*/);
+#  elif !FOUNDATION_PLATFORM_ANDROID
+	static atomic32_t counter;
+	char name[64];
+	string_t shmname = string_format(name, sizeof(name), STRING_CONST("/foundation_ringbuffer_%d_%d"),
+	                                 (int)getpid(), (int)atomic_incr32(&counter));
+	fd = shm_open(shmname.str, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd >= 0)
+		shm_unlink(shmname.str);
+#  endif
+	if (fd < 0)
+		return 0;
+	base = 0;
+	if (ftruncate(fd, (off_t)size) == 0) {
+		void* address = mmap(0, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (address != MAP_FAILED) {
+			//Fixed mappings replace the reserved range in place
+			if ((mmap(address, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == address) &&
+			    (mmap(pointer_offset(address, size), size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+			          fd, 0) == pointer_offset(address, size)))
+				base = address;
+			else
+				munmap(address, size * 2);
+		}
+	}
+	close(fd);
+	return base;
+#else
+	FOUNDATION_UNUSED(size);
+	return 0;
+#endif
+}
+
+static void
+_ringbuffer_mirror_unmap(char* base, size_t size) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	UnmapViewOfFile(base + size);
+	UnmapViewOfFile(base);
+#elif FOUNDATION_PLATFORM_POSIX
+	if (munmap(base, size * 2) < 0)
+		log_warn(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Failed to unmap mirrored ring buffer"));
+#else
+	FOUNDATION_UNUSED(base);
+	FOUNDATION_UNUSED(size);
+#endif
+}
+
+ringbuffer_mirror_t*
+ringbuffer_mirror_allocate(size_t size) {
+	ringbuffer_mirror_t* buffer = memory_allocate(0, sizeof(ringbuffer_mirror_t), 64,
+	                                              MEMORY_PERSISTENT);
+
+	if (!ringbuffer_mirror_initialize(buffer, size)) {
+		memory_deallocate(buffer);
+		return 0;
+	}
+
+	return buffer;
+}
+
+bool
+ringbuffer_mirror_initialize(ringbuffer_mirror_t* buffer, size_t size) {
+	size_t granularity = _ringbuffer_mirror_granularity();
+
+	atomic_store64(&buffer->total_write, 0);
+	atomic_store64(&buffer->total_read, 0);
+	buffer->cached_read = 0;
+	buffer->cached_write = 0;
+	buffer->buffer_size = 0;
+	buffer->buffer = 0;
+
+	size = (size ? ((size + granularity - 1) / granularity) : 1) * granularity;
+	buffer->buffer = _ringbuffer_mirror_map(size);
+	if (!buffer->buffer) {
+		string_const_t errmsg = system_error_message(0);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to map mirrored ring buffer of %" PRIsize " bytes: %.*s"),
+		           size, STRING_FORMAT(errmsg));
+		return false;
+	}
+	buffer->buffer_size = size;
+
+	return true;
+}
+
+void
+ringbuffer_mirror_deallocate(ringbuffer_mirror_t* buffer) {
+	ringbuffer_mirror_finalize(buffer);
+	memory_deallocate(buffer);
+}
+
+void
+ringbuffer_mirror_finalize(ringbuffer_mirror_t* buffer) {
+	if (buffer->buffer)
+		_ringbuffer_mirror_unmap(buffer->buffer, buffer->buffer_size);
+	buffer->buffer = 0;
+	buffer->buffer_size = 0;
+}
+
+size_t
+ringbuffer_mirror_size(ringbuffer_mirror_t* buffer) {
+	return buffer->buffer_size;
+}
+
+void*
+ringbuffer_mirror_write_reserve(ringbuffer_mirror_t* buffer, size_t* num) {
+	uint64_t total_write = (uint64_t)atomic_load64(&buffer->total_write);
+	size_t buffer_size = buffer->buffer_size;
+	size_t available;
+
+	//Only refresh the consumer position when cached position is not enough
+	available = buffer_size - (size_t)(total_write - buffer->cached_read);
+	if (available < *num) {
+		buffer->cached_read = (uint64_t)atomic_load64(&buffer->total_read);
+		atomic_thread_fence_acquire();
+		available = buffer_size - (size_t)(total_write - buffer->cached_read);
+	}
+
+	//Space wrapping around end of buffer continues in the mirrored pages
+	if (*num > available)
+		*num = available;
+
+	return buffer->buffer + (buffer_size ? (size_t)(total_write % buffer_size) : 0);
+}
+
+void
+ringbuffer_mirror_write_commit(ringbuffer_mirror_t* buffer, size_t num) {
+	uint64_t total_write = (uint64_t)atomic_load64(&buffer->total_write);
+	atomic_thread_fence_release();
+	atomic_store64(&buffer->total_write, (int64_t)(total_write + num));
+}
+
+const void*
+ringbuffer_mirror_read_reserve(ringbuffer_mirror_t* buffer, size_t* num) {
+	uint64_t total_read = (uint64_t)atomic_load64(&buffer->total_read);
+	size_t buffer_size = buffer->buffer_size;
+	size_t available;
+
+	//Only refresh the producer position when cached position is not enough
+	available = (size_t)(buffer->cached_write - total_read);
+	if (available < *num) {
+		buffer->cached_write = (uint64_t)atomic_load64(&buffer->total_write);
+		atomic_thread_fence_acquire();
+		available = (size_t)(buffer->cached_write - total_read);
+	}
+
+	//Data wrapping around end of buffer continues in the mirrored pages
+	if (*num > available)
+		*num = available;
+
+	return buffer->buffer + (buffer_size ? (size_t)(total_read % buffer_size) : 0);
+}
+
+void
+ringbuffer_mirror_read_commit(ringbuffer_mirror_t* buffer, size_t num) {
+	uint64_t total_read = (uint64_t)atomic_load64(&buffer->total_read);
+	atomic_thread_fence_release();
+	atomic_store64(&buffer->total_read, (int64_t)(total_read + num));
+}
+
+size_t
+ringbuffer_mirror_read(ringbuffer_mirror_t* buffer, void* dest, size_t num) {
+	const void* source = ringbuffer_mirror_read_reserve(buffer, &num);
+	if (!num)
+		return 0;
+	if (dest)
+		memcpy(dest, source, num);
+	ringbuffer_mirror_read_commit(buffer, num);
+	return num;
+}
+
+size_t
+ringbuffer_mirror_write(ringbuffer_mirror_t* buffer, const void* source, size_t num) {
+	void* dest = ringbuffer_mirror_write_reserve(buffer, &num);
+	if (!num)
+		return 0;
+	memcpy(dest, source, num);
+	ringbuffer_mirror_write_commit(buffer, num);
+	return num;
+}
+
+size_t
+ringbuffer_mirror_available_read(ringbuffer_mirror_t* buffer) {
+	return (size_t)((uint64_t)atomic_load64(&buffer->total_write) -
+	                (uint64_t)atomic_load64(&buffer->total_read));
+}
+
+size_t
+ringbuffer_mirror_available_write(ringbuffer_mirror_t* buffer) {
+	return buffer->buffer_size - ringbuffer_mirror_available_read(buffer);
+}
+
+uint64_t
+ringbuffer_mirror_total_read(ringbuffer_mirror_t* buffer) {
+	return (uint64_t)atomic_load64(&buffer->total_read);
+}
+
+uint64_t
+ringbuffer_mirror_total_written(ringbuffer_mirror_t* buffer) {
+	return (uint64_t)atomic_load64(&buffer->total_write);
+}
+
+//Number of bytes the stream can still transfer before reaching the total size
+static size_t
+_ringbuffer_stream_remain(stream_ringbuffer_t* rbstream, uint64_t total, size_t num) {
+	if (rbstream->total_size) {
+		size_t remain = (total < rbstream->total_size) ? (size_t)(rbstream->total_size - total) : 0;
+		if (num > remain)
+			num = remain;
+	}
+	return num;
+}
+
+static size_t
+_ringbuffer_stream_need_read(stream_ringbuffer_t* rbstream, size_t num) {
+	size_t need = _ringbuffer_stream_remain(rbstream,
+	              ringbuffer_spsc_total_read(RINGBUFFER_FROM_STREAM(rbstream)), rbstream->watermark_low);
+	if (need > num)
+		need = num;
+	return need ? need : 1;
+}
+
+static size_t
+_ringbuffer_stream_need_write(stream_ringbuffer_t* rbstream, size_t num) {
+	size_t buffer_size = rbstream->buffer_size;
+	size_t need = buffer_size - ((rbstream->watermark_high < buffer_size) ? rbstream->watermark_high :
+	                             buffer_size);
+	if (need > num)
+		need = num;
+	return need ? need : 1;
+}
+
+static void
+_ringbuffer_stream_wait(atomic64_t* pending, semaphore_t* signal, size_t need, size_t available) {
+	//Flag the number of bytes needed, then either the bytes became available after flagging
+	//the wait, or the other side will clear the flag and post the semaphore
+	atomic_store64(pending, (int64_t)need);
+	atomic_thread_fence_sequentially_consistent();
+	if ((available >= need) && atomic_cas64(pending, 0, (int64_t)need))
+		return;
+	semaphore_wait(signal);
+}
+
+static void
+_ringbuffer_stream_notify(atomic64_t* pending, semaphore_t* signal, size_t available) {
+	int64_t need;
+	atomic_thread_fence_sequentially_consistent();
+	need = atomic_load64(pending);
+	if (need && (available >= (size_t)need) && atomic_cas64(pending, 0, need))
+		semaphore_post(signal);
+}
+
+//Fire beacon once when buffered data reaches the low watermark (or the end of stream),
+//the flag is cleared by the reader when data drops below the watermark again
+static void
+_ringbuffer_stream_fire(stream_ringbuffer_t* rbstream) {
+	beacon_t* beacon = rbstream->beacon;
+	ringbuffer_spsc_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
+	if (!beacon || atomic_load32(&rbstream->beacon_fired))
+		return;
+	if ((ringbuffer_spsc_available_read(buffer) >= _ringbuffer_stream_need_read(rbstream, (size_t)-1)) &&
+	    atomic_cas32(&rbstream->beacon_fired, 1, 0))
+		beacon_fire(beacon);
+}
+
+static void
+_ringbuffer_stream_rearm(stream_ringbuffer_t* rbstream) {
+	ringbuffer_spsc_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
+	if (!rbstream->beacon || !atomic_load32(&rbstream->beacon_fired))
+		return;
+	if (ringbuffer_spsc_available_read(buffer) < _ringbuffer_stream_need_read(rbstream, (size_t)-1)) {
+		atomic_store32(&rbstream->beacon_fired, 0);
+		atomic_thread_fence_sequentially_consistent();
+		//Writer might have added data before flag was cleared
+		_ringbuffer_stream_fire(rbstream);
+	}
+}
+
+static size_t
+_ringbuffer_stream_read(stream_t* stream, void* dest, size_t num) {
 	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
-	ringbuffer_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
+	ringbuffer_spsc_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
 
-	size_t num_write = ringbuffer_write(buffer, source, num);
+	size_t num_read = ringbuffer_spsc_read(buffer, dest, num);
+	if (num_read)
+		_ringbuffer_stream_notify(PENDING_WRITE_FROM_STREAM(rbstream), &rbstream->signal_read,
+		                          ringbuffer_spsc_available_write(buffer));
 
-	while (num_write < num) {
-		rbstream->pending_write = 1;
+	while (num_read < num) {
+		_ringbuffer_stream_wait(PENDING_READ_FROM_STREAM(rbstream), &rbstream->signal_write,
+		                        _ringbuffer_stream_need_read(rbstream, num - num_read),
+		                        ringbuffer_spsc_available_read(buffer));
+
+		num_read += ringbuffer_spsc_read(buffer, dest ? pointer_offset(dest, num_read) : 0,
+		                                 num - num_read);
+		_ringbuffer_stream_notify(PENDING_WRITE_FROM_STREAM(rbstream), &rbstream->signal_read,
+		                          ringbuffer_spsc_available_write(buffer));
+	}
 
-		if (rbstream->pending_read)
-			semaphore_post(&rbstream->signal_write);
+	_ringbuffer_stream_rearm(rbstream);
 
-		semaphore_wait(&rbstream->signal_read);
-		rbstream->pending_write = 0;
+	return num_read;
+}
 
-		num_write += ringbuffer_write(buffer, source ? pointer_offset_const(source, num_write) : 0,
-		                              num - num_write);
+static size_t
+_ringbuffer_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	ringbuffer_spsc_t* buffer = RINGBUFFER_FROM_STREAM(rbstream);
+
+	size_t num_write = ringbuffer_spsc_write(buffer, source, num);
+	if (num_write) {
+		_ringbuffer_stream_notify(PENDING_READ_FROM_STREAM(rbstream), &rbstream->signal_write,
+		                          ringbuffer_spsc_available_read(buffer));
+		_ringbuffer_stream_fire(rbstream);
 	}
 
-	if (rbstream->pending_read)
-		semaphore_post(&rbstream->signal_write);
+	while (num_write < num) {
+		_ringbuffer_stream_wait(PENDING_WRITE_FROM_STREAM(rbstream), &rbstream->signal_read,
+		                        _ringbuffer_stream_need_write(rbstream, num - num_write),
+		                        ringbuffer_spsc_available_write(buffer));
+
+		num_write += ringbuffer_spsc_write(buffer, pointer_offset_const(source, num_write),
+		                                   num - num_write);
+		_ringbuffer_stream_notify(PENDING_READ_FROM_STREAM(rbstream), &rbstream->signal_write,
+		                          ringbuffer_spsc_available_read(buffer));
+		_ringbuffer_stream_fire(rbstream);
+	}
 
 	return num_write;
 }
 
 static bool
 _ringbuffer_stream_eos(stream_t* stream) {
-	stream_ringbuffer_t* buffer = (stream_ringbuffer_t*)stream;
-	return buffer->total_size ? (buffer->total_read >= buffer->total_size) : false;
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	return rbstream->total_size ?
+	       (ringbuffer_spsc_total_read(RINGBUFFER_FROM_STREAM(rbstream)) >= rbstream->total_size) :
+	       false;
 }
 
 static void
@@ -243,8 +761,8 @@ _ringbuffer_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t dir
 
 static size_t
 _ringbuffer_stream_tell(stream_t* stream) {
-	stream_ringbuffer_t* buffer = (stream_ringbuffer_t*)stream;
-	return (size_t)buffer->total_read;
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	return (size_t)ringbuffer_spsc_total_read(RINGBUFFER_FROM_STREAM(rbstream));
 }
 
 static tick_t
@@ -255,13 +773,13 @@ _ringbuffer_stream_lastmod(const stream_t* stream) {
 
 static size_t
 _ringbuffer_stream_available_read(stream_t* stream) {
-	stream_ringbuffer_t* buffer = (stream_ringbuffer_t*)stream;
-	return (size_t)(buffer->total_write - buffer->total_read);
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	return ringbuffer_spsc_available_read(RINGBUFFER_FROM_STREAM(rbstream));
 }
 
 stream_t*
 ringbuffer_stream_allocate(size_t buffer_size, size_t total_size) {
-	stream_ringbuffer_t* bufferstream = memory_allocate(0, sizeof(stream_ringbuffer_t) + buffer_size, 0,
+	stream_ringbuffer_t* bufferstream = memory_allocate(0, sizeof(stream_ringbuffer_t) + buffer_size, 64,
 	                                                    MEMORY_PERSISTENT);
 
 	ringbuffer_stream_initialize(bufferstream, buffer_size, total_size);
@@ -281,15 +799,221 @@ ringbuffer_stream_initialize(stream_ringbuffer_t* stream, size_t buffer_size, si
 	                                      (uintptr_t)stream);
 	stream->mode = STREAM_OUT | STREAM_IN | STREAM_BINARY;
 
-	ringbuffer_initialize(RINGBUFFER_FROM_STREAM(stream), buffer_size);
+	ringbuffer_spsc_initialize(RINGBUFFER_FROM_STREAM(stream), buffer_size);
 	semaphore_initialize(&stream->signal_read, 0);
 	semaphore_initialize(&stream->signal_write, 0);
 
 	stream->total_size = total_size;
+	stream->watermark_low = 1;
+	stream->watermark_high = buffer_size;
 
 	stream->vtable = &_ringbuffer_stream_vtable;
 }
 
+#if RINGBUFFER_HAS_SHARED_STREAM
+
+//Wait for another process to finish setting up the shared object, giving up after a second
+//in case the other process died during initialization
+static bool
+_ringbuffer_shared_wait(atomic32_t* initialized) {
+	tick_t deadline = time_current() + time_ticks_per_second();
+	while (atomic_load32(initialized) != 2) {
+		if (time_current() > deadline)
+			return false;
+		thread_yield();
+	}
+	atomic_thread_fence_acquire();
+	return true;
+}
+
+#endif
+
+static ringbuffer_shared_t*
+_ringbuffer_shared_map(const char* name, size_t buffer_size, size_t* size) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	ringbuffer_shared_t* shared;
+	bool create;
+	size_t map_size = sizeof(ringbuffer_shared_t) + buffer_size;
+	HANDLE mapping = buffer_size ?
+	                 CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+	                                    (DWORD)((uint64_t)map_size >> 32ULL), (DWORD)map_size, name) :
+	                 OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+	if (!mapping)
+		return 0;
+	create = buffer_size && (GetLastError() != ERROR_ALREADY_EXISTS);
+	shared = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	//View keeps the mapping alive until unmapped
+	CloseHandle(mapping);
+	if (!shared)
+		return 0;
+#elif RINGBUFFER_HAS_SHARED_STREAM
+	ringbuffer_shared_t* shared;
+	size_t map_size = sizeof(ringbuffer_shared_t) + buffer_size;
+	struct stat st;
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, (mode_t)0666);
+	bool create = (fd >= 0);
+	if (create) {
+		if (!buffer_size || (ftruncate(fd, (off_t)map_size) != 0)) {
+			close(fd);
+			shm_unlink(name);
+			return 0;
+		}
+	}
+	else {
+		tick_t deadline = time_current() + time_ticks_per_second();
+		if (errno != EEXIST)
+			return 0;
+		fd = shm_open(name, O_RDWR, 0);
+		if (fd < 0)
+			return 0;
+		//Creating process sizes the object right after creating it
+		while ((fstat(fd, &st) == 0) && (st.st_size == 0) && (time_current() < deadline))
+			thread_yield();
+		if ((fstat(fd, &st) != 0) || ((size_t)st.st_size <= sizeof(ringbuffer_shared_t))) {
+			close(fd);
+			return 0;
+		}
+		map_size = (size_t)st.st_size;
+	}
+	shared = mmap(0, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shared == MAP_FAILED)
+		return 0;
+#else
+	FOUNDATION_UNUSED(name);
+	FOUNDATION_UNUSED(buffer_size);
+	FOUNDATION_UNUSED(size);
+	return 0;
+#endif
+#if RINGBUFFER_HAS_SHARED_STREAM
+	//Process creating the object initializes the ring buffer, others wait for it
+	if (create) {
+		atomic_store32(&shared->initialized, 1);
+		atomic_store64(&shared->pending_read, 0);
+		atomic_store64(&shared->pending_write, 0);
+		ringbuffer_spsc_initialize((ringbuffer_spsc_t*)&shared->total_write, buffer_size);
+		atomic_thread_fence_release();
+		atomic_store32(&shared->initialized, 2);
+	}
+	else if (!_ringbuffer_shared_wait(&shared->initialized)) {
+#  if FOUNDATION_PLATFORM_WINDOWS
+		UnmapViewOfFile(shared);
+#  else
+		munmap(shared, map_size);
+#  endif
+		return 0;
+	}
+	*size = sizeof(ringbuffer_shared_t) + shared->buffer_size;
+	return shared;
+#endif
+}
+
+static void
+_ringbuffer_shared_unmap(ringbuffer_shared_t* shared, size_t size, string_t name) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	FOUNDATION_UNUSED(size);
+	FOUNDATION_UNUSED(name);
+	UnmapViewOfFile(shared);
+#elif RINGBUFFER_HAS_SHARED_STREAM
+	shm_unlink(name.str);
+	if (munmap(shared, size) < 0)
+		log_warn(0, WARNING_SYSTEM_CALL_FAIL, STRING_CONST("Failed to unmap shared ring buffer"));
+#else
+	FOUNDATION_UNUSED(shared);
+	FOUNDATION_UNUSED(size);
+	FOUNDATION_UNUSED(name);
+#endif
+}
+
+stream_t*
+ringbuffer_stream_allocate_shared(const char* name, size_t length, size_t buffer_size,
+                                  size_t total_size) {
+	stream_ringbuffer_t* bufferstream = memory_allocate(0, sizeof(stream_ringbuffer_t), 64,
+	                                                    MEMORY_PERSISTENT);
+
+	if (!ringbuffer_stream_initialize_shared(bufferstream, name, length, buffer_size, total_size)) {
+		memory_deallocate(bufferstream);
+		return 0;
+	}
+
+	return (stream_t*)bufferstream;
+}
+
+bool
+ringbuffer_stream_initialize_shared(stream_ringbuffer_t* stream, const char* name, size_t length,
+                                    size_t buffer_size, size_t total_size) {
+	char semname[BUILD_MAX_PATHLEN];
+	string_t shmname;
+	string_t signame;
+	ringbuffer_shared_t* shared;
+	size_t shared_size = 0;
+
+	memset(stream, 0, sizeof(stream_ringbuffer_t));
+
+#if FOUNDATION_PLATFORM_WINDOWS
+	shmname = string_clone(name, length);
+#else
+	shmname = string_allocate_format(STRING_CONST("/%.*s"), (int)length, name);
+#endif
+	shared = _ringbuffer_shared_map(shmname.str, buffer_size, &shared_size);
+	if (!shared) {
+		int err = system_error();
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to map shared ring buffer '%.*s': %.*s (%d)"),
+		           (int)length, name, STRING_FORMAT(errmsg), err);
+		string_deallocate(shmname.str);
+		return false;
+	}
+
+	stream_initialize((stream_t*)stream, system_byteorder());
+
+	stream->type = STREAMTYPE_RINGBUFFER;
+	stream->sequential = 1;
+	stream->path = string_allocate_format(STRING_CONST("ringbuffer://%.*s"), (int)length, name);
+	stream->mode = STREAM_OUT | STREAM_IN | STREAM_BINARY;
+
+	stream->shared = shared;
+	stream->shared_size = shared_size;
+	stream->shared_name = shmname;
+	stream->buffer_size = shared->buffer_size;
+
+	signame = string_format(semname, sizeof(semname), STRING_CONST("%.*s_read"),
+	                                 (int)length, name);
+	semaphore_initialize_named(&stream->signal_read, STRING_ARGS(signame), 0);
+	signame = string_format(semname, sizeof(semname), STRING_CONST("%.*s_write"), (int)length, name);
+	semaphore_initialize_named(&stream->signal_write, STRING_ARGS(signame), 0);
+
+	stream->total_size = total_size;
+	stream->watermark_low = 1;
+	stream->watermark_high = stream->buffer_size;
+
+	stream->vtable = &_ringbuffer_stream_vtable;
+
+	return true;
+}
+
+void
+ringbuffer_stream_set_watermark(stream_t* stream, size_t low, size_t high) {
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	FOUNDATION_ASSERT(stream->type == STREAMTYPE_RINGBUFFER);
+	//Low watermark above high watermark could block both reader and writer
+	if (high > rbstream->buffer_size)
+		high = rbstream->buffer_size;
+	rbstream->watermark_low = (low < high) ? low : high;
+	rbstream->watermark_high = high;
+}
+
+void
+ringbuffer_stream_set_beacon(stream_t* stream, beacon_t* beacon) {
+	stream_ringbuffer_t* rbstream = (stream_ringbuffer_t*)stream;
+	FOUNDATION_ASSERT(stream->type == STREAMTYPE_RINGBUFFER);
+	atomic_store32(&rbstream->beacon_fired, 0);
+	rbstream->beacon = beacon;
+	atomic_thread_fence_sequentially_consistent();
+	_ringbuffer_stream_fire(rbstream);
+}
+
 static void
 _ringbuffer_stream_finalize(stream_t* stream) {
 	stream_ringbuffer_t* bufferstream = (stream_ringbuffer_t*)stream;
@@ -299,6 +1023,13 @@ _ringbuffer_stream_finalize(stream_t* stream) {
 
 	semaphore_finalize(&bufferstream->signal_read);
 	semaphore_finalize(&bufferstream->signal_write);
+
+	if (bufferstream->shared) {
+		_ringbuffer_shared_unmap(bufferstream->shared, bufferstream->shared_size,
+		                         bufferstream->shared_name);
+		string_deallocate(bufferstream->shared_name.str);
+		bufferstream->shared = 0;
+	}
 }
 
 void
@@ -18,8 +18,22 @@
 Simple memory ring buffer abstraction. Read and write are not
 thread safe. Synchronization needs to be done by caller.
 
-The ring buffer stream uses a semaphore to block and notify readers and is thus
-thread safe. */
+The single producer, single consumer ring buffer variant is lock free and safe for one
+thread writing while another thread is reading. Data can be written and read in place
+with the reserve and commit functions to avoid intermediate copies.
+
+The ring buffer stream is built on the single producer, single consumer ring buffer and
+uses semaphores only to block readers and writers on an empty or full buffer. Watermarks
+control how much data must be buffered before a blocked reader is woken, and how far the
+buffer must drain before a blocked writer is woken, to reduce the number of wakeups for
+small transfers. A beacon can be attached to the stream to wait for data together with
+other event sources.
+
+The mirrored ring buffer variant is a single producer, single consumer ring buffer where
+the buffer memory pages are mapped twice back to back in virtual memory. Any pending data
+or free space is then contiguous in memory, allowing data to be parsed or produced in place
+without copying even when wrapping around the end of the buffer. The buffer size is rounded
+up to the virtual memory page size (allocation granularity on Windows). */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -87,9 +101,213 @@ ringbuffer_total_read(ringbuffer_t* buffer);
 FOUNDATION_API uint64_t
 ringbuffer_total_written(ringbuffer_t* buffer);
 
+/*! Allocate a single producer, single consumer ring buffer of given size. Deallocate the
+ring buffer with a call to #ringbuffer_spsc_deallocate.
+\param size Size in bytes
+\return Ring buffer */
+FOUNDATION_API ringbuffer_spsc_t*
+ringbuffer_spsc_allocate(size_t size);
+
+/*! Deallocate ring buffer previously allocated with a call to #ringbuffer_spsc_allocate.
+\param buffer Ring buffer */
+FOUNDATION_API void
+ringbuffer_spsc_deallocate(ringbuffer_spsc_t* buffer);
+
+/*! Initialize a single producer, single consumer ring buffer of given size. The memory
+for the buffer must directly follow the structure, and the structure should be aligned
+to 64 bytes. Finalize the ring buffer with a call to #ringbuffer_spsc_finalize.
+\param buffer Ring buffer
+\param size Size in bytes */
+FOUNDATION_API void
+ringbuffer_spsc_initialize(ringbuffer_spsc_t* buffer, size_t size);
+
+/*! Finalize ring buffer previously initialized with a call to #ringbuffer_spsc_initialize.
+\param buffer Ring buffer */
+FOUNDATION_API void
+ringbuffer_spsc_finalize(ringbuffer_spsc_t* buffer);
+
+/*! Get ring buffer size.
+\param buffer Ring buffer
+\return Size of ring buffer */
+FOUNDATION_API size_t
+ringbuffer_spsc_size(ringbuffer_spsc_t* buffer);
+
+/*! Reserve contiguous space for writing in place. Only to be called by the producer thread.
+Data written to the returned memory is made available to the consumer by a call to
+#ringbuffer_spsc_write_commit.
+\param buffer Ring buffer
+\param num Number of bytes requested, updated with number of contiguous bytes available,
+which is less than requested if buffer is full or space wraps around end of buffer
+\return Pointer to memory to write */
+FOUNDATION_API void*
+ringbuffer_spsc_write_reserve(ringbuffer_spsc_t* buffer, size_t* num);
+
+/*! Commit bytes written to memory from #ringbuffer_spsc_write_reserve.
+\param buffer Ring buffer
+\param num Number of bytes written, at most the number of bytes reserved */
+FOUNDATION_API void
+ringbuffer_spsc_write_commit(ringbuffer_spsc_t* buffer, size_t num);
+
+/*! Reserve contiguous data for reading in place. Only to be called by the consumer thread.
+Memory is released to the producer by a call to #ringbuffer_spsc_read_commit.
+\param buffer Ring buffer
+\param num Number of bytes requested, updated with number of contiguous bytes available,
+which is less than requested if buffer is empty or data wraps around end of buffer
+\return Pointer to memory to read */
+FOUNDATION_API const void*
+ringbuffer_spsc_read_reserve(ringbuffer_spsc_t* buffer, size_t* num);
+
+/*! Commit bytes read from memory from #ringbuffer_spsc_read_reserve.
+\param buffer Ring buffer
+\param num Number of bytes read, at most the number of bytes reserved */
+FOUNDATION_API void
+ringbuffer_spsc_read_commit(ringbuffer_spsc_t* buffer, size_t num);
+
+/*! Read from ring buffer. Only to be called by the consumer thread.
+\param buffer Ring buffer
+\param dest Destination pointer, null to discard data
+\param num Number of bytes requested to be read
+\return Number of bytes actually read */
+FOUNDATION_API size_t
+ringbuffer_spsc_read(ringbuffer_spsc_t* buffer, void* dest, size_t num);
+
+/*! Write to ring buffer. Only to be called by the producer thread.
+\param buffer Ring buffer
+\param source Source pointer
+\param num Number of bytes requested to be written
+\return Number of bytes actually written */
+FOUNDATION_API size_t
+ringbuffer_spsc_write(ringbuffer_spsc_t* buffer, const void* source, size_t num);
+
+/*! Get number of bytes available for reading
+\param buffer Ring buffer
+\return Number of bytes available for reading */
+FOUNDATION_API size_t
+ringbuffer_spsc_available_read(ringbuffer_spsc_t* buffer);
+
+/*! Get number of bytes available for writing
+\param buffer Ring buffer
+\return Number of bytes available for writing */
+FOUNDATION_API size_t
+ringbuffer_spsc_available_write(ringbuffer_spsc_t* buffer);
+
+/*! Get total number of bytes read
+\param buffer Ring buffer
+\return Total number of bytes read */
+FOUNDATION_API uint64_t
+ringbuffer_spsc_total_read(ringbuffer_spsc_t* buffer);
+
+/*! Get total number of bytes written
+\param buffer Ring buffer
+\return Total number of bytes written */
+FOUNDATION_API uint64_t
+ringbuffer_spsc_total_written(ringbuffer_spsc_t* buffer);
+
+/*! Allocate a mirrored ring buffer of given size. Deallocate the ring buffer with a call
+to #ringbuffer_mirror_deallocate.
+\param size Size in bytes, rounded up to virtual memory page size
+\return Ring buffer, 0 if virtual memory mapping failed or is not supported */
+FOUNDATION_API ringbuffer_mirror_t*
+ringbuffer_mirror_allocate(size_t size);
+
+/*! Deallocate ring buffer previously allocated with a call to #ringbuffer_mirror_allocate.
+\param buffer Ring buffer */
+FOUNDATION_API void
+ringbuffer_mirror_deallocate(ringbuffer_mirror_t* buffer);
+
+/*! Initialize a mirrored ring buffer of given size. Finalize the ring buffer with a call
+to #ringbuffer_mirror_finalize.
+\param buffer Ring buffer
+\param size Size in bytes, rounded up to virtual memory page size
+\return true if successful, false if virtual memory mapping failed or is not supported */
+FOUNDATION_API bool
+ringbuffer_mirror_initialize(ringbuffer_mirror_t* buffer, size_t size);
+
+/*! Finalize ring buffer previously initialized with a call to #ringbuffer_mirror_initialize.
+\param buffer Ring buffer */
+FOUNDATION_API void
+ringbuffer_mirror_finalize(ringbuffer_mirror_t* buffer);
+
+/*! Get ring buffer size.
+\param buffer Ring buffer
+\return Size of ring buffer */
+FOUNDATION_API size_t
+ringbuffer_mirror_size(ringbuffer_mirror_t* buffer);
+
+/*! Reserve contiguous space for writing in place. Only to be called by the producer thread.
+Data written to the returned memory is made available to the consumer by a call to
+#ringbuffer_mirror_write_commit.
+\param buffer Ring buffer
+\param num Number of bytes requested, updated with number of contiguous bytes available,
+which is only less than requested if buffer is full
+\return Pointer to memory to write */
+FOUNDATION_API void*
+ringbuffer_mirror_write_reserve(ringbuffer_mirror_t* buffer, size_t* num);
+
+/*! Commit bytes written to memory from #ringbuffer_mirror_write_reserve.
+\param buffer Ring buffer
+\param num Number of bytes written, at most the number of bytes reserved */
+FOUNDATION_API void
+ringbuffer_mirror_write_commit(ringbuffer_mirror_t* buffer, size_t num);
+
+/*! Reserve contiguous data for reading in place. Only to be called by the consumer thread.
+Memory is released to the producer by a call to #ringbuffer_mirror_read_commit.
+\param buffer Ring buffer
+\param num Number of bytes requested, updated with number of contiguous bytes available,
+which is only less than requested if not enough data is pending
+\return Pointer to memory to read */
+FOUNDATION_API const void*
+ringbuffer_mirror_read_reserve(ringbuffer_mirror_t* buffer, size_t* num);
+
+/*! Commit bytes read from memory from #ringbuffer_mirror_read_reserve.
+\param buffer Ring buffer
+\param num Number of bytes read, at most the number of bytes reserved */
+FOUNDATION_API void
+ringbuffer_mirror_read_commit(ringbuffer_mirror_t* buffer, size_t num);
+
+/*! Read from ring buffer. Only to be called by the consumer thread.
+\param buffer Ring buffer
+\param dest Destination pointer, null to discard data
+\param num Number of bytes requested to be read
+\return Number of bytes actually read */
+FOUNDATION_API size_t
+ringbuffer_mirror_read(ringbuffer_mirror_t* buffer, void* dest, size_t num);
+
+/*! Write to ring buffer. Only to be called by the producer thread.
+\param buffer Ring buffer
+\param source Source pointer
+\param num Number of bytes requested to be written
+\return Number of bytes actually written */
+FOUNDATION_API size_t
+ringbuffer_mirror_write(ringbuffer_mirror_t* buffer, const void* source, size_t num);
+
+/*! Get number of bytes available for reading
+\param buffer Ring buffer
+\return Number of bytes available for reading */
+FOUNDATION_API size_t
+ringbuffer_mirror_available_read(ringbuffer_mirror_t* buffer);
+
+/*! Get number of bytes available for writing
+\param buffer Ring buffer
+\return Number of bytes available for writing */
+FOUNDATION_API size_t
+ringbuffer_mirror_available_write(ringbuffer_mirror_t* buffer);
+
+/*! Get total number of bytes read
+\param buffer Ring buffer
+\return Total number of bytes read */
+FOUNDATION_API uint64_t
+ringbuffer_mirror_total_read(ringbuffer_mirror_t* buffer);
+
+/*! Get total number of bytes written
+\param buffer Ring buffer
+\return Total number of bytes written */
+FOUNDATION_API uint64_t
+ringbuffer_mirror_total_written(ringbuffer_mirror_t* buffer);
+
 /*! Allocate a ringbuffer stream, which is basically a stream wrapped on top of a ringbuffer.
-Reads and writes block on semaphores on missing data, making it usable for ringbuffer
-threaded I/O. Stream should be deallocated by a call to #stream_deallocate
+Reads and writes are lock free and only block on semaphores on missing data or space, making
+it usable for producer/consumer threaded I/O. Stream should be deallocated by a call to #stream_deallocate
 \param buffer_size Size of ringbuffer
 \param total_size Total size of stream, 0 if infinite
 \return Ringbuffer stream */
@@ -97,10 +315,65 @@ FOUNDATION_API stream_t*
 ringbuffer_stream_allocate(size_t buffer_size, size_t total_size);
 
 /*! Initialize a ringbuffer stream, which is basically a stream wrapped on top of a ringbuffer.
-Reads and writes block on semaphores on missing data, making it usable for ringbuffer
-threaded I/O. Stream should be finalized by a call to #stream_finalize
+Reads and writes are lock free and only block on semaphores on missing data or space, making
+it usable for producer/consumer threaded I/O. Stream should be finalized by a call to #stream_finalize
 \param stream Ringbuffer stream
 \param buffer_size Size of ringbuffer
 \param total_size Total size of stream, 0 if infinite */
 FOUNDATION_API void
 ringbuffer_stream_initialize(stream_ringbuffer_t* stream, size_t buffer_size, size_t total_size);
+
+/*! Allocate a ringbuffer stream in named shared memory, for transferring data between two
+processes. The first call with a given name creates the shared memory object (using shm_open on
+posix and CreateFileMapping on Windows) and the ring buffer of the given size, a call in another
+process with the same name maps the same ring buffer. One process should only write and the other
+only read, reads and writes are lock free and only block on named semaphores on missing data or
+space, so no system call is made per transfer as long as the reader keeps up. The total size
+should be the same in both processes. A beacon set with #ringbuffer_stream_set_beacon is only
+fired by writes through the same stream object. The name is released when either stream is
+deallocated, streams already mapped keep working. Not supported on Android and iOS.
+Stream should be deallocated by a call to #stream_deallocate
+\param name Name of shared memory object
+\param length Length of name
+\param buffer_size Size of ringbuffer, ignored if the shared ring buffer already exists, 0 to only
+open an existing shared ring buffer
+\param total_size Total size of stream, 0 if infinite
+\return Ringbuffer stream, null if the shared memory could not be created or mapped */
+FOUNDATION_API stream_t*
+ringbuffer_stream_allocate_shared(const char* name, size_t length, size_t buffer_size,
+                                  size_t total_size);
+
+/*! Initialize a ringbuffer stream in named shared memory, see #ringbuffer_stream_allocate_shared.
+Stream should be finalized by a call to #stream_finalize
+\param stream Ringbuffer stream
+\param name Name of shared memory object
+\param length Length of name
+\param buffer_size Size of ringbuffer, ignored if the shared ring buffer already exists, 0 to only
+open an existing shared ring buffer
+\param total_size Total size of stream, 0 if infinite
+\return true if successful, false if the shared memory could not be created or mapped */
+FOUNDATION_API bool
+ringbuffer_stream_initialize_shared(stream_ringbuffer_t* stream, const char* name, size_t length,
+                                    size_t buffer_size, size_t total_size);
+
+/*! Set watermarks for waking blocked threads. A blocked reader is only woken once at least
+the low watermark number of bytes are buffered (or the remaining number of bytes of the
+read request or stream total size, if less). A blocked writer is only woken once the
+number of buffered bytes have dropped to the high watermark (or enough space for the
+remaining bytes of the write request is available). Default is a low watermark of one byte
+and a high watermark of the buffer size, waking threads on any progress. The low watermark
+is clamped to the high watermark, which is clamped to the buffer size.
+\param stream Ringbuffer stream
+\param low Low watermark in bytes
+\param high High watermark in bytes */
+FOUNDATION_API void
+ringbuffer_stream_set_watermark(stream_t* stream, size_t low, size_t high);
+
+/*! Set beacon to fire when the number of buffered bytes reaches the low watermark (or all
+remaining bytes of the stream total size are buffered). The beacon is fired once, and not
+fired again until a read has dropped the buffered data below the low watermark. Fires the
+beacon directly if enough data is already buffered.
+\param stream Ringbuffer stream
+\param beacon Beacon to fire, null to disable */
+FOUNDATION_API void
+ringbuffer_stream_set_beacon(stream_t* stream, beacon_t* beacon);
@@ -0,0 +1,376 @@
+/* runloop.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#define RUNLOOP_HAS_BEACON_SOURCES (FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_LINUX || \
+                                    FOUNDATION_PLATFORM_ANDROID || FOUNDATION_PLATFORM_APPLE || \
+                                    FOUNDATION_PLATFORM_BSD)
+
+//Number of fired beacon slots collected in a single wait
+#define RUNLOOP_WAIT_SLOTS 64
+
+runloop_t*
+runloop_allocate(void) {
+	runloop_t* loop = memory_allocate(0, sizeof(runloop_t), 0, MEMORY_PERSISTENT);
+	runloop_initialize(loop);
+	return loop;
+}
+
+void
+runloop_deallocate(runloop_t* loop) {
+	if (!loop)
+		return;
+	runloop_finalize(loop);
+	memory_deallocate(loop);
+}
+
+void
+runloop_initialize(runloop_t* loop) {
+	memset(loop, 0, sizeof(runloop_t));
+	beacon_initialize(&loop->beacon);
+}
+
+void
+runloop_finalize(runloop_t* loop) {
+	size_t ientry, esize;
+	for (ientry = 0, esize = array_size(loop->streams); ientry < esize; ++ientry) {
+		if (loop->streams[ientry].stream)
+			event_stream_set_beacon(loop->streams[ientry].stream, nullptr);
+	}
+#if RUNLOOP_HAS_BEACON_SOURCES
+	for (ientry = 0, esize = array_size(loop->sources); ientry < esize; ++ientry) {
+		if (loop->sources[ientry].beacon)
+			beacon_remove(&loop->beacon, beacon_event_handle(loop->sources[ientry].beacon));
+	}
+#endif
+	array_deallocate(loop->streams);
+	array_deallocate(loop->sources);
+	array_deallocate(loop->timers);
+	beacon_finalize(&loop->beacon);
+}
+
+void
+runloop_add_stream(runloop_t* loop, event_stream_t* stream, runloop_stream_fn fn, void* arg) {
+	runloop_stream_t entry;
+	entry.stream = stream;
+	entry.fn = fn;
+	entry.arg = arg;
+	array_push(loop->streams, entry);
+	event_stream_set_beacon(stream, &loop->beacon);
+	//Events posted before the stream was added might have fired another beacon, make sure
+	//the next pass processes the stream
+	beacon_fire(&loop->beacon);
+}
+
+void
+runloop_remove_stream(runloop_t* loop, event_stream_t* stream) {
+	size_t ientry, esize;
+	for (ientry = 0, esize = array_size(loop->streams); ientry < esize; ++ientry) {
+		if (loop->streams[ientry].stream != stream)
+			continue;
+		event_stream_set_beacon(stream, nullptr);
+		if (loop->dispatching) {
+			loop->streams[ientry].stream = nullptr;
+			loop->removed = true;
+		}
+		else {
+			array_erase_ordered(loop->streams, ientry);
+		}
+		return;
+	}
+}
+
+bool
+runloop_add_beacon(runloop_t* loop, beacon_t* beacon, runloop_beacon_fn fn, void* arg) {
+#if RUNLOOP_HAS_BEACON_SOURCES
+	runloop_source_t entry;
+	if (beacon_add(&loop->beacon, beacon_event_handle(beacon)) < 0)
+		return false;
+	entry.beacon = beacon;
+	entry.fn = fn;
+	entry.arg = arg;
+	array_push(loop->sources, entry);
+	return true;
+#else
+	FOUNDATION_UNUSED(loop);
+	FOUNDATION_UNUSED(beacon);
+	FOUNDATION_UNUSED(fn);
+	FOUNDATION_UNUSED(arg);
+	return false;
+#endif
+}
+
+void
+runloop_remove_beacon(runloop_t* loop, beacon_t* beacon) {
+#if RUNLOOP_HAS_BEACON_SOURCES
+	size_t ientry, esize;
+	for (ientry = 0, esize = array_size(loop->sources); ientry < esize; ++ientry) {
+		if (loop->sources[ientry].beacon != beacon)
+			continue;
+		beacon_remove(&loop->beacon, beacon_event_handle(beacon));
+		if (loop->dispatching) {
+			loop->sources[ientry].beacon = nullptr;
+			loop->removed = true;
+		}
+		else {
+			array_erase_ordered(loop->sources, ientry);
+		}
+		return;
+	}
+#else
+	FOUNDATION_UNUSED(loop);
+	FOUNDATION_UNUSED(beacon);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE bool
+_runloop_timer_before(const runloop_timer_t* timer, const runloop_timer_t* other) {
+	return (timer->deadline < other->deadline) ||
+	       ((timer->deadline == other->deadline) && (timer->sequence < other->sequence));
+}
+
+static void
+_runloop_timer_sift_up(runloop_timer_t* timer, size_t index) {
+	runloop_timer_t entry = timer[index];
+	while (index) {
+		size_t parent = (index - 1) / 2;
+		if (!_runloop_timer_before(&entry, timer + parent))
+			break;
+		timer[index] = timer[parent];
+		index = parent;
+	}
+	timer[index] = entry;
+}
+
+static void
+_runloop_timer_sift_down(runloop_timer_t* timer, size_t count, size_t index) {
+	runloop_timer_t entry = timer[index];
+	while (true) {
+		size_t child = (index * 2) + 1;
+		if (child >= count)
+			break;
+		if ((child + 1 < count) && _runloop_timer_before(timer + child + 1, timer + child))
+			++child;
+		if (!_runloop_timer_before(timer + child, &entry))
+			break;
+		timer[index] = timer[child];
+		index = child;
+	}
+	timer[index] = entry;
+}
+
+static void
+_runloop_timer_push(runloop_t* loop, runloop_timer_t* timer) {
+	timer->sequence = loop->timer_sequence++;
+	array_push(loop->timers, *timer);
+	_runloop_timer_sift_up(loop->timers, array_size(loop->timers) - 1);
+}
+
+static void
+_runloop_timer_erase(runloop_t* loop, size_t index) {
+	size_t count = array_size(loop->timers) - 1;
+	loop->timers[index] = loop->timers[count];
+	array_pop(loop->timers);
+	if (index < count) {
+		_runloop_timer_sift_up(loop->timers, index);
+		_runloop_timer_sift_down(loop->timers, count, index);
+	}
+}
+
+static tick_t
+_runloop_ticks(unsigned int milliseconds) {
+	return (time_ticks_per_second() * (tick_t)milliseconds) / 1000;
+}
+
+unsigned int
+runloop_add_timer(runloop_t* loop, unsigned int delay_ms, unsigned int period_ms,
+                  runloop_timer_fn fn, void* arg) {
+	runloop_timer_t timer;
+	if (!++loop->timer_id)
+		++loop->timer_id;
+	timer.deadline = time_current() + _runloop_ticks(delay_ms);
+	timer.period = period_ms ? _runloop_ticks(period_ms) : 0;
+	if (period_ms && !timer.period)
+		timer.period = 1;
+	timer.id = loop->timer_id;
+	timer.fn = fn;
+	timer.arg = arg;
+	_runloop_timer_push(loop, &timer);
+	return timer.id;
+}
+
+bool
+runloop_cancel_timer(runloop_t* loop, unsigned int id) {
+	size_t itimer, tsize;
+	for (itimer = 0, tsize = array_size(loop->timers); itimer < tsize; ++itimer) {
+		if (loop->timers[itimer].id == id) {
+			_runloop_timer_erase(loop, itimer);
+			return true;
+		}
+	}
+	return false;
+}
+
+//Earliest timer or delayed event deadline, zero if none
+static tick_t
+_runloop_next_deadline(runloop_t* loop) {
+	tick_t deadline = array_size(loop->timers) ? loop->timers[0].deadline : 0;
+	size_t istream, ssize;
+	for (istream = 0, ssize = array_size(loop->streams); istream < ssize; ++istream) {
+		tick_t delivery = event_stream_next_delivery(loop->streams[istream].stream);
+		if (delivery && (!deadline || (delivery < deadline)))
+			deadline = delivery;
+	}
+	return deadline;
+}
+
+static size_t
+_runloop_dispatch_sources(runloop_t* loop, const int* slots, size_t fired) {
+#if RUNLOOP_HAS_BEACON_SOURCES
+	size_t resolved[RUNLOOP_WAIT_SLOTS];
+	size_t islot, ientry, esize, count = 0;
+	size_t dispatched = 0;
+	//Resolve slots to sources before any callback can add or remove beacons and move slots
+	for (islot = 0; islot < fired; ++islot) {
+		if (!slots[islot])
+			continue;
+		for (ientry = 0, esize = array_size(loop->sources); ientry < esize; ++ientry) {
+			if (beacon_slot_handle(&loop->beacon, slots[islot]) ==
+			        beacon_event_handle(loop->sources[ientry].beacon)) {
+				resolved[count++] = ientry;
+				break;
+			}
+		}
+	}
+	for (islot = 0; islot < count; ++islot) {
+		runloop_source_t* source = loop->sources + resolved[islot];
+		if (!source->beacon)
+			continue;
+		//Linked beacons stay fired until waited on
+		if (beacon_try_wait(source->beacon, 0) < 0)
+			continue;
+		source->fn(loop, source->beacon, source->arg);
+		++dispatched;
+	}
+	return dispatched;
+#else
+	FOUNDATION_UNUSED(loop);
+	FOUNDATION_UNUSED(slots);
+	FOUNDATION_UNUSED(fired);
+	return 0;
+#endif
+}
+
+static size_t
+_runloop_dispatch_streams(runloop_t* loop, bool fired, tick_t now) {
+	size_t istream, ssize;
+	size_t dispatched = 0;
+	//Streams added from callbacks are picked up in the next pass
+	for (istream = 0, ssize = array_size(loop->streams); istream < ssize; ++istream) {
+		runloop_stream_t* entry = loop->streams + istream;
+		event_block_t* block;
+		tick_t delivery;
+		if (!entry->stream)
+			continue;
+		delivery = event_stream_next_delivery(entry->stream);
+		if (!fired && (!delivery || (delivery > now)))
+			continue;
+		block = event_stream_process(entry->stream);
+		if (!event_block_count(block))
+			continue;
+		entry->fn(loop, entry->stream, block, entry->arg);
+		++dispatched;
+	}
+	return dispatched;
+}
+
+static size_t
+_runloop_dispatch_timers(runloop_t* loop, tick_t now) {
+	//Timers scheduled from callbacks in this pass are dispatched in the next pass
+	uint64_t sequence_limit = loop->timer_sequence;
+	size_t dispatched = 0;
+	while (array_size(loop->timers) && (loop->timers[0].deadline <= now) &&
+	        (loop->timers[0].sequence < sequence_limit)) {
+		runloop_timer_t timer = loop->timers[0];
+		_runloop_timer_erase(loop, 0);
+		if (timer.period) {
+			timer.deadline += timer.period;
+			if (timer.deadline <= now)
+				timer.deadline = now + timer.period;
+			_runloop_timer_push(loop, &timer);
+		}
+		timer.fn(loop, timer.id, timer.arg);
+		++dispatched;
+	}
+	return dispatched;
+}
+
+static bool
+_runloop_entry_removed(const void* element, void* data) {
+	FOUNDATION_UNUSED(data);
+	//Stream and source entries both start with the registered object pointer
+	return !(*(const void* const*)element);
+}
+
+size_t
+runloop_run_once(runloop_t* loop, unsigned int milliseconds) {
+	int slots[RUNLOOP_WAIT_SLOTS];
+	size_t fired, islot, dispatched;
+	bool stream_fired = false;
+	tick_t deadline, now;
+
+	deadline = _runloop_next_deadline(loop);
+	if (deadline && milliseconds) {
+		tick_t ticks_per_second = time_ticks_per_second();
+		tick_t remain;
+		now = time_current();
+		remain = (deadline > now) ? (deadline - now) : 0;
+		//Round up so the wait does not return just before the deadline
+		if (remain < (ticks_per_second * (tick_t)milliseconds) / 1000)
+			milliseconds = (unsigned int)(((remain * 1000) + ticks_per_second - 1) / ticks_per_second);
+	}
+
+	fired = beacon_try_wait_many(&loop->beacon, milliseconds, slots, RUNLOOP_WAIT_SLOTS);
+	for (islot = 0; islot < fired; ++islot) {
+		if (!slots[islot])
+			stream_fired = true;
+	}
+
+	loop->dispatching = true;
+	dispatched = _runloop_dispatch_sources(loop, slots, fired);
+	now = time_current();
+	dispatched += _runloop_dispatch_streams(loop, stream_fired, now);
+	dispatched += _runloop_dispatch_timers(loop, now);
+	loop->dispatching = false;
+
+	if (loop->removed) {
+		array_erase_ordered_if(loop->streams, _runloop_entry_removed, nullptr);
+		array_erase_ordered_if(loop->sources, _runloop_entry_removed, nullptr);
+		loop->removed = false;
+	}
+
+	return dispatched;
+}
+
+void
+runloop_run(runloop_t* loop) {
+	while (!atomic_load32(&loop->stop))
+		runloop_run_once(loop, (unsigned int)-1);
+	atomic_store32(&loop->stop, 0);
+}
+
+void
+runloop_stop(runloop_t* loop) {
+	atomic_store32(&loop->stop, 1);
+	beacon_fire(&loop->beacon);
+}
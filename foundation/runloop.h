@@ -0,0 +1,128 @@
+/* runloop.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file runloop.h
+\brief Run loop dispatching event streams, beacons and timers
+
+Run loop waiting on all registered sources in a single beacon wait (epoll, kqueue or
+WaitForMultipleObjects depending on platform) and dispatching ready sources to callbacks.
+
+Event streams, for example #fs_event_stream and #system_event_stream, fire the beacon of the
+run loop when events are posted and are processed in the next pass, with the callback receiving
+the processed event block. Delayed events are delivered when due without any event being
+posted. Beacons are linked to the beacon of the run loop and consumed before the callback is
+called. Timers are kept in a min-heap ordered by deadline.
+
+Each pass sleeps until a source fires or the earliest timer or delayed event deadline is
+reached, there are no polling wakeups. Registering sources and running the loop must be done
+on the same thread, except #runloop_stop which can be called from any thread. Sources can be
+added and removed from inside callbacks. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a new run loop. Deallocate with a call to #runloop_deallocate
+\return New run loop */
+FOUNDATION_API runloop_t*
+runloop_allocate(void);
+
+/*! Deallocate a run loop previously allocated with #runloop_allocate
+\param loop Run loop */
+FOUNDATION_API void
+runloop_deallocate(runloop_t* loop);
+
+/*! Initialize a run loop. Finalize with a call to #runloop_finalize
+\param loop Run loop */
+FOUNDATION_API void
+runloop_initialize(runloop_t* loop);
+
+/*! Finalize a run loop previously initialized with #runloop_initialize. Registered event
+streams are reset to not fire any beacon and registered beacons are unlinked.
+\param loop Run loop */
+FOUNDATION_API void
+runloop_finalize(runloop_t* loop);
+
+/*! Register an event stream in the run loop. The stream is set to fire the beacon of the run
+loop, replacing any beacon previously set with #event_stream_set_beacon, and must not be
+processed by anyone else while registered.
+\param loop   Run loop
+\param stream Event stream
+\param fn     Callback receiving processed event blocks
+\param arg    Callback argument */
+FOUNDATION_API void
+runloop_add_stream(runloop_t* loop, event_stream_t* stream, runloop_stream_fn fn, void* arg);
+
+/*! Remove an event stream from the run loop and reset the stream to not fire any beacon
+\param loop   Run loop
+\param stream Event stream */
+FOUNDATION_API void
+runloop_remove_stream(runloop_t* loop, event_stream_t* stream);
+
+/*! Register a beacon in the run loop. The callback is called after the fired beacon has been
+waited on, so the beacon should not be waited on by anyone else while registered. Not
+available on platforms lacking #beacon_add.
+\param loop   Run loop
+\param beacon Beacon
+\param fn     Callback
+\param arg    Callback argument
+\return       true if registered, false if the beacon could not be linked */
+FOUNDATION_API bool
+runloop_add_beacon(runloop_t* loop, beacon_t* beacon, runloop_beacon_fn fn, void* arg);
+
+/*! Remove a beacon from the run loop
+\param loop   Run loop
+\param beacon Beacon */
+FOUNDATION_API void
+runloop_remove_beacon(runloop_t* loop, beacon_t* beacon);
+
+/*! Add a timer to the run loop. Periodic timers are rescheduled relative to the previous
+deadline to avoid drift, skipping missed periods if the loop falls behind.
+\param loop         Run loop
+\param delay_ms     Delay in milliseconds until first call
+\param period_ms    Period in milliseconds, zero for a one-shot timer
+\param fn           Callback
+\param arg          Callback argument
+\return             Timer id, never zero */
+FOUNDATION_API unsigned int
+runloop_add_timer(runloop_t* loop, unsigned int delay_ms, unsigned int period_ms,
+                  runloop_timer_fn fn, void* arg);
+
+/*! Cancel a pending timer. One-shot timers are removed once called, cancelling a periodic
+timer from its own callback stops further calls.
+\param loop Run loop
+\param id   Timer id returned by #runloop_add_timer
+\return     true if the timer was pending, false if not found */
+FOUNDATION_API bool
+runloop_cancel_timer(runloop_t* loop, unsigned int id);
+
+/*! Wait until a source fires, the earliest deadline is reached or the given timeout expires,
+then dispatch all ready sources.
+\param loop         Run loop
+\param milliseconds Maximum time to wait in milliseconds, 0 to only dispatch sources already
+                    ready, (unsigned int)-1 to wait without timeout
+\return             Number of callbacks called */
+FOUNDATION_API size_t
+runloop_run_once(runloop_t* loop, unsigned int milliseconds);
+
+/*! Run the loop until stopped with #runloop_stop. The stop flag is cleared on return so the
+loop can be run again.
+\param loop Run loop */
+FOUNDATION_API void
+runloop_run(runloop_t* loop);
+
+/*! Stop a loop running in #runloop_run after the current pass. Can be called from any thread
+and from inside callbacks.
+\param loop Run loop */
+FOUNDATION_API void
+runloop_stop(runloop_t* loop);
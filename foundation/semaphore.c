@@ -26,11 +26,15 @@ extern int MPWaitOnSemaphore(MPSemaphoreID, int);
 #  include <foundation/apple.h>
 #  include <dispatch/dispatch.h>
 #  include <errno.h>
-#elif FOUNDATION_PLATFORM_ANDROID
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+#  include <foundation/posix.h>
 #  include <time.h>
-#  include <semaphore.h>
-#  include <asm/fcntl.h>
-#  define native_sem_t sem_t
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  if !FOUNDATION_PLATFORM_ANDROID
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#  endif
 #elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
 #  include <time.h>
 #  include <semaphore.h>
@@ -66,14 +70,14 @@ semaphore_finalize(semaphore_t* semaphore) {
 	CloseHandle((HANDLE)*semaphore);
 }
 
-bool
-semaphore_wait(semaphore_t* semaphore) {
+static bool
+_semaphore_wait(semaphore_t* semaphore) {
 	DWORD res = WaitForSingleObject((HANDLE)*semaphore, INFINITE);
 	return (res == WAIT_OBJECT_0);
 }
 
-bool
-semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+static bool
+_semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
 	DWORD res = WaitForSingleObject((HANDLE)*semaphore, milliseconds);
 	return (res == WAIT_OBJECT_0);
 }
@@ -145,8 +149,8 @@ semaphore_finalize(semaphore_t* semaphore) {
 	}
 }
 
-bool
-semaphore_wait(semaphore_t* semaphore) {
+static bool
+_semaphore_wait(semaphore_t* semaphore) {
 	if (!semaphore->name.length) {
 		int ret = MPWaitOnSemaphore(semaphore->sem.unnamed, 0x7FFFFFFF/*kDurationForever*/);
 		if (ret < 0)
@@ -172,8 +176,8 @@ semaphore_wait(semaphore_t* semaphore) {
 	return true;
 }
 
-bool
-semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+static bool
+_semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
 	if (!semaphore->name.length) {
 		unsigned int duration = 0/*kDurationImmediate*/;
 		if (milliseconds > 0)
@@ -244,14 +248,14 @@ semaphore_finalize(semaphore_t* semaphore) {
 		dispatch_release(*semaphore);
 }
 
-bool
-semaphore_wait(semaphore_t* semaphore) {
+static bool
+_semaphore_wait(semaphore_t* semaphore) {
 	long result = dispatch_semaphore_wait(*semaphore, DISPATCH_TIME_FOREVER);
 	return (result == 0);
 }
 
-bool
-semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+static bool
+_semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
 	long result = dispatch_semaphore_wait(*semaphore, (milliseconds > 0) ?
 	                                      dispatch_time(DISPATCH_TIME_NOW, 1000000LL * (int64_t)milliseconds) :
 	                                      DISPATCH_TIME_NOW);
@@ -263,6 +267,178 @@ semaphore_post(semaphore_t* semaphore) {
 	dispatch_semaphore_signal(*semaphore);
 }
 
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+//Linux & Android:
+//unnamed - atomic counter in semaphore, futex private to process
+//named - atomic counter in shared memory object, futex shared between processes
+//Post and uncontended wait only touch the counter, threads only enter the kernel
+//when blocking on an empty semaphore or waking a blocked thread
+
+static semaphore_futex_t*
+_semaphore_futex(semaphore_t* semaphore) {
+	return semaphore->shared ? semaphore->shared : &semaphore->unnamed;
+}
+
+static void
+_semaphore_futex_initialize(semaphore_futex_t* futex, unsigned int value) {
+	atomic_store32(&futex->count, (int32_t)value);
+	atomic_store32(&futex->waiters, 0);
+	atomic_store32(&futex->initialized, 2);
+}
+
+static bool
+_semaphore_futex_try_decrement(semaphore_futex_t* futex) {
+	int32_t count = atomic_load32(&futex->count);
+	while (count > 0) {
+		if (atomic_cas32(&futex->count, count - 1, count))
+			return true;
+		count = atomic_load32(&futex->count);
+	}
+	return false;
+}
+
+void
+semaphore_initialize(semaphore_t* semaphore, unsigned int value) {
+	FOUNDATION_ASSERT(value <= 0xFFFF);
+
+	semaphore->name = (string_t) { 0, 0 };
+	semaphore->shared = 0;
+	_semaphore_futex_initialize(&semaphore->unnamed, value);
+}
+
+void
+semaphore_initialize_named(semaphore_t* semaphore, const char* name, size_t length,
+                           unsigned int value) {
+	FOUNDATION_ASSERT(name);
+	FOUNDATION_ASSERT(value <= 0xFFFF);
+
+	semaphore->shared = 0;
+	_semaphore_futex_initialize(&semaphore->unnamed, 0);
+
+#if FOUNDATION_PLATFORM_ANDROID
+	semaphore->name = (string_t) { 0, 0 };
+	FOUNDATION_ASSERT_FAIL("Named semaphores not supported on this platform");
+	FOUNDATION_UNUSED(name);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(value);
+#else
+	semaphore_futex_t* futex;
+	int fd;
+
+	if (name && (length > 0) && (name[0] != '/'))
+		semaphore->name = string_allocate_format(STRING_CONST("/%.*s"), (int)length, name);
+	else
+		semaphore->name = string_clone(name, length);
+
+	fd = shm_open(semaphore->name.str, O_RDWR | O_CREAT, (mode_t)0666);
+	if (fd < 0) {
+		int err = system_error();
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to initialize named semaphore (shm_open '%.*s'): %.*s (%d)"),
+		           STRING_FORMAT(semaphore->name), STRING_FORMAT(errmsg), err);
+		return;
+	}
+
+	futex = MAP_FAILED;
+	if (ftruncate(fd, (off_t)sizeof(semaphore_futex_t)) == 0)
+		futex = mmap(0, sizeof(semaphore_futex_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (futex == MAP_FAILED) {
+		int err = system_error();
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to map named semaphore '%.*s': %.*s (%d)"),
+		           STRING_FORMAT(semaphore->name), STRING_FORMAT(errmsg), err);
+		close(fd);
+		return;
+	}
+	close(fd);
+
+	//First process to open the shared object sets the initial value, others wait for it
+	if (atomic_cas32(&futex->initialized, 1, 0)) {
+		atomic_store32(&futex->count, (int32_t)value);
+		atomic_thread_fence_release();
+		atomic_store32(&futex->initialized, 2);
+	}
+	else {
+		while (atomic_load32(&futex->initialized) != 2)
+			thread_yield();
+		atomic_thread_fence_acquire();
+	}
+
+	semaphore->shared = futex;
+#endif
+}
+
+void
+semaphore_finalize(semaphore_t* semaphore) {
+#if !FOUNDATION_PLATFORM_ANDROID
+	if (semaphore->shared) {
+		shm_unlink(semaphore->name.str);
+		munmap(semaphore->shared, sizeof(semaphore_futex_t));
+		semaphore->shared = 0;
+	}
+#endif
+	if (semaphore->name.length)
+		string_deallocate(semaphore->name.str);
+	semaphore->name = (string_t) { 0, 0 };
+}
+
+static bool
+_semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+	semaphore_futex_t* futex = _semaphore_futex(semaphore);
+	int op = semaphore->shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+	tick_t ticks_per_sec;
+	tick_t deadline = 0;
+	bool acquired;
+
+	if (_semaphore_futex_try_decrement(futex))
+		return true;
+	if (!milliseconds)
+		return false;
+
+	ticks_per_sec = time_ticks_per_second();
+	if (milliseconds != 0xFFFFFFFF)
+		deadline = time_current() + (((tick_t)milliseconds * ticks_per_sec) / 1000LL);
+
+	//Announce waiter before final check of counter, a post either sees the waiter
+	//and wakes the futex or the check below sees the incremented counter
+	atomic_incr32(&futex->waiters);
+	while (!(acquired = _semaphore_futex_try_decrement(futex))) {
+		struct timespec timeout;
+		struct timespec* ptimeout = 0;
+		if (deadline) {
+			tick_t now = time_current();
+			tick_t remain;
+			if (now >= deadline)
+				break;
+			remain = deadline - now;
+			timeout.tv_sec = (time_t)(remain / ticks_per_sec);
+			timeout.tv_nsec = (long)(((remain % ticks_per_sec) * 1000000000LL) / ticks_per_sec);
+			ptimeout = &timeout;
+		}
+		syscall(SYS_futex, &futex->count, op, 0, ptimeout, 0, 0);
+	}
+	atomic_decr32(&futex->waiters);
+
+	return acquired;
+}
+
+static bool
+_semaphore_wait(semaphore_t* semaphore) {
+	return _semaphore_try_wait(semaphore, 0xFFFFFFFF);
+}
+
+void
+semaphore_post(semaphore_t* semaphore) {
+	semaphore_futex_t* futex = _semaphore_futex(semaphore);
+	atomic_incr32(&futex->count);
+	if (atomic_load32(&futex->waiters))
+		syscall(SYS_futex, &futex->count, semaphore->shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, 1, 0,
+		        0, 0);
+}
+
 #elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
 
 void
@@ -329,13 +505,13 @@ semaphore_finalize(semaphore_t* semaphore) {
 	}
 }
 
-bool
-semaphore_wait(semaphore_t* semaphore) {
+static bool
+_semaphore_wait(semaphore_t* semaphore) {
 	return sem_wait((native_sem_t*)semaphore->sem) == 0;
 }
 
-bool
-semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+static bool
+_semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
 	if (milliseconds > 0) {
 #if FOUNDATION_PLATFORM_PNACL
 		//PNaCl busy wait/yield simulation of sem_timedwait
@@ -373,3 +549,39 @@ semaphore_post(semaphore_t* semaphore) {
 #  error Not implemented
 #endif
 
+bool
+semaphore_wait(semaphore_t* semaphore) {
+	tick_t start;
+	bool was_signaled;
+
+	//Try first so only blocking waits are timed
+	if (_semaphore_try_wait(semaphore, 0))
+		return true;
+	start = time_current();
+	was_signaled = _semaphore_wait(semaphore);
+#if !BUILD_DEPLOY
+	profile_contention(STRING_CONST("semaphore_wait"), start, time_current());
+#else
+	FOUNDATION_UNUSED(start);
+#endif
+	return was_signaled;
+}
+
+bool
+semaphore_try_wait(semaphore_t* semaphore, unsigned int milliseconds) {
+	tick_t start;
+	bool was_signaled;
+
+	if (_semaphore_try_wait(semaphore, 0))
+		return true;
+	if (!milliseconds)
+		return false;
+	start = time_current();
+	was_signaled = _semaphore_try_wait(semaphore, milliseconds);
+#if !BUILD_DEPLOY
+	profile_contention(STRING_CONST("semaphore_wait"), start, time_current());
+#else
+	FOUNDATION_UNUSED(start);
+#endif
+	return was_signaled;
+}
@@ -16,7 +16,15 @@
 \brief Semaphore
 
 Semaphore for thread synchronization and notification. For more information, see
-https://en.wikipedia.org/wiki/Semaphore_(programming) */
+https://en.wikipedia.org/wiki/Semaphore_(programming)
+
+On Linux and Android the semaphore is an atomic counter and posting or waiting on a
+semaphore with a non-zero value does not enter the kernel. Only threads blocking on an
+empty semaphore wait on a futex. Named semaphores keep the counter in a shared memory
+object and are not supported on Android.
+
+Blocking waits longer than the profile contention threshold generate a profile block named
+semaphore_wait, see #profile_contention. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
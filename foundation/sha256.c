@@ -0,0 +1,333 @@
+/* sha256.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define SHA256_SHANI 1
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define SHA256_TARGET_SHANI
+#  else
+#    define SHA256_TARGET_SHANI __attribute__((target("sha,ssse3,sse4.1")))
+#  endif
+#elif defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#  define SHA256_ARM 1
+#  include <arm_neon.h>
+#endif
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA256_CH(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA256_MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_S0(x) (SHA256_ROTR(x, 2) ^ SHA256_ROTR(x, 13) ^ SHA256_ROTR(x, 22))
+#define SHA256_S1(x) (SHA256_ROTR(x, 6) ^ SHA256_ROTR(x, 11) ^ SHA256_ROTR(x, 25))
+#define SHA256_G0(x) (SHA256_ROTR(x, 7) ^ SHA256_ROTR(x, 18) ^ ((x) >> 3))
+#define SHA256_G1(x) (SHA256_ROTR(x, 17) ^ SHA256_ROTR(x, 19) ^ ((x) >> 10))
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static void
+sha256_transform_software(uint32_t* state, const unsigned char* data, size_t blocks) {
+	uint32_t w[64];
+	uint32_t a, b, c, d, e, f, g, h, t1, t2;
+	size_t i;
+
+	for (; blocks; --blocks, data += 64) {
+		for (i = 0; i < 16; ++i)
+			w[i] = ((uint32_t)data[i * 4] << 24) | ((uint32_t)data[(i * 4) + 1] << 16) |
+			       ((uint32_t)data[(i * 4) + 2] << 8) | (uint32_t)data[(i * 4) + 3];
+		for (i = 16; i < 64; ++i)
+			w[i] = SHA256_G1(w[i - 2]) + w[i - 7] + SHA256_G0(w[i - 15]) + w[i - 16];
+
+		a = state[0]; b = state[1]; c = state[2]; d = state[3];
+		e = state[4]; f = state[5]; g = state[6]; h = state[7];
+		for (i = 0; i < 64; ++i) {
+			t1 = h + SHA256_S1(e) + SHA256_CH(e, f, g) + sha256_k[i] + w[i];
+			t2 = SHA256_S0(a) + SHA256_MAJ(a, b, c);
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+}
+
+#if SHA256_SHANI
+
+static int _sha256_hardware = -1;
+
+static bool
+sha256_hardware_supported(void) {
+	if (_sha256_hardware < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		bool supported = false;
+		__cpuid(info, 1);
+		//Require SSSE3 and SSE4.1 for the byte shuffles and blends
+		if ((info[2] & (1 << 9)) && (info[2] & (1 << 19))) {
+			__cpuidex(info, 7, 0);
+			supported = (info[1] & (1 << 29)) != 0;
+		}
+		_sha256_hardware = supported ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		_sha256_hardware = (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) ?
+		                   1 : 0;
+#endif
+	}
+	return _sha256_hardware > 0;
+}
+
+static SHA256_TARGET_SHANI void
+sha256_transform_hardware(uint32_t* state, const unsigned char* data, size_t blocks) {
+	const __m128i swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+	__m128i msg[4];
+	__m128i state0, state1, abef, cdgh, value, tmp;
+	unsigned int group;
+
+	//Rearrange state from ABCD/EFGH to the ABEF/CDGH order used by the instructions
+	tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(const void*)state), 0xb1);
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(const void*)(state + 4)), 0x1b);
+	state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+	for (; blocks; --blocks, data += 64) {
+		abef = state0;
+		cdgh = state1;
+
+		//Each group does four rounds, extending the message schedule four words ahead
+		for (group = 0; group < 16; ++group) {
+			if (group < 4)
+				msg[group] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(const void*)(data +
+				                                              (group * 16))), swap);
+			value = _mm_add_epi32(msg[group & 3],
+			                      _mm_loadu_si128((const __m128i*)(const void*)(sha256_k + (group * 4))));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, value);
+			if ((group >= 3) && (group < 15)) {
+				tmp = _mm_alignr_epi8(msg[group & 3], msg[(group + 3) & 3], 4);
+				msg[(group + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(msg[(group + 1) & 3], tmp),
+				                                            msg[group & 3]);
+			}
+			value = _mm_shuffle_epi32(value, 0x0e);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, value);
+			if ((group >= 1) && (group < 13))
+				msg[(group + 3) & 3] = _mm_sha256msg1_epu32(msg[(group + 3) & 3], msg[group & 3]);
+		}
+
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	_mm_storeu_si128((__m128i*)(void*)state, _mm_blend_epi16(tmp, state1, 0xf0));
+	_mm_storeu_si128((__m128i*)(void*)(state + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#elif SHA256_ARM
+
+static bool
+sha256_hardware_supported(void) {
+	return true;
+}
+
+static void
+sha256_transform_hardware(uint32_t* state, const unsigned char* data, size_t blocks) {
+	uint32x4_t state0 = vld1q_u32(state);
+	uint32x4_t state1 = vld1q_u32(state + 4);
+	uint32x4_t msg[4];
+	uint32x4_t abcd, efgh, value, prev;
+	unsigned int group;
+
+	for (; blocks; --blocks, data += 64) {
+		abcd = state0;
+		efgh = state1;
+
+		for (group = 0; group < 4; ++group)
+			msg[group] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + (group * 16))));
+
+		//Each group does four rounds, extending the message schedule four words ahead
+		for (group = 0; group < 16; ++group) {
+			value = vaddq_u32(msg[group & 3], vld1q_u32(sha256_k + (group * 4)));
+			if (group < 12)
+				msg[group & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[group & 3], msg[(group + 1) & 3]),
+				                                 msg[(group + 2) & 3], msg[(group + 3) & 3]);
+			prev = state0;
+			state0 = vsha256hq_u32(state0, state1, value);
+			state1 = vsha256h2q_u32(state1, prev, value);
+		}
+
+		state0 = vaddq_u32(state0, abcd);
+		state1 = vaddq_u32(state1, efgh);
+	}
+
+	vst1q_u32(state, state0);
+	vst1q_u32(state + 4, state1);
+}
+
+#endif
+
+static void
+sha256_transform(sha256_t* digest, const unsigned char* data, size_t blocks) {
+#if SHA256_SHANI || SHA256_ARM
+	if (sha256_hardware_supported()) {
+		sha256_transform_hardware(digest->state, data, blocks);
+		return;
+	}
+#endif
+	sha256_transform_software(digest->state, data, blocks);
+}
+
+sha256_t*
+sha256_allocate(void) {
+	sha256_t* digest = memory_allocate(0, sizeof(sha256_t), 0, MEMORY_PERSISTENT);
+
+	sha256_initialize(digest);
+
+	return digest;
+}
+
+void
+sha256_deallocate(sha256_t* digest) {
+	sha256_finalize(digest);
+	memory_deallocate(digest);
+}
+
+void
+sha256_initialize(sha256_t* digest) {
+	digest->init = false;
+	digest->state[0] = 0x6a09e667U;
+	digest->state[1] = 0xbb67ae85U;
+	digest->state[2] = 0x3c6ef372U;
+	digest->state[3] = 0xa54ff53aU;
+	digest->state[4] = 0x510e527fU;
+	digest->state[5] = 0x9b05688cU;
+	digest->state[6] = 0x1f83d9abU;
+	digest->state[7] = 0x5be0cd19U;
+	digest->count = 0;
+
+	memset(digest->buffer, 0, 64);
+}
+
+void
+sha256_finalize(sha256_t* digest) {
+	FOUNDATION_UNUSED(digest);
+}
+
+sha256_t*
+sha256_digest(sha256_t* digest, const void* buffer, size_t size) {
+	const unsigned char* data = buffer;
+	size_t index_buf, space_buf, blocks;
+
+	if (!digest)
+		digest = sha256_allocate();
+	if (digest->init)
+		sha256_initialize(digest);
+
+	index_buf = (size_t)(digest->count & 63);
+	digest->count += size;
+
+	if (index_buf) {
+		space_buf = 64 - index_buf;
+		if (size < space_buf) {
+			memcpy(digest->buffer + index_buf, data, size);
+			return digest;
+		}
+		memcpy(digest->buffer + index_buf, data, space_buf);
+		sha256_transform(digest, digest->buffer, 1);
+		data += space_buf;
+		size -= space_buf;
+	}
+
+	//Full blocks are digested directly from the input buffer
+	blocks = size / 64;
+	if (blocks) {
+		sha256_transform(digest, data, blocks);
+		data += blocks * 64;
+		size -= blocks * 64;
+	}
+
+	if (size)
+		memcpy(digest->buffer, data, size);
+
+	return digest;
+}
+
+void
+sha256_digest_finalize(sha256_t* digest) {
+	uint64_t bits;
+	size_t index_buf, ibyte;
+
+	if (!digest)
+		return;
+
+	bits = digest->count << 3ULL;
+	index_buf = (size_t)(digest->count & 63);
+	digest->buffer[index_buf++] = 0x80;
+	if (index_buf > 56) {
+		memset(digest->buffer + index_buf, 0, 64 - index_buf);
+		sha256_transform(digest, digest->buffer, 1);
+		index_buf = 0;
+	}
+	memset(digest->buffer + index_buf, 0, 56 - index_buf);
+	for (ibyte = 0; ibyte < 8; ++ibyte)
+		digest->buffer[63 - ibyte] = (unsigned char)(bits >> (ibyte * 8));
+	sha256_transform(digest, digest->buffer, 1);
+
+	for (ibyte = 0; ibyte < 32; ++ibyte)
+		digest->digest[ibyte] = (unsigned char)(digest->state[ibyte / 4] >> (24 - ((ibyte & 3) * 8)));
+
+	memset(digest->buffer, 0, 64);
+
+	digest->init = true;
+}
+
+uint256_t
+sha256_get_digest_raw(const sha256_t* digest) {
+	uint256_t val = uint256_null();
+	if (digest)
+		memcpy(&val, digest->digest, sizeof(uint256_t));
+	return val;
+}
+
+string_t
+sha256_get_digest(const sha256_t* digest, char* str, size_t length) {
+	const char trn[17] = "0123456789ABCDEF";
+	size_t i, j, num;
+
+	if (!digest)
+		return (string_t) { 0, 0 };
+
+	num = length / 2;
+	if (num > 32)
+		num = 32;
+
+	for (i = 0, j = 0; i < num; ++i, j += 2) {
+		str[j]   = trn[ digest->digest[i] / 16 ];
+		str[j + 1] = trn[ digest->digest[i] % 16 ];
+	}
+	if (length > 64)
+		str[64] = 0;
+
+	return (string_t) {str, num * 2};
+}
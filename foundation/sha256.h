@@ -0,0 +1,89 @@
+/* sha256.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file sha256.h
+\brief SHA-256 algorithm
+
+SHA-256 message-digest algorithm (FIPS 180-4). Blocks are digested with the SHA extensions on
+x86 processors and the cryptography extensions on ARMv8 processors if available, with a
+portable implementation used otherwise.
+
+The API mirrors the MD5 API, normal use case is to first allocate/initialize the SHA-256 block,
+then do any number of initialize-digest-finalize call sequences:
+
+<pre>sha256_initialize()
+sha256_digest()
+sha256_digest()
+... //More digest operations
+sha256_digest_finalize()
+sha256_get_digest()
+sha256_get_digest_raw()
+... //More initialize, digest sequences
+sha256_finalize()</pre> */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a new SHA-256 block and initialize for digestion.
+\return New SHA-256 block */
+FOUNDATION_API sha256_t*
+sha256_allocate(void);
+
+/*! Deallocate SHA-256 block
+\param digest SHA-256 block */
+FOUNDATION_API void
+sha256_deallocate(sha256_t* digest);
+
+/*! Initialize SHA-256 block. Must be called before each block of digest operations
+with #sha256_digest
+\param digest SHA-256 block */
+FOUNDATION_API void
+sha256_initialize(sha256_t* digest);
+
+/*! Finalize SHA-256 block previously initialized with #sha256_initialize. After this call the
+block may no longer be used until a new #sha256_initialize call is made.
+\param digest SHA-256 block */
+FOUNDATION_API void
+sha256_finalize(sha256_t* digest);
+
+/*! Digest a raw data buffer.
+\param digest SHA-256 block
+\param buffer Data to digest
+\param size Size of buffer
+\return SHA-256 block */
+FOUNDATION_API sha256_t*
+sha256_digest(sha256_t* digest, const void* buffer, size_t size);
+
+/*! Finalize digest. Must be called between digesting data with #sha256_digest
+and getting the final message digest with #sha256_get_digest/#sha256_get_digest_raw. If a new
+digest sequence is required the block must be re-initialized with a call to #sha256_initialize.
+\param digest SHA-256 block */
+FOUNDATION_API void
+sha256_digest_finalize(sha256_t* digest);
+
+/*! Get digest as string. Before getting the digest string the SHA-256 block must be
+finalized with a call to #sha256_digest_finalize.
+\param digest SHA-256 block
+\param str String buffer
+\param length Length of string buffer, 64 characters required for the full digest
+\return Message digest string */
+FOUNDATION_API string_t
+sha256_get_digest(const sha256_t* digest, char* str, size_t length);
+
+/*! Get digest as raw 256-bit value, holding the digest bytes in order. Before getting the raw
+digest the SHA-256 block must be finalized with a call to #sha256_digest_finalize.
+\param digest SHA-256 block
+\return Message digest */
+FOUNDATION_API uint256_t
+sha256_get_digest_raw(const sha256_t* digest);
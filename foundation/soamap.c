@@ -0,0 +1,157 @@
+/* soamap.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#define SOAMAP_MIN_CAPACITY 16
+#define SOAMAP_FIELD_ALIGN  16
+
+static void
+_soamap_grow_rows(soamap_t* map, size_t capacity) {
+	size_t ifield;
+	for (ifield = 0; ifield < map->num_fields; ++ifield) {
+		size_t size = map->field_size[ifield];
+		if (map->field[ifield])
+			map->field[ifield] = memory_reallocate(map->field[ifield], size * capacity, SOAMAP_FIELD_ALIGN,
+			                                       size * map->count);
+		else
+			map->field[ifield] = memory_allocate(0, size * capacity, SOAMAP_FIELD_ALIGN, MEMORY_PERSISTENT);
+	}
+	if (map->object)
+		map->object = memory_reallocate(map->object, sizeof(object_t) * capacity, 0,
+		                                sizeof(object_t) * map->count);
+	else
+		map->object = memory_allocate(0, sizeof(object_t) * capacity, 0, MEMORY_PERSISTENT);
+	map->capacity = capacity;
+}
+
+static void
+_soamap_grow_sparse(soamap_t* map, size_t slot) {
+	size_t size = map->sparse_size ? map->sparse_size : SOAMAP_MIN_CAPACITY;
+	while (size <= slot)
+		size <<= 1;
+	if (map->sparse)
+		map->sparse = memory_reallocate(map->sparse, sizeof(uint32_t) * size, 0,
+		                                sizeof(uint32_t) * map->sparse_size);
+	else
+		map->sparse = memory_allocate(0, sizeof(uint32_t) * size, 0, MEMORY_PERSISTENT);
+	memset(map->sparse + map->sparse_size, 0, sizeof(uint32_t) * (size - map->sparse_size));
+	map->sparse_size = size;
+}
+
+soamap_t*
+soamap_allocate(const objectmap_t* objects, const size_t* field_size, size_t num_fields,
+                size_t capacity) {
+	soamap_t* map = memory_allocate(0, sizeof(soamap_t), 0, MEMORY_PERSISTENT);
+
+	soamap_initialize(map, objects, field_size, num_fields, capacity);
+
+	return map;
+}
+
+void
+soamap_deallocate(soamap_t* map) {
+	soamap_finalize(map);
+	memory_deallocate(map);
+}
+
+void
+soamap_initialize(soamap_t* map, const objectmap_t* objects, const size_t* field_size,
+                  size_t num_fields, size_t capacity) {
+	size_t ifield;
+
+	FOUNDATION_ASSERT_MSG(num_fields <= SOAMAP_MAX_FIELDS, "Too many fields in structure of arrays map");
+	if (num_fields > SOAMAP_MAX_FIELDS)
+		num_fields = SOAMAP_MAX_FIELDS;
+
+	memset(map, 0, sizeof(soamap_t));
+	map->mask_index = objects->mask_index;
+	map->num_fields = num_fields;
+	for (ifield = 0; ifield < num_fields; ++ifield)
+		map->field_size[ifield] = field_size[ifield];
+
+	_soamap_grow_rows(map, (capacity < SOAMAP_MIN_CAPACITY) ? SOAMAP_MIN_CAPACITY : capacity);
+}
+
+void
+soamap_finalize(soamap_t* map) {
+	size_t ifield;
+	for (ifield = 0; ifield < map->num_fields; ++ifield)
+		memory_deallocate(map->field[ifield]);
+	memory_deallocate(map->object);
+	memory_deallocate(map->sparse);
+	memset(map, 0, sizeof(soamap_t));
+}
+
+size_t
+soamap_insert(soamap_t* map, object_t id) {
+	size_t slot = (size_t)(id & map->mask_index);
+	size_t row = soamap_index(map, id);
+	size_t ifield;
+
+	if (row != SOAMAP_INVALID)
+		return row;
+
+	if (slot >= map->sparse_size)
+		_soamap_grow_sparse(map, slot);
+	else if (map->sparse[slot]) {
+		//Slot reused by a newer handle, drop the row of the outdated handle
+		soamap_remove(map, map->object[map->sparse[slot] - 1]);
+	}
+	if (map->count >= map->capacity)
+		_soamap_grow_rows(map, map->capacity * 2);
+
+	row = map->count++;
+	for (ifield = 0; ifield < map->num_fields; ++ifield)
+		memset(pointer_offset(map->field[ifield], row * map->field_size[ifield]), 0,
+		       map->field_size[ifield]);
+	map->object[row] = id;
+	map->sparse[slot] = (uint32_t)(row + 1);
+	return row;
+}
+
+bool
+soamap_remove(soamap_t* map, object_t id) {
+	size_t row = soamap_index(map, id);
+	size_t last, ifield;
+
+	if (row == SOAMAP_INVALID)
+		return false;
+
+	//Swap remove, move last row into the removed row
+	last = --map->count;
+	if (row != last) {
+		for (ifield = 0; ifield < map->num_fields; ++ifield) {
+			size_t size = map->field_size[ifield];
+			memcpy(pointer_offset(map->field[ifield], row * size),
+			       pointer_offset(map->field[ifield], last * size), size);
+		}
+		map->object[row] = map->object[last];
+		map->sparse[map->object[row] & map->mask_index] = (uint32_t)(row + 1);
+	}
+	map->sparse[id & map->mask_index] = 0;
+	return true;
+}
+
+void
+soamap_reserve(soamap_t* map, size_t capacity) {
+	if (capacity > map->capacity)
+		_soamap_grow_rows(map, capacity);
+}
+
+void
+soamap_clear(soamap_t* map) {
+	size_t row;
+	for (row = 0; row < map->count; ++row)
+		map->sparse[map->object[row] & map->mask_index] = 0;
+	map->count = 0;
+}
@@ -0,0 +1,157 @@
+/* soamap.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file soamap.h
+\brief Structure of arrays storage keyed by object handles
+
+Structure of arrays storage keyed by object handles. Each stored handle owns a row with one
+element in each field, and each field is stored as a single contiguous array over all rows.
+Rows are kept densely packed, removing a row moves the last row into its place, so batch
+processing can iterate each field array linearly from index zero to #soamap_size.
+
+Handles are the handles of an object map, the slot index of a handle selects the entry in a
+sparse array holding the row index, and the full handle including the ID tag is compared on
+lookup, so outdated handles for a reused slot are rejected.
+
+Access is not atomic and therefor not thread safe, provide external synchronization in
+caller if needed. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate new structure of arrays map for handles of the given object map. Structure of
+arrays map should be deallocated with a call to #soamap_deallocate
+\param objects    Object map issuing the handles
+\param field_size Array of element sizes, one for each field
+\param num_fields Number of fields, at most #SOAMAP_MAX_FIELDS
+\param capacity   Initial row capacity
+\return           New structure of arrays map */
+FOUNDATION_API soamap_t*
+soamap_allocate(const objectmap_t* objects, const size_t* field_size, size_t num_fields,
+                size_t capacity);
+
+/*! Deallocate a structure of arrays map previously allocated with #soamap_allocate
+\param map Structure of arrays map */
+FOUNDATION_API void
+soamap_deallocate(soamap_t* map);
+
+/*! Initialize new structure of arrays map, see #soamap_allocate. Structure of arrays map
+should be finalized with a call to #soamap_finalize
+\param map        Structure of arrays map
+\param objects    Object map issuing the handles
+\param field_size Array of element sizes, one for each field
+\param num_fields Number of fields, at most #SOAMAP_MAX_FIELDS
+\param capacity   Initial row capacity */
+FOUNDATION_API void
+soamap_initialize(soamap_t* map, const objectmap_t* objects, const size_t* field_size,
+                  size_t num_fields, size_t capacity);
+
+/*! Finalize a structure of arrays map previously initialized with #soamap_initialize and
+free resources
+\param map Structure of arrays map */
+FOUNDATION_API void
+soamap_finalize(soamap_t* map);
+
+/*! Add a row for the given handle. New rows are zero initialized, if the handle already has
+a row the existing row is returned unmodified. Adding rows can move the field arrays.
+\param map Structure of arrays map
+\param id  Object handle
+\return    Row index */
+FOUNDATION_API size_t
+soamap_insert(soamap_t* map, object_t id);
+
+/*! Remove the row for the given handle. The last row is moved into the place of the removed
+row, changing the row index of the handle of the last row.
+\param map Structure of arrays map
+\param id  Object handle
+\return    true if a row was removed, false if the handle had no row */
+FOUNDATION_API bool
+soamap_remove(soamap_t* map, object_t id);
+
+/*! Reserve storage for the given total number of rows, avoiding storage growth during later
+inserts until the map holds more rows than reserved. Never reduces storage.
+\param map      Structure of arrays map
+\param capacity Number of rows */
+FOUNDATION_API void
+soamap_reserve(soamap_t* map, size_t capacity);
+
+/*! Remove all rows
+\param map Structure of arrays map */
+FOUNDATION_API void
+soamap_clear(soamap_t* map);
+
+/*! Get the row index for the given handle
+\param map Structure of arrays map
+\param id  Object handle
+\return    Row index, #SOAMAP_INVALID if the handle has no row */
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL size_t
+soamap_index(const soamap_t* map, object_t id);
+
+/*! Get a pointer to the element of the given field in the row for the given handle
+\param map   Structure of arrays map
+\param id    Object handle
+\param field Field index
+\return      Element pointer, 0 if the handle has no row */
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL void*
+soamap_lookup(const soamap_t* map, object_t id, size_t field);
+
+/*! Get the element array of the given field, holding one element per row
+\param map   Structure of arrays map
+\param field Field index
+\return      Element array */
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL void*
+soamap_field(const soamap_t* map, size_t field);
+
+/*! Get the array of object handles, holding the handle of each row
+\param map Structure of arrays map
+\return    Handle array */
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL const object_t*
+soamap_objects(const soamap_t* map);
+
+/*! Get the number of rows
+\param map Structure of arrays map
+\return    Number of rows */
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL size_t
+soamap_size(const soamap_t* map);
+
+// Implementation
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL size_t
+soamap_index(const soamap_t* map, object_t id) {
+	size_t slot = (size_t)(id & map->mask_index);
+	size_t row = (slot < map->sparse_size) ? (size_t)map->sparse[slot] - 1 : SOAMAP_INVALID;
+	return ((row < map->count) && (map->object[row] == id)) ? row : SOAMAP_INVALID;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL void*
+soamap_lookup(const soamap_t* map, object_t id, size_t field) {
+	size_t row = soamap_index(map, id);
+	return (row != SOAMAP_INVALID) ?
+	       pointer_offset(map->field[field], row * map->field_size[field]) : 0;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL void*
+soamap_field(const soamap_t* map, size_t field) {
+	return map->field[field];
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL const object_t*
+soamap_objects(const soamap_t* map) {
+	return map->object;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL size_t
+soamap_size(const soamap_t* map) {
+	return map->count;
+}
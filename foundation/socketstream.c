@@ -0,0 +1,609 @@
+/* socketstream.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#if FOUNDATION_PLATFORM_POSIX
+#  include <foundation/posix.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <netdb.h>
+#endif
+
+#if FOUNDATION_PLATFORM_POSIX
+
+static stream_vtable_t _socket_stream_vtable;
+
+#define SOCKET_STREAM_HOST_MAX 256
+#define SOCKET_STREAM_PORT_MAX 16
+
+//Split address in host and port, or Unix domain socket path in host
+static bool
+_socket_stream_parse(const char* path, size_t length, bool* local,
+                     char* host, char* port) {
+	size_t protocol_end = string_find_string(path, length, STRING_CONST("://"), 0);
+	size_t offset, host_end, separator;
+
+	if (protocol_end == STRING_NPOS)
+		return false;
+	offset = protocol_end + 3;
+	port[0] = 0;
+
+	*local = string_equal(path, protocol_end, STRING_CONST("unix"));
+	if (*local) {
+		if ((offset >= length) || ((length - offset) >= sizeof(((struct sockaddr_un*)0)->sun_path)))
+			return false;
+		string_copy(host, SOCKET_STREAM_HOST_MAX, path + offset, length - offset);
+		return true;
+	}
+	if (!string_equal(path, protocol_end, STRING_CONST("tcp")))
+		return false;
+
+	if ((offset < length) && (path[offset] == '[')) {
+		host_end = string_find(path, length, ']', offset);
+		if ((host_end == STRING_NPOS) || (host_end + 1 >= length) || (path[host_end + 1] != ':'))
+			return false;
+		++offset;
+		separator = host_end + 1;
+	}
+	else {
+		separator = string_rfind(path, length, ':', STRING_NPOS);
+		if ((separator == STRING_NPOS) || (separator < offset))
+			return false;
+		host_end = separator;
+	}
+	if (((host_end - offset) >= SOCKET_STREAM_HOST_MAX) ||
+	        ((length - separator - 1) >= SOCKET_STREAM_PORT_MAX) || (separator + 1 >= length))
+		return false;
+	string_copy(host, SOCKET_STREAM_HOST_MAX, path + offset, host_end - offset);
+	string_copy(port, SOCKET_STREAM_PORT_MAX, path + separator + 1, length - separator - 1);
+	return true;
+}
+
+static socklen_t
+_socket_stream_unix_address(struct sockaddr_un* addr, const char* path) {
+	memset(addr, 0, sizeof(struct sockaddr_un));
+	addr->sun_family = AF_UNIX;
+	string_copy(addr->sun_path, sizeof(addr->sun_path), path, string_length(path));
+	return (socklen_t)sizeof(struct sockaddr_un);
+}
+
+static string_t
+_socket_stream_address_string(const struct sockaddr* addr, socklen_t addrlen) {
+	char host[NI_MAXHOST];
+	char port[NI_MAXSERV];
+	if (addr->sa_family == AF_UNIX) {
+		const struct sockaddr_un* local = (const struct sockaddr_un*)addr;
+		return string_allocate_format(STRING_CONST("unix://%s"), local->sun_path);
+	}
+	if (getnameinfo(addr, addrlen, host, sizeof(host), port, sizeof(port),
+	                NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+		return string_clone(STRING_CONST("tcp://"));
+	if (addr->sa_family == AF_INET6)
+		return string_allocate_format(STRING_CONST("tcp://[%s]:%s"), host, port);
+	return string_allocate_format(STRING_CONST("tcp://%s:%s"), host, port);
+}
+
+static int
+_socket_stream_create(int family, int type, int protocol) {
+	int fd = socket(family, type, protocol);
+#if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+	//Report a closed connection as an error instead of raising SIGPIPE
+	if (fd >= 0) {
+		int on = 1;
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+	}
+#endif
+	return fd;
+}
+
+static int
+_socket_stream_connect(int fd, const struct sockaddr* addr, socklen_t addrlen) {
+	int ret;
+	do {
+		ret = connect(fd, addr, addrlen);
+	}
+	while ((ret < 0) && (errno == EINTR));
+	return ret;
+}
+
+static stream_t*
+_socket_stream_allocate(int fd, string_t path, unsigned int mode) {
+	stream_socket_t* socketstream = memory_allocate(HASH_STREAM, sizeof(stream_socket_t), 8,
+	                                                MEMORY_PERSISTENT);
+	stream_t* stream = (stream_t*)socketstream;
+
+	memset(socketstream, 0, sizeof(stream_socket_t));
+	stream_initialize(stream, system_byteorder());
+
+	socketstream->type = STREAMTYPE_SOCKET;
+	socketstream->path = path;
+	socketstream->mode = (mode & (STREAM_IN | STREAM_OUT | STREAM_BINARY));
+	if (!(socketstream->mode & (STREAM_IN | STREAM_OUT)))
+		socketstream->mode |= STREAM_IN | STREAM_OUT;
+	socketstream->sequential = true;
+	socketstream->fd = fd;
+	socketstream->vtable = &_socket_stream_vtable;
+
+	return stream;
+}
+
+static stream_socket_t*
+_socket_stream_cast(stream_t* stream) {
+	return (stream && (stream->type == STREAMTYPE_SOCKET)) ? (stream_socket_t*)stream : nullptr;
+}
+
+stream_t*
+socket_stream_open(const char* path, size_t length, unsigned int mode) {
+	char host[SOCKET_STREAM_HOST_MAX];
+	char port[SOCKET_STREAM_PORT_MAX];
+	bool local = false;
+	int fd = -1;
+	int err = 0;
+
+	if (!_socket_stream_parse(path, length, &local, host, port)) {
+		log_warnf(HASH_STREAM, WARNING_INVALID_VALUE, STRING_CONST("Invalid socket address: %.*s"),
+		          (int)length, path);
+		return nullptr;
+	}
+
+	if (local) {
+		struct sockaddr_un addr;
+		socklen_t addrlen = _socket_stream_unix_address(&addr, host);
+		fd = _socket_stream_create(AF_UNIX, SOCK_STREAM, 0);
+		if ((fd >= 0) && (_socket_stream_connect(fd, (struct sockaddr*)&addr, addrlen) < 0)) {
+			err = errno;
+			close(fd);
+			fd = -1;
+		}
+	}
+	else {
+		struct addrinfo hints;
+		struct addrinfo* result = nullptr;
+		struct addrinfo* info;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		if (getaddrinfo(host[0] ? host : nullptr, port, &hints, &result) != 0) {
+			log_warnf(HASH_STREAM, WARNING_SYSTEM_CALL_FAIL,
+			          STRING_CONST("Unable to resolve socket address: %.*s"), (int)length, path);
+			return nullptr;
+		}
+		for (info = result; info && (fd < 0); info = info->ai_next) {
+			fd = _socket_stream_create(info->ai_family, info->ai_socktype, info->ai_protocol);
+			if ((fd >= 0) && (_socket_stream_connect(fd, info->ai_addr, info->ai_addrlen) < 0)) {
+				err = errno;
+				close(fd);
+				fd = -1;
+			}
+		}
+		freeaddrinfo(result);
+	}
+
+	if (fd < 0) {
+		string_const_t errmsg = system_error_message(err);
+		log_warnf(HASH_STREAM, WARNING_SYSTEM_CALL_FAIL,
+		          STRING_CONST("Unable to connect socket to %.*s: %.*s (%d)"),
+		          (int)length, path, STRING_FORMAT(errmsg), err);
+		return nullptr;
+	}
+
+	return _socket_stream_allocate(fd, string_clone(path, length), mode);
+}
+
+stream_t*
+socket_stream_listen(const char* path, size_t length, unsigned int backlog) {
+	char host[SOCKET_STREAM_HOST_MAX];
+	char port[SOCKET_STREAM_PORT_MAX];
+	struct sockaddr_storage bound;
+	socklen_t boundlen = sizeof(bound);
+	stream_t* stream;
+	bool local = false;
+	int fd = -1;
+	int err = 0;
+
+	if (!_socket_stream_parse(path, length, &local, host, port)) {
+		log_warnf(HASH_STREAM, WARNING_INVALID_VALUE, STRING_CONST("Invalid socket address: %.*s"),
+		          (int)length, path);
+		return nullptr;
+	}
+
+	if (local) {
+		struct sockaddr_un addr;
+		socklen_t addrlen = _socket_stream_unix_address(&addr, host);
+		fd = _socket_stream_create(AF_UNIX, SOCK_STREAM, 0);
+		if ((fd >= 0) && (bind(fd, (struct sockaddr*)&addr, addrlen) < 0)) {
+			err = errno;
+			close(fd);
+			fd = -1;
+		}
+	}
+	else {
+		struct addrinfo hints;
+		struct addrinfo* result = nullptr;
+		struct addrinfo* info;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = AI_PASSIVE;
+		if (getaddrinfo(host[0] ? host : nullptr, port, &hints, &result) != 0) {
+			log_warnf(HASH_STREAM, WARNING_SYSTEM_CALL_FAIL,
+			          STRING_CONST("Unable to resolve socket address: %.*s"), (int)length, path);
+			return nullptr;
+		}
+		for (info = result; info && (fd < 0); info = info->ai_next) {
+			int on = 1;
+			fd = _socket_stream_create(info->ai_family, info->ai_socktype, info->ai_protocol);
+			if (fd < 0)
+				continue;
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+			if (bind(fd, info->ai_addr, info->ai_addrlen) < 0) {
+				err = errno;
+				close(fd);
+				fd = -1;
+			}
+		}
+		freeaddrinfo(result);
+	}
+
+	if ((fd >= 0) && (listen(fd, backlog ? (int)backlog : SOMAXCONN) < 0)) {
+		err = errno;
+		close(fd);
+		fd = -1;
+	}
+	if (fd < 0) {
+		string_const_t errmsg = system_error_message(err);
+		log_warnf(HASH_STREAM, WARNING_SYSTEM_CALL_FAIL,
+		          STRING_CONST("Unable to listen on socket %.*s: %.*s (%d)"),
+		          (int)length, path, STRING_FORMAT(errmsg), err);
+		return nullptr;
+	}
+
+	//Path holds the bound address, resolving any port chosen by the system
+	if (local || (getsockname(fd, (struct sockaddr*)&bound, &boundlen) < 0))
+		stream = _socket_stream_allocate(fd, string_clone(path, length), STREAM_IN);
+	else
+		stream = _socket_stream_allocate(fd, _socket_stream_address_string((struct sockaddr*)&bound,
+		                                 boundlen), STREAM_IN);
+	((stream_socket_t*)stream)->listening = true;
+	return stream;
+}
+
+stream_t*
+socket_stream_accept(stream_t* listener) {
+	stream_socket_t* socketstream = _socket_stream_cast(listener);
+	struct sockaddr_storage addr;
+	socklen_t addrlen = sizeof(addr);
+	string_t path;
+	int fd;
+
+	if (!socketstream || !socketstream->listening || (socketstream->fd < 0))
+		return nullptr;
+
+	do {
+		addrlen = sizeof(addr);
+		fd = accept(socketstream->fd, (struct sockaddr*)&addr, &addrlen);
+	}
+	while ((fd < 0) && (errno == EINTR));
+	if (fd < 0) {
+		if (!socketstream->nonblocking || ((errno != EAGAIN) && (errno != EWOULDBLOCK))) {
+			int err = errno;
+			string_const_t errmsg = system_error_message(err);
+			log_warnf(HASH_STREAM, WARNING_SYSTEM_CALL_FAIL,
+			          STRING_CONST("Unable to accept connection on socket %.*s: %.*s (%d)"),
+			          STRING_FORMAT(socketstream->path), STRING_FORMAT(errmsg), err);
+		}
+		return nullptr;
+	}
+
+	//Accepted sockets might inherit the non-blocking flag of the listening socket
+	{
+		int flags = fcntl(fd, F_GETFL);
+		if ((flags >= 0) && (flags & O_NONBLOCK))
+			fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+	}
+#if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+	{
+		int on = 1;
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+	}
+#endif
+
+	if (((struct sockaddr*)&addr)->sa_family == AF_UNIX)
+		path = string_clone(STRING_ARGS(socketstream->path));
+	else
+		path = _socket_stream_address_string((struct sockaddr*)&addr, addrlen);
+	return _socket_stream_allocate(fd, path, STREAM_IN | STREAM_OUT | STREAM_BINARY);
+}
+
+void
+socket_stream_close_write(stream_t* stream) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	if (!socketstream || (socketstream->fd < 0))
+		return;
+	shutdown(socketstream->fd, SHUT_WR);
+	socketstream->mode &= ~STREAM_OUT;
+}
+
+void
+socket_stream_set_nonblocking(stream_t* stream, bool nonblocking) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	int flags;
+	if (!socketstream || (socketstream->fd < 0))
+		return;
+	flags = fcntl(socketstream->fd, F_GETFL);
+	if (flags >= 0)
+		fcntl(socketstream->fd, F_SETFL, nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+	socketstream->nonblocking = nonblocking;
+}
+
+void
+socket_stream_set_nodelay(stream_t* stream, bool nodelay) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	int flag = nodelay ? 1 : 0;
+	if (!socketstream || (socketstream->fd < 0))
+		return;
+	setsockopt(socketstream->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+static void
+_socket_stream_cork(stream_socket_t* socketstream, bool cork) {
+	int flag = cork ? 1 : 0;
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	setsockopt(socketstream->fd, IPPROTO_TCP, TCP_CORK, &flag, sizeof(flag));
+#elif defined(TCP_NOPUSH)
+	setsockopt(socketstream->fd, IPPROTO_TCP, TCP_NOPUSH, &flag, sizeof(flag));
+#else
+	FOUNDATION_UNUSED(flag);
+#endif
+}
+
+void
+socket_stream_set_cork(stream_t* stream, bool cork) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	if (!socketstream || (socketstream->fd < 0))
+		return;
+	_socket_stream_cork(socketstream, cork);
+	socketstream->corked = cork;
+}
+
+int
+socket_stream_handle(stream_t* stream) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	return socketstream ? socketstream->fd : -1;
+}
+
+static void
+_socket_stream_finalize(stream_t* stream) {
+	stream_socket_t* socketstream = _socket_stream_cast(stream);
+	if (!socketstream || (socketstream->fd < 0))
+		return;
+	close(socketstream->fd);
+	socketstream->fd = -1;
+	//Remove the socket file created by binding a Unix domain listening socket
+	if (socketstream->listening && (socketstream->path.length > 7) &&
+	        string_equal(socketstream->path.str, 7, STRING_CONST("unix://")))
+		unlink(socketstream->path.str + 7);
+}
+
+static bool
+_socket_stream_would_block(const stream_socket_t* socketstream) {
+	return socketstream->nonblocking && ((errno == EAGAIN) || (errno == EWOULDBLOCK));
+}
+
+static size_t
+_socket_stream_read(stream_t* stream, void* dest, size_t num) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	size_t total_read = 0;
+	if ((socketstream->fd < 0) || socketstream->listening || !(socketstream->mode & STREAM_IN))
+		return 0;
+	while (total_read < num) {
+		ssize_t num_read = recv(socketstream->fd, pointer_offset(dest, total_read),
+		                        num - total_read, 0);
+		if (num_read > 0) {
+			total_read += (size_t)num_read;
+			continue;
+		}
+		if ((num_read < 0) && (errno == EINTR))
+			continue;
+		//Non-blocking read with no more available data is not end of stream
+		if (!num_read || !_socket_stream_would_block(socketstream))
+			socketstream->eos = true;
+		break;
+	}
+	return total_read;
+}
+
+static size_t
+_socket_stream_write(stream_t* stream, const void* source, size_t num) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	size_t total_written = 0;
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	if ((socketstream->fd < 0) || socketstream->listening || !(socketstream->mode & STREAM_OUT))
+		return 0;
+	while (total_written < num) {
+		ssize_t num_written = send(socketstream->fd, pointer_offset_const(source, total_written),
+		                           num - total_written, flags);
+		if (num_written > 0) {
+			total_written += (size_t)num_written;
+			continue;
+		}
+		if ((num_written < 0) && (errno == EINTR))
+			continue;
+		//Non-blocking write with full socket buffers is not end of stream
+		if (!num_written || !_socket_stream_would_block(socketstream))
+			socketstream->eos = true;
+		break;
+	}
+	return total_written;
+}
+
+static size_t
+_socket_stream_read_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	size_t ispan, num, total_read;
+	if ((socketstream->fd < 0) || socketstream->listening || !(socketstream->mode & STREAM_IN))
+		return 0;
+	for (ispan = 0, num = 0; ispan < count; ++ispan)
+		num += spans[ispan].size;
+	errno = 0;
+	total_read = _stream_fd_vector(socketstream->fd, spans, count, false);
+	if ((total_read < num) && !_socket_stream_would_block(socketstream))
+		socketstream->eos = true;
+	return total_read;
+}
+
+static size_t
+_socket_stream_write_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	size_t ispan, num, total_written;
+	if ((socketstream->fd < 0) || socketstream->listening || !(socketstream->mode & STREAM_OUT))
+		return 0;
+	for (ispan = 0, num = 0; ispan < count; ++ispan)
+		num += spans[ispan].size;
+	errno = 0;
+	total_written = _stream_fd_vector(socketstream->fd, spans, count, true);
+	if ((total_written < num) && !_socket_stream_would_block(socketstream))
+		socketstream->eos = true;
+	return total_written;
+}
+
+static bool
+_socket_stream_eos(stream_t* stream) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	return !stream || (socketstream->fd < 0) || socketstream->eos;
+}
+
+static void
+_socket_stream_flush(stream_t* stream) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	//Toggling the cork sends any held back partial segment
+	if ((socketstream->fd >= 0) && socketstream->corked) {
+		_socket_stream_cork(socketstream, false);
+		_socket_stream_cork(socketstream, true);
+	}
+}
+
+static void
+_socket_stream_truncate(stream_t* stream, size_t size) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(size);
+}
+
+static size_t
+_socket_stream_size(stream_t* stream) {
+	FOUNDATION_UNUSED(stream);
+	return 0;
+}
+
+static void
+_socket_stream_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(offset);
+	FOUNDATION_UNUSED(direction);
+}
+
+static size_t
+_socket_stream_tell(stream_t* stream) {
+	FOUNDATION_UNUSED(stream);
+	return 0;
+}
+
+static tick_t
+_socket_stream_lastmod(const stream_t* stream) {
+	FOUNDATION_UNUSED(stream);
+	return time_current();
+}
+
+static size_t
+_socket_stream_available_read(stream_t* stream) {
+	stream_socket_t* socketstream = (stream_socket_t*)stream;
+	int available = 0;
+	if ((socketstream->fd >= 0) && !socketstream->listening &&
+	        (ioctl(socketstream->fd, FIONREAD, &available) == 0) && (available > 0))
+		return (size_t)available;
+	return 0;
+}
+
+void
+_socket_stream_initialize(void) {
+	_socket_stream_vtable.read = _socket_stream_read;
+	_socket_stream_vtable.write = _socket_stream_write;
+	_socket_stream_vtable.read_vector = _socket_stream_read_vector;
+	_socket_stream_vtable.write_vector = _socket_stream_write_vector;
+	_socket_stream_vtable.eos = _socket_stream_eos;
+	_socket_stream_vtable.flush = _socket_stream_flush;
+	_socket_stream_vtable.truncate = _socket_stream_truncate;
+	_socket_stream_vtable.size = _socket_stream_size;
+	_socket_stream_vtable.seek = _socket_stream_seek;
+	_socket_stream_vtable.tell = _socket_stream_tell;
+	_socket_stream_vtable.lastmod = _socket_stream_lastmod;
+	_socket_stream_vtable.available_read = _socket_stream_available_read;
+	_socket_stream_vtable.finalize = _socket_stream_finalize;
+}
+
+#else
+
+stream_t*
+socket_stream_open(const char* path, size_t length, unsigned int mode) {
+	FOUNDATION_UNUSED(mode);
+	log_warnf(HASH_STREAM, WARNING_UNSUPPORTED,
+	          STRING_CONST("Socket streams not supported on this platform: %.*s"), (int)length, path);
+	return nullptr;
+}
+
+stream_t*
+socket_stream_listen(const char* path, size_t length, unsigned int backlog) {
+	FOUNDATION_UNUSED(backlog);
+	return socket_stream_open(path, length, 0);
+}
+
+stream_t*
+socket_stream_accept(stream_t* listener) {
+	FOUNDATION_UNUSED(listener);
+	return nullptr;
+}
+
+void
+socket_stream_close_write(stream_t* stream) {
+	FOUNDATION_UNUSED(stream);
+}
+
+void
+socket_stream_set_nonblocking(stream_t* stream, bool nonblocking) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(nonblocking);
+}
+
+void
+socket_stream_set_nodelay(stream_t* stream, bool nodelay) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(nodelay);
+}
+
+void
+socket_stream_set_cork(stream_t* stream, bool cork) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(cork);
+}
+
+void
+_socket_stream_initialize(void) {
+}
+
+#endif
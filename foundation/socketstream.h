@@ -0,0 +1,102 @@
+/* socketstream.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file socketstream.h
+\brief Socket stream
+
+Stream for TCP and Unix domain socket connections, so the stream helpers and serializers can
+be used for network I/O. Socket streams are sequential (non-seekable). Addresses are given as
+<code>tcp://host:port</code>, with IPv6 hosts in brackets like <code>tcp://[::1]:port</code>,
+or <code>unix:///path/to/socket</code>. The "tcp" and "unix" protocols are registered with
+#stream_open, opening a stream connects to the given address.
+
+Reads and writes are blocking by default and transfer the full requested size unless the
+connection is closed. In non-blocking mode reads and writes only transfer what the socket
+buffers allow and return the partial count. Combined with adding the socket to a beacon with
+#beacon_add for read readiness, or #beacon_add_writable for write readiness, a single thread can
+service many connections. Vectored writes with #stream_write_vector gather all buffers in a
+single system call.
+
+Only supported on posix platforms, on other platforms no stream is created. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Connect to the given address. This is the stream open function registered for the "tcp"
+and "unix" protocols. Deallocate the stream with a call to #stream_deallocate
+\param path   Address
+\param length Length of address
+\param mode   Open mode, only #STREAM_IN, #STREAM_OUT and #STREAM_BINARY are used
+\return       New socket stream, null if connection failed */
+FOUNDATION_API stream_t*
+socket_stream_open(const char* path, size_t length, unsigned int mode);
+
+/*! Create a socket listening for connections on the given address. An empty host listens on
+all interfaces, and port zero binds any available port. The path of the returned stream holds
+the bound address, and can be passed to #stream_open to connect. A Unix domain socket file is
+removed when the listening stream is deallocated.
+\param path    Address
+\param length  Length of address
+\param backlog Maximum number of pending connections, zero for system default
+\return        Listening socket stream, null if the address could not be bound */
+FOUNDATION_API stream_t*
+socket_stream_listen(const char* path, size_t length, unsigned int backlog);
+
+/*! Accept a pending connection on a listening socket stream. Blocks until a connection is
+available unless the listening stream is in non-blocking mode. The accepted stream is in
+blocking mode.
+\param listener Listening socket stream
+\return         Connected socket stream, null if no connection was accepted */
+FOUNDATION_API stream_t*
+socket_stream_accept(stream_t* listener);
+
+/*! Shut down the sending side of the connection, the peer reads end of stream once all data
+written has been received. The stream can still be read.
+\param stream Socket stream */
+FOUNDATION_API void
+socket_stream_close_write(stream_t* stream);
+
+/*! Set non-blocking mode for the socket
+\param stream      Socket stream
+\param nonblocking Non-blocking flag */
+FOUNDATION_API void
+socket_stream_set_nonblocking(stream_t* stream, bool nonblocking);
+
+/*! Control Nagle's algorithm for a TCP socket. With no delay enabled small writes are sent
+immediately instead of being coalesced while waiting for acknowledgement of data in flight.
+No effect on Unix domain sockets.
+\param stream  Socket stream
+\param nodelay No delay flag */
+FOUNDATION_API void
+socket_stream_set_nodelay(stream_t* stream, bool nodelay);
+
+/*! Cork a TCP socket, holding back partial segments so that a response written in several
+pieces is sent in full segments. Uncorking or calling #stream_flush sends any held back data.
+Uses TCP_CORK on Linux and TCP_NOPUSH on Apple and BSD platforms. No effect on Unix domain
+sockets.
+\param stream Socket stream
+\param cork   Cork flag */
+FOUNDATION_API void
+socket_stream_set_cork(stream_t* stream, bool cork);
+
+#if FOUNDATION_PLATFORM_POSIX
+
+/*! Posix only, get OS file descriptor of the socket, for use with #beacon_add or
+#beacon_add_writable
+\param stream Socket stream
+\return       File descriptor, negative if not a socket stream */
+FOUNDATION_API int
+socket_stream_handle(stream_t* stream);
+
+#endif
@@ -28,6 +28,19 @@
 #  include <unwind.h>
 #endif
 
+//Frame pointer walk, requires callers to keep the frame pointer chain intact
+#if FOUNDATION_PLATFORM_POSIX && (FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG) && \
+    (FOUNDATION_ARCH_X86_64 || FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_ARM8_64)
+#  include <ucontext.h>
+#  if FOUNDATION_PLATFORM_BSD
+#    include <pthread_np.h>
+#  endif
+#  define FOUNDATION_HAVE_FRAME_WALK 1
+#endif
+#ifndef FOUNDATION_HAVE_FRAME_WALK
+#  define FOUNDATION_HAVE_FRAME_WALK 0
+#endif
+
 #if FOUNDATION_PLATFORM_LINUX_RASPBERRYPI
 extern void FOUNDATION_NOINLINE _gcc_barrier_function(uint32_t fp);
 void __attribute__((optimize("O0"))) _gcc_barrier_function(uint32_t fp) { FOUNDATION_UNUSED(fp); }
@@ -534,6 +547,140 @@ stacktrace_capture(void** trace, size_t max_depth, size_t skip_frames) {
 	return num_frames;
 }
 
+#if FOUNDATION_HAVE_FRAME_WALK
+
+//Stack bounds of the thread, zero if unknown
+FOUNDATION_DECLARE_THREAD_LOCAL(uintptr_t, stack_low, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(uintptr_t, stack_high, 0)
+
+//Span above the current frame walked when the stack bounds of the thread are unknown
+#define STACKTRACE_UNBOUNDED_SPAN (256U * 1024U)
+
+//Walk the chain of saved frame pointer and return address pairs. Every frame must be aligned,
+//inside the thread stack and above the previous frame, so a broken chain ends the walk instead
+//of reading arbitrary memory.
+static size_t
+_stacktrace_walk(void** trace, size_t max_depth, size_t skip_frames, void* const* frame) {
+	size_t num_frames = 0;
+	uintptr_t low = get_thread_stack_low();
+	uintptr_t high = get_thread_stack_high();
+	if (!high) {
+		low = (uintptr_t)frame;
+		high = low + STACKTRACE_UNBOUNDED_SPAN;
+	}
+	while (num_frames < max_depth) {
+		uintptr_t addr = (uintptr_t)frame;
+		void* const* next;
+		void* retaddr;
+		if ((addr < low) || (addr > high - (2 * sizeof(void*))) || (addr & (sizeof(void*) - 1)))
+			break;
+		next = frame[0];
+		retaddr = frame[1];
+		if (!retaddr)
+			break;
+		if (skip_frames)
+			--skip_frames;
+		else
+			trace[num_frames++] = retaddr;
+		if ((uintptr_t)next <= addr)
+			break;
+		frame = next;
+	}
+	return num_frames;
+}
+
+#endif
+
+void
+stacktrace_thread_initialize(void) {
+#if FOUNDATION_HAVE_FRAME_WALK
+	uintptr_t low = 0, high = 0;
+#  if FOUNDATION_PLATFORM_APPLE
+	pthread_t self = pthread_self();
+	high = (uintptr_t)pthread_get_stackaddr_np(self);
+	low = high - (uintptr_t)pthread_get_stacksize_np(self);
+#  else
+	pthread_attr_t attr;
+	void* addr = 0;
+	size_t size = 0;
+#    if FOUNDATION_PLATFORM_BSD
+	pthread_attr_init(&attr);
+	if (pthread_attr_get_np(pthread_self(), &attr) == 0) {
+#    else
+	if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+#    endif
+		if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+			low = (uintptr_t)addr;
+			high = low + size;
+		}
+		pthread_attr_destroy(&attr);
+	}
+#  endif
+	set_thread_stack_low(low);
+	set_thread_stack_high(high);
+#endif
+}
+
+size_t FOUNDATION_NOINLINE
+stacktrace_capture_fast(void** trace, size_t max_depth, size_t skip_frames) {
+	if (!trace || !max_depth)
+		return 0;
+#if FOUNDATION_HAVE_FRAME_WALK
+	//The return address in the frame of this function is the first frame
+	return _stacktrace_walk(trace, max_depth, skip_frames, __builtin_frame_address(0));
+#elif FOUNDATION_PLATFORM_WINDOWS && USE_CAPTURESTACKBACKTRACE
+	if (!_stackwalk_initialized)
+		_initialize_stackwalker();
+	if (CallRtlCaptureStackBackTrace)
+		return CallRtlCaptureStackBackTrace((DWORD)skip_frames + 1, (DWORD)max_depth, trace, 0);
+	return 0;
+#else
+	return stacktrace_capture(trace, max_depth, skip_frames + 1);
+#endif
+}
+
+size_t
+stacktrace_capture_context(void** trace, size_t max_depth, const void* context) {
+#if FOUNDATION_HAVE_FRAME_WALK
+	const ucontext_t* uc = context;
+	uintptr_t pc, fp;
+	if (!trace || !max_depth || !uc)
+		return 0;
+#  if FOUNDATION_PLATFORM_APPLE && FOUNDATION_ARCH_X86_64
+	pc = (uintptr_t)uc->uc_mcontext->__ss.__rip;
+	fp = (uintptr_t)uc->uc_mcontext->__ss.__rbp;
+#  elif FOUNDATION_PLATFORM_APPLE
+	pc = (uintptr_t)uc->uc_mcontext->__ss.__pc;
+	fp = (uintptr_t)uc->uc_mcontext->__ss.__fp;
+#  elif FOUNDATION_PLATFORM_LINUX && FOUNDATION_ARCH_X86_64
+	pc = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+	fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+#  elif FOUNDATION_PLATFORM_LINUX && FOUNDATION_ARCH_X86
+	pc = (uintptr_t)uc->uc_mcontext.gregs[REG_EIP];
+	fp = (uintptr_t)uc->uc_mcontext.gregs[REG_EBP];
+#  elif FOUNDATION_PLATFORM_LINUX
+	pc = (uintptr_t)uc->uc_mcontext.pc;
+	fp = (uintptr_t)uc->uc_mcontext.regs[29];
+#  elif FOUNDATION_ARCH_X86_64
+	pc = (uintptr_t)uc->uc_mcontext.mc_rip;
+	fp = (uintptr_t)uc->uc_mcontext.mc_rbp;
+#  else
+	pc = 0;
+	fp = 0;
+#  endif
+	if (!pc)
+		return 0;
+	//The interrupted instruction is the first frame, followed by the frame pointer chain
+	trace[0] = (void*)pc;
+	return 1 + _stacktrace_walk(trace + 1, max_depth - 1, 0, (void* const*)fp);
+#else
+	FOUNDATION_UNUSED(trace);
+	FOUNDATION_UNUSED(max_depth);
+	FOUNDATION_UNUSED(context);
+	return 0;
+#endif
+}
+
 static bool _symbol_resolve_initialized = false;
 #if FOUNDATION_PLATFORM_WINDOWS
 static void* _stacktrace_psapi_dll;
@@ -638,31 +785,52 @@ _finalize_symbol_resolve() {
 #define UNKNOWN_SYMBOL "?""?"
 #endif
 
-static FOUNDATION_NOINLINE string_t
-_resolve_stack_frames(char* buffer, size_t capacity, void** frames, size_t max_frames) {
+//Resolved symbol line for a single frame address, with the line stored after the struct
+typedef struct stacktrace_symbol_t stacktrace_symbol_t;
+
+struct stacktrace_symbol_t {
+	string_t line;
+	bool is_main;
+};
+
+//Address to symbol cache, only available between stacktrace module initialization and
+//finalization since the memory tracker resolves leaks after the module is finalized
+static hashmap_t* _stacktrace_cache;
+static lock_t _stacktrace_cache_lock;
+
+static stacktrace_symbol_t*
+_stacktrace_symbol_allocate(string_t line, bool is_main) {
+	stacktrace_symbol_t* symbol = memory_allocate(0, sizeof(stacktrace_symbol_t) + line.length + 1,
+	                                              0, MEMORY_PERSISTENT);
+	symbol->line.str = (char*)(symbol + 1);
+	symbol->line.length = line.length;
+	symbol->is_main = is_main;
+	memcpy(symbol->line.str, line.str, line.length);
+	symbol->line.str[line.length] = 0;
+	return symbol;
+}
+
+//Resolve the given frame addresses to one symbol each, in a single batch
+static FOUNDATION_NOINLINE void
+_resolve_symbols(void** frames, size_t num_frames, stacktrace_symbol_t** symbols) {
 #if FOUNDATION_PLATFORM_WINDOWS
 	char                symbol_buffer[ sizeof(IMAGEHLP_SYMBOL64) + 512 ];
+	char                linebuf[1024];
 	PIMAGEHLP_SYMBOL64  symbol;
 	DWORD               displacement = 0;
 	uint64_t            displacement64 = 0;
 	size_t              iaddr;
 	HANDLE              process_handle = GetCurrentProcess();
-	bool                last_was_main = false;
 	IMAGEHLP_LINE64     line64;
 	IMAGEHLP_MODULE64   module64;
-	string_t            resolved = {buffer, 0};
 
-	for (iaddr = 0; (iaddr < max_frames) && !last_was_main && (resolved.length < capacity-1); ++iaddr) {
+	for (iaddr = 0; iaddr < num_frames; ++iaddr) {
 		string_t line;
 		const char* function_name = UNKNOWN_SYMBOL;
 		const char* file_name = function_name;
 		const char* module_name = function_name;
 		unsigned int line_number = 0;
 
-		//Allow first frame to be null in case of a function call to a null pointer
-		if (iaddr && !frames[iaddr])
-			break;
-
 		// Initialize symbol.
 		symbol = (PIMAGEHLP_SYMBOL64)symbol_buffer;
 		memset(symbol, 0, sizeof(symbol_buffer));
@@ -700,74 +868,55 @@ _resolve_stack_frames(char* buffer, size_t capacity, void** frames, size_t max_f
 				module_name += last_slash + 1;
 		}
 
-		if (resolved.length)
-			resolved.str[resolved.length++] = '\n';
-		line = string_format(resolved.str + resolved.length, capacity - resolved.length,
+		line = string_format(linebuf, sizeof(linebuf),
 		                     STRING_CONST("[0x%" PRIfixPTR "] %s (%s:%d +%d bytes) [in %s]"),
 		                     frames[iaddr], function_name, file_name, line_number,
 		                     displacement, module_name);
-		resolved.length += line.length;
-
-		if (string_equal(function_name, string_length(function_name), STRING_CONST("main")))
-			last_was_main = true;
+		symbols[iaddr] = _stacktrace_symbol_allocate(line,
+		                 string_equal(function_name, string_length(function_name), STRING_CONST("main")));
 	}
 
-	return resolved;
-
 #elif FOUNDATION_PLATFORM_MACOSX || FOUNDATION_PLATFORM_IOS
 
 	//TODO: Use dladdr instead to avoid memory allocation with malloc in backtrace_symbols
-	string_t symbols = (string_t) { buffer, 0 };
-	char** resolved = backtrace_symbols(frames, (int)max_frames);
-	for (unsigned int iframe = 0; iframe < max_frames; ++iframe) {
-		size_t length = string_length(resolved[iframe]);
-		if (length)
-			symbols = string_append_varg(symbols.str, symbols.length, capacity, resolved[iframe], length,
-			                             STRING_CONST(STRING_NEWLINE), nullptr);
+	char** resolved = backtrace_symbols(frames, (int)num_frames);
+	for (size_t iframe = 0; iframe < num_frames; ++iframe) {
+		const char* name = resolved ? resolved[iframe] : "";
+		symbols[iframe] = _stacktrace_symbol_allocate((string_t) {(char*)name, string_length(name)},
+		                                              false);
 	}
 	free(resolved);
 
-	return symbols;
-
 #elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_BSD
 
 	string_const_t* args = 0;
 	process_t* proc;
-	unsigned int num_frames = 0;
-	unsigned int requested_frames = 0;
-	bool last_was_main = false;
-	string_t resolved = (string_t) {buffer, 0};
+	size_t iaddr;
+	char linebuf[1024];
+	char* addrbuf;
 	string_t line, filename, function;
 	stream_t* procout;
 
 	if (!environment_executable_path().length) {
-		for (unsigned int iaddr = 0; iaddr < max_frames; ++iaddr) {
-			//Allow first frame to be null in case of a function call to a null pointer
-			if (iaddr && !frames[iaddr])
-				break;
-			line = string_format(resolved.str + resolved.length, capacity - resolved.length,
-			                     STRING_CONST("[0x%" PRIfixPTR "]" STRING_NEWLINE),
+		for (iaddr = 0; iaddr < num_frames; ++iaddr) {
+			line = string_format(linebuf, sizeof(linebuf), STRING_CONST("[0x%" PRIfixPTR "]"),
 			                     (uintptr_t)frames[iaddr]);
-			resolved.length += line.length;
+			symbols[iaddr] = _stacktrace_symbol_allocate(line, false);
 		}
-		return resolved;
+		return;
 	}
 
+	//All addresses are resolved by a single addr2line invocation
+	addrbuf = memory_allocate(0, num_frames * 20, 0, MEMORY_TEMPORARY);
+
 	array_push(args, string_const(STRING_CONST("-e")));
 	array_push(args, environment_executable_path());
 	array_push(args, string_const(STRING_CONST("-f")));
 
-	for (unsigned int iaddr = 0; iaddr < max_frames; ++iaddr) {
-		//Allow first frame to be null in case of a function call to a null pointer
-		if (iaddr && !frames[iaddr])
-			break;
-
-		line = string_format(resolved.str + resolved.length, capacity - resolved.length,
-		                     STRING_CONST("0x%" PRIfixPTR), (uintptr_t)frames[iaddr]);
-		resolved.length += line.length;
-
+	for (iaddr = 0; iaddr < num_frames; ++iaddr) {
+		line = string_format(addrbuf + (iaddr * 20), 20, STRING_CONST("0x%" PRIfixPTR),
+		                     (uintptr_t)frames[iaddr]);
 		array_push(args, string_const(STRING_ARGS(line)));
-		++requested_frames;
 	}
 
 	proc = process_allocate();
@@ -779,59 +928,53 @@ _resolve_stack_frames(char* buffer, size_t capacity, void** frames, size_t max_f
 	process_spawn(proc);
 	procout = process_stdout(proc);
 
-	resolved.length = 0;
-	while (!stream_eos(procout) && (num_frames < requested_frames) && !last_was_main) {
-		line = string_format(resolved.str + resolved.length, capacity - resolved.length,
-		                     STRING_CONST("[0x%" PRIfixPTR "] "), (uintptr_t)frames[num_frames]);
-		resolved.length += line.length;
+	for (iaddr = 0; iaddr < num_frames; ++iaddr) {
+		size_t length;
+
+		line = string_format(linebuf, sizeof(linebuf), STRING_CONST("[0x%" PRIfixPTR "] "),
+		                     (uintptr_t)frames[iaddr]);
+		length = line.length;
 
-		function = stream_read_line_buffer(procout, resolved.str + resolved.length,
-		                                   capacity - resolved.length, '\n');
+		function = (string_t) {0, 0};
+		if (procout && !stream_eos(procout))
+			function = stream_read_line_buffer(procout, linebuf + length, sizeof(linebuf) - length,
+			                                   '\n');
 		if (!function.length)
-			function = string_copy(resolved.str + resolved.length, capacity - resolved.length,
+			function = string_copy(linebuf + length, sizeof(linebuf) - length,
 			                       STRING_CONST(UNKNOWN_SYMBOL));
-		resolved.length += function.length;
+		length += function.length;
 
-		string_copy(resolved.str + resolved.length, capacity - resolved.length, STRING_CONST(" ("));
-		resolved.length += 2;
+		string_copy(linebuf + length, sizeof(linebuf) - length, STRING_CONST(" ("));
+		length += 2;
 
-		filename = stream_read_line_buffer(procout, resolved.str + resolved.length,
-		                                   capacity - resolved.length, '\n');
+		filename = (string_t) {0, 0};
+		if (procout && !stream_eos(procout))
+			filename = stream_read_line_buffer(procout, linebuf + length, sizeof(linebuf) - length,
+			                                   '\n');
 		if (!filename.length)
-			filename = string_copy(resolved.str + resolved.length, capacity - resolved.length,
+			filename = string_copy(linebuf + length, sizeof(linebuf) - length,
 			                       STRING_CONST(UNKNOWN_SYMBOL));
-		resolved.length += filename.length;
-
-		string_copy(resolved.str + resolved.length, capacity - resolved.length,
-		            STRING_CONST(")" STRING_NEWLINE));
-		resolved.length += 2;
+		length += filename.length;
 
-		if (string_equal(STRING_ARGS(function), STRING_CONST("main")))
-			last_was_main = true;
-
-		++num_frames;
+		line = string_append(linebuf, length, sizeof(linebuf), STRING_CONST(")"));
+		symbols[iaddr] = _stacktrace_symbol_allocate(line,
+		                 string_equal(STRING_ARGS(function), STRING_CONST("main")));
 	}
 
 	process_wait(proc);
 	process_deallocate(proc);
 
 	array_deallocate(args);
-
-	return resolved;
+	memory_deallocate(addrbuf);
 
 #elif FOUNDATION_PLATFORM_ANDROID
 
-	string_t symbols = (string_t) { buffer, 0 };
 	string_t line;
 	char linebuf[128];
 
 	_load_process_modules();
 
-	for (unsigned int iaddr = 0; iaddr < max_frames; ++iaddr) {
-		//Allow first frame to be null in case of a function call to a null pointer
-		if (iaddr && !frames[iaddr])
-			break;
-
+	for (size_t iaddr = 0; iaddr < num_frames; ++iaddr) {
 		//Find the module and relative address
 		uintptr_t relativeframe = (uintptr_t)frames[iaddr];
 		string_const_t module = string_const(STRING_CONST("<no module found>"));
@@ -846,44 +989,161 @@ _resolve_stack_frames(char* buffer, size_t capacity, void** frames, size_t max_f
 		}
 
 		line = string_format(linebuf, sizeof(linebuf),
-		                     STRING_CONST("[0x%" PRIfixPTR "] 0x%" PRIfixPTR " %.*s\n"),
+		                     STRING_CONST("[0x%" PRIfixPTR "] 0x%" PRIfixPTR " %.*s"),
 		                     (uintptr_t)frames[iaddr], (uintptr_t)relativeframe, STRING_FORMAT(module));
-		symbols = string_append(STRING_ARGS(symbols), capacity, STRING_ARGS(line));
+		symbols[iaddr] = _stacktrace_symbol_allocate(line, false);
 	}
 
-	return symbols;
-
 #else
 
-	string_t symbols = (string_t) { buffer, 0 };
 	string_t line;
 	char linebuf[64];
 
-	for (unsigned int iaddr = 0; iaddr < max_frames; ++iaddr) {
-		//Allow first frame to be null in case of a function call to a null pointer
-		if (iaddr && !frames[iaddr])
-			break;
-
-		line = string_format(linebuf, sizeof(linebuf), STRING_CONST("[0x%" PRIfixPTR "]\n"),
+	for (size_t iaddr = 0; iaddr < num_frames; ++iaddr) {
+		line = string_format(linebuf, sizeof(linebuf), STRING_CONST("[0x%" PRIfixPTR "]"),
 		                     (uintptr_t)frames[iaddr]);
-		symbols = string_append(STRING_ARGS(symbols), capacity, STRING_ARGS(line));
+		symbols[iaddr] = _stacktrace_symbol_allocate(line, false);
 	}
 
-	return symbols;
-
 #endif
 }
 
+static size_t
+_stacktrace_frame_count(void** trace, size_t max_depth) {
+	size_t num_frames = 0;
+	//Allow first frame to be null in case of a function call to a null pointer
+	while ((num_frames < max_depth) && (!num_frames || trace[num_frames]))
+		++num_frames;
+	return num_frames;
+}
+
+static string_t
+_stacktrace_format(char* buffer, size_t capacity, void** frames, size_t num_frames,
+                   hashmap_t* symbols) {
+	string_t resolved = {buffer, 0};
+	for (size_t iframe = 0; iframe < num_frames; ++iframe) {
+		stacktrace_symbol_t* symbol = hashmap_lookup(symbols, (hash_t)(uintptr_t)frames[iframe]);
+		if (!symbol)
+			continue;
+		resolved = string_append_varg(STRING_ARGS(resolved), capacity, STRING_ARGS(symbol->line),
+		                              STRING_CONST(STRING_NEWLINE), nullptr);
+		if (symbol->is_main)
+			break;
+	}
+	return resolved;
+}
+
+static void
+_stacktrace_free_symbols(hashmap_t* map) {
+	hashmap_node_t* node = 0;
+	while ((node = hashmap_next(map, node)))
+		memory_deallocate(node->value);
+	hashmap_clear(map);
+}
+
 string_t
 stacktrace_resolve(char* str, size_t length, void** trace, size_t max_depth, size_t skip_frames) {
-	_initialize_symbol_resolve();
+	string_t resolved = {str, 0};
 
 	if (!max_depth)
 		max_depth = _foundation_config.stacktrace_depth;
 	if (max_depth + skip_frames > _foundation_config.stacktrace_depth)
 		max_depth = _foundation_config.stacktrace_depth - skip_frames;
+	if (!max_depth || !length)
+		return resolved;
+
+	trace += skip_frames;
+	stacktrace_resolve_many(str, length, &trace, &max_depth, 1, &resolved);
+	return resolved;
+}
+
+size_t
+stacktrace_resolve_many(char* str, size_t capacity, void** const* traces, const size_t* depths,
+                        size_t num_traces, string_t* resolved) {
+	hashmap_t pending;
+	hashmap_t* cache = _stacktrace_cache;
+	void** missing = 0;
+	stacktrace_symbol_t** symbols;
+	size_t itrace, iframe, imissing, num_missing, offset = 0;
+
+	_initialize_symbol_resolve();
+
+	//Collect the unique addresses not yet in the cache
+	hashmap_initialize(&pending, 0, 0);
+	if (cache)
+		lock_lock(&_stacktrace_cache_lock);
+	for (itrace = 0; itrace < num_traces; ++itrace) {
+		size_t depth = depths[itrace] ? depths[itrace] : _foundation_config.stacktrace_depth;
+		size_t num_frames = _stacktrace_frame_count(traces[itrace], depth);
+		for (iframe = 0; iframe < num_frames; ++iframe) {
+			hash_t key = (hash_t)(uintptr_t)traces[itrace][iframe];
+			if ((!cache || !hashmap_has_key(cache, key)) &&
+			        !hashmap_has_key(&pending, key)) {
+				hashmap_insert(&pending, key, 0);
+				array_push(missing, traces[itrace][iframe]);
+			}
+		}
+	}
+	if (cache)
+		lock_unlock(&_stacktrace_cache_lock);
+
+	//Resolve outside the lock, symbolizing may spawn a process
+	num_missing = array_size(missing);
+	symbols = num_missing ? memory_allocate(0, sizeof(stacktrace_symbol_t*) * num_missing, 0,
+	                                        MEMORY_TEMPORARY) : 0;
+	if (num_missing)
+		_resolve_symbols(missing, num_missing, symbols);
+
+	if (cache) {
+		lock_lock(&_stacktrace_cache_lock);
+		for (imissing = 0; imissing < num_missing; ++imissing) {
+			hash_t key = (hash_t)(uintptr_t)missing[imissing];
+			//Another thread may have resolved the same address concurrently
+			if (hashmap_has_key(cache, key))
+				memory_deallocate(symbols[imissing]);
+			else
+				hashmap_insert(cache, key, symbols[imissing]);
+		}
+	}
+	else {
+		for (imissing = 0; imissing < num_missing; ++imissing)
+			hashmap_insert(&pending, (hash_t)(uintptr_t)missing[imissing], symbols[imissing]);
+	}
+
+	for (itrace = 0; itrace < num_traces; ++itrace) {
+		size_t depth = depths[itrace] ? depths[itrace] : _foundation_config.stacktrace_depth;
+		size_t num_frames = _stacktrace_frame_count(traces[itrace], depth);
+		//Keep the zero terminator of each trace
+		if (offset < capacity) {
+			resolved[itrace] = _stacktrace_format(str + offset, capacity - offset, traces[itrace],
+			                                      num_frames, cache ? cache : &pending);
+			offset += resolved[itrace].length + 1;
+		}
+		else {
+			//Point at the terminator of the last string in the buffer
+			resolved[itrace] = (string_t) {capacity ? str + capacity - 1 : str, 0};
+		}
+	}
+
+	if (cache)
+		lock_unlock(&_stacktrace_cache_lock);
+	else
+		_stacktrace_free_symbols(&pending);
 
-	return _resolve_stack_frames(str, length, trace + skip_frames, max_depth);
+	hashmap_finalize(&pending);
+	memory_deallocate(symbols);
+	array_deallocate(missing);
+
+	return (offset > capacity) ? capacity : offset;
+}
+
+void
+stacktrace_cache_clear(void) {
+	if (!_stacktrace_cache)
+		return;
+	lock_lock(&_stacktrace_cache_lock);
+	_stacktrace_free_symbols(_stacktrace_cache);
+	lock_unlock(&_stacktrace_cache_lock);
 }
 
 int
@@ -891,12 +1151,22 @@ _stacktrace_initialize(void) {
 #if FOUNDATION_PLATFORM_ANDROID
 	_load_process_modules();
 #endif
+	stacktrace_thread_initialize();
+	lock_initialize(&_stacktrace_cache_lock);
+	_stacktrace_cache = hashmap_allocate(0, 0);
 	return 0;
 }
 
 void
 _stacktrace_finalize(void) {
+	hashmap_t* cache = _stacktrace_cache;
+	lock_lock(&_stacktrace_cache_lock);
+	_stacktrace_cache = 0;
+	lock_unlock(&_stacktrace_cache_lock);
+	if (cache) {
+		_stacktrace_free_symbols(cache);
+		hashmap_deallocate(cache);
+	}
 	_finalize_symbol_resolve();
 	_finalize_stackwalker();
 }
-
@@ -15,7 +15,9 @@
 /*! \file stacktrace.h
 \brief Stacktrace utilities
 
-Stacktrace utilities */
+Stacktrace utilities. Resolved symbols are cached per frame address while the foundation
+library is initialized, so resolving the same addresses again only formats the cached
+symbols. Addresses not in the cache are symbolized in a single batch per call. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -28,6 +30,34 @@ Stacktrace utilities */
 FOUNDATION_API size_t
 stacktrace_capture(void** trace, size_t max_depth, size_t skip_frames);
 
+/*! Capture stack trace by walking the frame pointer chain. The capture is async-signal-safe
+and does not lock or allocate memory, making it cheap enough for use in a sampling signal
+handler. Code compiled without frame pointers ends the walk early, resulting in a truncated stack
+trace. On platforms without frame pointer walk support this falls back to #stacktrace_capture.
+\param trace Stack trace buffer. Must be able to hold max_depth number of frame pointers.
+\param max_depth Maximum call stack depth to capture
+\param skip_frames Number of initial frames to skip before starting capture
+\return Number of stack frames captured */
+FOUNDATION_API size_t
+stacktrace_capture_fast(void** trace, size_t max_depth, size_t skip_frames);
+
+/*! Capture stack trace of the interrupted code from a signal handler installed with SA_SIGINFO,
+starting with the interrupted instruction and followed by the frame pointer chain. The capture
+is async-signal-safe.
+\param trace Stack trace buffer. Must be able to hold max_depth number of frame pointers.
+\param max_depth Maximum call stack depth to capture
+\param context Signal handler context argument (ucontext_t)
+\return Number of stack frames captured, zero if not supported */
+FOUNDATION_API size_t
+stacktrace_capture_context(void** trace, size_t max_depth, const void* context);
+
+/*! Cache the stack bounds of the calling thread, used to validate frames in
+#stacktrace_capture_fast. Called automatically for the thread initializing the foundation
+library and for threads started through #thread_start. Threads created by other means should call
+this before being sampled, without the stack bounds the frame walk is limited by heuristics. */
+FOUNDATION_API void
+stacktrace_thread_initialize(void);
+
 /*! Resolve a previously captured stack trace
 \param str Buffer for resolved stack trace string
 \param capacity Capacity of buffer
@@ -37,3 +67,24 @@ stacktrace_capture(void** trace, size_t max_depth, size_t skip_frames);
 \return Resolved stack trace string, empty string if unable to resolve */
 FOUNDATION_API string_t
 stacktrace_resolve(char* str, size_t capacity, void** trace, size_t max_depth, size_t skip_frames);
+
+/*! Resolve multiple previously captured stack traces in one call. Frame addresses not in the
+symbol cache are collected over all traces and symbolized in a single batch. The resolved
+strings are stored consecutively in the buffer, each zero terminated. Traces which do not fit in
+the buffer are truncated or resolved to empty strings.
+\param str Buffer for resolved stack trace strings
+\param capacity Capacity of buffer
+\param traces Stack trace buffers
+\param depths Maximum call stack depth to resolve for each stack trace, zero for the configured
+               stack trace depth
+\param num_traces Number of stack traces
+\param resolved Receives resolved stack trace string for each stack trace
+\return Number of bytes used in buffer */
+FOUNDATION_API size_t
+stacktrace_resolve_many(char* str, size_t capacity, void** const* traces, const size_t* depths,
+                        size_t num_traces, string_t* resolved);
+
+/*! Clear the symbol cache. Should be called after unloading a dynamic library, as its
+addresses may be reused by other code. */
+FOUNDATION_API void
+stacktrace_cache_clear(void);
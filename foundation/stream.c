@@ -23,10 +23,129 @@
 #  include <foundation/posix.h>
 #  include <sys/select.h>
 #  include <sys/stat.h>
+#  include <sys/uio.h>
 #endif
 
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+#  include <sys/sendfile.h>
+#  include <sys/syscall.h>
+#endif
+
+#if FOUNDATION_ARCH_SSE2
+#  include <emmintrin.h>
+#elif FOUNDATION_ARCH_NEON
+#  include <arm_neon.h>
+#endif
+
+//The header macros read memory streams inline, this module implements the generic calls
+#undef stream_read_bool
+#undef stream_read_int8
+#undef stream_read_uint8
+#undef stream_read_int16
+#undef stream_read_uint16
+#undef stream_read_int32
+#undef stream_read_uint32
+#undef stream_read_int64
+#undef stream_read_uint64
+#undef stream_read_float32
+#undef stream_read_float64
+
+#define STREAM_COPY_BUFFER_SIZE (256 * 1024)
+#define STREAM_LINE_BUFFER_SIZE (16 * 1024)
+#define STREAM_SWAP_BUFFER_SIZE (16 * 1024)
+
 static hashtable64_t* _stream_protocol_table;
 
+void
+_stream_swap_array(void* dst, const void* src, size_t count, size_t width) {
+	uint8_t* out = dst;
+	const uint8_t* in = src;
+	size_t ival = 0;
+	size_t vector_count = (width > 1) ? (count * width) / 16 : 0;
+#if FOUNDATION_ARCH_SSE2
+	//Swap bytes in 16-bit lanes, then swap 16-bit lanes within 32 or 64-bit elements
+	for (; ival < vector_count; ++ival, in += 16, out += 16) {
+		__m128i value = _mm_loadu_si128((const __m128i*)(const void*)in);
+		value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+		if (width == 4) {
+			value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+			value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+		else if (width == 8) {
+			value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+			value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+		}
+		_mm_storeu_si128((__m128i*)(void*)out, value);
+	}
+#elif FOUNDATION_ARCH_NEON
+	for (; ival < vector_count; ++ival, in += 16, out += 16) {
+		uint8x16_t value = vld1q_u8(in);
+		if (width == 2)
+			value = vrev16q_u8(value);
+		else if (width == 4)
+			value = vrev32q_u8(value);
+		else
+			value = vrev64q_u8(value);
+		vst1q_u8(out, value);
+	}
+#else
+	vector_count = 0;
+#endif
+	count -= (vector_count * 16) / width;
+	for (ival = 0; ival < count; ++ival, in += width, out += width) {
+		if (width == 2) {
+			uint16_t value;
+			memcpy(&value, in, 2);
+			value = byteorder_swap16(value);
+			memcpy(out, &value, 2);
+		}
+		else if (width == 4) {
+			uint32_t value;
+			memcpy(&value, in, 4);
+			value = byteorder_swap32(value);
+			memcpy(out, &value, 4);
+		}
+		else if (width == 8) {
+			uint64_t value;
+			memcpy(&value, in, 8);
+			value = byteorder_swap64(value);
+			memcpy(out, &value, 8);
+		}
+		else if (out != in) {
+			memcpy(out, in, width);
+		}
+	}
+}
+
+static size_t
+_stream_read_array(stream_t* stream, void* values, size_t count, size_t width) {
+	size_t read = stream_read(stream, values, count * width) / width;
+	if (stream->swap)
+		_stream_swap_array(values, values, read, width);
+	return read;
+}
+
+static void
+_stream_write_array(stream_t* stream, const void* values, size_t count, size_t width) {
+	uint64_t buffer[STREAM_SWAP_BUFFER_SIZE / 8];
+	size_t chunk;
+	if (!stream->swap) {
+		stream_write(stream, values, count * width);
+		return;
+	}
+	//Swap into a bounce buffer to leave the source data untouched
+	while (count) {
+		chunk = sizeof(buffer) / width;
+		if (chunk > count)
+			chunk = count;
+		_stream_swap_array(buffer, values, chunk, width);
+		if (stream_write(stream, buffer, chunk * width) != chunk * width)
+			return;
+		values = pointer_offset_const(values, chunk * width);
+		count -= chunk;
+	}
+}
+
 static stream_t*
 _stream_open_stdout(const char* path, size_t length, unsigned int mode) {
 	FOUNDATION_UNUSED(path);
@@ -63,9 +182,12 @@ _stream_initialize(void) {
 	stream_set_protocol_handler(STRING_CONST("asset"), asset_stream_open);
 #endif
 	stream_set_protocol_handler(STRING_CONST("file"), fs_open_file);
+	stream_set_protocol_handler(STRING_CONST("mmap"), fs_map_file);
 	stream_set_protocol_handler(STRING_CONST("stdout"), _stream_open_stdout);
 	stream_set_protocol_handler(STRING_CONST("stderr"), _stream_open_stderr);
 	stream_set_protocol_handler(STRING_CONST("stdin"), _stream_open_stdin);
+	stream_set_protocol_handler(STRING_CONST("tcp"), socket_stream_open);
+	stream_set_protocol_handler(STRING_CONST("unix"), socket_stream_open);
 	return 0;
 }
 
@@ -212,9 +334,48 @@ stream_read(stream_t* stream, void* buffer, size_t num_bytes) {
 	return stream->vtable->read(stream, buffer, num_bytes);
 }
 
+size_t
+stream_read_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	size_t ispan, read;
+	size_t total = 0;
+
+	if (!(stream->mode & STREAM_IN))
+		return 0;
+	if (stream->vtable->read_vector)
+		return stream->vtable->read_vector(stream, spans, count);
+
+	for (ispan = 0; ispan < count; ++ispan) {
+		read = stream->vtable->read(stream, spans[ispan].data, spans[ispan].size);
+		total += read;
+		if (read < spans[ispan].size)
+			break;
+	}
+	return total;
+}
+
+//Get unread data of streams backed by memory, allowing lines to be scanned in place
+static const char*
+_stream_memory_data(stream_t* stream, size_t* available) {
+	if (stream->type == STREAMTYPE_MEMORY) {
+		stream_buffer_t* buffer_stream = (stream_buffer_t*)stream;
+		*available = buffer_stream->size - buffer_stream->current;
+		return pointer_offset_const(buffer_stream->buffer, buffer_stream->current);
+	}
+	if (stream->type == STREAMTYPE_MAPPED) {
+		size_t size = 0;
+		size_t current = stream_tell(stream);
+		const void* data = fs_mapped_data(stream, &size);
+		*available = (current < size) ? size - current : 0;
+		return data ? pointer_offset_const(data, current) : 0;
+	}
+	return 0;
+}
+
 string_t
 stream_read_line_buffer(stream_t* stream, char* dest, size_t count, char delimiter) {
-	size_t i, read, total, limit, hardlimit;
+	size_t read, total, limit, hardlimit;
+	const char* data;
+	const char* found;
 
 	if (!(stream->mode & STREAM_IN) || !dest || (count < 2)) {
 		if (dest && count)
@@ -222,11 +383,22 @@ stream_read_line_buffer(stream_t* stream, char* dest, size_t count, char delimit
 		return (string_t) { dest, 0 };
 	}
 
+	--count;
+	data = _stream_memory_data(stream, &read);
+	if (data) {
+		limit = (read < count) ? read : count;
+		found = memchr(data, delimiter, limit);
+		total = found ? (size_t)(found - data) : limit;
+		memcpy(dest, data, total);
+		dest[total] = 0;
+		stream_seek(stream, (ssize_t)(total + (found ? 1 : 0)), STREAM_SEEK_CURRENT);
+		return (string_t) { dest, total };
+	}
+
 	total = 0;
-	hardlimit = stream_is_sequential(stream) ? 1 : 128;
+	hardlimit = stream_is_sequential(stream) ? 1 : 512;
 	//Need to read one byte at a time since we can't scan back if overreading in sequential streams
 
-	--count;
 	while (!stream_eos(stream)) {
 		limit = count - total;
 		if (limit > hardlimit)
@@ -239,20 +411,19 @@ stream_read_line_buffer(stream_t* stream, char* dest, size_t count, char delimit
 		read = stream->vtable->read(stream, dest + total, limit);
 		if (!read)
 			break;
-		for (i = 0; i < read; ++i) {
-			/* coverity[read_parm] */
-			if (dest[total + i] == delimiter)
-				break;
-		}
-		total += i;
-		if (i < read) {
-			if ((i + 1) < read) {
+		/* coverity[read_parm] */
+		found = memchr(dest + total, delimiter, read);
+		if (found) {
+			size_t consumed = (size_t)(found - (dest + total)) + 1;
+			total += consumed - 1;
+			if (consumed < read) {
 				//Sequential should never end up here reading one byte at a time
 				FOUNDATION_ASSERT(!stream_is_sequential(stream));
-				stream_seek(stream, (ssize_t)(1 + i) - (ssize_t)read, STREAM_SEEK_CURRENT);
+				stream_seek(stream, (ssize_t)consumed - (ssize_t)read, STREAM_SEEK_CURRENT);
 			}
 			break;
 		}
+		total += read;
 	}
 
 	dest[total] = 0;
@@ -262,16 +433,31 @@ stream_read_line_buffer(stream_t* stream, char* dest, size_t count, char delimit
 
 string_t
 stream_read_line(stream_t* stream, char delimiter) {
-	char buffer[128];
+	char buffer[512];
 	char* outbuffer = 0;
 	size_t outsize = 0;
 	size_t cursize = 0;
 	size_t read, i;
-	size_t want_read = 128;
+	size_t want_read = sizeof(buffer);
+	const char* data;
+	const char* found;
 
 	if (!(stream->mode & STREAM_IN))
 		return (string_t) { 0, 0 };
 
+	data = _stream_memory_data(stream, &read);
+	if (data) {
+		found = memchr(data, delimiter, read);
+		i = found ? (size_t)(found - data) : read;
+		if (i) {
+			outbuffer = memory_allocate(0, i + 1, 0, MEMORY_PERSISTENT);
+			memcpy(outbuffer, data, i);
+			outbuffer[i] = 0;
+		}
+		stream_seek(stream, (ssize_t)(i + (found ? 1 : 0)), STREAM_SEEK_CURRENT);
+		return (string_t) { outbuffer, i };
+	}
+
 	//Need to read one byte at a time since we can't scan back if overreading
 	if (stream_is_sequential(stream))
 		want_read = 1;
@@ -280,10 +466,8 @@ stream_read_line(stream_t* stream, char delimiter) {
 		read = stream->vtable->read(stream, buffer, want_read);
 		if (!read)
 			break;
-		for (i = 0; i < read; ++i) {
-			if (buffer[i] == delimiter)
-				break;
-		}
+		found = memchr(buffer, delimiter, read);
+		i = found ? (size_t)(found - buffer) : read;
 		if (cursize + i > outsize) {
 			size_t nextsize;
 			if (!outbuffer) {
@@ -292,7 +476,8 @@ stream_read_line(stream_t* stream, char delimiter) {
 			}
 			else {
 				nextsize = (outsize < 511 ? 512 : outsize + 513);   //Always aligns to 512 multiples
-				FOUNDATION_ASSERT(!(nextsize % 512));
+				if (nextsize < cursize + i + 1)
+					nextsize = cursize + i + 1;
 				outbuffer = memory_reallocate(outbuffer, nextsize, 0, outsize + 1);
 			}
 			outsize = nextsize - 1;
@@ -317,6 +502,94 @@ stream_read_line(stream_t* stream, char delimiter) {
 	return (string_t) { outbuffer, cursize };
 }
 
+void
+stream_line_iterator_initialize(stream_line_iterator_t* iterator, stream_t* stream,
+                                char delimiter) {
+	size_t available;
+	memset(iterator, 0, sizeof(stream_line_iterator_t));
+	iterator->stream = stream;
+	iterator->delimiter = delimiter;
+	if (!(stream->mode & STREAM_IN) || _stream_memory_data(stream, &available))
+		return;
+	iterator->capacity = STREAM_LINE_BUFFER_SIZE;
+	iterator->buffer = memory_allocate(HASH_STREAM, iterator->capacity, 0, MEMORY_PERSISTENT);
+}
+
+bool
+stream_line_iterator_next(stream_line_iterator_t* iterator, string_const_t* line) {
+	stream_t* stream = iterator->stream;
+	const char* data;
+	const char* found;
+	size_t available, length;
+
+	if (!(stream->mode & STREAM_IN))
+		return false;
+
+	if (!iterator->buffer) {
+		data = _stream_memory_data(stream, &available);
+		if (!data || !available)
+			return false;
+		found = memchr(data, iterator->delimiter, available);
+		length = found ? (size_t)(found - data) : available;
+		stream_seek(stream, (ssize_t)(length + (found ? 1 : 0)), STREAM_SEEK_CURRENT);
+		*line = string_const(data, length);
+		return true;
+	}
+
+	while (true) {
+		data = iterator->buffer + iterator->offset;
+		available = iterator->size - iterator->offset;
+		found = available ? memchr(data, iterator->delimiter, available) : 0;
+		if (found) {
+			length = (size_t)(found - data);
+			iterator->offset += length + 1;
+			*line = string_const(data, length);
+			return true;
+		}
+
+		//Move partial line to start of buffer and grow buffer if line does not fit
+		if (iterator->offset) {
+			memmove(iterator->buffer, data, available);
+			iterator->offset = 0;
+			iterator->size = available;
+		}
+		if (iterator->size == iterator->capacity) {
+			iterator->buffer = memory_reallocate(iterator->buffer, iterator->capacity * 2, 0,
+			                                     iterator->capacity);
+			iterator->capacity *= 2;
+		}
+
+		length = iterator->capacity - iterator->size;
+		if (stream_is_sequential(stream)) {
+			//Avoid blocking on data beyond what is available, but wait for at least one byte
+			size_t ready = stream_available_read(stream);
+			length = ready ? ((ready < length) ? ready : length) : 1;
+		}
+		length = stream_eos(stream) ? 0 :
+		         stream->vtable->read(stream, iterator->buffer + iterator->size, length);
+		if (!length) {
+			//Last line without trailing delimiter
+			if (!iterator->size)
+				return false;
+			*line = string_const(iterator->buffer, iterator->size);
+			iterator->offset = iterator->size;
+			return true;
+		}
+		iterator->size += length;
+	}
+}
+
+void
+stream_line_iterator_finalize(stream_line_iterator_t* iterator) {
+	//Return unconsumed data to seekable streams, positioning them after the last line
+	if (iterator->buffer && (iterator->size > iterator->offset) &&
+	        !stream_is_sequential(iterator->stream))
+		stream_seek(iterator->stream, (ssize_t)iterator->offset - (ssize_t)iterator->size,
+		            STREAM_SEEK_CURRENT);
+	memory_deallocate(iterator->buffer);
+	memset(iterator, 0, sizeof(stream_line_iterator_t));
+}
+
 size_t
 stream_size(stream_t* stream) {
 	return (stream->vtable->size ? stream->vtable->size(stream) : 0);
@@ -499,6 +772,83 @@ stream_read_uint64(stream_t* stream) {
 	return value;
 }
 
+uint64_t
+stream_read_varint(stream_t* stream) {
+	uint64_t value = 0;
+	if (stream_is_binary(stream)) {
+		uint8_t buffer[VARINT_MAX_SIZE];
+		size_t size = 0;
+		do {
+			if (stream_read(stream, buffer + size, 1) != 1)
+				return 0;
+		}
+		while ((buffer[size++] & 0x80) && (size < VARINT_MAX_SIZE));
+		if (!varint_decode(buffer, size, &value))
+			return 0;
+	}
+	else {
+		value = stream_read_uint64(stream);
+	}
+	return value;
+}
+
+int64_t
+stream_read_varint_signed(stream_t* stream) {
+	if (stream_is_binary(stream))
+		return varint_unzigzag(stream_read_varint(stream));
+	return stream_read_int64(stream);
+}
+
+size_t
+stream_read_vbyte(stream_t* stream, uint32_t* values, size_t capacity, bool delta) {
+	size_t count, ival, control_size, data_size, size;
+	uint32_t previous = 0;
+	uint8_t* buffer;
+	uint32_t* decoded;
+
+	count = (size_t)stream_read_varint(stream);
+	if (!stream_is_binary(stream)) {
+		for (ival = 0; ival < count; ++ival) {
+			uint32_t value = stream_read_uint32(stream);
+			if (delta)
+				value += previous;
+			previous = value;
+			if (ival < capacity)
+				values[ival] = value;
+		}
+		return count;
+	}
+	if (!count)
+		return 0;
+
+	//Read control bytes to find the size of the value bytes
+	control_size = (count + 3) / 4;
+	buffer = memory_allocate(HASH_STREAM, vbyte_bound(count), 0, MEMORY_TEMPORARY);
+	if (stream_read(stream, buffer, control_size) != control_size) {
+		memory_deallocate(buffer);
+		return 0;
+	}
+	for (ival = 0, data_size = 0; ival < count; ++ival)
+		data_size += ((buffer[ival / 4] >> ((ival % 4) * 2)) & 3) + 1;
+	size = control_size + data_size;
+	if (stream_read(stream, buffer + control_size, data_size) != data_size) {
+		memory_deallocate(buffer);
+		return 0;
+	}
+
+	decoded = (count > capacity) ?
+	          memory_allocate(HASH_STREAM, sizeof(uint32_t) * count, 0, MEMORY_TEMPORARY) : values;
+	if (vbyte_decode(buffer, size, decoded, count, delta) != size)
+		count = 0;
+	if (decoded != values) {
+		if (count)
+			memcpy(values, decoded, sizeof(uint32_t) * capacity);
+		memory_deallocate(decoded);
+	}
+	memory_deallocate(buffer);
+	return count;
+}
+
 float32_t
 stream_read_float32(stream_t* stream) {
 	float32_t value = 0;
@@ -539,6 +889,56 @@ stream_read_float64(stream_t* stream) {
 	return value;
 }
 
+size_t
+stream_read_uint16_array(stream_t* stream, uint16_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream))
+		return _stream_read_array(stream, values, count, 2);
+	for (ival = 0; (ival < count) && !stream_eos(stream); ++ival)
+		values[ival] = stream_read_uint16(stream);
+	return ival;
+}
+
+size_t
+stream_read_uint32_array(stream_t* stream, uint32_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream))
+		return _stream_read_array(stream, values, count, 4);
+	for (ival = 0; (ival < count) && !stream_eos(stream); ++ival)
+		values[ival] = stream_read_uint32(stream);
+	return ival;
+}
+
+size_t
+stream_read_uint64_array(stream_t* stream, uint64_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream))
+		return _stream_read_array(stream, values, count, 8);
+	for (ival = 0; (ival < count) && !stream_eos(stream); ++ival)
+		values[ival] = stream_read_uint64(stream);
+	return ival;
+}
+
+size_t
+stream_read_float32_array(stream_t* stream, float32_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream))
+		return _stream_read_array(stream, values, count, 4);
+	for (ival = 0; (ival < count) && !stream_eos(stream); ++ival)
+		values[ival] = stream_read_float32(stream);
+	return ival;
+}
+
+size_t
+stream_read_float64_array(stream_t* stream, float64_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream))
+		return _stream_read_array(stream, values, count, 8);
+	for (ival = 0; (ival < count) && !stream_eos(stream); ++ival)
+		values[ival] = stream_read_float64(stream);
+	return ival;
+}
+
 string_t
 stream_read_string(stream_t* stream) {
 	char buffer[128];
@@ -551,6 +951,12 @@ stream_read_string(stream_t* stream) {
 	if (!(stream->mode & STREAM_IN))
 		return (string_t) { 0, 0 };
 
+	//Streams backed by memory are scanned in place and copied with a single allocation
+	if (_stream_memory_data(stream, &read)) {
+		string_const_t view = stream_read_string_view(stream, 0, 0);
+		return view.length ? string_clone(STRING_ARGS(view)) : (string_t) { 0, 0 };
+	}
+
 	if (stream_is_sequential(stream)) {
 		//Single byte reading since we can't seek backwards (and don't want to block on network sockets)
 		char c;
@@ -567,7 +973,8 @@ stream_read_string(stream_t* stream) {
 			}
 		}
 
-		if (cursize > 0) {
+		//Binary strings have no leading whitespace to skip and are read up to the terminator
+		if (binary || (cursize > 0)) {
 			while (!stream_eos(stream)) {
 				read = stream->vtable->read(stream, &c, 1);
 				if (!read)
@@ -736,8 +1143,6 @@ stream_read_string_buffer(stream_t* stream, char* outbuffer, size_t size) {
 				if (!binary && ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t')))
 					break;
 			}
-			if (!i)
-				break;
 			if (cursize + i > size)
 				i = size - cursize;
 			memcpy(outbuffer + cursize, buffer, i);
@@ -756,6 +1161,48 @@ stream_read_string_buffer(stream_t* stream, char* outbuffer, size_t size) {
 	return (string_t) {outbuffer, cursize};
 }
 
+string_const_t
+stream_read_string_view(stream_t* stream, char* buffer, size_t capacity) {
+	size_t available, skip, length;
+	const char* data;
+	const char* end;
+	string_t str;
+
+	if (!(stream->mode & STREAM_IN))
+		return string_const(0, 0);
+
+	data = _stream_memory_data(stream, &available);
+	if (!data) {
+		str = stream_read_string_buffer(stream, buffer, capacity);
+		return string_const(str.str, str.length);
+	}
+
+	skip = 0;
+	if (stream_is_binary(stream)) {
+		end = memchr(data, 0, available);
+		length = end ? (size_t)pointer_diff(end, data) : available;
+	}
+	else {
+		while ((skip < available) && ((data[skip] == ' ') || (data[skip] == '\n') ||
+		                              (data[skip] == '\r') || (data[skip] == '\t')))
+			++skip;
+		data += skip;
+		available -= skip;
+		for (length = 0; length < available; ++length) {
+			char c = data[length];
+			if (!c || (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t'))
+				break;
+		}
+	}
+
+	//Consume the string and its terminator
+	skip += length + ((length < available) ? 1 : 0);
+	if (skip)
+		stream_seek(stream, (ssize_t)skip, STREAM_SEEK_CURRENT);
+
+	return string_const(data, length);
+}
+
 void
 stream_buffer_read(stream_t* stream) {
 	if (stream->vtable->buffer_read)
@@ -769,72 +1216,193 @@ stream_available_read(stream_t* stream) {
 	return (unsigned int)(stream_size(stream) - stream_tell(stream));
 }
 
-uint128_t
-stream_md5(stream_t* stream) {
-	size_t cur, ic, lastc, num, limit;
-	md5_t md5;
-	uint128_t ret = uint128_null();
-	unsigned char buf[1025];
-	bool ignore_lf = false;
+typedef void (* stream_digest_fn)(void* state, const void* buffer, size_t size);
 
-	if (stream->vtable->md5)
-		return stream->vtable->md5(stream);
+static FOUNDATION_FORCEINLINE unsigned int
+_stream_first_bit(uint32_t mask) {
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	_BitScanForward(&index, (unsigned long)mask);
+	return (unsigned int)index;
+#else
+	return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+//Offset of first CR in buffer starting at given offset, size if not found
+static size_t
+_stream_find_cr(const unsigned char* buf, size_t offset, size_t size) {
+#if FOUNDATION_ARCH_SSE2
+	const __m128i cr = _mm_set1_epi8('\r');
+	while (offset + 16 <= size) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(const void*)(buf + offset));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block, cr));
+		if (mask)
+			return offset + _stream_first_bit(mask);
+		offset += 16;
+	}
+#elif FOUNDATION_ARCH_NEON
+	const uint8x16_t cr = vdupq_n_u8('\r');
+	while (offset + 16 <= size) {
+		uint8x16_t match = vceqq_u8(vld1q_u8(buf + offset), cr);
+		uint8x8_t any = vorr_u8(vget_low_u8(match), vget_high_u8(match));
+		if (vget_lane_u64(vreinterpret_u64_u8(any), 0))
+			break;
+		offset += 16;
+	}
+#else
+	while (offset + 8 <= size) {
+		uint64_t block;
+		memcpy(&block, buf + offset, sizeof(block));
+		block ^= 0x0D0D0D0D0D0D0D0DULL;
+		if ((block - 0x0101010101010101ULL) & ~block & 0x8080808080808080ULL)
+			break;
+		offset += 8;
+	}
+#endif
+	while ((offset < size) && (buf[offset] != '\r'))
+		++offset;
+	return offset;
+}
+
+//Normalize line endings in place, treating all line endings (LF, CR, CR+LF) as Unix style LF.
+//A CR ending the buffer sets the ignore flag so a leading LF in the next buffer is skipped.
+//Returns the normalized size
+static size_t
+_stream_normalize_line_endings(unsigned char* buf, size_t size, bool* ignore_lf) {
+	size_t in = 0;
+	size_t out = 0;
+	size_t next;
+
+	if (*ignore_lf && size && (buf[0] == '\n'))
+		in = 1;
+	*ignore_lf = false;
+
+	while (in < size) {
+		next = _stream_find_cr(buf, in, size);
+		if (out != in)
+			memmove(buf + out, buf + in, next - in);
+		out += next - in;
+		if (next == size)
+			break;
+		buf[out++] = '\n';
+		in = next + 1;
+		if (in == size)
+			*ignore_lf = true;
+		else if (buf[in] == '\n')
+			++in;
+	}
+
+	return out;
+}
+
+//Digest stream content from the beginning, normalizing line endings for text streams
+static bool
+_stream_digest_content(stream_t* stream, stream_digest_fn digest, void* state) {
+	size_t cur, num;
+	unsigned char* buffer;
+	bool ignore_lf = false;
 
 	if (stream_is_sequential(stream) || !(stream->mode & STREAM_IN))
-		return ret;
+		return false;
 
 	cur = stream_tell(stream);
 	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
 
-	md5_initialize(&md5);
-	limit = sizeof(buf)-1;
-	buf[limit] = 0;
-
+	buffer = memory_allocate(0, STREAM_COPY_BUFFER_SIZE, 0, MEMORY_TEMPORARY);
 	while (!stream_eos(stream)) {
-		num = stream->vtable->read(stream, buf, limit);
+		num = stream->vtable->read(stream, buffer, STREAM_COPY_BUFFER_SIZE);
 		if (!num)
 			continue;
-		if (stream->mode & STREAM_BINARY)
-			md5_digest(&md5, buf, (size_t)num);
-		else {
-			//If last buffer ended with CR, ignore a leading LF
-			lastc = 0;
-			if (ignore_lf && (buf[0] == '\n'))
-				lastc = 1;
-			ignore_lf = false;
-
-			//Digest one line at a time
-			//Treat all line endings (LF, CR, CR+LF) as Unix style LF. If file has mixed line endings
-			//(for example, one line ending in a single CR and next is empty and ending in a single LF),
-			//it will not work!
-			/*lint -e{850} */
-			for (ic = lastc; ic < num && ic < limit; ++ic) {
-				bool was_cr = (buf[ic] == '\r');
-				bool was_lf = (buf[ic] == '\n');
-				if (was_cr || was_lf) {
-					if (was_cr && (ic == limit-1))
-						ignore_lf = true; //Make next buffer ignore leading LF as it is part of CR+LF
-					buf[ic] = '\n';
-					md5_digest(&md5, buf + lastc, (size_t)((ic - lastc) + 1)); //Include the LF
-					if (was_cr && (buf[ic + 1] == '\n'))  //Check for CR+LF
-						++ic;
-					lastc = ic + 1;
-				}
-			}
-			if (lastc < num)
-				md5_digest(&md5, buf + lastc, (size_t)(num - lastc));
-		}
+		if (!(stream->mode & STREAM_BINARY))
+			num = _stream_normalize_line_endings(buffer, num, &ignore_lf);
+		if (num)
+			digest(state, buffer, num);
 	}
+	memory_deallocate(buffer);
 
 	stream_seek(stream, (ssize_t)cur, STREAM_SEEK_BEGIN);
 
-	md5_digest_finalize(&md5);
-	ret = md5_get_digest_raw(&md5);
+	return true;
+}
+
+static void
+_stream_digest_md5(void* state, const void* buffer, size_t size) {
+	md5_digest(state, buffer, size);
+}
+
+static void
+_stream_digest_sha256(void* state, const void* buffer, size_t size) {
+	sha256_digest(state, buffer, size);
+}
+
+uint128_t
+stream_md5(stream_t* stream) {
+	md5_t md5;
+	uint128_t ret = uint128_null();
+
+	if (stream->vtable->md5)
+		return stream->vtable->md5(stream);
+
+	md5_initialize(&md5);
+	if (_stream_digest_content(stream, _stream_digest_md5, &md5)) {
+		md5_digest_finalize(&md5);
+		ret = md5_get_digest_raw(&md5);
+	}
 	md5_finalize(&md5);
 
 	return ret;
 }
 
+uint256_t
+stream_sha256(stream_t* stream) {
+	sha256_t sha256;
+	uint256_t ret = uint256_null();
+
+	sha256_initialize(&sha256);
+	if (_stream_digest_content(stream, _stream_digest_sha256, &sha256)) {
+		sha256_digest_finalize(&sha256);
+		ret = sha256_get_digest_raw(&sha256);
+	}
+	sha256_finalize(&sha256);
+
+	return ret;
+}
+
+uint64_t
+stream_checksum(stream_t* stream, checksum_type_t type) {
+	size_t cur, num;
+	checksum_t checksum;
+	const void* data;
+	void* buffer;
+
+	if (stream_is_sequential(stream) || !(stream->mode & STREAM_IN))
+		return 0;
+
+	checksum_initialize(&checksum, type);
+
+	//Memory backed streams are digested in place
+	cur = stream_tell(stream);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	data = _stream_memory_data(stream, &num);
+	if (data) {
+		checksum_digest(&checksum, data, num);
+	}
+	else {
+		buffer = memory_allocate(0, STREAM_COPY_BUFFER_SIZE, 0, MEMORY_TEMPORARY);
+		while (!stream_eos(stream)) {
+			num = stream->vtable->read(stream, buffer, STREAM_COPY_BUFFER_SIZE);
+			if (!num)
+				break;
+			checksum_digest(&checksum, buffer, num);
+		}
+		memory_deallocate(buffer);
+	}
+	stream_seek(stream, (ssize_t)cur, STREAM_SEEK_BEGIN);
+
+	return checksum_value(&checksum);
+}
+
 size_t
 stream_write(stream_t* stream, const void* buffer, size_t num_bytes) {
 	if (!(stream->mode & STREAM_OUT))
@@ -842,6 +1410,198 @@ stream_write(stream_t* stream, const void* buffer, size_t num_bytes) {
 	return stream->vtable->write(stream, buffer, num_bytes);
 }
 
+size_t
+stream_write_vector(stream_t* stream, const stream_span_t* spans, size_t count) {
+	size_t ispan, written;
+	size_t total = 0;
+
+	if (!(stream->mode & STREAM_OUT))
+		return 0;
+	if (stream->vtable->write_vector)
+		return stream->vtable->write_vector(stream, spans, count);
+
+	for (ispan = 0; ispan < count; ++ispan) {
+		written = stream->vtable->write(stream, spans[ispan].data, spans[ispan].size);
+		total += written;
+		if (written < spans[ispan].size)
+			break;
+	}
+	return total;
+}
+
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+static int
+_stream_copy_descriptor_acquire(stream_t* stream, bool write) {
+	if (stream->type == STREAMTYPE_FILE)
+		return _fs_file_descriptor_acquire(stream);
+	if (stream->type == STREAMTYPE_PIPE) {
+		int fd = write ? pipe_write_handle(stream) : pipe_read_handle(stream);
+		return fd ? fd : -1;
+	}
+	return -1;
+}
+
+static void
+_stream_copy_descriptor_release(stream_t* stream, int fd, bool eos) {
+	if (stream->type == STREAMTYPE_FILE)
+		_fs_file_descriptor_release(stream, fd, eos);
+	else if ((stream->type == STREAMTYPE_PIPE) && eos)
+		((stream_pipe_t*)stream)->eos = true;
+}
+
+//Copy between descriptors without passing data through user space. Methods are tried in
+//order until one is supported for the descriptor pair, copy_file_range for files (which
+//can clone extents on copy-on-write file systems), sendfile from a file to any descriptor
+//and splice to or from a pipe
+static size_t
+_stream_copy_kernel(int fd_out, int fd_in, size_t bytes, bool* eos) {
+	size_t total = 0;
+	int method = 0;
+	struct stat st_in, st_out;
+
+	//Only splice can move data to or from a pipe, skip the other attempts for pipe forwarding
+	if (((fstat(fd_in, &st_in) == 0) && S_ISFIFO(st_in.st_mode)) ||
+	        ((fstat(fd_out, &st_out) == 0) && S_ISFIFO(st_out.st_mode)))
+		method = 2;
+
+	while ((!bytes || (total < bytes)) && (method < 3)) {
+		size_t chunk = 1024 * 1024 * 1024;
+		ssize_t done;
+
+		if (bytes && (bytes - total < chunk))
+			chunk = bytes - total;
+		if (method == 0) {
+#if defined(__NR_copy_file_range)
+			done = syscall(__NR_copy_file_range, fd_in, 0, fd_out, 0, chunk, 0);
+#else
+			done = -1;
+			errno = ENOSYS;
+#endif
+		}
+		else if (method == 1) {
+			done = sendfile(fd_out, fd_in, 0, chunk);
+		}
+		else {
+			done = splice(fd_in, 0, fd_out, 0, chunk, SPLICE_F_MOVE);
+		}
+
+		if (done < 0) {
+			if (errno != EINTR)
+				++method;
+			continue;
+		}
+		if (!done) {
+			*eos = true;
+			break;
+		}
+		total += (size_t)done;
+	}
+
+	return total;
+}
+
+#endif
+
+size_t
+stream_copy(stream_t* dest, stream_t* source, size_t bytes) {
+	size_t total = 0;
+	void* buffer;
+
+	if (!(source->mode & STREAM_IN) || !(dest->mode & STREAM_OUT))
+		return 0;
+
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	{
+		int fd_in = _stream_copy_descriptor_acquire(source, false);
+		int fd_out = (fd_in >= 0) ? _stream_copy_descriptor_acquire(dest, true) : -1;
+		bool eos = false;
+		if (fd_out >= 0) {
+			total = _stream_copy_kernel(fd_out, fd_in, bytes, &eos);
+			_stream_copy_descriptor_release(dest, fd_out, false);
+		}
+		if (fd_in >= 0)
+			_stream_copy_descriptor_release(source, fd_in, eos);
+		if (eos || (bytes && (total >= bytes)))
+			return total;
+	}
+#endif
+
+	//Copy remaining data through a large buffer
+	buffer = memory_allocate(0, STREAM_COPY_BUFFER_SIZE, 0, MEMORY_TEMPORARY);
+	while ((!bytes || (total < bytes)) && !stream_eos(source)) {
+		size_t num = STREAM_COPY_BUFFER_SIZE;
+		size_t was_read, was_written;
+		if (bytes && (bytes - total < num))
+			num = bytes - total;
+		was_read = stream_read(source, buffer, num);
+		if (!was_read)
+			continue;
+		was_written = stream_write(dest, buffer, was_read);
+		total += was_written;
+		if (was_written < was_read)
+			break;
+	}
+	memory_deallocate(buffer);
+
+	return total;
+}
+
+#if FOUNDATION_PLATFORM_POSIX
+
+//Spans are passed to the kernel in batches, well below the IOV_MAX minimum of all platforms
+#define STREAM_VECTOR_BATCH 16
+
+size_t
+_stream_fd_vector(int fd, const stream_span_t* spans, size_t count, bool write) {
+	struct iovec iov[STREAM_VECTOR_BATCH];
+	size_t total = 0;
+	size_t ispan = 0;
+	size_t offset = 0;
+
+	while (ispan < count) {
+		int iovcnt = 0;
+		size_t iscan, skip, remain;
+		ssize_t done;
+
+		for (iscan = ispan, skip = offset; (iscan < count) && (iovcnt < STREAM_VECTOR_BATCH);
+		        ++iscan, skip = 0) {
+			if (spans[iscan].size > skip) {
+				iov[iovcnt].iov_base = pointer_offset(spans[iscan].data, skip);
+				iov[iovcnt].iov_len = spans[iscan].size - skip;
+				++iovcnt;
+			}
+		}
+		if (!iovcnt)
+			break;
+
+		done = write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+		if ((done < 0) && (errno == EINTR))
+			continue;
+		if (done <= 0)
+			break;
+		total += (size_t)done;
+
+		//Advance past transferred bytes, a short transfer resumes mid-span
+		for (remain = (size_t)done; remain && (ispan < count);) {
+			size_t left = spans[ispan].size - offset;
+			if (remain >= left) {
+				remain -= left;
+				offset = 0;
+				++ispan;
+			}
+			else {
+				offset += remain;
+				remain = 0;
+			}
+		}
+	}
+
+	return total;
+}
+
+#endif
+
 void
 stream_write_bool(stream_t* stream, bool data) {
 	if (stream_is_binary(stream)) {
@@ -954,6 +1714,44 @@ stream_write_uint64(stream_t* stream, uint64_t data) {
 	}
 }
 
+void
+stream_write_varint(stream_t* stream, uint64_t data) {
+	if (stream_is_binary(stream)) {
+		uint8_t buffer[VARINT_MAX_SIZE];
+		stream_write(stream, buffer, varint_encode(data, buffer));
+	}
+	else {
+		stream_write_uint64(stream, data);
+	}
+}
+
+void
+stream_write_varint_signed(stream_t* stream, int64_t data) {
+	if (stream_is_binary(stream))
+		stream_write_varint(stream, varint_zigzag(data));
+	else
+		stream_write_int64(stream, data);
+}
+
+void
+stream_write_vbyte(stream_t* stream, const uint32_t* values, size_t count, bool delta) {
+	stream_write_varint(stream, count);
+	if (!stream_is_binary(stream)) {
+		size_t ival;
+		uint32_t previous = 0;
+		for (ival = 0; ival < count; ++ival) {
+			stream_write_string(stream, STRING_CONST(" "));
+			stream_write_uint32(stream, delta ? values[ival] - previous : values[ival]);
+			previous = values[ival];
+		}
+	}
+	else if (count) {
+		uint8_t* buffer = memory_allocate(HASH_STREAM, vbyte_bound(count), 0, MEMORY_TEMPORARY);
+		stream_write(stream, buffer, vbyte_encode(values, count, delta, buffer));
+		memory_deallocate(buffer);
+	}
+}
+
 void
 stream_write_float32(stream_t* stream, float32_t data) {
 	if (stream_is_binary(stream)) {
@@ -992,6 +1790,76 @@ stream_write_float64(stream_t* stream, float64_t data) {
 	}
 }
 
+void
+stream_write_uint16_array(stream_t* stream, const uint16_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream)) {
+		_stream_write_array(stream, values, count, 2);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival) {
+		if (ival)
+			stream_write_string(stream, STRING_CONST(" "));
+		stream_write_uint16(stream, values[ival]);
+	}
+}
+
+void
+stream_write_uint32_array(stream_t* stream, const uint32_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream)) {
+		_stream_write_array(stream, values, count, 4);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival) {
+		if (ival)
+			stream_write_string(stream, STRING_CONST(" "));
+		stream_write_uint32(stream, values[ival]);
+	}
+}
+
+void
+stream_write_uint64_array(stream_t* stream, const uint64_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream)) {
+		_stream_write_array(stream, values, count, 8);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival) {
+		if (ival)
+			stream_write_string(stream, STRING_CONST(" "));
+		stream_write_uint64(stream, values[ival]);
+	}
+}
+
+void
+stream_write_float32_array(stream_t* stream, const float32_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream)) {
+		_stream_write_array(stream, values, count, 4);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival) {
+		if (ival)
+			stream_write_string(stream, STRING_CONST(" "));
+		stream_write_float32(stream, values[ival]);
+	}
+}
+
+void
+stream_write_float64_array(stream_t* stream, const float64_t* values, size_t count) {
+	size_t ival;
+	if (stream_is_binary(stream)) {
+		_stream_write_array(stream, values, count, 8);
+		return;
+	}
+	for (ival = 0; ival < count; ++ival) {
+		if (ival)
+			stream_write_string(stream, STRING_CONST(" "));
+		stream_write_float64(stream, values[ival]);
+	}
+}
+
 void
 stream_write_string(stream_t* stream, const char* str, size_t length) {
 	if (str && length)
@@ -1034,6 +1902,12 @@ stream_flush(stream_t* stream) {
 		stream->vtable->flush(stream);
 }
 
+void
+stream_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	if (stream->vtable->advise)
+		stream->vtable->advise(stream, advice, offset, size);
+}
+
 #include <stdio.h>
 
 /*lint -e754 */
@@ -1140,6 +2014,8 @@ static stream_vtable_t _stream_stdout_vtable = {
 	0,
 	_stream_stdout_write,
 	0,
+	0,
+	0,
 	_stream_stdout_flush,
 	0,
 	0,
@@ -1150,13 +2026,16 @@ static stream_vtable_t _stream_stdout_vtable = {
 	0,
 	0,
 	0,
-	_stream_std_clone
+	_stream_std_clone,
+	0
 };
 
 
 static stream_vtable_t _stream_stdin_vtable = {
 	_stream_stdin_read,
 	0,
+	0,
+	0,
 	_stream_stdin_eos,
 	0,
 	0,
@@ -1168,7 +2047,8 @@ static stream_vtable_t _stream_stdin_vtable = {
 	0,
 	_stream_stdin_available_read,
 	0,
-	_stream_std_clone
+	_stream_std_clone,
+	0
 };
 
 stream_t*
@@ -1212,3 +2092,246 @@ stream_open_stdin(void) {
 	stream->std = stdin;
 	return (stream_t*)stream;
 }
+
+#define STREAM_BUFFERED_DEFAULT_SIZE (64 * 1024)
+
+static bool
+_stream_buffered_write_pending(stream_buffered_t* buffered) {
+	size_t pending = buffered->write_size;
+	if (!pending)
+		return true;
+	//Data the wrapped stream does not accept is discarded like a failed unbuffered write
+	buffered->write_size = 0;
+	return stream_write(buffered->stream, buffered->write_buffer, pending) == pending;
+}
+
+static void
+_stream_buffered_discard_read(stream_buffered_t* buffered) {
+	size_t unread = buffered->read_size - buffered->read_offset;
+	//Move wrapped stream back to the logical position, sequential streams can not seek back
+	//and keep the read-ahead data instead
+	if (buffered->sequential)
+		return;
+	if (unread)
+		stream_seek(buffered->stream, -(ssize_t)unread, STREAM_SEEK_CURRENT);
+	buffered->read_offset = 0;
+	buffered->read_size = 0;
+}
+
+static size_t
+_stream_buffered_read(stream_t* stream, void* buffer, size_t num_bytes) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	char* dest = buffer;
+	size_t total = 0;
+	size_t available, want, was_read;
+
+	_stream_buffered_write_pending(buffered);
+
+	while (total < num_bytes) {
+		available = buffered->read_size - buffered->read_offset;
+		if (available) {
+			if (available > num_bytes - total)
+				available = num_bytes - total;
+			memcpy(dest + total, buffered->read_buffer + buffered->read_offset, available);
+			buffered->read_offset += available;
+			total += available;
+			continue;
+		}
+
+		want = num_bytes - total;
+		if (want >= buffered->capacity)
+			return total + stream_read(buffered->stream, dest + total, want);
+
+		//Sequential streams only read ahead what is available without blocking
+		if (buffered->sequential) {
+			available = stream_available_read(buffered->stream);
+			if (available > want)
+				want = (available < buffered->capacity) ? available : buffered->capacity;
+		}
+		else {
+			want = buffered->capacity;
+		}
+		was_read = stream_read(buffered->stream, buffered->read_buffer, want);
+		buffered->read_offset = 0;
+		buffered->read_size = was_read;
+		if (!was_read)
+			break;
+	}
+
+	return total;
+}
+
+static size_t
+_stream_buffered_write(stream_t* stream, const void* buffer, size_t num_bytes) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+
+	_stream_buffered_discard_read(buffered);
+
+	if ((buffered->write_size + num_bytes > buffered->capacity) &&
+	        !_stream_buffered_write_pending(buffered))
+		return 0;
+	if (num_bytes >= buffered->capacity)
+		return stream_write(buffered->stream, buffer, num_bytes);
+
+	memcpy(buffered->write_buffer + buffered->write_size, buffer, num_bytes);
+	buffered->write_size += num_bytes;
+	return num_bytes;
+}
+
+static bool
+_stream_buffered_eos(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	if (buffered->read_offset < buffered->read_size)
+		return false;
+	return stream_eos(buffered->stream);
+}
+
+static void
+_stream_buffered_flush(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	_stream_buffered_write_pending(buffered);
+	stream_flush(buffered->stream);
+}
+
+static void
+_stream_buffered_truncate(stream_t* stream, size_t size) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	_stream_buffered_write_pending(buffered);
+	_stream_buffered_discard_read(buffered);
+	stream_truncate(buffered->stream, size);
+}
+
+static size_t
+_stream_buffered_size(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	_stream_buffered_write_pending(buffered);
+	return stream_size(buffered->stream);
+}
+
+static void
+_stream_buffered_seek(stream_t* stream, ssize_t offset, stream_seek_mode_t direction) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+
+	_stream_buffered_write_pending(buffered);
+
+	if (direction == STREAM_SEEK_CURRENT) {
+		size_t unread = buffered->read_size - buffered->read_offset;
+		//Seek within read-ahead data, also allows sequential streams to seek back
+		if ((offset >= -(ssize_t)buffered->read_offset) && (offset <= (ssize_t)unread)) {
+			buffered->read_offset = (size_t)((ssize_t)buffered->read_offset + offset);
+			return;
+		}
+		if (buffered->sequential) {
+			buffered->read_offset = 0;
+			buffered->read_size = 0;
+			if (offset > (ssize_t)unread)
+				stream_seek(buffered->stream, offset - (ssize_t)unread, STREAM_SEEK_CURRENT);
+			return;
+		}
+	}
+
+	_stream_buffered_discard_read(buffered);
+	buffered->read_offset = 0;
+	buffered->read_size = 0;
+	stream_seek(buffered->stream, offset, direction);
+}
+
+static size_t
+_stream_buffered_tell(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	size_t position = stream_tell(buffered->stream) + buffered->write_size;
+	size_t unread = buffered->read_size - buffered->read_offset;
+	return (position > unread) ? position - unread : 0;
+}
+
+static tick_t
+_stream_buffered_last_modified(const stream_t* stream) {
+	return stream_last_modified(((const stream_buffered_t*)stream)->stream);
+}
+
+static void
+_stream_buffered_buffer_read(stream_t* stream) {
+	stream_buffer_read(((stream_buffered_t*)stream)->stream);
+}
+
+static size_t
+_stream_buffered_available_read(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+	return (buffered->read_size - buffered->read_offset) + stream_available_read(buffered->stream);
+}
+
+static void
+_stream_buffered_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size) {
+	//Buffered stream position maps directly to wrapped stream position
+	stream_advise(((stream_buffered_t*)stream)->stream, advice, offset, size);
+}
+
+static void
+_stream_buffered_finalize(stream_t* stream) {
+	stream_buffered_t* buffered = (stream_buffered_t*)stream;
+
+	if (!buffered || (stream->type != STREAMTYPE_BUFFERED))
+		return;
+
+	_stream_buffered_write_pending(buffered);
+	if (buffered->own)
+		stream_deallocate(buffered->stream);
+
+	memory_deallocate(buffered->read_buffer);
+	memory_deallocate(buffered->write_buffer);
+	buffered->stream = 0;
+	buffered->read_buffer = 0;
+	buffered->write_buffer = 0;
+}
+
+static stream_vtable_t _stream_buffered_vtable = {
+	_stream_buffered_read,
+	_stream_buffered_write,
+	0,
+	0,
+	_stream_buffered_eos,
+	_stream_buffered_flush,
+	_stream_buffered_truncate,
+	_stream_buffered_size,
+	_stream_buffered_seek,
+	_stream_buffered_tell,
+	_stream_buffered_last_modified,
+	0,
+	_stream_buffered_buffer_read,
+	_stream_buffered_available_read,
+	_stream_buffered_finalize,
+	0,
+	_stream_buffered_advise
+};
+
+stream_t*
+stream_buffered_allocate(stream_t* stream, size_t buffer_size, bool adopt) {
+	stream_buffered_t* buffered = memory_allocate(HASH_STREAM, sizeof(stream_buffered_t), 8,
+	                                              MEMORY_PERSISTENT);
+	stream_buffered_initialize(buffered, stream, buffer_size, adopt);
+	return (stream_t*)buffered;
+}
+
+void
+stream_buffered_initialize(stream_buffered_t* buffered, stream_t* stream, size_t buffer_size,
+                           bool adopt) {
+	memset(buffered, 0, sizeof(stream_buffered_t));
+	stream_initialize((stream_t*)buffered, stream_byteorder(stream));
+
+	buffered->type = STREAMTYPE_BUFFERED;
+	buffered->sequential = stream->sequential;
+	buffered->reliable = stream->reliable;
+	buffered->inorder = stream->inorder;
+	buffered->mode = stream->mode;
+	buffered->path = string_clone(STRING_ARGS(stream->path));
+	buffered->vtable = &_stream_buffered_vtable;
+	buffered->stream = stream;
+	buffered->own = adopt;
+	buffered->capacity = buffer_size ? buffer_size : STREAM_BUFFERED_DEFAULT_SIZE;
+	if (stream->mode & STREAM_IN)
+		buffered->read_buffer = memory_allocate(HASH_STREAM, buffered->capacity, 0,
+		                                        MEMORY_PERSISTENT);
+	if (stream->mode & STREAM_OUT)
+		buffered->write_buffer = memory_allocate(HASH_STREAM, buffered->capacity, 0,
+		                                         MEMORY_PERSISTENT);
+}
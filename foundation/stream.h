@@ -15,10 +15,21 @@
 /*! \file stream.h
 \brief Stream I/O
 
-Base abstraction of I/O streams. */
+Base abstraction of I/O streams.
+
+Any stream can be wrapped in a buffered stream, adding a read-ahead and a write-behind buffer
+so that small reads and writes like stream_read_int32 are served from memory instead of
+calling the wrapped stream implementation each time. Writes are passed on when the buffer is
+full or the stream is flushed, seeked, truncated or read from. For sequential wrapped streams
+read-ahead is limited to the number of bytes reported by stream_available_read, so reads never
+block waiting for more data than requested.
+
+Typed binary reads like stream_read_uint32 from memory buffer streams and memory mapped
+streams are done inline directly from memory, without calling through the stream vtable. */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
+#include <foundation/bits.h>
 
 /*! Open stream with the given path, which may include a protocol specifier.
 \param path Path
@@ -160,6 +171,17 @@ stream_last_modified(const stream_t* stream);
 FOUNDATION_API size_t
 stream_read(stream_t* stream, void* buffer, size_t num_bytes);
 
+/*! Read raw data from stream into multiple buffers, disregarding byte order. The buffers
+are filled in order as if they were one contiguous buffer. File and pipe streams read all
+buffers with a single system call where supported, other streams read each buffer in turn.
+\param stream Stream
+\param spans Destination buffer spans
+\param count Number of buffer spans
+\return Total number of bytes read, less than the total size of the spans if end of
+        stream was reached */
+FOUNDATION_API size_t
+stream_read_vector(stream_t* stream, const stream_span_t* spans, size_t count);
+
 /*! Read line of up to count characters, consuming but discarding delimiter, reading into buffer.
 \param stream Stream
 \param dest Destination buffer, null if input is to be ignored
@@ -177,6 +199,32 @@ be freed with a call to #string_deallocate
 FOUNDATION_API string_t
 stream_read_line(stream_t* stream, char delimiter);
 
+/*! Initialize an iterator over lines in a stream. Lines of memory buffer and memory mapped
+streams are returned in place without copying, lines of other streams are returned from an
+internal buffer. Delimiters are located with a vectorized scan of the data.
+\param iterator Line iterator
+\param stream Stream
+\param delimiter Line delimiter */
+FOUNDATION_API void
+stream_line_iterator_initialize(stream_line_iterator_t* iterator, stream_t* stream,
+                                char delimiter);
+
+/*! Get the next line from the stream, discarding delimiter. The returned string is not zero
+terminated and is only valid until the next call to #stream_line_iterator_next or
+#stream_line_iterator_finalize. The last line is returned even if not terminated by a
+delimiter.
+\param iterator Line iterator
+\param line Receives the line
+\return true if a line was read, false if end of stream */
+FOUNDATION_API bool
+stream_line_iterator_next(stream_line_iterator_t* iterator, string_const_t* line);
+
+/*! Finalize a line iterator. Streams that are not sequential are positioned directly after
+the last returned line, data buffered ahead by the iterator in sequential streams is lost.
+\param iterator Line iterator */
+FOUNDATION_API void
+stream_line_iterator_finalize(stream_line_iterator_t* iterator);
+
 /*! Read boolean value from stream.
 \param stream Stream
 \return Boolean value read, false if error */
@@ -231,6 +279,31 @@ stream_read_int64(stream_t* stream);
 FOUNDATION_API uint64_t
 stream_read_uint64(stream_t* stream);
 
+/*! Read varint coded unsigned integer from stream, see #varint_encode. In text mode the
+value is read as a decimal number like #stream_read_uint64.
+\param stream Stream
+\return Value read, 0 if error */
+FOUNDATION_API uint64_t
+stream_read_varint(stream_t* stream);
+
+/*! Read zigzag and varint coded integer from stream, see #varint_zigzag. In text mode the
+value is read as a decimal number like #stream_read_int64.
+\param stream Stream
+\return Value read, 0 if error */
+FOUNDATION_API int64_t
+stream_read_varint_signed(stream_t* stream);
+
+/*! Read an array of 32-bit values written with #stream_write_vbyte. If the array holds more
+values than the given capacity, the entire array is consumed but only the first capacity
+values are stored.
+\param stream Stream
+\param values Destination array
+\param capacity Capacity of destination array
+\param delta Values were delta coded
+\return Number of values in the array written to stream, 0 if error */
+FOUNDATION_API size_t
+stream_read_vbyte(stream_t* stream, uint32_t* values, size_t capacity, bool delta);
+
 /*! Read 32-bit float from stream
 \param stream Stream
 \return Value read, 0 if error */
@@ -243,6 +316,56 @@ stream_read_float32(stream_t* stream);
 FOUNDATION_API float64_t
 stream_read_float64(stream_t* stream);
 
+/*! Read an array of 16-bit unsigned integer values from stream. In binary mode all values are read with a
+single read operation and byte order swapped in bulk if needed, in text mode values are read
+one by one as whitespace separated numbers.
+\param stream Stream
+\param values Destination array
+\param count Number of values to read
+\return Number of values read */
+FOUNDATION_API size_t
+stream_read_uint16_array(stream_t* stream, uint16_t* values, size_t count);
+
+/*! Read an array of 32-bit unsigned integer values from stream. In binary mode all values are read with a
+single read operation and byte order swapped in bulk if needed, in text mode values are read
+one by one as whitespace separated numbers.
+\param stream Stream
+\param values Destination array
+\param count Number of values to read
+\return Number of values read */
+FOUNDATION_API size_t
+stream_read_uint32_array(stream_t* stream, uint32_t* values, size_t count);
+
+/*! Read an array of 64-bit unsigned integer values from stream. In binary mode all values are read with a
+single read operation and byte order swapped in bulk if needed, in text mode values are read
+one by one as whitespace separated numbers.
+\param stream Stream
+\param values Destination array
+\param count Number of values to read
+\return Number of values read */
+FOUNDATION_API size_t
+stream_read_uint64_array(stream_t* stream, uint64_t* values, size_t count);
+
+/*! Read an array of 32-bit float values from stream. In binary mode all values are read with a
+single read operation and byte order swapped in bulk if needed, in text mode values are read
+one by one as whitespace separated numbers.
+\param stream Stream
+\param values Destination array
+\param count Number of values to read
+\return Number of values read */
+FOUNDATION_API size_t
+stream_read_float32_array(stream_t* stream, float32_t* values, size_t count);
+
+/*! Read an array of 64-bit float values from stream. In binary mode all values are read with a
+single read operation and byte order swapped in bulk if needed, in text mode values are read
+one by one as whitespace separated numbers.
+\param stream Stream
+\param values Destination array
+\param count Number of values to read
+\return Number of values read */
+FOUNDATION_API size_t
+stream_read_float64_array(stream_t* stream, float64_t* values, size_t count);
+
 /*! Read string from stream. Must be freed with a call to #string_deallocate
 \param stream Stream
 \return String, null string if error or if no bytes (or in binary mode, an empty string)
@@ -258,6 +381,18 @@ stream_read_string(stream_t* stream);
 FOUNDATION_API string_t
 stream_read_string_buffer(stream_t* stream, char* buffer, size_t capacity);
 
+/*! Read string from stream without copying. Strings in memory buffer and memory mapped streams
+are returned in place pointing directly into the stream memory, strings in other streams are
+read into the given buffer as with #stream_read_string_buffer. A string returned in place is only
+valid as long as the stream memory is not modified or unmapped, and is not zero terminated in
+text mode. In binary mode the string is followed by its zero terminator in stream memory.
+\param stream Stream
+\param buffer Buffer used for streams not backed by memory
+\param capacity Size of buffer, including terminating zero
+\return String, null string if error */
+FOUNDATION_API string_const_t
+stream_read_string_view(stream_t* stream, char* buffer, size_t capacity);
+
 /*! Write raw data to stream.
 \param stream Stream
 \param buffer Buffer of data to write
@@ -266,6 +401,28 @@ stream_read_string_buffer(stream_t* stream, char* buffer, size_t capacity);
 FOUNDATION_API size_t
 stream_write(stream_t* stream, const void* buffer, size_t num_bytes);
 
+/*! Write raw data from multiple buffers to stream. The buffers are written in order as if
+they were one contiguous buffer, for example a record header followed by its payload. File
+and pipe streams write all buffers with a single system call where supported, other streams
+write each buffer in turn.
+\param stream Stream
+\param spans Source buffer spans
+\param count Number of buffer spans
+\return Total number of bytes written */
+FOUNDATION_API size_t
+stream_write_vector(stream_t* stream, const stream_span_t* spans, size_t count);
+
+/*! Copy data from the current position of the source stream to the current position of
+the destination stream. On Linux and Android data is copied between file and pipe streams
+in the kernel without passing through user space, using copy_file_range, sendfile or
+splice. Other streams are copied through a large intermediate buffer.
+\param dest Destination stream
+\param source Source stream
+\param bytes Number of bytes to copy, 0 to copy until end of source stream
+\return Number of bytes copied */
+FOUNDATION_API size_t
+stream_copy(stream_t* dest, stream_t* source, size_t bytes);
+
 /*! Write boolean to stream.
 \param stream Stream
 \param data Boolean to write */
@@ -320,6 +477,32 @@ stream_write_int64(stream_t* stream, int64_t data);
 FOUNDATION_API void
 stream_write_uint64(stream_t* stream, uint64_t data);
 
+/*! Write varint coded unsigned integer to stream, using one byte for values less than 128
+and at most #VARINT_MAX_SIZE bytes. In text mode the value is written as a decimal number
+like #stream_write_uint64.
+\param stream Stream
+\param data Unsigned integer to write */
+FOUNDATION_API void
+stream_write_varint(stream_t* stream, uint64_t data);
+
+/*! Write zigzag and varint coded integer to stream, using one byte for values in the
+range [-64,63]. In text mode the value is written as a decimal number like
+#stream_write_int64.
+\param stream Stream
+\param data Integer to write */
+FOUNDATION_API void
+stream_write_varint_signed(stream_t* stream, int64_t data);
+
+/*! Write an array of 32-bit values to stream, as a varint count followed by the values
+coded in the Stream VByte format, see #vbyte_encode. In text mode the count and values
+are written as space separated decimal numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values
+\param delta Delta code values, for sorted arrays */
+FOUNDATION_API void
+stream_write_vbyte(stream_t* stream, const uint32_t* values, size_t count, bool delta);
+
 /*! Write 32-bit float to stream.
 \param stream Stream
 \param data Float to write */
@@ -332,6 +515,51 @@ stream_write_float32(stream_t* stream, float32_t data);
 FOUNDATION_API void
 stream_write_float64(stream_t* stream, float64_t data);
 
+/*! Write an array of 16-bit unsigned integer values to stream. In binary mode all values are written with
+a single write operation, byte order swapped in bulk through a bounce buffer if needed, in text
+mode values are written as space separated numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values */
+FOUNDATION_API void
+stream_write_uint16_array(stream_t* stream, const uint16_t* values, size_t count);
+
+/*! Write an array of 32-bit unsigned integer values to stream. In binary mode all values are written with
+a single write operation, byte order swapped in bulk through a bounce buffer if needed, in text
+mode values are written as space separated numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values */
+FOUNDATION_API void
+stream_write_uint32_array(stream_t* stream, const uint32_t* values, size_t count);
+
+/*! Write an array of 64-bit unsigned integer values to stream. In binary mode all values are written with
+a single write operation, byte order swapped in bulk through a bounce buffer if needed, in text
+mode values are written as space separated numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values */
+FOUNDATION_API void
+stream_write_uint64_array(stream_t* stream, const uint64_t* values, size_t count);
+
+/*! Write an array of 32-bit float values to stream. In binary mode all values are written with
+a single write operation, byte order swapped in bulk through a bounce buffer if needed, in text
+mode values are written as space separated numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values */
+FOUNDATION_API void
+stream_write_float32_array(stream_t* stream, const float32_t* values, size_t count);
+
+/*! Write an array of 64-bit float values to stream. In binary mode all values are written with
+a single write operation, byte order swapped in bulk through a bounce buffer if needed, in text
+mode values are written as space separated numbers.
+\param stream Stream
+\param values Values to write
+\param count Number of values */
+FOUNDATION_API void
+stream_write_float64_array(stream_t* stream, const float64_t* values, size_t count);
+
 /*! Write string to stream.
 \param stream Stream
 \param data String to write
@@ -371,6 +599,22 @@ stream_available_read(stream_t* stream);
 FOUNDATION_API uint128_t
 stream_md5(stream_t* stream);
 
+/*! Read stream SHA-256 digest. Like #stream_md5 line endings of text streams are normalized
+to LF before digesting, binary streams are digested as is.
+\param stream Stream
+\return SHA-256 digest, 0 if not available for stream type or invalid stream */
+FOUNDATION_API uint256_t
+stream_sha256(stream_t* stream);
+
+/*! Calculate checksum of the stream content from start to end of stream. The stream position
+is restored after the checksum has been calculated. Unlike #stream_md5 the raw content is
+digested, line endings of text streams are not normalized.
+\param stream Stream
+\param type Checksum algorithm
+\return Checksum value, 0 if not available for stream type or invalid stream */
+FOUNDATION_API uint64_t
+stream_checksum(stream_t* stream, checksum_type_t type);
+
 /*! Truncate stream to given size if it is larger, do nothing if smaller or equal in size.
 \param stream Stream
 \param length New length of stream */
@@ -382,6 +626,15 @@ stream_truncate(stream_t* stream, size_t length);
 FOUNDATION_API void
 stream_flush(stream_t* stream);
 
+/*! Hint the expected access pattern of a range of the stream, allowing the underlying storage
+to read ahead or drop cached data. Ignored by stream types without access pattern hints.
+\param stream Stream
+\param advice Access pattern
+\param offset Offset of range in bytes
+\param size Size of range in bytes, 0 for range extending to end of stream */
+FOUNDATION_API void
+stream_advise(stream_t* stream, stream_advice_t advice, size_t offset, size_t size);
+
 /*! Allocate a stream for stdout
 \return Stream wrapping stdout */
 FOUNDATION_API stream_t*
@@ -397,6 +650,25 @@ stream_open_stderr(void);
 FOUNDATION_API stream_t*
 stream_open_stdin(void);
 
+/*! Allocate a buffered stream wrapping the given stream. Deallocate the stream with a call
+to #stream_deallocate, which flushes pending writes.
+\param stream Stream to wrap
+\param buffer_size Size of read-ahead and write-behind buffers, 0 for default (64KiB)
+\param adopt Take ownership of the wrapped stream, deallocating it with the buffered stream
+\return New buffered stream */
+FOUNDATION_API stream_t*
+stream_buffered_allocate(stream_t* stream, size_t buffer_size, bool adopt);
+
+/*! Initialize a buffered stream wrapping the given stream. Finalize the stream with a call
+to #stream_finalize, which flushes pending writes.
+\param buffered Buffered stream
+\param stream Stream to wrap
+\param buffer_size Size of read-ahead and write-behind buffers, 0 for default (64KiB)
+\param adopt Take ownership of the wrapped stream, deallocating it with the buffered stream */
+FOUNDATION_API void
+stream_buffered_initialize(stream_buffered_t* buffered, stream_t* stream, size_t buffer_size,
+                           bool adopt);
+
 /*! Set function to handle opening streams for the given protocol
 \param protocol Protocol
 \param length Length of protocol
@@ -410,3 +682,136 @@ stream_set_protocol_handler(const char* protocol, size_t length, stream_open_fn
 \return Handler function, 0 if none registered */
 FOUNDATION_API stream_open_fn
 stream_protocol_handler(const char* protocol, size_t length);
+
+/*! Get pointer to the next bytes of a binary input stream reading directly from memory (memory
+buffer and memory mapped streams) and advance the stream position. Private to the stream
+module, used by the inline fast path of the typed read functions.
+\param stream Stream
+\param size Number of bytes to read
+\return Pointer to bytes, null if stream is not read from memory or not enough bytes remain */
+static FOUNDATION_FORCEINLINE const void*
+_stream_read_memory(stream_t* stream, size_t size) {
+	stream_buffer_t* memory = (stream_buffer_t*)stream;
+	if (((stream->type == STREAMTYPE_MEMORY) || (stream->type == STREAMTYPE_MAPPED)) &&
+	    ((stream->mode & (STREAM_IN | STREAM_BINARY)) == (STREAM_IN | STREAM_BINARY)) &&
+	    ((memory->size - memory->current) >= size)) {
+		const void* data = pointer_offset_const(memory->buffer, memory->current);
+		memory->current += size;
+		return data;
+	}
+	return 0;
+}
+
+static FOUNDATION_FORCEINLINE bool
+_stream_read_bool_inline(stream_t* stream) {
+	const char* data = _stream_read_memory(stream, 1);
+	return data ? (*data != 0) : (stream_read_bool)(stream);
+}
+
+static FOUNDATION_FORCEINLINE int8_t
+_stream_read_int8_inline(stream_t* stream) {
+	const int8_t* data = _stream_read_memory(stream, 1);
+	return data ? *data : (stream_read_int8)(stream);
+}
+
+static FOUNDATION_FORCEINLINE uint8_t
+_stream_read_uint8_inline(stream_t* stream) {
+	const uint8_t* data = _stream_read_memory(stream, 1);
+	return data ? *data : (stream_read_uint8)(stream);
+}
+
+static FOUNDATION_FORCEINLINE uint16_t
+_stream_read_uint16_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 2);
+	uint16_t value;
+	if (!data)
+		return (stream_read_uint16)(stream);
+	memcpy(&value, data, 2);
+	return stream->swap ? byteorder_swap16(value) : value;
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+_stream_read_uint32_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 4);
+	uint32_t value;
+	if (!data)
+		return (stream_read_uint32)(stream);
+	memcpy(&value, data, 4);
+	return stream->swap ? byteorder_swap32(value) : value;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+_stream_read_uint64_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 8);
+	uint64_t value;
+	if (!data)
+		return (stream_read_uint64)(stream);
+	memcpy(&value, data, 8);
+	return stream->swap ? byteorder_swap64(value) : value;
+}
+
+static FOUNDATION_FORCEINLINE int16_t
+_stream_read_int16_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 2);
+	uint16_t value;
+	if (!data)
+		return (stream_read_int16)(stream);
+	memcpy(&value, data, 2);
+	return (int16_t)(stream->swap ? byteorder_swap16(value) : value);
+}
+
+static FOUNDATION_FORCEINLINE int32_t
+_stream_read_int32_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 4);
+	uint32_t value;
+	if (!data)
+		return (stream_read_int32)(stream);
+	memcpy(&value, data, 4);
+	return (int32_t)(stream->swap ? byteorder_swap32(value) : value);
+}
+
+static FOUNDATION_FORCEINLINE int64_t
+_stream_read_int64_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 8);
+	uint64_t value;
+	if (!data)
+		return (stream_read_int64)(stream);
+	memcpy(&value, data, 8);
+	return (int64_t)(stream->swap ? byteorder_swap64(value) : value);
+}
+
+static FOUNDATION_FORCEINLINE float32_t
+_stream_read_float32_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 4);
+	float32_cast_t cast;
+	if (!data)
+		return (stream_read_float32)(stream);
+	memcpy(&cast.uival, data, 4);
+	if (stream->swap)
+		cast.uival = byteorder_swap32(cast.uival);
+	return cast.fval;
+}
+
+static FOUNDATION_FORCEINLINE float64_t
+_stream_read_float64_inline(stream_t* stream) {
+	const void* data = _stream_read_memory(stream, 8);
+	float64_cast_t cast;
+	if (!data)
+		return (stream_read_float64)(stream);
+	memcpy(&cast.uival, data, 8);
+	if (stream->swap)
+		cast.uival = byteorder_swap64(cast.uival);
+	return cast.fval;
+}
+
+#define stream_read_bool(stream) _stream_read_bool_inline(stream)
+#define stream_read_int8(stream) _stream_read_int8_inline(stream)
+#define stream_read_uint8(stream) _stream_read_uint8_inline(stream)
+#define stream_read_int16(stream) _stream_read_int16_inline(stream)
+#define stream_read_uint16(stream) _stream_read_uint16_inline(stream)
+#define stream_read_int32(stream) _stream_read_int32_inline(stream)
+#define stream_read_uint32(stream) _stream_read_uint32_inline(stream)
+#define stream_read_int64(stream) _stream_read_int64_inline(stream)
+#define stream_read_uint64(stream) _stream_read_uint64_inline(stream)
+#define stream_read_float32(stream) _stream_read_float32_inline(stream)
+#define stream_read_float64(stream) _stream_read_float64_inline(stream)
@@ -25,6 +25,28 @@
 
 #include <time.h>
 
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_ARCH_SSE2 && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define STRING_SEARCH_SSE2 1
+#  include <emmintrin.h>
+#  include <immintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define STRING_TARGET_AVX2
+#    define STRING_TARGET_SSSE3
+#  else
+#    define STRING_TARGET_AVX2 __attribute__((target("avx2")))
+#    define STRING_TARGET_SSSE3 __attribute__((target("ssse3")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define STRING_SEARCH_NEON 1
+#  include <arm_neon.h>
+#endif
+
+//Keys up to this length are searched by filtering on first and last character, longer keys
+//use the linear time Two-Way algorithm
+#define STRING_SEARCH_FILTER_MAX 64
+
 string_t
 string_allocate(size_t length, size_t capacity) {
 	char* str;
@@ -181,6 +203,11 @@ string_hash(const char* str, size_t length) {
 	return length ? hash(str, length) : HASH_EMPTY_STRING;
 }
 
+hash_t
+string_hash_nocase(const char* str, size_t length) {
+	return length ? hash_nocase(str, length) : HASH_EMPTY_STRING;
+}
+
 string_t
 string_resize(char* str, size_t length, size_t capacity, size_t new_length, char c) {
 	FOUNDATION_ASSERT(length <= capacity);
@@ -633,16 +660,12 @@ string_find(const char* str, size_t length, char c, size_t offset) {
 	return STRING_NPOS;
 }
 
-size_t
-string_find_string(const char* str, size_t length, const char* key, size_t key_length,
-                   size_t offset) {
+static size_t
+_string_find_scalar(const char* str, size_t length, const char* key, size_t key_length,
+                    size_t offset) {
 	const char* found;
 	char keychar;
 	size_t last_offset;
-	if (!key_length)
-		return offset;
-	if ((key_length > length) || (offset > (length - key_length)))
-		return STRING_NPOS;
 
 	last_offset = length - key_length;
 
@@ -663,6 +686,373 @@ string_find_string(const char* str, size_t length, const char* key, size_t key_l
 	return STRING_NPOS;
 }
 
+static size_t
+_string_rfind_scalar(const char* str, const char* key, size_t key_length, size_t offset) {
+	//Wrap-around terminates
+	while (offset != STRING_NPOS) {
+		if ((str[offset] == *key) && (memcmp(str + offset, key, key_length) == 0))
+			return offset;
+		--offset;
+	}
+	return STRING_NPOS;
+}
+
+static FOUNDATION_FORCEINLINE unsigned char
+_string_search_char(const char* str, size_t length, size_t index, bool reverse) {
+	return (unsigned char)str[reverse ? (length - 1 - index) : index];
+}
+
+static FOUNDATION_FORCEINLINE ptrdiff_t
+_string_maximal_suffix(const char* key, ptrdiff_t key_length, bool reverse, bool invert,
+                       ptrdiff_t* period) {
+	ptrdiff_t suffix = -1;
+	ptrdiff_t j = 0, k = 1, p = 1;
+	while (j + k < key_length) {
+		unsigned char a = _string_search_char(key, (size_t)key_length, (size_t)(j + k), reverse);
+		unsigned char b = _string_search_char(key, (size_t)key_length, (size_t)(suffix + k), reverse);
+		if (invert ? (a > b) : (a < b)) {
+			j += k;
+			k = 1;
+			p = j - suffix;
+		}
+		else if (a == b) {
+			if (k != p) {
+				++k;
+			}
+			else {
+				j += p;
+				k = 1;
+			}
+		}
+		else {
+			suffix = j;
+			j = suffix + 1;
+			k = p = 1;
+		}
+	}
+	*period = p;
+	return suffix;
+}
+
+/* Two-Way string matching (Crochemore & Perrin), linear time and constant space. The key is
+split at a critical factorization found from the maximal suffixes, the right part is matched
+left to right and the left part right to left. In reverse mode both the string and the key
+are accessed back to front, finding the last occurrence. */
+static FOUNDATION_FORCEINLINE size_t
+_string_search_twoway(const char* str, size_t length, const char* key, size_t key_length,
+                      bool reverse) {
+	ptrdiff_t n = (ptrdiff_t)length, m = (ptrdiff_t)key_length;
+	ptrdiff_t i, j, ell, memory, per, period, period_invert, suffix_invert;
+	bool periodic = true;
+
+	ell = _string_maximal_suffix(key, m, reverse, false, &period);
+	suffix_invert = _string_maximal_suffix(key, m, reverse, true, &period_invert);
+	if (suffix_invert > ell) {
+		ell = suffix_invert;
+		period = period_invert;
+	}
+	per = period;
+	for (i = 0; (i <= ell) && periodic; ++i)
+		periodic = (_string_search_char(key, key_length, (size_t)i, reverse) ==
+		            _string_search_char(key, key_length, (size_t)(i + per), reverse));
+
+#define STRING_KEY(index) _string_search_char(key, key_length, (size_t)(index), reverse)
+#define STRING_STR(index) _string_search_char(str, length, (size_t)(index), reverse)
+	if (periodic) {
+		j = 0;
+		memory = -1;
+		while (j <= n - m) {
+			i = ((ell > memory) ? ell : memory) + 1;
+			while ((i < m) && (STRING_KEY(i) == STRING_STR(i + j)))
+				++i;
+			if (i >= m) {
+				i = ell;
+				while ((i > memory) && (STRING_KEY(i) == STRING_STR(i + j)))
+					--i;
+				if (i <= memory)
+					return (size_t)j;
+				j += per;
+				memory = m - per - 1;
+			}
+			else {
+				j += i - ell;
+				memory = -1;
+			}
+		}
+	}
+	else {
+		per = (((ell + 1) > (m - ell - 1)) ? (ell + 1) : (m - ell - 1)) + 1;
+		j = 0;
+		while (j <= n - m) {
+			i = ell + 1;
+			while ((i < m) && (STRING_KEY(i) == STRING_STR(i + j)))
+				++i;
+			if (i >= m) {
+				i = ell;
+				while ((i >= 0) && (STRING_KEY(i) == STRING_STR(i + j)))
+					--i;
+				if (i < 0)
+					return (size_t)j;
+				j += per;
+			}
+			else {
+				j += i - ell;
+			}
+		}
+	}
+#undef STRING_KEY
+#undef STRING_STR
+
+	return STRING_NPOS;
+}
+
+static size_t
+_string_find_twoway(const char* str, size_t length, const char* key, size_t key_length,
+                    size_t offset) {
+	size_t found = _string_search_twoway(str + offset, length - offset, key, key_length, false);
+	return (found != STRING_NPOS) ? (found + offset) : STRING_NPOS;
+}
+
+static size_t
+_string_rfind_twoway(const char* str, const char* key, size_t key_length, size_t offset) {
+	size_t length = offset + key_length;
+	size_t found = _string_search_twoway(str, length, key, key_length, true);
+	return (found != STRING_NPOS) ? (length - key_length - found) : STRING_NPOS;
+}
+
+static FOUNDATION_FORCEINLINE unsigned int
+_string_search_first_bit(uint64_t mask) {
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)mask))
+		return (unsigned int)index;
+	_BitScanForward(&index, (unsigned long)(mask >> 32ULL));
+	return (unsigned int)index + 32;
+#else
+	return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE unsigned int
+_string_search_last_bit(uint64_t mask) {
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(mask >> 32ULL)))
+		return (unsigned int)index + 32;
+	_BitScanReverse(&index, (unsigned long)mask);
+	return (unsigned int)index;
+#else
+	return 63U - (unsigned int)__builtin_clzll(mask);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE bool
+_string_search_verify(const char* str, const char* key, size_t key_length) {
+	//First and last character already matched by the filter
+	return (key_length <= 2) || (memcmp(str + 1, key + 1, key_length - 2) == 0);
+}
+
+#if STRING_SEARCH_SSE2
+
+static int _string_search_avx2 = -1;
+
+static bool
+_string_search_avx2_supported(void) {
+	if (_string_search_avx2 < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		bool supported = false;
+		__cpuid(info, 1);
+		//Require OS support for saving YMM state
+		if ((info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6)) {
+			__cpuidex(info, 7, 0);
+			supported = (info[1] & (1 << 5)) != 0;
+		}
+		_string_search_avx2 = supported ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		_string_search_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+	}
+	return _string_search_avx2 > 0;
+}
+
+static uint32_t
+_string_search_mask_sse2(const char* str, size_t key_length, __m128i first, __m128i last) {
+	__m128i block_first = _mm_loadu_si128((const __m128i*)(const void*)str);
+	__m128i block_last = _mm_loadu_si128((const __m128i*)(const void*)(str + key_length - 1));
+	return (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first),
+	                                                 _mm_cmpeq_epi8(block_last, last)));
+}
+
+static size_t
+_string_find_sse2(const char* str, size_t length, const char* key, size_t key_length,
+                  size_t offset) {
+	const __m128i first = _mm_set1_epi8(key[0]);
+	const __m128i last = _mm_set1_epi8(key[key_length - 1]);
+	size_t last_offset = length - key_length;
+	while (offset + 16 <= last_offset + 1) {
+		uint32_t mask = _string_search_mask_sse2(str + offset, key_length, first, last);
+		while (mask) {
+			size_t pos = offset + _string_search_first_bit(mask);
+			if (_string_search_verify(str + pos, key, key_length))
+				return pos;
+			mask &= mask - 1;
+		}
+		offset += 16;
+	}
+	if (offset > last_offset)
+		return STRING_NPOS;
+	return _string_find_scalar(str, length, key, key_length, offset);
+}
+
+static size_t
+_string_rfind_sse2(const char* str, const char* key, size_t key_length, size_t offset) {
+	const __m128i first = _mm_set1_epi8(key[0]);
+	const __m128i last = _mm_set1_epi8(key[key_length - 1]);
+	while (offset >= 15) {
+		size_t base = offset - 15;
+		uint32_t mask = _string_search_mask_sse2(str + base, key_length, first, last);
+		while (mask) {
+			unsigned int bit = _string_search_last_bit(mask);
+			if (_string_search_verify(str + base + bit, key, key_length))
+				return base + bit;
+			mask &= ~(1U << bit);
+		}
+		if (!base)
+			return STRING_NPOS;
+		offset = base - 1;
+	}
+	return _string_rfind_scalar(str, key, key_length, offset);
+}
+
+static STRING_TARGET_AVX2 uint32_t
+_string_search_mask_avx2(const char* str, size_t key_length, __m256i first, __m256i last) {
+	__m256i block_first = _mm256_loadu_si256((const __m256i*)(const void*)str);
+	__m256i block_last = _mm256_loadu_si256((const __m256i*)(const void*)(str + key_length - 1));
+	return (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+	                                                       _mm256_cmpeq_epi8(block_last, last)));
+}
+
+static STRING_TARGET_AVX2 size_t
+_string_find_avx2(const char* str, size_t length, const char* key, size_t key_length,
+                  size_t offset) {
+	const __m256i first = _mm256_set1_epi8(key[0]);
+	const __m256i last = _mm256_set1_epi8(key[key_length - 1]);
+	size_t last_offset = length - key_length;
+	while (offset + 32 <= last_offset + 1) {
+		uint32_t mask = _string_search_mask_avx2(str + offset, key_length, first, last);
+		while (mask) {
+			size_t pos = offset + _string_search_first_bit(mask);
+			if (_string_search_verify(str + pos, key, key_length))
+				return pos;
+			mask &= mask - 1;
+		}
+		offset += 32;
+	}
+	if (offset > last_offset)
+		return STRING_NPOS;
+	return _string_find_sse2(str, length, key, key_length, offset);
+}
+
+static STRING_TARGET_AVX2 size_t
+_string_rfind_avx2(const char* str, const char* key, size_t key_length, size_t offset) {
+	const __m256i first = _mm256_set1_epi8(key[0]);
+	const __m256i last = _mm256_set1_epi8(key[key_length - 1]);
+	while (offset >= 31) {
+		size_t base = offset - 31;
+		uint32_t mask = _string_search_mask_avx2(str + base, key_length, first, last);
+		while (mask) {
+			unsigned int bit = _string_search_last_bit(mask);
+			if (_string_search_verify(str + base + bit, key, key_length))
+				return base + bit;
+			mask &= ~(1U << bit);
+		}
+		if (!base)
+			return STRING_NPOS;
+		offset = base - 1;
+	}
+	return _string_rfind_sse2(str, key, key_length, offset);
+}
+
+#elif STRING_SEARCH_NEON
+
+static uint64_t
+_string_search_mask_neon(const char* str, size_t key_length, uint8x16_t first, uint8x16_t last) {
+	uint8x16_t block_first = vld1q_u8((const uint8_t*)str);
+	uint8x16_t block_last = vld1q_u8((const uint8_t*)(str + key_length - 1));
+	uint8x16_t match = vandq_u8(vceqq_u8(block_first, first), vceqq_u8(block_last, last));
+	//Narrow to four bits per character, keep one bit per character
+	uint8x8_t narrow = vshrn_n_u16(vreinterpretq_u16_u8(match), 4);
+	return vget_lane_u64(vreinterpret_u64_u8(narrow), 0) & 0x8888888888888888ULL;
+}
+
+static size_t
+_string_find_neon(const char* str, size_t length, const char* key, size_t key_length,
+                  size_t offset) {
+	const uint8x16_t first = vdupq_n_u8((uint8_t)key[0]);
+	const uint8x16_t last = vdupq_n_u8((uint8_t)key[key_length - 1]);
+	size_t last_offset = length - key_length;
+	while (offset + 16 <= last_offset + 1) {
+		uint64_t mask = _string_search_mask_neon(str + offset, key_length, first, last);
+		while (mask) {
+			size_t pos = offset + (_string_search_first_bit(mask) / 4);
+			if (_string_search_verify(str + pos, key, key_length))
+				return pos;
+			mask &= mask - 1;
+		}
+		offset += 16;
+	}
+	if (offset > last_offset)
+		return STRING_NPOS;
+	return _string_find_scalar(str, length, key, key_length, offset);
+}
+
+static size_t
+_string_rfind_neon(const char* str, const char* key, size_t key_length, size_t offset) {
+	const uint8x16_t first = vdupq_n_u8((uint8_t)key[0]);
+	const uint8x16_t last = vdupq_n_u8((uint8_t)key[key_length - 1]);
+	while (offset >= 15) {
+		size_t base = offset - 15;
+		uint64_t mask = _string_search_mask_neon(str + base, key_length, first, last);
+		while (mask) {
+			unsigned int bit = _string_search_last_bit(mask);
+			if (_string_search_verify(str + base + (bit / 4), key, key_length))
+				return base + (bit / 4);
+			mask &= ~(1ULL << bit);
+		}
+		if (!base)
+			return STRING_NPOS;
+		offset = base - 1;
+	}
+	return _string_rfind_scalar(str, key, key_length, offset);
+}
+
+#endif
+
+size_t
+string_find_string(const char* str, size_t length, const char* key, size_t key_length,
+                   size_t offset) {
+	if (!key_length)
+		return offset;
+	if ((key_length > length) || (offset > (length - key_length)))
+		return STRING_NPOS;
+
+	if (key_length == 1)
+		return string_find(str, length, *key, offset);
+	if (key_length > STRING_SEARCH_FILTER_MAX)
+		return _string_find_twoway(str, length, key, key_length, offset);
+#if STRING_SEARCH_SSE2
+	if (_string_search_avx2_supported())
+		return _string_find_avx2(str, length, key, key_length, offset);
+	return _string_find_sse2(str, length, key, key_length, offset);
+#elif STRING_SEARCH_NEON
+	return _string_find_neon(str, length, key, key_length, offset);
+#else
+	return _string_find_scalar(str, length, key, key_length, offset);
+#endif
+}
+
 size_t
 string_rfind(const char* str, size_t length, char c, size_t offset) {
 	if (offset >= length)
@@ -689,13 +1079,17 @@ string_rfind_string(const char* str, size_t length, const char* key, size_t key_
 	if (offset >= length - key_length)
 		offset = length - key_length;
 
-	//Wrap-around terminates
-	while (offset != STRING_NPOS) {
-		if (memcmp(str + offset, key, key_length) == 0)
-			return offset;
-		--offset;
-	}
-	return STRING_NPOS;
+	if (key_length > STRING_SEARCH_FILTER_MAX)
+		return _string_rfind_twoway(str, key, key_length, offset);
+#if STRING_SEARCH_SSE2
+	if (_string_search_avx2_supported())
+		return _string_rfind_avx2(str, key, key_length, offset);
+	return _string_rfind_sse2(str, key, key_length, offset);
+#elif STRING_SEARCH_NEON
+	return _string_rfind_neon(str, key, key_length, offset);
+#else
+	return _string_rfind_scalar(str, key, key_length, offset);
+#endif
 }
 
 size_t
@@ -781,15 +1175,72 @@ string_equal(const char* rhs, size_t rhs_length, const char* lhs, size_t lhs_len
 	return (!rhs_length && !lhs_length);
 }
 
+static FOUNDATION_FORCEINLINE uint64_t
+_string_fold_block(uint64_t block) {
+	uint64_t heptets = block & 0x7F7F7F7F7F7F7F7FULL;
+	uint64_t is_ge_a = heptets + 0x3F3F3F3F3F3F3F3FULL;
+	uint64_t is_gt_z = heptets + 0x2525252525252525ULL;
+	uint64_t is_upper = (is_ge_a ^ is_gt_z) & ~block & 0x8080808080808080ULL;
+	return block | (is_upper >> 2);
+}
+
+static FOUNDATION_FORCEINLINE char
+_string_fold_char(char c) {
+	return ((c >= 'A') && (c <= 'Z')) ? (char)(c | 0x20) : c;
+}
+
 bool
 string_equal_nocase(const char* rhs, size_t rhs_length, const char* lhs, size_t lhs_length) {
-#if FOUNDATION_PLATFORM_WINDOWS
-#  define strncasecmp _strnicmp
+	size_t offset = 0;
+	if (rhs_length != lhs_length)
+		return false;
+	//Compare with ascii case folding, 16 or 8 characters at a time
+#if STRING_SEARCH_SSE2
+	{
+		const __m128i upper_min = _mm_set1_epi8('A' - 1);
+		const __m128i upper_max = _mm_set1_epi8('Z' + 1);
+		const __m128i lower_bit = _mm_set1_epi8(0x20);
+		while (offset + 16 <= rhs_length) {
+			__m128i r = _mm_loadu_si128((const __m128i*)(const void*)(rhs + offset));
+			__m128i l = _mm_loadu_si128((const __m128i*)(const void*)(lhs + offset));
+			__m128i r_upper = _mm_and_si128(_mm_cmpgt_epi8(r, upper_min), _mm_cmplt_epi8(r, upper_max));
+			__m128i l_upper = _mm_and_si128(_mm_cmpgt_epi8(l, upper_min), _mm_cmplt_epi8(l, upper_max));
+			r = _mm_or_si128(r, _mm_and_si128(r_upper, lower_bit));
+			l = _mm_or_si128(l, _mm_and_si128(l_upper, lower_bit));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(r, l)) != 0xFFFF)
+				return false;
+			offset += 16;
+		}
+	}
+#elif STRING_SEARCH_NEON
+	{
+		const uint8x16_t upper_min = vdupq_n_u8('A');
+		const uint8x16_t upper_range = vdupq_n_u8(26);
+		const uint8x16_t lower_bit = vdupq_n_u8(0x20);
+		while (offset + 16 <= rhs_length) {
+			uint8x16_t r = vld1q_u8((const uint8_t*)rhs + offset);
+			uint8x16_t l = vld1q_u8((const uint8_t*)lhs + offset);
+			r = vorrq_u8(r, vandq_u8(vcltq_u8(vsubq_u8(r, upper_min), upper_range), lower_bit));
+			l = vorrq_u8(l, vandq_u8(vcltq_u8(vsubq_u8(l, upper_min), upper_range), lower_bit));
+			if (vminvq_u8(vceqq_u8(r, l)) != 0xFF)
+				return false;
+			offset += 16;
+		}
+	}
 #endif
-	if (rhs_length && lhs_length) {
-		return (rhs_length == lhs_length) && (strncasecmp(rhs, lhs, rhs_length) == 0);
+	while (offset + 8 <= rhs_length) {
+		uint64_t r, l;
+		memcpy(&r, rhs + offset, sizeof(r));
+		memcpy(&l, lhs + offset, sizeof(l));
+		if (_string_fold_block(r) != _string_fold_block(l))
+			return false;
+		offset += 8;
 	}
-	return (!rhs_length && !lhs_length);
+	for (; offset < rhs_length; ++offset) {
+		if (_string_fold_char(rhs[offset]) != _string_fold_char(lhs[offset]))
+			return false;
+	}
+	return true;
 }
 
 bool
@@ -811,57 +1262,116 @@ string_equal_substr_nocase(const char* rhs, size_t rhs_length, size_t rhs_offset
 bool
 string_match_pattern(const char* element, size_t element_length, const char* pattern,
                      size_t pattern_length) {
-	if (!pattern_length || ((*pattern == '*') && (pattern_length == 1)))
-		return true;
-
-	if (*pattern == '*') {
-		if (string_match_pattern(element, element_length, pattern + 1, pattern_length - 1))
-			return true;
-		if (element_length)
-			return string_match_pattern(element + 1, element_length - 1, pattern, pattern_length);
+	size_t ielement = 0, ipattern = 0;
+	size_t star = STRING_NPOS, star_element = 0;
+
+	//Backtrack only to the last wildcard, and locate the literal run following a wildcard
+	//with a substring search instead of trying each position
+	while (ipattern < pattern_length) {
+		char pattern_char = pattern[ipattern];
+		if (pattern_char == '*') {
+			size_t run = 0;
+			star = ipattern++;
+			while (((ipattern + run) < pattern_length) && (pattern[ipattern + run] != '*') &&
+			        (pattern[ipattern + run] != '?'))
+				++run;
+			if (run) {
+				size_t found = string_find_string(element, element_length, pattern + ipattern, run,
+				                                  ielement);
+				if (found == STRING_NPOS)
+					return false;
+				ielement = found;
+			}
+			star_element = ielement;
+		}
+		else if ((ielement < element_length) &&
+		         ((pattern_char == '?') || (pattern_char == element[ielement]))) {
+			++ipattern;
+			++ielement;
+		}
+		else if ((star != STRING_NPOS) && (star_element < element_length)) {
+			ipattern = star;
+			ielement = star_element + 1;
+		}
+		else {
+			return false;
+		}
 	}
 
-	if (!element_length)
-		return false;
-
-	if (*pattern == '?')
-		return string_match_pattern(element + 1, element_length - 1, pattern + 1, pattern_length - 1);
-	else if (*element == *pattern)
-		return string_match_pattern(element + 1, element_length - 1, pattern + 1, pattern_length - 1);
-
-	return false;
+	return true;
 }
 
 size_t
 string_explode(const char* str, size_t length, const char* delimiters, size_t delim_length,
                string_const_t* arr, size_t arrsize, bool allow_empty) {
-	size_t token;
-	size_t end;
+	string_tokenizer_t tokenizer;
 	size_t count = 0;
 
-	if (!length || !arrsize)
-		return 0;
+	string_tokenizer_initialize(&tokenizer, str, length, delimiters, delim_length, allow_empty);
+	while ((count < arrsize) && string_tokenizer_next(&tokenizer, arr + count))
+		++count;
+
+	return count;
+}
 
-	if (!delim_length) {
-		arr[count++] = string_const(str, length);
-		return count;
+void
+string_tokenizer_initialize(string_tokenizer_t* tokenizer, const char* str, size_t length,
+                            const char* delimiters, size_t delim_length, bool allow_empty) {
+	size_t idelim;
+	tokenizer->str = str;
+	tokenizer->length = length;
+	tokenizer->offset = length ? 0 : 1;
+	tokenizer->allow_empty = allow_empty;
+	tokenizer->delimiter = delim_length ? delimiters[0] : 0;
+	tokenizer->delimiters = (unsigned char)math_min(delim_length, 2);
+	memset(tokenizer->mask, 0, sizeof(tokenizer->mask));
+	for (idelim = 0; idelim < delim_length; ++idelim) {
+		unsigned char c = (unsigned char)delimiters[idelim];
+		tokenizer->mask[c >> 6] |= 1ULL << (c & 63);
 	}
+}
 
-	token = 0;
-	end   = 0;
+static FOUNDATION_FORCEINLINE bool
+_string_tokenizer_is_delimiter(const string_tokenizer_t* tokenizer, char c) {
+	unsigned char uc = (unsigned char)c;
+	return ((tokenizer->mask[uc >> 6] >> (uc & 63)) & 1) != 0;
+}
 
-	while ((end < length) && (count < arrsize)) {
-		if (!allow_empty)
-			token = string_find_first_not_of(str, length, delimiters, delim_length, end);
-		end = string_find_first_of(str, length, delimiters, delim_length, token);
+bool
+string_tokenizer_next(string_tokenizer_t* tokenizer, string_const_t* token) {
+	const char* str = tokenizer->str;
+	size_t length = tokenizer->length;
+	size_t offset = tokenizer->offset;
+	size_t end;
 
-		if (token != STRING_NPOS)
-			arr[count++] = string_const(str + token, (end != STRING_NPOS) ? (end - token) : (length - token));
-		if (allow_empty)
-			token = end + 1;
+	if (!tokenizer->allow_empty) {
+		while ((offset < length) && _string_tokenizer_is_delimiter(tokenizer, str[offset]))
+			++offset;
+		if (offset >= length) {
+			tokenizer->offset = length + 1;
+			return false;
+		}
+	}
+	else if (offset > length) {
+		return false;
 	}
 
-	return count;
+	if (tokenizer->delimiters == 1) {
+		const char* found = memchr(str + offset, tokenizer->delimiter, length - offset);
+		end = found ? (size_t)(found - str) : length;
+	}
+	else if (tokenizer->delimiters) {
+		end = offset;
+		while ((end < length) && !_string_tokenizer_is_delimiter(tokenizer, str[end]))
+			++end;
+	}
+	else {
+		end = length;
+	}
+
+	*token = string_const(str + offset, end - offset);
+	tokenizer->offset = end + 1;
+	return true;
 }
 
 string_t
@@ -1011,6 +1521,94 @@ string_array_find(const string_const_t* array, size_t haystack_size, const char*
 	return -1;
 }
 
+string_set_t*
+string_set_allocate(const string_const_t* strings, size_t count) {
+	string_set_t* set = memory_allocate(HASH_STRING, sizeof(string_set_t), 0, MEMORY_PERSISTENT);
+	string_set_initialize(set, strings, count);
+	return set;
+}
+
+void
+string_set_deallocate(string_set_t* set) {
+	if (set)
+		string_set_finalize(set);
+	memory_deallocate(set);
+}
+
+void
+string_set_initialize(string_set_t* set, const string_const_t* strings, size_t count) {
+	size_t slots = 8;
+	size_t storage_size = 0;
+	size_t istr, slot;
+	char* storage;
+
+	FOUNDATION_ASSERT_MSG(count < 0x7FFFFFFFU, "Too many strings in string set");
+
+	//Keep the index at most half full for short probe sequences
+	while (slots < count * 2)
+		slots <<= 1;
+	for (istr = 0; istr < count; ++istr)
+		storage_size += strings[istr].length + 1;
+
+	//String array, hashes, index and string storage in a single block
+	set->count = count;
+	set->mask = slots - 1;
+	set->string = memory_allocate(HASH_STRING, (sizeof(string_const_t) + sizeof(hash_t)) * count +
+	                              (sizeof(uint32_t) * slots) + storage_size, 0, MEMORY_PERSISTENT);
+	set->hash = (hash_t*)(void*)(set->string + count);
+	set->index = (uint32_t*)(void*)(set->hash + count);
+	storage = (char*)(set->index + slots);
+	memset(set->index, 0, sizeof(uint32_t) * slots);
+
+	for (istr = 0; istr < count; ++istr) {
+		size_t length = strings[istr].length;
+		hash_t value = string_hash(strings[istr].str, length);
+		if (length)
+			memcpy(storage, strings[istr].str, length);
+		storage[length] = 0;
+		set->string[istr] = string_const(storage, length);
+		set->hash[istr] = value;
+		storage += length + 1;
+
+		//Duplicates keep the first index to match a linear search
+		slot = (size_t)value & set->mask;
+		while (set->index[slot]) {
+			uint32_t other = set->index[slot] - 1;
+			if ((set->hash[other] == value) &&
+			        string_equal(STRING_ARGS(set->string[other]), STRING_ARGS(set->string[istr])))
+				break;
+			slot = (slot + 1) & set->mask;
+		}
+		if (!set->index[slot])
+			set->index[slot] = (uint32_t)istr + 1;
+	}
+}
+
+void
+string_set_finalize(string_set_t* set) {
+	memory_deallocate(set->string);
+	memset(set, 0, sizeof(string_set_t));
+}
+
+ssize_t
+string_set_find(const string_set_t* set, const char* str, size_t length) {
+	hash_t value;
+	size_t slot;
+	uint32_t entry;
+	if (!set->count)
+		return -1;
+	value = string_hash(str, length);
+	slot = (size_t)value & set->mask;
+	while ((entry = set->index[slot]) != 0) {
+		--entry;
+		if ((set->hash[entry] == value) &&
+		        string_equal(STRING_ARGS(set->string[entry]), str, length))
+			return (ssize_t)entry;
+		slot = (slot + 1) & set->mask;
+	}
+	return -1;
+}
+
 #define get_bit_mask( numbits ) ( ( 1U << (numbits) ) - 1 )
 
 static size_t
@@ -1053,59 +1651,480 @@ encode_utf8(char* str, uint32_t val) {
 	return num + 1;
 }
 
-uint32_t
-string_glyph(const char* str, size_t length, size_t offset, size_t* consumed) {
-	uint32_t glyph;
-	unsigned char ext;
-	size_t num, j;
-	const char* cur;
-	const char* end;
-
-	if (offset >= length) {
-		if (consumed)
-			*consumed = 0;
-		return 0;
+/* Utf-8 validation and transcoding process runs of ascii characters in blocks of 16, and
+   validate multibyte sequences in blocks with the lookup algorithm by John Keiser and Daniel
+   Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" */
+
+#define UTF8_TOO_SHORT  (1 << 0)
+#define UTF8_TOO_LONG   (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE  (1 << 3)
+#define UTF8_SURROGATE  (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS  (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+//Error lookup on high nibble of first byte, low nibble of first byte and high nibble of
+//second byte in each pair of consecutive bytes
+static const uint8_t _string_utf8_byte_1_high[16] = {
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+	UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+	UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+	UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+	UTF8_TOO_SHORT,
+	UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+	UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+static const uint8_t _string_utf8_byte_1_low[16] = {
+	UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+	UTF8_CARRY | UTF8_OVERLONG_2,
+	UTF8_CARRY,
+	UTF8_CARRY,
+	UTF8_CARRY | UTF8_TOO_LARGE,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+	UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+
+static const uint8_t _string_utf8_byte_2_high[16] = {
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+	UTF8_OVERLONG_4,
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+	UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+	UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+//Maximum value of the last three bytes in a block not starting an incomplete sequence
+static const uint8_t _string_utf8_incomplete_max[16] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+//Number of leading ascii characters in utf-8 string
+static size_t
+_string_utf8_ascii_length(const char* str, size_t length) {
+	size_t offset = 0;
+#if STRING_SEARCH_SSE2
+	while (offset + 16 <= length) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(const void*)(str + offset));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(block);
+		if (mask)
+			return offset + _string_search_first_bit(mask);
+		offset += 16;
 	}
-
-	cur = str + offset;
-	if (!(*cur & 0x80)) {
-		glyph = (unsigned char)*cur++;
-		if (consumed)
-			*consumed = 1;
+#elif STRING_SEARCH_NEON
+	while (offset + 16 <= length) {
+		if (vmaxvq_u8(vld1q_u8((const uint8_t*)str + offset)) & 0x80)
+			break;
+		offset += 16;
 	}
-	else {
-		//Convert through UTF-32
-		end = str + length;
-		ext = (unsigned char)*cur;
-		num = get_num_bytes_utf8(ext) - 1; //Subtract one to get number of _extra_ bytes
-		glyph = ((uint32_t)ext & get_bit_mask(6 - num)) << (6 * num);
-		++cur;
-		for (j = 1; (j <= num) && (cur < end); ++j, ++cur) {
-			ext = (unsigned char)*cur;
-			glyph |= ((uint32_t)ext & 0x3F) << (6 * (num - j));
-		}
-		if (consumed)
-			*consumed = j;
+#else
+	while (offset + 8 <= length) {
+		uint64_t block;
+		memcpy(&block, str + offset, sizeof(block));
+		if (block & 0x8080808080808080ULL)
+			break;
+		offset += 8;
 	}
-	return glyph;
+#endif
+	while ((offset < length) && !(str[offset] & 0x80))
+		++offset;
+	return offset;
 }
 
-size_t
-string_glyphs(const char* str, size_t length) {
-	const char* end = pointer_offset_const(str, length);
-	size_t num = 0;
-	while (str && (str < end)) {
-		++num;
-		//Will catch invalid utf-8 sequences by overflowing str < end terminator
-		str += get_num_bytes_utf8((uint8_t)*str);
+//Widen leading ascii characters in utf-8 string, return number of characters converted
+static size_t
+_string_utf8_widen_ascii(wchar_t* dest, const char* str, size_t length) {
+	size_t offset = 0;
+#if STRING_SEARCH_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	while (offset + 16 <= length) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(const void*)(str + offset));
+		__m128i* out = (__m128i*)(void*)(dest + offset);
+		if (_mm_movemask_epi8(block))
+			break;
+#if FOUNDATION_SIZE_WCHAR == 2
+		_mm_storeu_si128(out, _mm_unpacklo_epi8(block, zero));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(block, zero));
+#else
+		__m128i low = _mm_unpacklo_epi8(block, zero);
+		__m128i high = _mm_unpackhi_epi8(block, zero);
+		_mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+#endif
+		offset += 16;
 	}
-	return num;
-}
-
-wchar_t*
-wstring_allocate_from_string(const char* cstr, size_t length) {
-	wchar_t* buffer;
-	wchar_t* dest;
+#elif STRING_SEARCH_NEON
+	while (offset + 16 <= length) {
+		uint8x16_t block = vld1q_u8((const uint8_t*)str + offset);
+		uint16x8_t low, high;
+		if (vmaxvq_u8(block) & 0x80)
+			break;
+		low = vmovl_u8(vget_low_u8(block));
+		high = vmovl_u8(vget_high_u8(block));
+#if FOUNDATION_SIZE_WCHAR == 2
+		vst1q_u16((uint16_t*)dest + offset, low);
+		vst1q_u16((uint16_t*)dest + offset + 8, high);
+#else
+		vst1q_u32((uint32_t*)dest + offset, vmovl_u16(vget_low_u16(low)));
+		vst1q_u32((uint32_t*)dest + offset + 4, vmovl_u16(vget_high_u16(low)));
+		vst1q_u32((uint32_t*)dest + offset + 8, vmovl_u16(vget_low_u16(high)));
+		vst1q_u32((uint32_t*)dest + offset + 12, vmovl_u16(vget_high_u16(high)));
+#endif
+		offset += 16;
+	}
+#endif
+	while ((offset < length) && !(str[offset] & 0x80)) {
+		dest[offset] = (wchar_t)str[offset];
+		++offset;
+	}
+	return offset;
+}
+
+//Narrow leading ascii characters in utf-16 string, return number of characters converted.
+//Only counts ascii characters if destination is null
+static size_t
+_string_utf16_narrow_ascii(char* dst, const uint16_t* src, size_t length) {
+	size_t offset = 0;
+#if STRING_SEARCH_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i nonascii = _mm_set1_epi16((short)0xFF80);
+	while (offset + 16 <= length) {
+		__m128i low = _mm_loadu_si128((const __m128i*)(const void*)(src + offset));
+		__m128i high = _mm_loadu_si128((const __m128i*)(const void*)(src + offset + 8));
+		__m128i test = _mm_and_si128(_mm_or_si128(low, high), nonascii);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(test, zero)) != 0xFFFF)
+			break;
+		if (dst)
+			_mm_storeu_si128((__m128i*)(void*)(dst + offset), _mm_packus_epi16(low, high));
+		offset += 16;
+	}
+#elif STRING_SEARCH_NEON
+	while (offset + 16 <= length) {
+		uint16x8_t low = vld1q_u16(src + offset);
+		uint16x8_t high = vld1q_u16(src + offset + 8);
+		if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80)
+			break;
+		if (dst)
+			vst1q_u8((uint8_t*)dst + offset, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+		offset += 16;
+	}
+#endif
+	while ((offset < length) && (src[offset] < 0x80)) {
+		if (dst)
+			dst[offset] = (char)src[offset];
+		++offset;
+	}
+	return offset;
+}
+
+//Narrow leading ascii characters in utf-32 string, return number of characters converted.
+//Only counts ascii characters if destination is null
+static size_t
+_string_utf32_narrow_ascii(char* dst, const uint32_t* src, size_t length) {
+	size_t offset = 0;
+#if STRING_SEARCH_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i nonascii = _mm_set1_epi32((int)0xFFFFFF80);
+	while (offset + 16 <= length) {
+		const __m128i* in = (const __m128i*)(const void*)(src + offset);
+		__m128i b0 = _mm_loadu_si128(in);
+		__m128i b1 = _mm_loadu_si128(in + 1);
+		__m128i b2 = _mm_loadu_si128(in + 2);
+		__m128i b3 = _mm_loadu_si128(in + 3);
+		__m128i test = _mm_and_si128(_mm_or_si128(_mm_or_si128(b0, b1), _mm_or_si128(b2, b3)),
+		                             nonascii);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(test, zero)) != 0xFFFF)
+			break;
+		if (dst)
+			_mm_storeu_si128((__m128i*)(void*)(dst + offset),
+			                 _mm_packus_epi16(_mm_packs_epi32(b0, b1), _mm_packs_epi32(b2, b3)));
+		offset += 16;
+	}
+#elif STRING_SEARCH_NEON
+	while (offset + 16 <= length) {
+		uint32x4_t b0 = vld1q_u32(src + offset);
+		uint32x4_t b1 = vld1q_u32(src + offset + 4);
+		uint32x4_t b2 = vld1q_u32(src + offset + 8);
+		uint32x4_t b3 = vld1q_u32(src + offset + 12);
+		if (vmaxvq_u32(vorrq_u32(vorrq_u32(b0, b1), vorrq_u32(b2, b3))) >= 0x80)
+			break;
+		if (dst) {
+			uint16x8_t low = vcombine_u16(vmovn_u32(b0), vmovn_u32(b1));
+			uint16x8_t high = vcombine_u16(vmovn_u32(b2), vmovn_u32(b3));
+			vst1q_u8((uint8_t*)dst + offset, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+		}
+		offset += 16;
+	}
+#endif
+	while ((offset < length) && (src[offset] < 0x80)) {
+		if (dst)
+			dst[offset] = (char)src[offset];
+		++offset;
+	}
+	return offset;
+}
+
+#if !STRING_SEARCH_NEON
+
+static bool
+_string_validate_utf8_scalar(const unsigned char* str, size_t length) {
+	size_t offset = 0;
+	while (offset < length) {
+		unsigned char lead = str[offset];
+		unsigned char next;
+		size_t num, j;
+		if (lead < 0x80) {
+			++offset;
+			continue;
+		}
+		if ((lead < 0xC2) || (lead > 0xF4))
+			return false;
+		num = (lead < 0xE0) ? 2 : ((lead < 0xF0) ? 3 : 4);
+		if (offset + num > length)
+			return false;
+		next = str[offset + 1];
+		//Reject overlong encodings, surrogates and glyphs above 0x10FFFF
+		if (((lead == 0xE0) && (next < 0xA0)) || ((lead == 0xED) && (next > 0x9F)) ||
+		        ((lead == 0xF0) && (next < 0x90)) || ((lead == 0xF4) && (next > 0x8F)))
+			return false;
+		for (j = 1; j < num; ++j) {
+			if ((str[offset + j] & 0xC0) != 0x80)
+				return false;
+		}
+		offset += num;
+	}
+	return true;
+}
+
+#endif
+
+#if STRING_SEARCH_SSE2
+
+static int _string_utf8_ssse3 = -1;
+
+static bool
+_string_utf8_ssse3_supported(void) {
+	if (_string_utf8_ssse3 < 0) {
+#if FOUNDATION_COMPILER_MSVC
+		int info[4];
+		__cpuid(info, 1);
+		_string_utf8_ssse3 = (info[2] & (1 << 9)) ? 1 : 0;
+#else
+		__builtin_cpu_init();
+		_string_utf8_ssse3 = __builtin_cpu_supports("ssse3") ? 1 : 0;
+#endif
+	}
+	return _string_utf8_ssse3 > 0;
+}
+
+static STRING_TARGET_SSSE3 bool
+_string_validate_utf8_ssse3(const char* str, size_t length) {
+	const __m128i byte_1_high = _mm_loadu_si128((const __m128i*)(const void*)_string_utf8_byte_1_high);
+	const __m128i byte_1_low = _mm_loadu_si128((const __m128i*)(const void*)_string_utf8_byte_1_low);
+	const __m128i byte_2_high = _mm_loadu_si128((const __m128i*)(const void*)_string_utf8_byte_2_high);
+	const __m128i incomplete_max =
+	    _mm_loadu_si128((const __m128i*)(const void*)_string_utf8_incomplete_max);
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i third_byte = _mm_set1_epi8((char)(0xE0 - 0x80));
+	const __m128i fourth_byte = _mm_set1_epi8((char)(0xF0 - 0x80));
+	const __m128i high_bit = _mm_set1_epi8((char)0x80);
+	__m128i error = _mm_setzero_si128();
+	__m128i prev_input = _mm_setzero_si128();
+	__m128i prev_incomplete = _mm_setzero_si128();
+	size_t offset = 0;
+
+	while (offset < length) {
+		__m128i input, prev1, prev2, prev3, special, must23;
+		if (offset + 16 <= length) {
+			input = _mm_loadu_si128((const __m128i*)(const void*)(str + offset));
+		}
+		else {
+			//Pad final block with ascii zeros
+			char block[16];
+			memset(block, 0, sizeof(block));
+			memcpy(block, str + offset, length - offset);
+			input = _mm_loadu_si128((const __m128i*)(const void*)block);
+		}
+		offset += 16;
+
+		if (!_mm_movemask_epi8(input)) {
+			error = _mm_or_si128(error, prev_incomplete);
+			prev_incomplete = _mm_setzero_si128();
+			prev_input = input;
+			continue;
+		}
+
+		prev1 = _mm_alignr_epi8(input, prev_input, 15);
+		special = _mm_and_si128(
+		              _mm_and_si128(
+		                  _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+		                  _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+		              _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+		//Third and fourth bytes of sequences must be continuations, which the lookup cannot see
+		prev2 = _mm_alignr_epi8(input, prev_input, 14);
+		prev3 = _mm_alignr_epi8(input, prev_input, 13);
+		must23 = _mm_or_si128(_mm_subs_epu8(prev2, third_byte), _mm_subs_epu8(prev3, fourth_byte));
+		error = _mm_or_si128(error, _mm_xor_si128(_mm_and_si128(must23, high_bit), special));
+
+		prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+		prev_input = input;
+	}
+
+	error = _mm_or_si128(error, prev_incomplete);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#elif STRING_SEARCH_NEON
+
+static bool
+_string_validate_utf8_neon(const char* str, size_t length) {
+	const uint8x16_t byte_1_high = vld1q_u8(_string_utf8_byte_1_high);
+	const uint8x16_t byte_1_low = vld1q_u8(_string_utf8_byte_1_low);
+	const uint8x16_t byte_2_high = vld1q_u8(_string_utf8_byte_2_high);
+	const uint8x16_t incomplete_max = vld1q_u8(_string_utf8_incomplete_max);
+	const uint8x16_t nibble = vdupq_n_u8(0x0F);
+	uint8x16_t error = vdupq_n_u8(0);
+	uint8x16_t prev_input = vdupq_n_u8(0);
+	uint8x16_t prev_incomplete = vdupq_n_u8(0);
+	size_t offset = 0;
+
+	while (offset < length) {
+		uint8x16_t input, prev1, prev2, prev3, special, must23;
+		if (offset + 16 <= length) {
+			input = vld1q_u8((const uint8_t*)str + offset);
+		}
+		else {
+			//Pad final block with ascii zeros
+			uint8_t block[16];
+			memset(block, 0, sizeof(block));
+			memcpy(block, str + offset, length - offset);
+			input = vld1q_u8(block);
+		}
+		offset += 16;
+
+		if (!(vmaxvq_u8(input) & 0x80)) {
+			error = vorrq_u8(error, prev_incomplete);
+			prev_incomplete = vdupq_n_u8(0);
+			prev_input = input;
+			continue;
+		}
+
+		prev1 = vextq_u8(prev_input, input, 15);
+		special = vandq_u8(vandq_u8(vqtbl1q_u8(byte_1_high, vshrq_n_u8(prev1, 4)),
+		                            vqtbl1q_u8(byte_1_low, vandq_u8(prev1, nibble))),
+		                   vqtbl1q_u8(byte_2_high, vshrq_n_u8(input, 4)));
+
+		//Third and fourth bytes of sequences must be continuations, which the lookup cannot see
+		prev2 = vextq_u8(prev_input, input, 14);
+		prev3 = vextq_u8(prev_input, input, 13);
+		must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+		                  vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+		error = vorrq_u8(error, veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), special));
+
+		prev_incomplete = vqsubq_u8(input, incomplete_max);
+		prev_input = input;
+	}
+
+	error = vorrq_u8(error, prev_incomplete);
+	return vmaxvq_u8(error) == 0;
+}
+
+#endif
+
+bool
+string_validate_utf8(const char* str, size_t length) {
+	size_t ascii = _string_utf8_ascii_length(str, length);
+	str += ascii;
+	length -= ascii;
+	if (!length)
+		return true;
+#if STRING_SEARCH_NEON
+	return _string_validate_utf8_neon(str, length);
+#else
+#if STRING_SEARCH_SSE2
+	if (_string_utf8_ssse3_supported())
+		return _string_validate_utf8_ssse3(str, length);
+#endif
+	return _string_validate_utf8_scalar((const unsigned char*)str, length);
+#endif
+}
+
+uint32_t
+string_glyph(const char* str, size_t length, size_t offset, size_t* consumed) {
+	uint32_t glyph;
+	unsigned char ext;
+	size_t num, j;
+	const char* cur;
+	const char* end;
+
+	if (offset >= length) {
+		if (consumed)
+			*consumed = 0;
+		return 0;
+	}
+
+	cur = str + offset;
+	if (!(*cur & 0x80)) {
+		glyph = (unsigned char)*cur++;
+		if (consumed)
+			*consumed = 1;
+	}
+	else {
+		//Convert through UTF-32
+		end = str + length;
+		ext = (unsigned char)*cur;
+		num = get_num_bytes_utf8(ext) - 1; //Subtract one to get number of _extra_ bytes
+		glyph = ((uint32_t)ext & get_bit_mask(6 - num)) << (6 * num);
+		++cur;
+		for (j = 1; (j <= num) && (cur < end); ++j, ++cur) {
+			ext = (unsigned char)*cur;
+			glyph |= ((uint32_t)ext & 0x3F) << (6 * (num - j));
+		}
+		if (consumed)
+			*consumed = j;
+	}
+	return glyph;
+}
+
+size_t
+string_glyphs(const char* str, size_t length) {
+	const char* end = pointer_offset_const(str, length);
+	size_t num = 0;
+	while (str && (str < end)) {
+		size_t ascii = _string_utf8_ascii_length(str, (size_t)(end - str));
+		num += ascii;
+		str += ascii;
+		if (str >= end)
+			break;
+		++num;
+		//Will catch invalid utf-8 sequences by overflowing str < end terminator
+		str += get_num_bytes_utf8((uint8_t)*str);
+	}
+	return num;
+}
+
+wchar_t*
+wstring_allocate_from_string(const char* cstr, size_t length) {
+	wchar_t* buffer;
+	wchar_t* dest;
 	size_t num_chars, num_bytes, i, j;
 	uint32_t glyph;
 	unsigned char ext;
@@ -1123,6 +2142,12 @@ wstring_allocate_from_string(const char* cstr, size_t length) {
 	cur = cstr;
 	end = cstr + length;
 	for (i = 0; (i < length) && (cur < end);) {
+		size_t ascii = _string_utf8_ascii_length(cur, (size_t)(end - cur));
+		num_chars += ascii;
+		cur += ascii;
+		i += ascii;
+		if (cur >= end)
+			break;
 		num_bytes = get_num_bytes_utf8((uint8_t)(*cur));
 #if FOUNDATION_SIZE_WCHAR == 2
 		if (num_bytes >= 4)
@@ -1142,8 +2167,11 @@ wstring_allocate_from_string(const char* cstr, size_t length) {
 	dest = buffer;
 	cur = cstr;
 	for (i = 0; (i < length) && (cur < end);) {
-		if (!(*cur & 0x80))
-			*dest++ = *cur++;
+		if (!(*cur & 0x80)) {
+			size_t ascii = _string_utf8_widen_ascii(dest, cur, (size_t)(end - cur));
+			dest += ascii;
+			cur += ascii;
+		}
 		else {
 			//Convert through UTF-32
 			ext = (unsigned char)*cur;
@@ -1192,8 +2220,13 @@ wstring_from_string(wchar_t* dest, size_t capacity, const char* source, size_t l
 
 	/*lint -e{850} */
 	for (i = 0; (i < length) && (cur < end) && (dest < last); ++i) {
-		if (!(*cur & 0x80))
-			*dest++ = *cur++;
+		if (!(*cur & 0x80)) {
+			size_t ascii = _string_utf8_widen_ascii(dest, cur,
+			                                        math_min((size_t)(end - cur), (size_t)(last - dest)));
+			dest += ascii;
+			cur += ascii;
+			i += ascii - 1;
+		}
 		else {
 			//Convert through UTF-32
 			ext = (unsigned char)(*cur);
@@ -1266,6 +2299,12 @@ string_allocate_from_utf16(const uint16_t* str, size_t length) {
 
 	/*lint -e{850} */
 	for (i = 0; i < length; ++i) {
+		if (!swap && (str[i] < 0x80)) {
+			size_t ascii = _string_utf16_narrow_ascii(0, str + i, length - i);
+			curlen += ascii;
+			i += ascii - 1;
+			continue;
+		}
 		glyph = str[i];
 		if ((glyph == 0xFFFE) || (glyph == 0xFEFF)) {
 			swap = (glyph != 0xFEFF);
@@ -1303,6 +2342,12 @@ string_allocate_from_utf32(const uint32_t* str, size_t length) {
 
 	/*lint -e{850} */
 	for (i = 0; i < length; ++i) {
+		if (!swap && (str[i] < 0x80)) {
+			size_t ascii = _string_utf32_narrow_ascii(0, str + i, length - i);
+			curlen += ascii;
+			i += ascii - 1;
+			continue;
+		}
 		glyph = str[i];
 		if ((glyph == 0x0000FEFF) || (glyph == 0xFFFE0000)) {
 			swap = (glyph != 0x0000FEFF);
@@ -1329,6 +2374,15 @@ string_convert_utf16(char* dst, size_t capacity, const uint16_t* src, size_t len
 
 	/*lint -e{850} */
 	for (i = 0; (i < length) && (curlen < capacity); ++i) {
+		if (!swap && (src[i] < 0x80)) {
+			size_t ascii = _string_utf16_narrow_ascii(dst + curlen, src + i,
+			                                          math_min(length - i, capacity - curlen - 1));
+			if (!ascii)
+				break;
+			curlen += ascii;
+			i += ascii - 1;
+			continue;
+		}
 		//Convert through full UTF-32
 		glyph = src[i];
 		if ((glyph == 0xFFFE) || (glyph == 0xFEFF)) {
@@ -1364,6 +2418,15 @@ string_convert_utf32(char* dst, size_t capacity, const uint32_t* src, size_t len
 	swap = false;
 
 	for (i = 0; (i < length) && (curlen < capacity); ++i) {
+		if (!swap && (src[i] < 0x80)) {
+			size_t ascii = _string_utf32_narrow_ascii(dst + curlen, src + i,
+			                                          math_min(length - i, capacity - curlen - 1));
+			if (!ascii)
+				break;
+			curlen += ascii;
+			i += ascii - 1;
+			continue;
+		}
 		glyph = src[i];
 		if ((glyph == 0x0000FEFF) || (glyph == 0xFFFE0000)) {
 			swap = (glyph != 0x0000FEFF);
@@ -1381,80 +2444,540 @@ string_convert_utf32(char* dst, size_t capacity, const uint32_t* src, size_t len
 	return (string_t) {dst, curlen};
 }
 
-#define THREAD_BUFFER_SIZE BUILD_MAX_PATHLEN
-FOUNDATION_DECLARE_THREAD_LOCAL_ARRAY(char, convert_buffer, THREAD_BUFFER_SIZE)
+#define THREAD_BUFFER_SIZE BUILD_THREAD_STRING_BUFFER_SIZE
+FOUNDATION_DECLARE_THREAD_LOCAL_ARRAY(char, convert_buffer,
+                                      THREAD_BUFFER_SIZE * BUILD_THREAD_STRING_BUFFERS)
+FOUNDATION_DECLARE_THREAD_LOCAL(unsigned int, convert_buffer_index, 0)
+
+//Hand out the thread local buffers in turn so nested conversions do not overwrite each other
+static char*
+_string_thread_buffer(void) {
+	unsigned int index = get_thread_convert_buffer_index();
+	set_thread_convert_buffer_index((index + 1) % BUILD_THREAD_STRING_BUFFERS);
+	return get_thread_convert_buffer() + (index * THREAD_BUFFER_SIZE);
+}
+
+static const char _string_digit_pairs[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static const char _string_hex_digits[17] = "0123456789abcdef";
+static const char _string_hex_digits_upper[17] = "0123456789ABCDEF";
+
+//Write decimal digits backwards ending at end, return number of characters written
+static size_t
+_string_format_decimal(char* end, uint64_t val) {
+	char* ptr = end;
+	while (val >= 100) {
+		const char* pair = _string_digit_pairs + ((val % 100) * 2);
+		val /= 100;
+		*--ptr = pair[1];
+		*--ptr = pair[0];
+	}
+	if (val >= 10) {
+		const char* pair = _string_digit_pairs + (val * 2);
+		*--ptr = pair[1];
+		*--ptr = pair[0];
+	}
+	else {
+		*--ptr = (char)('0' + val);
+	}
+	return (size_t)(end - ptr);
+}
+
+
+static FOUNDATION_FORCEINLINE bool
+_string_is_digit(char c) {
+	return (unsigned int)(c - '0') < 10;
+}
+
+static FOUNDATION_FORCEINLINE int
+_string_hex_value(char c) {
+	if (_string_is_digit(c))
+		return c - '0';
+	c |= 0x20;
+	if ((c >= 'a') && (c <= 'f'))
+		return c - 'a' + 10;
+	return -1;
+}
+
+//Hex digits are computed sixteen bytes at a time as nibble + '0', adding the distance to the
+//letters for nibbles above nine, and interleaved high nibble first
+string_t
+string_hex_encode(char* str, size_t capacity, const void* data, size_t size, bool uppercase) {
+	const uint8_t* src = data;
+	const char* digits = uppercase ? _string_hex_digits_upper : _string_hex_digits;
+	size_t i = 0;
+
+	if (size > capacity / 2)
+		size = capacity / 2;
+
+#if STRING_SEARCH_SSE2
+	for (; i + 16 <= size; i += 16) {
+		const __m128i mask = _mm_set1_epi8(0x0F);
+		const __m128i nine = _mm_set1_epi8(9);
+		const __m128i zero = _mm_set1_epi8('0');
+		const __m128i alpha = _mm_set1_epi8(uppercase ? ('A' - '0' - 10) : ('a' - '0' - 10));
+		__m128i in = _mm_loadu_si128((const __m128i*)(const void*)(src + i));
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), mask);
+		__m128i lo = _mm_and_si128(in, mask);
+		hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha));
+		lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha));
+		_mm_storeu_si128((__m128i*)(void*)(str + (i * 2)), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(void*)(str + (i * 2) + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+#elif STRING_SEARCH_NEON
+	for (; i + 16 <= size; i += 16) {
+		const uint8x16_t mask = vdupq_n_u8(0x0F);
+		const uint8x16_t nine = vdupq_n_u8(9);
+		const uint8x16_t zero = vdupq_n_u8('0');
+		const uint8x16_t alpha = vdupq_n_u8(uppercase ? ('A' - '0' - 10) : ('a' - '0' - 10));
+		uint8x16_t in = vld1q_u8(src + i);
+		uint8x16_t hi = vshrq_n_u8(in, 4);
+		uint8x16_t lo = vandq_u8(in, mask);
+		uint8x16x2_t out;
+		out.val[0] = vaddq_u8(vaddq_u8(hi, zero), vandq_u8(vcgtq_u8(hi, nine), alpha));
+		out.val[1] = vaddq_u8(vaddq_u8(lo, zero), vandq_u8(vcgtq_u8(lo, nine), alpha));
+		vst2q_u8((uint8_t*)str + (i * 2), out);
+	}
+#endif
+	for (; i < size; ++i) {
+		str[i * 2] = digits[src[i] >> 4];
+		str[(i * 2) + 1] = digits[src[i] & 0xF];
+	}
+	if (size * 2 < capacity)
+		str[size * 2] = 0;
+	return (string_t) {str, size * 2};
+}
+
+//Decode pairs of hex digits sixteen bytes at a time. Blocks containing a character that is not
+//a hex digit are left to the scalar loop, which stops at that character
+size_t
+string_hex_decode(const char* str, size_t length, void* data, size_t capacity) {
+	uint8_t* dest = data;
+	size_t size = length / 2;
+	size_t i = 0;
+
+	if (size > capacity)
+		size = capacity;
+
+#if STRING_SEARCH_SSE2
+	for (; i + 16 <= size; i += 16) {
+		const __m128i nine = _mm_set1_epi8(9);
+		const __m128i five = _mm_set1_epi8(5);
+		const __m128i low = _mm_set1_epi16(0x00FF);
+		__m128i in0 = _mm_loadu_si128((const __m128i*)(const void*)(str + (i * 2)));
+		__m128i in1 = _mm_loadu_si128((const __m128i*)(const void*)(str + (i * 2) + 16));
+		__m128i digit0 = _mm_sub_epi8(in0, _mm_set1_epi8('0'));
+		__m128i digit1 = _mm_sub_epi8(in1, _mm_set1_epi8('0'));
+		__m128i alpha0 = _mm_sub_epi8(_mm_or_si128(in0, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		__m128i alpha1 = _mm_sub_epi8(_mm_or_si128(in1, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		//Unsigned compare against upper bound, x <= n if min(x, n) == x
+		__m128i isdigit0 = _mm_cmpeq_epi8(_mm_min_epu8(digit0, nine), digit0);
+		__m128i isdigit1 = _mm_cmpeq_epi8(_mm_min_epu8(digit1, nine), digit1);
+		__m128i isalpha0 = _mm_cmpeq_epi8(_mm_min_epu8(alpha0, five), alpha0);
+		__m128i isalpha1 = _mm_cmpeq_epi8(_mm_min_epu8(alpha1, five), alpha1);
+		__m128i value0, value1;
+		if (_mm_movemask_epi8(_mm_and_si128(_mm_or_si128(isdigit0, isalpha0),
+		                                    _mm_or_si128(isdigit1, isalpha1))) != 0xFFFF)
+			break;
+		value0 = _mm_or_si128(_mm_and_si128(isdigit0, digit0),
+		                      _mm_andnot_si128(isdigit0, _mm_add_epi8(alpha0, _mm_set1_epi8(10))));
+		value1 = _mm_or_si128(_mm_and_si128(isdigit1, digit1),
+		                      _mm_andnot_si128(isdigit1, _mm_add_epi8(alpha1, _mm_set1_epi8(10))));
+		//Each 16-bit lane holds the high nibble in the low byte and the low nibble in the high byte
+		value0 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(value0, low), 4), _mm_srli_epi16(value0, 8));
+		value1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(value1, low), 4), _mm_srli_epi16(value1, 8));
+		_mm_storeu_si128((__m128i*)(void*)(dest + i), _mm_packus_epi16(value0, value1));
+	}
+#elif STRING_SEARCH_NEON
+	for (; i + 16 <= size; i += 16) {
+		const uint8x16_t nine = vdupq_n_u8(9);
+		const uint8x16_t five = vdupq_n_u8(5);
+		const uint8x16_t ten = vdupq_n_u8(10);
+		uint8x16x2_t in = vld2q_u8((const uint8_t*)str + (i * 2));
+		uint8x16_t digithi = vsubq_u8(in.val[0], vdupq_n_u8('0'));
+		uint8x16_t digitlo = vsubq_u8(in.val[1], vdupq_n_u8('0'));
+		uint8x16_t alphahi = vsubq_u8(vorrq_u8(in.val[0], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+		uint8x16_t alphalo = vsubq_u8(vorrq_u8(in.val[1], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+		uint8x16_t isdigithi = vcleq_u8(digithi, nine);
+		uint8x16_t isdigitlo = vcleq_u8(digitlo, nine);
+		uint8x16_t valid = vandq_u8(vorrq_u8(isdigithi, vcleq_u8(alphahi, five)),
+		                            vorrq_u8(isdigitlo, vcleq_u8(alphalo, five)));
+		uint64x2_t valid64 = vreinterpretq_u64_u8(valid);
+		uint8x16_t hi, lo;
+		if ((vgetq_lane_u64(valid64, 0) & vgetq_lane_u64(valid64, 1)) != 0xFFFFFFFFFFFFFFFFULL)
+			break;
+		hi = vbslq_u8(isdigithi, digithi, vaddq_u8(alphahi, ten));
+		lo = vbslq_u8(isdigitlo, digitlo, vaddq_u8(alphalo, ten));
+		vst1q_u8(dest + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+	}
+#endif
+	for (; i < size; ++i) {
+		int hi = _string_hex_value(str[i * 2]);
+		int lo = _string_hex_value(str[(i * 2) + 1]);
+		if ((hi < 0) || (lo < 0))
+			break;
+		dest[i] = (uint8_t)((hi << 4) | lo);
+	}
+	return i;
+}
+
+//Write hex digits without leading zeros backwards ending at end, return number of characters
+static size_t
+_string_format_hex(char* end, uint64_t val) {
+	char digits[16];
+	uint64_t bigendian = byteorder_bigendian64(val);
+	size_t skip = 0;
+	string_hex_encode(digits, sizeof(digits), &bigendian, sizeof(bigendian), false);
+	while ((skip < 15) && (digits[skip] == '0'))
+		++skip;
+	memcpy(end - (16 - skip), digits + skip, 16 - skip);
+	return 16 - skip;
+}
+
+//Copy formatted number to buffer, truncating to capacity or padding to width
+static string_t
+_string_from_formatted(char* buffer, size_t capacity, const char* str, size_t length,
+                       unsigned int width, char fill) {
+	size_t ofs;
+	if (length >= capacity) {
+		//Truncate by copying the leading part, width does not apply
+		length = capacity - 1;
+		width = 0;
+	}
+	if (width >= capacity)
+		width = (unsigned int)capacity - 1;
+	ofs = (length < width) ? (width - length) : 0;
+	if (ofs)
+		memset(buffer, fill, ofs);
+	memcpy(buffer + ofs, str, length);
+	buffer[ ofs + length ] = 0;
+	return (string_t) {buffer, ofs + length};
+}
 
 string_t
 string_from_int(char* buffer, size_t capacity, int64_t val, unsigned int width, char fill) {
-	int len;
+	char digits[24];
+	char* end = digits + sizeof(digits);
+	size_t len;
 	if (!capacity)
 		return (string_t) {buffer, 0};
-	len = snprintf(buffer, capacity, "%" PRId64, val);
-	if ((unsigned int)len >= capacity) {
-		buffer[ capacity - 1 ] = 0;
-		return (string_t) {buffer, capacity - 1};
+	if (val < 0) {
+		len = _string_format_decimal(end, (uint64_t)0 - (uint64_t)val);
+		*(end - (++len)) = '-';
 	}
-	if (width >= capacity)
-		width = (unsigned int)capacity - 1;
-	if ((unsigned int)len < width) {
-		size_t diff = width - (unsigned int)len;
-		memmove(buffer + diff, buffer, (unsigned int)(len + 1));
-		memset(buffer, fill, diff);
-		return (string_t) {buffer, width};
+	else {
+		len = _string_format_decimal(end, (uint64_t)val);
 	}
-	return (string_t) {buffer, (unsigned int)len};
+	return _string_from_formatted(buffer, capacity, end - len, len, width, fill);
 }
 
 string_const_t
 string_from_int_static(int64_t val, unsigned int width, char fill) {
-	return string_to_const(string_from_int(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, val, width,
+	return string_to_const(string_from_int(_string_thread_buffer(), THREAD_BUFFER_SIZE, val, width,
 	                                       fill));
 }
 
 string_t
 string_from_uint(char* buffer, size_t capacity, uint64_t val, bool hex, unsigned int width,
                  char fill) {
-	int len;
+	char digits[24];
+	char* end = digits + sizeof(digits);
+	size_t len;
 	if (!capacity)
 		return (string_t) {buffer, 0};
-	len = snprintf(buffer, capacity, hex ? "%" PRIx64 : "%" PRIu64, val);
-	if ((unsigned int)len >= capacity) {
-		buffer[ capacity - 1 ] = 0;
-		return (string_t) {buffer, capacity - 1};
-	}
-	if (width >= capacity)
-		width = (unsigned int)capacity - 1;
-	if ((unsigned int)len < width) {
-		size_t diff = width - (unsigned int)len;
-		memmove(buffer + diff, buffer, (unsigned int)(len + 1));
-		memset(buffer, fill, diff);
-		return (string_t) {buffer, width};
-	}
-	return (string_t) {buffer, (unsigned int)len};
+	len = hex ? _string_format_hex(end, val) : _string_format_decimal(end, val);
+	return _string_from_formatted(buffer, capacity, end - len, len, width, fill);
 }
 
 string_const_t
 string_from_uint_static(uint64_t val, bool hex, unsigned int width, char fill) {
-	return string_to_const(string_from_uint(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, val, hex,
+	return string_to_const(string_from_uint(_string_thread_buffer(), THREAD_BUFFER_SIZE, val, hex,
 	                                        width, fill));
 }
 
 string_t
 string_from_uint128(char* buffer, size_t capacity, const uint128_t val) {
-	int len;
+	uint64_t words[2];
+	char digits[32];
 	if (!capacity)
 		return (string_t) {buffer, 0};
-	len = snprintf(buffer, capacity, "%016" PRIx64 "%016" PRIx64, val.word[0], val.word[1]);
-	if ((unsigned int)len >= capacity) {
-		buffer[ capacity - 1 ] = 0;
-		return (string_t) {buffer, capacity - 1};
-	}
-	return (string_t) {buffer, (unsigned int)len};
+	words[0] = byteorder_bigendian64(val.word[0]);
+	words[1] = byteorder_bigendian64(val.word[1]);
+	string_hex_encode(digits, sizeof(digits), words, sizeof(words), false);
+	return _string_from_formatted(buffer, capacity, digits, sizeof(digits), 0, 0);
 }
 
 string_const_t
 string_from_uint128_static(const uint128_t val) {
-	return string_to_const(string_from_uint128(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, val));
+	return string_to_const(string_from_uint128(_string_thread_buffer(), THREAD_BUFFER_SIZE, val));
+}
+
+/* Shortest round trip formatting of floating point values with the Grisu2 algorithm by
+   Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers" */
+
+typedef struct {
+	uint64_t f;
+	int e;
+} string_diyfp_t;
+
+//Normalized 10^k for k = -348, -340, ..., 340
+static const uint64_t _string_cached_power_f[] = {
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+	0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+	0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+	0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+	0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+	0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+	0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+	0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+	0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+	0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+	0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+	0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+	0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+	0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+	0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+	0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+	0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+	0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+	0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+	0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+	0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+	0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t _string_cached_power_e[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint64_t _string_pow10[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+	1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+	100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+	1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static string_diyfp_t
+_string_diyfp_normalize(string_diyfp_t v) {
+	while (!(v.f & 0x8000000000000000ULL)) {
+		v.f <<= 1;
+		--v.e;
+	}
+	return v;
+}
+
+//Upper 64 bits of the 128-bit product, rounded
+static string_diyfp_t
+_string_diyfp_multiply(string_diyfp_t lhs, string_diyfp_t rhs) {
+	const uint64_t mask = 0xFFFFFFFFULL;
+	const uint64_t a = lhs.f >> 32, b = lhs.f & mask;
+	const uint64_t c = rhs.f >> 32, d = rhs.f & mask;
+	const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+	tmp += 1ULL << 31;
+	return (string_diyfp_t) {ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), lhs.e + rhs.e + 64};
+}
+
+//Cached power c such that the binary exponent of e scaled by c is in [-60,-32]
+static string_diyfp_t
+_string_cached_power(int e, int* K) {
+	const double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int k = (int)dk;
+	unsigned int index;
+	if (dk - k > 0.0)
+		++k;
+	index = (unsigned int)((k >> 3) + 1);
+	*K = -(-348 + (int)(index << 3));
+	return (string_diyfp_t) {_string_cached_power_f[index], _string_cached_power_e[index]};
+}
+
+static void
+_string_grisu_round(char* digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa,
+                    uint64_t wp_w) {
+	while ((rest < wp_w) && (delta - rest >= ten_kappa) &&
+	        ((rest + ten_kappa < wp_w) || (wp_w - rest > rest + ten_kappa - wp_w))) {
+		digits[length - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+static int
+_string_grisu_digits(char* digits, string_diyfp_t w, string_diyfp_t wp, uint64_t delta, int* K) {
+	const int shift = -wp.e;
+	const uint64_t one = 1ULL << shift;
+	const uint64_t wp_w = wp.f - w.f;
+	uint32_t p1 = (uint32_t)(wp.f >> shift);
+	uint64_t p2 = wp.f & (one - 1);
+	int kappa = 1;
+	int length = 0;
+
+	while ((kappa < 10) && (p1 >= _string_pow10[kappa]))
+		++kappa;
+
+	while (kappa > 0) {
+		const uint32_t pow10 = (uint32_t)_string_pow10[kappa - 1];
+		const uint32_t d = p1 / pow10;
+		uint64_t rest;
+		p1 %= pow10;
+		if (d || length)
+			digits[length++] = (char)('0' + d);
+		--kappa;
+		rest = ((uint64_t)p1 << shift) + p2;
+		if (rest <= delta) {
+			*K += kappa;
+			_string_grisu_round(digits, length, delta, rest, _string_pow10[kappa] << shift, wp_w);
+			return length;
+		}
+	}
+
+	while (true) {
+		char d;
+		p2 *= 10;
+		delta *= 10;
+		d = (char)(p2 >> shift);
+		if (d || length)
+			digits[length++] = (char)('0' + d);
+		p2 &= one - 1;
+		--kappa;
+		if (p2 < delta) {
+			*K += kappa;
+			_string_grisu_round(digits, length, delta, p2, one,
+			                    (-kappa < 20) ? wp_w * _string_pow10[-kappa] : 0);
+			return length;
+		}
+	}
+}
+
+//Shortest digits d such that d * 10^K rounds to f * 2^e, f including the hidden bit
+static int
+_string_grisu2(char* digits, uint64_t f, int e, bool lower_closer, int* K) {
+	string_diyfp_t w = _string_diyfp_normalize((string_diyfp_t) {f, e});
+	string_diyfp_t wp = _string_diyfp_normalize((string_diyfp_t) {(f << 1) + 1, e - 1});
+	string_diyfp_t wm = lower_closer ? (string_diyfp_t) {(f << 2) - 1, e - 2} :
+	                    (string_diyfp_t) {(f << 1) - 1, e - 1};
+	string_diyfp_t cached;
+
+	wm.f <<= wm.e - wp.e;
+	wm.e = wp.e;
+
+	cached = _string_cached_power(wp.e, K);
+	w = _string_diyfp_multiply(w, cached);
+	wp = _string_diyfp_multiply(wp, cached);
+	wm = _string_diyfp_multiply(wm, cached);
+	++wm.f;
+	--wp.f;
+	return _string_grisu_digits(digits, w, wp, wp.f - wm.f, K);
+}
+
+//Format real with the shortest representation that parses back to the same value, in fixed
+//notation for magnitudes in [1e-6,1e21) and exponent notation otherwise
+static size_t
+_string_format_shortest(char* dest, real val) {
+	char digits[32];
+	char* ptr = dest;
+	uint64_t f;
+	int e, K, length, kk;
+	bool negative, lower_closer;
+#if FOUNDATION_SIZE_REAL == 8
+	float64_cast_t conv;
+	uint64_t significand;
+	int biased;
+	conv.fval = val;
+	significand = conv.uival & 0x000FFFFFFFFFFFFFULL;
+	biased = (int)((conv.uival >> 52) & 0x7FF);
+	negative = (conv.uival >> 63) != 0;
+	if (biased == 0x7FF) {
+#else
+	float32_cast_t conv;
+	uint32_t significand;
+	int biased;
+	conv.fval = val;
+	significand = conv.uival & 0x007FFFFFU;
+	biased = (int)((conv.uival >> 23) & 0xFF);
+	negative = (conv.uival >> 31) != 0;
+	if (biased == 0xFF) {
+#endif
+		if (significand) {
+			memcpy(dest, "nan", 3);
+			return 3;
+		}
+		if (negative)
+			*ptr++ = '-';
+		memcpy(ptr, "inf", 3);
+		return (size_t)(ptr - dest) + 3;
+	}
+#if FOUNDATION_SIZE_REAL == 8
+	f = biased ? (significand | (1ULL << 52)) : significand;
+	e = (biased ? biased : 1) - 1075;
+#else
+	f = biased ? (significand | (1U << 23)) : significand;
+	e = (biased ? biased : 1) - 150;
+#endif
+	if (!f) {
+		*dest = '0';
+		return 1;
+	}
+	if (negative)
+		*ptr++ = '-';
+
+	lower_closer = !significand && (biased > 1);
+	length = _string_grisu2(digits, f, e, lower_closer, &K);
+	kk = length + K;
+
+	if ((K >= 0) && (kk <= 21)) {
+		memcpy(ptr, digits, (size_t)length);
+		memset(ptr + length, '0', (size_t)K);
+		ptr += kk;
+	}
+	else if ((kk > 0) && (kk <= 21)) {
+		memcpy(ptr, digits, (size_t)kk);
+		ptr[kk] = '.';
+		memcpy(ptr + kk + 1, digits + kk, (size_t)(length - kk));
+		ptr += length + 1;
+	}
+	else if ((kk > -6) && (kk <= 0)) {
+		*ptr++ = '0';
+		*ptr++ = '.';
+		memset(ptr, '0', (size_t)-kk);
+		memcpy(ptr - kk, digits, (size_t)length);
+		ptr += length - kk;
+	}
+	else {
+		char exponent[8];
+		size_t explen;
+		*ptr++ = digits[0];
+		if (length > 1) {
+			*ptr++ = '.';
+			memcpy(ptr, digits + 1, (size_t)(length - 1));
+			ptr += length - 1;
+		}
+		*ptr++ = 'e';
+		if (--kk < 0) {
+			*ptr++ = '-';
+			kk = -kk;
+		}
+		explen = _string_format_decimal(exponent + sizeof(exponent), (uint64_t)kk);
+		memcpy(ptr, exponent + sizeof(exponent) - explen, explen);
+		ptr += explen;
+	}
+	return (size_t)(ptr - dest);
 }
 
 string_t
@@ -1466,16 +2989,15 @@ string_from_real(char* buffer, size_t capacity, real val, unsigned int precision
 	int len = -1;
 	if (!capacity)
 		return (string_t) {buffer, 0};
+	if (!precision) {
+		char formatted[48];
+		size_t length = _string_format_shortest(formatted, val);
+		return _string_from_formatted(buffer, capacity, formatted, length, width, fill);
+	}
 #if FOUNDATION_SIZE_REAL == 8
-	if (precision)
-		len = snprintf(buffer, capacity, "%.*lf", precision, val);
-	else
-		len = snprintf(buffer, capacity, "%.16lf", val);
+	len = snprintf(buffer, capacity, "%.*lf", precision, val);
 #else
-	if (precision)
-		len = snprintf(buffer, capacity, "%.*f", precision, val);
-	else
-		len = snprintf(buffer, capacity, "%.7f", val);
+	len = snprintf(buffer, capacity, "%.*f", precision, val);
 #endif
 
 	ulen = (unsigned int)len;
@@ -1517,7 +3039,7 @@ string_from_real(char* buffer, size_t capacity, real val, unsigned int precision
 
 string_const_t
 string_from_real_static(real val, unsigned int precision, unsigned int width, char fill) {
-	return string_to_const(string_from_real(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, val,
+	return string_to_const(string_from_real(_string_thread_buffer(), THREAD_BUFFER_SIZE, val,
 	                                        precision, width, fill));
 }
 
@@ -1546,12 +3068,12 @@ string_from_time(char* buffer, size_t capacity, tick_t t, bool local) {
 
 string_const_t
 string_from_time_static(tick_t t, bool local) {
-	return string_to_const(string_from_time(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, t, local));
+	return string_to_const(string_from_time(_string_thread_buffer(), THREAD_BUFFER_SIZE, t, local));
 }
 
 string_const_t
 string_from_uuid_static(const uuid_t val) {
-	return string_to_const(string_from_uuid(get_thread_convert_buffer(), THREAD_BUFFER_SIZE, val));
+	return string_to_const(string_from_uuid(_string_thread_buffer(), THREAD_BUFFER_SIZE, val));
 }
 
 string_t
@@ -1578,59 +3100,1008 @@ string_from_version(char* buffer, size_t capacity, const version_t version) {
 
 string_const_t
 string_from_version_static(const version_t version) {
-	return string_to_const(string_from_version(get_thread_convert_buffer(), THREAD_BUFFER_SIZE,
+	return string_to_const(string_from_version(_string_thread_buffer(), THREAD_BUFFER_SIZE,
 	                                           version));
 }
 
-int
-string_to_int(const char* val, size_t length) {
-	int ret = 0;
-	char buf[16];
-	if (length) {
-		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, "%d", &ret);
+/* Number parsing. Integers are parsed eight digits at a time with SWAR arithmetic, floats are
+   converted with the Eisel-Lemire algorithm, see Daniel Lemire, "Number Parsing at a Gigabyte
+   per Second". Parsing is locale independent and follows the scanf conventions of skipping
+   leading whitespace and stopping at the first character not part of the number. */
+
+//Normalized 128-bit approximations of 5^q for q = -342, -341, ..., 308
+static const uint64_t _string_pow5_128[] = {
+	0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL,
+	0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+	0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL,
+	0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+	0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL,
+	0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+	0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL,
+	0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+	0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL,
+	0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+	0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL,
+	0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+	0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL,
+	0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+	0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL,
+	0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+	0x84a57695fe98746dULL, 0x014bb630f7604b57ULL,
+	0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+	0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL,
+	0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+	0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL,
+	0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+	0xfd00b897478238d0ULL, 0x8920b098955522b4ULL,
+	0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+	0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL,
+	0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+	0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL,
+	0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+	0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL,
+	0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+	0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL,
+	0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+	0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL,
+	0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+	0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL,
+	0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+	0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL,
+	0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+	0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL,
+	0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+	0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL,
+	0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+	0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL,
+	0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+	0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL,
+	0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+	0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL,
+	0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+	0xa37fce126597973cULL, 0xe50ff107bab528a0ULL,
+	0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+	0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL,
+	0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+	0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL,
+	0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+	0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL,
+	0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+	0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL,
+	0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+	0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL,
+	0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+	0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL,
+	0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+	0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL,
+	0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+	0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL,
+	0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+	0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL,
+	0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+	0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL,
+	0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+	0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL,
+	0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+	0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL,
+	0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+	0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL,
+	0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+	0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL,
+	0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+	0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL,
+	0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+	0xc987434744ac874eULL, 0xa327ffb266b56220ULL,
+	0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+	0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL,
+	0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+	0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL,
+	0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+	0xc0314325637a1939ULL, 0xfa911155fefb5308ULL,
+	0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+	0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL,
+	0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+	0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL,
+	0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+	0xb749faed14125d36ULL, 0xcef980ec671f667bULL,
+	0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+	0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL,
+	0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+	0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL,
+	0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+	0xaecc49914078536dULL, 0x58fae9f773886e18ULL,
+	0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+	0x888f99797a5e012dULL, 0x6d8406c952429603ULL,
+	0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+	0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL,
+	0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+	0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL,
+	0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+	0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL,
+	0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+	0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL,
+	0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+	0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL,
+	0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+	0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL,
+	0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+	0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL,
+	0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+	0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL,
+	0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+	0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL,
+	0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+	0xb913179899f68584ULL, 0x28e2557b59846e3fULL,
+	0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+	0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL,
+	0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+	0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL,
+	0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+	0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL,
+	0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+	0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL,
+	0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+	0xd77485cb25823ac7ULL, 0x7d633293366b828bULL,
+	0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+	0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL,
+	0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+	0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL,
+	0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+	0xcd795be870516656ULL, 0x67902e276c921f8bULL,
+	0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+	0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL,
+	0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+	0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL,
+	0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+	0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL,
+	0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+	0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL,
+	0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+	0xef340a98172aace4ULL, 0x86fb897116c87c34ULL,
+	0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+	0xbae0a846d2195712ULL, 0x8974836059cca109ULL,
+	0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+	0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL,
+	0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+	0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL,
+	0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+	0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL,
+	0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+	0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL,
+	0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+	0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL,
+	0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+	0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL,
+	0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+	0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL,
+	0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+	0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL,
+	0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+	0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL,
+	0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+	0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL,
+	0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+	0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL,
+	0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+	0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL,
+	0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+	0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL,
+	0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+	0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL,
+	0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+	0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL,
+	0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+	0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL,
+	0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+	0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL,
+	0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+	0x8c974f7383725573ULL, 0x1e414218c73a13fbULL,
+	0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+	0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL,
+	0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+	0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL,
+	0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+	0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL,
+	0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+	0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL,
+	0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+	0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL,
+	0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+	0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL,
+	0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+	0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL,
+	0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+	0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL,
+	0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+	0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL,
+	0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+	0xbe89523386091465ULL, 0xf6bbb397f1135823ULL,
+	0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+	0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL,
+	0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+	0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL,
+	0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+	0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL,
+	0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+	0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL,
+	0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+	0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL,
+	0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+	0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL,
+	0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+	0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL,
+	0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+	0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL,
+	0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+	0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL,
+	0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+	0x811ccc668829b887ULL, 0x0806357d5a3f525fULL,
+	0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+	0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL,
+	0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+	0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL,
+	0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+	0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL,
+	0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+	0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL,
+	0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+	0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL,
+	0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+	0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL,
+	0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+	0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL,
+	0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+	0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL,
+	0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+	0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL,
+	0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+	0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL,
+	0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+	0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL,
+	0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+	0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL,
+	0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+	0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL,
+	0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+	0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL,
+	0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+	0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL,
+	0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+	0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL,
+	0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+	0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL,
+	0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+	0xc24452da229b021bULL, 0xfbe85badce996168ULL,
+	0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+	0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL,
+	0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+	0xed246723473e3813ULL, 0x290123e9aab23b68ULL,
+	0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+	0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL,
+	0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+	0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL,
+	0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+	0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL,
+	0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+	0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL,
+	0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+	0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL,
+	0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+	0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL,
+	0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+	0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+	0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+	0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+	0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+	0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+	0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+	0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+	0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+	0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+	0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+	0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+	0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+	0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+	0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+	0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+	0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+	0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+	0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+	0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+	0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+	0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+	0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+	0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+	0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+	0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+	0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+	0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+	0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+	0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+	0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+	0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+	0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+	0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+	0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+	0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+	0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+	0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+	0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+	0xc612062576589ddaULL, 0x95364afe032a819eULL,
+	0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+	0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+	0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+	0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+	0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+	0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+	0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+	0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+	0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+	0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+	0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+	0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+	0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+	0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+	0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+	0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+	0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+	0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+	0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+	0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+	0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+	0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+	0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+	0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+	0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+	0x8000000000000000ULL, 0x0000000000000000ULL,
+	0xa000000000000000ULL, 0x0000000000000000ULL,
+	0xc800000000000000ULL, 0x0000000000000000ULL,
+	0xfa00000000000000ULL, 0x0000000000000000ULL,
+	0x9c40000000000000ULL, 0x0000000000000000ULL,
+	0xc350000000000000ULL, 0x0000000000000000ULL,
+	0xf424000000000000ULL, 0x0000000000000000ULL,
+	0x9896800000000000ULL, 0x0000000000000000ULL,
+	0xbebc200000000000ULL, 0x0000000000000000ULL,
+	0xee6b280000000000ULL, 0x0000000000000000ULL,
+	0x9502f90000000000ULL, 0x0000000000000000ULL,
+	0xba43b74000000000ULL, 0x0000000000000000ULL,
+	0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+	0x9184e72a00000000ULL, 0x0000000000000000ULL,
+	0xb5e620f480000000ULL, 0x0000000000000000ULL,
+	0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+	0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+	0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+	0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+	0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+	0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+	0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+	0x878678326eac9000ULL, 0x0000000000000000ULL,
+	0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+	0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+	0x84595161401484a0ULL, 0x0000000000000000ULL,
+	0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+	0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+	0x813f3978f8940984ULL, 0x4000000000000000ULL,
+	0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+	0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+	0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+	0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+	0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+	0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+	0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+	0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+	0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+	0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+	0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+	0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL,
+	0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+	0xb7abc627050305adULL, 0xf14a3d9e40000000ULL,
+	0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+	0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL,
+	0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+	0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL,
+	0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+	0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL,
+	0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+	0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL,
+	0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+	0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL,
+	0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+	0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL,
+	0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+	0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL,
+	0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+	0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL,
+	0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+	0x9f4f2726179a2245ULL, 0x01d762422c946590ULL,
+	0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+	0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL,
+	0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+	0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL,
+	0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+	0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL,
+	0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+	0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL,
+	0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+	0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL,
+	0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+	0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL,
+	0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+	0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL,
+	0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+	0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL,
+	0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+	0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL,
+	0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+	0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL,
+	0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+	0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL,
+	0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+	0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL,
+	0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+	0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL,
+	0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+	0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL,
+	0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+	0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL,
+	0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+	0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL,
+	0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+	0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL,
+	0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+	0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL,
+	0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+	0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL,
+	0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+	0x924d692ca61be758ULL, 0x593c2626705f9c56ULL,
+	0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+	0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL,
+	0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+	0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL,
+	0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+	0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL,
+	0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+	0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL,
+	0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+	0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL,
+	0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+	0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL,
+	0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+	0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL,
+	0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+	0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL,
+	0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+	0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL,
+	0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+	0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL,
+	0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+	0x9ae757596946075fULL, 0x3375788de9b06958ULL,
+	0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+	0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL,
+	0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+	0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL,
+	0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+	0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL,
+	0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+	0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL,
+	0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+	0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL,
+	0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+	0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL,
+	0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+	0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL,
+	0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+	0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL,
+	0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+	0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL,
+	0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+	0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL,
+	0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+	0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL,
+	0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+	0x802221226be55a64ULL, 0xc2494954da2c9789ULL,
+	0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+	0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL,
+	0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+	0x9c69a97284b578d7ULL, 0xff2a760414536efbULL,
+	0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+	0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL,
+	0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+	0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL,
+	0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+	0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL,
+	0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+	0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL,
+	0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+	0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL,
+	0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+	0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL,
+	0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+	0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL,
+	0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+	0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL,
+	0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+	0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL,
+	0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+	0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL,
+	0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+	0xa59bc234db398c25ULL, 0x43fab9837e699095ULL,
+	0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+	0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL,
+	0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+	0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL,
+	0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+	0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL,
+	0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+	0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL,
+	0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+	0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL,
+	0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+	0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL,
+	0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+	0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL,
+	0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+	0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL,
+	0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+	0x8fa475791a569d10ULL, 0xf96e017d694487bcULL,
+	0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+	0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL,
+	0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+	0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL,
+	0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+	0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL,
+	0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+	0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL,
+	0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+	0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL,
+	0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+	0x82a45b450226b39cULL, 0xecc0024661173473ULL,
+	0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+	0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL,
+	0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+	0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL,
+	0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+	0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL,
+	0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+	0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL,
+	0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+	0x98165af37b2153deULL, 0xc3727a337a8b704aULL,
+	0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+	0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL,
+	0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+	0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL,
+	0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+	0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL,
+	0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+	0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL,
+	0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+	0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL,
+	0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+	0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL,
+	0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+	0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL,
+	0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+	0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL,
+	0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+	0x83ea2b892091e44dULL, 0x934aed0aab460432ULL,
+	0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+	0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL,
+	0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+	0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL,
+	0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+	0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL,
+	0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+	0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL,
+	0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+	0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL,
+	0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+	0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL,
+	0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+	0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL,
+	0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+	0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL,
+	0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+	0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL,
+	0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+	0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL,
+	0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+	0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL,
+	0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+	0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL,
+	0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+	0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL,
+	0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+	0x8533285c936b35deULL, 0xd53a88958f87275fULL,
+	0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+	0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL,
+	0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+	0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL,
+	0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+	0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL,
+	0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+	0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL,
+	0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+	0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL,
+	0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+	0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL,
+	0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+	0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL,
+	0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+	0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL,
+	0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+	0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL,
+	0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+	0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL,
+	0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+	0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL,
+	0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+	0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL,
+	0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+	0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL,
+	0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+	0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL,
+	0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+	0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL,
+	0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+	0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL,
+	0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+	0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL,
+	0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+	0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL,
+	0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+	0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL,
+	0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+	0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL,
+	0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+	0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL,
+	0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+	0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL,
+	0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+	0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL,
+	0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+	0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL,
+	0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+	0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL
+};
+
+#define STRING_POW5_MIN -342
+#define STRING_POW5_MAX 308
+
+static FOUNDATION_FORCEINLINE uint64_t
+_string_load_eight(const char* str) {
+	uint64_t val;
+	memcpy(&val, str, sizeof(val));
+	return byteorder_littleendian64(val);
+}
+
+static FOUNDATION_FORCEINLINE bool
+_string_is_eight_digits(uint64_t val) {
+	return !(((val + 0x4646464646464646ULL) | (val - 0x3030303030303030ULL)) &
+	         0x8080808080808080ULL);
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+_string_parse_eight_digits(uint64_t val) {
+	const uint64_t mask = 0x000000FF000000FFULL;
+	const uint64_t mul1 = 100ULL + (1000000ULL << 32);
+	const uint64_t mul2 = 1ULL + (10000ULL << 32);
+	val -= 0x3030303030303030ULL;
+	val = (val * 10) + (val >> 8);
+	return (uint32_t)((((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32);
+}
+
+static size_t
+_string_skip_sign(const char* val, size_t length, size_t pos, bool* negative) {
+	while ((pos < length) && ((val[pos] == ' ') || ((unsigned int)(val[pos] - '\t') < 5)))
+		++pos;
+	*negative = false;
+	if ((pos < length) && ((val[pos] == '-') || (val[pos] == '+'))) {
+		*negative = (val[pos] == '-');
+		++pos;
+	}
+	return pos;
+}
+
+//Parse unsigned integer, saturating to UINT64_MAX on overflow
+static uint64_t
+_string_parse_unsigned(const char* val, size_t length, bool hex, bool* negative) {
+	uint64_t ret = 0;
+	size_t pos = _string_skip_sign(val, length, 0, negative);
+	if (hex) {
+		int digit;
+		if ((pos + 2 < length) && (val[pos] == '0') && ((val[pos + 1] | 0x20) == 'x') &&
+		        (_string_hex_value(val[pos + 2]) >= 0))
+			pos += 2;
+		while ((pos < length) && ((digit = _string_hex_value(val[pos])) >= 0)) {
+			if (ret >> 60)
+				return UINT64_MAX;
+			ret = (ret << 4) | (uint64_t)digit;
+			++pos;
+		}
+		return ret;
+	}
+	//Sixteen digits are always safe from overflow
+	while ((pos + 8 <= length) && (ret < 100000000ULL)) {
+		uint64_t eight = _string_load_eight(val + pos);
+		if (!_string_is_eight_digits(eight))
+			break;
+		ret = (ret * 100000000ULL) + _string_parse_eight_digits(eight);
+		pos += 8;
+	}
+	while ((pos < length) && _string_is_digit(val[pos])) {
+		uint64_t digit = (uint64_t)(val[pos] - '0');
+		if (ret > (UINT64_MAX - digit) / 10)
+			return UINT64_MAX;
+		ret = (ret * 10) + digit;
+		++pos;
 	}
 	return ret;
 }
 
+static FOUNDATION_FORCEINLINE uint64_t
+_string_multiply_high(uint64_t a, uint64_t b, uint64_t* low) {
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 string_uint128_t;
+	string_uint128_t product = (string_uint128_t)a * b;
+	*low = (uint64_t)product;
+	return (uint64_t)(product >> 64);
+#elif FOUNDATION_COMPILER_MSVC && FOUNDATION_ARCH_X86_64
+	uint64_t high;
+	*low = _umul128(a, b, &high);
+	return high;
+#else
+	const uint64_t mask = 0xFFFFFFFFULL;
+	const uint64_t ad = (a >> 32) * (b & mask), bc = (a & mask) * (b >> 32);
+	const uint64_t bd = (a & mask) * (b & mask);
+	const uint64_t mid = (bd >> 32) + (ad & mask) + (bc & mask);
+	*low = (mid << 32) | (bd & mask);
+	return ((a >> 32) * (b >> 32)) + (ad >> 32) + (bc >> 32) + (mid >> 32);
+#endif
+}
+
+typedef struct {
+	int mantissa_bits;
+	int minimum_exponent;
+	int infinite_power;
+	int smallest_power;
+	int largest_power;
+	int min_round_to_even;
+	int max_round_to_even;
+} string_float_format_t;
+
+static const string_float_format_t _string_format_float64 = {52, -1023, 0x7FF, -342, 308, -4, 23};
+static const string_float_format_t _string_format_float32 = {23, -127, 0xFF, -65, 38, -17, 10};
+
+//Convert w * 10^q to a binary floating point value, returning the biased exponent and
+//storing the mantissa without the hidden bit
+static int
+_string_eisel_lemire(const string_float_format_t* format, int64_t q, uint64_t w,
+                     uint64_t* mantissa) {
+	uint64_t high, low, second_high, second_low;
+	const uint64_t* pow5;
+	uint64_t precision_mask;
+	int lz, upperbit, shift, power2;
+
+	if (!w || (q < format->smallest_power)) {
+		*mantissa = 0;
+		return 0;
+	}
+	if (q > format->largest_power) {
+		*mantissa = 0;
+		return format->infinite_power;
+	}
+
+	lz = 63 - (int)_string_search_last_bit(w);
+	w <<= lz;
+
+	pow5 = _string_pow5_128 + (2 * (q - STRING_POW5_MIN));
+	high = _string_multiply_high(w, pow5[0], &low);
+	precision_mask = UINT64_MAX >> (format->mantissa_bits + 3);
+	if ((high & precision_mask) == precision_mask) {
+		second_high = _string_multiply_high(w, pow5[1], &second_low);
+		low += second_high;
+		if (second_high > low)
+			++high;
+	}
+
+	upperbit = (int)(high >> 63);
+	shift = upperbit + 64 - format->mantissa_bits - 3;
+	*mantissa = high >> shift;
+	power2 = (int)(((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - format->minimum_exponent;
+
+	if (power2 <= 0) {
+		//Subnormal
+		if (-power2 + 1 >= 64) {
+			*mantissa = 0;
+			return 0;
+		}
+		*mantissa >>= -power2 + 1;
+		*mantissa += (*mantissa & 1);
+		*mantissa >>= 1;
+		power2 = (*mantissa < (1ULL << format->mantissa_bits)) ? 0 : 1;
+		*mantissa &= ~(1ULL << format->mantissa_bits);
+		return power2;
+	}
+
+	//Round half to even when exactly in between
+	if ((low <= 1) && (q >= format->min_round_to_even) && (q <= format->max_round_to_even) &&
+	        ((*mantissa & 3) == 1) && ((*mantissa << shift) == high))
+		*mantissa &= ~1ULL;
+	*mantissa += (*mantissa & 1);
+	*mantissa >>= 1;
+	if (*mantissa >= (2ULL << format->mantissa_bits)) {
+		*mantissa = (1ULL << format->mantissa_bits);
+		++power2;
+	}
+	*mantissa &= ~(1ULL << format->mantissa_bits);
+	if (power2 >= format->infinite_power) {
+		*mantissa = 0;
+		return format->infinite_power;
+	}
+	return power2;
+}
+
+static bool
+_string_match_nocase(const char* val, size_t length, const char* match, size_t match_length) {
+	size_t i;
+	if (length < match_length)
+		return false;
+	for (i = 0; i < match_length; ++i) {
+		if ((val[i] | 0x20) != match[i])
+			return false;
+	}
+	return true;
+}
+
+//Parse a floating point number into sign, exponent and mantissa bits
+static uint64_t
+_string_parse_float(const char* val, size_t length, const string_float_format_t* format,
+                    bool* negative, int* power2) {
+	const char* str;
+	const char* end = val + length;
+	const char* digits;
+	const char* integer_end;
+	const char* fraction = 0;
+	uint64_t w = 0;
+	uint64_t mantissa, mantissa_next;
+	int64_t exponent = 0;
+	int64_t digit_count;
+	size_t pos;
+
+	pos = _string_skip_sign(val, length, 0, negative);
+	str = val + pos;
+	if (_string_match_nocase(str, (size_t)(end - str), "inf", 3)) {
+		*power2 = format->infinite_power;
+		return 0;
+	}
+	if (_string_match_nocase(str, (size_t)(end - str), "nan", 3)) {
+		*power2 = format->infinite_power;
+		return 1ULL << (format->mantissa_bits - 1);
+	}
+	if ((str + 1 < end) && (str[0] == '0') && ((str[1] | 0x20) == 'x')) {
+		*power2 = -1;
+		return 0;
+	}
+
+	digits = str;
+	while ((str + 8 <= end) && _string_is_eight_digits(_string_load_eight(str))) {
+		w = (w * 100000000ULL) + _string_parse_eight_digits(_string_load_eight(str));
+		str += 8;
+	}
+	while ((str < end) && _string_is_digit(*str))
+		w = (w * 10) + (uint64_t)(*str++ - '0');
+	integer_end = str;
+	digit_count = integer_end - digits;
+
+	if ((str < end) && (*str == '.')) {
+		fraction = ++str;
+		while ((str + 8 <= end) && _string_is_eight_digits(_string_load_eight(str))) {
+			w = (w * 100000000ULL) + _string_parse_eight_digits(_string_load_eight(str));
+			str += 8;
+		}
+		while ((str < end) && _string_is_digit(*str))
+			w = (w * 10) + (uint64_t)(*str++ - '0');
+		exponent = fraction - str;
+		digit_count -= exponent;
+	}
+	if (!digit_count) {
+		*negative = false;
+		*power2 = 0;
+		return 0;
+	}
+
+	if ((str < end) && ((*str | 0x20) == 'e')) {
+		const char* exp = str + 1;
+		bool exp_negative = false;
+		int64_t exp_number = 0;
+		if ((exp < end) && ((*exp == '-') || (*exp == '+')))
+			exp_negative = (*exp++ == '-');
+		if ((exp < end) && _string_is_digit(*exp)) {
+			while ((exp < end) && _string_is_digit(*exp)) {
+				if (exp_number < 0x10000000)
+					exp_number = (exp_number * 10) + (*exp - '0');
+				++exp;
+			}
+			exponent += exp_negative ? -exp_number : exp_number;
+		}
+	}
+
+	if (digit_count > 19) {
+		//Leading zeros are not significant
+		const char* start = digits;
+		while ((start < str) && ((*start == '0') || (*start == '.'))) {
+			if (*start == '0')
+				--digit_count;
+			++start;
+		}
+		if (digit_count > 19) {
+			//Keep the first 19 significant digits and check if the remaining digits can affect
+			//rounding by converting both the truncated value and the next value up
+			const uint64_t minimal_nineteen_digits = 1000000000000000000ULL;
+			const char* ptr = digits;
+			int64_t explicit_exponent = exponent + (fraction ? (str - fraction) : 0);
+			w = 0;
+			while ((w < minimal_nineteen_digits) && (ptr != integer_end))
+				w = (w * 10) + (uint64_t)(*ptr++ - '0');
+			if (w >= minimal_nineteen_digits) {
+				exponent = (integer_end - ptr) + explicit_exponent;
+			}
+			else {
+				ptr = fraction;
+				while ((w < minimal_nineteen_digits) && (ptr != str))
+					w = (w * 10) + (uint64_t)(*ptr++ - '0');
+				exponent = (fraction - ptr) + explicit_exponent;
+			}
+			*power2 = _string_eisel_lemire(format, exponent, w, &mantissa);
+			if ((_string_eisel_lemire(format, exponent, w + 1, &mantissa_next) != *power2) ||
+			        (mantissa_next != mantissa))
+				*power2 = -1;
+			return mantissa;
+		}
+	}
+
+	*power2 = _string_eisel_lemire(format, exponent, w, &mantissa);
+	return mantissa;
+}
+
+int
+string_to_int(const char* val, size_t length) {
+	return (int)string_to_int64(val, length);
+}
+
 unsigned int
 string_to_uint(const char* val, size_t length, bool hex) {
-	unsigned int ret = 0;
-	char buf[16];
-	if (length) {
-		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, hex ? "%x" : "%u", &ret);
-	}
-	return ret;
+	bool negative;
+	uint64_t ret = _string_parse_unsigned(val, length, hex, &negative);
+	return negative ? (unsigned int)(0 - ret) : (unsigned int)ret;
 }
 
 int64_t
 string_to_int64(const char* val, size_t length) {
-	int64_t ret = 0;
-	char buf[32];
-	if (length) {
-		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, "%" PRId64, &ret);
-	}
-	return ret;
+	bool negative;
+	uint64_t ret = _string_parse_unsigned(val, length, false, &negative);
+	if (negative)
+		return (ret > (uint64_t)INT64_MAX) ? INT64_MIN : -(int64_t)ret;
+	return (ret > (uint64_t)INT64_MAX) ? INT64_MAX : (int64_t)ret;
 }
 
 uint64_t
 string_to_uint64(const char* val, size_t length, bool hex) {
-	uint64_t ret = 0;
-	char buf[32];
-	if (length) {
-		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, hex ? "%" PRIx64 : "%" PRIu64, &ret);
-	}
-	return ret;
+	bool negative;
+	uint64_t ret = _string_parse_unsigned(val, length, hex, &negative);
+	return (negative && (ret != UINT64_MAX)) ? (0 - ret) : ret;
 }
 
 uint128_t
 string_to_uint128(const char* val, size_t length) {
 	uint128_t ret = uint128_null();
 	char buf[64];
-	if (length) {
+	if ((length >= 32) && (string_hex_decode(val, 32, ret.word, sizeof(ret.word)) == 16)) {
+		ret.word[0] = byteorder_bigendian64(ret.word[0]);
+		ret.word[1] = byteorder_bigendian64(ret.word[1]);
+	}
+	else if (length) {
+		ret = uint128_null();
 		string_copy(buf, sizeof(buf), val, length);
 		sscanf(buf, "%016" PRIx64 "%016" PRIx64, &ret.word[0], &ret.word[1]);
 	}
@@ -1639,35 +4110,45 @@ string_to_uint128(const char* val, size_t length) {
 
 float32_t
 string_to_float32(const char* val, size_t length) {
-	float32_t ret = 0.0f;
-	char buf[32];
-	if (length) {
+	float32_cast_t ret;
+	bool negative;
+	int power2;
+	uint64_t mantissa = _string_parse_float(val, length, &_string_format_float32, &negative,
+	                                        &power2);
+	if (power2 < 0) {
+		//Hexadecimal or ambiguous rounding of very long input, use the library conversion
+		char buf[512];
 		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, "%f", &ret);
+		return strtof(buf, 0);
 	}
-	return ret;
+	ret.uival = (uint32_t)mantissa | ((uint32_t)power2 << 23) | (negative ? 0x80000000U : 0);
+	return ret.fval;
 }
 
 float64_t
 string_to_float64(const char* val, size_t length) {
-	float64_t ret = 0.0;
-	char buf[64];
-	if (length) {
+	float64_cast_t ret;
+	bool negative;
+	int power2;
+	uint64_t mantissa = _string_parse_float(val, length, &_string_format_float64, &negative,
+	                                        &power2);
+	if (power2 < 0) {
+		//Hexadecimal or ambiguous rounding of very long input, use the library conversion
+		char buf[512];
 		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, "%lf", &ret);
+		return strtod(buf, 0);
 	}
-	return ret;
+	ret.uival = mantissa | ((uint64_t)power2 << 52) | (negative ? 0x8000000000000000ULL : 0);
+	return ret.fval;
 }
 
 real
 string_to_real(const char* val, size_t length) {
-	real ret = 0.0f;
-	char buf[64];
-	if (length) {
-		string_copy(buf, sizeof(buf), val, length);
-		sscanf(buf, "%" PRIreal, &ret);
-	}
-	return ret;
+#if FOUNDATION_SIZE_REAL == 8
+	return string_to_float64(val, length);
+#else
+	return string_to_float32(val, length);
+#endif
 }
 
 version_t
@@ -1692,8 +4173,133 @@ string_to_version(const char* val, size_t length) {
 	return version_make(0, 0, 0, 0, 0);
 }
 
+#define STRING_BUILDER_MIN_CAPACITY 32
+
+string_builder_t*
+string_builder_allocate(size_t capacity) {
+	string_builder_t* builder = memory_allocate(HASH_STRING, sizeof(string_builder_t), 0,
+	                                            MEMORY_PERSISTENT);
+	string_builder_initialize(builder, capacity);
+	return builder;
+}
+
+void
+string_builder_deallocate(string_builder_t* builder) {
+	if (builder)
+		string_builder_finalize(builder);
+	memory_deallocate(builder);
+}
+
+void
+string_builder_initialize(string_builder_t* builder, size_t capacity) {
+	memset(builder, 0, sizeof(string_builder_t));
+	if (capacity)
+		string_builder_reserve(builder, capacity - 1);
+}
+
+void
+string_builder_finalize(string_builder_t* builder) {
+	memory_deallocate(builder->str);
+	memset(builder, 0, sizeof(string_builder_t));
+}
+
+void
+string_builder_reserve(string_builder_t* builder, size_t length) {
+	size_t capacity;
+	if (length < builder->capacity)
+		return;
+	//Geometric growth gives amortized constant time appends
+	capacity = builder->capacity * 2;
+	if (capacity < length + 1)
+		capacity = length + 1;
+	if (capacity < STRING_BUILDER_MIN_CAPACITY)
+		capacity = STRING_BUILDER_MIN_CAPACITY;
+	if (builder->str)
+		builder->str = memory_reallocate(builder->str, capacity, 0, builder->length + 1);
+	else
+		builder->str = memory_allocate(HASH_STRING, capacity, 0, MEMORY_PERSISTENT);
+	builder->str[builder->length] = 0;
+	builder->capacity = capacity;
+}
+
+void
+string_builder_append(string_builder_t* builder, const char* str, size_t length) {
+	string_builder_reserve(builder, builder->length + length);
+	if (length)
+		memcpy(builder->str + builder->length, str, length);
+	builder->length += length;
+	builder->str[builder->length] = 0;
+}
+
+void
+string_builder_append_char(string_builder_t* builder, char c) {
+	string_builder_reserve(builder, builder->length + 1);
+	builder->str[builder->length++] = c;
+	builder->str[builder->length] = 0;
+}
+
+void
+string_builder_append_format(string_builder_t* builder, const char* format, size_t length, ...) {
+	va_list list;
+	va_start(list, length);
+	string_builder_append_vformat(builder, format, length, list);
+	va_end(list);
+}
+
+void
+string_builder_append_vformat(string_builder_t* builder, const char* format, size_t length,
+                              va_list list) {
+	va_list copy_list;
+	size_t available;
+	int n;
+
+	if (!length)
+		return;
+	FOUNDATION_ASSERT(format);
+
+	string_builder_reserve(builder, builder->length + length);
+	while (true) {
+		//Format directly into the spare capacity, retry with the required size if truncated
+		available = builder->capacity - builder->length;
+		va_copy(copy_list, list);
+		n = vsnprintf(builder->str + builder->length, available, format, copy_list);
+		va_end(copy_list);
+
+		if ((n > -1) && ((size_t)n < available))
+			break;
+
+		string_builder_reserve(builder, builder->length + ((n > -1) ? (size_t)n : (available * 2)));
+	}
+
+	builder->length += (size_t)n;
+}
+
+void
+string_builder_clear(string_builder_t* builder) {
+	builder->length = 0;
+	if (builder->str)
+		builder->str[0] = 0;
+}
+
+string_const_t
+string_builder_string(const string_builder_t* builder) {
+	if (!builder->str)
+		return string_empty();
+	return string_const(builder->str, builder->length);
+}
+
+string_t
+string_builder_take(string_builder_t* builder) {
+	string_t str;
+	if (!builder->str)
+		string_builder_reserve(builder, 0);
+	str = string(builder->str, builder->length);
+	memset(builder, 0, sizeof(string_builder_t));
+	return str;
+}
+
 string_t
 string_thread_buffer(void) {
-	char* buffer = get_thread_convert_buffer();
+	char* buffer = _string_thread_buffer();
 	return (string_t) {buffer, THREAD_BUFFER_SIZE};
 }
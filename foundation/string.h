@@ -173,6 +173,14 @@ invalid utf-8 sequences, even with incomplete sequences at end of string.
 FOUNDATION_API size_t
 string_glyphs(const char* str, size_t length);
 
+/*! Validate utf-8 encoding of string. Rejects truncated sequences, overlong encodings,
+surrogate halves and glyphs above 0x10FFFF.
+\param str String in utf-8 encoding
+\param length Length of string
+\return true if string is valid utf-8, false if not */
+FOUNDATION_API bool
+string_validate_utf8(const char* str, size_t length);
+
 /*! Calculate hash of string.
 \param str String
 \param length Length of string
@@ -180,6 +188,15 @@ string_glyphs(const char* str, size_t length);
 FOUNDATION_API hash_t
 string_hash(const char* str, size_t length);
 
+/*! Calculate hash of string ignoring case of ascii characters, equal to the #string_hash of the
+string converted to lower case. Strings equal according to #string_equal_nocase have equal
+case insensitive hashes.
+\param str String
+\param length Length of string
+\return Case insensitive hash of string */
+FOUNDATION_API hash_t
+string_hash_nocase(const char* str, size_t length);
+
 /*! Copy one string to another. Like strlcpy in that dst will always be zero terminated,
 i.e copies at most (capacity-1) characters from source string. Safe to pass null
 pointers in both pointer arguments.
@@ -602,6 +619,27 @@ FOUNDATION_API size_t
 string_explode(const char* str, size_t length, const char* delimiters, size_t delim_length,
                string_const_t* arr, size_t arrsize, bool allow_empty);
 
+/*! Initialize a tokenizer iterating over the substrings of a string along given separator
+characters without allocating memory. The tokens are the same substrings #string_explode
+would store, get them in order with #string_tokenizer_next. The tokenizer references the
+source string, which must remain valid while tokens are iterated.
+\param tokenizer Tokenizer
+\param str Source string
+\param length Length of source string
+\param delimiters Separator characters
+\param delim_length Length of separator characters
+\param allow_empty Flag to include empty substrings if true, ignore if false */
+FOUNDATION_API void
+string_tokenizer_initialize(string_tokenizer_t* tokenizer, const char* str, size_t length,
+                            const char* delimiters, size_t delim_length, bool allow_empty);
+
+/*! Get next token from a tokenizer
+\param tokenizer Tokenizer
+\param token Receives the token
+\return true if a token was stored, false if all tokens have been consumed */
+FOUNDATION_API bool
+string_tokenizer_next(string_tokenizer_t* tokenizer, string_const_t* token);
+
 /*! Merge a string array using the given separator string
 \param dst Destination string buffer
 \param capacity Capacity of the destination buffer
@@ -674,6 +712,43 @@ will be reset to null.
   array_deallocate( array ); \
   (array) = 0
 
+/*! Allocate a hashed string set from an array of strings. The strings are copied to storage
+owned by the set, the array can be released after the call. Deallocate the set with a call to
+#string_set_deallocate.
+\param strings Array of strings
+\param count Number of strings in array
+\return New string set */
+FOUNDATION_API string_set_t*
+string_set_allocate(const string_const_t* strings, size_t count);
+
+/*! Deallocate a string set and the string storage
+\param set String set */
+FOUNDATION_API void
+string_set_deallocate(string_set_t* set);
+
+/*! Initialize a hashed string set from an array of strings, see #string_set_allocate.
+Finalize the set with a call to #string_set_finalize.
+\param set String set
+\param strings Array of strings
+\param count Number of strings in array */
+FOUNDATION_API void
+string_set_initialize(string_set_t* set, const string_const_t* strings, size_t count);
+
+/*! Finalize a string set and free the string storage
+\param set String set */
+FOUNDATION_API void
+string_set_finalize(string_set_t* set);
+
+/*! Find a string in a string set with a single hashed lookup. The result is the same as
+calling #string_array_find on the array the set was built from.
+\param set String set
+\param str String to find
+\param length Length of string to find
+\return Index of first matching string in the array the set was built from, or <0 if no
+        string matching */
+FOUNDATION_API ssize_t
+string_set_find(const string_set_t* set, const char* str, size_t length);
+
 /*! Allocate a wide char string from utf-8 encoded string
 \param cstr Source utf-8 encoded string
 \param length Length of source string in bytes (NOT unicode glyphs)
@@ -788,11 +863,13 @@ FOUNDATION_API string_t
 string_from_uint128(char* str, size_t capacity, const uint128_t val);
 
 /*! Convert a float to a string, with optional fixed notation, field width, precision and
-fill character. String will be zero terminated.
+fill character. String will be zero terminated. With zero precision the shortest string that
+converts back to the same value is generated, in fixed notation for magnitudes in [1e-6,1e21)
+and exponent notation otherwise.
 \param str String buffer
 \param capacity Capacity of string buffer.
 \param val Float value
-\param precision Precision
+\param precision Precision, 0 for shortest round trip representation
 \param width Field width
 \param padding Fill character
 \return String in given buffer */
@@ -831,8 +908,8 @@ FOUNDATION_API string_t
 string_from_version(char* str, size_t capacity, const version_t version);
 
 /*! Convert an integer into a thread-local conversion buffer, with optional field width and
-fill character. The buffer is shared between all string_from_*_static functions and
-only valid until next call to one of these functions.
+fill character. The buffer is taken from the thread-local buffer ring, see
+#string_thread_buffer.
 \param val Integer value
 \param width Field width
 \param padding Fill character
@@ -841,9 +918,8 @@ FOUNDATION_API string_const_t
 string_from_int_static(int64_t val, unsigned int width, char padding);
 
 /*! Convert an unsigned integer into a thread-local conversion buffer, with optional
-hexadecimal base and base prefix, field width and fill character. The buffer is
-shared between all string_from_*_static functions and only valid until next call to one
-of these functions.
+hexadecimal base and base prefix, field width and fill character. The buffer is taken
+from the thread-local buffer ring, see #string_thread_buffer.
 \param val Integer value
 \param hex Hexadecimal flag
 \param width Field width
@@ -852,17 +928,16 @@ of these functions.
 FOUNDATION_API string_const_t
 string_from_uint_static(uint64_t val, bool hex, unsigned int width, char padding);
 
-/*! Convert an 128-bit unsigned integer into a thread-local conversion buffer. The
-buffer is shared between all string_from_*_static functions and only valid until next
-call to one of these functions.
+/*! Convert an 128-bit unsigned integer into a thread-local conversion buffer. The buffer is
+taken from the thread-local buffer ring, see #string_thread_buffer.
 \param val Integer value
 \return String in thread-local buffer */
 FOUNDATION_API string_const_t
 string_from_uint128_static(const uint128_t val);
 
 /*! Convert a float into a thread-local conversion buffer, with optional fixed notation,
-field width, precision and fill character. The buffer is shared between all
-string_from_*_static functions and only valid until next call to one of these functions.
+field width, precision and fill character. The buffer is taken from the thread-local buffer
+ring, see #string_thread_buffer.
 \param val Float value
 \param precision Precision
 \param width Field width
@@ -871,8 +946,8 @@ string_from_*_static functions and only valid until next call to one of these fu
 FOUNDATION_API string_const_t
 string_from_real_static(real val, unsigned int precision, unsigned int width, char padding);
 
-/*! Convert a timestamp into a thread-local conversion buffer. The buffer is shared between all
-string_from_*_static functions and only valid until next call to one of these functions.
+/*! Convert a timestamp into a thread-local conversion buffer. The buffer is taken from the
+thread-local buffer ring, see #string_thread_buffer.
 The string will be formetted like "Thu Jan 01 00:00:00 1970" and the timestamp is treated
 as either local time or as UTC (no local timezone is taken into consideration).
 String will be zero terminated.
@@ -882,16 +957,15 @@ String will be zero terminated.
 FOUNDATION_API string_const_t
 string_from_time_static(tick_t time, bool local);
 
-/*! Convert an UUID into a thread-local conversion buffer. The buffer is shared between all
-string_from_*_static functions and only valid until next call to one of these functions.
+/*! Convert an UUID into a thread-local conversion buffer. The buffer is taken from the
+thread-local buffer ring, see #string_thread_buffer.
 \param uuid UUID
 \return String in thread-local buffer */
 FOUNDATION_API string_const_t
 string_from_uuid_static(const uuid_t uuid);
 
-/*! Convert a version identifier into a thread-local conversion buffer. The buffer is shared
-between all string_from_*_static functions and only valid until next call to one of
-these functions.
+/*! Convert a version identifier into a thread-local conversion buffer. The buffer is taken
+from the thread-local buffer ring, see #string_thread_buffer.
 \param version Version
 \return String in thread-local buffer */
 FOUNDATION_API string_const_t
@@ -934,14 +1008,39 @@ string_to_uint64(const char* str, size_t length, bool hex);
 FOUNDATION_API uint128_t
 string_to_uint128(const char* str, size_t length);
 
-/*! Convert a string to a 32-bit float
+/*! Encode binary data as hex digits, two per byte with the high nibble first. Encodes as many
+bytes as fit in the buffer, and zero terminates the string if there is room left for the
+terminator. Data is encoded sixteen bytes at a time with vector instructions where available.
+\param str String buffer
+\param capacity Capacity of string buffer
+\param data Data to encode
+\param size Size of data in bytes
+\param uppercase Flag to use uppercase letters for digits above nine
+\return Hex string in given buffer */
+FOUNDATION_API string_t
+string_hex_encode(char* str, size_t capacity, const void* data, size_t size, bool uppercase);
+
+/*! Decode pairs of hex digits into binary data, accepting both upper and lower case letters.
+Decoding stops at the first pair containing a character that is not a hex digit, or when the
+data buffer is full. A trailing single digit is ignored.
+\param str Hex string
+\param length Length of string
+\param data Data buffer
+\param capacity Capacity of data buffer in bytes
+\return Number of bytes decoded */
+FOUNDATION_API size_t
+string_hex_decode(const char* str, size_t length, void* data, size_t capacity);
+
+/*! Convert a string to a 32-bit float. Conversion is locale independent and correctly rounded,
+accepting decimal and exponent notation as well as "inf" and "nan".
 \param str String
 \param length Length of string
 \return Floating point value, 0 if conversion failed */
 FOUNDATION_API float32_t
 string_to_float32(const char* str, size_t length);
 
-/*! Convert a string to a 64-bit float
+/*! Convert a string to a 64-bit float. Conversion is locale independent and correctly rounded,
+accepting decimal and exponent notation as well as "inf" and "nan".
 \param str String
 \param length Length of string
 \return Floating point value, 0 if conversion failed */
@@ -969,7 +1068,95 @@ string_to_uuid(const char* str, size_t length);
 FOUNDATION_API version_t
 string_to_version(const char* str, size_t length);
 
-/*! Thread local buffer for string operations and conversions.
+/*! Allocate a string builder with the given initial capacity. Deallocate the builder with
+a call to #string_builder_deallocate.
+\param capacity Initial capacity, zero to allocate on first append
+\return New string builder */
+FOUNDATION_API string_builder_t*
+string_builder_allocate(size_t capacity);
+
+/*! Deallocate a string builder and the string buffer
+\param builder String builder */
+FOUNDATION_API void
+string_builder_deallocate(string_builder_t* builder);
+
+/*! Initialize a string builder with the given initial capacity. Finalize the builder with
+a call to #string_builder_finalize, or take ownership of the string with
+#string_builder_take.
+\param builder String builder
+\param capacity Initial capacity, zero to allocate on first append */
+FOUNDATION_API void
+string_builder_initialize(string_builder_t* builder, size_t capacity);
+
+/*! Finalize a string builder and free the string buffer
+\param builder String builder */
+FOUNDATION_API void
+string_builder_finalize(string_builder_t* builder);
+
+/*! Make sure the builder can hold a string of the given length without reallocating
+\param builder String builder
+\param length String length to reserve storage for, not including zero terminator */
+FOUNDATION_API void
+string_builder_reserve(string_builder_t* builder, size_t length);
+
+/*! Append a string, growing the buffer if needed
+\param builder String builder
+\param str String to append
+\param length Length of string to append */
+FOUNDATION_API void
+string_builder_append(string_builder_t* builder, const char* str, size_t length);
+
+/*! Append a character, growing the buffer if needed
+\param builder String builder
+\param c Character to append */
+FOUNDATION_API void
+string_builder_append_char(string_builder_t* builder, char c);
+
+/*! Append a formatted string, printf style. The string is formatted directly into the
+builder buffer, growing the buffer if needed.
+\param builder String builder
+\param format Format specifier
+\param length Length of format specifier */
+FOUNDATION_API void
+string_builder_append_format(string_builder_t* builder, const char* format, size_t length, ...)
+FOUNDATION_PRINTFCALL(2, 4);
+
+/*! Append a formatted string with variable data given as a va_list, printf style, see
+#string_builder_append_format
+\param builder String builder
+\param format Format specifier
+\param length Length of format specifier
+\param list Variable argument list */
+FOUNDATION_API void
+string_builder_append_vformat(string_builder_t* builder, const char* format, size_t length,
+                              va_list list)
+FOUNDATION_PRINTFCALL(2, 0);
+
+/*! Clear the string, keeping the buffer for reuse
+\param builder String builder */
+FOUNDATION_API void
+string_builder_clear(string_builder_t* builder);
+
+/*! Get the current string of a builder. The string is valid until the next modifying call
+on the builder.
+\param builder String builder
+\return Current string, zero terminated */
+FOUNDATION_API string_const_t
+string_builder_string(const string_builder_t* builder);
+
+/*! Take ownership of the built string without copying. The builder is reset to an empty
+state and can be reused. The returned string must be freed with a call to
+#string_deallocate.
+\param builder String builder
+\return Built string, never null and always zero terminated */
+FOUNDATION_API string_t
+string_builder_take(string_builder_t* builder);
+
+/*! Thread local buffer for string operations and conversions. Each thread has a ring of
+#BUILD_THREAD_STRING_BUFFERS buffers of #BUILD_THREAD_STRING_BUFFER_SIZE bytes, shared with the
+string_from_*_static functions, and each call returns the next buffer in the ring. A returned
+buffer stays valid until the ring wraps around, so nested conversions in the same expression do
+not overwrite each other as long as they use no more buffers than the ring holds.
 \return String thread local buffer with size indicating capacity */
 FOUNDATION_API string_t
 string_thread_buffer(void);
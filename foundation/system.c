@@ -50,6 +50,36 @@ FOUNDATION_DECLARE_THREAD_LOCAL(char*, system_buffer, 0)
 static device_orientation_t _system_device_orientation = DEVICEORIENTATION_UNKNOWN;
 static event_stream_t* _system_event_stream;
 
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+//Topology is queried from the operating system on first use rather than at startup, state is
+//zero if not queried, one while querying and two once the tables are published
+static atomic32_t _system_topology_state;
+
+static void
+_system_topology_initialize(void);
+
+static void
+_system_topology_ensure(void) {
+	if (atomic_load32(&_system_topology_state) == 2) {
+		atomic_thread_fence_acquire();
+		return;
+	}
+	if (atomic_cas32(&_system_topology_state, 1, 0)) {
+		tick_t start = _time_system_ns();
+		_system_topology_initialize();
+		_foundation_subsystem_timing(STRING_CONST("system_topology"), start);
+		atomic_thread_fence_release();
+		atomic_store32(&_system_topology_state, 2);
+		return;
+	}
+	while (atomic_load32(&_system_topology_state) != 2)
+		thread_yield();
+	atomic_thread_fence_acquire();
+}
+
+#endif
+
 struct platform_info_t {
 	platform_t      platform;
 	architecture_t  architecture;
@@ -117,6 +147,17 @@ static const platform_info_t _platform_info = {
 #endif
 };
 
+//Host and user names are queried on first use and kept until invalidated
+#define SYSTEM_NAME_MAXLEN 256
+static char _system_hostname_buffer[SYSTEM_NAME_MAXLEN];
+static char _system_username_buffer[SYSTEM_NAME_MAXLEN];
+static string_const_t _system_hostname_cache;
+static string_const_t _system_username_cache;
+static atomic32_t _system_names_state;
+
+static void
+_system_names_ensure(void);
+
 static char*
 _system_buffer() {
 	char* buffer = get_thread_system_buffer();
@@ -142,15 +183,133 @@ system_byteorder() {
 	return _platform_info.byteorder;
 }
 
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+#define SYSTEM_CLASS_MAX 8
+
+//Rank core capacities into core classes, highest capacity being class 0
+static size_t
+_system_topology_classify(hardware_topology_t* topology, const unsigned int* capacity,
+                          size_t count) {
+	unsigned int level[SYSTEM_CLASS_MAX];
+	size_t levels = 0;
+	size_t ithread, ilevel, iclass;
+
+	for (ithread = 0; ithread < count; ++ithread) {
+		for (ilevel = 0; ilevel < levels; ++ilevel) {
+			if (level[ilevel] == capacity[ithread])
+				break;
+		}
+		if ((ilevel == levels) && (levels < SYSTEM_CLASS_MAX))
+			level[levels++] = capacity[ithread];
+	}
+
+	for (ithread = 0; ithread < count; ++ithread) {
+		iclass = 0;
+		for (ilevel = 0; ilevel < levels; ++ilevel) {
+			if (level[ilevel] > capacity[ithread])
+				++iclass;
+		}
+		topology[ithread].core_class = (unsigned int)iclass;
+	}
+
+	return levels ? levels : 1;
+}
+
+#endif
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 #include <foundation/windows.h>
 
 object_t _system_library_iphlpapi;
 
+static size_t              _system_core_count;
+static size_t              _system_class_count;
+static hardware_topology_t _system_thread_topology[64];
+
+static void
+_system_topology_initialize(void) {
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* buffer;
+	SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info;
+	unsigned int capacity[64];
+	size_t threads = system_hardware_threads();
+	size_t package_count = 0;
+	DWORD length = 0;
+	DWORD offset;
+	unsigned int ithread;
+
+	memset(capacity, 0, sizeof(capacity));
+	for (ithread = 0; ithread < 64; ++ithread) {
+		hardware_topology_t* topology = _system_thread_topology + ithread;
+		topology->core = ithread;
+		topology->core_mask = topology->l2_mask = (1ULL << ithread);
+		topology->l3_mask = (threads >= 64) ? ~0ULL : ((1ULL << threads) - 1);
+		topology->node = system_hardware_thread_node(ithread);
+	}
+	_system_core_count = threads;
+	_system_class_count = 1;
+
+	GetLogicalProcessorInformationEx(RelationAll, 0, &length);
+	if (!length)
+		return;
+	buffer = memory_allocate(0, length, 0, MEMORY_TEMPORARY);
+	if (!GetLogicalProcessorInformationEx(RelationAll, buffer, &length)) {
+		memory_deallocate(buffer);
+		return;
+	}
+
+	//Only processor group 0 is representable in hardware thread masks
+	_system_core_count = 0;
+	for (offset = 0; offset < length; offset += info->Size) {
+		uint64_t mask;
+		info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)pointer_offset(buffer, offset);
+		if (info->Relationship == RelationProcessorCore) {
+			mask = info->Processor.GroupMask[0].Group ? 0 : info->Processor.GroupMask[0].Mask;
+			for (ithread = 0; ithread < 64; ++ithread) {
+				if (!(mask & (1ULL << ithread)))
+					continue;
+				_system_thread_topology[ithread].core = (unsigned int)_system_core_count;
+				_system_thread_topology[ithread].core_mask = mask;
+				capacity[ithread] = info->Processor.EfficiencyClass;
+			}
+			++_system_core_count;
+		}
+		else if (info->Relationship == RelationProcessorPackage) {
+			mask = info->Processor.GroupMask[0].Group ? 0 : info->Processor.GroupMask[0].Mask;
+			for (ithread = 0; ithread < 64; ++ithread) {
+				if (mask & (1ULL << ithread))
+					_system_thread_topology[ithread].package = (unsigned int)package_count;
+			}
+			++package_count;
+		}
+		else if ((info->Relationship == RelationCache) &&
+		         ((info->Cache.Level == 2) || (info->Cache.Level == 3)) &&
+		         (info->Cache.Type != CacheInstruction)) {
+			mask = info->Cache.GroupMask.Group ? 0 : info->Cache.GroupMask.Mask;
+			for (ithread = 0; ithread < 64; ++ithread) {
+				if (!(mask & (1ULL << ithread)))
+					continue;
+				if (info->Cache.Level == 2)
+					_system_thread_topology[ithread].l2_mask = mask;
+				else
+					_system_thread_topology[ithread].l3_mask = mask;
+			}
+		}
+	}
+	memory_deallocate(buffer);
+
+	if (!_system_core_count)
+		_system_core_count = threads;
+	_system_class_count = _system_topology_classify(_system_thread_topology, capacity,
+	                                                (threads < 64) ? threads : 64);
+}
+
 int
 _system_initialize(void) {
 	_system_event_stream = event_stream_allocate(128);
+	atomic_store32(&_system_topology_state, 0);
+	atomic_store32(&_system_names_state, 0);
 	return 0;
 }
 
@@ -190,8 +349,8 @@ system_error_message(int code) {
 	return string_strip(errmsg, string_length(errmsg), STRING_CONST(STRING_WHITESPACE));
 }
 
-string_t
-system_hostname(char* buffer, size_t capacity) {
+static string_t
+_system_hostname_query(char* buffer, size_t capacity) {
 	DWORD size = (DWORD)capacity;
 	if (!GetComputerNameA(buffer, &size))
 		return string_copy(buffer, capacity, STRING_CONST("unknown"));
@@ -230,8 +389,8 @@ system_hostid(void) {
 	return *(uint64_t*)hostid;
 }
 
-string_t
-system_username(char* buffer, size_t capacity) {
+static string_t
+_system_username_query(char* buffer, size_t capacity) {
 	DWORD size = (DWORD)capacity;
 	if (!GetUserNameA(buffer, &size))
 		return string_copy(buffer, capacity, STRING_CONST("unknown"));
@@ -245,6 +404,52 @@ system_hardware_threads(void) {
 	return system_info.dwNumberOfProcessors;
 }
 
+size_t
+system_hardware_nodes(void) {
+	ULONG highest = 0;
+	if (!GetNumaHighestNodeNumber(&highest))
+		return 1;
+	return (size_t)highest + 1;
+}
+
+uint64_t
+system_hardware_node_mask(unsigned int node) {
+	ULONGLONG mask = 0;
+	if ((node > 0xFF) || !GetNumaNodeProcessorMask((UCHAR)node, &mask))
+		return 0;
+	return mask;
+}
+
+unsigned int
+system_hardware_thread_node(unsigned int hwthread) {
+	UCHAR node = 0;
+	if ((hwthread > 0xFF) || !GetNumaProcessorNode((UCHAR)hwthread, &node) || (node == 0xFF))
+		return 0;
+	return node;
+}
+
+size_t
+system_hardware_cores(void) {
+	_system_topology_ensure();
+	return _system_core_count ? _system_core_count : 1;
+}
+
+size_t
+system_hardware_core_classes(void) {
+	_system_topology_ensure();
+	return _system_class_count ? _system_class_count : 1;
+}
+
+hardware_topology_t
+system_hardware_topology(unsigned int hwthread) {
+	hardware_topology_t topology;
+	_system_topology_ensure();
+	if (hwthread < 64)
+		return _system_thread_topology[hwthread];
+	memset(&topology, 0, sizeof(topology));
+	return topology;
+}
+
 void
 system_process_events(void) {
 }
@@ -294,9 +499,228 @@ _system_user_locale(void) {
 #    include <ifaddrs.h>
 #  endif
 
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+#define SYSTEM_NODE_MAX        64
+#define SYSTEM_THREAD_MAX      1024
+
+static size_t              _system_node_count;
+static uint64_t            _system_node_mask[SYSTEM_NODE_MAX];
+static size_t              _system_core_count;
+static size_t              _system_class_count;
+static hardware_topology_t _system_thread_topology[SYSTEM_THREAD_MAX];
+
+static bool
+_system_read_file(const char* path, char* buffer, size_t capacity) {
+	ssize_t read_size;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	read_size = read(fd, buffer, capacity - 1);
+	close(fd);
+	if (read_size <= 0)
+		return false;
+	buffer[read_size] = 0;
+	return true;
+}
+
+//Parse a kernel list format string like "0-3,8,10-11" into a bit array
+static void
+_system_parse_list(const char* list, uint64_t* bits, unsigned int count) {
+	const char* cur = list;
+	while (*cur) {
+		char* end;
+		unsigned long first, last;
+		first = strtoul(cur, &end, 10);
+		if (end == cur)
+			break;
+		last = first;
+		if (*end == '-') {
+			cur = end + 1;
+			last = strtoul(cur, &end, 10);
+			if (end == cur)
+				break;
+		}
+		for (; (first <= last) && (first < count); ++first)
+			bits[first / 64] |= (1ULL << (first % 64));
+		cur = end;
+		if (*cur != ',')
+			break;
+		++cur;
+	}
+}
+
+static unsigned long
+_system_read_value(const char* path, unsigned long fallback) {
+	char buffer[32];
+	char* end;
+	unsigned long value;
+	if (!_system_read_file(path, buffer, sizeof(buffer)))
+		return fallback;
+	value = strtoul(buffer, &end, 10);
+	return (end != buffer) ? value : fallback;
+}
+
+static bool
+_system_read_mask(const char* path, uint64_t* mask) {
+	char buffer[1024];
+	uint64_t bits[SYSTEM_THREAD_MAX / 64];
+	if (!_system_read_file(path, buffer, sizeof(buffer)))
+		return false;
+	memset(bits, 0, sizeof(bits));
+	_system_parse_list(buffer, bits, SYSTEM_THREAD_MAX);
+	*mask = bits[0];
+	return true;
+}
+
+static void
+_system_topology_initialize_cpu(void) {
+	char buffer[1024];
+	char path[128];
+	uint64_t online[SYSTEM_THREAD_MAX / 64];
+	unsigned int core_id[SYSTEM_THREAD_MAX];
+	unsigned int capacity[SYSTEM_THREAD_MAX];
+	unsigned int ithread, iother, icache, count = 0;
+
+	_system_core_count = 0;
+	memset(capacity, 0, sizeof(capacity));
+	memset(online, 0, sizeof(online));
+	if (_system_read_file("/sys/devices/system/cpu/online", buffer, sizeof(buffer))) {
+		_system_parse_list(buffer, online, SYSTEM_THREAD_MAX);
+	}
+	else {
+		size_t threads = system_hardware_threads();
+		for (ithread = 0; (ithread < threads) && (ithread < SYSTEM_THREAD_MAX); ++ithread)
+			online[ithread / 64] |= (1ULL << (ithread % 64));
+	}
+
+	for (ithread = 0; ithread < SYSTEM_THREAD_MAX; ++ithread) {
+		hardware_topology_t* topology = _system_thread_topology + ithread;
+		uint64_t self = (ithread < 64) ? (1ULL << ithread) : 0;
+		topology->core_mask = topology->l2_mask = topology->l3_mask = self;
+		core_id[ithread] = ithread;
+		if (!(online[ithread / 64] & (1ULL << (ithread % 64))))
+			continue;
+		count = ithread + 1;
+
+		string_format(path, sizeof(path),
+		              STRING_CONST("/sys/devices/system/cpu/cpu%u/topology/core_id"), ithread);
+		core_id[ithread] = (unsigned int)_system_read_value(path, ithread);
+		string_format(path, sizeof(path),
+		              STRING_CONST("/sys/devices/system/cpu/cpu%u/topology/physical_package_id"), ithread);
+		topology->package = (unsigned int)_system_read_value(path, 0);
+		if (topology->package == (unsigned int)-1)
+			topology->package = 0;
+		string_format(path, sizeof(path),
+		              STRING_CONST("/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list"), ithread);
+		_system_read_mask(path, &topology->core_mask);
+
+		for (icache = 0; icache < 8; ++icache) {
+			unsigned long level;
+			uint64_t* mask;
+			string_format(path, sizeof(path),
+			              STRING_CONST("/sys/devices/system/cpu/cpu%u/cache/index%u/level"), ithread, icache);
+			level = _system_read_value(path, 0);
+			if (!level)
+				break;
+			if ((level != 2) && (level != 3))
+				continue;
+			string_format(path, sizeof(path),
+			              STRING_CONST("/sys/devices/system/cpu/cpu%u/cache/index%u/type"), ithread, icache);
+			if (_system_read_file(path, buffer, sizeof(buffer)) && string_equal(buffer, 11, "Instruction", 11))
+				continue;
+			mask = (level == 2) ? &topology->l2_mask : &topology->l3_mask;
+			string_format(path, sizeof(path),
+			              STRING_CONST("/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list"), ithread, icache);
+			_system_read_mask(path, mask);
+		}
+
+		//Relative capacity on heterogenous ARM systems, fall back to maximum frequency
+		string_format(path, sizeof(path),
+		              STRING_CONST("/sys/devices/system/cpu/cpu%u/cpu_capacity"), ithread);
+		capacity[ithread] = (unsigned int)_system_read_value(path, 0);
+		if (!capacity[ithread]) {
+			string_format(path, sizeof(path),
+			              STRING_CONST("/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq"), ithread);
+			capacity[ithread] = (unsigned int)_system_read_value(path, 0);
+		}
+
+		//Physical core index from first hardware thread with same package and core id
+		for (iother = 0; iother < ithread; ++iother) {
+			if ((online[iother / 64] & (1ULL << (iother % 64))) &&
+			        (core_id[iother] == core_id[ithread]) &&
+			        (_system_thread_topology[iother].package == topology->package))
+				break;
+		}
+		if (iother < ithread)
+			topology->core = _system_thread_topology[iother].core;
+		else
+			topology->core = (unsigned int)_system_core_count++;
+	}
+
+	//Offline hardware threads are excluded from class ranking
+	for (ithread = 0; ithread < count; ++ithread) {
+		if (!(online[ithread / 64] & (1ULL << (ithread % 64))))
+			capacity[ithread] = capacity[0];
+	}
+	_system_class_count = _system_topology_classify(_system_thread_topology, capacity, count);
+	if (!_system_core_count)
+		_system_core_count = 1;
+}
+
+static void
+_system_topology_initialize(void) {
+	char buffer[1024];
+	char path[128];
+	uint64_t bits[SYSTEM_THREAD_MAX / 64];
+	unsigned int node, ithread;
+	bool found = false;
+
+	memset(_system_node_mask, 0, sizeof(_system_node_mask));
+	memset(_system_thread_topology, 0, sizeof(_system_thread_topology));
+	_system_node_count = 1;
+
+	memset(bits, 0, sizeof(bits));
+	if (_system_read_file("/sys/devices/system/node/online", buffer, sizeof(buffer)))
+		_system_parse_list(buffer, bits, SYSTEM_NODE_MAX);
+	for (node = 0; node < SYSTEM_NODE_MAX; ++node) {
+		if (bits[0] & (1ULL << node))
+			_system_node_count = node + 1;
+	}
+
+	for (node = 0; node < _system_node_count; ++node) {
+		string_format(path, sizeof(path), STRING_CONST("/sys/devices/system/node/node%u/cpulist"), node);
+		if (!_system_read_file(path, buffer, sizeof(buffer)))
+			continue;
+		found = true;
+		memset(bits, 0, sizeof(bits));
+		_system_parse_list(buffer, bits, SYSTEM_THREAD_MAX);
+		_system_node_mask[node] = bits[0];
+		for (ithread = 0; ithread < SYSTEM_THREAD_MAX; ++ithread) {
+			if (bits[ithread / 64] & (1ULL << (ithread % 64)))
+				_system_thread_topology[ithread].node = node;
+		}
+	}
+
+	//Kernel without NUMA support, single node with all hardware threads
+	if (!found) {
+		size_t threads = system_hardware_threads();
+		_system_node_count = 1;
+		_system_node_mask[0] = (threads >= 64) ? ~0ULL : ((1ULL << threads) - 1);
+	}
+
+	_system_topology_initialize_cpu();
+}
+
+#endif
+
 int
 _system_initialize(void) {
 	_system_event_stream = event_stream_allocate(128);
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	atomic_store32(&_system_topology_state, 0);
+#endif
+	atomic_store32(&_system_names_state, 0);
 	return 0;
 }
 
@@ -333,16 +757,16 @@ system_error_message(int code) {
 	return string_const(STRING_CONST("<no error string>"));
 }
 
-string_t
-system_hostname(char* buffer, size_t size) {
+static string_t
+_system_hostname_query(char* buffer, size_t size) {
 	int ret = gethostname(buffer, size);
 	if ((ret < 0) || !size || !*buffer)
 		return string_copy(buffer, size, STRING_CONST("unknown"));
 	return (string_t){buffer, string_length(buffer)};
 }
 
-string_t
-system_username(char* buffer, size_t size) {
+static string_t
+_system_username_query(char* buffer, size_t size) {
 	struct passwd passwd;
 	struct passwd* result;
 
@@ -536,6 +960,93 @@ system_hardware_threads(void) {
 #endif
 }
 
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+size_t
+system_hardware_nodes(void) {
+	_system_topology_ensure();
+	return _system_node_count ? _system_node_count : 1;
+}
+
+uint64_t
+system_hardware_node_mask(unsigned int node) {
+	_system_topology_ensure();
+	return (node < _system_node_count) ? _system_node_mask[node] : 0;
+}
+
+unsigned int
+system_hardware_thread_node(unsigned int hwthread) {
+	_system_topology_ensure();
+	return (hwthread < SYSTEM_THREAD_MAX) ? _system_thread_topology[hwthread].node : 0;
+}
+
+size_t
+system_hardware_cores(void) {
+	_system_topology_ensure();
+	return _system_core_count ? _system_core_count : 1;
+}
+
+size_t
+system_hardware_core_classes(void) {
+	_system_topology_ensure();
+	return _system_class_count ? _system_class_count : 1;
+}
+
+hardware_topology_t
+system_hardware_topology(unsigned int hwthread) {
+	hardware_topology_t topology;
+	_system_topology_ensure();
+	if (hwthread < SYSTEM_THREAD_MAX)
+		return _system_thread_topology[hwthread];
+	memset(&topology, 0, sizeof(topology));
+	return topology;
+}
+
+#else
+
+size_t
+system_hardware_nodes(void) {
+	return 1;
+}
+
+uint64_t
+system_hardware_node_mask(unsigned int node) {
+	size_t threads;
+	if (node)
+		return 0;
+	threads = system_hardware_threads();
+	return (threads >= 64) ? ~0ULL : ((1ULL << threads) - 1);
+}
+
+unsigned int
+system_hardware_thread_node(unsigned int hwthread) {
+	FOUNDATION_UNUSED(hwthread);
+	return 0;
+}
+
+size_t
+system_hardware_cores(void) {
+	return system_hardware_threads();
+}
+
+size_t
+system_hardware_core_classes(void) {
+	return 1;
+}
+
+hardware_topology_t
+system_hardware_topology(unsigned int hwthread) {
+	hardware_topology_t topology;
+	size_t threads = system_hardware_threads();
+	memset(&topology, 0, sizeof(topology));
+	topology.core = hwthread;
+	topology.core_mask = topology.l2_mask = (hwthread < 64) ? (1ULL << hwthread) : 0;
+	topology.l3_mask = (threads >= 64) ? ~0ULL : ((1ULL << threads) - 1);
+	return topology;
+}
+
+#endif
+
 void
 system_process_events(void) {
 #if FOUNDATION_PLATFORM_ANDROID
@@ -641,18 +1152,76 @@ _system_user_locale(void) {
 
 #endif
 
+static void
+_system_names_ensure(void) {
+	if (atomic_load32(&_system_names_state) == 2) {
+		atomic_thread_fence_acquire();
+		return;
+	}
+	if (atomic_cas32(&_system_names_state, 1, 0)) {
+		//User name query needs room for the full password database entry
+		char buffer[1024];
+		string_t name = _system_hostname_query(buffer, sizeof(buffer));
+		name = string_copy(_system_hostname_buffer, sizeof(_system_hostname_buffer), STRING_ARGS(name));
+		_system_hostname_cache = string_to_const(name);
+		name = _system_username_query(buffer, sizeof(buffer));
+		name = string_copy(_system_username_buffer, sizeof(_system_username_buffer), STRING_ARGS(name));
+		_system_username_cache = string_to_const(name);
+		atomic_thread_fence_release();
+		atomic_store32(&_system_names_state, 2);
+		return;
+	}
+	while (atomic_load32(&_system_names_state) != 2)
+		thread_yield();
+	atomic_thread_fence_acquire();
+}
+
+string_t
+system_hostname(char* buffer, size_t capacity) {
+	_system_names_ensure();
+	return string_copy(buffer, capacity, STRING_ARGS(_system_hostname_cache));
+}
+
+string_t
+system_username(char* buffer, size_t capacity) {
+	_system_names_ensure();
+	return string_copy(buffer, capacity, STRING_ARGS(_system_username_cache));
+}
+
+string_const_t
+system_hostname_cached(void) {
+	_system_names_ensure();
+	return _system_hostname_cache;
+}
+
+string_const_t
+system_username_cached(void) {
+	_system_names_ensure();
+	return _system_username_cache;
+}
+
+void
+system_names_invalidate(void) {
+	atomic_cas32(&_system_names_state, 0, 2);
+}
+
 uint32_t
 system_locale(void) {
 	uint32_t localeval = 0;
 	char localestr[4];
+	string_const_t locale;
 
-	string_const_t locale = config_string(HASH_USER, HASH_LOCALE);
+	//Config strings are only kept valid inside a read section
+	config_read_begin();
+	locale = config_string(HASH_USER, HASH_LOCALE);
 	if (locale.length != 4)
 		locale = config_string(HASH_APPLICATION, HASH_LOCALE);
 	if (locale.length != 4)
 		locale = config_string(HASH_FOUNDATION, HASH_LOCALE);
-	if (locale.length != 4)
+	if (locale.length != 4) {
+		config_read_end();
 		return _system_user_locale();
+	}
 
 #define LOCALE_CHAR_TO_LOWERCASE(x) ((((unsigned char)(x) >= 'A') && ((unsigned char)(x) <= 'Z')) ? (char)(((unsigned char)(x)) | (32)) : ((char)(x)))
 #define LOCALE_CHAR_TO_UPPERCASE(x) ((((unsigned char)(x) >= 'a') && ((unsigned char)(x) <= 'z')) ? (char)(((unsigned char)(x)) & (~32)) : ((char)(x)))
@@ -660,6 +1229,7 @@ system_locale(void) {
 	localestr[1] = LOCALE_CHAR_TO_LOWERCASE(locale.str[1]);
 	localestr[2] = LOCALE_CHAR_TO_UPPERCASE(locale.str[2]);
 	localestr[3] = LOCALE_CHAR_TO_UPPERCASE(locale.str[3]);
+	config_read_end();
 
 	memcpy(&localeval, localestr, 4);
 	return localeval;
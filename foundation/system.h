@@ -58,25 +58,86 @@ system_byteorder(void);
 FOUNDATION_API size_t
 system_hardware_threads(void);
 
-/*! Get current host name of system in the given buffer
+/*! Get number of NUMA memory nodes in the system. Systems without NUMA support report a
+single node containing all hardware threads.
+\return Number of memory nodes */
+FOUNDATION_API size_t
+system_hardware_nodes(void);
+
+/*! Get mask of hardware threads belonging to the given NUMA memory node, in the same format
+as the mask passed to #thread_set_hardware. Only the first 64 hardware threads are represented.
+\param node Memory node
+\return     Hardware thread mask, 0 if node is invalid */
+FOUNDATION_API uint64_t
+system_hardware_node_mask(unsigned int node);
+
+/*! Get the NUMA memory node the given hardware thread belongs to. To get the node for the
+calling thread, use #thread_hardware as argument.
+\param hwthread Hardware thread, as returned by #thread_hardware
+\return         Memory node */
+FOUNDATION_API unsigned int
+system_hardware_thread_node(unsigned int hwthread);
+
+/*! Get number of physical cores in the system. Hardware threads sharing a core through
+simultaneous multithreading count as a single core.
+\return Number of physical cores */
+FOUNDATION_API size_t
+system_hardware_cores(void);
+
+/*! Get number of core classes in the system. Heterogenous systems (like big.LITTLE) report
+one class per distinct core performance level, other systems report a single class.
+\return Number of core classes */
+FOUNDATION_API size_t
+system_hardware_core_classes(void);
+
+/*! Get topology information for the given hardware thread, like physical core, cache sharing
+and core class. Systems where topology cannot be queried report each hardware thread as a
+separate core sharing a single level 3 cache.
+\param hwthread Hardware thread, as returned by #thread_hardware
+\return         Topology information */
+FOUNDATION_API hardware_topology_t
+system_hardware_topology(unsigned int hwthread);
+
+/*! Get current host name of system in the given buffer. The name is queried once and cached,
+see #system_names_invalidate
 \param buffer Buffer
 \param capacity Capacity of buffer
 \return Host name string */
 FOUNDATION_API string_t
 system_hostname(char* buffer, size_t capacity);
 
+/*! Get cached host name of system without copying. Returned string must not be modified or
+deallocated and remains valid until #system_names_invalidate is called
+\return Host name string */
+FOUNDATION_API string_const_t
+system_hostname_cached(void);
+
 /*! Get current unique host id
 \return Host id */
 FOUNDATION_API uint64_t
 system_hostid(void);
 
-/*! Get user name of user owning the executing process in the given buffer
+/*! Get user name of user owning the executing process in the given buffer. The name is
+queried once and cached, see #system_names_invalidate
 \param buffer Buffer
 \param capacity Capacity of buffer
 \return User name string */
 FOUNDATION_API string_t
 system_username(char* buffer, size_t capacity);
 
+/*! Get cached user name of user owning the executing process without copying. Returned
+string must not be modified or deallocated and remains valid until #system_names_invalidate
+is called
+\return User name string */
+FOUNDATION_API string_const_t
+system_username_cached(void);
+
+/*! Discard cached host and user names, making the next query go to the operating system.
+Must not be called while other threads use strings returned by #system_hostname_cached or
+#system_username_cached */
+FOUNDATION_API void
+system_names_invalidate(void);
+
 /*! Query if debugger is attached.
 \return true if debugger is attached, false if not */
 FOUNDATION_API bool
@@ -0,0 +1,860 @@
+/* task.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+//Number of idle loops a worker yields before going to sleep
+#define TASK_IDLE_SPIN   64
+
+//Maximum time in milliseconds an idle worker sleeps before looking for work again
+#define TASK_IDLE_SLEEP  10
+
+//Maximum time in milliseconds an idle worker with suspended fibers sleeps before polling them again
+#define TASK_FIBER_SLEEP 1
+
+typedef struct task_job_t     task_job_t;
+typedef struct task_deque_t   task_deque_t;
+typedef struct task_worker_t  task_worker_t;
+typedef struct task_node_t    task_node_t;
+typedef struct task_parallel_t task_parallel_t;
+typedef struct task_fiber_t   task_fiber_t;
+typedef struct task_beacon_wait_t task_beacon_wait_t;
+typedef struct task_mutex_hold_t task_mutex_hold_t;
+
+typedef bool (* task_ready_fn)(void* data);
+
+struct task_job_t {
+	task_t task;
+	task_counter_t* counter;
+	task_job_t* next;
+};
+
+//Chase-Lev work stealing deque, owner pushes and pops at bottom, thieves steal at top
+FOUNDATION_ALIGNED_STRUCT(task_deque_t, 64) {
+	FOUNDATION_ALIGN(64) atomic64_t top;
+	FOUNDATION_ALIGN(64) atomic64_t bottom;
+	FOUNDATION_ALIGN(64) int64_t mask;
+	atomicptr_t* job;
+};
+
+//Tasks on a worker execute on fibers, a task waiting for a counter or a synchronization
+//primitive suspends its fiber and the worker picks up other tasks until the wait is ready.
+//Suspended fibers are only resumed by the worker that suspended them
+struct task_fiber_t {
+	fiber_t* fiber;
+	task_worker_t* worker;
+	task_job_t* job;
+	task_ready_fn ready;
+	void* data;
+};
+
+struct task_beacon_wait_t {
+	beacon_t* beacon;
+	int slot;
+};
+
+//Mutexes are recursive per thread, so mutexes locked by fibers are tracked per worker to keep
+//other fibers on the same worker thread from entering the lock
+struct task_mutex_hold_t {
+	mutex_t* mutex;
+	task_fiber_t* fiber;
+};
+
+FOUNDATION_ALIGNED_STRUCT(task_worker_t, 64) {
+	task_deque_t deque;
+	task_scheduler_t* scheduler;
+	size_t index;
+	thread_t thread;
+	fiber_t* fiber;
+	task_fiber_t* current;
+	task_fiber_t** fiber_free;
+	task_fiber_t** fiber_wait;
+	task_mutex_hold_t* mutex_hold;
+};
+
+FOUNDATION_ALIGNED_STRUCT(task_scheduler_t, 64) {
+	queue_t queue;
+	queue_t free;
+	size_t worker_count;
+	task_worker_t* worker;
+	task_job_t* job;
+	semaphore_t wake;
+	atomic32_t sleeping;
+	atomic32_t running;
+};
+
+struct task_node_t {
+	task_t task;
+	task_graph_t* graph;
+	int32_t dependencies;
+	atomic32_t pending;
+	size_t* dependants;
+};
+
+struct task_graph_t {
+	task_node_t* node;
+	task_scheduler_t* scheduler;
+	task_counter_t* counter;
+	task_counter_t wait;
+};
+
+struct task_parallel_t {
+	atomic64_t next;
+	int64_t end;
+	int64_t grain;
+	int64_t participants;
+	task_range_fn range;
+	task_reduce_fn reduce;
+	void* arg;
+	char* partial;
+	size_t partial_size;
+	atomic32_t participant;
+};
+
+FOUNDATION_DECLARE_THREAD_LOCAL(task_worker_t*, task_worker, 0)
+
+static void
+_task_deque_initialize(task_deque_t* deque, size_t capacity) {
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	deque->mask = (int64_t)size - 1;
+	deque->job = memory_allocate(0, sizeof(atomicptr_t) * size, 0,
+	                             MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	atomic_store64(&deque->top, 0);
+	atomic_store64(&deque->bottom, 0);
+}
+
+static void
+_task_deque_finalize(task_deque_t* deque) {
+	memory_deallocate(deque->job);
+	deque->job = 0;
+}
+
+static bool
+_task_deque_push(task_deque_t* deque, task_job_t* job) {
+	int64_t bottom = atomic_load64(&deque->bottom);
+	int64_t top = atomic_load64(&deque->top);
+	if (bottom - top > deque->mask)
+		return false;
+	atomic_storeptr(&deque->job[bottom & deque->mask], job);
+	atomic_thread_fence_release();
+	atomic_store64(&deque->bottom, bottom + 1);
+	return true;
+}
+
+static task_job_t*
+_task_deque_pop(task_deque_t* deque) {
+	task_job_t* job = 0;
+	int64_t bottom = atomic_load64(&deque->bottom) - 1;
+	int64_t top;
+	atomic_store64(&deque->bottom, bottom);
+	atomic_thread_fence_sequentially_consistent();
+	top = atomic_load64(&deque->top);
+	if (top <= bottom) {
+		job = atomic_loadptr(&deque->job[bottom & deque->mask]);
+		if (top == bottom) {
+			//Last item, race against thieves
+			if (!atomic_cas64(&deque->top, top + 1, top))
+				job = 0;
+			atomic_store64(&deque->bottom, bottom + 1);
+		}
+	}
+	else {
+		atomic_store64(&deque->bottom, bottom + 1);
+	}
+	return job;
+}
+
+static task_job_t*
+_task_deque_steal(task_deque_t* deque) {
+	task_job_t* job;
+	int64_t top = atomic_load64(&deque->top);
+	int64_t bottom;
+	atomic_thread_fence_sequentially_consistent();
+	bottom = atomic_load64(&deque->bottom);
+	if (top >= bottom)
+		return 0;
+	job = atomic_loadptr(&deque->job[top & deque->mask]);
+	if (!atomic_cas64(&deque->top, top + 1, top))
+		return 0;
+	return job;
+}
+
+static bool
+_task_deque_empty(task_deque_t* deque) {
+	return atomic_load64(&deque->top) >= atomic_load64(&deque->bottom);
+}
+
+static task_worker_t*
+_task_worker(task_scheduler_t* scheduler) {
+	task_worker_t* worker = get_thread_task_worker();
+	return (worker && (worker->scheduler == scheduler)) ? worker : 0;
+}
+
+static task_job_t*
+_task_next(task_scheduler_t* scheduler, task_worker_t* worker) {
+	task_job_t* job = 0;
+	size_t ivictim, victim;
+
+	if (worker)
+		job = _task_deque_pop(&worker->deque);
+	if (!job)
+		job = queue_try_pop(&scheduler->queue, 0);
+	if (!job) {
+		victim = worker ? worker->index + 1 : 0;
+		for (ivictim = 0; !job && (ivictim < scheduler->worker_count); ++ivictim, ++victim) {
+			if (victim >= scheduler->worker_count)
+				victim = 0;
+			if (scheduler->worker + victim != worker)
+				job = _task_deque_steal(&scheduler->worker[victim].deque);
+		}
+	}
+	return job;
+}
+
+static bool
+_task_has_work(task_scheduler_t* scheduler) {
+	size_t iworker;
+	if (queue_size(&scheduler->queue))
+		return true;
+	for (iworker = 0; iworker < scheduler->worker_count; ++iworker) {
+		if (!_task_deque_empty(&scheduler->worker[iworker].deque))
+			return true;
+	}
+	return false;
+}
+
+static void
+_task_schedule(task_scheduler_t* scheduler, task_job_t* job) {
+	task_worker_t* worker = _task_worker(scheduler);
+	if (!worker || !_task_deque_push(&worker->deque, job))
+		queue_push(&scheduler->queue, job);
+	atomic_thread_fence_sequentially_consistent();
+	if (atomic_load32(&scheduler->sleeping) > 0)
+		semaphore_post(&scheduler->wake);
+}
+
+static void
+_task_counter_signal(task_scheduler_t* scheduler, task_counter_t* counter) {
+	task_job_t* job;
+	do {
+		job = atomic_loadptr(&counter->continuation);
+	}
+	while (job && !atomic_cas_ptr(&counter->continuation, 0, job));
+	while (job) {
+		task_job_t* next = job->next;
+		job->next = 0;
+		_task_schedule(scheduler, job);
+		job = next;
+	}
+}
+
+static void
+_task_execute(task_scheduler_t* scheduler, task_job_t* job) {
+	task_counter_t* counter;
+
+	if (job->task.name.length)
+		profile_begin_block(STRING_ARGS(job->task.name));
+	else
+		profile_begin_block(STRING_CONST("task"));
+	job->task.function(job->task.arg);
+	profile_end_block();
+
+	counter = job->counter;
+	queue_push(&scheduler->free, job);
+	if (counter && !atomic_decr32(&counter->value))
+		_task_counter_signal(scheduler, counter);
+}
+
+static task_job_t*
+_task_acquire(task_scheduler_t* scheduler) {
+	task_worker_t* worker = 0;
+	task_job_t* job = queue_try_pop(&scheduler->free, 0);
+	if (!job)
+		worker = _task_worker(scheduler);
+	while (!job) {
+		task_job_t* next = _task_next(scheduler, worker);
+		if (next)
+			_task_execute(scheduler, next);
+		else
+			thread_yield();
+		job = queue_try_pop(&scheduler->free, 0);
+	}
+	return job;
+}
+
+static void
+_task_fiber_entry(void* arg) {
+	task_fiber_t* task_fiber = arg;
+	task_worker_t* worker = task_fiber->worker;
+	while (true) {
+		_task_execute(worker->scheduler, task_fiber->job);
+		task_fiber->job = 0;
+		fiber_switch(task_fiber->fiber, worker->fiber);
+	}
+}
+
+static void
+_task_fiber_resume(task_worker_t* worker, task_fiber_t* task_fiber) {
+	worker->current = task_fiber;
+	fiber_switch(worker->fiber, task_fiber->fiber);
+	worker->current = 0;
+	//Fiber is either done with the task or suspended in the wait list
+	if (!task_fiber->job)
+		array_push(worker->fiber_free, task_fiber);
+}
+
+static void
+_task_fiber_run(task_worker_t* worker, task_job_t* job) {
+	task_fiber_t* task_fiber;
+	if (array_size(worker->fiber_free)) {
+		task_fiber = worker->fiber_free[array_size(worker->fiber_free) - 1];
+		array_pop(worker->fiber_free);
+	}
+	else {
+		task_fiber = memory_allocate(0, sizeof(task_fiber_t), 0,
+		                             MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		task_fiber->worker = worker;
+		task_fiber->fiber = fiber_allocate(_task_fiber_entry, task_fiber, 0);
+		if (!task_fiber->fiber) {
+			memory_deallocate(task_fiber);
+			_task_execute(worker->scheduler, job);
+			return;
+		}
+	}
+	task_fiber->job = job;
+	_task_fiber_resume(worker, task_fiber);
+}
+
+static size_t
+_task_fiber_poll(task_worker_t* worker) {
+	size_t ifiber = 0;
+	while (ifiber < array_size(worker->fiber_wait)) {
+		task_fiber_t* task_fiber = worker->fiber_wait[ifiber];
+		if (task_fiber->ready(task_fiber->data)) {
+			array_erase(worker->fiber_wait, ifiber);
+			_task_fiber_resume(worker, task_fiber);
+		}
+		else {
+			++ifiber;
+		}
+	}
+	return array_size(worker->fiber_wait);
+}
+
+static void
+_task_fiber_finalize(task_worker_t* worker) {
+	size_t ifiber, count;
+	//Suspended fibers have tasks that never completed, they are discarded with the fiber
+	for (ifiber = 0, count = array_size(worker->fiber_wait); ifiber < count; ++ifiber)
+		array_push(worker->fiber_free, worker->fiber_wait[ifiber]);
+	for (ifiber = 0, count = array_size(worker->fiber_free); ifiber < count; ++ifiber) {
+		fiber_deallocate(worker->fiber_free[ifiber]->fiber);
+		memory_deallocate(worker->fiber_free[ifiber]);
+	}
+	array_deallocate(worker->fiber_free);
+	array_deallocate(worker->fiber_wait);
+	array_deallocate(worker->mutex_hold);
+	fiber_deallocate(worker->fiber);
+	worker->fiber = 0;
+}
+
+//Suspend the task executing on the calling worker until the ready function returns true,
+//returns false without waiting if the calling thread is not executing a task on a fiber
+static bool
+_task_fiber_suspend(task_ready_fn ready, void* data) {
+	task_worker_t* worker = get_thread_task_worker();
+	task_fiber_t* task_fiber = worker ? worker->current : 0;
+	string_const_t name;
+	if (!task_fiber)
+		return false;
+
+	task_fiber->ready = ready;
+	task_fiber->data = data;
+	array_push(worker->fiber_wait, task_fiber);
+
+	//Profile blocks are per thread, close the block while other tasks run on the worker
+	name = task_fiber->job->task.name;
+	profile_end_block();
+	fiber_switch(task_fiber->fiber, worker->fiber);
+	if (name.length)
+		profile_begin_block(STRING_ARGS(name));
+	else
+		profile_begin_block(STRING_CONST("task"));
+	return true;
+}
+
+static void*
+_task_worker_thread(void* arg) {
+	task_worker_t* worker = arg;
+	task_scheduler_t* scheduler = worker->scheduler;
+	unsigned int idle = 0;
+
+	set_thread_task_worker(worker);
+	worker->fiber = fiber_allocate_thread();
+	if (system_hardware_threads() > 1)
+		thread_set_hardware((uint64_t)1 << (worker->index % (system_hardware_threads() < 64 ?
+		                                                     system_hardware_threads() : 64)));
+
+	while (atomic_load32(&scheduler->running)) {
+		size_t suspended = 0;
+		task_job_t* job = _task_next(scheduler, worker);
+		if (job) {
+			if (worker->fiber)
+				_task_fiber_run(worker, job);
+			else
+				_task_execute(scheduler, job);
+			idle = 0;
+		}
+		if (worker->fiber)
+			suspended = _task_fiber_poll(worker);
+		if (job)
+			continue;
+		if (++idle < TASK_IDLE_SPIN) {
+			thread_yield();
+			continue;
+		}
+		atomic_incr32(&scheduler->sleeping);
+		atomic_thread_fence_sequentially_consistent();
+		if (!_task_has_work(scheduler) && atomic_load32(&scheduler->running))
+			semaphore_try_wait(&scheduler->wake, suspended ? TASK_FIBER_SLEEP : TASK_IDLE_SLEEP);
+		atomic_decr32(&scheduler->sleeping);
+		idle = 0;
+	}
+
+	if (worker->fiber)
+		_task_fiber_finalize(worker);
+	set_thread_task_worker(0);
+	return 0;
+}
+
+task_scheduler_t*
+task_scheduler_allocate(size_t workers, size_t capacity) {
+	task_scheduler_t* scheduler;
+	size_t iworker, ijob, job_count;
+
+	if (!workers)
+		workers = system_hardware_threads();
+	if (!workers)
+		workers = 1;
+	if (!capacity)
+		capacity = 256;
+	job_count = (workers + 1) * capacity;
+
+	scheduler = memory_allocate(0, sizeof(task_scheduler_t), 64,
+	                            MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	scheduler->worker_count = workers;
+	scheduler->worker = memory_allocate(0, sizeof(task_worker_t) * workers, 64,
+	                                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	scheduler->job = memory_allocate(0, sizeof(task_job_t) * job_count, 0,
+	                                 MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	queue_initialize(&scheduler->queue, job_count);
+	queue_initialize(&scheduler->free, job_count);
+	for (ijob = 0; ijob < job_count; ++ijob)
+		queue_push(&scheduler->free, scheduler->job + ijob);
+	semaphore_initialize(&scheduler->wake, 0);
+	atomic_store32(&scheduler->sleeping, 0);
+	atomic_store32(&scheduler->running, 1);
+
+	for (iworker = 0; iworker < workers; ++iworker) {
+		task_worker_t* worker = scheduler->worker + iworker;
+		_task_deque_initialize(&worker->deque, capacity);
+		worker->scheduler = scheduler;
+		worker->index = iworker;
+		thread_initialize(&worker->thread, _task_worker_thread, worker, STRING_CONST("task_worker"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (iworker = 0; iworker < workers; ++iworker)
+		thread_start(&scheduler->worker[iworker].thread);
+
+	return scheduler;
+}
+
+void
+task_scheduler_deallocate(task_scheduler_t* scheduler) {
+	size_t iworker;
+	if (!scheduler)
+		return;
+
+	atomic_store32(&scheduler->running, 0);
+	for (iworker = 0; iworker < scheduler->worker_count; ++iworker)
+		semaphore_post(&scheduler->wake);
+	for (iworker = 0; iworker < scheduler->worker_count; ++iworker) {
+		task_worker_t* worker = scheduler->worker + iworker;
+		thread_join(&worker->thread);
+		thread_finalize(&worker->thread);
+		_task_deque_finalize(&worker->deque);
+	}
+
+	semaphore_finalize(&scheduler->wake);
+	queue_finalize(&scheduler->free);
+	queue_finalize(&scheduler->queue);
+	memory_deallocate(scheduler->job);
+	memory_deallocate(scheduler->worker);
+	memory_deallocate(scheduler);
+}
+
+size_t
+task_scheduler_worker_count(const task_scheduler_t* scheduler) {
+	return scheduler->worker_count;
+}
+
+void
+task_submit(task_scheduler_t* scheduler, const task_t* task, size_t count,
+            task_counter_t* counter) {
+	size_t itask;
+	if (counter)
+		atomic_add32(&counter->value, (int32_t)count);
+	for (itask = 0; itask < count; ++itask) {
+		task_job_t* job = _task_acquire(scheduler);
+		job->task = task[itask];
+		job->counter = counter;
+		job->next = 0;
+		_task_schedule(scheduler, job);
+	}
+}
+
+void
+task_continue(task_scheduler_t* scheduler, task_counter_t* dependency, const task_t* task,
+              size_t count, task_counter_t* counter) {
+	size_t itask;
+	if (counter)
+		atomic_add32(&counter->value, (int32_t)count);
+	for (itask = 0; itask < count; ++itask) {
+		task_job_t* job = _task_acquire(scheduler);
+		job->task = task[itask];
+		job->counter = counter;
+		do {
+			job->next = atomic_loadptr(&dependency->continuation);
+		}
+		while (!atomic_cas_ptr(&dependency->continuation, job, job->next));
+	}
+	//If the dependency completed while continuations were queued, whoever grabs the
+	//list first submits it
+	atomic_thread_fence_sequentially_consistent();
+	if (!atomic_load32(&dependency->value))
+		_task_counter_signal(scheduler, dependency);
+}
+
+static bool
+_task_ready_counter(void* data) {
+	return atomic_load32(&((task_counter_t*)data)->value) <= 0;
+}
+
+static bool
+_task_ready_semaphore(void* data) {
+	return semaphore_try_wait(data, 0);
+}
+
+static bool
+_task_mutex_try_lock(task_fiber_t* task_fiber, mutex_t* mutex) {
+	task_worker_t* worker = task_fiber->worker;
+	task_mutex_hold_t hold;
+	size_t ihold, count;
+	for (ihold = 0, count = array_size(worker->mutex_hold); ihold < count; ++ihold) {
+		if ((worker->mutex_hold[ihold].mutex == mutex) &&
+		        (worker->mutex_hold[ihold].fiber != task_fiber))
+			return false;
+	}
+	if (!mutex_try_lock(mutex))
+		return false;
+	hold.mutex = mutex;
+	hold.fiber = task_fiber;
+	array_push(worker->mutex_hold, hold);
+	return true;
+}
+
+static bool
+_task_ready_mutex(void* data) {
+	task_mutex_hold_t* wait = data;
+	return _task_mutex_try_lock(wait->fiber, wait->mutex);
+}
+
+static bool
+_task_ready_beacon(void* data) {
+	task_beacon_wait_t* wait = data;
+	wait->slot = beacon_try_wait(wait->beacon, 0);
+	return (wait->slot >= 0);
+}
+
+void
+task_wait(task_scheduler_t* scheduler, task_counter_t* counter) {
+	task_worker_t* worker;
+	if (_task_ready_counter(counter) || _task_fiber_suspend(_task_ready_counter, counter))
+		return;
+	worker = _task_worker(scheduler);
+	while (atomic_load32(&counter->value) > 0) {
+		task_job_t* job = _task_next(scheduler, worker);
+		if (job)
+			_task_execute(scheduler, job);
+		else
+			thread_yield();
+	}
+}
+
+bool
+task_counter_done(const task_counter_t* counter) {
+	return atomic_load32(&counter->value) <= 0;
+}
+
+bool
+task_semaphore_wait(semaphore_t* semaphore) {
+	if (_task_ready_semaphore(semaphore) || _task_fiber_suspend(_task_ready_semaphore, semaphore))
+		return true;
+	return semaphore_wait(semaphore);
+}
+
+bool
+task_mutex_lock(mutex_t* mutex) {
+	task_worker_t* worker = get_thread_task_worker();
+	task_mutex_hold_t wait;
+	if (!worker || !worker->current)
+		return mutex_lock(mutex);
+	wait.mutex = mutex;
+	wait.fiber = worker->current;
+	if (!_task_ready_mutex(&wait))
+		_task_fiber_suspend(_task_ready_mutex, &wait);
+	return true;
+}
+
+bool
+task_mutex_unlock(mutex_t* mutex) {
+	task_worker_t* worker = get_thread_task_worker();
+	size_t ihold, count;
+	if (worker && worker->current) {
+		for (ihold = 0, count = array_size(worker->mutex_hold); ihold < count; ++ihold) {
+			if ((worker->mutex_hold[ihold].mutex == mutex) &&
+			        (worker->mutex_hold[ihold].fiber == worker->current)) {
+				array_erase(worker->mutex_hold, ihold);
+				break;
+			}
+		}
+	}
+	return mutex_unlock(mutex);
+}
+
+int
+task_beacon_wait(beacon_t* beacon) {
+	task_beacon_wait_t wait;
+	wait.beacon = beacon;
+	if (_task_ready_beacon(&wait) || _task_fiber_suspend(_task_ready_beacon, &wait))
+		return wait.slot;
+	return beacon_wait(beacon);
+}
+
+task_graph_t*
+task_graph_allocate(size_t capacity) {
+	task_graph_t* graph = memory_allocate(0, sizeof(task_graph_t), 0,
+	                                      MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	if (capacity)
+		array_reserve(graph->node, capacity);
+	return graph;
+}
+
+void
+task_graph_deallocate(task_graph_t* graph) {
+	if (!graph)
+		return;
+	task_graph_clear(graph);
+	array_deallocate(graph->node);
+	memory_deallocate(graph);
+}
+
+void
+task_graph_clear(task_graph_t* graph) {
+	size_t inode, count;
+	for (inode = 0, count = array_size(graph->node); inode < count; ++inode)
+		array_deallocate(graph->node[inode].dependants);
+	array_clear(graph->node);
+}
+
+size_t
+task_graph_add(task_graph_t* graph, const task_t* task) {
+	task_node_t node;
+	memset(&node, 0, sizeof(node));
+	node.task = *task;
+	node.graph = graph;
+	array_push_memcpy(graph->node, &node);
+	return array_size(graph->node) - 1;
+}
+
+void
+task_graph_depend(task_graph_t* graph, size_t task, size_t dependency) {
+	FOUNDATION_ASSERT(task < array_size(graph->node));
+	FOUNDATION_ASSERT(dependency < array_size(graph->node));
+	FOUNDATION_ASSERT(task != dependency);
+	array_push(graph->node[dependency].dependants, task);
+	++graph->node[task].dependencies;
+}
+
+size_t
+task_graph_size(const task_graph_t* graph) {
+	return array_size(graph->node);
+}
+
+static void
+_task_graph_node(void* arg) {
+	task_node_t* node = arg;
+	task_graph_t* graph = node->graph;
+	size_t idep, count;
+
+	node->task.function(node->task.arg);
+
+	//Release dependants, the last dependency to complete submits the task. Dependants are
+	//submitted before this task completes so the graph counter never reaches zero early
+	for (idep = 0, count = array_size(node->dependants); idep < count; ++idep) {
+		task_node_t* dependant = graph->node + node->dependants[idep];
+		if (!atomic_decr32(&dependant->pending)) {
+			task_t task = {_task_graph_node, dependant, dependant->task.name};
+			task_submit(graph->scheduler, &task, 1, graph->counter);
+		}
+	}
+}
+
+void
+task_graph_execute(task_graph_t* graph, task_scheduler_t* scheduler, task_counter_t* counter) {
+	size_t inode, count;
+	task_t* root = 0;
+
+	count = array_size(graph->node);
+	if (!count)
+		return;
+
+	graph->scheduler = scheduler;
+	graph->counter = counter ? counter : &graph->wait;
+	for (inode = 0; inode < count; ++inode) {
+		task_node_t* node = graph->node + inode;
+		atomic_store32(&node->pending, node->dependencies);
+		if (!node->dependencies) {
+			task_t task = {_task_graph_node, node, node->task.name};
+			array_push(root, task);
+		}
+	}
+	FOUNDATION_ASSERT_MSG(array_size(root), "Task graph has no root task, dependencies form a cycle");
+	atomic_thread_fence_release();
+
+	task_submit(scheduler, root, array_size(root), graph->counter);
+	array_deallocate(root);
+
+	if (!counter)
+		task_wait(scheduler, &graph->wait);
+}
+
+//Guided chunking, each chunk claims a share of the remaining range that shrinks as the range
+//is consumed, so early chunks are large and the tail is balanced with small chunks
+static bool
+_task_parallel_chunk(task_parallel_t* parallel, size_t* begin, size_t* end) {
+	int64_t pos, chunk;
+	do {
+		pos = atomic_load64(&parallel->next);
+		if (pos >= parallel->end)
+			return false;
+		chunk = (parallel->end - pos) / (parallel->participants * 2);
+		if (chunk < parallel->grain)
+			chunk = parallel->grain;
+		if (chunk > parallel->end - pos)
+			chunk = parallel->end - pos;
+	}
+	while (!atomic_cas64(&parallel->next, pos + chunk, pos));
+	*begin = (size_t)pos;
+	*end = (size_t)(pos + chunk);
+	return true;
+}
+
+static void
+_task_parallel(void* arg) {
+	task_parallel_t* parallel = arg;
+	size_t begin, end;
+	void* partial = 0;
+	if (parallel->reduce) {
+		int32_t participant = atomic_incr32(&parallel->participant) - 1;
+		partial = pointer_offset(parallel->partial, parallel->partial_size * (size_t)participant);
+	}
+	while (_task_parallel_chunk(parallel, &begin, &end)) {
+		if (parallel->reduce)
+			parallel->reduce(begin, end, partial, parallel->arg);
+		else
+			parallel->range(begin, end, parallel->arg);
+	}
+}
+
+static void
+_task_parallel_run(task_scheduler_t* scheduler, task_parallel_t* parallel, size_t begin,
+                   size_t end, size_t grain) {
+	task_counter_t counter;
+	task_t task;
+	size_t participants, count;
+
+	count = end - begin;
+	participants = scheduler->worker_count + 1;
+	if (!grain)
+		grain = count / (participants * 32);
+	if (!grain)
+		grain = 1;
+	if (participants > (count + grain - 1) / grain)
+		participants = (count + grain - 1) / grain;
+
+	atomic_store64(&parallel->next, (int64_t)begin);
+	parallel->end = (int64_t)end;
+	parallel->grain = (int64_t)grain;
+	parallel->participants = (int64_t)participants;
+	atomic_store32(&parallel->participant, 0);
+
+	//Calling thread is one of the participants
+	memset(&counter, 0, sizeof(counter));
+	task.function = _task_parallel;
+	task.arg = parallel;
+	task.name = string_const(STRING_CONST("parallel"));
+	while (--participants)
+		task_submit(scheduler, &task, 1, &counter);
+	_task_parallel(parallel);
+	task_wait(scheduler, &counter);
+}
+
+void
+task_parallel_for(task_scheduler_t* scheduler, size_t begin, size_t end, size_t grain,
+                  task_range_fn fn, void* arg) {
+	task_parallel_t parallel;
+	if (end <= begin)
+		return;
+	memset(&parallel, 0, sizeof(parallel));
+	parallel.range = fn;
+	parallel.arg = arg;
+	_task_parallel_run(scheduler, &parallel, begin, end, grain);
+}
+
+void
+task_parallel_reduce(task_scheduler_t* scheduler, size_t begin, size_t end, size_t grain,
+                     task_reduce_fn reduce, task_join_fn join, void* result,
+                     const void* identity, size_t size, void* arg) {
+	task_parallel_t parallel;
+	size_t ipart, parts;
+	if (end <= begin)
+		return;
+
+	parts = scheduler->worker_count + 1;
+	memset(&parallel, 0, sizeof(parallel));
+	parallel.reduce = reduce;
+	parallel.arg = arg;
+	parallel.partial_size = size;
+	parallel.partial = memory_allocate(0, size * parts, 0, MEMORY_TEMPORARY);
+	for (ipart = 0; ipart < parts; ++ipart)
+		memcpy(parallel.partial + (size * ipart), identity, size);
+
+	_task_parallel_run(scheduler, &parallel, begin, end, grain);
+
+	parts = (size_t)atomic_load32(&parallel.participant);
+	for (ipart = 0; ipart < parts; ++ipart)
+		join(result, parallel.partial + (size * ipart), arg);
+	memory_deallocate(parallel.partial);
+}
@@ -0,0 +1,207 @@
+/* task.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file task.h
+\brief Task scheduler
+
+Task scheduler executing tasks on a pool of worker threads. Each worker owns a work stealing
+deque, tasks submitted from a worker are pushed to its own deque while tasks submitted from other
+threads go through a shared queue. Idle workers steal tasks from other workers.
+
+Completion is tracked by task counters, a zero initialized #task_counter_t which is incremented
+for each task submitted with the counter and decremented when the task completes. Threads waiting
+on a counter help executing tasks until the counter reaches zero. Continuation tasks can be
+queued on a counter and are submitted once the counter reaches zero.
+
+Each task is executed inside a profile block named after the task.
+
+On platforms supporting fibers, tasks executed by worker threads run on fibers. A task waiting
+on a task counter, or using the task variants of semaphore, mutex and beacon waits, suspends its
+fiber instead of blocking the worker thread, and the worker continues executing other tasks. A
+suspended task is resumed on the same worker thread once the wait is satisfied.
+
+A task graph declares a set of tasks and dependencies between them. Executing the graph
+submits all tasks without dependencies, and each completed task decrements the pending
+dependency count of its dependants, submitting any dependant that reaches zero. A graph can be
+executed any number of times, but only once at a time.
+
+Parallel for and reduce helpers split an index range in chunks executed by the worker threads
+and the calling thread. Chunks are claimed dynamically with sizes shrinking as the range is
+consumed, balancing load between uneven chunks. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a task scheduler and start the worker threads. Workers are pinned to a hardware
+thread each.
+\param workers Number of worker threads, zero for default (number of hardware threads)
+\param capacity Capacity of each worker task deque, zero for default (256)
+\return New task scheduler */
+FOUNDATION_API task_scheduler_t*
+task_scheduler_allocate(size_t workers, size_t capacity);
+
+/*! Stop worker threads and deallocate a task scheduler. Tasks not yet executed are
+discarded, wait on the task counters before deallocating to make sure all tasks completed.
+\param scheduler Task scheduler */
+FOUNDATION_API void
+task_scheduler_deallocate(task_scheduler_t* scheduler);
+
+/*! Get number of worker threads
+\param scheduler Task scheduler
+\return Number of worker threads */
+FOUNDATION_API size_t
+task_scheduler_worker_count(const task_scheduler_t* scheduler);
+
+/*! Submit tasks for execution. If all internal task slots are in use the calling thread
+helps executing tasks until a slot is available.
+\param scheduler Task scheduler
+\param task Array of task descriptions
+\param count Number of tasks
+\param counter Counter tracking completion of the tasks, may be null */
+FOUNDATION_API void
+task_submit(task_scheduler_t* scheduler, const task_t* task, size_t count,
+            task_counter_t* counter);
+
+/*! Submit tasks for execution once the given counter reaches zero. If the counter is already
+zero the tasks are submitted immediately. The continuation tasks are counted in the completion
+counter, if any, from the point of this call.
+\param scheduler Task scheduler
+\param dependency Counter the tasks depend on
+\param task Array of task descriptions
+\param count Number of tasks
+\param counter Counter tracking completion of the tasks, may be null */
+FOUNDATION_API void
+task_continue(task_scheduler_t* scheduler, task_counter_t* dependency, const task_t* task,
+              size_t count, task_counter_t* counter);
+
+/*! Wait for a task counter to reach zero. A task executing on a worker thread suspends its
+fiber while waiting, other threads execute pending tasks while waiting.
+\param scheduler Task scheduler
+\param counter Counter to wait on */
+FOUNDATION_API void
+task_wait(task_scheduler_t* scheduler, task_counter_t* counter);
+
+/*! Query if a task counter has reached zero
+\param counter Counter
+\return true if all tasks tracked by the counter have completed */
+FOUNDATION_API bool
+task_counter_done(const task_counter_t* counter);
+
+/*! Wait on a semaphore from a task. If the semaphore is not signalled, a task executing on a
+worker thread suspends its fiber and the worker executes other tasks until the semaphore can be
+acquired. Outside of worker threads this blocks like #semaphore_wait.
+\param semaphore Semaphore
+\return true if semaphore was acquired, false if error */
+FOUNDATION_API bool
+task_semaphore_wait(semaphore_t* semaphore);
+
+/*! Lock a mutex from a task. If the mutex is locked, a task executing on a worker thread
+suspends its fiber and the worker executes other tasks until the mutex can be locked. Outside
+of worker threads this blocks like #mutex_lock. A mutex locked with this function must be
+unlocked with #task_mutex_unlock from the same task.
+\param mutex Mutex
+\return true if mutex was locked, false if error */
+FOUNDATION_API bool
+task_mutex_lock(mutex_t* mutex);
+
+/*! Unlock a mutex locked with #task_mutex_lock
+\param mutex Mutex
+\return true if mutex was unlocked, false if error */
+FOUNDATION_API bool
+task_mutex_unlock(mutex_t* mutex);
+
+/*! Wait on a beacon from a task. If the beacon is not fired, a task executing on a worker
+thread suspends its fiber and the worker executes other tasks until the beacon fires. Outside
+of worker threads this blocks like #beacon_wait.
+\param beacon Beacon
+\return Index of event causing the beacon to fire, negative if error */
+FOUNDATION_API int
+task_beacon_wait(beacon_t* beacon);
+
+/*! Allocate a task graph
+\param capacity Initial capacity for number of tasks, zero for default
+\return New task graph */
+FOUNDATION_API task_graph_t*
+task_graph_allocate(size_t capacity);
+
+/*! Deallocate a task graph. The graph must not be executing.
+\param graph Task graph */
+FOUNDATION_API void
+task_graph_deallocate(task_graph_t* graph);
+
+/*! Remove all tasks and dependencies from a task graph. The graph must not be executing.
+\param graph Task graph */
+FOUNDATION_API void
+task_graph_clear(task_graph_t* graph);
+
+/*! Add a task to a task graph
+\param graph Task graph
+\param task Task description
+\return Index of task in graph */
+FOUNDATION_API size_t
+task_graph_add(task_graph_t* graph, const task_t* task);
+
+/*! Add a dependency edge, the task will not execute until the dependency has completed.
+Dependencies must not form a cycle.
+\param graph Task graph
+\param task Index of dependant task
+\param dependency Index of task it depends on */
+FOUNDATION_API void
+task_graph_depend(task_graph_t* graph, size_t task, size_t dependency);
+
+/*! Get number of tasks in a task graph
+\param graph Task graph
+\return Number of tasks */
+FOUNDATION_API size_t
+task_graph_size(const task_graph_t* graph);
+
+/*! Execute all tasks in a task graph, respecting dependencies
+\param graph Task graph
+\param scheduler Task scheduler
+\param counter Counter tracking completion of the graph, null to block until the graph
+       has completed */
+FOUNDATION_API void
+task_graph_execute(task_graph_t* graph, task_scheduler_t* scheduler, task_counter_t* counter);
+
+/*! Execute a function over an index range in parallel, splitting the range in chunks of
+at least the given grain size. The calling thread participates and the call returns when
+the entire range has been processed.
+\param scheduler Task scheduler
+\param begin Start of range
+\param end End of range (exclusive)
+\param grain Minimum number of indices in a chunk, zero for default
+\param fn Function called for each chunk
+\param arg Argument passed to function */
+FOUNDATION_API void
+task_parallel_for(task_scheduler_t* scheduler, size_t begin, size_t end, size_t grain,
+                  task_range_fn fn, void* arg);
+
+/*! Reduce an index range in parallel. Each participating thread accumulates chunks into a
+private partial result initialized to the identity value, and the partial results are then
+joined into the result by the calling thread. The join function must be associative and
+commutative since the assignment of chunks to partial results is not deterministic.
+\param scheduler Task scheduler
+\param begin Start of range
+\param end End of range (exclusive)
+\param grain Minimum number of indices in a chunk, zero for default
+\param reduce Function accumulating a chunk into a partial result
+\param join Function joining a partial result into the result
+\param result Result, should be initialized by the caller
+\param identity Identity value for partial results
+\param size Size of result value
+\param arg Argument passed to reduce and join functions */
+FOUNDATION_API void
+task_parallel_reduce(task_scheduler_t* scheduler, size_t begin, size_t end, size_t grain,
+                     task_reduce_fn reduce, task_join_fn join, void* result,
+                     const void* identity, size_t size, void* arg);
@@ -48,7 +48,7 @@ static GetCurrentProcessorNumberFn _fnGetCurrentProcessorNumber = GetCurrentProc
 #  include <pthread_np.h>
 #endif
 
-#if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_ANDROID || ( FOUNDATION_PLATFORM_WINDOWS && FOUNDATION_COMPILER_CLANG )
+#if !FOUNDATION_HAVE_NATIVE_TLS
 
 struct thread_local_block_t {
 	uint64_t     thread;
@@ -82,6 +82,11 @@ _allocate_thread_local_block(size_t size) {
 #endif
 
 FOUNDATION_DECLARE_THREAD_LOCAL(thread_t*, self, 0)
+
+#if FOUNDATION_HAVE_NATIVE_TLS
+FOUNDATION_THREADLOCAL foundation_thread_context_t _foundation_thread_context
+FOUNDATION_THREADLOCAL_MODEL;
+#endif
 static uint64_t _thread_main_id;
 
 int
@@ -102,7 +107,8 @@ _thread_initialize(void) {
 
 void
 _thread_finalize(void) {
-#if FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_ANDROID || ( FOUNDATION_PLATFORM_WINDOWS && FOUNDATION_COMPILER_CLANG )
+	thread_enable_pool(0);
+#if !FOUNDATION_HAVE_NATIVE_TLS
 	for (int i = 0; i < 1024; ++i) {
 		if (atomic_loadptr(&_thread_local_blocks[i].block)) {
 			void* block = atomic_loadptr(&_thread_local_blocks[i].block);
@@ -215,10 +221,8 @@ typedef void* thread_arg_t;
 #  error Not implemented
 #endif
 
-static thread_return_t FOUNDATION_THREADCALL
-_thread_entry(thread_arg_t data) {
-	thread_t* thread = GET_THREAD_PTR(data);
-
+static void
+_thread_run(thread_t* thread) {
 	thread->osid = thread_id();
 
 #if FOUNDATION_PLATFORM_WINDOWS && !BUILD_DEPLOY
@@ -237,6 +241,7 @@ _thread_entry(thread_arg_t data) {
 	           crash_guard_callback() ? " (guarded)" : "");
 
 	set_thread_self(thread);
+	stacktrace_thread_initialize();
 	atomic_store32(&thread->state, 1);
 	atomic_thread_fence_release();
 
@@ -266,10 +271,169 @@ _thread_entry(thread_arg_t data) {
 
 	set_thread_self(0);
 	thread_exit();
+}
 
+static thread_return_t FOUNDATION_THREADCALL
+_thread_entry(thread_arg_t data) {
+	_thread_run(GET_THREAD_PTR(data));
+	return 0;
+}
+
+static bool
+_thread_create(thread_return_t (FOUNDATION_THREADCALL* entry)(thread_arg_t), thread_arg_t arg,
+               unsigned int stacksize, uintptr_t* handle) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	*handle = _beginthreadex(nullptr, stacksize, entry, arg, 0, nullptr);
+	if (!*handle) {
+		int err = system_error();
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_OUT_OF_MEMORY,
+		           STRING_CONST("Unable to create thread: CreateThread failed: %.*s (%d)"),
+		           STRING_FORMAT(errmsg), err);
+		return false;
+	}
+#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
+	pthread_t id = 0;
+	int err = pthread_create(&id, 0, entry, arg);
+	FOUNDATION_UNUSED(stacksize);
+	if (err) {
+		string_const_t errmsg = system_error_message(err);
+		log_errorf(0, ERROR_OUT_OF_MEMORY,
+		           STRING_CONST("Unable to create thread: pthread_create failed: %.*s (%d)"),
+		           STRING_FORMAT(errmsg), err);
+		return false;
+	}
+	*handle = (uintptr_t)id;
+#else
+#  error Not implemented
+#endif
+	return true;
+}
+
+static void
+_thread_join(uintptr_t handle) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	WaitForSingleObject((HANDLE)handle, INFINITE);
+	CloseHandle((HANDLE)handle);
+#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
+	void* result = 0;
+	pthread_join((pthread_t)handle, &result);
+#else
+#  error Not implemented
+#endif
+}
+
+//OS thread parked in the thread pool between runs. The thread joining a run owns the runner
+//and either parks it as idle or terminates it, so a runner is never reassigned before the
+//previous run is joined
+struct thread_runner_t {
+	thread_runner_t* next;
+	thread_t* thread;
+	unsigned int stacksize;
+	uintptr_t handle;
+	semaphore_t wake;
+	semaphore_t done;
+};
+
+static lock_t           _thread_pool_lock;
+static thread_runner_t* _thread_pool_idle;
+static size_t           _thread_pool_idle_count;
+static size_t           _thread_pool_max;
+
+static thread_return_t FOUNDATION_THREADCALL
+_thread_runner_entry(thread_arg_t data) {
+	thread_runner_t* runner = data;
+	while (semaphore_wait(&runner->wake) && runner->thread) {
+		_thread_run(runner->thread);
+		semaphore_post(&runner->done);
+	}
 	return 0;
 }
 
+static void
+_thread_runner_terminate(thread_runner_t* runner) {
+	runner->thread = 0;
+	semaphore_post(&runner->wake);
+	_thread_join(runner->handle);
+	semaphore_finalize(&runner->wake);
+	semaphore_finalize(&runner->done);
+	memory_deallocate(runner);
+}
+
+static thread_runner_t*
+_thread_runner_acquire(unsigned int stacksize) {
+	thread_runner_t* runner;
+	thread_runner_t** prev;
+
+	lock_lock(&_thread_pool_lock);
+	for (prev = &_thread_pool_idle, runner = *prev; runner; prev = &runner->next, runner = *prev) {
+		if (runner->stacksize == stacksize) {
+			*prev = runner->next;
+			--_thread_pool_idle_count;
+			break;
+		}
+	}
+	lock_unlock(&_thread_pool_lock);
+
+	if (!runner) {
+		runner = memory_allocate(0, sizeof(thread_runner_t), 0,
+		                         MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		runner->stacksize = stacksize;
+		semaphore_initialize(&runner->wake, 0);
+		semaphore_initialize(&runner->done, 0);
+		if (!_thread_create(_thread_runner_entry, runner, stacksize, &runner->handle)) {
+			semaphore_finalize(&runner->wake);
+			semaphore_finalize(&runner->done);
+			memory_deallocate(runner);
+			return 0;
+		}
+	}
+	runner->next = 0;
+	return runner;
+}
+
+static void
+_thread_runner_release(thread_runner_t* runner) {
+	bool park = false;
+	lock_lock(&_thread_pool_lock);
+	if (_thread_pool_idle_count < _thread_pool_max) {
+		runner->next = _thread_pool_idle;
+		_thread_pool_idle = runner;
+		++_thread_pool_idle_count;
+		park = true;
+	}
+	lock_unlock(&_thread_pool_lock);
+	if (!park)
+		_thread_runner_terminate(runner);
+}
+
+void
+thread_enable_pool(size_t max_idle) {
+	thread_runner_t* terminate = 0;
+
+	lock_lock(&_thread_pool_lock);
+	_thread_pool_max = max_idle;
+	while (_thread_pool_idle_count > max_idle) {
+		thread_runner_t* runner = _thread_pool_idle;
+		_thread_pool_idle = runner->next;
+		--_thread_pool_idle_count;
+		runner->next = terminate;
+		terminate = runner;
+	}
+	lock_unlock(&_thread_pool_lock);
+
+	while (terminate) {
+		thread_runner_t* next = terminate->next;
+		_thread_runner_terminate(terminate);
+		terminate = next;
+	}
+}
+
+size_t
+thread_pool_idle(void) {
+	return _thread_pool_idle_count;
+}
+
 thread_t*
 thread_allocate(thread_fn fn, void* data, const char* name, size_t length,
                 thread_priority_t priority, unsigned int stacksize) {
@@ -312,55 +476,35 @@ bool
 thread_start(thread_t* thread) {
 	//Reset beacon
 	beacon_try_wait(&thread->beacon, 0);
-#if FOUNDATION_PLATFORM_WINDOWS
-	FOUNDATION_ASSERT(!thread->handle);
-	thread->handle = _beginthreadex(nullptr, thread->stacksize, _thread_entry, thread, 0, nullptr);
-	if (!thread->handle) {
-		int err = system_error();
-		string_const_t errmsg = system_error_message(err);
-		log_errorf(0, ERROR_OUT_OF_MEMORY,
-		           STRING_CONST("Unable to create thread: CreateThread failed: %.*s (%d)"),
-		           STRING_FORMAT(errmsg), err);
-		return false;
-	}
-#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
-	FOUNDATION_ASSERT(!thread->handle);
-	pthread_t id = 0;
-	int err = pthread_create(&id, 0, _thread_entry, thread);
-	if (err) {
-		string_const_t errmsg = system_error_message(err);
-		log_errorf(0, ERROR_OUT_OF_MEMORY,
-		           STRING_CONST("Unable to create thread: pthread_create failed: %.*s (%d)"),
-		           STRING_FORMAT(errmsg), err);
-		return false;
+	FOUNDATION_ASSERT(!thread->handle && !thread->runner);
+
+	if (_thread_pool_max) {
+		thread_runner_t* runner = _thread_runner_acquire(thread->stacksize);
+		if (!runner)
+			return false;
+		thread->runner = runner;
+		runner->thread = thread;
+		semaphore_post(&runner->wake);
+		return true;
 	}
-	thread->handle = (uintptr_t)id;
-#else
-#  error Not implemented
-#endif
 
-	return true;
+	return _thread_create(_thread_entry, thread, thread->stacksize, &thread->handle);
 }
 
 void*
 thread_join(thread_t* thread) {
-#if FOUNDATION_PLATFORM_WINDOWS
-	if (thread->handle) {
-		WaitForSingleObject((HANDLE)thread->handle, INFINITE);
-		CloseHandle((HANDLE)thread->handle);
+	if (thread->runner) {
+		thread_runner_t* runner = thread->runner;
+		semaphore_wait(&runner->done);
+		thread->runner = 0;
 		atomic_store32(&thread->state, 3);
+		_thread_runner_release(runner);
 	}
-	thread->handle = 0;
-#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
-	void* result = 0;
-	if (thread->handle) {
-		pthread_join((pthread_t)thread->handle, &result);
+	else if (thread->handle) {
+		_thread_join(thread->handle);
 		atomic_store32(&thread->state, 3);
 	}
 	thread->handle = 0;
-#else
-#  error Not implemented
-#endif
 	atomic_thread_fence_release();
 	return thread->result;
 }
@@ -516,10 +660,13 @@ thread_exit(void) {
 	thread_detach_jvm();
 #endif
 
+	_objectmap_thread_finalize();
+	_config_thread_finalize();
 	error_context_thread_finalize();
 	memory_context_thread_finalize();
+	_log_thread_finalize();
 
-#if FOUNDATION_PLATFORM_MACOSX || FOUNDATION_PLATFORM_IOS
+#if !FOUNDATION_HAVE_NATIVE_TLS
 	uint64_t curid = thread_id();
 	for (int i = 0; i < 1024; ++i) {
 		if ((_thread_local_blocks[i].thread == curid) && atomic_loadptr(&_thread_local_blocks[i].block)) {
@@ -530,6 +677,8 @@ thread_exit(void) {
 		}
 	}
 #endif
+
+	memory_thread_finalize();
 }
 
 #if FOUNDATION_PLATFORM_ANDROID
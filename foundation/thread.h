@@ -77,6 +77,20 @@ corresponding call to #thread_start
 FOUNDATION_API void*
 thread_join(thread_t* thread);
 
+/*! Enable recycling of OS threads. While enabled, a thread joined with #thread_join parks its
+OS thread as idle instead of terminating it, and #thread_start runs the next thread on an idle
+OS thread with the same stack size, replacing OS thread creation with a wakeup. Per-thread
+library state is finalized after each run as on thread termination. Idle OS threads exceeding
+the maximum are terminated, and all are terminated when the library is finalized.
+\param max_idle Maximum number of idle OS threads, zero to disable */
+FOUNDATION_API void
+thread_enable_pool(size_t max_idle);
+
+/*! Get number of idle OS threads parked in the thread pool
+\return Number of idle OS threads */
+FOUNDATION_API size_t
+thread_pool_idle(void);
+
 /*! Query if thread has started execution
 \param thread Thread
 \return true if started, false if not */
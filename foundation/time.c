@@ -28,9 +28,26 @@
 #  error Not implemented on this platform!
 #endif
 
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && FOUNDATION_COMPILER_MSVC
+#  include <intrin.h>
+#  define TIME_CYCLE_COUNTER 1
+#elif (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && (FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  include <cpuid.h>
+#  include <x86intrin.h>
+#  define TIME_CYCLE_COUNTER 1
+#elif FOUNDATION_ARCH_ARM_64 && (FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define TIME_CYCLE_COUNTER 1
+#else
+#  define TIME_CYCLE_COUNTER 0
+#endif
+
+//Milliseconds of operating system clock used to calibrate the cycle counter frequency
+#define TIME_CALIBRATION_MS 10
+
 static tick_t _time_freq;
 static double _time_oofreq;
 static tick_t _time_startup;
+static bool   _time_cycle_counter;
 
 #if FOUNDATION_PLATFORM_APPLE
 
@@ -43,6 +60,74 @@ absolutetime_to_nanoseconds(uint64_t mach_time, tick_t* clock) {
 
 #endif
 
+#if TIME_CYCLE_COUNTER
+
+static FOUNDATION_FORCEINLINE tick_t
+_time_cycle_counter_read(void) {
+#if FOUNDATION_ARCH_ARM_64
+	uint64_t counter;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(counter));
+	return (tick_t)counter;
+#else
+	return (tick_t)__rdtsc();
+#endif
+}
+
+//The cycle counter is only usable as a clock if it runs at a constant rate regardless
+//of frequency scaling and sleep states, and is synchronized across cores
+static bool
+_time_cycle_counter_invariant(void) {
+#if FOUNDATION_ARCH_ARM_64
+	//Generic timer virtual counter runs at a fixed system frequency
+	return true;
+#elif FOUNDATION_COMPILER_MSVC
+	int info[4];
+	__cpuid(info, (int)0x80000000);
+	if ((unsigned int)info[0] < 0x80000007U)
+		return false;
+	__cpuid(info, (int)0x80000007);
+	return (info[3] & (1 << 8)) != 0;
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (!__get_cpuid(0x80000000U, &eax, &ebx, &ecx, &edx) || (eax < 0x80000007U))
+		return false;
+	if (!__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx))
+		return false;
+	return (edx & (1U << 8)) != 0;
+#endif
+}
+
+static tick_t
+_time_cycle_counter_frequency(void) {
+#if FOUNDATION_ARCH_ARM_64
+	uint64_t freq;
+	__asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+	return (tick_t)freq;
+#else
+	//Measure counter against operating system clock, spinning rather than sleeping to
+	//avoid scheduling delays between the clock and counter reads
+	tick_t start, end, os_elapsed;
+	tick_t counter_start, counter_end;
+	tick_t duration = (_time_freq * TIME_CALIBRATION_MS) / 1000LL;
+
+	start = time_current();
+	counter_start = _time_cycle_counter_read();
+	do {
+		end = time_current();
+	}
+	while ((end - start) < duration);
+	counter_end = _time_cycle_counter_read();
+	os_elapsed = end - start;
+
+	if ((counter_end <= counter_start) || (os_elapsed <= 0))
+		return 0;
+	return (tick_t)(((double)(counter_end - counter_start) * (double)_time_freq) /
+	                (double)os_elapsed);
+#endif
+}
+
+#endif
+
 int
 _time_initialize(void) {
 #if FOUNDATION_PLATFORM_WINDOWS
@@ -63,6 +148,17 @@ _time_initialize(void) {
 #  error Not implemented
 #endif
 
+	_time_cycle_counter = false;
+#if TIME_CYCLE_COUNTER
+	if (_foundation_config.time_cycle_counter && _time_cycle_counter_invariant()) {
+		tick_t freq = _time_cycle_counter_frequency();
+		if (freq > 0) {
+			_time_freq = freq;
+			_time_cycle_counter = true;
+		}
+	}
+#endif
+
 	_time_oofreq  = 1.0 / (double)_time_freq;
 	_time_startup = time_current();
 
@@ -75,6 +171,11 @@ _time_finalize(void) {
 
 tick_t
 time_current(void) {
+#if TIME_CYCLE_COUNTER
+	if (_time_cycle_counter)
+		return _time_cycle_counter_read();
+#endif
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 	tick_t curclock;
@@ -98,6 +199,46 @@ time_current(void) {
 #endif
 }
 
+tick_t
+_time_system_ns(void) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	tick_t curclock, freq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&freq);
+	QueryPerformanceCounter((LARGE_INTEGER*)&curclock);
+	return (tick_t)((double)curclock * (1000000000.0 / (double)freq));
+#elif FOUNDATION_PLATFORM_APPLE
+	mach_timebase_info_data_t info;
+	mach_timebase_info(&info);
+	return (tick_t)(mach_absolute_time() * info.numer / info.denom);
+#elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
+	struct timespec ts = { .tv_sec = 0, .tv_nsec = 0 };
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((tick_t)ts.tv_sec * 1000000000LL) + (tick_t)ts.tv_nsec;
+#else
+#  error Not implemented
+#endif
+}
+
+tick_t
+time_current_coarse(void) {
+#if TIME_CYCLE_COUNTER
+	if (_time_cycle_counter)
+		return _time_cycle_counter_read();
+#endif
+
+#if (FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL) && defined(CLOCK_MONOTONIC_COARSE)
+
+	struct timespec ts = { .tv_sec = 0, .tv_nsec = 0 };
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+	return ((tick_t)ts.tv_sec * 1000000000LL) + (tick_t)ts.tv_nsec;
+
+#else
+
+	return time_current();
+
+#endif
+}
+
 tick_t
 time_startup(void) {
 	return _time_startup;
@@ -108,6 +249,11 @@ time_ticks_per_second(void) {
 	return _time_freq;
 }
 
+bool
+time_is_cycle_counter(void) {
+	return _time_cycle_counter;
+}
+
 tick_t
 time_diff(const tick_t from, const tick_t to) {
 	return (to - from);
@@ -123,6 +269,11 @@ tick_t
 time_elapsed_ticks(const tick_t t) {
 	tick_t dt;
 
+#if TIME_CYCLE_COUNTER
+	if (_time_cycle_counter)
+		return _time_cycle_counter_read() - t;
+#endif
+
 #if FOUNDATION_PLATFORM_WINDOWS
 
 	tick_t curclock = t;
@@ -186,3 +337,18 @@ time_system(void) {
 #  error Not implemented
 #endif
 }
+
+tick_t
+time_system_coarse(void) {
+#if (FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL) && defined(CLOCK_REALTIME_COARSE)
+
+	struct timespec ts = { .tv_sec = 0, .tv_nsec = 0 };
+	clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+	return ((int64_t)ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
+
+#else
+
+	return time_system();
+
+#endif
+}
@@ -22,11 +22,22 @@ Time measurements. */
 
 /*! Get current timestamp, in ticks of system-specific frequency (queryable with
 #time_ticks_per_second), measured from some system-specific base timestamp and not in sync
-with other timestamps.
+with other timestamps. If enabled in the foundation config and supported by the CPU, the
+timestamp is read from the CPU cycle counter, see #time_is_cycle_counter.
 \return Current timestamp */
 FOUNDATION_API tick_t
 time_current(void);
 
+/*! Get current timestamp with coarse resolution, in the same ticks and from the same base as
+#time_current. On Linux and Android the timestamp is read from the coarse monotonic clock,
+which has a resolution of the kernel timer tick (typically 1-4ms) and is read without a
+system call or clock hardware access. If the cycle counter is used, or no coarse clock is
+available, this is equal to #time_current. The coarse clock may lag #time_current by up to
+its resolution.
+\return Current coarse timestamp */
+FOUNDATION_API tick_t
+time_current_coarse(void);
+
 /*! Calculate time difference.
 \param from Start timestamp
 \param to End timestamp
@@ -51,6 +62,15 @@ time_elapsed_ticks(const tick_t since);
 FOUNDATION_API tick_t
 time_ticks_per_second(void);
 
+/*! Query if timestamps are read from the CPU cycle counter rather than the operating system
+monotonic clock. The cycle counter is used if enabled by the time_cycle_counter field of
+#foundation_config_t and the counter runs at a constant rate synchronized across cores,
+which is the invariant TSC on x86 and the generic timer virtual counter on ARM64. On x86
+the counter frequency is calibrated against the operating system clock on initialization.
+\return true if cycle counter is used, false if operating system clock is used */
+FOUNDATION_API bool
+time_is_cycle_counter(void);
+
 /*! Get ticks as seconds (effectively calculating <code>ticks / time_ticks_per_second()</code>).
 \param dt Deltatime in ticks
 \return Deltatime in seconds */
@@ -67,3 +87,10 @@ time_startup(void);
 FOUNDATION_API tick_t
 time_system(void);
 
+/*! Get system time with coarse resolution, in milliseconds since the epoch (UNIX time). On
+Linux and Android the time is read from the coarse realtime clock with a resolution of the
+kernel timer tick, on other platforms this is equal to #time_system.
+\return Current coarse timestamp, in milliseconds */
+FOUNDATION_API tick_t
+time_system_coarse(void);
+
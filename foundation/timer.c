@@ -0,0 +1,391 @@
+/* timer.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+
+#define TIMER_WHEEL_BITS   6
+#define TIMER_WHEEL_SLOTS  (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK   ((uint64_t)TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 5
+#define TIMER_WHEEL_RANGE  ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+#define TIMER_SLOT_NONE    0xFFFFFFFFU
+
+typedef struct timer_entry_t timer_entry_t;
+typedef struct timer_dispatch_t timer_dispatch_t;
+
+struct timer_entry_t {
+	//Expiry tick, in milliseconds since service start
+	uint64_t expiry;
+	unsigned int period;
+	uint32_t generation;
+	//Wheel slot as level * slots + index, or TIMER_SLOT_NONE if not active
+	uint32_t slot;
+	timer_entry_t* next;
+	timer_entry_t* prev;
+	task_fn fn;
+	void* arg;
+};
+
+struct timer_dispatch_t {
+	timer_id_t id;
+	task_fn fn;
+	void* arg;
+};
+
+struct timer_service_t {
+	lock_t lock;
+	thread_t thread;
+	atomic32_t stop;
+	task_scheduler_t* scheduler;
+	event_stream_t* events;
+	tick_t base;
+	tick_t ticks_per_ms;
+	//Next tick to process, all earlier ticks are processed
+	uint64_t current;
+	//Tick the timer thread sleeps until
+	uint64_t wake;
+	size_t capacity;
+	size_t count;
+	timer_entry_t* entries;
+	timer_entry_t* free;
+	uint64_t occupied[TIMER_WHEEL_LEVELS];
+	timer_entry_t* slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	//Expired timers pending dispatch, only accessed by timer thread
+	timer_dispatch_t* dispatch;
+	task_t* tasks;
+};
+
+static FOUNDATION_FORCEINLINE unsigned int
+_timer_first_bit(uint64_t mask) {
+#if FOUNDATION_COMPILER_MSVC
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)mask))
+		return (unsigned int)index;
+	_BitScanForward(&index, (unsigned long)(mask >> 32ULL));
+	return (unsigned int)index + 32;
+#else
+	return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+static uint64_t
+_timer_now(const timer_service_t* service) {
+	tick_t elapsed = time_current() - service->base;
+	return (elapsed > 0) ? (uint64_t)(elapsed / service->ticks_per_ms) : 0;
+}
+
+static timer_id_t
+_timer_id(const timer_service_t* service, const timer_entry_t* entry) {
+	return ((uint64_t)entry->generation << 32ULL) | (uint64_t)((entry - service->entries) + 1);
+}
+
+static void
+_timer_link(timer_service_t* service, timer_entry_t* entry) {
+	uint64_t expiry = entry->expiry;
+	uint64_t delta;
+	uint32_t level = 0;
+	uint32_t index;
+
+	if (expiry < service->current)
+		expiry = service->current;
+	delta = expiry - service->current;
+	while ((level < (TIMER_WHEEL_LEVELS - 1)) &&
+	        (delta >= ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1)))))
+		++level;
+	//Timers beyond the wheel range are placed in the last slot and requeued when cascaded
+	if (delta >= TIMER_WHEEL_RANGE)
+		expiry = service->current + TIMER_WHEEL_RANGE - 1;
+	index = (uint32_t)((expiry >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+
+	entry->slot = (level * TIMER_WHEEL_SLOTS) + index;
+	entry->prev = 0;
+	entry->next = service->slot[level][index];
+	if (entry->next)
+		entry->next->prev = entry;
+	service->slot[level][index] = entry;
+	service->occupied[level] |= (1ULL << index);
+}
+
+static void
+_timer_unlink(timer_service_t* service, timer_entry_t* entry) {
+	uint32_t level = entry->slot / TIMER_WHEEL_SLOTS;
+	uint32_t index = entry->slot % TIMER_WHEEL_SLOTS;
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		service->slot[level][index] = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	if (!service->slot[level][index])
+		service->occupied[level] &= ~(1ULL << index);
+	entry->slot = TIMER_SLOT_NONE;
+}
+
+static void
+_timer_free(timer_service_t* service, timer_entry_t* entry) {
+	++entry->generation;
+	entry->slot = TIMER_SLOT_NONE;
+	entry->next = service->free;
+	service->free = entry;
+	--service->count;
+}
+
+//Take the list of a slot and clear it
+static timer_entry_t*
+_timer_take(timer_service_t* service, uint32_t level, uint32_t index) {
+	timer_entry_t* list = service->slot[level][index];
+	service->slot[level][index] = 0;
+	service->occupied[level] &= ~(1ULL << index);
+	return list;
+}
+
+//Process the current tick, cascading higher levels at wheel boundaries and queueing expired
+//timers for dispatch
+static void
+_timer_tick(timer_service_t* service) {
+	uint64_t tick = service->current;
+	uint32_t level;
+	timer_entry_t* entry;
+
+	for (level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+		uint32_t index;
+		if ((tick >> (TIMER_WHEEL_BITS * (level - 1))) & TIMER_WHEEL_MASK)
+			break;
+		index = (uint32_t)((tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+		entry = _timer_take(service, level, index);
+		while (entry) {
+			timer_entry_t* next = entry->next;
+			_timer_link(service, entry);
+			entry = next;
+		}
+	}
+
+	//Periodic timers are requeued relative to the next tick
+	entry = _timer_take(service, 0, (uint32_t)(tick & TIMER_WHEEL_MASK));
+	service->current = tick + 1;
+	while (entry) {
+		timer_entry_t* next = entry->next;
+		timer_dispatch_t dispatch = {_timer_id(service, entry), entry->fn, entry->arg};
+		array_push_memcpy(service->dispatch, &dispatch);
+		if (entry->period) {
+			entry->expiry += entry->period;
+			_timer_link(service, entry);
+		}
+		else {
+			_timer_free(service, entry);
+		}
+		entry = next;
+	}
+}
+
+//Earliest tick at or after the current tick where a slot holding timers is processed
+static uint64_t
+_timer_next(const timer_service_t* service) {
+	uint64_t next = (uint64_t)-1;
+	uint32_t level;
+	if (!service->count)
+		return next;
+	for (level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+		uint32_t shift = TIMER_WHEEL_BITS * level;
+		uint64_t position = service->current >> shift;
+		uint64_t index = position & TIMER_WHEEL_MASK;
+		uint64_t occupied = service->occupied[level];
+		//Higher level slots at the current index were already cascaded and are due on the
+		//next rotation, unless the current tick is the boundary which cascades them
+		uint64_t ahead = (service->current & ((1ULL << shift) - 1)) ? (index + 1) : index;
+		uint64_t pending = (ahead < TIMER_WHEEL_SLOTS) ? (occupied & ~((1ULL << ahead) - 1)) : 0;
+		uint64_t candidate;
+		if (pending) {
+			candidate = ((position & ~TIMER_WHEEL_MASK) |
+			             (uint64_t)_timer_first_bit(pending)) << shift;
+			if (candidate < next)
+				next = candidate;
+		}
+		if (occupied & ~pending) {
+			candidate = ((position | TIMER_WHEEL_MASK) + 1) << shift;
+			if (candidate < next)
+				next = candidate;
+		}
+	}
+	return (next > service->current) ? next : service->current;
+}
+
+static void
+_timer_dispatch(timer_service_t* service) {
+	size_t idisp, dsize;
+	for (idisp = 0, dsize = array_size(service->dispatch); idisp < dsize; ++idisp) {
+		const timer_dispatch_t* dispatch = service->dispatch + idisp;
+		if (dispatch->fn && service->scheduler) {
+			task_t task = {dispatch->fn, dispatch->arg, {STRING_CONST("timer")}};
+			array_push_memcpy(service->tasks, &task);
+		}
+		else if (dispatch->fn) {
+			dispatch->fn(dispatch->arg);
+		}
+		else {
+			timer_event_payload_t payload = {dispatch->id, dispatch->arg};
+			event_post(service->events, FOUNDATIONEVENT_TIMER, 0, 0, &payload, sizeof(payload));
+		}
+	}
+	if (service->tasks)
+		task_submit(service->scheduler, service->tasks, array_size(service->tasks), 0);
+	array_clear(service->dispatch);
+	array_clear(service->tasks);
+}
+
+static void*
+_timer_thread(void* arg) {
+	timer_service_t* service = arg;
+	while (!atomic_load32(&service->stop)) {
+		uint64_t now = _timer_now(service);
+		uint64_t next;
+		unsigned int wait = 0;
+
+		lock_lock(&service->lock);
+		while (service->current <= now) {
+			//Skip ahead over ticks without any slot to process
+			next = _timer_next(service);
+			if (next > now) {
+				service->current = now + 1;
+				break;
+			}
+			service->current = next;
+			_timer_tick(service);
+		}
+		next = _timer_next(service);
+		service->wake = next;
+		if (next != (uint64_t)-1)
+			wait = (next - now < 0xFFFFFFFFULL) ? (unsigned int)(next - now) : 0xFFFFFFFFU;
+		lock_unlock(&service->lock);
+
+		_timer_dispatch(service);
+
+		if (wait)
+			thread_try_wait(wait);
+		else
+			thread_wait();
+	}
+	return 0;
+}
+
+timer_service_t*
+timer_service_allocate(size_t capacity, task_scheduler_t* scheduler, event_stream_t* events) {
+	timer_service_t* service;
+	size_t ientry;
+
+	service = memory_allocate(0, sizeof(timer_service_t), 0,
+	                          MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	lock_initialize(&service->lock);
+	service->scheduler = scheduler;
+	service->events = events;
+	service->capacity = capacity;
+	service->entries = capacity ? memory_allocate(0, sizeof(timer_entry_t) * capacity, 0,
+	                                              MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED) : 0;
+	for (ientry = capacity; ientry; --ientry) {
+		timer_entry_t* entry = service->entries + (ientry - 1);
+		entry->slot = TIMER_SLOT_NONE;
+		entry->next = service->free;
+		service->free = entry;
+	}
+	service->ticks_per_ms = time_ticks_per_second() / 1000;
+	if (service->ticks_per_ms < 1)
+		service->ticks_per_ms = 1;
+	service->base = time_current();
+	service->wake = (uint64_t)-1;
+
+	thread_initialize(&service->thread, _timer_thread, service, STRING_CONST("timer"),
+	                  THREAD_PRIORITY_ABOVENORMAL, 0);
+	thread_start(&service->thread);
+
+	return service;
+}
+
+void
+timer_service_deallocate(timer_service_t* service) {
+	if (!service)
+		return;
+	atomic_store32(&service->stop, 1);
+	thread_signal(&service->thread);
+	thread_finalize(&service->thread);
+
+	array_deallocate(service->dispatch);
+	array_deallocate(service->tasks);
+	memory_deallocate(service->entries);
+	memory_deallocate(service);
+}
+
+timer_id_t
+timer_add(timer_service_t* service, unsigned int delay, unsigned int period, task_fn fn,
+          void* arg) {
+	timer_entry_t* entry;
+	timer_id_t id;
+	bool signal;
+
+	if (!fn && !service->events)
+		return 0;
+
+	lock_lock(&service->lock);
+	entry = service->free;
+	if (!entry) {
+		lock_unlock(&service->lock);
+		return 0;
+	}
+	service->free = entry->next;
+	++service->count;
+
+	entry->expiry = _timer_now(service) + delay;
+	entry->period = period;
+	entry->fn = fn;
+	entry->arg = arg;
+	_timer_link(service, entry);
+	id = _timer_id(service, entry);
+
+	//Wake the timer thread if the timer is due before its planned wakeup
+	signal = (entry->expiry < service->wake);
+	if (signal)
+		service->wake = entry->expiry;
+	lock_unlock(&service->lock);
+
+	if (signal)
+		thread_signal(&service->thread);
+	return id;
+}
+
+bool
+timer_cancel(timer_service_t* service, timer_id_t id) {
+	size_t index = (size_t)(id & 0xFFFFFFFFULL);
+	timer_entry_t* entry;
+	bool cancelled = false;
+
+	if (!index || (index > service->capacity))
+		return false;
+
+	entry = service->entries + (index - 1);
+	lock_lock(&service->lock);
+	if ((entry->generation == (uint32_t)(id >> 32ULL)) && (entry->slot != TIMER_SLOT_NONE)) {
+		_timer_unlink(service, entry);
+		_timer_free(service, entry);
+		cancelled = true;
+	}
+	lock_unlock(&service->lock);
+	return cancelled;
+}
+
+size_t
+timer_count(timer_service_t* service) {
+	size_t count;
+	lock_lock(&service->lock);
+	count = service->count;
+	lock_unlock(&service->lock);
+	return count;
+}
@@ -0,0 +1,74 @@
+/* timer.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file timer.h
+\brief Timer service
+
+Timer service managing one-shot and periodic timers with millisecond resolution. Timers are
+kept in a hierarchical timer wheel of five levels with 64 slots each, covering delays of up
+to 2^30 milliseconds before re-queueing, with constant time add and cancel. The wheel is
+driven by a single thread which sleeps until the next slot holding timers is due.
+
+An expired timer either calls its function, submitted as a task to the task scheduler of the
+service if it has one and called directly on the timer thread if not, or posts a
+#FOUNDATIONEVENT_TIMER event with a #timer_event_payload_t payload to the event stream of the
+service. Callbacks executed on the timer thread must be short, as they delay other timers. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Allocate a timer service and start the timer thread
+\param capacity Maximum number of active timers
+\param scheduler Task scheduler executing timer functions, null to call timer functions on the
+                 timer thread
+\param events Event stream receiving events for timers without a function, may be null
+\return New timer service */
+FOUNDATION_API timer_service_t*
+timer_service_allocate(size_t capacity, task_scheduler_t* scheduler, event_stream_t* events);
+
+/*! Stop the timer thread and deallocate the timer service. Active timers are discarded
+without firing.
+\param service Timer service */
+FOUNDATION_API void
+timer_service_deallocate(timer_service_t* service);
+
+/*! Add a timer. If a function is given it is called when the timer expires, otherwise a
+#FOUNDATIONEVENT_TIMER event is posted to the event stream of the service. A periodic timer is
+rescheduled relative to its previous expiry time, not the time it was dispatched, and keeps
+firing until cancelled.
+\param service Timer service
+\param delay Delay until the first expiry in milliseconds, zero to expire on the next tick
+\param period Period in milliseconds for a periodic timer, zero for a one-shot timer
+\param fn Function to call, null to post an event
+\param arg Argument passed to the function, or in the event payload
+\return Timer identifier, zero if the service is at capacity or the timer has neither a
+        function nor an event stream to post to */
+FOUNDATION_API timer_id_t
+timer_add(timer_service_t* service, unsigned int delay, unsigned int period, task_fn fn,
+          void* arg);
+
+/*! Cancel a timer. A timer that has already been dispatched for its last expiry can no longer
+be cancelled, and a cancelled periodic timer may still have a dispatched callback or event
+being processed.
+\param service Timer service
+\param id Timer identifier
+\return true if the timer was active and is cancelled, false if not */
+FOUNDATION_API bool
+timer_cancel(timer_service_t* service, timer_id_t id);
+
+/*! Get number of active timers
+\param service Timer service
+\return Number of active timers */
+FOUNDATION_API size_t
+timer_count(timer_service_t* service);
@@ -207,6 +207,20 @@ typedef enum {
 	STREAMTYPE_PIPE,
 	/*! Standard stream (stdin, stderr, stdout) */
 	STREAMTYPE_STDSTREAM,
+	/*! Buffered stream wrapping another stream */
+	STREAMTYPE_BUFFERED,
+	/*! Memory mapped file stream, read-only or copy-on-write */
+	STREAMTYPE_MAPPED,
+	/*! Compressed stream wrapping another stream */
+	STREAMTYPE_COMPRESSED,
+	/*! Checksum stream wrapping another stream */
+	STREAMTYPE_CHECKSUM,
+	/*! Segmented memory buffer stream */
+	STREAMTYPE_SEGMENTED,
+	/*! Base64 encoding or decoding stream wrapping another stream */
+	STREAMTYPE_BASE64,
+	/*! Encrypting and decrypting stream wrapping another stream */
+	STREAMTYPE_CIPHER,
 	/*! Last reserved built-in stream type, not a valid type */
 	STREAMTYPE_LAST_RESERVED = 0x0FFF
 } stream_type_t;
@@ -237,6 +251,21 @@ typedef enum {
 	THREAD_PRIORITY_TIMECRITICAL
 } thread_priority_t;
 
+/*! Memory order for explicit atomic operations, see atomic.h. Values match the compiler
+builtin memory order constants */
+typedef enum {
+	/*! Only atomicity, no ordering of other memory accesses */
+	MEMORY_ORDER_RELAXED = 0,
+	/*! Later memory accesses are not reordered before the operation */
+	MEMORY_ORDER_ACQUIRE = 2,
+	/*! Earlier memory accesses are not reordered after the operation */
+	MEMORY_ORDER_RELEASE = 3,
+	/*! Both acquire and release order, for read-modify-write operations */
+	MEMORY_ORDER_ACQ_REL = 4,
+	/*! Acquire and release order and a single total order of all such operations */
+	MEMORY_ORDER_SEQ_CST = 5
+} memory_order_t;
+
 /*! Foundation library level event identifiers. These event identifiers are only
 valid in conjunction with foundation event streams. Other event streams will use
 their own event identifiers with the same value, and event streams should be treated
@@ -263,7 +292,13 @@ typedef enum {
 	/*! Low memory warning */
 	FOUNDATIONEVENT_LOW_MEMORY_WARNING,
 	/*! Device orientation changed */
-	FOUNDATIONEVENT_DEVICE_ORIENTATION
+	FOUNDATIONEVENT_DEVICE_ORIENTATION,
+	/*! Asynchronous file I/O request completed, payload is a fs_async_result_t */
+	FOUNDATIONEVENT_FILE_ASYNC_COMPLETE,
+	/*! Monitored config file was reloaded, payload is a config_event_payload_t */
+	FOUNDATIONEVENT_CONFIG_CHANGED,
+	/*! Timer expired, payload is a timer_event_payload_t */
+	FOUNDATIONEVENT_TIMER
 } foundation_event_id;
 
 /*! Block cipher mode of operation, see
@@ -276,9 +311,88 @@ typedef enum {
 	/*! Cipher feedback */
 	BLOCKCIPHER_CFB,
 	/*! Output feedback */
-	BLOCKCIPHER_OFB
+	BLOCKCIPHER_OFB,
+	/*! Counter, encrypting successive values of the initialization vector. Blocks are
+	independent and can be processed in any order, and the final block may be partial */
+	BLOCKCIPHER_CTR
 } blockcipher_mode_t;
 
+/*! Log file synchronization policy, see #log_set_file */
+typedef enum {
+	/*! Buffered data is written when the buffer is full, when the flush interval has elapsed
+	and on explicit flush */
+	LOGFILE_SYNC_NONE = 0,
+	/*! Buffered data is also written immediately after error and panic messages */
+	LOGFILE_SYNC_ERROR,
+	/*! Buffered data is written immediately after error and panic messages and committed to
+	storage each time it is written */
+	LOGFILE_SYNC_ALWAYS
+} log_file_sync_t;
+
+/*! Access pattern hint for memory mapped file streams, see #fs_map_advise */
+typedef enum {
+	/*! No specific access pattern */
+	FS_MAP_ADVICE_NORMAL = 0,
+	/*! Data is accessed sequentially, pages can be read ahead aggressively and dropped
+	soon after access */
+	FS_MAP_ADVICE_SEQUENTIAL,
+	/*! Data is accessed in random order, read ahead is not useful */
+	FS_MAP_ADVICE_RANDOM,
+	/*! Data will be accessed soon, start reading it into memory */
+	FS_MAP_ADVICE_WILLNEED
+} fs_map_advice_t;
+
+/*! Type of an entry in a directory listing, see #fs_list_directory */
+typedef enum {
+	/*! Regular file */
+	FS_ENTRY_FILE = 0,
+	/*! Directory */
+	FS_ENTRY_DIRECTORY,
+	/*! Other type of entry, like device, socket or named pipe, or a broken symbolic link */
+	FS_ENTRY_OTHER
+} fs_entry_type_t;
+
+/*! Type of asynchronous file system request, see #fs_async_submit */
+typedef enum {
+	/*! Positional read from a file stream, see #fs_async_read */
+	FS_ASYNC_READ = 0,
+	/*! Positional write to a file stream, see #fs_async_write */
+	FS_ASYNC_WRITE,
+	/*! Query type, size and modification time of a path */
+	FS_ASYNC_STAT,
+	/*! Remove a file, see #fs_remove_file */
+	FS_ASYNC_REMOVE_FILE,
+	/*! Create a directory including missing parent directories, see #fs_make_directory */
+	FS_ASYNC_MAKE_DIRECTORY,
+	/*! Copy a file, see #fs_copy_file */
+	FS_ASYNC_COPY_FILE,
+	/*! Update the modification time of a file, see #fs_touch */
+	FS_ASYNC_TOUCH
+} fs_async_op_t;
+
+/*! Checksum algorithm, see #checksum_initialize */
+typedef enum {
+	/*! 32-bit CRC using the Castagnoli polynomial (CRC-32C), hardware accelerated on SSE4.2
+	and ARMv8 CRC capable processors */
+	CHECKSUM_CRC32C = 0,
+	/*! 64-bit xxHash (XXH64) with seed 0 */
+	CHECKSUM_XXHASH64
+} checksum_type_t;
+
+/*! Access pattern hint for streams, see #stream_advise */
+typedef enum {
+	/*! No specific access pattern */
+	STREAM_ADVICE_NORMAL = 0,
+	/*! Data is accessed sequentially, data can be read ahead aggressively */
+	STREAM_ADVICE_SEQUENTIAL,
+	/*! Data is accessed in random order, read ahead is not useful */
+	STREAM_ADVICE_RANDOM,
+	/*! Data will be accessed soon, start reading it into memory */
+	STREAM_ADVICE_WILLNEED,
+	/*! Data will not be accessed in the near future, cached data can be dropped */
+	STREAM_ADVICE_DONTNEED
+} stream_advice_t;
+
 /*! Radix sort data types */
 typedef enum {
 	/*! 32-bit signed integer */
@@ -292,7 +406,9 @@ typedef enum {
 	/*! 32-bit floating point */
 	RADIXSORT_FLOAT32,
 	/*! 64-bit floating point */
-	RADIXSORT_FLOAT64
+	RADIXSORT_FLOAT64,
+	/*! 128-bit unsigned integer (uint128_t) with word[1] as the most significant word */
+	RADIXSORT_UINT128
 } radixsort_data_t;
 
 /*! Device orientation */
@@ -315,6 +431,33 @@ typedef enum {
 	DEVICEORIENTATION_FACEDOWN
 } device_orientation_t;
 
+/*! Record types in a crash dump written by #crash_guard on POSIX platforms */
+typedef enum {
+	/*! Raw machine context of the crashing thread, platform specific layout */
+	CRASH_DUMP_CONTEXT = 1,
+	/*! Stack trace of the crashing thread as 64-bit frame addresses */
+	CRASH_DUMP_STACKTRACE,
+	/*! Stack memory of the crashing thread, 64-bit start address followed by the memory */
+	CRASH_DUMP_STACK,
+	/*! Loaded modules, each a 64-bit load address, 32-bit name length and the name, starting
+	with the executable */
+	CRASH_DUMP_MODULES,
+	/*! Most recent log output as text */
+	CRASH_DUMP_LOG,
+	/*! Most recent messages of all threads recorded by the log flight recorder as text, only
+	written if the recorder is enabled */
+	CRASH_DUMP_RECORDER
+} crash_dump_record_t;
+
+/*! Accuracy of batch math functions */
+typedef enum {
+	/*! Results within a few units in the last place of the correctly rounded result over the
+	full argument range */
+	MATH_ACCURACY_PRECISE = 0,
+	/*! Shorter approximations with a relative error up to about 1e-4 */
+	MATH_ACCURACY_FAST
+} math_accuracy_t;
+
 /*! Memory hint, memory allocationis persistent (retained when function returns) */
 #define MEMORY_PERSISTENT       0
 /*! Memory hint, memory is temporary (extremely short lived and generally freed
@@ -326,6 +469,23 @@ before function returns or scope ends) */
 #define MEMORY_32BIT_ADDRESS    (1U<<2)
 /*! Memory flag, memory should be initialized to zero during allocation */
 #define MEMORY_ZERO_INITIALIZED (1U<<3)
+/*! Memory flag, memory should be mapped directly from the operating system and backed by
+huge pages (large pages on Windows) if available */
+#define MEMORY_HUGE_PAGES       (1U<<4)
+/*! Memory flag, memory should be mapped directly from the operating system and placed on the
+NUMA memory node of the hardware thread the calling thread is running on */
+#define MEMORY_NODE_LOCAL       (1U<<5)
+/*! Memory flag, memory should be mapped directly from the operating system and placed on
+the given NUMA memory node (0-254), see #system_hardware_nodes */
+#define MEMORY_NODE(node)       ((((unsigned int)(node)) + 1U) << 24U)
+/*! Mask of memory node bits in memory hints, see #MEMORY_NODE */
+#define MEMORY_NODE_MASK        (0xFFU<<24)
+
+/*! Number of power-of-two buckets in memory histograms */
+#define MEMORY_HISTOGRAM_BUCKETS    32
+/*! Lifetime in microseconds below which a deallocated block is counted as short lived in
+memory histograms, making it a candidate for the MEMORY_TEMPORARY hint */
+#define MEMORY_HISTOGRAM_SHORT_LIVED 1000
 
 /*! Event flag, event is delayed and will be delivered at a later timestamp */
 #define EVENTFLAG_DELAY 1U
@@ -348,8 +508,17 @@ a normal windowing system interaction loop */
 #define STREAM_ATEND    (1U<<4)
 /*! Stream flag/mode, stream I/O is binary (I/O is in ascii if flag not set) */
 #define STREAM_BINARY   (1U<<5)
-/*! Stream flag, stream is synchronized on each write */
+/*! Stream flag, stream data is committed to storage on each flush and when closed */
 #define STREAM_SYNC     (1U<<6)
+/*! Stream flag, stream is expected to be accessed sequentially from start to end, allowing
+aggressive read ahead. Ignored by stream types without access pattern hints */
+#define STREAM_HINT_SEQUENTIAL (1U<<7)
+/*! Stream flag, stream is expected to be accessed in random order, disabling read ahead.
+Ignored by stream types without access pattern hints */
+#define STREAM_HINT_RANDOM     (1U<<8)
+
+/*! Pack entry flag, entry data is compressed in the pack, see #pack_builder_add */
+#define PACK_ENTRY_COMPRESSED 1U
 
 /*! Process flag, spawn method will block until process ends and then return
 process exit code */
@@ -365,6 +534,11 @@ an error occurs during spawning */
 #define PROCESS_WINDOWS_USE_SHELLEXECUTE   (1U<<3)
 /*! Process flag, use LSOpenApplication instead of fork/execve (MacOSX platform only) */
 #define PROCESS_MACOSX_USE_OPENAPPLICATION (1U<<4)
+/*! Process flag, create a separate stderr pipe to process */
+#define PROCESS_STDERR                     (1U<<5)
+/*! Process flag, make stdout/stderr pipes non-blocking for polling many processes from a
+single thread, see #pipe_set_nonblocking */
+#define PROCESS_NONBLOCKING                (1U<<6)
 
 /*! Process exit code, returned when given invalid arguments */
 #define PROCESS_INVALID_ARGS      0x7FFFFFF0
@@ -397,10 +571,17 @@ typedef int64_t       tick_t;
 typedef real          deltatime_t;
 /*! Object handle used for identifying reference counted objects */
 typedef uint64_t      object_t;
-/*! Default is 16 bit, typedef to 32 bit if need to sort more than 2^16 items in one array */
+/*! Index type for #radixsort_t, use #radixsort32_t or #radixsort64_t to sort more than
+2^16-1 items in one array */
 typedef uint16_t      radixsort_index_t;
+/*! Index type for #radixsort32_t */
+typedef uint32_t      radixsort32_index_t;
+/*! Index type for #radixsort64_t */
+typedef uint64_t      radixsort64_index_t;
 /*! UUID, 128-bit unique identifier */
 typedef uint128_t     uuid_t;
+/*! Timer identifier, see #timer_add */
+typedef uint64_t      timer_id_t;
 
 /*! Used to bit manipulate 32-bit floating point values in a alias safe way */
 typedef union {
@@ -452,14 +633,34 @@ typedef union {
 typedef struct string_t               string_t;
 /*! Constant immutable string */
 typedef struct string_const_t         string_const_t;
+/*! Interned string and hash */
+typedef struct interned_t             interned_t;
+/*! Growable string buffer */
+typedef struct string_builder_t       string_builder_t;
+/*! Allocation free string token iterator */
+typedef struct string_tokenizer_t     string_tokenizer_t;
+/*! Hashed set of strings */
+typedef struct string_set_t           string_set_t;
 /*! Application declaration and configuration */
 typedef struct application_t          application_t;
+/*! Allocator bound to an array */
+typedef struct array_allocator_t      array_allocator_t;
+/*! AES cipher instance */
+typedef struct aes_t                  aes_t;
 /*! Beacon for waiting */
 typedef struct beacon_t               beacon_t;
 /*! Bit buffer instance */
 typedef struct bitbuffer_t            bitbuffer_t;
 /*! Blowfish cipher instance */
 typedef struct blowfish_t             blowfish_t;
+/*! Checksum control block */
+typedef struct checksum_t             checksum_t;
+/*! Handle to a config value for repeated lookups */
+typedef struct config_key_handle_t    config_key_handle_t;
+/*! Section and key of a changed config value */
+typedef struct config_change_t        config_change_t;
+/*! Payload for a config change event */
+typedef struct config_event_payload_t config_event_payload_t;
 /*! Error frame holding debug data for an entry in the frame stack in the error context */
 typedef struct error_frame_t          error_frame_t;
 /*! Error context holding error frame stack for a thread */
@@ -470,14 +671,46 @@ typedef struct event_t                event_t;
 typedef struct event_block_t          event_block_t;
 /*! Event stream instance producing event blocks of events */
 typedef struct event_stream_t         event_stream_t;
+/*! Delayed event pending delivery */
+typedef struct event_timer_t          event_timer_t;
+/*! Event description for batch posting */
+typedef struct event_post_t           event_post_t;
+/*! Event stream statistics */
+typedef struct event_statistics_t     event_statistics_t;
+/*! Event id range routed to stream subscribers */
+typedef struct event_route_t          event_route_t;
+/*! Fiber execution context */
+typedef struct fiber_t                fiber_t;
 /*! Payload for a file system event */
 typedef struct fs_event_payload_t     fs_event_payload_t;
+/*! Asynchronous file I/O context */
+typedef struct fs_async_t             fs_async_t;
+/*! Result of a completed asynchronous file I/O request */
+typedef struct fs_async_result_t      fs_async_result_t;
+/*! Asynchronous file system path operation */
+typedef struct fs_async_operation_t   fs_async_operation_t;
+/*! Entry in a directory listing */
+typedef struct fs_entry_t             fs_entry_t;
+/*! Directory listing with entry metadata */
+typedef struct fs_listing_t           fs_listing_t;
+/*! Topology information for a hardware thread */
+typedef struct hardware_topology_t    hardware_topology_t;
+/*! Streaming hash state */
+typedef struct hash_state_t           hash_state_t;
 /*! Node in a hash map */
 typedef struct hashmap_node_t         hashmap_node_t;
 /*! Hash map mapping hash value keys to pointer values */
 typedef struct hashmap_t              hashmap_t;
 /*! Hash map of fixed size */
 typedef struct hashmap_fixed_t        hashmap_fixed_t;
+/*! Shard in a concurrent hash map */
+typedef struct hashmap_shard_t        hashmap_shard_t;
+/*! Concurrent hash map of independently locked shards */
+typedef struct hashmap_concurrent_t   hashmap_concurrent_t;
+/*! Node in a string keyed hash map */
+typedef struct hashmap_string_node_t  hashmap_string_node_t;
+/*! Hash map mapping string keys to pointer values */
+typedef struct hashmap_string_t       hashmap_string_t;
 /*! Entry in a 32-bit hash table */
 typedef struct hashtable32_entry_t    hashtable32_entry_t;
 /*! Entry in a 64-bit hash table */
@@ -486,8 +719,48 @@ typedef struct hashtable64_entry_t    hashtable64_entry_t;
 typedef struct hashtable32_t          hashtable32_t;
 /*! Hash table mapping 64-bit keys to 64-bit values */
 typedef struct hashtable64_t          hashtable64_t;
+/*! Slot in a resizable 32-bit hash table */
+typedef struct hashtable32_slot_t     hashtable32_slot_t;
+/*! Slot in a resizable 64-bit hash table */
+typedef struct hashtable64_slot_t     hashtable64_slot_t;
+/*! Storage of a resizable 32-bit hash table */
+typedef struct hashtable32_storage_t  hashtable32_storage_t;
+/*! Storage of a resizable 64-bit hash table */
+typedef struct hashtable64_storage_t  hashtable64_storage_t;
+/*! Resizable hash table mapping 32-bit keys to 32-bit values */
+typedef struct hashtable32_resizable_t hashtable32_resizable_t;
+/*! Resizable hash table mapping 64-bit keys to 64-bit values */
+typedef struct hashtable64_resizable_t hashtable64_resizable_t;
+/*! Lightweight non-recursive lock */
+typedef struct lock_t                 lock_t;
+/*! Lock contention statistics */
+typedef struct lock_statistics_t      lock_statistics_t;
+/*! Lightweight reader-writer lock */
+typedef struct rwlock_t               rwlock_t;
+/*! Reader counter slot in a distributed reader-writer lock */
+typedef struct rwlock_slot_t          rwlock_slot_t;
+/*! Reader-writer lock with distributed reader counters for read-mostly data */
+typedef struct rwlock_distributed_t   rwlock_distributed_t;
+/*! Intrusive node in lock-free containers */
+typedef struct lockfree_node_t        lockfree_node_t;
+/*! Lock-free intrusive LIFO stack */
+typedef struct lockfree_stack_t       lockfree_stack_t;
+/*! Lock-free intrusive multi-producer, single consumer FIFO queue */
+typedef struct lockfree_queue_t       lockfree_queue_t;
+/*! Log file configuration */
+typedef struct log_file_config_t      log_file_config_t;
+/*! Crash dump file header */
+typedef struct crash_dump_header_t    crash_dump_header_t;
 /*! MD5 control block */
 typedef struct md5_t                  md5_t;
+/*! Memory arena for bump allocation with bulk reset */
+typedef struct memory_arena_t         memory_arena_t;
+/*! Memory arena chunk */
+typedef struct memory_arena_chunk_t   memory_arena_chunk_t;
+/*! Memory pool of fixed size blocks */
+typedef struct memory_pool_t          memory_pool_t;
+/*! Memory pool per-thread magazine */
+typedef struct memory_pool_magazine_t memory_pool_magazine_t;
 /*! Memory context holding the allocation context stack */
 typedef struct memory_context_t       memory_context_t;
 /*! Memory system declaration */
@@ -496,38 +769,114 @@ typedef struct memory_system_t        memory_system_t;
 typedef struct memory_tracker_t       memory_tracker_t;
 /*! Memory statistics */
 typedef struct memory_statistics_t    memory_statistics_t;
+/*! Memory statistics for a single memory context */
+typedef struct memory_context_statistics_t memory_context_statistics_t;
+/*! Histograms of allocation sizes, alignments and lifetimes */
+typedef struct memory_histogram_t     memory_histogram_t;
 /*! Platform specific mutex representation, opaque data type */
 typedef struct mutex_t                mutex_t;
 /*! Base object type all reference counted object types are based on */
 typedef struct object_base_t          object_base_t;
 /*! Object map mapping object handles to object instance pointers */
 typedef struct objectmap_t            objectmap_t;
+/*! Object map per-thread magazine */
+typedef struct objectmap_magazine_t   objectmap_magazine_t;
+/*! Memory mapped pack file with indexed entries */
+typedef struct pack_t                 pack_t;
+/*! Builder collecting entries and writing a pack file */
+typedef struct pack_builder_t         pack_builder_t;
 /*! Child process control block */
 typedef struct process_t              process_t;
+/*! Pool of reusable worker processes */
+typedef struct processpool_t          processpool_t;
+/*! Slot in a bounded multi-producer, multi-consumer queue */
+typedef struct queue_slot_t           queue_slot_t;
+/*! Bounded multi-producer, multi-consumer queue */
+typedef struct queue_t                queue_t;
 /*! Radix sorter control block */
 typedef struct radixsort_t            radixsort_t;
+/*! Radix sorter control block with 32-bit indices */
+typedef struct radixsort32_t          radixsort32_t;
+/*! Radix sorter control block with 64-bit indices */
+typedef struct radixsort64_t          radixsort64_t;
+/*! Alias table for constant time weighted random sampling */
+typedef struct random_alias_t         random_alias_t;
+/*! Explicit pseudorandom generator state */
+typedef struct random_state_t         random_state_t;
 /*! Compiled regex */
 typedef struct regex_t                regex_t;
+/*! Lazily constructed DFA of a compiled regex */
+typedef struct regex_dfa_t            regex_dfa_t;
+/*! Run loop dispatching event streams, beacons and timers from a single wait */
+typedef struct runloop_t              runloop_t;
+/*! Event stream registered in a run loop */
+typedef struct runloop_stream_t       runloop_stream_t;
+/*! Beacon registered in a run loop */
+typedef struct runloop_source_t       runloop_source_t;
+/*! Timer pending in a run loop */
+typedef struct runloop_timer_t        runloop_timer_t;
 /*! Memory ring buffer */
 typedef struct ringbuffer_t           ringbuffer_t;
+/*! Lock free single producer, single consumer memory ring buffer */
+typedef struct ringbuffer_spsc_t      ringbuffer_spsc_t;
+/*! Lock free single producer, single consumer ring buffer mapped twice in virtual memory */
+typedef struct ringbuffer_mirror_t    ringbuffer_mirror_t;
+/*! Ring buffer stream state in named shared memory */
+typedef struct ringbuffer_shared_t    ringbuffer_shared_t;
+/*! SHA-256 control block */
+typedef struct sha256_t               sha256_t;
+/*! Structure of arrays storage keyed by object handles */
+typedef struct soamap_t               soamap_t;
 /*! Base stream type all stream types are based on */
 typedef struct stream_t               stream_t;
 /*! Memory buffer stream */
 typedef struct stream_buffer_t        stream_buffer_t;
 /*! Pipe stream */
 typedef struct stream_pipe_t          stream_pipe_t;
+/*! Socket stream */
+typedef struct stream_socket_t        stream_socket_t;
 /*! Ring buffer stream */
 typedef struct stream_ringbuffer_t    stream_ringbuffer_t;
+/*! Buffered stream wrapping another stream */
+typedef struct stream_buffered_t      stream_buffered_t;
+/*! Compressed stream wrapping another stream */
+typedef struct stream_compressed_t    stream_compressed_t;
+/*! Checksum stream wrapping another stream */
+typedef struct stream_checksum_t      stream_checksum_t;
+/*! Base64 encoding or decoding stream wrapping another stream */
+typedef struct stream_base64_t        stream_base64_t;
+/*! Encrypting and decrypting stream wrapping another stream */
+typedef struct stream_cipher_t        stream_cipher_t;
+/*! Buffer span for vectored stream I/O */
+typedef struct stream_span_t          stream_span_t;
+/*! Iterator returning lines of a stream without copying */
+typedef struct stream_line_iterator_t stream_line_iterator_t;
 /*! Vtable for streams providing stream type specific implementations
 of stream operations */
 typedef struct stream_vtable_t        stream_vtable_t;
+/*! Task description */
+typedef struct task_t                 task_t;
+/*! Task completion counter */
+typedef struct task_counter_t         task_counter_t;
+/*! Task scheduler executing tasks on worker threads */
+typedef struct task_scheduler_t       task_scheduler_t;
+/*! Graph of tasks with dependencies */
+typedef struct task_graph_t           task_graph_t;
 /*! Thread */
 typedef struct thread_t               thread_t;
+/*! Pooled OS thread running threads started with the thread pool enabled */
+typedef struct thread_runner_t        thread_runner_t;
+/*! Timer service driving timers from a timer wheel */
+typedef struct timer_service_t        timer_service_t;
+/*! Payload for a timer event */
+typedef struct timer_event_payload_t  timer_event_payload_t;
 /*! Version declaration */
 typedef union  version_t              version_t;
 /*! Library configuration block controlling limits, functionality and memory
 usage of the library */
 typedef struct foundation_config_t    foundation_config_t;
+/*! Time spent initializing a foundation subsystem */
+typedef struct foundation_subsystem_timing_t foundation_subsystem_timing_t;
 
 #if FOUNDATION_PLATFORM_WINDOWS
 /*! Platform specific representation of a semaphore */
@@ -541,6 +890,9 @@ typedef struct dispatch_semaphore_s*  semaphore_t;
 #  include <semaphore.h>
 typedef sem_t                         semaphore_native_t;
 typedef struct semaphore_t            semaphore_t;
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+typedef struct semaphore_futex_t      semaphore_futex_t;
+typedef struct semaphore_t            semaphore_t;
 #elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
 typedef union semaphore_native_t      semaphore_native_t;
 typedef struct semaphore_t            semaphore_t;
@@ -578,6 +930,12 @@ the log functions.
 typedef void (* log_callback_fn)(hash_t context, error_level_t severity, const char* msg,
                                  size_t length);
 
+/*! Log file rotation callback. Called after the log file has been rotated, for example to
+compress or archive the rotated file.
+\param path Path of rotated file
+\param length Length of path */
+typedef void (* log_rotate_fn)(const char* path, size_t length);
+
 /*! Subsystem initialization function prototype. Return value should be the success
 state of initialization
 \return 0 on success, <0 if failure (errors should be reported through log_error
@@ -628,6 +986,29 @@ provide an implementation with this prototype for memory statistics
 \return Memory statistics */
 typedef memory_statistics_t (* memory_statistics_fn)(void);
 
+/*! Array allocator reallocation function prototype. Implementation of an array allocator
+must provide an implementation with this prototype for allocating and growing array storage
+\param allocator Array allocator
+\param p Pointer to previous memory block, null to allocate a new block
+\param size Requested size
+\param align Aligmnent requirement
+\param oldsize Size of previous memory block
+\return Pointer to allocated memory block if successful, 0 if error */
+typedef void* (* array_reallocate_fn)(array_allocator_t* allocator, void* p, size_t size,
+                                      unsigned int align, size_t oldsize);
+
+/*! Array allocator deallocation function prototype. Implementation of an array allocator
+must provide an implementation with this prototype for deallocating array storage
+\param allocator Array allocator
+\param p Pointer to memory block */
+typedef void (* array_deallocate_fn)(array_allocator_t* allocator, void* p);
+
+/*! Array element predicate function prototype, see #array_erase_ordered_if
+\param element Pointer to array element
+\param data Caller data
+\return true if predicate holds for the element, false if not */
+typedef bool (* array_predicate_fn)(const void* element, void* data);
+
 /*! Callback function for writing profiling data to a stream
 \param data Pointer to data block
 \param size Size of data block */
@@ -638,6 +1019,75 @@ typedef void (* profile_write_fn)(void* data, size_t size);
 \param size Size of data block */
 typedef void (* profile_read_fn)(void* data, size_t size);
 
+/*! Callback function for entries found by #fs_walk. May be called concurrently from multiple
+threads, in no particular order.
+\param directory Path of directory containing the entry
+\param entry Directory entry
+\param arg Argument given to #fs_walk
+\return For directory entries, true to walk the directory, false to prune it. Ignored for
+        other entries */
+typedef bool (* fs_walk_fn)(string_const_t directory, const fs_entry_t* entry, void* arg);
+
+/*! Callback function for matches found by #regex_match_all and #regex_match_stream. The match
+and captured substrings are only valid for the duration of the call.
+\param offset Offset of match in input
+\param match Matched substring
+\param captures Captured substrings
+\param num_captures Number of captures in array
+\param arg Argument given to the matching function
+\return true to continue matching, false to stop */
+typedef bool (* regex_match_fn)(size_t offset, string_const_t match, const string_const_t* captures,
+                                size_t num_captures, void* arg);
+
+/*! Fiber function prototype
+\param arg Argument given when allocating the fiber */
+typedef void (* fiber_fn)(void* arg);
+
+/*! Task execution function prototype
+\param arg Argument given in task description */
+typedef void (* task_fn)(void* arg);
+
+/*! Range function prototype for parallel for, processing a chunk of an index range
+\param begin Start of chunk
+\param end End of chunk (exclusive)
+\param arg Argument given to #task_parallel_for */
+typedef void (* task_range_fn)(size_t begin, size_t end, void* arg);
+
+/*! Reduce function prototype for parallel reduce, accumulating a chunk of an index range
+into a partial result
+\param begin Start of chunk
+\param end End of chunk (exclusive)
+\param partial Partial result
+\param arg Argument given to #task_parallel_reduce */
+typedef void (* task_reduce_fn)(size_t begin, size_t end, void* partial, void* arg);
+
+/*! Join function prototype for parallel reduce, joining a partial result into the result
+\param result Result
+\param partial Partial result
+\param arg Argument given to #task_parallel_reduce */
+typedef void (* task_join_fn)(void* result, const void* partial, void* arg);
+
+/*! Run loop event stream callback, called with the block of events processed from a stream
+registered in the run loop. The block is only valid until the callback returns
+\param loop Run loop
+\param stream Event stream
+\param block Event block with at least one event
+\param arg Argument given when adding the stream */
+typedef void (* runloop_stream_fn)(runloop_t* loop, event_stream_t* stream, event_block_t* block,
+                                   void* arg);
+
+/*! Run loop beacon callback, called once the fired beacon has been waited on
+\param loop Run loop
+\param beacon Beacon that fired
+\param arg Argument given when adding the beacon */
+typedef void (* runloop_beacon_fn)(runloop_t* loop, beacon_t* beacon, void* arg);
+
+/*! Run loop timer callback
+\param loop Run loop
+\param id Timer id returned when adding the timer
+\param arg Argument given when adding the timer */
+typedef void (* runloop_timer_fn)(runloop_t* loop, unsigned int id, void* arg);
+
 /*! Thread entry point function prototype
 \param arg Argument passed by caller when starting the thread
 \return Implementation specific data which can be obtained through thread_result */
@@ -683,6 +1133,22 @@ typedef size_t (* stream_read_fn)(stream_t* stream, void* dst, size_t size);
 \return Number of bytes actually written */
 typedef size_t (* stream_write_fn)(stream_t* stream, const void* src, size_t size);
 
+/*! Generic function to read data from a stream into multiple buffers in order
+\param stream Stream to read from
+\param spans Destination buffer spans
+\param count Number of buffer spans
+\return Total number of bytes actually read */
+typedef size_t (* stream_read_vector_fn)(stream_t* stream, const stream_span_t* spans,
+                                         size_t count);
+
+/*! Generic function to write data from multiple buffers to a stream in order
+\param stream Stream to write to
+\param spans Source buffer spans
+\param count Number of buffer spans
+\return Total number of bytes actually written */
+typedef size_t (* stream_write_vector_fn)(stream_t* stream, const stream_span_t* spans,
+                                          size_t count);
+
 /*! Query if end of stream
 \param stream Stream
 \return true if stream at end, false if not */
@@ -745,6 +1211,14 @@ typedef void (* stream_finalize_fn)(stream_t* stream);
 \return Clone of stream, 0 if not supported or invalid source stream */
 typedef stream_t* (* stream_clone_fn)(stream_t* stream);
 
+/*! Hint the expected access pattern of a range of the stream.
+\param stream Stream
+\param advice Access pattern
+\param offset Offset of range in bytes
+\param size Size of range in bytes, 0 for range extending to end of stream */
+typedef void (* stream_advise_fn)(stream_t* stream, stream_advice_t advice, size_t offset,
+                                  size_t size);
+
 /*! Identifier returned from threads and crash guards after a fatal exception (crash)
 has been caught */
 #define FOUNDATION_CRASH_DUMP_GENERATED 0x0badf00dL
@@ -759,17 +1233,37 @@ struct foundation_config_t {
 	size_t library_max;
 	/*! Maximum number of concurrent allocations in memory tracker. Zero for default (32k) */
 	size_t memory_tracker_max;
+	/*! Average number of bytes between sampled allocations in sampled memory tracker.
+	Zero for default (512KiB) */
+	size_t memory_tracker_sample_rate;
 	/*! Maximum number of file system monitors. Zero for default (16) */
 	size_t fs_monitor_max;
+	/*! Number of entries in the file system stat cache answering #fs_is_file,
+	#fs_is_directory, #fs_size and #fs_last_modified queries for paths in monitored directories
+	from memory. Zero for default (disabled) */
+	size_t fs_stat_cache_size;
+	/*! Window in milliseconds during which repeated modification notifications for the same
+	file are coalesced into a single #FOUNDATIONEVENT_FILE_MODIFIED event by file system
+	monitors. Currently only used on Linux and Android. Zero for default (disabled) */
+	size_t fs_monitor_coalesce;
 	/*! Size of temporary memory pool (short lived allocations). Zero for default (512KiB) */
 	size_t temporary_memory;
+	/*! Minimum size of allocations mapped directly from the operating system, with transparent
+	huge pages where available. Zero for default (disabled) */
+	size_t memory_map_threshold;
+	/*! Average number of allocations between allocations placed between inaccessible guard
+	pages by the malloc memory system, making overruns and use after free of sampled blocks
+	fault immediately. Low enough overhead to leave enabled in production with a sample rate of
+	a few thousand. Only used on 64-bit platforms. Zero for default (disabled) */
+	size_t memory_guard_sample_rate;
 	/*! Maximum depth of an error context. Zero for default (32) */
 	size_t error_context_depth;
 	/*! Maximum depth of a memory context. Zero for default (32) */
 	size_t memory_context_depth;
 	/*! Maximum depth of a stack trace. Zero for default (32) */
 	size_t stacktrace_depth;
-	/*! Maximum number of hash values stored in reverse lookup. Zero for default (0) */
+	/*! Initial number of hash values stored in reverse lookup, the store grows as needed.
+	Zero for default (0, reverse lookup disabled) */
 	size_t hash_store_size;
 	/*! Default size of an event block. Zero for default (8KiB) */
 	size_t event_block_chunk;
@@ -777,8 +1271,22 @@ struct foundation_config_t {
 	size_t event_block_limit;
 	/*! Default thread stack size. Zero for default (32KiB) */
 	size_t thread_stack_size;
+	/*! Default fiber stack size. Zero for default (64KiB) */
+	size_t fiber_stack_size;
 	/*! Number of random state blocks to preallocate on thread startup. Zero for default (0) */
 	size_t random_state_prealloc;
+	/*! Maximum number of compiled expressions kept in the regex cache. Zero for default (64) */
+	size_t regex_cache_size;
+	/*! Cache config files loaded by #config_load as binary snapshots of the parsed values in
+	the "cache" subdirectory of the user config directory, reused while the config file size and
+	modification time are unchanged. False for default (disabled) */
+	bool config_cache;
+	/*! Monitor config files loaded by #config_load through #fs_monitor, reloading them when
+	passed the file events with #config_process_event. False for default (disabled) */
+	bool config_monitor;
+	/*! Read timestamps from the CPU cycle counter if invariant, falling back to the operating
+	system clock if not. False for default (operating system clock) */
+	bool time_cycle_counter;
 };
 
 /*! String tuple holding string data pointer and length. This is used to avoid extra calls
@@ -799,6 +1307,217 @@ struct string_const_t {
 	size_t length;
 };
 
+/*! Time spent initializing a foundation subsystem, see #foundation_subsystem_timing */
+struct foundation_subsystem_timing_t {
+	/*! Subsystem name */
+	string_const_t name;
+	/*! Initialization time in nanoseconds of the operating system monotonic clock */
+	tick_t time;
+};
+
+/*! Interned string, see #intern_string. The string data is zero terminated and valid until
+the foundation library is finalized. */
+struct interned_t {
+	/*! Interned string, identical strings share the same string data pointer */
+	string_const_t string;
+	/*! Hash of string, equal to hash() of the string data */
+	hash_t hash;
+};
+
+/*! Growable string buffer for building strings with repeated appends, see
+#string_builder_initialize. The buffer grows geometrically so appending is amortized
+constant time per character. The string is always zero terminated. */
+struct string_builder_t {
+	/*! String buffer, null if nothing allocated */
+	char* str;
+	/*! Length of string, not including zero terminator */
+	size_t length;
+	/*! Capacity of buffer */
+	size_t capacity;
+};
+
+/*! Iterator over tokens in a string separated by delimiter characters, see
+#string_tokenizer_initialize. The tokenizer does not allocate memory and tokens reference the
+source string. */
+struct string_tokenizer_t {
+	/*! Source string */
+	const char* str;
+	/*! Length of source string */
+	size_t length;
+	/*! Offset of next token, past length when all tokens are consumed */
+	size_t offset;
+	/*! Lookup mask with one bit per delimiter character value */
+	uint64_t mask[4];
+	/*! Delimiter character if exactly one delimiter */
+	char delimiter;
+	/*! Number of delimiter characters, 0 for none, 1 for one and 2 for several */
+	unsigned char delimiters;
+	/*! Flag to include empty tokens */
+	bool allow_empty;
+};
+
+/*! Immutable hashed set of strings built from an array of strings, see
+#string_set_initialize. All data is stored in a single memory block owned by the set. */
+struct string_set_t {
+	/*! Number of strings, including duplicates */
+	size_t count;
+	/*! Index mask, number of index slots minus one */
+	size_t mask;
+	/*! Strings in original array order, referencing the string storage */
+	string_const_t* string;
+	/*! Hash of each string */
+	hash_t* hash;
+	/*! Hash index, string index plus one for each used slot and zero for free slots */
+	uint32_t* index;
+};
+
+/*! Lightweight non-recursive lock, 4 bytes in size so it can be embedded in data structures.
+Zero initialized memory is a valid unlocked lock, see #lock_initialize */
+struct lock_t {
+	/*! Lock state, 0 if unlocked, 1 if locked, 2 if locked with waiting threads */
+	atomic32_t state;
+};
+
+/*! Lock contention statistics, running counters since lock initialization. Only gathered
+if #BUILD_ENABLE_LOCK_STATISTICS is enabled */
+struct lock_statistics_t {
+	/*! Number of successful lock acquisitions or waits */
+	uint64_t acquisitions;
+	/*! Number of acquisitions or waits that had to block */
+	uint64_t contentions;
+	/*! Total time spent blocking, in ticks */
+	tick_t wait_ticks;
+	/*! Longest single time spent blocking, in ticks */
+	tick_t peak_wait_ticks;
+	/*! Id of the thread holding the lock at the last contention, zero if the lock type
+	    has no owner */
+	uint64_t holder;
+};
+
+/*! Lightweight reader-writer lock, 4 bytes in size so it can be embedded in data structures.
+Zero initialized memory is a valid unlocked lock, see #rwlock_initialize */
+struct rwlock_t {
+	/*! Lock state, reader count in low bits and writer and waiter flags in high bits */
+	atomic32_t state;
+};
+
+/*! Reader counter in a distributed reader-writer lock, padded to a cache line */
+FOUNDATION_ALIGNED_STRUCT(rwlock_slot_t, 64) {
+	/*! Number of readers holding the lock through this slot */
+	atomic32_t readers;
+};
+
+/*! Reader-writer lock with one reader counter per slot, readers on different threads
+do not contend on the same cache line. See #rwlock_distributed_initialize */
+struct rwlock_distributed_t {
+	/*! Writer flag, 0 if no writer, 1 if writer active, 2 if writer active with
+	    waiting readers */
+	atomic32_t writer;
+	/*! Lock serializing writers */
+	lock_t write_lock;
+	/*! Number of reader slots, always a power of two */
+	size_t num_slots;
+	/*! Reader slot array */
+	rwlock_slot_t* slot;
+};
+
+/*! Intrusive node in lock-free containers, embed in the item struct. A node can only be
+in one container at a time */
+struct lockfree_node_t {
+	/*! Next node */
+	atomicptr_t next;
+};
+
+/*! Lock-free intrusive LIFO stack. Head pointer is tagged to avoid ABA issues.
+Zero initialized memory is a valid empty stack, see #lockfree_stack_initialize */
+struct lockfree_stack_t {
+	/*! Top node and modification tag */
+	atomictagptr_t head;
+};
+
+/*! Lock-free intrusive multi-producer, single consumer FIFO queue. Producer and consumer
+ends are kept on separate cache lines. See #lockfree_queue_initialize */
+FOUNDATION_ALIGNED_STRUCT(lockfree_queue_t, 64) {
+	/*! Last pushed node, producer end */
+	atomicptr_t head;
+	/*! Padding to cache line */
+	char padding[64 - sizeof(atomicptr_t)];
+	/*! Next node to pop, consumer end */
+	lockfree_node_t* tail;
+	/*! Stub node keeping the queue non-empty */
+	lockfree_node_t stub;
+};
+
+/*! Log file configuration, see #log_set_file */
+struct log_file_config_t {
+	/*! Size of write buffer in bytes, zero for default (64KiB) */
+	size_t buffer_size;
+	/*! Maximum time in milliseconds data is kept in the buffer, zero for default (1000) */
+	unsigned int flush_interval;
+	/*! Synchronization policy */
+	log_file_sync_t sync;
+	/*! Rotate file when size would exceed this number of bytes, zero to disable */
+	size_t rotate_size;
+	/*! Rotate file when it has been open for this number of seconds, zero to disable */
+	unsigned int rotate_age;
+	/*! Number of rotated files to keep, zero for default (5) */
+	unsigned int rotate_count;
+	/*! Callback after rotation, null for none */
+	log_rotate_fn rotate;
+};
+
+/*! Header of a crash dump file. The header is followed by records, each a 32-bit record type
+(#crash_dump_record_t) and 32-bit size followed by the record data. All values are in native
+byte order. */
+struct crash_dump_header_t {
+	/*! File identifier "FDMP" */
+	char magic[4];
+	/*! Format version */
+	uint32_t version;
+	/*! Signal number */
+	int32_t signal;
+	/*! Signal code */
+	int32_t code;
+	/*! Faulting address */
+	uint64_t address;
+	/*! Process identifier */
+	uint64_t pid;
+	/*! Thread identifier */
+	uint64_t thread;
+	/*! System time of crash in milliseconds */
+	tick_t time;
+};
+
+/*! Checksum state */
+struct checksum_t {
+	/*! Checksum algorithm */
+	checksum_type_t type;
+	/*! Number of bytes digested */
+	uint64_t size;
+	/*! Internal state during data digestion */
+	uint64_t state[4];
+	/*! Internal buffer holding data not yet digested */
+	unsigned char buffer[32];
+};
+
+/*! Streaming XXH3 hash state, see #hash_state_initialize */
+struct hash_state_t {
+	/*! Accumulators */
+	uint64_t acc[8];
+	/*! Secret derived from seed */
+	uint8_t secret[192];
+	/*! Internal buffer holding data not yet accumulated */
+	uint8_t buffer[256];
+	/*! Number of bytes in buffer */
+	size_t buffered;
+	/*! Number of stripes accumulated in current block */
+	size_t stripes;
+	/*! Number of bytes hashed */
+	uint64_t size;
+	/*! Seed */
+	uint64_t seed;
+};
+
 /*! MD5 state */
 struct md5_t {
 	/*! Flag indicating the md5 state has been initialized and ready for digestion of data */
@@ -813,6 +1532,20 @@ struct md5_t {
 	unsigned char digest[16];
 };
 
+/*! SHA-256 state */
+struct sha256_t {
+	/*! Flag indicating the state has been finalized and must be reinitialized before digestion */
+	bool init;
+	/*! Internal state during data digestion */
+	uint32_t state[8];
+	/*! Number of bytes digested */
+	uint64_t count;
+	/*! Internal buffer during data digestion */
+	unsigned char buffer[64];
+	/*! Internal digest data buffer */
+	unsigned char digest[32];
+};
+
 /*! Memory management system declaration with function pointers for all memory system
 entry points. */
 struct memory_system_t {
@@ -826,6 +1559,8 @@ struct memory_system_t {
 	system_initialize_fn initialize;
 	/*! System finalization */
 	system_finalize_fn finalize;
+	/*! Thread finalization, called when a foundation thread exits (optional, can be null) */
+	system_finalize_fn thread_finalize;
 };
 
 /*! Memory tracking system declarations with function pointers for all memory tracking
@@ -855,6 +1590,47 @@ struct memory_statistics_t {
 	uint64_t allocated_current;
 };
 
+/*! Memory statistics for a single memory context */
+struct memory_context_statistics_t {
+	/*! Memory context */
+	hash_t context;
+	/*! Statistics for allocations made in the context */
+	memory_statistics_t statistics;
+};
+
+/*! Histograms of allocations passed to the memory system, see #memory_histogram. Buckets are
+powers of two, bucket n counting values in (2^(n-1), 2^n] and bucket 0 counting values 0 and
+1. The last bucket also counts all larger values */
+struct memory_histogram_t {
+	/*! Allocations by size in bytes */
+	uint64_t size[MEMORY_HISTOGRAM_BUCKETS];
+	/*! Allocations by requested alignment in bytes */
+	uint64_t align[MEMORY_HISTOGRAM_BUCKETS];
+	/*! Deallocations by block lifetime in microseconds */
+	uint64_t lifetime[MEMORY_HISTOGRAM_BUCKETS];
+	/*! Blocks deallocated within #MEMORY_HISTOGRAM_SHORT_LIVED microseconds */
+	uint64_t short_lived;
+	/*! Short lived blocks allocated without the MEMORY_TEMPORARY hint */
+	uint64_t short_lived_persistent;
+	/*! Blocks allocated with the MEMORY_TEMPORARY hint but not short lived */
+	uint64_t long_lived_temporary;
+};
+
+/*! Allocator for array storage, see #array_initialize_allocator. The allocator must remain
+valid while any array bound to it is in use */
+struct array_allocator_t {
+	/*! Storage allocation and reallocation */
+	array_reallocate_fn reallocate;
+	/*! Storage deallocation */
+	array_deallocate_fn deallocate;
+	/*! Allocator specific data, such as a memory arena or pool */
+	void* data;
+	/*! Memory context for allocations */
+	hash_t context;
+	/*! Growth factor applied to capacity when array grows, zero for default (2) */
+	unsigned int factor;
+};
+
 /*! Version identifier expressed as an 128-bit integer with major, minor,
 revision, build and control version number components */
 union version_t {
@@ -908,6 +1684,19 @@ struct blowfish_t {
 	uint32_t sboxes[BLOWFISH_SBOXES][BLOWFISH_SBOXENTRIES];
 };
 
+#define AES_BLOCKSIZE               16U
+#define AES_MAXROUNDS               14U
+
+/*! State for an AES encryption block */
+struct aes_t {
+	/*! Number of rounds, 10, 12 or 14 for 128, 192 or 256 bit keys */
+	unsigned int rounds;
+	/*! Encryption round keys */
+	uint8_t encrypt_keys[AES_MAXROUNDS + 1][AES_BLOCKSIZE];
+	/*! Decryption round keys for the equivalent inverse cipher */
+	uint8_t decrypt_keys[AES_MAXROUNDS + 1][AES_BLOCKSIZE];
+};
+
 /*! Bit buffer for bit based I/O to a memory buffer or stream */
 struct bitbuffer_t {
 	/*! Memory buffer for buffer based I/O */
@@ -922,6 +1711,10 @@ struct bitbuffer_t {
 	uint32_t pending_read;
 	/*! Pending data to be written */
 	uint32_t pending_write;
+	/*! Next chunk of data read ahead by a peek past the pending read data */
+	uint32_t lookahead_read;
+	/*! Flag indicating lookahead_read holds valid data */
+	bool lookahead;
 	/*! Current read offset in bits into pending data */
 	unsigned int offset_read;
 	/*! Current write offset in bits into pending data */
@@ -999,20 +1792,117 @@ struct event_block_t {
 	event_stream_t* stream;
 	/*! Memory buffer holding event data */
 	event_t* events;
-	/*! Fired state */
-	bool fired;
+	/*! Offsets of events in memory buffer (array), only maintained for processed blocks */
+	uint32_t* offset;
 };
 
-/*! Event stream from a single module. Event streams produce event blocks for processing */
+/*! Event description for posting a batch of events with #event_post_batch */
+struct event_post_t {
+	/*! Event id */
+	int id;
+	/*! Sender */
+	object_t object;
+	/*! Delivery time, 0 for immediate delivery */
+	tick_t delivery;
+	/*! Event payload */
+	const void* payload;
+	/*! Event payload size */
+	size_t size;
+};
+
+/*! Delayed event pending delivery, entry in the delayed event min-heap of an event stream */
+struct event_timer_t {
+	/*! Delivery timestamp */
+	tick_t timestamp;
+	/*! Sequence number to deliver events with equal timestamp in posting order */
+	uint64_t sequence;
+	/*! Offset of event in delayed event storage */
+	size_t offset;
+};
+
+/*! Event stream statistics, running counters since stream initialization. Rates such as
+posts per second are derived by sampling the counters over time. Only gathered if
+#BUILD_ENABLE_EVENT_STATISTICS is enabled */
+struct event_statistics_t {
+	/*! Number of events posted */
+	uint64_t posted;
+	/*! Number of bytes of events posted, including event headers */
+	uint64_t posted_bytes;
+	/*! Number of events dropped from hitting the event block size limit */
+	uint64_t dropped;
+	/*! Number of times the event block size limit was hit */
+	uint64_t limit_hits;
+	/*! Number of staging block capacity reallocations */
+	uint64_t reallocations;
+	/*! Number of contended staging block lock acquisitions */
+	uint64_t spin_count;
+	/*! Time spent spinning on contended staging block locks, in ticks */
+	tick_t spin_ticks;
+	/*! Number of processed event blocks */
+	uint64_t processed_blocks;
+	/*! Number of events in processed event blocks */
+	uint64_t processed_events;
+	/*! Number of bytes in processed event blocks */
+	uint64_t processed_bytes;
+	/*! Largest number of bytes in a single processed event block */
+	uint64_t peak_block_bytes;
+	/*! Current number of pending delayed events */
+	uint64_t delayed_pending;
+};
+
+/*! Event id range routed to a set of stream subscribers, see #event_stream_subscribe */
+struct event_route_t {
+	/*! First event id in range */
+	int first_id;
+	/*! Last event id in range, inclusive */
+	int last_id;
+	/*! Bit mask of subscribers receiving events in range */
+	uint32_t subscribers;
+};
+
+/*! Maximum number of staging blocks per event stream. Posting threads are assigned to
+staging blocks in order of first post, threads beyond this number share staging blocks */
+#define EVENT_STREAM_STAGES 16
+
+/*! Maximum number of subscribers per event stream, see #event_stream_subscribe */
+#define EVENT_STREAM_SUBSCRIBERS 32
+
+/*! Event stream from a single module. Event streams produce event blocks for processing.
+Events are posted into per-thread staging blocks which are merged into the read block
+when the stream is processed */
 FOUNDATION_ALIGNED_STRUCT(event_stream_t, 16) {
-	/*! Write block index */
-	atomic32_t write;
 	/*! Read block index */
 	int32_t read;
-	/*! Event blocks, double buffered for concurrent read/write access */
+	/*! Read blocks holding events merged from staging blocks, double buffered so previous
+	block stays valid until next processing */
 	event_block_t block[2];
 	/*! Optional beacon */
 	beacon_t* beacon;
+	/*! Beacon fired state, cleared when stream is processed */
+	atomic32_t fired;
+	/*! Staging blocks, allocated on first post from a thread */
+	atomicptr_t stage[EVENT_STREAM_STAGES];
+	/*! Storage for pending delayed events */
+	event_block_t delay;
+	/*! Number of bytes of already delivered events in delayed event storage */
+	size_t delay_free;
+	/*! Min-heap of pending delayed events ordered by delivery timestamp (array) */
+	event_timer_t* timer;
+	/*! Sequence number of next delayed event */
+	uint64_t timer_sequence;
+	/*! Statistics for stream processing, posting statistics are kept per staging block */
+	event_statistics_t statistics;
+	/*! Bit mask of allocated subscribers */
+	uint32_t subscribers;
+	/*! Event id ranges routed to subscribers (array) */
+	event_route_t* route;
+	/*! Subscriber masks indexed by event id offset from route_base, rebuilt when subscriptions
+	change (array) */
+	uint32_t* route_table;
+	/*! Event id of first entry in route table */
+	int route_base;
+	/*! Offsets of events routed to each subscriber for each read block (arrays) */
+	uint32_t* routed[2][EVENT_STREAM_SUBSCRIBERS];
 };
 
 /*! Payload layout for a file system event */
@@ -1023,6 +1913,102 @@ struct fs_event_payload_t {
 	const char str[];
 };
 
+/*! Section and key of a config value changed by a reload */
+struct config_change_t {
+	/*! Section hash */
+	hash_t section;
+	/*! Key hash */
+	hash_t key;
+};
+
+/*! Payload layout for a config change event */
+struct config_event_payload_t {
+	/*! Number of changed values */
+	size_t count;
+	/*! Changed values */
+	config_change_t change[];
+};
+
+/*! Result of an asynchronous file read or write, delivered either as the payload of a
+FOUNDATIONEVENT_FILE_ASYNC_COMPLETE event or through #fs_async_completed */
+struct fs_async_result_t {
+	/*! User data passed when submitting the request */
+	void* userdata;
+	/*! File stream */
+	stream_t* stream;
+	/*! Buffer read into or written from */
+	void* buffer;
+	/*! File offset */
+	size_t offset;
+	/*! Number of bytes requested */
+	size_t size;
+	/*! Number of bytes transferred, negative if error. Zero for successful path operations */
+	int64_t transferred;
+	/*! Flag if request was a write */
+	bool write;
+	/*! Request type */
+	fs_async_op_t op;
+	/*! Entry type for stat requests */
+	fs_entry_type_t type;
+	/*! Last modification time for stat requests, same as #fs_last_modified */
+	tick_t last_modified;
+};
+
+/*! Asynchronous file system path operation, see #fs_async_submit */
+struct fs_async_operation_t {
+	/*! Operation type, any type except #FS_ASYNC_READ and #FS_ASYNC_WRITE */
+	fs_async_op_t op;
+	/*! Path to operate on, source path for copy operations */
+	string_const_t path;
+	/*! Destination path for copy operations */
+	string_const_t destination;
+	/*! User data passed back in result */
+	void* userdata;
+};
+
+/*! Entry in a directory listing. Symbolic links are resolved and report the type, size and
+modification time of the link target. */
+struct fs_entry_t {
+	/*! Entry name, zero terminated */
+	string_const_t name;
+	/*! Entry type */
+	fs_entry_type_t type;
+	/*! Size of file, 0 for directories and other entry types */
+	size_t size;
+	/*! Last modification time in milliseconds since the epoch (UNIX time) */
+	tick_t last_modified;
+};
+
+/*! Directory listing allocated as one contiguous memory block holding all entries and names,
+see #fs_list_directory */
+struct fs_listing_t {
+	/*! Number of entries */
+	size_t count;
+	/*! Entries */
+	fs_entry_t entry[];
+};
+
+/*! Topology information for a single hardware thread, see #system_hardware_topology. Masks are
+in the same format as the mask passed to #thread_set_hardware and only represent the first 64
+hardware threads. Masks always include the hardware thread itself if representable. */
+struct hardware_topology_t {
+	/*! Physical core index, in range [0, #system_hardware_cores) */
+	unsigned int core;
+	/*! Physical package (socket) index */
+	unsigned int package;
+	/*! NUMA memory node */
+	unsigned int node;
+	/*! Core class, 0 being the highest performance class (big cores in a big.LITTLE setup),
+	in range [0, #system_hardware_core_classes) */
+	unsigned int core_class;
+	/*! Mask of hardware threads on the same physical core (SMT siblings) */
+	uint64_t core_mask;
+	/*! Mask of hardware threads sharing the level 2 cache */
+	uint64_t l2_mask;
+	/*! Mask of hardware threads sharing the level 3 cache */
+	uint64_t l3_mask;
+};
+
 /*! Single node in a hash map, mapping a single key to a single data value (pointer). */
 struct hashmap_node_t {
 	/*! Key for the hash map node */
@@ -1031,30 +2017,105 @@ struct hashmap_node_t {
 	void* value;
 };
 
-/*! Hash map container, mapping hash values to data pointers */
+/*! Hash map container, mapping hash values to data pointers. Nodes are stored in a single
+open addressed table with robin hood probing, growing in powers of two as needed. */
 struct hashmap_t {
-	/*! Number of buckets in the hash map */
+	/*! Number of node slots in the hash map, always a power of two */
 	size_t num_buckets;
-	/*! Total number of nodes in the hash map across all buckets */
+	/*! Total number of nodes stored in the hash map */
 	size_t num_nodes;
-	/*! Bucket array, represented as an array of hashmap_node_t arrays, which will be
-	    dynamically allocated and reallocated to the required sizes. */
-	hashmap_node_t* bucket[];
+	/*! Probe distance for each slot, one plus distance from home slot of stored node, zero
+	    for empty slots */
+	uint8_t* probe;
+	/*! Node slot array */
+	hashmap_node_t* bucket;
 };
 
-/*! Declare an inlined hashmap of given size */
+/*! Declare an inlined hashmap. Node storage is allocated on initialization, the size
+argument is ignored and kept for compatibility */
 #define FOUNDATION_DECLARE_HASHMAP(size) \
 	size_t num_buckets; \
 	size_t num_nodes; \
-	hashmap_node_t* bucket[size]
+	uint8_t* probe; \
+	hashmap_node_t* bucket
 
-/*! Hashmap of default size. Initialize with a call to 
+/*! Hashmap for inline declaration. Initialize with a call to
 <code>hashmap_fixed_t map;
-hashmap_initialize((hashmap_t*)&map, sizeof(map.bucket)/sizeof(map.bucket[0]), bucketsize)</code> */
+hashmap_initialize((hashmap_t*)&map, buckets, bucketsize)</code> */
 struct hashmap_fixed_t {
 	FOUNDATION_DECLARE_HASHMAP(13);
 };
 
+/*! Shard in a concurrent hash map. Writers serialize on the lock and make the sequence
+odd while modifying the shard, readers retry if the sequence changed during the lookup.
+Aligned to separate shards written by different threads into different cache lines */
+FOUNDATION_ALIGNED_STRUCT(hashmap_shard_t, 64) {
+	/*! Write sequence, odd while a write is in progress */
+	atomic32_t sequence;
+	/*! Writer lock */
+	lock_t lock;
+	/*! Current hash map storage */
+	atomicptr_t map;
+	/*! Hash maps replaced by growth, kept until finalization since readers may still
+	    access them */
+	hashmap_t** retired;
+};
+
+/*! Concurrent hash map container, mapping hash values to data pointers */
+struct hashmap_concurrent_t {
+	/*! Number of shards, always a power of two */
+	size_t num_shards;
+	/*! Shard array */
+	hashmap_shard_t* shard;
+};
+
+/*! Maximum length of a key stored inline in a string hash map node, longer keys are stored
+in the key arena of the map */
+#define HASHMAP_STRING_INLINE 20
+
+/*! Single node in a string keyed hash map, mapping a single string key to a single data value
+(pointer). Keys are not zero terminated. */
+struct hashmap_string_node_t {
+	/*! Hash of the key */
+	hash_t hash;
+	/*! Value for the hash map node */
+	void* value;
+	/*! Length of the key */
+	uint32_t length;
+	/*! Key storage */
+	union {
+		/*! Key characters if length is at most #HASHMAP_STRING_INLINE */
+		char chars[HASHMAP_STRING_INLINE];
+		/*! Offset of key characters in the key arena if length is above
+		    #HASHMAP_STRING_INLINE */
+		uint32_t offset;
+	} key;
+};
+
+/*! String keyed hash map container, mapping strings to data pointers. Nodes are stored in a
+single open addressed table with robin hood probing like #hashmap_t, keys are compared in full
+only on matching hash. Long keys are stored in a single contiguous arena, compacted when the
+table grows. */
+struct hashmap_string_t {
+	/*! Number of node slots in the hash map, always a power of two */
+	size_t num_buckets;
+	/*! Total number of nodes stored in the hash map */
+	size_t num_nodes;
+	/*! Probe distance for each slot, one plus distance from home slot of stored node, zero
+	    for empty slots */
+	uint8_t* probe;
+	/*! Node slot array */
+	hashmap_string_node_t* bucket;
+	/*! Key arena holding keys too long to be stored inline */
+	char* arena;
+	/*! Number of bytes used in key arena */
+	size_t arena_used;
+	/*! Number of bytes allocated for key arena */
+	size_t arena_capacity;
+	/*! Number of bytes in key arena used by erased keys */
+	size_t arena_garbage;
+};
+
 /*! Node in 32-bit hash table holding key and value for a single node. */
 FOUNDATION_ALIGNED_STRUCT(hashtable32_entry_t, 8) {
 	/*! Hash key for node in hash table */
@@ -1077,6 +2138,8 @@ FOUNDATION_ALIGNED_STRUCT(hashtable64_entry_t, 8) {
 FOUNDATION_ALIGNED_STRUCT(hashtable32_t, 8) {
 	/*! Number of nodes in the table, i.e maximum number of key-value pairs that can be stored. */
 	size_t capacity;
+	/*! Compaction generation, odd while entries are being moved by compaction */
+	atomic32_t generation;
 	/*! Hash table storage as array of nodes where each node is a key-value pair. */
 	hashtable32_entry_t entries[];
 };
@@ -1085,10 +2148,80 @@ FOUNDATION_ALIGNED_STRUCT(hashtable32_t, 8) {
 FOUNDATION_ALIGNED_STRUCT(hashtable64_t, 8) {
 	/*! Number of nodes in the table, i.e maximum number of key-value pairs that can be stored. */
 	size_t capacity;
+	/*! Compaction generation, odd while entries are being moved by compaction */
+	atomic32_t generation;
 	/*! Hash table storage as array of nodes where each node is a key-value pair. */
 	hashtable64_entry_t entries[];
 };
 
+/*! Slot in resizable 32-bit hash table, both key and value are updated atomically */
+FOUNDATION_ALIGNED_STRUCT(hashtable32_slot_t, 8) {
+	/*! Hash key for slot, zero if unused */
+	atomic32_t key;
+	/*! Value for the hash key, zero if erased. Reserved values mark slots being migrated
+	    to or already migrated to the next storage */
+	atomic32_t value;
+};
+
+/*! Storage of a resizable 32-bit hash table. Storage is migrated to a next storage of
+twice the capacity when it fills up */
+FOUNDATION_ALIGNED_STRUCT(hashtable32_storage_t, 8) {
+	/*! Number of slots, always a power of two */
+	size_t capacity;
+	/*! Number of claimed slots */
+	atomic32_t used;
+	/*! Index of next slot chunk to migrate */
+	atomic32_t copy_index;
+	/*! Number of migrated slots */
+	atomic32_t copy_done;
+	/*! Next storage, null if storage is not being migrated */
+	atomicptr_t next;
+	/*! Slot array */
+	hashtable32_slot_t slots[];
+};
+
+/*! Resizable hash table, a lock free mapping of 32-bit keys to 32-bit integer data */
+struct hashtable32_resizable_t {
+	/*! Current storage */
+	atomicptr_t current;
+	/*! First storage, head of the list of storages linked by next pointers */
+	hashtable32_storage_t* first;
+};
+
+/*! Slot in resizable 64-bit hash table, both key and value are updated atomically */
+FOUNDATION_ALIGNED_STRUCT(hashtable64_slot_t, 16) {
+	/*! Hash key for slot, zero if unused */
+	atomic64_t key;
+	/*! Value for the hash key, zero if erased. Reserved values mark slots being migrated
+	    to or already migrated to the next storage */
+	atomic64_t value;
+};
+
+/*! Storage of a resizable 64-bit hash table. Storage is migrated to a next storage of
+twice the capacity when it fills up */
+FOUNDATION_ALIGNED_STRUCT(hashtable64_storage_t, 8) {
+	/*! Number of slots, always a power of two */
+	size_t capacity;
+	/*! Number of claimed slots */
+	atomic32_t used;
+	/*! Index of next slot chunk to migrate */
+	atomic32_t copy_index;
+	/*! Number of migrated slots */
+	atomic32_t copy_done;
+	/*! Next storage, null if storage is not being migrated */
+	atomicptr_t next;
+	/*! Slot array */
+	hashtable64_slot_t slots[];
+};
+
+/*! Resizable hash table, a lock free mapping of 64-bit keys to 64-bit integer data */
+struct hashtable64_resizable_t {
+	/*! Current storage */
+	atomicptr_t current;
+	/*! First storage, head of the list of storages linked by next pointers */
+	hashtable64_storage_t* first;
+};
+
 /*! Memory context stack */
 struct memory_context_t {
 	/*! Current depth of memory context stack */
@@ -1097,6 +2230,69 @@ struct memory_context_t {
 	hash_t context[];
 };
 
+/*! Header of a chunk of memory owned by a memory arena. Chunks are linked in a list
+with the most recently allocated chunk first, allocations are bumped from the memory
+following the header */
+struct memory_arena_chunk_t {
+	/*! Next chunk in list */
+	memory_arena_chunk_t* next;
+	/*! End of chunk memory */
+	void* end;
+};
+
+/*! Memory arena for bump allocation. Allocations are bumped from the current chunk
+and new chunks are allocated as needed, all memory is released in bulk when the arena
+is reset or finalized */
+struct memory_arena_t {
+	/*! Memory context used for chunk allocations */
+	hash_t context;
+	/*! Default chunk size */
+	size_t chunk_size;
+	/*! Current chunk, head of chunk list */
+	memory_arena_chunk_t* chunk;
+	/*! Current allocation head in current chunk */
+	void* head;
+	/*! End of current chunk */
+	void* end;
+	/*! Arena below this arena in the thread arena scope stack */
+	memory_arena_t* outer;
+};
+
+struct memory_pool_t {
+	/*! Memory context used for chunk allocations */
+	hash_t context;
+	/*! Block size requested */
+	size_t block_size;
+	/*! Distance between blocks including header */
+	size_t stride;
+	/*! Block header size (and block alignment) */
+	size_t header;
+	/*! Number of blocks per chunk as a power of two shift */
+	unsigned int chunk_shift;
+	/*! Maximum number of chunks */
+	unsigned int chunk_max;
+	/*! Number of allocated chunks */
+	atomic32_t chunk_count;
+	/*! Lock for chunk growth */
+	atomic32_t chunk_lock;
+	/*! Free list head, lower 32 bits block index plus one, upper 32 bits ABA tag */
+	atomic64_t free;
+	/*! Chunk storage pointers */
+	void** chunk;
+};
+
+/*! Number of blocks held in a memory pool magazine */
+#define MEMORY_POOL_MAGAZINE_SIZE 32
+
+struct memory_pool_magazine_t {
+	/*! Pool */
+	memory_pool_t* pool;
+	/*! Number of blocks in magazine */
+	unsigned int count;
+	/*! Blocks */
+	void* block[MEMORY_POOL_MAGAZINE_SIZE];
+};
+
 /*! Declares the base object data layout. Object structures should be 8-byte align for
 platform compatibility. Use the macro as first declaration in an object struct:
 <code>typedef struct ALIGN(8)
@@ -1137,7 +2333,7 @@ FOUNDATION_ALIGNED_STRUCT(objectmap_t, 8) {
 	atomic64_t free;
 	/*! Counter for next available ID */
 	atomic64_t id;
-	/*! Number of slots in map */
+	/*! Maximum number of slots in map */
 	size_t size;
 	/*! Number of bits needed for slot index */
 	unsigned int size_bits;
@@ -1147,10 +2343,68 @@ FOUNDATION_ALIGNED_STRUCT(objectmap_t, 8) {
 	uint64_t mask_index;
 	/*! Bitmask for ID */
 	uint64_t mask_id;
-	/*! Slot array */
+	/*! Number of slots per segment as a power of two shift */
+	unsigned int segment_shift;
+	/*! Maximum number of segments */
+	unsigned int segment_max;
+	/*! Bitmask for slot index in segment */
+	uint64_t mask_segment;
+	/*! Number of allocated segments */
+	atomic32_t segment_count;
+	/*! Lock for segment growth */
+	atomic32_t segment_lock;
+	/*! Segment slot array pointers */
+	void*** segment;
+	/*! Slot array for maps with a single fixed size segment */
 	void* map[];
 };
 
+/*! Number of slots held in an object map magazine */
+#define OBJECTMAP_MAGAZINE_SIZE 32
+
+struct objectmap_magazine_t {
+	/*! Object map */
+	objectmap_t* map;
+	/*! Number of slots in magazine */
+	unsigned int count;
+	/*! Next ID tag in block of tags reserved from map */
+	uint64_t tag;
+	/*! End of block of tags reserved from map */
+	uint64_t tag_end;
+	/*! Slot indices */
+	uint64_t slot[OBJECTMAP_MAGAZINE_SIZE];
+};
+
+/*! Maximum number of fields in a structure of arrays map */
+#define SOAMAP_MAX_FIELDS 16
+
+/*! Value returned for handles not stored in a structure of arrays map */
+#define SOAMAP_INVALID ((size_t)-1)
+
+/*! Structure of arrays map storing a row of fields for each object handle. Rows are kept
+densely packed with one contiguous array per field, handles map to rows through a sparse
+array indexed by the object map slot index of the handle. */
+struct soamap_t {
+	/*! Bitmask for slot index in object handles */
+	uint64_t mask_index;
+	/*! Number of fields */
+	size_t num_fields;
+	/*! Size of a single element for each field */
+	size_t field_size[SOAMAP_MAX_FIELDS];
+	/*! Dense element array for each field */
+	void* field[SOAMAP_MAX_FIELDS];
+	/*! Dense array of object handles, one for each row */
+	object_t* object;
+	/*! Sparse array of row index plus one for each slot index, zero for no row */
+	uint32_t* sparse;
+	/*! Number of entries in sparse array */
+	size_t sparse_size;
+	/*! Number of rows */
+	size_t count;
+	/*! Number of rows allocated */
+	size_t capacity;
+};
+
 /*! State for a child process */
 struct process_t {
 	/*! Working directory */
@@ -1167,6 +2421,8 @@ struct process_t {
 	stream_t* pipeout;
 	/*! Pipe stream for stdin */
 	stream_t* pipein;
+	/*! Pipe stream for stderr */
+	stream_t* pipeerr;
 #if FOUNDATION_PLATFORM_WINDOWS
 	/*! Windows only, shell verb used when launching process with ShellExecute */
 	string_t verb;
@@ -1202,14 +2458,73 @@ struct radixsort_t {
 	radixsort_index_t* offset;
 };
 
+/*! State for a radix sorter with 32-bit indices for a defined data type. */
+struct radixsort32_t {
+	/*! Data type being sorted */
+	radixsort_data_t type;
+	/*! Maximum number of elements that can be sorted */
+	radixsort32_index_t size;
+	/*! Number of elements in last call to #radixsort32_sort */
+	radixsort32_index_t lastused;
+	/*! Index buffers holding sorted result */
+	radixsort32_index_t* indices[2];
+	/*! Buffer for histogram data */
+	radixsort32_index_t* histogram;
+	/*! Offset table */
+	radixsort32_index_t* offset;
+};
+
+/*! State for a radix sorter with 64-bit indices for a defined data type. */
+struct radixsort64_t {
+	/*! Data type being sorted */
+	radixsort_data_t type;
+	/*! Maximum number of elements that can be sorted */
+	radixsort64_index_t size;
+	/*! Number of elements in last call to #radixsort64_sort */
+	radixsort64_index_t lastused;
+	/*! Index buffers holding sorted result */
+	radixsort64_index_t* indices[2];
+	/*! Buffer for histogram data */
+	radixsort64_index_t* histogram;
+	/*! Offset table */
+	radixsort64_index_t* offset;
+};
+
+/*! Alias table for constant time weighted random sampling, see #random_alias_initialize */
+struct random_alias_t {
+	/*! Number of entries */
+	uint32_t count;
+	/*! Pairs of acceptance threshold and alias index for each entry */
+	uint32_t* table;
+};
+
+/*! Explicit pseudorandom generator state (xoshiro256**), see #random_state_initialize */
+struct random_state_t {
+	/*! Generator state words, must not all be zero */
+	uint64_t s[4];
+};
+
 /*! Compiled regular expression */
 struct regex_t {
-	/*! Counter during regex matching keeping number of currently captured substrings */
+	/*! Number of capture groups in the expression, set when compiling. Matching does not
+	modify the expression, so a compiled expression can be matched concurrently from any
+	number of threads */
 	unsigned int num_captures;
 	/*! Length of the compiled code array */
 	size_t code_length;
 	/*! Capacity of the code array (number of bytes) */
 	size_t code_allocated;
+	/*! Lazily constructed DFA used when matching without captures, null if not compiled
+	with #regex_compile_dfa */
+	regex_dfa_t* dfa;
+	/*! Offset in code array of the longest literal every match must contain, used to reject
+	input before matching */
+	size_t literal_offset;
+	/*! Length of required literal, zero if none */
+	size_t literal_length;
+	/*! Flag if the required literal is a prefix of every match, in which case match attempts
+	only start at occurrences of the literal */
+	bool literal_prefix;
 	/*! Compiled regex code */
 	uint8_t code[];
 };
@@ -1255,6 +2570,61 @@ struct ringbuffer_t {
 	FOUNDATION_DECLARE_RINGBUFFER;
 };
 
+/*! Declares the base single producer, single consumer ring buffer data layout. Producer
+and consumer state are kept on separate cache lines, each side caching the last seen position
+of the other side to avoid touching the shared cache line on every operation. Use the macro
+as last declaration in a ring buffer struct. */
+#define FOUNDATION_DECLARE_RINGBUFFER_SPSC \
+	FOUNDATION_ALIGN(64) atomic64_t total_write; \
+	uint64_t cached_read; \
+	FOUNDATION_ALIGN(64) atomic64_t total_read; \
+	uint64_t cached_write; \
+	FOUNDATION_ALIGN(64) size_t buffer_size; \
+	char buffer[]
+
+/*! Single producer, single consumer ring buffer, safe for one thread writing concurrently
+with one thread reading without locks. */
+struct ringbuffer_spsc_t {
+	/*!
+	\var ringbuffer_spsc_t::total_write
+	Total number of bytes written to ring buffer, owned by producer
+
+	\var ringbuffer_spsc_t::cached_read
+	Last total number of bytes read seen by producer
+
+	\var ringbuffer_spsc_t::total_read
+	Total number of bytes read from ring buffer, owned by consumer
+
+	\var ringbuffer_spsc_t::cached_write
+	Last total number of bytes written seen by consumer
+
+	\var ringbuffer_spsc_t::buffer_size
+	Size of buffer in bytes
+
+	\var ringbuffer_spsc_t::buffer
+	Memory buffer
+	*/
+	FOUNDATION_DECLARE_RINGBUFFER_SPSC;
+};
+
+/*! Single producer, single consumer ring buffer with the buffer memory pages mapped twice
+back to back in virtual memory, making any range of pending data or free space contiguous
+in memory even when wrapping around the end of the buffer. */
+FOUNDATION_ALIGNED_STRUCT(ringbuffer_mirror_t, 64) {
+	/*! Total number of bytes written to ring buffer, owned by producer */
+	FOUNDATION_ALIGN(64) atomic64_t total_write;
+	/*! Last total number of bytes read seen by producer */
+	uint64_t cached_read;
+	/*! Total number of bytes read from ring buffer, owned by consumer */
+	FOUNDATION_ALIGN(64) atomic64_t total_read;
+	/*! Last total number of bytes written seen by consumer */
+	uint64_t cached_write;
+	/*! Size of buffer in bytes, multiple of virtual memory page size */
+	FOUNDATION_ALIGN(64) size_t buffer_size;
+	/*! Memory buffer, mapped twice over a range of twice the buffer size */
+	char* buffer;
+};
+
 #if FOUNDATION_PLATFORM_MACOSX
 
 /*! Semaphore for thread synchronization and communication. Actual type specifics depend
@@ -1276,12 +2646,30 @@ struct semaphore_t {
 	semaphore_native_t unnamed;
 };
 
+#elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+
+/*! Semaphore counter, also used as the futex word blocking threads wait on */
+struct semaphore_futex_t {
+	/*! Semaphore value */
+	atomic32_t count;
+	/*! Number of threads blocking or about to block on the futex */
+	atomic32_t waiters;
+	/*! Initialization state of a shared counter, 2 once the initial value is set */
+	atomic32_t initialized;
+};
+
+struct semaphore_t {
+	string_t name;
+	/*! Counter mapped from shared memory for named semaphores, null for unnamed */
+	semaphore_futex_t* shared;
+	/*! Counter for unnamed semaphores */
+	semaphore_futex_t unnamed;
+};
+
 #elif FOUNDATION_PLATFORM_POSIX || FOUNDATION_PLATFORM_PNACL
 
 union semaphore_native_t {
-#  if FOUNDATION_PLATFORM_ANDROID
-	volatile unsigned int count;
-#  elif FOUNDATION_PLATFORM_PNACL
+#  if FOUNDATION_PLATFORM_PNACL
 	volatile int count;
 	volatile int nwaiters;
 #else
@@ -1309,15 +2697,17 @@ struct beacon_t {
 #if FOUNDATION_PLATFORM_WINDOWS
 	/*! Beacon event */
 	void* event;
-	/*! Linked events */
-	void* all[8];
+	/*! Linked events (array), limited to MAXIMUM_WAIT_OBJECTS */
+	void** all;
 #elif FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
 	/*! Beacon file descriptor */
 	int fd;
 	/*! Beacon poll descriptor */
 	int poll;
-	/*! Linked events (file descriptors) */
-	int all[8];
+	/*! Linked events (array of file descriptors) */
+	int* all;
+	/*! Linked event write readiness flags (array), false for read readiness */
+	bool* writable;
 	/*! Fired flag */
 	atomic32_t fired;
 #elif FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
@@ -1325,14 +2715,136 @@ struct beacon_t {
 	int kq;
 	/*! Beacon file descriptor */
 	int writefd;
-	/*! Linked events (file descriptors) */
-	int all[8];
+	/*! Linked events (array of file descriptors) */
+	int* all;
+	/*! Linked event write readiness flags (array), false for read readiness */
+	bool* writable;
 	/*! Fired flag */
 	atomic32_t fired;
 #elif FOUNDATION_PLATFORM_PNACL
 	/*! Beacon mutex and event */
 	mutex_t* mutex;
 #endif
+	/*! Wait statistics */
+	lock_statistics_t statistics;
+};
+
+/*! Event stream registered in a run loop */
+struct runloop_stream_t {
+	/*! Event stream, null if removed during dispatch */
+	event_stream_t* stream;
+	/*! Callback */
+	runloop_stream_fn fn;
+	/*! Callback argument */
+	void* arg;
+};
+
+/*! Beacon registered in a run loop */
+struct runloop_source_t {
+	/*! Beacon, null if removed during dispatch */
+	beacon_t* beacon;
+	/*! Callback */
+	runloop_beacon_fn fn;
+	/*! Callback argument */
+	void* arg;
+};
+
+/*! Timer pending in a run loop, entry in the timer min-heap */
+struct runloop_timer_t {
+	/*! Deadline timestamp */
+	tick_t deadline;
+	/*! Sequence number to dispatch timers with equal deadline in order of scheduling */
+	uint64_t sequence;
+	/*! Period in ticks, zero for one-shot timers */
+	tick_t period;
+	/*! Timer id */
+	unsigned int id;
+	/*! Callback */
+	runloop_timer_fn fn;
+	/*! Callback argument */
+	void* arg;
+};
+
+/*! Run loop waiting on all registered sources through a single beacon wait, sleeping until
+the earliest timer or delayed event deadline */
+struct runloop_t {
+	/*! Beacon fired by registered event streams and linked to registered beacons */
+	beacon_t beacon;
+	/*! Registered event streams (array) */
+	runloop_stream_t* streams;
+	/*! Registered beacons (array) */
+	runloop_source_t* sources;
+	/*! Timer min-heap ordered by deadline (array) */
+	runloop_timer_t* timers;
+	/*! Last timer id */
+	unsigned int timer_id;
+	/*! Timer sequence counter */
+	uint64_t timer_sequence;
+	/*! Stop flag */
+	atomic32_t stop;
+	/*! Dispatching flag, removals are deferred while set */
+	bool dispatching;
+	/*! Removal during dispatch flag */
+	bool removed;
+};
+
+/*! Slot in a bounded queue, sequence number flagging if the slot is ready for
+enqueue or dequeue at a given position */
+FOUNDATION_ALIGNED_STRUCT(queue_slot_t, 16) {
+	/*! Sequence number */
+	atomic64_t sequence;
+	/*! Item */
+	void* item;
+};
+
+/*! Bounded multi-producer, multi-consumer queue of pointer sized items. Enqueue and dequeue
+positions are kept on separate cache lines. */
+FOUNDATION_ALIGNED_STRUCT(queue_t, 64) {
+	/*! Enqueue position */
+	FOUNDATION_ALIGN(64) atomic64_t enqueue;
+	/*! Dequeue position */
+	FOUNDATION_ALIGN(64) atomic64_t dequeue;
+	/*! Number of slots, power of two */
+	FOUNDATION_ALIGN(64) size_t capacity;
+	/*! Bitmask for slot index */
+	size_t mask;
+	/*! Number of threads waiting for space to push */
+	atomic32_t waiting_push;
+	/*! Number of threads waiting for items to pop */
+	atomic32_t waiting_pop;
+	/*! Semaphore signalling available space */
+	semaphore_t signal_push;
+	/*! Semaphore signalling available items */
+	semaphore_t signal_pop;
+	/*! Slots */
+	queue_slot_t* slot;
+};
+
+/*! Task description, function to execute with argument and name of profile block */
+struct task_t {
+	/*! Task function */
+	task_fn function;
+	/*! Argument passed to task function */
+	void* arg;
+	/*! Name of task, used for profile block */
+	string_const_t name;
+};
+
+/*! Task completion counter, must be zero initialized. Counts tasks submitted with the
+counter that have not yet completed. */
+struct task_counter_t {
+	/*! Number of tasks not yet completed */
+	atomic32_t value;
+	/*! Continuation tasks submitted when the counter reaches zero */
+	atomicptr_t continuation;
+};
+
+/*! Payload layout for a timer event */
+struct timer_event_payload_t {
+	/*! Timer identifier */
+	timer_id_t id;
+	/*! Argument given when adding the timer */
+	void* arg;
 };
 
 /*! Thread representation */
@@ -1362,6 +2874,8 @@ struct thread_t {
 	/*! OS handle */
 	uintptr_t handle;
 #endif
+	/*! Pooled OS thread running the thread, null if not pooled */
+	thread_runner_t* runner;
 	/*! Name string */
 	string_const_t name;
 	/*! Buffer for name string */
@@ -1436,10 +2950,11 @@ FOUNDATION_ALIGNED_STRUCT(stream_buffer_t, 8) {
 	size_t current;
 	/*! Current size of buffer (always less or equal than capacity) */
 	size_t size;
+	/*! Memory buffer. Offset, size and buffer are shared in layout with memory mapped
+	streams, allowing inline reads of both directly from memory */
+	void* buffer;
 	/*! Current allocated capacity of buffer */
 	size_t capacity;
-	/*! Memory buffer */
-	void* buffer;
 	/*! If this flag is set the memory buffer is owned internally by the stream buffer
 	and will be deallocated together with the stream buffer. If not set, the ownership
 	of the memory buffer is handled externally. */
@@ -1461,6 +2976,8 @@ FOUNDATION_ALIGNED_STRUCT(stream_pipe_t, 8) {
 	/*! End of stream flag indicating the pipe has reached end of stream and
 	is considered closed. */
 	bool eos;
+	/*! Non-blocking flag, reads only return data available in the pipe. */
+	bool nonblocking;
 #if FOUNDATION_PLATFORM_WINDOWS
 	/*! Windows only, file handle for read end of the pipe. */
 	void* handle_read;
@@ -1475,24 +2992,215 @@ FOUNDATION_ALIGNED_STRUCT(stream_pipe_t, 8) {
 #endif
 };
 
+/*! Stream interface for a TCP or Unix domain socket. This struct is also a stream_t (stream
+struct type declared at start of struct) and can be used in all functions operating on a
+stream_t. Socket streams are sequential (non-seekable). */
+FOUNDATION_ALIGNED_STRUCT(stream_socket_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! End of stream flag indicating the connection has been closed by the peer or failed */
+	bool eos;
+	/*! Non-blocking flag, reads and writes only transfer what the socket buffers allow */
+	bool nonblocking;
+	/*! Listening flag, the socket accepts connections and does not transfer data */
+	bool listening;
+	/*! Cork flag, partial segments are held back until uncorked or flushed */
+	bool corked;
+	/*! Socket file descriptor, negative if closed */
+	int fd;
+};
+
+/*! Ring buffer stream state placed in named shared memory, allowing a ring buffer stream to
+be read and written by two different processes. The ring buffer memory follows the struct. */
+FOUNDATION_ALIGNED_STRUCT(ringbuffer_shared_t, 64) {
+	/*! Initialization state, 0 uninitialized, 1 initializing, 2 initialized */
+	atomic32_t initialized;
+	/*! Number of bytes reader is waiting for, 0 if not waiting */
+	atomic64_t pending_read;
+	/*! Number of bytes of space writer is waiting for, 0 if not waiting */
+	atomic64_t pending_write;
+	FOUNDATION_DECLARE_RINGBUFFER_SPSC;
+};
+
 /*! Stream interface for read/write to a ring buffer. This struct is also a stream_t
 (stream struct type declared at start of struct) and can be used in all functions
 operating on a stream_t. Read and write operation can be concurrent (one single
-thread reading, one single thread writing) as availability of data is flagged with
-semaphores. Multiple readers and/or writers are not supported. Stream is sequential. */
-FOUNDATION_ALIGNED_STRUCT(stream_ringbuffer_t, 8) {
+thread reading, one single thread writing) using a lock free single producer, single
+consumer ring buffer, with semaphores used only to block on a full or empty buffer.
+Multiple readers and/or writers are not supported. Stream is sequential. Streams created
+in named shared memory keep the ring buffer in the shared memory block instead of at the end
+of the struct. */
+FOUNDATION_ALIGNED_STRUCT(stream_ringbuffer_t, 64) {
 	FOUNDATION_DECLARE_STREAM;
 	/*! Semaphore signalling availability of data for reading */
 	semaphore_t signal_read;
 	/*! Semaphore signalling availability of data for writing */
 	semaphore_t signal_write;
-	/*! Number of bytes pending for reading */
-	volatile int pending_read;
-	/*! Number of bytes pending for writing */
-	volatile int pending_write;
+	/*! Number of bytes reader is waiting for, 0 if not waiting */
+	atomic64_t pending_read;
+	/*! Number of bytes of space writer is waiting for, 0 if not waiting */
+	atomic64_t pending_write;
 	/*! Number of bytes written (total size of stream) */
 	size_t total_size;
-	FOUNDATION_DECLARE_RINGBUFFER;
+	/*! Minimum number of buffered bytes before waking a blocked reader or firing beacon */
+	size_t watermark_low;
+	/*! Maximum number of buffered bytes before waking a blocked writer */
+	size_t watermark_high;
+	/*! Optional beacon fired when data reaches the low watermark */
+	beacon_t* beacon;
+	/*! Flag set when beacon has been fired and reader has not yet drained the data */
+	atomic32_t beacon_fired;
+	/*! Shared memory state for inter-process streams, null if ring buffer is local */
+	ringbuffer_shared_t* shared;
+	/*! Size of shared memory mapping */
+	size_t shared_size;
+	/*! Name of shared memory object */
+	string_t shared_name;
+	FOUNDATION_DECLARE_RINGBUFFER_SPSC;
+};
+
+/*! Stream interface adding read-ahead and write-behind buffering to another stream. This
+struct is also a stream_t (stream struct type declared at start of struct) and can be used
+in all functions operating on a stream_t. Stream flags and mode are inherited from the
+wrapped stream, which must not be accessed directly while wrapped. */
+FOUNDATION_ALIGNED_STRUCT(stream_buffered_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! Wrapped stream */
+	stream_t* stream;
+	/*! Flag indicating the wrapped stream is owned and deallocated with this stream */
+	bool own;
+	/*! Capacity of each of the read-ahead and write-behind buffers */
+	size_t capacity;
+	/*! Read-ahead buffer, null if stream is not opened for reading */
+	char* read_buffer;
+	/*! Offset of next byte to read in read-ahead buffer */
+	size_t read_offset;
+	/*! Number of bytes in read-ahead buffer */
+	size_t read_size;
+	/*! Write-behind buffer, null if stream is not opened for writing */
+	char* write_buffer;
+	/*! Number of bytes pending in write-behind buffer */
+	size_t write_size;
+};
+
+/*! Stream interface compressing data written to another stream or decompressing data read
+from another stream, in independently compressed blocks. This struct is also a stream_t
+(stream struct type declared at start of struct) and can be used in all functions operating
+on a stream_t. The wrapped stream must not be accessed directly while wrapped. */
+FOUNDATION_ALIGNED_STRUCT(stream_compressed_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! Wrapped stream */
+	stream_t* stream;
+	/*! Flag indicating the wrapped stream is owned and deallocated with this stream */
+	bool own;
+	/*! Flag indicating the frame header has been read or written */
+	bool header;
+	/*! Flag indicating the end of frame marker has been read */
+	bool end;
+	/*! Maximum number of uncompressed bytes in a block */
+	size_t block_size;
+	/*! Offset of frame header in wrapped stream */
+	size_t frame_offset;
+	/*! Uncompressed stream offset of start of current block */
+	size_t block_offset;
+	/*! Uncompressed data of current block */
+	char* raw;
+	/*! Offset of next byte to read in current block */
+	size_t raw_offset;
+	/*! Number of bytes in current block */
+	size_t raw_size;
+	/*! Compressed data of current block */
+	char* packed;
+	/*! Match table used when compressing blocks, null if stream is not opened for writing */
+	uint32_t* table;
+};
+
+/*! Stream interface computing a checksum of all data read from or written to another stream.
+This struct is also a stream_t (stream struct type declared at start of struct) and can be
+used in all functions operating on a stream_t. */
+FOUNDATION_ALIGNED_STRUCT(stream_checksum_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! Wrapped stream */
+	stream_t* stream;
+	/*! Flag indicating the wrapped stream is owned and deallocated with this stream */
+	bool own;
+	/*! Checksum of transferred data */
+	checksum_t checksum;
+};
+
+/*! Stream interface encoding data written to another stream as base64 text, or decoding
+base64 text read from another stream. This struct is also a stream_t (stream struct type
+declared at start of struct) and can be used in all functions operating on a stream_t. */
+FOUNDATION_ALIGNED_STRUCT(stream_base64_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! Wrapped stream */
+	stream_t* stream;
+	/*! Flag indicating the wrapped stream is owned and deallocated with this stream */
+	bool own;
+	/*! Flag indicating the end of the wrapped stream has been decoded */
+	bool end;
+	/*! Number of raw bytes read or written */
+	size_t offset;
+	/*! Offset of next decoded byte to read from buffer */
+	size_t buffer_offset;
+	/*! Number of decoded bytes in buffer when reading, or number of bytes of an incomplete
+	group pending encoding when writing */
+	size_t buffer_size;
+	/*! Number of characters of an incomplete group carried over to next decode */
+	size_t carry_size;
+	/*! Characters of an incomplete group carried over to next decode */
+	char carry[4];
+	/*! Decoded data when reading, or bytes of an incomplete group when writing */
+	unsigned char buffer[768];
+};
+
+/*! Stream interface encrypting data written to another stream and decrypting data read from
+another stream with a block cipher in counter mode. This struct is also a stream_t (stream
+struct type declared at start of struct) and can be used in all functions operating on a
+stream_t. */
+FOUNDATION_ALIGNED_STRUCT(stream_cipher_t, 8) {
+	FOUNDATION_DECLARE_STREAM;
+	/*! Wrapped stream */
+	stream_t* stream;
+	/*! Flag indicating the wrapped stream is owned and deallocated with this stream */
+	bool own;
+	/*! AES cipher, null if the stream uses blowfish */
+	const aes_t* aes;
+	/*! Blowfish cipher, null if the stream uses AES */
+	const blowfish_t* blowfish;
+	/*! Counter of the first block */
+	uint128_t vec;
+	/*! Offset of the start of the stream in the wrapped stream */
+	size_t base;
+	/*! Current offset in stream */
+	size_t offset;
+	/*! Keystream buffer for one chunk of data */
+	uint8_t* keystream;
+};
+
+/*! Buffer span for vectored stream I/O, a pointer to a buffer and the number of bytes in
+the buffer. Spans are read or written in order as if the buffers were contiguous. */
+struct stream_span_t {
+	/*! Buffer */
+	void* data;
+	/*! Number of bytes in buffer */
+	size_t size;
+};
+
+/*! Iterator over lines in a stream. Lines are returned as slices of the stream memory for
+memory backed streams, or of an internal read buffer for other streams. */
+struct stream_line_iterator_t {
+	/*! Stream */
+	stream_t* stream;
+	/*! Line delimiter */
+	char delimiter;
+	/*! Read buffer, null if lines are sliced directly from stream memory */
+	char* buffer;
+	/*! Capacity of read buffer */
+	size_t capacity;
+	/*! Offset of next line in read buffer */
+	size_t offset;
+	/*! Number of bytes in read buffer */
+	size_t size;
 };
 
 /*! Virtual function table for stream implementations. Each stream type must provide
@@ -1503,6 +3211,12 @@ struct stream_vtable_t {
 	stream_read_fn read;
 	/*! Function to write data to stream. */
 	stream_write_fn write;
+	/*! Function to read data from stream into multiple buffers, null to read each buffer
+	with the read function. */
+	stream_read_vector_fn read_vector;
+	/*! Function to write data from multiple buffers to stream, null to write each buffer
+	with the write function. */
+	stream_write_vector_fn write_vector;
 	/*! Function to query if current position is at end of stream. */
 	stream_eos_fn eos;
 	/*! Function to flush any pending data to stream. */
@@ -1528,6 +3242,8 @@ struct stream_vtable_t {
 	stream_finalize_fn finalize;
 	/*! Function to clone the stream. */
 	stream_clone_fn clone;
+	/*! Function to hint the expected access pattern, null if hints are not supported. */
+	stream_advise_fn advise;
 };
 
 #if FOUNDATION_COMPILER_CLANG
@@ -42,6 +42,12 @@ typedef union {
 
 static atomic32_t _uuid_last_counter;
 
+//Last time-ordered UUID issued, millisecond timestamp in the upper bits and a 12 bit
+//sequence counter in the lower bits. Overflowing the counter advances the timestamp
+static atomic64_t _uuid_ordered_state;
+
+#define UUID_ORDERED_BLOCK 64
+
 //6ba7b810-9dad-11d1-80b4-00c04fd430c8
 #if FOUNDATION_ARCH_ENDIAN_LITTLE
 const uuid_t UUID_DNS = { { 0x11d19dad6ba7b810ULL, 0xc830d44fc000b480ULL } };
@@ -113,6 +119,65 @@ uuid_generate_time(void) {
 	return convert.uuid;
 }
 
+//Reserve a range of time-ordered states, returns the first state of the range
+static uint64_t
+_uuid_ordered_reserve(size_t count) {
+	int64_t now = (int64_t)time_system() << 12;
+	int64_t last, first;
+	do {
+		last = atomic_load64(&_uuid_ordered_state);
+		first = (now > last) ? now : last + 1;
+	}
+	while (!atomic_cas64(&_uuid_ordered_state, first + (int64_t)count - 1, last));
+	return (uint64_t)first;
+}
+
+static uuid_t
+_uuid_make_ordered(uint64_t state, uint32_t rnd0, uint32_t rnd1) {
+	uuid_convert_t convert;
+	uint64_t timestamp = state >> 12;
+
+	//48 bit timestamp, version, 12 bit sequence counter, variant and 62 random bits
+	convert.raw.data1 = (uint32_t)(timestamp >> 16);
+	convert.raw.data2 = (uint16_t)(timestamp & 0xFFFF);
+	convert.raw.data3 = (uint16_t)(0x7000 | (state & 0x0FFF));
+	convert.raw.data4[0] = (uint8_t)((rnd0 & 0x3F) | 0x80);
+	convert.raw.data4[1] = (uint8_t)((rnd0 >> 8) & 0xFF);
+	convert.raw.data4[2] = (uint8_t)((rnd0 >> 16) & 0xFF);
+	convert.raw.data4[3] = (uint8_t)((rnd0 >> 24) & 0xFF);
+	convert.raw.data4[4] = (uint8_t)(rnd1 & 0xFF);
+	convert.raw.data4[5] = (uint8_t)((rnd1 >> 8) & 0xFF);
+	convert.raw.data4[6] = (uint8_t)((rnd1 >> 16) & 0xFF);
+	convert.raw.data4[7] = (uint8_t)((rnd1 >> 24) & 0xFF);
+	return convert.uuid;
+}
+
+uuid_t
+uuid_generate_time_ordered(void) {
+	uint64_t state = _uuid_ordered_reserve(1);
+	uint64_t rnd = random64();
+	return _uuid_make_ordered(state, (uint32_t)rnd, (uint32_t)(rnd >> 32));
+}
+
+void
+uuid_generate_time_ordered_array(uuid_t* uuids, size_t count) {
+	uint32_t rnd[UUID_ORDERED_BLOCK * 2];
+	uint64_t state;
+	size_t iuuid, num;
+	if (!count)
+		return;
+
+	state = _uuid_ordered_reserve(count);
+	while (count) {
+		num = (count < UUID_ORDERED_BLOCK) ? count : UUID_ORDERED_BLOCK;
+		random_fill_uint32(rnd, num * 2);
+		for (iuuid = 0; iuuid < num; ++iuuid, ++state)
+			uuids[iuuid] = _uuid_make_ordered(state, rnd[iuuid * 2], rnd[(iuuid * 2) + 1]);
+		uuids += num;
+		count -= num;
+	}
+}
+
 uuid_t
 uuid_generate_name(const uuid_t ns, const char* name, size_t length) {
 	//v3 uuid, namespace and md5
@@ -159,28 +224,73 @@ uuid_generate_name(const uuid_t ns, const char* name, size_t length) {
 #  define snprintf _snprintf
 #endif
 
+//Fields are hex encoded in big endian byte order as one block, then spread out around dashes
 string_t
 string_from_uuid(char* buffer, size_t size, const uuid_t val) {
-	int len;
+	char digits[32];
+	char formatted[36];
+	uint8_t bytes[16];
 	uuid_convert_t convert;
+	size_t length;
+	uint32_t data1;
+	uint16_t data2, data3;
+
 	convert.uuid = val;
-	len = snprintf(buffer, size, "%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x", convert.raw.data1,
-	               convert.raw.data2, convert.raw.data3, convert.raw.data4[0], convert.raw.data4[1],
-	               convert.raw.data4[2], convert.raw.data4[3], convert.raw.data4[4], convert.raw.data4[5],
-	               convert.raw.data4[6], convert.raw.data4[7]);
-	if ((len < 0) || ((unsigned int)len > size)) {
-		if (size)
-			buffer[ size - 1 ] = 0;
-		return (string_t) {buffer, size ? (size - 1) : 0};
-	}
-	return (string_t) {buffer, (unsigned int)len};
+	data1 = byteorder_bigendian32(convert.raw.data1);
+	data2 = byteorder_bigendian16(convert.raw.data2);
+	data3 = byteorder_bigendian16(convert.raw.data3);
+	memcpy(bytes, &data1, 4);
+	memcpy(bytes + 4, &data2, 2);
+	memcpy(bytes + 6, &data3, 2);
+	memcpy(bytes + 8, convert.raw.data4, 8);
+	string_hex_encode(digits, sizeof(digits), bytes, sizeof(bytes), false);
+
+	memcpy(formatted, digits, 8);
+	formatted[8] = '-';
+	memcpy(formatted + 9, digits + 8, 4);
+	formatted[13] = '-';
+	memcpy(formatted + 14, digits + 12, 4);
+	formatted[18] = '-';
+	memcpy(formatted + 19, digits + 16, 4);
+	formatted[23] = '-';
+	memcpy(formatted + 24, digits + 20, 12);
+
+	if (!size)
+		return (string_t) {buffer, 0};
+	length = (size > sizeof(formatted)) ? sizeof(formatted) : (size - 1);
+	memcpy(buffer, formatted, length);
+	buffer[length] = 0;
+	return (string_t) {buffer, length};
 }
 
+//Canonical uuid strings are decoded as one block with dashes removed, other strings are parsed
+//field by field with the library conversion
 uuid_t
 string_to_uuid(const char* str, size_t length) {
 	uuid_convert_t convert;
 	unsigned int data[10];
-	FOUNDATION_UNUSED(length);
+	if ((length >= 36) && (str[8] == '-') && (str[13] == '-') && (str[18] == '-') &&
+	        (str[23] == '-')) {
+		char digits[32];
+		uint8_t bytes[16];
+		memcpy(digits, str, 8);
+		memcpy(digits + 8, str + 9, 4);
+		memcpy(digits + 12, str + 14, 4);
+		memcpy(digits + 16, str + 19, 4);
+		memcpy(digits + 20, str + 24, 12);
+		if (string_hex_decode(digits, sizeof(digits), bytes, sizeof(bytes)) == sizeof(bytes)) {
+			uint32_t data1;
+			uint16_t data2, data3;
+			memcpy(&data1, bytes, 4);
+			memcpy(&data2, bytes + 4, 2);
+			memcpy(&data3, bytes + 6, 2);
+			convert.raw.data1 = byteorder_bigendian32(data1);
+			convert.raw.data2 = byteorder_bigendian16(data2);
+			convert.raw.data3 = byteorder_bigendian16(data3);
+			memcpy(convert.raw.data4, bytes + 8, 8);
+			return convert.uuid;
+		}
+	}
 	memset(data, 0, sizeof(data));
 	convert.raw.data1 = 0;
 	if (length)
@@ -15,7 +15,7 @@
 /*! \file uuid.h
 \brief UUID
 
-UUID generation (version 1, 3 and 4) and utility functions */
+UUID generation (version 1, 3, 4 and 7) and utility functions */
 
 #include <foundation/platform.h>
 #include <foundation/types.h>
@@ -41,6 +41,23 @@ uuid_generate_name(const uuid_t ns, const char* name, size_t length);
 FOUNDATION_API uuid_t
 uuid_generate_random(void);
 
+/*! Generate UUID based on Unix time in milliseconds and random numbers - version 7. UUIDs
+generated in the process are strictly increasing in string form (and when compared as big
+endian bytes), which keeps them local in ordered indices. Up to 4096 UUIDs are issued per
+millisecond from a sequence counter, beyond that the timestamp runs ahead of the clock.
+Generation is lock free.
+\return Time-ordered UUID */
+FOUNDATION_API uuid_t
+uuid_generate_time_ordered(void);
+
+/*! Generate an array of time-ordered UUIDs, see #uuid_generate_time_ordered. The range is
+reserved with a single atomic operation and the random bits are generated in bulk from the
+random state of the calling thread.
+\param uuids Array receiving the UUIDs, in increasing order
+\param count Number of UUIDs to generate */
+FOUNDATION_API void
+uuid_generate_time_ordered_array(uuid_t* uuids, size_t count);
+
 /*! Check if UUIDs are equal.
 \param u0 First UUID
 \param u1 Second UUID
@@ -0,0 +1,245 @@
+/* varint.c  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <foundation/internal.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && \
+    (FOUNDATION_COMPILER_MSVC || FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG)
+#  define VBYTE_SSSE3 1
+#  include <tmmintrin.h>
+#  if FOUNDATION_COMPILER_MSVC
+#    include <intrin.h>
+#    define VBYTE_TARGET_SSSE3
+#  else
+#    define VBYTE_TARGET_SSSE3 __attribute__((target("ssse3")))
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define VBYTE_NEON 1
+#  include <arm_neon.h>
+#endif
+
+//Byte shuffle and coded length for each control byte
+FOUNDATION_ALIGN(16) static uint8_t _vbyte_shuffle[256][16];
+static uint8_t _vbyte_length[256];
+static bool _vbyte_simd;
+
+size_t
+varint_encode(uint64_t value, void* buffer) {
+	uint8_t* out = buffer;
+	size_t size = 0;
+	while (value >= 0x80) {
+		out[size++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[size++] = (uint8_t)value;
+	return size;
+}
+
+size_t
+varint_decode(const void* buffer, size_t size, uint64_t* value) {
+	const uint8_t* in = buffer;
+	uint64_t result = 0;
+	size_t ibyte;
+	if (size > VARINT_MAX_SIZE)
+		size = VARINT_MAX_SIZE;
+	for (ibyte = 0; ibyte < size; ++ibyte) {
+		result |= (uint64_t)(in[ibyte] & 0x7F) << (7 * ibyte);
+		if (!(in[ibyte] & 0x80)) {
+			//Tenth byte can only hold the top bit
+			if ((ibyte == VARINT_MAX_SIZE - 1) && (in[ibyte] > 1))
+				return 0;
+			*value = result;
+			return ibyte + 1;
+		}
+	}
+	return 0;
+}
+
+size_t
+vbyte_bound(size_t count) {
+	return ((count + 3) / 4) + (count * 4);
+}
+
+size_t
+vbyte_encode(const uint32_t* values, size_t count, bool delta, void* buffer) {
+	uint8_t* control = buffer;
+	uint8_t* data = control + ((count + 3) / 4);
+	uint32_t previous = 0;
+	size_t ival;
+
+	memset(control, 0, (count + 3) / 4);
+	for (ival = 0; ival < count; ++ival) {
+		uint32_t value = delta ? values[ival] - previous : values[ival];
+		unsigned int code = (value > 0xFFFFFF) ? 3 : ((value > 0xFFFF) ? 2 : ((value > 0xFF) ? 1 : 0));
+		control[ival / 4] |= (uint8_t)(code << ((ival % 4) * 2));
+		data[0] = (uint8_t)value;
+		if (code > 0)
+			data[1] = (uint8_t)(value >> 8);
+		if (code > 1)
+			data[2] = (uint8_t)(value >> 16);
+		if (code > 2)
+			data[3] = (uint8_t)(value >> 24);
+		data += code + 1;
+		previous = values[ival];
+	}
+	return (size_t)pointer_diff(data, buffer);
+}
+
+static const uint8_t*
+_vbyte_decode_scalar(const uint8_t* control, const uint8_t* data, uint32_t* values, size_t begin,
+                     size_t end, bool delta, uint32_t previous) {
+	size_t ival;
+	for (ival = begin; ival < end; ++ival) {
+		unsigned int code = (control[ival / 4] >> ((ival % 4) * 2)) & 3;
+		uint32_t value = data[0];
+		if (code > 0)
+			value |= (uint32_t)data[1] << 8;
+		if (code > 1)
+			value |= (uint32_t)data[2] << 16;
+		if (code > 2)
+			value |= (uint32_t)data[3] << 24;
+		data += code + 1;
+		if (delta) {
+			value += previous;
+			previous = value;
+		}
+		values[ival] = value;
+	}
+	return data;
+}
+
+#if VBYTE_SSSE3
+
+//Decode full groups of four values while at least 16 bytes of data can be loaded
+static VBYTE_TARGET_SSSE3 size_t
+_vbyte_decode_ssse3(const uint8_t* control, const uint8_t** data, const uint8_t* end,
+                    uint32_t* values, size_t groups, bool delta) {
+	const uint8_t* in = *data;
+	__m128i previous = _mm_setzero_si128();
+	size_t igroup;
+	for (igroup = 0; (igroup < groups) && (in + 16 <= end); ++igroup) {
+		uint8_t code = control[igroup];
+		__m128i raw = _mm_loadu_si128((const __m128i*)(const void*)in);
+		__m128i value = _mm_shuffle_epi8(raw, _mm_load_si128((const __m128i*)(const void*)
+		                                                     _vbyte_shuffle[code]));
+		if (delta) {
+			value = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+			value = _mm_add_epi32(value, _mm_slli_si128(value, 8));
+			value = _mm_add_epi32(value, previous);
+			previous = _mm_shuffle_epi32(value, 0xFF);
+		}
+		_mm_storeu_si128((__m128i*)(void*)(values + (igroup * 4)), value);
+		in += _vbyte_length[code];
+	}
+	*data = in;
+	return igroup;
+}
+
+static bool
+_vbyte_ssse3_supported(void) {
+#if FOUNDATION_COMPILER_MSVC
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+#elif VBYTE_NEON
+
+static size_t
+_vbyte_decode_neon(const uint8_t* control, const uint8_t** data, const uint8_t* end,
+                   uint32_t* values, size_t groups, bool delta) {
+	const uint8_t* in = *data;
+	const uint32x4_t zero = vdupq_n_u32(0);
+	uint32x4_t previous = zero;
+	size_t igroup;
+	for (igroup = 0; (igroup < groups) && (in + 16 <= end); ++igroup) {
+		uint8_t code = control[igroup];
+		uint8x16_t raw = vld1q_u8(in);
+		uint32x4_t value = vreinterpretq_u32_u8(vqtbl1q_u8(raw, vld1q_u8(_vbyte_shuffle[code])));
+		if (delta) {
+			value = vaddq_u32(value, vextq_u32(zero, value, 3));
+			value = vaddq_u32(value, vextq_u32(zero, value, 2));
+			value = vaddq_u32(value, previous);
+			previous = vdupq_laneq_u32(value, 3);
+		}
+		vst1q_u32(values + (igroup * 4), value);
+		in += _vbyte_length[code];
+	}
+	*data = in;
+	return igroup;
+}
+
+#endif
+
+size_t
+vbyte_decode(const void* buffer, size_t size, uint32_t* values, size_t count, bool delta) {
+	const uint8_t* control = buffer;
+	size_t control_size = (count + 3) / 4;
+	const uint8_t* data = control + control_size;
+	const uint8_t* end = pointer_offset_const(buffer, size);
+	size_t data_size = 0;
+	size_t done = 0;
+	size_t ival;
+
+	if (control_size > size)
+		return 0;
+
+	//Validate total data size before touching any data
+	for (ival = 0; ival < count / 4; ++ival)
+		data_size += _vbyte_length[control[ival]];
+	for (ival = (count / 4) * 4; ival < count; ++ival)
+		data_size += ((control[ival / 4] >> ((ival % 4) * 2)) & 3) + 1;
+	if (data_size > size - control_size)
+		return 0;
+
+#if VBYTE_SSSE3
+	if (_vbyte_simd)
+		done = _vbyte_decode_ssse3(control, &data, end, values, count / 4, delta) * 4;
+#elif VBYTE_NEON
+	done = _vbyte_decode_neon(control, &data, end, values, count / 4, delta) * 4;
+#else
+	FOUNDATION_UNUSED(end);
+#endif
+	data = _vbyte_decode_scalar(control, data, values, done, count, delta,
+	                            (delta && done) ? values[done - 1] : 0);
+
+	return (size_t)pointer_diff(data, buffer);
+}
+
+int
+_varint_initialize(void) {
+	unsigned int code, ival, ibyte;
+	for (code = 0; code < 256; ++code) {
+		uint8_t offset = 0;
+		for (ival = 0; ival < 4; ++ival) {
+			unsigned int length = ((code >> (ival * 2)) & 3) + 1;
+			for (ibyte = 0; ibyte < 4; ++ibyte)
+				_vbyte_shuffle[code][(ival * 4) + ibyte] = (ibyte < length) ? offset++ : 0x80;
+		}
+		_vbyte_length[code] = offset;
+	}
+#if VBYTE_SSSE3
+	_vbyte_simd = _vbyte_ssse3_supported();
+#elif VBYTE_NEON
+	_vbyte_simd = true;
+#endif
+	return 0;
+}
+
+void
+_varint_finalize(void) {
+}
@@ -0,0 +1,101 @@
+/* varint.h  -  Foundation library  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#pragma once
+
+/*! \file varint.h
+\brief Variable length integer coding
+
+Variable length integer coding storing small values in few bytes. Single values are coded as
+LEB128 varints, seven bits per byte with the high bit set on all bytes but the last. Signed
+values are zigzag coded before varint coding, mapping values of small magnitude to small
+unsigned values (0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ...).
+
+Arrays of 32-bit values can be coded in the Stream VByte format, where a block of two bit
+length codes (one control byte for every four values) is followed by the value bytes. The
+format is decoded with a single byte shuffle per four values on processors with SSSE3 or
+NEON. Arrays can optionally be delta coded, storing the difference to the previous value,
+which makes sorted arrays of ids or timestamps code into mostly single byte values.
+
+Stream and bit buffer helpers are available as #stream_write_varint, #stream_write_vbyte and
+#bitbuffer_write_varint and corresponding read functions. */
+
+#include <foundation/platform.h>
+#include <foundation/types.h>
+
+/*! Maximum number of bytes of a varint coded 64-bit value */
+#define VARINT_MAX_SIZE 10
+
+/*! Zigzag code a signed value, mapping values of small magnitude to small unsigned values
+\param value Signed value
+\return Zigzag coded value */
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+varint_zigzag(int64_t value);
+
+/*! Decode a zigzag coded value
+\param value Zigzag coded value
+\return Signed value */
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL int64_t
+varint_unzigzag(uint64_t value);
+
+/*! Encode a value as a varint
+\param value Value
+\param buffer Destination buffer, must have room for #VARINT_MAX_SIZE bytes
+\return Number of bytes stored */
+FOUNDATION_API size_t
+varint_encode(uint64_t value, void* buffer);
+
+/*! Decode a varint
+\param buffer Source buffer
+\param size Size of source buffer
+\param value Receives decoded value
+\return Number of bytes consumed, 0 if the buffer does not hold a complete valid varint */
+FOUNDATION_API size_t
+varint_decode(const void* buffer, size_t size, uint64_t* value);
+
+/*! Get the maximum number of bytes required to Stream VByte code an array
+\param count Number of values
+\return Maximum coded size in bytes */
+FOUNDATION_API size_t
+vbyte_bound(size_t count);
+
+/*! Encode an array of 32-bit values in the Stream VByte format
+\param values Values
+\param count Number of values
+\param delta Code the difference to the previous value (starting from zero) instead of the
+             value itself, for sorted arrays
+\param buffer Destination buffer, must have room for #vbyte_bound bytes
+\return Number of bytes stored */
+FOUNDATION_API size_t
+vbyte_encode(const uint32_t* values, size_t count, bool delta, void* buffer);
+
+/*! Decode an array of 32-bit values in the Stream VByte format
+\param buffer Source buffer
+\param size Size of source buffer
+\param values Destination array receiving the values
+\param count Number of values to decode, must match the number of values encoded
+\param delta Values were delta coded
+\return Number of bytes consumed, 0 if the buffer is too small to hold the values */
+FOUNDATION_API size_t
+vbyte_decode(const void* buffer, size_t size, uint32_t* values, size_t count, bool delta);
+
+// Implementation
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+varint_zigzag(int64_t value) {
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL int64_t
+varint_unzigzag(uint64_t value) {
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
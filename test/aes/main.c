@@ -0,0 +1,210 @@
+/* main.c  -  Foundation aes test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_aes_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation aes tests"));
+	app.short_name = string_const(STRING_CONST("test_aes"));
+	app.config_dir = string_const(STRING_CONST("test_aes"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_aes_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_aes_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_aes_initialize(void) {
+	return 0;
+}
+
+static void
+test_aes_finalize(void) {
+}
+
+
+static void
+test_aes_hex(const char* hex, uint8_t* data) {
+	size_t i, length = string_length(hex) / 2;
+	for (i = 0; i < length; ++i)
+		data[i] = (uint8_t)string_to_uint(hex + (i * 2), 2, true);
+}
+
+DECLARE_TEST(aes, known_data) {
+	aes_t* aes;
+	uint8_t key[32];
+	uint8_t data[32];
+	uint8_t expect[32];
+	uint8_t plaintext[32];
+	uint128_t vec;
+	size_t i;
+	const char* cipher_keys[3] = {
+		"000102030405060708090a0b0c0d0e0f",
+		"000102030405060708090a0b0c0d0e0f1011121314151617",
+		"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	};
+	const char* cipher_text[3] = {
+		"69c4e0d86a7b0430d8cdb78070b4c55a",
+		"dda97ca4864cdfe06eaf70a0ec0d7191",
+		"8ea2b7ca516745bfeafc49904b496089"
+	};
+	const blockcipher_mode_t modes[4] = {
+		BLOCKCIPHER_CBC, BLOCKCIPHER_CFB, BLOCKCIPHER_OFB, BLOCKCIPHER_CTR
+	};
+	const char* mode_text[4] = {
+		"7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2",
+		"3b3fd92eb72dad20333449f8e83cfb4ac8a64537a0b3a93fcde3cdad9f1ce58b",
+		"3b3fd92eb72dad20333449f8e83cfb4a7789508d16918f03f53c52dac54ed825",
+		"874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+	};
+
+	aes = aes_allocate();
+
+	//FIPS-197 appendix C
+	for (i = 0; i < 3; ++i) {
+		test_aes_hex(cipher_keys[i], key);
+		test_aes_hex("00112233445566778899aabbccddeeff", plaintext);
+		test_aes_hex(cipher_text[i], expect);
+		memcpy(data, plaintext, 16);
+		aes_initialize(aes, key, 16 + (i * 8));
+		EXPECT_EQ(aes->rounds, 10 + (i * 2));
+		aes_encrypt(aes, data, 16, BLOCKCIPHER_ECB, uint128_null());
+		EXPECT_EQ(memcmp(data, expect, 16), 0);
+		aes_decrypt(aes, data, 16, BLOCKCIPHER_ECB, uint128_null());
+		EXPECT_EQ(memcmp(data, plaintext, 16), 0);
+	}
+
+	//NIST SP 800-38A AES-128 vectors
+	test_aes_hex("2b7e151628aed2a6abf7158809cf4f3c", key);
+	test_aes_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51", plaintext);
+	aes_initialize(aes, key, 16);
+	for (i = 0; i < 4; ++i) {
+		if (modes[i] == BLOCKCIPHER_CTR)
+			vec = uint128_make(0xf8f9fafbfcfdfeffULL, 0xf0f1f2f3f4f5f6f7ULL);
+		else
+			vec = uint128_make(0x08090a0b0c0d0e0fULL, 0x0001020304050607ULL);
+		test_aes_hex(mode_text[i], expect);
+		memcpy(data, plaintext, 32);
+		aes_encrypt(aes, data, 32, modes[i], vec);
+		EXPECT_EQ(memcmp(data, expect, 32), 0);
+		aes_decrypt(aes, data, 32, modes[i], vec);
+		EXPECT_EQ(memcmp(data, plaintext, 32), 0);
+	}
+
+	aes_deallocate(aes);
+
+	return 0;
+}
+
+DECLARE_TEST(aes, random_data) {
+	uint8_t plaintext[2][4096];
+	uint8_t single[16];
+	uint64_t keytext[4];
+	unsigned int i, j, imode;
+	aes_t aes;
+	uint128_t init_vector;
+	const blockcipher_mode_t modes[5] = {
+		BLOCKCIPHER_ECB, BLOCKCIPHER_CBC, BLOCKCIPHER_CFB, BLOCKCIPHER_OFB, BLOCKCIPHER_CTR
+	};
+
+	for (i = 0; i < 128; ++i) {
+		for (j = 0; j < 4; ++j)
+			keytext[j] = random64();
+		for (j = 0; j < sizeof(plaintext[0]); ++j)
+			plaintext[0][j] = plaintext[1][j] = (uint8_t)random32_range(0, 256);
+
+		//Low half limited to not carry when offsetting the counter below
+		init_vector = uint128_make(random64() >> 1, random64());
+		aes_initialize(&aes, keytext, 16 + ((i % 3) * 8));
+
+		for (imode = 0; imode < 5; ++imode) {
+			aes_encrypt(&aes, plaintext[0], sizeof(plaintext[0]), modes[imode], init_vector);
+			EXPECT_NE(memcmp(plaintext[0], plaintext[1], 16), 0);
+			aes_decrypt(&aes, plaintext[0], sizeof(plaintext[0]), modes[imode], init_vector);
+			EXPECT_EQ(memcmp(plaintext[0], plaintext[1], sizeof(plaintext[0])), 0);
+		}
+
+		//Counter mode with a partial final block, decrypted in two independent parts
+		aes_encrypt(&aes, plaintext[0], sizeof(plaintext[0]) - 3, BLOCKCIPHER_CTR, init_vector);
+		EXPECT_EQ(memcmp(plaintext[0] + sizeof(plaintext[0]) - 3,
+		                 plaintext[1] + sizeof(plaintext[0]) - 3, 3), 0);
+		aes_decrypt(&aes, plaintext[0] + (37 * 16), sizeof(plaintext[0]) - (37 * 16) - 3,
+		            BLOCKCIPHER_CTR, uint128_make(init_vector.word[0] + 37, init_vector.word[1]));
+		aes_decrypt(&aes, plaintext[0], 37 * 16, BLOCKCIPHER_CTR, init_vector);
+		EXPECT_EQ(memcmp(plaintext[0], plaintext[1], sizeof(plaintext[0])), 0);
+	}
+
+	//Counter carries into the high 64 bits
+	init_vector = uint128_make(0xFFFFFFFFFFFFFFFFULL, 41);
+	aes_initialize(&aes, keytext, 32);
+	memcpy(single, plaintext[1] + 16, 16);
+	aes_encrypt(&aes, plaintext[0], 32, BLOCKCIPHER_CTR, init_vector);
+	aes_encrypt(&aes, single, 16, BLOCKCIPHER_CTR, uint128_make(0, 42));
+	EXPECT_EQ(memcmp(plaintext[0] + 16, single, 16), 0);
+
+	aes_finalize(&aes);
+
+	return 0;
+}
+
+static void
+test_aes_declare(void) {
+	ADD_TEST(aes, known_data);
+	ADD_TEST(aes, random_data);
+}
+
+static test_suite_t test_aes_suite = {
+	test_aes_application,
+	test_aes_memory_system,
+	test_aes_config,
+	test_aes_declare,
+	test_aes_initialize,
+	test_aes_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_aes_run(void);
+
+int
+test_aes_run(void) {
+	test_suite = test_aes_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_aes_suite;
+}
+
+#endif
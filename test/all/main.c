@@ -173,6 +173,8 @@ main_initialize(void) {
 			while (true)
 				thread_sleep(100);
 		}
+		if (string_array_find(cmdline, array_size(cmdline), STRING_CONST("processpool worker")) >= 0)
+			process_exit(test_processpool_worker());
 	}
 #endif
 	return ret;
@@ -183,6 +185,7 @@ main_initialize(void) {
 #endif
 
 #if BUILD_MONOLITHIC
+extern int test_aes_run(void);
 extern int test_app_run(void);
 extern int test_array_run(void);
 extern int test_atomic_run(void);
@@ -191,35 +194,53 @@ extern int test_beacon_run(void);
 extern int test_bitbuffer_run(void);
 extern int test_blowfish_run(void);
 extern int test_bufferstream_run(void);
+extern int test_checksum_run(void);
+extern int test_cipherstream_run(void);
+extern int test_compressstream_run(void);
 extern int test_config_run(void);
 extern int test_crash_run(void);
 extern int test_environment_run(void);
 extern int test_error_run(void);
 extern int test_event_run(void);
+extern int test_fiber_run(void);
 extern int test_fs_run(void);
 extern int test_hash_run(void);
 extern int test_hashmap_run(void);
 extern int test_hashtable_run(void);
+extern int test_intern_run(void);
 extern int test_library_run(void);
+extern int test_lock_run(void);
+extern int test_lockfree_run(void);
 extern int test_math_run(void);
 extern int test_md5_run(void);
 extern int test_mutex_run(void);
 extern int test_objectmap_run(void);
+extern int test_pack_run(void);
 extern int test_path_run(void);
 extern int test_pipe_run(void);
 extern int test_process_run(void);
+extern int test_processpool_run(void);
+extern int test_processpool_worker(void);
 extern int test_profile_run(void);
+extern int test_queue_run(void);
 extern int test_radixsort_run(void);
 extern int test_random_run(void);
 extern int test_regex_run(void);
 extern int test_ringbuffer_run(void);
+extern int test_runloop_run(void);
 extern int test_semaphore_run(void);
+extern int test_sha256_run(void);
+extern int test_socketstream_run(void);
+extern int test_soamap_run(void);
 extern int test_stacktrace_run(void);
 extern int test_stream_run(void);
 extern int test_string_run(void);
 extern int test_system_run(void);
+extern int test_task_run(void);
 extern int test_time_run(void);
+extern int test_timer_run(void);
 extern int test_uuid_run(void);
+extern int test_varint_run(void);
 typedef int (*test_run_fn)(void);
 
 static void*
@@ -297,6 +318,7 @@ main_run(void* main_arg) {
 #if BUILD_MONOLITHIC
 
 	test_run_fn tests[] = {
+		test_aes_run,
 		test_app_run,
 		test_array_run,
 		test_atomic_run,
@@ -305,35 +327,52 @@ main_run(void* main_arg) {
 		test_bitbuffer_run,
 		test_blowfish_run,
 		test_bufferstream_run,
+		test_checksum_run,
+		test_cipherstream_run,
+		test_compressstream_run,
 		test_config_run,
 		test_crash_run,
 		test_environment_run,
 		test_error_run,
 		test_event_run,
+		test_fiber_run,
 		test_fs_run,
 		test_hash_run,
 		test_hashmap_run,
 		test_hashtable_run,
+		test_intern_run,
 		test_library_run,
+		test_lock_run,
+		test_lockfree_run,
 		test_math_run,
 		test_md5_run,
 		test_mutex_run,
 		test_objectmap_run,
+		test_pack_run,
 		test_path_run,
 		test_pipe_run,
 		test_process_run,
+		test_processpool_run,
 		test_profile_run,
+		test_queue_run,
 		test_radixsort_run,
 		test_random_run,
 		test_regex_run,
 		test_ringbuffer_run,
+		test_runloop_run,
 		test_semaphore_run,
+		test_sha256_run,
+		test_socketstream_run,
+		test_soamap_run,
 		test_stacktrace_run,
 		test_stream_run, //stream test closes stdin
 		test_string_run,
 		test_system_run,
+		test_task_run,
 		test_time_run,
+		test_timer_run,
 		test_uuid_run,
+		test_varint_run,
 		0
 	};
 
@@ -36,6 +36,8 @@ test_app_config(void) {
 	foundation_config_t config;
 	memset(&config, 0, sizeof(config));
 	config.temporary_memory = 128 * 1024;
+	config.memory_map_threshold = 1024 * 1024;
+	config.memory_guard_sample_rate = 4;
 	return config;
 }
 
@@ -127,6 +129,671 @@ DECLARE_TEST(app, memory) {
 	return 0;
 }
 
+static atomic32_t _memory_wrap_ready;
+static atomic32_t _memory_wrap_done;
+
+static FOUNDATION_NOINLINE void*
+memory_wrap_thread(void* arg) {
+	void** block = arg;
+
+	//Cut a thread arena from the ring, then allocate from it again after the ring wrapped
+	block[0] = memory_allocate(0, 64, 16, MEMORY_TEMPORARY);
+	memset(block[0], 0x5a, 64);
+	atomic_incr32(&_memory_wrap_ready);
+	while (!atomic_load32(&_memory_wrap_done))
+		thread_yield();
+	block[1] = memory_allocate(0, 64, 16, MEMORY_TEMPORARY);
+	memset(block[1], 0x5a, 64);
+
+	return 0;
+}
+
+DECLARE_TEST(app, memory_temporary_wrap) {
+	void* block[4][2];
+	thread_t thread[4];
+	size_t ith;
+	uintptr_t start, end, last, highest;
+	uintptr_t mem;
+
+	atomic_store32(&_memory_wrap_ready, 0);
+	atomic_store32(&_memory_wrap_done, 0);
+
+	//Chunks larger than half a thread arena are bumped directly from the shared ring, allocate
+	//until the ring wraps so the thread arenas are cut right after the start of the ring
+	last = (uintptr_t)memory_allocate(0, 8176, 16, MEMORY_TEMPORARY);
+	while ((mem = (uintptr_t)memory_allocate(0, 8176, 16, MEMORY_TEMPORARY)) > last)
+		last = mem;
+	start = mem;
+
+	for (ith = 0; ith < 4; ++ith) {
+		thread_initialize(&thread[ith], memory_wrap_thread, block[ith], STRING_CONST("memory_wrap"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+		thread_start(&thread[ith]);
+	}
+	test_wait_for_threads_startup(thread, 4);
+	while (atomic_load32(&_memory_wrap_ready) < 4)
+		thread_yield();
+
+	highest = 0;
+	for (ith = 0; ith < 4; ++ith) {
+		if ((uintptr_t)block[ith][0] > highest)
+			highest = (uintptr_t)block[ith][0];
+	}
+
+	//Wrap the ring and hand out the next lap up past the blocks in the thread arenas
+	last = start;
+	while ((mem = (uintptr_t)memory_allocate(0, 8176, 16, MEMORY_TEMPORARY)) > last)
+		last = mem;
+	EXPECT_EQ(mem, start);
+	end = mem + 8192;
+	while (end <= highest + 64) {
+		mem = (uintptr_t)memory_allocate(0, 8176, 16, MEMORY_TEMPORARY);
+		end = mem + 8192;
+	}
+
+	atomic_store32(&_memory_wrap_done, 1);
+	test_wait_for_threads_finish(thread, 4);
+
+	//Arenas cut before the wrap must be dropped, not handed out again over the new lap
+	for (ith = 0; ith < 4; ++ith) {
+		EXPECT_EQ(thread[ith].result, 0);
+		EXPECT_TRUE(((uintptr_t)block[ith][1] < start) || ((uintptr_t)block[ith][1] >= end));
+		thread_finalize(&thread[ith]);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(app, memory_tracker) {
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	void* blocks[4096];
+	size_t iblock, iloop;
+	memory_statistics_t oldstats, newstats;
+
+	memory_set_tracker(memory_tracker_local());
+
+	oldstats = memory_statistics();
+	for (iloop = 0; iloop < 4; ++iloop) {
+		for (iblock = 0; iblock < 4096; ++iblock)
+			blocks[iblock] = memory_allocate(0, 16 + iblock, 0, MEMORY_PERSISTENT);
+
+		newstats = memory_statistics();
+		EXPECT_SIZEGE(newstats.allocations_current, oldstats.allocations_current + 4096);
+		EXPECT_SIZEGE(newstats.allocations_total, oldstats.allocations_total + 4096 * (iloop + 1));
+
+		for (iblock = 0; iblock < 4096; iblock += 2)
+			memory_deallocate(blocks[iblock]);
+		for (iblock = 1; iblock < 4096; iblock += 2)
+			memory_deallocate(blocks[iblock]);
+
+		newstats = memory_statistics();
+		EXPECT_SIZEEQ(newstats.allocations_current, oldstats.allocations_current);
+		EXPECT_SIZEEQ(newstats.allocated_current, oldstats.allocated_current);
+	}
+#endif
+	return 0;
+}
+
+DECLARE_TEST(app, memory_guard_sampled) {
+#if FOUNDATION_SIZE_POINTER > 4
+	void* blocks[256];
+	size_t iblock, ibyte;
+	size_t guarded = 0;
+
+	//Sampled blocks end within the guard value padding of a page boundary
+	for (iblock = 0; iblock < 256; ++iblock) {
+		size_t size = 16 * (iblock + 1);
+		uintptr_t end;
+		blocks[iblock] = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+		memset(blocks[iblock], (int)(iblock & 0xFF), size);
+		end = (uintptr_t)blocks[iblock] + size;
+		if (((4096 - (end & 4095)) & 4095) < 32)
+			++guarded;
+	}
+	EXPECT_SIZEGE(guarded, 16);
+
+	//Blocks keep content when reallocated in and out of guarded placement
+	for (iblock = 0; iblock < 256; iblock += 3) {
+		size_t size = 16 * (iblock + 1);
+		uint8_t* data;
+		blocks[iblock] = memory_reallocate(blocks[iblock], size * 2, 0, size);
+		data = blocks[iblock];
+		for (ibyte = 0; ibyte < size; ++ibyte)
+			EXPECT_UINTEQ(data[ibyte], iblock & 0xFF);
+		memset(data, 0, size * 2);
+	}
+
+	for (iblock = 0; iblock < 256; ++iblock)
+		memory_deallocate(blocks[iblock]);
+#endif
+	return 0;
+}
+
+static void*
+memory_statistics_thread(void* arg) {
+	void** blocks = arg;
+	size_t iblock;
+	//Free half of the blocks allocated by the main thread, allocate replacements
+	for (iblock = 0; iblock < 1024; ++iblock) {
+		memory_deallocate(blocks[iblock]);
+		blocks[iblock] = memory_allocate(0, 32, 0, MEMORY_PERSISTENT);
+	}
+	return 0;
+}
+
+DECLARE_TEST(app, memory_statistics_threaded) {
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	void* blocks[4][2048];
+	thread_t thread[4];
+	size_t ith, iblock;
+	memory_statistics_t oldstats, newstats;
+
+	memory_set_tracker(memory_tracker_local());
+
+	oldstats = memory_statistics();
+	for (ith = 0; ith < 4; ++ith) {
+		for (iblock = 0; iblock < 2048; ++iblock)
+			blocks[ith][iblock] = memory_allocate(0, 64, 0, MEMORY_PERSISTENT);
+		thread_initialize(&thread[ith], memory_statistics_thread, blocks[ith],
+		                  STRING_CONST("memory_statistics"), THREAD_PRIORITY_NORMAL, 0);
+		thread_start(&thread[ith]);
+	}
+
+	test_wait_for_threads_startup(thread, 4);
+	test_wait_for_threads_finish(thread, 4);
+
+	//Counters of exited threads are kept, including deallocations of other threads blocks
+	newstats = memory_statistics();
+	EXPECT_SIZEGE(newstats.allocations_current, oldstats.allocations_current + 4 * 2048);
+	EXPECT_SIZEGE(newstats.allocated_current,
+	              oldstats.allocated_current + 4 * (1024 * 64 + 1024 * 32));
+	EXPECT_SIZEGE(newstats.allocations_total, oldstats.allocations_total + 4 * 3072);
+
+	for (ith = 0; ith < 4; ++ith) {
+		thread_finalize(&thread[ith]);
+		for (iblock = 0; iblock < 2048; ++iblock)
+			memory_deallocate(blocks[ith][iblock]);
+	}
+
+	newstats = memory_statistics();
+	EXPECT_SIZEEQ(newstats.allocations_current, oldstats.allocations_current);
+	EXPECT_SIZEEQ(newstats.allocated_current, oldstats.allocated_current);
+#endif
+	return 0;
+}
+
+DECLARE_TEST(app, memory_tracker_sampled) {
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	void** blocks;
+	size_t iblock;
+	size_t num_blocks = 64 * 1024;
+	size_t block_size = 1024;
+	memory_statistics_t oldstats, newstats;
+
+	blocks = memory_allocate(0, sizeof(void*) * num_blocks, 0, MEMORY_PERSISTENT);
+
+	memory_set_tracker(memory_tracker_sampled());
+
+	oldstats = memory_statistics();
+	for (iblock = 0; iblock < num_blocks; ++iblock)
+		blocks[iblock] = memory_allocate(0, block_size, 0, MEMORY_PERSISTENT);
+
+	//Estimate should be well within 40% of the actual size with 64MiB sampled at 512KiB
+	newstats = memory_statistics();
+	EXPECT_SIZEGE(newstats.allocated_current - oldstats.allocated_current,
+	              (num_blocks * block_size * 6) / 10);
+	EXPECT_SIZELE(newstats.allocated_current - oldstats.allocated_current,
+	              (num_blocks * block_size * 14) / 10);
+	EXPECT_SIZEGE(newstats.allocations_current - oldstats.allocations_current,
+	              (num_blocks * 6) / 10);
+	EXPECT_SIZELE(newstats.allocations_current - oldstats.allocations_current,
+	              (num_blocks * 14) / 10);
+
+	for (iblock = 0; iblock < num_blocks; ++iblock)
+		memory_deallocate(blocks[iblock]);
+
+	newstats = memory_statistics();
+	EXPECT_SIZEEQ(newstats.allocations_current, oldstats.allocations_current);
+	EXPECT_SIZEEQ(newstats.allocated_current, oldstats.allocated_current);
+
+	memory_set_tracker(memory_tracker_local());
+	memory_deallocate(blocks);
+#endif
+	return 0;
+}
+
+#if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+
+static bool
+memory_context_statistics_find(hash_t context, memory_statistics_t* stats) {
+	memory_context_statistics_t context_stats[256];
+	size_t icontext, count;
+	count = memory_context_statistics(context_stats, sizeof(context_stats) / sizeof(context_stats[0]));
+	for (icontext = 0; icontext < count; ++icontext) {
+		if (context_stats[icontext].context == context) {
+			*stats = context_stats[icontext].statistics;
+			return true;
+		}
+	}
+	memset(stats, 0, sizeof(memory_statistics_t));
+	return false;
+}
+
+static void*
+memory_context_statistics_thread(void* arg) {
+	void** blocks = arg;
+	size_t iblock;
+	memory_context_push(HASH_STREAM);
+	for (iblock = 0; iblock < 64; ++iblock)
+		blocks[iblock] = memory_allocate(0, 100, 0, MEMORY_PERSISTENT);
+	memory_context_pop();
+	return 0;
+}
+
+#endif
+
+DECLARE_TEST(app, memory_context_statistics) {
+#if BUILD_ENABLE_MEMORY_CONTEXT_STATISTICS
+	void* blocks[64];
+	void* other[64];
+	size_t iblock;
+	thread_t thread;
+	memory_statistics_t before, after;
+
+	memory_context_statistics_find(HASH_TEST, &before);
+
+	memory_context_push(HASH_TEST);
+	for (iblock = 0; iblock < 64; ++iblock)
+		blocks[iblock] = memory_allocate(0, 16 + iblock, 0, MEMORY_PERSISTENT);
+	memory_context_pop();
+
+	EXPECT_TRUE(memory_context_statistics_find(HASH_TEST, &after));
+	EXPECT_SIZEEQ(after.allocations_current, before.allocations_current + 64);
+	EXPECT_SIZEEQ(after.allocations_total, before.allocations_total + 64);
+	EXPECT_SIZEEQ(after.allocated_current, before.allocated_current + (64 * 16) + (63 * 64) / 2);
+
+	for (iblock = 0; iblock < 64; ++iblock)
+		blocks[iblock] = memory_reallocate(blocks[iblock], 1000, 0, 16 + iblock);
+
+	EXPECT_TRUE(memory_context_statistics_find(HASH_TEST, &after));
+	EXPECT_SIZEEQ(after.allocations_current, before.allocations_current + 64);
+	EXPECT_SIZEEQ(after.allocated_current, before.allocated_current + (64 * 1000));
+
+	//Statistics from other threads are merged on thread exit
+	memory_context_statistics_find(HASH_STREAM, &before);
+	thread_initialize(&thread, memory_context_statistics_thread, other,
+	                  STRING_CONST("context_statistics"), THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	test_wait_for_threads_startup(&thread, 1);
+	test_wait_for_threads_finish(&thread, 1);
+	thread_finalize(&thread);
+
+	EXPECT_TRUE(memory_context_statistics_find(HASH_STREAM, &after));
+	EXPECT_SIZEEQ(after.allocations_current, before.allocations_current + 64);
+	EXPECT_SIZEEQ(after.allocated_current, before.allocated_current + (64 * 100));
+
+	for (iblock = 0; iblock < 64; ++iblock) {
+		memory_deallocate(blocks[iblock]);
+		memory_deallocate(other[iblock]);
+	}
+
+	EXPECT_TRUE(memory_context_statistics_find(HASH_STREAM, &after));
+	EXPECT_SIZEEQ(after.allocations_current, before.allocations_current);
+	EXPECT_SIZEEQ(after.allocated_current, before.allocated_current);
+#endif
+	return 0;
+}
+
+DECLARE_TEST(app, memory_histogram) {
+	memory_histogram_t before, after;
+	void* blocks[16];
+	size_t iblock;
+	stream_t* stream;
+
+	memory_histogram(&before);
+	for (iblock = 0; iblock < 16; ++iblock)
+		blocks[iblock] = memory_allocate(0, 4000 + iblock, 64, MEMORY_PERSISTENT);
+	for (iblock = 0; iblock < 16; ++iblock)
+		memory_deallocate(blocks[iblock]);
+	memory_histogram(&after);
+
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	EXPECT_SIZEEQ(after.size[12], before.size[12] + 16);
+	EXPECT_SIZEEQ(after.align[6], before.align[6] + 16);
+	EXPECT_SIZEGE(after.short_lived, before.short_lived + 16);
+	EXPECT_SIZEGE(after.short_lived_persistent, before.short_lived_persistent + 16);
+#else
+	EXPECT_SIZEEQ(after.size[12], 0);
+	EXPECT_SIZEEQ(after.short_lived, 0);
+#endif
+
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+	memory_histogram_dump(stream);
+#if BUILD_ENABLE_MEMORY_HISTOGRAM
+	EXPECT_SIZEGT(stream_size(stream), 0);
+#endif
+	stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(app, memory_mapped) {
+	size_t size = 4 * 1024 * 1024;
+	unsigned char* block;
+	size_t ibyte, iloop;
+
+	block = memory_allocate(0, size, 16, MEMORY_PERSISTENT | MEMORY_HUGE_PAGES | MEMORY_ZERO_INITIALIZED);
+	EXPECT_NE(block, 0);
+	EXPECT_EQ((uintptr_t)block & 15, 0);
+	for (ibyte = 0; ibyte < size; ibyte += 4096)
+		EXPECT_EQ(block[ibyte], 0);
+	memset(block, 0x5a, size);
+	memory_deallocate(block);
+
+	//Above threshold set in config, mapped without huge page flag
+	block = memory_allocate(0, size / 2, 0, MEMORY_PERSISTENT);
+	EXPECT_NE(block, 0);
+	memset(block, 0x5a, size / 2);
+	block = memory_reallocate(block, size, 0, size / 2);
+	EXPECT_NE(block, 0);
+	EXPECT_EQ(block[size / 2 - 1], 0x5a);
+	block = memory_reallocate(block, 1024, 0, size);
+	EXPECT_NE(block, 0);
+	EXPECT_EQ(block[1023], 0x5a);
+	memory_deallocate(block);
+
+	//Node placement, falls back to default placement on systems without NUMA
+	block = memory_allocate(0, size, 0, MEMORY_PERSISTENT | MEMORY_NODE_LOCAL);
+	EXPECT_NE(block, 0);
+	memset(block, 0x5a, size);
+	memory_deallocate(block);
+	block = memory_allocate(0, size, 0, MEMORY_PERSISTENT | MEMORY_NODE(system_hardware_nodes() - 1));
+	EXPECT_NE(block, 0);
+	memset(block, 0x5a, size);
+	memory_deallocate(block);
+	block = memory_allocate(0, 64, 0, MEMORY_PERSISTENT | MEMORY_NODE_LOCAL);
+	EXPECT_NE(block, 0);
+	memset(block, 0x5a, 64);
+	block = memory_reallocate(block, 256, 0, 64);
+	EXPECT_NE(block, 0);
+	EXPECT_EQ(block[63], 0x5a);
+	memory_deallocate(block);
+
+	//Repeated growth of mapped blocks preserves contents
+	block = memory_allocate(0, size / 4, 0, MEMORY_PERSISTENT);
+	EXPECT_NE(block, 0);
+	for (iloop = 0; iloop < 16; ++iloop) {
+		memset(block + (size * iloop) / 4, (int)iloop, size / 4);
+		block = memory_reallocate(block, (size * (iloop + 2)) / 4, 0, (size * (iloop + 1)) / 4);
+		EXPECT_NE(block, 0);
+	}
+	for (iloop = 0; iloop < 16; ++iloop) {
+		EXPECT_EQ(block[(size * iloop) / 4], (unsigned char)iloop);
+		EXPECT_EQ(block[(size * (iloop + 1)) / 4 - 1], (unsigned char)iloop);
+	}
+	memory_deallocate(block);
+
+	return 0;
+}
+
+static memory_system_t _thread_cache;
+
+static FOUNDATION_NOINLINE void*
+memory_thread_cache_thread(void* arg) {
+	void** blocks = arg;
+	size_t iloop, iblock;
+	size_t size;
+
+	for (iloop = 0; iloop < 64; ++iloop) {
+		for (iblock = 0; iblock < 256; ++iblock) {
+			size = 1 + ((iblock * 37 + iloop * 13) % (iloop & 1 ? 20000 : 600));
+			if (blocks[iblock]) {
+				EXPECT_EQ(*(unsigned char*)blocks[iblock], (unsigned char)iblock);
+				_thread_cache.deallocate(blocks[iblock]);
+			}
+			blocks[iblock] = _thread_cache.allocate(0, size, 16, MEMORY_PERSISTENT);
+			EXPECT_NE(blocks[iblock], 0);
+			EXPECT_EQ((uintptr_t)blocks[iblock] & (FOUNDATION_PLATFORM_ANDROID ? 7 : 15), 0);
+			memset(blocks[iblock], (int)iblock, size);
+		}
+		thread_yield();
+	}
+
+	_thread_cache.thread_finalize();
+	return 0;
+}
+
+DECLARE_TEST(app, memory_thread_cache) {
+	thread_t thread[8];
+	void* blocks[8][256];
+	size_t ith, iblock;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 2, 8);
+	void* p;
+
+	_thread_cache = memory_system_thread_cache();
+	EXPECT_INTEQ(_thread_cache.initialize(), 0);
+
+	p = _thread_cache.allocate(0, 40, 0, MEMORY_ZERO_INITIALIZED);
+	EXPECT_NE(p, 0);
+	EXPECT_EQ(*(uint64_t*)p, 0);
+	memset(p, 0xAB, 40);
+	p = _thread_cache.reallocate(p, 48, 0, 40);
+	EXPECT_EQ(*((unsigned char*)p + 39), 0xAB);
+	p = _thread_cache.reallocate(p, 128 * 1024, 0, 48);
+	EXPECT_EQ(*((unsigned char*)p + 39), 0xAB);
+	p = _thread_cache.reallocate(p, 256 * 1024, 0, 128 * 1024);
+	EXPECT_EQ(*((unsigned char*)p + 39), 0xAB);
+	_thread_cache.deallocate(p);
+
+	//Partial batches released on thread finalize must keep their real block count
+	for (iblock = 0; iblock < 3; ++iblock)
+		blocks[0][iblock] = _thread_cache.allocate(0, 40, 0, 0);
+	_thread_cache.thread_finalize();
+	for (iblock = 0; iblock < 3; ++iblock)
+		_thread_cache.deallocate(blocks[0][iblock]);
+	_thread_cache.thread_finalize();
+	p = _thread_cache.allocate(0, 40, 0, 0);
+	EXPECT_NE(p, 0);
+	_thread_cache.thread_finalize();
+	_thread_cache.deallocate(p);
+	_thread_cache.thread_finalize();
+
+	memset(blocks, 0, sizeof(blocks));
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], memory_thread_cache_thread, blocks[ith],
+		                  STRING_CONST("memory_thread"), THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith) {
+		EXPECT_EQ(thread[ith].result, 0);
+		thread_finalize(&thread[ith]);
+	}
+
+	//Free blocks from other thread than the allocating one
+	for (ith = 0; ith < num_threads; ++ith) {
+		for (iblock = 0; iblock < 256; ++iblock) {
+			EXPECT_EQ(*(unsigned char*)blocks[ith][iblock], (unsigned char)iblock);
+			_thread_cache.deallocate(blocks[ith][iblock]);
+		}
+	}
+
+	_thread_cache.thread_finalize();
+	_thread_cache.finalize();
+
+	return 0;
+}
+
+DECLARE_TEST(app, memory_arena) {
+	memory_arena_t* arena;
+	memory_arena_t inner;
+	void* first;
+	void* block;
+	int* intarr = 0;
+	string_t str;
+	hashmap_t* map;
+	int iloop;
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	memory_statistics_t oldstats, newstats;
+#endif
+
+	arena = memory_arena_allocate(HASH_TEST, 1024);
+	EXPECT_NE(arena, 0);
+
+	first = memory_arena_allocate_block(arena, 13, 0);
+	EXPECT_NE(first, 0);
+	block = memory_arena_allocate_block(arena, 16, 16);
+	EXPECT_EQ((uintptr_t)block & 15, 0);
+	EXPECT_GE(block, pointer_offset(first, 13));
+	block = memory_arena_allocate_block(arena, 4096, 16);
+	EXPECT_NE(block, 0);
+	memset(block, 0, 4096);
+
+	memory_arena_reset(arena);
+	EXPECT_EQ(memory_arena_allocate_block(arena, 13, 0), first);
+	memory_arena_reset(arena);
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	//Make sure the thread memory context stack is allocated before measuring
+	memory_context_push(HASH_TEST);
+	memory_context_pop();
+	oldstats = memory_statistics();
+#endif
+
+	memory_arena_push(arena);
+#if BUILD_ENABLE_MEMORY_CONTEXT
+	EXPECT_EQ(memory_context(), HASH_TEST);
+#endif
+
+	EXPECT_EQ(memory_allocate(0, 13, 0, MEMORY_PERSISTENT), first);
+	for (iloop = 0; iloop < 1024; ++iloop)
+		array_push(intarr, iloop);
+	for (iloop = 0; iloop < 1024; ++iloop)
+		EXPECT_INTEQ(intarr[iloop], iloop);
+	str = string_allocate_format(STRING_CONST("arena %d"), 42);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("arena 42")));
+	map = hashmap_allocate(13, 4);
+	for (iloop = 0; iloop < 256; ++iloop)
+		hashmap_insert(map, (hash_t)iloop + 1, intarr + iloop);
+	EXPECT_EQ(hashmap_lookup(map, 100), intarr + 99);
+
+	memory_arena_initialize(&inner, 0, 0);
+	memory_arena_push(&inner);
+	block = memory_allocate(0, 64, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	EXPECT_EQ(*(uint64_t*)block, 0);
+	EXPECT_EQ(block, pointer_offset(inner.chunk, sizeof(memory_arena_chunk_t)));
+	memory_arena_pop();
+
+	hashmap_deallocate(map);
+	string_deallocate(str.str);
+	array_deallocate(intarr);
+
+	memory_arena_pop();
+#if BUILD_ENABLE_MEMORY_CONTEXT
+	EXPECT_EQ(memory_context(), 0);
+#endif
+
+	memory_arena_finalize(&inner);
+	memory_arena_reset(arena);
+	EXPECT_EQ(memory_arena_allocate_block(arena, 13, 0), first);
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	newstats = memory_statistics();
+	EXPECT_SIZEEQ(oldstats.allocated_current, newstats.allocated_current);
+#endif
+
+	memory_arena_deallocate(arena);
+
+	return 0;
+}
+
+static FOUNDATION_NOINLINE void*
+memory_pool_thread(void* arg) {
+	memory_pool_t* pool = arg;
+	memory_pool_magazine_t magazine;
+	void* blocks[64];
+	size_t iloop, iblock;
+	uint64_t tag = thread_id();
+
+	memory_pool_magazine_initialize(&magazine, pool);
+	for (iloop = 0; iloop < 2048; ++iloop) {
+		bool use_magazine = (iloop & 1);
+		for (iblock = 0; iblock < 64; ++iblock) {
+			blocks[iblock] = use_magazine ? memory_pool_magazine_allocate_block(&magazine) :
+			                 memory_pool_allocate_block(pool);
+			EXPECT_NE(blocks[iblock], 0);
+			EXPECT_EQ((uintptr_t)blocks[iblock] & 15, 0);
+			*(uint64_t*)blocks[iblock] = tag + iblock;
+			*((uint64_t*)blocks[iblock] + 2) = tag + iblock;
+		}
+		for (iblock = 0; iblock < 64; ++iblock) {
+			EXPECT_EQ(*(uint64_t*)blocks[iblock], tag + iblock);
+			EXPECT_EQ(*((uint64_t*)blocks[iblock] + 2), tag + iblock);
+			if (use_magazine)
+				memory_pool_magazine_deallocate_block(&magazine, blocks[iblock]);
+			else
+				memory_pool_deallocate_block(pool, blocks[iblock]);
+		}
+	}
+	memory_pool_magazine_finalize(&magazine);
+
+	return 0;
+}
+
+DECLARE_TEST(app, memory_pool) {
+	thread_t thread[16];
+	size_t ith, iblock;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 2, 16);
+	memory_pool_t* pool;
+	void* blocks[40];
+
+	pool = memory_pool_allocate(HASH_TEST, 24, 16, 16, 4);
+	EXPECT_NE(pool, 0);
+	for (iblock = 0; iblock < 40; ++iblock) {
+		blocks[iblock] = memory_pool_allocate_block(pool);
+		EXPECT_NE(blocks[iblock], 0);
+		EXPECT_EQ((uintptr_t)blocks[iblock] & 15, 0);
+		if (iblock)
+			EXPECT_NE(blocks[iblock], blocks[iblock - 1]);
+	}
+	EXPECT_INTEQ(atomic_load32(&pool->chunk_count), 3);
+	for (iblock = 40; iblock < 64; ++iblock)
+		EXPECT_NE(memory_pool_allocate_block(pool), 0);
+	EXPECT_EQ(memory_pool_allocate_block(pool), 0);
+	memory_pool_deallocate_block(pool, blocks[7]);
+	EXPECT_EQ(memory_pool_allocate_block(pool), blocks[7]);
+	memory_pool_deallocate(pool);
+
+	pool = memory_pool_allocate(HASH_TEST, 24, 16, 0, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], memory_pool_thread, pool, STRING_CONST("pool_thread"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith) {
+		EXPECT_EQ(thread[ith].result, 0);
+		thread_finalize(&thread[ith]);
+	}
+
+	//All blocks returned, so a single thread can reuse all without growth
+	{
+		int32_t chunk_count = atomic_load32(&pool->chunk_count);
+		for (iblock = 0; iblock < (size_t)chunk_count * 256; ++iblock)
+			EXPECT_NE(memory_pool_allocate_block(pool), 0);
+		EXPECT_INTEQ(atomic_load32(&pool->chunk_count), chunk_count);
+	}
+	memory_pool_deallocate(pool);
+
+	return 0;
+}
+
 static void*
 test_thread(void* arg) {
 	semaphore_t* sync = (semaphore_t*)arg;
@@ -229,11 +896,88 @@ DECLARE_TEST(app, thread) {
 	return 0;
 }
 
+static void*
+pool_thread(void* arg) {
+	uint64_t* osid = arg;
+	*osid = thread_id();
+	if (!string_equal(STRING_ARGS(thread_name()), STRING_CONST("pool_thread")) ||
+	        (thread_self()->osid != *osid))
+		return 0;
+	thread_sleep(10);
+	return arg;
+}
+
+DECLARE_TEST(app, thread_pool) {
+	thread_t thread[8];
+	uint64_t osid[8];
+	uint64_t first;
+	size_t ithread;
+
+	thread_enable_pool(4);
+	EXPECT_SIZEEQ(thread_pool_idle(), 0);
+
+	thread_initialize(&thread[0], pool_thread, &osid[0], STRING_CONST("pool_thread"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	EXPECT_TRUE(thread_start(&thread[0]));
+	EXPECT_EQ(thread_join(&thread[0]), &osid[0]);
+	EXPECT_FALSE(thread_is_running(&thread[0]));
+	thread_finalize(&thread[0]);
+	EXPECT_SIZEEQ(thread_pool_idle(), 1);
+	first = osid[0];
+
+	//Next thread runs on the parked OS thread
+	thread_initialize(&thread[0], pool_thread, &osid[0], STRING_CONST("pool_thread"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	EXPECT_TRUE(thread_start(&thread[0]));
+	EXPECT_SIZEEQ(thread_pool_idle(), 0);
+	EXPECT_EQ(thread_join(&thread[0]), &osid[0]);
+	thread_finalize(&thread[0]);
+	EXPECT_UINTEQ(osid[0], first);
+	EXPECT_SIZEEQ(thread_pool_idle(), 1);
+
+	//Concurrent threads need more OS threads, only the maximum number is kept idle
+	for (ithread = 0; ithread < 8; ++ithread) {
+		thread_initialize(&thread[ithread], pool_thread, &osid[ithread], STRING_CONST("pool_thread"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+		EXPECT_TRUE(thread_start(&thread[ithread]));
+	}
+	for (ithread = 0; ithread < 8; ++ithread) {
+		EXPECT_EQ(thread_join(&thread[ithread]), &osid[ithread]);
+		thread_finalize(&thread[ithread]);
+	}
+	EXPECT_SIZEEQ(thread_pool_idle(), 4);
+
+	thread_enable_pool(0);
+	EXPECT_SIZEEQ(thread_pool_idle(), 0);
+
+	//Disabled pool creates a new OS thread
+	thread_initialize(&thread[0], pool_thread, &osid[0], STRING_CONST("pool_thread"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	EXPECT_TRUE(thread_start(&thread[0]));
+	EXPECT_EQ(thread_join(&thread[0]), &osid[0]);
+	thread_finalize(&thread[0]);
+	EXPECT_SIZEEQ(thread_pool_idle(), 0);
+
+	return 0;
+}
+
 static void
 test_app_declare(void) {
 	ADD_TEST(app, environment);
 	ADD_TEST(app, memory);
+	ADD_TEST(app, memory_temporary_wrap);
+	ADD_TEST(app, memory_tracker);
+	ADD_TEST(app, memory_statistics_threaded);
+	ADD_TEST(app, memory_guard_sampled);
+	ADD_TEST(app, memory_tracker_sampled);
+	ADD_TEST(app, memory_context_statistics);
+	ADD_TEST(app, memory_histogram);
+	ADD_TEST(app, memory_mapped);
+	ADD_TEST(app, memory_thread_cache);
+	ADD_TEST(app, memory_arena);
+	ADD_TEST(app, memory_pool);
 	ADD_TEST(app, thread);
+	ADD_TEST(app, thread_pool);
 }
 
 static test_suite_t test_app_suite = {
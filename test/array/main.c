@@ -2003,6 +2003,224 @@ DECLARE_TEST(array, resize) {
 	return 0;
 }
 
+DECLARE_TEST(array, inline) {
+	array_inline_storage(int, 8) storage;
+	array_inline_storage(combine_t, 2) combine_storage;
+	int* intarr = 0;
+	combine_t* combinearr = 0;
+	combine_t combine;
+	int iloop;
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	memory_statistics_t oldstats, newstats;
+#endif
+
+	array_initialize_inline(intarr, storage);
+	EXPECT_EQ((void*)intarr, (void*)storage.elements);
+	EXPECT_EQ(array_capacity(intarr), 8);
+	EXPECT_EQ(array_size(intarr), 0);
+
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	oldstats = memory_statistics();
+#endif
+	for (iloop = 0; iloop < 8; ++iloop)
+		array_push(intarr, iloop);
+	array_erase_ordered(intarr, 0);
+	array_insert(intarr, 0, 0);
+#if BUILD_ENABLE_MEMORY_STATISTICS
+	newstats = memory_statistics();
+	EXPECT_SIZEEQ(newstats.allocations_total, oldstats.allocations_total);
+#endif
+	EXPECT_EQ((void*)intarr, (void*)storage.elements);
+	EXPECT_EQ(array_size(intarr), 8);
+
+	//Spill to heap
+	array_push(intarr, 8);
+	EXPECT_NE((void*)intarr, (void*)storage.elements);
+	EXPECT_EQ(array_size(intarr), 9);
+	EXPECT_GE(array_capacity(intarr), 9);
+	for (iloop = 0; iloop < 9; ++iloop)
+		EXPECT_EQ(intarr[iloop], iloop);
+	array_deallocate(intarr);
+	EXPECT_EQ(intarr, 0);
+
+	//Deallocate without spill
+	array_initialize_inline(intarr, storage);
+	array_push(intarr, 1);
+	array_deallocate(intarr);
+	EXPECT_EQ(intarr, 0);
+
+	array_initialize_inline(intarr, storage);
+	array_resize(intarr, 4);
+	EXPECT_EQ((void*)intarr, (void*)storage.elements);
+	array_reserve(intarr, 32);
+	EXPECT_NE((void*)intarr, (void*)storage.elements);
+	EXPECT_EQ(array_size(intarr), 4);
+	EXPECT_EQ(array_capacity(intarr), 32);
+	array_deallocate(intarr);
+
+	array_initialize_inline(combinearr, combine_storage);
+	memset(&combine, 0, sizeof(combine));
+	for (iloop = 0; iloop < 5; ++iloop) {
+		combine.intval = iloop;
+		array_push_memcpy(combinearr, &combine);
+	}
+	EXPECT_EQ(array_size(combinearr), 5);
+	for (iloop = 0; iloop < 5; ++iloop)
+		EXPECT_EQ(combinearr[iloop].intval, iloop);
+	array_deallocate(combinearr);
+
+	return 0;
+}
+
+DECLARE_TEST(array, allocator) {
+	array_allocator_t allocator;
+	memory_arena_t arena;
+	memory_pool_t pool;
+	int* intarr = 0;
+	int* prev;
+	int iloop;
+
+	array_allocator_initialize(&allocator, HASH_TEST, 4);
+	array_initialize_allocator(intarr, &allocator);
+	EXPECT_NE(intarr, 0);
+	EXPECT_EQ(array_size(intarr), 0);
+	array_push(intarr, 0);
+	array_push(intarr, 1);
+	EXPECT_EQ(array_capacity(intarr), 5);
+	for (iloop = 2; iloop < 1000; ++iloop)
+		array_push(intarr, iloop);
+	for (iloop = 0; iloop < 1000; ++iloop)
+		EXPECT_EQ(intarr[iloop], iloop);
+	array_deallocate(intarr);
+	EXPECT_EQ(intarr, 0);
+
+	memory_arena_initialize(&arena, HASH_TEST, 0);
+	array_allocator_initialize_arena(&allocator, &arena, 0);
+	array_initialize_allocator(intarr, &allocator);
+	array_push(intarr, 0);
+	prev = intarr;
+	for (iloop = 1; iloop < 1000; ++iloop)
+		array_push(intarr, iloop);
+	//Last allocation in arena grows in place
+	EXPECT_EQ(intarr, prev);
+	EXPECT_GE((void*)intarr, (void*)arena.chunk);
+	EXPECT_LT((void*)intarr, arena.end);
+	for (iloop = 0; iloop < 1000; ++iloop)
+		EXPECT_EQ(intarr[iloop], iloop);
+	array_deallocate(intarr);
+	EXPECT_EQ(intarr, 0);
+	memory_arena_finalize(&arena);
+
+	memory_pool_initialize(&pool, HASH_TEST, 256, 16, 0, 0);
+	array_allocator_initialize_pool(&allocator, &pool);
+	array_initialize_allocator(intarr, &allocator);
+	array_reserve(intarr, 56);
+	prev = intarr;
+	for (iloop = 0; iloop < 56; ++iloop)
+		array_push(intarr, iloop);
+	EXPECT_EQ(intarr, prev);
+	for (iloop = 0; iloop < 56; ++iloop)
+		EXPECT_EQ(intarr[iloop], iloop);
+	array_deallocate(intarr);
+	EXPECT_EQ(intarr, 0);
+	memory_pool_finalize(&pool);
+
+	return 0;
+}
+
+static bool
+array_predicate_odd(const void* element, void* data) {
+	FOUNDATION_UNUSED(data);
+	return (*(const int*)element & 1) != 0;
+}
+
+static bool
+array_predicate_all(const void* element, void* data) {
+	FOUNDATION_UNUSED(element);
+	++(*(int*)data);
+	return true;
+}
+
+DECLARE_TEST(array, bulk) {
+	uint32_t* keys = 0;
+	hash_t* hashes = 0;
+	combine_t* combinearr = 0;
+	int* intarr = 0;
+	combine_t combine;
+	uint32_t key;
+	int range[37];
+	int value = 0;
+	int calls;
+	size_t ielem;
+	size_t isize;
+
+	EXPECT_INTLT((int)array_find32(keys, 1), 0);
+	EXPECT_INTLT((int)array_find64(hashes, 1), 0);
+
+	//Cover vectorized blocks and scalar tails at every match position
+	for (isize = 1; isize < 67; ++isize) {
+		array_clear(keys);
+		array_clear(hashes);
+		for (ielem = 0; ielem < isize; ++ielem) {
+			array_push(keys, (uint32_t)(ielem * 3 + 1));
+			array_push(hashes, ((hash_t)ielem << 32) | (ielem * 3 + 1));
+		}
+		for (ielem = 0; ielem < isize; ++ielem) {
+			EXPECT_INTEQ((int)array_find32(keys, ielem * 3 + 1), (int)ielem);
+			EXPECT_INTEQ((int)array_find64(hashes, ((hash_t)ielem << 32) | (ielem * 3 + 1)), (int)ielem);
+			//Matching only one 32-bit half must not match
+			EXPECT_INTLT((int)array_find64(hashes, (ielem * 3 + 1) | (ielem ? 0 : ((hash_t)1 << 32))), 0);
+		}
+		EXPECT_INTLT((int)array_find32(keys, 2), 0);
+		EXPECT_INTLT((int)array_find64(hashes, 2), 0);
+	}
+	key = 4;
+	EXPECT_INTEQ((int)array_find_memcmp(keys, &key), 1);
+
+	memset(&combine, 0, sizeof(combine));
+	for (ielem = 0; ielem < 10; ++ielem) {
+		combine.intval = (int)ielem;
+		array_push_memcpy(combinearr, &combine);
+	}
+	combine.intval = 7;
+	EXPECT_INTEQ((int)array_find_memcmp(combinearr, &combine), 7);
+	combine.intval = 10;
+	EXPECT_INTLT((int)array_find_memcmp(combinearr, &combine), 0);
+
+	combine.intval = 42;
+	array_fill_memcpy(combinearr, &combine);
+	EXPECT_EQ(array_size(combinearr), 10);
+	for (ielem = 0; ielem < 10; ++ielem)
+		EXPECT_EQ(combinearr[ielem].intval, 42);
+	array_fill_memcpy(intarr, &value);
+
+	for (ielem = 0; ielem < 37; ++ielem)
+		range[ielem] = (int)ielem;
+	array_push(intarr, -1);
+	array_push_range_memcpy(intarr, range, 37);
+	array_push_range_memcpy(intarr, range, 0);
+	EXPECT_EQ(array_size(intarr), 38);
+	EXPECT_EQ(intarr[0], -1);
+	for (ielem = 0; ielem < 37; ++ielem)
+		EXPECT_EQ(intarr[ielem + 1], (int)ielem);
+
+	EXPECT_SIZEEQ(array_erase_ordered_if(intarr, array_predicate_odd, 0), 19);
+	EXPECT_EQ(array_size(intarr), 19);
+	for (ielem = 0; ielem < 19; ++ielem)
+		EXPECT_EQ(intarr[ielem], (int)(ielem * 2));
+	calls = 0;
+	EXPECT_SIZEEQ(array_erase_ordered_if(intarr, array_predicate_all, &calls), 19);
+	EXPECT_EQ(calls, 19);
+	EXPECT_EQ(array_size(intarr), 0);
+
+	array_deallocate(keys);
+	array_deallocate(hashes);
+	array_deallocate(combinearr);
+	array_deallocate(intarr);
+
+	return 0;
+}
+
 static void
 test_array_declare(void) {
 	ADD_TEST(array, allocation);
@@ -2010,6 +2228,9 @@ test_array_declare(void) {
 	ADD_TEST(array, pushpop);
 	ADD_TEST(array, inserterase);
 	ADD_TEST(array, resize);
+	ADD_TEST(array, inline);
+	ADD_TEST(array, allocator);
+	ADD_TEST(array, bulk);
 }
 
 static test_suite_t test_array_suite = {
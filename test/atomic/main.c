@@ -105,6 +105,27 @@ add_thread(void* arg) {
 	return 0;
 }
 
+static void*
+explicit_thread(void* arg) {
+	int loop = 0;
+	int32_t icount = 0;
+	FOUNDATION_UNUSED(arg);
+	while (!thread_try_wait(0) && (loop < 65535)) {
+		for (icount = 0; icount < 128; ++icount) {
+			atomic_add32_explicit(&val_32, icount % 2 ? -icount : icount, MEMORY_ORDER_RELAXED);
+			atomic_add64_explicit(&val_64, icount % 2 ? -icount : icount, MEMORY_ORDER_ACQ_REL);
+		}
+		for (icount = 0; icount < 128; ++icount) {
+			atomic_add32_explicit(&val_32, icount % 2 ? icount : -icount, MEMORY_ORDER_RELEASE);
+			atomic_add64_explicit(&val_64, icount % 2 ? icount : -icount, MEMORY_ORDER_RELAXED);
+		}
+
+		++loop;
+		thread_yield();
+	}
+	return 0;
+}
+
 typedef struct {
 	int32_t val_32;
 	int64_t val_64;
@@ -138,6 +159,58 @@ cas_thread(void* arg) {
 	return 0;
 }
 
+#if FOUNDATION_ATOMIC_TAGPTR
+
+typedef struct tagptr_node_t tagptr_node_t;
+struct tagptr_node_t {
+	tagptr_node_t* next;
+};
+
+static atomictagptr_t tagptr_stack;
+static tagptr_node_t  tagptr_nodes[64];
+
+static tagptr_node_t*
+tagptr_pop(void) {
+	uintptr_t tag;
+	tagptr_node_t* node;
+	do {
+		node = atomic_load_tagptr(&tagptr_stack, &tag);
+	}
+	while (node && !atomic_cas_tagptr(&tagptr_stack, node->next, node, tag));
+	return node;
+}
+
+static void
+tagptr_push(tagptr_node_t* node) {
+	uintptr_t tag;
+	tagptr_node_t* head;
+	do {
+		head = atomic_load_tagptr(&tagptr_stack, &tag);
+		node->next = head;
+	}
+	while (!atomic_cas_tagptr(&tagptr_stack, node, head, tag));
+}
+
+static void*
+tagptr_thread(void* arg) {
+	unsigned int loop = 0;
+	tagptr_node_t* node[2];
+	FOUNDATION_UNUSED(arg);
+	while (!thread_try_wait(0) && (loop < 65535)) {
+		node[0] = tagptr_pop();
+		node[1] = tagptr_pop();
+		if (node[1])
+			tagptr_push(node[1]);
+		if (node[0])
+			tagptr_push(node[0]);
+		if (!(++loop % 64))
+			thread_yield();
+	}
+	return 0;
+}
+
+#endif
+
 DECLARE_TEST(atomic, incdec) {
 	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
 	size_t ithread;
@@ -213,11 +286,117 @@ DECLARE_TEST(atomic, cas) {
 	return 0;
 }
 
+DECLARE_TEST(atomic, explicit) {
+	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
+	size_t ithread;
+	thread_t threads[32];
+	int32_t ref_32 = 0;
+
+	atomic_store32_explicit(&val_32, 0, MEMORY_ORDER_RELAXED);
+	atomic_store64_explicit(&val_64, 0, MEMORY_ORDER_RELEASE);
+	atomic_storeptr_explicit(&val_ptr, 0, MEMORY_ORDER_SEQ_CST);
+
+	EXPECT_FALSE(atomic_cas32_explicit(&val_32, 1, 2, MEMORY_ORDER_ACQUIRE));
+	EXPECT_TRUE(atomic_cas32_explicit(&val_32, 1, ref_32, MEMORY_ORDER_ACQ_REL));
+	EXPECT_EQ(atomic_load32_explicit(&val_32, MEMORY_ORDER_ACQUIRE), 1);
+	EXPECT_TRUE(atomic_cas32_explicit(&val_32, 0, 1, MEMORY_ORDER_RELEASE));
+	EXPECT_FALSE(atomic_cas64_explicit(&val_64, 1, 2, MEMORY_ORDER_RELAXED));
+	EXPECT_TRUE(atomic_cas64_explicit(&val_64, 2, 0, MEMORY_ORDER_SEQ_CST));
+	EXPECT_EQ(atomic_load64_explicit(&val_64, MEMORY_ORDER_RELAXED), 2);
+	EXPECT_EQ(atomic_add64_explicit(&val_64, -2, MEMORY_ORDER_RELAXED), 0);
+	EXPECT_TRUE(atomic_cas_ptr_explicit(&val_ptr, &ref_32, 0, MEMORY_ORDER_RELEASE));
+	EXPECT_EQ(atomic_loadptr_explicit(&val_ptr, MEMORY_ORDER_ACQUIRE), &ref_32);
+	atomic_storeptr_explicit(&val_ptr, 0, MEMORY_ORDER_RELEASE);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_initialize(&threads[ithread], explicit_thread, 0,
+		                  STRING_CONST("explicit"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&threads[ithread]);
+
+	test_wait_for_threads_startup(threads, num_threads);
+	test_wait_for_threads_finish(threads, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&threads[ithread]);
+
+	EXPECT_EQ(atomic_load32_explicit(&val_32, MEMORY_ORDER_SEQ_CST), 0);
+	EXPECT_EQ(atomic_load64_explicit(&val_64, MEMORY_ORDER_SEQ_CST), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(atomic, cas128) {
+#if FOUNDATION_ATOMIC128
+	atomic128_t val_128;
+	uint128_t val;
+
+	atomic_store128(&val_128, uint128_make(1, 2));
+	val = atomic_load128(&val_128);
+	EXPECT_TRUE(uint128_equal(val, uint128_make(1, 2)));
+
+	EXPECT_FALSE(atomic_cas128(&val_128, uint128_make(3, 4), uint128_make(1, 3)));
+	EXPECT_FALSE(atomic_cas128(&val_128, uint128_make(3, 4), uint128_make(2, 2)));
+	EXPECT_TRUE(uint128_equal(atomic_load128(&val_128), uint128_make(1, 2)));
+
+	EXPECT_TRUE(atomic_cas128(&val_128, uint128_make(0xFFFFFFFFFFFFFFFFULL, 4), uint128_make(1, 2)));
+	EXPECT_TRUE(uint128_equal(atomic_load128(&val_128), uint128_make(0xFFFFFFFFFFFFFFFFULL, 4)));
+#endif
+	return 0;
+}
+
+DECLARE_TEST(atomic, tagptr) {
+#if FOUNDATION_ATOMIC_TAGPTR
+	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
+	size_t ithread, inode, count;
+	uintptr_t tag, last_tag;
+	thread_t threads[32];
+	tagptr_node_t* node;
+
+	memset(&tagptr_stack, 0, sizeof(tagptr_stack));
+	EXPECT_EQ(atomic_load_tagptr(&tagptr_stack, &tag), 0);
+	EXPECT_EQ(tag, 0);
+
+	for (inode = 0; inode < 64; ++inode)
+		tagptr_push(&tagptr_nodes[inode]);
+	EXPECT_EQ(atomic_load_tagptr(&tagptr_stack, &tag), &tagptr_nodes[63]);
+	EXPECT_EQ(tag, 64);
+
+	EXPECT_FALSE(atomic_cas_tagptr(&tagptr_stack, 0, &tagptr_nodes[63], tag - 1));
+	EXPECT_EQ(atomic_load_tagptr(&tagptr_stack, &last_tag), &tagptr_nodes[63]);
+	EXPECT_EQ(last_tag, tag);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_initialize(&threads[ithread], tagptr_thread, 0,
+		                  STRING_CONST("tagptr"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&threads[ithread]);
+
+	test_wait_for_threads_startup(threads, num_threads);
+	test_wait_for_threads_finish(threads, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&threads[ithread]);
+
+	count = 0;
+	while ((node = tagptr_pop()) != 0) {
+		EXPECT_GE(node, &tagptr_nodes[0]);
+		EXPECT_LE(node, &tagptr_nodes[63]);
+		++count;
+	}
+	EXPECT_SIZEEQ(count, 64);
+#endif
+	return 0;
+}
+
 static void
 test_atomic_declare(void) {
 	ADD_TEST(atomic, incdec);
 	ADD_TEST(atomic, add);
 	ADD_TEST(atomic, cas);
+	ADD_TEST(atomic, explicit);
+	ADD_TEST(atomic, cas128);
+	ADD_TEST(atomic, tagptr);
 }
 
 static test_suite_t test_atomic_suite = {
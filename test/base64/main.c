@@ -315,9 +315,156 @@ DECLARE_TEST(base64, encode_decode) {
 	return 0;
 }
 
+DECLARE_TEST(base64, blocks) {
+	size_t size = 8192 + 13;
+	size_t capacity = ((size + 2) / 3) * 4 + 1;
+	unsigned char* data = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	unsigned char* verify = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	char* text = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT);
+	char* reference = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT);
+	char* noisy = memory_allocate(0, capacity * 2, 0, MEMORY_PERSISTENT);
+	size_t i, offset, length, written, noisy_length;
+
+	for (i = 0; i < size; ++i)
+		data[i] = (unsigned char)random32_range(0, 256);
+
+	//Reference encoding in groups too small for the vectorized code paths
+	for (offset = 0, length = 0; offset < size; offset += 12)
+		length += base64_encode(data + offset, (size - offset > 12) ? 12 : (size - offset),
+		                        reference + length, capacity - length) - 1;
+	EXPECT_SIZEEQ(length, capacity - 1);
+
+	for (i = 0; i < 64; ++i) {
+		size_t partial = size - (size_t)random32_range(0, 128);
+		written = base64_encode(data, partial, text, capacity);
+		EXPECT_SIZEEQ(written, ((partial + 2) / 3) * 4 + 1);
+		EXPECT_EQ(memcmp(text, reference, ((partial / 3) * 4)), 0);
+
+		memset(verify, 0, size);
+		written = base64_decode(text, written - 1, verify, size);
+		EXPECT_SIZEEQ(written, partial);
+		EXPECT_EQ(memcmp(data, verify, partial), 0);
+	}
+
+	//Every character value in the middle of otherwise valid blocks, invalid characters are
+	//discarded and valid characters replace the encoded value
+	for (i = 0; i < 256; ++i) {
+		bool valid = ((i >= 'A') && (i <= 'Z')) || ((i >= 'a') && (i <= 'z')) ||
+		             ((i >= '0') && (i <= '9')) || (i == '+') || (i == '/');
+		memcpy(noisy, reference, 96);
+		noisy[37] = (char)i;
+		memset(verify, 0, size);
+		written = base64_decode(noisy, 96, verify, size);
+		EXPECT_SIZEEQ(written, valid ? 72 : 71);
+		EXPECT_EQ(memcmp(data, verify, 27), 0);
+		if (valid) {
+			EXPECT_EQ(memcmp(data + 30, verify + 30, 42), 0);
+		}
+		else {
+			memmove(noisy + 37, noisy + 38, 58);
+			EXPECT_SIZEEQ(base64_decode(noisy, 95, verify + 100, 71), 71);
+			EXPECT_EQ(memcmp(verify, verify + 100, 71), 0);
+		}
+	}
+
+	//Line breaks and noise
+	for (offset = 0, noisy_length = 0; offset < capacity - 1; offset += 76) {
+		length = (capacity - 1 - offset > 76) ? 76 : (capacity - 1 - offset);
+		memcpy(noisy + noisy_length, reference + offset, length);
+		noisy_length += length;
+		noisy[noisy_length++] = '\r';
+		noisy[noisy_length++] = '\n';
+		if (!(offset % 3))
+			noisy[noisy_length++] = '*';
+	}
+	memset(verify, 0, size);
+	written = base64_decode(noisy, noisy_length, verify, size);
+	EXPECT_SIZEEQ(written, size);
+	EXPECT_EQ(memcmp(data, verify, size), 0);
+
+	//Limited capacity
+	memset(verify, 0, size);
+	written = base64_decode(reference, capacity - 1, verify, 4099);
+	EXPECT_SIZEEQ(written, 4099);
+	EXPECT_EQ(memcmp(data, verify, written), 0);
+	EXPECT_EQ(verify[4099], 0);
+
+	//In-place decoding
+	memcpy(noisy, reference, capacity);
+	written = base64_decode(noisy, capacity - 1, noisy, capacity);
+	EXPECT_SIZEEQ(written, size);
+	EXPECT_EQ(memcmp(data, noisy, size), 0);
+
+	memory_deallocate(data);
+	memory_deallocate(verify);
+	memory_deallocate(text);
+	memory_deallocate(reference);
+	memory_deallocate(noisy);
+
+	return 0;
+}
+
+DECLARE_TEST(base64, stream) {
+	size_t size = 5000;
+	size_t capacity = ((size + 2) / 3) * 4 + 1;
+	unsigned char* data = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	unsigned char* verify = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	char* reference = memory_allocate(0, capacity, 0, MEMORY_PERSISTENT);
+	stream_t* buffer;
+	stream_t* stream;
+	size_t i, offset, chunk, length;
+
+	for (i = 0; i < size; ++i)
+		data[i] = (unsigned char)random32_range(0, 256);
+
+	for (length = size - 2; length <= size; ++length) {
+		base64_encode(data, length, reference, capacity);
+
+		buffer = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+		stream = base64_stream_allocate(buffer, STREAM_OUT, false);
+		EXPECT_EQ(stream->type, STREAMTYPE_BASE64);
+		for (offset = 0; offset < length; offset += chunk) {
+			chunk = random32_range(1, 1500);
+			if (chunk > length - offset)
+				chunk = length - offset;
+			EXPECT_SIZEEQ(stream_write(stream, data + offset, chunk), chunk);
+		}
+		EXPECT_SIZEEQ(stream_tell(stream), length);
+		stream_deallocate(stream);
+
+		EXPECT_SIZEEQ(stream_size(buffer), string_length(reference));
+		EXPECT_EQ(memcmp(((stream_buffer_t*)buffer)->buffer, reference, string_length(reference)), 0);
+
+		//Decode with line breaks inserted
+		stream_seek(buffer, 0, STREAM_SEEK_END);
+		stream_write(buffer, STRING_CONST("\n"));
+		stream_seek(buffer, 0, STREAM_SEEK_BEGIN);
+		stream = base64_stream_allocate(buffer, STREAM_IN, true);
+		memset(verify, 0, size);
+		for (offset = 0; !stream_eos(stream); offset += chunk) {
+			chunk = random32_range(1, 1500);
+			if (chunk > size - offset)
+				chunk = size - offset;
+			chunk = stream_read(stream, verify + offset, chunk);
+		}
+		EXPECT_SIZEEQ(offset, length);
+		EXPECT_SIZEEQ(stream_tell(stream), length);
+		EXPECT_EQ(memcmp(data, verify, length), 0);
+		stream_deallocate(stream);
+	}
+
+	memory_deallocate(data);
+	memory_deallocate(verify);
+	memory_deallocate(reference);
+
+	return 0;
+}
+
 static void
 test_base64_declare(void) {
 	ADD_TEST(base64, encode_decode);
+	ADD_TEST(base64, blocks);
+	ADD_TEST(base64, stream);
 }
 
 static test_suite_t test_base64_suite = {
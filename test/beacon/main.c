@@ -72,6 +72,32 @@ DECLARE_TEST(beacon, fire) {
 	return 0;
 }
 
+DECLARE_TEST(beacon, statistics) {
+	beacon_t beacon;
+	lock_statistics_t statistics;
+
+	beacon_initialize(&beacon);
+
+	EXPECT_INTLT(beacon_try_wait(&beacon, 0), 0);
+	EXPECT_INTLT(beacon_try_wait(&beacon, 10), 0);
+	beacon_fire(&beacon);
+	EXPECT_INTEQ(beacon_try_wait(&beacon, 100), 0);
+
+	statistics = beacon_statistics(&beacon);
+#if BUILD_ENABLE_LOCK_STATISTICS
+	EXPECT_EQ(statistics.acquisitions, 1);
+	EXPECT_EQ(statistics.contentions, 1);
+	EXPECT_TICKGT(statistics.wait_ticks, 0);
+	EXPECT_EQ(statistics.holder, 0);
+#else
+	EXPECT_EQ(statistics.acquisitions, 0);
+#endif
+
+	beacon_finalize(&beacon);
+
+	return 0;
+}
+
 DECLARE_TEST(beacon, multiwait) {
 #if !FOUNDATION_PLATFORM_PNACL
 	beacon_t* beacon[2];
@@ -177,10 +203,105 @@ DECLARE_TEST(beacon, multiwait) {
 	return 0;
 }
 
+DECLARE_TEST(beacon, many) {
+#if !FOUNDATION_PLATFORM_PNACL
+#if FOUNDATION_PLATFORM_WINDOWS
+	const size_t num_sources = MAXIMUM_WAIT_OBJECTS - 1;
+	semaphore_t* source;
+#else
+	const size_t num_sources = 200;
+	stream_pipe_t* source;
+	char data[8] = {0};
+#endif
+	int slots[16];
+	size_t isource, ifired, fired;
+	beacon_t* beacon = beacon_allocate();
+
+	source = memory_allocate(0, sizeof(*source) * num_sources, 0, MEMORY_PERSISTENT);
+	for (isource = 0; isource < num_sources; ++isource) {
+#if FOUNDATION_PLATFORM_WINDOWS
+		semaphore_initialize(source + isource, 0);
+		EXPECT_INTEQ(beacon_add(beacon, semaphore_event_handle(source + isource)), (int)isource + 1);
+		EXPECT_EQ(beacon_slot_handle(beacon, (int)isource + 1), semaphore_event_handle(source + isource));
+#else
+		pipe_initialize(source + isource);
+		EXPECT_INTEQ(beacon_add(beacon, pipe_read_handle((stream_t*)(source + isource))), (int)isource + 1);
+		EXPECT_INTEQ(beacon_slot_handle(beacon, (int)isource + 1), pipe_read_handle((stream_t*)(source + isource)));
+#endif
+	}
+#if FOUNDATION_PLATFORM_WINDOWS
+	EXPECT_INTLT(beacon_add(beacon, semaphore_event_handle(source)), 0);
+	EXPECT_EQ(beacon_slot_handle(beacon, (int)num_sources + 1), nullptr);
+#else
+	EXPECT_INTLT(beacon_slot_handle(beacon, (int)num_sources + 1), 0);
+#endif
+
+	EXPECT_SIZEEQ(beacon_try_wait_many(beacon, 0, slots, sizeof(slots) / sizeof(slots[0])), 0);
+
+	//Fire base event and the last and two middle sources
+	beacon_fire(beacon);
+#if FOUNDATION_PLATFORM_WINDOWS
+	semaphore_post(source + (num_sources / 3));
+	semaphore_post(source + (num_sources / 2));
+	semaphore_post(source + (num_sources - 1));
+#else
+	stream_write((stream_t*)(source + (num_sources / 3)), data, sizeof(data));
+	stream_write((stream_t*)(source + (num_sources / 2)), data, sizeof(data));
+	stream_write((stream_t*)(source + (num_sources - 1)), data, sizeof(data));
+#endif
+
+	fired = beacon_try_wait_many(beacon, 100, slots, sizeof(slots) / sizeof(slots[0]));
+	EXPECT_SIZEEQ(fired, 4);
+	for (ifired = 0; ifired < fired; ++ifired) {
+		int slot = slots[ifired];
+		EXPECT_TRUE((slot == 0) || (slot == (int)(num_sources / 3) + 1) ||
+		            (slot == (int)(num_sources / 2) + 1) || (slot == (int)num_sources));
+#if !FOUNDATION_PLATFORM_WINDOWS
+		if (slot > 0)
+			stream_read((stream_t*)(source + (slot - 1)), data, sizeof(data));
+#endif
+	}
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	//Remove all but the last source, which should keep firing with a new index
+	for (isource = 0; isource < num_sources - 1; ++isource) {
+#if FOUNDATION_PLATFORM_WINDOWS
+		beacon_remove(beacon, semaphore_event_handle(source + isource));
+#else
+		beacon_remove(beacon, pipe_read_handle((stream_t*)(source + isource)));
+#endif
+	}
+#if FOUNDATION_PLATFORM_WINDOWS
+	semaphore_post(source + (num_sources - 1));
+	EXPECT_INTEQ(beacon_try_wait(beacon, 100), 1);
+	EXPECT_EQ(beacon_slot_handle(beacon, 1), semaphore_event_handle(source + (num_sources - 1)));
+#else
+	stream_write((stream_t*)(source + (num_sources - 1)), data, sizeof(data));
+	EXPECT_INTEQ(beacon_try_wait(beacon, 100), 1);
+	EXPECT_INTEQ(beacon_slot_handle(beacon, 1), pipe_read_handle((stream_t*)(source + (num_sources - 1))));
+	stream_read((stream_t*)(source + (num_sources - 1)), data, sizeof(data));
+#endif
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	beacon_deallocate(beacon);
+	for (isource = 0; isource < num_sources; ++isource) {
+#if FOUNDATION_PLATFORM_WINDOWS
+		semaphore_finalize(source + isource);
+#else
+		stream_finalize((stream_t*)(source + isource));
+#endif
+	}
+	memory_deallocate(source);
+#endif
+	return 0;
+}
+
 static void
 test_beacon_declare(void) {
 	ADD_TEST(beacon, fire);
+	ADD_TEST(beacon, statistics);
 	ADD_TEST(beacon, multiwait);
+	ADD_TEST(beacon, many);
 }
 
 static test_suite_t test_beacon_suite = {
@@ -650,12 +650,156 @@ DECLARE_TEST(bitbuffer, stream) {
 	return 0;
 }
 
+DECLARE_TEST(bitbuffer, peek) {
+	uint32_t buffer[256];
+	uint32_t reference[256];
+	bitbuffer_t bitbuffer;
+	bitbuffer_t verify;
+	stream_t* stream;
+	unsigned int bits[64];
+	int ipass, ival;
+
+	for (ival = 0; ival < 256; ++ival)
+		reference[ival] = random32();
+
+	for (ipass = 0; ipass < 256; ++ipass) {
+		for (ival = 0; ival < 64; ++ival)
+			bits[ival] = random32_range(1, 33);
+
+		//Peek matches read, and consume matches read of the same bits
+		memcpy(buffer, reference, sizeof(buffer));
+		bitbuffer_initialize_buffer(&bitbuffer, buffer, sizeof(buffer), false);
+		bitbuffer_initialize_buffer(&verify, reference, sizeof(reference), false);
+		for (ival = 0; ival < 64; ++ival) {
+			uint32_t peeked = bitbuffer_peek32(&bitbuffer, bits[ival]);
+			EXPECT_UINTEQ(bitbuffer_peek32(&bitbuffer, bits[ival]), peeked);
+			EXPECT_UINTEQ(bitbuffer_read32(&verify, bits[ival]), peeked);
+			if (ival & 1)
+				bitbuffer_consume(&bitbuffer, bits[ival]);
+			else
+				EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, bits[ival]), peeked);
+		}
+		EXPECT_UINTEQ(bitbuffer.count_read, verify.count_read);
+
+		//Bulk consume crossing several chunks
+		bitbuffer_consume(&bitbuffer, bits[0] * 7);
+		bitbuffer_consume(&verify, bits[0] * 7);
+		EXPECT_UINTEQ(bitbuffer.count_read, verify.count_read);
+		EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, bits[1]), bitbuffer_read32(&verify, bits[1]));
+		EXPECT_UINTEQ(bitbuffer_read64(&bitbuffer, 32 + bits[2]),
+		              bitbuffer_read64(&verify, 32 + bits[2]));
+	}
+
+	//Peek ahead from a stream is kept for following reads
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	bitbuffer_initialize_stream(&bitbuffer, stream);
+	bitbuffer_write32(&bitbuffer, 0x12345678, 32);
+	bitbuffer_write32(&bitbuffer, 0x9ABCDEF0, 32);
+	bitbuffer_write64(&bitbuffer, 0x0123456789ABCDEFULL, 64);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	bitbuffer_initialize_stream(&bitbuffer, stream);
+	EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, 24), 0x345678);
+	EXPECT_UINTEQ(bitbuffer_peek32(&bitbuffer, 16), 0xF012);
+	EXPECT_SIZEEQ(stream_tell(stream), 8);
+	EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, 12), 0x012);
+	EXPECT_TYPEEQ(bitbuffer_read64(&bitbuffer, 64), 0x789ABCDEF9ABCDEFULL, uint64_t, PRIx64);
+	EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, 20), 0x23456);
+	bitbuffer_finalize(&bitbuffer);
+	stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(bitbuffer, arrays) {
+	uint32_t buffer[256];
+	uint32_t reference[256];
+	uint32_t values[256];
+	uint32_t readback[256];
+	float32_t floats[64];
+	float32_t readfloats[64];
+	bitbuffer_t bitbuffer;
+	stream_t* stream;
+	int ipass, iswap;
+	size_t ival;
+
+	for (ival = 0; ival < 256; ++ival)
+		values[ival] = random32();
+	for (ival = 0; ival < 64; ++ival)
+		floats[ival] = (float32_t)ival * 1.5f;
+
+	for (iswap = 0; iswap < 2; ++iswap) {
+		for (ipass = 0; ipass < 3; ++ipass) {
+			//Bulk and per-value writes produce the same chunks, aligned and unaligned
+			unsigned int lead = (ipass == 1) ? 5 : 0;
+			unsigned int bits = (ipass == 2) ? 17 : 32;
+			memset(buffer, 0, sizeof(buffer));
+			memset(reference, 0, sizeof(reference));
+			bitbuffer_initialize_buffer(&bitbuffer, buffer, sizeof(buffer), iswap != 0);
+			bitbuffer_write32(&bitbuffer, 3, lead);
+			bitbuffer_write32_array(&bitbuffer, values, 200, bits);
+			bitbuffer_write_float32_array(&bitbuffer, floats, 10);
+			EXPECT_TYPEEQ(bitbuffer.count_write, lead + (200 * bits) + 320, uint64_t, PRIu64);
+			bitbuffer_align_write(&bitbuffer, false);
+
+			bitbuffer_initialize_buffer(&bitbuffer, reference, sizeof(reference), iswap != 0);
+			bitbuffer_write32(&bitbuffer, 3, lead);
+			for (ival = 0; ival < 200; ++ival)
+				bitbuffer_write32(&bitbuffer, values[ival], bits);
+			for (ival = 0; ival < 10; ++ival)
+				bitbuffer_write_float32(&bitbuffer, floats[ival]);
+			bitbuffer_align_write(&bitbuffer, false);
+			EXPECT_EQ(memcmp(buffer, reference, sizeof(buffer)), 0);
+
+			bitbuffer_initialize_buffer(&bitbuffer, buffer, sizeof(buffer), iswap != 0);
+			EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, lead), lead ? 3 : 0);
+			bitbuffer_read32_array(&bitbuffer, readback, 200, bits);
+			bitbuffer_read_float32_array(&bitbuffer, readfloats, 10);
+			EXPECT_TYPEEQ(bitbuffer.count_read, lead + (200 * bits) + 320, uint64_t, PRIu64);
+			for (ival = 0; ival < 200; ++ival)
+				EXPECT_UINTEQ(readback[ival], (bits < 32) ? (values[ival] & ((1U << bits) - 1)) :
+				              values[ival]);
+			EXPECT_EQ(memcmp(readfloats, floats, sizeof(float32_t) * 10), 0);
+		}
+	}
+
+	//Reading past end of buffer gives zero
+	bitbuffer_initialize_buffer(&bitbuffer, buffer, 16, false);
+	bitbuffer_read32_array(&bitbuffer, readback, 6, 32);
+	EXPECT_UINTEQ(readback[3], buffer[3]);
+	EXPECT_UINTEQ(readback[4], 0);
+	EXPECT_UINTEQ(readback[5], 0);
+
+	//Lookahead chunk is used by bulk read
+	bitbuffer_initialize_buffer(&bitbuffer, reference, sizeof(reference), false);
+	bitbuffer_read32(&bitbuffer, 16);
+	bitbuffer_peek32(&bitbuffer, 32);
+	bitbuffer_consume(&bitbuffer, 16);
+	bitbuffer_read32_array(&bitbuffer, readback, 4, 32);
+	EXPECT_EQ(memcmp(readback, reference + 1, 16), 0);
+
+	//Stream backed bulk transfers
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	bitbuffer_initialize_stream(&bitbuffer, stream);
+	bitbuffer_write32_array(&bitbuffer, values, 256, 32);
+	EXPECT_SIZEEQ(stream_size(stream), sizeof(values));
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	bitbuffer_initialize_stream(&bitbuffer, stream);
+	bitbuffer_read32_array(&bitbuffer, readback, 256, 32);
+	EXPECT_EQ(memcmp(readback, values, sizeof(values)), 0);
+	bitbuffer_finalize(&bitbuffer);
+	stream_deallocate(stream);
+
+	return 0;
+}
+
 static void
 test_bitbuffer_declare(void) {
 	ADD_TEST(bitbuffer, basics);
 	ADD_TEST(bitbuffer, readwrite);
 	ADD_TEST(bitbuffer, readwriteswap);
 	ADD_TEST(bitbuffer, stream);
+	ADD_TEST(bitbuffer, peek);
+	ADD_TEST(bitbuffer, arrays);
 }
 
 static test_suite_t test_bitbuffer_suite = {
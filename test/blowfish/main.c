@@ -283,6 +283,16 @@ DECLARE_TEST(blowfish, random_data) {
     blowfish_encrypt(blowfish, plaintext[0], 1024 * 8, BLOCKCIPHER_OFB, init_vector);
     blowfish_decrypt(blowfish, plaintext[0], 1024 * 8, BLOCKCIPHER_OFB, init_vector);
     EXPECT_EQ(memcmp(plaintext[0], plaintext[1], 1024 * 8), 0);
+
+    //Counter mode with a partial final block, decrypted in two independent parts
+    blowfish_encrypt(blowfish, plaintext[0], (1024 * 8) - 3, BLOCKCIPHER_CTR, init_vector);
+    EXPECT_NE(memcmp(plaintext[0], plaintext[1], 8), 0);
+    EXPECT_EQ(memcmp(pointer_offset(plaintext[0], (1024 * 8) - 3),
+                     pointer_offset(plaintext[1], (1024 * 8) - 3), 3), 0);
+    blowfish_decrypt(blowfish, plaintext[0] + 100, (924 * 8) - 3, BLOCKCIPHER_CTR,
+                     init_vector + 100);
+    blowfish_decrypt(blowfish, plaintext[0], 100 * 8, BLOCKCIPHER_CTR, init_vector);
+    EXPECT_EQ(memcmp(plaintext[0], plaintext[1], 1024 * 8), 0);
   }
 
   blowfish_deallocate(blowfish);
@@ -588,6 +588,231 @@ DECLARE_TEST(bufferstream, sized_nogrow) {
 	return 0;
 }
 
+DECLARE_TEST(bufferstream, segmented) {
+	stream_t* stream;
+	stream_t* copy;
+	stream_span_t spans[8];
+	stream_span_t allspans[16];
+	uint8_t data[1000];
+	uint8_t readbuffer[1000];
+	size_t i, count, total;
+
+	for (i = 0; i < sizeof(data); ++i)
+		data[i] = (uint8_t)((i * 13) + 1);
+
+	stream = buffer_stream_allocate_segmented(STREAM_IN | STREAM_OUT | STREAM_BINARY, 64);
+	EXPECT_NE(stream, 0);
+	EXPECT_EQ(stream->type, STREAMTYPE_SEGMENTED);
+	EXPECT_TRUE(stream_eos(stream));
+	EXPECT_EQ(stream_size(stream), 0);
+	EXPECT_SIZEEQ(buffer_stream_segments(stream, spans, 8), 0);
+	EXPECT_TRUE(string_equal(stream_path(stream).str, 11, "buffer://0x", 11));
+
+	//Writes crossing segment boundaries at different offsets
+	for (i = 0; i < sizeof(data); i += 37) {
+		size_t size = (i + 37 > sizeof(data)) ? sizeof(data) - i : 37;
+		EXPECT_SIZEEQ(stream_write(stream, data + i, size), size);
+	}
+	EXPECT_SIZEEQ(stream_size(stream), sizeof(data));
+	EXPECT_SIZEEQ(stream_tell(stream), sizeof(data));
+	EXPECT_TRUE(stream_eos(stream));
+
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, readbuffer, sizeof(readbuffer) + 10), sizeof(data));
+	EXPECT_EQ(memcmp(readbuffer, data, sizeof(data)), 0);
+
+	stream_seek(stream, -100, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_tell(stream), sizeof(data) - 100);
+	EXPECT_SIZEEQ(stream_available_read(stream), 100);
+	EXPECT_SIZEEQ(stream_read(stream, readbuffer, 50), 50);
+	EXPECT_EQ(memcmp(readbuffer, data + sizeof(data) - 100, 50), 0);
+	stream_seek(stream, -200, STREAM_SEEK_CURRENT);
+	EXPECT_SIZEEQ(stream_tell(stream), sizeof(data) - 250);
+	stream_seek(stream, 2000, STREAM_SEEK_CURRENT);
+	EXPECT_SIZEEQ(stream_tell(stream), sizeof(data));
+
+	//Overwrite across a segment boundary
+	stream_seek(stream, 60, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_write(stream, data, 10), 10);
+	EXPECT_SIZEEQ(stream_size(stream), sizeof(data));
+	stream_seek(stream, 60, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, readbuffer, 10), 10);
+	EXPECT_EQ(memcmp(readbuffer, data, 10), 0);
+	stream_seek(stream, 60, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_write(stream, data + 60, 10), 10);
+
+	//Segment spans cover content in order
+	EXPECT_SIZEEQ(buffer_stream_segments(stream, 0, 0), 16);
+	EXPECT_SIZEEQ(buffer_stream_segments(stream, spans, 8), 16);
+	for (i = 0; i < 8; ++i) {
+		EXPECT_SIZEEQ(spans[i].size, 64);
+		EXPECT_EQ(memcmp(spans[i].data, data + (i * 64), 64), 0);
+	}
+	count = buffer_stream_segments(stream, allspans, 16);
+	EXPECT_SIZEEQ(count, 16);
+	EXPECT_SIZEEQ(allspans[15].size, sizeof(data) - (15 * 64));
+
+	//Vectored write of the segment list to another stream
+	copy = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	total = stream_write_vector(copy, allspans, count);
+	EXPECT_SIZEEQ(total, sizeof(data));
+	EXPECT_SIZEEQ(stream_size(copy), sizeof(data));
+	stream_seek(copy, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(copy, readbuffer, sizeof(readbuffer)), sizeof(data));
+	EXPECT_EQ(memcmp(readbuffer, data, sizeof(data)), 0);
+	stream_deallocate(copy);
+
+	//Truncate releases segments and zero fills when extending
+	stream_seek(stream, 0, STREAM_SEEK_END);
+	stream_truncate(stream, 100);
+	EXPECT_SIZEEQ(stream_size(stream), 100);
+	EXPECT_SIZEEQ(stream_tell(stream), 100);
+	EXPECT_SIZEEQ(buffer_stream_segments(stream, spans, 8), 2);
+	EXPECT_SIZEEQ(spans[1].size, 36);
+	stream_truncate(stream, 300);
+	EXPECT_SIZEEQ(stream_size(stream), 300);
+	EXPECT_SIZEEQ(stream_tell(stream), 100);
+	EXPECT_SIZEEQ(stream_read(stream, readbuffer, sizeof(readbuffer)), 200);
+	for (i = 0; i < 200; ++i)
+		EXPECT_INTEQ(readbuffer[i], 0);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, readbuffer, 100), 100);
+	EXPECT_EQ(memcmp(readbuffer, data, 100), 0);
+	stream_truncate(stream, 0);
+	EXPECT_TRUE(stream_eos(stream));
+	EXPECT_SIZEEQ(buffer_stream_segments(stream, spans, 8), 0);
+
+	stream_deallocate(stream);
+
+	EXPECT_SIZEEQ(buffer_stream_segments(0, spans, 8), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(bufferstream, typed_read) {
+	stream_t* stream;
+	unsigned int iorder;
+	uint8_t store[64];
+
+	//Typed reads from memory streams are done inline, with fallback to the stream
+	//implementation at end of stream and for text streams
+	for (iorder = 0; iorder < 2; ++iorder) {
+		stream = buffer_stream_allocate(store, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0,
+		                                sizeof(store), false, false);
+		stream_set_byteorder(stream, iorder ? BYTEORDER_BIGENDIAN : BYTEORDER_LITTLEENDIAN);
+		stream_write_bool(stream, true);
+		stream_write_int8(stream, -3);
+		stream_write_uint8(stream, 250);
+		stream_write_int16(stream, -1234);
+		stream_write_uint16(stream, 0xABCD);
+		stream_write_int32(stream, -123456789);
+		stream_write_uint32(stream, 0x89ABCDEF);
+		stream_write_int64(stream, -1234567890123LL);
+		stream_write_uint64(stream, 0x0123456789ABCDEFULL);
+		stream_write_float32(stream, 1.5f);
+		stream_write_float64(stream, -2.25);
+		stream_write_uint16(stream, 0x1234);
+		EXPECT_SIZEEQ(stream_size(stream), 45);
+
+		stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+		EXPECT_TRUE(stream_read_bool(stream));
+		EXPECT_INTEQ(stream_read_int8(stream), -3);
+		EXPECT_UINTEQ(stream_read_uint8(stream), 250);
+		EXPECT_INTEQ(stream_read_int16(stream), -1234);
+		EXPECT_UINTEQ(stream_read_uint16(stream), 0xABCD);
+		EXPECT_INTEQ(stream_read_int32(stream), -123456789);
+		EXPECT_UINTEQ(stream_read_uint32(stream), 0x89ABCDEF);
+		EXPECT_TRUE(stream_read_int64(stream) == -1234567890123LL);
+		EXPECT_TRUE(stream_read_uint64(stream) == 0x0123456789ABCDEFULL);
+		EXPECT_REALEQ(stream_read_float32(stream), REAL_C(1.5));
+		EXPECT_REALEQ((real)stream_read_float64(stream), REAL_C(-2.25));
+		EXPECT_SIZEEQ(stream_tell(stream), 43);
+
+		//Partial value at end of stream is consumed by the generic read
+		stream_truncate(stream, 44);
+		stream_read_uint32(stream);
+		EXPECT_TRUE(stream_eos(stream));
+		EXPECT_UINTEQ(stream_read_uint16(stream), 0);
+		stream_deallocate(stream);
+	}
+
+	//Input mode is respected
+	stream = buffer_stream_allocate(store, STREAM_OUT | STREAM_BINARY, 16, sizeof(store), false,
+	                                false);
+	EXPECT_UINTEQ(stream_read_uint32(stream), 0);
+	EXPECT_SIZEEQ(stream_tell(stream), 0);
+	stream_deallocate(stream);
+
+	//Text streams parse values
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+	stream_write_string(stream, STRING_CONST("1234 -56 "));
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_UINTEQ(stream_read_uint32(stream), 1234);
+	EXPECT_INTEQ(stream_read_int16(stream), -56);
+	stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(bufferstream, text_digest) {
+	stream_t* stream;
+	md5_t md5;
+	size_t size = 256 * 1024 + 4096;
+	size_t iline, ichar, offset, unixsize;
+	char* text;
+	char* unixtext;
+	uint128_t digest;
+
+	//Mixed line endings, with one CR+LF split across the internal read buffer boundary
+	text = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	unixtext = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	offset = 0;
+	unixsize = 0;
+	for (iline = 0; offset < size - 128; ++iline) {
+		size_t linelength = (iline * 7) % 97;
+		for (ichar = 0; ichar < linelength; ++ichar) {
+			text[offset++] = (char)('a' + ((iline + ichar) % 26));
+			unixtext[unixsize++] = text[offset - 1];
+		}
+		if ((offset < 256 * 1024 - 1) && (offset > 256 * 1024 - 100))
+			while (offset < 256 * 1024 - 1)
+				unixtext[unixsize++] = text[offset++] = 'x';
+		if ((offset == 256 * 1024 - 1) || (iline % 3 == 0)) {
+			text[offset++] = '\r';
+			text[offset++] = '\n';
+		}
+		else {
+			text[offset++] = (iline % 3 == 1) ? '\n' : '\r';
+		}
+		unixtext[unixsize++] = '\n';
+	}
+	text[offset++] = '\r';
+	unixtext[unixsize++] = '\n';
+
+	md5_initialize(&md5);
+	md5_digest(&md5, unixtext, unixsize);
+	md5_digest_finalize(&md5);
+	digest = md5_get_digest_raw(&md5);
+	md5_finalize(&md5);
+
+	stream = buffer_stream_allocate(text, STREAM_IN, offset, size, false, false);
+	EXPECT_TRUE(uint128_equal(stream_md5(stream), digest));
+	stream_deallocate(stream);
+
+	stream = buffer_stream_allocate(unixtext, STREAM_IN, unixsize, size, false, false);
+	EXPECT_TRUE(uint128_equal(stream_md5(stream), digest));
+	stream_deallocate(stream);
+
+	stream = buffer_stream_allocate(text, STREAM_IN | STREAM_BINARY, offset, size, false, false);
+	EXPECT_FALSE(uint128_equal(stream_md5(stream), digest));
+	stream_deallocate(stream);
+
+	memory_deallocate(text);
+	memory_deallocate(unixtext);
+
+	return 0;
+}
+
 static void
 test_bufferstream_declare(void) {
 	ADD_TEST(bufferstream, null);
@@ -597,6 +822,9 @@ test_bufferstream_declare(void) {
 	ADD_TEST(bufferstream, zero_nogrow);
 	ADD_TEST(bufferstream, sized_grow);
 	ADD_TEST(bufferstream, sized_nogrow);
+	ADD_TEST(bufferstream, segmented);
+	ADD_TEST(bufferstream, typed_read);
+	ADD_TEST(bufferstream, text_digest);
 }
 
 static test_suite_t test_bufferstream_suite = {
@@ -0,0 +1,210 @@
+/* main.c  -  Foundation checksum test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+#define TEST_DATA_SIZE 1000
+
+static uint8_t test_data[TEST_DATA_SIZE];
+
+static application_t
+test_checksum_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation checksum tests"));
+	app.short_name = string_const(STRING_CONST("test_checksum"));
+	app.config_dir = string_const(STRING_CONST("test_checksum"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_checksum_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_checksum_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_checksum_initialize(void) {
+	size_t i;
+	for (i = 0; i < TEST_DATA_SIZE; ++i)
+		test_data[i] = (uint8_t)((i * 31) + 7);
+	return 0;
+}
+
+static void
+test_checksum_finalize(void) {
+}
+
+DECLARE_TEST(checksum, reference) {
+	EXPECT_UINTEQ(checksum(CHECKSUM_CRC32C, "", 0), 0);
+	EXPECT_UINTEQ(checksum(CHECKSUM_CRC32C, "123456789", 9), 0xE3069283U);
+	EXPECT_UINTEQ(checksum(CHECKSUM_CRC32C, test_data, TEST_DATA_SIZE), 0xFF52EE97U);
+
+	EXPECT_UINTEQ(checksum(CHECKSUM_XXHASH64, "", 0), 0xEF46DB3751D8E999ULL);
+	EXPECT_UINTEQ(checksum(CHECKSUM_XXHASH64, "abc", 3), 0x44BC2CF5AD770999ULL);
+	EXPECT_UINTEQ(checksum(CHECKSUM_XXHASH64, test_data, TEST_DATA_SIZE), 0x99594F4828043D35ULL);
+
+	return 0;
+}
+
+DECLARE_TEST(checksum, incremental) {
+	checksum_type_t types[] = { CHECKSUM_CRC32C, CHECKSUM_XXHASH64 };
+	checksum_t* block;
+	size_t itype, chunk, offset;
+
+	for (itype = 0; itype < sizeof(types) / sizeof(types[0]); ++itype) {
+		uint64_t expect = checksum(types[itype], test_data, TEST_DATA_SIZE);
+		block = checksum_allocate(types[itype]);
+		//Chunk sizes crossing stripe and alignment boundaries at different offsets
+		for (chunk = 1; chunk < 70; ++chunk) {
+			checksum_initialize(block, types[itype]);
+			for (offset = 0; offset < TEST_DATA_SIZE; offset += chunk) {
+				size_t size = (offset + chunk > TEST_DATA_SIZE) ? (TEST_DATA_SIZE - offset) : chunk;
+				checksum_digest(block, test_data + offset, size);
+				if (offset == 0)
+					EXPECT_UINTEQ(checksum_value(block), checksum(types[itype], test_data, size));
+			}
+			EXPECT_UINTEQ(checksum_value(block), expect);
+		}
+		//Unaligned data
+		checksum_initialize(block, types[itype]);
+		checksum_digest(block, test_data + 3, TEST_DATA_SIZE - 3);
+		EXPECT_UINTEQ(checksum_value(block), checksum(types[itype], test_data + 3,
+		                                              TEST_DATA_SIZE - 3));
+		checksum_deallocate(block);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(checksum, stream) {
+	stream_t* buffer_stream;
+	stream_t* checksum_stream;
+	char read_buffer[TEST_DATA_SIZE];
+	uint64_t crc = checksum(CHECKSUM_CRC32C, test_data, TEST_DATA_SIZE);
+	uint64_t xxh = checksum(CHECKSUM_XXHASH64, test_data, TEST_DATA_SIZE);
+	size_t offset;
+
+	//Checksum of data written through stream
+	buffer_stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true,
+	                                       true);
+	checksum_stream = checksum_stream_allocate(buffer_stream, CHECKSUM_CRC32C, false);
+	EXPECT_EQ(checksum_stream->type, STREAMTYPE_CHECKSUM);
+	for (offset = 0; offset < TEST_DATA_SIZE; offset += 100)
+		EXPECT_SIZEEQ(stream_write(checksum_stream, test_data + offset, 100), 100);
+	EXPECT_UINTEQ(checksum_stream_value(checksum_stream), crc);
+	EXPECT_SIZEEQ(stream_tell(checksum_stream), TEST_DATA_SIZE);
+	EXPECT_SIZEEQ(stream_size(checksum_stream), TEST_DATA_SIZE);
+	stream_deallocate(checksum_stream);
+
+	//Checksum of data read through stream, seeking does not affect checksum
+	stream_seek(buffer_stream, 0, STREAM_SEEK_BEGIN);
+	checksum_stream = checksum_stream_allocate(buffer_stream, CHECKSUM_XXHASH64, true);
+	EXPECT_SIZEEQ(stream_read(checksum_stream, read_buffer, 10), 10);
+	checksum_stream_reset(checksum_stream);
+	stream_seek(checksum_stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(checksum_stream, read_buffer, sizeof(read_buffer)), TEST_DATA_SIZE);
+	EXPECT_EQ(memcmp(read_buffer, test_data, TEST_DATA_SIZE), 0);
+	EXPECT_TRUE(stream_eos(checksum_stream));
+	EXPECT_UINTEQ(checksum_stream_value(checksum_stream), xxh);
+
+	//Whole stream checksum restores position
+	stream_seek(checksum_stream, 17, STREAM_SEEK_BEGIN);
+	EXPECT_UINTEQ(stream_checksum(buffer_stream, CHECKSUM_CRC32C), crc);
+	EXPECT_UINTEQ(stream_checksum(checksum_stream, CHECKSUM_XXHASH64), xxh);
+	EXPECT_SIZEEQ(stream_tell(checksum_stream), 17);
+	stream_deallocate(checksum_stream);
+
+	EXPECT_UINTEQ(checksum_stream_value(0), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(checksum, file) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_const_t directory;
+	stream_t* file;
+	size_t iblock;
+	checksum_t block;
+
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	file = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                   STREAM_TRUNCATE);
+	EXPECT_NE(file, 0);
+	checksum_initialize(&block, CHECKSUM_XXHASH64);
+	for (iblock = 0; iblock < 1000; ++iblock) {
+		stream_write(file, test_data, TEST_DATA_SIZE - iblock);
+		checksum_digest(&block, test_data, TEST_DATA_SIZE - iblock);
+	}
+	stream_seek(file, 0, STREAM_SEEK_BEGIN);
+	EXPECT_UINTEQ(stream_checksum(file, CHECKSUM_XXHASH64), checksum_value(&block));
+	EXPECT_SIZEEQ(stream_tell(file), 0);
+	checksum_finalize(&block);
+	stream_deallocate(file);
+
+	fs_remove_file(STRING_ARGS(path));
+
+	return 0;
+}
+
+static void
+test_checksum_declare(void) {
+	ADD_TEST(checksum, reference);
+	ADD_TEST(checksum, incremental);
+	ADD_TEST(checksum, stream);
+	ADD_TEST(checksum, file);
+}
+
+static test_suite_t test_checksum_suite = {
+	test_checksum_application,
+	test_checksum_memory_system,
+	test_checksum_config,
+	test_checksum_declare,
+	test_checksum_initialize,
+	test_checksum_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_checksum_run(void);
+
+int
+test_checksum_run(void) {
+	test_suite = test_checksum_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_checksum_suite;
+}
+
+#endif
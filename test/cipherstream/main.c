@@ -0,0 +1,257 @@
+/* main.c  -  Foundation cipherstream test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_cipherstream_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation cipherstream tests"));
+	app.short_name = string_const(STRING_CONST("test_cipherstream"));
+	app.config_dir = string_const(STRING_CONST("test_cipherstream"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_cipherstream_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_cipherstream_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_cipherstream_initialize(void) {
+	return 0;
+}
+
+static void
+test_cipherstream_finalize(void) {
+}
+
+#define CIPHERSTREAM_DATA_SIZE (70 * 1024 + 13)
+
+static void
+test_cipherstream_fill(uint8_t* data, size_t size) {
+	size_t i;
+	for (i = 0; i < size; ++i)
+		data[i] = (uint8_t)random32_range(0, 256);
+}
+
+static void*
+test_cipherstream_roundtrip(stream_t* writer, stream_t* reader, const uint8_t* data,
+                            uint8_t* verify, size_t size) {
+	size_t offset, chunk;
+
+	//Random chunk sizes crossing blocks and internal chunks at varying offsets
+	for (offset = 0; offset < size; offset += chunk) {
+		chunk = random32_range(1, 20000);
+		if (offset + chunk > size)
+			chunk = size - offset;
+		EXPECT_SIZEEQ(stream_write(writer, data + offset, chunk), chunk);
+	}
+	EXPECT_SIZEEQ(stream_tell(writer), size);
+
+	memset(verify, 0, size);
+	stream_seek(reader, 0, STREAM_SEEK_BEGIN);
+	for (offset = 0; offset < size; offset += chunk) {
+		chunk = random32_range(1, 20000);
+		if (offset + chunk > size)
+			chunk = size - offset;
+		EXPECT_SIZEEQ(stream_read(reader, verify + offset, chunk), chunk);
+	}
+	EXPECT_EQ(memcmp(data, verify, size), 0);
+	EXPECT_SIZEEQ(stream_read(reader, verify, 1), 0);
+	EXPECT_TRUE(stream_eos(reader));
+	return 0;
+}
+
+DECLARE_TEST(cipherstream, aes) {
+	aes_t aes;
+	uint8_t key[32];
+	uint128_t vec;
+	uint8_t* data;
+	uint8_t* verify;
+	uint8_t* encrypted;
+	stream_t* buffer;
+	stream_t* stream;
+	size_t size = CIPHERSTREAM_DATA_SIZE;
+	size_t i;
+
+	test_cipherstream_fill(key, sizeof(key));
+	aes_initialize(&aes, key, sizeof(key));
+	//Counter close to wrapping the low word to verify the carry
+	vec = uint128_make(0xFFFFFFFFFFFFFF00ULL, random64());
+
+	data = memory_allocate(0, size, 16, MEMORY_PERSISTENT);
+	verify = memory_allocate(0, size, 16, MEMORY_PERSISTENT);
+	encrypted = memory_allocate(0, size + AES_BLOCKSIZE, 16, MEMORY_PERSISTENT);
+	test_cipherstream_fill(data, size);
+
+	buffer = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream = cipher_stream_allocate(buffer, &aes, vec, true);
+	EXPECT_EQ(stream->type, STREAMTYPE_CIPHER);
+	if (test_cipherstream_roundtrip(stream, stream, data, verify, size))
+		return FAILED_TEST;
+	EXPECT_SIZEEQ(stream_size(stream), size);
+
+	//Wrapped stream holds the same ciphertext as encrypting the whole buffer at once
+	memset(encrypted, 0, size + AES_BLOCKSIZE);
+	memcpy(encrypted, data, size);
+	aes_encrypt(&aes, encrypted, (size + AES_BLOCKSIZE - 1) & ~(size_t)(AES_BLOCKSIZE - 1),
+	            BLOCKCIPHER_CTR, vec);
+	stream_seek(buffer, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(buffer, verify, size), size);
+	EXPECT_EQ(memcmp(encrypted, verify, size), 0);
+	EXPECT_NE(memcmp(data, verify, size), 0);
+
+	//Random access reads and overwrites
+	for (i = 0; i < 64; ++i) {
+		size_t offset = random32_range(0, (uint32_t)size);
+		size_t chunk = random32_range(0, (uint32_t)(size - offset) + 1);
+		stream_seek(stream, (ssize_t)offset, STREAM_SEEK_BEGIN);
+		EXPECT_SIZEEQ(stream_tell(stream), offset);
+		if (i % 2) {
+			test_cipherstream_fill(data + offset, chunk);
+			EXPECT_SIZEEQ(stream_write(stream, data + offset, chunk), chunk);
+		}
+		else {
+			EXPECT_SIZEEQ(stream_read(stream, verify, chunk), chunk);
+			EXPECT_EQ(memcmp(data + offset, verify, chunk), 0);
+		}
+		EXPECT_SIZEEQ(stream_tell(stream), offset + chunk);
+	}
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, verify, size), size);
+	EXPECT_EQ(memcmp(data, verify, size), 0);
+
+	stream_seek(stream, -100, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_tell(stream), size - 100);
+	EXPECT_SIZEEQ(stream_read(stream, verify, 100), 100);
+	EXPECT_EQ(memcmp(data + size - 100, verify, 100), 0);
+
+	stream_truncate(stream, 1000);
+	EXPECT_SIZEEQ(stream_size(stream), 1000);
+	EXPECT_SIZEEQ(stream_size(buffer), 1000);
+
+	stream_deallocate(stream);
+
+	memory_deallocate(data);
+	memory_deallocate(verify);
+	memory_deallocate(encrypted);
+	aes_finalize(&aes);
+
+	return 0;
+}
+
+DECLARE_TEST(cipherstream, blowfish) {
+	blowfish_t blowfish;
+	uint8_t key[32];
+	uint64_t vec;
+	uint8_t* data;
+	uint8_t* verify;
+	uint8_t* encrypted;
+	stream_t* buffer;
+	stream_t* writer;
+	stream_t* reader;
+	size_t size = CIPHERSTREAM_DATA_SIZE;
+	size_t prefix = 21;
+
+	test_cipherstream_fill(key, sizeof(key));
+	blowfish_initialize(&blowfish, key, sizeof(key));
+	vec = random64();
+
+	data = memory_allocate(0, size, 16, MEMORY_PERSISTENT);
+	verify = memory_allocate(0, size, 16, MEMORY_PERSISTENT);
+	encrypted = memory_allocate(0, size + 8, 16, MEMORY_PERSISTENT);
+	test_cipherstream_fill(data, size);
+
+	//Cipher stream starting after a plain header in the wrapped stream
+	buffer = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream_write(buffer, data, prefix);
+	writer = cipher_stream_allocate_blowfish(buffer, &blowfish, vec, false);
+	reader = cipher_stream_allocate_blowfish(buffer, &blowfish, vec, false);
+	if (test_cipherstream_roundtrip(writer, reader, data, verify, size))
+		return FAILED_TEST;
+	EXPECT_SIZEEQ(stream_size(writer), size);
+	EXPECT_SIZEEQ(stream_size(buffer), size + prefix);
+
+	memset(encrypted, 0, size + 8);
+	memcpy(encrypted, data, size);
+	blowfish_encrypt(&blowfish, encrypted, (size + 7) & ~(size_t)7, BLOCKCIPHER_CTR, vec);
+	stream_seek(buffer, (ssize_t)prefix, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(buffer, verify, size), size);
+	EXPECT_EQ(memcmp(encrypted, verify, size), 0);
+
+	stream_seek(reader, -5, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_tell(reader), 0);
+	stream_seek(reader, 3333, STREAM_SEEK_CURRENT);
+	EXPECT_SIZEEQ(stream_read(reader, verify, 77), 77);
+	EXPECT_EQ(memcmp(data + 3333, verify, 77), 0);
+
+	stream_deallocate(writer);
+	stream_deallocate(reader);
+	stream_deallocate(buffer);
+
+	memory_deallocate(data);
+	memory_deallocate(verify);
+	memory_deallocate(encrypted);
+	blowfish_finalize(&blowfish);
+
+	return 0;
+}
+
+static void
+test_cipherstream_declare(void) {
+	ADD_TEST(cipherstream, aes);
+	ADD_TEST(cipherstream, blowfish);
+}
+
+static test_suite_t test_cipherstream_suite = {
+	test_cipherstream_application,
+	test_cipherstream_memory_system,
+	test_cipherstream_config,
+	test_cipherstream_declare,
+	test_cipherstream_initialize,
+	test_cipherstream_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_cipherstream_run(void);
+
+int
+test_cipherstream_run(void) {
+	test_suite = test_cipherstream_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_cipherstream_suite;
+}
+
+#endif
@@ -0,0 +1,328 @@
+/* main.c  -  Foundation compressstream test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+#define TEST_DATA_SIZE (256 * 1024)
+
+static char* test_data;
+
+static application_t
+test_compressstream_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation compressstream tests"));
+	app.short_name = string_const(STRING_CONST("test_compressstream"));
+	app.config_dir = string_const(STRING_CONST("test_compressstream"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_compressstream_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_compressstream_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_compressstream_initialize(void) {
+	size_t offset = 0;
+	size_t i;
+	int line = 0;
+
+	//Mix of text, runs of repeated bytes and incompressible random data
+	test_data = memory_allocate(0, TEST_DATA_SIZE, 0, MEMORY_PERSISTENT);
+	while (offset < TEST_DATA_SIZE) {
+		size_t remain = TEST_DATA_SIZE - offset;
+		size_t chunk = 0;
+		switch (line % 4) {
+		case 0:
+		case 1:
+			chunk = string_format(test_data + offset, remain, STRING_CONST("line %d of text\n"),
+			                      line).length;
+			break;
+		case 2:
+			chunk = random32_range(1, 600);
+			if (chunk > remain)
+				chunk = remain;
+			memset(test_data + offset, (int)random32_range(0, 256), chunk);
+			break;
+		default:
+			chunk = random32_range(1, 300);
+			if (chunk > remain)
+				chunk = remain;
+			for (i = 0; i < chunk; ++i)
+				test_data[offset + i] = (char)random32();
+			break;
+		}
+		offset += chunk;
+		++line;
+	}
+	return 0;
+}
+
+static void
+test_compressstream_finalize(void) {
+	memory_deallocate(test_data);
+}
+
+DECLARE_TEST(compressstream, readwrite) {
+	char* buffer = memory_allocate(0, TEST_DATA_SIZE, 0, MEMORY_PERSISTENT);
+	stream_t* packed;
+	stream_t* stream;
+	size_t packed_size;
+	size_t sizes[] = { 0, 1, 13, 1000, TEST_DATA_SIZE };
+	size_t isize;
+
+	for (isize = 0; isize < sizeof(sizes) / sizeof(sizes[0]); ++isize) {
+		size_t size = sizes[isize];
+
+		packed = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+		stream = compressed_stream_allocate(packed, STREAM_OUT, 4096, false);
+		EXPECT_NE(stream, 0);
+		EXPECT_TRUE(stream_is_binary(stream));
+		EXPECT_TRUE(stream_is_sequential(stream));
+		EXPECT_SIZEEQ(stream_write(stream, test_data, size), size);
+		EXPECT_SIZEEQ(stream_tell(stream), size);
+		EXPECT_SIZEEQ(stream_size(stream), size);
+		stream_deallocate(stream);
+
+		packed_size = stream_size(packed);
+		if (size == TEST_DATA_SIZE)
+			EXPECT_SIZELT(packed_size, size / 2);
+
+		stream_seek(packed, 0, STREAM_SEEK_BEGIN);
+		stream = compressed_stream_allocate(packed, STREAM_IN, 0, true);
+		EXPECT_FALSE(stream_is_sequential(stream));
+		memset(buffer, 0, size);
+		EXPECT_SIZEEQ(stream_read(stream, buffer, TEST_DATA_SIZE), size);
+		EXPECT_EQ(memcmp(buffer, test_data, size), 0);
+		EXPECT_TRUE(stream_eos(stream));
+		EXPECT_SIZEEQ(stream_tell(stream), size);
+		EXPECT_SIZEEQ(stream_read(stream, buffer, 1), 0);
+		stream_deallocate(stream);
+	}
+
+	//Typed data through compressed stream
+	packed = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream = compressed_stream_allocate(packed, STREAM_OUT, 0, false);
+	for (isize = 0; isize < 1000; ++isize)
+		stream_write_uint32(stream, (uint32_t)isize);
+	stream_write_string(stream, STRING_CONST("compressed string"));
+	stream_deallocate(stream);
+
+	stream_seek(packed, 0, STREAM_SEEK_BEGIN);
+	stream = compressed_stream_allocate(packed, STREAM_IN, 0, true);
+	for (isize = 0; isize < 1000; ++isize)
+		EXPECT_UINTEQ(stream_read_uint32(stream), (uint32_t)isize);
+	{
+		string_t str = stream_read_string_buffer(stream, buffer, 64);
+		EXPECT_STRINGEQ(str, string_const(STRING_CONST("compressed string")));
+	}
+	EXPECT_TRUE(stream_eos(stream));
+	stream_deallocate(stream);
+
+	memory_deallocate(buffer);
+
+	return 0;
+}
+
+DECLARE_TEST(compressstream, seek) {
+	char* buffer = memory_allocate(0, TEST_DATA_SIZE, 0, MEMORY_PERSISTENT);
+	char pathbuf[BUILD_MAX_PATHLEN];
+	stream_t* file;
+	stream_t* stream;
+	string_t path;
+	string_const_t directory;
+	size_t offsets[] = { 0, 5000, 4095, 4096, 4097, 100000, TEST_DATA_SIZE - 1, 12 };
+	size_t ioffset;
+
+	path = path_make_temporary(pathbuf, sizeof(pathbuf));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	file = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                   STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(file, 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+
+	//Frame does not need to start at beginning of wrapped stream
+	stream_write_uint32(file, 0xDEADBEEF);
+	stream = compressed_stream_allocate(file, STREAM_OUT, 4096, false);
+	stream_write(stream, test_data, TEST_DATA_SIZE);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_tell(stream), TEST_DATA_SIZE);
+	stream_deallocate(stream);
+	stream_write_uint32(file, 0xCAFEBABE);
+
+	stream_seek(file, 4, STREAM_SEEK_BEGIN);
+	stream = compressed_stream_allocate(file, STREAM_IN, 0, false);
+	EXPECT_SIZEEQ(stream_size(stream), TEST_DATA_SIZE);
+	EXPECT_SIZEEQ(stream_tell(stream), 0);
+
+	for (ioffset = 0; ioffset < sizeof(offsets) / sizeof(offsets[0]); ++ioffset) {
+		size_t offset = offsets[ioffset];
+		size_t size = (TEST_DATA_SIZE - offset) < 10000 ? (TEST_DATA_SIZE - offset) : 10000;
+		stream_seek(stream, (ssize_t)offset, STREAM_SEEK_BEGIN);
+		EXPECT_SIZEEQ(stream_tell(stream), offset);
+		EXPECT_SIZEEQ(stream_read(stream, buffer, size), size);
+		EXPECT_EQ(memcmp(buffer, test_data + offset, size), 0);
+		EXPECT_SIZEEQ(stream_tell(stream), offset + size);
+	}
+
+	stream_seek(stream, -100, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_tell(stream), TEST_DATA_SIZE - 100);
+	EXPECT_SIZEEQ(stream_read(stream, buffer, 1000), 100);
+	EXPECT_EQ(memcmp(buffer, test_data + TEST_DATA_SIZE - 100, 100), 0);
+	EXPECT_TRUE(stream_eos(stream));
+
+	stream_seek(stream, -8000, STREAM_SEEK_CURRENT);
+	EXPECT_FALSE(stream_eos(stream));
+	EXPECT_SIZEEQ(stream_read(stream, buffer, 100), 100);
+	EXPECT_EQ(memcmp(buffer, test_data + TEST_DATA_SIZE - 8000, 100), 0);
+	stream_seek(stream, 3000, STREAM_SEEK_CURRENT);
+	EXPECT_SIZEEQ(stream_tell(stream), TEST_DATA_SIZE - 4900);
+
+	//Seek past end clamps to end
+	stream_seek(stream, TEST_DATA_SIZE + 100, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_tell(stream), TEST_DATA_SIZE);
+	EXPECT_TRUE(stream_eos(stream));
+	stream_deallocate(stream);
+
+	//Data after frame is untouched
+	EXPECT_UINTEQ(stream_read_uint32(file), 0xCAFEBABE);
+
+	stream_deallocate(file);
+	fs_remove_file(STRING_ARGS(path));
+	memory_deallocate(buffer);
+
+	return 0;
+}
+
+DECLARE_TEST(compressstream, sequential) {
+	char buffer[8192];
+	stream_t* ring = ringbuffer_stream_allocate(64 * 1024, 0);
+	stream_t* writer = compressed_stream_allocate(ring, STREAM_OUT, 1024, false);
+	stream_t* reader = compressed_stream_allocate(ring, STREAM_IN, 0, false);
+	size_t offset = 0;
+	int iloop;
+
+	EXPECT_TRUE(stream_is_sequential(reader));
+
+	//Flushing makes all written data available to reader
+	for (iloop = 0; iloop < 8; ++iloop) {
+		size_t size = 1000 + (size_t)iloop * 700;
+		EXPECT_SIZEEQ(stream_write(writer, test_data + offset, size), size);
+		stream_flush(writer);
+		EXPECT_SIZEEQ(stream_read(reader, buffer, size), size);
+		EXPECT_EQ(memcmp(buffer, test_data + offset, size), 0);
+		EXPECT_SIZEEQ(stream_available_read(reader), 0);
+		offset += size;
+	}
+	EXPECT_SIZEEQ(stream_tell(reader), offset);
+
+	//Forward seek decompresses and discards data
+	stream_write(writer, test_data, 5000);
+	stream_deallocate(writer);
+	stream_seek(reader, 3000, STREAM_SEEK_CURRENT);
+	EXPECT_SIZEEQ(stream_tell(reader), offset + 3000);
+	EXPECT_SIZEEQ(stream_read(reader, buffer, sizeof(buffer)), 2000);
+	EXPECT_EQ(memcmp(buffer, test_data + 3000, 2000), 0);
+	EXPECT_TRUE(stream_eos(reader));
+
+	stream_deallocate(reader);
+	stream_deallocate(ring);
+
+	return 0;
+}
+
+DECLARE_TEST(compressstream, invalid) {
+	char buffer[256];
+	stream_t* packed;
+	stream_t* stream;
+	error_level_t suppress = log_suppress(HASH_STREAM);
+
+	error();
+	packed = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream_write(packed, "not a compressed stream", 23);
+	stream_seek(packed, 0, STREAM_SEEK_BEGIN);
+	stream = compressed_stream_allocate(packed, STREAM_IN, 0, true);
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_PANIC);
+	EXPECT_SIZEEQ(stream_read(stream, buffer, sizeof(buffer)), 0);
+	log_set_suppress(HASH_STREAM, suppress);
+	EXPECT_EQ(error(), ERROR_INVALID_VALUE);
+	EXPECT_TRUE(stream_eos(stream));
+	stream_deallocate(stream);
+
+	//Truncated frame ends stream at last complete block
+	packed = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream = compressed_stream_allocate(packed, STREAM_OUT, 100, false);
+	stream_write(stream, test_data, 250);
+	stream_deallocate(stream);
+	stream_truncate(packed, stream_size(packed) - 20);
+	stream_seek(packed, 0, STREAM_SEEK_BEGIN);
+	stream = compressed_stream_allocate(packed, STREAM_IN, 0, true);
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_PANIC);
+	EXPECT_SIZEEQ(stream_read(stream, buffer, sizeof(buffer)), 200);
+	log_set_suppress(HASH_STREAM, suppress);
+	EXPECT_EQ(memcmp(buffer, test_data, 200), 0);
+	stream_deallocate(stream);
+
+	return 0;
+}
+
+static void
+test_compressstream_declare(void) {
+	ADD_TEST(compressstream, readwrite);
+	ADD_TEST(compressstream, seek);
+	ADD_TEST(compressstream, sequential);
+	ADD_TEST(compressstream, invalid);
+}
+
+static test_suite_t test_compressstream_suite = {
+	test_compressstream_application,
+	test_compressstream_memory_system,
+	test_compressstream_config,
+	test_compressstream_declare,
+	test_compressstream_initialize,
+	test_compressstream_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_compressstream_run(void);
+
+int
+test_compressstream_run(void) {
+	test_suite = test_compressstream_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_compressstream_suite;
+}
+
+#endif
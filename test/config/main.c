@@ -63,6 +63,8 @@ static foundation_config_t
 test_config_config(void) {
 	foundation_config_t config;
 	memset(&config, 0, sizeof(config));
+	config.config_cache = true;
+	config.config_monitor = true;
 	return config;
 }
 
@@ -1131,6 +1133,340 @@ DECLARE_TEST(config, readwrite) {
 	return 0;
 }
 
+DECLARE_TEST(config, handles) {
+	hash_t section = hash(STRING_CONST("handles"));
+	hash_t key = hash(STRING_CONST("value"));
+	config_key_handle_t* handle;
+	config_key_handle_t* variable;
+	uint32_t version;
+	int ikey;
+
+	handle = config_key_handle(section, key);
+	EXPECT_NE(handle, 0);
+	EXPECT_EQ(config_key_handle(section, key), handle);
+	EXPECT_NE(config_key_handle(hash(STRING_CONST("other")), key), handle);
+	EXPECT_FALSE(config_handle_bool(handle));
+	EXPECT_EQ(config_handle_int(handle), 0);
+	EXPECT_CONSTSTRINGEQ(config_handle_string(handle), string_empty());
+	version = config_handle_version(handle);
+
+	config_set_int(section, key, 1234);
+	EXPECT_NE(config_handle_version(handle), version);
+	version = config_handle_version(handle);
+	EXPECT_TRUE(config_handle_bool(handle));
+	EXPECT_EQ(config_handle_int(handle), 1234);
+	EXPECT_REALEQ(config_handle_real(handle), REAL_C(1234.0));
+	EXPECT_CONSTSTRINGEQ(config_handle_string(handle), string_const(STRING_CONST("1234")));
+
+	//Other keys moving the value in the repository do not change the version
+	for (ikey = 0; ikey < 64; ++ikey)
+		config_set_int(section, (hash_t)ikey, ikey);
+	EXPECT_EQ(config_handle_version(handle), version);
+	EXPECT_EQ(config_handle_int(handle), 1234);
+
+	config_set_string(section, key, STRING_CONST("false"));
+	EXPECT_NE(config_handle_version(handle), version);
+	EXPECT_FALSE(config_handle_bool(handle));
+	EXPECT_CONSTSTRINGEQ(config_handle_string(handle), string_const(STRING_CONST("false")));
+
+	config_set_bool(section, key, true);
+	EXPECT_EQ(config_handle_int(handle), 1);
+	EXPECT_CONSTSTRINGEQ(config_handle_string(handle), string_const(STRING_CONST("true")));
+
+	//Handle to a key already set
+	config_set_int(section, hash(STRING_CONST("seven")), 7);
+	config_set_string(section, hash(STRING_CONST("variable")), STRING_CONST("$(value) and $(seven)"));
+	variable = config_key_handle(section, hash(STRING_CONST("variable")));
+	EXPECT_CONSTSTRINGEQ(config_handle_string(variable), string_const(STRING_CONST("true and 7")));
+	EXPECT_CONSTSTRINGEQ(config_handle_string(variable),
+	                     config_string(section, hash(STRING_CONST("variable"))));
+
+	return 0;
+}
+
+static atomic32_t _test_config_running;
+static atomic32_t _test_config_fail;
+
+static void*
+config_reader_thread(void* arg) {
+	hash_t section = hash(STRING_CONST("concurrent"));
+	hash_t counter = hash(STRING_CONST("counter"));
+	hash_t variable = hash(STRING_CONST("variable"));
+	config_key_handle_t* handle = config_key_handle(section, counter);
+	int64_t last = 0;
+	FOUNDATION_UNUSED(arg);
+	while (atomic_load32(&_test_config_running)) {
+		int64_t handle_value, value, strvalue, varvalue;
+		string_const_t str;
+		config_read_begin();
+		handle_value = config_handle_int(handle);
+		value = config_int(section, counter);
+		str = config_string(section, counter);
+		strvalue = string_to_int64(STRING_ARGS(str));
+		varvalue = config_int(section, variable);
+		config_read_end();
+		//Values only grow, and the string was read after the integer
+		if ((handle_value < last) || (value < handle_value) || (strvalue < value) || (varvalue < 0))
+			atomic_incr32(&_test_config_fail);
+		last = handle_value;
+		thread_yield();
+	}
+	return 0;
+}
+
+DECLARE_TEST(config, threads) {
+	thread_t thread[8];
+	size_t num_threads = math_clamp(system_hardware_threads(), 2, 8);
+	hash_t section = hash(STRING_CONST("concurrent"));
+	hash_t counter = hash(STRING_CONST("counter"));
+	size_t i;
+	int64_t value;
+
+	config_set_int(section, counter, 0);
+	config_set_string(section, hash(STRING_CONST("variable")),
+	                  STRING_CONST("$(counter)"));
+	atomic_store32(&_test_config_running, 1);
+	atomic_store32(&_test_config_fail, 0);
+
+	for (i = 0; i < num_threads; ++i)
+		thread_initialize(&thread[i], config_reader_thread, 0, STRING_CONST("config"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	for (i = 0; i < num_threads; ++i)
+		thread_start(&thread[i]);
+	test_wait_for_threads_startup(thread, num_threads);
+
+	//Update the value and add keys growing the buckets while readers are running
+	for (value = 1; value <= 2000; ++value) {
+		char name[32];
+		string_t keyname = string_format(name, sizeof(name), STRING_CONST("key%d"), (int)value);
+		config_set_int(section, counter, value);
+		config_set_int(section, hash(STRING_ARGS(keyname)), value);
+	}
+
+	atomic_store32(&_test_config_running, 0);
+	test_wait_for_threads_finish(thread, num_threads);
+	for (i = 0; i < num_threads; ++i)
+		thread_finalize(&thread[i]);
+
+	EXPECT_EQ(atomic_load32(&_test_config_fail), 0);
+	EXPECT_EQ(config_int(section, counter), 2000);
+	EXPECT_EQ(config_int(section, hash(STRING_CONST("variable"))), 2000);
+	EXPECT_EQ(config_int(section, hash(STRING_CONST("key1234"))), 1234);
+
+	return 0;
+}
+
+DECLARE_TEST(config, retire) {
+	hash_t section = hash(STRING_CONST("retire"));
+	hash_t key = hash(STRING_CONST("value"));
+	hash_t strkey = hash(STRING_CONST("string"));
+	int64_t value;
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	memory_statistics_t oldstats, newstats;
+
+	memory_set_tracker(memory_tracker_local());
+#endif
+
+	//Warm up the section so the baseline includes the live storage
+	config_set_int(section, key, 0);
+	config_set_string(section, strkey, STRING_CONST("$(value)"));
+	EXPECT_EQ(config_int(section, strkey), 0);
+
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	oldstats = memory_statistics();
+#endif
+
+	//Replaced storage must be reclaimed, not accumulated until finalization
+	for (value = 1; value <= 100000; ++value) {
+		config_set_int(section, key, value);
+		EXPECT_EQ(config_int(section, strkey), value);
+	}
+
+#if BUILD_ENABLE_MEMORY_TRACKER && BUILD_ENABLE_MEMORY_STATISTICS
+	newstats = memory_statistics();
+	EXPECT_SIZELT(newstats.allocated_current, oldstats.allocated_current + 256 * 1024);
+#endif
+
+	config_read_begin();
+	config_read_begin();
+	EXPECT_EQ(config_int(section, key), 100000);
+	config_read_end();
+	EXPECT_EQ(config_int(section, strkey), 100000);
+	config_read_end();
+
+	return 0;
+}
+
+DECLARE_TEST(config, cache) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	char cache_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_t cachepath;
+	string_const_t directory;
+	string_t* files;
+	stream_t* stream;
+	hash_t section = HASH_TEST;
+	hash_t key_int = hash(STRING_CONST("cache_int"));
+	hash_t key_real = hash(STRING_CONST("cache_real"));
+	hash_t key_bool = hash(STRING_CONST("cache_bool"));
+	hash_t key_string = hash(STRING_CONST("cache_string"));
+	hash_t key_variable = hash(STRING_CONST("cache_variable"));
+	hash_t key_new = hash(STRING_CONST("cache_new"));
+
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	path = string_append(STRING_ARGS(path), sizeof(path_buffer), STRING_CONST(".ini"));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	cachepath = string_concat_varg(cache_buffer, sizeof(cache_buffer),
+	                               STRING_ARGS(environment_home_directory()), STRING_CONST("/."),
+	                               STRING_ARGS(environment_application()->config_dir),
+	                               STRING_CONST("/cache"), nullptr);
+	fs_remove_directory(STRING_ARGS(cachepath));
+
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	stream_write_string(stream, STRING_CONST("[test]\ncache_int=42\ncache_real=1.5\n"
+	                                         "cache_bool=true\ncache_string=cached value\n"
+	                                         "cache_variable=$(cache_string)\n"));
+	stream_deallocate(stream);
+
+	config_load_file(STRING_ARGS(path), 0, true);
+	EXPECT_INTEQ(config_int(section, key_int), 42);
+	EXPECT_REALEQ(config_real(section, key_real), REAL_C(1.5));
+	EXPECT_TRUE(config_bool(section, key_bool));
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_string),
+	                     string_const(STRING_CONST("cached value")));
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_variable),
+	                     string_const(STRING_CONST("cached value")));
+
+	files = fs_matching_files(STRING_ARGS(cachepath), STRING_CONST("^.*\\.cfgcache$"), false);
+	EXPECT_SIZEEQ(array_size(files), 1);
+	string_array_deallocate(files);
+
+	//Load again from the cache
+	config_set_int(section, key_int, 0);
+	config_set_string(section, key_string, STRING_CONST("changed"));
+	config_load_file(STRING_ARGS(path), 0, false);
+	EXPECT_INTEQ(config_int(section, key_int), 0);
+	config_load_file(STRING_ARGS(path), 0, true);
+	EXPECT_INTEQ(config_int(section, key_int), 42);
+	EXPECT_REALEQ(config_real(section, key_real), REAL_C(1.5));
+	EXPECT_TRUE(config_bool(section, key_bool));
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_string),
+	                     string_const(STRING_CONST("cached value")));
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_variable),
+	                     string_const(STRING_CONST("cached value")));
+
+	//Modified source invalidates the cache
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	stream_write_string(stream, STRING_CONST("[test]\ncache_int=4711\ncache_new=false\n"));
+	stream_deallocate(stream);
+
+	config_set_bool(section, key_new, true);
+	config_load_file(STRING_ARGS(path), 0, true);
+	EXPECT_INTEQ(config_int(section, key_int), 4711);
+	EXPECT_FALSE(config_bool(section, key_new));
+
+	files = fs_matching_files(STRING_ARGS(cachepath), STRING_CONST("^.*\\.cfgcache$"), false);
+	EXPECT_SIZEEQ(array_size(files), 1);
+	string_array_deallocate(files);
+
+	fs_remove_file(STRING_ARGS(path));
+	fs_remove_directory(STRING_ARGS(cachepath));
+
+	return 0;
+}
+
+static size_t
+test_config_process_events(const string_const_t path, config_change_t* changes, size_t capacity) {
+	event_block_t* block;
+	event_t* event;
+	size_t count = 0;
+
+	fs_post_event(FOUNDATIONEVENT_FILE_MODIFIED, STRING_ARGS(path));
+	block = event_stream_process(fs_event_stream());
+	event = event_next(block, 0);
+	while (event) {
+		config_process_event(event);
+		event = event_next(block, event);
+	}
+
+	block = event_stream_process(config_event_stream());
+	event = event_next(block, 0);
+	while (event) {
+		const config_event_payload_t* payload = (const config_event_payload_t*)event->payload;
+		size_t ichange;
+		if (event->id == FOUNDATIONEVENT_CONFIG_CHANGED) {
+			for (ichange = 0; (ichange < payload->count) && (count < capacity); ++ichange)
+				changes[count++] = payload->change[ichange];
+		}
+		event = event_next(block, event);
+	}
+	return count;
+}
+
+DECLARE_TEST(config, monitor) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_const_t directory;
+	stream_t* stream;
+	event_t event;
+	config_change_t changes[8];
+	hash_t section = HASH_TEST;
+	hash_t other_section = hash(STRING_CONST("other"));
+	hash_t key_int = hash(STRING_CONST("monitor_int"));
+	hash_t key_string = hash(STRING_CONST("monitor_string"));
+	hash_t key_same = hash(STRING_CONST("monitor_same"));
+	hash_t key_new = hash(STRING_CONST("monitor_new"));
+
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	path = string_append(STRING_ARGS(path), sizeof(path_buffer), STRING_CONST(".ini"));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	stream_write_string(stream, STRING_CONST("[test]\nmonitor_int=1\nmonitor_string=first\n"
+	                                         "monitor_same=unchanged\n"));
+	stream_deallocate(stream);
+
+	config_load_file(STRING_ARGS(path), 0, true);
+	EXPECT_INTEQ(config_int(section, key_int), 1);
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_string), string_const(STRING_CONST("first")));
+
+	//Unchanged file posts no change event
+	EXPECT_SIZEEQ(test_config_process_events(string_to_const(path), changes, 8), 0);
+
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	stream_write_string(stream, STRING_CONST("[test]\nmonitor_int=2\nmonitor_string=second\n"
+	                                         "monitor_same=unchanged\n[other]\nmonitor_new=true\n"));
+	stream_deallocate(stream);
+
+	EXPECT_SIZEEQ(test_config_process_events(string_to_const(path), changes, 8), 3);
+	EXPECT_EQ(changes[0].section, section);
+	EXPECT_EQ(changes[0].key, key_int);
+	EXPECT_EQ(changes[1].section, section);
+	EXPECT_EQ(changes[1].key, key_string);
+	EXPECT_EQ(changes[2].section, other_section);
+	EXPECT_EQ(changes[2].key, key_new);
+	EXPECT_INTEQ(config_int(section, key_int), 2);
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_string), string_const(STRING_CONST("second")));
+	EXPECT_CONSTSTRINGEQ(config_string(section, key_same), string_const(STRING_CONST("unchanged")));
+	EXPECT_TRUE(config_bool(other_section, key_new));
+
+	//Events for other files are not processed
+	memset(&event, 0, sizeof(event));
+	event.id = FOUNDATIONEVENT_FILE_DELETED;
+	EXPECT_FALSE(config_process_event(&event));
+
+	fs_remove_file(STRING_ARGS(path));
+
+	return 0;
+}
+
 static void
 test_config_declare(void) {
 	ADD_TEST(config, builtin);
@@ -1140,6 +1476,11 @@ test_config_declare(void) {
 	ADD_TEST(config, environment);
 	ADD_TEST(config, commandline);
 	ADD_TEST(config, readwrite);
+	ADD_TEST(config, handles);
+	ADD_TEST(config, threads);
+	ADD_TEST(config, retire);
+	ADD_TEST(config, cache);
+	ADD_TEST(config, monitor);
 }
 
 static test_suite_t test_config_suite = {
@@ -25,6 +25,8 @@ static char handled_log[512];
 static log_callback_fn _global_log_callback = 0;
 #endif
 
+static char _crash_dump_path[BUILD_MAX_PATHLEN];
+
 static error_level_t _error_level_test;
 static error_t _error_test;
 
@@ -68,6 +70,7 @@ test_crash_callback(const char* dump_path, size_t length) {
 	FOUNDATION_UNUSED(length);
 #endif
 	log_infof(HASH_TEST, STRING_CONST("Crash callback called: %.*s"), (int)length, dump_path);
+	string_copy(_crash_dump_path, sizeof(_crash_dump_path), dump_path, length);
 	_crash_callback_called = true;
 }
 
@@ -110,6 +113,9 @@ thread_crash(void* arg) {
 }
 
 DECLARE_TEST(crash, assert_callback) {
+#if BUILD_ENABLE_LOG
+	const char* nonsense;
+#endif
 	EXPECT_EQ(assert_handler(), 0);
 
 	assert_set_handler(handle_assert);
@@ -146,12 +152,7 @@ DECLARE_TEST(crash, assert_callback) {
 
 	log_enable_stdout(false);
 	log_set_suppress(HASH_TEST, ERRORLEVEL_NONE);
-#if BUILD_ENABLE_DEBUG_LOG
-	log_debugf(HASH_TEST, STRING_CONST("%s"),
-#else
-	log_infof(HASH_TEST, STRING_CONST("%s"),
-#endif
-	           "To test log callback and memory handling this test will print "
+	nonsense = "To test log callback and memory handling this test will print "
 	           "a really long log line with complete nonsense. Log callbacks only occur for non-suppressed "
 	           "log levels, which is why this will be visible. However, it will not be printed to stdout. "
 	           "Lorem ipsum dolor sit amet, an quas vivendum sed, in est summo conclusionemque, an est nulla nonumy option. "
@@ -167,8 +168,12 @@ DECLARE_TEST(crash, assert_callback) {
 	           "imperdiet, mei affert probatus ut. Quo veri modus ad, solet nostrud atomorum ius ea. Everti aliquid ne usu, populo "
 	           "sapientem pro te. Persecuti definitionem qui ei, dicit dicunt ea quo. Sed minimum copiosae ei, pri dicat possit "
 	           "urbanitas eu. Tritani interesset theophrastus id sit, phaedrum facilisis his eu. Dictas accusam eu quo. Ea democritum "
-	           "consetetur vel. Iudicabit definitionem est eu, oportere temporibus at nec."
-	          );
+	           "consetetur vel. Iudicabit definitionem est eu, oportere temporibus at nec.";
+#if BUILD_ENABLE_DEBUG_LOG
+	log_debugf(HASH_TEST, STRING_CONST("%s"), nonsense);
+#else
+	log_infof(HASH_TEST, STRING_CONST("%s"), nonsense);
+#endif
 	log_set_suppress(HASH_TEST, ERRORLEVEL_DEBUG);
 	log_enable_stdout(true);
 	EXPECT_TRUE(string_find_string(handled_log, string_length(handled_log), STRING_CONST("Lorem ipsum"),
@@ -262,11 +267,71 @@ DECLARE_TEST(crash, crash_guard) {
 
 	_crash_callback_called = false;
 	log_enable_stdout(false);
+	log_enable_recorder(64 * 1024);
+	log_infof(HASH_TEST, STRING_CONST("Recorded before crash %d"), 42);
 	crash_result = crash_guard(instant_crash, 0, test_crash_callback, STRING_CONST("instant_crash"));
+	log_enable_recorder(0);
 	log_enable_stdout(true);
 	EXPECT_EQ(crash_result, FOUNDATION_CRASH_DUMP_GENERATED);
 	EXPECT_TRUE(_crash_callback_called);
 
+#if FOUNDATION_PLATFORM_POSIX
+	{
+		stream_t* stream;
+		crash_dump_header_t header;
+		uint32_t record[2];
+		size_t num_frames = 0;
+		bool has_modules = false;
+		bool has_log = false;
+		bool has_recorder = false;
+		string_const_t exe = environment_executable_path();
+
+		stream = stream_open(_crash_dump_path, string_length(_crash_dump_path),
+		                     STREAM_IN | STREAM_BINARY);
+		EXPECT_NE(stream, 0);
+		EXPECT_SIZEEQ(stream_read(stream, &header, sizeof(header)), sizeof(header));
+		EXPECT_EQ(memcmp(header.magic, "FDMP", 4), 0);
+		EXPECT_EQ(header.version, 1);
+		EXPECT_NE(header.signal, 0);
+		EXPECT_EQ(header.thread, thread_id());
+
+		while (stream_read(stream, record, sizeof(record)) == sizeof(record)) {
+			char* data = memory_allocate(0, record[1] + 1, 0, MEMORY_TEMPORARY);
+			EXPECT_SIZEEQ(stream_read(stream, data, record[1]), record[1]);
+			data[record[1]] = 0;
+			if (record[0] == CRASH_DUMP_STACKTRACE) {
+				num_frames = record[1] / sizeof(uint64_t);
+			}
+			else if ((record[0] == CRASH_DUMP_MODULES) && (record[1] > 12)) {
+				uint32_t length;
+				memcpy(&length, data + sizeof(uint64_t), sizeof(length));
+				has_modules = string_equal(data + 12, length, STRING_ARGS(exe));
+			}
+			else if (record[0] == CRASH_DUMP_LOG) {
+				has_log = (string_find_string(data, record[1],
+				                              STRING_CONST("Caught crash guard signal"), 0) != STRING_NPOS);
+			}
+			else if (record[0] == CRASH_DUMP_RECORDER) {
+				has_recorder = (string_find_string(data, record[1],
+				                                   STRING_CONST("Recorded before crash 42"), 0) != STRING_NPOS);
+			}
+			memory_deallocate(data);
+		}
+		stream_deallocate(stream);
+		fs_remove_file(_crash_dump_path, string_length(_crash_dump_path));
+
+		EXPECT_SIZEGT(num_frames, 0);
+		EXPECT_TRUE(has_modules);
+#if BUILD_ENABLE_LOG
+		EXPECT_TRUE(has_log);
+		EXPECT_TRUE(has_recorder);
+#else
+		FOUNDATION_UNUSED(has_log);
+		FOUNDATION_UNUSED(has_recorder);
+#endif
+	}
+#endif
+
 	return 0;
 }
 
@@ -13,6 +13,10 @@
 #include <foundation/foundation.h>
 #include <test/test.h>
 
+#if FOUNDATION_PLATFORM_POSIX
+#  include <foundation/posix.h>
+#endif
+
 static application_t
 test_environment_application(void) {
 	application_t app;
@@ -77,6 +81,25 @@ DECLARE_TEST(environment, builtin) {
 #if !FOUNDATION_PLATFORM_PNACL
 	EXPECT_NE(environment_variable(STRING_CONST("PATH")).str, 0);
 	EXPECT_NE(environment_variable(STRING_CONST("PATH")).length, 0);
+	//Cached value is returned on repeated queries
+	EXPECT_EQ(environment_variable(STRING_CONST("PATH")).str,
+	          environment_variable(STRING_CONST("PATH")).str);
+	EXPECT_EQ(environment_variable(STRING_CONST("FOUNDATION_UNSET_VARIABLE")).str, 0);
+	EXPECT_EQ(environment_variable(STRING_CONST("FOUNDATION_UNSET_VARIABLE")).length, 0);
+#endif
+#if FOUNDATION_PLATFORM_POSIX
+	setenv("FOUNDATION_TEST_VARIABLE", "first", 1);
+	EXPECT_CONSTSTRINGEQ(environment_variable(STRING_CONST("FOUNDATION_TEST_VARIABLE")),
+	                     string_const(STRING_CONST("first")));
+	setenv("FOUNDATION_TEST_VARIABLE", "second", 1);
+	EXPECT_CONSTSTRINGEQ(environment_variable(STRING_CONST("FOUNDATION_TEST_VARIABLE")),
+	                     string_const(STRING_CONST("first")));
+	environment_variables_invalidate();
+	EXPECT_CONSTSTRINGEQ(environment_variable(STRING_CONST("FOUNDATION_TEST_VARIABLE")),
+	                     string_const(STRING_CONST("second")));
+	unsetenv("FOUNDATION_TEST_VARIABLE");
+	environment_variables_invalidate();
+	EXPECT_EQ(environment_variable(STRING_CONST("FOUNDATION_TEST_VARIABLE")).length, 0);
 #endif
 
 	return 0;
@@ -119,6 +119,28 @@ DECLARE_TEST(error, context) {
 
 	error_context_pop();
 
+	error_context_push_static("static test", "static data");
+	error_context_push(STRING_CONST("another test"), STRING_CONST("more data"));
+	context = error_context();
+
+#if BUILD_ENABLE_ERROR_CONTEXT
+	{
+		char buffer[256];
+		EXPECT_NE(context, 0);
+		EXPECT_EQ(context->depth, 2);
+		EXPECT_CONSTSTRINGEQ(context->frame[0].name, string_const(STRING_CONST("static test")));
+		EXPECT_CONSTSTRINGEQ(context->frame[0].data, string_const(STRING_CONST("static data")));
+		EXPECT_STRINGEQ(error_context_buffer(buffer, sizeof(buffer)),
+		                string_const(STRING_CONST("When static test: static data\n"
+		                                          "When another test: more data")));
+	}
+#else
+	EXPECT_EQ(context, 0);
+#endif
+
+	error_context_pop();
+	error_context_pop();
+
 	return 0;
 }
 
@@ -245,12 +267,18 @@ static hash_t _last_log_context;
 static error_level_t _last_log_severity;
 static const char* _last_log_msg;
 static size_t _last_log_length;
+static char _last_log_buffer[512];
 
 static void
 log_verify_callback(hash_t context, error_level_t severity, const char* msg, size_t length) {
+	//Message buffer is only valid during the callback
+	if (length >= sizeof(_last_log_buffer))
+		length = sizeof(_last_log_buffer) - 1;
+	memcpy(_last_log_buffer, msg, length);
+	_last_log_buffer[length] = 0;
 	_last_log_context = context;
 	_last_log_severity = severity;
-	_last_log_msg = msg;
+	_last_log_msg = _last_log_buffer;
 	_last_log_length = length;
 }
 
@@ -423,12 +451,456 @@ DECLARE_TEST(error, output) {
 	return 0;
 }
 
+#if BUILD_ENABLE_LOG
+
+static atomic32_t _async_log_count;
+static atomic32_t _async_log_hold;
+static atomic32_t _async_log_dropped_reported;
+static atomic32_t _async_log_suppressed_reported;
+
+static void
+log_async_callback(hash_t context, error_level_t severity, const char* msg, size_t length) {
+	FOUNDATION_UNUSED(context);
+	FOUNDATION_UNUSED(severity);
+	if (string_find_string(msg, length, STRING_CONST("log messages dropped"), 0) != STRING_NPOS)
+		atomic_incr32(&_async_log_dropped_reported);
+	if (string_find_string(msg, length, STRING_CONST("Rate limit suppressed"), 0) != STRING_NPOS)
+		atomic_incr32(&_async_log_suppressed_reported);
+	atomic_incr32(&_async_log_count);
+	while (atomic_load32(&_async_log_hold))
+		thread_yield();
+}
+
+#endif
+
+DECLARE_TEST(error, async) {
+#if BUILD_ENABLE_LOG
+	log_callback_fn callback_log = log_callback();
+	int imsg;
+
+	log_set_callback(log_async_callback);
+	log_enable_stdout(false);
+
+	atomic_store32(&_async_log_count, 0);
+	log_enable_async(true, 0, true);
+	for (imsg = 0; imsg < 1000; ++imsg)
+		log_infof(HASH_TEST, STRING_CONST("Async message %d"), imsg);
+	log_flush();
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1000);
+	log_enable_async(false, 0, false);
+
+	//Hold log thread in first message, the queue then accepts capacity messages in total
+	atomic_store32(&_async_log_count, 0);
+	atomic_store32(&_async_log_hold, 1);
+	atomic_store32(&_async_log_dropped_reported, 0);
+	log_enable_async(true, 4, false);
+	for (imsg = 0; imsg < 10; ++imsg)
+		log_infof(HASH_TEST, STRING_CONST("Async message %d"), imsg);
+	EXPECT_UINTEQ(log_async_dropped(), 6);
+	atomic_store32(&_async_log_hold, 0);
+	log_flush();
+	log_enable_async(false, 0, false);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 5);
+	EXPECT_INTEQ(atomic_load32(&_async_log_dropped_reported), 1);
+	EXPECT_UINTEQ(log_async_dropped(), 0);
+
+	log_enable_stdout(true);
+	log_set_callback(callback_log);
+#endif
+	return 0;
+}
+
+DECLARE_TEST(error, binary) {
+#if BUILD_ENABLE_LOG
+	log_callback_fn callback_log = log_callback();
+	stream_t* binary = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true,
+	                                          true);
+	stream_t* text = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+	string_const_t name = string_const(STRING_CONST("binary string argument"));
+	char expected[256];
+	string_t message;
+	char* output;
+	size_t size;
+	int imsg;
+
+	log_set_callback(log_async_callback);
+	log_enable_stdout(false);
+	atomic_store32(&_async_log_count, 0);
+
+	log_set_binary_stream(binary);
+	EXPECT_EQ(log_binary_stream(), binary);
+	for (imsg = 0; imsg < 4; ++imsg)
+		log_infof(HASH_TEST, STRING_CONST("Message %d of %*d: %.*s %s %" PRIu64 " %.3f %%"), imsg, 3, 4,
+		          STRING_FORMAT(name), "terminated", (uint64_t)0x100000000ULL + (uint64_t)imsg, 1.5);
+	log_warnf(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Precision %.*s|%-5c|"), -1, "negative",
+	          'x');
+	log_errorf(HASH_TEST, ERROR_INVALID_VALUE, STRING_CONST("Pointer %p"), (void*)binary);
+	log_infof(HASH_TEST, STRING_CONST("Unsupported %Lf"), (long double)1.0);
+	log_set_binary_stream(0);
+	EXPECT_EQ(log_binary_stream(), 0);
+
+	//Only the unsupported format should be output as text
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1);
+
+	log_enable_prefix(false);
+	stream_seek(binary, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(log_binary_expand(binary, text), 6);
+	log_enable_prefix(true);
+
+	size = stream_size(text);
+	output = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT);
+	stream_seek(text, 0, STREAM_SEEK_BEGIN);
+	stream_read(text, output, size);
+	output[size] = 0;
+
+	for (imsg = 0; imsg < 4; ++imsg) {
+		message = string_format(expected, sizeof(expected),
+		                        STRING_CONST("Message %d of %*d: %.*s %s %" PRIu64 " %.3f %%\n"), imsg, 3, 4,
+		                        STRING_FORMAT(name), "terminated", (uint64_t)0x100000000ULL + (uint64_t)imsg, 1.5);
+		EXPECT_SIZENE(string_find_string(output, size, STRING_ARGS(message), 0), STRING_NPOS);
+	}
+	EXPECT_SIZENE(string_find_string(output, size,
+	                                 STRING_CONST("WARNING [suspicious]: Precision negative|x    |\n"), 0), STRING_NPOS);
+	message = string_format(expected, sizeof(expected), STRING_CONST("ERROR [invalid value]: Pointer %p\n"),
+	                        (void*)binary);
+	EXPECT_SIZENE(string_find_string(output, size, STRING_ARGS(message), 0), STRING_NPOS);
+	EXPECT_SIZEEQ(string_find_string(output, size, STRING_CONST("Unsupported"), 0), STRING_NPOS);
+
+	memory_deallocate(output);
+
+	//Records are written by the log thread in asynchronous mode
+	stream_truncate(binary, 0);
+	stream_truncate(text, 0);
+	log_enable_async(true, 0, true);
+	log_set_binary_stream(binary);
+	for (imsg = 0; imsg < 100; ++imsg)
+		log_infof(HASH_TEST, STRING_CONST("Async binary message %d"), imsg);
+	log_set_binary_stream(0);
+	log_enable_async(false, 0, false);
+	stream_seek(binary, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(log_binary_expand(binary, text), 100);
+
+	stream_deallocate(text);
+	stream_deallocate(binary);
+
+	log_enable_stdout(true);
+	log_set_callback(callback_log);
+#endif
+	return 0;
+}
+
+static void*
+recorder_thread(void* arg) {
+	log_debugf(HASH_TEST + 2, STRING_CONST("Recorder thread message %d"), (int)(uintptr_t)arg);
+	return 0;
+}
+
+DECLARE_TEST(error, recorder) {
+#if BUILD_ENABLE_LOG
+	log_callback_fn callback_log = log_callback();
+	//Test framework reports failures in the test context, use separate context
+	hash_t recorded = HASH_TEST + 2;
+	stream_t* text = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+	thread_t thread;
+	char buffer[1024];
+	string_t history;
+	char* output;
+	size_t size, offset;
+	int imsg;
+
+	log_set_callback(log_async_callback);
+	log_enable_stdout(false);
+	atomic_store32(&_async_log_count, 0);
+	log_set_suppress(recorded, ERRORLEVEL_WARNING);
+
+	EXPECT_SIZEEQ(log_recorder_size(), 0);
+	EXPECT_FALSE(log_enabled(recorded, ERRORLEVEL_INFO));
+	log_enable_recorder(1);
+	EXPECT_SIZEEQ(log_recorder_size(), 16 * 1024);
+	EXPECT_TRUE(log_enabled(recorded, ERRORLEVEL_INFO));
+
+	log_infof(recorded, STRING_CONST("Recorded %d %s %.2f"), 1, "suppressed", 2.5);
+#if BUILD_ENABLE_DEBUG_LOG
+	log_debugf(recorded, STRING_CONST("Recorded debug %" PRIu64), (uint64_t)0x100000000ULL);
+#endif
+	log_infof(recorded, STRING_CONST("Unsupported %Lf"), (long double)1.5);
+	log_errorf(recorded, ERROR_INVALID_VALUE, STRING_CONST("Recorded error %d"), 3);
+
+	thread_initialize(&thread, recorder_thread, (void*)(uintptr_t)7, STRING_CONST("recorder"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	thread_finalize(&thread);
+
+	//Only the error passes the suppression level
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1);
+
+	//Recorder also holds messages output by the test framework and thread module
+	log_enable_prefix(false);
+#if BUILD_ENABLE_DEBUG_LOG
+	EXPECT_SIZEGE(log_recorder_dump(text), 5);
+#else
+	EXPECT_SIZEGE(log_recorder_dump(text), 3);
+#endif
+	log_enable_prefix(true);
+
+	size = stream_size(text);
+	output = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT);
+	stream_seek(text, 0, STREAM_SEEK_BEGIN);
+	stream_read(text, output, size);
+	output[size] = 0;
+
+	offset = string_find_string(output, size, STRING_CONST("Recorded 1 suppressed 2.50\n"), 0);
+	EXPECT_SIZENE(offset, STRING_NPOS);
+	offset = string_find_string(output, size, STRING_CONST("Unsupported 1.500000\n"), offset);
+	EXPECT_SIZENE(offset, STRING_NPOS);
+	offset = string_find_string(output, size,
+	                            STRING_CONST("ERROR [invalid value]: Recorded error 3\n"), offset);
+	EXPECT_SIZENE(offset, STRING_NPOS);
+#if BUILD_ENABLE_DEBUG_LOG
+	EXPECT_SIZENE(string_find_string(output, size, STRING_CONST("Recorded debug 4294967296\n"), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(output, size, STRING_CONST("Recorder thread message 7\n"), 0),
+	              STRING_NPOS);
+#endif
+	memory_deallocate(output);
+
+	//Oldest messages are overwritten, history keeps the most recent complete lines
+	for (imsg = 0; imsg < 2000; ++imsg)
+		log_infof(recorded, STRING_CONST("Recorder overflow message %d"), imsg);
+	stream_truncate(text, 0);
+	EXPECT_SIZELT(log_recorder_dump(text), 1000);
+
+	history = log_recorder_history(buffer, sizeof(buffer));
+	EXPECT_SIZEGT(history.length, 0);
+	EXPECT_SIZELT(history.length, sizeof(buffer));
+	EXPECT_INTEQ(history.str[0], '[');
+	EXPECT_INTEQ(history.str[history.length - 1], '\n');
+	EXPECT_SIZENE(string_find_string(STRING_ARGS(history),
+	                                 STRING_CONST("Recorder overflow message 1999\n"), 0), STRING_NPOS);
+
+	log_enable_recorder(0);
+	EXPECT_FALSE(log_enabled(recorded, ERRORLEVEL_INFO));
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1);
+
+	stream_deallocate(text);
+	log_suppress_clear();
+	log_enable_stdout(true);
+	log_set_callback(callback_log);
+#endif
+	return 0;
+}
+
+DECLARE_TEST(error, ratelimit) {
+#if BUILD_ENABLE_LOG
+	log_callback_fn callback_log = log_callback();
+	//Test framework reports failures in the test context, use separate contexts
+	hash_t limited = HASH_TEST + 1;
+	hash_t other = HASH_TEST + 2;
+	int32_t passed;
+	int imsg;
+
+	log_set_callback(log_async_callback);
+	log_enable_stdout(false);
+
+	//Burst of 5 at 100 messages per second, a quick loop should pass only the burst
+	atomic_store32(&_async_log_count, 0);
+	log_set_rate_limit(limited, 100, 5);
+	for (imsg = 0; imsg < 100; ++imsg)
+		log_warnf(limited, WARNING_SUSPICIOUS, STRING_CONST("Rate limited %d"), imsg);
+	passed = atomic_load32(&_async_log_count);
+	EXPECT_INTGE(passed, 5);
+	EXPECT_INTLT(passed, 20);
+
+	//Other contexts are not affected
+	for (imsg = 0; imsg < 100; ++imsg)
+		log_warnf(other, WARNING_SUSPICIOUS, STRING_CONST("Not limited %d"), imsg);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), passed + 100);
+
+	//Next message passing the limit is preceded by a summary
+	thread_sleep(50);
+	atomic_store32(&_async_log_count, 0);
+	atomic_store32(&_async_log_suppressed_reported, 0);
+	log_warnf(limited, WARNING_SUSPICIOUS, STRING_CONST("Rate limited done"));
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 2);
+	EXPECT_INTEQ(atomic_load32(&_async_log_suppressed_reported), 1);
+
+	//Default limit applies to contexts without explicit limit
+	log_rate_limit_clear();
+	atomic_store32(&_async_log_count, 0);
+	log_set_rate_limit(0, 1, 1);
+	log_set_rate_limit(HASH_TEST, 0, 0);
+	for (imsg = 0; imsg < 10; ++imsg)
+		log_warnf(other, WARNING_SUSPICIOUS, STRING_CONST("Default limited %d"), imsg);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1);
+	log_rate_limit_clear();
+
+	for (imsg = 0; imsg < 10; ++imsg)
+		log_warnf(other, WARNING_SUSPICIOUS, STRING_CONST("Not limited %d"), imsg);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 11);
+
+	log_enable_stdout(true);
+	log_set_callback(callback_log);
+#endif
+	return 0;
+}
+
+#if BUILD_ENABLE_LOG
+
+static atomic32_t _log_file_rotated;
+
+static void
+log_file_rotate_callback(const char* path, size_t length) {
+	if (fs_is_file(path, length))
+		atomic_incr32(&_log_file_rotated);
+}
+
+#endif
+
+DECLARE_TEST(error, file) {
+#if BUILD_ENABLE_LOG
+	char path_buffer[BUILD_MAX_PATHLEN];
+	char rotated_buffer[BUILD_MAX_PATHLEN];
+	string_const_t temp = environment_temporary_directory();
+	string_t path = path_concat(path_buffer, sizeof(path_buffer), STRING_ARGS(temp),
+	                            STRING_CONST("error_log_file.log"));
+	string_t rotated;
+	log_file_config_t config;
+	unsigned int index;
+	int imsg;
+
+	fs_make_directory(STRING_ARGS(temp));
+	fs_remove_file(STRING_ARGS(path));
+	log_enable_stdout(false);
+
+	memset(&config, 0, sizeof(config));
+	config.buffer_size = 256;
+	EXPECT_TRUE(log_set_file(STRING_ARGS(path), &config));
+	for (imsg = 0; imsg < 100; ++imsg)
+		log_warnf(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Log file message %d"), imsg);
+	log_flush();
+	EXPECT_SIZEGT(fs_size(STRING_ARGS(path)), 100 * 30);
+
+	//Appends to existing file
+	EXPECT_TRUE(log_set_file(STRING_ARGS(path), &config));
+	log_warnf(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Log file appended"));
+	EXPECT_TRUE(log_set_file(0, 0, 0));
+	EXPECT_SIZEGT(fs_size(STRING_ARGS(path)), 101 * 30);
+	fs_remove_file(STRING_ARGS(path));
+
+	//Rotation by size on the log thread
+	atomic_store32(&_log_file_rotated, 0);
+	config.rotate_size = 1024;
+	config.rotate_count = 2;
+	config.rotate = log_file_rotate_callback;
+	config.sync = LOGFILE_SYNC_ERROR;
+	log_enable_async(true, 0, true);
+	EXPECT_TRUE(log_set_file(STRING_ARGS(path), &config));
+	for (imsg = 0; imsg < 200; ++imsg)
+		log_warnf(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Log file message %d"), imsg);
+	log_flush();
+	EXPECT_SIZELE(fs_size(STRING_ARGS(path)), 1024);
+	EXPECT_TRUE(log_set_file(0, 0, 0));
+	log_enable_async(false, 0, false);
+	EXPECT_INTGE(atomic_load32(&_log_file_rotated), 5);
+
+	for (index = 1; index <= 3; ++index) {
+		rotated = string_format(rotated_buffer, sizeof(rotated_buffer), STRING_CONST("%.*s.%u"),
+		                        STRING_FORMAT(path), index);
+		if (index <= 2) {
+			EXPECT_TRUE(fs_is_file(STRING_ARGS(rotated)));
+			EXPECT_SIZELE(fs_size(STRING_ARGS(rotated)), 1024);
+			EXPECT_SIZEGT(fs_size(STRING_ARGS(rotated)), 900);
+		}
+		else {
+			EXPECT_FALSE(fs_is_file(STRING_ARGS(rotated)));
+		}
+		fs_remove_file(STRING_ARGS(rotated));
+	}
+	fs_remove_file(STRING_ARGS(path));
+
+	log_enable_stdout(true);
+#endif
+	return 0;
+}
+
+#if BUILD_ENABLE_LOG
+
+static int _log_lazy_evaluated;
+
+static int
+log_lazy_argument(void) {
+	return ++_log_lazy_evaluated;
+}
+
+#endif
+
+DECLARE_TEST(error, lazy) {
+#if BUILD_ENABLE_LOG
+	log_callback_fn callback_log = log_callback();
+	error_level_t default_level = log_suppress(0);
+	//Test framework reports failures in the test context, use separate contexts
+	hash_t context = HASH_TEST + 1;
+	hash_t other = HASH_TEST + 2;
+
+	log_set_callback(log_async_callback);
+	log_enable_stdout(false);
+	atomic_store32(&_async_log_count, 0);
+	_log_lazy_evaluated = 0;
+
+	//Suppressed messages do not evaluate arguments
+	log_set_suppress(context, ERRORLEVEL_WARNING);
+	EXPECT_FALSE(log_enabled(context, ERRORLEVEL_INFO));
+	EXPECT_FALSE(log_enabled(context, ERRORLEVEL_WARNING));
+	EXPECT_TRUE(log_enabled(context, ERRORLEVEL_ERROR));
+	EXPECT_TRUE(log_enabled(other, ERRORLEVEL_WARNING));
+	log_infof(context, STRING_CONST("Suppressed %d"), log_lazy_argument());
+	log_warnf(context, WARNING_SUSPICIOUS, STRING_CONST("Suppressed %d"), log_lazy_argument());
+	EXPECT_INTEQ(_log_lazy_evaluated, 0);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 0);
+
+	log_warnf(other, WARNING_SUSPICIOUS, STRING_CONST("Not suppressed %d"), log_lazy_argument());
+	EXPECT_INTEQ(_log_lazy_evaluated, 1);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 1);
+
+	//Cached levels are invalidated when suppression changes
+	log_set_suppress(context, ERRORLEVEL_INFO);
+	EXPECT_TRUE(log_enabled(context, ERRORLEVEL_WARNING));
+	log_warnf(context, WARNING_SUSPICIOUS, STRING_CONST("Not suppressed %d"), log_lazy_argument());
+	EXPECT_INTEQ(_log_lazy_evaluated, 2);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 2);
+
+	log_set_suppress(0, ERRORLEVEL_WARNING);
+	EXPECT_FALSE(log_enabled(other, ERRORLEVEL_WARNING));
+	EXPECT_TRUE(log_enabled(context, ERRORLEVEL_WARNING));
+	log_warnf(other, WARNING_SUSPICIOUS, STRING_CONST("Suppressed %d"), log_lazy_argument());
+	EXPECT_INTEQ(_log_lazy_evaluated, 2);
+	log_set_suppress(0, default_level);
+
+	//Context is evaluated exactly once
+	log_warnf(context + (hash_t)log_lazy_argument() * 0, WARNING_SUSPICIOUS,
+	          STRING_CONST("Context"));
+	EXPECT_INTEQ(_log_lazy_evaluated, 3);
+	EXPECT_INTEQ(atomic_load32(&_async_log_count), 3);
+
+	log_set_suppress(context, ERRORLEVEL_NONE);
+	log_enable_stdout(true);
+	log_set_callback(callback_log);
+#endif
+	return 0;
+}
+
 static void
 test_error_declare(void) {
 	ADD_TEST(error, error);
 	ADD_TEST(error, context);
 	ADD_TEST(error, thread);
 	ADD_TEST(error, output);
+	ADD_TEST(error, async);
+	ADD_TEST(error, binary);
+	ADD_TEST(error, recorder);
+	ADD_TEST(error, ratelimit);
+	ADD_TEST(error, file);
+	ADD_TEST(error, lazy);
 }
 
 static test_suite_t test_error_suite = {
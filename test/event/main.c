@@ -571,6 +571,337 @@ DECLARE_TEST(event, delay_threaded) {
 	return 0;
 }
 
+DECLARE_TEST(event, reserve) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	char* payload;
+	tick_t current;
+
+	stream = event_stream_allocate(0);
+
+	payload = event_reserve(stream, FOUNDATIONEVENT_TERMINATE, 42, 0, 100);
+	EXPECT_NE(payload, 0);
+	memcpy(payload, "in place payload", 16);
+	event_commit(stream, payload, 16);
+
+	current = time_current();
+	payload = event_reserve(stream, FOUNDATIONEVENT_TERMINATE + 1, 0, current, 64);
+	EXPECT_NE(payload, 0);
+	memset(payload, 0xAB, 64);
+	event_commit(stream, payload, 5);
+
+	event_post(stream, FOUNDATIONEVENT_TERMINATE + 2, 0, 0, 0, 0);
+
+	block = event_stream_process(stream);
+	event = event_next(block, 0);
+	EXPECT_NE(event, 0);
+	EXPECT_EQ(event->id, FOUNDATIONEVENT_TERMINATE);
+	EXPECT_EQ(event->object, 42);
+	EXPECT_SIZEEQ(event_payload_size(event), 16);
+	EXPECT_EQ(memcmp(event->payload, "in place payload", 16), 0);
+
+	event = event_next(block, event);
+	EXPECT_NE(event, 0);
+	EXPECT_EQ(event->id, FOUNDATIONEVENT_TERMINATE + 2);
+
+	event = event_next(block, event);
+	EXPECT_NE(event, 0);
+	EXPECT_EQ(event->id, FOUNDATIONEVENT_TERMINATE + 1);
+	EXPECT_EQ(event->flags, EVENTFLAG_DELAY);
+	EXPECT_SIZEEQ(event_payload_size(event), 8);
+	EXPECT_EQ(((uint8_t*)event->payload)[4], 0xAB);
+	EXPECT_TYPEEQ(*(tick_t*)pointer_offset(event, event->size - 8), current, tick_t, PRItick);
+
+	EXPECT_EQ(event_next(block, event), 0);
+
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(event, batch) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	event_post_t post[64];
+	const uint32_t* offset;
+	beacon_t* beacon;
+	uint64_t value[64];
+	size_t ipost;
+
+	stream = event_stream_allocate(0);
+	beacon = beacon_allocate();
+	event_stream_set_beacon(stream, beacon);
+
+	for (ipost = 0; ipost < 64; ++ipost) {
+		value[ipost] = ipost * 3;
+		post[ipost].id = (int)ipost + 1;
+		post[ipost].object = (object_t)ipost;
+		post[ipost].delivery = (ipost % 8) ? 0 : time_current();
+		post[ipost].payload = value + ipost;
+		post[ipost].size = (ipost % 2) ? sizeof(uint64_t) : 0;
+	}
+	EXPECT_SIZEEQ(event_post_batch(stream, post, 0), 0);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+	EXPECT_SIZEEQ(event_post_batch(stream, post, 64), 64);
+	EXPECT_INTGE(beacon_try_wait(beacon, 0), 0);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	block = event_stream_process(stream);
+	EXPECT_SIZEEQ(event_block_count(block), 64);
+	offset = event_block_offsets(block);
+	EXPECT_NE(offset, 0);
+
+	//Offsets match iteration order, immediate events first followed by due delayed events
+	ipost = 0;
+	for (event = event_next(block, 0); event; event = event_next(block, event), ++ipost) {
+		size_t source = (size_t)event->object;
+		EXPECT_EQ(pointer_offset(block->events, offset[ipost]), event);
+		EXPECT_EQ(event->id, post[source].id);
+		EXPECT_SIZEEQ(event_payload_size(event), (source % 2) ? 8 : 0);
+		if (source % 2)
+			EXPECT_EQ(*(uint64_t*)event->payload, value[source]);
+		EXPECT_EQ((event->flags & EVENTFLAG_DELAY) ? 1 : 0, (source % 8) ? 0 : 1);
+		EXPECT_EQ((ipost < 56) ? 1 : 0, (source % 8) ? 1 : 0);
+	}
+	EXPECT_SIZEEQ(ipost, 64);
+
+	block = event_stream_process(stream);
+	EXPECT_SIZEEQ(event_block_count(block), 0);
+
+	event_stream_set_beacon(stream, 0);
+	event_stream_deallocate(stream);
+	beacon_deallocate(beacon);
+
+	return 0;
+}
+
+DECLARE_TEST(event, subscribe) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	const uint32_t* offset;
+	int low, high, wide, sub;
+	size_t ievent, count;
+	int id, value;
+
+	stream = event_stream_allocate(0);
+
+	low = event_stream_subscribe(stream, 1, 10);
+	high = event_stream_subscribe(stream, 11, 20);
+	wide = event_stream_subscribe(stream, 5, 15);
+	EXPECT_INTEQ(low, 0);
+	EXPECT_INTEQ(high, 1);
+	EXPECT_INTEQ(wide, 2);
+	event_stream_subscribe_range(stream, low, 30, 30);
+
+	for (id = 1; id <= 30; ++id)
+		event_post(stream, id, 0, 0, &id, sizeof(id));
+
+	block = event_stream_process(stream);
+	EXPECT_SIZEEQ(event_block_count(block), 30);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, low), 11);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, high), 10);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, wide), 11);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, 3), 0);
+
+	//Views are in block order and only hold events in the subscribed ranges
+	offset = event_block_subscriber_offsets(block, low);
+	for (ievent = 0; ievent < 10; ++ievent) {
+		event = pointer_offset(block->events, offset[ievent]);
+		EXPECT_INTEQ(event->id, (int)ievent + 1);
+		memcpy(&value, event->payload, sizeof(value));
+		EXPECT_INTEQ(value, (int)ievent + 1);
+	}
+	event = pointer_offset(block->events, offset[10]);
+	EXPECT_INTEQ(event->id, 30);
+	offset = event_block_subscriber_offsets(block, wide);
+	for (ievent = 0; ievent < 11; ++ievent) {
+		event = pointer_offset(block->events, offset[ievent]);
+		EXPECT_INTEQ(event->id, (int)ievent + 5);
+	}
+
+	//Removed subscriber slot is reused, wide ranges fall back to scanning routes
+	event_stream_unsubscribe(stream, high);
+	sub = event_stream_subscribe(stream, 20, 20000);
+	EXPECT_INTEQ(sub, high);
+	event_post(stream, 12, 0, 0, 0, 0);
+	event_post(stream, 20000, 0, 0, 0, 0);
+	event_post(stream, 20001, 0, 0, 0, 0);
+	block = event_stream_process(stream);
+	EXPECT_SIZEEQ(event_block_count(block), 3);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, low), 0);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, wide), 1);
+	EXPECT_SIZEEQ(event_block_subscriber_count(block, sub), 1);
+	offset = event_block_subscriber_offsets(block, sub);
+	event = pointer_offset(block->events, offset[0]);
+	EXPECT_INTEQ(event->id, 20000);
+
+	for (count = 3; count < EVENT_STREAM_SUBSCRIBERS; ++count)
+		EXPECT_INTEQ(event_stream_subscribe(stream, 1, 1), (int)count);
+	EXPECT_INTEQ(event_stream_subscribe(stream, 1, 1), -1);
+
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(event, timer) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	tick_t current, timestamp, lasttime, limit;
+	size_t ievent, delivered;
+	size_t num_events = 8 * 1024;
+	int expect_id;
+
+	stream = event_stream_allocate(0);
+	current = time_current();
+
+	//Equal timestamps are delivered in posting order, after immediate events
+	event_post(stream, 1, 0, current, 0, 0);
+	event_post(stream, 2, 0, current, 0, 0);
+	event_post(stream, 3, 0, 0, 0, 0);
+	event_post(stream, 4, 0, current, 0, 0);
+	block = event_stream_process(stream);
+	event = event_next(block, 0);
+	EXPECT_NE(event, 0);
+	EXPECT_EQ(event->id, 3);
+	for (expect_id = 1; expect_id < 5; ++expect_id) {
+		if (expect_id == 3)
+			continue;
+		event = event_next(block, event);
+		EXPECT_NE(event, 0);
+		EXPECT_EQ(event->id, expect_id);
+		EXPECT_EQ(event->flags, EVENTFLAG_DELAY);
+	}
+	EXPECT_EQ(event_next(block, event), 0);
+
+	//Many pending timers are delivered in timestamp order
+	current = time_current();
+	for (ievent = 0; ievent < num_events; ++ievent) {
+		timestamp = current + (tick_t)random64_range(0, (uint64_t)time_ticks_per_second() / 4);
+		event_post(stream, 1, (object_t)ievent, timestamp, &timestamp, sizeof(timestamp));
+	}
+
+	delivered = 0;
+	lasttime = 0;
+	limit = current + (time_ticks_per_second() * 10);
+	while ((delivered < num_events) && (time_current() < limit)) {
+		block = event_stream_process(stream);
+		current = time_current();
+		for (event = event_next(block, 0); event; event = event_next(block, event)) {
+			memcpy(&timestamp, event->payload, sizeof(timestamp));
+			EXPECT_GE(timestamp, lasttime);
+			EXPECT_LE(timestamp, current);
+			lasttime = timestamp;
+			++delivered;
+		}
+		thread_sleep(1);
+	}
+	EXPECT_SIZEEQ(delivered, num_events);
+
+	block = event_stream_process(stream);
+	EXPECT_EQ(event_next(block, 0), 0);
+
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(event, statistics) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_statistics_t statistics;
+	assert_handler_fn prev_assert_handler;
+	uint8_t buffer[128];
+	size_t iloop;
+
+	stream = event_stream_allocate(0);
+	statistics = event_stream_statistics(stream);
+	EXPECT_EQ(statistics.posted, 0);
+	EXPECT_EQ(statistics.processed_blocks, 0);
+
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, buffer, 16);
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, time_current() + time_ticks_per_second(), 0, 0);
+	block = event_stream_process(stream);
+	FOUNDATION_UNUSED(block);
+
+	statistics = event_stream_statistics(stream);
+#if BUILD_ENABLE_EVENT_STATISTICS
+	EXPECT_EQ(statistics.posted, 2);
+	EXPECT_EQ(statistics.posted_bytes, (sizeof(event_t) + 16) + (sizeof(event_t) + 8));
+	EXPECT_EQ(statistics.dropped, 0);
+	EXPECT_EQ(statistics.limit_hits, 0);
+	EXPECT_GE(statistics.reallocations, 1);
+	EXPECT_EQ(statistics.processed_blocks, 1);
+	EXPECT_EQ(statistics.processed_events, 1);
+	EXPECT_EQ(statistics.processed_bytes, sizeof(event_t) + 16);
+	EXPECT_EQ(statistics.peak_block_bytes, sizeof(event_t) + 16);
+	EXPECT_EQ(statistics.delayed_pending, 1);
+
+	//Hitting block limit is counted
+	log_enable_stdout(false);
+	prev_assert_handler = assert_handler();
+	assert_set_handler(assert_ignore_handler);
+	for (iloop = 0; iloop < 64 * 1024; ++iloop)
+		event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, buffer, sizeof(buffer));
+	assert_set_handler(prev_assert_handler);
+	log_enable_stdout(true);
+
+	statistics = event_stream_statistics(stream);
+	EXPECT_GT(statistics.dropped, 0);
+	EXPECT_EQ(statistics.dropped, statistics.limit_hits);
+	EXPECT_EQ(statistics.posted + statistics.dropped, 2 + 64 * 1024);
+#else
+	FOUNDATION_UNUSED(prev_assert_handler);
+	FOUNDATION_UNUSED(iloop);
+	EXPECT_EQ(statistics.posted, 0);
+#endif
+
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(event, beacon) {
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	beacon_t* beacon;
+	size_t count;
+
+	stream = event_stream_allocate(0);
+	beacon = beacon_allocate();
+
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, 0, 0);
+	event_stream_set_beacon(stream, beacon);
+	EXPECT_INTGE(beacon_try_wait(beacon, 0), 0);
+
+	//Beacon fires once until stream is processed
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, 0, 0);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	block = event_stream_process(stream);
+	count = 0;
+	for (event = event_next(block, 0); event; event = event_next(block, event))
+		++count;
+	EXPECT_SIZEEQ(count, 2);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, 0, 0);
+	EXPECT_INTGE(beacon_try_wait(beacon, 0), 0);
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, 0, 0, 0);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	event_stream_set_beacon(stream, 0);
+	event_stream_deallocate(stream);
+	beacon_deallocate(beacon);
+
+	return 0;
+}
+
 static void
 test_event_declare(void) {
 	ADD_TEST(event, empty);
@@ -578,6 +909,12 @@ test_event_declare(void) {
 	ADD_TEST(event, delay);
 	ADD_TEST(event, immediate_threaded);
 	ADD_TEST(event, delay_threaded);
+	ADD_TEST(event, reserve);
+	ADD_TEST(event, batch);
+	ADD_TEST(event, subscribe);
+	ADD_TEST(event, timer);
+	ADD_TEST(event, statistics);
+	ADD_TEST(event, beacon);
 }
 
 static test_suite_t test_event_suite = {
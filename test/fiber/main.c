@@ -0,0 +1,175 @@
+/* main.c  -  Foundation fiber test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_fiber_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation fiber tests"));
+	app.short_name = string_const(STRING_CONST("test_fiber"));
+	app.config_dir = string_const(STRING_CONST("test_fiber"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_fiber_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_fiber_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_fiber_initialize(void) {
+	return 0;
+}
+
+static void
+test_fiber_finalize(void) {
+}
+
+static fiber_t* fiber_main;
+static int fiber_counter;
+
+static void
+fiber_pingpong(void* arg) {
+	fiber_t** self = arg;
+	int iloop;
+	for (iloop = 0; iloop < 10; ++iloop) {
+		++fiber_counter;
+		fiber_switch(*self, fiber_main);
+	}
+}
+
+static void
+fiber_chain(void* arg) {
+	fiber_t** fiber = arg;
+	char buffer[4096];
+	//Touch stack to verify a usable stack is mapped
+	memset(buffer, (int)fiber_counter, sizeof(buffer));
+	fiber_counter += (buffer[0] == (char)fiber_counter) ? 1 : 0;
+	//Switch to next fiber in chain, last one switches back to main
+	fiber_switch(fiber[0], fiber[1] ? fiber[1] : fiber_main);
+	++fiber_counter;
+}
+
+DECLARE_TEST(fiber, basic) {
+	fiber_t* fiber;
+	int iloop;
+
+	fiber_main = fiber_allocate_thread();
+#if FOUNDATION_PLATFORM_ANDROID || FOUNDATION_PLATFORM_PNACL
+	EXPECT_EQ(fiber_main, 0);
+	return 0;
+#endif
+	EXPECT_NE(fiber_main, 0);
+
+	fiber_counter = 0;
+	fiber = fiber_allocate(fiber_pingpong, &fiber, 0);
+	EXPECT_NE(fiber, 0);
+	EXPECT_FALSE(fiber_is_finished(fiber));
+
+	for (iloop = 0; iloop < 10; ++iloop) {
+		fiber_switch(fiber_main, fiber);
+		EXPECT_INTEQ(fiber_counter, iloop + 1);
+		EXPECT_FALSE(fiber_is_finished(fiber));
+	}
+	//Fiber function returns and switches back
+	fiber_switch(fiber_main, fiber);
+	EXPECT_TRUE(fiber_is_finished(fiber));
+	EXPECT_INTEQ(fiber_counter, 10);
+
+	fiber_deallocate(fiber);
+	fiber_deallocate(fiber_main);
+	fiber_main = 0;
+	return 0;
+}
+
+DECLARE_TEST(fiber, many) {
+	fiber_t* fiber[1025];
+	size_t ifiber;
+	const size_t num_fibers = (sizeof(fiber) / sizeof(fiber[0])) - 1;
+
+	fiber_main = fiber_allocate_thread();
+#if FOUNDATION_PLATFORM_ANDROID || FOUNDATION_PLATFORM_PNACL
+	return 0;
+#endif
+
+	fiber_counter = 0;
+	fiber[num_fibers] = 0;
+	for (ifiber = 0; ifiber < num_fibers; ++ifiber) {
+		fiber[ifiber] = fiber_allocate(fiber_chain, fiber + ifiber, 16 * 1024);
+		EXPECT_NE(fiber[ifiber], 0);
+	}
+
+	//Run all fibers through the chain, then resume each to let them finish
+	fiber_switch(fiber_main, fiber[0]);
+	EXPECT_INTEQ(fiber_counter, (int)num_fibers);
+	for (ifiber = 0; ifiber < num_fibers; ++ifiber) {
+		fiber_switch(fiber_main, fiber[ifiber]);
+		EXPECT_TRUE(fiber_is_finished(fiber[ifiber]));
+	}
+	EXPECT_INTEQ(fiber_counter, 2 * (int)num_fibers);
+
+	for (ifiber = 0; ifiber < num_fibers; ++ifiber)
+		fiber_deallocate(fiber[ifiber]);
+	fiber_deallocate(fiber_main);
+	fiber_main = 0;
+	return 0;
+}
+
+static void
+test_fiber_declare(void) {
+	ADD_TEST(fiber, basic);
+	ADD_TEST(fiber, many);
+}
+
+static test_suite_t test_fiber_suite = {
+	test_fiber_application,
+	test_fiber_memory_system,
+	test_fiber_config,
+	test_fiber_declare,
+	test_fiber_initialize,
+	test_fiber_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_fiber_run(void);
+
+int
+test_fiber_run(void) {
+	test_suite = test_fiber_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_fiber_suite;
+}
+
+#endif
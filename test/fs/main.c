@@ -35,6 +35,8 @@ test_fs_config(void) {
 	foundation_config_t config;
 	memset(&config, 0, sizeof(config));
 	config.fs_monitor_max = 1;
+	config.fs_stat_cache_size = 1024;
+	config.fs_monitor_coalesce = 250;
 	return config;
 }
 
@@ -315,6 +317,15 @@ DECLARE_TEST(fs, file) {
 	fs_remove_file(STRING_ARGS(copypath));
 	EXPECT_FALSE(fs_is_file(STRING_ARGS(copypath)));
 
+	EXPECT_TRUE(fs_move_file(STRING_ARGS(testpath), STRING_ARGS(copypath)));
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(testpath)));
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(copypath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(copypath)), 15);
+	EXPECT_FALSE(fs_move_file(STRING_ARGS(testpath), STRING_ARGS(copypath)));
+	EXPECT_TRUE(fs_move_file(STRING_ARGS(copypath), STRING_ARGS(testpath)));
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(testpath)));
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(copypath)));
+
 	//This will fail on POSIX if you have write access to filesystem root
 	log_enable_stdout(false);
 	EXPECT_FALSE(fs_copy_file(STRING_ARGS(testpath), STRING_CONST("/../@;:*this/:is/;not=?a-valid<*>name")));
@@ -537,6 +548,163 @@ DECLARE_TEST(fs, query) {
 	return 0;
 }
 
+DECLARE_TEST(fs, listing) {
+	string_const_t fname;
+	string_t testpath;
+	string_t subtestpath;
+	string_t filepath;
+	fs_listing_t* listing;
+	size_t ifile, ientry;
+	size_t found_files = 0;
+	size_t found_dirs = 0;
+	char buffer[64];
+	char namebuffer[16];
+	stream_t* file;
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	testpath = path_allocate_concat(STRING_ARGS(environment_temporary_directory()), STRING_ARGS(fname));
+	subtestpath = path_allocate_concat(STRING_ARGS(testpath), STRING_CONST("subdir"));
+	fs_make_directory(STRING_ARGS(subtestpath));
+
+	memset(buffer, 0xAB, sizeof(buffer));
+	for (ifile = 0; ifile < 16; ++ifile) {
+		string_t name = string_format(namebuffer, sizeof(namebuffer), STRING_CONST("file%" PRIsize),
+		                              ifile);
+		filepath = path_allocate_concat(STRING_ARGS(testpath), STRING_ARGS(name));
+		file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_CREATE);
+		EXPECT_NE(file, 0);
+		stream_write(file, buffer, ifile * 3);
+		stream_deallocate(file);
+		string_deallocate(filepath.str);
+	}
+
+	EXPECT_EQ(fs_list_directory(STRING_CONST("/this/path/should/not/exist")), 0);
+
+	listing = fs_list_directory(STRING_ARGS(subtestpath));
+	EXPECT_NE(listing, 0);
+	EXPECT_SIZEEQ(listing->count, 0);
+	fs_listing_deallocate(listing);
+
+	listing = fs_list_directory(STRING_ARGS(testpath));
+	EXPECT_NE(listing, 0);
+	EXPECT_SIZEEQ(listing->count, 17);
+	for (ientry = 0; ientry < listing->count; ++ientry) {
+		fs_entry_t* entry = listing->entry + ientry;
+		string_t entrypath = path_allocate_concat(STRING_ARGS(testpath), STRING_ARGS(entry->name));
+		EXPECT_EQ(entry->name.str[entry->name.length], 0);
+		if (entry->type == FS_ENTRY_DIRECTORY) {
+			EXPECT_CONSTSTRINGEQ(entry->name, string_const(STRING_CONST("subdir")));
+			EXPECT_TRUE(fs_is_directory(STRING_ARGS(entrypath)));
+			EXPECT_SIZEEQ(entry->size, 0);
+			++found_dirs;
+		}
+		else {
+			EXPECT_EQ(entry->type, FS_ENTRY_FILE);
+			EXPECT_TRUE(string_equal(entry->name.str, 4, STRING_CONST("file")));
+			ifile = string_to_uint(entry->name.str + 4, entry->name.length - 4, false);
+			EXPECT_SIZEEQ(entry->size, ifile * 3);
+			EXPECT_SIZEEQ(entry->size, fs_size(STRING_ARGS(entrypath)));
+			EXPECT_TICKEQ(entry->last_modified, fs_last_modified(STRING_ARGS(entrypath)));
+			++found_files;
+		}
+		string_deallocate(entrypath.str);
+	}
+	EXPECT_SIZEEQ(found_files, 16);
+	EXPECT_SIZEEQ(found_dirs, 1);
+	fs_listing_deallocate(listing);
+
+	fs_remove_directory(STRING_ARGS(testpath));
+	string_deallocate(subtestpath.str);
+	string_deallocate(testpath.str);
+
+	return 0;
+}
+
+typedef struct {
+	atomic32_t files;
+	atomic32_t directories;
+	atomic64_t size;
+} test_walk_t;
+
+static bool
+test_walk_callback(string_const_t directory, const fs_entry_t* entry, void* arg) {
+	test_walk_t* walk = arg;
+	if (entry->type == FS_ENTRY_DIRECTORY) {
+		atomic_incr32(&walk->directories);
+		//Prune directories named "pruned"
+		return !string_equal(STRING_ARGS(entry->name), STRING_CONST("pruned"));
+	}
+	atomic_incr32(&walk->files);
+	atomic_add64(&walk->size, (int64_t)entry->size);
+	FOUNDATION_UNUSED(directory);
+	return true;
+}
+
+DECLARE_TEST(fs, walk) {
+	const char* subdirs[] = {
+		"a", "a/b", "a/b/c", "a/b/c/d", "e", "e/f", "pruned", "pruned/g", "excluded", "excluded/h"
+	};
+	string_const_t fname;
+	string_t testpath;
+	string_t subpath;
+	size_t idir, ifile;
+	test_walk_t walk;
+	task_scheduler_t* scheduler;
+	regex_t* exclude;
+	char buffer[16];
+	stream_t* file;
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	testpath = path_allocate_concat(STRING_ARGS(environment_temporary_directory()), STRING_ARGS(fname));
+
+	//Three files of 10 bytes in root and each subdirectory
+	memset(buffer, 0, sizeof(buffer));
+	for (idir = 0; idir <= sizeof(subdirs) / sizeof(subdirs[0]); ++idir) {
+		string_t dirpath = idir ? path_allocate_concat(STRING_ARGS(testpath), subdirs[idir - 1],
+		                                               string_length(subdirs[idir - 1])) :
+		                   string_clone(STRING_ARGS(testpath));
+		fs_make_directory(STRING_ARGS(dirpath));
+		for (ifile = 0; ifile < 3; ++ifile) {
+			string_t name = string_format(buffer, sizeof(buffer), STRING_CONST("file%" PRIsize), ifile);
+			subpath = path_allocate_concat(STRING_ARGS(dirpath), STRING_ARGS(name));
+			file = fs_open_file(STRING_ARGS(subpath), STREAM_OUT | STREAM_CREATE);
+			stream_write(file, buffer, 10);
+			stream_deallocate(file);
+			string_deallocate(subpath.str);
+		}
+		string_deallocate(dirpath.str);
+	}
+
+	exclude = regex_compile(STRING_CONST("^excluded$"));
+	scheduler = task_scheduler_allocate(4, 0);
+
+	//Sequential walk, pruned directory is reported but not walked
+	memset(&walk, 0, sizeof(walk));
+	EXPECT_SIZEEQ(fs_walk(0, STRING_ARGS(testpath), 0, test_walk_callback, &walk), 9 + 27);
+	EXPECT_INTEQ(atomic_load32(&walk.directories), 9);
+	EXPECT_INTEQ(atomic_load32(&walk.files), 27);
+	EXPECT_INTEQ((int)atomic_load64(&walk.size), 270);
+
+	//Parallel walk, excluded directory is neither reported nor walked
+	memset(&walk, 0, sizeof(walk));
+	EXPECT_SIZEEQ(fs_walk(scheduler, STRING_ARGS(testpath), exclude, test_walk_callback, &walk),
+	              7 + 21);
+	EXPECT_INTEQ(atomic_load32(&walk.directories), 7);
+	EXPECT_INTEQ(atomic_load32(&walk.files), 21);
+	EXPECT_INTEQ((int)atomic_load64(&walk.size), 210);
+
+	EXPECT_SIZEEQ(fs_walk(scheduler, STRING_CONST("/this/path/should/not/exist"), 0,
+	                      test_walk_callback, &walk), 0);
+
+	task_scheduler_deallocate(scheduler);
+	regex_deallocate(exclude);
+
+	fs_remove_directory(STRING_ARGS(testpath));
+	string_deallocate(testpath.str);
+
+	return 0;
+}
+
 DECLARE_TEST(fs, event) {
 	event_stream_t* stream;
 	event_block_t* block;
@@ -570,8 +738,766 @@ DECLARE_TEST(fs, event) {
 	return 0;
 }
 
+DECLARE_TEST(fs, async) {
+	char buf[BUILD_MAX_PATHLEN];
+	char block[64][256];
+	char readblock[64][256];
+	fs_async_result_t result[16];
+	string_const_t fname;
+	string_t testpath;
+	stream_t* teststream;
+	fs_async_t* async;
+	beacon_t* beacon;
+	event_stream_t* stream;
+	event_block_t* eventblock;
+	event_t* event;
+	size_t iblock, icompleted, completed, count;
+	const size_t num_blocks = sizeof(block) / sizeof(block[0]);
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	testpath = path_concat(buf, BUILD_MAX_PATHLEN, STRING_ARGS(environment_temporary_directory()),
+	                       STRING_ARGS(fname));
+
+	if (!fs_is_directory(STRING_ARGS(environment_temporary_directory())))
+		fs_make_directory(STRING_ARGS(environment_temporary_directory()));
+
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_IN | STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(teststream, 0);
+
+	for (iblock = 0; iblock < num_blocks; ++iblock)
+		memset(block[iblock], (int)iblock + 1, sizeof(block[iblock]));
+	memset(readblock, 0, sizeof(readblock));
+
+	//Writes with completions queued on the context, signalled through the beacon
+	beacon = beacon_allocate();
+	async = fs_async_allocate(16, 0, beacon);
+	EXPECT_NE(async, 0);
+
+	for (iblock = 0; iblock < num_blocks; ++iblock) {
+		EXPECT_TRUE(fs_async_write(async, teststream, iblock * sizeof(block[0]), block[iblock],
+		                           sizeof(block[iblock]), block[iblock]));
+	}
+
+	completed = 0;
+	while (completed < num_blocks) {
+		count = fs_async_completed(async, result, sizeof(result) / sizeof(result[0]));
+		if (!count) {
+			beacon_try_wait(beacon, 100);
+			continue;
+		}
+		for (icompleted = 0; icompleted < count; ++icompleted) {
+			EXPECT_TRUE(result[icompleted].write);
+			EXPECT_EQ(result[icompleted].stream, teststream);
+			EXPECT_EQ(result[icompleted].userdata, result[icompleted].buffer);
+			EXPECT_TYPEEQ(result[icompleted].transferred, (int64_t)sizeof(block[0]), int64_t, PRId64);
+		}
+		completed += count;
+	}
+	//Results are posted before the request is released
+	while (fs_async_pending(async))
+		thread_yield();
+	EXPECT_SIZEEQ(stream_size(teststream), sizeof(block));
+	EXPECT_EQ(stream_tell(teststream), 0);
+
+	fs_async_deallocate(async);
+
+	//Reads with completions posted as events, in reverse order of offsets
+	stream = event_stream_allocate(0);
+	async = fs_async_allocate(8, stream, 0);
+
+	for (iblock = 0; iblock < num_blocks; ++iblock) {
+		size_t ireverse = num_blocks - iblock - 1;
+		EXPECT_TRUE(fs_async_read(async, teststream, ireverse * sizeof(block[0]), readblock[ireverse],
+		                          sizeof(readblock[ireverse]), (void*)(uintptr_t)ireverse));
+	}
+	//Read past end of file transfers nothing
+	EXPECT_TRUE(fs_async_read(async, teststream, sizeof(block), readblock[0], sizeof(readblock[0]),
+	                          (void*)(uintptr_t)num_blocks));
+	while (fs_async_pending(async))
+		thread_yield();
+
+	completed = 0;
+	eventblock = event_stream_process(stream);
+	event = event_next(eventblock, 0);
+	while (event) {
+		const fs_async_result_t* eventresult = (const fs_async_result_t*)event->payload;
+		EXPECT_EQ(event->id, FOUNDATIONEVENT_FILE_ASYNC_COMPLETE);
+		EXPECT_FALSE(eventresult->write);
+		if ((uintptr_t)eventresult->userdata == num_blocks) {
+			EXPECT_TYPEEQ(eventresult->transferred, (int64_t)0, int64_t, PRId64);
+		}
+		else {
+			EXPECT_EQ(eventresult->buffer, readblock[(uintptr_t)eventresult->userdata]);
+			EXPECT_TYPEEQ(eventresult->transferred, (int64_t)sizeof(block[0]), int64_t, PRId64);
+		}
+		++completed;
+		event = event_next(eventblock, event);
+	}
+	EXPECT_SIZEEQ(completed, num_blocks + 1);
+	EXPECT_EQ(memcmp(block, readblock, sizeof(block)), 0);
+
+	//Stream reads see data written asynchronously
+	EXPECT_TRUE(fs_async_write(async, teststream, 0, block[num_blocks - 1], sizeof(block[0]), 0));
+	while (fs_async_pending(async))
+		thread_yield();
+	EXPECT_SIZEEQ(stream_read(teststream, readblock[0], sizeof(readblock[0])), sizeof(readblock[0]));
+	EXPECT_EQ(memcmp(readblock[0], block[num_blocks - 1], sizeof(readblock[0])), 0);
+
+	EXPECT_FALSE(fs_async_read(async, 0, 0, readblock[0], sizeof(readblock[0]), 0));
+
+	fs_async_deallocate(async);
+	event_stream_deallocate(stream);
+	beacon_deallocate(beacon);
+
+	stream_deallocate(teststream);
+	fs_remove_file(STRING_ARGS(testpath));
+
+	return 0;
+}
+
+DECLARE_TEST(fs, asyncops) {
+	char dirbuf[BUILD_MAX_PATHLEN];
+	char filebuf[BUILD_MAX_PATHLEN];
+	char copybuf[BUILD_MAX_PATHLEN];
+	fs_async_operation_t op[4];
+	fs_async_result_t result[8];
+	string_t dirpath, filepath, copypath;
+	string_const_t fname;
+	stream_t* teststream;
+	fs_async_t* async;
+	beacon_t* beacon;
+	event_stream_t* stream;
+	event_block_t* eventblock;
+	event_t* event;
+	size_t icompleted, completed, count;
+	tick_t modified;
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	dirpath = path_concat(dirbuf, BUILD_MAX_PATHLEN, STRING_ARGS(environment_temporary_directory()),
+	                      STRING_ARGS(fname));
+	dirpath = path_append(STRING_ARGS(dirpath), BUILD_MAX_PATHLEN, STRING_CONST("nested"));
+	filepath = path_concat(filebuf, BUILD_MAX_PATHLEN, STRING_ARGS(dirpath), STRING_CONST("file"));
+	copypath = path_concat(copybuf, BUILD_MAX_PATHLEN, STRING_ARGS(dirpath), STRING_CONST("copy"));
+
+	beacon = beacon_allocate();
+	async = fs_async_allocate(2, 0, beacon);
+
+	//Invalid operations reject the entire batch
+	memset(op, 0, sizeof(op));
+	op[0].op = FS_ASYNC_STAT;
+	op[0].path = string_to_const(dirpath);
+	op[1].op = FS_ASYNC_READ;
+	op[1].path = string_to_const(filepath);
+	EXPECT_FALSE(fs_async_submit(async, op, 2));
+	op[1].op = FS_ASYNC_COPY_FILE;
+	EXPECT_FALSE(fs_async_submit(async, op, 2));
+	EXPECT_SIZEEQ(fs_async_pending(async), 0);
+
+	//Nested directory with missing parent, then stat of missing file
+	memset(op, 0, sizeof(op));
+	op[0].op = FS_ASYNC_MAKE_DIRECTORY;
+	op[0].path = string_to_const(dirpath);
+	op[0].userdata = op;
+	EXPECT_TRUE(fs_async_submit(async, op, 1));
+	op[0].op = FS_ASYNC_STAT;
+	op[0].path = string_to_const(filepath);
+	while (fs_async_pending(async))
+		beacon_try_wait(beacon, 100);
+	EXPECT_TRUE(fs_async_submit(async, op, 1));
+	while (fs_async_pending(async))
+		beacon_try_wait(beacon, 100);
+	count = fs_async_completed(async, result, sizeof(result) / sizeof(result[0]));
+	EXPECT_SIZEEQ(count, 2);
+	EXPECT_EQ(result[0].op, FS_ASYNC_MAKE_DIRECTORY);
+	EXPECT_EQ(result[0].userdata, op);
+	EXPECT_EQ(result[0].stream, 0);
+	EXPECT_TYPEEQ(result[0].transferred, (int64_t)0, int64_t, PRId64);
+	EXPECT_EQ(result[1].op, FS_ASYNC_STAT);
+	EXPECT_TYPELT(result[1].transferred, (int64_t)0, int64_t, PRId64);
+	EXPECT_TRUE(fs_is_directory(STRING_ARGS(dirpath)));
+
+	//Touch existing file, then copy and stat in a batch larger than the request pool
+	teststream = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(teststream, 0);
+	stream_write(teststream, "data", 4);
+	stream_deallocate(teststream);
+
+	op[0].op = FS_ASYNC_TOUCH;
+	op[0].path = string_to_const(filepath);
+	EXPECT_TRUE(fs_async_submit(async, op, 1));
+	while (fs_async_pending(async))
+		beacon_try_wait(beacon, 100);
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(filepath)));
+	modified = fs_last_modified(STRING_ARGS(filepath));
+
+	memset(op, 0, sizeof(op));
+	op[0].op = FS_ASYNC_COPY_FILE;
+	op[0].path = string_to_const(filepath);
+	op[0].destination = string_to_const(copypath);
+	op[1].op = FS_ASYNC_STAT;
+	op[1].path = string_to_const(filepath);
+	op[2].op = FS_ASYNC_STAT;
+	op[2].path = string_to_const(dirpath);
+	op[3].op = FS_ASYNC_MAKE_DIRECTORY;
+	op[3].path = string_to_const(dirpath);
+	EXPECT_TRUE(fs_async_submit(async, op, 4));
+
+	completed = 0;
+	while (completed < 4) {
+		count = fs_async_completed(async, result, sizeof(result) / sizeof(result[0]));
+		if (!count) {
+			beacon_try_wait(beacon, 100);
+			continue;
+		}
+		for (icompleted = 0; icompleted < count; ++icompleted) {
+			EXPECT_TYPEEQ(result[icompleted].transferred, (int64_t)0, int64_t, PRId64);
+			if (result[icompleted].op != FS_ASYNC_STAT)
+				continue;
+			if (result[icompleted].type == FS_ENTRY_FILE) {
+				EXPECT_SIZEEQ(result[icompleted].size, 4);
+				EXPECT_TYPEEQ(result[icompleted].last_modified / 1000, modified / 1000, tick_t, PRId64);
+			}
+			else {
+				EXPECT_EQ(result[icompleted].type, FS_ENTRY_DIRECTORY);
+			}
+		}
+		completed += count;
+	}
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(copypath)));
+
+	fs_async_deallocate(async);
+	beacon_deallocate(beacon);
+
+	//Removal with completions posted as events
+	stream = event_stream_allocate(0);
+	async = fs_async_allocate(0, stream, 0);
+	memset(op, 0, sizeof(op));
+	op[0].op = FS_ASYNC_REMOVE_FILE;
+	op[0].path = string_to_const(filepath);
+	op[1].op = FS_ASYNC_REMOVE_FILE;
+	op[1].path = string_to_const(copypath);
+	EXPECT_TRUE(fs_async_submit(async, op, 2));
+	while (fs_async_pending(async))
+		thread_yield();
+
+	completed = 0;
+	eventblock = event_stream_process(stream);
+	event = event_next(eventblock, 0);
+	while (event) {
+		const fs_async_result_t* eventresult = (const fs_async_result_t*)event->payload;
+		EXPECT_EQ(event->id, FOUNDATIONEVENT_FILE_ASYNC_COMPLETE);
+		EXPECT_EQ(eventresult->op, FS_ASYNC_REMOVE_FILE);
+		EXPECT_TYPEEQ(eventresult->transferred, (int64_t)0, int64_t, PRId64);
+		++completed;
+		event = event_next(eventblock, event);
+	}
+	EXPECT_SIZEEQ(completed, 2);
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(filepath)));
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(copypath)));
+
+	fs_async_deallocate(async);
+	event_stream_deallocate(stream);
+
+	fs_remove_directory(STRING_ARGS(path_directory_name(STRING_ARGS(dirpath))));
+	EXPECT_FALSE(fs_is_directory(STRING_ARGS(dirpath)));
+
+	return 0;
+}
+
+DECLARE_TEST(fs, mmap) {
+	char buf[BUILD_MAX_PATHLEN];
+	char url[BUILD_MAX_PATHLEN];
+	char block[1024];
+	char readblock[256];
+	string_const_t fname;
+	string_t testpath;
+	string_t testurl;
+	stream_t* teststream;
+	stream_t* mapstream;
+	stream_t* clonestream;
+	const void* data;
+	size_t size, iblock;
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	testpath = path_concat(buf, BUILD_MAX_PATHLEN, STRING_ARGS(environment_temporary_directory()),
+	                       STRING_ARGS(fname));
+
+	if (!fs_is_directory(STRING_ARGS(environment_temporary_directory())))
+		fs_make_directory(STRING_ARGS(environment_temporary_directory()));
+
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE(teststream, 0);
+	for (iblock = 0; iblock < sizeof(block); ++iblock)
+		block[iblock] = (char)(iblock * 7);
+	EXPECT_SIZEEQ(stream_write(teststream, block, sizeof(block)), sizeof(block));
+	stream_deallocate(teststream);
+
+	//Mapped streams must be readable
+	EXPECT_EQ(fs_map_file(STRING_ARGS(testpath), STREAM_OUT), 0);
+
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_POSIX
+	mapstream = fs_map_file(STRING_ARGS(testpath), STREAM_IN | STREAM_BINARY);
+	EXPECT_NE(mapstream, 0);
+	data = fs_mapped_data(mapstream, &size);
+	EXPECT_NE(data, 0);
+	EXPECT_SIZEEQ(size, sizeof(block));
+	EXPECT_EQ(memcmp(data, block, sizeof(block)), 0);
+	fs_map_advise(mapstream, FS_MAP_ADVICE_SEQUENTIAL);
+	stream_advise(mapstream, STREAM_ADVICE_WILLNEED, 100, 200);
+
+	EXPECT_SIZEEQ(stream_size(mapstream), sizeof(block));
+	EXPECT_SIZEEQ(stream_read(mapstream, readblock, sizeof(readblock)), sizeof(readblock));
+	EXPECT_EQ(memcmp(readblock, block, sizeof(readblock)), 0);
+	EXPECT_SIZEEQ(stream_tell(mapstream), sizeof(readblock));
+	stream_seek(mapstream, -16, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_available_read(mapstream), 16);
+	EXPECT_SIZEEQ(stream_read(mapstream, readblock, sizeof(readblock)), 16);
+	EXPECT_EQ(memcmp(readblock, block + sizeof(block) - 16, 16), 0);
+	EXPECT_TRUE(stream_eos(mapstream));
+	EXPECT_SIZEEQ(stream_write(mapstream, block, 16), 0);
+	EXPECT_NE(stream_last_modified(mapstream), 0);
+
+	clonestream = stream_clone(mapstream);
+	EXPECT_NE(clonestream, 0);
+	EXPECT_EQ(memcmp(fs_mapped_data(clonestream, 0), block, sizeof(block)), 0);
+	stream_deallocate(clonestream);
+	stream_deallocate(mapstream);
+
+	//Copy-on-write mapping modifies private pages, never the file
+	mapstream = fs_map_file(STRING_ARGS(testpath), STREAM_IN | STREAM_OUT | STREAM_BINARY);
+	EXPECT_NE(mapstream, 0);
+	stream_seek(mapstream, 10, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_write(mapstream, readblock, 16), 16);
+	memset((void*)(uintptr_t)fs_mapped_data(mapstream, 0), 0xFF, 4);
+	stream_seek(mapstream, -8, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_write(mapstream, block, 16), 8);
+	data = fs_mapped_data(mapstream, &size);
+	EXPECT_SIZEEQ(size, sizeof(block));
+	EXPECT_UINTEQ((unsigned int)((const uint8_t*)data)[0], 0xFF);
+	EXPECT_EQ(memcmp(pointer_offset_const(data, 10), readblock, 16), 0);
+	EXPECT_EQ(memcmp(pointer_offset_const(data, sizeof(block) - 8), block, 8), 0);
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_IN | STREAM_BINARY);
+	EXPECT_SIZEEQ(stream_read(teststream, readblock, sizeof(readblock)), sizeof(readblock));
+	EXPECT_EQ(memcmp(readblock, block, sizeof(readblock)), 0);
+	stream_deallocate(teststream);
+	stream_deallocate(mapstream);
+
+	//Protocol handler
+	testurl = string_copy(url, sizeof(url), STRING_CONST("mmap://"));
+	testurl = string_append(STRING_ARGS(testurl), sizeof(url), STRING_ARGS(testpath));
+	mapstream = stream_open(STRING_ARGS(testurl), STREAM_IN);
+	EXPECT_NE(mapstream, 0);
+	fs_map_advise(mapstream, FS_MAP_ADVICE_RANDOM);
+	EXPECT_UINTEQ(stream_read_uint8(mapstream), (unsigned int)(uint8_t)block[0]);
+	EXPECT_NE(fs_mapped_data(mapstream, &size), 0);
+	EXPECT_SIZEEQ(size, sizeof(block));
+	stream_deallocate(mapstream);
+
+	//Empty file maps to no data
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_OUT | STREAM_TRUNCATE);
+	stream_deallocate(teststream);
+	mapstream = fs_map_file(STRING_ARGS(testpath), STREAM_IN);
+	EXPECT_NE(mapstream, 0);
+	EXPECT_EQ(fs_mapped_data(mapstream, &size), 0);
+	EXPECT_SIZEEQ(size, 0);
+	EXPECT_TRUE(stream_eos(mapstream));
+	stream_deallocate(mapstream);
+#else
+	FOUNDATION_UNUSED(mapstream);
+	FOUNDATION_UNUSED(data);
+	FOUNDATION_UNUSED(clonestream);
+	FOUNDATION_UNUSED(readblock);
+	FOUNDATION_UNUSED(url);
+	FOUNDATION_UNUSED(testurl);
+#endif
+
+	//Not a file stream
+	EXPECT_EQ(fs_mapped_data(0, &size), 0);
+	EXPECT_EQ(fs_map_file(STRING_CONST("mmap:///this/path/does/not/exist"), STREAM_IN), 0);
+
+	fs_remove_file(STRING_ARGS(testpath));
+
+	return 0;
+}
+
+DECLARE_TEST(fs, checksum) {
+	string_const_t fname;
+	string_t path[3];
+	string_const_t paths[3];
+	uint64_t checksums[3];
+	uint128_t digests[3];
+	uint64_t leaf[4];
+	uint8_t* block;
+	stream_t* teststream;
+	task_scheduler_t* scheduler;
+	md5_t md5;
+	size_t size, ileaf, ipath;
+
+	size = (1024 * 1024 * 7) / 2;
+	block = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	for (ipath = 0; ipath < size; ++ipath)
+		block[ipath] = (uint8_t)((ipath * 13) ^ (ipath >> 11));
+
+	for (ipath = 0; ipath < 3; ++ipath) {
+		fname = string_from_uint_static(random64(), true, 0, 0);
+		path[ipath] = path_allocate_concat(STRING_ARGS(environment_temporary_directory()),
+		                                   STRING_ARGS(fname));
+		paths[ipath] = string_to_const(path[ipath]);
+	}
+
+	teststream = fs_open_file(STRING_ARGS(path[0]), STREAM_OUT | STREAM_BINARY | STREAM_CREATE);
+	stream_write(teststream, block, size);
+	stream_deallocate(teststream);
+	teststream = fs_open_file(STRING_ARGS(path[1]), STREAM_OUT | STREAM_BINARY | STREAM_CREATE);
+	stream_write(teststream, STRING_CONST("foobar barfoo"));
+	stream_deallocate(teststream);
+
+	//Chunk checksums hashed into root checksum
+	for (ileaf = 0; ileaf < 4; ++ileaf) {
+		size_t offset = ileaf * 1024 * 1024;
+		leaf[ileaf] = byteorder_littleendian64(checksum(CHECKSUM_XXHASH64, block + offset,
+		                                                (ileaf < 3) ? (1024 * 1024) : (size - offset)));
+	}
+
+	EXPECT_UINTEQ(fs_checksum(0, STRING_ARGS(path[0]), CHECKSUM_XXHASH64),
+	              checksum(CHECKSUM_XXHASH64, leaf, sizeof(leaf)));
+	EXPECT_UINTEQ(fs_checksum(0, STRING_ARGS(path[1]), CHECKSUM_CRC32C),
+	              checksum(CHECKSUM_CRC32C, STRING_CONST("foobar barfoo")));
+	EXPECT_UINTEQ(fs_checksum(0, STRING_ARGS(path[2]), CHECKSUM_CRC32C), 0);
+
+	md5_initialize(&md5);
+	md5_digest(&md5, block, size);
+	md5_digest_finalize(&md5);
+	EXPECT_TRUE(uint128_equal(md5_get_digest_raw(&md5), fs_md5(STRING_ARGS(path[0]))));
+	md5_finalize(&md5);
+
+	//Result does not depend on scheduler
+	scheduler = task_scheduler_allocate(4, 0);
+	EXPECT_UINTEQ(fs_checksum(scheduler, STRING_ARGS(path[0]), CHECKSUM_XXHASH64),
+	              checksum(CHECKSUM_XXHASH64, leaf, sizeof(leaf)));
+
+	fs_checksum_files(scheduler, paths, 3, CHECKSUM_XXHASH64, checksums);
+	EXPECT_UINTEQ(checksums[0], fs_checksum(0, STRING_ARGS(path[0]), CHECKSUM_XXHASH64));
+	EXPECT_UINTEQ(checksums[1], checksum(CHECKSUM_XXHASH64, STRING_CONST("foobar barfoo")));
+	EXPECT_UINTEQ(checksums[2], 0);
+
+	fs_md5_files(scheduler, paths, 3, digests);
+	EXPECT_TRUE(uint128_equal(digests[0], fs_md5(STRING_ARGS(path[0]))));
+	EXPECT_TRUE(uint128_equal(digests[1], fs_md5(STRING_ARGS(path[1]))));
+	EXPECT_TRUE(uint128_is_null(digests[2]));
+	task_scheduler_deallocate(scheduler);
+
+	fs_checksum_files(0, paths, 3, CHECKSUM_CRC32C, checksums);
+	EXPECT_UINTEQ(checksums[1], checksum(CHECKSUM_CRC32C, STRING_CONST("foobar barfoo")));
+	EXPECT_UINTEQ(checksums[2], 0);
+
+	fs_md5_files(0, paths + 1, 2, digests);
+	EXPECT_TRUE(uint128_equal(digests[0], fs_md5(STRING_ARGS(path[1]))));
+	EXPECT_TRUE(uint128_is_null(digests[1]));
+
+	for (ipath = 0; ipath < 3; ++ipath) {
+		fs_remove_file(STRING_ARGS(path[ipath]));
+		string_deallocate(path[ipath].str);
+	}
+	memory_deallocate(block);
+
+	return 0;
+}
+
+DECLARE_TEST(fs, prefetch) {
+	char buf[BUILD_MAX_PATHLEN];
+	string_const_t fname;
+	string_t testpath;
+	stream_t* teststream;
+	stream_t* clonestream;
+	stream_t* bufferedstream;
+	uint32_t* block;
+	uint32_t* readblock;
+	size_t iblock, ivalue;
+	size_t block_count = 64;
+	size_t block_values = 16 * 1024;
+	size_t block_size = block_values * sizeof(uint32_t);
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	testpath = path_concat(buf, BUILD_MAX_PATHLEN, STRING_ARGS(environment_temporary_directory()),
+	                       STRING_ARGS(fname));
+
+	if (!fs_is_directory(STRING_ARGS(environment_temporary_directory())))
+		fs_make_directory(STRING_ARGS(environment_temporary_directory()));
+
+	block = memory_allocate(0, block_size, 0, MEMORY_PERSISTENT);
+	readblock = memory_allocate(0, block_size, 0, MEMORY_PERSISTENT);
+
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE |
+	                          STREAM_BINARY);
+	EXPECT_NE(teststream, 0);
+	for (iblock = 0; iblock < block_count; ++iblock) {
+		for (ivalue = 0; ivalue < block_values; ++ivalue)
+			block[ivalue] = (uint32_t)((iblock * block_values) + ivalue);
+		EXPECT_SIZEEQ(stream_write(teststream, block, block_size), block_size);
+	}
+	stream_advise(teststream, STREAM_ADVICE_DONTNEED, 0, 0);
+	stream_deallocate(teststream);
+
+	//Hints are kept in stream mode and used by clones
+	teststream = fs_open_file(STRING_ARGS(testpath), STREAM_IN | STREAM_BINARY |
+	                          STREAM_HINT_SEQUENTIAL);
+	EXPECT_NE(teststream, 0);
+	EXPECT_UINTEQ(teststream->mode & STREAM_HINT_SEQUENTIAL, STREAM_HINT_SEQUENTIAL);
+	clonestream = stream_clone(teststream);
+	EXPECT_NE(clonestream, 0);
+	EXPECT_UINTEQ(clonestream->mode & STREAM_HINT_SEQUENTIAL, STREAM_HINT_SEQUENTIAL);
+	stream_deallocate(clonestream);
+
+	//Prefetching does not change data read or stream position
+	stream_advise(teststream, STREAM_ADVICE_WILLNEED, 0, block_size * 4);
+	fs_prefetch(teststream, block_size * 8);
+	for (iblock = 0; iblock < block_count; ++iblock) {
+		EXPECT_SIZEEQ(stream_read(teststream, readblock, block_size), block_size);
+		EXPECT_UINTEQ(readblock[0], (uint32_t)(iblock * block_values));
+		EXPECT_UINTEQ(readblock[block_values - 1], (uint32_t)(((iblock + 1) * block_values) - 1));
+		EXPECT_SIZEEQ(stream_tell(teststream), (iblock + 1) * block_size);
+	}
+	EXPECT_SIZEEQ(stream_read(teststream, readblock, block_size), 0);
+	EXPECT_TRUE(stream_eos(teststream));
+
+	stream_seek(teststream, (ssize_t)block_size * 3, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(teststream, readblock, block_size), block_size);
+	EXPECT_UINTEQ(readblock[0], (uint32_t)(3 * block_values));
+
+	fs_prefetch(teststream, 0);
+	stream_advise(teststream, STREAM_ADVICE_RANDOM, 0, 0);
+	EXPECT_SIZEEQ(stream_read(teststream, readblock, block_size), block_size);
+	EXPECT_UINTEQ(readblock[0], (uint32_t)(4 * block_values));
+
+	//Buffered streams forward hints, deallocating the stream stops prefetching
+	fs_prefetch(teststream, block_size);
+	bufferedstream = stream_buffered_allocate(teststream, 0, true);
+	stream_advise(bufferedstream, STREAM_ADVICE_SEQUENTIAL, 0, 0);
+	EXPECT_SIZEEQ(stream_read(bufferedstream, readblock, block_size), block_size);
+	EXPECT_UINTEQ(readblock[0], (uint32_t)(5 * block_values));
+	stream_deallocate(bufferedstream);
+
+	//Not a file stream
+	teststream = buffer_stream_allocate(0, STREAM_IN, 0, 0, true, false);
+	stream_advise(teststream, STREAM_ADVICE_WILLNEED, 0, 0);
+	fs_prefetch(teststream, block_size);
+	stream_deallocate(teststream);
+
+	memory_deallocate(block);
+	memory_deallocate(readblock);
+	fs_remove_file(STRING_ARGS(testpath));
+
+	return 0;
+}
+
+DECLARE_TEST(fs, anonymous) {
+	stream_t* stream;
+	stream_t* copy;
+	size_t size = 1024 * 1024;
+	size_t ival;
+	uint32_t* block;
+	uint32_t* readblock;
+
+	block = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	readblock = memory_allocate(0, size, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (ival = 0; ival < size / sizeof(uint32_t); ++ival)
+		block[ival] = (uint32_t)(ival * 2654435761U);
+
+	stream = fs_temporary_file_anonymous();
+	EXPECT_NE(stream, nullptr);
+	EXPECT_EQ(stream->type, STREAMTYPE_FILE);
+	EXPECT_EQ(stream_path(stream).length, 0);
+	EXPECT_TRUE(stream_is_binary(stream));
+
+	EXPECT_SIZEEQ(stream_write(stream, block, size), size);
+	EXPECT_SIZEEQ(stream_size(stream), size);
+	EXPECT_SIZEEQ(stream_tell(stream), size);
+
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, readblock, size), size);
+	EXPECT_INTEQ(memcmp(block, readblock, size), 0);
+
+	stream_truncate(stream, size / 2);
+	EXPECT_SIZEEQ(stream_size(stream), size / 2);
+	EXPECT_SIZEEQ(stream_tell(stream), size / 2);
+
+	copy = stream_clone(stream);
+	EXPECT_EQ(copy, nullptr);
+
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	memset(readblock, 0, size);
+	EXPECT_SIZEEQ(stream_read(stream, readblock, size), size / 2);
+	EXPECT_INTEQ(memcmp(block, readblock, size / 2), 0);
+
+	stream_deallocate(stream);
+
+	memory_deallocate(block);
+	memory_deallocate(readblock);
+
+	return 0;
+}
+
 #if !FOUNDATION_PLATFORM_IOS && !FOUNDATION_PLATFORM_ANDROID && !FOUNDATION_PLATFORM_PNACL && !FOUNDATION_PLATFORM_BSD
 
+DECLARE_TEST(fs, statcache) {
+	string_const_t fname;
+	string_t testpath;
+	string_t filepath;
+	string_t subpath;
+	stream_t* file;
+	tick_t start;
+	char buffer[64];
+	size_t iwait;
+
+	fname = string_from_uint_static(random64(), false, 0, 0);
+	testpath = path_allocate_concat(STRING_ARGS(environment_temporary_directory()), STRING_ARGS(fname));
+	filepath = path_allocate_concat(STRING_ARGS(testpath), STRING_CONST("file"));
+	subpath = path_allocate_concat(STRING_ARGS(testpath), STRING_CONST("subdir"));
+	fs_make_directory(STRING_ARGS(testpath));
+
+	//Without a monitor queries go directly to the file system
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(filepath)));
+
+	EXPECT_TRUE(fs_monitor(STRING_ARGS(testpath)));
+	thread_sleep(500);
+
+	//Queries are answered consistently as the library modifies the file system
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(filepath)));
+	EXPECT_FALSE(fs_is_directory(STRING_ARGS(filepath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 0);
+	EXPECT_TICKEQ(fs_last_modified(STRING_ARGS(filepath)), 0);
+
+	start = time_system();
+	memset(buffer, 0x55, sizeof(buffer));
+	file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_CREATE);
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(filepath)));
+	stream_write(file, buffer, 10);
+	stream_deallocate(file);
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(filepath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 10);
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 10);
+	EXPECT_GE(fs_last_modified(STRING_ARGS(filepath)), (start / 1000LL) * 1000LL);
+
+	EXPECT_FALSE(fs_is_directory(STRING_ARGS(subpath)));
+	fs_make_directory(STRING_ARGS(subpath));
+	EXPECT_TRUE(fs_is_directory(STRING_ARGS(subpath)));
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(subpath)));
+
+	//Writes to an open stream are picked up through the monitor
+	file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_ATEND);
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 10);
+	stream_write(file, buffer, 20);
+	stream_flush(file);
+	for (iwait = 0; (iwait < 100) && (fs_size(STRING_ARGS(filepath)) != 30); ++iwait)
+		thread_sleep(50);
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 30);
+	stream_deallocate(file);
+
+	fs_remove_file(STRING_ARGS(filepath));
+	EXPECT_FALSE(fs_is_file(STRING_ARGS(filepath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(filepath)), 0);
+
+	fs_remove_directory(STRING_ARGS(testpath));
+	EXPECT_FALSE(fs_is_directory(STRING_ARGS(subpath)));
+	EXPECT_FALSE(fs_is_directory(STRING_ARGS(testpath)));
+
+	fs_unmonitor(STRING_ARGS(testpath));
+
+	//Discard generated events
+	event_stream_process(fs_event_stream());
+	event_stream_process(fs_event_stream());
+
+	string_deallocate(subpath.str);
+	string_deallocate(filepath.str);
+	string_deallocate(testpath.str);
+
+	return 0;
+}
+
+#if FOUNDATION_PLATFORM_LINUX
+
+DECLARE_TEST(fs, coalesce) {
+	string_const_t fname;
+	string_t testpath;
+	string_t filepath;
+	stream_t* file;
+	event_block_t* block;
+	event_t* event;
+	char buffer[16];
+	size_t iwrite;
+	size_t evtsize;
+	unsigned int modified, deleted;
+
+	fname = string_from_uint_static(random64(), false, 0, 0);
+	testpath = path_allocate_concat(STRING_ARGS(environment_temporary_directory()), STRING_ARGS(fname));
+	filepath = path_allocate_concat(STRING_ARGS(testpath), STRING_CONST("file"));
+	fs_make_directory(STRING_ARGS(testpath));
+	memset(buffer, 0x55, sizeof(buffer));
+
+	EXPECT_TRUE(fs_monitor(STRING_ARGS(testpath)));
+	thread_sleep(500);
+
+	file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_CREATE);
+	stream_deallocate(file);
+	thread_sleep(1000);
+	event_stream_process(fs_event_stream());
+
+	//Repeated modifications within the window are posted as a single event
+	file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_ATEND);
+	for (iwrite = 0; iwrite < 32; ++iwrite) {
+		stream_write(file, buffer, sizeof(buffer));
+		stream_flush(file);
+	}
+	stream_deallocate(file);
+	thread_sleep(1000);
+
+	modified = 0;
+	block = event_stream_process(fs_event_stream());
+	event = 0;
+	while ((event = event_next(block, event))) {
+		evtsize = event->payload[0];
+		EXPECT_STRINGEQ(string((char*)pointer_offset(event->payload, sizeof(size_t)), evtsize),
+		                string_to_const(filepath));
+		EXPECT_EQ(event->id, FOUNDATIONEVENT_FILE_MODIFIED);
+		++modified;
+	}
+	EXPECT_UINTEQ(modified, 1);
+
+	//Pending modification is dropped when the file is deleted
+	file = fs_open_file(STRING_ARGS(filepath), STREAM_OUT | STREAM_ATEND);
+	stream_write(file, buffer, sizeof(buffer));
+	stream_deallocate(file);
+	fs_remove_file(STRING_ARGS(filepath));
+	thread_sleep(1000);
+
+	modified = deleted = 0;
+	block = event_stream_process(fs_event_stream());
+	event = 0;
+	while ((event = event_next(block, event))) {
+		if (event->id == FOUNDATIONEVENT_FILE_MODIFIED)
+			++modified;
+		else if (event->id == FOUNDATIONEVENT_FILE_DELETED)
+			++deleted;
+	}
+	EXPECT_UINTEQ(modified, 0);
+	EXPECT_UINTEQ(deleted, 1);
+
+	fs_unmonitor(STRING_ARGS(testpath));
+	fs_remove_directory(STRING_ARGS(testpath));
+
+	//Discard generated events
+	event_stream_process(fs_event_stream());
+	event_stream_process(fs_event_stream());
+
+	string_deallocate(filepath.str);
+	string_deallocate(testpath.str);
+
+	return 0;
+}
+
+#endif
+
 DECLARE_TEST(fs, monitor) {
 	string_const_t fname;
 	string_t testpath;
@@ -888,8 +1814,20 @@ test_fs_declare(void) {
 	ADD_TEST(fs, file);
 	ADD_TEST(fs, util);
 	ADD_TEST(fs, query);
+	ADD_TEST(fs, listing);
+	ADD_TEST(fs, walk);
 	ADD_TEST(fs, event);
+	ADD_TEST(fs, async);
+	ADD_TEST(fs, asyncops);
+	ADD_TEST(fs, mmap);
+	ADD_TEST(fs, checksum);
+	ADD_TEST(fs, prefetch);
+	ADD_TEST(fs, anonymous);
 #if !FOUNDATION_PLATFORM_IOS && !FOUNDATION_PLATFORM_ANDROID && !FOUNDATION_PLATFORM_PNACL && !FOUNDATION_PLATFORM_BSD
+	ADD_TEST(fs, statcache);
+#if FOUNDATION_PLATFORM_LINUX
+	ADD_TEST(fs, coalesce);
+#endif
 	ADD_TEST(fs, monitor);
 #endif
 }
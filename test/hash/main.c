@@ -11,6 +11,7 @@
  */
 
 #include <foundation/foundation.h>
+#include <foundation/hashstrings_table.h>
 #include <test/test.h>
 
 static application_t
@@ -57,11 +58,120 @@ DECLARE_TEST(hash, known) {
 	return 0;
 }
 
+static atomic32_t store_failures;
+
+static void*
+store_thread(void* arg) {
+	char buffer[64];
+	uintptr_t ithread = (uintptr_t)arg;
+	unsigned int i;
+	for (i = 0; i < 8192; ++i) {
+		string_t str = string_format(buffer, sizeof(buffer), STRING_CONST("store_%u_%u"),
+		                             (unsigned int)ithread, i);
+		hash_t value = hash_store(STRING_ARGS(str));
+		string_const_t stored = hash_to_string(value);
+		if ((value != hash(STRING_ARGS(str))) || !string_equal(STRING_ARGS(stored), STRING_ARGS(str)))
+			atomic_incr32(&store_failures);
+		//Strings stored by all threads
+		str = string_format(buffer, sizeof(buffer), STRING_CONST("shared_%u"), i % 512);
+		stored = hash_to_string(hash_store(STRING_ARGS(str)));
+		if (!string_equal(STRING_ARGS(stored), STRING_ARGS(str)))
+			atomic_incr32(&store_failures);
+		if (!(i % 256))
+			thread_yield();
+	}
+	return 0;
+}
+
 DECLARE_TEST(hash, store) {
-#if BUILD_ENABLE_STATIC_HASH_DEBUG
-	string_const_t foundation = hash_to_string(HASH_FOUNDATION);
-	EXPECT_CONSTSTRINGEQ(foundation, string_const(STRING_CONST("foundation")));
-#endif
+	char buffer[64];
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 4, 16);
+	size_t ithread;
+	thread_t threads[16];
+	unsigned int i;
+	string_const_t stored;
+	string_t str;
+
+	//Static hash strings resolve through the generated table regardless of build config
+	stored = hash_to_string(HASH_FOUNDATION);
+	EXPECT_CONSTSTRINGEQ(stored, string_const(STRING_CONST("foundation")));
+	stored = hash_to_string(HASH_TEMPORARY_DIRECTORY);
+	EXPECT_CONSTSTRINGEQ(stored, string_const(STRING_CONST("temporary_directory")));
+
+	EXPECT_EQ(hash_store(STRING_CONST("hash_store")), hash(STRING_CONST("hash_store")));
+	stored = hash_to_string(hash(STRING_CONST("hash_store")));
+	EXPECT_CONSTSTRINGEQ(stored, string_const(STRING_CONST("hash_store")));
+	EXPECT_EQ(hash_to_string(hash(STRING_CONST("not_stored"))).length, 0);
+
+	//Concurrent inserts and lookups growing the store past the configured size
+	atomic_store32(&store_failures, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_initialize(&threads[ithread], store_thread, (void*)(uintptr_t)ithread,
+		                  STRING_CONST("store"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&threads[ithread]);
+
+	test_wait_for_threads_startup(threads, num_threads);
+	test_wait_for_threads_finish(threads, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&threads[ithread]);
+
+	EXPECT_EQ(atomic_load32(&store_failures), 0);
+	for (ithread = 0; ithread < num_threads; ++ithread) {
+		for (i = 0; i < 8192; i += 97) {
+			str = string_format(buffer, sizeof(buffer), STRING_CONST("store_%u_%u"),
+			                    (unsigned int)ithread, i);
+			stored = hash_to_string(hash(STRING_ARGS(str)));
+			EXPECT_CONSTSTRINGEQ(stored, string_to_const(str));
+		}
+	}
+	stored = hash_to_string(hash(STRING_CONST("hash_store")));
+	EXPECT_CONSTSTRINGEQ(stored, string_const(STRING_CONST("hash_store")));
+
+	return 0;
+}
+
+DECLARE_TEST(hash, table) {
+	size_t index;
+	hash_t value;
+
+	for (index = 0; index < HASHSTRINGS_TABLE_SIZE; ++index) {
+		value = hashstrings_table_hash[index];
+		EXPECT_SIZEEQ(hashstrings_table_index(value), index);
+		EXPECT_EQ(hash(STRING_ARGS(hashstrings_table_string[index])), value);
+		EXPECT_CONSTSTRINGEQ(hashstrings_table_lookup(value), hashstrings_table_string[index]);
+	}
+
+	EXPECT_SIZEEQ(hashstrings_table_index(HASH_FOUNDATION), HASH_FOUNDATION_INDEX);
+	EXPECT_SIZEEQ(hashstrings_table_index(HASH_FS), HASH_FS_INDEX);
+	EXPECT_SIZEEQ(hashstrings_table_index(hash(STRING_CONST("not_a_static_string"))),
+	              HASHSTRINGS_TABLE_SIZE);
+	EXPECT_EQ(hashstrings_table_lookup(hash(STRING_CONST("not_a_static_string"))).length, 0);
+	for (value = 0; value < 1024; ++value)
+		EXPECT_SIZEEQ(hashstrings_table_index(value), HASHSTRINGS_TABLE_SIZE);
+
+	return 0;
+}
+
+DECLARE_TEST(hash, literal) {
+	uint64_t storage[16];
+	char* buffer = (char*)storage;
+	size_t len;
+
+	EXPECT_EQ(hash_literal(""), HASH_EMPTY_STRING);
+	EXPECT_EQ(hash_literal("engine"), 0x39c8cc157cfd24f8ULL);
+	EXPECT_EQ(hash_literal("enable_remote_debugger"), 0xb760826929ca10a3ULL);
+	EXPECT_EQ(hash_literal("cache_directory"), 0x3e7b4931a3841da8ULL);
+	EXPECT_EQ(hash_literal("foundation"), HASH_FOUNDATION);
+	EXPECT_EQ(hash_literal("temporary_directory"), HASH_TEMPORARY_DIRECTORY);
+
+	//Every tail length and several blocks, with a runtime key
+	for (len = 0; len < sizeof(storage); ++len)
+		buffer[len] = (char)(random32_range(1, 256));
+	for (len = 0; len <= sizeof(storage); ++len)
+		EXPECT_EQ(hash_const(buffer, len), hash(buffer, len));
+
 	return 0;
 }
 
@@ -133,11 +243,106 @@ DECLARE_TEST(hash, stability) {
 	return 0;
 }
 
+DECLARE_TEST(hash, nocase) {
+	uint64_t buffer[24];
+	char* data = (char*)buffer;
+	char lower[sizeof(buffer)];
+	size_t len, i;
+	int ipass;
+
+	EXPECT_EQ(hash_nocase(STRING_CONST("Foundation")), hash(STRING_CONST("foundation")));
+	EXPECT_EQ(hash_nocase(STRING_CONST("FOUNDATION_LIB")), hash(STRING_CONST("foundation_lib")));
+	EXPECT_EQ(hash_nocase(STRING_CONST("@[`{")), hash(STRING_CONST("@[`{")));
+	EXPECT_EQ(string_hash_nocase(STRING_CONST("")), string_hash(STRING_CONST("")));
+
+	for (ipass = 0; ipass < 10000; ++ipass) {
+		len = random32_range(0, sizeof(buffer));
+		for (i = 0; i < len; ++i) {
+			data[i] = (char)random32_range(0, 256);
+			lower[i] = ((data[i] >= 'A') && (data[i] <= 'Z')) ? (char)(data[i] + ('a' - 'A')) : data[i];
+		}
+		EXPECT_EQ(hash_nocase(data, len), hash(lower, len));
+		EXPECT_EQ(string_hash_nocase(data, len), string_hash(lower, len));
+	}
+	return 0;
+}
+
+DECLARE_TEST(hash, xxh3) {
+	//Reference values from the XXH3 reference implementation
+	const uint64_t seed = 0x9e3779b97f4a7c15ULL;
+	static const struct {
+		size_t len;
+		bool seeded;
+		uint64_t value64;
+		uint64_t low;
+		uint64_t high;
+	} known[] = {
+		{ 0, 0, 0x2d06800538d394c2ULL, 0x6001c324468d497fULL, 0x99aa06d3014798d8ULL },
+		{ 3, 0, 0x15f7093b173d005cULL, 0x15f7093b173d005cULL, 0x46f66cb935381565ULL },
+		{ 8, 0, 0xdec6a9a43575982eULL, 0x56bb836ceb6d4baaULL, 0x803c675a846cc6c2ULL },
+		{ 16, 0, 0x7e484c18d74895d0ULL, 0xf853dd94614dfa07ULL, 0x650fe308c566747dULL },
+		{ 129, 0, 0xf8f76713f2bb60faULL, 0xc51bc887976aef63ULL, 0x6881633650cd8924ULL },
+		{ 241, 0, 0x0b3b630948ce4a00ULL, 0x0b3b630948ce4a00ULL, 0x92b991a7192f3f08ULL },
+		{ 4096, 0, 0xa3c19f8174cde0bbULL, 0xa3c19f8174cde0bbULL, 0x49d3842b33d51e8aULL },
+		{ 0, 1, 0x602b0e2cd6662c8bULL, 0x4ca5176998171787ULL, 0xd142977a2cca554bULL },
+		{ 1, 1, 0x2f3acd3805f81de3ULL, 0x2f3acd3805f81de3ULL, 0x00a711eb5a736b26ULL },
+		{ 4, 1, 0x1a246e2efb9c9b2eULL, 0x64e9e646b51d20e4ULL, 0xb51a3f0020dfa57eULL },
+		{ 9, 1, 0x9c98d3e24dc54d34ULL, 0x2d1266ad8e2a983eULL, 0xd073a967e56faabbULL },
+		{ 17, 1, 0x0b2caf8bf9648effULL, 0xec6d60966729df8dULL, 0x81d87d7004dc4f98ULL },
+		{ 240, 1, 0x2d882e7899ff64ccULL, 0xde896b7f1ae3bc6fULL, 0x5b131678a4a9b8f4ULL },
+		{ 1025, 1, 0x16cfe055154ff1ddULL, 0x16cfe055154ff1ddULL, 0x0d225711ec9bb344ULL }
+	};
+	static uint8_t data[4096];
+	static uint8_t unaligned[4096 + 8];
+	hash_state_t state;
+	uint128_t value;
+	size_t i, ipass, offset, chunk;
+
+	for (i = 0; i < 4096; ++i)
+		data[i] = (uint8_t)((i * 31) + 7);
+	for (i = 0; i < sizeof(known) / sizeof(known[0]); ++i) {
+		uint64_t known_seed = known[i].seeded ? seed : 0;
+		EXPECT_TYPEEQ(hash64(data, known[i].len, known_seed), known[i].value64, uint64_t, PRIx64);
+		value = hash128(data, known[i].len, known_seed);
+		EXPECT_TYPEEQ(value.word[0], known[i].low, uint64_t, PRIx64);
+		EXPECT_TYPEEQ(value.word[1], known[i].high, uint64_t, PRIx64);
+		//Unaligned input
+		memcpy(unaligned + 3, data, known[i].len);
+		EXPECT_TYPEEQ(hash64(unaligned + 3, known[i].len, known_seed), known[i].value64, uint64_t,
+		              PRIx64);
+	}
+
+	//Streaming in random chunks gives the same hash as hashing all data at once
+	for (ipass = 0; ipass < 512; ++ipass) {
+		size_t len = random32_range(0, 4096);
+		uint64_t stream_seed = (ipass & 1) ? random64() : 0;
+		for (i = 0; i < len; ++i)
+			data[i] = (uint8_t)random32();
+		hash_state_initialize(&state, stream_seed);
+		for (offset = 0; offset < len; offset += chunk) {
+			chunk = random32_range(0, (ipass & 2) ? 600 : 70);
+			if (chunk > len - offset)
+				chunk = len - offset;
+			hash_state_update(&state, data + offset, chunk);
+			EXPECT_TYPEEQ(hash_state_value64(&state), hash64(data, offset + chunk, stream_seed),
+			              uint64_t, PRIx64);
+		}
+		EXPECT_TYPEEQ(hash_state_value64(&state), hash64(data, len, stream_seed), uint64_t, PRIx64);
+		EXPECT_TRUE(uint128_equal(hash_state_value128(&state), hash128(data, len, stream_seed)));
+	}
+
+	return 0;
+}
+
 static void
 test_hash_declare(void) {
 	ADD_TEST(hash, known);
 	ADD_TEST(hash, store);
+	ADD_TEST(hash, table);
+	ADD_TEST(hash, literal);
 	ADD_TEST(hash, stability);
+	ADD_TEST(hash, nocase);
+	ADD_TEST(hash, xxh3);
 }
 
 static test_suite_t test_hash_suite = {
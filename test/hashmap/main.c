@@ -46,6 +46,52 @@ static void
 test_hashmap_finalize(void) {
 }
 
+typedef struct {
+	hashmap_concurrent_t* map;
+	hash_t                key_offset;
+	size_t                key_num;
+	atomic32_t*           done;
+	size_t                failed;
+} concurrent_arg_t;
+
+static void*
+concurrent_writer_thread(void* arg) {
+	concurrent_arg_t* carg = arg;
+	size_t ikey;
+
+	for (ikey = 0; ikey < carg->key_num; ++ikey)
+		hashmap_concurrent_insert(carg->map, carg->key_offset + ikey, (void*)(uintptr_t)ikey);
+
+	thread_yield();
+
+	for (ikey = 0; ikey < carg->key_num / 2; ++ikey)
+		hashmap_concurrent_erase(carg->map, carg->key_offset + ikey);
+
+	thread_yield();
+
+	for (ikey = 0; ikey < carg->key_num; ++ikey)
+		hashmap_concurrent_insert(carg->map, carg->key_offset + ikey, (void*)(uintptr_t)(ikey + 1));
+
+	return 0;
+}
+
+static void*
+concurrent_reader_thread(void* arg) {
+	concurrent_arg_t* carg = arg;
+	size_t ikey;
+
+	//Stable keys must always be found with the correct value while writers grow shards
+	do {
+		for (ikey = 0; ikey < carg->key_num; ++ikey) {
+			if (hashmap_concurrent_lookup(carg->map, carg->key_offset + ikey) !=
+			        (void*)(uintptr_t)(ikey + 1))
+				++carg->failed;
+		}
+	} while (!atomic_load32(carg->done));
+
+	return 0;
+}
+
 DECLARE_TEST(hashmap, allocation) {
 	hashmap_t* map = hashmap_allocate(0, 0);
 
@@ -161,12 +207,272 @@ DECLARE_TEST(hashmap, lookup) {
 	return 0;
 }
 
+DECLARE_TEST(hashmap, grow) {
+	hashmap_t* map = hashmap_allocate(0, 0);
+	size_t initial = map->num_buckets;
+	hash_t key;
+	size_t ikey;
+	const size_t count = 64 * 1024;
+
+	//Keys differing only in high bits stress the home slot mixing
+	for (ikey = 0; ikey < count; ++ikey) {
+		key = ((hash_t)ikey << 40) | 7;
+		EXPECT_EQ(hashmap_insert(map, key, (void*)(uintptr_t)(ikey + 1)), 0);
+	}
+	EXPECT_SIZEEQ(hashmap_size(map), count);
+	EXPECT_SIZEGE(map->num_buckets, count);
+	EXPECT_GT(map->num_buckets, initial);
+	EXPECT_EQ(map->num_buckets & (map->num_buckets - 1), 0);
+
+	for (ikey = 0; ikey < count; ikey += 2) {
+		key = ((hash_t)ikey << 40) | 7;
+		EXPECT_EQ(hashmap_erase(map, key), (void*)(uintptr_t)(ikey + 1));
+	}
+	EXPECT_SIZEEQ(hashmap_size(map), count / 2);
+	for (ikey = 0; ikey < count; ++ikey) {
+		key = ((hash_t)ikey << 40) | 7;
+		if (ikey & 1) {
+			EXPECT_EQ(hashmap_lookup(map, key), (void*)(uintptr_t)(ikey + 1));
+		}
+		else {
+			EXPECT_FALSE(hashmap_has_key(map, key));
+		}
+	}
+
+	hashmap_clear(map);
+	EXPECT_SIZEEQ(hashmap_size(map), 0);
+	for (ikey = 0; ikey < count; ++ikey) {
+		key = ((hash_t)ikey << 40) | 7;
+		EXPECT_FALSE(hashmap_has_key(map, key));
+	}
+	EXPECT_EQ(hashmap_insert(map, 7, map), 0);
+	EXPECT_EQ(hashmap_lookup(map, 7), map);
+
+	hashmap_deallocate(map);
+
+	return 0;
+}
+
+DECLARE_TEST(hashmap, bulk) {
+	hashmap_t* map = hashmap_allocate(0, 0);
+	hashmap_node_t* node;
+	hash_t keys[1024];
+	void* values[1024];
+	size_t capacity;
+	size_t ikey;
+	size_t visited;
+	hash_t keysum;
+
+	EXPECT_EQ(hashmap_next(map, 0), 0);
+
+	hashmap_reserve(map, 1024);
+	capacity = map->num_buckets;
+	EXPECT_SIZEGE(capacity, 1024);
+	hashmap_reserve(map, 16);
+	EXPECT_SIZEEQ(map->num_buckets, capacity);
+
+	for (ikey = 0; ikey < 1024; ++ikey) {
+		keys[ikey] = (hash_t)ikey * 0x10001ULL;
+		values[ikey] = (void*)(uintptr_t)(ikey + 1);
+	}
+	hashmap_insert_bulk(map, keys, values, 1024);
+	EXPECT_SIZEEQ(hashmap_size(map), 1024);
+	EXPECT_SIZEEQ(map->num_buckets, capacity);
+	for (ikey = 0; ikey < 1024; ++ikey)
+		EXPECT_EQ(hashmap_lookup(map, keys[ikey]), values[ikey]);
+
+	//Duplicate keys replace values
+	for (ikey = 0; ikey < 1024; ++ikey)
+		values[ikey] = (void*)(uintptr_t)(ikey + 2);
+	hashmap_insert_bulk(map, keys, values, 512);
+	EXPECT_SIZEEQ(hashmap_size(map), 1024);
+	EXPECT_EQ(hashmap_lookup(map, keys[0]), (void*)(uintptr_t)2);
+	EXPECT_EQ(hashmap_lookup(map, keys[1023]), (void*)(uintptr_t)1024);
+
+	visited = 0;
+	keysum = 0;
+	for (node = hashmap_next(map, 0); node; node = hashmap_next(map, node)) {
+		++visited;
+		keysum += node->key;
+		node->value = 0;
+	}
+	EXPECT_SIZEEQ(visited, 1024);
+	EXPECT_EQ(keysum, (hash_t)(1023 * 1024 / 2) * 0x10001ULL);
+	EXPECT_EQ(hashmap_lookup(map, keys[7]), 0);
+	EXPECT_TRUE(hashmap_has_key(map, keys[7]));
+
+	hashmap_clear(map);
+	EXPECT_EQ(hashmap_next(map, 0), 0);
+
+	hashmap_deallocate(map);
+
+	return 0;
+}
+
+DECLARE_TEST(hashmap, concurrent) {
+	hashmap_concurrent_t* map = hashmap_concurrent_allocate(0, 0);
+	thread_t writer[16];
+	thread_t reader[4];
+	concurrent_arg_t writer_args[16];
+	concurrent_arg_t reader_args[4];
+	atomic32_t done;
+	size_t num_writers;
+	size_t ikey, ithread;
+	const size_t stable = 4096;
+	const size_t key_num = 32768;
+
+	atomic_store32(&done, 0);
+	EXPECT_SIZEEQ(map->num_shards, 16);
+	EXPECT_EQ(hashmap_concurrent_lookup(map, 0), 0);
+	EXPECT_FALSE(hashmap_concurrent_has_key(map, 0));
+
+	for (ikey = 0; ikey < stable; ++ikey)
+		EXPECT_EQ(hashmap_concurrent_insert(map, ikey, (void*)(uintptr_t)(ikey + 1)), 0);
+	EXPECT_SIZEEQ(hashmap_concurrent_size(map), stable);
+
+	num_writers = math_clamp(system_hardware_threads(), 2U, 16U);
+	for (ithread = 0; ithread < num_writers; ++ithread) {
+		writer_args[ithread].map = map;
+		writer_args[ithread].key_offset = ((hash_t)(ithread + 1) << 32);
+		writer_args[ithread].key_num = key_num;
+		thread_initialize(&writer[ithread], concurrent_writer_thread, writer_args + ithread,
+		                  STRING_CONST("map_writer"), THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (ithread = 0; ithread < 4; ++ithread) {
+		reader_args[ithread].map = map;
+		reader_args[ithread].key_offset = 0;
+		reader_args[ithread].key_num = stable;
+		reader_args[ithread].done = &done;
+		reader_args[ithread].failed = 0;
+		thread_initialize(&reader[ithread], concurrent_reader_thread, reader_args + ithread,
+		                  STRING_CONST("map_reader"), THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (ithread = 0; ithread < 4; ++ithread)
+		thread_start(&reader[ithread]);
+	for (ithread = 0; ithread < num_writers; ++ithread)
+		thread_start(&writer[ithread]);
+
+	test_wait_for_threads_startup(writer, num_writers);
+	test_wait_for_threads_finish(writer, num_writers);
+	atomic_store32(&done, 1);
+	test_wait_for_threads_finish(reader, 4);
+
+	for (ithread = 0; ithread < num_writers; ++ithread)
+		thread_finalize(&writer[ithread]);
+	for (ithread = 0; ithread < 4; ++ithread) {
+		thread_finalize(&reader[ithread]);
+		EXPECT_SIZEEQ(reader_args[ithread].failed, 0);
+	}
+
+	EXPECT_SIZEEQ(hashmap_concurrent_size(map), stable + (num_writers * key_num));
+	for (ithread = 0; ithread < num_writers; ++ithread) {
+		for (ikey = 0; ikey < key_num; ++ikey) {
+			EXPECT_EQ(hashmap_concurrent_lookup(map, writer_args[ithread].key_offset + ikey),
+			          (void*)(uintptr_t)(ikey + 1));
+		}
+	}
+	EXPECT_EQ(hashmap_concurrent_erase(map, 1), (void*)(uintptr_t)2);
+	EXPECT_FALSE(hashmap_concurrent_has_key(map, 1));
+
+	hashmap_concurrent_clear(map);
+	EXPECT_SIZEEQ(hashmap_concurrent_size(map), 0);
+	EXPECT_FALSE(hashmap_concurrent_has_key(map, 0));
+
+	hashmap_concurrent_deallocate(map);
+
+	return 0;
+}
+
+DECLARE_TEST(hashmap, string) {
+	hashmap_string_t* map = hashmap_string_allocate(0);
+	hashmap_string_node_t* node;
+	char buffer[128];
+	string_t key;
+	size_t ikey, count;
+	size_t valuesum = 0;
+	const size_t key_num = 2048;
+
+	EXPECT_SIZEEQ(hashmap_string_size(map), 0);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("short")), 0);
+	EXPECT_FALSE(hashmap_string_has_key(map, STRING_CONST("")));
+
+	//Empty, inline and arena stored keys, including keys differing only in length
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST(""), (void*)(uintptr_t)1), 0);
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST("short"), (void*)(uintptr_t)2), 0);
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST("shor"), (void*)(uintptr_t)3), 0);
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST("/a/rather/long/path/to/some/file.txt"),
+	                                (void*)(uintptr_t)4), 0);
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST("/a/rather/long/path/to/some/file.tx"),
+	                                (void*)(uintptr_t)5), 0);
+	EXPECT_SIZEEQ(hashmap_string_size(map), 5);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("")), (void*)(uintptr_t)1);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("short")), (void*)(uintptr_t)2);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("shor")), (void*)(uintptr_t)3);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("/a/rather/long/path/to/some/file.txt")),
+	          (void*)(uintptr_t)4);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("/a/rather/long/path/to/some/file.tx")),
+	          (void*)(uintptr_t)5);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("shorts")), 0);
+
+	EXPECT_EQ(hashmap_string_insert(map, STRING_CONST("short"), (void*)(uintptr_t)6),
+	          (void*)(uintptr_t)2);
+	EXPECT_EQ(hashmap_string_lookup(map, STRING_CONST("short")), (void*)(uintptr_t)6);
+	EXPECT_SIZEEQ(hashmap_string_size(map), 5);
+
+	EXPECT_EQ(hashmap_string_erase(map, STRING_CONST("/a/rather/long/path/to/some/file.txt")),
+	          (void*)(uintptr_t)4);
+	EXPECT_EQ(hashmap_string_erase(map, STRING_CONST("/a/rather/long/path/to/some/file.txt")), 0);
+	EXPECT_FALSE(hashmap_string_has_key(map, STRING_CONST("/a/rather/long/path/to/some/file.txt")));
+	EXPECT_TRUE(hashmap_string_has_key(map, STRING_CONST("/a/rather/long/path/to/some/file.tx")));
+	EXPECT_SIZEEQ(hashmap_string_size(map), 4);
+
+	hashmap_string_clear(map);
+	EXPECT_SIZEEQ(hashmap_string_size(map), 0);
+	EXPECT_EQ(hashmap_string_next(map, 0), 0);
+
+	//Grow through rehash and arena compaction with interleaved erase
+	for (ikey = 0; ikey < key_num; ++ikey) {
+		key = string_format(buffer, sizeof(buffer), STRING_CONST("%s/%" PRIsize),
+		                    (ikey & 1) ? "key" : "/a/long/prefix/stored/in/the/arena", ikey);
+		EXPECT_EQ(hashmap_string_insert(map, STRING_ARGS(key), (void*)(uintptr_t)(ikey + 1)), 0);
+		if ((ikey & 3) == 2) {
+			key = string_format(buffer, sizeof(buffer), STRING_CONST("%s/%" PRIsize),
+			                    "/a/long/prefix/stored/in/the/arena", ikey - 2);
+			EXPECT_EQ(hashmap_string_erase(map, STRING_ARGS(key)), (void*)(uintptr_t)(ikey - 1));
+		}
+	}
+	EXPECT_SIZEEQ(hashmap_string_size(map), key_num - (key_num / 4));
+	for (ikey = 0; ikey < key_num; ++ikey) {
+		bool erased = ((ikey & 3) == 0) && (ikey + 2 < key_num);
+		key = string_format(buffer, sizeof(buffer), STRING_CONST("%s/%" PRIsize),
+		                    (ikey & 1) ? "key" : "/a/long/prefix/stored/in/the/arena", ikey);
+		EXPECT_EQ(hashmap_string_lookup(map, STRING_ARGS(key)),
+		          erased ? 0 : (void*)(uintptr_t)(ikey + 1));
+	}
+
+	for (node = hashmap_string_next(map, 0), count = 0; node; node = hashmap_string_next(map, node), ++count) {
+		string_const_t nodekey = hashmap_string_node_key(map, node);
+		EXPECT_EQ(hashmap_string_lookup(map, STRING_ARGS(nodekey)), node->value);
+		valuesum += (uintptr_t)node->value;
+	}
+	EXPECT_SIZEEQ(count, hashmap_string_size(map));
+	EXPECT_GT(valuesum, 0);
+
+	hashmap_string_deallocate(map);
+
+	return 0;
+}
+
 static void
 test_hashmap_declare(void) {
 	ADD_TEST(hashmap, allocation);
 	ADD_TEST(hashmap, insert);
 	ADD_TEST(hashmap, erase);
 	ADD_TEST(hashmap, lookup);
+	ADD_TEST(hashmap, grow);
+	ADD_TEST(hashmap, bulk);
+	ADD_TEST(hashmap, concurrent);
+	ADD_TEST(hashmap, string);
 }
 
 
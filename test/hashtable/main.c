@@ -329,12 +329,404 @@ DECLARE_TEST(hashtable, 64bit_threaded) {
 	return 0;
 }
 
+DECLARE_TEST(hashtable, 32bit_batch) {
+	hashtable32_t* table = hashtable32_allocate(4099);
+	uint32_t keys[1000];
+	uint32_t values[1000];
+	size_t ikey;
+
+	for (ikey = 0; ikey < 2000; ++ikey)
+		hashtable32_set(table, (uint32_t)(1 + ikey * 7), (uint32_t)(ikey + 1));
+	//Mix of present and missing keys
+	for (ikey = 0; ikey < 1000; ++ikey)
+		keys[ikey] = (uint32_t)(1 + ((ikey * 7919) % 3000) * 7 + ((ikey & 3) ? 0 : 3));
+
+	hashtable32_get_batch(table, keys, values, 1000);
+	for (ikey = 0; ikey < 1000; ++ikey)
+		EXPECT_EQ(values[ikey], hashtable32_get(table, keys[ikey]));
+	EXPECT_EQ(values[1], 1919 + 1);
+
+	//Batches shorter than prefetch distance
+	memset(values, 0xFF, sizeof(values));
+	hashtable32_get_batch(table, keys, values, 3);
+	for (ikey = 0; ikey < 3; ++ikey)
+		EXPECT_EQ(values[ikey], hashtable32_get(table, keys[ikey]));
+	EXPECT_EQ(values[3], (uint32_t)-1);
+	hashtable32_get_batch(table, keys, values, 0);
+
+	hashtable32_deallocate(table);
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 64bit_batch) {
+	hashtable64_t* table = hashtable64_allocate(4099);
+	uint64_t keys[1000];
+	uint64_t values[1000];
+	size_t ikey;
+
+	for (ikey = 0; ikey < 2000; ++ikey)
+		hashtable64_set(table, (uint64_t)(1 + ikey * 7), (uint64_t)(ikey + 1));
+	//Mix of present and missing keys
+	for (ikey = 0; ikey < 1000; ++ikey)
+		keys[ikey] = (uint64_t)(1 + ((ikey * 7919) % 3000) * 7 + ((ikey & 3) ? 0 : 3));
+
+	hashtable64_get_batch(table, keys, values, 1000);
+	for (ikey = 0; ikey < 1000; ++ikey)
+		EXPECT_EQ(values[ikey], hashtable64_get(table, keys[ikey]));
+	EXPECT_EQ(values[1], 1919 + 1);
+
+	//Batches shorter than prefetch distance
+	memset(values, 0xFF, sizeof(values));
+	hashtable64_get_batch(table, keys, values, 3);
+	for (ikey = 0; ikey < 3; ++ikey)
+		EXPECT_EQ(values[ikey], hashtable64_get(table, keys[ikey]));
+	EXPECT_EQ(values[3], (uint64_t)-1);
+	hashtable64_get_batch(table, keys, values, 0);
+
+	hashtable64_deallocate(table);
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 32bit_compact) {
+	hashtable32_t* table = hashtable32_allocate(1031);
+	uint32_t ikey;
+
+	for (ikey = 1; ikey <= 900; ++ikey)
+		hashtable32_set(table, ikey * 13, ikey);
+	for (ikey = 1; ikey <= 900; ++ikey) {
+		if (ikey % 3)
+			hashtable32_erase(table, ikey * 13);
+	}
+	EXPECT_SIZEEQ(hashtable32_size(table), 300);
+
+	EXPECT_SIZEEQ(hashtable32_compact(table), 600);
+	EXPECT_SIZEEQ(hashtable32_size(table), 300);
+	for (ikey = 1; ikey <= 900; ++ikey)
+		EXPECT_EQ(hashtable32_get(table, ikey * 13), (ikey % 3) ? 0 : ikey);
+
+	EXPECT_SIZEEQ(hashtable32_compact(table), 0);
+	for (ikey = 901; ikey <= 1500; ++ikey)
+		hashtable32_set(table, ikey * 13, ikey);
+	EXPECT_SIZEEQ(hashtable32_size(table), 900);
+	for (ikey = 901; ikey <= 1500; ++ikey)
+		EXPECT_EQ(hashtable32_get(table, ikey * 13), ikey);
+
+	hashtable32_deallocate(table);
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 64bit_compact) {
+	hashtable64_t* table = hashtable64_allocate(1031);
+	uint64_t ikey;
+
+	for (ikey = 1; ikey <= 900; ++ikey)
+		hashtable64_set(table, ikey * 13, ikey);
+	for (ikey = 1; ikey <= 900; ++ikey) {
+		if (ikey % 3)
+			hashtable64_erase(table, ikey * 13);
+	}
+	EXPECT_SIZEEQ(hashtable64_size(table), 300);
+
+	EXPECT_SIZEEQ(hashtable64_compact(table), 600);
+	EXPECT_SIZEEQ(hashtable64_size(table), 300);
+	for (ikey = 1; ikey <= 900; ++ikey)
+		EXPECT_EQ(hashtable64_get(table, ikey * 13), (ikey % 3) ? 0 : ikey);
+
+	EXPECT_SIZEEQ(hashtable64_compact(table), 0);
+	for (ikey = 901; ikey <= 1500; ++ikey)
+		hashtable64_set(table, ikey * 13, ikey);
+	EXPECT_SIZEEQ(hashtable64_size(table), 900);
+	for (ikey = 901; ikey <= 1500; ++ikey)
+		EXPECT_EQ(hashtable64_get(table, ikey * 13), ikey);
+
+	hashtable64_deallocate(table);
+
+	return 0;
+}
+
+typedef struct {
+	hashtable32_resizable_t* table;
+	uint32_t                 key_offset;
+	uint32_t                 key_num;
+	size_t                     failed;
+} resizable32_arg_t;
+
+static void*
+resizable32_thread(void* arg) {
+	resizable32_arg_t* parg = arg;
+	hashtable32_resizable_t* table = parg->table;
+	uint32_t key_offset = parg->key_offset;
+	uint32_t key;
+
+	for (key = 0; key < parg->key_num; ++key) {
+		hashtable32_resizable_set(table, 1 + key + key_offset, 1);
+		if (hashtable32_resizable_get(table, 1 + key + key_offset) != 1)
+			++parg->failed;
+	}
+
+	thread_yield();
+
+	for (key = 0; key < parg->key_num / 2; ++key)
+		hashtable32_resizable_erase(table, 1 + key + key_offset);
+
+	thread_yield();
+
+	for (key = 0; key < parg->key_num; ++key) {
+		hashtable32_resizable_set(table, 1 + key + key_offset, 1 + ((key + key_offset) % 17));
+		if (hashtable32_resizable_get(table, 1 + key + key_offset) != 1 + ((key + key_offset) % 17))
+			++parg->failed;
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 32bit_resizable) {
+	hashtable32_resizable_t* table = hashtable32_resizable_allocate(0);
+	thread_t thread[32];
+	resizable32_arg_t args[32];
+	size_t num_threads;
+	size_t i;
+	uint32_t j;
+
+	EXPECT_SIZEEQ(hashtable32_resizable_size(table), 0);
+	EXPECT_EQ(hashtable32_resizable_get(table, 1), 0);
+
+	//Grow single threaded well past initial capacity
+	for (j = 1; j < 10000; ++j)
+		EXPECT_TRUE(hashtable32_resizable_set(table, j, j));
+	EXPECT_SIZEEQ(hashtable32_resizable_size(table), 9999);
+	for (j = 1; j < 10000; ++j)
+		EXPECT_EQ(hashtable32_resizable_get(table, j), j);
+	for (j = 1; j < 10000; j += 2)
+		hashtable32_resizable_erase(table, j);
+	EXPECT_SIZEEQ(hashtable32_resizable_size(table), 4999);
+	for (j = 1; j < 10000; ++j)
+		EXPECT_EQ(hashtable32_resizable_get(table, j), (j & 1) ? 0 : j);
+	hashtable32_resizable_deallocate(table);
+
+	table = hashtable32_resizable_allocate(16);
+	num_threads = math_clamp(system_hardware_threads() * 2U, 4U, 32U);
+	for (i = 0; i < num_threads; ++i) {
+		args[i].table = table;
+		args[i].key_offset = (uint32_t)(i * 100000);
+		args[i].key_num = 20000;
+		args[i].failed = 0;
+
+		thread_initialize(&thread[i], resizable32_thread, args + i, STRING_CONST("table_producer"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (i = 0; i < num_threads; ++i)
+		thread_start(&thread[i]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (i = 0; i < num_threads; ++i) {
+		thread_finalize(&thread[i]);
+		EXPECT_SIZEEQ(args[i].failed, 0);
+	}
+
+	for (i = 0; i < num_threads; ++i) {
+		for (j = 0; j < 20000; ++j) {
+			uint32_t key = (uint32_t)(i * 100000) + j;
+			EXPECT_EQ(hashtable32_resizable_get(table, 1 + key), 1 + (key % 17));
+		}
+	}
+	EXPECT_SIZEEQ(hashtable32_resizable_size(table), num_threads * 20000);
+
+	hashtable32_resizable_deallocate(table);
+
+	return 0;
+}
+
+typedef struct {
+	hashtable64_resizable_t* table;
+	uint64_t                 key_offset;
+	uint64_t                 key_num;
+	size_t                     failed;
+} resizable64_arg_t;
+
+static void*
+resizable64_thread(void* arg) {
+	resizable64_arg_t* parg = arg;
+	hashtable64_resizable_t* table = parg->table;
+	uint64_t key_offset = parg->key_offset;
+	uint64_t key;
+
+	for (key = 0; key < parg->key_num; ++key) {
+		hashtable64_resizable_set(table, 1 + key + key_offset, 1);
+		if (hashtable64_resizable_get(table, 1 + key + key_offset) != 1)
+			++parg->failed;
+	}
+
+	thread_yield();
+
+	for (key = 0; key < parg->key_num / 2; ++key)
+		hashtable64_resizable_erase(table, 1 + key + key_offset);
+
+	thread_yield();
+
+	for (key = 0; key < parg->key_num; ++key) {
+		hashtable64_resizable_set(table, 1 + key + key_offset, 1 + ((key + key_offset) % 17));
+		if (hashtable64_resizable_get(table, 1 + key + key_offset) != 1 + ((key + key_offset) % 17))
+			++parg->failed;
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 64bit_resizable) {
+	hashtable64_resizable_t* table = hashtable64_resizable_allocate(0);
+	thread_t thread[32];
+	resizable64_arg_t args[32];
+	size_t num_threads;
+	size_t i;
+	uint64_t j;
+
+	EXPECT_SIZEEQ(hashtable64_resizable_size(table), 0);
+	EXPECT_EQ(hashtable64_resizable_get(table, 1), 0);
+
+	//Grow single threaded well past initial capacity
+	for (j = 1; j < 10000; ++j)
+		EXPECT_TRUE(hashtable64_resizable_set(table, j, j));
+	EXPECT_SIZEEQ(hashtable64_resizable_size(table), 9999);
+	for (j = 1; j < 10000; ++j)
+		EXPECT_EQ(hashtable64_resizable_get(table, j), j);
+	for (j = 1; j < 10000; j += 2)
+		hashtable64_resizable_erase(table, j);
+	EXPECT_SIZEEQ(hashtable64_resizable_size(table), 4999);
+	for (j = 1; j < 10000; ++j)
+		EXPECT_EQ(hashtable64_resizable_get(table, j), (j & 1) ? 0 : j);
+	hashtable64_resizable_deallocate(table);
+
+	table = hashtable64_resizable_allocate(16);
+	num_threads = math_clamp(system_hardware_threads() * 2U, 4U, 32U);
+	for (i = 0; i < num_threads; ++i) {
+		args[i].table = table;
+		args[i].key_offset = (uint64_t)(i * 100000);
+		args[i].key_num = 20000;
+		args[i].failed = 0;
+
+		thread_initialize(&thread[i], resizable64_thread, args + i, STRING_CONST("table_producer"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (i = 0; i < num_threads; ++i)
+		thread_start(&thread[i]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (i = 0; i < num_threads; ++i) {
+		thread_finalize(&thread[i]);
+		EXPECT_SIZEEQ(args[i].failed, 0);
+	}
+
+	for (i = 0; i < num_threads; ++i) {
+		for (j = 0; j < 20000; ++j) {
+			uint64_t key = (uint64_t)(i * 100000) + j;
+			EXPECT_EQ(hashtable64_resizable_get(table, 1 + key), 1 + (key % 17));
+		}
+	}
+	EXPECT_SIZEEQ(hashtable64_resizable_size(table), num_threads * 20000);
+
+	hashtable64_resizable_deallocate(table);
+
+	return 0;
+}
+
+DECLARE_TEST(hashtable, 64bit_snapshot) {
+	hashtable64_t* table = hashtable64_allocate(4099);
+	hashtable64_t* mapped;
+	char buf[BUILD_MAX_PATHLEN];
+	string_const_t fname;
+	string_t path;
+	stream_t* stream;
+	stream_t* mapstream;
+	size_t ikey;
+
+	fname = string_from_uint_static(random64(), true, 0, 0);
+	path = path_concat(buf, sizeof(buf), STRING_ARGS(environment_temporary_directory()),
+	                   STRING_ARGS(fname));
+	if (!fs_is_directory(STRING_ARGS(environment_temporary_directory())))
+		fs_make_directory(STRING_ARGS(environment_temporary_directory()));
+
+	for (ikey = 0; ikey < 2000; ++ikey)
+		hashtable64_set(table, (uint64_t)(1 + ikey * 7), (uint64_t)(ikey + 1));
+	hashtable64_erase(table, 8);
+
+	stream = fs_open_file(STRING_ARGS(path), STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                      STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	EXPECT_TRUE(hashtable64_write(table, stream));
+	stream_deallocate(stream);
+
+	//Non-mapped and non-snapshot streams are rejected
+	stream = fs_open_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	EXPECT_EQ(hashtable64_map(stream), nullptr);
+	stream_deallocate(stream);
+
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_POSIX
+	//Read-only mapping
+	mapstream = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	mapped = hashtable64_map(mapstream);
+	EXPECT_NE(mapped, nullptr);
+	EXPECT_SIZEEQ(mapped->capacity, 4099);
+	EXPECT_SIZEEQ(hashtable64_size(mapped), 1999);
+	for (ikey = 0; ikey < 2000; ++ikey)
+		EXPECT_EQ(hashtable64_get(mapped, (uint64_t)(1 + ikey * 7)), (ikey == 1) ? 0 : ikey + 1);
+	EXPECT_EQ(hashtable64_get(mapped, 2), 0);
+	stream_deallocate(mapstream);
+
+	//Copy-on-write mapping can be modified without changing the file
+	mapstream = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY);
+	mapped = hashtable64_map(mapstream);
+	EXPECT_NE(mapped, nullptr);
+	EXPECT_TRUE(hashtable64_set(mapped, 2, 42));
+	hashtable64_erase(mapped, 1);
+	EXPECT_EQ(hashtable64_get(mapped, 2), 42);
+	EXPECT_EQ(hashtable64_get(mapped, 1), 0);
+	stream_deallocate(mapstream);
+
+	mapstream = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	mapped = hashtable64_map(mapstream);
+	EXPECT_EQ(hashtable64_get(mapped, 2), 0);
+	EXPECT_EQ(hashtable64_get(mapped, 1), 1);
+	stream_deallocate(mapstream);
+
+	//Truncated snapshot is rejected
+	stream = fs_open_file(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY);
+	stream_truncate(stream, 1024);
+	stream_deallocate(stream);
+	mapstream = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	EXPECT_EQ(hashtable64_map(mapstream), nullptr);
+	stream_deallocate(mapstream);
+#else
+	FOUNDATION_UNUSED(mapped);
+	FOUNDATION_UNUSED(mapstream);
+#endif
+
+	fs_remove_file(STRING_ARGS(path));
+	hashtable64_deallocate(table);
+
+	return 0;
+}
+
 static void
 test_hashtable_declare(void) {
 	ADD_TEST(hashtable, 32bit_basic);
 	ADD_TEST(hashtable, 32bit_threaded);
 	ADD_TEST(hashtable, 64bit_basic);
 	ADD_TEST(hashtable, 64bit_threaded);
+	ADD_TEST(hashtable, 32bit_batch);
+	ADD_TEST(hashtable, 64bit_batch);
+	ADD_TEST(hashtable, 32bit_compact);
+	ADD_TEST(hashtable, 64bit_compact);
+	ADD_TEST(hashtable, 32bit_resizable);
+	ADD_TEST(hashtable, 64bit_resizable);
+	ADD_TEST(hashtable, 64bit_snapshot);
 }
 
 static test_suite_t test_hashtable_suite = {
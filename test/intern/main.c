@@ -0,0 +1,187 @@
+/* main.c  -  Foundation intern test    -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+#define TEST_INTERN_STRINGS 4096
+#define TEST_INTERN_THREADS 16
+
+typedef struct {
+	size_t offset;
+	const char* interned[TEST_INTERN_STRINGS];
+} intern_thread_arg_t;
+
+static intern_thread_arg_t intern_thread_args[TEST_INTERN_THREADS];
+
+static application_t
+test_intern_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation intern tests"));
+	app.short_name = string_const(STRING_CONST("test_intern"));
+	app.config_dir = string_const(STRING_CONST("test_intern"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_intern_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_intern_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_intern_initialize(void) {
+	return 0;
+}
+
+static void
+test_intern_finalize(void) {
+}
+
+DECLARE_TEST(intern, basic) {
+	char buffer[64];
+	char large[100000];
+	string_t str;
+	interned_t first, second, other, empty, big;
+	size_t count = intern_count();
+
+	str = string_copy(buffer, sizeof(buffer), STRING_CONST("config.section.key"));
+	first = intern_string(STRING_ARGS(str));
+	EXPECT_NE(first.string.str, str.str);
+	EXPECT_TRUE(string_equal(STRING_ARGS(first.string), STRING_ARGS(str)));
+	EXPECT_EQ(first.string.str[first.string.length], 0);
+	EXPECT_TYPEEQ(first.hash, hash(STRING_ARGS(str)), hash_t, PRIx64);
+	EXPECT_SIZEEQ(intern_count(), count + 1);
+
+	//Identical string in a different buffer shares storage
+	second = intern_string(STRING_CONST("config.section.key"));
+	EXPECT_EQ(second.string.str, first.string.str);
+	EXPECT_TYPEEQ(second.hash, first.hash, hash_t, PRIx64);
+	EXPECT_SIZEEQ(intern_count(), count + 1);
+
+	//Prefix is a different string
+	other = intern_string(STRING_CONST("config.section"));
+	EXPECT_NE(other.string.str, first.string.str);
+	EXPECT_SIZEEQ(other.string.length, 14);
+	EXPECT_SIZEEQ(intern_count(), count + 2);
+
+	empty = intern_string(0, 0);
+	EXPECT_SIZEEQ(empty.string.length, 0);
+	EXPECT_NE(empty.string.str, 0);
+	EXPECT_EQ(intern_string(STRING_CONST("")).string.str, empty.string.str);
+
+	//Strings larger than a storage block
+	memset(large, 'x', sizeof(large));
+	big = intern_string(large, sizeof(large));
+	EXPECT_EQ(intern_string(large, sizeof(large)).string.str, big.string.str);
+	EXPECT_EQ(memcmp(big.string.str, large, sizeof(large)), 0);
+
+	EXPECT_EQ(intern_lookup(first.hash).str, first.string.str);
+	EXPECT_EQ(intern_lookup(other.hash).str, other.string.str);
+	EXPECT_EQ(intern_lookup(hash(STRING_CONST("not interned"))).str, 0);
+
+	return 0;
+}
+
+static void*
+intern_thread(void* arg) {
+	intern_thread_arg_t* thread_arg = arg;
+	char buffer[64];
+	size_t istr;
+	for (istr = 0; istr < TEST_INTERN_STRINGS; ++istr) {
+		//Threads intern the same strings in different order
+		size_t index = (istr + thread_arg->offset) % TEST_INTERN_STRINGS;
+		string_t str = string_format(buffer, sizeof(buffer), STRING_CONST("thread/string/%" PRIsize),
+		                             index);
+		interned_t interned = intern_string(STRING_ARGS(str));
+		thread_arg->interned[index] = interned.string.str;
+		if ((istr % 256) == 0)
+			thread_yield();
+	}
+	return 0;
+}
+
+DECLARE_TEST(intern, threaded) {
+	thread_t thread[TEST_INTERN_THREADS];
+	size_t ithread, istr;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2U, 4U, TEST_INTERN_THREADS);
+	size_t count = intern_count();
+
+	for (ithread = 0; ithread < num_threads; ++ithread) {
+		intern_thread_args[ithread].offset = ithread * 257;
+		thread_initialize(&thread[ithread], intern_thread, intern_thread_args + ithread,
+		                  STRING_CONST("intern"), THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&thread[ithread]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&thread[ithread]);
+
+	EXPECT_SIZEEQ(intern_count(), count + TEST_INTERN_STRINGS);
+	for (istr = 0; istr < TEST_INTERN_STRINGS; ++istr) {
+		for (ithread = 1; ithread < num_threads; ++ithread)
+			EXPECT_EQ(intern_thread_args[ithread].interned[istr], intern_thread_args[0].interned[istr]);
+	}
+
+	return 0;
+}
+
+static void
+test_intern_declare(void) {
+	ADD_TEST(intern, basic);
+	ADD_TEST(intern, threaded);
+}
+
+static test_suite_t test_intern_suite = {
+	test_intern_application,
+	test_intern_memory_system,
+	test_intern_config,
+	test_intern_declare,
+	test_intern_initialize,
+	test_intern_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_intern_run(void);
+
+int
+test_intern_run(void) {
+	test_suite = test_intern_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_intern_suite;
+}
+
+#endif
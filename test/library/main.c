@@ -52,6 +52,8 @@ DECLARE_TEST(library, lookup) {
 	void* symbol = 0;
 	string_const_t libraryname;
 	string_const_t symbolname;
+	string_const_t symbolnames[3];
+	void* symbols[3];
 
 	if (system_platform() == PLATFORM_PNACL)
 		return 0;
@@ -92,6 +94,19 @@ DECLARE_TEST(library, lookup) {
 
 	symbol = library_symbol(lib, STRING_ARGS(symbolname));
 	EXPECT_NE(symbol, 0);
+	EXPECT_EQ(library_symbol(lib, STRING_ARGS(symbolname)), symbol);
+	EXPECT_EQ(library_symbol(lib, STRING_CONST("this_symbol_should_not_exist")), 0);
+	EXPECT_EQ(library_symbol(lib, STRING_CONST("this_symbol_should_not_exist")), 0);
+
+	symbolnames[0] = symbolname;
+	symbolnames[1] = string_const(STRING_CONST("this_symbol_should_not_exist"));
+	symbolnames[2] = symbolname;
+	EXPECT_SIZEEQ(library_symbols(lib, symbolnames, 3, symbols), 2);
+	EXPECT_EQ(symbols[0], symbol);
+	EXPECT_EQ(symbols[1], 0);
+	EXPECT_EQ(symbols[2], symbol);
+	EXPECT_SIZEEQ(library_symbols(0, symbolnames, 3, symbols), 0);
+	EXPECT_EQ(symbols[0], 0);
 
 	EXPECT_EQ(library_symbol(0, STRING_ARGS(symbolname)), 0);
 
@@ -100,6 +115,13 @@ DECLARE_TEST(library, lookup) {
 
 	EXPECT_FALSE(library_valid(lib));
 
+	//Loading again after release creates a new library object
+	otherlib = library_load(STRING_ARGS(libraryname));
+	EXPECT_NE(otherlib, 0);
+	EXPECT_NE(otherlib, lib);
+	EXPECT_EQ(library_symbol(otherlib, STRING_ARGS(symbolname)), symbol);
+	library_unload(otherlib);
+
 	return 0;
 }
 
@@ -0,0 +1,315 @@
+/* main.c  -  Foundation lock test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_lock_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation lock tests"));
+	app.short_name = string_const(STRING_CONST("test_lock"));
+	app.config_dir = string_const(STRING_CONST("test_lock"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_lock_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_lock_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_lock_initialize(void) {
+	return 0;
+}
+
+static void
+test_lock_finalize(void) {
+}
+
+
+DECLARE_TEST(lock, basic) {
+	lock_t lock;
+
+	EXPECT_EQ(sizeof(lock_t), 4);
+
+	lock_initialize(&lock);
+	EXPECT_TRUE(lock_try_lock(&lock));
+	EXPECT_FALSE(lock_try_lock(&lock));
+	lock_unlock(&lock);
+
+	lock_lock(&lock);
+	EXPECT_FALSE(lock_try_lock(&lock));
+	lock_unlock(&lock);
+	EXPECT_TRUE(lock_try_lock(&lock));
+	lock_unlock(&lock);
+
+	return 0;
+}
+
+static lock_t thread_lock;
+static size_t thread_counter;
+
+static void*
+lock_thread(void* arg) {
+	size_t i;
+	FOUNDATION_UNUSED(arg);
+
+	for (i = 0; i < 1024 * 16; ++i) {
+		lock_lock(&thread_lock);
+		++thread_counter;
+		if ((i % 64) == 0)
+			thread_yield();
+		lock_unlock(&thread_lock);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(lock, sync) {
+	thread_t thread[32];
+	size_t ith;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 4, 32);
+
+	lock_initialize(&thread_lock);
+	thread_counter = 0;
+	lock_lock(&thread_lock);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], lock_thread, 0, STRING_CONST("lock_thread"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+
+	lock_unlock(&thread_lock);
+
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_finalize(&thread[ith]);
+
+	EXPECT_SIZEEQ(thread_counter, num_threads * 1024 * 16);
+	EXPECT_INTEQ(atomic_load32(&thread_lock.state), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(lock, rwlock) {
+	rwlock_t lock;
+
+	EXPECT_EQ(sizeof(rwlock_t), 4);
+
+	rwlock_initialize(&lock);
+	EXPECT_TRUE(rwlock_read_try_lock(&lock, 0));
+	EXPECT_TRUE(rwlock_read_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_write_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_write_try_lock(&lock, 10));
+	rwlock_read_unlock(&lock);
+	EXPECT_FALSE(rwlock_write_try_lock(&lock, 0));
+	rwlock_read_unlock(&lock);
+
+	EXPECT_TRUE(rwlock_write_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_read_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_read_try_lock(&lock, 10));
+	EXPECT_FALSE(rwlock_write_try_lock(&lock, 0));
+	rwlock_write_unlock(&lock);
+
+	rwlock_read_lock(&lock);
+	rwlock_read_unlock(&lock);
+	rwlock_write_lock(&lock);
+	rwlock_write_unlock(&lock);
+	EXPECT_INTEQ(atomic_load32(&lock.state), 0);
+
+	return 0;
+}
+
+static rwlock_t thread_rwlock;
+static rwlock_distributed_t thread_rwlock_distributed;
+static atomic32_t thread_readers;
+static atomic32_t thread_writers;
+static atomic32_t thread_violations;
+
+static void
+rwlock_check_read(void) {
+	atomic_incr32(&thread_readers);
+	if (atomic_load32(&thread_writers))
+		atomic_incr32(&thread_violations);
+	atomic_decr32(&thread_readers);
+}
+
+static void
+rwlock_check_write(void) {
+	if (atomic_incr32(&thread_writers) != 1)
+		atomic_incr32(&thread_violations);
+	if (atomic_load32(&thread_readers))
+		atomic_incr32(&thread_violations);
+	++thread_counter;
+	thread_yield();
+	atomic_decr32(&thread_writers);
+}
+
+static void*
+rwlock_thread(void* arg) {
+	size_t i;
+	bool distributed = (arg != 0);
+
+	for (i = 0; i < 1024 * 4; ++i) {
+		if (i % 16) {
+			if (distributed)
+				rwlock_distributed_read_lock(&thread_rwlock_distributed);
+			else
+				rwlock_read_lock(&thread_rwlock);
+			rwlock_check_read();
+			if (distributed)
+				rwlock_distributed_read_unlock(&thread_rwlock_distributed);
+			else
+				rwlock_read_unlock(&thread_rwlock);
+		}
+		else {
+			if (distributed)
+				rwlock_distributed_write_lock(&thread_rwlock_distributed);
+			else
+				rwlock_write_lock(&thread_rwlock);
+			rwlock_check_write();
+			if (distributed)
+				rwlock_distributed_write_unlock(&thread_rwlock_distributed);
+			else
+				rwlock_write_unlock(&thread_rwlock);
+		}
+	}
+
+	return 0;
+}
+
+static void*
+rwlock_run_threads(bool distributed) {
+	thread_t thread[32];
+	size_t ith;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 4, 32);
+
+	thread_counter = 0;
+	atomic_store32(&thread_readers, 0);
+	atomic_store32(&thread_writers, 0);
+	atomic_store32(&thread_violations, 0);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], rwlock_thread, distributed ? &thread_rwlock_distributed : 0,
+		                  STRING_CONST("rwlock_thread"), THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_finalize(&thread[ith]);
+
+	EXPECT_SIZEEQ(thread_counter, num_threads * 256);
+	EXPECT_INTEQ(atomic_load32(&thread_violations), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(lock, rwlock_sync) {
+	rwlock_initialize(&thread_rwlock);
+	if (rwlock_run_threads(false))
+		return FAILED_TEST;
+	EXPECT_INTEQ(atomic_load32(&thread_rwlock.state), 0);
+	return 0;
+}
+
+DECLARE_TEST(lock, rwlock_distributed) {
+	rwlock_distributed_t lock;
+
+	rwlock_distributed_initialize(&lock, 3);
+	EXPECT_SIZEEQ(lock.num_slots, 4);
+
+	EXPECT_TRUE(rwlock_distributed_read_try_lock(&lock, 0));
+	rwlock_distributed_read_lock(&lock);
+	EXPECT_FALSE(rwlock_distributed_write_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_distributed_write_try_lock(&lock, 10));
+	rwlock_distributed_read_unlock(&lock);
+	rwlock_distributed_read_unlock(&lock);
+
+	EXPECT_TRUE(rwlock_distributed_write_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_distributed_read_try_lock(&lock, 0));
+	EXPECT_FALSE(rwlock_distributed_read_try_lock(&lock, 10));
+	EXPECT_FALSE(rwlock_distributed_write_try_lock(&lock, 0));
+	rwlock_distributed_write_unlock(&lock);
+
+	rwlock_distributed_write_lock(&lock);
+	rwlock_distributed_write_unlock(&lock);
+	rwlock_distributed_read_lock(&lock);
+	rwlock_distributed_read_unlock(&lock);
+
+	rwlock_distributed_finalize(&lock);
+
+	rwlock_distributed_initialize(&thread_rwlock_distributed, 0);
+	if (rwlock_run_threads(true))
+		return FAILED_TEST;
+	rwlock_distributed_finalize(&thread_rwlock_distributed);
+
+	return 0;
+}
+
+static void
+test_lock_declare(void) {
+	ADD_TEST(lock, basic);
+	ADD_TEST(lock, sync);
+	ADD_TEST(lock, rwlock);
+	ADD_TEST(lock, rwlock_sync);
+	ADD_TEST(lock, rwlock_distributed);
+}
+
+static test_suite_t test_lock_suite = {
+	test_lock_application,
+	test_lock_memory_system,
+	test_lock_config,
+	test_lock_declare,
+	test_lock_initialize,
+	test_lock_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_lock_run(void);
+
+int
+test_lock_run(void) {
+	test_suite = test_lock_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_lock_suite;
+}
+
+#endif
@@ -0,0 +1,278 @@
+/* main.c  -  Foundation lockfree test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_lockfree_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation lockfree tests"));
+	app.short_name = string_const(STRING_CONST("test_lockfree"));
+	app.config_dir = string_const(STRING_CONST("test_lockfree"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_lockfree_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_lockfree_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_lockfree_initialize(void) {
+	return 0;
+}
+
+static void
+test_lockfree_finalize(void) {
+}
+
+
+typedef struct {
+	lockfree_node_t node;
+	size_t producer;
+	size_t sequence;
+} lockfree_item_t;
+
+#define LOCKFREE_ITEMS_PER_THREAD 1024
+
+static lockfree_stack_t thread_stack;
+static lockfree_queue_t thread_queue;
+static lockfree_item_t  thread_items[32 * LOCKFREE_ITEMS_PER_THREAD];
+
+DECLARE_TEST(lockfree, stack) {
+	lockfree_stack_t stack;
+	lockfree_item_t items[8];
+	lockfree_node_t* node;
+	size_t iitem;
+
+	lockfree_stack_initialize(&stack);
+	EXPECT_TRUE(lockfree_stack_is_empty(&stack));
+	EXPECT_EQ(lockfree_stack_pop(&stack), 0);
+	EXPECT_EQ(lockfree_stack_pop_all(&stack), 0);
+
+	for (iitem = 0; iitem < 4; ++iitem)
+		lockfree_stack_push(&stack, &items[iitem].node);
+	EXPECT_FALSE(lockfree_stack_is_empty(&stack));
+
+	for (iitem = 4; iitem < 8; ++iitem)
+		atomic_storeptr(&items[iitem].node.next, (iitem < 7) ? &items[iitem + 1].node : 0);
+	lockfree_stack_push_list(&stack, &items[4].node, &items[7].node);
+
+	for (iitem = 4; iitem < 8; ++iitem)
+		EXPECT_EQ(lockfree_stack_pop(&stack), &items[iitem].node);
+	for (iitem = 4; iitem > 0; --iitem)
+		EXPECT_EQ(lockfree_stack_pop(&stack), &items[iitem - 1].node);
+	EXPECT_EQ(lockfree_stack_pop(&stack), 0);
+	EXPECT_TRUE(lockfree_stack_is_empty(&stack));
+
+	for (iitem = 0; iitem < 8; ++iitem)
+		lockfree_stack_push(&stack, &items[iitem].node);
+	node = lockfree_stack_pop_all(&stack);
+	EXPECT_TRUE(lockfree_stack_is_empty(&stack));
+	for (iitem = 8; iitem > 0; --iitem) {
+		EXPECT_EQ(node, &items[iitem - 1].node);
+		node = atomic_loadptr(&node->next);
+	}
+	EXPECT_EQ(node, 0);
+
+	return 0;
+}
+
+static void*
+stack_thread(void* arg) {
+	unsigned int loop;
+	lockfree_node_t* node[4];
+	size_t inode;
+	FOUNDATION_UNUSED(arg);
+	for (loop = 0; loop < 16384; ++loop) {
+		for (inode = 0; inode < 4; ++inode)
+			node[inode] = lockfree_stack_pop(&thread_stack);
+		for (inode = 0; inode < 4; ++inode) {
+			if (node[inode])
+				lockfree_stack_push(&thread_stack, node[inode]);
+		}
+		if (!(loop % 128))
+			thread_yield();
+	}
+	return 0;
+}
+
+DECLARE_TEST(lockfree, stack_threads) {
+	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
+	size_t ithread, iitem, count;
+	thread_t threads[32];
+	lockfree_node_t* node;
+
+	lockfree_stack_initialize(&thread_stack);
+	for (iitem = 0; iitem < 256; ++iitem)
+		lockfree_stack_push(&thread_stack, &thread_items[iitem].node);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_initialize(&threads[ithread], stack_thread, 0,
+		                  STRING_CONST("stack"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&threads[ithread]);
+
+	test_wait_for_threads_startup(threads, num_threads);
+	test_wait_for_threads_finish(threads, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&threads[ithread]);
+
+	count = 0;
+	while ((node = lockfree_stack_pop(&thread_stack)) != 0) {
+		EXPECT_GE((void*)node, (void*)&thread_items[0]);
+		EXPECT_LT((void*)node, (void*)&thread_items[256]);
+		++count;
+	}
+	EXPECT_SIZEEQ(count, 256);
+
+	return 0;
+}
+
+DECLARE_TEST(lockfree, queue) {
+	lockfree_queue_t* queue;
+	lockfree_item_t items[8];
+	size_t iitem;
+
+	queue = memory_allocate(0, sizeof(lockfree_queue_t), 64, MEMORY_PERSISTENT);
+	lockfree_queue_initialize(queue);
+	EXPECT_EQ(lockfree_queue_pop(queue), 0);
+
+	lockfree_queue_push(queue, &items[0].node);
+	EXPECT_EQ(lockfree_queue_pop(queue), &items[0].node);
+	EXPECT_EQ(lockfree_queue_pop(queue), 0);
+
+	for (iitem = 0; iitem < 4; ++iitem)
+		lockfree_queue_push(queue, &items[iitem].node);
+	EXPECT_EQ(lockfree_queue_pop(queue), &items[0].node);
+	EXPECT_EQ(lockfree_queue_pop(queue), &items[1].node);
+	for (iitem = 4; iitem < 8; ++iitem)
+		lockfree_queue_push(queue, &items[iitem].node);
+	for (iitem = 2; iitem < 8; ++iitem)
+		EXPECT_EQ(lockfree_queue_pop(queue), &items[iitem].node);
+	EXPECT_EQ(lockfree_queue_pop(queue), 0);
+
+	memory_deallocate(queue);
+
+	return 0;
+}
+
+static void*
+queue_thread(void* arg) {
+	size_t producer = (size_t)(uintptr_t)arg;
+	size_t iitem;
+	for (iitem = 0; iitem < LOCKFREE_ITEMS_PER_THREAD; ++iitem) {
+		lockfree_item_t* item = thread_items + (producer * LOCKFREE_ITEMS_PER_THREAD) + iitem;
+		item->producer = producer;
+		item->sequence = iitem;
+		lockfree_queue_push(&thread_queue, &item->node);
+		if (!(iitem % 64))
+			thread_yield();
+	}
+	return 0;
+}
+
+DECLARE_TEST(lockfree, queue_threads) {
+	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
+	size_t ithread, count;
+	size_t next_sequence[32];
+	thread_t threads[32];
+	lockfree_node_t* node;
+	tick_t start;
+
+	lockfree_queue_initialize(&thread_queue);
+	memset(next_sequence, 0, sizeof(next_sequence));
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_initialize(&threads[ithread], queue_thread, (void*)(uintptr_t)ithread,
+		                  STRING_CONST("queue"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_start(&threads[ithread]);
+
+	count = 0;
+	start = time_current();
+	while ((count < num_threads * LOCKFREE_ITEMS_PER_THREAD) && (time_elapsed(start) < 30)) {
+		lockfree_item_t* item;
+		node = lockfree_queue_pop(&thread_queue);
+		if (!node) {
+			thread_yield();
+			continue;
+		}
+		item = (lockfree_item_t*)node;
+		EXPECT_LT(item->producer, num_threads);
+		EXPECT_SIZEEQ(item->sequence, next_sequence[item->producer]);
+		++next_sequence[item->producer];
+		++count;
+	}
+
+	test_wait_for_threads_finish(threads, num_threads);
+
+	for (ithread = 0; ithread < num_threads; ++ithread)
+		thread_finalize(&threads[ithread]);
+
+	EXPECT_SIZEEQ(count, num_threads * LOCKFREE_ITEMS_PER_THREAD);
+	EXPECT_EQ(lockfree_queue_pop(&thread_queue), 0);
+
+	return 0;
+}
+
+static void
+test_lockfree_declare(void) {
+	ADD_TEST(lockfree, stack);
+	ADD_TEST(lockfree, stack_threads);
+	ADD_TEST(lockfree, queue);
+	ADD_TEST(lockfree, queue_threads);
+}
+
+static test_suite_t test_lockfree_suite = {
+	test_lockfree_application,
+	test_lockfree_memory_system,
+	test_lockfree_config,
+	test_lockfree_declare,
+	test_lockfree_initialize,
+	test_lockfree_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_lockfree_run(void);
+
+int
+test_lockfree_run(void) {
+	test_suite = test_lockfree_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_lockfree_suite;
+}
+
+#endif
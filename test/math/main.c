@@ -443,6 +443,122 @@ DECLARE_TEST(math, exponentials) {
 	return 0;
 }
 
+//Maximum error of batch results relative to the reference, in absolute terms for results
+//close to zero
+static double
+test_math_batch_error32(const float32_t* result, const float32_t* in, size_t count,
+                        double (*reference)(double)) {
+	double max_error = 0;
+	size_t ival;
+	for (ival = 0; ival < count; ++ival) {
+		double expect = reference((double)in[ival]);
+		double error = fabs((double)result[ival] - expect);
+		if (fabs(expect) > 1.0)
+			error /= fabs(expect);
+		if (!(error <= max_error))
+			max_error = error;
+	}
+	return max_error;
+}
+
+static double
+test_math_rsqrt(double x) {
+	return 1.0 / sqrt(x);
+}
+
+DECLARE_TEST(math, batch) {
+	float32_t in[1003];
+	float32_t out[1003];
+	float64_t in64[1003];
+	float64_t out64[1003];
+	float32_t special[6] = {0.0f, -1.0f, HUGE_VALF, -HUGE_VALF, NAN, 1.0f};
+	float32_t special_out[6];
+	size_t ival;
+	int iacc;
+
+	for (iacc = 0; iacc < 2; ++iacc) {
+		math_accuracy_t accuracy = (math_accuracy_t)iacc;
+		double limit = (accuracy == MATH_ACCURACY_PRECISE) ? 3e-7 : 2e-4;
+
+		//Odd count to exercise the partial vector at the end
+		for (ival = 0; ival < 1003; ++ival)
+			in[ival] = (float32_t)((double)ival * 0.0731 - 36.0);
+		in[7] = 5000.0f;
+		in[8] = -123456.0f;
+		math_batch_sin32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, sin), limit);
+		math_batch_cos32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, cos), limit);
+
+		for (ival = 0; ival < 1003; ++ival)
+			in[ival] = (float32_t)((double)ival * 0.19 - 102.0);
+		math_batch_exp32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, exp), limit);
+
+		for (ival = 0; ival < 1003; ++ival)
+			in[ival] = (float32_t)exp((double)ival * 0.17 - 100.0);
+		in[0] = 1e-40f;
+		math_batch_log32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, log), limit);
+		math_batch_sqrt32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, sqrt), 1e-7);
+		math_batch_rsqrt32(out, in, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, test_math_rsqrt), limit);
+
+		//In place
+		memcpy(out, in, sizeof(in));
+		math_batch_log32(out, out, 1003, accuracy);
+		EXPECT_LE(test_math_batch_error32(out, in, 1003, log), limit);
+
+		math_batch_log32(special_out, special, 6, accuracy);
+		EXPECT_TRUE(special_out[0] == -HUGE_VALF);
+		EXPECT_TRUE(math_real_is_nan(special_out[1]));
+		EXPECT_TRUE(special_out[2] == HUGE_VALF);
+		EXPECT_TRUE(math_real_is_nan(special_out[3]));
+		EXPECT_TRUE(math_real_is_nan(special_out[4]));
+		EXPECT_TRUE(special_out[5] == 0.0f);
+		math_batch_exp32(special_out, special, 6, accuracy);
+		EXPECT_TRUE(special_out[0] == 1.0f);
+		EXPECT_TRUE(special_out[2] == HUGE_VALF);
+		EXPECT_TRUE(special_out[3] == 0.0f);
+		EXPECT_TRUE(math_real_is_nan(special_out[4]));
+		math_batch_sin32(special_out, special, 6, accuracy);
+		EXPECT_TRUE(special_out[0] == 0.0f);
+		EXPECT_TRUE(math_real_is_nan(special_out[2]));
+		EXPECT_TRUE(math_real_is_nan(special_out[4]));
+
+		for (ival = 0; ival < 1003; ++ival)
+			in64[ival] = (double)ival * 0.0731 - 36.0;
+		math_batch_sin64(out64, in64, 1003, accuracy);
+		math_batch_cos64(out64 + 500, in64 + 500, 503, accuracy);
+		for (ival = 0; ival < 1003; ++ival) {
+			double expect = (ival < 500) ? sin(in64[ival]) : cos(in64[ival]);
+			//Fast math builds may call the vector math library on either side, allow an ulp
+			if (accuracy == MATH_ACCURACY_PRECISE)
+				EXPECT_LE(fabs(out64[ival] - expect), 1e-15);
+			else
+				EXPECT_LE(fabs(out64[ival] - expect), 1e-5);
+		}
+
+		for (ival = 0; ival < 1003; ++ival)
+			in64[ival] = (double)ival * 0.07 + 0.01;
+		math_batch_exp64(out64, in64, 1003, accuracy);
+		for (ival = 0; ival < 1003; ++ival)
+			EXPECT_LE(fabs(out64[ival] - exp(in64[ival])) / exp(in64[ival]), limit);
+		math_batch_log64(out64, in64, 1003, accuracy);
+		for (ival = 0; ival < 1003; ++ival)
+			EXPECT_LE(fabs(out64[ival] - log(in64[ival])), limit * 5);
+		math_batch_sqrt64(out64, in64, 1003, accuracy);
+		for (ival = 0; ival < 1003; ++ival)
+			EXPECT_TRUE(out64[ival] == sqrt(in64[ival]));
+		math_batch_rsqrt64(out64, in64, 1003, accuracy);
+		for (ival = 0; ival < 1003; ++ival)
+			EXPECT_LE(fabs(out64[ival] * sqrt(in64[ival]) - 1.0), 1e-15);
+	}
+
+	return 0;
+}
+
 DECLARE_TEST(math, wrap) {
 	int32_t min32, max32;
 	int64_t min64, max64;
@@ -519,6 +635,7 @@ test_math_declare(void) {
 	ADD_TEST(math, squareroot);
 	ADD_TEST(math, utility);
 	ADD_TEST(math, exponentials);
+	ADD_TEST(math, batch);
 	ADD_TEST(math, wrap);
 }
 
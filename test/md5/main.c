@@ -121,6 +121,48 @@ DECLARE_TEST(md5, reference) {
 	return 0;
 }
 
+DECLARE_TEST(md5, multi) {
+	const void* buffers[64];
+	size_t sizes[64];
+	uint128_t digests[64];
+	md5_t md5;
+	size_t ibuf, count;
+
+	memset(buffers, 0, sizeof(buffers));
+	memset(sizes, 0, sizeof(sizes));
+
+	//Sizes around block and padding boundaries, more buffers than lanes to refill lanes
+	for (count = 0; count <= 64; count += (count < 8) ? 1 : 19) {
+		for (ibuf = 0; ibuf < count; ++ibuf) {
+			buffers[ibuf] = digest_test_string + (ibuf * 7);
+			sizes[ibuf] = (ibuf * 29) % 1500;
+			if (ibuf & 1)
+				sizes[ibuf] = 48 + (ibuf % 24);
+		}
+		md5_digest_multi(buffers, sizes, count, digests);
+		for (ibuf = 0; ibuf < count; ++ibuf) {
+			md5_initialize(&md5);
+			md5_digest(&md5, buffers[ibuf], sizes[ibuf]);
+			md5_digest_finalize(&md5);
+			EXPECT_TRUE(uint128_equal(digests[ibuf], md5_get_digest_raw(&md5)));
+			md5_finalize(&md5);
+		}
+	}
+
+	buffers[0] = digest_test_string;
+	sizes[0] = 2000;
+	buffers[1] = "";
+	sizes[1] = 0;
+	md5_digest_multi(buffers, sizes, 2, digests);
+	EXPECT_TRUE(uint128_equal(digests[0], uint128_make(0x230e0a23943c7d13ULL,
+	                                                   0xd2ccac7ec9df4d0cULL)));
+	md5_initialize(&md5);
+	md5_digest_finalize(&md5);
+	EXPECT_TRUE(uint128_equal(digests[1], md5_get_digest_raw(&md5)));
+
+	return 0;
+}
+
 DECLARE_TEST(md5, streams) {
 	stream_t* test_stream;
 	stream_t* unix_stream;
@@ -230,6 +272,7 @@ static void
 test_md5_declare(void) {
 	ADD_TEST(md5, empty);
 	ADD_TEST(md5, reference);
+	ADD_TEST(md5, multi);
 	ADD_TEST(md5, streams);
 }
 
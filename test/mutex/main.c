@@ -202,11 +202,57 @@ DECLARE_TEST(mutex, signal) {
 	return 0;
 }
 
+static void*
+mutex_contend_thread(void* arg) {
+	mutex_t* mutex = arg;
+	mutex_lock(mutex);
+	mutex_unlock(mutex);
+	return 0;
+}
+
+DECLARE_TEST(mutex, statistics) {
+	mutex_t* mutex;
+	thread_t thread;
+	lock_statistics_t statistics;
+
+	mutex = mutex_allocate(STRING_CONST("test"));
+
+	EXPECT_TRUE(mutex_lock(mutex));
+	EXPECT_TRUE(mutex_unlock(mutex));
+
+	EXPECT_TRUE(mutex_lock(mutex));
+	thread_initialize(&thread, mutex_contend_thread, mutex, STRING_CONST("mutex_contend"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	test_wait_for_threads_startup(&thread, 1);
+	thread_sleep(100);
+	EXPECT_TRUE(mutex_unlock(mutex));
+	test_wait_for_threads_finish(&thread, 1);
+	thread_finalize(&thread);
+
+	statistics = mutex_statistics(mutex);
+#if BUILD_ENABLE_LOCK_STATISTICS
+	EXPECT_EQ(statistics.acquisitions, 3);
+	EXPECT_EQ(statistics.contentions, 1);
+	EXPECT_TICKGT(statistics.wait_ticks, 0);
+	EXPECT_TICKEQ(statistics.peak_wait_ticks, statistics.wait_ticks);
+	EXPECT_EQ(statistics.holder, thread_id());
+#else
+	EXPECT_EQ(statistics.acquisitions, 0);
+	EXPECT_EQ(statistics.contentions, 0);
+#endif
+
+	mutex_deallocate(mutex);
+
+	return 0;
+}
+
 static void
 test_mutex_declare(void) {
 	ADD_TEST(mutex, basic);
 	ADD_TEST(mutex, sync);
 	ADD_TEST(mutex, signal);
+	ADD_TEST(mutex, statistics);
 }
 
 static test_suite_t test_mutex_suite = {
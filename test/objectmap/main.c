@@ -178,6 +178,257 @@ DECLARE_TEST(objectmap, store) {
 	return 0;
 }
 
+DECLARE_TEST(objectmap, growable) {
+	objectmap_t* map;
+	object_base_t objects[100];
+	object_t id;
+	size_t iobj;
+
+	map = objectmap_allocate_growable(10, 6);
+	EXPECT_SIZEEQ(objectmap_size(map), 16);
+
+	for (iobj = 0; iobj < 96; ++iobj) {
+		atomic_store32(&objects[iobj].ref, 1);
+		objects[iobj].id = objectmap_reserve(map);
+		EXPECT_TYPENE(objects[iobj].id, 0, object_t, PRIx64);
+		EXPECT_TRUE(objectmap_set(map, objects[iobj].id, objects + iobj));
+	}
+	EXPECT_SIZEEQ(objectmap_size(map), 96);
+
+	log_enable_stdout(false);
+	EXPECT_TYPEEQ(objectmap_reserve(map), 0, object_t, PRIx64);
+	log_enable_stdout(true);
+
+	//Existing slots are not moved by growth
+	for (iobj = 0; iobj < 96; ++iobj) {
+		EXPECT_EQ(objectmap_lookup(map, objects[iobj].id), objects + iobj);
+		EXPECT_EQ(objectmap_raw_lookup(map, objects[iobj].id & map->mask_index), objects + iobj);
+	}
+
+	id = objects[40].id;
+	EXPECT_TRUE(objectmap_free(map, id));
+	EXPECT_EQ(objectmap_lookup(map, id), 0);
+	objects[40].id = objectmap_reserve(map);
+	EXPECT_TYPENE(objects[40].id, id, object_t, PRIx64);
+	EXPECT_TYPEEQ(objects[40].id & map->mask_index, id & map->mask_index, object_t, PRIx64);
+	EXPECT_EQ(objectmap_lookup(map, id), 0);
+	objectmap_set(map, objects[40].id, objects + 40);
+
+	for (iobj = 0; iobj < 96; ++iobj)
+		EXPECT_TRUE(objectmap_free(map, objects[iobj].id));
+
+	objectmap_deallocate(map);
+
+	return 0;
+}
+
+DECLARE_TEST(objectmap, magazine) {
+	objectmap_t* map;
+	objectmap_magazine_t magazine;
+	object_base_t objects[100];
+	size_t iobj, iloop;
+
+	map = objectmap_allocate_growable(16, 16);
+	objectmap_magazine_initialize(&magazine, map);
+
+	for (iloop = 0; iloop < 4; ++iloop) {
+		for (iobj = 0; iobj < 100; ++iobj) {
+			atomic_store32(&objects[iobj].ref, 1);
+			objects[iobj].id = objectmap_magazine_reserve(&magazine);
+			EXPECT_TYPENE(objects[iobj].id, 0, object_t, PRIx64);
+			EXPECT_EQ(objectmap_lookup(map, objects[iobj].id), 0);
+			EXPECT_TRUE(objectmap_set(map, objects[iobj].id, objects + iobj));
+		}
+		for (iobj = 0; iobj < 100; ++iobj)
+			EXPECT_EQ(objectmap_lookup(map, objects[iobj].id), objects + iobj);
+		for (iobj = 0; iobj < 100; iobj += 2)
+			EXPECT_TRUE(objectmap_magazine_free(&magazine, objects[iobj].id));
+		for (iobj = 1; iobj < 100; iobj += 2)
+			EXPECT_TRUE(objectmap_free(map, objects[iobj].id));
+		for (iobj = 0; iobj < 100; ++iobj) {
+			EXPECT_EQ(objectmap_lookup(map, objects[iobj].id), 0);
+			EXPECT_FALSE(objectmap_magazine_free(&magazine, objects[iobj].id));
+		}
+	}
+	EXPECT_SIZELE(objectmap_size(map), 160);
+
+	objectmap_magazine_finalize(&magazine);
+	objectmap_deallocate(map);
+
+	return 0;
+}
+
+DECLARE_TEST(objectmap, iterate) {
+	objectmap_t* map;
+	object_base_t objects[40];
+	object_t unset;
+	size_t iobj, index, count;
+	void* object;
+
+	map = objectmap_allocate_growable(16, 4);
+
+	index = 0;
+	EXPECT_EQ(objectmap_next(map, &index), 0);
+
+	for (iobj = 0; iobj < 40; ++iobj) {
+		atomic_store32(&objects[iobj].ref, 1);
+		objects[iobj].id = objectmap_reserve(map);
+		objectmap_set(map, objects[iobj].id, objects + iobj);
+	}
+	unset = objectmap_reserve(map);
+	for (iobj = 0; iobj < 40; iobj += 3)
+		objectmap_free(map, objects[iobj].id);
+
+	index = 0;
+	count = 0;
+	while ((object = objectmap_next(map, &index))) {
+		object_base_t* base = object;
+		EXPECT_NE((size_t)(base - objects) % 3, 0);
+		EXPECT_EQ(objectmap_lookup(map, base->id), object);
+		++count;
+	}
+	EXPECT_SIZEEQ(count, 26);
+	EXPECT_SIZEEQ(index, objectmap_size(map));
+	EXPECT_EQ(objectmap_next(map, &index), 0);
+
+	for (iobj = 0; iobj < 40; ++iobj) {
+		if (iobj % 3)
+			objectmap_free(map, objects[iobj].id);
+	}
+	objects[0].id = unset;
+	objectmap_set(map, unset, objects);
+	objectmap_free(map, unset);
+
+	objectmap_deallocate(map);
+
+	return 0;
+}
+
+typedef struct {
+	FOUNDATION_DECLARE_OBJECT;
+	atomic32_t alive;
+} epoch_object_t;
+
+static atomic32_t epoch_deallocated;
+
+static void
+epoch_object_deallocate(object_t id, void* object) {
+	epoch_object_t* epoch_object = object;
+	FOUNDATION_UNUSED(id);
+	atomic_store32(&epoch_object->alive, 0);
+	atomic_incr32(&epoch_deallocated);
+	memory_deallocate(object);
+}
+
+static epoch_object_t*
+epoch_object_allocate(objectmap_t* map) {
+	epoch_object_t* object = memory_allocate(0, sizeof(epoch_object_t), 16, MEMORY_PERSISTENT);
+	atomic_store32(&object->ref, 1);
+	atomic_store32(&object->alive, 1);
+	object->id = objectmap_reserve(map);
+	objectmap_set(map, object->id, object);
+	return object;
+}
+
+typedef struct {
+	objectmap_t* map;
+	atomicptr_t* current;
+	atomic32_t* done;
+	size_t lookups;
+} epoch_reader_arg_t;
+
+static void*
+objectmap_epoch_reader(void* arg) {
+	epoch_reader_arg_t* reader = arg;
+	while (!atomic_load32(reader->done)) {
+		objectmap_read_begin();
+		{
+			epoch_object_t* current = atomic_loadptr(reader->current);
+			epoch_object_t* object = objectmap_lookup(reader->map, current->id);
+			if (object) {
+				thread_yield();
+				EXPECT_INTEQ(atomic_load32(&object->alive), 1);
+				++reader->lookups;
+			}
+		}
+		objectmap_read_end();
+	}
+	return 0;
+}
+
+DECLARE_TEST(objectmap, epoch) {
+	objectmap_t* map;
+	epoch_object_t* object;
+	epoch_object_t* replace;
+	thread_t thread[8];
+	epoch_reader_arg_t reader[8];
+	atomicptr_t current;
+	atomic32_t done;
+	size_t ith, iloop;
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 2, 8);
+
+	map = objectmap_allocate(256);
+	atomic_store32(&epoch_deallocated, 0);
+
+	//Deallocation is deferred until read section ends
+	object = epoch_object_allocate(map);
+	objectmap_read_begin();
+	EXPECT_EQ(objectmap_lookup(map, object->id), object);
+	EXPECT_TRUE(objectmap_free_deferred(map, object->id, epoch_object_deallocate));
+	EXPECT_EQ(objectmap_lookup(map, object->id), 0);
+	EXPECT_FALSE(objectmap_free_deferred(map, object->id, epoch_object_deallocate));
+	EXPECT_SIZEEQ(objectmap_reclaim(), 0);
+	EXPECT_INTEQ(atomic_load32(&object->alive), 1);
+	objectmap_read_end();
+	EXPECT_SIZEEQ(objectmap_reclaim(), 1);
+	EXPECT_INTEQ(atomic_load32(&epoch_deallocated), 1);
+	EXPECT_SIZEEQ(objectmap_reclaim(), 0);
+
+	//Replace object while readers look it up concurrently
+	object = epoch_object_allocate(map);
+	atomic_storeptr(&current, object);
+	atomic_store32(&done, 0);
+	for (ith = 0; ith < num_threads; ++ith) {
+		reader[ith].map = map;
+		reader[ith].current = &current;
+		reader[ith].done = &done;
+		reader[ith].lookups = 0;
+		thread_initialize(&thread[ith], objectmap_epoch_reader, reader + ith,
+		                  STRING_CONST("objectmap_reader"), THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+
+	for (iloop = 0; iloop < 2000; ++iloop) {
+		replace = epoch_object_allocate(map);
+		atomic_storeptr(&current, replace);
+		EXPECT_TRUE(objectmap_free_deferred(map, object->id, epoch_object_deallocate));
+		object = replace;
+		if (!(iloop % 64))
+			thread_yield();
+	}
+
+	atomic_store32(&done, 1);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith) {
+		EXPECT_EQ(thread[ith].result, 0);
+		thread_finalize(&thread[ith]);
+	}
+
+	//No readers left, all pending deallocations can run
+	objectmap_reclaim();
+	EXPECT_INTEQ(atomic_load32(&epoch_deallocated), 2001);
+
+	objectmap_free(map, object->id);
+	memory_deallocate(object);
+	objectmap_deallocate(map);
+
+	return 0;
+}
+
 static void*
 objectmap_thread(void* arg) {
 	objectmap_t* map;
@@ -262,11 +513,82 @@ DECLARE_TEST(objectmap, thread) {
 	return 0;
 }
 
+static void*
+objectmap_magazine_thread(void* arg) {
+	objectmap_t* map = arg;
+	objectmap_magazine_t magazine;
+	object_base_t* objects;
+	int obj;
+	int loop;
+
+	objects = memory_allocate(0, sizeof(object_base_t) * 512, 16,
+	                          MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	objectmap_magazine_initialize(&magazine, map);
+
+	for (loop = 0; loop < 32; ++loop) {
+		for (obj = 0; obj < 512; ++obj) {
+			atomic_store32(&objects[obj].ref, 1);
+			objects[obj].id = objectmap_magazine_reserve(&magazine);
+			EXPECT_NE_MSGFORMAT(objects[obj].id, 0, "Unable to reserve slot for object num %d", obj);
+			EXPECT_TRUE(objectmap_set(map, objects[obj].id, objects + obj));
+		}
+
+		thread_yield();
+
+		for (obj = 0; obj < 512; ++obj) {
+			EXPECT_EQ_MSGFORMAT(objectmap_lookup(map, objects[obj].id), objects + obj,
+			                    "Object %d (%" PRIx64 ") was not set at reserved slot in map in loop %d",
+			                    obj, objects[obj].id, loop);
+			EXPECT_TRUE(objectmap_magazine_free(&magazine, objects[obj].id));
+			EXPECT_EQ(objectmap_lookup(map, objects[obj].id), 0);
+		}
+	}
+
+	objectmap_magazine_finalize(&magazine);
+	memory_deallocate(objects);
+
+	return 0;
+}
+
+DECLARE_TEST(objectmap, thread_magazine) {
+	objectmap_t* map;
+	thread_t thread[32];
+	size_t ith;
+	size_t num_threads = math_clamp(system_hardware_threads() * 4, 4, 32);
+
+	//Start small and let threads grow the map concurrently
+	map = objectmap_allocate_growable(256, (num_threads + 1) * 4);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], objectmap_magazine_thread, map,
+		                  STRING_CONST("objectmap_thread"), THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		EXPECT_EQ(thread[ith].result, 0);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_finalize(&thread[ith]);
+
+	objectmap_deallocate(map);
+
+	return 0;
+}
+
 static void
 test_objectmap_declare(void) {
 	ADD_TEST(objectmap, initialize);
 	ADD_TEST(objectmap, store);
+	ADD_TEST(objectmap, growable);
+	ADD_TEST(objectmap, magazine);
 	ADD_TEST(objectmap, thread);
+	ADD_TEST(objectmap, thread_magazine);
+	ADD_TEST(objectmap, iterate);
+	ADD_TEST(objectmap, epoch);
 }
 
 static test_suite_t test_objectmap_suite = {
@@ -0,0 +1,276 @@
+/* main.c  -  Foundation pack test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+#define TEST_DATA_SIZE (256 * 1024)
+#define TEST_ENTRY_COUNT 300
+
+static uint8_t test_data[TEST_DATA_SIZE];
+
+static application_t
+test_pack_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation pack tests"));
+	app.short_name = string_const(STRING_CONST("test_pack"));
+	app.config_dir = string_const(STRING_CONST("test_pack"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_pack_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_pack_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_pack_initialize(void) {
+	size_t i;
+	//Compressible data with some variation
+	for (i = 0; i < TEST_DATA_SIZE; ++i)
+		test_data[i] = (uint8_t)((i / 7) ^ (i >> 10));
+	return 0;
+}
+
+static void
+test_pack_finalize(void) {
+}
+
+static string_t
+test_pack_write(pack_builder_t* builder) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_const_t directory;
+	stream_t* file;
+
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	file = fs_open_file(STRING_ARGS(path), STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                    STREAM_TRUNCATE);
+	if (file) {
+		if (!pack_builder_write(builder, file))
+			log_warn(HASH_TEST, WARNING_SUSPICIOUS, STRING_CONST("Unable to write pack file"));
+		stream_deallocate(file);
+	}
+
+	return string_clone(STRING_ARGS(path));
+}
+
+DECLARE_TEST(pack, entries) {
+	pack_builder_t* builder;
+	pack_t* pack;
+	string_t path;
+	string_const_t name;
+	const void* data;
+	stream_t* stream;
+	char name_buffer[64];
+	char read_buffer[256];
+	size_t ientry, size;
+
+	builder = pack_builder_allocate();
+	for (ientry = 0; ientry < TEST_ENTRY_COUNT; ++ientry) {
+		name = string_to_const(string_format(name_buffer, sizeof(name_buffer),
+		                                     STRING_CONST("dir%" PRIsize "/file%" PRIsize ".dat"),
+		                                     ientry % 7, ientry));
+		EXPECT_TRUE(pack_builder_add(builder, STRING_ARGS(name), test_data + ientry, ientry, 0));
+	}
+	EXPECT_FALSE(pack_builder_add(builder, STRING_CONST("/dir0/file0.dat"), test_data, 10, 0));
+	EXPECT_FALSE(pack_builder_add(builder, STRING_CONST("/"), test_data, 10, 0));
+	EXPECT_TRUE(pack_builder_add(builder, STRING_CONST("/big.dat"), test_data, TEST_DATA_SIZE,
+	                             PACK_ENTRY_COMPRESSED));
+	EXPECT_TRUE(pack_builder_add(builder, STRING_CONST("empty.dat"), 0, 0, PACK_ENTRY_COMPRESSED));
+	path = test_pack_write(builder);
+	pack_builder_deallocate(builder);
+
+	pack = pack_open(STRING_ARGS(path));
+	EXPECT_NE(pack, 0);
+	EXPECT_SIZEEQ(pack_entry_count(pack), TEST_ENTRY_COUNT + 2);
+	EXPECT_CONSTSTRINGEQ(pack_entry_name(pack, TEST_ENTRY_COUNT), string_const(STRING_CONST("big.dat")));
+
+	//Uncompressed entries are aligned and accessed in place
+	for (ientry = 0; ientry < TEST_ENTRY_COUNT; ++ientry) {
+		name = string_to_const(string_format(name_buffer, sizeof(name_buffer),
+		                                     STRING_CONST("/dir%" PRIsize "/file%" PRIsize ".dat"),
+		                                     ientry % 7, ientry));
+		EXPECT_TRUE(pack_has_entry(pack, STRING_ARGS(name)));
+		data = pack_entry_data(pack, STRING_ARGS(name), &size);
+		EXPECT_SIZEEQ(size, ientry);
+		if (ientry) {
+			EXPECT_EQ((uintptr_t)data & 63, 0);
+			EXPECT_EQ(memcmp(data, test_data + ientry, ientry), 0);
+		}
+
+		stream = pack_open_entry(pack, STRING_ARGS(name), STREAM_IN | STREAM_BINARY);
+		EXPECT_NE(stream, 0);
+		EXPECT_SIZEEQ(stream_size(stream), ientry);
+		EXPECT_SIZEEQ(stream_read(stream, read_buffer, sizeof(read_buffer)),
+		              (ientry < sizeof(read_buffer)) ? ientry : sizeof(read_buffer));
+		EXPECT_EQ(memcmp(read_buffer, test_data + ientry,
+		                 (ientry < sizeof(read_buffer)) ? ientry : sizeof(read_buffer)), 0);
+		stream_deallocate(stream);
+	}
+	EXPECT_FALSE(pack_has_entry(pack, STRING_CONST("dir0/file1.dat")));
+	EXPECT_EQ(pack_open_entry(pack, STRING_CONST("missing"), STREAM_IN), 0);
+	EXPECT_EQ(pack_open_entry(pack, STRING_CONST("big.dat"), STREAM_IN | STREAM_OUT), 0);
+
+	//Compressed entries are decompressed when read
+	EXPECT_EQ(pack_entry_data(pack, STRING_CONST("big.dat"), &size), 0);
+	stream = pack_open_entry(pack, STRING_CONST("big.dat"), STREAM_IN | STREAM_BINARY);
+	EXPECT_NE(stream, 0);
+	EXPECT_SIZEEQ(stream_size(stream), TEST_DATA_SIZE);
+	EXPECT_UINTEQ(stream_checksum(stream, CHECKSUM_XXHASH64),
+	              checksum(CHECKSUM_XXHASH64, test_data, TEST_DATA_SIZE));
+	stream_seek(stream, 100000, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, read_buffer, sizeof(read_buffer)), sizeof(read_buffer));
+	EXPECT_EQ(memcmp(read_buffer, test_data + 100000, sizeof(read_buffer)), 0);
+	stream_deallocate(stream);
+	EXPECT_SIZELT(fs_size(STRING_ARGS(path)), TEST_DATA_SIZE);
+
+	stream = pack_open_entry(pack, STRING_CONST("empty.dat"), STREAM_IN | STREAM_BINARY);
+	EXPECT_NE(stream, 0);
+	EXPECT_SIZEEQ(stream_size(stream), 0);
+	EXPECT_TRUE(stream_eos(stream));
+	stream_deallocate(stream);
+
+	pack_close(pack);
+	fs_remove_file(STRING_ARGS(path));
+	string_deallocate(path.str);
+
+	return 0;
+}
+
+DECLARE_TEST(pack, protocol) {
+	pack_builder_t* builder;
+	pack_t* base;
+	pack_t* patch;
+	string_t base_path;
+	string_t patch_path;
+	stream_t* stream;
+	char buffer[64];
+
+	builder = pack_builder_allocate();
+	pack_builder_add(builder, STRING_CONST("config.ini"), STRING_CONST("base config"), 0);
+	pack_builder_add(builder, STRING_CONST("data/base.txt"), STRING_CONST("base data"),
+	                 PACK_ENTRY_COMPRESSED);
+	base_path = test_pack_write(builder);
+	pack_builder_deallocate(builder);
+
+	builder = pack_builder_allocate();
+	pack_builder_add(builder, STRING_CONST("config.ini"), STRING_CONST("patch config"), 0);
+	patch_path = test_pack_write(builder);
+	pack_builder_deallocate(builder);
+
+	base = pack_open(STRING_ARGS(base_path));
+	patch = pack_open(STRING_ARGS(patch_path));
+	EXPECT_NE(base, 0);
+	EXPECT_NE(patch, 0);
+
+	EXPECT_EQ(stream_open(STRING_CONST("pack://config.ini"), STREAM_IN), 0);
+
+	pack_mount(base);
+	stream = stream_open(STRING_CONST("pack://config.ini"), STREAM_IN);
+	EXPECT_NE(stream, 0);
+	EXPECT_CONSTSTRINGEQ(stream_path(stream), string_const(STRING_CONST("pack://config.ini")));
+	EXPECT_CONSTSTRINGEQ(string_to_const(stream_read_string_buffer(stream, buffer, sizeof(buffer))),
+	                     string_const(STRING_CONST("base")));
+	stream_deallocate(stream);
+
+	//Most recently mounted pack overrides entries
+	pack_mount(patch);
+	stream = stream_open(STRING_CONST("pack:///config.ini"), STREAM_IN);
+	EXPECT_NE(stream, 0);
+	EXPECT_CONSTSTRINGEQ(string_to_const(stream_read_line_buffer(stream, buffer, sizeof(buffer), '\n')),
+	                     string_const(STRING_CONST("patch config")));
+	stream_deallocate(stream);
+
+	stream = stream_open(STRING_CONST("pack://data/base.txt"), STREAM_IN);
+	EXPECT_NE(stream, 0);
+	EXPECT_CONSTSTRINGEQ(string_to_const(stream_read_line_buffer(stream, buffer, sizeof(buffer), '\n')),
+	                     string_const(STRING_CONST("base data")));
+	stream_deallocate(stream);
+
+	pack_close(patch);
+	stream = stream_open(STRING_CONST("pack://config.ini"), STREAM_IN);
+	EXPECT_NE(stream, 0);
+	EXPECT_CONSTSTRINGEQ(string_to_const(stream_read_line_buffer(stream, buffer, sizeof(buffer), '\n')),
+	                     string_const(STRING_CONST("base config")));
+	stream_deallocate(stream);
+
+	pack_unmount(base);
+	EXPECT_EQ(stream_open(STRING_CONST("pack://config.ini"), STREAM_IN), 0);
+	pack_close(base);
+
+	//Files that are not packs are rejected
+	log_enable_stdout(false);
+	stream = fs_open_file(STRING_ARGS(patch_path), STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	stream_write_string(stream, STRING_CONST("not a pack file at all, just some text"));
+	stream_deallocate(stream);
+	EXPECT_EQ(pack_open(STRING_ARGS(patch_path)), 0);
+	log_enable_stdout(true);
+
+	fs_remove_file(STRING_ARGS(base_path));
+	fs_remove_file(STRING_ARGS(patch_path));
+	string_deallocate(base_path.str);
+	string_deallocate(patch_path.str);
+
+	return 0;
+}
+
+static void
+test_pack_declare(void) {
+	ADD_TEST(pack, entries);
+	ADD_TEST(pack, protocol);
+}
+
+static test_suite_t test_pack_suite = {
+	test_pack_application,
+	test_pack_memory_system,
+	test_pack_config,
+	test_pack_declare,
+	test_pack_initialize,
+	test_pack_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_pack_run(void);
+
+int
+test_pack_run(void) {
+	test_suite = test_pack_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_pack_suite;
+}
+
+#endif
@@ -606,6 +606,42 @@ DECLARE_TEST(path, clean) {
 	return 0;
 }
 
+DECLARE_TEST(path, is_clean) {
+	static const char* const paths[] = {
+		"", "/", "/.", "./", "..", "/..", "\\", "a", ".a", "..a", "a.", "a..", "/a/b.c/d",
+		"/a//b", "/a/./b", "/a/../b", "/a/b/", "/a/b/.", "/a/b/..", "a/.../b", "./a", "../a",
+		"file://a/b", "file:///a/b", "file:/a", "file:a", ":a", "C:/a", "C://a", "C:\\a",
+		"C:./a", "vfs://test", "vfs://test/", "http://./a", "http://C:/a", "a:b:c/d",
+		"/some/long/path/to/a/file/with/words/longer/than/eight/bytes.extension",
+		"/some/long/path/to/a/file/with/words/longer/than/eight/bytes//extension",
+		"/some/long/path/to/a/file/with/words/longer/than/eight/bytes/./extension",
+		"/some/long/path/to/a/file/with/words/longer/than/eight/bytes\\extension",
+		"/some/long/path/to/a/file/with/words/longer/than/eight/bytes/extension/.."
+	};
+	char buffer[BUILD_MAX_PATHLEN];
+	size_t ipath;
+
+	for (ipath = 0; ipath < sizeof(paths) / sizeof(paths[0]); ++ipath) {
+		string_const_t path = string_const(paths[ipath], string_length(paths[ipath]));
+		string_t cleaned = string_copy(buffer, sizeof(buffer), STRING_ARGS(path));
+		bool clean = path_is_clean(STRING_ARGS(path));
+		//A clean path must come back unmodified from the slow path
+		cleaned = path_clean(STRING_ARGS(cleaned), sizeof(buffer));
+		if (clean)
+			EXPECT_CONSTSTRINGEQ(string_to_const(cleaned), path);
+		//A cleaned path is clean, except for the conservatively rejected leading ".." segments
+		if (!string_equal(cleaned.str, 2, STRING_CONST("..")))
+			EXPECT_TRUE(path_is_clean(STRING_ARGS(cleaned)));
+	}
+
+	EXPECT_TRUE(path_is_clean(STRING_CONST("/a/b.c/d")));
+	EXPECT_TRUE(path_is_clean(STRING_CONST("file://a/b")));
+	EXPECT_FALSE(path_is_clean(STRING_CONST("/a//b")));
+	EXPECT_FALSE(path_is_clean(STRING_CONST("a/../b")));
+
+	return 0;
+}
+
 DECLARE_TEST(path, absolute) {
 	string_t path1;
 	string_t path2;
@@ -936,6 +972,7 @@ static void
 test_path_declare(void) {
 	ADD_TEST(path, extract);
 	ADD_TEST(path, clean);
+	ADD_TEST(path, is_clean);
 	ADD_TEST(path, absolute);
 	ADD_TEST(path, operations);
 	ADD_TEST(path, query);
@@ -182,9 +182,135 @@ DECLARE_TEST(pipe, readwrite) {
 	return 0;
 }
 
+DECLARE_TEST(pipe, splice) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_const_t directory;
+	stream_t* source;
+	stream_t* copy;
+	stream_t* file;
+	unsigned char src_buffer[1024];
+	unsigned char dest_buffer[1024];
+	size_t i;
+
+	if (system_platform() == PLATFORM_PNACL)
+		return 0;
+
+	for (i = 0; i < sizeof(src_buffer); ++i)
+		src_buffer[i] = (unsigned char)(i * 7);
+
+	source = pipe_allocate();
+	copy = pipe_allocate();
+
+	EXPECT_SIZEEQ(stream_write(source, src_buffer, sizeof(src_buffer)), sizeof(src_buffer));
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	//Duplicated data is still available in source pipe
+	EXPECT_SIZEEQ(pipe_tee(copy, source, 0), sizeof(src_buffer));
+	EXPECT_SIZEEQ(stream_read(copy, dest_buffer, sizeof(dest_buffer)), sizeof(dest_buffer));
+	EXPECT_EQ(memcmp(src_buffer, dest_buffer, sizeof(src_buffer)), 0);
+#else
+	EXPECT_SIZEEQ(pipe_tee(copy, source, 0), 0);
+#endif
+	EXPECT_SIZEEQ(pipe_tee(copy, 0, 0), 0);
+	EXPECT_SIZEEQ(pipe_tee(copy, copy, 0), 0);
+
+	//Forward pipe to file
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+	file = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                   STREAM_TRUNCATE);
+	EXPECT_NE(file, 0);
+
+	pipe_close_write(source);
+	EXPECT_SIZEEQ(stream_copy(file, source, 0), sizeof(src_buffer));
+	EXPECT_SIZEEQ(stream_size(file), sizeof(src_buffer));
+	EXPECT_TRUE(stream_eos(source));
+
+	//Forward file to pipe
+	stream_seek(file, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_copy(copy, file, 0), sizeof(src_buffer));
+	memset(dest_buffer, 0, sizeof(dest_buffer));
+	EXPECT_SIZEEQ(stream_read(copy, dest_buffer, sizeof(dest_buffer)), sizeof(dest_buffer));
+	EXPECT_EQ(memcmp(src_buffer, dest_buffer, sizeof(src_buffer)), 0);
+
+	stream_deallocate(file);
+	stream_deallocate(source);
+	stream_deallocate(copy);
+
+	fs_remove_file(STRING_ARGS(path));
+
+	return 0;
+}
+
+DECLARE_TEST(pipe, nonblocking) {
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID || \
+    FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+	stream_t* pipe;
+	beacon_t* beacon;
+	unsigned char* buffer;
+	size_t size = 4 * 1024 * 1024;
+	size_t written, read, chunk;
+	int read_slot, write_slot;
+
+	buffer = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+	memset(buffer, 0x5a, size);
+
+	pipe = pipe_allocate();
+	pipe_set_nonblocking(pipe, true);
+
+	beacon = beacon_allocate();
+	read_slot = beacon_add(beacon, pipe_read_handle(pipe));
+	write_slot = beacon_add_writable(beacon, pipe_write_handle(pipe));
+	EXPECT_INTGT(read_slot, 0);
+	EXPECT_INTGT(write_slot, 0);
+
+	//Empty pipe returns immediately without flagging end of stream
+	EXPECT_SIZEEQ(stream_read(pipe, buffer, 16), 0);
+	EXPECT_FALSE(stream_eos(pipe));
+	EXPECT_INTEQ(beacon_try_wait(beacon, 0), write_slot);
+
+	//Full pipe returns a partial count without flagging end of stream
+	written = stream_write(pipe, buffer, size);
+	EXPECT_SIZEGT(written, 0);
+	EXPECT_SIZELT(written, size);
+	EXPECT_FALSE(stream_eos(pipe));
+	EXPECT_SIZEEQ(stream_write(pipe, buffer, size), 0);
+	EXPECT_FALSE(stream_eos(pipe));
+	EXPECT_INTEQ(beacon_try_wait(beacon, 100), read_slot);
+
+	//Draining the pipe makes it writable again
+	read = 0;
+	do {
+		chunk = stream_read(pipe, buffer, size);
+		read += chunk;
+	}
+	while (chunk);
+	EXPECT_SIZEEQ(read, written);
+	EXPECT_FALSE(stream_eos(pipe));
+	EXPECT_INTEQ(beacon_try_wait(beacon, 100), write_slot);
+
+	beacon_remove(beacon, pipe_write_handle(pipe));
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	EXPECT_SIZEEQ(stream_write(pipe, buffer, 1024), 1024);
+	EXPECT_INTEQ(beacon_try_wait(beacon, 100), read_slot);
+	pipe_close_write(pipe);
+	EXPECT_SIZEEQ(stream_read(pipe, buffer, size), 1024);
+	EXPECT_TRUE(stream_eos(pipe));
+
+	beacon_deallocate(beacon);
+	stream_deallocate(pipe);
+	memory_deallocate(buffer);
+#endif
+	return 0;
+}
+
 static void
 test_pipe_declare(void) {
 	ADD_TEST(pipe, readwrite);
+	ADD_TEST(pipe, splice);
+	ADD_TEST(pipe, nonblocking);
 }
 
 static test_suite_t test_pipe_suite = {
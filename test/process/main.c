@@ -232,10 +232,92 @@ DECLARE_TEST(process, kill) {
 	return 0;
 }
 
+DECLARE_TEST(process, nonblocking) {
+#if FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_MACOSX || FOUNDATION_PLATFORM_BSD
+	process_t proc[16];
+	stream_t* pipes[32];
+	char output[32][64];
+	size_t length[32];
+	string_const_t args[2];
+	char script[64];
+	beacon_t* beacon;
+	size_t iproc, ipipe, open;
+	tick_t start;
+
+	beacon = beacon_allocate();
+	args[0] = string_const(STRING_CONST("-c"));
+
+	//Capture stdout and stderr of all processes from this single thread
+	for (iproc = 0; iproc < 16; ++iproc) {
+		string_t cmd = string_format(script, sizeof(script),
+		                             STRING_CONST("echo out%d; sleep 0.1; echo err%d 1>&2"),
+		                             (int)iproc, (int)iproc);
+		args[1] = string_to_const(cmd);
+
+		process_initialize(proc + iproc);
+		process_set_working_directory(proc + iproc, STRING_CONST("/"));
+		process_set_executable_path(proc + iproc, STRING_CONST("/bin/sh"));
+		process_set_arguments(proc + iproc, args, 2);
+		process_set_flags(proc + iproc, PROCESS_DETACHED | PROCESS_STDSTREAMS | PROCESS_STDERR |
+		                  PROCESS_NONBLOCKING);
+		EXPECT_INTEQ(process_spawn(proc + iproc), PROCESS_STILL_ACTIVE);
+
+		pipes[iproc * 2] = process_stdout(proc + iproc);
+		pipes[(iproc * 2) + 1] = process_stderr(proc + iproc);
+		EXPECT_NE(pipes[iproc * 2], 0);
+		EXPECT_NE(pipes[(iproc * 2) + 1], 0);
+		EXPECT_INTGE(beacon_add(beacon, pipe_read_handle(pipes[iproc * 2])), 0);
+		EXPECT_INTGE(beacon_add(beacon, pipe_read_handle(pipes[(iproc * 2) + 1])), 0);
+	}
+	memset(length, 0, sizeof(length));
+
+	start = time_current();
+	open = 32;
+	while (open && (time_elapsed(start) < 10.0)) {
+		int slots[64];
+		beacon_try_wait_many(beacon, 100, slots, sizeof(slots) / sizeof(slots[0]));
+		for (ipipe = 0; ipipe < 32; ++ipipe) {
+			stream_t* pipe = pipes[ipipe];
+			if (!pipe)
+				continue;
+			//Reads never block, only returning what is available
+			length[ipipe] += stream_read(pipe, output[ipipe] + length[ipipe],
+			                             sizeof(output[ipipe]) - length[ipipe] - 1);
+			if (stream_eos(pipe)) {
+				beacon_remove(beacon, pipe_read_handle(pipe));
+				pipes[ipipe] = 0;
+				--open;
+			}
+		}
+	}
+	EXPECT_SIZEEQ(open, 0);
+
+	for (iproc = 0; iproc < 16; ++iproc) {
+		char expect[16];
+		string_t line;
+		line = string_format(expect, sizeof(expect), STRING_CONST("out%d\n"), (int)iproc);
+		EXPECT_CONSTSTRINGEQ(string_const(output[iproc * 2], length[iproc * 2]),
+		                     string_to_const(line));
+		line = string_format(expect, sizeof(expect), STRING_CONST("err%d\n"), (int)iproc);
+		EXPECT_CONSTSTRINGEQ(string_const(output[(iproc * 2) + 1], length[(iproc * 2) + 1]),
+		                     string_to_const(line));
+
+		while (process_wait(proc + iproc) == PROCESS_STILL_ACTIVE)
+			thread_yield();
+		EXPECT_INTEQ(process_wait(proc + iproc), 0);
+		process_finalize(proc + iproc);
+	}
+
+	beacon_deallocate(beacon);
+#endif
+	return 0;
+}
+
 static void
 test_process_declare(void) {
 	ADD_TEST(process, spawn);
 	ADD_TEST(process, kill);
+	ADD_TEST(process, nonblocking);
 }
 
 static test_suite_t test_process_suite = {
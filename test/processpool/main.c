@@ -0,0 +1,247 @@
+/* main.c  -  Foundation processpool test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static processpool_t* processpool_test;
+
+int
+test_processpool_worker(void);
+
+//Worker side, replies with the job data reversed until stdin is closed
+int
+test_processpool_worker(void) {
+	stream_t* in = stream_open_stdin();
+	stream_t* out = stream_open_stdout();
+	void* job;
+	size_t size;
+
+	while ((job = processpool_worker_receive(in, &size)) != 0) {
+		char* data = job;
+		size_t i;
+		if ((size == 5) && string_equal(data, size, STRING_CONST("crash")))
+			process_exit(PROCESS_EXIT_FAILURE);
+		for (i = 0; i < size / 2; ++i) {
+			char c = data[i];
+			data[i] = data[size - i - 1];
+			data[size - i - 1] = c;
+		}
+		processpool_worker_reply(out, data, size);
+		memory_deallocate(job);
+	}
+
+	stream_deallocate(in);
+	stream_deallocate(out);
+	return 0;
+}
+
+static application_t
+test_processpool_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation processpool tests"));
+	app.short_name = string_const(STRING_CONST("test_processpool"));
+	app.config_dir = string_const(STRING_CONST("test_processpool"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_processpool_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_processpool_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_processpool_initialize(void) {
+	const string_const_t* cmdline = environment_command_line();
+	if (string_array_find(cmdline, array_size(cmdline), STRING_CONST("processpool worker")) < 0)
+		return 0;
+
+	process_exit(test_processpool_worker());
+	return -1;
+}
+
+static void
+test_processpool_finalize(void) {
+}
+
+static bool
+test_processpool_supported(void) {
+	return (system_platform() != PLATFORM_IOS) && (system_platform() != PLATFORM_ANDROID) &&
+	       (system_platform() != PLATFORM_PNACL);
+}
+
+static processpool_t*
+test_processpool_allocate(size_t workers) {
+	string_const_t args[] = { string_const(STRING_CONST("processpool worker")) };
+	return processpool_allocate(STRING_ARGS(environment_executable_path()), args, 1, workers);
+}
+
+static bool
+test_processpool_job(processpool_t* pool, size_t seed) {
+	char request[256];
+	char* response;
+	size_t size, response_size, i;
+	bool valid;
+
+	memset(request, 0, sizeof(request));
+	size = seed % sizeof(request);
+	for (i = 0; i < size; ++i)
+		request[i] = (char)('a' + ((seed + i) % 26));
+
+	response = processpool_execute(pool, request, size, &response_size);
+	valid = (response != 0) && (response_size == size);
+	for (i = 0; valid && (i < size); ++i)
+		valid = (response[i] == request[size - i - 1]);
+	memory_deallocate(response);
+	return valid;
+}
+
+static void*
+processpool_thread(void* arg) {
+	size_t ijob;
+	size_t base = (size_t)(uintptr_t)arg;
+	for (ijob = 0; ijob < 32; ++ijob) {
+		if (!test_processpool_job(processpool_test, base + (ijob * 7)))
+			return FAILED_TEST;
+	}
+	return 0;
+}
+
+DECLARE_TEST(processpool, execute) {
+	processpool_t* pool;
+	size_t ijob;
+
+	if (!test_processpool_supported())
+		return 0;
+
+	pool = test_processpool_allocate(2);
+	EXPECT_NE(pool, 0);
+
+	for (ijob = 0; ijob < 64; ++ijob)
+		EXPECT_TRUE(test_processpool_job(pool, ijob * 5));
+	EXPECT_SIZEEQ(processpool_respawn_count(pool), 0);
+
+	processpool_deallocate(pool);
+
+	return 0;
+}
+
+DECLARE_TEST(processpool, concurrent) {
+	thread_t thread[8];
+	size_t ithread;
+
+	if (!test_processpool_supported())
+		return 0;
+
+	processpool_test = test_processpool_allocate(4);
+	EXPECT_NE(processpool_test, 0);
+
+	for (ithread = 0; ithread < 8; ++ithread)
+		thread_initialize(&thread[ithread], processpool_thread, (void*)(uintptr_t)(ithread * 31),
+		                  STRING_CONST("processpool"), THREAD_PRIORITY_NORMAL, 0);
+	for (ithread = 0; ithread < 8; ++ithread)
+		thread_start(&thread[ithread]);
+
+	test_wait_for_threads_startup(thread, 8);
+	test_wait_for_threads_finish(thread, 8);
+
+	for (ithread = 0; ithread < 8; ++ithread) {
+		EXPECT_EQ(thread[ithread].result, 0);
+		thread_finalize(&thread[ithread]);
+	}
+	EXPECT_SIZEEQ(processpool_respawn_count(processpool_test), 0);
+
+	processpool_deallocate(processpool_test);
+	processpool_test = 0;
+
+	return 0;
+}
+
+DECLARE_TEST(processpool, respawn) {
+	processpool_t* pool;
+	void* response;
+	size_t response_size;
+	size_t ijob;
+
+	if (!test_processpool_supported())
+		return 0;
+
+	pool = test_processpool_allocate(1);
+	EXPECT_NE(pool, 0);
+
+	EXPECT_TRUE(test_processpool_job(pool, 17));
+
+	log_enable_stdout(false);
+	response = processpool_execute(pool, STRING_CONST("crash"), &response_size);
+	log_enable_stdout(true);
+	EXPECT_EQ(response, 0);
+	EXPECT_SIZEEQ(response_size, 0);
+	EXPECT_SIZEEQ(processpool_respawn_count(pool), 1);
+
+	//Respawned worker handles following jobs
+	for (ijob = 0; ijob < 8; ++ijob)
+		EXPECT_TRUE(test_processpool_job(pool, ijob * 3));
+	EXPECT_SIZEEQ(processpool_respawn_count(pool), 1);
+
+	processpool_deallocate(pool);
+
+	return 0;
+}
+
+static void
+test_processpool_declare(void) {
+	ADD_TEST(processpool, execute);
+	ADD_TEST(processpool, concurrent);
+	ADD_TEST(processpool, respawn);
+}
+
+static test_suite_t test_processpool_suite = {
+	test_processpool_application,
+	test_processpool_memory_system,
+	test_processpool_config,
+	test_processpool_declare,
+	test_processpool_initialize,
+	test_processpool_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_processpool_run(void);
+
+int
+test_processpool_run(void) {
+	test_suite = test_processpool_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_processpool_suite;
+}
+
+#endif
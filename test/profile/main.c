@@ -353,12 +353,329 @@ DECLARE_TEST(profile, stream) {
 	return 0;
 }
 
+DECLARE_TEST(profile, trace) {
+	stream_t* stream;
+	char* trace;
+	size_t size;
+
+	error(); //Clear error
+
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+
+	profile_initialize(STRING_CONST("test_\"profile\""), _test_profile_buffer,
+	                   TEST_PROFILE_BUFFER_SIZE);
+	profile_set_output_stream(stream);
+	profile_set_output_wait(10);
+	profile_enable(true);
+
+	profile_begin_block(STRING_CONST("Trace block"));
+	profile_log(STRING_CONST("This is a profile log line long enough to span multiple blocks"));
+	profile_lock(STRING_CONST("Trace lock"));
+	profile_end_block();
+	profile_end_frame(42);
+
+	thread_sleep(100);
+
+	profile_enable(false);
+	profile_finalize();
+	profile_set_output_stream(0);
+
+	size = (size_t)stream_size(stream);
+	trace = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, trace, size), size);
+	stream_deallocate(stream);
+
+#if BUILD_ENABLE_PROFILE
+	EXPECT_GE(size, 4);
+	EXPECT_INTEQ(trace[0], '[');
+	EXPECT_STRINGEQ(string(trace + size - 3, 3), string_const(STRING_CONST("\n]\n")));
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"name\":\"test_\\\"profile\\\"\""), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("{\"name\":\"Trace block\",\"cat\":\"block\",\"ph\":\"X\""), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size,
+	                                 STRING_CONST("{\"name\":\"This is a profile log line long enough to span multiple blocks\""), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"object\":\"Trace lock\""), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"frame\":42"), 0), STRING_NPOS);
+#else
+	EXPECT_SIZEEQ(size, 0);
+#endif
+
+	memory_deallocate(trace);
+
+	EXPECT_EQ(error(), ERROR_NONE);
+
+	return 0;
+}
+
+DECLARE_TEST(profile, counter) {
+	stream_t* stream;
+	char* trace;
+	size_t size;
+	int icount;
+
+	error(); //Clear error
+
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+
+	profile_initialize(STRING_CONST("test_profile"), _test_profile_buffer,
+	                   TEST_PROFILE_BUFFER_SIZE);
+	profile_set_output_stream(stream);
+	profile_set_output_wait(10);
+	profile_enable(true);
+
+	profile_gauge(STRING_CONST("Queue depth"), 17);
+	for (icount = 0; icount < 5; ++icount)
+		profile_counter(STRING_CONST("Events"), 3);
+	profile_end_frame(1);
+	profile_end_frame(2);
+
+	thread_sleep(100);
+
+	profile_enable(false);
+	profile_finalize();
+	profile_set_output_stream(0);
+
+	size = (size_t)stream_size(stream);
+	trace = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, trace, size), size);
+	stream_deallocate(stream);
+
+#if BUILD_ENABLE_PROFILE
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("{\"name\":\"Queue depth\",\"cat\":\"counter\",\"ph\":\"C\""), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"args\":{\"value\":17}"), 0),
+	              STRING_NPOS);
+	//Accumulated in first frame, reset for second frame
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"args\":{\"value\":15}"), 0),
+	              STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"args\":{\"value\":0}"), 0),
+	              STRING_NPOS);
+#else
+	EXPECT_SIZEEQ(size, 0);
+#endif
+
+	memory_deallocate(trace);
+
+	EXPECT_EQ(error(), ERROR_NONE);
+
+	return 0;
+}
+
+static FOUNDATION_NOINLINE uint64_t
+test_profile_sample_spin(tick_t duration) {
+	uint64_t count = 0;
+	tick_t start = time_current();
+	while (time_elapsed_ticks(start) < duration)
+		count += (uint64_t)time_current();
+	return count;
+}
+
+DECLARE_TEST(profile, sample) {
+	stream_t* stream;
+	char* trace;
+	size_t size;
+	uint64_t spin;
+
+	error(); //Clear error
+
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+
+	profile_initialize(STRING_CONST("test_profile"), _test_profile_buffer,
+	                   TEST_PROFILE_BUFFER_SIZE);
+	profile_set_output_stream(stream);
+	profile_set_output_wait(10);
+	profile_set_sample_rate(1000);
+	profile_enable(true);
+
+	spin = test_profile_sample_spin(time_ticks_per_second() / 2);
+
+	profile_enable(false);
+	profile_set_sample_rate(0);
+	profile_finalize();
+	profile_set_output_stream(0);
+
+	size = (size_t)stream_size(stream);
+	trace = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, trace, size), size);
+	stream_deallocate(stream);
+
+#if BUILD_ENABLE_PROFILE && FOUNDATION_PLATFORM_POSIX && !FOUNDATION_PLATFORM_PNACL
+	EXPECT_SIZENE(string_find_string(trace, size, STRING_CONST("\"cat\":\"sample\""), 0),
+	              STRING_NPOS);
+#endif
+	FOUNDATION_UNUSED(spin);
+
+	memory_deallocate(trace);
+
+	EXPECT_EQ(error(), ERROR_NONE);
+
+	return 0;
+}
+
+#if BUILD_ENABLE_PROFILE
+
+static uint64_t
+test_profile_remote_uint(const char* data, size_t size, size_t* offset) {
+	uint64_t value = 0;
+	unsigned int shift = 0;
+	while (*offset < size) {
+		uint8_t byte = (uint8_t)data[(*offset)++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			break;
+		shift += 7;
+	}
+	return value;
+}
+
+static int64_t
+test_profile_remote_int(const char* data, size_t size, size_t* offset) {
+	uint64_t zigzag = test_profile_remote_uint(data, size, offset);
+	return (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+}
+
+//Decode remote stream and count blocks with the given name, returns -1 on malformed stream
+static int
+test_profile_remote_count(const char* data, size_t size, const char* name, size_t length) {
+	string_const_t table[1024];
+	size_t table_next = 0;
+	size_t offset = 5;
+	int64_t id = 0;
+	int count = 0;
+
+	test_profile_remote_uint(data, size, &offset);
+	offset += (size_t)test_profile_remote_uint(data, size, &offset);
+	while (offset < size) {
+		string_const_t blockname;
+		uint64_t ref;
+		id += test_profile_remote_int(data, size, &offset);
+		test_profile_remote_int(data, size, &offset);
+		test_profile_remote_uint(data, size, &offset);
+		test_profile_remote_int(data, size, &offset);
+		test_profile_remote_int(data, size, &offset);
+		test_profile_remote_int(data, size, &offset);
+		ref = test_profile_remote_uint(data, size, &offset);
+		if (ref < 2) {
+			blockname.length = (size_t)test_profile_remote_uint(data, size, &offset);
+			blockname.str = data + offset;
+			offset += blockname.length;
+			if (ref == 1) {
+				table[table_next] = blockname;
+				table_next = (table_next + 1) % 1024;
+			}
+		}
+		else if (ref - 2 < 1024) {
+			blockname = table[ref - 2];
+		}
+		else {
+			return -1;
+		}
+		if (offset > size)
+			return -1;
+		if (string_equal(STRING_ARGS(blockname), name, length))
+			++count;
+	}
+	return (id == 0) ? count : -1;
+}
+
+#endif
+
+DECLARE_TEST(profile, remote) {
+	stream_t* stream;
+	char* data;
+	size_t size;
+	size_t offset;
+	int iblock;
+
+	error(); //Clear error
+
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+
+	profile_initialize(STRING_CONST("test_profile"), _test_profile_buffer,
+	                   TEST_PROFILE_BUFFER_SIZE);
+	profile_set_output_remote(stream, 0);
+	profile_set_output_wait(10);
+	profile_enable(true);
+
+	for (iblock = 0; iblock < 16; ++iblock) {
+		profile_begin_block(STRING_CONST("Remote block"));
+		profile_log(STRING_CONST("Remote message"));
+		profile_end_block();
+	}
+
+	thread_sleep(100);
+
+	profile_enable(false);
+	profile_finalize();
+	profile_set_output_remote(0, 0);
+
+	size = (size_t)stream_size(stream);
+	data = memory_allocate(0, size + 1, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(stream, data, size), size);
+	stream_deallocate(stream);
+
+#if BUILD_ENABLE_PROFILE
+	EXPECT_GE(size, 5);
+	EXPECT_INTEQ(memcmp(data, "FPRF", 4), 0);
+	EXPECT_INTEQ(data[4], 2);
+	EXPECT_SIZENE(string_find_string(data, size, STRING_CONST("test_profile"), 0), STRING_NPOS);
+	//Repeated block names are sent once and referenced through the string table
+	offset = string_find_string(data, size, STRING_CONST("Remote block"), 0);
+	EXPECT_SIZENE(offset, STRING_NPOS);
+	EXPECT_SIZEEQ(string_find_string(data, size, STRING_CONST("Remote block"), offset + 1), STRING_NPOS);
+	EXPECT_SIZENE(string_find_string(data, size, STRING_CONST("Remote message"), 0), STRING_NPOS);
+	EXPECT_INTEQ(test_profile_remote_count(data, size, STRING_CONST("Remote block")), 16);
+	EXPECT_UINTEQ((unsigned int)profile_remote_dropped(), 0);
+#else
+	EXPECT_SIZEEQ(size, 0);
+	FOUNDATION_UNUSED(offset);
+#endif
+	memory_deallocate(data);
+
+	//Send buffer too small for any block, all blocks are dropped
+	stream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+
+	profile_initialize(STRING_CONST("test"), _test_profile_buffer, TEST_PROFILE_BUFFER_SIZE);
+	profile_set_output_remote(stream, 16);
+	profile_set_output_wait(10);
+	profile_enable(true);
+
+	profile_begin_block(STRING_CONST("Dropped block"));
+	profile_end_block();
+
+	thread_sleep(100);
+
+	profile_enable(false);
+	profile_finalize();
+
+#if BUILD_ENABLE_PROFILE
+	EXPECT_UINTGT((unsigned int)profile_remote_dropped(), 0);
+#endif
+	profile_set_output_remote(0, 0);
+	stream_deallocate(stream);
+
+	EXPECT_EQ(error(), ERROR_NONE);
+
+	return 0;
+}
+
 static void
 test_profile_declare(void) {
 	ADD_TEST(profile, initialize);
 	ADD_TEST(profile, output);
 	ADD_TEST(profile, thread);
 	ADD_TEST(profile, stream);
+	ADD_TEST(profile, trace);
+	ADD_TEST(profile, counter);
+	ADD_TEST(profile, sample);
+	ADD_TEST(profile, remote);
 }
 
 static test_suite_t test_profile_suite = {
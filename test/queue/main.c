@@ -0,0 +1,189 @@
+/* main.c  -  Foundation queue test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_queue_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation queue tests"));
+	app.short_name = string_const(STRING_CONST("test_queue"));
+	app.config_dir = string_const(STRING_CONST("test_queue"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_queue_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_queue_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_queue_initialize(void) {
+	return 0;
+}
+
+static void
+test_queue_finalize(void) {
+}
+
+DECLARE_TEST(queue, basic) {
+	queue_t* queue;
+	uintptr_t item;
+	tick_t start;
+
+	queue = queue_allocate(0);
+	EXPECT_SIZEEQ(queue_capacity(queue), 2);
+	queue_deallocate(queue);
+
+	queue = queue_allocate(5);
+	EXPECT_SIZEEQ(queue_capacity(queue), 8);
+	EXPECT_SIZEEQ(queue_size(queue), 0);
+	EXPECT_EQ(queue_try_pop(queue, 0), 0);
+
+	for (item = 1; item <= 8; ++item)
+		EXPECT_TRUE(queue_try_push(queue, (void*)item, 0));
+	EXPECT_SIZEEQ(queue_size(queue), 8);
+	EXPECT_FALSE(queue_try_push(queue, (void*)item, 0));
+	EXPECT_FALSE(queue_try_push(queue, (void*)item, 10));
+
+	for (item = 1; item <= 4; ++item)
+		EXPECT_EQ(queue_pop(queue), (void*)item);
+	for (item = 9; item <= 12; ++item)
+		queue_push(queue, (void*)item);
+	for (item = 5; item <= 12; ++item)
+		EXPECT_EQ(queue_try_pop(queue, 0), (void*)item);
+	EXPECT_SIZEEQ(queue_size(queue), 0);
+
+	start = time_current();
+	EXPECT_EQ(queue_try_pop(queue, 50), 0);
+	EXPECT_REALGE(time_elapsed(start), REAL_C(0.04));
+
+	queue_deallocate(queue);
+
+	return 0;
+}
+
+typedef struct {
+	queue_t*      queue;
+	int           loopcount;
+	atomic32_t    producer;
+	atomic64_t    sum;
+} queue_test_t;
+
+static void*
+queue_producer(void* arg) {
+	queue_test_t* test = arg;
+	uintptr_t base = (uintptr_t)atomic_incr32(&test->producer) * (uintptr_t)test->loopcount;
+	int loop;
+
+	for (loop = 1; loop <= test->loopcount; ++loop)
+		queue_push(test->queue, (void*)(base + (uintptr_t)loop));
+
+	return 0;
+}
+
+static void*
+queue_consumer(void* arg) {
+	queue_test_t* test = arg;
+	int64_t sum = 0;
+	int loop;
+
+	for (loop = 0; loop < test->loopcount; ++loop)
+		sum += (int64_t)(uintptr_t)queue_pop(test->queue);
+	atomic_add64(&test->sum, sum);
+
+	return 0;
+}
+
+DECLARE_TEST(queue, threaded) {
+	thread_t thread[8];
+	queue_test_t test;
+	int64_t expect = 0;
+	int64_t item;
+	int ith;
+
+	test.queue = queue_allocate(64);
+	test.loopcount = 32 * 1024;
+	atomic_store32(&test.producer, 0);
+	atomic_store64(&test.sum, 0);
+
+	for (ith = 0; ith < 8; ++ith)
+		thread_initialize(&thread[ith], (ith % 2) ? queue_consumer : queue_producer, &test,
+		                  STRING_CONST("queue_worker"), THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < 8; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, 8);
+	test_wait_for_threads_finish(thread, 8);
+
+	for (ith = 0; ith < 8; ++ith)
+		thread_finalize(&thread[ith]);
+
+	for (item = test.loopcount + 1; item <= 5 * test.loopcount; ++item)
+		expect += item;
+	EXPECT_TYPEEQ(atomic_load64(&test.sum), expect, int64_t, PRId64);
+	EXPECT_SIZEEQ(queue_size(test.queue), 0);
+	EXPECT_EQ(queue_try_pop(test.queue, 0), 0);
+
+	queue_deallocate(test.queue);
+
+	return 0;
+}
+
+static void
+test_queue_declare(void) {
+	ADD_TEST(queue, basic);
+	ADD_TEST(queue, threaded);
+}
+
+static test_suite_t test_queue_suite = {
+	test_queue_application,
+	test_queue_memory_system,
+	test_queue_config,
+	test_queue_declare,
+	test_queue_initialize,
+	test_queue_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_queue_run(void);
+
+int
+test_queue_run(void) {
+	test_suite = test_queue_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_queue_suite;
+}
+
+#endif
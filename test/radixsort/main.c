@@ -384,12 +384,387 @@ DECLARE_TEST(radixsort, sort_real) {
 	return 0;
 }
 
+DECLARE_TEST(radixsort, sort_large) {
+	size_t num = 300000;
+	size_t ival;
+	int32_t* arr_int;
+	float32_t* arr_32;
+	int64_t* arr_int64;
+	float64_t* arr_64;
+	uint8_t* seen;
+	radixsort32_t* sort_int;
+	radixsort32_t* sort_32;
+	radixsort64_t* sort_int64;
+	radixsort64_t* sort_64;
+	const radixsort32_index_t* sindex_int;
+	const radixsort32_index_t* sindex_32;
+	const radixsort64_index_t* sindex_int64;
+	const radixsort64_index_t* sindex_64;
+	real low_range = -(real)(1 << 30);
+	real high_range = (real)(1 << 30);
+	unsigned int iloop;
+
+	arr_int = memory_allocate(0, sizeof(int32_t) * num, 0, MEMORY_PERSISTENT);
+	arr_32 = memory_allocate(0, sizeof(float32_t) * num, 0, MEMORY_PERSISTENT);
+	arr_int64 = memory_allocate(0, sizeof(int64_t) * num, 0, MEMORY_PERSISTENT);
+	arr_64 = memory_allocate(0, sizeof(float64_t) * num, 0, MEMORY_PERSISTENT);
+	seen = memory_allocate(0, num * 4, 0, MEMORY_PERSISTENT);
+
+	sort_int = radixsort32_allocate(RADIXSORT_INT32, (radixsort32_index_t)num);
+	sort_32 = radixsort32_allocate(RADIXSORT_FLOAT32, (radixsort32_index_t)num);
+	sort_int64 = radixsort64_allocate(RADIXSORT_INT64, num);
+	sort_64 = radixsort64_allocate(RADIXSORT_FLOAT64, num);
+
+	//Second loop sorts a subset of slightly modified data for temporal coherence
+	for (iloop = 0; iloop < 2; ++iloop) {
+		if (iloop)
+			num -= 1000;
+		for (ival = 0; ival < num; ++ival) {
+			if (!iloop || !(ival % 64)) {
+				arr_int[ival] = (int32_t)random32();
+				arr_32[ival] = (float32_t)random_range(low_range, high_range);
+				arr_int64[ival] = (int64_t)random64();
+				arr_64[ival] = (float64_t)random_range(low_range, high_range);
+			}
+		}
+
+		sindex_int = radixsort32_sort(sort_int, arr_int, (radixsort32_index_t)num);
+		sindex_32 = radixsort32_sort(sort_32, arr_32, (radixsort32_index_t)num);
+		sindex_int64 = radixsort64_sort(sort_int64, arr_int64, num);
+		sindex_64 = radixsort64_sort(sort_64, arr_64, num);
+
+		memset(seen, 0, num * 4);
+		for (ival = 0; ival < num; ++ival) {
+			EXPECT_LT(sindex_int[ival], num);
+			EXPECT_LT(sindex_32[ival], num);
+			EXPECT_LT(sindex_int64[ival], num);
+			EXPECT_LT(sindex_64[ival], num);
+			seen[(sindex_int[ival] * 4) + 0] = 1;
+			seen[(sindex_32[ival] * 4) + 1] = 1;
+			seen[(sindex_int64[ival] * 4) + 2] = 1;
+			seen[(sindex_64[ival] * 4) + 3] = 1;
+			if (ival) {
+				EXPECT_LE(arr_int[ sindex_int[ival - 1] ], arr_int[ sindex_int[ival] ]);
+				EXPECT_LE(arr_32[ sindex_32[ival - 1] ], arr_32[ sindex_32[ival] ]);
+				EXPECT_LE(arr_int64[ sindex_int64[ival - 1] ], arr_int64[ sindex_int64[ival] ]);
+				EXPECT_LE(arr_64[ sindex_64[ival - 1] ], arr_64[ sindex_64[ival] ]);
+			}
+		}
+		//Every index present exactly once
+		for (ival = 0; ival < num * 4; ++ival)
+			EXPECT_EQ(seen[ival], 1);
+	}
+
+	radixsort32_deallocate(sort_int);
+	radixsort32_deallocate(sort_32);
+	radixsort64_deallocate(sort_int64);
+	radixsort64_deallocate(sort_64);
+
+	memory_deallocate(arr_int);
+	memory_deallocate(arr_32);
+	memory_deallocate(arr_int64);
+	memory_deallocate(arr_64);
+	memory_deallocate(seen);
+
+	return 0;
+}
+
+DECLARE_TEST(radixsort, sort_parallel) {
+	size_t num = 400000;
+	size_t ival;
+	unsigned int itype, iloop;
+	void* arr;
+	void* sorted;
+	uint64_t* arr_bits;
+	radixsort32_t* sort;
+	radixsort32_t* sort_parallel;
+	radixsort64_t* sort64;
+	radixsort64_t* sort64_parallel;
+	const radixsort32_index_t* sindex;
+	const radixsort32_index_t* sindex_parallel;
+	const radixsort64_index_t* sindex64;
+	const radixsort64_index_t* sindex64_parallel;
+	task_scheduler_t* scheduler = task_scheduler_allocate(3, 0);
+	const radixsort_data_t types[] = {
+		RADIXSORT_INT32, RADIXSORT_UINT32, RADIXSORT_INT64,
+		RADIXSORT_UINT64, RADIXSORT_FLOAT32, RADIXSORT_FLOAT64
+	};
+
+	arr = memory_allocate(0, sizeof(uint64_t) * num, 0, MEMORY_PERSISTENT);
+	arr_bits = arr;
+	sorted = memory_allocate(0, sizeof(uint64_t) * num, 0, MEMORY_PERSISTENT);
+
+	for (itype = 0; itype < sizeof(types) / sizeof(types[0]); ++itype) {
+		sort = radixsort32_allocate(types[itype], (radixsort32_index_t)num);
+		sort_parallel = radixsort32_allocate(types[itype], (radixsort32_index_t)num);
+		sort64 = radixsort64_allocate(types[itype], num);
+		sort64_parallel = radixsort64_allocate(types[itype], num);
+
+		//Random data with duplicates, then all negative data, then a smaller subset of data,
+		//then the same subset again to hit the temporal coherence check
+		for (iloop = 0; iloop < 4; ++iloop) {
+			size_t count = (iloop >= 2) ? (num / 2) : num;
+			for (ival = 0; (iloop < 3) && (ival < count); ++ival) {
+				uint64_t value = random64() & 0xFFFFFFFFFF0FFFFFULL;
+				if (types[itype] == RADIXSORT_FLOAT32)
+					((float32_t*)arr)[ival] = (float32_t)random_range(-1000.0f, 1000.0f);
+				else if (types[itype] == RADIXSORT_FLOAT64)
+					((float64_t*)arr)[ival] = (float64_t)random_range(-1000.0f, 1000.0f);
+				else
+					arr_bits[ival] = value;
+				if (iloop == 1) {
+					if (types[itype] == RADIXSORT_FLOAT32)
+						((float32_t*)arr)[ival] = -math_abs(((float32_t*)arr)[ival]) - 1.0f;
+					else if (types[itype] == RADIXSORT_FLOAT64)
+						((float64_t*)arr)[ival] = -math_abs(((float64_t*)arr)[ival]) - 1.0;
+					else
+						arr_bits[ival] |= 0x8000000080000000ULL;
+				}
+			}
+			if (iloop == 2) {
+				//Presort the subset with a separate sorter to keep sorter states in sync
+				radixsort64_t* presort = radixsort64_allocate(RADIXSORT_UINT64, count);
+				sindex64 = radixsort64_sort(presort, arr, count);
+				for (ival = 0; ival < count; ++ival)
+					((uint64_t*)sorted)[ival] = arr_bits[ sindex64[ival] ];
+				memcpy(arr, sorted, sizeof(uint64_t) * count);
+				radixsort64_deallocate(presort);
+			}
+
+			sindex = radixsort32_sort(sort, arr, (radixsort32_index_t)count);
+			sindex_parallel = radixsort32_sort_parallel(sort_parallel, arr,
+			                                            (radixsort32_index_t)count, scheduler);
+			sindex64 = radixsort64_sort(sort64, arr, count);
+			sindex64_parallel = radixsort64_sort_parallel(sort64_parallel, arr, count, scheduler);
+
+			//Sort is stable so the parallel result must match exactly
+			EXPECT_EQ(memcmp(sindex, sindex_parallel, sizeof(radixsort32_index_t) * count), 0);
+			EXPECT_EQ(memcmp(sindex64, sindex64_parallel, sizeof(radixsort64_index_t) * count), 0);
+		}
+
+		radixsort32_deallocate(sort);
+		radixsort32_deallocate(sort_parallel);
+		radixsort64_deallocate(sort64);
+		radixsort64_deallocate(sort64_parallel);
+	}
+
+	memory_deallocate(arr);
+	memory_deallocate(sorted);
+	task_scheduler_deallocate(scheduler);
+
+	return 0;
+}
+
+DECLARE_TEST(radixsort, sort_records) {
+	size_t num = 20000;
+	size_t ival;
+	unsigned int itype, imode, isize;
+	uint64_t* keys;
+	unsigned char* records;
+	radixsort32_t* sort;
+	const radixsort32_index_t* sindex;
+	const size_t record_size[] = {16, 12, 8};
+	const size_t key_offset[] = {0, 4, 0};
+	const radixsort_data_t types[] = {
+		RADIXSORT_INT32, RADIXSORT_UINT32, RADIXSORT_INT64,
+		RADIXSORT_UINT64, RADIXSORT_FLOAT32, RADIXSORT_FLOAT64
+	};
+
+	keys = memory_allocate(0, sizeof(uint64_t) * num, 0, MEMORY_PERSISTENT);
+	records = memory_allocate(0, 32 * num, 0, MEMORY_PERSISTENT);
+
+	for (itype = 0; itype < sizeof(types) / sizeof(types[0]); ++itype) {
+		size_t key_size = ((types[itype] == RADIXSORT_INT32) || (types[itype] == RADIXSORT_UINT32) ||
+		                   (types[itype] == RADIXSORT_FLOAT32)) ? 4 : 8;
+
+		//Random keys, narrow range keys with duplicates, all negative keys
+		for (imode = 0; imode < 3; ++imode) {
+			for (ival = 0; ival < num; ++ival) {
+				if (types[itype] == RADIXSORT_FLOAT32)
+					((float32_t*)keys)[ival] = (float32_t)((imode == 1) ?
+					                                       (real)random32_range(0, 100) :
+					                                       random_range(-1000.0f, 1000.0f));
+				else if (types[itype] == RADIXSORT_FLOAT64)
+					((float64_t*)keys)[ival] = (float64_t)((imode == 1) ?
+					                                       (real)random32_range(0, 100) :
+					                                       random_range(-1000.0f, 1000.0f));
+				else
+					keys[ival] = (imode == 1) ? (0x123400 + random32_range(0, 300)) : random64();
+				if (imode == 2) {
+					if (types[itype] == RADIXSORT_FLOAT32)
+						((float32_t*)keys)[ival] = -math_abs(((float32_t*)keys)[ival]) - 1.0f;
+					else if (types[itype] == RADIXSORT_FLOAT64)
+						((float64_t*)keys)[ival] = -math_abs(((float64_t*)keys)[ival]) - 1.0;
+					else
+						keys[ival] |= 0x8000000080000000ULL;
+				}
+			}
+			//New sorter to compare with a stable sort of the input order
+			sort = radixsort32_allocate(types[itype], (radixsort32_index_t)num);
+			sindex = radixsort32_sort(sort, keys, (radixsort32_index_t)num);
+
+			for (isize = 0; isize < sizeof(record_size) / sizeof(record_size[0]); ++isize) {
+				size_t size = record_size[isize];
+				if (key_offset[isize] + key_size + 4 > size)
+					continue;
+				for (ival = 0; ival < num; ++ival) {
+					unsigned char* record = records + (ival * size);
+					uint32_t id = (uint32_t)ival;
+					memset(record, 0, size);
+					memcpy(record + key_offset[isize], (char*)keys + (ival * key_size), key_size);
+					memcpy(record + size - 4, &id, 4);
+				}
+
+				radixsort_sort_records(types[itype], records, num, size, key_offset[isize],
+				                       (isize == 1) ? records + (num * size) : 0);
+
+				//Stable sort must give the same order as the index sort
+				for (ival = 0; ival < num; ++ival) {
+					const unsigned char* record = records + (ival * size);
+					uint32_t id;
+					memcpy(&id, record + size - 4, 4);
+					EXPECT_UINTEQ(id, sindex[ival]);
+					EXPECT_EQ(memcmp(record + key_offset[isize], (char*)keys + (id * key_size),
+					                 key_size), 0);
+				}
+			}
+
+			radixsort32_deallocate(sort);
+		}
+	}
+
+	memory_deallocate(keys);
+	memory_deallocate(records);
+
+	return 0;
+}
+
+DECLARE_TEST(radixsort, sort_uint128) {
+	size_t num = 70000;
+	size_t ival;
+	uint128_t* arr;
+	unsigned char* records;
+	radixsort_t* sort_small;
+	radixsort32_t* sort;
+	const radixsort_index_t* sindex_small;
+	const radixsort32_index_t* sindex;
+
+	arr = memory_allocate(0, sizeof(uint128_t) * num, 0, MEMORY_PERSISTENT);
+	records = memory_allocate(0, 24 * num, 0, MEMORY_PERSISTENT);
+	for (ival = 0; ival < num; ++ival) {
+		//Narrow range high word to get ties resolved by the low word
+		arr[ival] = uint128_make(random64(), random64_range(0, 100) << 60);
+		if (!(ival % 7))
+			arr[ival] = arr[ival / 2];
+	}
+
+	sort = radixsort32_allocate(RADIXSORT_UINT128, (radixsort32_index_t)num);
+	sindex = radixsort32_sort(sort, arr, (radixsort32_index_t)num);
+	for (ival = 1; ival < num; ++ival) {
+		const uint128_t prev = arr[ sindex[ival - 1] ];
+		const uint128_t cur = arr[ sindex[ival] ];
+		EXPECT_TRUE((prev.word[1] < cur.word[1]) ||
+		            ((prev.word[1] == cur.word[1]) && (prev.word[0] <= cur.word[0])));
+	}
+
+	//Already sorted in previous order
+	EXPECT_EQ(radixsort32_sort(sort, arr, (radixsort32_index_t)num), sindex);
+
+	//Records with the key after a payload
+	for (ival = 0; ival < num; ++ival) {
+		uint64_t id = ival;
+		memcpy(records + (ival * 24), &id, 8);
+		memcpy(records + (ival * 24) + 8, arr + ival, 16);
+	}
+	radixsort_sort_records(RADIXSORT_UINT128, records, num, 24, 8, 0);
+	for (ival = 0; ival < num; ++ival) {
+		uint64_t id;
+		memcpy(&id, records + (ival * 24), 8);
+		EXPECT_TRUE(uint128_equal(arr[id], arr[ sindex[ival] ]));
+	}
+	radixsort32_deallocate(sort);
+
+	sort_small = radixsort_allocate(RADIXSORT_UINT128, 1000);
+	sindex_small = radixsort_sort(sort_small, arr, 1000);
+	for (ival = 1; ival < 1000; ++ival) {
+		const uint128_t prev = arr[ sindex_small[ival - 1] ];
+		const uint128_t cur = arr[ sindex_small[ival] ];
+		EXPECT_TRUE((prev.word[1] < cur.word[1]) ||
+		            ((prev.word[1] == cur.word[1]) && (prev.word[0] <= cur.word[0])));
+	}
+	radixsort_deallocate(sort_small);
+
+	memory_deallocate(arr);
+	memory_deallocate(records);
+
+	return 0;
+}
+
+static int
+test_radixsort_string_compare(const void* lhs, const void* rhs) {
+	const string_const_t* lstr = lhs;
+	const string_const_t* rstr = rhs;
+	size_t length = (lstr->length < rstr->length) ? lstr->length : rstr->length;
+	int result = length ? memcmp(lstr->str, rstr->str, length) : 0;
+	if (result)
+		return result;
+	return (lstr->length < rstr->length) ? -1 : ((lstr->length > rstr->length) ? 1 : 0);
+}
+
+DECLARE_TEST(radixsort, sort_strings) {
+	size_t num = 20000;
+	size_t ival, ichar;
+	char* data;
+	string_const_t* strings;
+	string_const_t* reference;
+	const char* prefix[] = {"", "/usr/local/lib/", "/usr/local/include/", "/usr/", "\xff\x80"};
+	unsigned int inum;
+	const size_t sizes[] = {0, 1, 2, 31, 32, 33, 100, 20000};
+
+	data = memory_allocate(0, num * 64, 0, MEMORY_PERSISTENT);
+	strings = memory_allocate(0, sizeof(string_const_t) * num, 0, MEMORY_PERSISTENT);
+	reference = memory_allocate(0, sizeof(string_const_t) * num, 0, MEMORY_PERSISTENT);
+
+	for (ival = 0; ival < num; ++ival) {
+		char* str = data + (ival * 64);
+		size_t prefix_length = string_length(prefix[ival % 5]);
+		size_t length = prefix_length + random32_range(0, 16);
+		memcpy(str, prefix[ival % 5], prefix_length);
+		//Small alphabet including high bytes and zero bytes to get shared prefixes
+		for (ichar = prefix_length; ichar < length; ++ichar)
+			str[ichar] = "ab/\xe4\0"[random32_range(0, 5)];
+		strings[ival] = string_const(str, length);
+		if (!(ival % 11))
+			strings[ival] = strings[ival / 3];
+	}
+
+	for (inum = 0; inum < sizeof(sizes) / sizeof(sizes[0]); ++inum) {
+		size_t count = sizes[inum];
+		memcpy(reference, strings, sizeof(string_const_t) * count);
+		qsort(reference, count, sizeof(string_const_t), test_radixsort_string_compare);
+		radixsort_sort_strings(strings, count);
+		for (ival = 0; ival < count; ++ival)
+			EXPECT_EQ(test_radixsort_string_compare(strings + ival, reference + ival), 0);
+	}
+
+	memory_deallocate(data);
+	memory_deallocate(strings);
+	memory_deallocate(reference);
+
+	return 0;
+}
+
 static void
 test_radixsort_declare(void) {
 	ADD_TEST(radixsort, allocation);
 	ADD_TEST(radixsort, sort_int32);
 	ADD_TEST(radixsort, sort_int64);
 	ADD_TEST(radixsort, sort_real);
+	ADD_TEST(radixsort, sort_large);
+	ADD_TEST(radixsort, sort_parallel);
+	ADD_TEST(radixsort, sort_records);
+	ADD_TEST(radixsort, sort_uint128);
+	ADD_TEST(radixsort, sort_strings);
 }
 
 static test_suite_t test_radixsort_suite = {
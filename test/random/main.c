@@ -349,6 +349,41 @@ DECLARE_TEST(random, threads) {
 	return 0;
 }
 
+static void*
+random_churn_thread(void* arg) {
+	uint64_t* value = arg;
+	uint32_t values[16];
+	random_fill_uint32(values, 16);
+	*value = ((uint64_t)random32() << 32ULL) | values[15];
+	return 0;
+}
+
+DECLARE_TEST(random, thread_churn) {
+	//Short lived threads recycling state buffers must continue sequences, not restart them
+	thread_t thread[8];
+	uint64_t value[8 * 16];
+	size_t i, j, round;
+
+	for (round = 0; round < 16; ++round) {
+		for (i = 0; i < 8; ++i)
+			thread_initialize(&thread[i], random_churn_thread, value + (round * 8) + i,
+			                  STRING_CONST("random"), THREAD_PRIORITY_NORMAL, 0);
+		for (i = 0; i < 8; ++i)
+			thread_start(&thread[i]);
+		test_wait_for_threads_startup(thread, 8);
+		test_wait_for_threads_finish(thread, 8);
+		for (i = 0; i < 8; ++i)
+			thread_finalize(&thread[i]);
+	}
+
+	for (i = 0; i < 8 * 16; ++i) {
+		for (j = 0; j < i; ++j)
+			EXPECT_NE(value[i], value[j]);
+	}
+
+	return 0;
+}
+
 DECLARE_TEST(random, util) {
 	int i;
 	int32_t ival32;
@@ -429,13 +464,260 @@ DECLARE_TEST(random, util) {
 	return 0;
 }
 
+DECLARE_TEST(random, fill) {
+	size_t count = 512000 * 8;
+	size_t i, j, size;
+	uint32_t* values32 = memory_allocate(0, sizeof(uint32_t) * (count + 1), 0, MEMORY_PERSISTENT);
+	float* valuesf = memory_allocate(0, sizeof(float) * (count + 1), 0, MEMORY_PERSISTENT);
+	real* values = memory_allocate(0, sizeof(real) * (count + 1), 0, MEMORY_PERSISTENT);
+	unsigned int max_num = 0, min_num = 0xFFFFFFFF;
+	real diff;
+
+	memset(_test_bits, 0, sizeof(unsigned int) * 32);
+	random_fill_uint32(values32, count);
+	for (i = 0; i < count; ++i) {
+		for (j = 0; j < 32; ++j) {
+			if (values32[i] & (1U << j))
+				++_test_bits[j];
+		}
+	}
+	for (j = 0; j < 32; ++j) {
+		if (_test_bits[j] < min_num)
+			min_num = _test_bits[j];
+		if (_test_bits[j] > max_num)
+			max_num = _test_bits[j];
+	}
+	diff = (real)(max_num - min_num) / ((real)min_num + ((real)(max_num - min_num) / REAL_C(2.0)));
+	EXPECT_LT(diff, 0.01);
+
+	memset(_test_hist, 0, sizeof(unsigned int) * 64);
+	random_fill_float(valuesf, count);
+	for (i = 0; i < count; ++i) {
+		EXPECT_GE(valuesf[i], 0);
+		EXPECT_LT(valuesf[i], 1);
+		++_test_hist[(int)(valuesf[i] * 64.0f)];
+	}
+	random_fill_real(values, count);
+	for (i = 0; i < count; ++i) {
+		EXPECT_GE(values[i], 0);
+		EXPECT_LT(values[i], 1);
+		++_test_hist[(int)(values[i] * REAL_C(64.0))];
+	}
+	min_num = 0xFFFFFFFF;
+	max_num = 0;
+	for (i = 0; i < 64; ++i) {
+		if (_test_hist[i] < min_num)
+			min_num = _test_hist[i];
+		if (_test_hist[i] > max_num)
+			max_num = _test_hist[i];
+	}
+	diff = (real)(max_num - min_num) / ((real)min_num + ((real)(max_num - min_num) / REAL_C(2.0)));
+	EXPECT_LT(diff, 0.02);
+
+	//Partial blocks must not write past the end and consecutive calls must continue the sequence
+	for (size = 0; size < 67; ++size) {
+		values32[size] = 0xDEADBEEF;
+		valuesf[size] = -1.0f;
+		values[size] = REAL_C(-1.0);
+		random_fill_uint32(values32, size);
+		random_fill_float(valuesf, size);
+		random_fill_real(values, size);
+		EXPECT_EQ(values32[size], 0xDEADBEEF);
+		EXPECT_REALEQ(valuesf[size], -1.0f);
+		EXPECT_REALEQ(values[size], REAL_C(-1.0));
+	}
+	random_fill_uint32(values32, 64);
+	random_fill_uint32(values32 + 64, 64);
+	for (i = 0; i < 64; ++i)
+		EXPECT_NE(values32[i], values32[i + 64]);
+
+	memory_deallocate(values32);
+	memory_deallocate(valuesf);
+	memory_deallocate(values);
+
+	return 0;
+}
+
+DECLARE_TEST(random, state) {
+	random_state_t state, other, combined;
+	random_state_t streams[4];
+	size_t i, j;
+	int num_passes = 512000;
+	unsigned int max_num = 0, min_num = 0xFFFFFFFF;
+	real diff, val;
+	real weights[] = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f };
+
+	//Reference xoshiro256** output
+	state.s[0] = 1;
+	state.s[1] = 2;
+	state.s[2] = 3;
+	state.s[3] = 4;
+	EXPECT_EQ(random_state64(&state), 11520ULL);
+	EXPECT_EQ(random_state64(&state), 0ULL);
+	EXPECT_EQ(random_state64(&state), 1509978240ULL);
+	EXPECT_EQ(random_state64(&state), 1215971899390074240ULL);
+
+	//Same seed gives same sequence
+	random_state_initialize(&state, 0x1234);
+	random_state_initialize(&other, 0x1234);
+	for (i = 0; i < 1000; ++i)
+		EXPECT_EQ(random_state64(&state), random_state64(&other));
+	random_state_initialize(&other, 0x1235);
+	EXPECT_NE(random_state64(&state), random_state64(&other));
+
+	//Jumps are linear in the state
+	random_state_initialize(&state, 1);
+	random_state_initialize(&other, 2);
+	for (j = 0; j < 4; ++j)
+		combined.s[j] = state.s[j] ^ other.s[j];
+	random_state_jump(&state);
+	random_state_jump(&other);
+	random_state_jump(&combined);
+	for (j = 0; j < 4; ++j)
+		EXPECT_EQ(combined.s[j], state.s[j] ^ other.s[j]);
+
+	//Streams split by jumping are reproducible and distinct
+	random_state_initialize(&streams[0], 42);
+	for (i = 1; i < 4; ++i) {
+		streams[i] = streams[i - 1];
+		if (i == 2)
+			random_state_long_jump(&streams[i]);
+		else
+			random_state_jump(&streams[i]);
+	}
+	random_state_initialize(&state, 42);
+	random_state_jump(&state);
+	EXPECT_EQ(memcmp(&state, &streams[1], sizeof(state)), 0);
+	for (i = 0; i < 4; ++i) {
+		uint64_t first = random_state64(&streams[i]);
+		for (j = 0; j < i; ++j)
+			EXPECT_NE(first, streams[j].s[0]);
+	}
+
+	memset(_test_hist, 0, sizeof(unsigned int) * 64);
+	random_state_initialize(&state, 7);
+	for (i = 0; i < (size_t)num_passes * 16; ++i) {
+		val = random_state_normalized(&state);
+		EXPECT_GE(val, 0);
+		EXPECT_LT(val, 1);
+		++_test_hist[(int)(val * REAL_C(64.0))];
+	}
+	for (i = 0; i < 64; ++i) {
+		if (_test_hist[i] < min_num)
+			min_num = _test_hist[i];
+		if (_test_hist[i] > max_num)
+			max_num = _test_hist[i];
+	}
+	diff = (real)(max_num - min_num) / ((real)min_num + ((real)(max_num - min_num) / REAL_C(2.0)));
+	EXPECT_LT(diff, 0.02);
+
+	for (i = 0; i < (size_t)num_passes; ++i) {
+		uint32_t val32 = random_state32_range(&state, 100, 10);
+		uint64_t val64 = random_state64_range(&state, 10, 100);
+		int32_t ival32 = random_state32_gaussian_range(&state, 32, -32);
+		EXPECT_GE(val32, 10);
+		EXPECT_LT(val32, 100);
+		EXPECT_GE(val64, 10);
+		EXPECT_LT(val64, 100);
+		EXPECT_GE(ival32, -32);
+		EXPECT_LT(ival32, 32);
+
+		ival32 = random_state32_triangle_range(&state, -128, -64);
+		EXPECT_GE(ival32, -128);
+		EXPECT_LT(ival32, -64);
+
+		val = random_state_range(&state, REAL_C(100.0), REAL_C(0.0));
+		EXPECT_GE(val, REAL_C(0.0));
+		EXPECT_LT(val, REAL_C(100.0));
+
+		val = random_state_gaussian_range(&state, REAL_C(-32.0), REAL_C(32.0));
+		EXPECT_GE(val, REAL_C(-32.0));
+		EXPECT_LT(val, REAL_C(32.0));
+
+		val = random_state_triangle_range(&state, REAL_C(128.0), REAL_C(-64.0));
+		EXPECT_GE(val, REAL_C(-64.0));
+		EXPECT_LT(val, REAL_C(128.0));
+
+		EXPECT_LT(random_state32_weighted(&state, 10, weights), 10);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(random, alias) {
+	random_alias_t alias;
+	random_alias_t* table;
+	random_state_t state, other;
+	uint32_t values[1000];
+	size_t i;
+	size_t num_passes = 1024000;
+	unsigned int hist[8];
+	real weights[8] = { 1.0f, 0.0f, 3.0f, 6.0f, -2.0f, 10.0f, 0.5f, 0.5f };
+	real zero[4] = { 0, 0, 0, 0 };
+	real sum = REAL_C(21.0);
+
+	//Sampled frequencies match relative weights, entries without weight are never sampled
+	random_alias_initialize(&alias, 8, weights);
+	EXPECT_UINTEQ(alias.count, 8);
+	memset(hist, 0, sizeof(hist));
+	for (i = 0; i < num_passes; ++i)
+		++hist[random32_alias(&alias)];
+	for (i = 0; i < num_passes; i += 1000) {
+		size_t j;
+		random_fill_alias(&alias, values, 1000);
+		for (j = 0; j < 1000; ++j) {
+			EXPECT_LT(values[j], 8);
+			++hist[values[j]];
+		}
+	}
+	EXPECT_UINTEQ(hist[1], 0);
+	EXPECT_UINTEQ(hist[4], 0);
+	for (i = 0; i < 8; ++i) {
+		real expected = (weights[i] > 0 ? weights[i] : 0) * (real)(num_passes * 2) / sum;
+		EXPECT_LE(math_abs((real)hist[i] - expected), (expected * REAL_C(0.02)) + REAL_C(1.0));
+	}
+
+	//Explicit state gives reproducible samples, bulk and single samples are equal
+	random_state_initialize(&state, 0x5EED);
+	random_state_initialize(&other, 0x5EED);
+	random_state_fill_alias(&state, &alias, values, 1000);
+	for (i = 0; i < 1000; ++i)
+		EXPECT_UINTEQ(values[i], random_state32_alias(&other, &alias));
+	random_alias_finalize(&alias);
+
+	//Without positive weights all numbers are equally likely
+	table = random_alias_allocate(4, zero);
+	memset(hist, 0, sizeof(hist));
+	for (i = 0; i < num_passes; ++i)
+		++hist[random_state32_alias(&state, table)];
+	for (i = 0; i < 4; ++i)
+		EXPECT_LE(math_abs((real)hist[i] - (real)(num_passes / 4)), (real)(num_passes / 100));
+	random_alias_deallocate(table);
+
+	//Empty and single entry tables always give zero
+	table = random_alias_allocate(0, weights);
+	EXPECT_UINTEQ(random32_alias(table), 0);
+	random_alias_deallocate(table);
+	table = random_alias_allocate(1, weights);
+	random_fill_alias(table, values, 1000);
+	for (i = 0; i < 1000; ++i)
+		EXPECT_UINTEQ(values[i], 0);
+	random_alias_deallocate(table);
+
+	return 0;
+}
+
 static void
 test_random_declare(void) {
 	ADD_TEST(random, distribution32);
 	ADD_TEST(random, distribution64);
 	ADD_TEST(random, distribution_real);
 	ADD_TEST(random, threads);
+	ADD_TEST(random, thread_churn);
 	ADD_TEST(random, util);
+	ADD_TEST(random, fill);
+	ADD_TEST(random, state);
+	ADD_TEST(random, alias);
 }
 
 static test_suite_t test_random_suite = {
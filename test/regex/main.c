@@ -34,6 +34,7 @@ static foundation_config_t
 test_regex_config(void) {
 	foundation_config_t config;
 	memset(&config, 0, sizeof(config));
+	config.regex_cache_size = 4;
 	return config;
 }
 
@@ -449,6 +450,394 @@ DECLARE_TEST(regex, invalid) {
 	return 0;
 }
 
+DECLARE_TEST(regex, dfa) {
+	static const char* patterns[] = {
+		"^(TEST\\20REGEX)$", "^(.TEST.REGEX).$", "^(.*)$", "^(\\s+|\\S+)$", "^([ \\n\\d]+)$",
+		"\\6D\\61tchthis(\\s+|\\S+)!", "matchthis(\\s+|\\S+)!endof\\6cine([abcd\\\\]*)", "ab*c",
+		"a+?b", "(a|b|c)d", "x?y$", "[^ab]+c", "a|b", "^$", "$", "\\d+.\\d*", "[\\s\\d]+x",
+		"^a*?b+y?$", "(ab|cd)(x|y)", "^[abc]*(d|xy)y+?$"
+	};
+	static const char alphabet[] = "abcdxy .19\n";
+	char input[16];
+	size_t ipattern, iinput, length, ichar;
+	regex_t* regex;
+	regex_t* dfa;
+	string_const_t captures[4];
+	char* long_input;
+
+	//DFA matching must agree with the backtracking interpreter
+	for (ipattern = 0; ipattern < sizeof(patterns) / sizeof(patterns[0]); ++ipattern) {
+		regex = regex_compile(patterns[ipattern], string_length(patterns[ipattern]));
+		dfa = regex_compile_dfa(patterns[ipattern], string_length(patterns[ipattern]));
+		EXPECT_NE(regex, 0);
+		EXPECT_NE(dfa, 0);
+		for (iinput = 0; iinput < 4000; ++iinput) {
+			length = random32_range(0, sizeof(input));
+			for (ichar = 0; ichar < length; ++ichar)
+				input[ichar] = alphabet[random32_range(0, sizeof(alphabet) - 1)];
+			EXPECT_EQ(regex_match(dfa, input, length, 0, 0), regex_match(regex, input, length, 0, 0));
+		}
+		regex_deallocate(regex);
+		regex_deallocate(dfa);
+	}
+
+	//Exhaust the DFA state cache, continuing with NFA simulation
+	regex = regex_compile(STRING_CONST("[ab]*a[ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab]$"));
+	dfa = regex_compile_dfa(STRING_CONST("[ab]*a[ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab]$"));
+	long_input = memory_allocate(0, 256, 0, MEMORY_PERSISTENT);
+	for (iinput = 0; iinput < 1000; ++iinput) {
+		length = random32_range(1, 256);
+		for (ichar = 0; ichar < length; ++ichar)
+			long_input[ichar] = (random32() & 1) ? 'a' : 'b';
+		EXPECT_EQ(regex_match(dfa, long_input, length, 0, 0),
+		          regex_match(regex, long_input, length, 0, 0));
+	}
+	memory_deallocate(long_input);
+	regex_deallocate(regex);
+	regex_deallocate(dfa);
+
+	//Captures fall back to backtracking
+	dfa = regex_compile_dfa(STRING_CONST("^(a+)(b*)$"));
+	EXPECT_TRUE(regex_match(dfa, STRING_CONST("aabbb"), captures, 4));
+	EXPECT_SIZEEQ(captures[0].length, 2);
+	EXPECT_SIZEEQ(captures[1].length, 3);
+	regex_deallocate(dfa);
+
+	//Exponential for the backtracking interpreter, linear for the DFA
+	length = 64 * 1024;
+	long_input = memory_allocate(0, length, 0, MEMORY_PERSISTENT);
+	memset(long_input, 'a', length);
+	dfa = regex_compile_dfa(STRING_CONST("a*a*a*a*a*a*a*a*a*a*b"));
+	EXPECT_FALSE(regex_match(dfa, long_input, length, 0, 0));
+	long_input[length - 1] = 'b';
+	EXPECT_TRUE(regex_match(dfa, long_input, length, 0, 0));
+	regex_deallocate(dfa);
+	memory_deallocate(long_input);
+
+	return 0;
+}
+
+DECLARE_TEST(regex, literal) {
+	regex_t* regex;
+
+	regex = regex_compile(STRING_CONST("ERROR.*timeout \\d+ms"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 8);
+	EXPECT_FALSE(regex->literal_prefix);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("[worker] ERROR ERROR request timeout 300ms"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("[worker] ERROR request timeout ms ERROR"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("[worker] INFO request completed in 12ms"), 0, 0));
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("(\\d+) requests? failed$"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 8);
+	EXPECT_FALSE(regex->literal_prefix);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("summary: 12 request failed"), 0, 0));
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("summary: 3 requests failed"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("summary: no requests failed"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("summary: 3 requests failed!"), 0, 0));
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("^(abc)x?def"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 3);
+	EXPECT_TRUE(regex->literal_prefix);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("abcxdefg"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("zabcdef"), 0, 0));
+	regex_deallocate(regex);
+
+	//Nothing after the first branch is required
+	regex = regex_compile(STRING_CONST("(a|b)long literal"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 0);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("xblong literal"), 0, 0));
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("ERROR\\s+(\\d+)"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 5);
+	EXPECT_TRUE(regex->literal_prefix);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("ERROR ERROR ERROR ERROR 3"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("ERROR ERROR ERROR ERROR"), 0, 0));
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("ab*c"));
+	EXPECT_NE(regex, 0);
+	EXPECT_SIZEEQ(regex->literal_length, 1);
+	EXPECT_TRUE(regex->literal_prefix);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("xxabbbc"), 0, 0));
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("aaac"), 0, 0));
+	EXPECT_FALSE(regex_match(regex, STRING_CONST("xxabbb"), 0, 0));
+	regex_deallocate(regex);
+
+	return 0;
+}
+
+typedef struct {
+	size_t count;
+	size_t offset[32768];
+	size_t length[32768];
+	size_t capture[32768];
+} test_regex_matches_t;
+
+static bool
+test_regex_collect(size_t offset, string_const_t match, const string_const_t* captures,
+                   size_t num_captures, void* arg) {
+	test_regex_matches_t* matches = arg;
+	if (matches->count >= sizeof(matches->offset) / sizeof(matches->offset[0]))
+		return false;
+	matches->offset[matches->count] = offset;
+	matches->length[matches->count] = match.length;
+	matches->capture[matches->count] = num_captures ? captures[0].length : 0;
+	++matches->count;
+	return true;
+}
+
+static bool
+test_regex_stop(size_t offset, string_const_t match, const string_const_t* captures,
+                size_t num_captures, void* arg) {
+	FOUNDATION_UNUSED(offset);
+	FOUNDATION_UNUSED(match);
+	FOUNDATION_UNUSED(captures);
+	FOUNDATION_UNUSED(num_captures);
+	return --(*(int*)arg) > 0;
+}
+
+DECLARE_TEST(regex, match_all) {
+	regex_t* regex;
+	string_const_t captures[2];
+	test_regex_matches_t* matches;
+	int limit;
+
+	matches = memory_allocate(0, sizeof(test_regex_matches_t), 0, MEMORY_PERSISTENT);
+
+	regex = regex_compile(STRING_CONST("(\\d+)ms"));
+	EXPECT_NE(regex, 0);
+	matches->count = 0;
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("a 12ms b 3ms c 4 d 560ms"), captures, 2,
+	                              test_regex_collect, matches), 3);
+	EXPECT_SIZEEQ(matches->count, 3);
+	EXPECT_SIZEEQ(matches->offset[0], 2);
+	EXPECT_SIZEEQ(matches->length[0], 4);
+	EXPECT_SIZEEQ(matches->capture[0], 2);
+	EXPECT_SIZEEQ(matches->offset[1], 9);
+	EXPECT_SIZEEQ(matches->length[1], 3);
+	EXPECT_SIZEEQ(matches->capture[1], 1);
+	EXPECT_SIZEEQ(matches->offset[2], 19);
+	EXPECT_SIZEEQ(matches->length[2], 5);
+	EXPECT_SIZEEQ(matches->capture[2], 3);
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("no durations"), 0, 0, 0, 0), 0);
+	limit = 2;
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("1ms 2ms 3ms 4ms"), 0, 0, test_regex_stop,
+	                              &limit), 2);
+	regex_deallocate(regex);
+
+	//Matches do not overlap, empty matches advance one character
+	regex = regex_compile(STRING_CONST("aa"));
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("aaaaa"), 0, 0, 0, 0), 2);
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("b*a"));
+	matches->count = 0;
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("abbac"), 0, 0, test_regex_collect, matches), 2);
+	EXPECT_SIZEEQ(matches->offset[0], 0);
+	EXPECT_SIZEEQ(matches->length[0], 1);
+	EXPECT_SIZEEQ(matches->offset[1], 1);
+	EXPECT_SIZEEQ(matches->length[1], 3);
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("c?"));
+	matches->count = 0;
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("acb"), 0, 0, test_regex_collect, matches), 3);
+	EXPECT_SIZEEQ(matches->offset[0], 0);
+	EXPECT_SIZEEQ(matches->length[0], 0);
+	EXPECT_SIZEEQ(matches->offset[1], 1);
+	EXPECT_SIZEEQ(matches->length[1], 1);
+	EXPECT_SIZEEQ(matches->offset[2], 2);
+	EXPECT_SIZEEQ(matches->length[2], 0);
+	regex_deallocate(regex);
+
+	regex = regex_compile(STRING_CONST("^ab"));
+	EXPECT_SIZEEQ(regex_match_all(regex, STRING_CONST("ababab"), 0, 0, 0, 0), 1);
+	regex_deallocate(regex);
+
+	memory_deallocate(matches);
+
+	return 0;
+}
+
+DECLARE_TEST(regex, stream) {
+	const char* patterns[] = {
+		"ERROR\\s+(\\d+)", "a+b", "b+c", "x[^y]*y", "(ab|ba)a?", "\\d\\d$", "^ab", "ERR"
+	};
+	char* content;
+	size_t size = 300000;
+	size_t ipat, i;
+	stream_t* stream;
+	string_const_t captures[1];
+	test_regex_matches_t* expect;
+	test_regex_matches_t* matches;
+	int limit;
+
+	expect = memory_allocate(0, sizeof(test_regex_matches_t), 0, MEMORY_PERSISTENT);
+	matches = memory_allocate(0, sizeof(test_regex_matches_t), 0, MEMORY_PERSISTENT);
+	content = memory_allocate(0, size, 0, MEMORY_PERSISTENT);
+
+	//Content with matches crossing chunk boundaries, and one match spanning several chunks
+	for (i = 0; i < size; ++i)
+		content[i] = "ab c   ab  \n"[random32_range(0, 12)];
+	for (i = 1000; i < size - 20; i += random32_range(1000, 5000))
+		memcpy(content + i, "ERROR   1234", 12);
+	memcpy(content + 65530, "ERROR 98765", 11);
+	content[70000] = 'x';
+	content[200000] = 'y';
+	memcpy(content + size - 2, "42", 2);
+	content[0] = 'a';
+	content[1] = 'b';
+
+	for (ipat = 0; ipat < sizeof(patterns) / sizeof(patterns[0]); ++ipat) {
+		regex_t* regex = regex_compile(patterns[ipat], string_length(patterns[ipat]));
+		EXPECT_NE(regex, 0);
+
+		expect->count = 0;
+		regex_match_all(regex, content, size, captures, 1, test_regex_collect, expect);
+		EXPECT_LT(expect->count, 32768);
+
+		stream = buffer_stream_allocate(content, STREAM_IN, size, size, false, false);
+		matches->count = 0;
+		EXPECT_SIZEEQ(regex_match_stream(regex, stream, false, captures, 1, test_regex_collect,
+		                                 matches), expect->count);
+		EXPECT_SIZEEQ(matches->count, expect->count);
+		for (i = 0; i < expect->count; ++i) {
+			EXPECT_SIZEEQ(matches->offset[i], expect->offset[i]);
+			EXPECT_SIZEEQ(matches->length[i], expect->length[i]);
+			EXPECT_SIZEEQ(matches->capture[i], expect->capture[i]);
+		}
+		stream_deallocate(stream);
+
+		//Line mode matches each line separately
+		expect->count = 0;
+		for (i = 0; i < size;) {
+			size_t end = string_find(content, size, '\n', i);
+			size_t base = expect->count;
+			size_t imatch;
+			if (end == STRING_NPOS)
+				end = size;
+			regex_match_all(regex, content + i, end - i, captures, 1, test_regex_collect, expect);
+			for (imatch = base; imatch < expect->count; ++imatch)
+				expect->offset[imatch] += i;
+			i = end + 1;
+		}
+
+		stream = buffer_stream_allocate(content, STREAM_IN, size, size, false, false);
+		matches->count = 0;
+		EXPECT_SIZEEQ(regex_match_stream(regex, stream, true, captures, 1, test_regex_collect,
+		                                 matches), expect->count);
+		for (i = 0; i < expect->count; ++i) {
+			EXPECT_SIZEEQ(matches->offset[i], expect->offset[i]);
+			EXPECT_SIZEEQ(matches->length[i], expect->length[i]);
+		}
+		stream_deallocate(stream);
+
+		regex_deallocate(regex);
+	}
+
+	{
+		regex_t* regex = regex_compile(STRING_CONST("ERROR"));
+		stream = buffer_stream_allocate(content, STREAM_IN, size, size, false, false);
+		limit = 3;
+		EXPECT_SIZEEQ(regex_match_stream(regex, stream, false, 0, 0, test_regex_stop, &limit), 3);
+		stream_deallocate(stream);
+		regex_deallocate(regex);
+	}
+
+	memory_deallocate(content);
+	memory_deallocate(matches);
+	memory_deallocate(expect);
+
+	return 0;
+}
+
+static atomic32_t _test_regex_cache_fail;
+
+static void*
+regex_cache_thread(void* arg) {
+	char pattern[32];
+	char input[32];
+	size_t i;
+	FOUNDATION_UNUSED(arg);
+	for (i = 0; i < 2000; ++i) {
+		uint32_t value = random32_range(0, 8);
+		string_t patternstr = string_format(pattern, sizeof(pattern), STRING_CONST("^id%u(\\d)$"),
+		                                    value);
+		string_t inputstr = string_format(input, sizeof(input), STRING_CONST("id%u%u"), value, value);
+		string_const_t captures[1];
+		regex_t* regex = regex_cache_acquire(STRING_ARGS(patternstr));
+		if (!regex || !regex_match(regex, STRING_ARGS(inputstr), captures, 1) ||
+		        (captures[0].length != 1) || (*captures[0].str != (char)('0' + value)) ||
+		        regex_match(regex, STRING_CONST("id9"), 0, 0))
+			atomic_incr32(&_test_regex_cache_fail);
+		regex_cache_release(regex);
+	}
+	return 0;
+}
+
+DECLARE_TEST(regex, cache) {
+	regex_t* first;
+	regex_t* regex;
+	thread_t thread[16];
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 4, 16);
+	size_t i;
+
+	first = regex_cache_acquire(STRING_CONST("^cached\\s+(\\d+)$"));
+	EXPECT_NE(first, 0);
+	regex = regex_cache_acquire(STRING_CONST("^cached\\s+(\\d+)$"));
+	EXPECT_EQ(regex, first);
+	regex_cache_release(regex);
+	EXPECT_EQ(regex_cache_acquire(STRING_CONST("(invalid")), 0);
+
+	//Evicted while held, the expression remains valid until released
+	regex = regex_cache_acquire(STRING_CONST("one"));
+	regex_cache_release(regex);
+	regex = regex_cache_acquire(STRING_CONST("two"));
+	regex_cache_release(regex);
+	regex = regex_cache_acquire(STRING_CONST("three"));
+	regex_cache_release(regex);
+	regex = regex_cache_acquire(STRING_CONST("four"));
+	regex_cache_release(regex);
+	EXPECT_TRUE(regex_match(first, STRING_CONST("cached 42"), 0, 0));
+	regex = regex_cache_acquire(STRING_CONST("^cached\\s+(\\d+)$"));
+	EXPECT_NE(regex, 0);
+	EXPECT_TRUE(regex_match(regex, STRING_CONST("cached 42"), 0, 0));
+	regex_cache_release(regex);
+	regex_cache_release(first);
+
+	//Recently used entries are kept
+	first = regex_cache_acquire(STRING_CONST("one"));
+	regex_cache_release(first);
+	regex = regex_cache_acquire(STRING_CONST("five"));
+	regex_cache_release(regex);
+	regex = regex_cache_acquire(STRING_CONST("one"));
+	EXPECT_EQ(regex, first);
+	regex_cache_release(regex);
+
+	//More patterns than cache entries matched concurrently
+	atomic_store32(&_test_regex_cache_fail, 0);
+	for (i = 0; i < num_threads; ++i)
+		thread_initialize(&thread[i], regex_cache_thread, 0, STRING_CONST("regex"),
+		                  THREAD_PRIORITY_NORMAL, 0);
+	for (i = 0; i < num_threads; ++i)
+		thread_start(&thread[i]);
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+	for (i = 0; i < num_threads; ++i)
+		thread_finalize(&thread[i]);
+	EXPECT_EQ(atomic_load32(&_test_regex_cache_fail), 0);
+
+	return 0;
+}
+
 static void
 test_regex_declare(void) {
 	ADD_TEST(regex, exact);
@@ -459,6 +848,11 @@ test_regex_declare(void) {
 	ADD_TEST(regex, noanchor);
 	ADD_TEST(regex, captures);
 	ADD_TEST(regex, invalid);
+	ADD_TEST(regex, dfa);
+	ADD_TEST(regex, literal);
+	ADD_TEST(regex, match_all);
+	ADD_TEST(regex, stream);
+	ADD_TEST(regex, cache);
 }
 
 static test_suite_t test_regex_suite = {
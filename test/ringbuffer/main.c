@@ -170,6 +170,228 @@ DECLARE_TEST(ringbuffer, io) {
 	return 0;
 }
 
+DECLARE_TEST(ringbuffer, spsc) {
+	ringbuffer_spsc_t* buffer;
+	char store[256];
+	char verify[256];
+	size_t num, ichar;
+	void* dest;
+	const void* source;
+
+	for (ichar = 0; ichar < 256; ++ichar)
+		store[ichar] = (char)ichar;
+
+	buffer = ringbuffer_spsc_allocate(0);
+	EXPECT_SIZEEQ(ringbuffer_spsc_size(buffer), 0);
+	EXPECT_SIZEEQ(ringbuffer_spsc_write(buffer, store, 256), 0);
+	EXPECT_SIZEEQ(ringbuffer_spsc_read(buffer, verify, 256), 0);
+	ringbuffer_spsc_deallocate(buffer);
+
+	buffer = ringbuffer_spsc_allocate(128);
+	EXPECT_SIZEEQ(ringbuffer_spsc_size(buffer), 128);
+	EXPECT_SIZEEQ(ringbuffer_spsc_available_write(buffer), 128);
+
+	//Full capacity is usable
+	EXPECT_SIZEEQ(ringbuffer_spsc_write(buffer, store, 256), 128);
+	EXPECT_SIZEEQ(ringbuffer_spsc_available_read(buffer), 128);
+	EXPECT_SIZEEQ(ringbuffer_spsc_write(buffer, store, 1), 0);
+	EXPECT_SIZEEQ(ringbuffer_spsc_read(buffer, verify, 100), 100);
+	EXPECT_EQ(memcmp(verify, store, 100), 0);
+
+	//Write wraps around end of buffer
+	EXPECT_SIZEEQ(ringbuffer_spsc_write(buffer, store, 90), 90);
+	EXPECT_SIZEEQ(ringbuffer_spsc_read(buffer, verify, 256), 118);
+	EXPECT_EQ(memcmp(verify, store + 100, 28), 0);
+	EXPECT_EQ(memcmp(verify + 28, store, 90), 0);
+	EXPECT_EQ(ringbuffer_spsc_total_read(buffer), 218);
+	EXPECT_EQ(ringbuffer_spsc_total_written(buffer), 218);
+
+	//Reserve returns contiguous space up to end of buffer
+	num = 64;
+	dest = ringbuffer_spsc_write_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 38);
+	memcpy(dest, store, num);
+	ringbuffer_spsc_write_commit(buffer, 30);
+	EXPECT_SIZEEQ(ringbuffer_spsc_available_read(buffer), 30);
+	num = 64;
+	dest = ringbuffer_spsc_write_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 8);
+	memcpy(dest, store + 30, num);
+	ringbuffer_spsc_write_commit(buffer, num);
+	num = 64;
+	dest = ringbuffer_spsc_write_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 64);
+	memcpy(dest, store + 38, num);
+	ringbuffer_spsc_write_commit(buffer, num);
+
+	num = 256;
+	source = ringbuffer_spsc_read_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 38);
+	EXPECT_EQ(memcmp(source, store, 38), 0);
+	ringbuffer_spsc_read_commit(buffer, num);
+	num = 256;
+	source = ringbuffer_spsc_read_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 64);
+	EXPECT_EQ(memcmp(source, store + 38, 64), 0);
+	ringbuffer_spsc_read_commit(buffer, num);
+	num = 256;
+	ringbuffer_spsc_read_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 0);
+
+	ringbuffer_spsc_deallocate(buffer);
+
+	return 0;
+}
+
+typedef struct {
+	ringbuffer_spsc_t* buffer;
+	size_t count;
+	uint32_t checksum;
+} ringbuffer_spsc_test_t;
+
+static void*
+spsc_producer_thread(void* arg) {
+	ringbuffer_spsc_test_t* test = arg;
+	uint32_t value = 0;
+	while (value < test->count) {
+		size_t num = 64 * sizeof(uint32_t);
+		uint32_t* dest = ringbuffer_spsc_write_reserve(test->buffer, &num);
+		size_t ivalue, count = num / sizeof(uint32_t);
+		if (count > test->count - value)
+			count = test->count - value;
+		if (!count) {
+			thread_yield();
+			continue;
+		}
+		for (ivalue = 0; ivalue < count; ++ivalue)
+			dest[ivalue] = value++;
+		ringbuffer_spsc_write_commit(test->buffer, count * sizeof(uint32_t));
+	}
+	return 0;
+}
+
+static void*
+spsc_consumer_thread(void* arg) {
+	ringbuffer_spsc_test_t* test = arg;
+	uint32_t values[37];
+	uint32_t expect = 0;
+	while (expect < test->count) {
+		size_t num = ringbuffer_spsc_read(test->buffer, values, sizeof(values));
+		size_t ivalue;
+		if (!num) {
+			thread_yield();
+			continue;
+		}
+		EXPECT_SIZEEQ(num % sizeof(uint32_t), 0);
+		for (ivalue = 0; ivalue < num / sizeof(uint32_t); ++ivalue, ++expect) {
+			EXPECT_EQ(values[ivalue], expect);
+			test->checksum += values[ivalue];
+		}
+	}
+	return 0;
+}
+
+DECLARE_TEST(ringbuffer, spsc_threaded) {
+	ringbuffer_spsc_test_t test;
+	thread_t producer, consumer;
+	uint32_t checksum = 0;
+	uint32_t value;
+
+	//Buffer size multiple of element size so elements never straddle the wrap point
+	test.buffer = ringbuffer_spsc_allocate(4096 * sizeof(uint32_t));
+	test.count = 4 * 1024 * 1024;
+	test.checksum = 0;
+	for (value = 0; value < test.count; ++value)
+		checksum += value;
+
+	thread_initialize(&consumer, spsc_consumer_thread, &test, STRING_CONST("consumer"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_initialize(&producer, spsc_producer_thread, &test, STRING_CONST("producer"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&consumer);
+	thread_start(&producer);
+
+	while (!thread_is_started(&consumer) || !thread_is_started(&producer))
+		thread_sleep(10);
+	while (thread_is_running(&consumer) || thread_is_running(&producer))
+		thread_sleep(10);
+
+	EXPECT_EQ(consumer.result, 0);
+	EXPECT_EQ(producer.result, 0);
+	EXPECT_EQ(test.checksum, checksum);
+	EXPECT_EQ(ringbuffer_spsc_total_read(test.buffer), test.count * sizeof(uint32_t));
+	EXPECT_EQ(ringbuffer_spsc_total_written(test.buffer), test.count * sizeof(uint32_t));
+
+	thread_finalize(&consumer);
+	thread_finalize(&producer);
+	ringbuffer_spsc_deallocate(test.buffer);
+
+	return 0;
+}
+
+DECLARE_TEST(ringbuffer, mirror) {
+	ringbuffer_mirror_t* buffer;
+	char store[256];
+	size_t size, num, ichar;
+	char* dest;
+	const char* source;
+
+	for (ichar = 0; ichar < 256; ++ichar)
+		store[ichar] = (char)ichar;
+
+	buffer = ringbuffer_mirror_allocate(100);
+	EXPECT_NE(buffer, 0);
+	size = ringbuffer_mirror_size(buffer);
+	EXPECT_SIZEGE(size, 100);
+	EXPECT_SIZEEQ(ringbuffer_mirror_available_write(buffer), size);
+
+	//Buffer pages are visible at both mappings
+	buffer->buffer[0] = 42;
+	EXPECT_EQ(buffer->buffer[size], 42);
+	buffer->buffer[size + 1] = 24;
+	EXPECT_EQ(buffer->buffer[1], 24);
+
+	//Move positions close to the end of the buffer
+	for (num = 0; num < size - 100;) {
+		size_t do_write = size - 100 - num;
+		if (do_write > sizeof(store))
+			do_write = sizeof(store);
+		EXPECT_SIZEEQ(ringbuffer_mirror_write(buffer, store, do_write), do_write);
+		EXPECT_SIZEEQ(ringbuffer_mirror_read(buffer, 0, do_write), do_write);
+		num += do_write;
+	}
+
+	//Reserve returns contiguous space across the end of buffer
+	num = 256;
+	dest = ringbuffer_mirror_write_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 256);
+	memcpy(dest, store, num);
+	ringbuffer_mirror_write_commit(buffer, num);
+	EXPECT_EQ(memcmp(buffer->buffer, store + 100, 156), 0);
+
+	num = 512;
+	source = ringbuffer_mirror_read_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, 256);
+	EXPECT_EQ(memcmp(source, store, 256), 0);
+	ringbuffer_mirror_read_commit(buffer, 200);
+	EXPECT_SIZEEQ(ringbuffer_mirror_available_read(buffer), 56);
+
+	//Full capacity is usable
+	EXPECT_SIZEEQ(ringbuffer_mirror_write(buffer, store, 1), 1);
+	num = size;
+	ringbuffer_mirror_write_reserve(buffer, &num);
+	EXPECT_SIZEEQ(num, size - 57);
+	ringbuffer_mirror_write_commit(buffer, num);
+	EXPECT_SIZEEQ(ringbuffer_mirror_available_write(buffer), 0);
+	EXPECT_SIZEEQ(ringbuffer_mirror_write(buffer, store, 1), 0);
+	EXPECT_SIZEEQ(ringbuffer_mirror_read(buffer, 0, size), size);
+	EXPECT_EQ(ringbuffer_mirror_total_read(buffer), ringbuffer_mirror_total_written(buffer));
+
+	ringbuffer_mirror_deallocate(buffer);
+
+	return 0;
+}
+
 typedef struct {
 	stream_t* stream;
 
@@ -310,12 +532,204 @@ DECLARE_TEST(ringbufferstream, threadedio) {
 	return 0;
 }
 
+typedef struct {
+	stream_t* stream;
+	char* source;
+	char* dest;
+	size_t size;
+} ringbufferstream_watermark_test_t;
+
+static void*
+watermark_write_thread(void* arg) {
+	ringbufferstream_watermark_test_t* test = arg;
+	size_t offset = 0;
+	while (offset < test->size) {
+		size_t num = (test->size - offset < 7) ? test->size - offset : 7;
+		stream_write(test->stream, test->source + offset, num);
+		offset += num;
+	}
+	return 0;
+}
+
+static void*
+watermark_read_thread(void* arg) {
+	ringbufferstream_watermark_test_t* test = arg;
+	size_t offset = 0;
+	while (offset < test->size) {
+		size_t num = (test->size - offset < 1000) ? test->size - offset : 1000;
+		EXPECT_SIZEEQ(stream_read(test->stream, test->dest + offset, num), num);
+		offset += num;
+	}
+	return 0;
+}
+
+DECLARE_TEST(ringbufferstream, watermark) {
+	ringbufferstream_watermark_test_t test;
+	thread_t reader, writer;
+	beacon_t* beacon;
+	char store[512];
+	size_t ichar;
+
+	for (ichar = 0; ichar < sizeof(store); ++ichar)
+		store[ichar] = (char)ichar;
+
+	beacon = beacon_allocate();
+	test.stream = ringbuffer_stream_allocate(1024, 0);
+	ringbuffer_stream_set_watermark(test.stream, 256, 512);
+	ringbuffer_stream_set_beacon(test.stream, beacon);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	//Beacon fires once when reaching low watermark
+	stream_write(test.stream, store, 100);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+	stream_write(test.stream, store, 200);
+	EXPECT_INTGE(beacon_try_wait(beacon, 0), 0);
+	stream_write(test.stream, store, 10);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+
+	//Draining below low watermark rearms beacon
+	stream_read(test.stream, 0, 100);
+	stream_write(test.stream, store, 10);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+	stream_read(test.stream, 0, 200);
+	stream_write(test.stream, store, 100);
+	EXPECT_INTLT(beacon_try_wait(beacon, 0), 0);
+	stream_write(test.stream, store, 200);
+	EXPECT_INTGE(beacon_try_wait(beacon, 0), 0);
+	EXPECT_SIZEEQ(stream_available_read(test.stream), 320);
+
+	ringbuffer_stream_set_beacon(test.stream, 0);
+	stream_deallocate(test.stream);
+
+	//Blocking transfers with watermarks, where end of stream is below low watermark
+	test.size = 256 * 1024 + 333;
+	test.source = memory_allocate(0, test.size, 0, MEMORY_PERSISTENT);
+	test.dest = memory_allocate(0, test.size, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (ichar = 0; ichar < test.size; ++ichar)
+		test.source[ichar] = (char)random32();
+	test.stream = ringbuffer_stream_allocate(4096, test.size);
+	ringbuffer_stream_set_watermark(test.stream, 2048, 1024);
+	ringbuffer_stream_set_beacon(test.stream, beacon);
+
+	thread_initialize(&reader, watermark_read_thread, &test, STRING_CONST("reader"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_initialize(&writer, watermark_write_thread, &test, STRING_CONST("writer"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&reader);
+	thread_start(&writer);
+
+	test_wait_for_threads_startup(&reader, 1);
+	test_wait_for_threads_startup(&writer, 1);
+	test_wait_for_threads_finish(&reader, 1);
+	test_wait_for_threads_finish(&writer, 1);
+
+	EXPECT_EQ(reader.result, 0);
+	EXPECT_EQ(memcmp(test.source, test.dest, test.size), 0);
+	EXPECT_TRUE(stream_eos(test.stream));
+
+	thread_finalize(&reader);
+	thread_finalize(&writer);
+	stream_deallocate(test.stream);
+	memory_deallocate(test.source);
+	memory_deallocate(test.dest);
+	beacon_deallocate(beacon);
+
+	return 0;
+}
+
+typedef struct {
+	stream_t* stream;
+	char* source;
+	size_t size;
+} ringbufferstream_shared_test_t;
+
+static void*
+shared_write_thread(void* arg) {
+	ringbufferstream_shared_test_t* test = arg;
+	size_t offset = 0;
+	while (offset < test->size) {
+		size_t num = (test->size - offset < 1013) ? test->size - offset : 1013;
+		if (stream_write(test->stream, test->source + offset, num) != num)
+			return FAILED_TEST;
+		offset += num;
+	}
+	return 0;
+}
+
+DECLARE_TEST(ringbufferstream, shared) {
+#if FOUNDATION_PLATFORM_ANDROID || FOUNDATION_PLATFORM_IOS || FOUNDATION_PLATFORM_PNACL
+	return 0;
+#else
+	ringbufferstream_shared_test_t test;
+	stream_t* reader;
+	thread_t writer;
+	char* dest;
+	char namebuf[64];
+	string_t name;
+	size_t ichar;
+
+	name = string_format(namebuf, sizeof(namebuf), STRING_CONST("foundation_test_rb_%u"),
+	                     (unsigned int)random32());
+
+	//Opening without size requires an existing ring buffer
+	EXPECT_EQ(ringbuffer_stream_allocate_shared(STRING_ARGS(name), 0, 0), nullptr);
+
+	test.size = 1024 * 1024 + 17;
+	test.source = memory_allocate(0, test.size, 0, MEMORY_PERSISTENT);
+	dest = memory_allocate(0, test.size, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (ichar = 0; ichar < test.size; ++ichar)
+		test.source[ichar] = (char)random32();
+
+	//Writer creates the shared ring buffer, reader maps the same memory by name
+	test.stream = ringbuffer_stream_allocate_shared(STRING_ARGS(name), 4096, test.size);
+	EXPECT_NE(test.stream, nullptr);
+	reader = ringbuffer_stream_allocate_shared(STRING_ARGS(name), 0, test.size);
+	EXPECT_NE(reader, nullptr);
+	EXPECT_EQ(reader->type, STREAMTYPE_RINGBUFFER);
+	EXPECT_TRUE(stream_is_sequential(reader));
+
+	stream_write(test.stream, test.source, 100);
+	EXPECT_SIZEEQ(stream_available_read(reader), 100);
+	EXPECT_SIZEEQ(stream_read(reader, dest, 100), 100);
+	EXPECT_EQ(memcmp(test.source, dest, 100), 0);
+
+	//Blocking transfer through a buffer much smaller than the data
+	test.source += 100;
+	test.size -= 100;
+	thread_initialize(&writer, shared_write_thread, &test, STRING_CONST("writer"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&writer);
+	EXPECT_SIZEEQ(stream_read(reader, dest + 100, test.size), test.size);
+	test_wait_for_threads_finish(&writer, 1);
+	EXPECT_EQ(writer.result, 0);
+	test.source -= 100;
+	test.size += 100;
+
+	EXPECT_EQ(memcmp(test.source, dest, test.size), 0);
+	EXPECT_TRUE(stream_eos(reader));
+	EXPECT_SIZEEQ(stream_tell(reader), test.size);
+
+	thread_finalize(&writer);
+	stream_deallocate(test.stream);
+	stream_deallocate(reader);
+	memory_deallocate(test.source);
+	memory_deallocate(dest);
+
+	return 0;
+#endif
+}
+
 static void
 test_ringbuffer_declare(void) {
 	ADD_TEST(ringbuffer, allocate);
 	ADD_TEST(ringbuffer, io);
+	ADD_TEST(ringbuffer, spsc);
+	ADD_TEST(ringbuffer, spsc_threaded);
+	ADD_TEST(ringbuffer, mirror);
 
 	ADD_TEST(ringbufferstream, threadedio);
+	ADD_TEST(ringbufferstream, watermark);
+	ADD_TEST(ringbufferstream, shared);
 }
 
 static test_suite_t test_ringbuffer_suite = {
@@ -0,0 +1,368 @@
+/* main.c  -  Foundation run loop test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_runloop_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation run loop tests"));
+	app.short_name = string_const(STRING_CONST("test_runloop"));
+	app.config_dir = string_const(STRING_CONST("test_runloop"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_runloop_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_runloop_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_runloop_initialize(void) {
+	return 0;
+}
+
+static void
+test_runloop_finalize(void) {
+}
+
+typedef struct {
+	size_t blocks;
+	size_t events;
+	int last_id;
+	tick_t delivered;
+} runloop_stream_test_t;
+
+static void
+runloop_test_stream(runloop_t* loop, event_stream_t* stream, event_block_t* block, void* arg) {
+	runloop_stream_test_t* test = arg;
+	event_t* event = 0;
+	FOUNDATION_UNUSED(loop);
+	FOUNDATION_UNUSED(stream);
+	++test->blocks;
+	while ((event = event_next(block, event))) {
+		++test->events;
+		test->last_id = event->id;
+		test->delivered = time_current();
+	}
+}
+
+typedef struct {
+	size_t calls;
+	unsigned int id;
+	tick_t fired[8];
+	bool cancel;
+	bool stop;
+} runloop_timer_test_t;
+
+static void
+runloop_test_timer(runloop_t* loop, unsigned int id, void* arg) {
+	runloop_timer_test_t* test = arg;
+	if (test->calls < sizeof(test->fired) / sizeof(test->fired[0]))
+		test->fired[test->calls] = time_current();
+	++test->calls;
+	test->id = id;
+	if (test->cancel)
+		runloop_cancel_timer(loop, id);
+	if (test->stop)
+		runloop_stop(loop);
+}
+
+static size_t runloop_beacon_calls;
+
+static void
+runloop_test_beacon(runloop_t* loop, beacon_t* beacon, void* arg) {
+	FOUNDATION_UNUSED(beacon);
+	FOUNDATION_UNUSED(arg);
+	++runloop_beacon_calls;
+	runloop_stop(loop);
+}
+
+static void*
+runloop_test_fire(void* arg) {
+	thread_sleep(20);
+	beacon_fire(arg);
+	return 0;
+}
+
+static void*
+runloop_test_post(void* arg) {
+	thread_sleep(20);
+	event_post(arg, FOUNDATIONEVENT_TERMINATE, 0, 0, 0, 0);
+	return 0;
+}
+
+static void*
+runloop_test_stop(void* arg) {
+	thread_sleep(20);
+	runloop_stop(arg);
+	return 0;
+}
+
+DECLARE_TEST(runloop, stream) {
+	runloop_t* loop;
+	event_stream_t* stream;
+	runloop_stream_test_t test;
+	thread_t thread;
+	tick_t start;
+
+	memset(&test, 0, sizeof(test));
+	loop = runloop_allocate();
+	stream = event_stream_allocate(0);
+
+	//Events posted before adding the stream are dispatched in the first pass
+	event_post(stream, FOUNDATIONEVENT_START, 0, 0, 0, 0);
+	event_post(stream, FOUNDATIONEVENT_RESUME, 0, 0, 0, 0);
+	runloop_add_stream(loop, stream, runloop_test_stream, &test);
+	EXPECT_SIZEEQ(runloop_run_once(loop, 0), 1);
+	EXPECT_SIZEEQ(test.blocks, 1);
+	EXPECT_SIZEEQ(test.events, 2);
+	EXPECT_INTEQ(test.last_id, FOUNDATIONEVENT_RESUME);
+
+	//Nothing pending
+	EXPECT_SIZEEQ(runloop_run_once(loop, 0), 0);
+	EXPECT_SIZEEQ(test.blocks, 1);
+
+	//Wait wakes up on event posted from another thread
+	thread_initialize(&thread, runloop_test_post, stream, STRING_CONST("runloop_post"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	start = time_current();
+	while (!test.blocks || (test.blocks == 1)) {
+		runloop_run_once(loop, 5000);
+		if (time_elapsed(start) > REAL_C(5.0))
+			break;
+	}
+	thread_join(&thread);
+	thread_finalize(&thread);
+	EXPECT_SIZEEQ(test.blocks, 2);
+	EXPECT_INTEQ(test.last_id, FOUNDATIONEVENT_TERMINATE);
+	EXPECT_REALLT(time_elapsed(start), REAL_C(2.0));
+
+	runloop_remove_stream(loop, stream);
+	event_post(stream, FOUNDATIONEVENT_START, 0, 0, 0, 0);
+	EXPECT_SIZEEQ(runloop_run_once(loop, 0), 0);
+	EXPECT_SIZEEQ(test.blocks, 2);
+
+	runloop_deallocate(loop);
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(runloop, delayed) {
+	runloop_t* loop;
+	event_stream_t* stream;
+	runloop_stream_test_t test;
+	tick_t start, delivery;
+	size_t passes = 0;
+
+	memset(&test, 0, sizeof(test));
+	loop = runloop_allocate();
+	stream = event_stream_allocate(0);
+	runloop_add_stream(loop, stream, runloop_test_stream, &test);
+
+	//Delayed event is delivered when due without any other event firing the beacon
+	start = time_current();
+	delivery = start + (time_ticks_per_second() / 20);
+	event_post(stream, FOUNDATIONEVENT_TERMINATE, 0, delivery, 0, 0);
+	while (!test.events && (passes < 16)) {
+		runloop_run_once(loop, 5000);
+		++passes;
+	}
+	EXPECT_SIZEEQ(test.events, 1);
+	EXPECT_TICKGE(test.delivered, delivery);
+	EXPECT_REALLT(time_elapsed(start), REAL_C(2.0));
+	//Sleeping until the deadline takes a few passes at most, not one per poll interval
+	EXPECT_SIZELE(passes, 4);
+
+	runloop_deallocate(loop);
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(runloop, timer) {
+	runloop_t* loop;
+	runloop_timer_test_t oneshot, early, periodic;
+	unsigned int id, periodic_id;
+	tick_t start;
+	size_t passes = 0;
+
+	memset(&oneshot, 0, sizeof(oneshot));
+	memset(&early, 0, sizeof(early));
+	memset(&periodic, 0, sizeof(periodic));
+	loop = runloop_allocate();
+
+	start = time_current();
+	id = runloop_add_timer(loop, 60, 0, runloop_test_timer, &oneshot);
+	EXPECT_UINTNE(id, 0);
+	EXPECT_UINTNE(runloop_add_timer(loop, 20, 0, runloop_test_timer, &early), 0);
+	periodic_id = runloop_add_timer(loop, 10, 10, runloop_test_timer, &periodic);
+	EXPECT_UINTNE(periodic_id, id);
+
+	while (!oneshot.calls && (passes < 64)) {
+		runloop_run_once(loop, 5000);
+		++passes;
+	}
+	EXPECT_SIZEEQ(oneshot.calls, 1);
+	EXPECT_UINTEQ(oneshot.id, id);
+	EXPECT_SIZEEQ(early.calls, 1);
+	EXPECT_TICKLT(early.fired[0], oneshot.fired[0]);
+	EXPECT_REALGE(time_ticks_to_seconds(oneshot.fired[0] - start), REAL_C(0.059));
+	EXPECT_REALGE(time_ticks_to_seconds(early.fired[0] - start), REAL_C(0.019));
+	EXPECT_SIZEGE(periodic.calls, 3);
+	EXPECT_TICKLT(periodic.fired[0], periodic.fired[1]);
+
+	//One-shot timers are removed once called
+	EXPECT_FALSE(runloop_cancel_timer(loop, id));
+
+	//Cancel periodic timer from its own callback
+	periodic.calls = 0;
+	periodic.cancel = true;
+	runloop_run_once(loop, 100);
+	EXPECT_SIZEEQ(periodic.calls, 1);
+	EXPECT_FALSE(runloop_cancel_timer(loop, periodic_id));
+	EXPECT_SIZEEQ(runloop_run_once(loop, 30), 0);
+	EXPECT_SIZEEQ(periodic.calls, 1);
+
+	//Cancel pending timer
+	oneshot.calls = 0;
+	id = runloop_add_timer(loop, 10, 0, runloop_test_timer, &oneshot);
+	EXPECT_TRUE(runloop_cancel_timer(loop, id));
+	EXPECT_SIZEEQ(runloop_run_once(loop, 30), 0);
+	EXPECT_SIZEEQ(oneshot.calls, 0);
+
+	runloop_deallocate(loop);
+
+	return 0;
+}
+
+DECLARE_TEST(runloop, beacon) {
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID || \
+    FOUNDATION_PLATFORM_APPLE || FOUNDATION_PLATFORM_BSD
+	runloop_t* loop;
+	beacon_t beacon;
+	thread_t thread;
+
+	runloop_beacon_calls = 0;
+	loop = runloop_allocate();
+	beacon_initialize(&beacon);
+	EXPECT_TRUE(runloop_add_beacon(loop, &beacon, runloop_test_beacon, 0));
+
+	EXPECT_SIZEEQ(runloop_run_once(loop, 0), 0);
+
+	//Callback stops the loop when the beacon fired from another thread
+	thread_initialize(&thread, runloop_test_fire, &beacon, STRING_CONST("runloop_fire"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	runloop_run(loop);
+	thread_join(&thread);
+	thread_finalize(&thread);
+	EXPECT_SIZEEQ(runloop_beacon_calls, 1);
+
+	//Beacon was consumed by the loop
+	EXPECT_INTLT(beacon_try_wait(&beacon, 0), 0);
+	EXPECT_SIZEEQ(runloop_run_once(loop, 0), 0);
+
+	runloop_remove_beacon(loop, &beacon);
+	beacon_fire(&beacon);
+	EXPECT_SIZEEQ(runloop_run_once(loop, 10), 0);
+	EXPECT_SIZEEQ(runloop_beacon_calls, 1);
+	EXPECT_INTEQ(beacon_try_wait(&beacon, 0), 0);
+
+	runloop_deallocate(loop);
+	beacon_finalize(&beacon);
+#endif
+	return 0;
+}
+
+DECLARE_TEST(runloop, stop) {
+	runloop_t* loop;
+	runloop_timer_test_t periodic;
+	thread_t thread;
+
+	memset(&periodic, 0, sizeof(periodic));
+	loop = runloop_allocate();
+
+	//Stop from another thread
+	thread_initialize(&thread, runloop_test_stop, loop, STRING_CONST("runloop_stop"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	runloop_run(loop);
+	thread_join(&thread);
+	thread_finalize(&thread);
+
+	//Stop from callback, stop flag is cleared when the loop returns
+	periodic.stop = true;
+	runloop_add_timer(loop, 5, 5, runloop_test_timer, &periodic);
+	runloop_run(loop);
+	EXPECT_SIZEEQ(periodic.calls, 1);
+	runloop_run(loop);
+	EXPECT_SIZEEQ(periodic.calls, 2);
+
+	runloop_deallocate(loop);
+
+	return 0;
+}
+
+static void
+test_runloop_declare(void) {
+	ADD_TEST(runloop, stream);
+	ADD_TEST(runloop, delayed);
+	ADD_TEST(runloop, timer);
+	ADD_TEST(runloop, beacon);
+	ADD_TEST(runloop, stop);
+}
+
+static test_suite_t test_runloop_suite = {
+	test_runloop_application,
+	test_runloop_memory_system,
+	test_runloop_config,
+	test_runloop_declare,
+	test_runloop_initialize,
+	test_runloop_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_runloop_run(void);
+
+int
+test_runloop_run(void) {
+	test_suite = test_runloop_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_runloop_suite;
+}
+
+#endif
@@ -0,0 +1,215 @@
+/* main.c  -  Foundation sha256 test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_sha256_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation sha256 tests"));
+	app.short_name = string_const(STRING_CONST("test_sha256"));
+	app.config_dir = string_const(STRING_CONST("test_sha256"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_sha256_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_sha256_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_sha256_initialize(void) {
+	return 0;
+}
+
+static void
+test_sha256_finalize(void) {
+}
+
+DECLARE_TEST(sha256, reference) {
+	sha256_t* sha256;
+	char sha256str[65];
+	char block[100];
+	string_t digest;
+	size_t i;
+
+	sha256 = sha256_allocate();
+	sha256_digest_finalize(sha256);
+	digest = sha256_get_digest(sha256, sha256str, sizeof(sha256str));
+	EXPECT_STRINGEQ(digest, string_const(STRING_CONST(
+	                  "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855")));
+
+	sha256_digest(sha256, "abc", 3);
+	sha256_digest_finalize(sha256);
+	digest = sha256_get_digest(sha256, sha256str, sizeof(sha256str));
+	EXPECT_STRINGEQ(digest, string_const(STRING_CONST(
+	                  "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD")));
+	EXPECT_TRUE(uint256_equal(sha256_get_digest_raw(sha256),
+	                          uint256_make(byteorder_bigendian64(0xba7816bf8f01cfeaULL),
+	                                       byteorder_bigendian64(0x414140de5dae2223ULL),
+	                                       byteorder_bigendian64(0xb00361a396177a9cULL),
+	                                       byteorder_bigendian64(0xb410ff61f20015adULL))));
+
+	//Padding spilling into an extra block
+	sha256_digest(sha256, STRING_CONST("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+	sha256_digest_finalize(sha256);
+	digest = sha256_get_digest(sha256, sha256str, sizeof(sha256str));
+	EXPECT_STRINGEQ(digest, string_const(STRING_CONST(
+	                  "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1")));
+
+	memset(block, 'a', sizeof(block));
+	for (i = 0; i < 10000; ++i)
+		sha256_digest(sha256, block, sizeof(block));
+	sha256_digest_finalize(sha256);
+	digest = sha256_get_digest(sha256, sha256str, sizeof(sha256str));
+	EXPECT_STRINGEQ(digest, string_const(STRING_CONST(
+	                  "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0")));
+
+	sha256_deallocate(sha256);
+
+	return 0;
+}
+
+DECLARE_TEST(sha256, incremental) {
+	sha256_t sha256;
+	uint8_t data[1000];
+	uint256_t expect;
+	size_t i, chunk, offset;
+
+	for (i = 0; i < sizeof(data); ++i)
+		data[i] = (uint8_t)((i * 31) + 7);
+
+	sha256_initialize(&sha256);
+	sha256_digest(&sha256, data, sizeof(data));
+	sha256_digest_finalize(&sha256);
+	expect = sha256_get_digest_raw(&sha256);
+
+	//Chunk sizes crossing block boundaries at different offsets
+	for (chunk = 1; chunk < 140; ++chunk) {
+		sha256_initialize(&sha256);
+		for (offset = 0; offset < sizeof(data); offset += chunk) {
+			size_t size = (offset + chunk > sizeof(data)) ? (sizeof(data) - offset) : chunk;
+			sha256_digest(&sha256, data + offset, size);
+		}
+		sha256_digest_finalize(&sha256);
+		EXPECT_TRUE(uint256_equal(sha256_get_digest_raw(&sha256), expect));
+	}
+	sha256_finalize(&sha256);
+
+	return 0;
+}
+
+DECLARE_TEST(sha256, streams) {
+	char path_buffer[BUILD_MAX_PATHLEN];
+	string_t path;
+	string_const_t directory;
+	stream_t* stream;
+	stream_t* unix_stream;
+	stream_t* windows_stream;
+	sha256_t sha256;
+	uint256_t digest;
+	char unix_buffer[] = "first line\nsecond line\n\nlast line\n";
+	char windows_buffer[] = "first line\r\nsecond line\r\n\r\nlast line\r\n";
+
+	sha256_initialize(&sha256);
+	sha256_digest(&sha256, STRING_CONST(unix_buffer));
+	sha256_digest_finalize(&sha256);
+	digest = sha256_get_digest_raw(&sha256);
+
+	unix_stream = buffer_stream_allocate((void*)unix_buffer, STREAM_IN, string_length(unix_buffer),
+	                                     string_length(unix_buffer), false, false);
+	windows_stream = buffer_stream_allocate((void*)windows_buffer, STREAM_IN,
+	                                        string_length(windows_buffer),
+	                                        string_length(windows_buffer), false, false);
+
+	stream_set_binary(unix_stream, false);
+	stream_set_binary(windows_stream, false);
+	EXPECT_TRUE(uint256_equal(stream_sha256(unix_stream), digest));
+	EXPECT_TRUE(uint256_equal(stream_sha256(windows_stream), digest));
+
+	stream_set_binary(windows_stream, true);
+	EXPECT_FALSE(uint256_equal(stream_sha256(windows_stream), digest));
+
+	stream_deallocate(unix_stream);
+	stream_deallocate(windows_stream);
+
+	//Mapped and streamed file content
+	path = path_make_temporary(path_buffer, sizeof(path_buffer));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_BINARY | STREAM_CREATE |
+	                     STREAM_TRUNCATE);
+	EXPECT_NE(stream, 0);
+	stream_write(stream, STRING_CONST(unix_buffer));
+	stream_deallocate(stream);
+
+	EXPECT_TRUE(uint256_equal(fs_sha256(STRING_ARGS(path)), digest));
+	stream = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	EXPECT_TRUE(uint256_equal(stream_sha256(stream), digest));
+	stream_deallocate(stream);
+
+	fs_remove_file(STRING_ARGS(path));
+	EXPECT_TRUE(uint256_is_null(fs_sha256(STRING_ARGS(path))));
+
+	return 0;
+}
+
+static void
+test_sha256_declare(void) {
+	ADD_TEST(sha256, reference);
+	ADD_TEST(sha256, incremental);
+	ADD_TEST(sha256, streams);
+}
+
+static test_suite_t test_sha256_suite = {
+	test_sha256_application,
+	test_sha256_memory_system,
+	test_sha256_config,
+	test_sha256_declare,
+	test_sha256_initialize,
+	test_sha256_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_sha256_run(void);
+
+int
+test_sha256_run(void) {
+	test_suite = test_sha256_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_sha256_suite;
+}
+
+#endif
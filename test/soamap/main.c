@@ -0,0 +1,207 @@
+/* main.c  -  Foundation soamap test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_soamap_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation soamap tests"));
+	app.short_name = string_const(STRING_CONST("test_soamap"));
+	app.config_dir = string_const(STRING_CONST("test_soamap"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_soamap_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_soamap_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_soamap_initialize(void) {
+	return 0;
+}
+
+static void
+test_soamap_finalize(void) {
+}
+
+typedef struct {
+	real x, y, z;
+} soamap_position_t;
+
+static object_base_t _soamap_object[1024];
+
+static object_t
+soamap_object_reserve(objectmap_t* objects, size_t iobj) {
+	object_t id = objectmap_reserve(objects);
+	_soamap_object[iobj].id = id;
+	objectmap_set(objects, id, _soamap_object + iobj);
+	return id;
+}
+
+DECLARE_TEST(soamap, insert) {
+	objectmap_t* objects = objectmap_allocate(64);
+	size_t field_size[] = { sizeof(soamap_position_t), sizeof(uint32_t) };
+	soamap_t* map = soamap_allocate(objects, field_size, 2, 0);
+	object_t id[64];
+	size_t iobj, row;
+	soamap_position_t* position;
+	uint32_t* flags;
+
+	EXPECT_SIZEEQ(soamap_size(map), 0);
+	EXPECT_SIZEEQ(soamap_index(map, 0), SOAMAP_INVALID);
+
+	for (iobj = 0; iobj < 64; ++iobj) {
+		id[iobj] = soamap_object_reserve(objects, iobj);
+		EXPECT_NE(id[iobj], 0);
+		row = soamap_insert(map, id[iobj]);
+		EXPECT_SIZEEQ(row, iobj);
+		flags = soamap_lookup(map, id[iobj], 1);
+		EXPECT_NE(flags, 0);
+		EXPECT_UINTEQ(*flags, 0);
+		*flags = (uint32_t)iobj;
+		position = soamap_lookup(map, id[iobj], 0);
+		position->x = (real)iobj;
+	}
+	EXPECT_SIZEEQ(soamap_size(map), 64);
+	EXPECT_SIZEEQ(soamap_insert(map, id[7]), 7);
+	EXPECT_SIZEEQ(soamap_size(map), 64);
+
+	//Fields are contiguous arrays in row order
+	flags = soamap_field(map, 1);
+	position = soamap_field(map, 0);
+	for (row = 0; row < soamap_size(map); ++row) {
+		EXPECT_UINTEQ(flags[row], (uint32_t)row);
+		EXPECT_REALEQ(position[row].x, (real)row);
+		EXPECT_EQ(soamap_objects(map)[row], id[row]);
+	}
+
+	soamap_deallocate(map);
+	for (iobj = 0; iobj < 64; ++iobj)
+		objectmap_free(objects, id[iobj]);
+	objectmap_deallocate(objects);
+
+	return 0;
+}
+
+DECLARE_TEST(soamap, remove) {
+	objectmap_t* objects = objectmap_allocate(1024);
+	size_t field_size[] = { sizeof(uint64_t) };
+	soamap_t map;
+	object_t id[1024];
+	object_t stale;
+	size_t iobj, row;
+	uint64_t* value;
+
+	soamap_initialize(&map, objects, field_size, 1, 16);
+	for (iobj = 0; iobj < 1024; ++iobj) {
+		id[iobj] = soamap_object_reserve(objects, iobj);
+		row = soamap_insert(&map, id[iobj]);
+		*(uint64_t*)soamap_lookup(&map, id[iobj], 0) = id[iobj];
+		EXPECT_SIZEEQ(row, iobj);
+	}
+	EXPECT_GE(map.capacity, 1024);
+
+	//Swap remove keeps rows dense and handles mapped to their own row
+	for (iobj = 0; iobj < 1024; iobj += 3) {
+		EXPECT_TRUE(soamap_remove(&map, id[iobj]));
+		EXPECT_FALSE(soamap_remove(&map, id[iobj]));
+		EXPECT_EQ(soamap_lookup(&map, id[iobj], 0), 0);
+	}
+	EXPECT_SIZEEQ(soamap_size(&map), 1024 - 342);
+	value = soamap_field(&map, 0);
+	for (row = 0; row < soamap_size(&map); ++row) {
+		EXPECT_EQ(value[row], soamap_objects(&map)[row]);
+		EXPECT_SIZEEQ(soamap_index(&map, soamap_objects(&map)[row]), row);
+	}
+	for (iobj = 0; iobj < 1024; ++iobj) {
+		if (iobj % 3)
+			EXPECT_EQ(*(uint64_t*)soamap_lookup(&map, id[iobj], 0), id[iobj]);
+	}
+
+	//Outdated handle for a reused slot is rejected, and its row replaced on insert
+	stale = id[1];
+	objectmap_free(objects, stale);
+	id[1] = soamap_object_reserve(objects, 1);
+	EXPECT_NE(id[1], stale);
+	EXPECT_EQ((id[1] & objects->mask_index), (stale & objects->mask_index));
+	EXPECT_SIZEEQ(soamap_index(&map, id[1]), SOAMAP_INVALID);
+	EXPECT_NE(soamap_index(&map, stale), SOAMAP_INVALID);
+	row = soamap_insert(&map, id[1]);
+	EXPECT_SIZEEQ(soamap_index(&map, id[1]), row);
+	EXPECT_SIZEEQ(soamap_index(&map, stale), SOAMAP_INVALID);
+	EXPECT_EQ(*(uint64_t*)soamap_lookup(&map, id[1], 0), 0);
+	EXPECT_SIZEEQ(soamap_size(&map), 1024 - 342);
+
+	soamap_clear(&map);
+	EXPECT_SIZEEQ(soamap_size(&map), 0);
+	for (iobj = 0; iobj < 1024; ++iobj)
+		EXPECT_SIZEEQ(soamap_index(&map, id[iobj]), SOAMAP_INVALID);
+	EXPECT_SIZEEQ(soamap_insert(&map, id[2]), 0);
+
+	soamap_finalize(&map);
+	for (iobj = 0; iobj < 1024; ++iobj)
+		objectmap_free(objects, id[iobj]);
+	objectmap_deallocate(objects);
+
+	return 0;
+}
+
+static void
+test_soamap_declare(void) {
+	ADD_TEST(soamap, insert);
+	ADD_TEST(soamap, remove);
+}
+
+static test_suite_t test_soamap_suite = {
+	test_soamap_application,
+	test_soamap_memory_system,
+	test_soamap_config,
+	test_soamap_declare,
+	test_soamap_initialize,
+	test_soamap_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_soamap_run(void);
+
+int
+test_soamap_run(void) {
+	test_suite = test_soamap_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_soamap_suite;
+}
+
+#endif
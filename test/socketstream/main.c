@@ -0,0 +1,262 @@
+/* main.c  -  Foundation socket stream test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_socketstream_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation socket stream tests"));
+	app.short_name = string_const(STRING_CONST("test_socketstream"));
+	app.config_dir = string_const(STRING_CONST("test_socketstream"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_socketstream_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_socketstream_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_socketstream_initialize(void) {
+	return 0;
+}
+
+static void
+test_socketstream_finalize(void) {
+}
+
+#if FOUNDATION_PLATFORM_POSIX
+
+static void
+socketstream_connect(const char* address, size_t length, stream_t** listener, stream_t** client,
+                     stream_t** server) {
+	*listener = socket_stream_listen(address, length, 0);
+	*client = *listener ? stream_open(STRING_ARGS((*listener)->path),
+	                                  STREAM_IN | STREAM_OUT | STREAM_BINARY) : 0;
+	*server = *client ? socket_stream_accept(*listener) : 0;
+}
+
+DECLARE_TEST(socketstream, tcp) {
+	stream_t* listener;
+	stream_t* client;
+	stream_t* server;
+	stream_span_t spans[3];
+	char buffer[64];
+	string_t str;
+
+	socketstream_connect(STRING_CONST("tcp://127.0.0.1:0"), &listener, &client, &server);
+	EXPECT_NE(listener, 0);
+	EXPECT_NE(client, 0);
+	EXPECT_NE(server, 0);
+	EXPECT_INTEQ(client->type, STREAMTYPE_SOCKET);
+	EXPECT_TRUE(stream_is_sequential(client));
+	EXPECT_NE(string_find_string(STRING_ARGS(listener->path), STRING_CONST("tcp://127.0.0.1:"), 0),
+	          STRING_NPOS);
+	EXPECT_NE(string_find_string(STRING_ARGS(server->path), STRING_CONST("tcp://127.0.0.1:"), 0),
+	          STRING_NPOS);
+	EXPECT_FALSE(stream_eos(client));
+
+	//Stream helpers serialize over the connection
+	socket_stream_set_nodelay(client, true);
+	stream_write_uint32(client, 0x12345678);
+	stream_write_string(client, STRING_CONST("foundation"));
+	stream_flush(client);
+	EXPECT_UINTEQ(stream_read_uint32(server), 0x12345678);
+	str = stream_read_string(server);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("foundation")));
+	string_deallocate(str.str);
+
+	//Vectored write gathers buffers, corked data is sent on flush
+	socket_stream_set_cork(server, true);
+	spans[0].data = (void*)(uintptr_t)"first ";
+	spans[0].size = 6;
+	spans[1].data = (void*)(uintptr_t)"second ";
+	spans[1].size = 7;
+	spans[2].data = (void*)(uintptr_t)"third";
+	spans[2].size = 5;
+	EXPECT_SIZEEQ(stream_write_vector(server, spans, 3), 18);
+	stream_flush(server);
+	socket_stream_set_cork(server, false);
+	EXPECT_SIZEEQ(stream_read(client, buffer, 18), 18);
+	EXPECT_CONSTSTRINGEQ(string_const(buffer, 18), string_const(STRING_CONST("first second third")));
+
+	//Closing write side flags end of stream on peer once data is read
+	stream_write(server, "end", 3);
+	socket_stream_close_write(server);
+	EXPECT_SIZEEQ(stream_read(client, buffer, sizeof(buffer)), 3);
+	EXPECT_TRUE(stream_eos(client));
+	EXPECT_FALSE(stream_eos(server));
+
+	//Server can still read after closing write side
+	stream_write(client, "ok", 2);
+	EXPECT_SIZEEQ(stream_read(server, buffer, 2), 2);
+	EXPECT_CONSTSTRINGEQ(string_const(buffer, 2), string_const(STRING_CONST("ok")));
+
+	stream_deallocate(server);
+	stream_deallocate(client);
+	stream_deallocate(listener);
+
+	return 0;
+}
+
+DECLARE_TEST(socketstream, nonblocking) {
+	stream_t* listener;
+	stream_t* client;
+	stream_t* server;
+	beacon_t beacon;
+	char buffer[64];
+	size_t written, total;
+	char* block;
+
+	socketstream_connect(STRING_CONST("tcp://127.0.0.1:0"), &listener, &client, &server);
+	EXPECT_NE(server, 0);
+
+	//Non-blocking read without data is not end of stream
+	socket_stream_set_nonblocking(server, true);
+	EXPECT_SIZEEQ(stream_read(server, buffer, sizeof(buffer)), 0);
+	EXPECT_FALSE(stream_eos(server));
+	EXPECT_SIZEEQ(stream_available_read(server), 0);
+
+	//Beacon fires when data is available
+	beacon_initialize(&beacon);
+	EXPECT_INTGT(beacon_add(&beacon, socket_stream_handle(server)), 0);
+	EXPECT_INTLT(beacon_try_wait(&beacon, 0), 0);
+	stream_write(client, "data", 4);
+	EXPECT_INTGT(beacon_try_wait(&beacon, 1000), 0);
+	EXPECT_SIZEEQ(stream_available_read(server), 4);
+	EXPECT_SIZEEQ(stream_read(server, buffer, sizeof(buffer)), 4);
+	EXPECT_FALSE(stream_eos(server));
+	beacon_finalize(&beacon);
+
+	//Non-blocking write stops when socket buffers are full
+	socket_stream_set_nonblocking(client, true);
+	block = memory_allocate(0, 64 * 1024, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	total = 0;
+	do {
+		written = stream_write(client, block, 64 * 1024);
+		total += written;
+	}
+	while ((written == 64 * 1024) && (total < 256 * 1024 * 1024));
+	EXPECT_SIZELT(written, 64 * 1024);
+	EXPECT_FALSE(stream_eos(client));
+	memory_deallocate(block);
+
+	//Accept on non-blocking listener without pending connection
+	socket_stream_set_nonblocking(listener, true);
+	EXPECT_EQ(socket_stream_accept(listener), 0);
+
+	stream_deallocate(server);
+	stream_deallocate(client);
+	stream_deallocate(listener);
+
+	return 0;
+}
+
+DECLARE_TEST(socketstream, unix) {
+	stream_t* listener;
+	stream_t* client;
+	stream_t* server;
+	char address[256];
+	string_t path;
+	string_const_t tmp = environment_temporary_directory();
+
+	path = string_format(address, sizeof(address), STRING_CONST("unix://%.*s/sock-%" PRIx64),
+	                     STRING_FORMAT(tmp), random64());
+	socketstream_connect(STRING_ARGS(path), &listener, &client, &server);
+	EXPECT_NE(listener, 0);
+	EXPECT_NE(client, 0);
+	EXPECT_NE(server, 0);
+	EXPECT_STRINGEQ(listener->path, string_to_const(path));
+
+	stream_write_uint64(server, 0x0123456789abcdefULL);
+	EXPECT_TRUE(stream_read_uint64(client) == 0x0123456789abcdefULL);
+
+	stream_deallocate(server);
+	EXPECT_SIZEEQ(stream_read(client, address, 1), 0);
+	EXPECT_TRUE(stream_eos(client));
+	stream_deallocate(client);
+
+	//Socket file is removed with the listening stream
+	stream_deallocate(listener);
+	EXPECT_FALSE(fs_is_file(path.str + 7, path.length - 7));
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_ERROR);
+	EXPECT_EQ(stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT), 0);
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_INFO);
+
+	return 0;
+}
+
+DECLARE_TEST(socketstream, address) {
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_ERROR);
+	EXPECT_EQ(stream_open(STRING_CONST("tcp://127.0.0.1"), STREAM_IN), 0);
+	EXPECT_EQ(stream_open(STRING_CONST("tcp://[::1"), STREAM_IN), 0);
+	EXPECT_EQ(stream_open(STRING_CONST("tcp://127.0.0.1:"), STREAM_IN), 0);
+	EXPECT_EQ(socket_stream_listen(STRING_CONST("udp://127.0.0.1:0"), 0), 0);
+	log_set_suppress(HASH_STREAM, ERRORLEVEL_INFO);
+	return 0;
+}
+
+#endif
+
+static void
+test_socketstream_declare(void) {
+#if FOUNDATION_PLATFORM_POSIX
+	ADD_TEST(socketstream, tcp);
+	ADD_TEST(socketstream, nonblocking);
+	ADD_TEST(socketstream, unix);
+	ADD_TEST(socketstream, address);
+#endif
+}
+
+static test_suite_t test_socketstream_suite = {
+	test_socketstream_application,
+	test_socketstream_memory_system,
+	test_socketstream_config,
+	test_socketstream_declare,
+	test_socketstream_initialize,
+	test_socketstream_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_socketstream_run(void);
+
+int
+test_socketstream_run(void) {
+	test_suite = test_socketstream_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_socketstream_suite;
+}
+
+#endif
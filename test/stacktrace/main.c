@@ -13,6 +13,10 @@
 #include <foundation/foundation.h>
 #include <test/test.h>
 
+#if FOUNDATION_PLATFORM_POSIX
+#include <foundation/posix.h>
+#endif
+
 static application_t
 test_stacktrace_application(void) {
 	application_t app;
@@ -96,10 +100,164 @@ DECLARE_TEST(stacktrace, resolve) {
 	return 0;
 }
 
+DECLARE_TEST(stacktrace, resolve_many) {
+	void* trace[2][TEST_DEPTH];
+	void** traces[3];
+	size_t depths[3];
+	string_t resolved[3];
+	string_t single;
+	char* buffer;
+	char* singlebuffer;
+	size_t used;
+
+	if (system_platform() == PLATFORM_PNACL)
+		return 0;
+
+	depths[0] = stacktrace_capture(trace[0], TEST_DEPTH, 0);
+	depths[1] = stacktrace_capture(trace[1], TEST_DEPTH, 1);
+	EXPECT_GT(depths[0], 3);
+	EXPECT_GT(depths[1], 3);
+	traces[0] = trace[0];
+	traces[1] = trace[1];
+	traces[2] = trace[0];
+	depths[2] = depths[0];
+
+	buffer = memory_allocate(0, 8192, 0, MEMORY_TEMPORARY);
+	singlebuffer = memory_allocate(0, 4096, 0, MEMORY_TEMPORARY);
+
+	used = stacktrace_resolve_many(buffer, 8192, traces, depths, 3, resolved);
+	EXPECT_GT(used, 0);
+	EXPECT_SIZELE(used, 8192);
+	EXPECT_NE(resolved[0].length, 0);
+	EXPECT_NE(resolved[1].length, 0);
+	EXPECT_TRUE(string_equal(STRING_ARGS(resolved[0]), STRING_ARGS(resolved[2])));
+	EXPECT_LT(resolved[0].str, resolved[1].str);
+	EXPECT_LT(resolved[1].str, resolved[2].str);
+
+	//Cached symbols resolve to the same string as a batch
+	single = stacktrace_resolve(singlebuffer, 4096, trace[1], depths[1], 0);
+	EXPECT_TRUE(string_equal(STRING_ARGS(single), STRING_ARGS(resolved[1])));
+
+	stacktrace_cache_clear();
+	single = stacktrace_resolve(singlebuffer, 4096, trace[0], depths[0], 0);
+	EXPECT_TRUE(string_equal(STRING_ARGS(single), STRING_ARGS(resolved[0])));
+
+	//Traces not fitting in buffer are truncated or empty
+	used = stacktrace_resolve_many(buffer, 64, traces, depths, 3, resolved);
+	EXPECT_SIZELE(used, 64);
+	EXPECT_SIZELE(resolved[0].length, 63);
+	EXPECT_EQ(resolved[2].length, 0);
+
+	memory_deallocate(singlebuffer);
+	memory_deallocate(buffer);
+
+	return 0;
+}
+
+static FOUNDATION_NOINLINE size_t
+stacktrace_fast_fn(void** trace, size_t skip_frames) {
+	size_t num_frames = stacktrace_capture_fast(trace, TEST_DEPTH, skip_frames);
+	//Prevent tail call
+	thread_yield();
+	return num_frames;
+}
+
+static void*
+stacktrace_fast_thread(void* arg) {
+	void* trace[TEST_DEPTH];
+	FOUNDATION_UNUSED(arg);
+	return (void*)(uintptr_t)stacktrace_fast_fn(trace, 0);
+}
+
+DECLARE_TEST(stacktrace, capture_fast) {
+	void* trace[2][TEST_DEPTH];
+	size_t num[2];
+	size_t num_frames, num_skipped, iframe, iskip;
+	thread_t thread;
+
+	if (system_platform() == PLATFORM_PNACL)
+		return 0;
+
+	//Capture from the same call site with and without skipping a frame
+	for (iskip = 0; iskip < 2; ++iskip)
+		num[iskip] = stacktrace_fast_fn(trace[iskip], iskip);
+	num_frames = num[0];
+	num_skipped = num[1];
+	EXPECT_GT(num_frames, 0);
+	EXPECT_SIZEEQ(num_skipped + 1, num_frames);
+	for (iframe = 0; iframe < num_frames; ++iframe)
+		EXPECT_NE(trace[0][iframe], 0);
+	for (iframe = 0; iframe < num_skipped; ++iframe)
+		EXPECT_EQ(trace[1][iframe], trace[0][iframe + 1]);
+
+	EXPECT_EQ(stacktrace_capture_fast(trace[0], 0, 0), 0);
+	EXPECT_EQ(stacktrace_fast_fn(trace[0], 1000), 0);
+
+	thread_initialize(&thread, stacktrace_fast_thread, 0, STRING_CONST("stacktrace"),
+	                  THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&thread);
+	thread_join(&thread);
+	EXPECT_NE(thread.result, 0);
+	thread_finalize(&thread);
+
+	return 0;
+}
+
+#if FOUNDATION_PLATFORM_POSIX
+
+static void* stacktrace_context_frames[TEST_DEPTH];
+static volatile size_t stacktrace_context_depth;
+
+static void
+stacktrace_context_signal(int sig, siginfo_t* info, void* context) {
+	FOUNDATION_UNUSED(sig);
+	FOUNDATION_UNUSED(info);
+	stacktrace_context_depth = stacktrace_capture_context(stacktrace_context_frames, TEST_DEPTH,
+	                                                      context);
+}
+
+#endif
+
+DECLARE_TEST(stacktrace, capture_context) {
+#if FOUNDATION_PLATFORM_POSIX
+	struct sigaction action, prev;
+
+	if (system_platform() == PLATFORM_PNACL)
+		return 0;
+
+	memset(&action, 0, sizeof(action));
+	sigemptyset(&action.sa_mask);
+#if FOUNDATION_COMPILER_CLANG
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wdisabled-macro-expansion"
+#endif
+	action.sa_sigaction = stacktrace_context_signal;
+#if FOUNDATION_COMPILER_CLANG
+#  pragma clang diagnostic pop
+#endif
+	action.sa_flags = SA_SIGINFO;
+	sigaction(SIGUSR2, &action, &prev);
+
+	stacktrace_context_depth = 0;
+	raise(SIGUSR2);
+	sigaction(SIGUSR2, &prev, 0);
+
+#if (FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_APPLE) && \
+    (FOUNDATION_ARCH_X86_64 || FOUNDATION_ARCH_ARM8_64)
+	EXPECT_GT(stacktrace_context_depth, 0);
+	EXPECT_NE(stacktrace_context_frames[0], 0);
+#endif
+#endif
+	return 0;
+}
+
 static void
 test_stacktrace_declare(void) {
 	ADD_TEST(stacktrace, capture);
 	ADD_TEST(stacktrace, resolve);
+	ADD_TEST(stacktrace, resolve_many);
+	ADD_TEST(stacktrace, capture_fast);
+	ADD_TEST(stacktrace, capture_context);
 }
 
 static test_suite_t test_stacktrace_suite = {
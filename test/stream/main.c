@@ -1345,6 +1345,549 @@ DECLARE_TEST(stream, readwrite_swap) {
 	return 0;
 }
 
+DECLARE_TEST(stream, buffered) {
+	char write_buffer[1024];
+	char read_buffer[1024];
+	stream_t* filestream;
+	stream_t* teststream;
+	stream_t* seqstream;
+	string_t path;
+	string_const_t directory;
+	string_t line;
+	int i;
+
+	path = path_make_temporary(write_buffer, 1024);
+	path = string_clone(STRING_ARGS(path));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	filestream = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                         STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(filestream, 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+
+	teststream = stream_buffered_allocate(filestream, 64, false);
+	EXPECT_NE(teststream, 0);
+	EXPECT_FALSE(stream_is_sequential(teststream));
+	EXPECT_TRUE(stream_is_binary(teststream));
+
+	for (i = 0; i < 1024; ++i)
+		write_buffer[i] = (char)(i + 63);
+
+	//Small writes are held back until buffer is full
+	for (i = 0; i < 8; ++i)
+		stream_write_int32(teststream, i);
+	EXPECT_SIZEEQ(stream_tell(filestream), 0);
+	EXPECT_SIZEEQ(stream_tell(teststream), 32);
+	EXPECT_SIZEEQ(stream_write(teststream, write_buffer, 1024), 1024);
+	for (i = 0; i < 100; ++i)
+		stream_write_uint16(teststream, (uint16_t)i);
+	stream_write_string(teststream, STRING_CONST("buffered string"));
+	EXPECT_SIZEEQ(stream_tell(teststream), 32 + 1024 + 200 + 16);
+	EXPECT_SIZEEQ(stream_size(teststream), 32 + 1024 + 200 + 16);
+
+	stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_tell(teststream), 0);
+	for (i = 0; i < 8; ++i)
+		EXPECT_INTEQ(stream_read_int32(teststream), i);
+	EXPECT_SIZEEQ(stream_read(teststream, read_buffer, 1024), 1024);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer, 1024), 0);
+	for (i = 0; i < 100; ++i)
+		EXPECT_UINTEQ(stream_read_uint16(teststream), (uint16_t)i);
+	line = stream_read_string_buffer(teststream, read_buffer, sizeof(read_buffer));
+	EXPECT_STRINGEQ(line, string_const(STRING_CONST("buffered string")));
+	EXPECT_TRUE(stream_eos(teststream));
+
+	//Writing after reading drops read-ahead data and writes at the logical position
+	stream_seek(teststream, 4, STREAM_SEEK_BEGIN);
+	EXPECT_INTEQ(stream_read_int32(teststream), 1);
+	stream_write_int32(teststream, 42);
+	EXPECT_SIZEEQ(stream_tell(teststream), 12);
+	EXPECT_INTEQ(stream_read_int32(teststream), 3);
+	stream_seek(teststream, -8, STREAM_SEEK_CURRENT);
+	EXPECT_INTEQ(stream_read_int32(teststream), 42);
+	stream_seek(teststream, 0, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_tell(teststream), 32 + 1024 + 200 + 16);
+
+	//Lines are read from read-ahead data
+	stream_set_binary(teststream, false);
+	stream_truncate(teststream, 0);
+	stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+	for (i = 0; i < 20; ++i)
+		stream_write_format(teststream, STRING_CONST("line %d\n"), i);
+	stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+	for (i = 0; i < 20; ++i) {
+		char expect[16];
+		string_t expect_line = string_format(expect, sizeof(expect), STRING_CONST("line %d"), i);
+		line = stream_read_line_buffer(teststream, read_buffer, sizeof(read_buffer), '\n');
+		EXPECT_STRINGEQ(line, string_to_const(expect_line));
+	}
+
+	//Pending writes are flushed when buffered stream is deallocated
+	stream_write_int32(teststream, 1234);
+	stream_deallocate(teststream);
+	EXPECT_SIZEEQ(stream_size(filestream), 20 * 7 + 10 * 1 + 4);
+	stream_deallocate(filestream);
+	fs_remove_file(STRING_ARGS(path));
+	string_deallocate(path.str);
+
+	//Sequential stream, adopted
+	seqstream = ringbuffer_stream_allocate(1024, 0);
+	teststream = stream_buffered_allocate(seqstream, 0, true);
+	EXPECT_TRUE(stream_is_sequential(teststream));
+	stream_set_binary(teststream, true);
+	for (i = 0; i < 100; ++i)
+		stream_write_int32(teststream, i);
+	stream_write_string(teststream, STRING_CONST("first line\nnext"));
+	stream_flush(teststream);
+	EXPECT_SIZEEQ(stream_available_read(teststream), 400 + 16);
+	for (i = 0; i < 100; ++i)
+		EXPECT_INTEQ(stream_read_int32(teststream), i);
+	line = stream_read_line_buffer(teststream, read_buffer, sizeof(read_buffer), '\n');
+	EXPECT_STRINGEQ(line, string_const(STRING_CONST("first line")));
+	EXPECT_SIZEEQ(stream_read(teststream, read_buffer, 4), 4);
+	EXPECT_EQ(memcmp(read_buffer, "next", 4), 0);
+	stream_deallocate(teststream);
+
+	return 0;
+}
+
+DECLARE_TEST(stream, vector) {
+	char write_buffer[1024];
+	char read_buffer[1024];
+	stream_span_t spans[40];
+	stream_t* teststream;
+	string_t path;
+	string_const_t directory;
+	uint32_t header = 0x12345678;
+	uint32_t read_header = 0;
+	int i;
+
+	path = path_make_temporary(write_buffer, 1024);
+	path = string_clone(STRING_ARGS(path));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	for (i = 0; i < 1024; ++i)
+		write_buffer[i] = (char)(i + 17);
+
+	teststream = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                         STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(teststream, 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+
+	//Vectored writes are ordered with buffered plain writes
+	stream_write_int32(teststream, 42);
+	spans[0].data = &header;
+	spans[0].size = sizeof(header);
+	spans[1].data = write_buffer;
+	spans[1].size = 0;
+	spans[2].data = write_buffer;
+	spans[2].size = 1000;
+	EXPECT_SIZEEQ(stream_write_vector(teststream, spans, 3), 1004);
+	EXPECT_SIZEEQ(stream_tell(teststream), 1008);
+	stream_write_int32(teststream, 43);
+
+	//More spans than a single system call batch
+	for (i = 0; i < 40; ++i) {
+		spans[i].data = write_buffer + (i * 25);
+		spans[i].size = 25;
+	}
+	EXPECT_SIZEEQ(stream_write_vector(teststream, spans, 40), 1000);
+	EXPECT_SIZEEQ(stream_tell(teststream), 2012);
+	EXPECT_SIZEEQ(stream_size(teststream), 2012);
+
+	stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+	EXPECT_INTEQ(stream_read_int32(teststream), 42);
+	spans[0].data = &read_header;
+	spans[0].size = sizeof(read_header);
+	spans[1].data = read_buffer;
+	spans[1].size = 1000;
+	EXPECT_SIZEEQ(stream_read_vector(teststream, spans, 2), 1004);
+	EXPECT_UINTEQ(read_header, header);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer, 1000), 0);
+	EXPECT_SIZEEQ(stream_tell(teststream), 1008);
+	EXPECT_INTEQ(stream_read_int32(teststream), 43);
+	EXPECT_FALSE(stream_eos(teststream));
+
+	//Short read at end of stream
+	memset(read_buffer, 0, sizeof(read_buffer));
+	for (i = 0; i < 40; ++i) {
+		spans[i].data = read_buffer + (i * 25);
+		spans[i].size = 25;
+	}
+	spans[39].size = 100;
+	EXPECT_SIZEEQ(stream_read_vector(teststream, spans, 40), 1000);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer, 1000), 0);
+	EXPECT_TRUE(stream_eos(teststream));
+	EXPECT_SIZEEQ(stream_tell(teststream), 2012);
+
+	stream_deallocate(teststream);
+	fs_remove_file(STRING_ARGS(path));
+	string_deallocate(path.str);
+
+	//Streams without vectored I/O transfer each span in turn
+	teststream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true,
+	                                    true);
+	spans[0].data = &header;
+	spans[0].size = sizeof(header);
+	spans[1].data = write_buffer;
+	spans[1].size = 500;
+	EXPECT_SIZEEQ(stream_write_vector(teststream, spans, 2), 504);
+	stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+	read_header = 0;
+	spans[0].data = &read_header;
+	spans[1].data = read_buffer;
+	spans[1].size = 1000;
+	EXPECT_SIZEEQ(stream_read_vector(teststream, spans, 2), 504);
+	EXPECT_UINTEQ(read_header, header);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer, 500), 0);
+	stream_deallocate(teststream);
+
+	return 0;
+}
+
+DECLARE_TEST(stream, copy) {
+	char write_buffer[1024];
+	char read_buffer[1024];
+	stream_t* source;
+	stream_t* dest;
+	stream_t* memstream;
+	string_t path;
+	string_t destpath;
+	string_const_t directory;
+	int i;
+
+	path = path_make_temporary(write_buffer, 1024);
+	path = string_clone(STRING_ARGS(path));
+	destpath = path_make_temporary(write_buffer, 1024);
+	destpath = string_clone(STRING_ARGS(destpath));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	for (i = 0; i < 1024; ++i)
+		write_buffer[i] = (char)(i * 7 + 3);
+
+	source = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                     STREAM_CREATE | STREAM_TRUNCATE);
+	dest = stream_open(STRING_ARGS(destpath), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                   STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(source, 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+	EXPECT_NE_MSGFORMAT(dest, 0, "test stream '%.*s' not created", STRING_FORMAT(destpath));
+
+	for (i = 0; i < 300; ++i)
+		stream_write(source, write_buffer, 1024);
+
+	//Copy from and to current positions with pending buffered writes
+	stream_seek(source, 1000, STREAM_SEEK_BEGIN);
+	stream_write_int32(dest, 42);
+	EXPECT_SIZEEQ(stream_copy(dest, source, 5000), 5000);
+	EXPECT_SIZEEQ(stream_tell(source), 6000);
+	EXPECT_SIZEEQ(stream_tell(dest), 5004);
+	EXPECT_FALSE(stream_eos(source));
+	stream_write_int32(dest, 43);
+
+	//Copy until end of source
+	EXPECT_SIZEEQ(stream_copy(dest, source, 0), 300 * 1024 - 6000);
+	EXPECT_TRUE(stream_eos(source));
+	EXPECT_SIZEEQ(stream_size(dest), 300 * 1024 - 1000 + 8);
+
+	stream_seek(dest, 0, STREAM_SEEK_BEGIN);
+	EXPECT_INTEQ(stream_read_int32(dest), 42);
+	EXPECT_SIZEEQ(stream_read(dest, read_buffer, 24), 24);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer + 1000, 24), 0);
+	stream_seek(dest, 5004, STREAM_SEEK_BEGIN);
+	EXPECT_INTEQ(stream_read_int32(dest), 43);
+	EXPECT_SIZEEQ(stream_read(dest, read_buffer, 1024), 1024);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer + 880, 144), 0);
+	EXPECT_EQ(memcmp(read_buffer + 144, write_buffer, 880), 0);
+
+	//Streams without descriptors are copied through a buffer
+	memstream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true, true);
+	stream_seek(source, -2048, STREAM_SEEK_END);
+	EXPECT_SIZEEQ(stream_copy(memstream, source, 0), 2048);
+	EXPECT_SIZEEQ(stream_size(memstream), 2048);
+	stream_seek(memstream, 1024, STREAM_SEEK_BEGIN);
+	stream_truncate(dest, 0);
+	stream_seek(dest, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_copy(dest, memstream, 4096), 1024);
+	EXPECT_TRUE(stream_eos(memstream));
+	stream_seek(dest, 0, STREAM_SEEK_BEGIN);
+	EXPECT_SIZEEQ(stream_read(dest, read_buffer, 1024), 1024);
+	EXPECT_EQ(memcmp(read_buffer, write_buffer, 1024), 0);
+	stream_deallocate(memstream);
+
+	stream_deallocate(source);
+	stream_deallocate(dest);
+
+	//File copy through file system
+	EXPECT_TRUE(fs_copy_file(STRING_ARGS(path), STRING_ARGS(destpath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(destpath)), 300 * 1024);
+	EXPECT_FALSE(fs_copy_file(STRING_CONST("/no/such/file"), STRING_ARGS(destpath)));
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(destpath)), 300 * 1024);
+
+	fs_remove_file(STRING_ARGS(path));
+	fs_remove_file(STRING_ARGS(destpath));
+	string_deallocate(path.str);
+	string_deallocate(destpath.str);
+
+	return 0;
+}
+
+DECLARE_TEST(stream, lines) {
+	char buffer[1024];
+	char longline[20000];
+	stream_t* streams[4];
+	stream_line_iterator_t iterator;
+	string_const_t line;
+	string_t str;
+	string_t path;
+	string_const_t directory;
+	size_t istream, iline;
+	const char text[] = "first line\n\nthird line\nlast line without delimiter";
+
+	path = path_make_temporary(buffer, sizeof(buffer));
+	path = string_clone(STRING_ARGS(path));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	memset(longline, 'x', sizeof(longline));
+
+	streams[0] = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                         STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(streams[0], 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+	stream_write(streams[0], longline, sizeof(longline));
+	stream_write(streams[0], STRING_CONST("\n"));
+	stream_write(streams[0], text, sizeof(text) - 1);
+	stream_deallocate(streams[0]);
+
+	streams[0] = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	streams[1] = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true,
+	                                    true);
+	streams[2] = ringbuffer_stream_allocate(64 * 1024, sizeof(longline) + sizeof(text));
+	streams[3] = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	for (istream = 1; istream < 3; ++istream) {
+		stream_write(streams[istream], longline, sizeof(longline));
+		stream_write(streams[istream], STRING_CONST("\n"));
+		stream_write(streams[istream], text, sizeof(text) - 1);
+	}
+	stream_seek(streams[1], 0, STREAM_SEEK_BEGIN);
+
+	for (istream = 0; istream < 4; ++istream) {
+		if (!streams[istream])
+			continue;
+		stream_line_iterator_initialize(&iterator, streams[istream], '\n');
+		for (iline = 0; stream_line_iterator_next(&iterator, &line); ++iline) {
+			if (iline == 0) {
+				EXPECT_SIZEEQ(line.length, sizeof(longline));
+				EXPECT_EQ(memcmp(line.str, longline, sizeof(longline)), 0);
+			}
+			else if (iline == 1)
+				EXPECT_CONSTSTRINGEQ(line, string_const(STRING_CONST("first line")));
+			else if (iline == 2)
+				EXPECT_SIZEEQ(line.length, 0);
+			else if (iline == 3)
+				EXPECT_CONSTSTRINGEQ(line, string_const(STRING_CONST("third line")));
+			else if (iline == 4)
+				EXPECT_CONSTSTRINGEQ(line, string_const(STRING_CONST("last line without delimiter")));
+		}
+		EXPECT_SIZEEQ(iline, 5);
+		stream_line_iterator_finalize(&iterator);
+	}
+
+	//Finalizing iterator positions seekable streams after the last returned line
+	stream_seek(streams[0], 0, STREAM_SEEK_BEGIN);
+	stream_line_iterator_initialize(&iterator, streams[0], '\n');
+	EXPECT_TRUE(stream_line_iterator_next(&iterator, &line));
+	EXPECT_TRUE(stream_line_iterator_next(&iterator, &line));
+	stream_line_iterator_finalize(&iterator);
+	EXPECT_SIZEEQ(stream_tell(streams[0]), sizeof(longline) + 12);
+	str = stream_read_line(streams[0], '\n');
+	EXPECT_SIZEEQ(str.length, 0);
+	str = stream_read_line_buffer(streams[0], buffer, sizeof(buffer), '\n');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("third line")));
+	EXPECT_SIZEEQ(stream_tell(streams[0]), sizeof(longline) + 24);
+
+	//Line readers scan memory streams in place
+	stream_seek(streams[1], (ssize_t)sizeof(longline) + 1, STREAM_SEEK_BEGIN);
+	str = stream_read_line_buffer(streams[1], buffer, 6, '\n');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("first")));
+	str = stream_read_line(streams[1], '\n');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST(" line")));
+	string_deallocate(str.str);
+	str = stream_read_line(streams[1], '\n');
+	EXPECT_SIZEEQ(str.length, 0);
+	EXPECT_EQ(str.str, 0);
+	str = stream_read_line_buffer(streams[1], buffer, sizeof(buffer), '\n');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("third line")));
+	str = stream_read_line(streams[1], '\n');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("last line without delimiter")));
+	string_deallocate(str.str);
+	EXPECT_TRUE(stream_eos(streams[1]));
+
+	for (istream = 0; istream < 4; ++istream)
+		stream_deallocate(streams[istream]);
+
+	fs_remove_file(STRING_ARGS(path));
+	string_deallocate(path.str);
+
+	return 0;
+}
+
+DECLARE_TEST(stream, string_view) {
+	char buffer[1024];
+	char small[8];
+	stream_t* streams[3];
+	string_const_t view;
+	string_t str;
+	string_t path;
+	string_const_t directory;
+	size_t istream;
+
+	path = path_make_temporary(buffer, sizeof(buffer));
+	path = string_clone(STRING_ARGS(path));
+	directory = path_directory_name(STRING_ARGS(path));
+	fs_make_directory(STRING_ARGS(directory));
+
+	streams[0] = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_OUT | STREAM_BINARY |
+	                         STREAM_CREATE | STREAM_TRUNCATE);
+	EXPECT_NE_MSGFORMAT(streams[0], 0, "test stream '%.*s' not created", STRING_FORMAT(path));
+	streams[1] = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | STREAM_BINARY, 0, 0, true,
+	                                    true);
+	for (istream = 0; istream < 2; ++istream) {
+		stream_write_string(streams[istream], STRING_CONST("first string"));
+		stream_write_string(streams[istream], 0, 0);
+		stream_write_string(streams[istream], STRING_CONST("last"));
+		stream_write_uint32(streams[istream], 0x12345678);
+	}
+	stream_deallocate(streams[0]);
+	streams[0] = stream_open(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	streams[2] = fs_map_file(STRING_ARGS(path), STREAM_IN | STREAM_BINARY);
+	stream_seek(streams[1], 0, STREAM_SEEK_BEGIN);
+
+	for (istream = 0; istream < 3; ++istream) {
+		if (!streams[istream])
+			continue;
+		view = stream_read_string_view(streams[istream], buffer, sizeof(buffer));
+		EXPECT_CONSTSTRINGEQ(view, string_const(STRING_CONST("first string")));
+		if (istream)
+			EXPECT_NE(view.str, buffer);
+		else
+			EXPECT_EQ(view.str, buffer);
+		view = stream_read_string_view(streams[istream], buffer, sizeof(buffer));
+		EXPECT_SIZEEQ(view.length, 0);
+		view = stream_read_string_view(streams[istream], buffer, sizeof(buffer));
+		EXPECT_CONSTSTRINGEQ(view, string_const(STRING_CONST("last")));
+		EXPECT_UINTEQ(stream_read_uint32(streams[istream]), 0x12345678);
+		EXPECT_SIZEEQ(stream_tell(streams[istream]), stream_size(streams[istream]));
+	}
+
+	//Strings in memory streams are returned in place even if longer than the buffer
+	stream_seek(streams[1], 0, STREAM_SEEK_BEGIN);
+	view = stream_read_string_view(streams[1], small, sizeof(small));
+	EXPECT_CONSTSTRINGEQ(view, string_const(STRING_CONST("first string")));
+	EXPECT_EQ(view.str[view.length], 0);
+
+	//Text mode strings are whitespace delimited
+	stream_deallocate(streams[1]);
+	streams[1] = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT, 0, 0, true, true);
+	stream_write(streams[1], STRING_CONST("  first\tsecond\n\nthird"));
+	stream_seek(streams[1], 0, STREAM_SEEK_BEGIN);
+	view = stream_read_string_view(streams[1], 0, 0);
+	EXPECT_CONSTSTRINGEQ(view, string_const(STRING_CONST("first")));
+	view = stream_read_string_view(streams[1], 0, 0);
+	EXPECT_CONSTSTRINGEQ(view, string_const(STRING_CONST("second")));
+	str = stream_read_string(streams[1]);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("third")));
+	string_deallocate(str.str);
+	EXPECT_TRUE(stream_eos(streams[1]));
+
+	for (istream = 0; istream < 3; ++istream)
+		stream_deallocate(streams[istream]);
+
+	fs_remove_file(STRING_ARGS(path));
+	string_deallocate(path.str);
+
+	return 0;
+}
+
+DECLARE_TEST(stream, arrays) {
+	uint16_t values16[1029];
+	uint32_t values32[1029];
+	uint64_t values64[1029];
+	float32_t valuesf32[37];
+	float64_t valuesf64[37];
+	uint16_t read16[1029];
+	uint32_t read32[1029];
+	uint64_t read64[1029];
+	float32_t readf32[37];
+	float64_t readf64[37];
+	stream_t* teststream;
+	size_t ival;
+	int ipass;
+
+	for (ival = 0; ival < 1029; ++ival) {
+		values16[ival] = (uint16_t)random32();
+		values32[ival] = random32();
+		values64[ival] = random64();
+	}
+	for (ival = 0; ival < 37; ++ival) {
+		valuesf32[ival] = (float32_t)ival * 0.5f;
+		valuesf64[ival] = (float64_t)(ival + 1) * -0.25;
+	}
+
+	//Native, swapped and text mode round trips
+	for (ipass = 0; ipass < 3; ++ipass) {
+		teststream = buffer_stream_allocate(0, STREAM_IN | STREAM_OUT | ((ipass < 2) ? STREAM_BINARY : 0),
+		                                    0, 0, true, true);
+		if (ipass == 1)
+			stream_set_byteorder(teststream, (system_byteorder() == BYTEORDER_LITTLEENDIAN) ?
+			                     BYTEORDER_BIGENDIAN : BYTEORDER_LITTLEENDIAN);
+		stream_write_uint16_array(teststream, values16, 1029);
+		stream_write_endl(teststream);
+		stream_write_uint32_array(teststream, values32, 1029);
+		stream_write_endl(teststream);
+		stream_write_uint64_array(teststream, values64, 1029);
+		stream_write_endl(teststream);
+		stream_write_float32_array(teststream, valuesf32, 37);
+		stream_write_endl(teststream);
+		stream_write_float64_array(teststream, valuesf64, 37);
+		stream_write_endl(teststream);
+		if (ipass < 2)
+			EXPECT_SIZEEQ(stream_size(teststream), 1029 * 14 + 37 * 12);
+
+		stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+		EXPECT_SIZEEQ(stream_read_uint16_array(teststream, read16, 1029), 1029);
+		EXPECT_SIZEEQ(stream_read_uint32_array(teststream, read32, 1029), 1029);
+		EXPECT_SIZEEQ(stream_read_uint64_array(teststream, read64, 1029), 1029);
+		EXPECT_SIZEEQ(stream_read_float32_array(teststream, readf32, 37), 37);
+		EXPECT_SIZEEQ(stream_read_float64_array(teststream, readf64, 37), 37);
+		EXPECT_EQ(memcmp(read16, values16, sizeof(values16)), 0);
+		EXPECT_EQ(memcmp(read32, values32, sizeof(values32)), 0);
+		EXPECT_EQ(memcmp(read64, values64, sizeof(values64)), 0);
+		EXPECT_EQ(memcmp(readf32, valuesf32, sizeof(valuesf32)), 0);
+		EXPECT_EQ(memcmp(readf64, valuesf64, sizeof(valuesf64)), 0);
+
+		//Bulk swap matches per-value swap
+		if (ipass == 1) {
+			stream_seek(teststream, 0, STREAM_SEEK_BEGIN);
+			for (ival = 0; ival < 1029; ++ival)
+				EXPECT_UINTEQ(stream_read_uint16(teststream), values16[ival]);
+			for (ival = 0; ival < 1029; ++ival)
+				EXPECT_UINTEQ(stream_read_uint32(teststream), values32[ival]);
+			for (ival = 0; ival < 1029; ++ival)
+				EXPECT_TYPEEQ(stream_read_uint64(teststream), values64[ival], uint64_t, PRIx64);
+		}
+
+		//Short read at end of stream
+		if (ipass < 2) {
+			stream_seek(teststream, -10, STREAM_SEEK_END);
+			EXPECT_SIZEEQ(stream_read_uint32_array(teststream, read32, 1029), 2);
+		}
+		stream_deallocate(teststream);
+	}
+
+	return 0;
+}
+
 static void
 test_stream_declare(void) {
 	ADD_TEST(stream, std);
@@ -1352,6 +1895,12 @@ test_stream_declare(void) {
 	ADD_TEST(stream, readwrite_text);
 	ADD_TEST(stream, readwrite_sequential);
 	ADD_TEST(stream, readwrite_swap);
+	ADD_TEST(stream, buffered);
+	ADD_TEST(stream, vector);
+	ADD_TEST(stream, copy);
+	ADD_TEST(stream, lines);
+	ADD_TEST(stream, string_view);
+	ADD_TEST(stream, arrays);
 }
 
 static test_suite_t test_stream_suite = {
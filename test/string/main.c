@@ -13,6 +13,8 @@
 #include <foundation/foundation.h>
 #include <test/test.h>
 
+#include <stdio.h>
+
 static application_t
 test_string_application(void) {
 	application_t app;
@@ -2153,6 +2155,9 @@ DECLARE_TEST(string, convert) {
 	EXPECT_EQ(str.length, 0);
 
 	str = string_from_real(buffer, 3, 1, 0, 0, '=');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1")));
+
+	str = string_from_real(buffer, 3, REAL_C(1.25), 0, 0, '=');
 	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1.")));
 
 	str = string_from_real(buffer, 3, REAL_C(1.1), 8, 16, '=');
@@ -2332,6 +2337,749 @@ DECLARE_TEST(string, convert) {
 	return 0;
 }
 
+DECLARE_TEST(string, builder) {
+	string_builder_t builder;
+	string_builder_t* allocated;
+	string_const_t current;
+	string_t str;
+	size_t capacity, iloop, reallocations;
+	char longstr[300];
+
+	string_builder_initialize(&builder, 0);
+	current = string_builder_string(&builder);
+	EXPECT_SIZEEQ(current.length, 0);
+	EXPECT_NE(current.str, 0);
+	EXPECT_EQ(builder.str, 0);
+
+	string_builder_append(&builder, STRING_CONST("foo"));
+	string_builder_append_char(&builder, ' ');
+	string_builder_append_format(&builder, STRING_CONST("%d:%s"), 42, "bar");
+	string_builder_append(&builder, 0, 0);
+	current = string_builder_string(&builder);
+	EXPECT_CONSTSTRINGEQ(current, string_const(STRING_CONST("foo 42:bar")));
+	EXPECT_EQ(current.str[current.length], 0);
+
+	//Formatted output larger than the current capacity
+	memset(longstr, 'x', sizeof(longstr) - 1);
+	longstr[sizeof(longstr) - 1] = 0;
+	string_builder_append_format(&builder, STRING_CONST("[%s]"), longstr);
+	EXPECT_SIZEEQ(builder.length, 10 + 2 + sizeof(longstr) - 1);
+	EXPECT_EQ(builder.str[10], '[');
+	EXPECT_EQ(builder.str[builder.length - 1], ']');
+	EXPECT_EQ(builder.str[builder.length], 0);
+
+	//Geometric growth
+	string_builder_clear(&builder);
+	EXPECT_SIZEEQ(builder.length, 0);
+	EXPECT_EQ(builder.str[0], 0);
+	capacity = builder.capacity;
+	reallocations = 0;
+	for (iloop = 0; iloop < 100000; ++iloop) {
+		string_builder_append(&builder, STRING_CONST("0123456789"));
+		if (builder.capacity != capacity) {
+			EXPECT_SIZEGE(builder.capacity, capacity * 2);
+			capacity = builder.capacity;
+			++reallocations;
+		}
+	}
+	EXPECT_SIZEEQ(builder.length, 1000000);
+	EXPECT_SIZELE(reallocations, 20);
+
+	//Take ownership without copy
+	current = string_builder_string(&builder);
+	str = string_builder_take(&builder);
+	EXPECT_EQ(str.str, current.str);
+	EXPECT_SIZEEQ(str.length, 1000000);
+	EXPECT_EQ(builder.str, 0);
+	EXPECT_SIZEEQ(builder.length, 0);
+	string_deallocate(str.str);
+
+	str = string_builder_take(&builder);
+	EXPECT_NE(str.str, 0);
+	EXPECT_SIZEEQ(str.length, 0);
+	EXPECT_EQ(str.str[0], 0);
+	string_deallocate(str.str);
+	string_builder_finalize(&builder);
+
+	allocated = string_builder_allocate(64);
+	EXPECT_SIZEGE(allocated->capacity, 64);
+	string_builder_append_format(allocated, STRING_CONST("%" PRIsize), (size_t)123);
+	EXPECT_CONSTSTRINGEQ(string_builder_string(allocated), string_const(STRING_CONST("123")));
+	string_builder_deallocate(allocated);
+
+	return 0;
+}
+
+static size_t
+test_string_find_reference(const char* str, size_t length, const char* key, size_t key_length,
+                            size_t offset) {
+	for (; offset + key_length <= length; ++offset) {
+		if (!memcmp(str + offset, key, key_length))
+			return offset;
+	}
+	return STRING_NPOS;
+}
+
+static size_t
+test_string_rfind_reference(const char* str, size_t length, const char* key, size_t key_length,
+                             size_t offset) {
+	if (offset > length - key_length)
+		offset = length - key_length;
+	for (; offset != STRING_NPOS; --offset) {
+		if (!memcmp(str + offset, key, key_length))
+			return offset;
+	}
+	return STRING_NPOS;
+}
+
+static bool
+test_string_match_reference(const char* element, size_t element_length, const char* pattern,
+                            size_t pattern_length) {
+	if (!pattern_length)
+		return true;
+	if (*pattern == '*') {
+		if (test_string_match_reference(element, element_length, pattern + 1, pattern_length - 1))
+			return true;
+		return element_length &&
+		       test_string_match_reference(element + 1, element_length - 1, pattern, pattern_length);
+	}
+	if (!element_length || ((*pattern != '?') && (*pattern != *element)))
+		return false;
+	return test_string_match_reference(element + 1, element_length - 1, pattern + 1,
+	                                   pattern_length - 1);
+}
+
+DECLARE_TEST(string, search) {
+	char str[512];
+	char key[160];
+	char pattern[16];
+	size_t length, key_length, offset, pattern_length;
+	unsigned int alphabet;
+	int ipass;
+
+	for (ipass = 0; ipass < 4000; ++ipass) {
+		//Small alphabets give many partial and periodic matches
+		alphabet = (ipass % 4 == 0) ? 1 : ((ipass % 4 == 1) ? 2 : 4 + (ipass % 20));
+		length = random32_range(0, sizeof(str));
+		for (offset = 0; offset < length; ++offset)
+			str[offset] = (char)('a' + random32_range(0, alphabet));
+		key_length = random32_range(1, (ipass & 1) ? 10 : sizeof(key));
+		if (length && (ipass % 3 == 0) && (key_length <= length)) {
+			//Copy key from string to guarantee at least one match
+			memcpy(key, str + random32_range(0, (uint32_t)(length - key_length + 1)), key_length);
+		}
+		else {
+			for (offset = 0; offset < key_length; ++offset)
+				key[offset] = (char)('a' + random32_range(0, alphabet));
+		}
+		offset = random32_range(0, (uint32_t)length + 2);
+
+		EXPECT_SIZEEQ(string_find_string(str, length, key, key_length, 0),
+		              test_string_find_reference(str, length, key, key_length, 0));
+		EXPECT_SIZEEQ(string_find_string(str, length, key, key_length, offset),
+		              test_string_find_reference(str, length, key, key_length, offset));
+		if (key_length <= length) {
+			EXPECT_SIZEEQ(string_rfind_string(str, length, key, key_length, STRING_NPOS),
+			              test_string_rfind_reference(str, length, key, key_length, STRING_NPOS));
+			EXPECT_SIZEEQ(string_rfind_string(str, length, key, key_length, offset),
+			              test_string_rfind_reference(str, length, key, key_length, offset));
+		}
+
+		pattern_length = random32_range(0, sizeof(pattern));
+		for (offset = 0; offset < pattern_length; ++offset) {
+			uint32_t kind = random32_range(0, 6);
+			pattern[offset] = (kind == 0) ? '*' : ((kind == 1) ? '?' :
+			                                       (char)('a' + random32_range(0, alphabet)));
+		}
+		if (length > 24)
+			length = 24;
+		EXPECT_EQ(string_match_pattern(str, length, pattern, pattern_length),
+		          test_string_match_reference(str, length, pattern, pattern_length));
+	}
+
+	EXPECT_TRUE(string_match_pattern(STRING_CONST("path/to/some/file.txt"), STRING_CONST("*/*.txt")));
+	EXPECT_FALSE(string_match_pattern(STRING_CONST("path/to/some/file.txt"), STRING_CONST("*.dat*")));
+	EXPECT_TRUE(string_match_pattern(STRING_CONST("en-US"), STRING_CONST("?" "?" "-" "?" "?")));
+
+	return 0;
+}
+
+DECLARE_TEST(string, numbers) {
+	char buffer[128];
+	char reference[128];
+	string_t str;
+	int ipass;
+
+	str = string_from_int(buffer, sizeof(buffer), INT64_MIN, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("-9223372036854775808")));
+	str = string_from_int(buffer, sizeof(buffer), INT64_MAX, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("9223372036854775807")));
+	str = string_from_int(buffer, sizeof(buffer), 0, 3, '0');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("000")));
+	str = string_from_int(buffer, 5, -1234567, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("-123")));
+	str = string_from_uint(buffer, sizeof(buffer), UINT64_MAX, false, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("18446744073709551615")));
+	str = string_from_uint(buffer, sizeof(buffer), UINT64_MAX, true, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("ffffffffffffffff")));
+	str = string_from_uint(buffer, sizeof(buffer), 0, true, 4, '0');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("0000")));
+
+	for (ipass = 0; ipass < 10000; ++ipass) {
+		uint64_t uval = random64() >> random32_range(0, 64);
+		int64_t ival = (int64_t)random64() >> random32_range(0, 64);
+		int len;
+
+		len = snprintf(reference, sizeof(reference), "%" PRId64, ival);
+		str = string_from_int(buffer, sizeof(buffer), ival, 0, 0);
+		EXPECT_STRINGEQ(str, string_const(reference, (size_t)len));
+
+		len = snprintf(reference, sizeof(reference), "%" PRIu64, uval);
+		str = string_from_uint(buffer, sizeof(buffer), uval, false, 0, 0);
+		EXPECT_STRINGEQ(str, string_const(reference, (size_t)len));
+
+		len = snprintf(reference, sizeof(reference), "%" PRIx64, uval);
+		str = string_from_uint(buffer, sizeof(buffer), uval, true, 0, 0);
+		EXPECT_STRINGEQ(str, string_const(reference, (size_t)len));
+	}
+
+#if FOUNDATION_SIZE_REAL == 8
+	str = string_from_real(buffer, sizeof(buffer), 0.1 + 0.2, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("0.30000000000000004")));
+	str = string_from_real(buffer, sizeof(buffer), 1e21, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1e21")));
+	str = string_from_real(buffer, sizeof(buffer), 123456789012345678e3, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("123456789012345680000")));
+	str = string_from_real(buffer, sizeof(buffer), -0.000001, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("-0.000001")));
+	str = string_from_real(buffer, sizeof(buffer), 1.5e-7, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1.5e-7")));
+	str = string_from_real(buffer, sizeof(buffer), 5e-324, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("5e-324")));
+	str = string_from_real(buffer, sizeof(buffer), DBL_MAX, 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1.7976931348623157e308")));
+
+	for (ipass = 0; ipass < 100000; ++ipass) {
+		float64_cast_t conv, parsed;
+		conv.uival = random64();
+		if ((conv.uival & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL)
+			continue;
+		if (ipass & 1)
+			conv.fval = (float64_t)random64_range(1, 1000000) / 1000.0;
+		str = string_from_real(buffer, sizeof(buffer), conv.fval, 0, 0, 0);
+		EXPECT_SIZELE(str.length, 25);
+		parsed.fval = string_to_float64(STRING_ARGS(str));
+		EXPECT_TYPEEQ(parsed.uival, conv.uival, uint64_t, PRIx64);
+	}
+#else
+	for (ipass = 0; ipass < 100000; ++ipass) {
+		float32_cast_t conv, parsed;
+		conv.uival = random32();
+		if ((conv.uival & 0x7F800000U) == 0x7F800000U)
+			continue;
+		str = string_from_real(buffer, sizeof(buffer), conv.fval, 0, 0, 0);
+		EXPECT_SIZELE(str.length, 22);
+		parsed.fval = string_to_float32(STRING_ARGS(str));
+		EXPECT_UINTEQ(parsed.uival, conv.uival);
+	}
+#endif
+	str = string_from_real(buffer, sizeof(buffer), REAL_C(1234.5), 0, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("1234.5")));
+	str = string_from_real(buffer, sizeof(buffer), REAL_C(-1e6), 0, 10, ' ');
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("  -1000000")));
+
+	return 0;
+}
+
+DECLARE_TEST(string, parse) {
+	char buffer[512];
+	int ipass;
+	size_t ichar;
+
+	EXPECT_INTEQ(string_to_int(STRING_CONST("  -1234xyz")), -1234);
+	EXPECT_INTEQ(string_to_int(STRING_CONST("+42")), 42);
+	EXPECT_INTEQ(string_to_int(STRING_CONST("abc")), 0);
+	EXPECT_UINTEQ(string_to_uint(STRING_CONST("0x1aF"), true), 0x1af);
+	EXPECT_UINTEQ(string_to_uint(STRING_CONST("ffffffff"), true), 0xffffffffU);
+	EXPECT_UINTEQ(string_to_uint(STRING_CONST("-1"), false), 0xffffffffU);
+	EXPECT_TYPEEQ(string_to_int64(STRING_CONST("-9223372036854775808")), INT64_MIN, int64_t, PRId64);
+	EXPECT_TYPEEQ(string_to_int64(STRING_CONST("9223372036854775808")), INT64_MAX, int64_t, PRId64);
+	EXPECT_TYPEEQ(string_to_uint64(STRING_CONST("18446744073709551615"), false), UINT64_MAX,
+	              uint64_t, PRIx64);
+	EXPECT_TYPEEQ(string_to_uint64(STRING_CONST("18446744073709551616"), false), UINT64_MAX,
+	              uint64_t, PRIx64);
+	EXPECT_TYPEEQ(string_to_uint64(STRING_CONST("123456789012345678"), false),
+	              123456789012345678ULL, uint64_t, PRIx64);
+	EXPECT_TYPEEQ(string_to_uint64(STRING_CONST("fedcba9876543210"), true), 0xfedcba9876543210ULL,
+	              uint64_t, PRIx64);
+
+	for (ipass = 0; ipass < 10000; ++ipass) {
+		int64_t ival = (int64_t)random64() >> random32_range(0, 64);
+		uint64_t uval = random64() >> random32_range(0, 64);
+		int len = snprintf(buffer, sizeof(buffer), "%" PRId64, ival);
+		EXPECT_TYPEEQ(string_to_int64(buffer, (size_t)len), ival, int64_t, PRId64);
+		len = snprintf(buffer, sizeof(buffer), "%" PRIu64 "-", uval);
+		EXPECT_TYPEEQ(string_to_uint64(buffer, (size_t)len, false), uval, uint64_t, PRIx64);
+		len = snprintf(buffer, sizeof(buffer), "%" PRIx64, uval);
+		EXPECT_TYPEEQ(string_to_uint64(buffer, (size_t)len, true), uval, uint64_t, PRIx64);
+	}
+
+	EXPECT_REALEQ(string_to_float64(STRING_CONST(" 1.5e3 ")), 1500.0);
+	EXPECT_REALEQ(string_to_float64(STRING_CONST("-.25")), -0.25);
+	EXPECT_REALEQ(string_to_float64(STRING_CONST("12.e")), 12.0);
+	EXPECT_REALEQ(string_to_float64(STRING_CONST("1e-400")), 0.0);
+	EXPECT_TRUE(math_real_is_inf((real)string_to_float64(STRING_CONST("1e400"))));
+	EXPECT_TRUE(math_real_is_inf((real)string_to_float64(STRING_CONST("-INF"))));
+	EXPECT_TRUE(math_real_is_nan((real)string_to_float64(STRING_CONST("nan"))));
+	EXPECT_REALEQ(string_to_float64(STRING_CONST(".")), 0.0);
+	EXPECT_REALEQ(string_to_float64(STRING_CONST("0x10")), 16.0);
+
+	for (ipass = 0; ipass < 20000; ++ipass) {
+		float64_cast_t expect, value;
+		float32_cast_t expect32, value32;
+		size_t length = 0;
+		switch (ipass % 4) {
+		case 0:
+			//Random bit patterns in shortest and full precision
+			expect.uival = random64();
+			if ((expect.uival & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL)
+				expect.uival &= 0x800FFFFFFFFFFFFFULL;
+			length = (size_t)snprintf(buffer, sizeof(buffer), "%.*g",
+			                          (int)random32_range(1, 18), expect.fval);
+			break;
+		case 1:
+			//Long digit sequences exercising truncation
+			length = random32_range(1, 60);
+			for (ichar = 0; ichar < length; ++ichar)
+				buffer[ichar] = (char)('0' + random32_range(0, 10));
+			if (ipass & 8)
+				buffer[random32_range(0, (uint32_t)length)] = '.';
+			length += (size_t)snprintf(buffer + length, sizeof(buffer) - length, "e%d",
+			                           (int)random32_range(0, 700) - 350);
+			break;
+		case 2:
+			//Halfway cases between adjacent doubles
+			expect.uival = random64() & 0x7FEFFFFFFFFFFFFFULL;
+			length = (size_t)snprintf(buffer, sizeof(buffer), "%.40e", expect.fval);
+			break;
+		default:
+			//Short decimals typical for config and data files
+			length = (size_t)snprintf(buffer, sizeof(buffer), "%u.%0*u",
+			                          random32_range(0, 100000), (int)random32_range(1, 6),
+			                          random32_range(0, 100000));
+			break;
+		}
+		buffer[length] = 0;
+		expect.fval = strtod(buffer, 0);
+		value.fval = string_to_float64(buffer, length);
+		EXPECT_TYPEEQ(value.uival, expect.uival, uint64_t, PRIx64);
+		expect32.fval = strtof(buffer, 0);
+		value32.fval = string_to_float32(buffer, length);
+		EXPECT_UINTEQ(value32.uival, expect32.uival);
+	}
+
+	return 0;
+}
+
+static bool
+test_string_utf8_reference(const unsigned char* str, size_t length) {
+	size_t offset = 0;
+	while (offset < length) {
+		uint32_t glyph, min;
+		size_t num, j;
+		if (str[offset] < 0x80) {
+			++offset;
+			continue;
+		}
+		if ((str[offset] & 0xE0) == 0xC0) {
+			num = 2;
+			min = 0x80;
+			glyph = str[offset] & 0x1F;
+		}
+		else if ((str[offset] & 0xF0) == 0xE0) {
+			num = 3;
+			min = 0x800;
+			glyph = str[offset] & 0x0F;
+		}
+		else if ((str[offset] & 0xF8) == 0xF0) {
+			num = 4;
+			min = 0x10000;
+			glyph = str[offset] & 0x07;
+		}
+		else {
+			return false;
+		}
+		if (offset + num > length)
+			return false;
+		for (j = 1; j < num; ++j) {
+			if ((str[offset + j] & 0xC0) != 0x80)
+				return false;
+			glyph = (glyph << 6) | (str[offset + j] & 0x3F);
+		}
+		if ((glyph < min) || (glyph > 0x10FFFF) || ((glyph >= 0xD800) && (glyph <= 0xDFFF)))
+			return false;
+		offset += num;
+	}
+	return true;
+}
+
+DECLARE_TEST(string, utf) {
+	uint32_t glyphs[256];
+	uint16_t utf16[512];
+	char utf8[1024];
+	char converted[1024];
+	string_t str;
+	wchar_t* wstr;
+	int ipass;
+	size_t iglyph, count, len16, len8, wlen;
+
+	EXPECT_TRUE(string_validate_utf8(STRING_CONST("")));
+	EXPECT_TRUE(string_validate_utf8(STRING_CONST("plain ascii text crossing a block boundary")));
+	EXPECT_TRUE(string_validate_utf8(STRING_CONST("\xc3\xa5\xc3\xa4\xc3\xb6 \xe2\x82\xac \xf0\x9f\x98\x80")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("\xc0\xaf")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("\xe0\x80\xaf")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("\xed\xa0\x80")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("\xf4\x90\x80\x80")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("0123456789abcde\xe2\x82")));
+	EXPECT_FALSE(string_validate_utf8(STRING_CONST("0123456789abcdef\x80")));
+
+	for (ipass = 0; ipass < 4000; ++ipass) {
+		//Mixed ascii runs and multibyte glyphs
+		count = random32_range(0, 256);
+		for (iglyph = 0; iglyph < count; ++iglyph) {
+			uint32_t kind = random32_range(0, (ipass & 1) ? 4 : 16);
+			if (kind == 1)
+				glyphs[iglyph] = random32_range(0x80, 0x800);
+			else if (kind == 2)
+				glyphs[iglyph] = random32_range(0x800, 0xD800);
+			else if (kind == 3)
+				glyphs[iglyph] = random32_range(0x10000, 0x110000);
+			else
+				glyphs[iglyph] = random32_range(1, 0x80);
+		}
+
+		str = string_convert_utf32(utf8, sizeof(utf8), glyphs, count);
+		len8 = str.length;
+		EXPECT_TRUE(string_validate_utf8(utf8, len8));
+		EXPECT_SIZEEQ(string_glyphs(utf8, len8), count);
+
+		len16 = 0;
+		for (iglyph = 0; iglyph < count; ++iglyph) {
+			if (glyphs[iglyph] >= 0x10000) {
+				utf16[len16++] = (uint16_t)(0xD800 | ((glyphs[iglyph] - 0x10000) >> 10));
+				utf16[len16++] = (uint16_t)(0xDC00 | ((glyphs[iglyph] - 0x10000) & 0x3FF));
+			}
+			else {
+				utf16[len16++] = (uint16_t)glyphs[iglyph];
+			}
+		}
+		str = string_convert_utf16(converted, sizeof(converted), utf16, len16);
+		EXPECT_STRINGEQ(str, string_const(utf8, len8));
+		str = string_allocate_from_utf16(utf16, len16);
+		EXPECT_STRINGEQ(str, string_const(utf8, len8));
+		string_deallocate(str.str);
+		str = string_allocate_from_utf32(glyphs, count);
+		EXPECT_STRINGEQ(str, string_const(utf8, len8));
+		string_deallocate(str.str);
+
+		wstr = wstring_allocate_from_string(utf8, len8);
+		wlen = wstring_length(wstr);
+#if FOUNDATION_SIZE_WCHAR == 2
+		EXPECT_SIZEEQ(wlen, len16);
+		EXPECT_EQ(memcmp(wstr, utf16, len16 * sizeof(uint16_t)), 0);
+#else
+		EXPECT_SIZEEQ(wlen, count);
+		EXPECT_EQ(memcmp(wstr, glyphs, count * sizeof(uint32_t)), 0);
+#endif
+		str = string_allocate_from_wstring(wstr, wlen);
+		EXPECT_STRINGEQ(str, string_const(utf8, len8));
+		string_deallocate(str.str);
+		wstring_deallocate(wstr);
+
+		//Corrupt bytes and compare validation with reference
+		if (len8) {
+			size_t icorrupt, corrupt = random32_range(1, 4);
+			for (icorrupt = 0; icorrupt < corrupt; ++icorrupt)
+				utf8[random32_range(0, (uint32_t)len8)] = (char)random32_range(0x80, 0x100);
+			len8 = random32_range(0, (uint32_t)len8 + 1);
+			EXPECT_EQ(string_validate_utf8(utf8, len8),
+			          test_string_utf8_reference((const unsigned char*)utf8, len8));
+		}
+	}
+
+	return 0;
+}
+
+static size_t
+test_string_explode_reference(const char* str, size_t length, const char* delimiters,
+                              size_t delim_length, string_const_t* arr, size_t arrsize,
+                              bool allow_empty) {
+	size_t token = 0, end = 0, count = 0;
+	if (!length || !arrsize)
+		return 0;
+	if (!delim_length) {
+		arr[count++] = string_const(str, length);
+		return count;
+	}
+	while ((end < length) && (count < arrsize)) {
+		if (!allow_empty)
+			token = string_find_first_not_of(str, length, delimiters, delim_length, end);
+		end = string_find_first_of(str, length, delimiters, delim_length, token);
+		if (token != STRING_NPOS)
+			arr[count++] = string_const(str + token, (end != STRING_NPOS) ? (end - token) : (length - token));
+		if (allow_empty)
+			token = end + 1;
+	}
+	return count;
+}
+
+DECLARE_TEST(string, tokenizer) {
+	static const char* const delimiters[] = {"", ",", ",;", "\xff,", ";;"};
+	char str[64];
+	string_const_t expect[64];
+	string_const_t token;
+	string_tokenizer_t tokenizer;
+	size_t length, num, itoken, ichar;
+	int ipass;
+
+	string_tokenizer_initialize(&tokenizer, STRING_CONST("path/to//file"), STRING_CONST("/"), false);
+	EXPECT_TRUE(string_tokenizer_next(&tokenizer, &token));
+	EXPECT_CONSTSTRINGEQ(token, string_const(STRING_CONST("path")));
+	EXPECT_TRUE(string_tokenizer_next(&tokenizer, &token));
+	EXPECT_CONSTSTRINGEQ(token, string_const(STRING_CONST("to")));
+	EXPECT_TRUE(string_tokenizer_next(&tokenizer, &token));
+	EXPECT_CONSTSTRINGEQ(token, string_const(STRING_CONST("file")));
+	EXPECT_FALSE(string_tokenizer_next(&tokenizer, &token));
+	EXPECT_FALSE(string_tokenizer_next(&tokenizer, &token));
+
+	for (ipass = 0; ipass < 10000; ++ipass) {
+		const char* delim = delimiters[ipass % 5];
+		bool allow_empty = (ipass & 8) != 0;
+		length = random32_range(0, sizeof(str));
+		for (ichar = 0; ichar < length; ++ichar) {
+			static const char alphabet[] = "ab,;\xff";
+			str[ichar] = alphabet[random32_range(0, 5)];
+		}
+
+		num = test_string_explode_reference(str, length, delim, string_length(delim), expect, 64,
+		                                    allow_empty);
+		string_tokenizer_initialize(&tokenizer, str, length, delim, string_length(delim),
+		                            allow_empty);
+		for (itoken = 0; string_tokenizer_next(&tokenizer, &token); ++itoken) {
+			EXPECT_SIZELT(itoken, num);
+			EXPECT_EQ(token.str, expect[itoken].str);
+			EXPECT_SIZEEQ(token.length, expect[itoken].length);
+		}
+		EXPECT_SIZEEQ(itoken, num);
+		EXPECT_SIZEEQ(string_explode(str, length, delim, string_length(delim), expect, 64,
+		                             allow_empty), num);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(string, nocase) {
+	char lhs[80];
+	char rhs[80];
+	size_t length, ichar, imismatch;
+	int ipass;
+
+	EXPECT_TRUE(string_equal_nocase(STRING_CONST("Content-Length"), STRING_CONST("content-LENGTH")));
+	EXPECT_FALSE(string_equal_nocase(STRING_CONST("Content-Length"), STRING_CONST("Content-Lengths")));
+	EXPECT_FALSE(string_equal_nocase(STRING_CONST("@[`{ @[`{ @[`{ @[`{"), STRING_CONST("`{@[ `{@[ `{@[ `{@[")));
+	EXPECT_FALSE(string_equal_nocase(STRING_CONST("\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5\xc5"),
+	                                 STRING_CONST("\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5\xe5")));
+	EXPECT_TRUE(string_equal_substr_nocase(STRING_CONST("path/To/File"), 5, STRING_CONST("to/file"), 0));
+
+	for (ipass = 0; ipass < 10000; ++ipass) {
+		length = random32_range(0, sizeof(lhs));
+		for (ichar = 0; ichar < length; ++ichar) {
+			char c = (char)random32_range(0, 256);
+			lhs[ichar] = c;
+			if ((c >= 'a') && (c <= 'z') && random32_range(0, 2))
+				c = (char)(c - ('a' - 'A'));
+			else if ((c >= 'A') && (c <= 'Z') && random32_range(0, 2))
+				c = (char)(c + ('a' - 'A'));
+			rhs[ichar] = c;
+		}
+		EXPECT_TRUE(string_equal_nocase(lhs, length, rhs, length));
+		EXPECT_EQ(string_hash_nocase(lhs, length), string_hash_nocase(rhs, length));
+		if (length) {
+			//Change a character to one not equal in any case
+			imismatch = random32_range(0, (uint32_t)length);
+			rhs[imismatch] = (char)(((lhs[imismatch] | 0x20) == 'x') ? '#' : 'x');
+			EXPECT_FALSE(string_equal_nocase(lhs, length, rhs, length));
+		}
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(string, set) {
+	string_const_t strings[512];
+	char buffer[512][16];
+	char needle[16];
+	string_set_t set;
+	string_set_t* allocated;
+	size_t istr, ichar, length;
+	int ipass;
+
+	allocated = string_set_allocate(0, 0);
+	EXPECT_EQ(allocated->count, 0);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("")), -1);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("foo")), -1);
+	string_set_deallocate(allocated);
+
+	strings[0] = string_const(STRING_CONST("include"));
+	strings[1] = string_const(STRING_CONST(""));
+	strings[2] = string_const(STRING_CONST("exclude"));
+	strings[3] = string_const(STRING_CONST("include"));
+	strings[4] = string_const("includes", 7);
+	allocated = string_set_allocate(strings, 5);
+	EXPECT_EQ(allocated->count, 5);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("include")), 0);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("")), 1);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("exclude")), 2);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("includes")), -1);
+	EXPECT_INTEQ(string_set_find(allocated, STRING_CONST("Include")), -1);
+	EXPECT_CONSTSTRINGEQ(allocated->string[4], string_const(STRING_CONST("include")));
+	EXPECT_NE(allocated->string[4].str, strings[4].str);
+	EXPECT_EQ(allocated->string[4].str[7], 0);
+	string_set_deallocate(allocated);
+
+	//Random strings from a small alphabet to get duplicates, verify against linear search
+	for (ipass = 0; ipass < 64; ++ipass) {
+		size_t count = random32_range(0, 512);
+		for (istr = 0; istr < count; ++istr) {
+			length = random32_range(0, 4);
+			for (ichar = 0; ichar < length; ++ichar)
+				buffer[istr][ichar] = (char)random32_range('a', 'e');
+			strings[istr] = string_const(buffer[istr], length);
+		}
+		string_set_initialize(&set, strings, count);
+		EXPECT_EQ(set.count, count);
+		for (istr = 0; istr < count; ++istr)
+			EXPECT_INTEQ(string_set_find(&set, STRING_ARGS(strings[istr])),
+			             string_array_find(strings, count, STRING_ARGS(strings[istr])));
+		for (istr = 0; istr < 256; ++istr) {
+			length = random32_range(0, 6);
+			for (ichar = 0; ichar < length; ++ichar)
+				needle[ichar] = (char)random32_range('a', 'f');
+			EXPECT_INTEQ(string_set_find(&set, needle, length),
+			             string_array_find(strings, count, needle, length));
+		}
+		string_set_finalize(&set);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(string, thread_buffer) {
+	string_t buffer[BUILD_THREAD_STRING_BUFFERS];
+	char local[64];
+	string_const_t first, second, value;
+	size_t ibuf, iother;
+
+	//Each call hands out the next buffer in the ring until it wraps around
+	for (ibuf = 0; ibuf < BUILD_THREAD_STRING_BUFFERS; ++ibuf) {
+		buffer[ibuf] = string_thread_buffer();
+		EXPECT_SIZEEQ(buffer[ibuf].length, BUILD_THREAD_STRING_BUFFER_SIZE);
+		for (iother = 0; iother < ibuf; ++iother)
+			EXPECT_NE(buffer[ibuf].str, buffer[iother].str);
+	}
+	EXPECT_EQ(string_thread_buffer().str, buffer[0].str);
+
+	//Nested static conversions do not overwrite each other
+	first = string_from_int_static(-1234, 0, 0);
+	second = string_from_uint_static(0xABCD, true, 0, 0);
+	value = string_from_version_static(version_make(1, 2, 3, 0, 0));
+	EXPECT_CONSTSTRINGEQ(first, string_const(STRING_CONST("-1234")));
+	EXPECT_CONSTSTRINGEQ(second, string_const(STRING_CONST("abcd")));
+	EXPECT_CONSTSTRINGEQ(value, string_const(STRING_CONST("1.2.3")));
+
+	value = string_to_const(string_format(local, sizeof(local), STRING_CONST("%.*s %.*s"),
+	                                      STRING_FORMAT(string_from_int_static(42, 0, 0)),
+	                                      STRING_FORMAT(string_from_real_static(REAL_C(0.5), 0, 0, 0))));
+	EXPECT_CONSTSTRINGEQ(value, string_const(STRING_CONST("42 0.5")));
+
+	return 0;
+}
+
+DECLARE_TEST(string, hex) {
+	char buffer[128];
+	char reference[128];
+	uint8_t data[48];
+	uint8_t decoded[48];
+	string_t str;
+	uuid_t uuid;
+	size_t ibyte, size;
+
+	for (ibyte = 0; ibyte < sizeof(data); ++ibyte)
+		data[ibyte] = (uint8_t)((ibyte * 37) ^ 0xA5);
+
+	//All sizes cover both vector blocks and the scalar tail
+	for (size = 0; size <= sizeof(data); ++size) {
+		for (ibyte = 0; ibyte < size; ++ibyte)
+			snprintf(reference + (ibyte * 2), 3, "%02x", data[ibyte]);
+		str = string_hex_encode(buffer, sizeof(buffer), data, size, false);
+		EXPECT_SIZEEQ(str.length, size * 2);
+		EXPECT_EQ(str.str[str.length], 0);
+		EXPECT_EQ(memcmp(str.str, reference, size * 2), 0);
+
+		memset(decoded, 0, sizeof(decoded));
+		EXPECT_SIZEEQ(string_hex_decode(STRING_ARGS(str), decoded, sizeof(decoded)), size);
+		EXPECT_EQ(memcmp(decoded, data, size), 0);
+	}
+
+	str = string_hex_encode(buffer, sizeof(buffer), data, 20, true);
+	for (ibyte = 0; ibyte < 20; ++ibyte)
+		snprintf(reference + (ibyte * 2), 3, "%02X", data[ibyte]);
+	EXPECT_STRINGEQ(str, string_const(reference, 40));
+	EXPECT_SIZEEQ(string_hex_decode(STRING_ARGS(str), decoded, sizeof(decoded)), 20);
+	EXPECT_EQ(memcmp(decoded, data, 20), 0);
+
+	//Truncated to capacity, without terminator if the buffer is full
+	buffer[6] = 'x';
+	str = string_hex_encode(buffer, 6, data, sizeof(data), false);
+	EXPECT_SIZEEQ(str.length, 6);
+	EXPECT_EQ(buffer[6], 'x');
+	str = string_hex_encode(buffer, 7, data, sizeof(data), false);
+	EXPECT_SIZEEQ(str.length, 6);
+	EXPECT_EQ(buffer[6], 0);
+
+	//Decoding stops at the first invalid pair, in vector blocks as well as the scalar tail
+	str = string_hex_encode(buffer, sizeof(buffer), data, sizeof(data), false);
+	buffer[41] = 'g';
+	EXPECT_SIZEEQ(string_hex_decode(STRING_ARGS(str), decoded, sizeof(decoded)), 20);
+	buffer[41] = '0';
+	buffer[90] = ':';
+	EXPECT_SIZEEQ(string_hex_decode(STRING_ARGS(str), decoded, sizeof(decoded)), 45);
+	EXPECT_SIZEEQ(string_hex_decode(STRING_CONST("0aFf1"), decoded, sizeof(decoded)), 2);
+	EXPECT_EQ(decoded[0], 0x0A);
+	EXPECT_EQ(decoded[1], 0xFF);
+	EXPECT_SIZEEQ(string_hex_decode(STRING_ARGS(str), decoded, 3), 3);
+
+	str = string_from_uint(buffer, sizeof(buffer), 0, true, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("0")));
+	str = string_from_uint(buffer, sizeof(buffer), 0xF00DULL, true, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("f00d")));
+	str = string_from_uint(buffer, sizeof(buffer), 0xFEDCBA9876543210ULL, true, 0, 0);
+	EXPECT_STRINGEQ(str, string_const(STRING_CONST("fedcba9876543210")));
+
+	EXPECT_TRUE(uint128_equal(string_to_uint128(STRING_CONST("a234567890234567b345678902345678")),
+	                          uint128_make(0xa234567890234567ULL, 0xb345678902345678ULL)));
+	EXPECT_TRUE(uint128_equal(string_to_uint128(STRING_CONST("1234")), uint128_make(0x1234, 0)));
+
+	uuid = string_to_uuid(STRING_CONST("6ba7b810-9dad-11d1-80b4-00c04fd430c8"));
+	EXPECT_TRUE(uuid_equal(uuid, UUID_DNS));
+	uuid = string_to_uuid(STRING_CONST("6BA7B810-9DAD-11D1-80B4-00C04FD430C8"));
+	EXPECT_TRUE(uuid_equal(uuid, UUID_DNS));
+	uuid = string_to_uuid(STRING_CONST("6ba7b810-9dad-11d1-80b4-00c04fd430"));
+	EXPECT_FALSE(uuid_equal(uuid, UUID_DNS));
+
+	return 0;
+}
+
 static void
 test_string_declare(void) {
 	ADD_TEST(string, allocate);
@@ -2341,6 +3089,16 @@ test_string_declare(void) {
 	ADD_TEST(string, prepend);
 	ADD_TEST(string, format);
 	ADD_TEST(string, convert);
+	ADD_TEST(string, search);
+	ADD_TEST(string, builder);
+	ADD_TEST(string, numbers);
+	ADD_TEST(string, parse);
+	ADD_TEST(string, utf);
+	ADD_TEST(string, tokenizer);
+	ADD_TEST(string, nocase);
+	ADD_TEST(string, set);
+	ADD_TEST(string, thread_buffer);
+	ADD_TEST(string, hex);
 }
 
 static test_suite_t test_string_suite = {
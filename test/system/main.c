@@ -136,6 +136,14 @@ DECLARE_TEST(system, builtin) {
 	EXPECT_EQ(system_hostname(buffer, 2).length, 1);
 	EXPECT_NE(system_username(buffer, 2).str, 0);
 	EXPECT_EQ(system_username(buffer, 2).length, 1);
+	EXPECT_CONSTSTRINGEQ(system_hostname_cached(),
+	                     string_to_const(system_hostname(buffer, sizeof(buffer))));
+	EXPECT_CONSTSTRINGEQ(system_username_cached(),
+	                     string_to_const(system_username(buffer, sizeof(buffer))));
+	EXPECT_EQ(system_hostname_cached().str, system_hostname_cached().str);
+	system_names_invalidate();
+	EXPECT_CONSTSTRINGEQ(system_hostname_cached(),
+	                     string_to_const(system_hostname(buffer, sizeof(buffer))));
 
 #if !FOUNDATION_PLATFORM_PNACL
 	EXPECT_NE(system_hostid(), 0);
@@ -176,10 +184,97 @@ DECLARE_TEST(system, builtin) {
 	return 0;
 }
 
+DECLARE_TEST(system, topology) {
+	size_t num_nodes = system_hardware_nodes();
+	uint64_t all_mask = 0;
+	unsigned int node;
+
+	EXPECT_GE(num_nodes, 1);
+	for (node = 0; node < num_nodes; ++node)
+		all_mask |= system_hardware_node_mask(node);
+	EXPECT_NE(all_mask, 0);
+	EXPECT_EQ(system_hardware_node_mask((unsigned int)num_nodes), 0);
+
+	EXPECT_LT(system_hardware_thread_node(thread_hardware()), num_nodes);
+	for (node = 0; node < num_nodes; ++node) {
+		uint64_t mask = system_hardware_node_mask(node);
+		unsigned int hwthread;
+		for (hwthread = 0; hwthread < 64; ++hwthread) {
+			if (mask & (1ULL << hwthread))
+				EXPECT_UINTEQ(system_hardware_thread_node(hwthread), node);
+		}
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(system, cores) {
+	size_t num_threads = system_hardware_threads();
+	size_t num_cores = system_hardware_cores();
+	size_t num_classes = system_hardware_core_classes();
+	unsigned int hwthread, other;
+
+	EXPECT_GE(num_cores, 1);
+	EXPECT_GE(num_classes, 1);
+
+	for (hwthread = 0; (hwthread < num_threads) && (hwthread < 64); ++hwthread) {
+		hardware_topology_t topology = system_hardware_topology(hwthread);
+		uint64_t self = (1ULL << hwthread);
+		EXPECT_LT(topology.core, num_cores);
+		EXPECT_LT(topology.core_class, num_classes);
+		EXPECT_UINTEQ(topology.node, system_hardware_thread_node(hwthread));
+		EXPECT_NE(topology.core_mask & self, 0);
+		EXPECT_NE(topology.l2_mask & self, 0);
+		EXPECT_NE(topology.l3_mask & self, 0);
+		//SMT siblings share core and caches
+		for (other = 0; other < 64; ++other) {
+			if ((other == hwthread) || !(topology.core_mask & (1ULL << other)))
+				continue;
+			EXPECT_UINTEQ(system_hardware_topology(other).core, topology.core);
+			EXPECT_NE(topology.l2_mask & (1ULL << other), 0);
+		}
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(system, startup) {
+	size_t count, itiming;
+	bool found_memory = false;
+	bool found_topology = false;
+	const foundation_subsystem_timing_t* timing;
+
+	//Query topology to force lazy initialization if not already done
+	EXPECT_GE(system_hardware_cores(), 1);
+
+	timing = foundation_subsystem_timing(&count);
+	EXPECT_NE(timing, 0);
+	EXPECT_GE(count, 20);
+	for (itiming = 0; itiming < count; ++itiming) {
+		EXPECT_GT(timing[itiming].name.length, 0);
+		EXPECT_GE(timing[itiming].time, 0);
+		if (string_equal(STRING_ARGS(timing[itiming].name), STRING_CONST("memory")))
+			found_memory = true;
+		else if (string_equal(STRING_ARGS(timing[itiming].name), STRING_CONST("system_topology")))
+			found_topology = true;
+	}
+	EXPECT_TRUE(found_memory);
+#if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_LINUX || FOUNDATION_PLATFORM_ANDROID
+	EXPECT_TRUE(found_topology);
+#else
+	EXPECT_FALSE(found_topology);
+#endif
+
+	return 0;
+}
+
 static void
 test_system_declare(void) {
 	ADD_TEST(system, align);
 	ADD_TEST(system, builtin);
+	ADD_TEST(system, topology);
+	ADD_TEST(system, cores);
+	ADD_TEST(system, startup);
 }
 
 static test_suite_t test_system_suite = {
@@ -0,0 +1,530 @@
+/* main.c  -  Foundation task test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_task_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation task tests"));
+	app.short_name = string_const(STRING_CONST("test_task"));
+	app.config_dir = string_const(STRING_CONST("test_task"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_task_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_task_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_task_initialize(void) {
+	return 0;
+}
+
+static void
+test_task_finalize(void) {
+}
+
+static atomic32_t task_executed;
+static atomic32_t task_order_error;
+static atomic32_t task_order_stage;
+static task_scheduler_t* task_scheduler;
+
+static void
+task_count(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	atomic_incr32(&task_executed);
+}
+
+static void
+task_spawn(void* arg) {
+	task_t child[8];
+	size_t ichild;
+	task_counter_t counter;
+	uintptr_t depth = (uintptr_t)arg;
+
+	atomic_incr32(&task_executed);
+	if (!depth)
+		return;
+
+	memset(&counter, 0, sizeof(counter));
+	for (ichild = 0; ichild < sizeof(child) / sizeof(child[0]); ++ichild) {
+		child[ichild].function = task_spawn;
+		child[ichild].arg = (void*)(depth - 1);
+		child[ichild].name = string_const(STRING_CONST("spawn"));
+	}
+	task_submit(task_scheduler, child, sizeof(child) / sizeof(child[0]), &counter);
+	task_wait(task_scheduler, &counter);
+}
+
+static void
+task_stage(void* arg) {
+	int32_t stage = (int32_t)(uintptr_t)arg;
+	if (atomic_load32(&task_order_stage) > stage)
+		atomic_incr32(&task_order_error);
+	thread_yield();
+	atomic_incr32(&task_executed);
+	if (atomic_load32(&task_order_stage) < stage)
+		atomic_store32(&task_order_stage, stage);
+}
+
+DECLARE_TEST(task, basic) {
+	task_scheduler_t* scheduler;
+	task_counter_t counter;
+	task_t task[100];
+	size_t itask, iloop;
+
+	scheduler = task_scheduler_allocate(0, 0);
+	EXPECT_SIZEEQ(task_scheduler_worker_count(scheduler), system_hardware_threads());
+	task_scheduler_deallocate(scheduler);
+
+	scheduler = task_scheduler_allocate(4, 16);
+	EXPECT_SIZEEQ(task_scheduler_worker_count(scheduler), 4);
+
+	memset(&counter, 0, sizeof(counter));
+	EXPECT_TRUE(task_counter_done(&counter));
+	task_wait(scheduler, &counter);
+
+	for (itask = 0; itask < sizeof(task) / sizeof(task[0]); ++itask) {
+		task[itask].function = task_count;
+		task[itask].arg = 0;
+		task[itask].name = string_const(STRING_CONST("count"));
+	}
+
+	//More tasks than internal slots, submitting thread must help out
+	atomic_store32(&task_executed, 0);
+	for (iloop = 0; iloop < 100; ++iloop)
+		task_submit(scheduler, task, sizeof(task) / sizeof(task[0]), &counter);
+	task_wait(scheduler, &counter);
+	EXPECT_TRUE(task_counter_done(&counter));
+	EXPECT_INTEQ(atomic_load32(&task_executed), 100 * (int)(sizeof(task) / sizeof(task[0])));
+
+	//No completion counter
+	atomic_store32(&task_executed, 0);
+	task_submit(scheduler, task, 10, 0);
+	while (atomic_load32(&task_executed) < 10)
+		thread_yield();
+
+	task_scheduler_deallocate(scheduler);
+	return 0;
+}
+
+DECLARE_TEST(task, nested) {
+	task_counter_t counter;
+	task_t task;
+
+	//Each task spawns children from the worker thread and waits on them, reaching
+	//1 + 8 + 64 + 512 tasks
+	task_scheduler = task_scheduler_allocate(0, 0);
+	atomic_store32(&task_executed, 0);
+	memset(&counter, 0, sizeof(counter));
+
+	task.function = task_spawn;
+	task.arg = (void*)(uintptr_t)3;
+	task.name = string_const(STRING_CONST("spawn"));
+	task_submit(task_scheduler, &task, 1, &counter);
+	task_wait(task_scheduler, &counter);
+
+	EXPECT_INTEQ(atomic_load32(&task_executed), 1 + 8 + 64 + 512);
+
+	task_scheduler_deallocate(task_scheduler);
+	task_scheduler = 0;
+	return 0;
+}
+
+DECLARE_TEST(task, continuation) {
+	task_scheduler_t* scheduler;
+	task_counter_t counter[3];
+	task_t task[32];
+	size_t itask, iloop;
+
+	scheduler = task_scheduler_allocate(4, 64);
+
+	for (iloop = 0; iloop < 32; ++iloop) {
+		memset(counter, 0, sizeof(counter));
+		atomic_store32(&task_executed, 0);
+		atomic_store32(&task_order_error, 0);
+		atomic_store32(&task_order_stage, 0);
+
+		//Three stages, continuations queued before and after the dependency completes
+		for (itask = 0; itask < 32; ++itask) {
+			task[itask].function = task_stage;
+			task[itask].arg = (void*)(uintptr_t)1;
+			task[itask].name = string_const(STRING_CONST("stage"));
+		}
+		task_submit(scheduler, task, 32, &counter[0]);
+
+		for (itask = 0; itask < 32; ++itask)
+			task[itask].arg = (void*)(uintptr_t)2;
+		task_continue(scheduler, &counter[0], task, 32, &counter[1]);
+
+		for (itask = 0; itask < 32; ++itask)
+			task[itask].arg = (void*)(uintptr_t)3;
+		if (iloop & 1)
+			task_wait(scheduler, &counter[1]);
+		task_continue(scheduler, &counter[1], task, 32, &counter[2]);
+
+		task_wait(scheduler, &counter[2]);
+		EXPECT_TRUE(task_counter_done(&counter[0]));
+		EXPECT_TRUE(task_counter_done(&counter[1]));
+		EXPECT_INTEQ(atomic_load32(&task_executed), 3 * 32);
+		EXPECT_INTEQ(atomic_load32(&task_order_error), 0);
+	}
+
+	//Continuation on a counter that never had any tasks runs immediately
+	memset(counter, 0, sizeof(counter));
+	atomic_store32(&task_executed, 0);
+	task[0].function = task_count;
+	task_continue(scheduler, &counter[0], task, 1, &counter[1]);
+	task_wait(scheduler, &counter[1]);
+	EXPECT_INTEQ(atomic_load32(&task_executed), 1);
+
+	task_scheduler_deallocate(scheduler);
+	return 0;
+}
+
+#define TASK_GRAPH_LAYERS 4
+#define TASK_GRAPH_WIDTH  16
+
+static atomic32_t task_graph_done[TASK_GRAPH_LAYERS * TASK_GRAPH_WIDTH + 1];
+
+static void
+task_graph_layer(void* arg) {
+	size_t index = (size_t)(uintptr_t)arg;
+	size_t layer = index / TASK_GRAPH_WIDTH;
+	size_t iprev;
+	//Every task in a layer depends on all tasks in the previous layer
+	if (layer) {
+		for (iprev = 0; iprev < TASK_GRAPH_WIDTH; ++iprev) {
+			if (!atomic_load32(&task_graph_done[((layer - 1) * TASK_GRAPH_WIDTH) + iprev]))
+				atomic_incr32(&task_order_error);
+		}
+	}
+	atomic_incr32(&task_executed);
+	atomic_store32(&task_graph_done[index], 1);
+}
+
+static void
+task_graph_sink(void* arg) {
+	size_t itask;
+	FOUNDATION_UNUSED(arg);
+	for (itask = 0; itask < TASK_GRAPH_LAYERS * TASK_GRAPH_WIDTH; ++itask) {
+		if (!atomic_load32(&task_graph_done[itask]))
+			atomic_incr32(&task_order_error);
+	}
+	atomic_incr32(&task_executed);
+}
+
+DECLARE_TEST(task, graph) {
+	task_scheduler_t* scheduler;
+	task_graph_t* graph;
+	task_counter_t counter;
+	task_t task;
+	size_t layer, itask, iprev, sink, iloop;
+
+	scheduler = task_scheduler_allocate(4, 0);
+	graph = task_graph_allocate(0);
+	EXPECT_SIZEEQ(task_graph_size(graph), 0);
+
+	//Empty graph completes immediately
+	task_graph_execute(graph, scheduler, 0);
+
+	task.name = string_const(STRING_CONST("layer"));
+	task.function = task_graph_layer;
+	for (layer = 0; layer < TASK_GRAPH_LAYERS; ++layer) {
+		for (itask = 0; itask < TASK_GRAPH_WIDTH; ++itask) {
+			size_t index = (layer * TASK_GRAPH_WIDTH) + itask;
+			task.arg = (void*)(uintptr_t)index;
+			EXPECT_SIZEEQ(task_graph_add(graph, &task), index);
+			if (layer) {
+				for (iprev = 0; iprev < TASK_GRAPH_WIDTH; ++iprev)
+					task_graph_depend(graph, index, ((layer - 1) * TASK_GRAPH_WIDTH) + iprev);
+			}
+		}
+	}
+	task.name = string_const(STRING_CONST("sink"));
+	task.function = task_graph_sink;
+	task.arg = 0;
+	sink = task_graph_add(graph, &task);
+	for (itask = 0; itask < TASK_GRAPH_WIDTH; ++itask)
+		task_graph_depend(graph, sink, ((TASK_GRAPH_LAYERS - 1) * TASK_GRAPH_WIDTH) + itask);
+	EXPECT_SIZEEQ(task_graph_size(graph), TASK_GRAPH_LAYERS * TASK_GRAPH_WIDTH + 1);
+
+	//Graph can be executed repeatedly, blocking and with a counter
+	for (iloop = 0; iloop < 16; ++iloop) {
+		memset(task_graph_done, 0, sizeof(task_graph_done));
+		atomic_store32(&task_executed, 0);
+		atomic_store32(&task_order_error, 0);
+		if (iloop & 1) {
+			memset(&counter, 0, sizeof(counter));
+			task_graph_execute(graph, scheduler, &counter);
+			task_wait(scheduler, &counter);
+		}
+		else {
+			task_graph_execute(graph, scheduler, 0);
+		}
+		EXPECT_INTEQ(atomic_load32(&task_executed), TASK_GRAPH_LAYERS * TASK_GRAPH_WIDTH + 1);
+		EXPECT_INTEQ(atomic_load32(&task_order_error), 0);
+	}
+
+	task_graph_clear(graph);
+	EXPECT_SIZEEQ(task_graph_size(graph), 0);
+
+	task_graph_deallocate(graph);
+	task_scheduler_deallocate(scheduler);
+	return 0;
+}
+
+static void
+task_parallel_visit(size_t begin, size_t end, void* arg) {
+	atomic32_t* visited = arg;
+	for (; begin < end; ++begin)
+		atomic_incr32(visited + begin);
+}
+
+static void
+task_parallel_sum(size_t begin, size_t end, void* partial, void* arg) {
+	const uint32_t* value = arg;
+	uint64_t sum = *(uint64_t*)partial;
+	for (; begin < end; ++begin)
+		sum += value[begin];
+	*(uint64_t*)partial = sum;
+}
+
+static void
+task_parallel_join(void* result, const void* partial, void* arg) {
+	FOUNDATION_UNUSED(arg);
+	*(uint64_t*)result += *(const uint64_t*)partial;
+}
+
+DECLARE_TEST(task, parallel) {
+	task_scheduler_t* scheduler;
+	atomic32_t* visited;
+	uint32_t* value;
+	uint64_t sum, expect, identity;
+	size_t num_values = 100000;
+	size_t ival, igrain;
+	size_t grain[] = {0, 1, 7, 1000, 200000};
+
+	scheduler = task_scheduler_allocate(4, 0);
+	visited = memory_allocate(0, sizeof(atomic32_t) * num_values, 0, MEMORY_PERSISTENT);
+	value = 0;
+	expect = 0;
+	for (ival = 0; ival < num_values; ++ival) {
+		array_push(value, (uint32_t)ival * 3);
+		expect += (uint64_t)ival * 3;
+	}
+
+	for (igrain = 0; igrain < sizeof(grain) / sizeof(grain[0]); ++igrain) {
+		memset(visited, 0, sizeof(atomic32_t) * num_values);
+		task_parallel_for(scheduler, 0, num_values, grain[igrain], task_parallel_visit, visited);
+		for (ival = 0; ival < num_values; ++ival)
+			EXPECT_INTEQ(atomic_load32(visited + ival), 1);
+
+		//Sub range
+		memset(visited, 0, sizeof(atomic32_t) * num_values);
+		task_parallel_for(scheduler, 10, 20, grain[igrain], task_parallel_visit, visited);
+		for (ival = 0; ival < num_values; ++ival)
+			EXPECT_INTEQ(atomic_load32(visited + ival), ((ival >= 10) && (ival < 20)) ? 1 : 0);
+
+		sum = 0;
+		identity = 0;
+		task_parallel_reduce(scheduler, 0, array_size(value), grain[igrain], task_parallel_sum,
+		                     task_parallel_join, &sum, &identity, sizeof(sum), value);
+		EXPECT_TYPEEQ(sum, expect, uint64_t, PRIu64);
+	}
+
+	//Empty and single element ranges
+	memset(visited, 0, sizeof(atomic32_t) * num_values);
+	task_parallel_for(scheduler, 5, 5, 0, task_parallel_visit, visited);
+	EXPECT_INTEQ(atomic_load32(visited + 5), 0);
+	task_parallel_for(scheduler, 5, 6, 0, task_parallel_visit, visited);
+	EXPECT_INTEQ(atomic_load32(visited + 5), 1);
+	sum = 0;
+	task_parallel_reduce(scheduler, 1, 2, 0, task_parallel_sum, task_parallel_join, &sum,
+	                     &identity, sizeof(sum), value);
+	EXPECT_TYPEEQ(sum, (uint64_t)3, uint64_t, PRIu64);
+
+	array_deallocate(value);
+	memory_deallocate(visited);
+	task_scheduler_deallocate(scheduler);
+	return 0;
+}
+
+static semaphore_t task_semaphore;
+static mutex_t* task_mutex;
+static beacon_t* task_beacon;
+static atomic32_t task_inside;
+
+static void
+task_semaphore_waiter(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	task_semaphore_wait(&task_semaphore);
+	atomic_incr32(&task_executed);
+}
+
+static void
+task_semaphore_poster(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	semaphore_post(&task_semaphore);
+}
+
+static void
+task_mutex_locker(void* arg) {
+	task_counter_t counter;
+	task_t child;
+	FOUNDATION_UNUSED(arg);
+
+	task_mutex_lock(task_mutex);
+	if (atomic_incr32(&task_inside) != 1)
+		atomic_incr32(&task_order_error);
+
+	//Suspend while holding the lock, other tasks on the same worker must not enter
+	memset(&counter, 0, sizeof(counter));
+	child.function = task_count;
+	child.arg = 0;
+	child.name = string_const(STRING_CONST("child"));
+	task_submit(task_scheduler, &child, 1, &counter);
+	task_wait(task_scheduler, &counter);
+
+	atomic_decr32(&task_inside);
+	task_mutex_unlock(task_mutex);
+}
+
+static void
+task_beacon_waiter(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	if (task_beacon_wait(task_beacon) == 0)
+		atomic_incr32(&task_executed);
+}
+
+DECLARE_TEST(task, fiber) {
+	task_counter_t counter;
+	task_t task[16];
+	size_t itask;
+	tick_t start;
+
+	//Single worker, waiting tasks must yield the worker to the tasks they wait for
+	task_scheduler = task_scheduler_allocate(1, 0);
+#if !FOUNDATION_PLATFORM_ANDROID && !FOUNDATION_PLATFORM_PNACL
+	semaphore_initialize(&task_semaphore, 0);
+	atomic_store32(&task_executed, 0);
+	memset(&counter, 0, sizeof(counter));
+	for (itask = 0; itask < 16; ++itask) {
+		task[itask].function = (itask < 8) ? task_semaphore_waiter : task_semaphore_poster;
+		task[itask].arg = 0;
+		task[itask].name = string_const(STRING_CONST("semaphore"));
+	}
+	//Submit directly from a task so all of them end up in the worker deque
+	task_submit(task_scheduler, task, 16, &counter);
+	start = time_current();
+	while (!task_counter_done(&counter) && (time_elapsed(start) < 10.0))
+		thread_yield();
+	EXPECT_TRUE(task_counter_done(&counter));
+	EXPECT_INTEQ(atomic_load32(&task_executed), 8);
+	semaphore_finalize(&task_semaphore);
+
+	task_mutex = mutex_allocate(STRING_CONST("task"));
+	atomic_store32(&task_inside, 0);
+	atomic_store32(&task_order_error, 0);
+	memset(&counter, 0, sizeof(counter));
+	for (itask = 0; itask < 16; ++itask) {
+		task[itask].function = task_mutex_locker;
+		task[itask].name = string_const(STRING_CONST("mutex"));
+	}
+	task_submit(task_scheduler, task, 16, &counter);
+	start = time_current();
+	while (!task_counter_done(&counter) && (time_elapsed(start) < 10.0))
+		thread_yield();
+	EXPECT_TRUE(task_counter_done(&counter));
+	EXPECT_INTEQ(atomic_load32(&task_order_error), 0);
+	mutex_deallocate(task_mutex);
+
+	task_beacon = beacon_allocate();
+	atomic_store32(&task_executed, 0);
+	memset(&counter, 0, sizeof(counter));
+	task[0].function = task_beacon_waiter;
+	task[0].name = string_const(STRING_CONST("beacon"));
+	task[1].function = task_count;
+	task[1].name = string_const(STRING_CONST("count"));
+	task_submit(task_scheduler, task, 2, &counter);
+	//Beacon waiting task must not keep the other task from executing
+	start = time_current();
+	while ((atomic_load32(&task_executed) < 1) && (time_elapsed(start) < 10.0))
+		thread_yield();
+	EXPECT_INTEQ(atomic_load32(&task_executed), 1);
+	beacon_fire(task_beacon);
+	start = time_current();
+	while (!task_counter_done(&counter) && (time_elapsed(start) < 10.0))
+		thread_yield();
+	EXPECT_TRUE(task_counter_done(&counter));
+	EXPECT_INTEQ(atomic_load32(&task_executed), 2);
+	beacon_deallocate(task_beacon);
+#endif
+	task_scheduler_deallocate(task_scheduler);
+	task_scheduler = 0;
+	return 0;
+}
+
+static void
+test_task_declare(void) {
+	ADD_TEST(task, basic);
+	ADD_TEST(task, nested);
+	ADD_TEST(task, continuation);
+	ADD_TEST(task, graph);
+	ADD_TEST(task, parallel);
+	ADD_TEST(task, fiber);
+}
+
+static test_suite_t test_task_suite = {
+	test_task_application,
+	test_task_memory_system,
+	test_task_config,
+	test_task_declare,
+	test_task_initialize,
+	test_task_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_task_run(void);
+
+int
+test_task_run(void) {
+	test_suite = test_task_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_task_suite;
+}
+
+#endif
@@ -34,6 +34,7 @@ static foundation_config_t
 test_time_config(void) {
 	foundation_config_t config;
 	memset(&config, 0, sizeof(config));
+	config.time_cycle_counter = true;
 	return config;
 }
 
@@ -100,9 +101,84 @@ DECLARE_TEST(time, builtin) {
 	return 0;
 }
 
+DECLARE_TEST(time, cycle_counter) {
+	tick_t tick, system;
+	deltatime_t dt;
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64 || FOUNDATION_ARCH_ARM_64) && \
+    (FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG || FOUNDATION_COMPILER_MSVC)
+	log_infof(HASH_TEST, STRING_CONST("Time source is %s, %" PRId64 " ticks per second"),
+	          time_is_cycle_counter() ? "cycle counter" : "system clock", time_ticks_per_second());
+#else
+	EXPECT_FALSE(time_is_cycle_counter());
+#endif
+
+	//Calibrated frequency must agree with system time
+	tick = time_current();
+	system = time_system();
+	thread_sleep(200);
+	dt = time_elapsed(tick);
+	system = time_system() - system;
+
+	EXPECT_REALGT(dt, 0.15f);
+	EXPECT_REALLT(dt, 0.5f);
+	EXPECT_REALGT(dt, (deltatime_t)system * 0.0009f);
+	EXPECT_REALLT(dt, (deltatime_t)system * 0.0011f + 0.002f);
+
+	return 0;
+}
+
+DECLARE_TEST(time, coarse) {
+	tick_t tick, coarse, newtick, newcoarse, tps;
+	tick_t system, newsystem;
+	int iloop;
+
+	tps = time_ticks_per_second();
+
+	//Coarse clock shares base with precise clock, and lags it by less than 50ms
+	tick = time_current();
+	coarse = time_current_coarse();
+	EXPECT_TICKGT(coarse, 0);
+	EXPECT_TICKLT(coarse, tick + (tps / 20));
+	EXPECT_TICKGT(coarse, tick - (tps / 20));
+
+	thread_sleep(30);
+	newtick = time_current();
+	newcoarse = time_current_coarse();
+	EXPECT_TICKGT(newcoarse, coarse);
+	EXPECT_TICKGT(newcoarse - coarse, tps / 100);
+	EXPECT_TICKLT(newcoarse - coarse, (newtick - tick) + (tps / 20));
+
+	//Monotonic
+	for (iloop = 0; iloop < 10000; ++iloop) {
+		coarse = newcoarse;
+		newcoarse = time_current_coarse();
+		EXPECT_TICKGE(newcoarse, coarse);
+	}
+
+	system = time_system();
+	newsystem = time_system_coarse();
+	EXPECT_TICKGT(newsystem, system - 50);
+	EXPECT_TICKLT(newsystem, system + 50);
+
+	thread_sleep(100);
+	system = newsystem;
+	newsystem = time_system_coarse();
+	EXPECT_GT_MSGFORMAT(newsystem - system, 50,
+	                    "Elapsed coarse system time less than 50ms, expected 100ms, got %" PRId64 "ms",
+	                    newsystem - system);
+	EXPECT_LT_MSGFORMAT(newsystem - system, 200,
+	                    "Elapsed coarse system time more than 200ms, expected 100ms, got %" PRId64 "ms",
+	                    newsystem - system);
+
+	return 0;
+}
+
 static void
 test_time_declare(void) {
 	ADD_TEST(time, builtin);
+	ADD_TEST(time, cycle_counter);
+	ADD_TEST(time, coarse);
 }
 
 static test_suite_t test_time_suite = {
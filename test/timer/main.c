@@ -0,0 +1,305 @@
+/* main.c  -  Foundation timer test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_timer_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation timer tests"));
+	app.short_name = string_const(STRING_CONST("test_timer"));
+	app.config_dir = string_const(STRING_CONST("test_timer"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_timer_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_timer_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_timer_initialize(void) {
+	return 0;
+}
+
+static void
+test_timer_finalize(void) {
+}
+
+#define TIMER_COUNT 1024
+
+typedef struct {
+	tick_t added;
+	tick_t fired;
+	unsigned int delay;
+	atomic32_t count;
+} timer_test_t;
+
+static timer_test_t timer_test[TIMER_COUNT];
+static atomic32_t timer_fired;
+
+static void
+timer_test_fn(void* arg) {
+	timer_test_t* test = arg;
+	if (!atomic_load32(&test->count))
+		test->fired = time_current();
+	atomic_incr32(&test->count);
+	atomic_incr32(&timer_fired);
+}
+
+static bool
+timer_test_wait(int32_t count, unsigned int timeout) {
+	tick_t start = time_current();
+	while (atomic_load32(&timer_fired) < count) {
+		if (time_elapsed(start) > (deltatime_t)timeout / REAL_C(1000.0))
+			return false;
+		thread_sleep(1);
+	}
+	return true;
+}
+
+static deltatime_t
+timer_test_elapsed(const timer_test_t* test) {
+	return time_ticks_to_seconds(test->fired - test->added) * REAL_C(1000.0);
+}
+
+DECLARE_TEST(timer, oneshot) {
+	timer_service_t* service;
+	unsigned int delay[] = {40, 0, 10, 70, 25, 130};
+	size_t itimer;
+	const size_t count = sizeof(delay) / sizeof(delay[0]);
+
+	memset(timer_test, 0, sizeof(timer_test));
+	atomic_store32(&timer_fired, 0);
+
+	service = timer_service_allocate(16, 0, 0);
+	EXPECT_EQ(timer_add(service, 10, 0, 0, 0), 0);
+
+	for (itimer = 0; itimer < count; ++itimer) {
+		timer_test[itimer].delay = delay[itimer];
+		timer_test[itimer].added = time_current();
+		EXPECT_NE(timer_add(service, delay[itimer], 0, timer_test_fn, timer_test + itimer), 0);
+	}
+	EXPECT_SIZEEQ(timer_count(service), count);
+
+	EXPECT_TRUE(timer_test_wait((int32_t)count, 2000));
+	thread_sleep(50);
+	EXPECT_INTEQ(atomic_load32(&timer_fired), (int32_t)count);
+	EXPECT_SIZEEQ(timer_count(service), 0);
+
+	for (itimer = 0; itimer < count; ++itimer) {
+		EXPECT_INTEQ(atomic_load32(&timer_test[itimer].count), 1);
+		EXPECT_REALGE(timer_test_elapsed(timer_test + itimer),
+		              (deltatime_t)timer_test[itimer].delay - REAL_C(1.0));
+	}
+	//Expiry order follows delay
+	EXPECT_TICKLT(timer_test[1].fired, timer_test[2].fired);
+	EXPECT_TICKLT(timer_test[2].fired, timer_test[4].fired);
+	EXPECT_TICKLT(timer_test[4].fired, timer_test[0].fired);
+	EXPECT_TICKLT(timer_test[0].fired, timer_test[3].fired);
+	EXPECT_TICKLT(timer_test[3].fired, timer_test[5].fired);
+
+	timer_service_deallocate(service);
+
+	return 0;
+}
+
+DECLARE_TEST(timer, periodic) {
+	timer_service_t* service;
+	timer_id_t id;
+	int32_t fired;
+
+	memset(timer_test, 0, sizeof(timer_test));
+	atomic_store32(&timer_fired, 0);
+
+	service = timer_service_allocate(4, 0, 0);
+	timer_test[0].added = time_current();
+	id = timer_add(service, 5, 10, timer_test_fn, timer_test);
+	EXPECT_NE(id, 0);
+
+	thread_sleep(200);
+	EXPECT_TRUE(timer_cancel(service, id));
+	EXPECT_FALSE(timer_cancel(service, id));
+	EXPECT_SIZEEQ(timer_count(service), 0);
+
+	fired = atomic_load32(&timer_test[0].count);
+	EXPECT_INTGE(fired, 10);
+	EXPECT_INTLE(fired, 21);
+
+	thread_sleep(50);
+	EXPECT_INTEQ(atomic_load32(&timer_test[0].count), fired);
+
+	timer_service_deallocate(service);
+
+	return 0;
+}
+
+DECLARE_TEST(timer, cancel) {
+	timer_service_t* service;
+	timer_id_t id[TIMER_COUNT];
+	size_t itimer;
+
+	memset(timer_test, 0, sizeof(timer_test));
+	atomic_store32(&timer_fired, 0);
+
+	service = timer_service_allocate(TIMER_COUNT, 0, 0);
+	for (itimer = 0; itimer < TIMER_COUNT; ++itimer) {
+		timer_test[itimer].added = time_current();
+		timer_test[itimer].delay = 20 + (unsigned int)(itimer % 200);
+		id[itimer] = timer_add(service, timer_test[itimer].delay, 0, timer_test_fn,
+		                       timer_test + itimer);
+		EXPECT_NE(id[itimer], 0);
+	}
+	EXPECT_EQ(timer_add(service, 10, 0, timer_test_fn, timer_test), 0);
+
+	for (itimer = 0; itimer < TIMER_COUNT; itimer += 2)
+		EXPECT_TRUE(timer_cancel(service, id[itimer]));
+	EXPECT_SIZEEQ(timer_count(service), TIMER_COUNT / 2);
+
+	EXPECT_TRUE(timer_test_wait(TIMER_COUNT / 2, 2000));
+	thread_sleep(20);
+	EXPECT_INTEQ(atomic_load32(&timer_fired), TIMER_COUNT / 2);
+	for (itimer = 0; itimer < TIMER_COUNT; ++itimer) {
+		EXPECT_INTEQ(atomic_load32(&timer_test[itimer].count), (itimer % 2) ? 1 : 0);
+		if (itimer % 2)
+			EXPECT_REALGE(timer_test_elapsed(timer_test + itimer),
+			              (deltatime_t)timer_test[itimer].delay - REAL_C(1.0));
+		//Expired and stale identifiers are not cancelled
+		EXPECT_FALSE(timer_cancel(service, id[itimer]));
+	}
+	EXPECT_FALSE(timer_cancel(service, 0));
+	EXPECT_FALSE(timer_cancel(service, TIMER_COUNT + 1));
+
+	//Slots are reused with new identifiers
+	EXPECT_NE(timer_add(service, 1000, 0, timer_test_fn, timer_test), id[0]);
+
+	timer_service_deallocate(service);
+
+	return 0;
+}
+
+DECLARE_TEST(timer, event) {
+	timer_service_t* service;
+	event_stream_t* stream;
+	event_block_t* block;
+	event_t* event;
+	timer_id_t id;
+	tick_t start;
+	int received = 0;
+
+	stream = event_stream_allocate(0);
+	service = timer_service_allocate(4, 0, stream);
+	id = timer_add(service, 10, 0, 0, timer_test);
+	EXPECT_NE(id, 0);
+
+	start = time_current();
+	while (!received && (time_elapsed(start) < REAL_C(2.0))) {
+		thread_sleep(5);
+		block = event_stream_process(stream);
+		event = event_next(block, 0);
+		while (event) {
+			const timer_event_payload_t* payload = (const timer_event_payload_t*)event->payload;
+			EXPECT_EQ(event->id, FOUNDATIONEVENT_TIMER);
+			EXPECT_EQ(payload->id, id);
+			EXPECT_EQ(payload->arg, timer_test);
+			++received;
+			event = event_next(block, event);
+		}
+	}
+	EXPECT_INTEQ(received, 1);
+
+	timer_service_deallocate(service);
+	event_stream_deallocate(stream);
+
+	return 0;
+}
+
+DECLARE_TEST(timer, scheduler) {
+	timer_service_t* service;
+	task_scheduler_t* scheduler;
+	size_t itimer;
+
+	memset(timer_test, 0, sizeof(timer_test));
+	atomic_store32(&timer_fired, 0);
+
+	scheduler = task_scheduler_allocate(2, 0);
+	service = timer_service_allocate(64, scheduler, 0);
+	for (itimer = 0; itimer < 64; ++itimer) {
+		timer_test[itimer].added = time_current();
+		timer_test[itimer].delay = (unsigned int)itimer;
+		EXPECT_NE(timer_add(service, (unsigned int)itimer, 0, timer_test_fn, timer_test + itimer), 0);
+	}
+
+	EXPECT_TRUE(timer_test_wait(64, 2000));
+	for (itimer = 0; itimer < 64; ++itimer) {
+		EXPECT_INTEQ(atomic_load32(&timer_test[itimer].count), 1);
+		EXPECT_REALGE(timer_test_elapsed(timer_test + itimer),
+		              (deltatime_t)timer_test[itimer].delay - REAL_C(1.0));
+	}
+
+	timer_service_deallocate(service);
+	task_scheduler_deallocate(scheduler);
+
+	return 0;
+}
+
+static void
+test_timer_declare(void) {
+	ADD_TEST(timer, oneshot);
+	ADD_TEST(timer, periodic);
+	ADD_TEST(timer, cancel);
+	ADD_TEST(timer, event);
+	ADD_TEST(timer, scheduler);
+}
+
+static test_suite_t test_timer_suite = {
+	test_timer_application,
+	test_timer_memory_system,
+	test_timer_config,
+	test_timer_declare,
+	test_timer_initialize,
+	test_timer_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_timer_run(void);
+
+int
+test_timer_run(void) {
+	test_suite = test_timer_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_timer_suite;
+}
+
+#endif
@@ -237,6 +237,96 @@ DECLARE_TEST(uuid, threaded) {
 	return 0;
 }
 
+static char uuid_thread_string[32][NUM_UUIDS][40];
+
+static void*
+uuid_thread_time_ordered(void* arg) {
+	int i;
+	int ithread = (int)(uintptr_t)arg;
+
+	for (i = 0; i < NUM_UUIDS; i += 64) {
+		uuid_thread_store[ithread][i] = uuid_generate_time_ordered();
+		uuid_generate_time_ordered_array(uuid_thread_store[ithread] + i + 1, 63);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(uuid, ordered) {
+	uuid_t uuid[1000];
+	char buffer[40];
+	char prev[40];
+	string_t str;
+	size_t i, ith, jth, j;
+	tick_t before, after, timestamp;
+	thread_t thread[32];
+	size_t num_threads = math_clamp(system_hardware_threads() * 2, 4, 8);
+
+	before = time_system();
+	uuid[0] = uuid_generate_time_ordered();
+	after = time_system();
+
+	str = string_from_uuid(buffer, sizeof(buffer), uuid[0]);
+	EXPECT_SIZEEQ(str.length, 36);
+	EXPECT_EQ(str.str[14], '7');
+	EXPECT_NE(string_find(STRING_CONST("89ab"), str.str[19], 0), STRING_NPOS);
+	timestamp = (tick_t)string_to_uint64(str.str, 8, true) << 16;
+	timestamp |= (tick_t)string_to_uint64(str.str + 9, 4, true);
+	EXPECT_GE(timestamp, before);
+	EXPECT_LE(timestamp, after + 1);
+
+	//Strictly increasing across single and bulk generation
+	string_copy(prev, sizeof(prev), STRING_ARGS(str));
+	uuid_generate_time_ordered_array(uuid + 1, 998);
+	uuid[999] = uuid_generate_time_ordered();
+	for (i = 1; i < 1000; ++i) {
+		str = string_from_uuid(buffer, sizeof(buffer), uuid[i]);
+		EXPECT_EQ(str.str[14], '7');
+		EXPECT_NE(string_find(STRING_CONST("89ab"), str.str[19], 0), STRING_NPOS);
+		EXPECT_GT(strcmp(str.str, prev), 0);
+		string_copy(prev, sizeof(prev), STRING_ARGS(str));
+	}
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_initialize(&thread[ith], uuid_thread_time_ordered, (void*)(uintptr_t)ith,
+		                  STRING_CONST("uuid_thread"), THREAD_PRIORITY_NORMAL, 0);
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_start(&thread[ith]);
+
+	test_wait_for_threads_startup(thread, num_threads);
+	test_wait_for_threads_finish(thread, num_threads);
+
+	for (ith = 0; ith < num_threads; ++ith)
+		thread_finalize(&thread[ith]);
+
+	for (ith = 0; ith < num_threads; ++ith) {
+		for (i = 0; i < NUM_UUIDS; ++i) {
+			string_from_uuid(uuid_thread_string[ith][i], sizeof(uuid_thread_string[ith][i]),
+			                 uuid_thread_store[ith][i]);
+			if (i)
+				EXPECT_GT(strcmp(uuid_thread_string[ith][i], uuid_thread_string[ith][i - 1]), 0);
+		}
+	}
+
+	//Sequences of different threads never overlap
+	for (ith = 0; ith < num_threads; ++ith) {
+		for (jth = ith + 1; jth < num_threads; ++jth) {
+			i = 0;
+			j = 0;
+			while ((i < NUM_UUIDS) && (j < NUM_UUIDS)) {
+				int cmp = strcmp(uuid_thread_string[ith][i], uuid_thread_string[jth][j]);
+				EXPECT_NE(cmp, 0);
+				if (cmp < 0)
+					++i;
+				else
+					++j;
+			}
+		}
+	}
+
+	return 0;
+}
+
 DECLARE_TEST(uuid, string) {
 	uuid_t uuid, uuidref;
 	string_t str;
@@ -277,6 +367,7 @@ static void
 test_uuid_declare(void) {
 	ADD_TEST(uuid, generate);
 	ADD_TEST(uuid, threaded);
+	ADD_TEST(uuid, ordered);
 	ADD_TEST(uuid, string);
 }
 
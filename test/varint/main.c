@@ -0,0 +1,251 @@
+/* main.c  -  Foundation varint test    -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+static application_t
+test_varint_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Foundation varint tests"));
+	app.short_name = string_const(STRING_CONST("test_varint"));
+	app.config_dir = string_const(STRING_CONST("test_varint"));
+	app.flags = APPLICATION_UTILITY;
+	app.dump_callback = test_crash_handler;
+	return app;
+}
+
+static memory_system_t
+test_varint_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_varint_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_varint_initialize(void) {
+	return 0;
+}
+
+static void
+test_varint_finalize(void) {
+}
+
+DECLARE_TEST(varint, scalar) {
+	uint8_t buffer[VARINT_MAX_SIZE];
+	uint64_t values[] = { 0, 1, 127, 128, 300, 16383, 16384, 0xFFFFFFFFULL, 0x7FFFFFFFFFFFFFFFULL,
+	                      0xFFFFFFFFFFFFFFFFULL };
+	size_t sizes[] = { 1, 1, 1, 2, 2, 2, 3, 5, 9, 10 };
+	uint64_t value;
+	size_t ival;
+
+	for (ival = 0; ival < sizeof(values) / sizeof(values[0]); ++ival) {
+		EXPECT_SIZEEQ(varint_encode(values[ival], buffer), sizes[ival]);
+		EXPECT_SIZEEQ(varint_decode(buffer, sizeof(buffer), &value), sizes[ival]);
+		EXPECT_TYPEEQ(value, values[ival], uint64_t, PRIx64);
+		//Truncated input
+		EXPECT_SIZEEQ(varint_decode(buffer, sizes[ival] - 1, &value), 0);
+	}
+	varint_encode(300, buffer);
+	EXPECT_UINTEQ(buffer[0], 0xAC);
+	EXPECT_UINTEQ(buffer[1], 0x02);
+
+	//Overlong encoding
+	memset(buffer, 0xFF, sizeof(buffer));
+	EXPECT_SIZEEQ(varint_decode(buffer, sizeof(buffer), &value), 0);
+	buffer[9] = 0x02;
+	EXPECT_SIZEEQ(varint_decode(buffer, sizeof(buffer), &value), 0);
+
+	EXPECT_TYPEEQ(varint_zigzag(0), 0, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(varint_zigzag(-1), 1, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(varint_zigzag(1), 2, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(varint_zigzag(-2), 3, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(varint_zigzag(INT64_MIN), 0xFFFFFFFFFFFFFFFFULL, uint64_t, PRIx64);
+	EXPECT_TYPEEQ(varint_unzigzag(varint_zigzag(INT64_MIN)), INT64_MIN, int64_t, PRId64);
+	EXPECT_TYPEEQ(varint_unzigzag(varint_zigzag(INT64_MAX)), INT64_MAX, int64_t, PRId64);
+	EXPECT_TYPEEQ(varint_unzigzag(varint_zigzag(-12345)), -12345, int64_t, PRId64);
+
+	return 0;
+}
+
+DECLARE_TEST(varint, vbyte) {
+	uint32_t values[1031];
+	uint32_t decoded[1031];
+	uint8_t* buffer;
+	size_t count, ival, size;
+	int delta;
+
+	buffer = memory_allocate(0, vbyte_bound(1031), 0, MEMORY_PERSISTENT);
+
+	//Counts not a multiple of four and all value byte lengths
+	for (count = 0; count <= 1031; count += (count < 40) ? 1 : 331) {
+		for (delta = 0; delta < 2; ++delta) {
+			uint32_t previous = 0;
+			for (ival = 0; ival < count; ++ival) {
+				uint32_t bits = random32_range(0, 33);
+				uint32_t value = random32() & ((bits < 32) ? ((1U << bits) - 1) : 0xFFFFFFFFU);
+				values[ival] = delta ? previous + (value & 0x3FF) : value;
+				previous = values[ival];
+			}
+			size = vbyte_encode(values, count, delta != 0, buffer);
+			EXPECT_SIZELE(size, vbyte_bound(count));
+			memset(decoded, 0, sizeof(decoded));
+			EXPECT_SIZEEQ(vbyte_decode(buffer, size, decoded, count, delta != 0), size);
+			EXPECT_EQ(memcmp(decoded, values, sizeof(uint32_t) * count), 0);
+			if (count)
+				EXPECT_SIZEEQ(vbyte_decode(buffer, size - 1, decoded, count, delta != 0), 0);
+		}
+	}
+
+	//Sorted small deltas take one byte per value
+	for (ival = 0; ival < 1024; ++ival)
+		values[ival] = 1000000000U + (uint32_t)(ival * 17);
+	size = vbyte_encode(values, 1024, true, buffer);
+	EXPECT_SIZEEQ(size, 256 + 4 + 1023);
+
+	memory_deallocate(buffer);
+
+	return 0;
+}
+
+#define VBYTE_BOUND_TEST (25 + 400)
+
+static void
+test_varint_separate(stream_t* stream) {
+	if (!stream_is_binary(stream))
+		stream_write_endl(stream);
+}
+
+DECLARE_TEST(varint, stream) {
+	stream_t* stream;
+	uint32_t values[100];
+	uint32_t decoded[100];
+	uint8_t buffer[VBYTE_BOUND_TEST];
+	size_t ival, delta_size, plain_size;
+	int ipass;
+
+	for (ival = 0; ival < 100; ++ival)
+		values[ival] = (uint32_t)(ival * ival * 31);
+	delta_size = vbyte_encode(values, 100, true, buffer);
+	plain_size = vbyte_encode(values, 100, false, buffer);
+
+	for (ipass = 0; ipass < 2; ++ipass) {
+		unsigned int mode = STREAM_IN | STREAM_OUT | (ipass ? 0 : STREAM_BINARY);
+		stream = buffer_stream_allocate(0, mode, 0, 0, true, true);
+		stream_write_varint(stream, 127);
+		test_varint_separate(stream);
+		stream_write_varint(stream, 0xFFFFFFFFFFFFFFFFULL);
+		test_varint_separate(stream);
+		stream_write_varint_signed(stream, -3);
+		test_varint_separate(stream);
+		stream_write_varint_signed(stream, INT64_MIN);
+		test_varint_separate(stream);
+		stream_write_vbyte(stream, values, 100, true);
+		test_varint_separate(stream);
+		stream_write_vbyte(stream, values, 100, false);
+		test_varint_separate(stream);
+		stream_write_vbyte(stream, values, 0, false);
+		test_varint_separate(stream);
+		stream_write_varint(stream, 42);
+		if (!ipass)
+			EXPECT_SIZEEQ(stream_size(stream), 1 + 10 + 1 + 10 + 1 + delta_size + 1 + plain_size + 1 + 1);
+
+		stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+		EXPECT_TYPEEQ(stream_read_varint(stream), 127, uint64_t, PRIu64);
+		EXPECT_TYPEEQ(stream_read_varint(stream), 0xFFFFFFFFFFFFFFFFULL, uint64_t, PRIx64);
+		EXPECT_TYPEEQ(stream_read_varint_signed(stream), -3, int64_t, PRId64);
+		EXPECT_TYPEEQ(stream_read_varint_signed(stream), INT64_MIN, int64_t, PRId64);
+		memset(decoded, 0, sizeof(decoded));
+		EXPECT_SIZEEQ(stream_read_vbyte(stream, decoded, 100, true), 100);
+		EXPECT_EQ(memcmp(decoded, values, sizeof(values)), 0);
+		memset(decoded, 0, sizeof(decoded));
+		EXPECT_SIZEEQ(stream_read_vbyte(stream, decoded, 10, false), 100);
+		EXPECT_EQ(memcmp(decoded, values, sizeof(uint32_t) * 10), 0);
+		EXPECT_UINTEQ(decoded[10], 0);
+		EXPECT_SIZEEQ(stream_read_vbyte(stream, decoded, 100, false), 0);
+		EXPECT_TYPEEQ(stream_read_varint(stream), 42, uint64_t, PRIu64);
+		stream_deallocate(stream);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(varint, bitbuffer) {
+	uint32_t buffer[64];
+	bitbuffer_t bitbuffer;
+
+	bitbuffer_initialize_buffer(&bitbuffer, buffer, sizeof(buffer), false);
+	bitbuffer_write32(&bitbuffer, 5, 3);
+	bitbuffer_write_varint(&bitbuffer, 0);
+	bitbuffer_write_varint(&bitbuffer, 300);
+	bitbuffer_write_varint(&bitbuffer, 0xFFFFFFFFFFFFFFFFULL);
+	bitbuffer_write_varint_signed(&bitbuffer, -64);
+	bitbuffer_write_varint_signed(&bitbuffer, INT64_MIN);
+	EXPECT_TYPEEQ(bitbuffer.count_write, 3 + 8 + 16 + 80 + 8 + 80, uint64_t, PRIu64);
+	bitbuffer_align_write(&bitbuffer, false);
+
+	bitbuffer_initialize_buffer(&bitbuffer, buffer, sizeof(buffer), false);
+	EXPECT_UINTEQ(bitbuffer_read32(&bitbuffer, 3), 5);
+	EXPECT_TYPEEQ(bitbuffer_read_varint(&bitbuffer), 0, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(bitbuffer_read_varint(&bitbuffer), 300, uint64_t, PRIu64);
+	EXPECT_TYPEEQ(bitbuffer_read_varint(&bitbuffer), 0xFFFFFFFFFFFFFFFFULL, uint64_t, PRIx64);
+	EXPECT_TYPEEQ(bitbuffer_read_varint_signed(&bitbuffer), -64, int64_t, PRId64);
+	EXPECT_TYPEEQ(bitbuffer_read_varint_signed(&bitbuffer), INT64_MIN, int64_t, PRId64);
+
+	return 0;
+}
+
+static void
+test_varint_declare(void) {
+	ADD_TEST(varint, scalar);
+	ADD_TEST(varint, vbyte);
+	ADD_TEST(varint, stream);
+	ADD_TEST(varint, bitbuffer);
+}
+
+static test_suite_t test_varint_suite = {
+	test_varint_application,
+	test_varint_memory_system,
+	test_varint_config,
+	test_varint_declare,
+	test_varint_initialize,
+	test_varint_finalize
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_varint_run(void);
+
+int
+test_varint_run(void) {
+	test_suite = test_varint_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_varint_suite;
+}
+
+#endif
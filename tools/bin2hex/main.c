@@ -14,21 +14,39 @@
 
 #include "errorcodes.h"
 
+//Input is read and output formatted in blocks of this size
+#define BIN2HEX_BLOCK_SIZE 65536
+
+typedef enum {
+	//Comma separated byte literals, 0x00, 0x01, ...
+	BIN2HEX_FORMAT_BYTES = 0,
+	//Comma separated 64-bit little endian word literals, 0x0706050403020100ULL, ...
+	BIN2HEX_FORMAT_WORDS,
+	//Concatenated string literals with octal escapes, "\000\001..."
+	BIN2HEX_FORMAT_STRING,
+	//Assembler .incbin directive in a named read-only data symbol
+	BIN2HEX_FORMAT_INCBIN
+} bin2hex_format_t;
+
 typedef struct {
-	string_t*    input_files;
-	string_t*    output_files;
-	size_t       columns;
-	bool         display_help;
+	string_t*         input_files;
+	string_t*         output_files;
+	size_t            columns;
+	bin2hex_format_t  format;
+	bool              display_help;
 } bin2hex_input_t;
 
 static bin2hex_input_t
 bin2hex_parse_command_line(const string_const_t* cmdline);
 
 static int
-bin2hex_process_files(string_t* input, string_t* output, size_t columns);
+bin2hex_process_files(string_t* input, string_t* output, size_t columns, bin2hex_format_t format);
+
+static int
+bin2hex_process_file(stream_t* input, stream_t* output, size_t columns, bin2hex_format_t format);
 
 static int
-bin2hex_process_file(stream_t* input, stream_t* output, size_t columns);
+bin2hex_process_incbin(string_t input_filename, stream_t* output);
 
 static void
 bin2hex_print_usage(void);
@@ -67,7 +85,8 @@ main_run(void* main_arg) {
 	if (input.display_help)
 		bin2hex_print_usage();
 	else {
-		result = bin2hex_process_files(input.input_files, input.output_files, input.columns);
+		result = bin2hex_process_files(input.input_files, input.output_files, input.columns,
+		                               input.format);
 		if (result < 0)
 			goto exit;
 	}
@@ -103,6 +122,24 @@ bin2hex_parse_command_line(const string_const_t* cmdline) {
 				input.columns = string_to_uint(cmdline[arg].str, cmdline[arg].length, false);
 			}
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--format"))) {
+			if (arg < (asize - 1)) {
+				++arg;
+				if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("bytes")))
+					input.format = BIN2HEX_FORMAT_BYTES;
+				else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("words")))
+					input.format = BIN2HEX_FORMAT_WORDS;
+				else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("string")))
+					input.format = BIN2HEX_FORMAT_STRING;
+				else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("incbin")))
+					input.format = BIN2HEX_FORMAT_INCBIN;
+				else {
+					log_warnf(0, WARNING_INVALID_VALUE, STRING_CONST("Unknown output format: %.*s"),
+					          STRING_FORMAT(cmdline[arg]));
+					input.display_help = true;
+				}
+			}
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--debug"))) {
 			log_set_suppress(0, ERRORLEVEL_NONE);
 		}
@@ -125,7 +162,7 @@ bin2hex_parse_command_line(const string_const_t* cmdline) {
 }
 
 int
-bin2hex_process_files(string_t* input, string_t* output, size_t columns) {
+bin2hex_process_files(string_t* input, string_t* output, size_t columns, bin2hex_format_t format) {
 	int result = BIN2HEX_RESULT_OK;
 	size_t ifile, files_size;
 	for (ifile = 0, files_size = array_size(input); (result == BIN2HEX_RESULT_OK) &&
@@ -156,7 +193,8 @@ bin2hex_process_files(string_t* input, string_t* output, size_t columns) {
 			result = BIN2HEX_RESULT_MISSING_INPUT_FILE;
 		}
 		else {
-			output_file = stream_open(STRING_ARGS(output_filename), STREAM_OUT);
+			output_file = stream_open(STRING_ARGS(output_filename),
+			                          STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
 			if (!output_file) {
 				log_warnf(0, WARNING_INVALID_VALUE, STRING_CONST("Unable to open output file: %.*s"),
 				          STRING_FORMAT(output_filename));
@@ -164,8 +202,12 @@ bin2hex_process_files(string_t* input, string_t* output, size_t columns) {
 			}
 		}
 
-		if (input_file && output_file)
-			result = bin2hex_process_file(input_file, output_file, columns);
+		if (input_file && output_file) {
+			if (format == BIN2HEX_FORMAT_INCBIN)
+				result = bin2hex_process_incbin(input_filename, output_file);
+			else
+				result = bin2hex_process_file(input_file, output_file, columns, format);
+		}
 
 		stream_deallocate(input_file);
 		stream_deallocate(output_file);
@@ -182,25 +224,164 @@ bin2hex_process_files(string_t* input, string_t* output, size_t columns) {
 	return result;
 }
 
+static const char bin2hex_digits[] = "0123456789abcdef";
+
+static char*
+bin2hex_format_byte(char* dest, uint8_t byte) {
+	dest[0] = '0';
+	dest[1] = 'x';
+	dest[2] = bin2hex_digits[byte >> 4];
+	dest[3] = bin2hex_digits[byte & 0xF];
+	dest[4] = ',';
+	dest[5] = ' ';
+	return dest + 6;
+}
+
+//Missing bytes of a final partial word are zero
+static char*
+bin2hex_format_word(char* dest, const uint8_t* bytes, size_t count) {
+	uint8_t word[8];
+	size_t ibyte;
+	for (ibyte = 0; ibyte < 8; ++ibyte)
+		word[ibyte] = ((7 - ibyte) < count) ? bytes[7 - ibyte] : 0;
+	dest[0] = '0';
+	dest[1] = 'x';
+	string_hex_encode(dest + 2, 16, word, sizeof(word), false);
+	memcpy(dest + 18, "ULL, ", 5);
+	return dest + 23;
+}
+
+//Three digit octal escapes cannot run into following characters like hex escapes can, and
+//question marks are escaped to avoid trigraphs
+static char*
+bin2hex_format_char(char* dest, uint8_t byte) {
+	if ((byte >= 0x20) && (byte < 0x7F) && (byte != '"') && (byte != '\\') && (byte != '?')) {
+		*dest++ = (char)byte;
+		return dest;
+	}
+	dest[0] = '\\';
+	dest[1] = (char)('0' + (byte >> 6));
+	dest[2] = (char)('0' + ((byte >> 3) & 7));
+	dest[3] = (char)('0' + (byte & 7));
+	return dest + 4;
+}
+
 int
-bin2hex_process_file(stream_t* input, stream_t* output, size_t columns) {
-	uint8_t block[512];
-	size_t read, byte;
+bin2hex_process_file(stream_t* input, stream_t* output, size_t columns, bin2hex_format_t format) {
+	uint8_t* block;
+	char* text;
+	size_t read, offset, byte, rows;
 
 	if (!columns)
 		columns = 32;
 	if (columns > 512)
 		columns = 512;
+	if (format == BIN2HEX_FORMAT_WORDS)
+		columns = (columns + 7) & ~(size_t)7;
+
+	//Read whole rows per block, worst case row length is a four character escape per byte
+	rows = BIN2HEX_BLOCK_SIZE / columns;
+	block = memory_allocate(0, rows * columns, 0, MEMORY_PERSISTENT);
+	text = memory_allocate(0, rows * (columns * 6 + 4), 0, MEMORY_PERSISTENT);
 
 	while (!stream_eos(input)) {
-		read = stream_read(input, block, columns);
+		char* dest = text;
+		read = stream_read(input, block, rows * columns);
 		if (!read)
 			break;
 
-		for (byte = 0; byte < read; ++byte)
-			stream_write_format(output, STRING_CONST("0x%02x, "), (unsigned int)block[byte]);
-		stream_write_endl(output);
+		for (offset = 0; offset < read; offset += columns) {
+			size_t row = ((read - offset) < columns) ? (read - offset) : columns;
+			const uint8_t* src = block + offset;
+			if (format == BIN2HEX_FORMAT_WORDS) {
+				for (byte = 0; byte < row; byte += 8)
+					dest = bin2hex_format_word(dest, src + byte, row - byte);
+			}
+			else if (format == BIN2HEX_FORMAT_STRING) {
+				*dest++ = '"';
+				for (byte = 0; byte < row; ++byte)
+					dest = bin2hex_format_char(dest, src[byte]);
+				*dest++ = '"';
+			}
+			else {
+				for (byte = 0; byte < row; ++byte)
+					dest = bin2hex_format_byte(dest, src[byte]);
+			}
+			*dest++ = '\n';
+		}
+
+		stream_write(output, text, (size_t)(dest - text));
 	}
+
+	memory_deallocate(text);
+	memory_deallocate(block);
+
+	return BIN2HEX_RESULT_OK;
+}
+
+//The assembler reads the file directly, the compiler only parses the directive. The path is
+//made absolute since the assembler resolves it from the working directory of the build.
+int
+bin2hex_process_incbin(string_t input_filename, stream_t* output) {
+	char symbol_buffer[128];
+	string_t symbol;
+	string_t path;
+	string_const_t file_name = path_file_name(STRING_ARGS(input_filename));
+	size_t ichar;
+
+	symbol = string_copy(symbol_buffer, sizeof(symbol_buffer), STRING_CONST("bin2hex_"));
+	symbol = string_append(STRING_ARGS(symbol), sizeof(symbol_buffer), STRING_ARGS(file_name));
+	for (ichar = 0; ichar < symbol.length; ++ichar) {
+		char c = symbol.str[ichar];
+		if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))))
+			symbol.str[ichar] = '_';
+	}
+
+	path = path_allocate_absolute(STRING_ARGS(input_filename));
+
+	stream_write_format(output, STRING_CONST(
+	                        "/* Embedded %.*s, symbols %.*s and %.*s_end delimit the data */\n\n"
+	                        "#if defined(_MSC_VER) && !defined(__clang__)\n"
+	                        "#  error bin2hex incbin output requires a GCC compatible compiler\n"
+	                        "#endif\n\n"
+	                        "#ifndef BIN2HEX_INCBIN_SECTION\n"
+	                        "#  if defined(__APPLE__) || (defined(_WIN32) && !defined(_WIN64))\n"
+	                        "#    define BIN2HEX_INCBIN_SYMBOL(name) \"_\" #name\n"
+	                        "#  else\n"
+	                        "#    define BIN2HEX_INCBIN_SYMBOL(name) #name\n"
+	                        "#  endif\n"
+	                        "#  if defined(__APPLE__)\n"
+	                        "#    define BIN2HEX_INCBIN_SECTION \".const_data\\n\"\n"
+	                        "#  elif defined(_WIN32)\n"
+	                        "#    define BIN2HEX_INCBIN_SECTION \".section .rdata,\\\"dr\\\"\\n\"\n"
+	                        "#  else\n"
+	                        "#    define BIN2HEX_INCBIN_SECTION \".section .rodata\\n\"\n"
+	                        "#  endif\n"
+	                        "#endif\n\n"
+	                        "__asm__(BIN2HEX_INCBIN_SECTION\n"
+	                        "        \".balign 16\\n\"\n"
+	                        "        \".globl \" BIN2HEX_INCBIN_SYMBOL(%.*s) \"\\n\"\n"
+	                        "        BIN2HEX_INCBIN_SYMBOL(%.*s) \":\\n\"\n"
+	                        "        \".incbin \\\"%.*s\\\"\\n\"\n"
+	                        "        \".globl \" BIN2HEX_INCBIN_SYMBOL(%.*s_end) \"\\n\"\n"
+	                        "        BIN2HEX_INCBIN_SYMBOL(%.*s_end) \":\\n\"\n"
+	                        "        \".byte 0\\n\"\n"
+	                        "        \".text\\n\");\n\n"
+	                        "#ifdef __cplusplus\n"
+	                        "extern \"C\" {\n"
+	                        "#endif\n"
+	                        "extern const unsigned char %.*s[];\n"
+	                        "extern const unsigned char %.*s_end[];\n"
+	                        "#ifdef __cplusplus\n"
+	                        "}\n"
+	                        "#endif\n"),
+	                    STRING_FORMAT(file_name), STRING_FORMAT(symbol), STRING_FORMAT(symbol),
+	                    STRING_FORMAT(symbol), STRING_FORMAT(symbol), STRING_FORMAT(path),
+	                    STRING_FORMAT(symbol), STRING_FORMAT(symbol), STRING_FORMAT(symbol),
+	                    STRING_FORMAT(symbol));
+
+	string_deallocate(path.str);
+
 	return BIN2HEX_RESULT_OK;
 }
 
@@ -210,11 +391,21 @@ bin2hex_print_usage(void) {
 	log_set_suppress(0, ERRORLEVEL_DEBUG);
 	log_info(0, STRING_CONST(
 	           "bin2hex usage:\n"
-	           "  bin2hex [--columns n] [--debug] [--help] <file> <file> <file> <...> [--]\n"
+	           "  bin2hex [--columns n] [--format f] [--debug] [--help] <file> <file> <file> <...> [--]\n"
 	           "    Required arguments:\n"
 	           "      <file>                       Input filename (any number of input files allowed). Output will be named \"<file>.hex\"\n"
 	           "    Optional arguments:\n"
 	           "      --columns n                  Print n bytes in each column (default is 32)\n"
+	           "      --format f                   Output format, one of\n"
+	           "                                     bytes   Byte literals, 0x00, 0x01, ... (default)\n"
+	           "                                     words   64-bit word literals in little endian byte order,\n"
+	           "                                             0x0706050403020100ULL, ... for uint64_t arrays,\n"
+	           "                                             the last word is zero padded\n"
+	           "                                     string  Concatenated string literals with octal escapes, the\n"
+	           "                                             data size is the literal size minus the terminator\n"
+	           "                                     incbin  Assembler .incbin of the file in a read-only data\n"
+	           "                                             symbol bin2hex_<file> and end symbol bin2hex_<file>_end,\n"
+	           "                                             for GCC and Clang\n"
 	           "      --debug                      Enable debug output\n"
 	           "      --help                       Display this help message\n"
 	           "      --                           Stop processing command line arguments"
@@ -23,3 +23,4 @@
 #define HASHIFY_RESULT_STRING_COLLISION            -8
 #define HASHIFY_RESULT_EXTRA_STRING                -9
 #define HASHIFY_RESULT_OUTPUT_FILE_WRITE_FAIL      -10
+#define HASHIFY_RESULT_TABLE_FAIL                  -11
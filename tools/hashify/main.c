@@ -18,8 +18,14 @@
 #define HASHIFY_LINEBUFFER_LENGTH           512
 #define HASHIFY_STRING_LENGTH               128
 
+//Average number of strings per bucket in perfect hash tables, and limit of displacement seeds
+//tried per bucket before giving up
+#define HASHIFY_TABLE_BUCKET_LOAD           4
+#define HASHIFY_TABLE_SEED_LIMIT            (1U << 24)
+
 typedef struct {
 	bool         check_only;
+	bool         table;
 	string_t*    strings;
 	string_t*    files;
 } hashify_input_t;
@@ -28,6 +34,8 @@ typedef struct {
 	char         buffer[HASHIFY_STRING_LENGTH];
 	string_t     string;
 	hash_t       hash;
+	char         define_buffer[HASHIFY_STRING_LENGTH];
+	string_t     define;
 } hashify_string_t;
 
 static hashify_input_t
@@ -40,15 +48,26 @@ static int
 hashify_process_strings(string_t* strings);
 
 static int
-hashify_process_files(string_t* files, bool check_only);
+hashify_process_files(string_t* files, bool check_only, bool table);
 
 static int
 hashify_process_file(stream_t* input_file, stream_t* output_file, string_t output_filename,
-                     bool check_only, hashify_string_t** history);
+                     bool check_only, hashify_string_t** history, hashify_string_t** generated);
+
+static int
+hashify_process_table(const hashify_string_t* generated, string_const_t base_filename,
+                      bool check_only);
+
+static int
+hashify_generate_table(stream_t* output_file, string_const_t table_name,
+                       const hashify_string_t* generated);
 
 static int
 hashify_generate_preamble(stream_t* output_file, string_t output_filename);
 
+static void
+hashify_push_string(hashify_string_t** strings, const hashify_string_t* string);
+
 static int
 hashify_read_hashes(stream_t* file, hashify_string_t** hashes);
 
@@ -101,7 +120,7 @@ main_run(void* main_arg) {
 	if (result < 0)
 		goto exit;
 
-	result = hashify_process_files(input.files, input.check_only);
+	result = hashify_process_files(input.files, input.check_only, input.table);
 	if (result < 0)
 		goto exit;
 
@@ -136,6 +155,10 @@ hashify_parse_command_line(const string_const_t* cmdline) {
 			input.check_only = true;
 			continue;
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--table"))) {
+			input.table = true;
+			continue;
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--generate-string"))) {
 			if (arg < asize - 1) {
 				++arg;
@@ -174,9 +197,10 @@ hashify_process_strings(string_t* strings) {
 }
 
 int
-hashify_process_files(string_t* files, bool check_only) {
+hashify_process_files(string_t* files, bool check_only, bool table) {
 	int result = HASHIFY_RESULT_OK;
 	hashify_string_t* history = 0;
+	hashify_string_t* generated = 0;
 	size_t ifile, files_size;
 	for (ifile = 0, files_size = array_size(files); (result == HASHIFY_RESULT_OK) &&
 	        (ifile < files_size); ++ifile) {
@@ -219,10 +243,14 @@ hashify_process_files(string_t* files, bool check_only) {
 		}
 
 		if (input_file && output_file) {
-			result = hashify_process_file(input_file, output_file, output_filename, check_only, &history);
+			result = hashify_process_file(input_file, output_file, output_filename, check_only, &history,
+			                              &generated);
 			if ((result == HASHIFY_RESULT_OK) && !check_only)
 				result = hashify_write_file(output_file, output_filename);
+			if ((result == HASHIFY_RESULT_OK) && table)
+				result = hashify_process_table(generated, base_filename, check_only);
 		}
+		array_clear(generated);
 
 		stream_deallocate(input_file);
 		stream_deallocate(output_file);
@@ -241,17 +269,17 @@ hashify_process_files(string_t* files, bool check_only) {
 	}
 
 	array_deallocate(history);
+	array_deallocate(generated);
 
 	return result;
 }
 
 int
 hashify_process_file(stream_t* input_file, stream_t* output_file, string_t output_filename,
-                     bool check_only, hashify_string_t** history) {
+                     bool check_only, hashify_string_t** history, hashify_string_t** generated) {
 	int result = HASHIFY_RESULT_OK;
 	char line_buffer[HASHIFY_LINEBUFFER_LENGTH];
 	hashify_string_t* local_hashes = 0;
-	hashify_string_t* local_generated = 0;
 
 	if (check_only)
 		result = hashify_read_hashes(output_file, &local_hashes);
@@ -302,23 +330,261 @@ hashify_process_file(stream_t* input_file, stream_t* output_file, string_t outpu
 				hash_string.string = string_copy(hash_string.buffer, HASHIFY_STRING_LENGTH,
 				                                 STRING_ARGS(value_string));
 				hash_string.hash = hash_value;
-				array_push_memcpy(*history, &hash_string);
-				array_push_memcpy(local_generated, &hash_string);
+				hash_string.define = string_copy(hash_string.define_buffer, HASHIFY_STRING_LENGTH,
+				                                 STRING_ARGS(def_string));
+				hashify_push_string(history, &hash_string);
+				hashify_push_string(generated, &hash_string);
 			}
 		}
 	}
 
-	if (check_only) {
+	if (check_only && (result == HASHIFY_RESULT_OK)) {
 		//Check local consistency
-		result = hashify_check_match(local_hashes, local_generated);
+		result = hashify_check_match(local_hashes, *generated);
 	}
 
 	array_deallocate(local_hashes);
-	array_deallocate(local_generated);
 
 	return result;
 }
 
+int
+hashify_process_table(const hashify_string_t* generated, string_const_t base_filename,
+                      bool check_only) {
+	int result = HASHIFY_RESULT_OK;
+	string_t table_filename;
+	string_const_t table_name;
+	stream_t* table_file;
+
+	table_filename = string_allocate_format(STRING_CONST("%.*s_table.h"), STRING_FORMAT(base_filename));
+	table_name = path_base_file_name(STRING_ARGS(table_filename));
+
+	log_infof(0, STRING_CONST("Generating perfect hash table %.*s"), STRING_FORMAT(table_filename));
+
+	table_file = buffer_stream_allocate(memory_allocate(0, 65536, 0, MEMORY_PERSISTENT),
+	                                    STREAM_IN | STREAM_OUT, 0, 65536, true, true);
+	result = hashify_generate_preamble(table_file, table_filename);
+	if (result == HASHIFY_RESULT_OK)
+		result = hashify_generate_table(table_file, table_name, generated);
+
+	if ((result == HASHIFY_RESULT_OK) && check_only) {
+		//Table is fully determined by the input strings, compare against a freshly generated table
+		stream_t* prev_file = stream_open(STRING_ARGS(table_filename), STREAM_IN);
+		if (!prev_file) {
+			log_warnf(0, WARNING_INVALID_VALUE, STRING_CONST("Unable to open output file: %.*s"),
+			          STRING_FORMAT(table_filename));
+			result = HASHIFY_RESULT_MISSING_OUTPUT_FILE;
+		}
+		else if (!uint128_equal(stream_md5(table_file), stream_md5(prev_file))) {
+			log_errorf(0, ERROR_INVALID_VALUE, STRING_CONST("  hash table file is out of date: %.*s"),
+			           STRING_FORMAT(table_filename));
+			result = HASHIFY_RESULT_OUTPUT_FILE_OUT_OF_DATE;
+		}
+		stream_deallocate(prev_file);
+	}
+	else if (result == HASHIFY_RESULT_OK) {
+		result = hashify_write_file(table_file, table_filename);
+	}
+
+	stream_deallocate(table_file);
+	string_deallocate(table_filename.str);
+
+	return result;
+}
+
+//Must match the mixing in the generated table lookup function
+static uint64_t
+hashify_table_mix(hash_t value, uint32_t seed) {
+	uint64_t mixed = value ^ ((uint64_t)seed * 0x9e3779b97f4a7c15ULL);
+	mixed = (mixed ^ (mixed >> 33)) * 0xff51afd7ed558ccdULL;
+	return mixed ^ (mixed >> 33);
+}
+
+//Compress, hash and displace: strings are grouped in buckets by the high bits of the hash, then
+//buckets are placed largest first by searching for a seed mapping all strings in the bucket to
+//free slots. Lookups mix the hash with the seed of its bucket to get the slot directly.
+static bool
+hashify_build_table(const hashify_string_t* generated, size_t count, size_t num_buckets,
+                    uint32_t* seeds, size_t* slots) {
+	size_t* bucket_order = memory_allocate(0, sizeof(size_t) * num_buckets, 0, MEMORY_TEMPORARY);
+	size_t* bucket_size = memory_allocate(0, sizeof(size_t) * num_buckets, 0,
+	                                      MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	size_t* string_slot = memory_allocate(0, sizeof(size_t) * count, 0, MEMORY_TEMPORARY);
+	bool* occupied = memory_allocate(0, sizeof(bool) * count, 0,
+	                                 MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	size_t istr, ibucket, iorder;
+	bool success = true;
+
+	for (istr = 0; istr < count; ++istr)
+		++bucket_size[(size_t)((generated[istr].hash >> 32) % num_buckets)];
+
+	//Stable insertion sort by descending bucket size keeps the output deterministic
+	for (ibucket = 0; ibucket < num_buckets; ++ibucket) {
+		for (iorder = ibucket; iorder && (bucket_size[bucket_order[iorder - 1]] < bucket_size[ibucket]);
+		        --iorder)
+			bucket_order[iorder] = bucket_order[iorder - 1];
+		bucket_order[iorder] = ibucket;
+	}
+
+	memset(seeds, 0, sizeof(uint32_t) * num_buckets);
+	for (iorder = 0; success && (iorder < num_buckets); ++iorder) {
+		uint32_t seed;
+		size_t bucket = bucket_order[iorder];
+		if (!bucket_size[bucket])
+			break;
+		for (seed = 0; seed < HASHIFY_TABLE_SEED_LIMIT; ++seed) {
+			size_t placed = 0;
+			for (istr = 0; istr < count; ++istr) {
+				size_t slot, iprev;
+				if ((size_t)((generated[istr].hash >> 32) % num_buckets) != bucket)
+					continue;
+				slot = (size_t)(hashify_table_mix(generated[istr].hash, seed) % count);
+				if (occupied[slot])
+					break;
+				for (iprev = 0; (iprev < placed) && (string_slot[iprev] != slot); ++iprev) {
+				}
+				if (iprev < placed)
+					break;
+				string_slot[placed++] = slot;
+			}
+			if (istr == count)
+				break;
+		}
+		if (seed == HASHIFY_TABLE_SEED_LIMIT) {
+			success = false;
+			break;
+		}
+		seeds[bucket] = seed;
+		for (istr = 0; istr < count; ++istr) {
+			if ((size_t)((generated[istr].hash >> 32) % num_buckets) == bucket) {
+				size_t slot = (size_t)(hashify_table_mix(generated[istr].hash, seed) % count);
+				occupied[slot] = true;
+				slots[istr] = slot;
+			}
+		}
+	}
+
+	memory_deallocate(occupied);
+	memory_deallocate(string_slot);
+	memory_deallocate(bucket_size);
+	memory_deallocate(bucket_order);
+
+	return success;
+}
+
+int
+hashify_generate_table(stream_t* output_file, string_const_t table_name,
+                       const hashify_string_t* generated) {
+	char name_buffer[HASHIFY_STRING_LENGTH];
+	char upper_buffer[HASHIFY_STRING_LENGTH];
+	string_t name, upper;
+	size_t count = array_size(generated);
+	size_t num_buckets = (count + HASHIFY_TABLE_BUCKET_LOAD - 1) / HASHIFY_TABLE_BUCKET_LOAD;
+	size_t* slots;
+	size_t* slot_string;
+	uint32_t* seeds;
+	size_t istr, ibucket, ichar;
+
+	if (!count) {
+		log_warn(0, WARNING_INVALID_VALUE, STRING_CONST("  no strings to generate hash table from"));
+		return HASHIFY_RESULT_MISSING_INPUT_FILE;
+	}
+
+	//Identifier prefix from file name, for example hashstrings_table and HASHSTRINGS_TABLE
+	name = string_copy(name_buffer, sizeof(name_buffer), STRING_ARGS(table_name));
+	for (ichar = 0; ichar < name.length; ++ichar) {
+		char c = name.str[ichar];
+		if (!(((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))))
+			name.str[ichar] = '_';
+	}
+	upper = string_copy(upper_buffer, sizeof(upper_buffer), STRING_ARGS(name));
+	for (ichar = 0; ichar < upper.length; ++ichar) {
+		if ((upper.str[ichar] >= 'a') && (upper.str[ichar] <= 'z'))
+			upper.str[ichar] = (char)(upper.str[ichar] - ('a' - 'A'));
+	}
+
+	seeds = memory_allocate(0, sizeof(uint32_t) * num_buckets, 0, MEMORY_PERSISTENT);
+	slots = memory_allocate(0, sizeof(size_t) * count, 0, MEMORY_PERSISTENT);
+	slot_string = memory_allocate(0, sizeof(size_t) * count, 0, MEMORY_PERSISTENT);
+	if (!hashify_build_table(generated, count, num_buckets, seeds, slots)) {
+		log_errorf(0, ERROR_INVALID_VALUE,
+		           STRING_CONST("  unable to build perfect hash table for %" PRIsize " strings"), count);
+		memory_deallocate(slot_string);
+		memory_deallocate(slots);
+		memory_deallocate(seeds);
+		return HASHIFY_RESULT_TABLE_FAIL;
+	}
+	for (istr = 0; istr < count; ++istr)
+		slot_string[slots[istr]] = istr;
+
+	stream_write_format(output_file, STRING_CONST(
+	                        "#include <foundation/string.h>\n\n"
+	                        "/* Minimal perfect hash table of the %" PRIsize " static hash strings, mapping each hash\n"
+	                        "   to a dense index in [0, %.*s_SIZE) and back to the string */\n\n"
+	                        "#define %.*s_SIZE %" PRIsize "\n"
+	                        "#define %.*s_BUCKETS %" PRIsize "\n\n"),
+	                    count, STRING_FORMAT(upper), STRING_FORMAT(upper), count, STRING_FORMAT(upper),
+	                    num_buckets);
+
+	for (istr = 0; istr < count; ++istr) {
+		stream_write_format(output_file, STRING_CONST("#define %.*s_INDEX %" PRIsize "\n"),
+		                    (int)generated[istr].define.length, generated[istr].define_buffer, slots[istr]);
+	}
+
+	stream_write_format(output_file, STRING_CONST("\nstatic const uint32_t %.*s_seed[%.*s_BUCKETS] = {"),
+	                    STRING_FORMAT(name), STRING_FORMAT(upper));
+	for (ibucket = 0; ibucket < num_buckets; ++ibucket)
+		stream_write_format(output_file, STRING_CONST("%s%s%u"), ibucket ? "," : "",
+		                    (ibucket % 8) ? " " : "\n\t", seeds[ibucket]);
+	stream_write_format(output_file, STRING_CONST("\n};\n\nstatic const hash_t %.*s_hash[%.*s_SIZE] = {"),
+	                    STRING_FORMAT(name), STRING_FORMAT(upper));
+	for (istr = 0; istr < count; ++istr)
+		stream_write_format(output_file, STRING_CONST("%s\n\t0x%016" PRIx64 "ULL"), istr ? "," : "",
+		                    generated[slot_string[istr]].hash);
+	stream_write_format(output_file,
+	                    STRING_CONST("\n};\n\nstatic const string_const_t %.*s_string[%.*s_SIZE] = {"),
+	                    STRING_FORMAT(name), STRING_FORMAT(upper));
+	for (istr = 0; istr < count; ++istr) {
+		const hashify_string_t* str = generated + slot_string[istr];
+		stream_write_format(output_file, STRING_CONST("%s\n\t{ \"%.*s\", %" PRIsize " }"), istr ? "," : "",
+		                    (int)str->string.length, str->buffer, str->string.length);
+	}
+
+	stream_write_format(output_file, STRING_CONST(
+	                        "\n};\n\n"
+	                        "/* Get dense index of a hash value in the table\n"
+	                        "   \\param value Hash value\n"
+	                        "   \\return Index of hash value, %.*s_SIZE if not in table */\n"
+	                        "static FOUNDATION_FORCEINLINE size_t\n"
+	                        "%.*s_index(hash_t value) {\n"
+	                        "\tuint64_t seed = %.*s_seed[(value >> 32) %% %.*s_BUCKETS];\n"
+	                        "\tuint64_t mixed = value ^ (seed * 0x9e3779b97f4a7c15ULL);\n"
+	                        "\tsize_t index;\n"
+	                        "\tmixed = (mixed ^ (mixed >> 33)) * 0xff51afd7ed558ccdULL;\n"
+	                        "\tindex = (size_t)((mixed ^ (mixed >> 33)) %% %.*s_SIZE);\n"
+	                        "\treturn (%.*s_hash[index] == value) ? index : %.*s_SIZE;\n"
+	                        "}\n\n"
+	                        "/* Reverse lookup of a hash value in the table\n"
+	                        "   \\param value Hash value\n"
+	                        "   \\return String matching hash value, empty string if not in table */\n"
+	                        "static FOUNDATION_FORCEINLINE string_const_t\n"
+	                        "%.*s_lookup(hash_t value) {\n"
+	                        "\tsize_t index = %.*s_index(value);\n"
+	                        "\tif (index < %.*s_SIZE)\n"
+	                        "\t\treturn %.*s_string[index];\n"
+	                        "\treturn string_null();\n"
+	                        "}\n"),
+	                    STRING_FORMAT(upper), STRING_FORMAT(name), STRING_FORMAT(name), STRING_FORMAT(upper),
+	                    STRING_FORMAT(upper), STRING_FORMAT(name), STRING_FORMAT(upper), STRING_FORMAT(name),
+	                    STRING_FORMAT(name), STRING_FORMAT(upper), STRING_FORMAT(name));
+
+	memory_deallocate(slot_string);
+	memory_deallocate(slots);
+	memory_deallocate(seeds);
+
+	return HASHIFY_RESULT_OK;
+}
+
 int
 hashify_generate_preamble(stream_t* output_file, string_t output_filename) {
 	//Read and preserve everything before #pragma once in case it contains header comments to be preserved
@@ -367,6 +633,18 @@ hashify_generate_preamble(stream_t* output_file, string_t output_filename) {
 	return 0;
 }
 
+void
+hashify_push_string(hashify_string_t** strings, const hashify_string_t* string) {
+	//Strings point to the buffers in the struct, repoint to the copies stored in the array
+	//since the array storage can move as it grows
+	size_t istr, strings_size;
+	array_push_memcpy(*strings, string);
+	for (istr = 0, strings_size = array_size(*strings); istr < strings_size; ++istr) {
+		(*strings)[istr].string.str = (*strings)[istr].buffer;
+		(*strings)[istr].define.str = (*strings)[istr].define_buffer;
+	}
+}
+
 int
 hashify_read_hashes(stream_t* file, hashify_string_t** hashes) {
 	//Read in hashes in file
@@ -379,16 +657,17 @@ hashify_read_hashes(stream_t* file, hashify_string_t** hashes) {
 		string_const_t stripped_line = string_strip(STRING_ARGS(line), STRING_CONST("\n\r"));
 		if ((string_find_string(STRING_ARGS(stripped_line), STRING_CONST("define"), 0) != STRING_NPOS) &&
 		        (string_find_string(STRING_ARGS(stripped_line), STRING_CONST("static_hash"), 0) != STRING_NPOS)) {
-			//Format is: #define HASH_<hashstring> static_hash_string( "<string>", 0x<hashvalue>ULL )
-			size_t num_tokens = string_explode(STRING_ARGS(stripped_line), STRING_CONST(" \t"), tokens, 32,
+			//Format is: #define HASH_<hashstring> static_hash_string("<string>", <length>, 0x<hashvalue>ULL)
+			size_t num_tokens = string_explode(STRING_ARGS(stripped_line), STRING_CONST(" \t(),"), tokens, 32,
 			                                   false);
 
 			if (num_tokens >= 6) {
 				hashify_string_t hash_string;
-				string_const_t stripped = string_strip(STRING_ARGS(tokens[3]), STRING_CONST(","));
-				stripped = string_strip(STRING_ARGS(stripped), STRING_CONST("\""));
+				string_const_t stripped = string_strip(STRING_ARGS(tokens[3]), STRING_CONST("\""));
 				hash_string.string = string_copy(hash_string.buffer, HASHIFY_STRING_LENGTH, STRING_ARGS(stripped));
-				hash_string.hash = string_to_uint64(STRING_ARGS(tokens[4]), true);
+				hash_string.define = string_copy(hash_string.define_buffer, HASHIFY_STRING_LENGTH,
+				                                 STRING_ARGS(tokens[1]));
+				hash_string.hash = string_to_uint64(STRING_ARGS(tokens[5]), true);
 
 				if (hash(STRING_ARGS(hash_string.string)) != hash_string.hash) {
 					log_errorf(0, ERROR_INVALID_VALUE,
@@ -398,7 +677,7 @@ hashify_read_hashes(stream_t* file, hashify_string_t** hashes) {
 					return HASHIFY_RESULT_OUTPUT_FILE_OUT_OF_DATE;
 				}
 
-				array_push_memcpy(*hashes, &hash_string);
+				hashify_push_string(hashes, &hash_string);
 			}
 		}
 	}
@@ -416,7 +695,7 @@ hashify_write_file(stream_t* generated_file, string_t output_filename) {
 	output_file = stream_open(STRING_ARGS(output_filename), STREAM_OUT | STREAM_IN);
 	if (!output_file) {
 		need_update = true;
-		output_file = stream_open(STRING_ARGS(output_filename), STREAM_OUT);
+		output_file = stream_open(STRING_ARGS(output_filename), STREAM_OUT | STREAM_CREATE);
 		if (!output_file) {
 			log_warnf(0, WARNING_INVALID_VALUE, STRING_CONST("Unable to open output file: %.*s"),
 			          STRING_FORMAT(output_filename));
@@ -572,10 +851,12 @@ hashify_print_usage(void) {
 	log_set_suppress(0, ERRORLEVEL_DEBUG);
 	log_info(0, STRING_CONST(
 	             "hashify usage:\n"
-	             "  hashify [--validate] [--generate-string <string>] [<filename> <filename> ...] [--debug] [--help] [--]\n"
+	             "  hashify [--validate] [--table] [--generate-string <string>] [<filename> <filename> ...] [--debug] [--help] [--]\n"
 	             "    Generated files have the same file name as the input file, with the extension replaced by .h\n"
 	             "    Optional arguments:\n"
 	             "      --validate                   Suppress output and only validate existing hashes\n"
+	             "      --table                      Also generate a minimal perfect hash table of the strings\n"
+	             "                                   in a file named as the input file with _table.h appended\n"
 	             "      --generate-string <string>   Generate hash of the given string\n"
 	             "      <filename> <filename> ...    Any number of input files\n"
 	             "      --debug                      Enable debug output\n"